@@ -0,0 +1,428 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __DOLFIN_BENCHMARK_H
+#define __DOLFIN_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include <dolfin.h>
+
+namespace bench
+{
+
+  /// Benchmark harness shared by the C++ benchmarks. Each case is
+  /// run a number of warmup repetitions followed by timed
+  /// repetitions. Processes synchronise before every repetition and
+  /// the time of a repetition is the maximum over processes, such
+  /// that stragglers are accounted for. The usage is
+  ///
+  ///   bench::Benchmark b("mesh-topology", argc, argv);
+  ///   b.run("facets", [&](){ mesh.clean(); }, [&](){ mesh.init(2); });
+  ///   b.write();
+  ///
+  /// measure_memory() runs a case once more, untimed, and records
+  /// the increase of the peak resident set size of the processes
+  /// during the body (GNU/Linux only).
+  ///
+  /// Command-line options --reps <n>, --warmup <n> and --json
+  /// <file> override the defaults given to the constructor; the
+  /// remaining arguments are passed to dolfin::parameters.parse.
+  ///
+  /// write() prints a summary, prints lines "BENCH <case> <median>"
+  /// for bench.py and writes medians, percentiles, all samples, the
+  /// git commit and machine information as JSON (default
+  /// <name>.json) on rank 0.
+
+  class Benchmark
+  {
+  public:
+
+    /// Create benchmark with given name and default number of
+    /// timed and warmup repetitions
+    Benchmark(std::string name, int argc, char* argv[],
+              std::size_t reps=5, std::size_t warmup=1)
+      : _name(name), _reps(reps), _warmup(warmup),
+        _filename(name + ".json"), _comm(MPI_COMM_WORLD)
+    {
+      // Strip harness options and pass the rest on to DOLFIN
+      std::vector<char*> args(1, argv[0]);
+      for (int i = 1; i < argc; ++i)
+      {
+        const std::string arg(argv[i]);
+        if (arg == "--reps" && i + 1 < argc)
+          _reps = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && i + 1 < argc)
+          _warmup = std::atoi(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc)
+          _filename = argv[++i];
+        else
+          args.push_back(argv[i]);
+      }
+      dolfin::parameters.parse(args.size(), args.data());
+
+      if (_reps == 0)
+        _reps = 1;
+    }
+
+    /// Set entry (e.g. problem size) stored with the results
+    void set(std::string key, std::string value)
+    {
+      for (auto& entry : _info)
+      {
+        if (entry.first == key)
+        {
+          entry.second = value;
+          return;
+        }
+      }
+      _info.push_back(std::make_pair(key, value));
+    }
+
+    /// Return number of timed repetitions
+    std::size_t reps() const
+    { return _reps; }
+
+    /// Return number of warmup repetitions
+    std::size_t warmup() const
+    { return _warmup; }
+
+    /// Run case: call setup (untimed) and body (timed) for each
+    /// warmup and timed repetition
+    void run(std::string name, std::function<void()> setup,
+             std::function<void()> body)
+    {
+      for (std::size_t i = 0; i < _warmup; ++i)
+      {
+        setup();
+        body();
+      }
+
+      Case& c = get_case(name);
+      for (std::size_t i = 0; i < _reps; ++i)
+      {
+        setup();
+        dolfin::MPI::barrier(_comm);
+        const auto t0 = std::chrono::steady_clock::now();
+        body();
+        const std::chrono::duration<double> t
+          = std::chrono::steady_clock::now() - t0;
+        record(c, t.count());
+      }
+    }
+
+    /// Run case without setup
+    void run(std::string name, std::function<void()> body)
+    { run(name, [](){}, body); }
+
+    /// Run case once (untimed) and record the increase of the peak
+    /// resident set size (in MB) during body, maximum over
+    /// processes. The peak is reset before body, so allocations
+    /// freed within body are accounted for. Nothing is recorded if
+    /// the peak cannot be reset or read. Collective.
+    void measure_memory(std::string name, std::function<void()> setup,
+                        std::function<void()> body)
+    {
+      setup();
+      dolfin::MPI::barrier(_comm);
+      const bool reset = reset_peak_memory();
+      const double rss = proc_status("VmRSS:");
+      body();
+      const double hwm = proc_status("VmHWM:");
+      const bool valid = reset && rss >= 0.0 && hwm >= 0.0;
+      if (dolfin::MPI::min(_comm, (int) valid) == 0)
+        return;
+
+      get_case(name).memory
+        = dolfin::MPI::max(_comm, std::max(hwm - rss, 0.0));
+    }
+
+    /// Measure memory of case without setup
+    void measure_memory(std::string name, std::function<void()> body)
+    { measure_memory(name, [](){}, body); }
+
+    /// Record time (in seconds) of one repetition of case measured
+    /// elsewhere, e.g. by a dolfin::Timer. Collective.
+    void record(std::string name, double time)
+    { record(get_case(name), time); }
+
+    /// Return median time (in seconds) of case, or zero if case
+    /// has not been run
+    double median(std::string name) const
+    {
+      for (auto& c : _cases)
+      {
+        if (c.name == name)
+          return statistics(c).median;
+      }
+      return 0.0;
+    }
+
+    /// Print summary and write JSON file. Collective.
+    void write() const
+    {
+      if (dolfin::MPI::rank(_comm) != 0)
+        return;
+
+      dolfin::Table table(_name);
+      for (auto& c : _cases)
+      {
+        const Statistics s = statistics(c);
+        table(c.name, "reps") = c.samples.size();
+        table(c.name, "min") = s.min;
+        table(c.name, "median") = s.median;
+        table(c.name, "p90") = s.p90;
+        table(c.name, "max") = s.max;
+        table(c.name, "imbalance") = s.imbalance;
+        if (c.memory >= 0.0)
+          table(c.name, "peak MB") = c.memory;
+        else
+          table(c.name, "peak MB") = "-";
+      }
+      dolfin::info(table.str(true));
+
+      for (auto& c : _cases)
+      {
+        std::string name = c.name;
+        std::replace(name.begin(), name.end(), ' ', '_');
+        dolfin::info("BENCH %s %g", name.c_str(), statistics(c).median);
+      }
+
+      std::ofstream f(_filename.c_str());
+      if (!f.is_open())
+      {
+        dolfin::dolfin_error("Benchmark.h",
+                             "write benchmark results",
+                             "Unable to open file \"%s\"",
+                             _filename.c_str());
+      }
+
+      f.precision(9);
+      f << "{\n"
+        << "  \"benchmark\": \"" << escape(_name) << "\",\n"
+        << "  \"git_commit\": \"" << escape(dolfin::git_commit_hash())
+        << "\",\n"
+        << "  \"dolfin_version\": \"" << escape(dolfin::dolfin_version())
+        << "\",\n"
+        << "  \"machine\": {\n"
+        << "    \"hostname\": \"" << escape(hostname()) << "\",\n"
+        << "    \"compiler\": \"" << escape(compiler()) << "\",\n"
+        << "    \"date\": \"" << escape(date()) << "\",\n"
+        << "    \"num_processes\": " << dolfin::MPI::size(_comm) << ",\n"
+        << "    \"num_threads\": "
+        << (int) dolfin::parameters["num_threads"] << ",\n"
+        << "    \"linear_algebra_backend\": \""
+        << escape(dolfin::parameters["linear_algebra_backend"]) << "\"\n"
+        << "  },\n"
+        << "  \"info\": {";
+      for (std::size_t i = 0; i < _info.size(); ++i)
+      {
+        f << (i == 0 ? "\n" : ",\n") << "    \"" << escape(_info[i].first)
+          << "\": \"" << escape(_info[i].second) << "\"";
+      }
+      f << (_info.empty() ? "},\n" : "\n  },\n")
+        << "  \"warmup\": " << _warmup << ",\n"
+        << "  \"cases\": [";
+      for (std::size_t i = 0; i < _cases.size(); ++i)
+      {
+        const Case& c = _cases[i];
+        const Statistics s = statistics(c);
+        f << (i == 0 ? "\n" : ",\n")
+          << "    {\"name\": \"" << escape(c.name) << "\""
+          << ", \"reps\": " << c.samples.size()
+          << ", \"min\": " << s.min
+          << ", \"median\": " << s.median
+          << ", \"p10\": " << s.p10
+          << ", \"p90\": " << s.p90
+          << ", \"max\": " << s.max
+          << ", \"mean\": " << s.mean
+          << ", \"imbalance\": " << s.imbalance;
+        if (c.memory >= 0.0)
+          f << ", \"peak_memory_mb\": " << c.memory;
+        f << ", \"samples\": [";
+        for (std::size_t j = 0; j < c.samples.size(); ++j)
+          f << (j == 0 ? "" : ", ") << c.samples[j];
+        f << "]}";
+      }
+      f << "\n  ]\n}\n";
+    }
+
+  private:
+
+    // Timings of one case: maximum and average over processes of
+    // each repetition, and increase of peak memory in MB (negative
+    // if not measured)
+    struct Case
+    {
+      std::string name;
+      std::vector<double> samples;
+      std::vector<double> averages;
+      double memory = -1.0;
+    };
+
+    struct Statistics
+    {
+      double min, p10, median, p90, max, mean, imbalance;
+    };
+
+    Case& get_case(std::string name)
+    {
+      for (auto& c : _cases)
+      {
+        if (c.name == name)
+          return c;
+      }
+      _cases.push_back(Case());
+      _cases.back().name = name;
+      return _cases.back();
+    }
+
+    void record(Case& c, double time)
+    {
+      c.samples.push_back(dolfin::MPI::max(_comm, time));
+      c.averages.push_back(dolfin::MPI::avg(_comm, time));
+    }
+
+    // Percentile by linear interpolation of sorted samples
+    static double percentile(const std::vector<double>& sorted, double p)
+    {
+      const double x = p*(sorted.size() - 1);
+      const std::size_t i = std::floor(x);
+      if (i + 1 >= sorted.size())
+        return sorted.back();
+      return sorted[i] + (x - i)*(sorted[i + 1] - sorted[i]);
+    }
+
+    static Statistics statistics(const Case& c)
+    {
+      Statistics s = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+      if (c.samples.empty())
+        return s;
+
+      std::vector<double> sorted(c.samples);
+      std::sort(sorted.begin(), sorted.end());
+      s.min = sorted.front();
+      s.max = sorted.back();
+      s.p10 = percentile(sorted, 0.1);
+      s.median = percentile(sorted, 0.5);
+      s.p90 = percentile(sorted, 0.9);
+
+      // Ratio of slowest to average process
+      double sum = 0.0, sum_avg = 0.0;
+      for (std::size_t i = 0; i < c.samples.size(); ++i)
+      {
+        sum += c.samples[i];
+        sum_avg += c.averages[i];
+      }
+      s.mean = sum/c.samples.size();
+      if (sum_avg > 0.0)
+        s.imbalance = sum/sum_avg;
+
+      return s;
+    }
+
+    static std::string escape(const std::string& s)
+    {
+      std::string e;
+      for (auto c : s)
+      {
+        if (c == '"' || c == '\\')
+          e += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+          e += c;
+      }
+      return e;
+    }
+
+    // Reset peak resident set size of this process to the current
+    // resident set size (Linux 4.0 and later)
+    static bool reset_peak_memory()
+    {
+      std::ofstream f("/proc/self/clear_refs");
+      if (!f.is_open())
+        return false;
+      f << "5";
+      f.close();
+      return !f.fail();
+    }
+
+    // Read entry (in kB) of /proc/self/status and return it in MB, or
+    // -1 if not available
+    static double proc_status(const std::string& key)
+    {
+      std::ifstream f("/proc/self/status");
+      std::string line;
+      while (std::getline(f, line))
+      {
+        if (line.compare(0, key.size(), key) == 0)
+        {
+          std::istringstream s(line.substr(key.size()));
+          double kb = -1.0;
+          s >> kb;
+          return kb < 0.0 ? -1.0 : kb/1024.0;
+        }
+      }
+      return -1.0;
+    }
+
+    static std::string hostname()
+    {
+      char name[256] = "";
+      gethostname(name, sizeof(name) - 1);
+      return name;
+    }
+
+    static std::string compiler()
+    {
+      #ifdef __VERSION__
+      return __VERSION__;
+      #else
+      return "unknown";
+      #endif
+    }
+
+    static std::string date()
+    {
+      char s[32] = "";
+      const std::time_t t = std::time(nullptr);
+      std::strftime(s, sizeof(s), "%Y-%m-%dT%H:%M:%S", std::localtime(&t));
+      return s;
+    }
+
+    std::string _name;
+    std::size_t _reps;
+    std::size_t _warmup;
+    std::string _filename;
+    MPI_Comm _comm;
+    std::vector<Case> _cases;
+    std::vector<std::pair<std::string, std::string>> _info;
+
+  };
+
+}
+
+#endif
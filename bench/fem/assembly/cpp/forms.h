@@ -16,8 +16,9 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2008-07-22
-// Last changed: 2010-05-03
+// Last changed: 2017-10-14
 
+#include <functional>
 #include <memory>
 #include <dolfin.h>
 
@@ -34,35 +35,35 @@
 
 using namespace dolfin;
 
-double bench_form(std::string form_name, double (*foo)(Form&))
+void bench_form(std::string form_name, std::function<void(Form&)> foo)
 {
   if (form_name == "poisson1")
   {
     auto mesh = std::make_shared<UnitSquareMesh>(SIZE_2D, SIZE_2D);
     auto V = std::make_shared<Poisson2DP1::FunctionSpace>(mesh);
     Poisson2DP1::BilinearForm form(V, V);
-    return foo(form);
+    foo(form);
   }
   else if (form_name == "poisson2")
   {
     auto mesh = std::make_shared<UnitSquareMesh>(SIZE_2D, SIZE_2D);
     auto V = std::make_shared<Poisson2DP2::FunctionSpace>(mesh);
     Poisson2DP2::BilinearForm form(V, V);
-    return foo(form);
+    foo(form);
   }
   else if (form_name == "poisson3")
   {
     auto mesh = std::make_shared<UnitSquareMesh>(SIZE_2D, SIZE_2D);
     auto V = std::make_shared<Poisson2DP3::FunctionSpace>(mesh);
     Poisson2DP3::BilinearForm form(V, V);
-    return foo(form);
+    foo(form);
   }
   else if (form_name == "stokes")
   {
     auto mesh = std::make_shared<UnitSquareMesh>(SIZE_2D, SIZE_2D);
     auto V = std::make_shared<THStokes2D::FunctionSpace>(mesh);
     THStokes2D::BilinearForm form(V, V);
-    return foo(form);
+    foo(form);
   }
   else if (form_name == "stabilization")
   {
@@ -70,14 +71,14 @@ double bench_form(std::string form_name, double (*foo)(Form&))
     auto V = std::make_shared<StabStokes2D::FunctionSpace>(mesh);
     auto h = std::make_shared<Constant>(1.0);
     StabStokes2D::BilinearForm form(V, V, h);
-    return foo(form);
+    foo(form);
   }
   else if (form_name == "elasticity")
   {
     auto mesh = std::make_shared<UnitCubeMesh>(SIZE_3D, SIZE_3D, SIZE_3D);
     auto V = std::make_shared<Elasticity3D::FunctionSpace>(mesh);
     Elasticity3D::BilinearForm form(V, V);
-    return foo(form);
+    foo(form);
   }
   else if (form_name == "navierstokes")
   {
@@ -89,12 +90,10 @@ double bench_form(std::string form_name, double (*foo)(Form&))
     auto k = std::make_shared<Constant>(1.0);
     auto nu = std::make_shared<Constant>(1.0);
     NSEMomentum3D::BilinearForm form(V, V, w, d1, d2, k, nu);
-    return foo(form);
+    foo(form);
   }
   else
   {
     error("Unknown form: %s.", form_name.c_str());
   }
-
-  return 0.0;
 }
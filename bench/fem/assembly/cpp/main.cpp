@@ -16,43 +16,20 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2008-07-22
-// Last changed: 2011-09-21
+// Last changed: 2017-10-14
 
 #include <string>
 #include <vector>
 #include <iostream>
 #include <dolfin.h>
+#include <Benchmark.h>
 #include "forms.h"
 
 using namespace dolfin;
 
-double assemble_form(Form& form)
-{
-  // Assemble once
-  const double t0 = time();
-  Matrix A;
-  Assembler assembler;
-  assembler.assemble(A, form);
-  return time() - t0;
-}
-
-double reassemble_form(Form& form)
-{
-  // Assemble once
-  Matrix A;
-  Assembler assembler;
-  assembler.assemble(A, form);
-
-  // Reassemble
-  const double t0 = time();
-  assembler.assemble(A, form);
-  return time() - t0;
-}
-
 int main(int argc, char* argv[])
 {
   info("Assembly for various forms and backends");
-  set_log_active(false);
 
   // FIXME: Why?
   parameters["reorder_dofs_serial"] = false;
@@ -78,93 +55,75 @@ int main(int argc, char* argv[])
   }
 
   // Override forms and backends with command-line arguments
-  if (argc == 3)
+  bool reassemble = true;
+  if (argc >= 3 && argv[1][0] != '-' && argv[2][0] != '-')
   {
     forms.clear();
     forms.push_back(argv[1]);
     backends.clear();
     backends.push_back(argv[2]);
+    reassemble = false;
+    argv[2] = argv[0];
+    argc -= 2;
+    argv += 2;
   }
-  else if (argc != 1)
+  else if (argc > 1 && argv[1][0] != '-')
   {
-    std::cout << "Usage: bench [form] [backend]" << std::endl;
+    std::cout << "Usage: bench [form backend] [--reps n] [--warmup n] "
+              << "[--json file]" << std::endl;
     exit(1);
   }
 
-  // Tables for results
-  Table t0("Assemble total");
-  Table t1("Init dofmap");
-  Table t2("Build sparsity");
-  Table t3("Init tensor");
-  Table t4("Delete sparsity");
-  Table t5("Assemble cells");
-  Table t6("Overhead");
-  Table t7("Reassemble total");
+  bench::Benchmark b("fem-assembly", argc, argv, 3);
+  set_log_active(false);
 
-  // Benchmark assembly
-  for (unsigned int i = 0; i < forms.size(); i++)
-  {
-    std::cout << "Form: " << forms[i] << std::endl;
-    for (unsigned int j = 0; j < backends.size(); j++)
-    {
-      parameters["linear_algebra_backend"] = backends[j];
-      parameters["timer_prefix"] = backends[j];
-      std::cout << "  Backend: " << backends[j] << std::endl;
-      const double tt0 = bench_form(forms[i], assemble_form);
-      const auto timing1 = timing(backends[j] + t1.name(), TimingClear::clear);
-      const auto timing2 = timing(backends[j] + t2.name(), TimingClear::clear);
-      const auto timing3 = timing(backends[j] + t3.name(), TimingClear::clear);
-      const auto timing4 = timing(backends[j] + t4.name(), TimingClear::clear);
-      const auto timing5 = timing(backends[j] + t5.name(), TimingClear::clear);
-      const double tt1
-        = std::get<1>(timing1)/static_cast<double>(std::get<0>(timing1));
-      const double tt2
-        = std::get<1>(timing2)/static_cast<double>(std::get<0>(timing2));
-      const double tt3
-        = std::get<1>(timing3)/static_cast<double>(std::get<0>(timing3));
-      const double tt4
-        = std::get<1>(timing4)/static_cast<double>(std::get<0>(timing4));
-      const double tt5
-        = std::get<1>(timing5)/static_cast<double>(std::get<0>(timing5));
-      t0(forms[i], backends[j]) = tt0;
-      t1(forms[i], backends[j]) = tt1;
-      t2(forms[i], backends[j]) = tt2;
-      t3(forms[i], backends[j]) = tt3;
-      t4(forms[i], backends[j]) = tt4;
-      t5(forms[i], backends[j]) = tt5;
-      t6(forms[i], backends[j]) = tt0 - tt1 - tt2 - tt3 - tt4 - tt5;
-      std::cout << "  BENCH " << forms[i] << "-" << backends[j] << " " << tt0
-                << std::endl;
-    }
-  }
+  // Sub-tasks of assembly timed by the assembler
+  const std::vector<std::string> tasks = {"Init dofmap", "Build sparsity",
+                                          "Init tensor", "Delete sparsity",
+                                          "Assemble cells"};
 
-  // Benchmark reassembly
-  if (argc == 1)
+  // Benchmark assembly and reassembly
+  for (auto& form_name : forms)
   {
-    for (unsigned int i = 0; i < forms.size(); i++)
+    for (auto& backend : backends)
     {
-      std::cout << "Form: " << forms[i] << std::endl;
-      for (unsigned int j = 0; j < backends.size(); j++)
-      {
-        parameters["linear_algebra_backend"] = backends[j];
-        parameters["timer_prefix"] = backends[j];
-        std::cout << "  Backend: " << backends[j] << std::endl;
-        t7(forms[i], backends[j]) = bench_form(forms[i], reassemble_form);
-      }
+      parameters["linear_algebra_backend"] = backend;
+      parameters["timer_prefix"] = backend;
+      const std::string name = form_name + "-" + backend;
+
+      bench_form(form_name, [&](Form& form)
+        {
+          // Assemble from scratch and record average sub-task
+          // timings
+          b.run(name, [&]()
+                {
+                  Matrix A;
+                  Assembler assembler;
+                  assembler.assemble(A, form);
+                });
+          for (auto& task : tasks)
+          {
+            const auto t = timing(backend + task, TimingClear::clear);
+            b.record(name + "-" + task,
+                     std::get<1>(t)/static_cast<double>(std::get<0>(t)));
+          }
+
+          // Reassemble into existing matrix
+          if (reassemble)
+          {
+            Matrix A;
+            Assembler assembler;
+            assembler.assemble(A, form);
+            b.run(name + "-reassemble", [&]()
+                  { assembler.assemble(A, form); });
+          }
+        });
     }
   }
 
   // Display results
   set_log_active(true);
-  std::cout << std::endl; info(t0, true);
-  std::cout << std::endl; info(t1, true);
-  std::cout << std::endl; info(t2, true);
-  std::cout << std::endl; info(t3, true);
-  std::cout << std::endl; info(t4, true);
-  std::cout << std::endl; info(t5, true);
-  std::cout << std::endl; info(t6, true);
-  if (argc == 1)
-    std::cout << std::endl; info(t7, true);
+  b.write();
 
   return 0;
 }
@@ -0,0 +1,78 @@
+"""Compute parallel efficiency per phase from JSON output of the
+scaling benchmark. Usage:
+
+  python analyse.py fem-scaling-np1.json fem-scaling-np2.json ...
+
+The run with the fewest processes is the reference. Weak scaling
+efficiency is T_ref/T_p, strong scaling efficiency is
+(p_ref T_ref)/(p T_p), using the median time of each phase.
+"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+from __future__ import print_function
+import json
+import sys
+
+
+def main(filenames):
+    runs = []
+    for filename in filenames:
+        with open(filename) as f:
+            runs.append(json.load(f))
+    if not runs:
+        print(__doc__)
+        return 1
+
+    runs.sort(key=lambda r: r["machine"]["num_processes"])
+    scalings = set(r["info"].get("scaling", "weak") for r in runs)
+    if len(scalings) != 1:
+        print("Cannot mix weak and strong scaling runs")
+        return 1
+    scaling = scalings.pop()
+
+    ref = runs[0]
+    p_ref = ref["machine"]["num_processes"]
+    t_ref = dict((c["name"], c["median"]) for c in ref["cases"])
+
+    # Header
+    procs = [r["machine"]["num_processes"] for r in runs]
+    print("%s scaling efficiency (reference: %d processes)" % (scaling, p_ref))
+    print("%-28s" % "phase" + "".join("%10d" % p for p in procs))
+
+    # Efficiency of each phase
+    for name in [c["name"] for c in ref["cases"]]:
+        row = "%-28s" % name
+        for r in runs:
+            p = r["machine"]["num_processes"]
+            t = dict((c["name"], c["median"]) for c in r["cases"]).get(name)
+            if not t or not t_ref[name]:
+                row += "%10s" % "-"
+                continue
+            if scaling == "weak":
+                e = t_ref[name]/t
+            else:
+                e = p_ref*t_ref[name]/(p*t)
+            row += "%10.2f" % e
+        print(row)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
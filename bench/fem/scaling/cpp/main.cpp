@@ -0,0 +1,230 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Strong and weak scaling benchmark for Poisson, Stokes and linear
+// elasticity on a unit cube. Each phase (mesh build, function space
+// and dofmap build, assembly, apply, Krylov solve, HDF5 write/read
+// and XDMF output) is timed separately. Run it for a range of
+// process counts, e.g.
+//
+//   mpirun -np 4 ./bench_fem_scaling_cpp --scaling weak --cells 100000
+//
+// and compute parallel efficiencies from the JSON output with
+// analyse.py.
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <dolfin.h>
+#include <Benchmark.h>
+
+#include "Poisson.h"
+#include "Stokes.h"
+#include "StokesPreconditioner.h"
+#include "Elasticity.h"
+
+using namespace dolfin;
+
+// Whole boundary
+class Boundary : public SubDomain
+{
+  bool inside(const Array<double>& x, bool on_boundary) const
+  { return on_boundary; }
+};
+
+// Benchmark all phases of one problem on UnitCubeMesh(n, n, n)
+template<typename Space, typename BilinearForm, typename LinearForm>
+void bench_problem(bench::Benchmark& b, std::string name, std::size_t n,
+                   std::shared_ptr<const GenericFunction> f,
+                   std::shared_ptr<const GenericFunction> g,
+                   std::function<std::shared_ptr<const FunctionSpace>
+                   (std::shared_ptr<const FunctionSpace>)> bc_space,
+                   std::function<std::shared_ptr<Form>
+                   (std::shared_ptr<const FunctionSpace>)> preconditioner,
+                   std::function<Function(const Function&)> output,
+                   std::string method, std::string pc)
+{
+  const MPI_Comm comm = MPI_COMM_WORLD;
+
+  // Mesh build
+  std::shared_ptr<Mesh> mesh;
+  b.run(name + "-mesh", [&]()
+        { mesh = std::make_shared<UnitCubeMesh>(comm, n, n, n); });
+
+  // Function space, dominated by building the dofmap
+  std::shared_ptr<Space> V;
+  b.run(name + "-dofmap", [&](){ V = std::make_shared<Space>(mesh); });
+  b.set(name + "-dofs", std::to_string(V->dim()));
+
+  BilinearForm a(V, V);
+  LinearForm L(V);
+  L.f = f;
+  auto bc = std::make_shared<DirichletBC>(bc_space(V), g,
+                                          std::make_shared<Boundary>());
+
+  // Assembly and apply, timed separately (the first assembly builds
+  // the sparsity pattern and is not timed)
+  Matrix A;
+  Assembler assembler;
+  assembler.assemble(A, a);
+  assembler.finalize_tensor = false;
+  for (std::size_t i = 0; i < b.reps(); ++i)
+  {
+    MPI::barrier(comm);
+    const double t0 = dolfin::time();
+    assembler.assemble(A, a);
+    const double t1 = dolfin::time();
+    A.apply("add");
+    const double t2 = dolfin::time();
+    b.record(name + "-assemble", t1 - t0);
+    b.record(name + "-apply", t2 - t1);
+  }
+
+  // Krylov solve
+  auto As = std::make_shared<Matrix>();
+  Vector rhs;
+  assemble_system(*As, rhs, a, L, {bc});
+  KrylovSolver solver(comm, method, pc);
+  solver.parameters["error_on_nonconvergence"] = false;
+  std::shared_ptr<Form> a_P = preconditioner(V);
+  if (a_P)
+  {
+    auto P = std::make_shared<Matrix>();
+    Vector tmp;
+    assemble_system(*P, tmp, *a_P, L, {bc});
+    solver.set_operators(As, P);
+  }
+  else
+    solver.set_operator(As);
+
+  Function u(V);
+  b.run(name + "-solve", [&](){ u.vector()->zero(); },
+        [&](){ solver.solve(*u.vector(), rhs); });
+
+  // I/O
+  if (has_hdf5())
+  {
+    const std::string h5_file = "scaling-" + name + ".h5";
+    b.run(name + "-hdf5-write", [&]()
+          {
+            HDF5File file(comm, h5_file, "w");
+            file.write(*mesh, "/mesh");
+            file.write(u, "/u");
+          });
+    b.run(name + "-hdf5-read", [&]()
+          {
+            HDF5File file(comm, h5_file, "r");
+            Mesh m(comm);
+            file.read(m, "/mesh", false);
+            Function v(V);
+            file.read(v, "/u");
+          });
+
+    const Function w = output(u);
+    b.run(name + "-xdmf-write", [&]()
+          {
+            XDMFFile file(comm, "scaling-" + name + ".xdmf");
+            file.write(w);
+          });
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  // Parse scaling options before handing the rest to the harness
+  std::string scaling = "weak";
+  double cells = 50000.0;
+  std::vector<char*> args(1, argv[0]);
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "--scaling" && i + 1 < argc)
+      scaling = argv[++i];
+    else if (arg == "--cells" && i + 1 < argc)
+      cells = std::atof(argv[++i]);
+    else
+      args.push_back(argv[i]);
+  }
+
+  if (scaling != "weak" && scaling != "strong")
+  {
+    std::cout << "Usage: bench [--scaling weak|strong] [--cells n] "
+              << "[--reps n] [--warmup n] [--json file]" << std::endl;
+    exit(1);
+  }
+
+  info("Strong and weak scaling of Poisson, Stokes and elasticity");
+
+  bench::Benchmark b("fem-scaling", args.size(), args.data(), 3);
+
+  // Mesh size: given number of cells per process (weak) or in
+  // total (strong), with 6 tetrahedra per cube
+  const std::size_t num_processes = MPI::size(MPI_COMM_WORLD);
+  const double total_cells
+    = scaling == "weak" ? cells*num_processes : cells;
+  const std::size_t n
+    = std::max(1.0, std::round(std::cbrt(total_cells/6.0)));
+  b.set("scaling", scaling);
+  b.set("cells", std::to_string(cells));
+  b.set("num_cells", std::to_string(6*n*n*n));
+
+  // Use AMG when available
+  const std::string pc
+    = has_krylov_solver_preconditioner("amg") ? "amg" : "default";
+
+  set_log_active(false);
+
+  auto same_space = [](std::shared_ptr<const FunctionSpace> V)
+    { return V; };
+  auto no_preconditioner = [](std::shared_ptr<const FunctionSpace> V)
+    { return std::shared_ptr<Form>(); };
+  auto same_function = [](const Function& u) { return Function(u); };
+
+  // Poisson
+  bench_problem<Poisson::FunctionSpace, Poisson::BilinearForm,
+                Poisson::LinearForm>
+    (b, "poisson", n, std::make_shared<Constant>(1.0),
+     std::make_shared<Constant>(0.0), same_space, no_preconditioner,
+     same_function, "cg", pc);
+
+  // Stokes with block preconditioner, writing the velocity
+  bench_problem<Stokes::FunctionSpace, Stokes::BilinearForm,
+                Stokes::LinearForm>
+    (b, "stokes", n, std::make_shared<Constant>(0.0, 0.0, 1.0),
+     std::make_shared<Constant>(0.0, 0.0, 0.0),
+     [](std::shared_ptr<const FunctionSpace> W) { return W->sub(0); },
+     [](std::shared_ptr<const FunctionSpace> W)
+     {
+       return std::shared_ptr<Form>
+         (new StokesPreconditioner::BilinearForm(W, W));
+     },
+     [](const Function& u) { return Function(u[0]); },
+     has_krylov_solver_method("minres") ? "minres" : "gmres", pc);
+
+  // Elasticity
+  bench_problem<Elasticity::FunctionSpace, Elasticity::BilinearForm,
+                Elasticity::LinearForm>
+    (b, "elasticity", n, std::make_shared<Constant>(0.0, 0.0, -1.0),
+     std::make_shared<Constant>(0.0, 0.0, 0.0), same_space,
+     no_preconditioner, same_function, "cg", pc);
+
+  set_log_active(true);
+  b.write();
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Setup benchmark for scalar and vector P1-P3 spaces on unit square
+// and unit cube meshes. Each setup phase is timed separately and its
+// increase of peak memory is recorded:
+//
+//   mesh        mesh build (in parallel dominated by partitioning
+//               and distribution of cells)
+//   topology    edges and faces needed by the dofmap, with global
+//               numbering
+//   dofmap      DofMapBuilder::build (via the function space)
+//   sparsity    SparsityPatternBuilder::build for the mass matrix
+//   matrix      GenericMatrix::init from the sparsity pattern
+//   bc          DirichletBC on the whole boundary, computing the
+//               boundary values
+//
+// Pass e.g. --ghost_mode shared_facet to benchmark ghosted meshes.
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin.h>
+#include <Benchmark.h>
+
+#include "Setup2D.h"
+#include "Setup3D.h"
+
+using namespace dolfin;
+
+#define SIZE_2D 256
+#define SIZE_3D 24
+
+// Use for quick testing
+//#define SIZE_2D 32
+//#define SIZE_3D 8
+
+// Whole boundary
+class Boundary : public SubDomain
+{
+  bool inside(const Array<double>& x, bool on_boundary) const
+  { return on_boundary; }
+};
+
+// Run and measure memory of case
+void bench_phase(bench::Benchmark& b, std::string name,
+                 std::function<void()> setup, std::function<void()> body)
+{
+  b.run(name, setup, body);
+  b.measure_memory(name, setup, body);
+}
+
+// Benchmark setup phases of space of given degree on a copy of
+// base mesh (which has no entities other than vertices and cells)
+template<typename BilinearForm>
+void bench_space(bench::Benchmark& b, std::string name, const Mesh& base,
+                 std::size_t degree)
+{
+  typedef typename BilinearForm::TestSpace Space;
+  const MPI_Comm comm = base.mpi_comm();
+  const std::size_t D = base.topology().dim();
+
+  // Topology needed by the dofmap besides vertices and cells: edges
+  // from degree 2 and, in 3D, faces from degree 3
+  auto mesh = std::make_shared<Mesh>(base);
+  std::vector<std::size_t> dims;
+  if (degree > 1)
+    dims.push_back(1);
+  if (degree > 2 && D == 3)
+    dims.push_back(2);
+  if (!dims.empty())
+  {
+    bench_phase(b, name + "-topology",
+                [&](){ mesh = std::make_shared<Mesh>(base); }, [&]()
+                {
+                  for (auto d : dims)
+                    mesh->init_global(d);
+                });
+  }
+
+  // Dofmap
+  std::shared_ptr<Space> V;
+  bench_phase(b, name + "-dofmap", [&](){ V.reset(); },
+              [&](){ V = std::make_shared<Space>(mesh); });
+  b.set(name + "-dofs", std::to_string(V->dim()));
+
+  // Sparsity pattern, building a new layout for each repetition
+  DefaultFactory factory;
+  const std::vector<const GenericDofMap*> dofmaps
+    = {V->dofmap().get(), V->dofmap().get()};
+  const std::vector<std::shared_ptr<const IndexMap>> index_maps
+    = {V->dofmap()->index_map(), V->dofmap()->index_map()};
+  std::shared_ptr<TensorLayout> layout;
+  bench_phase(b, name + "-sparsity", [&]()
+              {
+                layout = factory.create_layout(comm, 2);
+                layout->init(index_maps, TensorLayout::Ghosts::UNGHOSTED);
+              },
+              [&]()
+              {
+                dolfin_assert(layout->sparsity_pattern());
+                SparsityPatternBuilder::build(*layout->sparsity_pattern(),
+                                              *mesh, dofmaps,
+                                              true, false, false, false,
+                                              true);
+              });
+  b.set(name + "-nonzeros",
+        std::to_string(layout->sparsity_pattern()->num_nonzeros()));
+
+  // Matrix initialisation from the last sparsity pattern
+  std::shared_ptr<GenericMatrix> A;
+  bench_phase(b, name + "-matrix", [&](){ A = factory.create_matrix(comm); },
+              [&](){ A->init(*layout); });
+  A.reset();
+
+  // Boundary conditions, with boundary facets computed in advance
+  auto g = std::make_shared<Function>(V);
+  auto boundary = std::make_shared<Boundary>();
+  bench_phase(b, name + "-bc", [&]()
+              {
+                mesh->init(D - 1);
+                mesh->init(D - 1, D);
+              },
+              [&]()
+              {
+                DirichletBC bc(V, g, boundary);
+                DirichletBC::Map values;
+                bc.get_boundary_values(values);
+              });
+}
+
+int main(int argc, char* argv[])
+{
+  info("Setup of scalar and vector P1-P3 spaces on unit square of size %d x %d and unit cube of size %d x %d x %d",
+       SIZE_2D, SIZE_2D, SIZE_3D, SIZE_3D, SIZE_3D);
+
+  bench::Benchmark b("fem-setup", argc, argv, 3);
+  const std::string ghost_mode = parameters["ghost_mode"];
+  b.set("ghost_mode", ghost_mode);
+
+  const MPI_Comm comm = MPI_COMM_WORLD;
+  set_log_active(false);
+
+  // 2D
+  std::shared_ptr<Mesh> mesh;
+  bench_phase(b, "2d-mesh", [&](){ mesh.reset(); }, [&]()
+              { mesh = std::make_shared<UnitSquareMesh>(comm, SIZE_2D,
+                                                        SIZE_2D); });
+  bench_space<Setup2D::Form_a_P1>(b, "2d-p1", *mesh, 1);
+  bench_space<Setup2D::Form_a_P2>(b, "2d-p2", *mesh, 2);
+  bench_space<Setup2D::Form_a_P3>(b, "2d-p3", *mesh, 3);
+  bench_space<Setup2D::Form_a_VP1>(b, "2d-vp1", *mesh, 1);
+  bench_space<Setup2D::Form_a_VP2>(b, "2d-vp2", *mesh, 2);
+  bench_space<Setup2D::Form_a_VP3>(b, "2d-vp3", *mesh, 3);
+
+  // 3D
+  bench_phase(b, "3d-mesh", [&](){ mesh.reset(); }, [&]()
+              { mesh = std::make_shared<UnitCubeMesh>(comm, SIZE_3D,
+                                                      SIZE_3D, SIZE_3D); });
+  bench_space<Setup3D::Form_a_P1>(b, "3d-p1", *mesh, 1);
+  bench_space<Setup3D::Form_a_P2>(b, "3d-p2", *mesh, 2);
+  bench_space<Setup3D::Form_a_P3>(b, "3d-p3", *mesh, 3);
+  bench_space<Setup3D::Form_a_VP1>(b, "3d-vp1", *mesh, 1);
+  bench_space<Setup3D::Form_a_VP2>(b, "3d-vp2", *mesh, 2);
+  bench_space<Setup3D::Form_a_VP3>(b, "3d-vp3", *mesh, 3);
+
+  set_log_active(true);
+  b.write();
+
+  return 0;
+}
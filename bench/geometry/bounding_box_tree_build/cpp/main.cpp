@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <dolfin.h>
+#include <Benchmark.h>
 
 using namespace dolfin;
 
@@ -33,14 +34,19 @@ int main(int argc, char* argv[])
   info("Build bounding box tree on UnitCubeMesh(%d, %d, %d)",
        SIZE, SIZE, SIZE);
 
+  bench::Benchmark b("geometry-bounding_box_tree_build", argc, argv);
+
   // Create mesh
   UnitCubeMesh mesh(SIZE, SIZE, SIZE);
 
   // Create and build tree
-  tic();
-  BoundingBoxTree tree;
-  tree.build(mesh);
-  info("BENCH %g", toc());
+  b.run("build", [&]()
+        {
+          BoundingBoxTree tree;
+          tree.build(mesh);
+        });
+
+  b.write();
 
   return 0;
 }
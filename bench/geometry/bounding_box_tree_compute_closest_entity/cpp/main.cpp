@@ -18,10 +18,12 @@
 // This benchmark measures the performance of compute_entity_collisions.
 //
 // First added:  2013-05-23
-// Last changed: 2013-09-04
+// Last changed: 2017-10-14
 
+#include <string>
 #include <vector>
 #include <dolfin.h>
+#include <Benchmark.h>
 
 using namespace dolfin;
 
@@ -33,27 +35,37 @@ int main(int argc, char* argv[])
   info("Compute closest entity on UnitCubeMesh(%d, %d, %d)",
        SIZE, SIZE, SIZE);
 
+  bench::Benchmark b("geometry-bounding_box_tree_compute_closest_entity",
+                     argc, argv);
+
   // Create mesh
   UnitCubeMesh mesh(SIZE, SIZE, SIZE);
 
-  // First call
-  BoundingBoxTree tree;
-  tree.build(mesh);
-  Point point(-1.0, -1.0, 0.0);
-  tree.compute_closest_entity(point);
-  cout << "Built tree, searching for closest point" << endl;
-
-  // Call repeatedly
-  tic();
-  for (int i = 0; i < NUM_REPS; i++)
+  // Compare binary and wide tree layouts
+  const std::vector<std::string> layouts = {"binary", "wide4", "wide8"};
+  for (std::size_t l = 0; l < layouts.size(); ++l)
   {
-    tree.compute_closest_entity(point);
-    point.coordinates()[1] += 2.0 / static_cast<double>(NUM_REPS);
+    parameters["bounding_box_tree_layout"] = layouts[l];
+
+    // Build tree outside timed region
+    BoundingBoxTree tree;
+    tree.build(mesh);
+    Point point(-1.0, -1.0, 0.0);
+
+    // Call repeatedly, starting from the same point in each
+    // repetition
+    b.run(layouts[l], [&](){ point.coordinates()[1] = -1.0; },
+          [&]()
+          {
+            for (int i = 0; i < NUM_REPS; i++)
+            {
+              tree.compute_closest_entity(point);
+              point.coordinates()[1] += 2.0 / static_cast<double>(NUM_REPS);
+            }
+          });
   }
-  const double t = toc();
 
-  // Report result
-  info("BENCH %g", t);
+  b.write();
 
   return 0;
 }
@@ -0,0 +1,256 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// This benchmark measures BoundingBoxTree queries at scale for
+// realistic point distributions: point location for uniform and
+// clustered points, distance from points outside the mesh, collisions
+// between the trees of two meshes moving relative to each other and
+// rebuilding versus refitting a tree after the mesh is deformed.
+// Queries per second and tree nodes visited per query are stored
+// with the results. The tree layout can be selected with
+// --bounding_box_tree_layout binary|wide4|wide8.
+//
+// Usage: bench [--points n] [--size n] [--reps n] [--warmup n]
+//              [--json file]
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <dolfin.h>
+#include <Benchmark.h>
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+std::vector<Point> uniform_points(std::size_t n, double a, double b,
+                                  std::mt19937& gen)
+{
+  std::uniform_real_distribution<double> x(a, b);
+  std::vector<Point> points(n);
+  for (auto& p : points)
+    p = Point(x(gen), x(gen), x(gen));
+  return points;
+}
+//-----------------------------------------------------------------------------
+std::vector<Point> clustered_points(std::size_t n, std::size_t num_clusters,
+                                    double sigma, std::mt19937& gen)
+{
+  // Gaussian clusters around uniformly distributed centres, clamped
+  // to the unit cube
+  const std::vector<Point> centres = uniform_points(num_clusters, 0.1, 0.9,
+                                                    gen);
+  std::normal_distribution<double> dx(0.0, sigma);
+  std::vector<Point> points(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const Point& c = centres[i % num_clusters];
+    for (std::size_t j = 0; j < 3; ++j)
+      points[i][j] = std::min(1.0, std::max(0.0, c[j] + dx(gen)));
+  }
+  return points;
+}
+//-----------------------------------------------------------------------------
+std::vector<Point> outside_points(std::size_t n, std::mt19937& gen)
+{
+  // Points in a shell of width 0.5 around the unit cube
+  std::vector<Point> points;
+  points.reserve(n);
+  std::uniform_real_distribution<double> x(-0.5, 1.5);
+  while (points.size() < n)
+  {
+    const Point p(x(gen), x(gen), x(gen));
+    if (p[0] < 0.0 or p[0] > 1.0 or p[1] < 0.0 or p[1] > 1.0
+        or p[2] < 0.0 or p[2] > 1.0)
+    {
+      points.push_back(p);
+    }
+  }
+  return points;
+}
+//-----------------------------------------------------------------------------
+void deform(Mesh& mesh, double amplitude)
+{
+  // Smooth non-affine displacement, changing the shape of the cells
+  // but not the topology
+  std::vector<double>& x = mesh.geometry().x();
+  for (std::size_t i = 0; i < x.size(); i += 3)
+  {
+    const double s = amplitude*std::sin(DOLFIN_PI*x[i])
+      *std::sin(DOLFIN_PI*x[i + 1]);
+    x[i] += s;
+    x[i + 1] -= s;
+    x[i + 2] += 0.5*s;
+  }
+}
+//-----------------------------------------------------------------------------
+void bench_queries(bench::Benchmark& b, std::string name,
+                   std::size_t num_queries, std::function<void()> setup,
+                   std::function<void()> queries)
+{
+  b.run(name, setup, queries);
+
+  // Count nodes visited in one untimed pass
+  setup();
+  BoundingBoxTree::reset_nodes_visited();
+  queries();
+  const double nodes = BoundingBoxTree::nodes_visited();
+
+  const double t = b.median(name);
+  b.set(name + " queries/s",
+        std::to_string(t > 0.0 ? num_queries/t : 0.0));
+  b.set(name + " nodes/query", std::to_string(nodes/num_queries));
+
+  info("%s: %.3g queries/s, %.1f nodes/query", name.c_str(),
+       t > 0.0 ? num_queries/t : 0.0, nodes/num_queries);
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  // Parse problem size before handing the rest to the harness
+  std::size_t num_points = 1000000;
+  std::size_t size = 64;
+  std::vector<char*> args(1, argv[0]);
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "--points" && i + 1 < argc)
+      num_points = std::atol(argv[++i]);
+    else if (arg == "--size" && i + 1 < argc)
+      size = std::atol(argv[++i]);
+    else
+      args.push_back(argv[i]);
+  }
+
+  if (num_points == 0 or size == 0)
+  {
+    std::cout << "Usage: bench [--points n] [--size n] "
+              << "[--reps n] [--warmup n] [--json file]" << std::endl;
+    exit(1);
+  }
+
+  info("Bounding box tree queries on UnitCubeMesh(%d, %d, %d)",
+       size, size, size);
+
+  bench::Benchmark b("geometry-bounding_box_tree_queries", args.size(),
+                     args.data(), 3);
+  b.set("points", std::to_string(num_points));
+  b.set("size", std::to_string(size));
+  b.set("layout", parameters["bounding_box_tree_layout"]);
+
+  // Fixed seed so runs are comparable
+  std::mt19937 gen(12345);
+
+  UnitCubeMesh mesh(size, size, size);
+  BoundingBoxTree tree;
+  tree.build(mesh);
+
+  // Point location
+  const std::vector<Point> uniform = uniform_points(num_points, 0.0, 1.0,
+                                                    gen);
+  const std::vector<Point> clustered = clustered_points(num_points, 16, 0.02,
+                                                        gen);
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+  std::size_t found = 0;
+  bench_queries(b, "locate-uniform", num_points, [&](){ found = 0; },
+                [&]()
+                {
+                  for (auto& p : uniform)
+                    found += tree.compute_first_entity_collision(p)
+                      != not_found;
+                });
+  bench_queries(b, "locate-clustered", num_points, [&](){ found = 0; },
+                [&]()
+                {
+                  for (auto& p : clustered)
+                    found += tree.compute_first_entity_collision(p)
+                      != not_found;
+                });
+
+  // Point-to-mesh distance, fewer points since each query descends
+  // towards the boundary
+  const std::size_t num_outside = std::max(num_points/10, std::size_t(1));
+  const std::vector<Point> outside = outside_points(num_outside, gen);
+  double distance = 0.0;
+  bench_queries(b, "distance-outside", num_outside,
+                [&](){ distance = 0.0; },
+                [&]()
+                {
+                  for (auto& p : outside)
+                    distance += tree.compute_closest_entity(p).second;
+                });
+
+  // Tree-tree collisions between two meshes moving through each
+  // other, refitting the moving tree in setup (untimed)
+  const std::size_t moving_size = std::max(size/4, std::size_t(1));
+  UnitCubeMesh fixed_mesh(moving_size, moving_size, moving_size);
+  UnitCubeMesh moving_mesh(moving_size, moving_size, moving_size);
+  moving_mesh.translate(Point(-0.5, -0.25, 0.0));
+  BoundingBoxTree fixed_tree, moving_tree;
+  fixed_tree.build(fixed_mesh);
+  moving_tree.build(moving_mesh);
+  std::size_t num_collisions = 0;
+  b.run("tree-tree",
+        [&]()
+        {
+          moving_mesh.translate(Point(0.05, 0.0, 0.0));
+          moving_tree.refit();
+        },
+        [&]()
+        {
+          num_collisions
+            += fixed_tree.compute_entity_collisions(moving_tree).first.size();
+        });
+  b.set("tree-tree collisions", std::to_string(num_collisions/b.reps()));
+
+  // Rebuild versus refit after deformation, and the cost of queries
+  // on each tree (refitting keeps the partitioning of the undeformed
+  // mesh, so boxes overlap more)
+  UnitCubeMesh deformed_mesh(size, size, size);
+  BoundingBoxTree rebuilt_tree, refitted_tree;
+  rebuilt_tree.build(deformed_mesh);
+  refitted_tree.build(deformed_mesh);
+  deform(deformed_mesh, 0.1);
+  b.run("rebuild", [&](){ rebuilt_tree.build(deformed_mesh); });
+  b.run("refit", [&](){ refitted_tree.refit(); });
+  bench_queries(b, "locate-after-rebuild", num_points, [&](){ found = 0; },
+                [&]()
+                {
+                  for (auto& p : uniform)
+                    found += rebuilt_tree.compute_first_entity_collision(p)
+                      != not_found;
+                });
+  bench_queries(b, "locate-after-refit", num_points, [&](){ found = 0; },
+                [&]()
+                {
+                  for (auto& p : uniform)
+                    found += refitted_tree.compute_first_entity_collision(p)
+                      != not_found;
+                });
+
+  b.write();
+
+  // Use results so queries are not optimised away
+  if (found + num_collisions == 0 and distance < 0.0)
+    info("No collisions found");
+
+  return 0;
+}
+//-----------------------------------------------------------------------------
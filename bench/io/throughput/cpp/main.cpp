@@ -0,0 +1,378 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// This benchmark measures write and read throughput of XDMFFile,
+// HDF5File and VTKFile for a mesh, a vector-valued P1 function, a
+// cell function and time series of the function, with HDF5 and
+// ASCII encodings and (in parallel) for each ghost mode. The number
+// of processes is that of the run, e.g. mpirun -n 1, 2, 4, ...
+//
+// For each case the bytes on disk and the bandwidth (GB/s) are
+// stored with the results, and for XDMF output the time and
+// bandwidth of each phase: gathering the data to write (vertex
+// values, topology, geometry), encoding it (ASCII, single
+// precision), writing it to HDF5 and updating the XML file. Time
+// series also store the latency per step.
+//
+// Usage: bench [--size n] [--steps n] [--reps n] [--warmup n]
+//              [--json file]
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <dolfin.h>
+#include <Benchmark.h>
+#include "Output.h"
+
+using namespace dolfin;
+
+// Phases of XDMF output (names of the timers in XDMFFile)
+const std::vector<std::string> xdmf_phases
+  = {"XDMF: gather data", "XDMF: encode data", "XDMF: write data",
+     "XDMF: update XML"};
+
+//-----------------------------------------------------------------------------
+class Field : public Expression
+{
+public:
+
+  Field(double t) : Expression(3), _t(t) {}
+
+  void eval(Array<double>& values, const Array<double>& x) const
+  {
+    values[0] = std::sin(DOLFIN_PI*(x[0] + _t));
+    values[1] = std::cos(DOLFIN_PI*x[1])*_t;
+    values[2] = x[0]*x[1]*x[2];
+  }
+
+private:
+
+  double _t;
+
+};
+//-----------------------------------------------------------------------------
+void create_directory(MPI_Comm comm, std::string directory)
+{
+  if (dolfin::MPI::rank(comm) == 0)
+    boost::filesystem::create_directories(directory);
+  dolfin::MPI::barrier(comm);
+}
+//-----------------------------------------------------------------------------
+double file_bytes(MPI_Comm comm, std::string directory, std::string prefix)
+{
+  // Total size of files in directory whose names start with prefix,
+  // from process 0
+  double bytes = 0.0;
+  if (dolfin::MPI::rank(comm) == 0)
+  {
+    boost::filesystem::directory_iterator it(directory), end;
+    for (; it != end; ++it)
+    {
+      const std::string name = it->path().filename().string();
+      if (name.compare(0, prefix.size(), prefix) == 0
+          and boost::filesystem::is_regular_file(it->path()))
+      {
+        bytes += boost::filesystem::file_size(it->path());
+      }
+    }
+  }
+  return dolfin::MPI::max(comm, bytes);
+}
+//-----------------------------------------------------------------------------
+double phase_time(MPI_Comm comm, std::string phase)
+{
+  // Ensure the timing exists (adds a negligible empty timing) and
+  // take and clear the total time
+  { Timer t(phase); }
+  const double t = std::get<1>(timing(phase, TimingClear::clear));
+  return dolfin::MPI::max(comm, t);
+}
+//-----------------------------------------------------------------------------
+void set_bandwidth(bench::Benchmark& b, std::string name, double bytes,
+                   double time)
+{
+  b.set(name + " GB/s", std::to_string(time > 0.0 ? bytes/time/1.0e9 : 0.0));
+}
+//-----------------------------------------------------------------------------
+double bench_write(bench::Benchmark& b, MPI_Comm comm, std::string name,
+                   std::string directory, std::string prefix,
+                   std::function<void()> write, bool xdmf,
+                   std::size_t steps=1)
+{
+  // Time writing, then report bytes on disk and bandwidth of the
+  // whole write and (for XDMF) of each phase
+  timings(TimingClear::clear, {TimingType::wall});
+  b.run(name, write);
+  const double bytes = file_bytes(comm, directory, prefix);
+  const double t = b.median(name);
+  b.set(name + " MB", std::to_string(bytes/1.0e6));
+  set_bandwidth(b, name, bytes, t);
+  if (steps > 1)
+    b.set(name + " s/step", std::to_string(t/steps));
+
+  if (xdmf)
+  {
+    const double num_writes = b.reps() + b.warmup();
+    for (auto& phase : xdmf_phases)
+    {
+      const std::string phase_name = name + "/" + phase.substr(6);
+      const double t_phase = phase_time(comm, phase)/num_writes;
+      b.record(phase_name, t_phase);
+      set_bandwidth(b, phase_name, bytes, t_phase);
+    }
+  }
+
+  info("%s: %.3g MB, %.3g GB/s", name.c_str(), bytes/1.0e6,
+       t > 0.0 ? bytes/t/1.0e9 : 0.0);
+  return bytes;
+}
+//-----------------------------------------------------------------------------
+void bench_read(bench::Benchmark& b, std::string name, double bytes,
+                std::function<void()> read)
+{
+  b.run(name, read);
+  const double t = b.median(name);
+  set_bandwidth(b, name, bytes, t);
+  info("%s: %.3g GB/s", name.c_str(), t > 0.0 ? bytes/t/1.0e9 : 0.0);
+}
+//-----------------------------------------------------------------------------
+void bench_ghost_mode(bench::Benchmark& b, std::string ghost_mode,
+                      std::size_t size, std::size_t steps)
+{
+  MPI_Comm comm = MPI_COMM_WORLD;
+  parameters["ghost_mode"] = ghost_mode;
+  const std::string dir = "io-throughput/" + ghost_mode;
+  create_directory(comm, dir);
+
+  auto mesh = std::make_shared<UnitCubeMesh>(comm, size, size, size);
+  const std::size_t tdim = mesh->topology().dim();
+  auto V = std::make_shared<Output::FunctionSpace>(mesh);
+  Function u(V);
+  u.rename("u", "u");
+  u.interpolate(Field(0.0));
+  MeshFunction<std::size_t> cell_function(mesh, tdim);
+  cell_function.rename("cells", "cells");
+  for (CellIterator cell(*mesh); !cell.end(); ++cell)
+    cell_function[*cell] = cell->global_index() % 7;
+
+  // Inputs of the time series (interpolated once, not timed)
+  std::vector<std::shared_ptr<Function>> series(steps);
+  for (std::size_t i = 0; i < steps; ++i)
+  {
+    series[i] = std::make_shared<Function>(V);
+    series[i]->rename("u", "u");
+    series[i]->interpolate(Field((double) i/steps));
+  }
+
+  const std::string p = ghost_mode + "/";
+  const XDMFFile::Encoding hdf5 = XDMFFile::Encoding::HDF5;
+  const XDMFFile::Encoding ascii = XDMFFile::Encoding::ASCII;
+
+  // Mesh
+  const double mesh_bytes
+    = bench_write(b, comm, p + "xdmf-hdf5-mesh-write", dir, "mesh-hdf5",
+                  [&]()
+                  {
+                    XDMFFile file(comm, dir + "/mesh-hdf5.xdmf");
+                    file.write(*mesh, hdf5);
+                  }, true);
+  bench_write(b, comm, p + "xdmf-ascii-mesh-write", dir, "mesh-ascii",
+              [&]()
+              {
+                XDMFFile file(comm, dir + "/mesh-ascii.xdmf");
+                file.write(*mesh, ascii);
+              }, true);
+  bench_read(b, p + "xdmf-hdf5-mesh-read", mesh_bytes,
+             [&]()
+             {
+               XDMFFile file(comm, dir + "/mesh-hdf5.xdmf");
+               Mesh m(comm);
+               file.read(m);
+             });
+
+  // Function (visualisation output at vertices)
+  bench_write(b, comm, p + "xdmf-hdf5-function-write", dir, "function-hdf5",
+              [&]()
+              {
+                XDMFFile file(comm, dir + "/function-hdf5.xdmf");
+                file.write(u, hdf5);
+              }, true);
+  bench_write(b, comm, p + "xdmf-ascii-function-write", dir, "function-ascii",
+              [&]()
+              {
+                XDMFFile file(comm, dir + "/function-ascii.xdmf");
+                file.write(u, ascii);
+              }, true);
+
+  // Function checkpoint (dofs, for reading back)
+  const double checkpoint_bytes
+    = bench_write(b, comm, p + "xdmf-hdf5-checkpoint-write", dir,
+                  "checkpoint",
+                  [&]()
+                  {
+                    XDMFFile file(comm, dir + "/checkpoint.xdmf");
+                    file.write_checkpoint(u, "u", 0.0, hdf5);
+                  }, true);
+  bench_read(b, p + "xdmf-hdf5-checkpoint-read", checkpoint_bytes,
+             [&]()
+             {
+               XDMFFile file(comm, dir + "/checkpoint.xdmf");
+               Function v(V);
+               file.read_checkpoint(v, "u");
+             });
+
+  // Mesh function
+  const double mf_bytes
+    = bench_write(b, comm, p + "xdmf-hdf5-meshfunction-write", dir,
+                  "meshfunction-hdf5",
+                  [&]()
+                  {
+                    XDMFFile file(comm, dir + "/meshfunction-hdf5.xdmf");
+                    file.write(cell_function, hdf5);
+                  }, true);
+  bench_write(b, comm, p + "xdmf-ascii-meshfunction-write", dir,
+              "meshfunction-ascii",
+              [&]()
+              {
+                XDMFFile file(comm, dir + "/meshfunction-ascii.xdmf");
+                file.write(cell_function, ascii);
+              }, true);
+  bench_read(b, p + "xdmf-hdf5-meshfunction-read", mf_bytes,
+             [&]()
+             {
+               XDMFFile file(comm, dir + "/meshfunction-hdf5.xdmf");
+               MeshFunction<std::size_t> mf(mesh, tdim);
+               file.read(mf, "cells");
+             });
+
+  // HDF5File mesh and function
+  const double h5_bytes
+    = bench_write(b, comm, p + "hdf5-write", dir, "hdf5file",
+                  [&]()
+                  {
+                    HDF5File file(comm, dir + "/hdf5file.h5", "w");
+                    file.write(*mesh, "/mesh");
+                    file.write(u, "/u");
+                  }, false);
+  bench_read(b, p + "hdf5-read", h5_bytes,
+             [&]()
+             {
+               HDF5File file(comm, dir + "/hdf5file.h5", "r");
+               Mesh m(comm);
+               file.read(m, "/mesh", false);
+               Function v(V);
+               file.read(v, "/u");
+             });
+
+  // VTK function
+  bench_write(b, comm, p + "vtk-ascii-function-write", dir, "vtk-ascii",
+              [&]()
+              {
+                File file(comm, dir + "/vtk-ascii.pvd", "ascii");
+                file << u;
+              }, false);
+  bench_write(b, comm, p + "vtk-compressed-function-write", dir,
+              "vtk-compressed",
+              [&]()
+              {
+                File file(comm, dir + "/vtk-compressed.pvd", "compressed");
+                file << u;
+              }, false);
+
+  // Time series, including the XML update of each step
+  bench_write(b, comm, p + "xdmf-hdf5-series-write", dir, "series-hdf5",
+              [&]()
+              {
+                XDMFFile file(comm, dir + "/series-hdf5.xdmf");
+                for (std::size_t i = 0; i < steps; ++i)
+                  file.write(*series[i], (double) i, hdf5);
+                file.close();
+              }, true, steps);
+  bench_write(b, comm, p + "xdmf-ascii-series-write", dir, "series-ascii",
+              [&]()
+              {
+                XDMFFile file(comm, dir + "/series-ascii.xdmf");
+                for (std::size_t i = 0; i < steps; ++i)
+                  file.write(*series[i], (double) i, ascii);
+                file.close();
+              }, true, steps);
+  bench_write(b, comm, p + "vtk-series-write", dir, "series-vtk",
+              [&]()
+              {
+                File file(comm, dir + "/series-vtk.pvd", "compressed");
+                for (std::size_t i = 0; i < steps; ++i)
+                  file << std::pair<const Function*, double>(series[i].get(),
+                                                             (double) i);
+              }, false, steps);
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  // Parse problem size before handing the rest to the harness
+  std::size_t size = 32;
+  std::size_t steps = 20;
+  std::vector<char*> args(1, argv[0]);
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "--size" && i + 1 < argc)
+      size = std::atol(argv[++i]);
+    else if (arg == "--steps" && i + 1 < argc)
+      steps = std::atol(argv[++i]);
+    else
+      args.push_back(argv[i]);
+  }
+
+  if (size == 0 or steps == 0)
+  {
+    std::cout << "Usage: bench [--size n] [--steps n] "
+              << "[--reps n] [--warmup n] [--json file]" << std::endl;
+    exit(1);
+  }
+
+  info("I/O throughput on UnitCubeMesh(%d, %d, %d)", size, size, size);
+
+  if (!has_hdf5())
+  {
+    info("DOLFIN has not been configured with HDF5, skipping benchmark");
+    return 0;
+  }
+
+  bench::Benchmark b("io-throughput", args.size(), args.data(), 3);
+  b.set("size", std::to_string(size));
+  b.set("steps", std::to_string(steps));
+
+  // Ghost modes only differ in parallel
+  std::vector<std::string> ghost_modes = {"none"};
+  if (dolfin::MPI::size(MPI_COMM_WORLD) > 1)
+  {
+    ghost_modes.push_back("shared_facet");
+    ghost_modes.push_back("shared_vertex");
+  }
+  for (auto& ghost_mode : ghost_modes)
+    bench_ghost_mode(b, ghost_mode, size, steps);
+
+  b.write();
+
+  return 0;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,94 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Strong scaling of standard and pipelined Krylov methods for
+// Poisson's equation. Run with a fixed mesh size for an increasing
+// number of processes, e.g.
+//
+//   mpirun -np 64 ./bench_la_krylov_pipelined_cpp 64
+
+#include <cstdlib>
+#include <dolfin.h>
+#include "Poisson.h"
+
+using namespace dolfin;
+
+int main(int argc, char* argv[])
+{
+  #ifdef HAS_PETSC
+
+  parameters["linear_algebra_backend"] = "PETSc";
+
+  // Mesh size (fixed for strong scaling)
+  const std::size_t n = argc > 1 ? atoi(argv[1]) : 32;
+
+  // Create mesh and function space
+  auto mesh = std::make_shared<UnitCubeMesh>(n, n, n);
+  auto V = std::make_shared<const Poisson::FunctionSpace>(mesh);
+  const MPI_Comm comm = mesh->mpi_comm();
+
+  // Assemble system
+  auto u0 = std::make_shared<const Constant>(0.0);
+  auto boundary = std::make_shared<const DomainBoundary>();
+  auto bc = std::make_shared<const DirichletBC>(V, u0, boundary);
+  Poisson::BilinearForm a(V, V);
+  Poisson::LinearForm L(V);
+  L.f = std::make_shared<Constant>(1.0);
+  PETScMatrix A;
+  PETScVector b;
+  assemble_system(A, b, a, L, {bc});
+
+  if (dolfin::MPI::rank(comm) == 0)
+  {
+    info("Solving system of size %ld on %d processes", A.size(0),
+         dolfin::MPI::size(comm));
+  }
+
+  // Standard methods and their pipelined variants
+  std::vector<std::string> methods = {"cg", "pipecg", "gmres", "pgmres"};
+  if (PETScKrylovSolver::methods().count("pipegcr") == 1)
+    methods.push_back("pipegcr");
+
+  for (auto method : methods)
+  {
+    PETScKrylovSolver solver(comm, method, "jacobi");
+    solver.parameters["relative_tolerance"] = 1.0e-8;
+    solver.parameters["maximum_iterations"] = 10000;
+    solver.set_operator(A);
+
+    PETScVector x;
+    A.init_vector(x, 1);
+
+    // Solve linear system
+    dolfin::MPI::barrier(comm);
+    double t = time();
+    const std::size_t num_iterations = solver.solve(x, b);
+    dolfin::MPI::barrier(comm);
+    t = time() - t;
+    if (dolfin::MPI::rank(comm) == 0)
+    {
+      info("BENCH %s: %ld iterations, %.5g s (%.5g s per iteration)",
+           method.c_str(), num_iterations, t, t/num_iterations);
+    }
+  }
+
+  #else
+  error("This benchmark requires PETSc.");
+  #endif
+
+  return 0;
+}
@@ -21,27 +21,42 @@
 // Last changed: 2010-05-03
 
 #include <dolfin.h>
+#include <Benchmark.h>
 
 using namespace dolfin;
 
 #define SIZE 10000000
-#define NUM_REPS 100
+#define NUM_REPS 10
 
 int main(int argc, char* argv[])
 {
   info("Accessing vector of size %d (%d repetitions)",
        SIZE, NUM_REPS);
 
-  parameters.parse(argc, argv);
+  bench::Benchmark b("la-vector-access", argc, argv, NUM_REPS);
 
   Vector x(MPI_COMM_WORLD, SIZE);
   x.zero();
 
   double sum = 0.0;
-  for (unsigned int i = 0; i < NUM_REPS; i++)
-    for (unsigned int j = 0; j < SIZE; j++)
-      sum += x[j];
+  b.run("access", [&]()
+        {
+          for (unsigned int j = 0; j < SIZE; j++)
+            sum += x[j];
+        });
   dolfin::cout << "Sum is " << sum << dolfin::endl;
 
+  sum = 0.0;
+  b.run("local-array", [&]()
+        {
+          const Vector& y = x;
+          const LocalVectorArray<const double> values(y);
+          for (std::size_t j = 0; j < values.size(); j++)
+            sum += values[j];
+        });
+  dolfin::cout << "Sum is " << sum << dolfin::endl;
+
+  b.write();
+
   return 0;
 }
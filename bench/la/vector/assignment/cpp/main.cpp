@@ -21,10 +21,11 @@
 // Last changed: 2010-05-03
 
 #include <dolfin.h>
+#include <Benchmark.h>
 
 using namespace dolfin;
 
-#define NUM_REPS 100
+#define NUM_REPS 10
 #define SIZE 10000000
 
 int main(int argc, char* argv[])
@@ -32,13 +33,17 @@ int main(int argc, char* argv[])
   info("Assigning to vector of size %d (%d repetitions)",
        SIZE, NUM_REPS);
 
-  parameters.parse(argc, argv);
+  bench::Benchmark b("la-vector-assignment", argc, argv, NUM_REPS);
 
   Vector x(MPI_COMM_WORLD, SIZE);
 
-  for (unsigned int i = 0; i < NUM_REPS; i++)
-    for (unsigned int j = 0; j < SIZE; j++)
-      x.setitem(j, 1.0);
+  b.run("assignment", [&]()
+        {
+          for (unsigned int j = 0; j < SIZE; j++)
+            x.setitem(j, 1.0);
+        });
+
+  b.write();
 
   return 0;
 }
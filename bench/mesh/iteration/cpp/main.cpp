@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2006-11-01
-// Last changed: 2012-12-12
+// Last changed: 2017-10-14
 
 #include <dolfin.h>
 
@@ -34,6 +34,7 @@ int main(int argc, char* argv[])
 
   UnitCubeMesh mesh(SIZE, SIZE, SIZE);
 
+  // Iterate using mesh entity iterators
   std::size_t sum = 0;
   tic();
   for (int i = 0; i < NUM_REPS; i++)
@@ -44,8 +45,52 @@ int main(int argc, char* argv[])
   }
   info("BENCH %g", toc());
 
-  // To prevent optimizing the loop away
-  info("Sum is %llu", (unsigned long long)sum);
+  // Iterate using contiguous cell-vertex view
+  std::size_t sum_view = 0;
+  const CellVertexView view(mesh);
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    for (std::size_t c = 0; c < view.ghost_offset(); ++c)
+    {
+      const ArrayView<const unsigned int> vertices = view.vertices(c);
+      for (std::size_t j = 0; j < vertices.size(); ++j)
+        sum_view += vertices[j];
+    }
+  }
+  info("BENCH view %g", toc());
+
+  // Gather coordinate dofs using cell iterators
+  double xsum = 0.0;
+  std::vector<double> coordinate_dofs;
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    for (CellIterator c(mesh); !c.end(); ++c)
+    {
+      c->get_coordinate_dofs(coordinate_dofs);
+      xsum += coordinate_dofs[0];
+    }
+  }
+  info("BENCH coordinates %g", toc());
+
+  // Gather coordinate dofs using contiguous cell-vertex view
+  double xsum_view = 0.0;
+  tic();
+  for (int i = 0; i < NUM_REPS; i++)
+  {
+    for (std::size_t c = 0; c < view.ghost_offset(); ++c)
+    {
+      view.get_coordinate_dofs(c, coordinate_dofs.data());
+      xsum_view += coordinate_dofs[0];
+    }
+  }
+  info("BENCH coordinates-view %g", toc());
+
+  // To prevent optimizing the loops away
+  info("Sum is %llu (%llu)", (unsigned long long)sum,
+       (unsigned long long)sum_view);
+  info("Coordinate sum is %g (%g)", xsum, xsum_view);
 
   return 0;
 }
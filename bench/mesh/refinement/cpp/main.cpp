@@ -19,6 +19,7 @@
 // Last changed: 2012-12-12
 
 #include <dolfin.h>
+#include <dolfin/refinement/ParallelRefinement.h>
 
 using namespace dolfin;
 
@@ -43,5 +44,11 @@ int main(int argc, char* argv[])
   }
   info("BENCH %g", toc());
 
+  // Report communication volume of edge marker and vertex exchanges
+  const std::size_t volume
+    = dolfin::MPI::sum(mesh.mpi_comm(),
+                       ParallelRefinement::communication_volume());
+  info("Communication volume: %ld bytes", (long) volume);
+
   return 0;
 }
@@ -16,10 +16,10 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2010-11-25
-// Last changed: 2012-12-12
+// Last changed: 2017-10-14
 
 #include <dolfin.h>
-#include <dolfin/log/LogLevel.h>
+#include <Benchmark.h>
 
 using namespace dolfin;
 
@@ -32,34 +32,22 @@ using namespace dolfin;
 
 int main(int argc, char* argv[])
 {
-  info("Creating cell-cell connectivity for unit cube of size %d x %d x %d (%d repetitions)",
+  info("Creating cell-cell connectivity, facets and edges for unit cube of size %d x %d x %d (%d repetitions)",
        SIZE, SIZE, SIZE, NUM_REPS);
 
-  set_log_level(DBG);
-
-  parameters.parse(argc, argv);
+  bench::Benchmark b("mesh-topology", argc, argv, NUM_REPS);
 
   UnitCubeMesh mesh(SIZE, SIZE, SIZE);
   const int D = mesh.topology().dim();
 
-  // Clear timing (if there is some)
-  { Timer t("Compute connectivity 3-3"); }
-  timing("Compute connectivity 3-3", TimingClear::clear);
-
-  for (int i = 0; i < NUM_REPS; i++)
-  {
-    mesh.clean();
-    mesh.init(D, D);
-    dolfin::cout << "Created unit cube: " << mesh << dolfin::endl;
-  }
-
-  // Report timings
-  list_timings(TimingClear::keep,
-               { TimingType::wall, TimingType::user, TimingType::system });
+  // Time each computation from a clean mesh (use parameter
+  // "num_threads" to compute facets and edges with multiple threads)
+  b.run("connectivity_3_3", [&](){ mesh.clean(); },
+        [&](){ mesh.init(D, D); });
+  b.run("facets", [&](){ mesh.clean(); }, [&](){ mesh.init(2); });
+  b.run("edges", [&](){ mesh.clean(); }, [&](){ mesh.init(1); });
 
-  // Report timing
-  const auto t = timing("Compute connectivity 3-3", TimingClear::clear);
-  info("BENCH %g", std::get<1>(t));
+  b.write();
 
   return 0;
 }
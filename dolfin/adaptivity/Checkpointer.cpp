@@ -0,0 +1,236 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <sstream>
+#include <dolfin/function/Function.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include "Checkpointer.h"
+
+#ifdef HAS_HDF5
+#include <dolfin/io/HDF5File.h>
+#include <dolfin/io/HDF5Interface.h>
+#endif
+
+using namespace dolfin;
+
+namespace
+{
+  // Dataset for disk checkpoints (one row per checkpoint)
+  const std::string checkpoint_dataset_name = "/Checkpoints/values";
+}
+
+//-----------------------------------------------------------------------------
+Checkpointer::Checkpointer(MPI_Comm mpi_comm, std::size_t num_steps,
+                           std::size_t num_memory_checkpoints,
+                           std::size_t num_disk_checkpoints,
+                           std::string filename)
+  : _mpi_comm(mpi_comm), _num_memory_checkpoints(num_memory_checkpoints),
+    _num_disk_checkpoints(num_disk_checkpoints), _capo(0), _fine(num_steps),
+    _check(-1), _first(true), _current_step(0), _num_forward_steps(0),
+    _memory(num_memory_checkpoints), _filename(filename)
+{
+  if (num_steps > 0 && num_memory_checkpoints + num_disk_checkpoints == 0)
+  {
+    dolfin_error("Checkpointer.cpp",
+                 "create checkpointing schedule",
+                 "At least one checkpoint is required");
+  }
+
+#ifndef HAS_HDF5
+  if (num_disk_checkpoints > 0)
+  {
+    dolfin_error("Checkpointer.cpp",
+                 "create checkpointing schedule",
+                 "Disk checkpoints require DOLFIN to be configured with HDF5");
+  }
+#endif
+
+  _checkpoint_steps.resize(num_memory_checkpoints + num_disk_checkpoints);
+}
+//-----------------------------------------------------------------------------
+Checkpointer::~Checkpointer()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+Checkpointer::Action Checkpointer::next()
+{
+  // This follows the reference implementation of revolve (Griewank
+  // and Walther, ACM TOMS 26, 2000) for a known number of steps
+  const int num_checkpoints = _checkpoint_steps.size();
+
+  // All steps have been reversed; restore the last checkpoint or
+  // finish
+  if (_fine == _capo)
+  {
+    if (_check == -1 || _capo == _checkpoint_steps[0])
+      return Action::terminate;
+
+    _capo = _checkpoint_steps[_check];
+    _current_step = _capo;
+    return Action::restore;
+  }
+
+  // Combined forward and adjoint step
+  if (_fine - _capo == 1)
+  {
+    _fine -= 1;
+    _current_step = _capo;
+    if (_check >= 0 && _checkpoint_steps[_check] == _capo)
+      _check -= 1;
+
+    if (_first)
+    {
+      _first = false;
+      return Action::first_adjoint;
+    }
+    return Action::adjoint;
+  }
+
+  // Store current state if not already stored
+  if (_check == -1 || _checkpoint_steps[_check] != _capo)
+  {
+    _check += 1;
+    if (_check >= num_checkpoints)
+    {
+      dolfin_error("Checkpointer.cpp",
+                   "compute checkpointing schedule",
+                   "Number of checkpoints exceeded");
+    }
+    _checkpoint_steps[_check] = _capo;
+    _current_step = _capo;
+    return Action::store;
+  }
+
+  // Advance to the optimal step for the next checkpoint, given the
+  // number of free checkpoints (ds) and the number of repetitions
+  // (reps) needed for the remaining range of steps
+  const int old_capo = _capo;
+  const int ds = num_checkpoints - _check;
+  dolfin_assert(ds >= 1);
+  int reps = 0;
+  int range = 1;
+  while (range < _fine - _capo)
+  {
+    reps += 1;
+    range = range*(reps + ds)/reps;
+  }
+
+  const int bino1 = range*reps/(ds + reps);
+  const int bino2 = (ds > 1) ? bino1*ds/(ds + reps - 1) : 1;
+  const int bino3 = (ds == 1) ? 0
+    : ((ds > 2) ? bino2*(ds - 1)/(ds + reps - 2) : 1);
+  const int bino4 = bino2*(reps - 1)/ds;
+  const int bino5 = (ds < 3) ? 0 : ((ds > 3) ? bino3*(ds - 2)/reps : 1);
+
+  if (_fine - _capo <= bino1 + bino3)
+    _capo += bino4;
+  else if (_fine - _capo >= range - bino5)
+    _capo += bino1;
+  else
+    _capo = _fine - bino2 - bino3;
+  if (_capo == old_capo)
+    _capo = old_capo + 1;
+
+  _current_step = old_capo;
+  _num_forward_steps += _capo - old_capo;
+  return Action::advance;
+}
+//-----------------------------------------------------------------------------
+void Checkpointer::store(const GenericVector& x)
+{
+  const std::size_t c = checkpoint();
+  if (!on_disk(c))
+  {
+    std::shared_ptr<GenericVector>& y = _memory[c - _num_disk_checkpoints];
+    if (y && y->size() == x.size())
+      *y = x;
+    else
+      y = x.copy();
+    return;
+  }
+
+#ifdef HAS_HDF5
+  if (!_hdf5_file)
+    _hdf5_file.reset(new HDF5File(_mpi_comm.comm(), _filename, "w"));
+
+  std::vector<double> values;
+  x.get_local(values);
+  HDF5Interface::write_row(_hdf5_file->h5_id(), checkpoint_dataset_name, c,
+                           values.data(), x.local_range(), x.size(),
+                           _mpi_comm.size() > 1);
+#endif
+}
+//-----------------------------------------------------------------------------
+void Checkpointer::store(const Function& u)
+{
+  dolfin_assert(u.vector());
+  store(*u.vector());
+}
+//-----------------------------------------------------------------------------
+void Checkpointer::restore(GenericVector& x) const
+{
+  const std::size_t c = checkpoint();
+  if (!on_disk(c))
+  {
+    const std::shared_ptr<GenericVector>& y
+      = _memory[c - _num_disk_checkpoints];
+    dolfin_assert(y);
+    x = *y;
+    return;
+  }
+
+#ifdef HAS_HDF5
+  dolfin_assert(_hdf5_file);
+  const hid_t fid = _hdf5_file->h5_id();
+  if (x.empty())
+  {
+    const std::vector<std::int64_t> shape
+      = HDF5Interface::get_dataset_shape(fid, checkpoint_dataset_name);
+    x.init(shape[1]);
+  }
+
+  const std::pair<std::int64_t, std::int64_t> range = x.local_range();
+  std::vector<double> values(range.second - range.first);
+  HDF5Interface::read_row(fid, checkpoint_dataset_name, c, range,
+                          values.data(), _mpi_comm.size() > 1);
+  x.set_local(values);
+  x.apply("insert");
+#endif
+}
+//-----------------------------------------------------------------------------
+void Checkpointer::restore(Function& u) const
+{
+  dolfin_assert(u.vector());
+  restore(*u.vector());
+}
+//-----------------------------------------------------------------------------
+std::string Checkpointer::str(bool verbose) const
+{
+  std::stringstream s;
+  s << "<Checkpointer with " << _num_memory_checkpoints
+    << " memory and " << _num_disk_checkpoints << " disk checkpoint(s)>";
+  if (verbose)
+  {
+    s << std::endl << std::endl
+      << "  Current step:   " << _current_step << std::endl
+      << "  Forward steps:  " << _num_forward_steps << std::endl;
+  }
+  return s.str();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,163 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CHECKPOINTER_H
+#define __CHECKPOINTER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Variable.h>
+#include <dolfin/log/log.h>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Function;
+  class GenericVector;
+  class HDF5File;
+
+  /// This class schedules the storage and recomputation of forward
+  /// states for adjoint (reverse) sweeps over a time loop, using
+  /// binomial checkpointing (the "revolve" algorithm of Griewank and
+  /// Walther). For a given number of checkpoints, the schedule
+  /// minimises the number of recomputed forward steps, so that the
+  /// adjoint sweep runs within a fixed memory budget.
+  ///
+  /// Checkpoints are kept in memory or, for the given number of disk
+  /// checkpoints, in an HDF5 file. Disk checkpoints are used for the
+  /// longest lived states, which are restored least often.
+  ///
+  /// The caller repeatedly asks for the next action and performs it:
+  ///
+  ///   advance:       advance the forward state from current_step()
+  ///                  to target_step()
+  ///   store:         store the forward state at current_step()
+  ///   restore:       restore the forward state at current_step()
+  ///   first_adjoint,
+  ///   adjoint:       with the forward state at current_step(), take
+  ///                  the forward step to current_step() + 1 and the
+  ///                  adjoint step back to current_step()
+  ///   terminate:     the adjoint sweep is complete
+
+  class Checkpointer : public Variable
+  {
+  public:
+
+    /// Actions of the checkpointing schedule
+    enum class Action { advance, store, restore, first_adjoint, adjoint,
+                        terminate };
+
+    /// Create checkpointing schedule
+    ///
+    /// *Arguments*
+    ///     mpi_comm (MPI_Comm)
+    ///         An MPI communicator
+    ///     num_steps (std::size_t)
+    ///         The number of time steps
+    ///     num_memory_checkpoints (std::size_t)
+    ///         The number of checkpoints kept in memory
+    ///     num_disk_checkpoints (std::size_t)
+    ///         The number of checkpoints kept on disk
+    ///     filename (std::string)
+    ///         The HDF5 file for disk checkpoints
+    Checkpointer(MPI_Comm mpi_comm, std::size_t num_steps,
+                 std::size_t num_memory_checkpoints,
+                 std::size_t num_disk_checkpoints=0,
+                 std::string filename="checkpoints.h5");
+
+    /// Destructor
+    ~Checkpointer();
+
+    /// Return next action of schedule
+    Action next();
+
+    /// Return time step of forward state for the current action
+    std::size_t current_step() const
+    { return _current_step; }
+
+    /// Return time step to advance the forward state to (for
+    /// Action::advance)
+    std::size_t target_step() const
+    { return _capo; }
+
+    /// Return checkpoint used by the current store or restore action
+    std::size_t checkpoint() const
+    { dolfin_assert(_check >= 0); return _check; }
+
+    /// Return true if given checkpoint is kept on disk
+    bool on_disk(std::size_t checkpoint) const
+    { return checkpoint < _num_disk_checkpoints; }
+
+    /// Return number of forward steps taken by advance actions so far
+    std::size_t num_forward_steps() const
+    { return _num_forward_steps; }
+
+    /// Store vector in current checkpoint (for Action::store)
+    void store(const GenericVector& x);
+
+    /// Store function in current checkpoint (for Action::store)
+    void store(const Function& u);
+
+    /// Restore vector from current checkpoint (for Action::restore)
+    void restore(GenericVector& x) const;
+
+    /// Restore function from current checkpoint (for Action::restore)
+    void restore(Function& u) const;
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // MPI communicator
+    MPI::Comm _mpi_comm;
+
+    // Number of checkpoints
+    std::size_t _num_memory_checkpoints, _num_disk_checkpoints;
+
+    // Schedule state: current step (capo), last step not yet
+    // reversed (fine), current checkpoint (check) and steps of
+    // stored checkpoints
+    int _capo, _fine, _check;
+    std::vector<int> _checkpoint_steps;
+
+    // True until the first adjoint step
+    bool _first;
+
+    // Step of forward state for current action
+    std::size_t _current_step;
+
+    // Number of forward steps taken by advance actions
+    std::size_t _num_forward_steps;
+
+    // Memory checkpoints
+    std::vector<std::shared_ptr<GenericVector>> _memory;
+
+    // Disk checkpoints (one row per checkpoint)
+    std::string _filename;
+#ifdef HAS_HDF5
+    std::unique_ptr<HDF5File> _hdf5_file;
+#endif
+
+  };
+
+}
+
+#endif
@@ -20,6 +20,7 @@
 // First added:  2010-09-16
 // Last changed: 2011-03-23
 
+#include <limits>
 #include <memory>
 
 #include <dolfin/common/types.h>
@@ -46,6 +47,7 @@
 #include <dolfin/la/solve.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Facet.h>
+#include <dolfin/mesh/Mesh.h>
 
 #include "ErrorControl.h"
 
@@ -74,6 +76,11 @@ ErrorControl::ErrorControl(std::shared_ptr<Form> a_star,
   _eta_T = eta_T;
   _is_linear = is_linear;
 
+  // No local factorizations computed yet
+  const std::size_t none = std::numeric_limits<std::size_t>::max();
+  _cell_lu_state = std::make_pair(none, none);
+  _facet_lu_state = std::make_pair(none, none);
+
   // Extract and store additional function spaces
   const std::size_t improved_dual = _residual->num_coefficients() - 1;
   const Function& e_tmp = dynamic_cast<const Function&>(*_residual->coefficient(improved_dual));
@@ -93,16 +100,27 @@ ErrorControl::ErrorControl(std::shared_ptr<Form> a_star,
   parameters = default_parameters();
 }
 //-----------------------------------------------------------------------------
+namespace
+{
+  // State of mesh geometry and topology, used to decide whether local
+  // factorizations are still valid
+  std::pair<std::size_t, std::size_t> mesh_state(const dolfin::Mesh& mesh)
+  {
+    return std::make_pair(mesh.geometry().state(), mesh.topology().state());
+  }
+}
+//-----------------------------------------------------------------------------
 double ErrorControl::estimate_error(const Function& u,
   const std::vector<std::shared_ptr<const DirichletBC>> bcs)
 {
   // Compute discrete dual approximation
   dolfin_assert(_a_star);
-  Function z_h(_a_star->function_space(1));
-  compute_dual(z_h, bcs);
+  if (!_z_h)
+    _z_h = std::make_shared<Function>(_a_star->function_space(1));
+  compute_dual(*_z_h, bcs);
 
   // Compute extrapolation of discrete dual
-  compute_extrapolation(z_h, bcs);
+  compute_extrapolation(*_z_h, bcs);
 
   // Extract number of coefficients in residual
   dolfin_assert(_residual);
@@ -132,30 +150,43 @@ void ErrorControl::compute_dual(
 {
   log(PROGRESS, "Solving dual problem.");
 
-  // Create dual boundary conditions by homogenizing
-  std::vector<std::shared_ptr<const DirichletBC>> dual_bcs;
-  for (std::size_t i = 0; i < bcs.size(); i++)
+  // Keep the dual problem and solver (and hence the dual matrix and
+  // any factorization or preconditioner, see "reuse_policy") from
+  // the previous call if solving for the same function with the same
+  // boundary conditions
+  if (!_dual_solver or _dual_problem->solution().get() != &z
+      or _dual_bcs_source != bcs)
   {
-    dolfin_assert(bcs[i]);
+    // Create dual boundary conditions by homogenizing
+    std::vector<std::shared_ptr<const DirichletBC>> dual_bcs;
+    for (std::size_t i = 0; i < bcs.size(); i++)
+    {
+      dolfin_assert(bcs[i]);
 
-    // Create shared_ptr to boundary condition
-    auto dual_bc_ptr = std::make_shared<DirichletBC>(*bcs[i]);
+      // Create shared_ptr to boundary condition
+      auto dual_bc_ptr = std::make_shared<DirichletBC>(*bcs[i]);
 
-    // Run homogenize
-    dual_bc_ptr->homogenize();
+      // Run homogenize
+      dual_bc_ptr->homogenize();
 
-    // Plug pointer into into vector
-    dual_bcs.push_back(dual_bc_ptr);
-  }
+      // Plug pointer into into vector
+      dual_bcs.push_back(dual_bc_ptr);
+    }
+
+    // Create shared_ptr to dual solution (FIXME: missing interface ...)
+    auto dual = reference_to_no_delete_pointer(z);
 
-  // Create shared_ptr to dual solution (FIXME: missing interface ...)
-  auto dual = reference_to_no_delete_pointer(z);
+    // Create dual problem and solver
+    _dual_problem = std::make_shared<LinearVariationalProblem>(_a_star,
+                                                               _L_star, dual,
+                                                               dual_bcs);
+    _dual_solver.reset(new LinearVariationalSolver(_dual_problem));
+    _dual_bcs_source = bcs;
+  }
 
   // Solve dual problem
-  LinearVariationalProblem dual_problem(_a_star, _L_star, dual, dual_bcs);
-  LinearVariationalSolver solver(reference_to_no_delete_pointer(dual_problem));
-  solver.parameters.update(parameters("dual_variational_solver"));
-  solver.solve();
+  _dual_solver->parameters.update(parameters("dual_variational_solver"));
+  _dual_solver->solve();
 }
 //-----------------------------------------------------------------------------
 void ErrorControl::compute_extrapolation(
@@ -167,7 +198,7 @@ void ErrorControl::compute_extrapolation(
   // Extrapolate
   dolfin_assert(_extrapolation_space);
   _Ez_h = std::make_shared<Function>(_extrapolation_space);
-  _Ez_h->extrapolate(z);
+  _extrapolation.compute(*_Ez_h, z);
 
   // Apply appropriate boundary conditions to extrapolation
   apply_bcs_to_extrapolation(bcs);
@@ -292,10 +323,22 @@ void ErrorControl::compute_cell_residual(Function& R_T, const Function& u)
   // Define matrices for cell-residual problems
   dolfin_assert(V.element());
   const std::size_t N = V.element()->space_dimension();
-  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
-                Eigen::RowMajor> A(N, N), b(N, 1);
+  LocalMatrix A(N, N), b(N, 1);
   Eigen::VectorXd x(N);
 
+  // The left-hand side depends only on the mesh (through the cell
+  // bubble) unless it has further coefficients, in which case the
+  // local factorizations are kept and reused while the mesh is
+  // unchanged
+  const bool keep_lu = (_a_R_T->num_coefficients() == 1);
+  const std::pair<std::size_t, std::size_t> state = mesh_state(mesh);
+  const bool reuse_lu = keep_lu and _cell_lu_state == state
+    and _cell_lu.size() == mesh.num_cells();
+  if (keep_lu)
+    _cell_lu.resize(mesh.num_cells());
+  else
+    _cell_lu.clear();
+
   // Extract cell_domains etc from right-hand side form
   const MeshFunction<std::size_t>*
     cell_domains = _L_R_T->cell_domains().get();
@@ -312,16 +355,28 @@ void ErrorControl::compute_cell_residual(Function& R_T, const Function& u)
     // Get cell vertices
     cell->get_coordinate_dofs(coordinate_dofs);
 
-    // Assemble local linear system
-    LocalAssembler::assemble(A, ufc_lhs, coordinate_dofs,
-                             ufc_cell, *cell, cell_domains,
-                             exterior_facet_domains, interior_facet_domains);
+    // Assemble local linear system (left-hand side only if not
+    // already factorized)
+    if (!reuse_lu)
+    {
+      LocalAssembler::assemble(A, ufc_lhs, coordinate_dofs,
+                               ufc_cell, *cell, cell_domains,
+                               exterior_facet_domains, interior_facet_domains);
+    }
     LocalAssembler::assemble(b, ufc_rhs, coordinate_dofs, ufc_cell,
                              *cell, cell_domains,
                              exterior_facet_domains, interior_facet_domains);
 
     // Solve linear system and convert result
-    x = A.partialPivLu().solve(b);
+    if (!keep_lu)
+      x = A.partialPivLu().solve(b);
+    else
+    {
+      Eigen::PartialPivLU<LocalMatrix>& lu = _cell_lu[cell->index()];
+      if (!reuse_lu)
+        lu.compute(A);
+      x = lu.solve(b);
+    }
 
     // Get local-to-global dof map for cell
     auto dofs = dofmap.cell_dofs(cell->index());
@@ -330,6 +385,11 @@ void ErrorControl::compute_cell_residual(Function& R_T, const Function& u)
     dolfin_assert(R_T.vector());
     R_T.vector()->set(x.data(), N, dofs.data());
   }
+
+  // Record mesh state for the local factorizations
+  if (keep_lu)
+    _cell_lu_state = state;
+
   end();
 }
 //-----------------------------------------------------------------------------
@@ -376,12 +436,31 @@ void ErrorControl::compute_facet_residual(SpecialFacetFunction& R_dT,
   const GenericDofMap& dofmap = *V.dofmap();
 
   // Define matrices for facet-residual problems
-  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
-                Eigen::RowMajor> A(N, N), b(N, 1);
+  LocalMatrix A(N, N), b(N, 1);
   Eigen::VectorXd x(N);
 
   // Variables to be used for the construction of the cone function
   const std::size_t num_cells = mesh.num_cells();
+
+  // Keep and reuse the local factorizations while the mesh is
+  // unchanged if the left-hand side depends only on the cell cone
+  // (see compute_cell_residual)
+  dolfin_assert(_a_R_dT);
+  const bool keep_lu = (_a_R_dT->num_coefficients() == 1);
+  const std::pair<std::size_t, std::size_t> state = mesh_state(mesh);
+  const std::size_t num_systems = (dim + 1)*num_cells;
+  const bool reuse_lu = keep_lu and _facet_lu_state == state
+    and _facet_lu.size() == num_systems;
+  if (keep_lu)
+  {
+    _facet_lu.resize(num_systems);
+    _facet_singular_dofs.resize(num_systems);
+  }
+  else
+  {
+    _facet_lu.clear();
+    _facet_singular_dofs.clear();
+  }
   const std::vector<double> ones(num_cells, 1.0);
   std::vector<dolfin::la_index> facet_dofs(num_cells);
 
@@ -394,7 +473,6 @@ void ErrorControl::compute_facet_residual(SpecialFacetFunction& R_dT,
   const MeshFunction<std::size_t>*
     interior_facet_domains = _L_R_T->interior_facet_domains().get();
 
-  dolfin_assert(_a_R_dT);
   // Compute the facet residual for each local facet number
   for (int local_facet = 0; local_facet <= dim; local_facet++)
   {
@@ -429,26 +507,51 @@ void ErrorControl::compute_facet_residual(SpecialFacetFunction& R_dT,
       // Get cell coordinate_dofs
       cell->get_coordinate_dofs(coordinate_dofs);
 
-      // Assemble linear system
-      LocalAssembler::assemble(A, ufc_lhs, coordinate_dofs,
-                               ufc_cell, *cell, cell_domains,
-                               exterior_facet_domains, interior_facet_domains);
+      // Assemble right-hand side
       LocalAssembler::assemble(b, ufc_rhs, coordinate_dofs,
                                ufc_cell, *cell, cell_domains,
                                exterior_facet_domains, interior_facet_domains);
 
-      // Non-singularize local matrix
-      for (std::size_t i = 0; i < N; ++i)
+      if (reuse_lu)
+      {
+        // Reuse factorization computed for the current mesh
+        const std::size_t k = local_facet*num_cells + cell->index();
+        const std::vector<std::size_t>& singular = _facet_singular_dofs[k];
+        for (std::size_t i = 0; i < singular.size(); ++i)
+          b(singular[i]) = 0.0;
+        x = _facet_lu[k].solve(b);
+      }
+      else
       {
-        if (std::abs(A(i, i)) < 1.0e-10)
+        // Assemble left-hand side
+        LocalAssembler::assemble(A, ufc_lhs, coordinate_dofs,
+                                 ufc_cell, *cell, cell_domains,
+                                 exterior_facet_domains,
+                                 interior_facet_domains);
+
+        // Non-singularize local matrix
+        std::vector<std::size_t> singular;
+        for (std::size_t i = 0; i < N; ++i)
         {
-          A(i, i) = 1.0;
-          b(i) = 0.0;
+          if (std::abs(A(i, i)) < 1.0e-10)
+          {
+            A(i, i) = 1.0;
+            b(i) = 0.0;
+            singular.push_back(i);
+          }
         }
-      }
 
-      // Solve linear system and convert result
-      x = A.partialPivLu().solve(b);
+        // Solve linear system and convert result
+        if (keep_lu)
+        {
+          const std::size_t k = local_facet*num_cells + cell->index();
+          _facet_lu[k].compute(A);
+          _facet_singular_dofs[k] = singular;
+          x = _facet_lu[k].solve(b);
+        }
+        else
+          x = A.partialPivLu().solve(b);
+      }
 
       // Get local-to-global dof map for cell
       auto dofs = dofmap.cell_dofs(cell->index());
@@ -458,6 +561,11 @@ void ErrorControl::compute_facet_residual(SpecialFacetFunction& R_dT,
       R_dT[local_facet].vector()->set(x.data(), N, dofs.data());
     }
   }
+
+  // Record mesh state for the local factorizations
+  if (keep_lu)
+    _facet_lu_state = state;
+
   end();
 }
 //-----------------------------------------------------------------------------
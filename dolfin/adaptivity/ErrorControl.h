@@ -21,13 +21,17 @@
 #ifndef __ERROR_CONTROL_H
 #define __ERROR_CONTROL_H
 
-#include <vector>
+#include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
+#include <Eigen/Dense>
 
 #include <dolfin/common/Hierarchical.h>
 #include <dolfin/common/Variable.h>
 #include <dolfin/fem/LinearVariationalSolver.h>
 #include "adapt.h"
+#include "Extrapolation.h"
 
 namespace dolfin
 {
@@ -36,6 +40,7 @@ namespace dolfin
   class Form;
   class Function;
   class FunctionSpace;
+  class LinearVariationalProblem;
   class SpecialFacetFunction;
   class Vector;
 
@@ -195,6 +200,10 @@ namespace dolfin
 
     void apply_bcs_to_extrapolation(const std::vector<std::shared_ptr<const DirichletBC> > bcs);
 
+    // Local (dense) matrix type for the residual problems
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                          Eigen::RowMajor> LocalMatrix;
+
     // Bilinear and linear form for dual problem
     std::shared_ptr<Form> _a_star;
     std::shared_ptr<Form> _L_star;
@@ -230,6 +239,31 @@ namespace dolfin
     std::shared_ptr<Function> _R_T;
     std::shared_ptr<SpecialFacetFunction> _R_dT;
     std::shared_ptr<Function> _Pi_E_z_h;
+
+    // Discrete dual solution and dual solver, kept between calls to
+    // estimate_error together with the (primal) boundary conditions
+    // the homogenized dual boundary conditions were created from
+    std::shared_ptr<Function> _z_h;
+    std::shared_ptr<LinearVariationalProblem> _dual_problem;
+    std::unique_ptr<LinearVariationalSolver> _dual_solver;
+    std::vector<std::shared_ptr<const DirichletBC>> _dual_bcs_source;
+
+    // Factorizations of the local cell and facet residual matrices,
+    // which depend only on the mesh (through the bubble and cone
+    // functions). The facet systems are indexed by local_facet*num_cells
+    // + cell and store the dofs that were non-singularized.
+    std::vector<Eigen::PartialPivLU<LocalMatrix>> _cell_lu;
+    std::vector<Eigen::PartialPivLU<LocalMatrix>> _facet_lu;
+    std::vector<std::vector<std::size_t>> _facet_singular_dofs;
+
+    // Mesh (geometry, topology) states the cell and facet
+    // factorizations were computed for
+    std::pair<std::size_t, std::size_t> _cell_lu_state;
+    std::pair<std::size_t, std::size_t> _facet_lu_state;
+
+    // Extrapolation of the dual solution, which keeps the patch
+    // least-squares operators between calls to estimate_error
+    Extrapolation _extrapolation;
   };
 }
 
@@ -22,27 +22,70 @@
 // Last changed: 2011-11-12
 //
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
+#include <Eigen/Dense>
 #include <ufc.h>
 
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/fem/BasisFunction.h>
-#include <dolfin/fem/DirichletBC.h>
+#include <dolfin/fem/FiniteElement.h>
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/function/Function.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/log/log.h>
-#include <dolfin/mesh/BoundaryMesh.h>
 #include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Vertex.h>
-#include <dolfin/mesh/FacetCell.h>
 #include "Extrapolation.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Compute sorted cells of patch of cell (cells sharing a vertex
+  // with the cell, including the cell)
+  void compute_patch(std::vector<unsigned int>& cells, const Cell& cell)
+  {
+    cells.clear();
+    for (VertexIterator vtx(cell); !vtx.end(); ++vtx)
+    {
+      const unsigned int* vertex_cells = vtx->entities(vtx->mesh().topology().dim());
+      cells.insert(cells.end(), vertex_cells,
+                   vertex_cells + vtx->num_entities(vtx->mesh().topology().dim()));
+    }
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+  }
+}
+
+//-----------------------------------------------------------------------------
+Extrapolation::Extrapolation()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+Extrapolation::~Extrapolation()
+{
+  // Do nothing
+}
 //-----------------------------------------------------------------------------
 void Extrapolation::extrapolate(Function& w, const Function& v)
+{
+  Extrapolation extrapolation;
+  extrapolation.compute(w, v);
+}
+//-----------------------------------------------------------------------------
+void Extrapolation::clear()
+{
+  _patches.clear();
+  _state.clear();
+}
+//-----------------------------------------------------------------------------
+void Extrapolation::compute(Function& w, const Function& v)
 {
   // Using set_local for simplicity here
   not_working_in_parallel("Extrapolation of functions");
@@ -61,254 +104,280 @@ void Extrapolation::extrapolate(Function& w, const Function& v)
   dolfin_assert(V.mesh());
   const Mesh& mesh = *V.mesh();
 
-  // Initialize cell-cell connectivity
+  // Initialize connectivity used by the patches (before threads
+  // read the mesh)
   const std::size_t D = mesh.topology().dim();
   mesh.init(D, D);
+  mesh.init(0, D);
+
+  // Collect non-mixed subspaces (and subfunctions of v)
+  std::vector<const FunctionSpace*> V_sub;
+  std::vector<const FunctionSpace*> W_sub;
+  std::vector<const Function*> v_sub;
+  collect_subspaces(V_sub, W_sub, v_sub, V, W, v);
+
+  // Compute patch operators unless computed for this mesh and these
+  // spaces
+  const std::vector<std::size_t> state
+    = {mesh.id(), mesh.geometry().state(), mesh.topology().state(),
+       V.id(), W.id()};
+  if (state != _state || _patches.size() != V_sub.size())
+  {
+    Timer timer("Extrapolation: compute patch operators");
+    _state.clear();
+    _patches.clear();
+    _patches.resize(V_sub.size());
+    for (std::size_t k = 0; k < V_sub.size(); ++k)
+    {
+      build_patch_rows(_patches[k], *V_sub[k], mesh);
+      build_patch_operators(_patches[k], *V_sub[k], *W_sub[k], mesh);
+    }
+    _state = state;
+  }
 
-  // UFC cell view of center cell and vertex coordinate holder
-  ufc::cell c0;
-  std::vector<double> coordinate_dofs0;
-
-  // List of values for each dof of w (multivalued until we average)
-  std::vector<std::vector<double>> coefficients;
-  coefficients.resize(W.dim());
-
-  // Iterate over cells in mesh
+  // Offsets of coefficients of w on each cell
   dolfin_assert(W.dofmap());
-  for (CellIterator cell0(mesh); !cell0.end(); ++cell0)
+  const GenericDofMap& dofmap = *W.dofmap();
+  std::vector<std::size_t> cell_offsets(mesh.num_cells() + 1, 0);
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+    cell_offsets[c + 1] = cell_offsets[c] + dofmap.num_element_dofs(c);
+
+  // Compute coefficients of w on each cell
+  std::vector<double> cell_coefficients(cell_offsets.back());
+  std::size_t offset = 0;
+  for (std::size_t k = 0; k < _patches.size(); ++k)
   {
-    // Update UFC view
-    cell0->get_coordinate_dofs(coordinate_dofs0);
-    cell0->get_cell_data(c0);
-
-    // Tabulate dofs for w on cell and store values
-    auto dofs = W.dofmap()->cell_dofs(cell0->index());
+    apply_patch_operators(cell_coefficients, cell_offsets, offset,
+                          _patches[k], *V_sub[k], *v_sub[k], mesh);
+    offset += _patches[k].dim;
+  }
 
-    // Compute coefficients on this cell
-    std::size_t offset = 0;
-    compute_coefficients(coefficients, v, V, W, *cell0, coordinate_dofs0,
-                         c0, dofs, offset);
+  // Average coefficients of each dof over cells
+  std::vector<double> dof_values(W.dim(), 0.0);
+  std::vector<std::size_t> num_values(W.dim(), 0);
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    auto dofs = dofmap.cell_dofs(c);
+    for (std::size_t i = 0; i < cell_offsets[c + 1] - cell_offsets[c]; ++i)
+    {
+      dof_values[dofs[i]] += cell_coefficients[cell_offsets[c] + i];
+      ++num_values[dofs[i]];
+    }
   }
+  for (std::size_t i = 0; i < W.dim(); i++)
+    dof_values[i] /= static_cast<double>(num_values[i]);
 
-  // Average coefficients
-  average_coefficients(w, coefficients);
+  // Update dofs for w
+  dolfin_assert(w.vector());
+  w.vector()->set_local(dof_values);
 }
 //-----------------------------------------------------------------------------
-void Extrapolation::compute_coefficients(
-  std::vector<std::vector<double>>& coefficients,
-  const Function& v,
-  const FunctionSpace& V,
-  const FunctionSpace& W,
-  const Cell& cell0,
-  const std::vector<double>& coordinate_dofs0,
-  const ufc::cell& c0,
-  const Eigen::Ref<const Eigen::Matrix<dolfin::la_index, Eigen::Dynamic, 1>> dofs,
-  std::size_t& offset)
+void
+Extrapolation::collect_subspaces(std::vector<const FunctionSpace*>& V_sub,
+                                 std::vector<const FunctionSpace*>& W_sub,
+                                 std::vector<const Function*>& v_sub,
+                                 const FunctionSpace& V,
+                                 const FunctionSpace& W,
+                                 const Function& v)
 {
-  // Call recursively for mixed elements
+  // Call recursively for mixed elements (subspaces are cached by
+  // their parent spaces)
   dolfin_assert(V.element());
   const std::size_t num_sub_spaces = V.element()->num_sub_elements();
   if (num_sub_spaces > 0)
   {
     for (std::size_t k = 0; k < num_sub_spaces; k++)
-    {
-      compute_coefficients(coefficients, v[k], *V[k], *W[k], cell0,
-                           coordinate_dofs0, c0, dofs, offset);
-    }
+      collect_subspaces(V_sub, W_sub, v_sub, *V[k], *W[k], v[k]);
     return;
   }
 
-  // Build data structures for keeping track of unique dofs
-  std::map<std::size_t, std::map<std::size_t, std::size_t>> cell2dof2row;
-  std::set<std::size_t> unique_dofs;
-  build_unique_dofs(unique_dofs, cell2dof2row, cell0, V);
-
-  // Compute size of linear system
-  dolfin_assert(W.element());
-  const std::size_t N = W.element()->space_dimension();
-  const std::size_t M = unique_dofs.size();
-
-  // Check size of system
-  if (M < N)
-  {
-    dolfin_error("Extrapolation.cpp",
-                 "compute extrapolation",
-                 "Not enough degrees of freedom on local patch to build extrapolation");
-  }
-
-  // Create matrix and vector for linear system
-  Eigen::MatrixXd A(M, N);
-  Eigen::VectorXd b(M);
-
-  // Add equations on cell and neighboring cells
-  dolfin_assert(V.mesh());
-  ufc::cell c1;
-  std::vector<double> coordinate_dofs1;
-
-  // Get unique set of surrounding cells (including cell0)
-  std::set<std::size_t> cell_set;
-  for (VertexIterator vtx(cell0); !vtx.end(); ++vtx)
-  {
-    for (CellIterator cell1(*vtx); !cell1.end(); ++cell1)
-      cell_set.insert(cell1->index());
-  }
-
-  for (auto cell_it : cell_set)
-  {
-    if (cell2dof2row[cell_it].empty())
-      continue;
-
-    Cell cell1(cell0.mesh(), cell_it);
-
-    cell1.get_coordinate_dofs(coordinate_dofs1);
-    cell1.get_cell_data(c1);
-    add_cell_equations(A, b, cell0, cell1,
-                       coordinate_dofs0, coordinate_dofs1,
-                       c0, c1, V, W, v,
-                       cell2dof2row[cell_it]);
-  }
-
-  // Solve least squares system
-  const Eigen::VectorXd x
-    = A.jacobiSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(b);
-
-  // Insert resulting coefficients into global coefficient vector
-  dolfin_assert(W.dofmap());
-  for (std::size_t i = 0; i < W.dofmap()->num_element_dofs(cell0.index()); ++i)
-    coefficients[dofs[i + offset]].push_back(x[i]);
-
-  // Increase offset
-  offset += W.dofmap()->num_element_dofs(cell0.index());
+  V_sub.push_back(&V);
+  W_sub.push_back(&W);
+  v_sub.push_back(&v);
 }
 //-----------------------------------------------------------------------------
-void Extrapolation::build_unique_dofs(
-  std::set<std::size_t>& unique_dofs,
-  std::map<std::size_t, std::map<std::size_t, std::size_t>>& cell2dof2row,
-  const Cell& cell0,
-  const FunctionSpace& V)
+void Extrapolation::build_patch_rows(PatchOperators& patch,
+                                     const FunctionSpace& V,
+                                     const Mesh& mesh)
 {
-  // Counter for matrix row index
-  std::size_t row = 0;
-  dolfin_assert(V.mesh());
-
-  // Get unique set of surrounding cells (including cell0)
-  std::set<std::size_t> cell_set;
-  for (VertexIterator vtx(cell0); !vtx.end(); ++vtx)
+  const std::int64_t num_cells = mesh.num_cells();
+  dolfin_assert(V.dofmap());
+  const GenericDofMap& dofmap = *V.dofmap();
+
+  // Compute rows of each cell: the local dofs of the patch cells (in
+  // order of cell index) that have not appeared on an earlier patch
+  // cell
+  std::vector<std::vector<unsigned int>> row_cells(num_cells);
+  std::vector<std::vector<unsigned int>> row_dofs(num_cells);
+  const int num_threads = SubSystemsManager::num_threads();
+  #pragma omp parallel num_threads(num_threads)
   {
-    for (CellIterator cell1(*vtx); !cell1.end(); ++cell1)
-      cell_set.insert(cell1->index());
+    std::vector<unsigned int> cells;
+    std::vector<dolfin::la_index> unique_dofs;
+
+    #pragma omp for schedule(dynamic, 64)
+    for (std::int64_t c = 0; c < num_cells; ++c)
+    {
+      compute_patch(cells, Cell(mesh, c));
+      unique_dofs.clear();
+      for (std::size_t j = 0; j < cells.size(); ++j)
+      {
+        auto dofs = dofmap.cell_dofs(cells[j]);
+        for (unsigned int i = 0; i < dofs.size(); ++i)
+        {
+          // Ignore if this degree of freedom is already considered
+          if (std::find(unique_dofs.begin(), unique_dofs.end(), dofs[i])
+              != unique_dofs.end())
+            continue;
+          unique_dofs.push_back(dofs[i]);
+          row_cells[c].push_back(cells[j]);
+          row_dofs[c].push_back(i);
+        }
+      }
+    }
   }
 
-  // Compute unique dofs on patch
-  for (auto cell_it : cell_set)
+  // Store as flat arrays
+  patch.offsets.assign(num_cells + 1, 0);
+  for (std::int64_t c = 0; c < num_cells; ++c)
+    patch.offsets[c + 1] = patch.offsets[c] + row_cells[c].size();
+  patch.row_cells.resize(patch.offsets.back());
+  patch.row_dofs.resize(patch.offsets.back());
+  for (std::int64_t c = 0; c < num_cells; ++c)
   {
-    Cell cell1(cell0.mesh(), cell_it);
-    cell2dof2row[cell_it] = compute_unique_dofs(cell1, V, row,
-                                                unique_dofs);
+    std::copy(row_cells[c].begin(), row_cells[c].end(),
+              patch.row_cells.begin() + patch.offsets[c]);
+    std::copy(row_dofs[c].begin(), row_dofs[c].end(),
+              patch.row_dofs.begin() + patch.offsets[c]);
   }
-
 }
 //-----------------------------------------------------------------------------
-void
-Extrapolation::add_cell_equations(Eigen::MatrixXd& A,
-                                  Eigen::VectorXd& b,
-                                  const Cell& cell0,
-                                  const Cell& cell1,
-                                  const std::vector<double>& coordinate_dofs0,
-                                  const std::vector<double>& coordinate_dofs1,
-                                  const ufc::cell& c0,
-                                  const ufc::cell& c1,
-                                  const FunctionSpace& V,
-                                  const FunctionSpace& W,
-                                  const Function& v,
-                                  std::map<std::size_t, std::size_t>& dof2row)
+void Extrapolation::build_patch_operators(PatchOperators& patch,
+                                          const FunctionSpace& V,
+                                          const FunctionSpace& W,
+                                          const Mesh& mesh)
 {
-  // Extract coefficients for v on patch cell
   dolfin_assert(V.element());
-  std::vector<double> dof_values(V.element()->space_dimension());
-  v.restrict(&dof_values[0], *V.element(), cell1, coordinate_dofs1.data(),
-             c1);
-
-  // Create basis function
   dolfin_assert(W.element());
-  BasisFunction phi(0, W.element(), coordinate_dofs0);
+  const FiniteElement& V_element = *V.element();
+  const std::size_t N = W.element()->space_dimension();
+  patch.dim = N;
 
-  // Iterate over given local dofs for V on patch cell
-  for (auto const &it : dof2row)
+  // Check size of systems
+  const std::int64_t num_cells = mesh.num_cells();
+  for (std::int64_t c = 0; c < num_cells; ++c)
   {
-    const std::size_t i = it.first;
-    const std::size_t row = it.second;
-
-    // Iterate over basis functions for W on center cell
-    for (std::size_t j = 0; j < W.element()->space_dimension(); ++j)
+    if (patch.offsets[c + 1] - patch.offsets[c] < N)
     {
-      // Create basis function
-      phi.update_index(j);
-
-      // Evaluate dof on basis function
-      const double dof_value
-        = V.element()->evaluate_dof(i, phi,  coordinate_dofs1.data(),
-                                    c1.orientation, c1);
-
-      // Insert dof_value into matrix
-      A(row, j) = dof_value;
+      dolfin_error("Extrapolation.cpp",
+                   "compute extrapolation",
+                   "Not enough degrees of freedom on local patch to build extrapolation");
     }
-
-    // Insert coefficient into vector
-    b[row] = dof_values[i];
   }
-}
-//-----------------------------------------------------------------------------
-std::map<std::size_t, std::size_t>
-Extrapolation::compute_unique_dofs(const Cell& cell,
-                                   const FunctionSpace& V,
-                                   std::size_t& row,
-                                   std::set<std::size_t>& unique_dofs)
-{
-  dolfin_assert(V.dofmap());
-  auto dofs = V.dofmap()->cell_dofs(cell.index());
 
-  // Data structure for current cell
-  std::map<std::size_t, std::size_t> dof2row;
-
-  for (std::size_t i = 0; i < V.dofmap()->num_element_dofs(cell.index()); ++i)
+  // Compute pseudo-inverse of the matrix of each patch system
+  patch.operators.resize(N*patch.offsets.back());
+  const int num_threads = SubSystemsManager::num_threads();
+  #pragma omp parallel num_threads(num_threads)
   {
-    // Ignore if this degree of freedom is already considered
-    if (unique_dofs.find(dofs[i]) != unique_dofs.end())
-      continue;
-
-    // Put global index into unique_dofs
-    unique_dofs.insert(dofs[i]);
-
-    // Map local dof index to current matrix row-index
-    dof2row[i] = row;
+    ufc::cell c0, c1;
+    std::vector<double> coordinate_dofs0, coordinate_dofs1;
+    Eigen::MatrixXd A;
 
-    // Increase row index
-    row++;
+    #pragma omp for schedule(dynamic, 64)
+    for (std::int64_t c = 0; c < num_cells; ++c)
+    {
+      const Cell cell0(mesh, c);
+      cell0.get_coordinate_dofs(coordinate_dofs0);
+      cell0.get_cell_data(c0);
+      BasisFunction phi(0, W.element(), coordinate_dofs0);
+
+      // Evaluate dofs of V on patch cells on basis functions of W on
+      // center cell
+      const std::size_t offset = patch.offsets[c];
+      const std::size_t M = patch.offsets[c + 1] - offset;
+      A.resize(M, N);
+      std::size_t current_cell = mesh.num_cells();
+      for (std::size_t row = 0; row < M; ++row)
+      {
+        if (patch.row_cells[offset + row] != current_cell)
+        {
+          current_cell = patch.row_cells[offset + row];
+          const Cell cell1(mesh, current_cell);
+          cell1.get_coordinate_dofs(coordinate_dofs1);
+          cell1.get_cell_data(c1);
+        }
+        for (std::size_t j = 0; j < N; ++j)
+        {
+          phi.update_index(j);
+          A(row, j) = V_element.evaluate_dof(patch.row_dofs[offset + row], phi,
+                                             coordinate_dofs1.data(),
+                                             c1.orientation, c1);
+        }
+      }
+
+      // Least-squares solution operator (as the solution of the
+      // least-squares problem for each unit right-hand side)
+      Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                               Eigen::RowMajor>>
+        P(patch.operators.data() + N*offset, N, M);
+      P = A.jacobiSvd(Eigen::ComputeThinU | Eigen::ComputeThinV)
+        .solve(Eigen::MatrixXd::Identity(M, M));
+    }
   }
-
-  return dof2row;
 }
 //-----------------------------------------------------------------------------
-void Extrapolation::average_coefficients(
-  Function& w,
-  std::vector<std::vector<double>>& coefficients)
+void
+Extrapolation::apply_patch_operators(std::vector<double>& cell_coefficients,
+                                     const std::vector<std::size_t>& cell_offsets,
+                                     std::size_t offset,
+                                     const PatchOperators& patch,
+                                     const FunctionSpace& V,
+                                     const Function& v,
+                                     const Mesh& mesh)
 {
-  const FunctionSpace& W = *w.function_space();
-  std::vector<double> dof_values(W.dim());
-
-  for (std::size_t i = 0; i < W.dim(); i++)
+  dolfin_assert(V.element());
+  const FiniteElement& V_element = *V.element();
+  const std::size_t N = patch.dim;
+  const std::int64_t num_cells = mesh.num_cells();
+  const int num_threads = SubSystemsManager::num_threads();
+  #pragma omp parallel num_threads(num_threads)
   {
-    double s = 0.0;
-    for (std::size_t j = 0; j < coefficients[i].size(); ++j)
-      s += coefficients[i][j];
+    ufc::cell c1;
+    std::vector<double> coordinate_dofs1;
+    std::vector<double> dof_values(V_element.space_dimension());
+    Eigen::VectorXd b;
 
-    s /= static_cast<double>(coefficients[i].size());
-    dof_values[i] = s;
+    #pragma omp for schedule(dynamic, 64)
+    for (std::int64_t c = 0; c < num_cells; ++c)
+    {
+      // Extract coefficients of v on patch cells
+      const std::size_t row_offset = patch.offsets[c];
+      const std::size_t M = patch.offsets[c + 1] - row_offset;
+      b.resize(M);
+      std::size_t current_cell = mesh.num_cells();
+      for (std::size_t row = 0; row < M; ++row)
+      {
+        if (patch.row_cells[row_offset + row] != current_cell)
+        {
+          current_cell = patch.row_cells[row_offset + row];
+          const Cell cell1(mesh, current_cell);
+          cell1.get_coordinate_dofs(coordinate_dofs1);
+          cell1.get_cell_data(c1);
+          v.restrict(dof_values.data(), V_element, cell1,
+                     coordinate_dofs1.data(), c1);
+        }
+        b[row] = dof_values[patch.row_dofs[row_offset + row]];
+      }
+
+      // Apply least-squares solution operator
+      Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                                     Eigen::RowMajor>>
+        P(patch.operators.data() + N*row_offset, N, M);
+      Eigen::Map<Eigen::VectorXd>
+        x(cell_coefficients.data() + cell_offsets[c] + offset, N);
+      x = P*b;
+    }
   }
-
-  // Update dofs for w
-  dolfin_assert(w.vector());
-  w.vector()->set_local(dof_values);
 }
 //-----------------------------------------------------------------------------
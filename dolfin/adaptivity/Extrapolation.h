@@ -24,25 +24,15 @@
 #ifndef __EXTRAPOLATION_H
 #define __EXTRAPOLATION_H
 
-#include <map>
-#include <set>
+#include <cstddef>
 #include <vector>
-#include <Eigen/Dense>
-
-#include <dolfin/common/types.h>
-
-namespace ufc
-{
-  class cell;
-}
 
 namespace dolfin
 {
 
-  class Cell;
-  class DirichletBC;
   class Function;
   class FunctionSpace;
+  class Mesh;
 
   /// This class implements an algorithm for extrapolating a function
   /// on a given function space from an approximation of that function
@@ -55,55 +45,92 @@ namespace dolfin
   ///
   /// It is assumed that the extrapolation is computed on the same
   /// mesh as the original function.
+  ///
+  /// The extrapolation on each cell is the least-squares fit of the
+  /// dofs of v on the patch of cells sharing a vertex with the
+  /// cell. The least-squares systems depend only on the mesh and
+  /// the function spaces, so an Extrapolation object keeps the
+  /// solution operators of all patches and reuses them in later
+  /// calls to compute() for the same mesh and spaces. The patches
+  /// are computed in parallel with OpenMP (if enabled).
 
   class Extrapolation
   {
   public:
 
+    /// Constructor
+    Extrapolation();
+
+    /// Destructor
+    ~Extrapolation();
+
+    /// Compute extrapolation w from v, reusing the patch operators
+    /// of the last call if the mesh and the function spaces are the
+    /// same
+    void compute(Function& w, const Function& v);
+
+    /// Clear patch operators
+    void clear();
+
     /// Compute extrapolation w from v
     static void extrapolate(Function& w, const Function& v);
 
   private:
 
-    // Build data structures for unique dofs on patch of given cell
-    static void build_unique_dofs(std::set<std::size_t>& unique_dofs,
-                        std::map<std::size_t, std::map<std::size_t, std::size_t> >& cell2dof2row,
-                                  const Cell& cell0,
-                                  const FunctionSpace& V);
-
-    // Compute unique dofs in given cell
-    static std::map<std::size_t, std::size_t>
-      compute_unique_dofs(const Cell& cell, const FunctionSpace& V,
-                          std::size_t& row, std::set<std::size_t>& unique_dofs);
-
-    // Compute coefficients on given cell
-    static void
-      compute_coefficients(std::vector<std::vector<double> >& coefficients,
-                           const Function&v, const FunctionSpace& V,
-                           const FunctionSpace& W, const Cell& cell0,
-                           const std::vector<double>& coordinate_dofs0,
-                           const ufc::cell& c0,
-                           const Eigen::Ref<const Eigen::Matrix<dolfin::la_index, Eigen::Dynamic, 1>> dofs,
-                           std::size_t& offset);
-
-    // Add equations for current cell
-    static void add_cell_equations(Eigen::MatrixXd& A,
-                                 Eigen::VectorXd& b,
-                                 const Cell& cell0,
-                                 const Cell& cell1,
-                                 const std::vector<double>& coordinate_dofs0,
-                                 const std::vector<double>& coordinate_dofs1,
-                                 const ufc::cell& c0,
-                                 const ufc::cell& c1,
+    // Patch least-squares operators for a (non-mixed) subspace
+    struct PatchOperators
+    {
+      // Dimension of (sub)element of W
+      std::size_t dim;
+
+      // Patch cell and local dof of V for each row of the patch
+      // system of each cell, rows of cell c at offsets[c] to
+      // offsets[c + 1]
+      std::vector<std::size_t> offsets;
+      std::vector<unsigned int> row_cells;
+      std::vector<unsigned int> row_dofs;
+
+      // Least-squares solution operators (dim x num_rows, row-major)
+      // of each cell, at dim*offsets[c]
+      std::vector<double> operators;
+    };
+
+    // Collect non-mixed subspaces and subfunctions
+    static void collect_subspaces(std::vector<const FunctionSpace*>& V_sub,
+                                  std::vector<const FunctionSpace*>& W_sub,
+                                  std::vector<const Function*>& v_sub,
+                                  const FunctionSpace& V,
+                                  const FunctionSpace& W,
+                                  const Function& v);
+
+    // Compute rows of patch systems (cells and local dofs of V with
+    // unique global dofs on the patch of each cell)
+    static void build_patch_rows(PatchOperators& patch,
                                  const FunctionSpace& V,
-                                 const FunctionSpace& W,
-                                 const Function& v,
-                                 std::map<std::size_t, std::size_t>& dof2row);
-
-    // Average coefficients
-    static void
-      average_coefficients(Function& w,
-                           std::vector<std::vector<double> >& coefficients);
+                                 const Mesh& mesh);
+
+    // Compute least-squares solution operators of patch systems
+    static void build_patch_operators(PatchOperators& patch,
+                                      const FunctionSpace& V,
+                                      const FunctionSpace& W,
+                                      const Mesh& mesh);
+
+    // Apply patch operators to dofs of v, giving coefficients of w on
+    // each cell (at cell_offsets[c] + offset)
+    static void apply_patch_operators(std::vector<double>& cell_coefficients,
+                                      const std::vector<std::size_t>& cell_offsets,
+                                      std::size_t offset,
+                                      const PatchOperators& patch,
+                                      const FunctionSpace& V,
+                                      const Function& v,
+                                      const Mesh& mesh);
+
+    // Patch operators of each (non-mixed) subspace
+    std::vector<PatchOperators> _patches;
+
+    // Mesh (id, geometry, topology) and spaces (ids) the patch
+    // operators were computed for
+    std::vector<std::size_t> _state;
 
   };
 
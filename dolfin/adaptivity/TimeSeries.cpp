@@ -18,6 +18,7 @@
 #ifdef HAS_HDF5
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -37,55 +38,34 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Datasets for vector samples (one row per sample) and their times
+  const std::string vector_values_name = "/VectorSamples/values";
+  const std::string vector_times_name = "/VectorSamples/times";
+}
 //-----------------------------------------------------------------------------
 template <typename T>
-void TimeSeries::store_object(MPI_Comm comm, const T& object, double t,
+void TimeSeries::store_object(HDF5File& hdf5_file, const T& object, double t,
                               std::vector<double>& times,
-                              std::string series_name,
                               std::string group_name)
 {
-  // Write object
-
-  // Check for pre-existing file to append to
-  std::string mode = "w";
-  if(File::exists(series_name) &&
-     (_vector_times.size() > 0 || _mesh_times.size() > 0))
-    mode = "a";
-
-  // Get file handle for low level operations
-  HDF5File hdf5_file(comm, series_name, mode);
-  const hid_t fid = hdf5_file._hdf5_file_id;
-
-  // Find existing datasets (should be equal to number of times)
-  std::size_t nobjs = 0;
-  if(HDF5Interface::has_group(fid, group_name))
-    nobjs = HDF5Interface::num_datasets_in_group(fid, group_name);
-
-  dolfin_assert(nobjs == times.size());
-
-  // Write new dataset (mesh or vector)
-  std::string dataset_name = group_name + "/" + std::to_string(nobjs);
+  // Write new dataset (mesh or vector), numbered by the number of
+  // samples stored so far
+  const std::string dataset_name
+    = group_name + "/" + std::to_string(times.size());
+  append_time(times, t);
   hdf5_file.write(object, dataset_name);
 
-  // Check that time values are strictly increasing
-  const std::size_t n = times.size();
-  if (n >= 2 && (times[n - 1] - times[n - 2])*(t - times[n - 1]) < 0.0)
-  {
-    dolfin_error("TimeSeries.cpp",
-                 "store object to time series",
-                 "Sample points must be strictly monotone (t_0 = %g, t_1 = %g, t_2 = %g)",
-                 times[n - 2], times[n - 1], t);
-  }
-
-  // Add time
-  times.push_back(t);
-
   // Store time
-  HDF5Interface::add_attribute(fid, dataset_name, "time", t);
+  HDF5Interface::add_attribute(hdf5_file._hdf5_file_id, dataset_name, "time",
+                               t);
+  hdf5_file.flush();
 }
 //-----------------------------------------------------------------------------
 TimeSeries::TimeSeries(MPI_Comm mpi_comm, std::string name)
-  : _name(name + ".h5"), _cleared(false)
+  : _name(name + ".h5"), _cleared(false), _mpi_comm(mpi_comm),
+    _writable(false), _vector_datasets(false)
 {
   // Set default parameters
   parameters = default_parameters();
@@ -96,10 +76,16 @@ TimeSeries::TimeSeries(MPI_Comm mpi_comm, std::string name)
   if (File::exists(_name))
   {
     // Read from file
-    const hid_t hdf5_file_id = HDF5Interface::open_file(mpi_comm, _name, "r",
-                                                        true);
-    if (HDF5Interface::has_group(hdf5_file_id, "/Vector"))
+    const hid_t hdf5_file_id = file(false)._hdf5_file_id;
+    if (HDF5Interface::has_dataset(hdf5_file_id, vector_times_name))
     {
+      HDF5Interface::read_dataset(hdf5_file_id, vector_times_name,
+                                  {-1, -1}, _vector_times);
+    }
+    else if (HDF5Interface::has_group(hdf5_file_id, "/Vector"))
+    {
+      // One dataset per sample
+      _vector_datasets = true;
       const unsigned int nvecs
         = HDF5Interface::num_datasets_in_group(hdf5_file_id, "/Vector");
       _vector_times.clear();
@@ -110,7 +96,10 @@ TimeSeries::TimeSeries(MPI_Comm mpi_comm, std::string name)
         HDF5Interface::get_attribute(hdf5_file_id, dataset_name, "time", t);
         _vector_times.push_back(t);
       }
+    }
 
+    if (!_vector_times.empty())
+    {
       log(PROGRESS, "Found %d vector sample(s) in time series.",
           _vector_times.size());
       if (!monotone(_vector_times))
@@ -145,8 +134,6 @@ TimeSeries::TimeSeries(MPI_Comm mpi_comm, std::string name)
                      name.c_str());
       }
     }
-
-    HDF5Interface::close_file(hdf5_file_id);
   }
   else
     log(PROGRESS, "No samples found in time series.");
@@ -154,7 +141,8 @@ TimeSeries::TimeSeries(MPI_Comm mpi_comm, std::string name)
 //-----------------------------------------------------------------------------
 TimeSeries::~TimeSeries()
 {
-  // Do nothing (keep files)
+  // Do nothing (keep files, which are closed by the HDF5File
+  // destructor)
 }
 //-----------------------------------------------------------------------------
 void TimeSeries::store(const GenericVector& vector, double t)
@@ -164,8 +152,30 @@ void TimeSeries::store(const GenericVector& vector, double t)
   if (!_cleared && clear_on_write)
     clear();
 
-  // Store object
-  store_object(vector.mpi_comm(), vector, t, _vector_times, _name, "/Vector");
+  HDF5File& hdf5_file = file(true);
+
+  // Append to file written by an earlier version in the same format
+  if (_vector_datasets)
+  {
+    store_object(hdf5_file, vector, t, _vector_times, "/Vector");
+    return;
+  }
+
+  // Append local values as a new row of the vector dataset, and the
+  // time (from process 0) to the list of times
+  append_time(_vector_times, t);
+  const hid_t fid = hdf5_file._hdf5_file_id;
+  const bool mpi_io = _mpi_comm.size() > 1;
+  std::vector<double> values;
+  vector.get_local(values);
+  const std::pair<std::int64_t, std::int64_t> range = vector.local_range();
+  HDF5Interface::append_row(fid, vector_values_name, values.data(), range,
+                            vector.size(), mpi_io);
+  const std::pair<std::int64_t, std::int64_t>
+    time_range(0, _mpi_comm.rank() == 0 ? 1 : 0);
+  HDF5Interface::append_row(fid, vector_times_name, &t, time_range, 1,
+                            mpi_io);
+  hdf5_file.flush();
 }
 //-----------------------------------------------------------------------------
 void TimeSeries::store(const Mesh& mesh, double t)
@@ -176,22 +186,12 @@ void TimeSeries::store(const Mesh& mesh, double t)
     clear();
 
   // Store object
-  store_object(mesh.mpi_comm(), mesh, t, _mesh_times, _name, "/Mesh");
-
+  store_object(file(true), mesh, t, _mesh_times, "/Mesh");
 }
 //-----------------------------------------------------------------------------
 void TimeSeries::retrieve(GenericVector& vector, double t,
                               bool interpolate) const
 {
-  if (!File::exists(_name))
-  {
-    dolfin_error("TimeSeries.cpp",
-                 "open file to retrieve series",
-                 "File does not exist");
-  }
-
-  HDF5File hdf5_file(MPI_COMM_WORLD, _name, "r");
-
   // Interpolate value
   if (interpolate)
   {
@@ -204,7 +204,8 @@ void TimeSeries::retrieve(GenericVector& vector, double t,
     // Special case: same index
     if (i0 == i1)
     {
-      hdf5_file.read(vector, "/Vector/" + std::to_string(i0), false);
+      vector.set_local(vector_sample(vector, i0));
+      vector.apply("insert");
       log(PROGRESS, "Reading vector value at t = %g.", _vector_times[0]);
       return;
     }
@@ -212,21 +213,11 @@ void TimeSeries::retrieve(GenericVector& vector, double t,
     log(PROGRESS, "Interpolating vector value at t = %g in interval [%g, %g].",
         t, _vector_times[i0], _vector_times[i1]);
 
-    // Read vectors
-    GenericVector& x0(vector);
-    std::shared_ptr<GenericVector> x1
-      = x0.factory().create_vector(x0.mpi_comm());
-    hdf5_file.read(x0, "/Vector/" + std::to_string(i0), false);
-    hdf5_file.read(*x1, "/Vector/" + std::to_string(i1), false);
-
-    // Check that the vectors have the same size
-    if (x0.size() != x1->size())
-    {
-      dolfin_error("TimeSeries.cpp",
-                   "interpolate vector value in time series",
-                   "Vector sizes don't match (%d and %d)",
-                   x0.size(), x1->size());
-    }
+    // Get vectors (the cache keeps at least two samples, so both
+    // references stay valid)
+    const std::vector<double>& x0 = vector_sample(vector, i0);
+    const std::vector<double>& x1 = vector_sample(vector, i1);
+    dolfin_assert(x0.size() == x1.size());
 
     // Compute weights for linear interpolation
     const double dt = _vector_times[i1] - _vector_times[i0];
@@ -235,8 +226,11 @@ void TimeSeries::retrieve(GenericVector& vector, double t,
     const double w1 = 1.0 - w0;
 
     // Interpolate
-    x0 *= w0;
-    x0.axpy(w1, *x1);
+    std::vector<double> values(x0.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+      values[i] = w0*x0[i] + w1*x1[i];
+    vector.set_local(values);
+    vector.apply("insert");
   }
   else
   {
@@ -248,19 +242,13 @@ void TimeSeries::retrieve(GenericVector& vector, double t,
         _vector_times[index], t);
 
     // Read vector
-    hdf5_file.read(vector, "/Vector/" + std::to_string(index), false);
+    vector.set_local(vector_sample(vector, index));
+    vector.apply("insert");
   }
 }
 //-----------------------------------------------------------------------------
 void TimeSeries::retrieve(Mesh& mesh, double t) const
 {
-  if (!File::exists(_name))
-  {
-    dolfin_error("TimeSeries.cpp",
-                 "open file to retrieve series",
-                 "File does not exist");
-  }
-
   // Get index closest to given time
   const std::size_t index = find_closest_index(t, _mesh_times, _name, "mesh");
 
@@ -268,8 +256,7 @@ void TimeSeries::retrieve(Mesh& mesh, double t) const
       _mesh_times[index], t);
 
   // Read mesh
-  HDF5File hdf5_file(MPI_COMM_WORLD, _name, "r");
-  hdf5_file.read(mesh, "/Mesh/" + std::to_string(index), false);
+  file(false).read(mesh, "/Mesh/" + std::to_string(index), false);
 }
 //-----------------------------------------------------------------------------
 std::vector<double> TimeSeries::vector_times() const
@@ -286,9 +273,123 @@ void TimeSeries::clear()
 {
   _vector_times.clear();
   _mesh_times.clear();
+  _cache.clear();
   _cleared = true;
 }
 //-----------------------------------------------------------------------------
+HDF5File& TimeSeries::file(bool write) const
+{
+  if (write)
+  {
+    // Start a new file if no samples have been stored, otherwise
+    // reopen for appending if only opened for reading
+    const bool truncate = !File::exists(_name)
+      || (_vector_times.empty() && _mesh_times.empty());
+    if (truncate || !_writable)
+    {
+      _hdf5_file.reset();
+      _hdf5_file.reset(new HDF5File(_mpi_comm.comm(), _name,
+                                    truncate ? "w" : "a"));
+      _writable = true;
+      if (truncate)
+      {
+        _vector_datasets = false;
+        _cache.clear();
+      }
+    }
+  }
+  else if (!_hdf5_file)
+  {
+    if (!File::exists(_name))
+    {
+      dolfin_error("TimeSeries.cpp",
+                   "open file to retrieve series",
+                   "File does not exist");
+    }
+    _hdf5_file.reset(new HDF5File(_mpi_comm.comm(), _name, "r"));
+    _writable = false;
+  }
+
+  dolfin_assert(_hdf5_file);
+  return *_hdf5_file;
+}
+//-----------------------------------------------------------------------------
+const std::vector<double>&
+TimeSeries::vector_sample(GenericVector& vector, std::size_t index) const
+{
+  HDF5File& hdf5_file = file(false);
+  const hid_t fid = hdf5_file._hdf5_file_id;
+  const std::string dataset_name = _vector_datasets
+    ? "/Vector/" + std::to_string(index) : vector_values_name;
+
+  // Initialise vector if empty, and check size
+  const std::vector<std::int64_t> shape
+    = HDF5Interface::get_dataset_shape(fid, dataset_name);
+  const std::size_t size = _vector_datasets ? shape[0] : shape[1];
+  if (vector.empty())
+    vector.init(size);
+  else if (vector.size() != size)
+  {
+    dolfin_error("TimeSeries.cpp",
+                 "retrieve vector from time series",
+                 "Vector sizes don't match (%d and %d)",
+                 vector.size(), size);
+  }
+
+  // Look for sample in cache, and move it to front if found
+  const std::pair<std::size_t, std::size_t> range = vector.local_range();
+  for (auto it = _cache.begin(); it != _cache.end(); ++it)
+  {
+    if (it->index == index && it->range == range)
+    {
+      _cache.splice(_cache.begin(), _cache, it);
+      return _cache.front().values;
+    }
+  }
+
+  // Read sample from file
+  CachedSample sample;
+  sample.index = index;
+  sample.range = range;
+  if (_vector_datasets)
+  {
+    hdf5_file.read(vector, dataset_name, false);
+    vector.get_local(sample.values);
+  }
+  else
+  {
+    sample.values.resize(range.second - range.first);
+    HDF5Interface::read_row(fid, dataset_name, index, range,
+                            sample.values.data(), _mpi_comm.size() > 1);
+  }
+  _cache.push_front(std::move(sample));
+
+  // Remove least recently used samples, but keep at least two (for
+  // interpolation)
+  const int cache_size = this->parameters["cache_size"];
+  const std::size_t max_size = std::max(cache_size, 2);
+  while (_cache.size() > max_size)
+    _cache.pop_back();
+
+  return _cache.front().values;
+}
+//-----------------------------------------------------------------------------
+void TimeSeries::append_time(std::vector<double>& times, double t)
+{
+  // Check that time values are strictly increasing
+  const std::size_t n = times.size();
+  if (n >= 2 && (times[n - 1] - times[n - 2])*(t - times[n - 1]) < 0.0)
+  {
+    dolfin_error("TimeSeries.cpp",
+                 "store object to time series",
+                 "Sample points must be strictly monotone (t_0 = %g, t_1 = %g, t_2 = %g)",
+                 times[n - 2], times[n - 1], t);
+  }
+
+  // Add time
+  times.push_back(t);
+}
+//-----------------------------------------------------------------------------
 std::string TimeSeries::str(bool verbose) const
 {
   std::stringstream s;
@@ -20,7 +20,10 @@
 
 #ifdef HAS_HDF5
 
+#include <list>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/Variable.h>
@@ -30,6 +33,7 @@ namespace dolfin
 
   // Forward declarations
   class GenericVector;
+  class HDF5File;
   class Mesh;
 
   /// This class stores a time series of objects to file(s) in a
@@ -42,6 +46,12 @@ namespace dolfin
   /// file before (for a series with the same name) and in that
   /// case reuse those values. If new values are stored, old
   /// values will be cleared.
+  ///
+  /// The file is kept open between calls. Vectors are stored as the
+  /// rows of a single extendible dataset, and the most recently
+  /// retrieved vectors are kept in memory (see the parameter
+  /// "cache_size"), so that repeated retrieval (e.g. sweeps
+  /// backwards in time) does not read the same samples from disk.
 
   class TimeSeries : public Variable
   {
@@ -134,17 +144,41 @@ namespace dolfin
     {
       Parameters p("time_series");
       p.add("clear_on_write", true);
+      p.add("cache_size", 4);
       return p;
     }
 
   private:
 
+    // Local values of a retrieved vector sample
+    struct CachedSample
+    {
+      std::size_t index;
+      std::pair<std::size_t, std::size_t> range;
+      std::vector<double> values;
+    };
+
+    // Store object as a separate dataset in group
     template <typename T>
-      void store_object(MPI_Comm comm, const T& object, double t,
+      void store_object(HDF5File& hdf5_file, const T& object, double t,
                         std::vector<double>& times,
-                        std::string series_name,
                         std::string group_name);
 
+    // Return file, opened on first use and kept open. The file is
+    // reopened for writing if required, and truncated if no samples
+    // have been stored.
+    HDF5File& file(bool write) const;
+
+    // Return local values of vector sample with given index for the
+    // local range of the vector (initialised if empty), from the
+    // cache or from file
+    const std::vector<double>& vector_sample(GenericVector& vector,
+                                             std::size_t index) const;
+
+    // Check that time t continues the strictly monotone sequence of
+    // times, and add it
+    static void append_time(std::vector<double>& times, double t);
+
     // Check if values are strictly increasing
     static bool monotone(const std::vector<double>& times);
 
@@ -169,6 +203,22 @@ namespace dolfin
     // True if series has been cleared
     bool _cleared;
 
+    // MPI communicator
+    MPI::Comm _mpi_comm;
+
+    // File, kept open between calls
+    mutable std::unique_ptr<HDF5File> _hdf5_file;
+
+    // True if file has been opened for writing
+    mutable bool _writable;
+
+    // True if vectors are stored as one dataset per sample (files
+    // written by earlier versions)
+    mutable bool _vector_datasets;
+
+    // Recently retrieved vector samples, most recently used first
+    mutable std::list<CachedSample> _cache;
+
   };
 
 }
@@ -10,6 +10,7 @@
 #include <dolfin/adaptivity/ErrorControl.h>
 #include <dolfin/adaptivity/Extrapolation.h>
 #include <dolfin/adaptivity/TimeSeries.h>
+#include <dolfin/adaptivity/Checkpointer.h>
 
 #include <dolfin/adaptivity/adapt.h>
 #include <dolfin/adaptivity/marking.h>
@@ -22,6 +22,7 @@
 
 #include <vector>
 #include <dolfin/function/GenericFunction.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/mesh/BoundaryMesh.h>
 #include <dolfin/mesh/Vertex.h>
 #include <dolfin/fem/fem_utils.h>
@@ -37,7 +38,10 @@ std::shared_ptr<MeshDisplacement> ALE::move(std::shared_ptr<Mesh> mesh,
                                             const BoundaryMesh& new_boundary)
 {
   dolfin_assert(mesh);
-  return HarmonicSmoothing::move(mesh, new_boundary);
+  std::shared_ptr<MeshDisplacement> u
+    = HarmonicSmoothing::move(mesh, new_boundary);
+  refit_bounding_box_tree(*mesh);
+  return u;
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<MeshDisplacement> ALE::move(std::shared_ptr<Mesh> mesh0,
@@ -114,7 +118,10 @@ std::shared_ptr<MeshDisplacement> ALE::move(std::shared_ptr<Mesh> mesh0,
   }
 
   // Move mesh
-  return HarmonicSmoothing::move(mesh0, boundary0);
+  std::shared_ptr<MeshDisplacement> u
+    = HarmonicSmoothing::move(mesh0, boundary0);
+  refit_bounding_box_tree(*mesh0);
+  return u;
 }
 //-----------------------------------------------------------------------------
 void ALE::move(Mesh& mesh, const GenericFunction& displacement)
@@ -151,6 +158,8 @@ void ALE::move(Mesh& mesh, const GenericFunction& displacement)
       x[j] = geometry.x(i, j) + vertex_values[j*N + i];
     geometry.set(i, x.data());
   }
+
+  refit_bounding_box_tree(mesh);
 }
 //-----------------------------------------------------------------------------
 void ALE::move(Mesh& mesh, const Function& displacement)
@@ -159,5 +168,14 @@ void ALE::move(Mesh& mesh, const Function& displacement)
   get_coordinates(position, mesh.geometry());
   *position.vector() += *displacement.vector();
   set_coordinates(mesh.geometry(), position);
+
+  refit_bounding_box_tree(mesh);
+}
+//-----------------------------------------------------------------------------
+void ALE::refit_bounding_box_tree(const Mesh& mesh)
+{
+  // Only update a tree that has already been built
+  if (mesh._tree)
+    mesh._tree->refit();
 }
 //-----------------------------------------------------------------------------
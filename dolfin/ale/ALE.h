@@ -91,6 +91,11 @@ namespace dolfin
     ///         A vectorial Lagrange function of matching degree.
     static void move(Mesh& mesh, const Function& displacement);
 
+  private:
+
+    // Refit bounding box tree of mesh (if built) to moved coordinates
+    static void refit_bounding_box_tree(const Mesh& mesh);
+
   };
 
 }
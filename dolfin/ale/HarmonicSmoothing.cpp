@@ -16,12 +16,14 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2008-08-11
-// Last changed: 2013-12-02
+// Last changed: 2017-10-14
 
 #include <dolfin/common/Array.h>
+#include <dolfin/common/MPI.h>
 #include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/fem/assemble.h>
 #include <dolfin/fem/fem_utils.h>
+#include <dolfin/la/KrylovSolver.h>
 #include <dolfin/la/Matrix.h>
 #include <dolfin/la/solve.h>
 #include <dolfin/la/Vector.h>
@@ -39,62 +41,76 @@
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-std::shared_ptr<MeshDisplacement>
-HarmonicSmoothing::move(std::shared_ptr<Mesh> mesh,
-                        const BoundaryMesh& new_boundary)
+HarmonicSmoothing::HarmonicSmoothing(std::shared_ptr<Mesh> mesh)
+  : _mesh(mesh), _num_cells(0)
 {
-  dolfin_assert(mesh);
-  if (mesh->geometry().degree() != 1 || new_boundary.geometry().degree() != 1)
+  dolfin_assert(_mesh);
+  if (_mesh->geometry().degree() != 1)
   {
     dolfin_error("HarmonicSmoothing.cpp",
-                 "move mesh using harmonic smoothing",
+                 "create harmonic smoother",
                  "This function does not support higher-order mesh geometry");
   }
 
-  // Now this works regardless of reorder_dofs_serial value
-  const bool reorder_dofs_serial = parameters["reorder_dofs_serial"];
-  if (!reorder_dofs_serial)
-  {
-    warning("The function HarmonicSmoothing::move no longer needs "
-            "parameters[\"reorder_dofs_serial\"] = false");
-  }
-
-  const std::size_t D = mesh->topology().dim();
-  const std::size_t d = mesh->geometry().dim();
-
-  // Choose form and function space
-  std::shared_ptr<FunctionSpace> V;
-  std::shared_ptr<Form> form;
+  // Choose function space
+  const std::size_t D = _mesh->topology().dim();
   switch (D)
   {
   case 1:
-    V.reset(new Poisson1D::FunctionSpace(mesh));
-    form.reset(new Poisson1D::BilinearForm(V, V));
+    _V.reset(new Poisson1D::FunctionSpace(_mesh));
     break;
   case 2:
-    V.reset(new Poisson2D::FunctionSpace(mesh));
-    form.reset(new Poisson2D::BilinearForm(V, V));
+    _V.reset(new Poisson2D::FunctionSpace(_mesh));
     break;
   case 3:
-    V.reset(new Poisson3D::FunctionSpace(mesh));
-    form.reset(new Poisson3D::BilinearForm(V, V));
+    _V.reset(new Poisson3D::FunctionSpace(_mesh));
     break;
   default:
     dolfin_error("HarmonicSmoothing.cpp",
-                 "move mesh using harmonic smoothing",
+                 "create harmonic smoother",
                  "Illegal mesh dimension (%d)", D);
   }
+}
+//-----------------------------------------------------------------------------
+HarmonicSmoothing::~HarmonicSmoothing()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<MeshDisplacement>
+HarmonicSmoothing::move(std::shared_ptr<Mesh> mesh,
+                        const BoundaryMesh& new_boundary)
+{
+  // Now this works regardless of reorder_dofs_serial value
+  const bool reorder_dofs_serial = parameters["reorder_dofs_serial"];
+  if (!reorder_dofs_serial)
+  {
+    warning("The function HarmonicSmoothing::move no longer needs "
+            "parameters[\"reorder_dofs_serial\"] = false");
+  }
 
-  // Assemble matrix
-  auto A = std::make_shared<Matrix>();
-  assemble(*A, *form);
+  HarmonicSmoothing smoothing(mesh);
+  return smoothing.displace(new_boundary);
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<MeshDisplacement>
+HarmonicSmoothing::displace(const BoundaryMesh& new_boundary)
+{
+  if (new_boundary.geometry().degree() != 1)
+  {
+    dolfin_error("HarmonicSmoothing.cpp",
+                 "move mesh using harmonic smoothing",
+                 "This function does not support higher-order mesh geometry");
+  }
+
+  const std::size_t d = _mesh->geometry().dim();
 
   // Number of mesh vertices (local)
-  const std::size_t num_vertices = mesh->num_vertices();
+  const std::size_t num_vertices = _mesh->num_vertices();
 
   // Dof range
-  const dolfin::la_index n0 = V->dofmap()->ownership_range().first;
-  const dolfin::la_index n1 = V->dofmap()->ownership_range().second;
+  const dolfin::la_index n0 = _V->dofmap()->ownership_range().first;
+  const dolfin::la_index n1 = _V->dofmap()->ownership_range().second;
   const dolfin::la_index num_owned_dofs = n1 - n0;
 
   // Mapping of new_boundary vertex numbers to mesh vertex numbers
@@ -106,7 +122,7 @@ HarmonicSmoothing::move(std::shared_ptr<Mesh> mesh,
                vertex_map_mesh_func.values() + num_boundary_vertices);
 
   // Mapping of mesh vertex numbers to dofs (including ghost dofs)
-  const std::vector<dolfin::la_index> vertex_to_dofs = vertex_to_dof_map(*V);
+  const std::vector<dolfin::la_index> vertex_to_dofs = vertex_to_dof_map(*_V);
 
   // Array of all dofs (including ghosts) with local numbering
   std::vector<dolfin::la_index> all_global_dofs(num_vertices);
@@ -136,31 +152,24 @@ HarmonicSmoothing::move(std::shared_ptr<Mesh> mesh,
     }
   }
 
-  // Modify matrix (insert 1 on diagonal)
-  A->ident(num_boundary_dofs, boundary_dofs.data());
-  A->apply("insert");
+  // Assemble operator unless it can be reused (on all processes)
+  const bool reuse = _A && _num_cells == _mesh->num_cells()
+    && _boundary_dofs == boundary_dofs;
+  if (MPI::min(_mesh->mpi_comm(), (std::size_t) reuse) == 0)
+    init(boundary_dofs);
 
   // Arrays for storing Dirichlet condition and solution
   std::vector<double> boundary_values(num_boundary_dofs);
   std::vector<double> displacement;
   displacement.reserve(d*num_vertices);
 
-  // Pick amg as preconditioner if available
-  const std::string
-    prec(has_krylov_solver_preconditioner("amg") ? "amg" : "default");
-
   // Displacement solution wrapped in Expression subclass
   // MeshDisplacement
-  std::shared_ptr<MeshDisplacement> u(new MeshDisplacement(mesh));
+  std::shared_ptr<MeshDisplacement> u(new MeshDisplacement(_V));
 
   // RHS vector
   Vector b(*(*u)[0].vector());
 
-  // Prepare solver
-  KrylovSolver solver(mesh->mpi_comm(), "bicgstab", prec);
-  solver.parameters["nonzero_initial_guess"] = true;
-  solver.set_operator(A);
-
   // Solve system for each dimension
   for (std::size_t dim = 0; dim < d; dim++)
   {
@@ -174,14 +183,14 @@ HarmonicSmoothing::move(std::shared_ptr<Mesh> mesh,
     for (std::size_t i = 0; i < num_boundary_dofs; i++)
     {
       boundary_values[i] = new_boundary.geometry().x(boundary_vertices[i], dim)
-        - mesh->geometry().x(vertex_map[boundary_vertices[i]], dim);
+        - _mesh->geometry().x(vertex_map[boundary_vertices[i]], dim);
     }
     b.set(boundary_values.data(), num_boundary_dofs, boundary_dofs.data());
     b.apply("insert");
     *x = b;
 
     // Solve the system
-    solver.solve(*x, b);
+    _solver->solve(*x, b);
 
     // Get displacement
     std::vector<double> _displacement(num_vertices);
@@ -191,7 +200,7 @@ HarmonicSmoothing::move(std::shared_ptr<Mesh> mesh,
   }
 
   // Modify mesh coordinates
-  MeshGeometry& geometry = mesh->geometry();
+  MeshGeometry& geometry = _mesh->geometry();
   std::vector<double> coord(d);
   for (std::size_t i = 0; i < num_vertices; i++)
   {
@@ -204,3 +213,49 @@ HarmonicSmoothing::move(std::shared_ptr<Mesh> mesh,
   return u;
 }
 //-----------------------------------------------------------------------------
+void HarmonicSmoothing::reset()
+{
+  _A.reset();
+  _solver.reset();
+  _boundary_dofs.clear();
+  _num_cells = 0;
+}
+//-----------------------------------------------------------------------------
+void HarmonicSmoothing::init(const std::vector<dolfin::la_index>& boundary_dofs)
+{
+  // Choose form
+  std::shared_ptr<Form> form;
+  switch (_mesh->topology().dim())
+  {
+  case 1:
+    form.reset(new Poisson1D::BilinearForm(_V, _V));
+    break;
+  case 2:
+    form.reset(new Poisson2D::BilinearForm(_V, _V));
+    break;
+  default:
+    form.reset(new Poisson3D::BilinearForm(_V, _V));
+  }
+
+  // Assemble matrix
+  _A = std::make_shared<Matrix>();
+  assemble(*_A, *form);
+
+  // Modify matrix (insert 1 on diagonal)
+  _A->ident(boundary_dofs.size(), boundary_dofs.data());
+  _A->apply("insert");
+
+  // Pick amg as preconditioner if available
+  const std::string
+    prec(has_krylov_solver_preconditioner("amg") ? "amg" : "default");
+
+  // Prepare solver. The preconditioner is set up on the first solve
+  // and reused for the unchanged operator.
+  _solver = std::make_shared<KrylovSolver>(_mesh->mpi_comm(), "bicgstab", prec);
+  _solver->parameters["nonzero_initial_guess"] = true;
+  _solver->set_operator(_A);
+
+  _boundary_dofs = boundary_dofs;
+  _num_cells = _mesh->num_cells();
+}
+//-----------------------------------------------------------------------------
@@ -16,18 +16,23 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2008-08-11
-// Last changed: 2013-03-06
+// Last changed: 2017-10-14
 
 #ifndef __HARMONIC_SMOOTHING_H
 #define __HARMONIC_SMOOTHING_H
 
 #include <memory>
+#include <vector>
+#include <dolfin/common/types.h>
 #include "MeshDisplacement.h"
 
 namespace dolfin
 {
 
   class BoundaryMesh;
+  class FunctionSpace;
+  class KrylovSolver;
+  class Matrix;
   class Mesh;
 
   /// This class implements harmonic mesh smoothing. Poisson's
@@ -35,11 +40,45 @@ namespace dolfin
   /// equation) for each coordinate direction to compute new
   /// coordinates for all vertices, given new locations for the
   /// coordinates of the boundary.
+  ///
+  /// The static function move() assembles and solves the system for
+  /// the current mesh. For repeated mesh motion (e.g. every time step
+  /// of an ALE computation) create a HarmonicSmoothing object
+  /// instead: its operator is assembled once, on the configuration of
+  /// the first call to displace(), and is reused together with the
+  /// set up preconditioner of its Krylov solver. The smoothing is then
+  /// harmonic with respect to that reference configuration, until
+  /// reset() is called.
 
   class HarmonicSmoothing
   {
   public:
 
+    /// Create harmonic smoother for mesh
+    ///
+    /// @param mesh (Mesh)
+    ///   Mesh to be moved
+    explicit HarmonicSmoothing(std::shared_ptr<Mesh> mesh);
+
+    /// Destructor
+    ~HarmonicSmoothing();
+
+    /// Move coordinates of mesh according to new boundary coordinates
+    /// and return the displacement. The operator is assembled on the
+    /// first call, and reassembled only if the mesh topology or the
+    /// boundary vertices have changed since.
+    ///
+    /// @param new_boundary (BoundaryMesh)
+    ///   Boundary mesh
+    ///
+    /// @return MeshDisplacement
+    ///   Displacement
+    std::shared_ptr<MeshDisplacement> displace(const BoundaryMesh& new_boundary);
+
+    /// Discard the assembled operator, so that the next call to
+    /// displace() assembles it on the current mesh configuration
+    void reset();
+
     /// Move coordinates of mesh according to new boundary coordinates
     /// and return the displacement
     ///
@@ -53,6 +92,28 @@ namespace dolfin
     static std::shared_ptr<MeshDisplacement>
       move(std::shared_ptr<Mesh> mesh, const BoundaryMesh& new_boundary);
 
+  private:
+
+    // Assemble operator with identity rows for given boundary dofs
+    // and set up solver
+    void init(const std::vector<dolfin::la_index>& boundary_dofs);
+
+    // The mesh
+    std::shared_ptr<Mesh> _mesh;
+
+    // Linear Lagrange function space on mesh
+    std::shared_ptr<FunctionSpace> _V;
+
+    // Assembled operator and its solver (empty until assembled)
+    std::shared_ptr<Matrix> _A;
+    std::shared_ptr<KrylovSolver> _solver;
+
+    // Boundary dofs (global numbering) of assembled operator
+    std::vector<dolfin::la_index> _boundary_dofs;
+
+    // Number of mesh cells when operator was assembled
+    std::size_t _num_cells;
+
   };
 
 }
@@ -0,0 +1,126 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <dolfin/log/log.h>
+#include "HardwareCounters.h"
+
+using namespace dolfin;
+
+#ifdef __linux__
+namespace
+{
+  // Group of counters of one thread, opened on first use and
+  // closed when the thread exits
+  class CounterGroup
+  {
+  public:
+
+    CounterGroup()
+    {
+      const std::uint64_t config[4] = { PERF_COUNT_HW_CPU_CYCLES,
+                                        PERF_COUNT_HW_INSTRUCTIONS,
+                                        PERF_COUNT_HW_CACHE_REFERENCES,
+                                        PERF_COUNT_HW_CACHE_MISSES };
+      for (std::size_t i = 0; i < 4; ++i)
+      {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config[i];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // Count calling thread on any CPU, grouped with first counter
+        fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1,
+                        i == 0 ? -1 : fd[0], 0);
+      }
+    }
+
+    ~CounterGroup()
+    {
+      for (std::size_t i = 0; i < 4; ++i)
+      {
+        if (fd[i] >= 0)
+          close(fd[i]);
+      }
+    }
+
+    bool valid() const
+    { return fd[0] >= 0 && fd[1] >= 0 && fd[2] >= 0 && fd[3] >= 0; }
+
+    int fd[4];
+  };
+}
+#endif
+
+std::atomic<bool> HardwareCounters::_enabled(false);
+
+//-----------------------------------------------------------------------------
+bool HardwareCounters::enable()
+{
+  Counts counts;
+  if (!read(counts))
+  {
+    #ifndef __linux__
+    warning("Unable to enable hardware counters; only available on GNU/Linux.");
+    #else
+    warning("Unable to enable hardware counters; perf_event_open failed "
+            "(check /proc/sys/kernel/perf_event_paranoid).");
+    #endif
+    return false;
+  }
+
+  _enabled.store(true, std::memory_order_relaxed);
+  return true;
+}
+//-----------------------------------------------------------------------------
+void HardwareCounters::disable()
+{
+  _enabled.store(false, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+bool HardwareCounters::read(Counts& counts)
+{
+  #ifndef __linux__
+  return false;
+
+  #else
+  thread_local CounterGroup group;
+  if (!group.valid())
+    return false;
+
+  // Group read returns number of counters followed by values
+  std::uint64_t data[5];
+  if (::read(group.fd[0], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+    return false;
+  dolfin_assert(data[0] == 4);
+
+  for (std::size_t i = 0; i < 4; ++i)
+    counts[i] = data[i + 1];
+  return true;
+  #endif
+}
+//-----------------------------------------------------------------------------
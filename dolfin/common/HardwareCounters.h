@@ -0,0 +1,74 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __HARDWARE_COUNTERS_H
+#define __HARDWARE_COUNTERS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace dolfin
+{
+
+  /// This class provides access to hardware performance counters of
+  /// the calling thread through the Linux perf_event interface. When
+  /// enabled, named _Timer_ objects record the change of the counters
+  /// between start and stop, which may be listed by passing the
+  /// counter types of _TimingType_ to timings() and list_timings().
+  ///
+  /// The counters are, in order, CPU cycles, instructions, last
+  /// level cache references and last level cache misses in user
+  /// space. Multiplying the cache misses by the cache line size
+  /// (typically 64 bytes) estimates the memory traffic of a region.
+  /// A timer must be stopped on the thread which started it for the
+  /// counts to be meaningful.
+
+  class HardwareCounters
+  {
+  public:
+
+    /// Counter values (cycles, instructions, cache references,
+    /// cache misses)
+    typedef std::array<std::uint64_t, 4> Counts;
+
+    /// Enable counting. Returns false (with a warning) if counters
+    /// are not available, e.g. when not on GNU/Linux or when
+    /// prohibited by /proc/sys/kernel/perf_event_paranoid.
+    static bool enable();
+
+    /// Disable counting
+    static void disable();
+
+    /// Return true if counting is enabled
+    static bool enabled()
+    { return _enabled.load(std::memory_order_relaxed); }
+
+    /// Read counters of calling thread. Returns false if counters
+    /// are not available on this thread.
+    static bool read(Counts& counts);
+
+  private:
+
+    // True if counting is enabled
+    static std::atomic<bool> _enabled;
+
+  };
+
+}
+
+#endif
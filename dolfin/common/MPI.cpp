@@ -182,6 +182,32 @@ void dolfin::MPI::barrier(const MPI_Comm comm)
 #endif
 }
 //-----------------------------------------------------------------------------
+MPI_Comm dolfin::MPI::split(const MPI_Comm comm, unsigned int group_size)
+{
+#ifdef HAS_MPI
+  const int rank = MPI::rank(comm);
+  MPI_Comm group_comm = MPI_COMM_NULL;
+  int err;
+  if (group_size == 0)
+  {
+    err = MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank,
+                              MPI_INFO_NULL, &group_comm);
+  }
+  else
+    err = MPI_Comm_split(comm, rank/group_size, rank, &group_comm);
+
+  if (err != MPI_SUCCESS)
+  {
+    dolfin_error("MPI.cpp",
+                 "split MPI communicator",
+                 "MPI_Comm_split failed");
+  }
+  return group_comm;
+#else
+  return comm;
+#endif
+}
+//-----------------------------------------------------------------------------
 std::size_t dolfin::MPI::global_offset(const MPI_Comm comm,
                                        std::size_t range, bool exclusive)
 {
@@ -356,6 +382,33 @@ std::map<MPI_Op, std::string> dolfin::MPI::operation_map =
 #endif
 //-----------------------------------------------------------------------------
 #ifdef HAS_MPI
+int dolfin::MPI::sparse_exchange_tag(MPI_Comm comm)
+{
+  // Count calls per communicator using an attribute cached on the
+  // communicator (freed with it)
+  static int keyval = MPI_KEYVAL_INVALID;
+  static MPI_Comm_delete_attr_function* delete_fn
+    = [](MPI_Comm, int, void* value, void*)
+    { delete static_cast<int*>(value); return (int) MPI_SUCCESS; };
+  if (keyval == MPI_KEYVAL_INVALID)
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, delete_fn, &keyval, NULL);
+
+  int* count = NULL;
+  int found = 0;
+  MPI_Comm_get_attr(comm, keyval, &count, &found);
+  if (!found)
+  {
+    count = new int(0);
+    MPI_Comm_set_attr(comm, keyval, count);
+  }
+
+  const int tag = 4096 + (*count % 2);
+  ++(*count);
+  return tag;
+}
+#endif
+//-----------------------------------------------------------------------------
+#ifdef HAS_MPI
 MPI_Op dolfin::MPI::MPI_AVG()
 {
   // Return dummy MPI_Op which we identify with average
@@ -24,8 +24,10 @@
 #ifndef __MPI_DOLFIN_WRAPPER_H
 #define __MPI_DOLFIN_WRAPPER_H
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <map>
 #include <numeric>
 #include <type_traits>
 #include <utility>
@@ -140,6 +142,13 @@ namespace dolfin
     /// Set a barrier (synchronization point)
     static void barrier(MPI_Comm comm);
 
+    /// Split communicator into groups of processes that share memory
+    /// (one group per node) if group_size is zero, or otherwise into
+    /// groups of group_size consecutive ranks. Ranks keep their
+    /// relative order within each group. The returned communicator
+    /// must be freed by the caller (MPI_Comm_free).
+    static MPI_Comm split(MPI_Comm comm, unsigned int group_size);
+
     /// Send in_values[p0] to process p0 and receive values from
     /// process p1 in out_values[p1]
     template<typename T>
@@ -155,6 +164,45 @@ namespace dolfin
                              std::vector<std::vector<T>>& in_values,
                              std::vector<T>& out_values);
 
+    /// Send in_values[i] to the i-th destination and receive values
+    /// from the i-th source in out_values[i] on a communicator with a
+    /// distributed graph topology (see MPI_Dist_graph_create_adjacent).
+    /// Only the neighbours of each process are involved in the
+    /// communication.
+    template<typename T>
+      static void neighbor_all_to_all(MPI_Comm comm,
+                                      const std::vector<std::vector<T>>& in_values,
+                                      std::vector<std::vector<T>>& out_values);
+
+    /// Send send_data[send_offsets[i]:send_offsets[i + 1]] to
+    /// process dest[i] and receive the data sent to this process,
+    /// without communication or storage proportional to the number of
+    /// processes. The destinations must be distinct. On return, src
+    /// holds the (sorted) processes that sent data to this process,
+    /// including empty messages, and the data from src[j] is
+    /// recv_data[recv_offsets[j]:recv_offsets[j + 1]]. The receivers
+    /// need not know their sources: the exchange uses the
+    /// non-blocking consensus (NBX) algorithm, based on synchronous
+    /// sends and a non-blocking barrier. This should be used in
+    /// place of all_to_all when each process only communicates with
+    /// a few others.
+    template<typename T>
+      static void sparse_all_to_all(MPI_Comm comm,
+                                    const std::vector<int>& dest,
+                                    const std::vector<int>& send_offsets,
+                                    const std::vector<T>& send_data,
+                                    std::vector<int>& src,
+                                    std::vector<int>& recv_offsets,
+                                    std::vector<T>& recv_data);
+
+    /// Send in_values[p] to process p for each key p and receive the
+    /// values sent by process q in out_values[q] (see the flat
+    /// version of sparse_all_to_all)
+    template<typename T>
+      static void sparse_all_to_all(MPI_Comm comm,
+                                    const std::map<int, std::vector<T>>& in_values,
+                                    std::map<int, std::vector<T>>& out_values);
+
     /// Broadcast vector of value from broadcaster to all processes
     template<typename T>
       static void broadcast(MPI_Comm comm, std::vector<T>& value,
@@ -300,12 +348,20 @@ namespace dolfin
     #ifdef HAS_MPI
     // Maps some MPI_Op values to string
     static std::map<MPI_Op, std::string> operation_map;
+
+    // Return message tag for the next sparse_all_to_all on comm. The
+    // tag alternates between two values for consecutive calls on the
+    // same communicator, so that messages of a following exchange
+    // are never matched by a process still completing the previous
+    // one.
+    static int sparse_exchange_tag(MPI_Comm comm);
     #endif
 
   };
 
   #ifdef HAS_MPI
   // Specialisations for MPI_Datatypes
+  template<> inline MPI_Datatype MPI::mpi_type<char>() { return MPI_CHAR; }
   template<> inline MPI_Datatype MPI::mpi_type<float>() { return MPI_FLOAT; }
   template<> inline MPI_Datatype MPI::mpi_type<double>() { return MPI_DOUBLE; }
   template<> inline MPI_Datatype MPI::mpi_type<short int>() { return MPI_SHORT; }
@@ -444,6 +500,272 @@ namespace dolfin
     #endif
   }
   //---------------------------------------------------------------------------
+  template<typename T>
+    void dolfin::MPI::neighbor_all_to_all(MPI_Comm comm,
+                                          const std::vector<std::vector<T>>& in_values,
+                                          std::vector<std::vector<T>>& out_values)
+  {
+    #ifdef HAS_MPI
+    int indegree = 0, outdegree = 0, weighted = 0;
+    MPI_Dist_graph_neighbors_count(comm, &indegree, &outdegree, &weighted);
+    dolfin_assert(in_values.size() == (std::size_t) outdegree);
+
+    // Data size per destination
+    std::vector<int> data_size_send(outdegree);
+    std::vector<int> data_offset_send(outdegree + 1, 0);
+    for (int p = 0; p < outdegree; ++p)
+    {
+      data_size_send[p] = in_values[p].size();
+      data_offset_send[p + 1] = data_offset_send[p] + data_size_send[p];
+    }
+
+    // Pack data
+    std::vector<T> data_send(data_offset_send[outdegree]);
+    for (int p = 0; p < outdegree; ++p)
+    {
+      std::copy(in_values[p].begin(), in_values[p].end(),
+                data_send.begin() + data_offset_send[p]);
+    }
+
+    std::vector<int> data_size_recv(indegree);
+    std::vector<int> data_offset_recv(indegree + 1, 0);
+    std::vector<T> data_recv;
+
+    #if MPI_VERSION >= 3
+    // Get received data sizes
+    MPI_Neighbor_alltoall(data_size_send.data(), 1, mpi_type<int>(),
+                          data_size_recv.data(), 1, mpi_type<int>(), comm);
+    for (int p = 0; p < indegree; ++p)
+      data_offset_recv[p + 1] = data_offset_recv[p] + data_size_recv[p];
+
+    // Send/receive data
+    data_recv.resize(data_offset_recv[indegree]);
+    MPI_Neighbor_alltoallv(data_send.data(), data_size_send.data(),
+                           data_offset_send.data(), mpi_type<T>(),
+                           data_recv.data(), data_size_recv.data(),
+                           data_offset_recv.data(), mpi_type<T>(), comm);
+    #else
+    // Get neighbours
+    std::vector<int> sources(indegree), source_weights(indegree);
+    std::vector<int> destinations(outdegree), destination_weights(outdegree);
+    MPI_Dist_graph_neighbors(comm, indegree, sources.data(),
+                             source_weights.data(), outdegree,
+                             destinations.data(), destination_weights.data());
+
+    // Get received data sizes
+    std::vector<MPI_Request> requests(indegree + outdegree);
+    for (int p = 0; p < indegree; ++p)
+    {
+      MPI_Irecv(&data_size_recv[p], 1, mpi_type<int>(), sources[p], 0, comm,
+                &requests[p]);
+    }
+    for (int p = 0; p < outdegree; ++p)
+    {
+      MPI_Isend(&data_size_send[p], 1, mpi_type<int>(), destinations[p], 0,
+                comm, &requests[indegree + p]);
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    for (int p = 0; p < indegree; ++p)
+      data_offset_recv[p + 1] = data_offset_recv[p] + data_size_recv[p];
+
+    // Send/receive data
+    data_recv.resize(data_offset_recv[indegree]);
+    for (int p = 0; p < indegree; ++p)
+    {
+      MPI_Irecv(data_recv.data() + data_offset_recv[p], data_size_recv[p],
+                mpi_type<T>(), sources[p], 1, comm, &requests[p]);
+    }
+    for (int p = 0; p < outdegree; ++p)
+    {
+      MPI_Isend(data_send.data() + data_offset_send[p], data_size_send[p],
+                mpi_type<T>(), destinations[p], 1, comm,
+                &requests[indegree + p]);
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    #endif
+
+    // Repack data
+    out_values.resize(indegree);
+    for (int p = 0; p < indegree; ++p)
+    {
+      out_values[p].assign(data_recv.begin() + data_offset_recv[p],
+                           data_recv.begin() + data_offset_recv[p + 1]);
+    }
+    #else
+    out_values = in_values;
+    #endif
+  }
+  //---------------------------------------------------------------------------
+  template<typename T>
+    void dolfin::MPI::sparse_all_to_all(MPI_Comm comm,
+                                        const std::vector<int>& dest,
+                                        const std::vector<int>& send_offsets,
+                                        const std::vector<T>& send_data,
+                                        std::vector<int>& src,
+                                        std::vector<int>& recv_offsets,
+                                        std::vector<T>& recv_data)
+  {
+    dolfin_assert(send_offsets.size() == dest.size() + 1);
+    src.clear();
+    recv_offsets.assign(1, 0);
+    recv_data.clear();
+
+    #ifdef HAS_MPI
+    // Received messages, in order of arrival
+    std::vector<int> arrival_src, arrival_offsets(1, 0);
+    std::vector<T> arrival_data;
+
+    #if MPI_VERSION >= 3
+    const int tag = sparse_exchange_tag(comm);
+
+    // Post synchronous sends. A synchronous send completes only when
+    // it has been matched by a receive on the destination.
+    std::vector<MPI_Request> send_requests(dest.size());
+    for (std::size_t i = 0; i < dest.size(); ++i)
+    {
+      MPI_Issend(const_cast<T*>(send_data.data()) + send_offsets[i],
+                 send_offsets[i + 1] - send_offsets[i], mpi_type<T>(),
+                 dest[i], tag, comm, &send_requests[i]);
+    }
+
+    // Receive messages until the non-blocking barrier completes. A
+    // process enters the barrier once all its sends have been
+    // matched, so completion means that all messages have arrived.
+    MPI_Request barrier_request = MPI_REQUEST_NULL;
+    bool barrier_active = false;
+    while (true)
+    {
+      int message_waiting = 0;
+      MPI_Status status;
+      MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &message_waiting, &status);
+      if (message_waiting)
+      {
+        int count = 0;
+        MPI_Get_count(&status, mpi_type<T>(), &count);
+        const int offset = arrival_offsets.back();
+        arrival_data.resize(offset + count);
+        MPI_Recv(arrival_data.data() + offset, count, mpi_type<T>(),
+                 status.MPI_SOURCE, tag, comm, MPI_STATUS_IGNORE);
+        arrival_src.push_back(status.MPI_SOURCE);
+        arrival_offsets.push_back(offset + count);
+      }
+
+      if (barrier_active)
+      {
+        int barrier_done = 0;
+        MPI_Test(&barrier_request, &barrier_done, MPI_STATUS_IGNORE);
+        if (barrier_done)
+          break;
+      }
+      else
+      {
+        int sends_done = 0;
+        MPI_Testall(send_requests.size(), send_requests.data(), &sends_done,
+                    MPI_STATUSES_IGNORE);
+        if (sends_done)
+        {
+          MPI_Ibarrier(comm, &barrier_request);
+          barrier_active = true;
+        }
+      }
+    }
+    #else
+    // Without a non-blocking barrier, fall back to a dense exchange
+    // of message sizes (-1 if there is no message)
+    const std::size_t comm_size = MPI::size(comm);
+    std::vector<int> size_send(comm_size, -1), size_recv(comm_size);
+    for (std::size_t i = 0; i < dest.size(); ++i)
+      size_send[dest[i]] = send_offsets[i + 1] - send_offsets[i];
+    MPI_Alltoall(size_send.data(), 1, mpi_type<int>(),
+                 size_recv.data(), 1, mpi_type<int>(), comm);
+
+    for (std::size_t p = 0; p < comm_size; ++p)
+    {
+      if (size_recv[p] < 0)
+        continue;
+      arrival_src.push_back(p);
+      arrival_offsets.push_back(arrival_offsets.back() + size_recv[p]);
+    }
+    arrival_data.resize(arrival_offsets.back());
+
+    std::vector<MPI_Request> requests(arrival_src.size() + dest.size());
+    for (std::size_t j = 0; j < arrival_src.size(); ++j)
+    {
+      MPI_Irecv(arrival_data.data() + arrival_offsets[j],
+                arrival_offsets[j + 1] - arrival_offsets[j], mpi_type<T>(),
+                arrival_src[j], 0, comm, &requests[j]);
+    }
+    for (std::size_t i = 0; i < dest.size(); ++i)
+    {
+      MPI_Isend(const_cast<T*>(send_data.data()) + send_offsets[i],
+                send_offsets[i + 1] - send_offsets[i], mpi_type<T>(),
+                dest[i], 0, comm, &requests[arrival_src.size() + i]);
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    #endif
+
+    // Order messages by source process, so that the result does not
+    // depend on the order of arrival
+    std::vector<std::pair<int, std::size_t>> order(arrival_src.size());
+    for (std::size_t j = 0; j < arrival_src.size(); ++j)
+      order[j] = std::make_pair(arrival_src[j], j);
+    std::sort(order.begin(), order.end());
+
+    src.reserve(order.size());
+    recv_data.reserve(arrival_data.size());
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+      const std::size_t j = order[k].second;
+      src.push_back(arrival_src[j]);
+      recv_data.insert(recv_data.end(),
+                       arrival_data.begin() + arrival_offsets[j],
+                       arrival_data.begin() + arrival_offsets[j + 1]);
+      recv_offsets.push_back(recv_data.size());
+    }
+    #else
+    // Only messages to self are possible
+    for (std::size_t i = 0; i < dest.size(); ++i)
+    {
+      dolfin_assert(dest[i] == 0);
+      src.push_back(0);
+      recv_data.insert(recv_data.end(),
+                       send_data.begin() + send_offsets[i],
+                       send_data.begin() + send_offsets[i + 1]);
+      recv_offsets.push_back(recv_data.size());
+    }
+    #endif
+  }
+  //---------------------------------------------------------------------------
+  template<typename T>
+    void dolfin::MPI::sparse_all_to_all(MPI_Comm comm,
+                                        const std::map<int, std::vector<T>>& in_values,
+                                        std::map<int, std::vector<T>>& out_values)
+  {
+    // Flatten send data
+    std::vector<int> dest, send_offsets(1, 0);
+    std::vector<T> send_data;
+    for (auto p = in_values.begin(); p != in_values.end(); ++p)
+    {
+      dest.push_back(p->first);
+      send_data.insert(send_data.end(), p->second.begin(), p->second.end());
+      send_offsets.push_back(send_data.size());
+    }
+
+    // Exchange
+    std::vector<int> src, recv_offsets;
+    std::vector<T> recv_data;
+    sparse_all_to_all(comm, dest, send_offsets, send_data,
+                      src, recv_offsets, recv_data);
+
+    // Unpack received data
+    out_values.clear();
+    for (std::size_t j = 0; j < src.size(); ++j)
+    {
+      out_values[src[j]].assign(recv_data.begin() + recv_offsets[j],
+                                recv_data.begin() + recv_offsets[j + 1]);
+    }
+  }
+  //---------------------------------------------------------------------------
 #ifndef DOXYGEN_IGNORE
   template<> inline
     void dolfin::MPI::all_to_all(MPI_Comm comm,
@@ -0,0 +1,82 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <new>
+
+#include <dolfin/log/log.h>
+#include "MonotonicArena.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+MonotonicArena::MonotonicArena(std::size_t block_size)
+  : _current(nullptr), _remaining(0),
+    _block_size(std::max(block_size, (std::size_t) 1024)), _capacity(0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+MonotonicArena::~MonotonicArena()
+{
+  for (auto& block : _blocks)
+    ::operator delete(block.first);
+}
+//-----------------------------------------------------------------------------
+void MonotonicArena::release()
+{
+  if (_blocks.empty())
+    return;
+
+  // Keep the largest block, which is the most recent one unless a
+  // large request was served by a dedicated block
+  auto largest = std::max_element(_blocks.begin(), _blocks.end(),
+    [](const std::pair<char*, std::size_t>& a,
+       const std::pair<char*, std::size_t>& b)
+    { return a.second < b.second; });
+  const std::pair<char*, std::size_t> kept = *largest;
+  for (auto& block : _blocks)
+  {
+    if (block.first != kept.first)
+      ::operator delete(block.first);
+  }
+
+  _blocks.assign(1, kept);
+  _current = kept.first;
+  _remaining = kept.second;
+  _capacity = kept.second;
+}
+//-----------------------------------------------------------------------------
+void* MonotonicArena::allocate_block(std::size_t bytes, std::size_t alignment)
+{
+  dolfin_assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+  // Blocks from operator new are suitably aligned for any
+  // fundamental type, so padding is only needed within blocks
+  const std::size_t size = std::max(_block_size, bytes);
+  char* block = static_cast<char*>(::operator new(size));
+  _blocks.push_back({block, size});
+  _capacity += size;
+
+  // Grow next block geometrically, and serve request from the new
+  // block
+  _block_size = std::max(_block_size, size)*2;
+  _current = block + bytes;
+  _remaining = size - bytes;
+  return block;
+}
+//-----------------------------------------------------------------------------
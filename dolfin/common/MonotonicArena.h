@@ -0,0 +1,177 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __DOLFIN_MONOTONIC_ARENA_H
+#define __DOLFIN_MONOTONIC_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace dolfin
+{
+
+  /// A monotonic arena hands out memory from large blocks by
+  /// advancing a pointer. Deallocation of individual objects does
+  /// nothing; all memory is returned at once when the arena is
+  /// released or destroyed. Blocks grow geometrically, so that the
+  /// number of blocks is logarithmic in the total size.
+  ///
+  /// Together with _ArenaAllocator_ it is used for the many
+  /// short-lived containers of setup algorithms (in particular
+  /// node-based containers such as std::map and std::set), which
+  /// then cost one allocation per block instead of one per node and
+  /// are freed in one shot at the end of the phase, e.g.
+  ///
+  ///   MonotonicArena arena;
+  ///   std::map<int, int, std::less<int>,
+  ///            ArenaAllocator<std::pair<const int, int>>> m(arena);
+  ///
+  /// An arena is not thread safe, and containers using it must not
+  /// outlive it. Memory of containers that grow by reallocation
+  /// (e.g. std::vector) is not reused until the arena is released,
+  /// so such containers should be reserved in advance.
+
+  class MonotonicArena
+  {
+  public:
+
+    /// Create arena with given size (in bytes) of the first block,
+    /// which is allocated on first use
+    explicit MonotonicArena(std::size_t block_size=64*1024);
+
+    /// Destructor (frees all memory)
+    ~MonotonicArena();
+
+    /// Allocate given number of bytes with given alignment (a power
+    /// of two not larger than alignof(std::max_align_t))
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+      void* p = _current;
+      std::size_t space = _remaining;
+      if (std::align(alignment, bytes, p, space))
+      {
+        _current = static_cast<char*>(p) + bytes;
+        _remaining = space - bytes;
+        return p;
+      }
+      return allocate_block(bytes, alignment);
+    }
+
+    /// Free all memory obtained from the arena. The largest block is
+    /// kept for reuse, so that an arena released at the end of each
+    /// iteration of a loop does not allocate after the first
+    /// iterations.
+    void release();
+
+    /// Return total size (in bytes) of blocks held by the arena
+    std::size_t capacity() const
+    { return _capacity; }
+
+    /// Return number of blocks held by the arena
+    std::size_t num_blocks() const
+    { return _blocks.size(); }
+
+  private:
+
+    // Prevent copying
+    MonotonicArena(const MonotonicArena&);
+    MonotonicArena& operator=(const MonotonicArena&);
+
+    // Allocate new block large enough for given request and
+    // allocate from it
+    void* allocate_block(std::size_t bytes, std::size_t alignment);
+
+    // Blocks (start and size), in order of allocation
+    std::vector<std::pair<char*, std::size_t>> _blocks;
+
+    // Free part of the current block
+    char* _current;
+    std::size_t _remaining;
+
+    // Size of next block
+    std::size_t _block_size;
+
+    // Total size of blocks
+    std::size_t _capacity;
+
+  };
+
+  /// Standard allocator handing out memory from a _MonotonicArena_.
+  /// Containers using it are created from the arena, e.g.
+  ///
+  ///   std::vector<int, ArenaAllocator<int>> v(arena);
+  ///
+  /// Copies of the allocator (including those rebound to other
+  /// types by the container) refer to the same arena and compare
+  /// equal.
+
+  template<typename T>
+  class ArenaAllocator
+  {
+  public:
+
+    /// Value type
+    typedef T value_type;
+
+    /// Rebind to other value type
+    template<typename U>
+    struct rebind { typedef ArenaAllocator<U> other; };
+
+    /// Create allocator for given arena (implicit, so that
+    /// containers may be constructed directly from an arena)
+    ArenaAllocator(MonotonicArena& arena) : _arena(&arena) {}
+
+    /// Create allocator for same arena as allocator of other type
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& allocator)
+      : _arena(&allocator.arena()) {}
+
+    /// Allocate storage for n objects
+    T* allocate(std::size_t n)
+    {
+      return static_cast<T*>(_arena->allocate(n*sizeof(T),
+                                              alignof(T)));
+    }
+
+    /// Deallocate storage (does nothing, memory is returned when
+    /// the arena is released)
+    void deallocate(T*, std::size_t) {}
+
+    /// Return arena
+    MonotonicArena& arena() const
+    { return *_arena; }
+
+  private:
+
+    MonotonicArena* _arena;
+
+  };
+
+  /// Return true if allocators refer to the same arena
+  template<typename T, typename U>
+  bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+  { return &a.arena() == &b.arena(); }
+
+  /// Return true if allocators refer to different arenas
+  template<typename T, typename U>
+  bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+  { return !(a == b); }
+
+}
+
+#endif
@@ -0,0 +1,229 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <dolfin/log/log.h>
+#include "ScopedTimer.h"
+#include "TimingTrace.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Node of call tree, identified by region and parent node
+  struct RegionNode
+  {
+    RegionNode(std::size_t region, std::size_t parent)
+      : region(region), parent(parent), count(0), time(0.0) {}
+
+    std::size_t region;
+    std::size_t parent;
+    std::size_t count;
+    double time;
+    std::vector<std::size_t> children;
+  };
+
+  // Call tree of one thread. Node 0 is the root, which is never
+  // timed. Nodes are referred to by index since the node storage
+  // may be reallocated when new paths are entered.
+  struct RegionTree
+  {
+    RegionTree() : nodes(1, RegionNode(0, 0)), current(0) {}
+
+    std::vector<RegionNode> nodes;
+    std::size_t current;
+  };
+
+  // Registered region names and call trees of all threads which
+  // have entered a region. Trees are owned here so that timings of
+  // finished threads survive until summarised.
+  std::mutex region_mutex;
+  std::vector<std::string> region_names;
+  std::vector<std::unique_ptr<RegionTree>> region_trees;
+
+  // Call tree of calling thread
+  thread_local RegionTree* local_tree = nullptr;
+
+  RegionTree& thread_tree()
+  {
+    if (!local_tree)
+    {
+      std::unique_ptr<RegionTree> tree(new RegionTree);
+      local_tree = tree.get();
+      std::lock_guard<std::mutex> lock(region_mutex);
+      region_trees.push_back(std::move(tree));
+    }
+    return *local_tree;
+  }
+
+  // Accumulate (count, inclusive time, exclusive time) of all
+  // paths below given node
+  void accumulate_paths(
+    const RegionTree& tree, std::size_t node, const std::string& path,
+    std::map<std::string, std::tuple<std::size_t, double, double>>& summary)
+  {
+    for (auto child : tree.nodes[node].children)
+    {
+      const RegionNode& n = tree.nodes[child];
+      if (n.region >= region_names.size())
+      {
+        dolfin_error("ScopedTimer.cpp",
+                     "summarise scoped timings",
+                     "Region id %d has not been registered", n.region);
+      }
+
+      const std::string child_path = path.empty() ? region_names[n.region]
+        : path + "/" + region_names[n.region];
+
+      double time_in_children = 0.0;
+      for (auto grandchild : n.children)
+        time_in_children += tree.nodes[grandchild].time;
+
+      auto& entry = summary[child_path];
+      std::get<0>(entry) += n.count;
+      std::get<1>(entry) += n.time;
+      std::get<2>(entry) += n.time - time_in_children;
+
+      accumulate_paths(tree, child, child_path, summary);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+ScopedTimer::ScopedTimer(std::size_t region) : _running(true)
+{
+  RegionTree& tree = thread_tree();
+  const std::size_t parent = tree.current;
+
+  // Find node for region below current node, creating it when the
+  // path is entered the first time. The number of children is
+  // small in practice, so a linear search is cheapest.
+  _node = 0;
+  for (auto child : tree.nodes[parent].children)
+  {
+    if (tree.nodes[child].region == region)
+    {
+      _node = child;
+      break;
+    }
+  }
+
+  if (_node == 0)
+  {
+    _node = tree.nodes.size();
+    tree.nodes.push_back(RegionNode(region, parent));
+    tree.nodes[parent].children.push_back(_node);
+  }
+
+  tree.current = _node;
+  _start = std::chrono::steady_clock::now();
+}
+//-----------------------------------------------------------------------------
+ScopedTimer::~ScopedTimer()
+{
+  stop();
+}
+//-----------------------------------------------------------------------------
+void ScopedTimer::stop()
+{
+  if (!_running)
+    return;
+
+  const std::chrono::duration<double> elapsed
+    = std::chrono::steady_clock::now() - _start;
+
+  dolfin_assert(local_tree);
+  RegionTree& tree = *local_tree;
+  dolfin_assert(tree.current == _node);
+  RegionNode& node = tree.nodes[_node];
+  node.count += 1;
+  node.time += elapsed.count();
+  tree.current = node.parent;
+  _running = false;
+
+  if (TimingTrace::enabled())
+    TimingTrace::record(node.region, _start, elapsed.count());
+}
+//-----------------------------------------------------------------------------
+std::size_t ScopedTimer::register_region(std::string name)
+{
+  std::lock_guard<std::mutex> lock(region_mutex);
+  for (std::size_t i = 0; i < region_names.size(); ++i)
+  {
+    if (region_names[i] == name)
+      return i;
+  }
+
+  region_names.push_back(name);
+  return region_names.size() - 1;
+}
+//-----------------------------------------------------------------------------
+std::string ScopedTimer::region_name(std::size_t region)
+{
+  std::lock_guard<std::mutex> lock(region_mutex);
+  if (region >= region_names.size())
+  {
+    dolfin_error("ScopedTimer.cpp",
+                 "get region name",
+                 "Region id %d has not been registered", region);
+  }
+  return region_names[region];
+}
+//-----------------------------------------------------------------------------
+Table ScopedTimer::table(TimingClear clear)
+{
+  std::lock_guard<std::mutex> lock(region_mutex);
+
+  // Merge paths over threads
+  std::map<std::string, std::tuple<std::size_t, double, double>> summary;
+  for (const auto& tree : region_trees)
+    accumulate_paths(*tree, 0, "", summary);
+
+  Table table("Summary of scoped timings");
+  for (const auto& it : summary)
+  {
+    // Skip paths which have not been entered since last clear
+    if (std::get<0>(it.second) == 0)
+      continue;
+
+    table(it.first, "reps") = std::get<0>(it.second);
+    table(it.first, "incl") = std::get<1>(it.second);
+    table(it.first, "excl") = std::get<2>(it.second);
+  }
+
+  // Clear timings but keep tree structure, such that running
+  // timers remain valid
+  if (static_cast<bool>(clear))
+  {
+    for (auto& tree : region_trees)
+    {
+      for (auto& node : tree->nodes)
+      {
+        node.count = 0;
+        node.time = 0.0;
+      }
+    }
+  }
+
+  return table;
+}
+//-----------------------------------------------------------------------------
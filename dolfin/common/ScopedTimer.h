@@ -0,0 +1,100 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __SCOPED_TIMER_H
+#define __SCOPED_TIMER_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <dolfin/common/timing.h>
+#include <dolfin/log/Table.h>
+
+namespace dolfin
+{
+
+  /// A scoped timer is a lightweight alternative to _Timer_ for
+  /// timing regions that are entered very often. Regions are
+  /// registered once by name and then referred to by an integer
+  /// id, so entering and leaving a region involves neither string
+  /// handling nor locking. The basic usage is
+  ///
+  ///   static const std::size_t region
+  ///     = ScopedTimer::register_region("Tabulate cell tensor");
+  ///   ScopedTimer timer(region);
+  ///
+  /// Timing starts at construction and ends when the timer is
+  /// destroyed or stopped. Regions entered while another scoped
+  /// timer is active on the same thread are recorded as children
+  /// of that region, so that timings form a call tree per thread.
+  /// Scoped timers must be stopped in reverse order of
+  /// construction on the thread which created them.
+  ///
+  /// A summary with inclusive and exclusive times of all paths in
+  /// the tree, merged over threads, may be obtained by calling
+  ///
+  ///   list_timing_tree(TimingClear::keep);
+
+  class ScopedTimer
+  {
+  public:
+
+    /// Start timing region with given id
+    explicit ScopedTimer(std::size_t region);
+
+    /// Destructor (stops timer if still running)
+    ~ScopedTimer();
+
+    /// Stop timer and record elapsed wall time in region
+    void stop();
+
+    /// Register region with given name and return its id. Repeated
+    /// registration of the same name returns the same id. Thread
+    /// safe.
+    static std::size_t register_region(std::string name);
+
+    /// Return name of region with given id. Thread safe.
+    static std::string region_name(std::size_t region);
+
+    /// Return summary of timed regions on this process with one
+    /// row per path in the call tree (region names joined by '/')
+    /// and columns "reps", "incl" (inclusive wall time) and "excl"
+    /// (wall time not spent in child regions), merged over
+    /// threads. Must not be called while scoped timers are
+    /// running on other threads.
+    static Table table(TimingClear clear);
+
+  private:
+
+    // Prevent copying
+    ScopedTimer(const ScopedTimer&);
+    ScopedTimer& operator=(const ScopedTimer&);
+
+    // Index of node in call tree of this thread
+    std::size_t _node;
+
+    // Start time
+    std::chrono::steady_clock::time_point _start;
+
+    // True if timer is running
+    bool _running;
+
+  };
+
+}
+
+#endif
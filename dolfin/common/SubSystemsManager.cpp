@@ -29,6 +29,8 @@
 #include <slepc.h>
 #endif
 
+#include <chrono>
+#include <mutex>
 #include <boost/algorithm/string/trim.hpp>
 
 #include <dolfin/common/constants.h>
@@ -38,6 +40,17 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Time at which the library was loaded (reference for the startup
+  // timings)
+  const std::chrono::steady_clock::time_point load_time
+    = std::chrono::steady_clock::now();
+
+  // Mutex for startup timings
+  std::mutex startup_mutex;
+}
+
 // Return singleton instance. Do NOT make the singleton a global
 // static object; the method here ensures that the singleton is
 // initialised before use. (google "static initialization order
@@ -50,7 +63,8 @@ SubSystemsManager& SubSystemsManager::singleton()
 }
 //-----------------------------------------------------------------------------
 SubSystemsManager::SubSystemsManager() : petsc_err_msg(""),
-  petsc_initialized(false), control_mpi(false)
+  petsc_initialized(false), slepc_initialized(false), control_mpi(false),
+  thread_level_warning_issued(false)
 {
   // Do nothing
 }
@@ -68,11 +82,20 @@ void SubSystemsManager::init_mpi()
   if (mpi_initialized)
     return;
 
-  // Init MPI with highest level of thread support and take
+  // Init MPI with requested level of thread support and take
   // responsibility
+  const std::string level = dolfin::parameters["mpi_thread_level"];
+  int required_thread_level = MPI_THREAD_MULTIPLE;
+  if (level == "single")
+    required_thread_level = MPI_THREAD_SINGLE;
+  else if (level == "funneled")
+    required_thread_level = MPI_THREAD_FUNNELED;
+  else if (level == "serialized")
+    required_thread_level = MPI_THREAD_SERIALIZED;
+
   std::string s("");
   char* c = const_cast<char *>(s.c_str());
-  SubSystemsManager::init_mpi(0, &c, MPI_THREAD_MULTIPLE);
+  SubSystemsManager::init_mpi(0, &c, required_thread_level);
   singleton().control_mpi = true;
   #else
   // Do nothing
@@ -92,6 +115,7 @@ int SubSystemsManager::init_mpi(int argc, char* argv[],
   int provided = -1;
   MPI_Init_thread(&argc, &argv, required_thread_level, &provided);
   singleton().control_mpi = true;
+  mark_startup_phase("init MPI");
 
   const bool print_thread_support
     = dolfin::parameters["print_mpi_thread_support_level"];
@@ -160,10 +184,6 @@ void SubSystemsManager::init_petsc(int argc, char* argv[])
   if (!is_initialized)
     PetscInitialize(&argc, &argv, NULL, NULL);
 
-  #ifdef HAS_SLEPC
-  SlepcInitialize(&argc, &argv, NULL, NULL);
-  #endif
-
   // Avoid using default PETSc signal handler
   const bool use_petsc_signal_handler = parameters["use_petsc_signal_handler"];
   if (!use_petsc_signal_handler)
@@ -181,6 +201,7 @@ void SubSystemsManager::init_petsc(int argc, char* argv[])
   if (mpi_initialized() && !mpi_init_status)
     singleton().control_mpi = false;
 
+  mark_startup_phase("init PETSc");
   #else
   dolfin_error("SubSystemsManager.cpp",
                "initialize PETSc subsystem",
@@ -188,6 +209,46 @@ void SubSystemsManager::init_petsc(int argc, char* argv[])
   #endif
 }
 //-----------------------------------------------------------------------------
+void SubSystemsManager::init_slepc()
+{
+  #ifdef HAS_SLEPC
+  if (singleton().slepc_initialized)
+    return;
+
+  // Initialize PETSc first (SLEPc options are read from the PETSc
+  // options database)
+  init_petsc();
+  SlepcInitialize(NULL, NULL, NULL, NULL);
+  singleton().slepc_initialized = true;
+  mark_startup_phase("init SLEPc");
+  #else
+  dolfin_error("SubSystemsManager.cpp",
+               "initialize SLEPc subsystem",
+               "DOLFIN has not been configured with SLEPc support");
+  #endif
+}
+//-----------------------------------------------------------------------------
+void SubSystemsManager::mark_startup_phase(std::string phase)
+{
+  const double t = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - load_time).count();
+
+  std::lock_guard<std::mutex> lock(startup_mutex);
+  std::vector<std::pair<std::string, double>>& phases
+    = singleton().startup_phases;
+  for (std::size_t i = 0; i < phases.size(); ++i)
+    if (phases[i].first == phase)
+      return;
+  phases.push_back(std::make_pair(phase, t));
+}
+//-----------------------------------------------------------------------------
+std::vector<std::pair<std::string, double>>
+SubSystemsManager::startup_timings()
+{
+  std::lock_guard<std::mutex> lock(startup_mutex);
+  return singleton().startup_phases;
+}
+//-----------------------------------------------------------------------------
 void SubSystemsManager::finalize()
 {
   // Finalize subsystems in the correct order
@@ -195,6 +256,48 @@ void SubSystemsManager::finalize()
   finalize_mpi();
 }
 //-----------------------------------------------------------------------------
+int SubSystemsManager::mpi_thread_level()
+{
+  #ifdef HAS_MPI
+  int mpi_initialized;
+  MPI_Initialized(&mpi_initialized);
+  if (!mpi_initialized)
+    return -1;
+
+  int provided = -1;
+  MPI_Query_thread(&provided);
+  return provided;
+  #else
+  return -1;
+  #endif
+}
+//-----------------------------------------------------------------------------
+std::size_t SubSystemsManager::num_threads()
+{
+  std::size_t num_threads = 1;
+  #ifdef HAS_OPENMP
+  const std::size_t num_threads_parameter = dolfin::parameters["num_threads"];
+  if (num_threads_parameter > 0)
+    num_threads = num_threads_parameter;
+  #endif
+
+  #ifdef HAS_MPI
+  if (num_threads > 1 && !singleton().thread_level_warning_issued)
+  {
+    const int provided = mpi_thread_level();
+    if (provided != -1 && provided < MPI_THREAD_FUNNELED)
+    {
+      warning("MPI was initialised with MPI_THREAD_SINGLE, but \"num_threads\" "
+              "is %d. Use MPI_THREAD_FUNNELED or higher for hybrid "
+              "MPI/threaded runs", (int) num_threads);
+    }
+    singleton().thread_level_warning_issued = true;
+  }
+  #endif
+
+  return num_threads;
+}
+//-----------------------------------------------------------------------------
 bool SubSystemsManager::responsible_mpi()
 {
   return singleton().control_mpi;
@@ -242,15 +345,21 @@ void SubSystemsManager::finalize_petsc()
   #ifdef HAS_PETSC
   if (singleton().petsc_initialized)
   {
+    // Finalize SLEPc before PETSc (SLEPc was initialized after PETSc
+    // and does not finalize it)
+    #ifdef HAS_SLEPC
+    if (singleton().slepc_initialized)
+    {
+      SlepcFinalize();
+      singleton().slepc_initialized = false;
+    }
+    #endif
+
     if (!PetscFinalizeCalled)
     {
       PetscFinalize();
     }
     singleton().petsc_initialized = false;
-
-    #ifdef HAS_SLEPC
-    SlepcFinalize();
-    #endif
   }
   #else
   // Do nothing
@@ -19,6 +19,8 @@
 #define __SUB_SYSTEMS_MANAGER_H
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #ifdef HAS_PETSC
 #include <petsc.h>
@@ -29,6 +31,31 @@ namespace dolfin
 
   /// This is a singleton class which manages the initialisation and
   /// finalisation of various sub systems, such as MPI and PETSc.
+  ///
+  /// It is also the single place where the shared-memory threading
+  /// of DOLFIN is configured: the threaded algorithms (assembly,
+  /// topology computation, sparsity pattern and dof map building,
+  /// bounding box trees, multimesh quadrature, local solves, Eigen
+  /// vector operations) take their number of threads from
+  /// num_threads(), which reads the global parameter "num_threads".
+  /// The level of thread support requested when DOLFIN initialises
+  /// MPI is set by the global parameter "mpi_thread_level".
+  ///
+  /// Sub systems are initialised on first use: MPI when the first
+  /// communicator is used, PETSc when the first PETSc object is
+  /// created and SLEPc when the first SLEPc eigensolver is created.
+  /// The wall-clock times of these and other startup phases (the
+  /// first mesh and the first assembly) are recorded and returned by
+  /// startup_timings(). For short jobs and large job arrays, startup
+  /// is fastest with the global parameters
+  ///
+  ///     "linear_algebra_backend" = "Eigen"   (PETSc is never initialised)
+  ///     "mpi_thread_level" = "funneled"      (sufficient for threads)
+  ///
+  /// set before the first mesh is created. Asynchronous XDMF output
+  /// (XDMFFile parameter "async_output") makes MPI calls from a
+  /// background thread and requires "multiple"; with a lower level
+  /// output is written synchronously.
 
   class SubSystemsManager
   {
@@ -42,7 +69,8 @@ namespace dolfin
     // Copy constructor
     SubSystemsManager(const SubSystemsManager&) = delete;
 
-    /// Initialise MPI
+    /// Initialise MPI with the level of thread support given by the
+    /// global parameter "mpi_thread_level"
     static void init_mpi();
 
     /// Initialise MPI with required level of thread support
@@ -56,6 +84,18 @@ namespace dolfin
     /// by parameters.parse(argc, argv).
     static void init_petsc(int argc, char* argv[]);
 
+    /// Initialize SLEPc (and PETSc if not initialized)
+    static void init_slepc();
+
+    /// Record the end of a phase of program startup (only the first
+    /// call for each phase is recorded)
+    static void mark_startup_phase(std::string phase);
+
+    /// Return the phases of program startup in order of occurrence,
+    /// with the wall-clock time (in seconds) from loading of the
+    /// DOLFIN library to the end of each phase
+    static std::vector<std::pair<std::string, double>> startup_timings();
+
     /// Finalize subsystems. This will be called by the destructor, but in
     /// special cases it may be necessary to call finalize() explicitly.
     static void finalize();
@@ -76,6 +116,22 @@ namespace dolfin
     /// finalised)
     static bool mpi_finalized();
 
+    /// Return the level of thread support provided by MPI
+    /// (MPI_THREAD_SINGLE, MPI_THREAD_FUNNELED, MPI_THREAD_SERIALIZED
+    /// or MPI_THREAD_MULTIPLE), or -1 if MPI has not been initialised
+    static int mpi_thread_level();
+
+    /// Return the number of threads to be used by the threaded
+    /// algorithms of DOLFIN. This is the global parameter
+    /// "num_threads", or one if the parameter is zero or DOLFIN has
+    /// been built without OpenMP. The worker threads of these
+    /// algorithms do not make MPI calls, so MPI_THREAD_FUNNELED
+    /// suffices for them; a warning is issued (once) if MPI provides
+    /// less than that. Background threads that do make MPI calls
+    /// (asynchronous XDMF output) check for MPI_THREAD_MULTIPLE
+    /// themselves.
+    static std::size_t num_threads();
+
 #ifdef HAS_PETSC
     /// PETSc error handler. Logs everything known to DOLFIN logging
     /// system (with level TRACE) and stores the error message into
@@ -104,7 +160,12 @@ namespace dolfin
 
     // State variables
     bool petsc_initialized;
+    bool slepc_initialized;
     bool control_mpi;
+    bool thread_level_warning_issued;
+
+    // Startup phases and their end times
+    std::vector<std::pair<std::string, double>> startup_phases;
 
   };
 
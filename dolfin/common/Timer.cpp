@@ -21,19 +21,22 @@
 #include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/log/LogManager.h>
 #include "Timer.h"
+#include "TimingTrace.h"
 
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-Timer::Timer() : _task("")
+Timer::Timer() : _task(""), _counting(false)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
-Timer::Timer(std::string task) : _task("")
+Timer::Timer(std::string task) : _task(""), _counting(false)
 {
   const std::string prefix = parameters["timer_prefix"];
   _task = prefix + task;
+  if (HardwareCounters::enabled())
+    _counting = HardwareCounters::read(_counters);
 }
 //-----------------------------------------------------------------------------
 Timer::~Timer()
@@ -45,6 +48,8 @@ Timer::~Timer()
 void Timer::start()
 {
   _timer.start();
+  if (_task.size() > 0 && HardwareCounters::enabled())
+    _counting = HardwareCounters::read(_counters);
 }
 //-----------------------------------------------------------------------------
 void Timer::resume()
@@ -62,7 +67,28 @@ double Timer::stop()
   _timer.stop();
   const auto elapsed = this->elapsed();
   if (_task.size() > 0)
+  {
     LogManager::logger().register_timing(_task, elapsed);
+
+    // Record change of hardware counters
+    HardwareCounters::Counts counters;
+    if (_counting && HardwareCounters::read(counters))
+    {
+      for (std::size_t i = 0; i < counters.size(); ++i)
+        counters[i] -= _counters[i];
+      LogManager::logger().register_counters(_task, counters);
+    }
+    _counting = false;
+
+    // Record event in timeline, recovering start time from wall time
+    if (TimingTrace::enabled())
+    {
+      const std::chrono::duration<double> wall(std::get<0>(elapsed));
+      const auto start = std::chrono::steady_clock::now()
+        - std::chrono::duration_cast<std::chrono::steady_clock::duration>(wall);
+      TimingTrace::record(_task, start, std::get<0>(elapsed));
+    }
+  }
   return std::get<0>(elapsed);
 }
 //-----------------------------------------------------------------------------
@@ -24,6 +24,7 @@
 #include <string>
 #include <tuple>
 #include <boost/timer/timer.hpp>
+#include <dolfin/common/HardwareCounters.h>
 
 namespace dolfin
 {
@@ -43,6 +44,11 @@ namespace dolfin
   /// by calling
   ///
   ///   list_timings();
+  ///
+  /// When hardware counters are enabled (see
+  /// enable_hardware_counters()), a timer with a task name also
+  /// records the counts of the calling thread between start and
+  /// stop.
 
   class Timer
   {
@@ -80,6 +86,10 @@ namespace dolfin
     // Implementation of timer
     boost::timer::cpu_timer _timer;
 
+    // Hardware counters at start, valid if _counting is true
+    HardwareCounters::Counts _counters;
+    bool _counting;
+
   };
 
 }
@@ -0,0 +1,237 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include <dolfin/log/log.h>
+#include "ScopedTimer.h"
+#include "TimingTrace.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Complete event with start time relative to trace origin and
+  // duration, both in microseconds
+  struct TraceEvent
+  {
+    double start;
+    double duration;
+    std::size_t name;
+    bool region;
+  };
+
+  // Ring buffer of events of one thread
+  struct TraceBuffer
+  {
+    TraceBuffer() : count(0) {}
+
+    std::vector<TraceEvent> events;
+    std::size_t count;
+  };
+
+  // Buffers of all threads which have recorded events, interned
+  // task names of named timers, and trace settings
+  std::mutex trace_mutex;
+  std::vector<std::unique_ptr<TraceBuffer>> trace_buffers;
+  std::unordered_map<std::string, std::size_t> task_ids;
+  std::vector<std::string> task_names;
+  std::size_t trace_capacity = 0;
+  std::chrono::steady_clock::time_point trace_origin;
+
+  // Buffer of calling thread
+  thread_local TraceBuffer* local_buffer = nullptr;
+
+  TraceBuffer& thread_buffer()
+  {
+    if (!local_buffer)
+    {
+      std::unique_ptr<TraceBuffer> buffer(new TraceBuffer);
+      local_buffer = buffer.get();
+      std::lock_guard<std::mutex> lock(trace_mutex);
+      trace_buffers.push_back(std::move(buffer));
+    }
+    return *local_buffer;
+  }
+
+  void push_event(std::size_t name, bool region,
+                  std::chrono::steady_clock::time_point start,
+                  double duration)
+  {
+    if (trace_capacity == 0)
+      return;
+
+    const std::chrono::duration<double, std::micro> t
+      = start - trace_origin;
+    const TraceEvent event = {t.count(), 1.0e6*duration, name, region};
+
+    // Overwrite oldest event when buffer is full
+    TraceBuffer& buffer = thread_buffer();
+    if (buffer.events.size() < trace_capacity)
+      buffer.events.push_back(event);
+    else
+      buffer.events[buffer.count % trace_capacity] = event;
+    ++buffer.count;
+  }
+
+  // Escape string for use in JSON
+  std::string json_escape(const std::string& s)
+  {
+    std::stringstream e;
+    for (auto c : s)
+    {
+      if (c == '"' || c == '\\')
+        e << '\\' << c;
+      else if (static_cast<unsigned char>(c) < 0x20)
+        e << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+          << static_cast<int>(c) << std::dec;
+      else
+        e << c;
+    }
+    return e.str();
+  }
+}
+
+std::atomic<bool> TimingTrace::_enabled(false);
+
+//-----------------------------------------------------------------------------
+void TimingTrace::start(MPI_Comm comm, std::size_t events_per_thread)
+{
+  _enabled.store(false, std::memory_order_release);
+
+  {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    for (auto& buffer : trace_buffers)
+    {
+      buffer->events.clear();
+      buffer->count = 0;
+    }
+    trace_capacity = events_per_thread;
+  }
+
+  // Take common time origin on all processes
+  MPI::barrier(comm);
+  trace_origin = std::chrono::steady_clock::now();
+
+  _enabled.store(true, std::memory_order_release);
+}
+//-----------------------------------------------------------------------------
+void TimingTrace::stop()
+{
+  _enabled.store(false, std::memory_order_release);
+}
+//-----------------------------------------------------------------------------
+void TimingTrace::record(const std::string& task,
+                         std::chrono::steady_clock::time_point start,
+                         double duration)
+{
+  std::size_t name = 0;
+  {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    auto it = task_ids.find(task);
+    if (it == task_ids.end())
+    {
+      name = task_names.size();
+      task_ids.insert({task, name});
+      task_names.push_back(task);
+    }
+    else
+      name = it->second;
+  }
+
+  push_event(name, false, start, duration);
+}
+//-----------------------------------------------------------------------------
+void TimingTrace::record(std::size_t region,
+                         std::chrono::steady_clock::time_point start,
+                         double duration)
+{
+  push_event(region, true, start, duration);
+}
+//-----------------------------------------------------------------------------
+void TimingTrace::write(std::string filename, TimingClear clear,
+                        MPI_Comm comm)
+{
+  const std::string suffix = ".json";
+  if (filename.size() < suffix.size()
+      || filename.compare(filename.size() - suffix.size(), suffix.size(),
+                          suffix) != 0)
+  {
+    dolfin_error("TimingTrace.cpp",
+                 "write timing trace",
+                 "Filename \"%s\" does not have suffix \"%s\"",
+                 filename.c_str(), suffix.c_str());
+  }
+
+  // Write one file per process
+  const std::size_t rank = MPI::rank(comm);
+  if (MPI::size(comm) > 1)
+  {
+    filename = filename.substr(0, filename.size() - suffix.size())
+      + "_p" + std::to_string(rank) + suffix;
+  }
+
+  std::ofstream file(filename.c_str());
+  if (!file.is_open())
+  {
+    dolfin_error("TimingTrace.cpp",
+                 "write timing trace",
+                 "Unable to open file \"%s\"", filename.c_str());
+  }
+
+  std::lock_guard<std::mutex> lock(trace_mutex);
+
+  file << std::fixed << std::setprecision(3);
+  file << "{\"traceEvents\":[\n";
+  file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+       << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+  for (std::size_t tid = 0; tid < trace_buffers.size(); ++tid)
+  {
+    // Write events oldest first
+    const TraceBuffer& buffer = *trace_buffers[tid];
+    const std::size_t n = buffer.events.size();
+    const std::size_t first = buffer.count > n ? buffer.count % n : 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const TraceEvent& event = buffer.events[(first + i) % n];
+      const std::string name = event.region
+        ? ScopedTimer::region_name(event.name) : task_names[event.name];
+      file << ",\n{\"name\":\"" << json_escape(name)
+           << "\",\"ph\":\"X\",\"ts\":" << event.start
+           << ",\"dur\":" << event.duration
+           << ",\"pid\":" << rank << ",\"tid\":" << tid << "}";
+    }
+  }
+  file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  // Clear events
+  if (static_cast<bool>(clear))
+  {
+    for (auto& buffer : trace_buffers)
+    {
+      buffer->events.clear();
+      buffer->count = 0;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __TIMING_TRACE_H
+#define __TIMING_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/timing.h>
+
+namespace dolfin
+{
+
+  /// This class records a timeline of the regions timed by _Timer_
+  /// (named timers only) and _ScopedTimer_. Each region is stored
+  /// as one complete event (start time and duration) in a bounded
+  /// ring buffer per thread, such that the most recent events are
+  /// kept when a buffer is full. The timeline is written in the
+  /// Chrome trace event format, which can be viewed in
+  /// chrome://tracing or Perfetto.
+  ///
+  /// Tracing is controlled by the free functions
+  /// start_timing_trace, stop_timing_trace and dump_timing_trace.
+
+  class TimingTrace
+  {
+  public:
+
+    /// Start recording with given number of events per thread,
+    /// discarding previously recorded events. Time stamps are
+    /// relative to a common origin taken after a barrier.
+    /// Collective on given communicator.
+    static void start(MPI_Comm comm, std::size_t events_per_thread);
+
+    /// Stop recording
+    static void stop();
+
+    /// Return true if events are being recorded
+    static bool enabled()
+    { return _enabled.load(std::memory_order_acquire); }
+
+    /// Record event of _Timer_ with given task name
+    static void record(const std::string& task,
+                       std::chrono::steady_clock::time_point start,
+                       double duration);
+
+    /// Record event of _ScopedTimer_ region with given id
+    static void record(std::size_t region,
+                       std::chrono::steady_clock::time_point start,
+                       double duration);
+
+    /// Write recorded events of this process to file in Chrome
+    /// trace format, optionally clearing them. Must not be called
+    /// while timers are running on other threads.
+    static void write(std::string filename, TimingClear clear,
+                      MPI_Comm comm);
+
+  private:
+
+    // True if events are being recorded
+    static std::atomic<bool> _enabled;
+
+  };
+
+}
+
+#endif
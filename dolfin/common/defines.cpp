@@ -161,3 +161,21 @@ bool dolfin::has_hdf5_parallel()
 #endif
 }
 //-------------------------------------------------------------------------
+bool dolfin::has_adios2()
+{
+#ifdef HAS_ADIOS2
+  return true;
+#else
+  return false;
+#endif
+}
+//-------------------------------------------------------------------------
+bool dolfin::has_ascent()
+{
+#ifdef HAS_ASCENT
+  return true;
+#else
+  return false;
+#endif
+}
+//-------------------------------------------------------------------------
@@ -79,6 +79,12 @@ namespace dolfin
   /// Return true if DOLFIN is compiled with Parallel HDF5
   bool has_hdf5_parallel();
 
+  /// Return true if DOLFIN is compiled with ADIOS2
+  bool has_adios2();
+
+  /// Return true if DOLFIN is compiled with Ascent
+  bool has_ascent();
+
 }
 
 #endif
@@ -14,6 +14,9 @@
 #include <dolfin/common/IndexSet.h>
 #include <dolfin/common/Set.h>
 #include <dolfin/common/Timer.h>
+#include <dolfin/common/HardwareCounters.h>
+#include <dolfin/common/ScopedTimer.h>
+#include <dolfin/common/TimingTrace.h>
 #include <dolfin/common/Variable.h>
 #include <dolfin/common/Hierarchical.h>
 #include <dolfin/common/MPI.h>
@@ -23,7 +23,11 @@
 #include <dolfin/log/log.h>
 #include <dolfin/log/LogManager.h>
 #include <dolfin/log/Table.h>
+#include "HardwareCounters.h"
+#include "MPI.h"
+#include "ScopedTimer.h"
 #include "Timer.h"
+#include "TimingTrace.h"
 #include "timing.h"
 
 namespace dolfin
@@ -71,3 +75,50 @@ std::tuple<std::size_t, double, double, double>
   return LogManager::logger().timing(task, clear);
 }
 //-----------------------------------------------------------------------------
+Table dolfin::timing_tree(TimingClear clear)
+{
+  return ScopedTimer::table(clear);
+}
+//-----------------------------------------------------------------------------
+void dolfin::list_timing_tree(TimingClear clear)
+{
+  // Reduce to rank 0
+  const Table t = ScopedTimer::table(clear);
+  const Table t_max = MPI::max(MPI_COMM_WORLD, t);
+  const Table t_min = MPI::min(MPI_COMM_WORLD, t);
+  const Table t_avg = MPI::avg(MPI_COMM_WORLD, t);
+
+  // Print just on rank 0
+  if (MPI::rank(MPI_COMM_WORLD) == 0)
+  {
+    info(t_max.str(true));
+    info(t_min.str(true));
+    info(t_avg.str(true));
+  }
+}
+//-----------------------------------------------------------------------------
+void dolfin::start_timing_trace(std::size_t events_per_thread)
+{
+  TimingTrace::start(MPI_COMM_WORLD, events_per_thread);
+}
+//-----------------------------------------------------------------------------
+void dolfin::stop_timing_trace()
+{
+  TimingTrace::stop();
+}
+//-----------------------------------------------------------------------------
+void dolfin::dump_timing_trace(std::string filename, TimingClear clear)
+{
+  TimingTrace::write(filename, clear, MPI_COMM_WORLD);
+}
+//-----------------------------------------------------------------------------
+bool dolfin::enable_hardware_counters()
+{
+  return HardwareCounters::enable();
+}
+//-----------------------------------------------------------------------------
+void dolfin::disable_hardware_counters()
+{
+  HardwareCounters::disable();
+}
+//-----------------------------------------------------------------------------
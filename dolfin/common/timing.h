@@ -36,10 +36,16 @@ namespace dolfin
   ///   * ``TimingType::wall`` wall-clock time
   ///   * ``TimingType::user`` user (cpu) time
   ///   * ``TimingType::system`` system (kernel) time
+  ///   * ``TimingType::cycles`` CPU cycles
+  ///   * ``TimingType::instructions`` instructions
+  ///   * ``TimingType::cache_references`` last level cache references
+  ///   * ``TimingType::cache_misses`` last level cache misses
   ///
   /// Precision of wall is around 1 microsecond, user and system are around
-  /// 10 millisecond (on Linux).
-  enum class TimingType : int32_t { wall = 0, user = 1, system = 2 };
+  /// 10 millisecond (on Linux). Counter types are only recorded while
+  /// _HardwareCounters_ are enabled, see enable_hardware_counters().
+  enum class TimingType : int32_t { wall = 0, user = 1, system = 2,
+      cycles = 3, instructions = 4, cache_references = 5, cache_misses = 6 };
 
   /// Start timing (should not be used internally in DOLFIN!)
   void tic();
@@ -114,6 +120,72 @@ namespace dolfin
   std::tuple<std::size_t, double, double, double>
     timing(std::string task, TimingClear clear);
 
+  /// Return a summary of regions timed by _ScopedTimer_ on this
+  /// process in a _Table_, optionally clearing stored timings
+  ///
+  /// *Arguments*
+  ///     clear (TimingClear)
+  ///         * ``TimingClear::clear`` resets stored timings
+  ///         * ``TimingClear::keep`` leaves stored timings intact
+  ///
+  /// *Returns*
+  ///     _Table_
+  ///         _Table_ with count, inclusive and exclusive wall time
+  ///         of each path in the call tree
+  Table timing_tree(TimingClear clear);
+
+  /// List a summary of regions timed by _ScopedTimer_, optionally
+  /// clearing stored timings. ``MPI_MAX``, ``MPI_MIN`` and
+  /// ``MPI_AVG`` reductions are printed. Collective on
+  /// ``MPI_COMM_WORLD``.
+  ///
+  /// *Arguments*
+  ///     clear (TimingClear)
+  ///         * ``TimingClear::clear`` resets stored timings
+  ///         * ``TimingClear::keep`` leaves stored timings intact
+  void list_timing_tree(TimingClear clear);
+
+  /// Start recording a timeline of regions timed by named _Timer_
+  /// and _ScopedTimer_ objects, keeping at most the given number of
+  /// most recent events per thread. Collective on
+  /// ``MPI_COMM_WORLD``.
+  ///
+  /// *Arguments*
+  ///     events_per_thread (std::size_t)
+  ///         capacity of the ring buffer of each thread
+  void start_timing_trace(std::size_t events_per_thread);
+
+  /// Stop recording the timeline of timed regions
+  void stop_timing_trace();
+
+  /// Dump recorded timeline of timed regions in Chrome trace format
+  /// (viewable in chrome://tracing or Perfetto), optionally clearing
+  /// recorded events. In parallel, each process writes its own file
+  /// with ``_p<rank>`` inserted before the suffix. Collective on
+  /// ``MPI_COMM_WORLD``.
+  ///
+  /// *Arguments*
+  ///     filename (std::string)
+  ///         output filename; must have ``.json`` suffix; existing
+  ///         file is silently overwritten
+  ///     clear (TimingClear)
+  ///         * ``TimingClear::clear`` discards recorded events
+  ///         * ``TimingClear::keep`` leaves recorded events intact
+  void dump_timing_trace(std::string filename, TimingClear clear);
+
+  /// Enable recording of hardware performance counters (cycles,
+  /// instructions, last level cache references and misses) by named
+  /// timers. The counts are listed by timings() and list_timings()
+  /// for the counter types of _TimingType_.
+  ///
+  /// *Returns*
+  ///     bool
+  ///         false if counters are not available on this system
+  bool enable_hardware_counters();
+
+  /// Disable recording of hardware performance counters
+  void disable_hardware_counters();
+
 }
 
 #endif
@@ -20,6 +20,8 @@
 #ifndef __DOLFIN_TYPES_H
 #define __DOLFIN_TYPES_H
 
+#include <cstdint>
+
 #ifdef HAS_PETSC
 #include <petscsys.h>
 #endif
@@ -34,6 +36,19 @@ namespace dolfin
   typedef int la_index;
   #endif
 
+  /// Index type for process-local indices of mesh entities, dofs and
+  /// matrix entries in data structures built by DOLFIN (32-bit unless
+  /// DOLFIN is configured with DOLFIN_ENABLE_64BIT_LOCAL_INDICES)
+  #if (DOLFIN_LOCAL_INDEX_SIZE==8)
+  typedef std::int64_t local_index;
+  #else
+  typedef std::int32_t local_index;
+  #endif
+
+  /// Index type for global (across all processes) indices of mesh
+  /// entities
+  typedef std::int64_t global_index;
+
 }
 
 #endif
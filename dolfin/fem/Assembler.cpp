@@ -22,32 +22,78 @@
 // Modified by Martin Alnaes 2013-2015
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <string>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
 #include <dolfin/log/log.h>
 #include <dolfin/log/Progress.h>
 #include <dolfin/common/ArrayView.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/parameter/GlobalParameters.h>
+#include <dolfin/la/BlockBatch.h>
 #include <dolfin/la/GenericTensor.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/la/GenericLinearAlgebraFactory.h>
+#include <dolfin/la/IndexMap.h>
+#include <dolfin/la/TensorLayout.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Vertex.h>
+#include <dolfin/mesh/MeshColoring.h>
 #include <dolfin/mesh/MeshData.h>
 #include <dolfin/mesh/MeshFunction.h>
+#include <dolfin/mesh/MeshExteriorFacets.h>
+#include <dolfin/mesh/MeshInteriorFacets.h>
 #include <dolfin/mesh/SubDomain.h>
 #include <dolfin/function/GenericFunction.h>
 #include <dolfin/function/FunctionSpace.h>
 #include "GenericDofMap.h"
 #include "Form.h"
 #include "UFC.h"
+#include "CellBatch.h"
+#include "ElementTensorCache.h"
 #include "FiniteElement.h"
 #include "AssemblerBase.h"
+#include "AssemblyPlan.h"
 #include "Assembler.h"
 
 #include <dolfin/la/GenericMatrix.h>
 
 using namespace dolfin;
 
+namespace
+{
+  // Add the diagonal (or the row sums) of the m x n element tensor
+  // Ae to d at the given row dofs
+  void add_diagonal(GenericVector& d, const std::vector<double>& Ae,
+                    std::size_t m, std::size_t n,
+                    const dolfin::la_index* dofs, bool row_sum,
+                    std::vector<double>& de)
+  {
+    de.assign(m, 0.0);
+    if (row_sum)
+    {
+      for (std::size_t i = 0; i < m; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+          de[i] += Ae[i*n + j];
+    }
+    else
+    {
+      for (std::size_t i = 0; i < m; ++i)
+        de[i] = Ae[i*n + i];
+    }
+    d.add_local(de.data(), m, dofs);
+  }
+}
+
 //----------------------------------------------------------------------------
 void Assembler::assemble(GenericTensor& A, const Form& a)
 {
@@ -74,8 +120,14 @@ void Assembler::assemble(GenericTensor& A, const Form& a)
   // Check form
   AssemblerBase::check(a);
 
-  // Create data structure for local assembly data
-  UFC ufc(a);
+  // Start profile of this call
+  _profile.reset(collect_profile);
+
+  // Create data structure for local assembly data and gather
+  // Function coefficient values once
+  std::shared_ptr<UFC> ufc_data = a.ufc_data();
+  UFC& ufc = *ufc_data;
+  ufc.prefetch_coefficients();
 
   // Update off-process coefficients
   const std::vector<std::shared_ptr<const GenericFunction>>
@@ -99,7 +151,219 @@ void Assembler::assemble(GenericTensor& A, const Form& a)
 
   // Finalize assembly of global tensor
   if (finalize_tensor)
+  {
+    _profile.mark();
     A.apply("add");
+    _profile.lap(AssemblyProfile::apply);
+  }
+
+  SubSystemsManager::mark_startup_phase("first assembly");
+}
+//-----------------------------------------------------------------------------
+void Assembler::assemble_diagonal(GenericVector& d, const Form& a,
+                                  bool row_sum)
+{
+  if (a.rank() != 2)
+  {
+    dolfin_error("Assembler.cpp",
+                 "assemble diagonal",
+                 "Expecting a bilinear form (rank 2), not a form of rank %d",
+                 a.rank());
+  }
+  if (!row_sum && *a.function_space(0) != *a.function_space(1))
+  {
+    dolfin_error("Assembler.cpp",
+                 "assemble diagonal",
+                 "Test and trial spaces differ, only row sums can be assembled");
+  }
+
+  // Check form
+  AssemblerBase::check(a);
+
+  Timer timer("Assemble diagonal");
+
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *a.mesh();
+
+  // Create data structure for local assembly data
+  std::shared_ptr<UFC> ufc_data = a.ufc_data();
+  UFC& ufc = *ufc_data;
+  ufc.prefetch_coefficients();
+  if (ufc.form.has_vertex_integrals())
+  {
+    dolfin_error("Assembler.cpp",
+                 "assemble diagonal",
+                 "Vertex integrals are not supported");
+  }
+
+  // Get dof maps
+  dolfin_assert(a.function_space(0)->dofmap());
+  dolfin_assert(a.function_space(1)->dofmap());
+  const GenericDofMap& dofmap0 = *a.function_space(0)->dofmap();
+  const GenericDofMap& dofmap1 = *a.function_space(1)->dofmap();
+
+  // Initialize vector with the layout of the test space
+  if (d.empty())
+  {
+    std::shared_ptr<TensorLayout> layout
+      = d.factory().create_layout(mesh.mpi_comm(), 1);
+    dolfin_assert(layout);
+    std::vector<std::shared_ptr<const IndexMap>>
+      index_maps(1, dofmap0.index_map());
+    layout->init(index_maps, TensorLayout::Ghosts::UNGHOSTED);
+    d.init(*layout);
+  }
+  else if (d.size() != dofmap0.global_dimension())
+  {
+    dolfin_error("Assembler.cpp",
+                 "assemble diagonal",
+                 "Size of vector does not match test space");
+  }
+  if (!add_values)
+    d.zero();
+
+  std::vector<double> de;
+  std::vector<double> coordinate_dofs[2];
+  ufc::cell ufc_cell[2];
+
+  // Assemble over cells
+  if (ufc.form.has_cell_integrals())
+  {
+    std::shared_ptr<const MeshFunction<std::size_t>> domains
+      = a.cell_domains();
+    const bool use_domains = domains && !domains->empty();
+    ufc::cell_integral* integral = ufc.default_cell_integral.get();
+    for (CellIterator cell(mesh); !cell.end(); ++cell)
+    {
+      if (use_domains)
+        integral = ufc.get_cell_integral((*domains)[*cell]);
+      if (!integral)
+        continue;
+
+      cell->get_cell_data(ufc_cell[0]);
+      cell->get_coordinate_dofs(coordinate_dofs[0]);
+      ufc.update(*cell, coordinate_dofs[0], ufc_cell[0],
+                 integral->enabled_coefficients());
+      integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                                coordinate_dofs[0].data(),
+                                ufc_cell[0].orientation);
+
+      auto dofs0 = dofmap0.cell_dofs(cell->index());
+      auto dofs1 = dofmap1.cell_dofs(cell->index());
+      add_diagonal(d, ufc.A, dofs0.size(), dofs1.size(), dofs0.data(),
+                   row_sum, de);
+    }
+  }
+
+  // Assemble over exterior facets
+  const std::size_t D = mesh.topology().dim();
+  if (ufc.form.has_exterior_facet_integrals())
+  {
+    std::shared_ptr<const MeshFunction<std::size_t>> domains
+      = a.exterior_facet_domains();
+    const bool use_domains = domains && !domains->empty();
+    const ufc::exterior_facet_integral* integral
+      = ufc.default_exterior_facet_integral.get();
+
+    mesh.init(D - 1);
+    mesh.init(D - 1, D);
+    for (FacetIterator facet(mesh); !facet.end(); ++facet)
+    {
+      if (!facet->exterior())
+        continue;
+      if (use_domains)
+        integral = ufc.get_exterior_facet_integral((*domains)[*facet]);
+      if (!integral)
+        continue;
+
+      dolfin_assert(facet->num_entities(D) == 1);
+      const Cell cell(mesh, facet->entities(D)[0]);
+      const std::size_t local_facet = cell.index(*facet);
+
+      cell.get_cell_data(ufc_cell[0], local_facet);
+      cell.get_coordinate_dofs(coordinate_dofs[0]);
+      ufc.update(cell, coordinate_dofs[0], ufc_cell[0],
+                 integral->enabled_coefficients());
+      integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                                coordinate_dofs[0].data(), local_facet,
+                                ufc_cell[0].orientation);
+
+      auto dofs0 = dofmap0.cell_dofs(cell.index());
+      auto dofs1 = dofmap1.cell_dofs(cell.index());
+      add_diagonal(d, ufc.A, dofs0.size(), dofs1.size(), dofs0.data(),
+                   row_sum, de);
+    }
+  }
+
+  // Assemble over interior facets, with the rows of the macro
+  // element tensor ordered as the dofs of the two cells
+  if (ufc.form.has_interior_facet_integrals())
+  {
+    std::shared_ptr<const MeshFunction<std::size_t>> domains
+      = a.interior_facet_domains();
+    std::shared_ptr<const MeshFunction<std::size_t>> cell_domains
+      = a.cell_domains();
+    const bool use_domains = domains && !domains->empty();
+    const bool use_cell_domains = cell_domains && !cell_domains->empty();
+    const ufc::interior_facet_integral* integral
+      = ufc.default_interior_facet_integral.get();
+
+    const MeshInteriorFacets& interior_facets = *mesh.interior_facets();
+    const std::vector<unsigned int>& facets = interior_facets.facets();
+    const std::vector<unsigned int>& facet_cells = interior_facets.cells();
+    const std::vector<std::uint8_t>& local_facets
+      = interior_facets.local_facets();
+    const std::vector<std::uint8_t>& owned = interior_facets.owned();
+    std::vector<dolfin::la_index> macro_dofs;
+    for (std::size_t f = 0; f < interior_facets.size(); ++f)
+    {
+      if (!owned[f])
+        continue;
+      if (use_domains)
+        integral = ufc.get_interior_facet_integral((*domains)[facets[f]]);
+      if (!integral)
+        continue;
+
+      // The convention '+' = 0, '-' = 1 is from ffc
+      std::size_t k[2] = {2*f, 2*f + 1};
+      if (use_cell_domains && (*cell_domains)[facet_cells[k[0]]]
+          < (*cell_domains)[facet_cells[k[1]]])
+      {
+        std::swap(k[0], k[1]);
+      }
+      const Cell cell0(mesh, facet_cells[k[0]]);
+      const Cell cell1(mesh, facet_cells[k[1]]);
+
+      cell0.get_cell_data(ufc_cell[0], local_facets[k[0]]);
+      cell0.get_coordinate_dofs(coordinate_dofs[0]);
+      cell1.get_cell_data(ufc_cell[1], local_facets[k[1]]);
+      cell1.get_coordinate_dofs(coordinate_dofs[1]);
+      ufc.update(cell0, coordinate_dofs[0], ufc_cell[0],
+                 cell1, coordinate_dofs[1], ufc_cell[1],
+                 integral->enabled_coefficients());
+      integral->tabulate_tensor(ufc.macro_A.data(), ufc.macro_w(),
+                                coordinate_dofs[0].data(),
+                                coordinate_dofs[1].data(),
+                                local_facets[k[0]], local_facets[k[1]],
+                                ufc_cell[0].orientation,
+                                ufc_cell[1].orientation);
+
+      auto dofs00 = dofmap0.cell_dofs(cell0.index());
+      auto dofs01 = dofmap0.cell_dofs(cell1.index());
+      const std::size_t n = dofmap1.cell_dofs(cell0.index()).size()
+        + dofmap1.cell_dofs(cell1.index()).size();
+      macro_dofs.resize(dofs00.size() + dofs01.size());
+      std::copy(dofs00.data(), dofs00.data() + dofs00.size(),
+                macro_dofs.begin());
+      std::copy(dofs01.data(), dofs01.data() + dofs01.size(),
+                macro_dofs.begin() + dofs00.size());
+      add_diagonal(d, ufc.macro_A, macro_dofs.size(), n, macro_dofs.data(),
+                   row_sum, de);
+    }
+  }
+
+  if (finalize_tensor)
+    d.apply("add");
 }
 //-----------------------------------------------------------------------------
 void Assembler::assemble_cells(
@@ -113,6 +377,35 @@ void Assembler::assemble_cells(
   if (!ufc.form.has_cell_integrals())
     return;
 
+  // Assemble in shared-memory parallel if requested. Threaded
+  // assembly takes precedence over the options of serial assembly.
+  const std::size_t threads = assembly_threads();
+  if (threads > 0)
+  {
+    const std::size_t form_rank = ufc.form.rank();
+    std::string ignored;
+    if (batch_size > 0)
+      ignored += " batch_size";
+    if (cache_element_tensors && !(values && form_rank == 0))
+      ignored += " cache_element_tensors";
+    if (use_assembly_plan && form_rank == 2)
+      ignored += " use_assembly_plan";
+    if (device_assembly && form_rank == 2)
+      ignored += " device_assembly";
+    if (!ignored.empty())
+      warn_ignored_by_threads(ignored.substr(1));
+
+    assemble_cells_threaded(A, a, ufc, domains, values, threads);
+    return;
+  }
+
+  // Assemble cells in batches if requested
+  if (batch_size > 0 || (device_assembly && ufc.form.rank() == 2))
+  {
+    assemble_cells_batched(A, a, ufc, domains, values);
+    return;
+  }
+
   // Set timer
   Timer timer("Assemble cells");
 
@@ -140,6 +433,33 @@ void Assembler::assemble_cells(
   // Check whether integral is domain-dependent
   bool use_domains = domains && !domains->empty();
 
+  // Prepare cache of cell tensors (if requested)
+  ElementTensorCache* cache = NULL;
+  if (cache_element_tensors && !is_cell_functional
+      && ElementTensorCache::cacheable(a))
+  {
+    std::shared_ptr<ElementTensorCache>& c = _tensor_caches[&a];
+    if (!c)
+      c = std::make_shared<ElementTensorCache>();
+    cache = c.get();
+    cache->update(a, use_domains ? domains : nullptr);
+  }
+
+  // Add cell tensors directly to matrix values (if requested and
+  // the sparsity pattern of the matrix is final)
+  AssemblyPlan* plan = NULL;
+  if (use_assembly_plan && form_rank == 2)
+  {
+    std::shared_ptr<AssemblyPlan>& assembly_plan = _assembly_plans[&a];
+    if (!assembly_plan)
+      assembly_plan = std::make_shared<AssemblyPlan>();
+    if (assembly_plan->begin(A, a))
+      plan = assembly_plan.get();
+  }
+
+  // Cell tensors are added to the global tensor in batches
+  BlockBatch blocks(A);
+
   // Assemble over cells
   ufc::cell ufc_cell;
   std::vector<double> coordinate_dofs;
@@ -157,12 +477,7 @@ void Assembler::assemble_cells(
 
     // Check that cell is not a ghost
     dolfin_assert(!cell->is_ghost());
-
-    // Update to current cell
-    cell->get_cell_data(ufc_cell);
-    cell->get_coordinate_dofs(coordinate_dofs);
-    ufc.update(*cell, coordinate_dofs, ufc_cell,
-               integral->enabled_coefficients());
+    _profile.begin(AssemblyProfile::cells);
 
     // Get local-to-global dof maps for cell
     bool empty_dofmap = false;
@@ -177,20 +492,234 @@ void Assembler::assemble_cells(
     if (empty_dofmap)
       continue;
 
+    // Add stored cell tensor (if any)
+    if (cache && cache->has_tensor(cell->index()))
+    {
+      if (plan)
+        plan->add(cell->index(), cache->tensor(cell->index()));
+      else
+        blocks.add_local(cache->tensor(cell->index()), dofs);
+      _profile.lap(AssemblyProfile::add_local);
+      p++;
+      continue;
+    }
+
+    // Update to current cell
+    cell->get_cell_data(ufc_cell);
+    cell->get_coordinate_dofs(coordinate_dofs);
+    ufc.update(*cell, coordinate_dofs, ufc_cell,
+               integral->enabled_coefficients());
+    _profile.lap(AssemblyProfile::update);
+
     // Tabulate cell tensor
     integral->tabulate_tensor(ufc.A.data(), ufc.w(),
                               coordinate_dofs.data(),
                               ufc_cell.orientation);
+    _profile.lap(AssemblyProfile::tabulate_tensor);
+
+    // Store cell tensor for later assembly
+    if (cache)
+      cache->insert(cell->index(), ufc.A.data());
 
     // Add entries to global tensor. Either store values cell-by-cell
     // (currently only available for functionals)
     if (is_cell_functional)
       (*values)[cell->index()] = ufc.A[0];
+    else if (plan)
+      plan->add(cell->index(), ufc.A.data());
     else
-      A.add_local(ufc.A.data(), dofs);
+      blocks.add_local(ufc.A.data(), dofs);
+    _profile.lap(AssemblyProfile::add_local);
 
     p++;
   }
+  _profile.mark();
+  blocks.flush();
+  _profile.lap(AssemblyProfile::add_local);
+
+  if (plan)
+    plan->end(A);
+}
+//-----------------------------------------------------------------------------
+void Assembler::assemble_cells_batched(
+  GenericTensor& A,
+  const Form& a,
+  UFC& ufc,
+  std::shared_ptr<const MeshFunction<std::size_t>> domains,
+  std::vector<double>* values)
+{
+  // Set timer
+  Timer timer("Assemble cells (batched)");
+
+  // Extract mesh
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *(a.mesh());
+
+  // Form rank
+  const std::size_t form_rank = ufc.form.rank();
+
+  // Collect pointers to dof maps
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < form_rank; ++i)
+    dofmaps.push_back(a.function_space(i)->dofmap().get());
+
+  // Check whether integral is domain-dependent
+  bool use_domains = domains && !domains->empty();
+
+  // Batch size (all cells in one batch for device assembly if no
+  // size is given)
+  const std::size_t max_size = (batch_size > 0) ? batch_size
+    : std::max(mesh.num_cells(), (std::size_t) 1);
+
+  // Add bilinear form tensors with assembly plan for device assembly
+  AssemblyPlan* plan = NULL;
+  if (device_assembly && form_rank == 2)
+  {
+    std::shared_ptr<AssemblyPlan>& assembly_plan = _assembly_plans[&a];
+    if (!assembly_plan)
+      assembly_plan = std::make_shared<AssemblyPlan>();
+    if (assembly_plan->begin(A, a))
+      plan = assembly_plan.get();
+  }
+  std::vector<const DeviceCellIntegral*> device_integrals;
+
+  // Buffers for batch of cells
+  CellBatch batch(a, max_size);
+  std::vector<std::size_t> cells;
+  cells.reserve(max_size);
+
+  // Integral of the current batch (cells of a batch share the
+  // integral)
+  const ufc::cell_integral* batch_integral = NULL;
+
+  // Assemble over cells
+  Progress p(AssemblerBase::progress_message(A.rank(), "cells"),
+             mesh.num_cells());
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    // Get integral for sub domain (if any)
+    const ufc::cell_integral* integral = use_domains
+      ? ufc.get_cell_integral((*domains)[*cell])
+      : ufc.default_cell_integral.get();
+
+    // Skip if no integral on current domain
+    if (!integral)
+      continue;
+
+    // Check that cell is not a ghost
+    dolfin_assert(!cell->is_ghost());
+
+    // Skip if at least one dofmap is empty
+    bool empty_dofmap = false;
+    for (std::size_t i = 0; i < form_rank; ++i)
+      empty_dofmap = empty_dofmap || dofmaps[i]->num_element_dofs(cell->index()) == 0;
+    if (empty_dofmap)
+      continue;
+
+    // Assemble current batch if it is full or the integral changes
+    if (cells.size() == max_size
+        || (batch_integral && integral != batch_integral))
+    {
+      add_cell_batch(A, batch, *batch_integral, cells, dofmaps, values, plan,
+                     device_integrals);
+      cells.clear();
+    }
+
+    batch_integral = integral;
+    cells.push_back(cell->index());
+
+    p++;
+  }
+
+  // Assemble remaining cells
+  if (!cells.empty())
+  {
+    add_cell_batch(A, batch, *batch_integral, cells, dofmaps, values, plan,
+                   device_integrals);
+  }
+
+  // Add device values to matrix
+  if (plan)
+  {
+    _profile.mark();
+    for (std::size_t i = 0; i < device_integrals.size(); ++i)
+      device_integrals[i]->end_device_assembly(plan->values());
+    plan->end(A);
+    _profile.lap(AssemblyProfile::add_local);
+  }
+}
+//-----------------------------------------------------------------------------
+void Assembler::add_cell_batch(GenericTensor& A, CellBatch& batch,
+                               const ufc::cell_integral& integral,
+                               const std::vector<std::size_t>& cells,
+                               const std::vector<const GenericDofMap*>& dofmaps,
+                               std::vector<double>* values,
+                               AssemblyPlan* plan,
+                               std::vector<const DeviceCellIntegral*>& device_integrals)
+{
+  const std::size_t form_rank = dofmaps.size();
+  const bool is_cell_functional = (values && form_rank == 0) ? true : false;
+
+  // Gather cell data
+  _profile.begin(AssemblyProfile::cells, cells.size());
+  batch.gather(cells, integral.enabled_coefficients());
+  _profile.lap(AssemblyProfile::update);
+
+  // Tabulate and add element tensors on the device if the integral
+  // supports it and the values can be added with the plan
+  const DeviceCellIntegral* device_integral
+    = dynamic_cast<const DeviceCellIntegral*>(&integral);
+  if (plan && device_integral)
+  {
+    if (std::find(device_integrals.begin(), device_integrals.end(),
+                  device_integral) == device_integrals.end())
+    {
+      device_integral->begin_device_assembly(plan->num_values(), plan->id());
+      device_integrals.push_back(device_integral);
+    }
+    batch.tabulate_tensor_device(*device_integral, *plan);
+    _profile.lap(AssemblyProfile::tabulate_tensor);
+    return;
+  }
+
+  // Tabulate element tensors
+  batch.tabulate_tensor(integral);
+  _profile.lap(AssemblyProfile::tabulate_tensor);
+
+  // Add entries directly to matrix values with the plan
+  std::vector<double> Ae;
+  if (plan)
+  {
+    for (std::size_t c = 0; c < cells.size(); ++c)
+    {
+      batch.element_tensor(c, Ae);
+      plan->add(cells[c], Ae.data());
+    }
+    _profile.lap(AssemblyProfile::add_local);
+    return;
+  }
+
+  // Add entries to global tensor (all cells of the batch in one
+  // call)
+  std::vector<ArrayView<const dolfin::la_index>> dofs(form_rank);
+  BlockBatch blocks(A, cells.size());
+  for (std::size_t c = 0; c < cells.size(); ++c)
+  {
+    batch.element_tensor(c, Ae);
+    if (is_cell_functional)
+      (*values)[cells[c]] = Ae[0];
+    else
+    {
+      for (std::size_t i = 0; i < form_rank; ++i)
+      {
+        auto dmap = dofmaps[i]->cell_dofs(cells[c]);
+        dofs[i].set(dmap.size(), dmap.data());
+      }
+      blocks.add_local(Ae.data(), dofs);
+    }
+  }
+  blocks.flush();
+  _profile.lap(AssemblyProfile::add_local);
 }
 //-----------------------------------------------------------------------------
 void Assembler::assemble_exterior_facets(
@@ -204,6 +733,14 @@ void Assembler::assemble_exterior_facets(
   if (!ufc.form.has_exterior_facet_integrals())
     return;
 
+  // Assemble in shared-memory parallel if requested
+  const std::size_t threads = assembly_threads();
+  if (threads > 0)
+  {
+    assemble_exterior_facets_threaded(A, a, ufc, domains, threads);
+    return;
+  }
+
   // Set timer
   Timer timer("Assemble exterior facets");
 
@@ -229,15 +766,66 @@ void Assembler::assemble_exterior_facets(
   // Check whether integral is domain-dependent
   bool use_domains = domains && !domains->empty();
 
+  // Without sub domains, assemble over the table of exterior facets,
+  // which needs no facets or facet - cell connectivity
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+  dolfin_assert(mesh.ordered());
+  if (!use_domains)
+  {
+    if (!integral)
+      return;
+
+    std::shared_ptr<const MeshExteriorFacets> exterior_facets
+      = mesh.exterior_facets();
+    const std::vector<unsigned int>& cells = exterior_facets->cells();
+    const std::vector<std::uint8_t>& local_facets
+      = exterior_facets->local_facets();
+    Progress p(AssemblerBase::progress_message(A.rank(), "exterior facets"),
+               cells.size());
+    for (std::size_t f = 0; f < cells.size(); ++f)
+    {
+      _profile.begin(AssemblyProfile::exterior_facets);
+      const Cell mesh_cell(mesh, cells[f]);
+      const std::size_t local_facet = local_facets[f];
+
+      // Update UFC cell and UFC object
+      mesh_cell.get_cell_data(ufc_cell, local_facet);
+      mesh_cell.get_coordinate_dofs(coordinate_dofs);
+      ufc.update(mesh_cell, coordinate_dofs, ufc_cell,
+                 integral->enabled_coefficients());
+
+      // Get local-to-global dof maps for cell
+      for (std::size_t i = 0; i < form_rank; ++i)
+      {
+        auto dmap = dofmaps[i]->cell_dofs(mesh_cell.index());
+        dofs[i].set(dmap.size(), dmap.data());
+      }
+      _profile.lap(AssemblyProfile::update);
+
+      // Tabulate exterior facet tensor
+      integral->tabulate_tensor(ufc.A.data(),
+                                ufc.w(),
+                                coordinate_dofs.data(),
+                                local_facet,
+                                ufc_cell.orientation);
+      _profile.lap(AssemblyProfile::tabulate_tensor);
+
+      // Add entries to global tensor
+      A.add_local(ufc.A.data(), dofs);
+      _profile.lap(AssemblyProfile::add_local);
+
+      p++;
+    }
+    return;
+  }
+
   // Compute facets and facet - cell connectivity if not already computed
   const std::size_t D = mesh.topology().dim();
   mesh.init(D - 1);
   mesh.init(D - 1, D);
-  dolfin_assert(mesh.ordered());
 
   // Assemble over exterior facets (the cells of the boundary)
-  ufc::cell ufc_cell;
-  std::vector<double> coordinate_dofs;
   Progress p(AssemblerBase::progress_message(A.rank(), "exterior facets"),
              mesh.num_facets());
   for (FacetIterator facet(mesh); !facet.end(); ++facet)
@@ -259,6 +847,7 @@ void Assembler::assemble_exterior_facets(
 
     // Get mesh cell to which mesh facet belongs (pick first, there is
     // only one)
+    _profile.begin(AssemblyProfile::exterior_facets);
     dolfin_assert(facet->num_entities(D) == 1);
     Cell mesh_cell(mesh, facet->entities(D)[0]);
 
@@ -282,6 +871,7 @@ void Assembler::assemble_exterior_facets(
       auto dmap = dofmaps[i]->cell_dofs(mesh_cell.index());
       dofs[i].set(dmap.size(), dmap.data());
     }
+    _profile.lap(AssemblyProfile::update);
 
     // Tabulate exterior facet tensor
     integral->tabulate_tensor(ufc.A.data(),
@@ -289,9 +879,11 @@ void Assembler::assemble_exterior_facets(
                               coordinate_dofs.data(),
                               local_facet,
                               ufc_cell.orientation);
+    _profile.lap(AssemblyProfile::tabulate_tensor);
 
     // Add entries to global tensor
     A.add_local(ufc.A.data(), dofs);
+    _profile.lap(AssemblyProfile::add_local);
 
     p++;
   }
@@ -309,6 +901,15 @@ void Assembler::assemble_interior_facets(
   if (!ufc.form.has_interior_facet_integrals())
     return;
 
+  // Assemble in shared-memory parallel if requested
+  const std::size_t threads = assembly_threads();
+  if (threads > 0)
+  {
+    assemble_interior_facets_threaded(A, a, ufc, domains, cell_domains,
+                                      threads);
+    return;
+  }
+
   // Set timer
   Timer timer("Assemble interior facets");
 
@@ -321,9 +922,6 @@ void Assembler::assemble_interior_facets(
                 || mesh.ghost_mode() == "shared_facet"
                 || MPI::size(mesh.mpi_comm()) == 1);
 
-  // MPI rank
-  const int my_mpi_rank = MPI::rank(mesh.mpi_comm());
-
   // Form rank
   const std::size_t form_rank = ufc.form.rank();
 
@@ -344,51 +942,52 @@ void Assembler::assemble_interior_facets(
   bool use_domains = domains && !domains->empty();
   bool use_cell_domains = cell_domains && !cell_domains->empty();
 
-  // Compute facets and facet - cell connectivity if not already computed
-  const std::size_t D = mesh.topology().dim();
-  mesh.init(D - 1);
-  mesh.init(D - 1, D);
+  // Get interior facets with their cells and local facet indices
   dolfin_assert(mesh.ordered());
+  const MeshInteriorFacets& interior_facets = *mesh.interior_facets();
+  const std::vector<unsigned int>& facets = interior_facets.facets();
+  const std::vector<unsigned int>& facet_cells = interior_facets.cells();
+  const std::vector<std::uint8_t>& local_facets
+    = interior_facets.local_facets();
+  const std::vector<std::uint8_t>& owned = interior_facets.owned();
 
   // Assemble over interior facets (the facets of the mesh)
   ufc::cell ufc_cell[2];
   std::vector<double> coordinate_dofs[2];
   Progress p(AssemblerBase::progress_message(A.rank(), "interior facets"),
-             mesh.num_facets());
-  for (FacetIterator facet(mesh); !facet.end(); ++facet)
+             interior_facets.size());
+  for (std::size_t f = 0; f < interior_facets.size(); ++f)
   {
-    if (facet->num_entities(D) == 1)
+    // Skip facets on the process boundary assembled by another
+    // process
+    if (!owned[f])
       continue;
 
-    // Check that facet is not a ghost
-    dolfin_assert(!facet->is_ghost());
-
     // Get integral for sub domain (if any)
     if (use_domains)
-      integral = ufc.get_interior_facet_integral((*domains)[*facet]);
+      integral = ufc.get_interior_facet_integral((*domains)[facets[f]]);
 
     // Skip integral if zero
     if (!integral)
       continue;
 
-    // Get cells incident with facet (which is 0 and 1 here is arbitrary)
-    dolfin_assert(facet->num_entities(D) == 2);
-    std::size_t cell_index_plus = facet->entities(D)[0];
-    std::size_t cell_index_minus = facet->entities(D)[1];
-
-    if (use_cell_domains && (*cell_domains)[cell_index_plus]
-        < (*cell_domains)[cell_index_minus])
+    // Get cells incident with facet (which is 0 and 1 here is
+    // arbitrary) and the local index of facet with respect to each
+    // cell
+    _profile.begin(AssemblyProfile::interior_facets);
+    std::size_t k0 = 2*f;
+    std::size_t k1 = 2*f + 1;
+    if (use_cell_domains && (*cell_domains)[facet_cells[k0]]
+        < (*cell_domains)[facet_cells[k1]])
     {
-      std::swap(cell_index_plus, cell_index_minus);
+      std::swap(k0, k1);
     }
 
     // The convention '+' = 0, '-' = 1 is from ffc
-    const Cell cell0(mesh, cell_index_plus);
-    const Cell cell1(mesh, cell_index_minus);
-
-    // Get local index of facet with respect to each cell
-    std::size_t local_facet0 = cell0.index(*facet);
-    std::size_t local_facet1 = cell1.index(*facet);
+    const Cell cell0(mesh, facet_cells[k0]);
+    const Cell cell1(mesh, facet_cells[k1]);
+    const std::size_t local_facet0 = local_facets[k0];
+    const std::size_t local_facet1 = local_facets[k1];
 
     // Update to current pair of cells
     cell0.get_cell_data(ufc_cell[0], local_facet0);
@@ -417,6 +1016,7 @@ void Assembler::assemble_interior_facets(
                 macro_dofs[i].begin() + cell_dofs0.size());
       macro_dof_ptrs[i].set(macro_dofs[i]);
     }
+    _profile.lap(AssemblyProfile::update);
 
     // Tabulate interior facet tensor on macro element
     integral->tabulate_tensor(ufc.macro_A.data(),
@@ -427,23 +1027,11 @@ void Assembler::assemble_interior_facets(
                               local_facet1,
                               ufc_cell[0].orientation,
                               ufc_cell[1].orientation);
-
-    if (cell0.is_ghost() != cell1.is_ghost())
-    {
-      int ghost_rank = -1;
-      if (cell0.is_ghost())
-        ghost_rank = cell0.owner();
-      else
-        ghost_rank = cell1.owner();
-
-      dolfin_assert(my_mpi_rank != ghost_rank);
-      dolfin_assert(ghost_rank != -1);
-      if (ghost_rank < my_mpi_rank)
-        continue;
-    }
+    _profile.lap(AssemblyProfile::tabulate_tensor);
 
     // Add entries to global tensor
     A.add_local(ufc.macro_A.data(), macro_dof_ptrs);
+    _profile.lap(AssemblyProfile::add_local);
 
     p++;
   }
@@ -597,6 +1185,7 @@ void Assembler::assemble_vertices(
     }
 
     // Get mesh cell to which mesh vertex belongs (pick first)
+    _profile.begin(AssemblyProfile::vertices);
     Cell mesh_cell(mesh, vert->entities(D)[0]);
 
     // Check that cell is not a ghost
@@ -612,6 +1201,7 @@ void Assembler::assemble_vertices(
     // Update UFC object
     ufc.update(mesh_cell, coordinate_dofs, ufc_cell,
                integral->enabled_coefficients());
+    _profile.lap(AssemblyProfile::update);
 
     // Tabulate vertex tensor
     integral->tabulate_tensor(ufc.A.data(),
@@ -619,6 +1209,7 @@ void Assembler::assemble_vertices(
                               coordinate_dofs.data(),
                               local_vertex,
                               ufc_cell.orientation);
+    _profile.lap(AssemblyProfile::tabulate_tensor);
 
     // For rank 1 and 2 tensors we need to check if tabulated dofs for
     // the test space is within the local range
@@ -683,8 +1274,437 @@ void Assembler::assemble_vertices(
       // Add local entries to global tensor
       A.add_local(local_values.data(), global_dofs_p);
     }
+    _profile.lap(AssemblyProfile::add_local);
 
     p++;
   }
 }
 //-----------------------------------------------------------------------------
+void Assembler::assemble_cells_threaded(
+  GenericTensor& A,
+  const Form& a,
+  const UFC& ufc,
+  std::shared_ptr<const MeshFunction<std::size_t>> domains,
+  std::vector<double>* values,
+  std::size_t num_threads)
+{
+  // Set timer
+  Timer timer("Assemble cells (threaded)");
+
+  // Extract mesh
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *(a.mesh());
+  const std::size_t D = mesh.topology().dim();
+
+  // Form rank
+  const std::size_t form_rank = ufc.form.rank();
+
+  // Check if form is a functional
+  const bool is_cell_functional = (values && form_rank == 0) ? true : false;
+
+  // Collect pointers to dof maps
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < form_rank; ++i)
+    dofmaps.push_back(a.function_space(i)->dofmap().get());
+
+  // Check whether integral is domain-dependent
+  const bool use_domains = domains && !domains->empty();
+
+  // Check whether cell tensors of one color can be added
+  // concurrently, otherwise insertion is serialised
+  const bool concurrent = is_cell_functional
+    || AssemblerBase::concurrent_insertion(A, dofmaps);
+
+  // Color cells
+  const std::vector<std::size_t> coloring
+    = {D, MeshColoring::type_to_dim(coloring_type, mesh), D};
+  const std::vector<std::vector<std::size_t>>& cells_of_color
+    = AssemblerBase::colored_entities(mesh, coloring);
+
+  // An exception cannot leave the parallel region, so the first
+  // one is stored and rethrown after it
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  #pragma omp parallel num_threads(num_threads)
+  {
+    // Thread-local assembly data
+    UFC _ufc(ufc);
+    ufc::cell ufc_cell;
+    std::vector<double> coordinate_dofs;
+    std::vector<ArrayView<const dolfin::la_index>> dofs(form_rank);
+
+    for (std::size_t color = 0; color < cells_of_color.size(); ++color)
+    {
+      const std::vector<std::size_t>& cells = cells_of_color[color];
+      const int num_cells = cells.size();
+
+      // Cells of one color are assembled concurrently (implicit
+      // barrier between colors)
+      #pragma omp for schedule(guided, 20)
+      for (int c = 0; c < num_cells; ++c)
+      {
+        // Skip remaining cells after an error
+        if (failed)
+          continue;
+
+        try
+        {
+          const Cell cell(mesh, cells[c]);
+
+          // Ghost cells are not assembled
+          if (cell.is_ghost())
+            continue;
+
+          // Get integral for sub domain (if any)
+          ufc::cell_integral* integral = use_domains
+            ? _ufc.get_cell_integral((*domains)[cell])
+            : _ufc.default_cell_integral.get();
+
+          // Skip if no integral on current domain
+          if (!integral)
+            continue;
+
+          // Update to current cell
+          cell.get_cell_data(ufc_cell);
+          cell.get_coordinate_dofs(coordinate_dofs);
+          _ufc.update(cell, coordinate_dofs, ufc_cell,
+                      integral->enabled_coefficients());
+
+          // Get local-to-global dof maps for cell
+          bool empty_dofmap = false;
+          for (std::size_t i = 0; i < form_rank; ++i)
+          {
+            auto dmap = dofmaps[i]->cell_dofs(cell.index());
+            dofs[i].set(dmap.size(), dmap.data());
+            empty_dofmap = empty_dofmap || dofs[i].size() == 0;
+          }
+
+          // Skip if at least one dofmap is empty
+          if (empty_dofmap)
+            continue;
+
+          // Tabulate cell tensor
+          integral->tabulate_tensor(_ufc.A.data(), _ufc.w(),
+                                    coordinate_dofs.data(),
+                                    ufc_cell.orientation);
+
+          // Add entries to global tensor
+          if (is_cell_functional)
+            (*values)[cell.index()] = _ufc.A[0];
+          else if (concurrent)
+            A.add_local(_ufc.A.data(), dofs);
+          else
+          {
+            #pragma omp critical (dolfin_assembler_add_local)
+            A.add_local(_ufc.A.data(), dofs);
+          }
+        }
+        catch (...)
+        {
+          #pragma omp critical (dolfin_assembler_error)
+          if (!error)
+            error = std::current_exception();
+          failed = true;
+        }
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+//-----------------------------------------------------------------------------
+void Assembler::assemble_exterior_facets_threaded(
+  GenericTensor& A,
+  const Form& a,
+  const UFC& ufc,
+  std::shared_ptr<const MeshFunction<std::size_t>> domains,
+  std::size_t num_threads)
+{
+  // Set timer
+  Timer timer("Assemble exterior facets (threaded)");
+
+  // Extract mesh
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *(a.mesh());
+
+  // Form rank
+  const std::size_t form_rank = ufc.form.rank();
+
+  // Collect pointers to dof maps
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < form_rank; ++i)
+    dofmaps.push_back(a.function_space(i)->dofmap().get());
+
+  // Check whether integral is domain-dependent
+  const bool use_domains = domains && !domains->empty();
+
+  // Compute facets and facet - cell connectivity if not already computed
+  const std::size_t D = mesh.topology().dim();
+  mesh.init(D - 1);
+  mesh.init(D - 1, D);
+  dolfin_assert(mesh.ordered());
+
+  // Check whether facet tensors of one color can be added
+  // concurrently, otherwise insertion is serialised
+  const bool concurrent = AssemblerBase::concurrent_insertion(A, dofmaps);
+
+  // Color facets
+  const std::vector<std::vector<std::size_t>>& facets_of_color
+    = AssemblerBase::colored_entities(mesh, facet_coloring_type(mesh));
+
+  // An exception cannot leave the parallel region, so the first
+  // one is stored and rethrown after it
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  #pragma omp parallel num_threads(num_threads)
+  {
+    // Thread-local assembly data
+    UFC _ufc(ufc);
+    ufc::cell ufc_cell;
+    std::vector<double> coordinate_dofs;
+    std::vector<ArrayView<const dolfin::la_index>> dofs(form_rank);
+
+    for (std::size_t color = 0; color < facets_of_color.size(); ++color)
+    {
+      const std::vector<std::size_t>& facets = facets_of_color[color];
+      const int num_facets = facets.size();
+
+      #pragma omp for schedule(guided, 20)
+      for (int f = 0; f < num_facets; ++f)
+      {
+        // Skip remaining facets after an error
+        if (failed)
+          continue;
+
+        try
+        {
+          const Facet facet(mesh, facets[f]);
+
+          // Only consider exterior facets which are not ghosts
+          if (!facet.exterior() || facet.is_ghost())
+            continue;
+
+          // Get integral for sub domain (if any)
+          const ufc::exterior_facet_integral* integral = use_domains
+            ? _ufc.get_exterior_facet_integral((*domains)[facet])
+            : _ufc.default_exterior_facet_integral.get();
+
+          // Skip integral if zero
+          if (!integral)
+            continue;
+
+          // Get mesh cell to which mesh facet belongs (there is only
+          // one)
+          dolfin_assert(facet.num_entities(D) == 1);
+          const Cell mesh_cell(mesh, facet.entities(D)[0]);
+          dolfin_assert(!mesh_cell.is_ghost());
+
+          // Get local index of facet with respect to the cell
+          const std::size_t local_facet = mesh_cell.index(facet);
+
+          // Update UFC cell and UFC object
+          mesh_cell.get_cell_data(ufc_cell, local_facet);
+          mesh_cell.get_coordinate_dofs(coordinate_dofs);
+          _ufc.update(mesh_cell, coordinate_dofs, ufc_cell,
+                      integral->enabled_coefficients());
+
+          // Get local-to-global dof maps for cell
+          for (std::size_t i = 0; i < form_rank; ++i)
+          {
+            auto dmap = dofmaps[i]->cell_dofs(mesh_cell.index());
+            dofs[i].set(dmap.size(), dmap.data());
+          }
+
+          // Tabulate exterior facet tensor
+          integral->tabulate_tensor(_ufc.A.data(),
+                                    _ufc.w(),
+                                    coordinate_dofs.data(),
+                                    local_facet,
+                                    ufc_cell.orientation);
+
+          // Add entries to global tensor
+          if (concurrent)
+            A.add_local(_ufc.A.data(), dofs);
+          else
+          {
+            #pragma omp critical (dolfin_assembler_add_local)
+            A.add_local(_ufc.A.data(), dofs);
+          }
+        }
+        catch (...)
+        {
+          #pragma omp critical (dolfin_assembler_error)
+          if (!error)
+            error = std::current_exception();
+          failed = true;
+        }
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+//-----------------------------------------------------------------------------
+void Assembler::assemble_interior_facets_threaded(
+  GenericTensor& A,
+  const Form& a,
+  const UFC& ufc,
+  std::shared_ptr<const MeshFunction<std::size_t>> domains,
+  std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
+  std::size_t num_threads)
+{
+  // Set timer
+  Timer timer("Assemble interior facets (threaded)");
+
+  // Extract mesh
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *(a.mesh());
+
+  // Sanity check of ghost mode (proper check in AssemblerBase::check)
+  dolfin_assert(mesh.ghost_mode() == "shared_vertex"
+                || mesh.ghost_mode() == "shared_facet"
+                || MPI::size(mesh.mpi_comm()) == 1);
+
+  // Form rank
+  const std::size_t form_rank = ufc.form.rank();
+
+  // Collect pointers to dof maps
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < form_rank; ++i)
+    dofmaps.push_back(a.function_space(i)->dofmap().get());
+
+  // Check whether integral is domain-dependent
+  const bool use_domains = domains && !domains->empty();
+  const bool use_cell_domains = cell_domains && !cell_domains->empty();
+
+  // Get interior facets with their cells and local facet indices
+  dolfin_assert(mesh.ordered());
+  const MeshInteriorFacets& interior_facets = *mesh.interior_facets();
+  const std::vector<unsigned int>& facet_cells = interior_facets.cells();
+  const std::vector<std::uint8_t>& local_facets
+    = interior_facets.local_facets();
+  const std::vector<std::uint8_t>& owned = interior_facets.owned();
+
+  // Check whether facet tensors of one color can be added
+  // concurrently, otherwise insertion is serialised
+  const bool concurrent = AssemblerBase::concurrent_insertion(A, dofmaps);
+
+  // Color facets
+  const std::vector<std::vector<std::size_t>>& facets_of_color
+    = AssemblerBase::colored_entities(mesh, facet_coloring_type(mesh));
+
+  // An exception cannot leave the parallel region, so the first
+  // one is stored and rethrown after it
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  #pragma omp parallel num_threads(num_threads)
+  {
+    // Thread-local assembly data
+    UFC _ufc(ufc);
+    ufc::cell ufc_cell[2];
+    std::vector<double> coordinate_dofs[2];
+    std::vector<std::vector<dolfin::la_index>> macro_dofs(form_rank);
+    std::vector<ArrayView<const dolfin::la_index>> macro_dof_ptrs(form_rank);
+
+    for (std::size_t color = 0; color < facets_of_color.size(); ++color)
+    {
+      const std::vector<std::size_t>& facets = facets_of_color[color];
+      const int num_facets = facets.size();
+
+      #pragma omp for schedule(guided, 20)
+      for (int i = 0; i < num_facets; ++i)
+      {
+        // Skip remaining facets after an error
+        if (failed)
+          continue;
+
+        try
+        {
+          // Only consider interior facets which are not ghosts, and
+          // which are assembled by this process (facets on the process
+          // boundary are assembled by the lowest rank)
+          const int f = interior_facets.position(facets[i]);
+          if (f < 0 || !owned[f])
+            continue;
+
+          // Get integral for sub domain (if any)
+          const ufc::interior_facet_integral* integral = use_domains
+            ? _ufc.get_interior_facet_integral((*domains)[facets[i]])
+            : _ufc.default_interior_facet_integral.get();
+
+          // Skip integral if zero
+          if (!integral)
+            continue;
+
+          // Get cells incident with facet and the local index of facet
+          // with respect to each cell
+          std::size_t k0 = 2*f;
+          std::size_t k1 = 2*f + 1;
+          if (use_cell_domains && (*cell_domains)[facet_cells[k0]]
+              < (*cell_domains)[facet_cells[k1]])
+          {
+            std::swap(k0, k1);
+          }
+          const Cell cell0(mesh, facet_cells[k0]);
+          const Cell cell1(mesh, facet_cells[k1]);
+          const std::size_t local_facet0 = local_facets[k0];
+          const std::size_t local_facet1 = local_facets[k1];
+
+          // Update to current pair of cells
+          cell0.get_cell_data(ufc_cell[0], local_facet0);
+          cell0.get_coordinate_dofs(coordinate_dofs[0]);
+          cell1.get_cell_data(ufc_cell[1], local_facet1);
+          cell1.get_coordinate_dofs(coordinate_dofs[1]);
+          _ufc.update(cell0, coordinate_dofs[0], ufc_cell[0],
+                      cell1, coordinate_dofs[1], ufc_cell[1],
+                      integral->enabled_coefficients());
+
+          // Tabulate dofs for each dimension on macro element
+          for (std::size_t i = 0; i < form_rank; i++)
+          {
+            auto cell_dofs0 = dofmaps[i]->cell_dofs(cell0.index());
+            auto cell_dofs1 = dofmaps[i]->cell_dofs(cell1.index());
+            macro_dofs[i].resize(cell_dofs0.size() + cell_dofs1.size());
+            std::copy(cell_dofs0.data(), cell_dofs0.data() + cell_dofs0.size(),
+                      macro_dofs[i].begin());
+            std::copy(cell_dofs1.data(), cell_dofs1.data() + cell_dofs1.size(),
+                      macro_dofs[i].begin() + cell_dofs0.size());
+            macro_dof_ptrs[i].set(macro_dofs[i]);
+          }
+
+          // Tabulate interior facet tensor on macro element
+          integral->tabulate_tensor(_ufc.macro_A.data(),
+                                    _ufc.macro_w(),
+                                    coordinate_dofs[0].data(),
+                                    coordinate_dofs[1].data(),
+                                    local_facet0,
+                                    local_facet1,
+                                    ufc_cell[0].orientation,
+                                    ufc_cell[1].orientation);
+
+          // Add entries to global tensor
+          if (concurrent)
+            A.add_local(_ufc.macro_A.data(), macro_dof_ptrs);
+          else
+          {
+            #pragma omp critical (dolfin_assembler_add_local)
+            A.add_local(_ufc.macro_A.data(), macro_dof_ptrs);
+          }
+        }
+        catch (...)
+        {
+          #pragma omp critical (dolfin_assembler_error)
+          if (!error)
+            error = std::current_exception();
+          failed = true;
+        }
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+//-----------------------------------------------------------------------------
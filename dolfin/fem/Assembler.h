@@ -23,15 +23,29 @@
 #ifndef __ASSEMBLER_H
 #define __ASSEMBLER_H
 
+#include <map>
+#include <memory>
 #include <vector>
 #include "AssemblerBase.h"
 
+namespace ufc
+{
+  class cell_integral;
+}
+
 namespace dolfin
 {
 
   // Forward declarations
+  class AssemblyPlan;
+  class CellBatch;
+  class DeviceCellIntegral;
+  class ElementTensorCache;
+  class GenericDofMap;
   class GenericTensor;
+  class GenericVector;
   class Form;
+  class Mesh;
   class UFC;
   template<typename T> class MeshFunction;
 
@@ -65,6 +79,23 @@ namespace dolfin
     ///         The form to assemble the tensor from.
     void assemble(GenericTensor& A, const Form& a);
 
+    /// Assemble the diagonal (or the row sums) of the matrix of a
+    /// bilinear form into a vector, without creating the matrix or
+    /// its sparsity pattern. The row sums of a mass matrix give the
+    /// lumped mass matrix used in explicit time stepping. Cell,
+    /// exterior facet and interior facet integrals are supported.
+    ///
+    /// @param[out] d (GenericVector)
+    ///         The vector to assemble (initialized with the layout
+    ///         of the test space if empty).
+    /// @param[in]  a (Form&)
+    ///         The bilinear form.
+    /// @param[in]  row_sum (bool)
+    ///         Assemble the row sums instead of the diagonal. The
+    ///         diagonal requires equal test and trial spaces.
+    void assemble_diagonal(GenericVector& d, const Form& a,
+                           bool row_sum=false);
+
     /// Assemble tensor from given form over cells. This function is
     /// provided for users who wish to build a customized assembler.
     ///
@@ -125,6 +156,54 @@ namespace dolfin
     void assemble_vertices(GenericTensor& A, const Form& a, UFC& ufc,
                            std::shared_ptr<const MeshFunction<std::size_t>> domains);
 
+  private:
+
+    // Assemble over cells in batches of batch_size cells (of all
+    // cells for device assembly with zero batch_size)
+    void assemble_cells_batched(GenericTensor& A, const Form& a, UFC& ufc,
+                                std::shared_ptr<const MeshFunction<std::size_t>> domains,
+                                std::vector<double>* values);
+
+    // Tabulate element tensors for the cells of a batch and add them
+    // to the global tensor (or to values for cell-wise functionals),
+    // directly with the assembly plan if given, on the device for
+    // device integrals
+    void add_cell_batch(GenericTensor& A, CellBatch& batch,
+                        const ufc::cell_integral& integral,
+                        const std::vector<std::size_t>& cells,
+                        const std::vector<const GenericDofMap*>& dofmaps,
+                        std::vector<double>* values, AssemblyPlan* plan,
+                        std::vector<const DeviceCellIntegral*>& device_integrals);
+
+    // Assemble over cells using a cell coloring, with the cells of
+    // each color assembled concurrently by num_threads threads
+    void assemble_cells_threaded(GenericTensor& A, const Form& a,
+                                 const UFC& ufc,
+                                 std::shared_ptr<const MeshFunction<std::size_t>> domains,
+                                 std::vector<double>* values,
+                                 std::size_t num_threads);
+
+    // Assemble over exterior facets using a facet coloring
+    void assemble_exterior_facets_threaded(GenericTensor& A, const Form& a,
+                                           const UFC& ufc,
+                                           std::shared_ptr<const MeshFunction<std::size_t>> domains,
+                                           std::size_t num_threads);
+
+    // Assemble over interior facets using a facet coloring
+    void assemble_interior_facets_threaded(GenericTensor& A, const Form& a,
+                                           const UFC& ufc,
+                                           std::shared_ptr<const MeshFunction<std::size_t>> domains,
+                                           std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
+                                           std::size_t num_threads);
+
+    // Stored cell tensors for each assembled form (used if
+    // cache_element_tensors is true)
+    std::map<const Form*, std::shared_ptr<ElementTensorCache>> _tensor_caches;
+
+    // Assembly plans for each assembled bilinear form (used if
+    // use_assembly_plan is true)
+    std::map<const Form*, std::shared_ptr<AssemblyPlan>> _assembly_plans;
+
   };
 
 }
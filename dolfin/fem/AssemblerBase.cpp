@@ -23,9 +23,12 @@
 
 #include <memory>
 
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/function/GenericFunction.h>
+#include <dolfin/la/EigenMatrix.h>
+#include <dolfin/la/EigenVector.h>
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericTensor.h>
 #include <dolfin/la/SparsityPattern.h>
@@ -44,6 +47,23 @@
 
 using namespace dolfin;
 
+//-----------------------------------------------------------------------------
+AssemblerBase::AssemblerBase() : add_values(false), finalize_tensor(true),
+                                 keep_diagonal(false),
+                                 num_threads(0),
+                                 coloring_type("vertex"), batch_size(0),
+                                 cache_element_tensors(false),
+                                 use_assembly_plan(false),
+                                 device_assembly(false),
+                                 approximate_preallocation(false),
+                                 collect_profile(false),
+                                 _threads_warning_issued(false)
+{
+  // Assemble with threads if more than one thread is configured
+  const std::size_t threads = SubSystemsManager::num_threads();
+  if (threads > 1)
+    num_threads = threads;
+}
 //-----------------------------------------------------------------------------
 void AssemblerBase::init_global_tensor(GenericTensor& A, const Form& a)
 {
@@ -84,8 +104,21 @@ void AssemblerBase::init_global_tensor(GenericTensor& A, const Form& a)
 
     tensor_layout->init(index_maps, TensorLayout::Ghosts::UNGHOSTED);
 
-    // Build sparsity pattern if required
-    if (tensor_layout->sparsity_pattern())
+    // Build sparsity pattern if required, or compute row counts for
+    // preallocation only
+    const bool row_counts = approximate_preallocation && a.rank() == 2
+      && A.factory().supports_row_count_preallocation();
+    if (row_counts)
+    {
+      std::vector<std::size_t> num_nonzeros_diagonal;
+      std::vector<std::size_t> num_nonzeros_off_diagonal;
+      SparsityPatternBuilder::estimate_num_nonzeros(
+        num_nonzeros_diagonal, num_nonzeros_off_diagonal, mesh, dofmaps,
+        a.ufc_form()->has_interior_facet_integrals(), keep_diagonal);
+      tensor_layout->set_num_nonzeros(num_nonzeros_diagonal,
+                                      num_nonzeros_off_diagonal);
+    }
+    else if (tensor_layout->sparsity_pattern())
     {
       SparsityPattern& pattern = *tensor_layout->sparsity_pattern();
       SparsityPatternBuilder::build(pattern,
@@ -199,6 +232,10 @@ void AssemblerBase::check(const Form& a)
 {
   dolfin_assert(a.ufc_form());
 
+  // Skip checks if the form is unchanged since it was last checked
+  if (a.is_checked())
+    return;
+
   // Check the form
   a.check();
 
@@ -349,6 +386,77 @@ You might have forgotten to specify the value dimension correctly in an Expressi
                  "assemble form",
                  "Mesh is not correctly ordered. Consider calling mesh.order()");
   }
+
+  a.set_checked();
+}
+//-----------------------------------------------------------------------------
+std::size_t AssemblerBase::assembly_threads() const
+{
+  if (num_threads == 0)
+    return 0;
+
+#ifdef HAS_OPENMP
+  return num_threads;
+#else
+  warning("DOLFIN has not been compiled with OpenMP. Threaded assembly "
+          "requested with num_threads = %d will run in serial.", num_threads);
+  return 0;
+#endif
+}
+//-----------------------------------------------------------------------------
+void AssemblerBase::warn_ignored_by_threads(const std::string& options)
+{
+  if (_threads_warning_issued)
+    return;
+
+  warning("Assembler options %s are not supported by threaded assembly "
+          "(num_threads = %d) and are ignored. Set num_threads to zero "
+          "to use them.", options.c_str(), (int) num_threads);
+  _threads_warning_issued = true;
+}
+//-----------------------------------------------------------------------------
+bool AssemblerBase::concurrent_insertion(const GenericTensor& A,
+                            const std::vector<const GenericDofMap*>& dofmaps)
+{
+  // Only the Eigen backend adds values directly into preallocated
+  // storage without touching shared state, e.g. off-process stashes
+  if (!has_type<EigenMatrix>(A) && !has_type<EigenVector>(A))
+    return false;
+
+  // Global dofs are shared by all cells, so colors do not separate
+  // them
+  std::vector<std::size_t> global_dofs;
+  for (auto dofmap : dofmaps)
+  {
+    dolfin_assert(dofmap);
+    dofmap->tabulate_global_dofs(global_dofs);
+    if (!global_dofs.empty())
+      return false;
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------------------
+const std::vector<std::vector<std::size_t>>&
+AssemblerBase::colored_entities(const Mesh& mesh,
+                                const std::vector<std::size_t>& coloring_type)
+{
+  // Color mesh (does nothing if coloring has already been computed)
+  mesh.color(coloring_type);
+
+  // Get coloring data
+  auto coloring_data = mesh.topology().coloring.find(coloring_type);
+  dolfin_assert(coloring_data != mesh.topology().coloring.end());
+
+  return coloring_data->second.second;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t> AssemblerBase::facet_coloring_type(const Mesh& mesh)
+{
+  // Facets are connected if any of their cells share a vertex, which
+  // makes the cell dofs of facets of the same color disjoint
+  const std::size_t D = mesh.topology().dim();
+  return {D - 1, D, 0, D, D - 1};
 }
 //-----------------------------------------------------------------------------
 std::string AssemblerBase::progress_message(std::size_t rank,
@@ -29,13 +29,16 @@
 #include <vector>
 #include <dolfin/common/types.h>
 #include <dolfin/log/log.h>
+#include "AssemblyProfile.h"
 
 namespace dolfin
 {
 
   // Forward declarations
+  class GenericDofMap;
   class GenericTensor;
   class Form;
+  class Mesh;
 
   /// Provide some common functions used in assembler classes.
   class AssemblerBase
@@ -43,8 +46,7 @@ namespace dolfin
   public:
 
     /// Constructor
-    AssemblerBase() : add_values(false), finalize_tensor(true),
-      keep_diagonal(false) {}
+    AssemblerBase();
 
     /// add_values (bool)
     ///     Default value is false.
@@ -66,6 +68,102 @@ namespace dolfin
     ///     if the matrix is finalised.
     bool keep_diagonal;
 
+    /// num_threads (std::size_t)
+    ///     Default value is SubSystemsManager::num_threads() if that
+    ///     is greater than one (set by the global parameter
+    ///     "num_threads"), otherwise zero.
+    ///     If greater than zero, cells and facets are assembled
+    ///     concurrently by this number of OpenMP threads. Entities
+    ///     are grouped by a mesh coloring and the entities of one
+    ///     color are assembled in parallel. Coefficients must be
+    ///     safe to evaluate from multiple threads. Threaded assembly
+    ///     takes precedence over batch_size, cache_element_tensors,
+    ///     use_assembly_plan and device_assembly, which are only
+    ///     supported by serial assembly: they are ignored, with a
+    ///     warning (issued once per assembler), if num_threads is
+    ///     greater than zero.
+    std::size_t num_threads;
+
+    /// coloring_type (std::string)
+    ///     Default value is "vertex".
+    ///     The cell coloring used for threaded assembly ("vertex",
+    ///     "edge" or "facet"). Only "vertex" guarantees that cells of
+    ///     the same color share no degrees of freedom for all
+    ///     elements; "facet" is sufficient for discontinuous
+    ///     elements.
+    std::string coloring_type;
+
+    /// batch_size (std::size_t)
+    ///     Default value is 0.
+    ///     If greater than zero, cell integrals are assembled in
+    ///     batches of (at most) this number of cells. The coordinate
+    ///     dofs and coefficients of a batch are gathered into
+    ///     contiguous buffers and the element tensors are computed in
+    ///     one call for integrals implementing BatchCellIntegral.
+    ///     Ignored if num_threads is greater than zero.
+    std::size_t batch_size;
+
+    /// cache_element_tensors (bool)
+    ///     Default value is false.
+    ///     If true, the cell tensors of forms with Function and
+    ///     Constant coefficients are stored by the assembler and
+    ///     reused when the same form is assembled again with
+    ///     unchanged mesh, cell domains and coefficient values.
+    ///     Useful when a bilinear form is reassembled repeatedly,
+    ///     e.g. in time-stepping loops. Ignored if num_threads is
+    ///     greater than zero.
+    bool cache_element_tensors;
+
+    /// use_assembly_plan (bool)
+    ///     Default value is false.
+    ///     If true, cell tensors of bilinear forms are added
+    ///     directly to the value array of a matrix whose sparsity
+    ///     pattern is final (the matrix has been assembled before),
+    ///     using an _AssemblyPlan_ of precomputed value positions
+    ///     instead of searching for each entry. Supported for
+    ///     _EigenMatrix_ and sequential AIJ _PETScMatrix_; other
+    ///     matrices are assembled as usual. Ignored if num_threads
+    ///     is greater than zero.
+    bool use_assembly_plan;
+
+    /// device_assembly (bool)
+    ///     Default value is false.
+    ///     If true, cell integrals of bilinear forms are assembled in
+    ///     batches (of batch_size cells, or of all cells if
+    ///     batch_size is zero) with an _AssemblyPlan_, and integrals
+    ///     implementing DeviceCellIntegral tabulate and accumulate
+    ///     the element tensors on the device, the assembler only
+    ///     gathering the batch buffers. Other integrals, and
+    ///     matrices not supported by the plan, are assembled by the
+    ///     batched host path. Ignored if num_threads is greater than
+    ///     zero.
+    bool device_assembly;
+
+    /// approximate_preallocation (bool)
+    ///     Default value is false.
+    ///     If true, matrices are preallocated from upper bounds of
+    ///     the number of nonzeros of each row computed from the
+    ///     dofmaps and the cells containing each dof, without
+    ///     building the sparsity pattern. This is cheaper for the
+    ///     first creation of a matrix, at the cost of some unused
+    ///     preallocated memory (released when the matrix is
+    ///     finalized). Only used for backends that support it
+    ///     (PETSc); otherwise the sparsity pattern is built.
+    bool approximate_preallocation;
+
+    /// collect_profile (bool)
+    ///     Default value is false.
+    ///     If true, each call to assemble records the number of
+    ///     assembled entities and the time spent in updating local
+    ///     data, tabulate_tensor, add_local and apply, available
+    ///     from profile() after assembly.
+    bool collect_profile;
+
+    /// Return breakdown of the time spent in the last call to
+    /// assemble (empty unless collect_profile is true)
+    const AssemblyProfile& profile() const
+    { return _profile; }
+
     /// Initialize global tensor
     /// @param[out] A (GenericTensor&)
     ///  GenericTensor to assemble into
@@ -75,9 +173,44 @@ namespace dolfin
 
   protected:
 
+    /// Profile of last call to assemble
+    AssemblyProfile _profile;
+
+    /// True once the warning of warn_ignored_by_threads() has been
+    /// issued
+    bool _threads_warning_issued;
+
     /// Check form
     static void check(const Form& a);
 
+    /// Return the number of threads to use for assembly, which is
+    /// zero for serial assembly (also when DOLFIN has been compiled
+    /// without OpenMP)
+    std::size_t assembly_threads() const;
+
+    /// Warn (once per assembler) that the given options, which are
+    /// only supported by serial assembly, are ignored since
+    /// assembly is threaded
+    void warn_ignored_by_threads(const std::string& options);
+
+    /// Return true if element tensors for entities of the same color
+    /// may be added concurrently to the global tensor A. This
+    /// requires a backend that tolerates concurrent insertion into
+    /// disjoint rows and that no dofmap has global dofs (which are
+    /// shared by all cells).
+    static bool concurrent_insertion(const GenericTensor& A,
+                           const std::vector<const GenericDofMap*>& dofmaps);
+
+    /// Return the entities of each color for the given coloring
+    /// type, coloring the mesh if it has not already been colored
+    static const std::vector<std::vector<std::size_t>>&
+      colored_entities(const Mesh& mesh,
+                       const std::vector<std::size_t>& coloring_type);
+
+    /// Coloring type for facets such that two facets of the same
+    /// color are not connected to cells that share a vertex
+    static std::vector<std::size_t> facet_coloring_type(const Mesh& mesh);
+
     /// Pretty-printing for progress bar
     static std::string progress_message(std::size_t rank,
                                         std::string integral_type);
@@ -0,0 +1,235 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <limits>
+
+#ifdef HAS_PETSC
+#include <petscmat.h>
+#include <dolfin/la/PETScMatrix.h>
+#endif
+
+#include <dolfin/common/Timer.h>
+#include <dolfin/common/UniqueIdGenerator.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/EigenMatrix.h>
+#include <dolfin/la/GenericMatrix.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Mesh.h>
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "AssemblyPlan.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+AssemblyPlan::AssemblyPlan() : _values(NULL), _num_values(0), _id(0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+AssemblyPlan::~AssemblyPlan()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+bool AssemblyPlan::supported(const GenericTensor& A)
+{
+  if (has_type<const EigenMatrix>(A))
+    return true;
+
+  #ifdef HAS_PETSC
+  if (has_type<const PETScMatrix>(A))
+  {
+    // The GPU AIJ types keep a host copy in the SeqAIJ format
+    Mat mat = as_type<const PETScMatrix>(A).mat();
+    PetscBool is_seqaij = PETSC_FALSE;
+    PetscObjectTypeCompareAny((PetscObject) mat, &is_seqaij, MATSEQAIJ,
+                              MATSEQAIJCUSPARSE, MATSEQAIJVIENNACL, "");
+    return is_seqaij == PETSC_TRUE;
+  }
+  #endif
+
+  return false;
+}
+//-----------------------------------------------------------------------------
+bool AssemblyPlan::begin(GenericTensor& A, const Form& a)
+{
+  dolfin_assert(a.rank() == 2);
+  dolfin_assert(a.mesh());
+  _values = NULL;
+
+  if (!supported(A))
+    return false;
+
+  // Key for current matrix and form
+  const GenericMatrix& M = as_type<const GenericMatrix>(A);
+  std::vector<std::size_t> key = {A.id(), M.nnz(), a.mesh()->id(),
+                                  a.function_space(0)->id(),
+                                  a.function_space(1)->id()};
+
+  if (has_type<EigenMatrix>(A))
+  {
+    EigenMatrix::eigen_matrix_type& mat = as_type<EigenMatrix>(A).mat();
+
+    // Sparsity pattern is not final before the matrix is compressed
+    if (!mat.isCompressed())
+      return false;
+
+    // Build plan if necessary
+    if (key != _key)
+    {
+      _key = key;
+      if (!build(a, mat.outerSize(), mat.outerIndexPtr(),
+                 mat.innerIndexPtr()))
+        clear();
+    }
+
+    if (_offsets.empty())
+      return false;
+
+    _values = mat.valuePtr();
+    return true;
+  }
+
+  #ifdef HAS_PETSC
+  if (has_type<PETScMatrix>(A))
+  {
+    Mat mat = as_type<PETScMatrix>(A).mat();
+    PetscErrorCode ierr;
+
+    // Sparsity pattern is not final before the matrix is assembled
+    PetscBool assembled = PETSC_FALSE;
+    ierr = MatAssembled(mat, &assembled);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatAssembled");
+    if (!assembled)
+      return false;
+
+    // Build plan if necessary
+    if (key != _key)
+    {
+      _key = key;
+      PetscInt n = 0;
+      const PetscInt* ia = NULL;
+      const PetscInt* ja = NULL;
+      PetscBool done = PETSC_FALSE;
+      ierr = MatGetRowIJ(mat, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja,
+                         &done);
+      if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatGetRowIJ");
+      if (!done || !build(a, n, ia, ja))
+        clear();
+      ierr = MatRestoreRowIJ(mat, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja,
+                             &done);
+      if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatRestoreRowIJ");
+    }
+
+    if (_offsets.empty())
+      return false;
+
+    ierr = MatSeqAIJGetArray(mat, &_values);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatSeqAIJGetArray");
+    return true;
+  }
+  #endif
+
+  return false;
+}
+//-----------------------------------------------------------------------------
+void AssemblyPlan::end(GenericTensor& A)
+{
+  #ifdef HAS_PETSC
+  if (_values && has_type<PETScMatrix>(A))
+  {
+    Mat mat = as_type<PETScMatrix>(A).mat();
+    PetscErrorCode ierr = MatSeqAIJRestoreArray(mat, &_values);
+    if (ierr != 0)
+      PETScObject::petsc_error(ierr, __FILE__, "MatSeqAIJRestoreArray");
+  }
+  #endif
+
+  _values = NULL;
+}
+//-----------------------------------------------------------------------------
+void AssemblyPlan::clear()
+{
+  _offsets.clear();
+  _positions.clear();
+  _num_values = 0;
+}
+//-----------------------------------------------------------------------------
+void
+AssemblyPlan::gather_positions(const std::vector<std::size_t>& cells,
+                               std::vector<dolfin::local_index>& positions) const
+{
+  dolfin_assert(!_offsets.empty());
+  const std::size_t n = cells.size();
+  const std::size_t num_entries = n > 0
+    ? _offsets[cells[0] + 1] - _offsets[cells[0]] : 0;
+  positions.resize(num_entries*n);
+  for (std::size_t c = 0; c < n; ++c)
+  {
+    dolfin_assert(_offsets[cells[c] + 1] - _offsets[cells[c]] == num_entries);
+    const dolfin::local_index* pos = _positions.data() + _offsets[cells[c]];
+    for (std::size_t k = 0; k < num_entries; ++k)
+      positions[k*n + c] = pos[k];
+  }
+}
+//-----------------------------------------------------------------------------
+template<typename T>
+bool AssemblyPlan::build(const Form& a, std::size_t num_rows,
+                         const T* row_ptr, const T* cols)
+{
+  Timer timer("Build assembly plan");
+  _id = UniqueIdGenerator::id();
+
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *a.mesh();
+  const GenericDofMap& dofmap0 = *a.function_space(0)->dofmap();
+  const GenericDofMap& dofmap1 = *a.function_space(1)->dofmap();
+
+  const std::size_t num_cells = mesh.num_cells();
+  _offsets.assign(num_cells + 1, 0);
+  _positions.clear();
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    auto dofs0 = dofmap0.cell_dofs(c);
+    auto dofs1 = dofmap1.cell_dofs(c);
+
+    // Find position of each (row, column) entry of cell tensor
+    for (Eigen::Index i = 0; i < dofs0.size(); ++i)
+    {
+      const T* row_begin = cols + row_ptr[dofs0[i]];
+      const T* row_end = cols + row_ptr[dofs0[i] + 1];
+      for (Eigen::Index j = 0; j < dofs1.size(); ++j)
+      {
+        const T* pos = std::lower_bound(row_begin, row_end, (T) dofs1[j]);
+        if (pos == row_end || *pos != (T) dofs1[j])
+          return false;
+
+        // Positions must fit the local index type
+        if (pos - cols > std::numeric_limits<dolfin::local_index>::max())
+          return false;
+        _positions.push_back(pos - cols);
+      }
+    }
+    _offsets[c + 1] = _positions.size();
+  }
+  _num_values = row_ptr[num_rows];
+
+  return true;
+}
+//-----------------------------------------------------------------------------
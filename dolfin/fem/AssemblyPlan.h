@@ -0,0 +1,123 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __ASSEMBLY_PLAN_H
+#define __ASSEMBLY_PLAN_H
+
+#include <vector>
+#include <dolfin/common/types.h>
+
+namespace dolfin
+{
+
+  class Form;
+  class GenericTensor;
+
+  /// This class holds an assembly plan for a bilinear form: for each
+  /// cell, the positions in the compressed sparse row (CSR) value
+  /// array of the matrix of the entries in the cell tensor. Once the
+  /// plan has been built, cell tensors are added directly to the
+  /// value array of the matrix without searching for the entries.
+  ///
+  /// The plan requires the sparsity pattern of the matrix to be
+  /// final, i.e. the matrix must have been assembled (finalized)
+  /// once. Direct insertion is supported for _EigenMatrix_ and for
+  /// sequential AIJ _PETScMatrix_, including the CUSPARSE and
+  /// ViennaCL (GPU) AIJ types, for which the values are inserted in
+  /// the host copy and uploaded by PETSc when the matrix is next
+  /// used.
+
+  class AssemblyPlan
+  {
+  public:
+
+    /// Create empty plan
+    AssemblyPlan();
+
+    /// Destructor
+    ~AssemblyPlan();
+
+    /// Return true if direct insertion into A is supported
+    static bool supported(const GenericTensor& A);
+
+    /// Prepare for direct insertion of the cell tensors of form a
+    /// into A, building the plan if the matrix or the form function
+    /// spaces have changed. Returns false if the plan cannot be used
+    /// (in which case tensors must be added with add_local).
+    bool begin(GenericTensor& A, const Form& a);
+
+    /// Add cell tensor to the matrix (between begin and end)
+    void add(std::size_t cell, const double* Ae)
+    {
+      const dolfin::local_index* pos = _positions.data() + _offsets[cell];
+      const std::size_t n = _offsets[cell + 1] - _offsets[cell];
+      for (std::size_t k = 0; k < n; ++k)
+        _values[pos[k]] += Ae[k];
+    }
+
+    /// Gather the positions of the cell tensor entries of the given
+    /// cells, with entry k of cell c at k*cells.size() + c
+    void gather_positions(const std::vector<std::size_t>& cells,
+                          std::vector<dolfin::local_index>& positions) const;
+
+    /// Return CSR value array of the matrix (between begin and end)
+    double* values()
+    { return _values; }
+
+    /// Return number of entries in the CSR value array
+    std::size_t num_values() const
+    { return _num_values; }
+
+    /// Return unique identifier of the plan, which changes whenever
+    /// the plan is rebuilt
+    std::size_t id() const
+    { return _id; }
+
+    /// Finish direct insertion into A
+    void end(GenericTensor& A);
+
+    /// Discard plan
+    void clear();
+
+  private:
+
+    // Build plan from CSR structure of matrix
+    template<typename T>
+      bool build(const Form& a, std::size_t num_rows, const T* row_ptr,
+                 const T* cols);
+
+    // Key identifying the matrix and form the plan was built for
+    std::vector<std::size_t> _key;
+
+    // Offsets into positions for each cell (num_cells + 1)
+    std::vector<std::size_t> _offsets;
+
+    // Positions of cell tensor entries in CSR value array
+    std::vector<dolfin::local_index> _positions;
+
+    // CSR value array of matrix (between begin and end) and its size
+    double* _values;
+    std::size_t _num_values;
+
+    // Unique identifier, renewed when the plan is rebuilt
+    std::size_t _id;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <dolfin/log/Table.h>
+#include "AssemblyProfile.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+AssemblyProfile::AssemblyProfile() : _enabled(false), _type(cells)
+{
+  reset(false);
+}
+//-----------------------------------------------------------------------------
+void AssemblyProfile::reset(bool enabled)
+{
+  _enabled = enabled;
+  _type = cells;
+  _num_entities.fill(0);
+  for (auto& t : _times)
+    t.fill(0.0);
+  _apply_time = 0.0;
+}
+//-----------------------------------------------------------------------------
+double AssemblyProfile::time(EntityType type, Phase phase) const
+{
+  if (phase == apply)
+    return _apply_time;
+  return _times[type][phase];
+}
+//-----------------------------------------------------------------------------
+double AssemblyProfile::entities_per_second(EntityType type) const
+{
+  const double t = _times[type][update] + _times[type][tabulate_tensor]
+    + _times[type][add_local];
+  return t > 0.0 ? _num_entities[type]/t : 0.0;
+}
+//-----------------------------------------------------------------------------
+Table AssemblyProfile::table() const
+{
+  const std::array<std::string, 4> names
+    = {{"cells", "exterior facets", "interior facets", "vertices"}};
+
+  Table t("Assembly profile");
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    if (_num_entities[i] == 0)
+      continue;
+
+    const EntityType type = static_cast<EntityType>(i);
+    t(names[i], "count") = _num_entities[i];
+    t(names[i], "update") = _times[i][update];
+    t(names[i], "tabulate_tensor") = _times[i][tabulate_tensor];
+    t(names[i], "add_local") = _times[i][add_local];
+    t(names[i], "entities/s") = entities_per_second(type);
+  }
+  t("apply", "apply") = _apply_time;
+
+  return t;
+}
+//-----------------------------------------------------------------------------
+std::string AssemblyProfile::str(bool verbose) const
+{
+  return table().str(verbose);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __ASSEMBLY_PROFILE_H
+#define __ASSEMBLY_PROFILE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace dolfin
+{
+
+  class Table;
+
+  /// This class holds a breakdown of the time spent in one call to
+  /// assemble for each type of mesh entity: updating the local data
+  /// (cell data, coordinates, dofs and restriction of coefficients,
+  /// see UFC::update), computing the element tensor
+  /// (tabulate_tensor) and adding it to the global tensor
+  /// (add_local, including the modification for boundary conditions
+  /// in _SystemAssembler_). The time spent in finalizing the global
+  /// tensor (apply) is recorded separately.
+  ///
+  /// Times are measured by the assembler between consecutive calls
+  /// to begin() and lap() and only when collection is enabled (see
+  /// AssemblerBase::collect_profile). Kernel and insertion times are
+  /// not collected for threaded assembly, for which only the apply
+  /// time is recorded.
+
+  class AssemblyProfile
+  {
+  public:
+
+    /// Type of mesh entity assembled over
+    enum EntityType { cells, exterior_facets, interior_facets, vertices };
+
+    /// Phase of assembly of one entity
+    enum Phase { update, tabulate_tensor, add_local, apply };
+
+    /// Create empty profile (collection disabled)
+    AssemblyProfile();
+
+    /// Clear all counts and times and enable or disable collection
+    void reset(bool enabled);
+
+    /// Return true if collection is enabled
+    bool enabled() const
+    { return _enabled; }
+
+    /// Count n entities of given type and start timing their
+    /// assembly
+    void begin(EntityType type, std::size_t n=1)
+    {
+      if (_enabled)
+      {
+        _num_entities[type] += n;
+        _type = type;
+        _t0 = std::chrono::steady_clock::now();
+      }
+    }
+
+    /// Start timing without counting an entity (e.g. before apply)
+    void mark()
+    {
+      if (_enabled)
+        _t0 = std::chrono::steady_clock::now();
+    }
+
+    /// Add time since the last call to begin(), mark() or lap() to
+    /// the given phase of the current entity type
+    void lap(Phase phase)
+    {
+      if (_enabled)
+      {
+        const auto t = std::chrono::steady_clock::now();
+        const std::chrono::duration<double> dt = t - _t0;
+        if (phase == apply)
+          _apply_time += dt.count();
+        else
+          _times[_type][phase] += dt.count();
+        _t0 = t;
+      }
+    }
+
+    /// Return number of assembled entities of given type
+    std::size_t num_entities(EntityType type) const
+    { return _num_entities[type]; }
+
+    /// Return time (in seconds) spent in phase for entities of
+    /// given type, or in apply if phase is apply
+    double time(EntityType type, Phase phase) const;
+
+    /// Return number of entities of given type assembled per second
+    /// (not counting apply)
+    double entities_per_second(EntityType type) const;
+
+    /// Return table with counts, times and rates for each entity
+    /// type that has been assembled over
+    Table table() const;
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // True if collection is enabled
+    bool _enabled;
+
+    // Entity type of current entity
+    EntityType _type;
+
+    // Start of current phase
+    std::chrono::steady_clock::time_point _t0;
+
+    // Number of entities and time in update, tabulate_tensor and
+    // add_local for each entity type
+    std::array<std::size_t, 4> _num_entities;
+    std::array<std::array<double, 3>, 4> _times;
+
+    // Time in apply
+    double _apply_time;
+
+  };
+
+}
+
+#endif
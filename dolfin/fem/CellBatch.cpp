@@ -0,0 +1,255 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <ufc.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/function/GenericFunction.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshGeometry.h>
+#include "FiniteElement.h"
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "AssemblyPlan.h"
+#include "CellBatch.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+CellBatch::CellBatch(const Form& form, std::size_t max_size)
+  : _form(form), _mesh(*form.mesh()), _max_size(max_size),
+    _coefficients(form.coefficients())
+{
+  dolfin_assert(form.ufc_form());
+  dolfin_assert(form.mesh());
+  dolfin_assert(max_size > 0);
+
+  const ufc::form& ufc_form = *form.ufc_form();
+
+  // Size of element tensor
+  _num_entries = 1;
+  for (std::size_t i = 0; i < form.rank(); ++i)
+    _num_entries *= form.function_space(i)->dofmap()->max_element_dofs();
+
+  // Number of coordinate dofs
+  std::unique_ptr<ufc::finite_element>
+    coordinate_element(ufc_form.create_coordinate_finite_element());
+  _num_coordinate_dofs = coordinate_element->space_dimension();
+
+  // Create finite elements for coefficients and allocate storage
+  const std::size_t num_coefficients = ufc_form.num_coefficients();
+  _w.resize(num_coefficients);
+  _cell_w.resize(num_coefficients);
+  for (std::size_t i = 0; i < num_coefficients; ++i)
+  {
+    std::shared_ptr<ufc::finite_element>
+      element(ufc_form.create_finite_element(form.rank() + i));
+    _coefficient_elements.push_back(FiniteElement(element));
+    _w[i].resize(element->space_dimension()*_max_size);
+    _cell_w[i].resize(element->space_dimension());
+  }
+
+  _w_pointer.resize(num_coefficients);
+  _cell_w_pointer.resize(num_coefficients);
+  for (std::size_t i = 0; i < num_coefficients; ++i)
+  {
+    _w_pointer[i] = _w[i].data();
+    _cell_w_pointer[i] = _cell_w[i].data();
+  }
+
+  _A.resize(_num_entries*_max_size);
+  _coordinate_dofs.resize(_num_coordinate_dofs*_max_size);
+  _cell_orientations.resize(_max_size);
+  _Ae.resize(_num_entries);
+  _cell_coordinate_dofs.resize(_num_coordinate_dofs);
+  _cells.reserve(_max_size);
+}
+//-----------------------------------------------------------------------------
+CellBatch::~CellBatch()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void CellBatch::gather(const std::vector<std::size_t>& cells,
+                       const std::vector<bool>& enabled_coefficients)
+{
+  if (cells.size() > _max_size)
+  {
+    dolfin_error("CellBatch.cpp",
+                 "gather data for batch of cells",
+                 "Number of cells (%d) exceeds batch size (%d)",
+                 cells.size(), _max_size);
+  }
+
+  _cells = cells;
+  _enabled_coefficients = enabled_coefficients;
+  const std::size_t n = _cells.size();
+
+  // Gather coordinate dofs. Affine geometries are read directly from
+  // the coordinate array, higher-order geometries through the
+  // cell-to-point map.
+  if (_mesh.geometry().degree() > 1)
+    _mesh.init_cell_points();
+  const MeshGeometry& geometry = _mesh.geometry();
+  const std::size_t gdim = geometry.dim();
+  const std::size_t tdim = _mesh.topology().dim();
+  const MeshConnectivity& cell_vertices = _mesh.topology()(tdim, 0);
+  const std::vector<int>& orientations = _mesh.cell_orientations();
+  for (std::size_t c = 0; c < n; ++c)
+  {
+    if (geometry.degree() == 1)
+    {
+      const unsigned int* vertices = cell_vertices(_cells[c]);
+      const std::size_t num_vertices = _num_coordinate_dofs/gdim;
+      for (std::size_t i = 0; i < num_vertices; ++i)
+      {
+        const double* x = geometry.x(vertices[i]);
+        for (std::size_t j = 0; j < gdim; ++j)
+          _coordinate_dofs[(i*gdim + j)*n + c] = x[j];
+      }
+    }
+    else
+    {
+      dolfin_assert(geometry.num_cell_points()*gdim == _num_coordinate_dofs);
+      _cell_coordinate_dofs.resize(_num_coordinate_dofs);
+      geometry.get_coordinate_dofs(_cells[c], _cell_coordinate_dofs.data());
+      for (std::size_t k = 0; k < _num_coordinate_dofs; ++k)
+        _coordinate_dofs[k*n + c] = _cell_coordinate_dofs[k];
+    }
+
+    _cell_orientations[c] = orientations.empty() ? -1
+      : orientations[_cells[c]];
+  }
+
+  // Gather coefficients
+  for (std::size_t i = 0; i < _coefficients.size(); ++i)
+  {
+    if (enabled_coefficients[i])
+      gather_coefficient(i);
+  }
+}
+//-----------------------------------------------------------------------------
+void CellBatch::tabulate_tensor(const ufc::cell_integral& integral)
+{
+  const std::size_t n = _cells.size();
+
+  // Use batch kernel if provided by the integral
+  const BatchCellIntegral* batch_integral
+    = dynamic_cast<const BatchCellIntegral*>(&integral);
+  if (batch_integral)
+  {
+    batch_integral->tabulate_tensor_batch(_A.data(), _w_pointer.data(),
+                                          _coordinate_dofs.data(),
+                                          _cell_orientations.data(), n);
+    return;
+  }
+
+  // Fall back to a loop over the cells, calling the scalar kernel
+  for (std::size_t c = 0; c < n; ++c)
+  {
+    for (std::size_t k = 0; k < _num_coordinate_dofs; ++k)
+      _cell_coordinate_dofs[k] = _coordinate_dofs[k*n + c];
+
+    for (std::size_t i = 0; i < _coefficients.size(); ++i)
+    {
+      if (!_enabled_coefficients[i])
+        continue;
+      std::vector<double>& w = _cell_w[i];
+      for (std::size_t k = 0; k < w.size(); ++k)
+        w[k] = _w[i][k*n + c];
+    }
+
+    integral.tabulate_tensor(_Ae.data(), _cell_w_pointer.data(),
+                             _cell_coordinate_dofs.data(),
+                             _cell_orientations[c]);
+
+    for (std::size_t k = 0; k < _num_entries; ++k)
+      _A[k*n + c] = _Ae[k];
+  }
+}
+//-----------------------------------------------------------------------------
+void CellBatch::tabulate_tensor_device(const DeviceCellIntegral& integral,
+                                       const AssemblyPlan& plan)
+{
+  plan.gather_positions(_cells, _positions);
+  integral.tabulate_tensor_device(_positions.data(), _w_pointer.data(),
+                                  _coordinate_dofs.data(),
+                                  _cell_orientations.data(), _cells.size());
+}
+//-----------------------------------------------------------------------------
+void CellBatch::element_tensor(std::size_t c, std::vector<double>& Ae) const
+{
+  dolfin_assert(c < _cells.size());
+  const std::size_t n = _cells.size();
+  Ae.resize(_num_entries);
+  for (std::size_t k = 0; k < _num_entries; ++k)
+    Ae[k] = _A[k*n + c];
+}
+//-----------------------------------------------------------------------------
+void CellBatch::gather_coefficient(std::size_t i)
+{
+  const std::size_t n = _cells.size();
+  const FiniteElement& element = _coefficient_elements[i];
+  const std::size_t dim = element.space_dimension();
+  std::vector<double>& w = _w[i];
+
+  // If the coefficient is a Function on the same mesh and element,
+  // the values of all cells are picked from its vector in one call
+  std::shared_ptr<const Function> u
+    = std::dynamic_pointer_cast<const Function>(_coefficients[i]);
+  if (u && u->function_space()->has_element(element)
+      && u->function_space()->mesh().get() == &_mesh)
+  {
+    const GenericDofMap& dofmap = *u->function_space()->dofmap();
+    _dofs.resize(n*dim);
+    for (std::size_t c = 0; c < n; ++c)
+    {
+      auto cell_dofs = dofmap.cell_dofs(_cells[c]);
+      dolfin_assert((std::size_t) cell_dofs.size() == dim);
+      std::copy(cell_dofs.data(), cell_dofs.data() + dim,
+                _dofs.begin() + c*dim);
+    }
+
+    _values.resize(n*dim);
+    u->vector()->get_local(_values.data(), n*dim, _dofs.data());
+    for (std::size_t c = 0; c < n; ++c)
+      for (std::size_t k = 0; k < dim; ++k)
+        w[k*n + c] = _values[c*dim + k];
+  }
+  else
+  {
+    // Restrict cell by cell
+    ufc::cell ufc_cell;
+    std::vector<double>& cell_w = _cell_w[i];
+    for (std::size_t c = 0; c < n; ++c)
+    {
+      const Cell cell(_mesh, _cells[c]);
+      cell.get_cell_data(ufc_cell);
+      for (std::size_t k = 0; k < _num_coordinate_dofs; ++k)
+        _cell_coordinate_dofs[k] = _coordinate_dofs[k*n + c];
+      _coefficients[i]->restrict(cell_w.data(), element, cell,
+                                 _cell_coordinate_dofs.data(), ufc_cell);
+      for (std::size_t k = 0; k < dim; ++k)
+        w[k*n + c] = cell_w[k];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,236 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CELL_BATCH_H
+#define __CELL_BATCH_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <dolfin/common/types.h>
+
+namespace ufc
+{
+  class cell_integral;
+}
+
+namespace dolfin
+{
+
+  class AssemblyPlan;
+  class FiniteElement;
+  class Form;
+  class GenericFunction;
+  class Mesh;
+
+  /// Interface for cell integrals that tabulate the element tensors
+  /// of a batch of cells in one call. A cell integral class may
+  /// derive from both ufc::cell_integral and BatchCellIntegral, in
+  /// which case batched assembly calls tabulate_tensor_batch instead
+  /// of looping over the cells of the batch.
+  ///
+  /// All arrays are stored as structure-of-arrays over the cells of
+  /// the batch, i.e. entry k of cell c is stored at position
+  /// k*num_cells + c, so that kernels can vectorise across cells.
+
+  class BatchCellIntegral
+  {
+  public:
+
+    /// Destructor
+    virtual ~BatchCellIntegral() {}
+
+    /// Tabulate the element tensors for num_cells cells
+    ///
+    /// @param[out] A (double*)
+    ///         Element tensors (num_entries x num_cells)
+    /// @param[in] w (double**)
+    ///         Coefficient values, one array (space_dimension x
+    ///         num_cells) per coefficient
+    /// @param[in] coordinate_dofs (double*)
+    ///         Cell coordinate dofs (num_coordinate_dofs x num_cells)
+    /// @param[in] cell_orientations (int*)
+    ///         Cell orientations (num_cells)
+    /// @param[in] num_cells (std::size_t)
+    ///         Number of cells in the batch
+    virtual void tabulate_tensor_batch(double* A,
+                                       const double * const * w,
+                                       const double* coordinate_dofs,
+                                       const int* cell_orientations,
+                                       std::size_t num_cells) const = 0;
+
+  };
+
+  /// Interface for cell integrals that tabulate element tensors on
+  /// an accelerator (e.g. a GPU) and accumulate them there into a
+  /// copy of the compressed sparse row (CSR) value array of the
+  /// matrix. A cell integral class may derive from both
+  /// ufc::cell_integral and DeviceCellIntegral, in which case
+  /// batched assembly of a bilinear form with an _AssemblyPlan_
+  /// (see AssemblerBase::device_assembly) only gathers the packed
+  /// batch buffers on the host and leaves the kernel and the
+  /// accumulation to the device.
+  ///
+  /// For each assembled matrix, begin_device_assembly is called
+  /// once before the first batch, tabulate_tensor_device once per
+  /// batch and end_device_assembly once after the last batch. The
+  /// implementation owns the device memory (the methods are const
+  /// since integrals are shared, so device buffers are typically
+  /// mutable members) and may keep positions resident on the device
+  /// between calls for the same plan_id.
+
+  class DeviceCellIntegral
+  {
+  public:
+
+    /// Destructor
+    virtual ~DeviceCellIntegral() {}
+
+    /// Begin assembly into a matrix with num_values stored entries:
+    /// allocate (if necessary) and zero the device value array
+    ///
+    /// @param[in] num_values (std::size_t)
+    ///         Number of entries in the CSR value array
+    /// @param[in] plan_id (std::size_t)
+    ///         Identifier of the assembly plan, which changes when
+    ///         the positions of the cell tensor entries change
+    virtual void begin_device_assembly(std::size_t num_values,
+                                       std::size_t plan_id) const = 0;
+
+    /// Tabulate the element tensors for num_cells cells and add
+    /// entry k of cell c to position positions[k*num_cells + c] of
+    /// the device value array. The input arrays are host arrays
+    /// with the layout of BatchCellIntegral::tabulate_tensor_batch.
+    ///
+    /// @param[in] positions (dolfin::local_index*)
+    ///         Positions in the CSR value array (num_entries x num_cells)
+    /// @param[in] w (double**)
+    ///         Coefficient values, one array (space_dimension x
+    ///         num_cells) per coefficient
+    /// @param[in] coordinate_dofs (double*)
+    ///         Cell coordinate dofs (num_coordinate_dofs x num_cells)
+    /// @param[in] cell_orientations (int*)
+    ///         Cell orientations (num_cells)
+    /// @param[in] num_cells (std::size_t)
+    ///         Number of cells in the batch
+    virtual void tabulate_tensor_device(const dolfin::local_index* positions,
+                                        const double * const * w,
+                                        const double* coordinate_dofs,
+                                        const int* cell_orientations,
+                                        std::size_t num_cells) const = 0;
+
+    /// Finish assembly: add the device value array to the host
+    /// value array of the matrix
+    ///
+    /// @param[in,out] values (double*)
+    ///         CSR value array of the matrix (num_values)
+    virtual void end_device_assembly(double* values) const = 0;
+
+  };
+
+  /// This class holds contiguous structure-of-arrays buffers with
+  /// the coordinate dofs, coefficient values and element tensors of a
+  /// batch of cells. It is used by the batched cell assembly in
+  /// Assembler to amortise the per-cell overhead of gathering data
+  /// and calling the integral over many cells.
+
+  class CellBatch
+  {
+  public:
+
+    /// Create buffers for batches of at most max_size cells of the
+    /// mesh of the given form
+    CellBatch(const Form& form, std::size_t max_size);
+
+    /// Destructor
+    ~CellBatch();
+
+    /// Gather coordinate dofs, cell orientations and (enabled)
+    /// coefficient values for the given cells
+    void gather(const std::vector<std::size_t>& cells,
+                const std::vector<bool>& enabled_coefficients);
+
+    /// Tabulate the element tensors of all cells in the batch, using
+    /// BatchCellIntegral::tabulate_tensor_batch if the integral
+    /// implements it and a loop over the cells otherwise
+    void tabulate_tensor(const ufc::cell_integral& integral);
+
+    /// Tabulate the element tensors of all cells in the batch on the
+    /// device and add them to the device value array, with positions
+    /// from the assembly plan
+    void tabulate_tensor_device(const DeviceCellIntegral& integral,
+                                const AssemblyPlan& plan);
+
+    /// Copy the element tensor of the c-th cell in the batch into Ae
+    /// (row-major, as expected by GenericTensor::add_local)
+    void element_tensor(std::size_t c, std::vector<double>& Ae) const;
+
+    /// Number of cells in the current batch
+    std::size_t size() const
+    { return _cells.size(); }
+
+    /// Maximum number of cells in a batch
+    std::size_t max_size() const
+    { return _max_size; }
+
+  private:
+
+    // Gather coefficient i for the cells of the current batch
+    void gather_coefficient(std::size_t i);
+
+    // The form and its mesh
+    const Form& _form;
+    const Mesh& _mesh;
+
+    // Maximum batch size
+    const std::size_t _max_size;
+
+    // Cells of current batch and coefficients gathered for it
+    std::vector<std::size_t> _cells;
+    std::vector<bool> _enabled_coefficients;
+
+    // Finite elements for coefficients
+    std::vector<FiniteElement> _coefficient_elements;
+
+    // Coefficient functions
+    const std::vector<std::shared_ptr<const GenericFunction>> _coefficients;
+
+    // Number of entries in the element tensor and number of
+    // coordinate dofs per cell
+    std::size_t _num_entries, _num_coordinate_dofs;
+
+    // Structure-of-arrays buffers (entry k of cell c at k*size() + c)
+    std::vector<double> _A;
+    std::vector<double> _coordinate_dofs;
+    std::vector<std::vector<double>> _w;
+    std::vector<double*> _w_pointer;
+    std::vector<int> _cell_orientations;
+    std::vector<dolfin::local_index> _positions;
+
+    // Per-cell scratch data used for gathering and for the fallback
+    // loop over the scalar kernel
+    std::vector<double> _Ae, _cell_coordinate_dofs;
+    std::vector<std::vector<double>> _cell_w;
+    std::vector<double*> _cell_w_pointer;
+    std::vector<dolfin::la_index> _dofs;
+    std::vector<double> _values;
+
+  };
+
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include <cstdlib>
 #include <map>
 #include <utility>
+#include <boost/multi_array.hpp>
 #include <ufc.h>
 
 #include <dolfin/common/Array.h>
@@ -46,6 +47,7 @@
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshExteriorFacets.h>
 #include <dolfin/mesh/MeshData.h>
 #include <dolfin/mesh/MeshDomains.h>
 #include <dolfin/mesh/MeshFunction.h>
@@ -62,7 +64,7 @@
 using namespace dolfin;
 
 const std::set<std::string> DirichletBC::methods
-= {"topological", "geometric", "pointwise"};
+= {"topological", "geometric", "pointwise", "boundary"};
 
 //-----------------------------------------------------------------------------
 DirichletBC::DirichletBC(std::shared_ptr<const FunctionSpace> V,
@@ -134,6 +136,8 @@ const DirichletBC& DirichletBC::operator= (const DirichletBC& bc)
   _num_dofs = bc._num_dofs;
   _facets = bc._facets;
   _cells_to_localdofs = bc._cells_to_localdofs;
+  _bc_dofs = bc._bc_dofs;
+  _bc_dof_positions = bc._bc_dof_positions;
   _user_mesh_function = bc._user_mesh_function;
   _user_sub_domain_marker = bc._user_sub_domain_marker;
   _check_midpoint = bc._check_midpoint;
@@ -284,24 +288,17 @@ void DirichletBC::zero(GenericMatrix& A) const
   // Check arguments
   check_arguments(&A, NULL, NULL, 0);
 
-  // A map to hold the mapping from boundary dofs to boundary values
-  Map boundary_values;
-
   // Create local data for application of boundary conditions
   dolfin_assert(_function_space);
   LocalData data(*_function_space);
 
   // Compute dofs and values
-  compute_bc(boundary_values, data, _method);
-
-  // Copy boundary value data to arrays
-  std::vector<dolfin::la_index> dofs(boundary_values.size());
-  std::size_t i = 0;
-  for (auto bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
-    dofs[i++] = bv->first;
+  std::vector<dolfin::la_index> dofs;
+  std::vector<double> values;
+  compute_bc_arrays(dofs, values, data);
 
   // Modify linear system (A_ii = 1)
-  A.zero_local(boundary_values.size(), dofs.data());
+  A.zero_local(dofs.size(), dofs.data());
 
   // Finalise changes to A
   A.apply("insert");
@@ -311,52 +308,80 @@ void DirichletBC::zero_columns(GenericMatrix& A,
                                GenericVector& b,
                                double diag_val) const
 {
-  // Check arguments
-  check_arguments(&A, &b, NULL, 1);
-
-  // A map to hold the mapping from boundary dofs to boundary values
-  Map bv_map;
-  get_boundary_values(bv_map);
-
-  // Create lookup table of dofs
-  //const std::size_t nrows = A.size(0); // should be equal to b.size()
-  const std::size_t ncols = A.size(1); // should be equal to max possible dof+1
-
-  std::pair<std::size_t, std::size_t> rows = A.local_range(0);
+  zero_columns(A, b, {reference_to_no_delete_pointer(*this)}, diag_val);
+}
+//-----------------------------------------------------------------------------
+void DirichletBC::zero_columns(GenericMatrix& A, GenericVector& b,
+                               std::vector<std::shared_ptr<const DirichletBC>> bcs,
+                               double diag_val)
+{
+  Timer timer("DirichletBC zero columns");
 
-  std::vector<char> is_bc_dof(ncols);
-  std::vector<double> bc_dof_val(ncols);
-  for (Map::const_iterator bv = bv_map.begin(); bv != bv_map.end(); ++bv)
+  // Create lookup table of (global) dofs for all boundary conditions
+  const std::size_t ncols = A.size(1);
+  std::vector<char> is_bc_dof(ncols, 0);
+  std::vector<double> bc_dof_val(ncols, 0.0);
+  for (auto bc = bcs.begin(); bc != bcs.end(); ++bc)
   {
-    is_bc_dof[bv->first] = 1;
-    bc_dof_val[bv->first] = bv->second;
+    dolfin_assert(*bc);
+    (*bc)->check_arguments(&A, &b, NULL, 1);
+
+    // Compute dofs and values
+    dolfin_assert((*bc)->_function_space);
+    LocalData data(*(*bc)->_function_space);
+    std::vector<dolfin::la_index> dofs;
+    std::vector<double> values;
+    (*bc)->compute_bc_arrays(dofs, values, data);
+
+    // Get boundary values from neighbour processes
+    Map boundary_values;
+    boundary_values.reserve(dofs.size());
+    for (std::size_t i = 0; i < dofs.size(); ++i)
+      boundary_values[dofs[i]] = values[i];
+    if (MPI::size(A.mpi_comm()) > 1)
+      (*bc)->gather(boundary_values);
+
+    dolfin_assert((*bc)->_function_space->dofmap());
+    const IndexMap& index_map
+      = *(*bc)->_function_space->dofmap()->index_map();
+    for (auto bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
+    {
+      const std::size_t col = index_map.local_to_global(bv->first);
+      is_bc_dof[col] = 1;
+      bc_dof_val[col] = bv->second;
+    }
   }
 
   // Scan through all columns of all rows, setting to zero if
   // is_bc_dof[column]. At the same time, we collect corrections to
-  // the RHS
-
+  // the RHS. Modified rows are collected and set after the sweep, so
+  // that the matrix is finalised once.
+  const std::pair<std::int64_t, std::int64_t> rows = A.local_range(0);
   std::vector<std::size_t> cols;
   std::vector<double> vals;
-  std::vector<double> b_vals;
-  std::vector<dolfin::la_index> b_rows;
-
-  for (std::size_t row = rows.first; row < rows.second; row++)
+  std::vector<std::size_t> A_rows;
+  std::vector<std::vector<std::size_t>> A_cols;
+  std::vector<std::vector<double>> A_vals;
+  std::vector<double> b_set_vals, b_add_vals;
+  std::vector<dolfin::la_index> b_set_rows, b_add_rows;
+  for (std::size_t row = rows.first; row < (std::size_t) rows.second; row++)
   {
+    A.getrow(row, cols, vals);
+
     // If diag_val is nonzero, the matrix is a diagonal block
     // (nrows==ncols), and we can set the whole BC row
     if (diag_val != 0.0 && is_bc_dof[row])
     {
-      A.getrow(row, cols, vals);
       for (std::size_t j = 0; j < cols.size(); j++)
         vals[j] = (cols[j] == row)*diag_val;
-      A.setrow(row, cols, vals);
-      A.apply("insert");
-      b.setitem(row, bc_dof_val[row]*diag_val);
+      A_rows.push_back(row);
+      A_cols.push_back(cols);
+      A_vals.push_back(vals);
+      b_set_rows.push_back(row - rows.first);
+      b_set_vals.push_back(bc_dof_val[row]*diag_val);
     }
     else // Otherwise, we scan the row for BC columns
     {
-      A.getrow(row, cols, vals);
       bool row_changed = false;
       for (std::size_t j = 0; j < cols.size(); j++)
       {
@@ -370,22 +395,31 @@ void DirichletBC::zero_columns(GenericMatrix& A,
         if (!row_changed)
         {
           row_changed = true;
-          b_rows.push_back(row);
-          b_vals.push_back(0.0);
+          b_add_rows.push_back(row - rows.first);
+          b_add_vals.push_back(0.0);
         }
 
-        b_vals.back() -= bc_dof_val[col]*vals[j];
+        b_add_vals.back() -= bc_dof_val[col]*vals[j];
         vals[j] = 0.0;
       }
       if (row_changed)
       {
-        A.setrow(row, cols, vals);
-        A.apply("insert");
+        A_rows.push_back(row);
+        A_cols.push_back(cols);
+        A_vals.push_back(vals);
       }
     }
   }
 
-  b.add_local(&b_vals.front(), b_rows.size(), &b_rows.front());
+  // Set modified rows
+  for (std::size_t i = 0; i < A_rows.size(); ++i)
+    A.setrow(A_rows[i], A_cols[i], A_vals[i]);
+  A.apply("insert");
+
+  // Update right-hand side
+  b.set_local(b_set_vals.data(), b_set_rows.size(), b_set_rows.data());
+  b.apply("insert");
+  b.add_local(b_add_vals.data(), b_add_rows.size(), b_add_rows.data());
   b.apply("add");
 }
 //-----------------------------------------------------------------------------
@@ -449,27 +483,15 @@ void DirichletBC::apply(GenericMatrix* A,
   // Check arguments
   check_arguments(A, b, x, 0);
 
-  // A map to hold the mapping from boundary dofs to boundary values
-  Map boundary_values;
-
   // Create local data for application of boundary conditions
   dolfin_assert(_function_space);
   LocalData data(*_function_space);
 
   // Compute dofs and values
-  compute_bc(boundary_values, data, _method);
-
-  // Copy boundary value data to arrays
-  const std::size_t size = boundary_values.size();
-  std::vector<dolfin::la_index> dofs(size);
-  std::vector<double> values(size);
-  Map::const_iterator bv;
-  std::size_t counter = 0;
-  for (bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
-  {
-    dofs[counter]     = bv->first;
-    values[counter++] = bv->second;
-  }
+  std::vector<dolfin::la_index> dofs;
+  std::vector<double> values;
+  compute_bc_arrays(dofs, values, data);
+  const std::size_t size = dofs.size();
 
   // Modify boundary values for nonlinear problems
   if (x)
@@ -576,6 +598,14 @@ void DirichletBC::check() const
                  "Mesh is not ordered according to the UFC numbering convention. Consider calling mesh.order()");
   }
 
+  // Method "boundary" does not support facet markers
+  if (_method == "boundary" && _user_mesh_function)
+  {
+    dolfin_error("DirichletBC.cpp",
+                 "create Dirichlet boundary condition",
+                 "Method \"boundary\" requires a SubDomain");
+  }
+
   // Check user supplied MeshFunction
   if (_user_mesh_function)
   {
@@ -615,7 +645,17 @@ void DirichletBC::init_facets(const MPI_Comm mpi_comm) const
   if (MPI::max(mpi_comm, _facets.size()) > 0)
     return;
 
-  if (_user_sub_domain)
+  if (_method == "boundary")
+  {
+    if (!_user_sub_domain)
+    {
+      dolfin_error("DirichletBC.cpp",
+                   "compute boundary conditions",
+                   "Method \"boundary\" requires a SubDomain");
+    }
+    init_from_exterior_facets(*_user_sub_domain);
+  }
+  else if (_user_sub_domain)
     init_from_sub_domain(_user_sub_domain);
   else if (_user_mesh_function)
     init_from_mesh_function(*_user_mesh_function, _user_sub_domain_marker);
@@ -653,6 +693,113 @@ void DirichletBC::init_from_sub_domain(std::shared_ptr<const SubDomain>
   init_from_mesh_function(sub_domains, 0);
 }
 //-----------------------------------------------------------------------------
+void DirichletBC::init_from_exterior_facets(const SubDomain& sub_domain) const
+{
+  dolfin_assert(_facets.empty());
+  dolfin_assert(_function_space->mesh());
+  const Mesh& mesh = *_function_space->mesh();
+  const std::size_t D = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const CellType& cell_type = mesh.type();
+  const std::size_t num_facet_vertices = cell_type.num_vertices(D - 1);
+  const MeshConnectivity& cell_vertices = mesh.topology()(D, 0);
+
+  // Get exterior facets
+  std::shared_ptr<const MeshExteriorFacets> exterior_facets
+    = mesh.exterior_facets();
+  const std::vector<unsigned int>& cells = exterior_facets->cells();
+  const std::vector<std::uint8_t>& local_facets
+    = exterior_facets->local_facets();
+
+  // Set geometric dimension (needed for SWIG interface)
+  sub_domain._geometric_dimension = gdim;
+
+  // Vertices of each exterior facet, and the coordinates of each
+  // vertex on the boundary (checked once)
+  std::vector<unsigned int> facet_vertices(cells.size()*num_facet_vertices);
+  std::vector<int> vertex_points(mesh.num_vertices(), -1);
+  std::vector<double> x;
+  boost::multi_array<unsigned int, 2> entities;
+  for (std::size_t f = 0; f < cells.size(); ++f)
+  {
+    cell_type.create_entities(entities, D - 1, cell_vertices(cells[f]));
+    for (std::size_t i = 0; i < num_facet_vertices; ++i)
+    {
+      const unsigned int v = entities[local_facets[f]][i];
+      facet_vertices[f*num_facet_vertices + i] = v;
+      if (vertex_points[v] < 0)
+      {
+        vertex_points[v] = x.size()/gdim;
+        const double* _x = mesh.geometry().x(v);
+        x.insert(x.end(), _x, _x + gdim);
+      }
+    }
+  }
+  std::vector<bool> is_inside;
+  sub_domain.check_points(is_inside, x, true);
+
+  // Find facets with all vertices inside (positions in table)
+  std::vector<std::size_t> candidates;
+  for (std::size_t f = 0; f < cells.size(); ++f)
+  {
+    bool inside = true;
+    for (std::size_t i = 0; i < num_facet_vertices && inside; ++i)
+      inside = is_inside[vertex_points[facet_vertices[f*num_facet_vertices + i]]];
+    if (inside)
+      candidates.push_back(f);
+  }
+
+  // Check midpoints
+  if (!_check_midpoint)
+    is_inside.assign(candidates.size(), true);
+  else
+  {
+    x.assign(candidates.size()*gdim, 0.0);
+    for (std::size_t k = 0; k < candidates.size(); ++k)
+    {
+      const unsigned int* vertices
+        = facet_vertices.data() + candidates[k]*num_facet_vertices;
+      for (std::size_t i = 0; i < num_facet_vertices; ++i)
+      {
+        const double* _x = mesh.geometry().x(vertices[i]);
+        for (std::size_t j = 0; j < gdim; ++j)
+          x[k*gdim + j] += _x[j]/num_facet_vertices;
+      }
+    }
+    sub_domain.check_points(is_inside, x, true);
+  }
+
+  // Store facets as cell*num_cell_facets + local facet
+  const std::size_t num_cell_facets = cell_type.num_entities(D - 1);
+  for (std::size_t k = 0; k < candidates.size(); ++k)
+  {
+    const std::size_t f = candidates[k];
+    if (is_inside[k])
+      _facets.push_back(cells[f]*num_cell_facets + local_facets[f]);
+  }
+}
+//-----------------------------------------------------------------------------
+void DirichletBC::get_facet_cell(const Mesh& mesh, std::size_t f,
+                                 std::size_t& cell,
+                                 std::size_t& local_facet) const
+{
+  // Exterior facets are stored as cell*num_cell_facets + local facet
+  if (_method == "boundary")
+  {
+    const std::size_t num_cell_facets
+      = mesh.type().num_entities(mesh.topology().dim() - 1);
+    cell = _facets[f]/num_cell_facets;
+    local_facet = _facets[f] % num_cell_facets;
+    return;
+  }
+
+  const std::size_t D = mesh.topology().dim();
+  const Facet facet(mesh, _facets[f]);
+  dolfin_assert(facet.num_entities(D) > 0);
+  cell = facet.entities(D)[0];
+  local_facet = Cell(mesh, cell).index(facet);
+}
+//-----------------------------------------------------------------------------
 void DirichletBC::init_from_mesh_function(const MeshFunction<std::size_t>& sub_domains,
                                           std::size_t sub_domain) const
 {
@@ -707,7 +854,7 @@ void DirichletBC::compute_bc(Map& boundary_values, LocalData& data,
     method = _method;
 
   // Choose strategy
-  if (method == "topological")
+  if (method == "topological" || method == "boundary")
     compute_bc_topological(boundary_values, data);
   else if (method == "geometric")
     compute_bc_geometric(boundary_values, data);
@@ -721,6 +868,106 @@ void DirichletBC::compute_bc(Map& boundary_values, LocalData& data,
   }
 }
 //-----------------------------------------------------------------------------
+void DirichletBC::compute_bc_arrays(std::vector<dolfin::la_index>& dofs,
+                                    std::vector<double>& values,
+                                    LocalData& data) const
+{
+  // Copy boundary values computed by the given method
+  if (_method != "topological" && _method != "boundary")
+  {
+    Map boundary_values;
+    compute_bc(boundary_values, data, _method);
+    dofs.resize(boundary_values.size());
+    values.resize(boundary_values.size());
+    std::size_t counter = 0;
+    for (auto bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
+    {
+      dofs[counter] = bv->first;
+      values[counter++] = bv->second;
+    }
+    return;
+  }
+
+  Timer timer("DirichletBC compute bc");
+  dolfin_assert(_function_space);
+  dolfin_assert(_g);
+
+  // Get mesh and dofmap
+  dolfin_assert(_function_space->mesh());
+  const Mesh& mesh = *_function_space->mesh();
+  dolfin_assert(_function_space->dofmap());
+  const GenericDofMap& dofmap = *_function_space->dofmap();
+  const std::size_t num_facet_dofs = dofmap.num_facet_dofs();
+
+  // Extract the list of facets where the BC should be applied
+  init_facets(mesh.mpi_comm());
+  if (_facets.empty())
+  {
+    if (MPI::size(mesh.mpi_comm()) == 1)
+      warning("Found no facets matching domain for boundary condition.");
+    dofs.clear();
+    values.clear();
+    return;
+  }
+
+  // Initialise facet-cell connectivity (not needed for exterior
+  // facets)
+  const std::size_t D = mesh.topology().dim();
+  if (_method != "boundary")
+    mesh.init(D - 1, D);
+
+  // Compute and cache the boundary dofs on first call
+  if (_bc_dof_positions.size() != _facets.size()*num_facet_dofs)
+  {
+    _bc_dofs.clear();
+    _bc_dof_positions.clear();
+    _bc_dof_positions.reserve(_facets.size()*num_facet_dofs);
+    std::unordered_map<dolfin::la_index, std::size_t> positions;
+    for (std::size_t f = 0; f < _facets.size(); ++f)
+    {
+      std::size_t cell_index, facet_local_index;
+      get_facet_cell(mesh, f, cell_index, facet_local_index);
+      auto cell_dofs = dofmap.cell_dofs(cell_index);
+      dofmap.tabulate_facet_dofs(data.facet_dofs, facet_local_index);
+      for (std::size_t i = 0; i < num_facet_dofs; i++)
+      {
+        const dolfin::la_index dof = cell_dofs[data.facet_dofs[i]];
+        auto it = positions.insert(std::make_pair(dof, _bc_dofs.size()));
+        if (it.second)
+          _bc_dofs.push_back(dof);
+        _bc_dof_positions.push_back(it.first->second);
+      }
+    }
+  }
+
+  // Compute values by interpolation on the cells of the facets
+  dofs = _bc_dofs;
+  values.resize(_bc_dofs.size());
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+  dolfin_assert(_function_space->element());
+  for (std::size_t f = 0; f < _facets.size(); ++f)
+  {
+    std::size_t cell_index, facet_local_index;
+    get_facet_cell(mesh, f, cell_index, facet_local_index);
+    const Cell cell(mesh, cell_index);
+
+    // Restrict coefficient to cell
+    cell.get_coordinate_dofs(coordinate_dofs);
+    cell.get_cell_data(ufc_cell, facet_local_index);
+    _g->restrict(data.w.data(), *_function_space->element(), cell,
+                 coordinate_dofs.data(), ufc_cell);
+
+    // Pick values for facet
+    dofmap.tabulate_facet_dofs(data.facet_dofs, facet_local_index);
+    for (std::size_t i = 0; i < num_facet_dofs; i++)
+    {
+      values[_bc_dof_positions[f*num_facet_dofs + i]]
+        = data.w[data.facet_dofs[i]];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 void DirichletBC::compute_bc_topological(Map& boundary_values,
                                          LocalData& data) const
 {
@@ -746,12 +993,11 @@ void DirichletBC::compute_bc_topological(Map& boundary_values,
   dolfin_assert(_function_space->dofmap());
   const GenericDofMap& dofmap = *_function_space->dofmap();
 
-  // Topological dimension
+  // Initialise facet-cell connectivity (not needed for exterior
+  // facets)
   const std::size_t D = mesh.topology().dim();
-
-  // Initialise facet-cell connectivity
-  mesh.init(D);
-  mesh.init(D - 1, D);
+  if (_method != "boundary")
+    mesh.init(D - 1, D);
 
   // Create UFC cell
   ufc::cell ufc_cell;
@@ -767,19 +1013,14 @@ void DirichletBC::compute_bc_topological(Map& boundary_values,
              _facets.size());
   for (std::size_t f = 0; f < _facets.size(); ++f)
   {
-    // Create facet
-    const Facet facet(mesh, _facets[f]);
-
-    // Get cell to which facet belongs.
-    dolfin_assert(facet.num_entities(D) > 0);
-    const std::size_t cell_index = facet.entities(D)[0];
+    // Get cell to which facet belongs and local index of facet with
+    // respect to the cell
+    std::size_t cell_index, facet_local_index;
+    get_facet_cell(mesh, f, cell_index, facet_local_index);
 
     // Create attached cell
     const Cell cell(mesh, cell_index);
 
-    // Get local index of facet with respect to the cell
-    const size_t facet_local_index = cell.index(facet);
-
     // Update UFC cell geometry data
     cell.get_coordinate_dofs(coordinate_dofs);
     cell.get_cell_data(ufc_cell, facet_local_index);
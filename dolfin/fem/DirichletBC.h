@@ -50,6 +50,7 @@ namespace dolfin
   class GenericFunction;
   class FunctionSpace;
   class Facet;
+  class Mesh;
   class GenericMatrix;
   class GenericVector;
   class SubDomain;
@@ -100,6 +101,13 @@ namespace dolfin
   /// approach. The three possibilities are "topological", "geometric"
   /// and "pointwise".
   ///
+  /// The method "boundary" is the topological approach restricted to
+  /// the exterior facets of the mesh (SubDomain::inside is only
+  /// called with on_boundary true). It is available for boundary
+  /// conditions defined by a _SubDomain_, and uses the exterior
+  /// facets from Mesh::exterior_facets, so that neither the facets
+  /// nor the facet-cell connectivity of the mesh are computed.
+  ///
   /// Note: when using "pointwise", the boolean argument `on_boundary`
   /// in SubDomain::inside will always be false.
   ///
@@ -292,11 +300,30 @@ namespace dolfin
     void zero_columns(GenericMatrix& A, GenericVector& b,
                       double diag_val=0) const;
 
+    /// Make columns of matrix associated with a list of boundary
+    /// conditions zero, and update a (right-hand side) vector to
+    /// reflect the changes (symmetric lifting). The matrix is swept
+    /// once for all boundary conditions.
+    ///
+    /// @param[in,out] A (GenericMatrix&)
+    ///         The matrix
+    /// @param[in,out] b (GenericVector&)
+    ///         The vector
+    /// @param[in] bcs (std::vector<std::shared_ptr<const DirichletBC>>)
+    ///         The boundary conditions
+    /// @param[in] diag_val (double)
+    ///         This parameter would normally be -1, 0 or 1.
+    static void zero_columns(GenericMatrix& A, GenericVector& b,
+                             std::vector<std::shared_ptr<const DirichletBC>> bcs,
+                             double diag_val=0);
+
     /// Return boundary markers
     ///
     /// @return std::vector<std::size_t>&
     ///         Boundary markers (facets stored as pairs of cells and
-    ///         local facet numbers).
+    ///         local facet numbers, encoded as
+    ///         cell*num_cell_facets + local facet for method
+    ///         "boundary").
     const std::vector<std::size_t>& markers() const;
 
     /// Return function space V
@@ -362,6 +389,14 @@ namespace dolfin
     void
       init_from_sub_domain(std::shared_ptr<const SubDomain> sub_domain) const;
 
+    // Initialize sub domain markers from sub domain on exterior
+    // facets (for method "boundary")
+    void init_from_exterior_facets(const SubDomain& sub_domain) const;
+
+    // Get cell and local index of the f-th boundary facet
+    void get_facet_cell(const Mesh& mesh, std::size_t f,
+                        std::size_t& cell, std::size_t& local_facet) const;
+
     // Initialize sub domain markers from MeshFunction
     void init_from_mesh_function(const MeshFunction<std::size_t>& sub_domains,
                                  std::size_t sub_domain) const;
@@ -378,6 +413,13 @@ namespace dolfin
     void compute_bc_topological(Map& boundary_values,
                                 LocalData& data) const;
 
+    // Compute (process local) dofs and values as arrays. For the
+    // topological approach, the dofs are cached on the first call
+    // and later calls only compute the values.
+    void compute_bc_arrays(std::vector<dolfin::la_index>& dofs,
+                           std::vector<double>& values,
+                           LocalData& data) const;
+
     // Compute boundary values for facet (geometrical approach)
     void compute_bc_geometric(Map& boundary_values,
                               LocalData& data) const;
@@ -417,7 +459,8 @@ namespace dolfin
     // Cached number of bc dofs, used for memory allocation on second use
     mutable std::size_t _num_dofs;
 
-    // Boundary facets, stored by facet index (local to process)
+    // Boundary facets, stored by facet index (local to process), or
+    // as cell*num_cell_facets + local facet for method "boundary"
     mutable std::vector<std::size_t> _facets;
 
     // Cells attached to boundary, stored by cell index with map to
@@ -425,6 +468,11 @@ namespace dolfin
     mutable std::map<std::size_t, std::vector<std::size_t>>
       _cells_to_localdofs;
 
+    // Cached boundary dofs (topological approach), and the position
+    // in _bc_dofs of each facet dof of each boundary facet
+    mutable std::vector<dolfin::la_index> _bc_dofs;
+    mutable std::vector<std::size_t> _bc_dof_positions;
+
     // User defined mesh function
     std::shared_ptr<const MeshFunction<std::size_t>> _user_mesh_function;
 
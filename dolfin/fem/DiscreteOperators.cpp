@@ -15,15 +15,20 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <cmath>
 #include <vector>
+#include <ufc.h>
 #include <dolfin/common/ArrayView.h>
+#include <dolfin/fem/FiniteElement.h>
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/la/GenericMatrix.h>
+#include <dolfin/la/IndexMap.h>
 #include <dolfin/la/Matrix.h>
 #include <dolfin/la/PETScMatrix.h>
 #include <dolfin/la/SparsityPattern.h>
 #include <dolfin/la/TensorLayout.h>
+#include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Edge.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Vertex.h>
@@ -31,6 +36,42 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Wrap a single basis function of a finite element on a given cell
+  // as a ufc::function, so that the dual basis (evaluate_dofs) of
+  // another element can be applied to it
+  class BasisFunction : public ufc::function
+  {
+  public:
+
+    BasisFunction(const FiniteElement& element,
+                  const std::vector<double>& coordinate_dofs)
+      : _element(element), _coordinate_dofs(coordinate_dofs), _index(0),
+        _orientation(0) {}
+
+    void update(std::size_t index, int orientation)
+    {
+      _index = index;
+      _orientation = orientation;
+    }
+
+    void evaluate(double* values, const double* x, const ufc::cell& c) const
+    {
+      _element.evaluate_basis(_index, values, x, _coordinate_dofs.data(),
+                              _orientation);
+    }
+
+  private:
+
+    const FiniteElement& _element;
+    const std::vector<double>& _coordinate_dofs;
+    std::size_t _index;
+    int _orientation;
+
+  };
+}
+
 //-----------------------------------------------------------------------------
 std::shared_ptr<GenericMatrix>
 DiscreteOperators::build_gradient(const FunctionSpace& V0,
@@ -129,7 +170,8 @@ DiscreteOperators::build_gradient(const FunctionSpace& V0,
   // Initialise matrix
   A->init(*tensor_layout);
 
-  // Build discrete gradient operator/matrix
+  // Build discrete gradient operator/matrix. Only owned rows are
+  // set, so no off-process entries need to be communicated.
   for (EdgeIterator edge(mesh); !edge.end(); ++edge)
   {
     dolfin::la_index row;
@@ -137,6 +179,11 @@ DiscreteOperators::build_gradient(const FunctionSpace& V0,
     double values[2];
 
     row = local_to_global_map0[edge_to_dof[edge->index()]];
+    if ((std::size_t) row < local_range[0].first
+        or (std::size_t) row >= local_range[0].second)
+    {
+      continue;
+    }
 
     Vertex v0(mesh, edge->entities(0)[0]);
     Vertex v1(mesh, edge->entities(0)[1]);
@@ -164,3 +211,175 @@ DiscreteOperators::build_gradient(const FunctionSpace& V0,
   return A;
 }
 //-----------------------------------------------------------------------------
+std::shared_ptr<GenericMatrix>
+DiscreteOperators::build_interpolation_matrix(const FunctionSpace& V0,
+                                              const FunctionSpace& V1)
+{
+  // Get mesh
+  dolfin_assert(V0.mesh());
+  const Mesh& mesh = *(V0.mesh());
+
+  // Check that mesh is the same for both function spaces
+  dolfin_assert(V1.mesh());
+  if (&mesh != V1.mesh().get())
+  {
+    dolfin_error("DiscreteOperators.cpp",
+                 "compute interpolation matrix",
+                 "function spaces do not share the same mesh");
+  }
+
+  // Get elements and check that value shapes match
+  dolfin_assert(V0.element());
+  dolfin_assert(V1.element());
+  const FiniteElement& element0 = *V0.element();
+  const FiniteElement& element1 = *V1.element();
+  if (element0.value_rank() != element1.value_rank())
+  {
+    dolfin_error("DiscreteOperators.cpp",
+                 "compute interpolation matrix",
+                 "function spaces have different value ranks");
+  }
+  for (std::size_t i = 0; i < element0.value_rank(); ++i)
+  {
+    if (element0.value_dimension(i) != element1.value_dimension(i))
+    {
+      dolfin_error("DiscreteOperators.cpp",
+                   "compute interpolation matrix",
+                   "function spaces have different value shapes");
+    }
+  }
+
+  // Get dofmaps
+  dolfin_assert(V0.dofmap());
+  dolfin_assert(V1.dofmap());
+  const GenericDofMap& dofmap0 = *V0.dofmap();
+  const GenericDofMap& dofmap1 = *V1.dofmap();
+
+  // Build maps from local dof numbering to global
+  std::vector<std::size_t> local_to_global_map0;
+  std::vector<std::size_t> local_to_global_map1;
+  dofmap0.tabulate_local_to_global_dofs(local_to_global_map0);
+  dofmap1.tabulate_local_to_global_dofs(local_to_global_map1);
+
+  // Number of locally owned rows (owned dofs are numbered first)
+  dolfin_assert(dofmap0.index_map());
+  const std::size_t num_owned_rows
+    = dofmap0.index_map()->size(IndexMap::MapSize::OWNED);
+
+  // Rows are computed once, from the first cell that contains them,
+  // and stored in compressed form. This gives the exact sparsity
+  // pattern and avoids re-tabulating shared rows.
+  std::vector<bool> row_done(num_owned_rows, false);
+  std::vector<std::vector<dolfin::la_index>> row_cols(num_owned_rows);
+  std::vector<std::vector<double>> row_values(num_owned_rows);
+
+  const std::size_t dim0 = element0.space_dimension();
+  const std::size_t dim1 = element1.space_dimension();
+  std::vector<double> local_matrix(dim0*dim1);
+  std::vector<double> dof_values(dim0);
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+  BasisFunction basis(element1, coordinate_dofs);
+
+  for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
+  {
+    auto dofs0 = dofmap0.cell_dofs(cell->index());
+    auto dofs1 = dofmap1.cell_dofs(cell->index());
+    dolfin_assert(dofs0.size() == dim0);
+    dolfin_assert(dofs1.size() == dim1);
+
+    // Skip cells without any outstanding owned rows
+    bool needed = false;
+    for (std::size_t i = 0; i < dim0; ++i)
+    {
+      const std::size_t row = dofs0[i];
+      if (row < num_owned_rows and !row_done[row])
+      {
+        needed = true;
+        break;
+      }
+    }
+    if (!needed)
+      continue;
+
+    // Tabulate the local interpolation operator: column j holds the
+    // degrees of freedom of V0 applied to basis function j of V1
+    cell->get_coordinate_dofs(coordinate_dofs);
+    cell->get_cell_data(ufc_cell);
+    for (std::size_t j = 0; j < dim1; ++j)
+    {
+      basis.update(j, ufc_cell.orientation);
+      element0.evaluate_dofs(dof_values.data(), basis, coordinate_dofs.data(),
+                             ufc_cell.orientation, ufc_cell);
+      for (std::size_t i = 0; i < dim0; ++i)
+        local_matrix[i*dim1 + j] = dof_values[i];
+    }
+
+    // Store rows not yet computed, dropping (numerically) zero entries
+    for (std::size_t i = 0; i < dim0; ++i)
+    {
+      const std::size_t row = dofs0[i];
+      if (row >= num_owned_rows or row_done[row])
+        continue;
+      row_done[row] = true;
+
+      for (std::size_t j = 0; j < dim1; ++j)
+      {
+        const double value = local_matrix[i*dim1 + j];
+        if (std::abs(value) > DOLFIN_EPS)
+        {
+          row_cols[row].push_back(local_to_global_map1[dofs1[j]]);
+          row_values[row].push_back(value);
+        }
+      }
+    }
+  }
+
+  // Declare matrix
+  auto A = std::make_shared<Matrix>();
+
+  // Create layout for initialising tensor
+  std::shared_ptr<TensorLayout> tensor_layout;
+  tensor_layout = A->factory().create_layout(mesh.mpi_comm(), 2);
+  dolfin_assert(tensor_layout);
+
+  // Copy index maps from dofmaps
+  std::vector<std::shared_ptr<const IndexMap> > index_maps
+    = {dofmap0.index_map(), dofmap1.index_map()};
+
+  // Initialise tensor layout
+  tensor_layout->init(index_maps, TensorLayout::Ghosts::UNGHOSTED);
+
+  // Build exact sparsity pattern from the stored rows
+  if (tensor_layout->sparsity_pattern())
+  {
+    SparsityPattern& pattern = *tensor_layout->sparsity_pattern();
+    pattern.init(index_maps);
+    for (std::size_t row = 0; row < num_owned_rows; ++row)
+    {
+      const dolfin::la_index global_row = local_to_global_map0[row];
+      for (auto col : row_cols[row])
+        pattern.insert_global(global_row, col);
+    }
+    pattern.apply();
+  }
+
+  // Initialise matrix
+  A->init(*tensor_layout);
+
+  // Set owned rows
+  for (std::size_t row = 0; row < num_owned_rows; ++row)
+  {
+    if (row_cols[row].empty())
+      continue;
+    const dolfin::la_index global_row = local_to_global_map0[row];
+    A->set(row_values[row].data(), 1, &global_row, row_cols[row].size(),
+           row_cols[row].data());
+  }
+
+  // Finalise matrix
+  A->apply("insert");
+
+  return A;
+}
+//-----------------------------------------------------------------------------
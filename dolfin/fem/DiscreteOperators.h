@@ -56,6 +56,22 @@ namespace dolfin
     static std::shared_ptr<GenericMatrix>
       build_gradient(const FunctionSpace& V0, const FunctionSpace& V1);
 
+    /// Build the interpolation matrix A that maps the expansion
+    /// coefficients of a function in V1 to those of its interpolant
+    /// in V0, i.e. v = Aw. The spaces must be defined on the same
+    /// mesh and have the same value shape. The matrix is built from
+    /// the element interpolation operators, one cell at a time.
+    ///
+    /// @param[in] V0 (FunctionSpace&)
+    ///  Target space
+    /// @param[in] V1 (FunctionSpace&)
+    ///  Source space
+    ///
+    /// @return GenericMatrix
+    static std::shared_ptr<GenericMatrix>
+      build_interpolation_matrix(const FunctionSpace& V0,
+                                 const FunctionSpace& V1);
+
   };
 }
 
@@ -23,10 +23,12 @@
 // Modified by Mikael Mortensen 2012
 // Modified by Jan Blechta 2013
 
+#include <algorithm>
 #include <unordered_map>
 
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/NoDeleter.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/types.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/log/LogStream.h>
@@ -41,7 +43,8 @@ using namespace dolfin;
 //-----------------------------------------------------------------------------
 DofMap::DofMap(std::shared_ptr<const ufc::dofmap> ufc_dofmap,
                const Mesh& mesh)
-  : _cell_dimension(0), _ufc_dofmap(ufc_dofmap), _is_view(false),
+  : _dofmap_offset(0), _dofmap_stride(0), _cell_dimension(0),
+    _ufc_dofmap(ufc_dofmap), _is_view(false),
     _global_dimension(0), _ufc_offset(0), _multimesh_offset(0),
     _index_map(new IndexMap(mesh.mpi_comm()))
 {
@@ -54,7 +57,8 @@ DofMap::DofMap(std::shared_ptr<const ufc::dofmap> ufc_dofmap,
 DofMap::DofMap(std::shared_ptr<const ufc::dofmap> ufc_dofmap,
                const Mesh& mesh,
                std::shared_ptr<const SubDomain> constrained_domain)
-  : _cell_dimension(0), _ufc_dofmap(ufc_dofmap), _is_view(false),
+  : _dofmap_offset(0), _dofmap_stride(0), _cell_dimension(0),
+    _ufc_dofmap(ufc_dofmap), _is_view(false),
     _global_dimension(0), _ufc_offset(0), _multimesh_offset(0),
     _index_map(new IndexMap(mesh.mpi_comm()))
 {
@@ -69,7 +73,8 @@ DofMap::DofMap(std::shared_ptr<const ufc::dofmap> ufc_dofmap,
 //-----------------------------------------------------------------------------
 DofMap::DofMap(const DofMap& parent_dofmap,
                const std::vector<std::size_t>& component, const Mesh& mesh)
-  : _cell_dimension(0), _ufc_dofmap(0), _is_view(true),
+  : _dofmap_offset(0), _dofmap_stride(0), _cell_dimension(0),
+    _ufc_dofmap(0), _is_view(true),
     _global_dimension(0), _ufc_offset(0), _multimesh_offset(0),
     _index_map(parent_dofmap._index_map)
 {
@@ -77,9 +82,10 @@ DofMap::DofMap(const DofMap& parent_dofmap,
   DofMapBuilder::build_sub_map_view(*this, parent_dofmap, component, mesh);
 }
 //-----------------------------------------------------------------------------
-DofMap::DofMap(std::unordered_map<std::size_t, std::size_t>& collapsed_map,
+DofMap::DofMap(std::vector<std::size_t>& collapsed_map,
                const DofMap& dofmap_view, const Mesh& mesh)
-  : _cell_dimension(0), _ufc_dofmap(dofmap_view._ufc_dofmap), _is_view(false),
+  : _dofmap_offset(0), _dofmap_stride(0), _cell_dimension(0),
+    _ufc_dofmap(dofmap_view._ufc_dofmap), _is_view(false),
     _global_dimension(0), _ufc_offset(0), _multimesh_offset(0),
     _index_map(new IndexMap(mesh.mpi_comm()))
 {
@@ -104,31 +110,39 @@ DofMap::DofMap(std::unordered_map<std::size_t, std::size_t>& collapsed_map,
   DofMapBuilder::build(*this, mesh, constrained_domain);
 
   // Dimension sanity checks
-  dolfin_assert(dofmap_view._dofmap.size()
-                == mesh.num_cells()*dofmap_view._cell_dimension);
+  dolfin_assert(dofmap_view.num_cells() == mesh.num_cells());
   dolfin_assert(global_dimension() == dofmap_view.global_dimension());
-  dolfin_assert(_dofmap.size() == mesh.num_cells()*_cell_dimension);
-
-  // FIXME: Could we use a std::vector instead of std::map if the
-  //        collapsed dof map is contiguous (0, . . . , n)?
-
-  // Build map from collapsed dof index to original dof index
-  collapsed_map.clear();
-  for (std::size_t i = 0; i < mesh.num_cells(); ++i)
+  dolfin_assert(num_cells() == mesh.num_cells());
+
+  // Build map from collapsed dof index to original dof index. The
+  // collapsed (local) dofs are contiguous, so a flat array is
+  // used. Dofs shared between cells are written with the same value
+  // by every cell, hence the atomic write.
+  dolfin_assert(_index_map);
+  const std::int64_t num_cells = mesh.num_cells();
+  collapsed_map.assign(_index_map->size(IndexMap::MapSize::ALL), 0);
+  #pragma omp parallel for num_threads(SubSystemsManager::num_threads())
+  for (std::int64_t i = 0; i < num_cells; ++i)
   {
     auto view_cell_dofs = dofmap_view.cell_dofs(i);
     auto cell_dofs = this->cell_dofs(i);
     dolfin_assert(view_cell_dofs.size() == cell_dofs.size());
 
     for (Eigen::Index j = 0; j < view_cell_dofs.size(); ++j)
+    {
+      dolfin_assert(cell_dofs[j] < (dolfin::la_index) collapsed_map.size());
+      #pragma omp atomic write
       collapsed_map[cell_dofs[j]] = view_cell_dofs[j];
+    }
   }
 }
 //-----------------------------------------------------------------------------
 DofMap::DofMap(const DofMap& dofmap) : _index_map(dofmap._index_map)
 {
-  // Copy data
+  // Copy data (cell dofs storage is shared)
   _dofmap = dofmap._dofmap;
+  _dofmap_offset = dofmap._dofmap_offset;
+  _dofmap_stride = dofmap._dofmap_stride;
   _cell_dimension = dofmap._cell_dimension;
   _ufc_dofmap = dofmap._ufc_dofmap;
   _num_mesh_entities_global = dofmap._num_mesh_entities_global;
@@ -473,6 +487,21 @@ std::shared_ptr<GenericDofMap>
   DofMap::collapse(std::unordered_map<std::size_t, std::size_t>&
                    collapsed_map,
                    const Mesh& mesh) const
+{
+  std::vector<std::size_t> flat_map;
+  std::shared_ptr<GenericDofMap> dofmap = collapse(flat_map, mesh);
+
+  collapsed_map.clear();
+  collapsed_map.reserve(flat_map.size());
+  for (std::size_t i = 0; i < flat_map.size(); ++i)
+    collapsed_map[i] = flat_map[i];
+
+  return dofmap;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<GenericDofMap>
+  DofMap::collapse(std::vector<std::size_t>& collapsed_map,
+                   const Mesh& mesh) const
 {
   return std::shared_ptr<GenericDofMap>(new DofMap(collapsed_map,
                                                      *this, mesh));
@@ -552,17 +581,22 @@ std::vector<dolfin::la_index> DofMap::dofs() const
 {
   // Create vector to hold dofs
   std::vector<la_index> _dofs;
-  _dofs.reserve(_dofmap.size()*max_element_dofs());
+  _dofs.reserve(num_cells()*max_element_dofs());
 
   const dolfin::la_index local_ownership_size
     = _index_map->size(IndexMap::MapSize::OWNED);
   const std::size_t global_offset = _index_map->local_range().first;
 
   // Insert all dofs into a vector (will contain duplicates)
-  for (auto dof : _dofmap)
+  for (std::size_t i = 0; i < num_cells(); ++i)
   {
-    if (dof >= 0 && dof < local_ownership_size)
-      _dofs.push_back(dof + global_offset);
+    auto cell_dof_list = cell_dofs(i);
+    for (Eigen::Index j = 0; j < cell_dof_list.size(); ++j)
+    {
+      const la_index dof = cell_dof_list[j];
+      if (dof >= 0 && dof < local_ownership_size)
+        _dofs.push_back(dof + global_offset);
+    }
   }
 
   // Sort dofs (required to later remove duplicates)
@@ -576,11 +610,8 @@ std::vector<dolfin::la_index> DofMap::dofs() const
 //-----------------------------------------------------------------------------
 void DofMap::set(GenericVector& x, double value) const
 {
-  dolfin_assert(_dofmap.size() % _cell_dimension == 0);
-  const std::size_t num_cells = _dofmap.size() / _cell_dimension;
-
   std::vector<double> _value(_cell_dimension, value);
-  for (std::size_t i = 0; i < num_cells; ++i)
+  for (std::size_t i = 0; i < num_cells(); ++i)
   {
     auto dofs = cell_dofs(i);
     x.set_local(_value.data(), dofs.size(), dofs.data());
@@ -628,6 +659,83 @@ void DofMap::check_provided_entities(const ufc::dofmap& dofmap,
   }
 }
 //-----------------------------------------------------------------------------
+std::size_t DofMap::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this)
+    + _ufc_local_to_local.capacity()*sizeof(int)
+    + _num_mesh_entities_global.capacity()*sizeof(std::size_t)
+    + _global_nodes.size()*sizeof(std::size_t)
+    + _neighbours.size()*sizeof(int);
+  if (_dofmap)
+    bytes += _dofmap->capacity()*sizeof(dolfin::la_index);
+  if (_index_map)
+    bytes += _index_map->memory_usage();
+  for (auto& node : _shared_nodes)
+    bytes += sizeof(node) + node.second.capacity()*sizeof(int);
+  return bytes;
+}
+//-----------------------------------------------------------------------------
+std::size_t DofMap::bandwidth() const
+{
+  dolfin_assert(_dofmap);
+  dolfin_assert(_index_map);
+  const dolfin::la_index num_owned
+    = _index_map->size(IndexMap::MapSize::OWNED)*_index_map->block_size();
+  const std::size_t num_cells = _cell_dimension > 0
+    ? _dofmap->size()/_cell_dimension : 0;
+
+  std::size_t bandwidth = 0;
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    dolfin::la_index min_dof = num_owned;
+    dolfin::la_index max_dof = -1;
+    for (std::size_t i = 0; i < _cell_dimension; ++i)
+    {
+      const dolfin::la_index dof = (*_dofmap)[c*_cell_dimension + i];
+      if (dof < num_owned)
+      {
+        min_dof = std::min(min_dof, dof);
+        max_dof = std::max(max_dof, dof);
+      }
+    }
+    if (max_dof >= min_dof)
+      bandwidth = std::max(bandwidth, (std::size_t) (max_dof - min_dof));
+  }
+  return bandwidth;
+}
+//-----------------------------------------------------------------------------
+std::size_t DofMap::profile() const
+{
+  dolfin_assert(_dofmap);
+  dolfin_assert(_index_map);
+  const dolfin::la_index num_owned
+    = _index_map->size(IndexMap::MapSize::OWNED)*_index_map->block_size();
+  const std::size_t num_cells = _cell_dimension > 0
+    ? _dofmap->size()/_cell_dimension : 0;
+
+  // Smallest dof coupled to each owned dof
+  std::vector<dolfin::la_index> first_dof(num_owned);
+  for (dolfin::la_index i = 0; i < num_owned; ++i)
+    first_dof[i] = i;
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    dolfin::la_index min_dof = num_owned;
+    for (std::size_t i = 0; i < _cell_dimension; ++i)
+      min_dof = std::min(min_dof, (*_dofmap)[c*_cell_dimension + i]);
+    for (std::size_t i = 0; i < _cell_dimension; ++i)
+    {
+      const dolfin::la_index dof = (*_dofmap)[c*_cell_dimension + i];
+      if (dof < num_owned)
+        first_dof[dof] = std::min(first_dof[dof], min_dof);
+    }
+  }
+
+  std::size_t profile = 0;
+  for (dolfin::la_index i = 0; i < num_owned; ++i)
+    profile += i - first_dof[i];
+  return profile;
+}
+//-----------------------------------------------------------------------------
 std::string DofMap::str(bool verbose) const
 {
   std::stringstream s;
@@ -636,19 +744,17 @@ std::string DofMap::str(bool verbose) const
   if (verbose)
   {
     // Cell loop
-    dolfin_assert(_dofmap.size()%_cell_dimension == 0);
-    const std::size_t ncells = _dofmap.size() / _cell_dimension;
-
-    for (std::size_t i = 0; i < ncells; ++i)
+    for (std::size_t i = 0; i < num_cells(); ++i)
     {
       s << "Local cell index, cell dofmap dimension: " << i
         << ", " << _cell_dimension << std::endl;
 
       // Local dof loop
+      auto cell_dof_list = cell_dofs(i);
       for (std::size_t j = 0; j < _cell_dimension; ++j)
       {
         s <<  "  " << "Local, global dof indices: " << j
-          << ", " << _dofmap[i*_cell_dimension + j] << std::endl;
+          << ", " << cell_dof_list[j] << std::endl;
       }
     }
   }
@@ -83,7 +83,7 @@ namespace dolfin
            const Mesh& mesh);
 
     // Create a collapsed dofmap from parent_dofmap
-    DofMap(std::unordered_map<std::size_t, std::size_t>& collapsed_map,
+    DofMap(std::vector<std::size_t>& collapsed_map,
            const DofMap& dofmap_view, const Mesh& mesh);
 
     // Copy constructor
@@ -200,9 +200,10 @@ namespace dolfin
     Eigen::Map<const Eigen::Array<dolfin::la_index, Eigen::Dynamic, 1>>
       cell_dofs(std::size_t cell_index) const
     {
-      const std::size_t index = cell_index*_cell_dimension;
-      dolfin_assert(index + _cell_dimension <= _dofmap.size());
-      return Eigen::Map<const Eigen::Array<dolfin::la_index, Eigen::Dynamic, 1>>(&_dofmap[index], _cell_dimension);
+      dolfin_assert(_dofmap);
+      const std::size_t index = cell_index*_dofmap_stride + _dofmap_offset;
+      dolfin_assert(index + _cell_dimension <= _dofmap->size());
+      return Eigen::Map<const Eigen::Array<dolfin::la_index, Eigen::Dynamic, 1>>(_dofmap->data() + index, _cell_dimension);
     }
 
     /// Return the dof indices associated with entities of given dimension and entity indices
@@ -341,6 +342,20 @@ namespace dolfin
       collapse(std::unordered_map<std::size_t, std::size_t>&
                collapsed_map, const Mesh& mesh) const;
 
+    /// Create a "collapsed" dofmap (collapses a sub-dofmap)
+    ///
+    /// @param     collapsed_map (std::vector<std::size_t>)
+    ///         The "collapsed" map, indexed by the local dofs of the
+    ///         collapsed dofmap.
+    /// @param     mesh (_Mesh_)
+    ///         The mesh.
+    ///
+    /// @return    DofMap
+    ///         The collapsed dofmap.
+    std::shared_ptr<GenericDofMap>
+      collapse(std::vector<std::size_t>& collapsed_map,
+               const Mesh& mesh) const;
+
     // FIXME: Document this function properly
     /// Return list of dof indices on this process that belong to mesh
     /// entities of dimension dim
@@ -391,6 +406,31 @@ namespace dolfin
     const std::vector<std::size_t>& local_to_global_unowned() const
     { return _index_map->local_to_global_unowned(); }
 
+    /// Return estimate of memory used on this process
+    ///
+    /// @return    std::size_t
+    ///         Bytes used by the cell dofs, the index map and the
+    ///         shared dofs. Cell dofs shared with other dofmaps
+    ///         (views) are counted by each of them.
+    std::size_t memory_usage() const;
+
+    /// Return bandwidth of the dof numbering on this process, i.e.
+    /// the largest difference between the local indices of two owned
+    /// dofs of the same cell (the half-bandwidth of the owned block
+    /// of a matrix assembled with this dofmap)
+    ///
+    /// @return    std::size_t
+    ///         The bandwidth.
+    std::size_t bandwidth() const;
+
+    /// Return profile (envelope size) of the dof numbering on this
+    /// process, i.e. the sum over owned dofs i of i - j, where j is
+    /// the smallest owned dof sharing a cell with i
+    ///
+    /// @return    std::size_t
+    ///         The profile.
+    std::size_t profile() const;
+
     /// Return informal string representation (pretty-print)
     ///
     /// @param     verbose (bool)
@@ -413,8 +453,18 @@ namespace dolfin
     static void check_provided_entities(const ufc::dofmap& dofmap,
                                         const Mesh& mesh);
 
-    // Cell-local-to-dof map (dofs for cell dofmap[i])
-    std::vector<dolfin::la_index> _dofmap;
+    // Number of cells in cell-local-to-dof map
+    std::size_t num_cells() const
+    { return _dofmap_stride == 0 ? 0 : _dofmap->size()/_dofmap_stride; }
+
+    // Cell-local-to-dof map. The dofs for cell i are stored at
+    // (*_dofmap)[i*_dofmap_stride + _dofmap_offset + j], j = 0, ...,
+    // _cell_dimension - 1. The storage may be shared with a parent
+    // dofmap, in which case this is a strided view into the parent
+    // cell dofs (no copy is stored for sub-dofmap views).
+    std::shared_ptr<const std::vector<dolfin::la_index>> _dofmap;
+    std::size_t _dofmap_offset;
+    std::size_t _dofmap_stride;
 
     // List of global nodes
     std::set<std::size_t> _global_nodes;
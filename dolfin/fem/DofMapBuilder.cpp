@@ -22,17 +22,30 @@
 // Modified by Martin Alnaes, 2013-2015
 // Modified by Chris Richardson, 2014
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
+#include <limits>
 #include <random>
 #include <utility>
 #include <memory>
 #include <ufc.h>
 
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
+#include <dolfin/common/MonotonicArena.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/graph/BoostGraphOrdering.h>
+#include <dolfin/graph/CSRGraph.h>
 #include <dolfin/graph/GraphBuilder.h>
+#include <dolfin/geometry/Point.h>
 #include <dolfin/graph/SCOTCH.h>
 #include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/DistributedMeshTools.h>
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Mesh.h>
@@ -48,6 +61,153 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Hash map from global to local node index for temporary use,
+  // with nodes allocated from a MonotonicArena
+  typedef std::unordered_map<std::size_t, int, std::hash<std::size_t>,
+                             std::equal_to<std::size_t>,
+                             ArenaAllocator<std::pair<const std::size_t, int>>>
+    ArenaGlobalToLocalMap;
+
+  // Compute the edges of the node graph used for re-ordering, i.e.
+  // vertices v and w are connected if they share a cell. The vertex
+  // for a node is given by node_to_vertex (-1 if the node is not a
+  // graph vertex), and vertex_to_cells is the (CSR) list of cells
+  // that contain each vertex. If fill is false, the number of edges
+  // of vertex v is stored in offsets[v + 1]. Otherwise the (sorted)
+  // edges of vertex v are stored in edges[offsets[v]:offsets[v + 1]].
+  void compute_node_graph_edges(std::vector<int>& offsets,
+                                std::vector<int>& edges,
+                                const bool fill,
+                                const std::vector<int>& vertex_to_cells_offsets,
+                                const std::vector<int>& vertex_to_cells,
+                                const std::vector<la_index>& node_dofmap,
+                                const std::size_t nodes_per_cell,
+                                const std::vector<int>& node_to_vertex,
+                                const std::size_t num_threads)
+  {
+    const std::int64_t num_vertices = vertex_to_cells_offsets.size() - 1;
+    #pragma omp parallel num_threads(num_threads)
+    {
+      // Marker for last vertex a neighbour was added to (avoids
+      // duplicate edges)
+      std::vector<std::int64_t> marker(num_vertices, -1);
+
+      #pragma omp for schedule(static)
+      for (std::int64_t v = 0; v < num_vertices; ++v)
+      {
+        int pos = fill ? offsets[v] : 0;
+        for (int c = vertex_to_cells_offsets[v];
+             c < vertex_to_cells_offsets[v + 1]; ++c)
+        {
+          const la_index* cell_nodes
+            = node_dofmap.data() + vertex_to_cells[c]*nodes_per_cell;
+          for (std::size_t i = 0; i < nodes_per_cell; ++i)
+          {
+            const int w = node_to_vertex[cell_nodes[i]];
+            if (w < 0 or w == v or marker[w] == v)
+              continue;
+            marker[w] = v;
+            if (fill)
+              edges[pos] = w;
+            ++pos;
+          }
+        }
+
+        if (fill)
+        {
+          dolfin_assert(pos == offsets[v + 1]);
+          std::sort(edges.begin() + offsets[v], edges.begin() + pos);
+        }
+        else
+          offsets[v + 1] = pos;
+      }
+    }
+  }
+
+  // Compute ordering of graph vertices by their first appearance in
+  // the cells (vertices not in any cell are numbered last)
+  std::vector<int> compute_cell_ordering(const std::vector<la_index>& node_dofmap,
+                                         const std::vector<int>& node_to_vertex,
+                                         const std::size_t num_vertices)
+  {
+    std::vector<int> remap(num_vertices, -1);
+    int counter = 0;
+    for (auto node : node_dofmap)
+    {
+      const int v = node_to_vertex[node];
+      if (v >= 0 and remap[v] < 0)
+        remap[v] = counter++;
+    }
+    for (auto& r : remap)
+      if (r < 0)
+        r = counter++;
+    return remap;
+  }
+
+  // Compute ordering of graph vertices along the Morton (Z-order)
+  // space-filling curve through their coordinates x (gdim values per
+  // vertex)
+  std::vector<int> compute_sfc_ordering(const std::vector<double>& x,
+                                        const std::size_t gdim)
+  {
+    dolfin_assert(gdim > 0 and gdim <= 3);
+    const std::size_t num_vertices = x.size()/gdim;
+
+    // Bounding box of points
+    std::vector<double> x_min(gdim, std::numeric_limits<double>::max());
+    std::vector<double> x_max(gdim, -std::numeric_limits<double>::max());
+    for (std::size_t v = 0; v < num_vertices; ++v)
+    {
+      for (std::size_t i = 0; i < gdim; ++i)
+      {
+        x_min[i] = std::min(x_min[i], x[v*gdim + i]);
+        x_max[i] = std::max(x_max[i], x[v*gdim + i]);
+      }
+    }
+
+    // Quantize coordinates and interleave their bits
+    const std::size_t bits = 63/gdim;
+    const double scale = static_cast<double>((std::uint64_t(1) << bits) - 1);
+    std::vector<std::pair<std::uint64_t, int>> codes(num_vertices);
+    for (std::size_t v = 0; v < num_vertices; ++v)
+    {
+      std::uint64_t code = 0;
+      for (std::size_t i = 0; i < gdim; ++i)
+      {
+        const double h = x_max[i] - x_min[i];
+        const std::uint64_t q = (h > 0.0)
+          ? static_cast<std::uint64_t>(scale*(x[v*gdim + i] - x_min[i])/h) : 0;
+        for (std::size_t b = 0; b < bits; ++b)
+          code |= ((q >> b) & 1) << (gdim*b + i);
+      }
+      codes[v] = std::make_pair(code, (int) v);
+    }
+    std::sort(codes.begin(), codes.end());
+
+    std::vector<int> remap(num_vertices);
+    for (std::size_t i = 0; i < num_vertices; ++i)
+      remap[codes[i].second] = i;
+    return remap;
+  }
+
+  // Reorder graph vertices by component, keeping the given order
+  // within each component
+  void order_by_component(std::vector<int>& remap,
+                          const std::vector<int>& vertex_component)
+  {
+    dolfin_assert(remap.size() == vertex_component.size());
+    std::vector<std::pair<std::pair<int, int>, int>> keys(remap.size());
+    for (std::size_t v = 0; v < remap.size(); ++v)
+      keys[v] = std::make_pair(std::make_pair(vertex_component[v], remap[v]),
+                               (int) v);
+    std::sort(keys.begin(), keys.end());
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      remap[keys[i].second] = i;
+  }
+}
+
 
 //-----------------------------------------------------------------------------
 void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
@@ -102,9 +262,13 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
     = compute_global_dofs(dofmap._ufc_dofmap, num_mesh_entities_local);
 
   // Determine and set dof block size (block size must be 1 if UFC map
-  // is not re-ordered or if global dofs are present)
-  const std::size_t bs = (global_dofs.empty() and reorder)
+  // is not re-ordered or if global dofs are present). With blocked
+  // layout, the components are numbered one after another and the
+  // block size is 1.
+  const std::string block_layout = dolfin::parameters["dof_block_layout"];
+  const std::size_t natural_bs = (global_dofs.empty() and reorder)
     ? compute_blocksize(*dofmap._ufc_dofmap) : 1;
+  const std::size_t bs = (block_layout == "blocked") ? 1 : natural_bs;
 
   // Compute a 'node' dofmap based on a UFC dofmap. Returns:
   // - node dofmap (node_dofmap)
@@ -114,7 +278,7 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
   // - Number of mesh entities (global), which may differ from that
   //   from the mesh if the dofmap is constrained
   std::vector<std::size_t> node_local_to_global0;
-  std::vector<std::vector<la_index>> node_graph0;
+  std::vector<la_index> node_graph0;
   std::vector<int> node_ufc_local_to_local0;
   std::shared_ptr<const ufc::dofmap> ufc_node_dofmap;
   if (!constrained_domain)
@@ -138,6 +302,10 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
                                          bs);
   }
 
+  // Number of nodes per cell in (flat) node graph
+  dolfin_assert(ufc_node_dofmap);
+  const std::size_t nodes_per_cell = ufc_node_dofmap->num_element_dofs();
+
   // Set local (cell) dimension
   dofmap._cell_dimension = dofmap._ufc_dofmap->num_element_dofs();
 
@@ -160,8 +328,8 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
     global_nodes0 = remapped_global_nodes;
   }
 
-  // Dynamic data structure to build dofmap graph
-  std::vector<std::vector<la_index>> dofmap_graph;
+  // Flat cell-local-to-dof map
+  std::vector<la_index> dofmap_graph;
 
   // Re-order and switch to local indexing in dofmap when distributed
   // for process locality and set local_range
@@ -171,10 +339,12 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
     // positive integer, interior nodes are marked as -1, interior
     // nodes in ghost layer of other processes are marked -2, and
     // ghost nodes are marked as -3
+    Timer t1("Init dofmap: compute shared nodes");
     std::vector<int> shared_nodes;
     compute_shared_nodes(shared_nodes, node_graph0,
                            node_local_to_global0.size(),
                            *ufc_node_dofmap, mesh);
+    t1.stop();
 
     // Compute:
     // (a) owned and shared nodes (and owned and un-owned):
@@ -182,15 +352,16 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
     // (b) map from shared node to sharing processes; and
     // (c) set of all processes that share dofs with this process
     std::vector<short int> node_ownership0;
+    Timer t2("Init dofmap: compute node ownership");
     std::unordered_map<int, std::vector<int>> shared_node_to_processes0;
     const int num_owned_nodes
       = compute_node_ownership(node_ownership0,
                                shared_node_to_processes0,
                                dofmap._neighbours,
-                               node_graph0,
                                shared_nodes, global_nodes0,
                                node_local_to_global0, mesh,
                                dofmap._global_dimension/bs);
+    t2.stop();
 
     dofmap._index_map->init(num_owned_nodes, bs);
 
@@ -205,14 +376,30 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
     // (b) Owning process for nodes that are not owned by this process
     // (c) New local node index to new global node index
     // (d) Old local node index to new local node index
+    Timer t3("Init dofmap: reorder nodes");
+
+    // Component of each node for blocked layout (UFC numbers the
+    // dofs of each component of a vector element contiguously)
+    std::vector<int> node_component;
+    if (bs == 1 and natural_bs > 1 and !constrained_domain)
+    {
+      const std::size_t num_nodes = node_local_to_global0.size();
+      dolfin_assert(num_nodes % natural_bs == 0);
+      node_component.resize(num_nodes);
+      for (std::size_t i = 0; i < num_nodes; ++i)
+        node_component[i] = i/(num_nodes/natural_bs);
+    }
+
     std::vector<int> node_old_to_new_local;
     dolfin_assert(dofmap._index_map);
     compute_node_reordering(*dofmap._index_map,
                             node_old_to_new_local,
                             shared_node_to_processes0,
                             node_local_to_global0,
-                            node_graph0, node_ownership0, global_nodes0,
-                            mesh.mpi_comm());
+                            node_graph0, nodes_per_cell,
+                            node_ownership0, global_nodes0,
+                            node_component, mesh);
+    t3.stop();
 
     // Update UFC-local-to-local map to account for re-ordering
     if (constrained_domain)
@@ -248,13 +435,15 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
 
     // Build dofmap from original node 'dof' map and applying the
     // 'old_to_new_local' map for the re-ordered node indices
-    build_dofmap(dofmap_graph, node_graph0, node_old_to_new_local, bs);
+    Timer t4("Init dofmap: build dofmap from nodes");
+    build_dofmap(dofmap_graph, node_graph0, nodes_per_cell,
+                 node_old_to_new_local, bs);
   }
   else
   {
     // UFC dofmap has not been re-ordered
     dolfin_assert(!distributed);
-    dofmap_graph = node_graph0;
+    dofmap_graph = std::move(node_graph0);
     dofmap._ufc_local_to_local = node_ufc_local_to_local0;
     if (dofmap._ufc_local_to_local.empty()
         && dofmap._ufc_dofmap->num_sub_dofmaps() > 0)
@@ -275,13 +464,11 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
   if (dofmap._ufc_dofmap->num_sub_dofmaps() == 0)
     std::vector<int>().swap(dofmap._ufc_local_to_local);
 
-  // Build flattened dofmap graph
-  dofmap._dofmap.clear();
-  for (auto const &cell_dofs : dofmap_graph)
-  {
-    dofmap._dofmap.insert(dofmap._dofmap.end(), cell_dofs.begin(),
-                          cell_dofs.end());
-  }
+  // Store cell-local-to-dof map
+  dofmap._dofmap
+    = std::make_shared<const std::vector<la_index>>(std::move(dofmap_graph));
+  dofmap._dofmap_offset = 0;
+  dofmap._dofmap_stride = dofmap._cell_dimension;
 }
 //-----------------------------------------------------------------------------
 void
@@ -322,19 +509,13 @@ DofMapBuilder::build_sub_map_view(DofMap& sub_dofmap,
   // Set UFC sub-dofmap offset
   sub_dofmap._ufc_offset = ufc_offset;
 
-  // Build local UFC-based dof map for sub-dofmap
-  // Dynamic data structure to build dofmap graph
-  std::vector<std::vector<la_index>> sub_dofmap_graph;
+  // Build local UFC-based (flat) dof map for sub-dofmap
+  std::vector<la_index> sub_dofmap_graph;
   build_local_ufc_dofmap(sub_dofmap_graph, *sub_dofmap._ufc_dofmap, mesh);
 
   // Add offset to local UFC dofmap
-  for (std::size_t i = 0; i < sub_dofmap_graph.size(); ++i)
-  {
-    for (std::size_t j = 0; j < sub_dofmap_graph[i].size(); ++j)
-    {
-      sub_dofmap_graph[i][j] += ufc_offset;
-    }
-  }
+  for (auto& dof : sub_dofmap_graph)
+    dof += ufc_offset;
 
   // Store number of global mesh entities and set global dimension
   sub_dofmap._num_mesh_entities_global
@@ -366,37 +547,68 @@ DofMapBuilder::build_sub_map_view(DofMap& sub_dofmap,
   // Map to re-ordered dofs
   const std::vector<int>& local_to_local = parent_dofmap._ufc_local_to_local;
   const std::size_t bs = parent_dofmap.block_size();
-  for (auto cell_map = sub_dofmap_graph.begin();
-       cell_map != sub_dofmap_graph.end(); ++cell_map)
+  for (auto dof = sub_dofmap_graph.begin(); dof != sub_dofmap_graph.end();
+       ++dof)
   {
-    for (auto dof = cell_map->begin(); dof != cell_map->end(); ++dof)
-    {
-      const std::div_t  div = std::div((int) *dof, (int) local_to_local.size());
-      const std::size_t node = div.rem;
-      const std::size_t component = div.quot;
+    const std::div_t  div = std::div((int) *dof, (int) local_to_local.size());
+    const std::size_t node = div.rem;
+    const std::size_t component = div.quot;
 
-      // Get dof from UFC local-to-local map
-      dolfin_assert(node < local_to_local.size());
-      std::size_t current_dof = bs*local_to_local[node] + component;
+    // Get dof from UFC local-to-local map
+    dolfin_assert(node < local_to_local.size());
+    std::size_t current_dof = bs*local_to_local[node] + component;
 
-      // Add multimesh offset
-      current_dof += parent_dofmap._multimesh_offset;
+    // Add multimesh offset
+    current_dof += parent_dofmap._multimesh_offset;
 
-      // Set dof index in transformed dofmap
-      *dof = current_dof;
-    }
+    // Set dof index in transformed dofmap
+    *dof = current_dof;
   }
 
   // Set local (cell) dimension
   sub_dofmap._cell_dimension = sub_dofmap._ufc_dofmap->num_element_dofs();
 
-  // Construct flattened dofmap
-  sub_dofmap._dofmap.clear();
-  for (auto const &cell_dofs : sub_dofmap_graph)
+  // Compute position of sub-dofmap dofs in parent cell dofs. UFC
+  // orders the dofs of sub-dofmaps contiguously within a cell.
+  std::size_t cell_offset = 0;
+  std::shared_ptr<const ufc::dofmap> ufc_dofmap = parent_dofmap._ufc_dofmap;
+  for (auto c : component)
+  {
+    for (std::size_t i = 0; i < c; ++i)
+    {
+      std::unique_ptr<ufc::dofmap> ufc_sub_dofmap(ufc_dofmap->create_sub_dofmap(i));
+      cell_offset += ufc_sub_dofmap->num_element_dofs();
+    }
+    ufc_dofmap.reset(ufc_dofmap->create_sub_dofmap(c));
+  }
+
+  // Check if the sub-dofmap dofs coincide with the parent cell dofs,
+  // in which case the view shares the parent storage (strided view)
+  const std::size_t cell_dim = sub_dofmap._cell_dimension;
+  bool is_strided_view
+    = (cell_offset + cell_dim <= parent_dofmap._cell_dimension)
+    and (sub_dofmap_graph.size() == parent_dofmap.num_cells()*cell_dim);
+  for (std::size_t i = 0; i < parent_dofmap.num_cells() and is_strided_view;
+       ++i)
+  {
+    auto parent_cell_dofs = parent_dofmap.cell_dofs(i);
+    is_strided_view = std::equal(sub_dofmap_graph.begin() + i*cell_dim,
+                                 sub_dofmap_graph.begin() + (i + 1)*cell_dim,
+                                 parent_cell_dofs.data() + cell_offset);
+  }
+
+  if (is_strided_view)
+  {
+    sub_dofmap._dofmap = parent_dofmap._dofmap;
+    sub_dofmap._dofmap_offset = parent_dofmap._dofmap_offset + cell_offset;
+    sub_dofmap._dofmap_stride = parent_dofmap._dofmap_stride;
+  }
+  else
   {
-    sub_dofmap._dofmap.insert(sub_dofmap._dofmap.end(),
-                              cell_dofs.begin(),
-                              cell_dofs.end());
+    sub_dofmap._dofmap
+      = std::make_shared<const std::vector<la_index>>(std::move(sub_dofmap_graph));
+    sub_dofmap._dofmap_offset = 0;
+    sub_dofmap._dofmap_stride = cell_dim;
   }
 }
 //-----------------------------------------------------------------------------
@@ -588,7 +800,7 @@ std::size_t DofMapBuilder::build_constrained_vertex_indices(
 }
 //-----------------------------------------------------------------------------
 void DofMapBuilder::build_local_ufc_dofmap(
-  std::vector<std::vector<dolfin::la_index>>& dofmap,
+  std::vector<dolfin::la_index>& dofmap,
   const ufc::dofmap& ufc_dofmap,
   const Mesh& mesh)
 {
@@ -617,9 +829,9 @@ void DofMapBuilder::build_local_ufc_dofmap(
     entity_indices[d].resize(mesh.type().num_entities(d));
 
   // Build dofmap from ufc::dofmap
-  dofmap.resize(mesh.num_cells(),
-                std::vector<la_index>(ufc_dofmap.num_element_dofs()));
-  std::vector<std::size_t> dof_holder(ufc_dofmap.num_element_dofs());
+  const std::size_t local_dim = ufc_dofmap.num_element_dofs();
+  dofmap.resize(mesh.num_cells()*local_dim);
+  std::vector<std::size_t> dof_holder(local_dim);
   for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
   {
     // Fill entity indices array
@@ -630,7 +842,7 @@ void DofMapBuilder::build_local_ufc_dofmap(
                              num_mesh_entities,
                              entity_indices);
     std::copy(dof_holder.begin(), dof_holder.end(),
-              dofmap[cell->index()].begin());
+              dofmap.begin() + cell->index()*local_dim);
   }
 }
 //-----------------------------------------------------------------------------
@@ -639,7 +851,6 @@ DofMapBuilder::compute_node_ownership(
   std::vector<short int>& node_ownership,
   std::unordered_map<int, std::vector<int>>& shared_node_to_processes,
   std::set<int>& neighbours,
-  const std::vector<std::vector<la_index>>& dofmap,
   const std::vector<int>& shared_nodes,
   const std::set<std::size_t>& global_nodes,
   const std::vector<std::size_t>& local_to_global,
@@ -651,8 +862,11 @@ DofMapBuilder::compute_node_ownership(
   // Get number of nodes
   const std::size_t num_nodes_local = local_to_global.size();
 
+  // Temporary maps are allocated from an arena and freed on return
+  MonotonicArena arena;
+
   // Global-to-local node map for nodes on boundary
-  std::map<std::size_t, int> global_to_local;
+  ArenaGlobalToLocalMap global_to_local(arena);
 
   // Initialise node ownership array, provisionally all owned
   node_ownership.resize(num_nodes_local);
@@ -672,6 +886,19 @@ DofMapBuilder::compute_node_ownership(
   // FIXME: could get rid of global_to_local map since response will
   // come back in same order
 
+  // Count shared nodes to size hash map (avoids rehashing for large
+  // meshes)
+  std::size_t num_shared_nodes = 0;
+  for (std::size_t i = 0; i < num_nodes_local; ++i)
+  {
+    if (shared_nodes[i] == 0 or shared_nodes[i] == -2
+        or shared_nodes[i] == -3)
+    {
+      ++num_shared_nodes;
+    }
+  }
+  global_to_local.reserve(num_shared_nodes);
+
   // Loop over nodes and buffer nodes on process boundaries
   for (std::size_t i = 0; i < num_nodes_local; ++i)
   {
@@ -715,7 +942,10 @@ DofMapBuilder::compute_node_ownership(
   MPI::all_to_all(mpi_comm, send_buffer, recv_buffer);
 
   // Map from global index to sharing processes
-  std::map<std::size_t, std::vector<unsigned int>> global_to_procs;
+  typedef std::vector<unsigned int, ArenaAllocator<unsigned int>> Procs;
+  std::map<std::size_t, Procs, std::less<std::size_t>,
+           ArenaAllocator<std::pair<const std::size_t, Procs>>>
+    global_to_procs(arena);
   for (unsigned int i = 0; i != num_processes; ++i)
   {
     const std::vector<std::size_t>& recv_i = recv_buffer[i];
@@ -726,7 +956,7 @@ DofMapBuilder::compute_node_ownership(
       auto map_it = global_to_procs.find(recv_i[j]);
       if (map_it == global_to_procs.end())
         global_to_procs.insert(std::make_pair(recv_i[j],
-                               std::vector<unsigned int>(1, i)));
+                               Procs(1, i, arena)));
       else
         map_it->second.push_back(i);
     }
@@ -749,7 +979,7 @@ DofMapBuilder::compute_node_ownership(
       auto map_it = global_to_procs.find(recv_i[j]);
       if (map_it == global_to_procs.end())
         global_to_procs.insert(std::make_pair(recv_i[j],
-                               std::vector<unsigned int>(1, i)));
+                               Procs(1, i, arena)));
       else
         map_it->second.push_back(i);
     }
@@ -760,7 +990,9 @@ DofMapBuilder::compute_node_ownership(
   for (unsigned int i = 0; i != num_processes; ++i)
     for (auto q = recv_buffer[i].begin() + 1; q != recv_buffer[i].end(); ++q)
     {
-      std::vector<unsigned int>& gprocs = global_to_procs[*q];
+      auto map_it = global_to_procs.find(*q);
+      dolfin_assert(map_it != global_to_procs.end());
+      const Procs& gprocs = map_it->second;
       send_response[i].push_back(gprocs.size());
       send_response[i].insert(send_response[i].end(), gprocs.begin(),
                               gprocs.end());
@@ -769,6 +1001,7 @@ DofMapBuilder::compute_node_ownership(
   MPI::all_to_all(mpi_comm, send_response, recv_buffer);
   // [n_sharing, owner, others]
 
+  std::vector<int> sharing_procs;
   for (unsigned int i = 0; i != num_processes; ++i)
   {
     auto q = recv_buffer[i].begin();
@@ -779,8 +1012,17 @@ DofMapBuilder::compute_node_ownership(
       {
         const std::size_t global_index = *p;
         const std::size_t owner = *(q + 1);
-        std::set<std::size_t> sharing_procs(q + 1, q + 1 + num_sharing);
-        sharing_procs.erase(process_number);
+
+        // Sorted list of sharing processes, excluding this process
+        sharing_procs.assign(q + 1, q + 1 + num_sharing);
+        std::sort(sharing_procs.begin(), sharing_procs.end());
+        sharing_procs.erase(std::unique(sharing_procs.begin(),
+                                        sharing_procs.end()),
+                            sharing_procs.end());
+        sharing_procs.erase(std::remove(sharing_procs.begin(),
+                                        sharing_procs.end(),
+                                        (int) process_number),
+                            sharing_procs.end());
 
         auto it = global_to_local.find(global_index);
         dolfin_assert(it != global_to_local.end());
@@ -800,8 +1042,7 @@ DofMapBuilder::compute_node_ownership(
         else
           node_ownership[received_node_local] = -1;
 
-        shared_node_to_processes[received_node_local]
-          = std::vector<int>(sharing_procs.begin(), sharing_procs.end());
+        shared_node_to_processes[received_node_local] = sharing_procs;
       }
 
       q += num_sharing + 1;
@@ -1045,7 +1286,7 @@ std::size_t DofMapBuilder::compute_blocksize(const ufc::dofmap& ufc_dofmap)
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<const ufc::dofmap> DofMapBuilder::build_ufc_node_graph(
-  std::vector<std::vector<la_index>>& node_dofmap,
+  std::vector<la_index>& node_dofmap,
   std::vector<std::size_t>& node_local_to_global,
   std::vector<std::size_t>& num_mesh_entities_global,
   std::shared_ptr<const ufc::dofmap> ufc_dofmap,
@@ -1104,13 +1345,13 @@ std::shared_ptr<const ufc::dofmap> DofMapBuilder::build_ufc_node_graph(
 
   num_mesh_entities_global = num_mesh_entities_global_unconstrained;
 
-  // Allocate space for dof map
-  node_dofmap.clear();
-  node_dofmap.resize(mesh.num_cells());
-
-  // Get standard local elem2ent dimension
+  // Get standard local element dimension
   const std::size_t local_dim = dofmaps[0]->num_element_dofs();
 
+  // Allocate space for (flat) dof map
+  node_dofmap.clear();
+  node_dofmap.resize(mesh.num_cells()*local_dim);
+
   // Holder for UFC 64-bit dofmap integers
   std::vector<std::size_t> ufc_nodes_global(local_dim);
   std::vector<std::size_t> ufc_nodes_local(local_dim);
@@ -1126,17 +1367,13 @@ std::shared_ptr<const ufc::dofmap> DofMapBuilder::build_ufc_node_graph(
   // Build dofmaps from ufc::dofmap
   for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
   {
-    // Get reference to container for cell dofs
-    std::vector<la_index>& cell_nodes = node_dofmap[cell->index()];
-    cell_nodes.resize(local_dim);
-
     // Tabulate standard UFC dof map for first space (local)
     get_cell_entities_local(*cell, entity_indices, needs_entities);
     dofmaps[0]->tabulate_dofs(ufc_nodes_local.data(),
                               num_mesh_entities_local,
                               entity_indices);
     std::copy(ufc_nodes_local.begin(), ufc_nodes_local.end(),
-              cell_nodes.begin());
+              node_dofmap.begin() + cell->index()*local_dim);
 
     // Tabulate standard UFC dof map for first space (global)
     get_cell_entities_global(*cell, entity_indices, needs_entities);
@@ -1158,7 +1395,7 @@ std::shared_ptr<const ufc::dofmap> DofMapBuilder::build_ufc_node_graph(
 //-----------------------------------------------------------------------------
 std::shared_ptr<const ufc::dofmap>
 DofMapBuilder::build_ufc_node_graph_constrained(
-  std::vector<std::vector<la_index>>& node_dofmap,
+  std::vector<la_index>& node_dofmap,
   std::vector<std::size_t>& node_local_to_global,
   std::vector<int>& node_ufc_local_to_local,
   std::vector<std::size_t>& num_mesh_entities_global,
@@ -1227,13 +1464,13 @@ DofMapBuilder::build_ufc_node_graph_constrained(
   offset_local[block_size]
     = ufc_dofmap->global_dimension(num_mesh_entities_local);
 
-  // Allocate space for dof map
-  node_dofmap.clear();
-  node_dofmap.resize(mesh.num_cells());
-
   // Get standard local element dimension
   const std::size_t local_dim = dofmaps[0]->num_element_dofs();
 
+  // Allocate space for (flat) dof map
+  node_dofmap.clear();
+  node_dofmap.resize(mesh.num_cells()*local_dim);
+
   // Holder for UFC 64-bit dofmap integers
   std::vector<std::size_t> ufc_nodes_local(local_dim);
   std::vector<std::size_t> ufc_nodes_global_constrained(local_dim);
@@ -1250,17 +1487,13 @@ DofMapBuilder::build_ufc_node_graph_constrained(
   // Build dofmaps from ufc::dofmap
   for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
   {
-    // Get reference to container for cell dofs
-    std::vector<la_index>& cell_nodes = node_dofmap[cell->index()];
-    cell_nodes.resize(local_dim);
-
     // Tabulate standard UFC dof map for first space (local)
     get_cell_entities_local(*cell, entity_indices, needs_entities);
     dofmaps[0]->tabulate_dofs(ufc_nodes_local.data(),
                               num_mesh_entities_local,
                               entity_indices);
     std::copy(ufc_nodes_local.begin(), ufc_nodes_local.end(),
-              cell_nodes.begin());
+              node_dofmap.begin() + cell->index()*local_dim);
 
     // Tabulate standard UFC dof map for first space (global, constrained)
     get_cell_entities_global_constrained(*cell, entity_indices,
@@ -1277,16 +1510,18 @@ DofMapBuilder::build_ufc_node_graph_constrained(
     }
   }
 
-  // Modify for constraints
-  std::map<std::size_t, int> global_to_local;
+  // Modify for constraints (map allocated from an arena)
+  MonotonicArena arena;
+  ArenaGlobalToLocalMap global_to_local(arena);
+  global_to_local.reserve(offset_local[1]);
   std::vector<std::size_t> node_local_to_global_mod(offset_local[1]);
   node_ufc_local_to_local.resize(offset_local[1]);
   int counter = 0;
   for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
   {
     // Get nodes (local) on cell
-    std::vector<la_index>& cell_nodes = node_dofmap[cell->index()];
-    for (std::size_t i = 0; i < cell_nodes.size(); ++i)
+    la_index* cell_nodes = node_dofmap.data() + cell->index()*local_dim;
+    for (std::size_t i = 0; i < local_dim; ++i)
     {
       dolfin_assert(cell_nodes[i] < (int) node_local_to_global.size());
       const std::size_t node_index_global
@@ -1385,11 +1620,15 @@ void DofMapBuilder::compute_constrained_mesh_indices(
 //-----------------------------------------------------------------------------
 void DofMapBuilder::compute_shared_nodes(
   std::vector<int>& shared_nodes,
-  const std::vector<std::vector<la_index>>& node_dofmap,
+  const std::vector<la_index>& node_dofmap,
   const std::size_t num_nodes_local,
   const ufc::dofmap& ufc_dofmap,
   const Mesh& mesh)
 {
+  // Number of nodes per cell
+  const std::size_t local_dim = ufc_dofmap.num_element_dofs();
+  dolfin_assert(node_dofmap.size() == mesh.num_cells()*local_dim);
+
   // Initialise mesh
   const std::size_t D = mesh.topology().dim();
   mesh.init(D - 1);
@@ -1406,11 +1645,11 @@ void DofMapBuilder::compute_shared_nodes(
   bool has_ghost_cells = false;
   for (CellIterator c(mesh, "all"); !c.end(); ++c)
   {
-    const std::vector<la_index>& cell_nodes = node_dofmap[c->index()];
+    const la_index* cell_nodes = node_dofmap.data() + c->index()*local_dim;
     if (c->is_shared())
     {
       const int status = (c->is_ghost()) ? -3 : -2;
-      for (std::size_t i = 0; i < cell_nodes.size(); ++i)
+      for (std::size_t i = 0; i < local_dim; ++i)
       {
         // Ensure not already set (for R space)
         if (shared_nodes[cell_nodes[i]] == -1)
@@ -1453,7 +1692,8 @@ void DofMapBuilder::compute_shared_nodes(
     const Cell cell0(mesh, f->entities(D)[0]);
 
     // Tabulate dofs (local) on cell
-    const std::vector<la_index>& cell_nodes = node_dofmap[cell0.index()];
+    const la_index* cell_nodes
+      = node_dofmap.data() + cell0.index()*local_dim;
 
     // Tabulate which dofs are on the facet
     ufc_dofmap.tabulate_facet_dofs(facet_nodes.data(), cell0.index(*f));
@@ -1475,11 +1715,17 @@ void DofMapBuilder::compute_node_reordering(
   std::vector<int>& old_to_new_local,
   const std::unordered_map<int, std::vector<int>>& node_to_sharing_processes,
   const std::vector<std::size_t>& old_local_to_global,
-  const std::vector<std::vector<la_index>>& node_dofmap,
+  const std::vector<la_index>& node_dofmap,
+  const std::size_t nodes_per_cell,
   const std::vector<short int>& node_ownership,
   const std::set<std::size_t>& global_nodes,
-  MPI_Comm mpi_comm)
+  const std::vector<int>& node_component,
+  const Mesh& mesh)
 {
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::string ordering_library
+    = dolfin::parameters["dof_ordering_library"];
+
   // Count number of locally owned nodes
   std::size_t owned_local_size = 0;
   std::size_t unowned_local_size = 0;
@@ -1506,66 +1752,143 @@ void DofMapBuilder::compute_node_reordering(
     if (node_ownership[i] == -1)
       node_pairs.push_back(std::make_pair(old_local_to_global[i] , i));
   }
-  std::map<std::size_t, int>
-    global_to_local_nodes_unowned(node_pairs.begin(), node_pairs.end());
+  MonotonicArena arena;
+  ArenaGlobalToLocalMap global_to_local_nodes_unowned(arena);
+  global_to_local_nodes_unowned.reserve(node_pairs.size());
+  global_to_local_nodes_unowned.insert(node_pairs.begin(), node_pairs.end());
   std::vector<std::pair<std::size_t, int>>().swap(node_pairs);
 
-  // Build graph for re-ordering. Below block is scoped to clear
-  // working data structures once graph is constructed.
-  Graph graph(owned_local_size);
-
-  // Create contiguous local numbering for locally owned dofs
+  // Create contiguous local numbering for locally owned nodes, and
+  // map owned nodes that are not global to (re-ordering) graph
+  // vertices. Global nodes are not connected in the graph.
   std::size_t my_counter = 0;
-  std::vector<int> old_to_contiguous_node_index(node_ownership.size(), -1);
+  std::vector<int> node_to_vertex(node_ownership.size(), -1);
   for (std::size_t i = 0; i < node_ownership.size(); ++i)
   {
     if (node_ownership[i] >= 0)
-      old_to_contiguous_node_index[i] = my_counter++;
+      node_to_vertex[i] = my_counter++;
+  }
+  for (auto node : global_nodes)
+  {
+    dolfin_assert(node < node_to_vertex.size());
+    node_to_vertex[node] = -1;
+  }
+
+  // Number of threads for building the graph
+  const std::size_t num_threads = SubSystemsManager::num_threads();
+
+  // Component of each graph vertex (for blocked layout)
+  std::vector<int> vertex_component;
+  if (!node_component.empty())
+  {
+    vertex_component.resize(owned_local_size, 0);
+    for (std::size_t i = 0; i < node_to_vertex.size(); ++i)
+      if (node_to_vertex[i] >= 0)
+        vertex_component[node_to_vertex[i]] = node_component[i];
   }
 
-  // Build local graph, based on old dof map, with contiguous
-  // numbering
-  for (std::size_t cell = 0; cell < node_dofmap.size(); ++cell)
+  // Order of graph vertices when not computed from the graph
+  std::vector<int> node_remap;
+  if (ordering_library == "cell")
   {
-    // Cell dofmaps with old local indices
-    const std::vector<la_index>& nodes = node_dofmap[cell];
-    std::vector<int> local_old;
+    node_remap = compute_cell_ordering(node_dofmap, node_to_vertex,
+                                       owned_local_size);
+  }
 
-    // Loop over nodes collecting valid local nodes
-    for (std::size_t i = 0; i < nodes.size(); ++i)
+  // Build graph for re-ordering in compressed (CSR) form, based on
+  // old dof map, with contiguous numbering. Below block is scoped to
+  // clear working data structures once graph is constructed.
+  std::vector<int> graph_offsets(owned_local_size + 1, 0);
+  std::vector<int> graph_edges;
+  {
+    // Build vertex-to-cell connectivity
+    dolfin_assert(nodes_per_cell > 0);
+    const std::size_t num_cells = node_dofmap.size()/nodes_per_cell;
+    std::vector<int> vertex_to_cells_offsets(owned_local_size + 1, 0);
+    for (auto node : node_dofmap)
     {
-      if (global_nodes.find(nodes[i]) != global_nodes.end())
-        continue;
+      const int v = node_to_vertex[node];
+      if (v >= 0)
+        ++vertex_to_cells_offsets[v + 1];
+    }
+    for (std::size_t v = 0; v < owned_local_size; ++v)
+      vertex_to_cells_offsets[v + 1] += vertex_to_cells_offsets[v];
 
-      // Old node index (0)
-      const int n0_old = nodes[i];
+    std::vector<int> vertex_to_cells(vertex_to_cells_offsets.back());
+    std::vector<int> pos(vertex_to_cells_offsets.begin(),
+                         vertex_to_cells_offsets.end() - 1);
+    for (std::size_t cell = 0; cell < num_cells; ++cell)
+    {
+      for (std::size_t i = 0; i < nodes_per_cell; ++i)
+      {
+        const int v = node_to_vertex[node_dofmap[cell*nodes_per_cell + i]];
+        if (v >= 0)
+          vertex_to_cells[pos[v]++] = cell;
+      }
+    }
+    std::vector<int>().swap(pos);
 
-      // New node index (0)
-      dolfin_assert(n0_old < (int) old_to_contiguous_node_index.size());
-      const int n0_local = old_to_contiguous_node_index[n0_old];
+    // Order vertices along a space-filling curve through the average
+    // midpoint of the cells containing each vertex
+    if (ordering_library == "SFC")
+    {
+      const std::size_t gdim = mesh.geometry().dim();
+      std::vector<double> cell_midpoints(num_cells*gdim);
+      for (std::size_t cell = 0; cell < num_cells; ++cell)
+      {
+        const Point p = Cell(mesh, cell).midpoint();
+        for (std::size_t j = 0; j < gdim; ++j)
+          cell_midpoints[cell*gdim + j] = p[j];
+      }
 
-      // Add to graph if node n0_local is owned
-      if (n0_local != -1)
+      std::vector<double> x(owned_local_size*gdim, 0.0);
+      for (std::size_t v = 0; v < owned_local_size; ++v)
       {
-        dolfin_assert(n0_local < (int) graph.size());
-        local_old.push_back(n0_local);
+        const int n = vertex_to_cells_offsets[v + 1]
+          - vertex_to_cells_offsets[v];
+        for (int k = vertex_to_cells_offsets[v];
+             k < vertex_to_cells_offsets[v + 1]; ++k)
+        {
+          for (std::size_t j = 0; j < gdim; ++j)
+            x[v*gdim + j] += cell_midpoints[vertex_to_cells[k]*gdim + j]/n;
+        }
       }
+      node_remap = compute_sfc_ordering(x, gdim);
     }
 
-    for (std::size_t i = 0; i < local_old.size(); ++i)
-      for (std::size_t j = 0; j < local_old.size(); ++j)
-        if (i != j)
-          graph[local_old[i]].insert(local_old[j]);
+    // Count edges, compute offsets and fill edges
+    compute_node_graph_edges(graph_offsets, graph_edges, false,
+                             vertex_to_cells_offsets, vertex_to_cells,
+                             node_dofmap, nodes_per_cell, node_to_vertex,
+                             num_threads);
+    for (std::size_t v = 0; v < owned_local_size; ++v)
+      graph_offsets[v + 1] += graph_offsets[v];
+    graph_edges.resize(graph_offsets.back());
+    compute_node_graph_edges(graph_offsets, graph_edges, true,
+                             vertex_to_cells_offsets, vertex_to_cells,
+                             node_dofmap, nodes_per_cell, node_to_vertex,
+                             num_threads);
   }
+  std::vector<int>().swap(node_to_vertex);
+  const CSRGraph<int> graph(MPI_COMM_SELF, std::move(graph_offsets),
+                            std::move(graph_edges));
 
   // Reorder nodes
-  const std::string ordering_library
-    = dolfin::parameters["dof_ordering_library"];
-  std::vector<int> node_remap;
-  if (ordering_library == "Boost")
+  if (ordering_library == "cell" or ordering_library == "SFC")
+  {
+    // Computed above
+    dolfin_assert(node_remap.size() == graph.size());
+  }
+  else if (ordering_library == "Boost")
     node_remap = BoostGraphOrdering::compute_cuthill_mckee(graph, true);
   else if (ordering_library == "SCOTCH")
-    node_remap = SCOTCH::compute_gps(graph);
+  {
+    // Copy to dolfin::Graph for SCOTCH interface
+    Graph _graph(graph.size());
+    for (std::size_t v = 0; v < graph.size(); ++v)
+      _graph[v].insert(graph[v].begin(), graph[v].end());
+    node_remap = SCOTCH::compute_gps(_graph);
+  }
   else if (ordering_library == "random")
   {
     // NOTE: Randomised dof ordering should only be used for
@@ -1583,6 +1906,10 @@ void DofMapBuilder::compute_node_reordering(
                  ordering_library.c_str());
   }
 
+  // Number components one after another for blocked layout
+  if (!vertex_component.empty())
+    order_by_component(node_remap, vertex_component);
+
   // Compute offset for owned nodes
   const std::size_t process_offset
     = MPI::global_offset(mpi_comm, owned_local_size, true);
@@ -1592,10 +1919,9 @@ void DofMapBuilder::compute_node_reordering(
   old_to_new_local.resize(node_ownership.size(), -1);
 
   // Renumber owned nodes, and buffer nodes that are owned but shared
-  // with another process
-  const std::size_t mpi_size = MPI::size(mpi_comm);
-  std::vector<std::vector<std::size_t>> send_buffer(mpi_size);
-  std::vector<std::vector<std::size_t>> recv_buffer(mpi_size);
+  // with another process (only sharing processes are involved, so
+  // use sparse exchange)
+  std::map<int, std::vector<std::size_t>> send_buffer, recv_buffer;
   std::size_t counter = 0;
   for (std::size_t old_node_index_local = 0;
        old_node_index_local < node_ownership.size();
@@ -1629,15 +1955,14 @@ void DofMapBuilder::compute_node_reordering(
     ++counter;
   }
 
-  MPI::all_to_all(mpi_comm, send_buffer, recv_buffer);
+  MPI::sparse_all_to_all(mpi_comm, send_buffer, recv_buffer);
 
   std::vector<std::size_t> local_to_global_unowned(unowned_local_size);
   //  off_process_owner.resize(unowned_local_size);
   std::size_t off_process_node_counter = 0;
 
-  for (std::size_t src = 0; src != mpi_size; ++src)
-    for (auto q = recv_buffer[src].begin();
-         q != recv_buffer[src].end(); q += 2)
+  for (auto src = recv_buffer.begin(); src != recv_buffer.end(); ++src)
+    for (auto q = src->second.begin(); q != src->second.end(); q += 2)
     {
       const std::size_t received_old_node_index_global = *q;
       const std::size_t received_new_node_index_global = *(q + 1);
@@ -1667,27 +1992,28 @@ void DofMapBuilder::compute_node_reordering(
 }
 //-----------------------------------------------------------------------------
 void DofMapBuilder::build_dofmap(
-  std::vector<std::vector<la_index>>& dofmap,
-  const std::vector<std::vector<la_index>>& node_dofmap,
+  std::vector<la_index>& dofmap,
+  const std::vector<la_index>& node_dofmap,
+  const std::size_t nodes_per_cell,
   const std::vector<int>& old_to_new_node_local,
   const std::size_t block_size)
 {
-  // Build dofmap looping over nodes
-  dofmap.resize(node_dofmap.size());
-  for (std::size_t i = 0; i < node_dofmap.size(); ++i)
+  // Build dofmap looping over cells
+  dolfin_assert(nodes_per_cell > 0);
+  const std::size_t num_cells = node_dofmap.size()/nodes_per_cell;
+  const std::size_t local_dim = block_size*nodes_per_cell;
+  dofmap.resize(num_cells*local_dim);
+  for (std::size_t i = 0; i < num_cells; ++i)
   {
-    const std::size_t local_dim0 = node_dofmap[i].size();
-    dofmap[i].resize(block_size*local_dim0);
-    for (std::size_t j = 0; j < local_dim0; ++j)
+    const la_index* cell_nodes = node_dofmap.data() + i*nodes_per_cell;
+    la_index* cell_dofs = dofmap.data() + i*local_dim;
+    for (std::size_t j = 0; j < nodes_per_cell; ++j)
     {
-      const int old_node = node_dofmap[i][j];
+      const int old_node = cell_nodes[j];
       dolfin_assert(old_node < (int)  old_to_new_node_local.size());
       const int new_node = old_to_new_node_local[old_node];
       for (std::size_t block = 0; block < block_size; ++block)
-      {
-        dolfin_assert((block*local_dim0 + j) < dofmap[i].size());
-        dofmap[i][block*local_dim0 + j] = block_size*new_node + block;
-      }
+        cell_dofs[block*nodes_per_cell + j] = block_size*new_node + block;
     }
   }
 }
@@ -82,9 +82,10 @@ namespace dolfin
       std::vector<std::int64_t>& modified_vertex_indices_global);
 
     // Build simple local UFC-based dofmap data structure (does not
-    // account for master/slave constraints)
+    // account for master/slave constraints). The dofmap is stored
+    // flat, with ufc_dofmap.num_element_dofs() entries per cell.
     static void
-      build_local_ufc_dofmap(std::vector<std::vector<dolfin::la_index>>& dofmap,
+      build_local_ufc_dofmap(std::vector<dolfin::la_index>& dofmap,
                              const ufc::dofmap& ufc_dofmap,
                              const Mesh& mesh);
 
@@ -103,17 +104,17 @@ namespace dolfin
       std::vector<short int>& node_ownership,
       std::unordered_map<int, std::vector<int>>& shared_node_to_processes,
       std::set<int>& neighbours,
-      const std::vector<std::vector<la_index>>& node_dofmap,
       const std::vector<int>& boundary_nodes,
       const std::set<std::size_t>& global_nodes,
       const std::vector<std::size_t>& node_local_to_global,
       const Mesh& mesh,
       const std::size_t global_dim);
 
-    // Build dofmap based on re-ordered nodes
+    // Build (flat) dofmap based on re-ordered nodes
     static void
-      build_dofmap(std::vector<std::vector<la_index>>& dofmap,
-                   const std::vector<std::vector<la_index>>& node_dofmap,
+      build_dofmap(std::vector<la_index>& dofmap,
+                   const std::vector<la_index>& node_dofmap,
+                   const std::size_t nodes_per_cell,
                    const std::vector<int>& old_to_new_node_local,
                    const std::size_t block_size);
 
@@ -150,9 +151,12 @@ namespace dolfin
       const Mesh& mesh,
       const SubDomain& constrained_domain);
 
+    // Build (flat) node dofmap from UFC dofmap. The returned UFC
+    // dofmap describes the nodes, and its num_element_dofs() is the
+    // number of nodes per cell in node_dofmap.
     static std::shared_ptr<const ufc::dofmap>
       build_ufc_node_graph(
-        std::vector<std::vector<la_index>>& node_dofmap,
+        std::vector<la_index>& node_dofmap,
         std::vector<std::size_t>& node_local_to_global,
         std::vector<std::size_t>& num_mesh_entities_global,
         std::shared_ptr<const ufc::dofmap> ufc_dofmap,
@@ -162,7 +166,7 @@ namespace dolfin
 
     static std::shared_ptr<const ufc::dofmap>
       build_ufc_node_graph_constrained(
-        std::vector<std::vector<la_index>>& node_dofmap,
+        std::vector<la_index>& node_dofmap,
         std::vector<std::size_t>& node_local_to_global,
         std::vector<int>& node_ufc_local_to_local,
         std::vector<std::size_t>& num_mesh_entities_global,
@@ -178,20 +182,30 @@ namespace dolfin
     // ghost nodes are marked as -3
     static void compute_shared_nodes(
       std::vector<int>& boundary_nodes,
-      const std::vector<std::vector<la_index>>& node_dofmap,
+      const std::vector<la_index>& node_dofmap,
       const std::size_t num_nodes_local,
       const ufc::dofmap& ufc_dofmap,
       const Mesh& mesh);
 
+    // Compute node re-ordering for process index locality and
+    // spatial locality within a process. The graph of owned nodes is
+    // built in compressed (CSR) form, threaded over nodes when the
+    // global parameter "num_threads" is non-zero. The ordering within
+    // the process is selected by the global parameter
+    // "dof_ordering_library". If node_component is not empty, the
+    // nodes of each component are numbered one after another
+    // (blocked layout).
     static void compute_node_reordering(
       IndexMap& index_map,
       std::vector<int>& old_to_new_local,
       const std::unordered_map<int, std::vector<int>>& node_to_sharing_processes,
       const std::vector<std::size_t>& old_local_to_global,
-      const std::vector<std::vector<la_index>>& node_dofmap,
+      const std::vector<la_index>& node_dofmap,
+      const std::size_t nodes_per_cell,
       const std::vector<short int>& node_ownership,
       const std::set<std::size_t>& global_nodes,
-      const MPI_Comm mpi_comm);
+      const std::vector<int>& node_component,
+      const Mesh& mesh);
 
     static void get_cell_entities_local(const Cell& cell,
       std::vector<std::vector<std::size_t>>& entity_indices,
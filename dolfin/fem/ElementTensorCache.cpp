@@ -0,0 +1,144 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <ufc.h>
+#include <dolfin/common/utils.h>
+#include <dolfin/function/Constant.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshFunction.h>
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "ElementTensorCache.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+ElementTensorCache::ElementTensorCache() : _num_entries(0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+ElementTensorCache::~ElementTensorCache()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+bool ElementTensorCache::cacheable(const Form& a)
+{
+  for (auto coefficient : a.coefficients())
+  {
+    if (!std::dynamic_pointer_cast<const Function>(coefficient)
+        && !std::dynamic_pointer_cast<const Constant>(coefficient))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------------------
+void ElementTensorCache::update(const Form& a,
+                  std::shared_ptr<const MeshFunction<std::size_t>> domains)
+{
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *a.mesh();
+
+  // Discard stored tensors if state has changed
+  const std::vector<std::size_t> new_state = state(a, domains);
+  if (new_state != _state)
+  {
+    clear();
+    _state = new_state;
+  }
+
+  // Allocate storage
+  std::size_t num_entries = 1;
+  for (std::size_t i = 0; i < a.rank(); ++i)
+    num_entries *= a.function_space(i)->dofmap()->max_element_dofs();
+  const std::size_t num_cells = mesh.num_cells();
+  if (num_entries != _num_entries || _cached.size() != num_cells)
+  {
+    _num_entries = num_entries;
+    _values.assign(num_cells*num_entries, 0.0);
+    _cached.assign(num_cells, false);
+  }
+}
+//-----------------------------------------------------------------------------
+void ElementTensorCache::insert(std::size_t cell, const double* Ae)
+{
+  dolfin_assert(cell < _cached.size());
+  std::copy(Ae, Ae + _num_entries, _values.begin() + cell*_num_entries);
+  _cached[cell] = true;
+}
+//-----------------------------------------------------------------------------
+void ElementTensorCache::clear()
+{
+  _state.clear();
+  std::fill(_cached.begin(), _cached.end(), false);
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t> ElementTensorCache::state(const Form& a,
+                  std::shared_ptr<const MeshFunction<std::size_t>> domains)
+{
+  dolfin_assert(a.ufc_form());
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *a.mesh();
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+
+  std::vector<std::size_t> key;
+
+  // Form
+  key.push_back(hash_local(std::string(a.ufc_form()->signature())));
+  for (std::size_t i = 0; i < a.rank(); ++i)
+    key.push_back(a.function_space(i)->id());
+
+  // Mesh (the hash covers topology and geometry)
+  key.push_back(mesh.id());
+  key.push_back(mesh.hash());
+
+  // Cell domains
+  if (domains && !domains->empty())
+  {
+    key.push_back(domains->id());
+    const std::vector<std::size_t>
+      values(domains->values(), domains->values() + domains->size());
+    key.push_back(hash_global(mpi_comm, values));
+  }
+
+  // Coefficients
+  std::vector<double> values;
+  for (auto coefficient : a.coefficients())
+  {
+    dolfin_assert(coefficient);
+    key.push_back(coefficient->id());
+    if (auto u = std::dynamic_pointer_cast<const Function>(coefficient))
+    {
+      u->vector()->get_local(values);
+      key.push_back(hash_global(mpi_comm, values));
+    }
+    else if (auto c = std::dynamic_pointer_cast<const Constant>(coefficient))
+      key.push_back(hash_local(c->values()));
+  }
+
+  return key;
+}
+//-----------------------------------------------------------------------------
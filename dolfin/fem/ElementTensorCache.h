@@ -0,0 +1,97 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __ELEMENT_TENSOR_CACHE_H
+#define __ELEMENT_TENSOR_CACHE_H
+
+#include <memory>
+#include <vector>
+
+namespace dolfin
+{
+
+  class Form;
+  template<typename T> class MeshFunction;
+
+  /// This class stores the cell tensors of a form so that repeated
+  /// assembly of a form with unchanged data only needs to add the
+  /// stored tensors to the global tensor. The cache is tied to a
+  /// state key built from the form arguments, the mesh (identifier
+  /// and hash of topology and geometry), the cell domains and the
+  /// coefficients (identifier and hash of the vector for Functions,
+  /// values for Constants). The stored tensors are discarded when
+  /// the state key changes.
+  ///
+  /// Forms with coefficients whose state cannot be tracked (general
+  /// Expressions) are not cacheable.
+
+  class ElementTensorCache
+  {
+  public:
+
+    /// Create empty cache
+    ElementTensorCache();
+
+    /// Destructor
+    ~ElementTensorCache();
+
+    /// Return true if the cell tensors of form a can be cached
+    static bool cacheable(const Form& a);
+
+    /// Prepare cache for assembly of form a over cells, discarding
+    /// stored tensors if the data of the form has changed since the
+    /// previous call. This function is collective.
+    void update(const Form& a,
+                std::shared_ptr<const MeshFunction<std::size_t>> domains);
+
+    /// Return true if the tensor for the given cell is stored
+    bool has_tensor(std::size_t cell) const
+    { return cell < _cached.size() && _cached[cell]; }
+
+    /// Return stored tensor for cell
+    const double* tensor(std::size_t cell) const
+    { return _values.data() + cell*_num_entries; }
+
+    /// Store tensor for cell
+    void insert(std::size_t cell, const double* Ae);
+
+    /// Discard all stored tensors
+    void clear();
+
+  private:
+
+    // Compute state key for given form and domains
+    static std::vector<std::size_t>
+      state(const Form& a,
+            std::shared_ptr<const MeshFunction<std::size_t>> domains);
+
+    // State key of stored tensors
+    std::vector<std::size_t> _state;
+
+    // Size of a cell tensor
+    std::size_t _num_entries;
+
+    // Stored tensors (num_cells x num_entries) and flags for cells
+    // with stored tensors
+    std::vector<double> _values;
+    std::vector<bool> _cached;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,300 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <cmath>
+#include <Eigen/Dense>
+#include <dolfin/common/Array.h>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/function/GenericFunction.h>
+#include <dolfin/geometry/SimplexQuadrature.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include "FiniteElement.h"
+#include "GenericDofMap.h"
+#include "ErrorNorm.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Get expansion coefficients of function on cell
+  void restrict_function(std::vector<double>& w, const Function& f,
+                         std::size_t c)
+  {
+    auto dofs = f.function_space()->dofmap()->cell_dofs(c);
+    w.resize(dofs.size());
+    f.vector()->get_local(w.data(), dofs.size(), dofs.data());
+  }
+
+  // Compute values (value_size per point) or gradients (value_size x
+  // gdim per point) from tabulated basis functions
+  void expand(std::vector<double>& values, const std::vector<double>& w,
+              const std::vector<double>& basis, std::size_t size)
+  {
+    values.assign(size, 0.0);
+    for (std::size_t i = 0; i < w.size(); ++i)
+      for (std::size_t k = 0; k < size; ++k)
+        values[k] += w[i]*basis[i*size + k];
+  }
+}
+
+//-----------------------------------------------------------------------------
+ErrorNorm::ErrorNorm(std::shared_ptr<const Mesh> mesh,
+                     std::size_t quadrature_degree)
+  : _mesh(mesh), _degree(quadrature_degree), _geometry_state(0),
+    _topology_state(0), _other_mesh_id(0)
+{
+  dolfin_assert(_mesh);
+  const CellType::Type cell_type = _mesh->type().cell_type();
+  if (cell_type != CellType::interval && cell_type != CellType::triangle
+      && cell_type != CellType::tetrahedron)
+  {
+    dolfin_error("ErrorNorm.cpp",
+                 "create error norm",
+                 "Only simplex meshes are supported");
+  }
+  if (_mesh->geometry().degree() != 1)
+  {
+    dolfin_error("ErrorNorm.cpp",
+                 "create error norm",
+                 "Only affine meshes are supported");
+  }
+
+  // Check that a rule of the given degree exists
+  SimplexQuadrature::num_points(_mesh->topology().dim(), _degree);
+}
+//-----------------------------------------------------------------------------
+ErrorNorm::~ErrorNorm()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+double ErrorNorm::compute(const GenericFunction& u, const Function& uh,
+                          std::string norm_type) const
+{
+  Timer timer("Compute error norm");
+
+  if (norm_type != "L2" && norm_type != "H10" && norm_type != "H1")
+  {
+    dolfin_error("ErrorNorm.cpp",
+                 "compute error norm",
+                 "Unknown norm type \"%s\". Use \"L2\", \"H10\" or \"H1\"",
+                 norm_type.c_str());
+  }
+
+  const Mesh& mesh = *_mesh;
+  dolfin_assert(uh.function_space()->mesh());
+  if (uh.function_space()->mesh()->id() != mesh.id())
+  {
+    dolfin_error("ErrorNorm.cpp",
+                 "compute error norm",
+                 "Function uh is not defined on the mesh of the error norm");
+  }
+  const std::size_t value_size = uh.value_size();
+  if (u.value_size() != value_size)
+  {
+    dolfin_error("ErrorNorm.cpp",
+                 "compute error norm",
+                 "Value sizes of functions differ (%d and %d)",
+                 u.value_size(), value_size);
+  }
+
+  // Get Function u if it is defined on the same mesh
+  const Function* u_function = dynamic_cast<const Function*>(&u);
+  const Function* u_same = NULL;
+  if (u_function && u_function->function_space()->mesh()->id() == mesh.id())
+    u_same = u_function;
+
+  const std::size_t gdim = mesh.geometry().dim();
+  const bool gradients = (norm_type != "L2");
+  if (gradients && !u_same)
+  {
+    dolfin_error("ErrorNorm.cpp",
+                 "compute error norm",
+                 "Norm type \"%s\" requires u to be a Function on the same mesh as uh",
+                 norm_type.c_str());
+  }
+  if (gradients && mesh.topology().dim() != gdim)
+  {
+    dolfin_error("ErrorNorm.cpp",
+                 "compute error norm",
+                 "Gradients are not supported on manifolds");
+  }
+
+  update();
+  const std::size_t num_points = _weights.size();
+
+  // Evaluate Function on another mesh at all points, starting from
+  // the cells found in the previous call
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                        Eigen::RowMajor> RowMatrix;
+  RowMatrix u_other;
+  if (u_function && !u_same)
+  {
+    const std::size_t other_id = u_function->function_space()->mesh()->id();
+    if (_other_mesh_id != other_id
+        || _other_cells.size() != num_points)
+    {
+      _other_cells.clear();
+      _other_mesh_id = other_id;
+    }
+    u_other.resize(num_points, value_size);
+    Eigen::Map<const RowMatrix> x(_points.data(), num_points, gdim);
+    u_function->eval(u_other, x, _other_cells);
+  }
+
+  // Elements of the functions
+  const FiniteElement& element_h = *uh.function_space()->element();
+  const FiniteElement* element_u
+    = u_same ? u_same->function_space()->element().get() : NULL;
+
+  // Work arrays
+  std::vector<double> coordinate_dofs;
+  std::vector<double> w_h, w_u;
+  std::vector<double> basis_h, basis_u;
+  std::vector<double> values_h, values_u(value_size);
+  std::vector<double> grad_h, grad_u;
+  basis_h.resize(element_h.space_dimension()*value_size*gdim);
+  if (element_u)
+    basis_u.resize(element_u->space_dimension()*value_size*gdim);
+  Array<double> _values_u(value_size, values_u.data());
+
+  double l2 = 0.0;
+  double h10 = 0.0;
+  ufc::cell ufc_cell;
+  for (std::size_t k = 0; k < _cells.size(); ++k)
+  {
+    const Cell cell(mesh, _cells[k]);
+    cell.get_cell_data(ufc_cell);
+    cell.get_coordinate_dofs(coordinate_dofs);
+    restrict_function(w_h, uh, cell.index());
+    if (u_same)
+      restrict_function(w_u, *u_same, cell.index());
+
+    for (std::size_t q = _offsets[k]; q < _offsets[k + 1]; ++q)
+    {
+      const double* x = _points.data() + q*gdim;
+
+      // Values of uh and u
+      element_h.evaluate_basis_all(basis_h.data(), x,
+                                   coordinate_dofs.data(),
+                                   ufc_cell.orientation);
+      expand(values_h, w_h, basis_h, value_size);
+      if (u_same)
+      {
+        element_u->evaluate_basis_all(basis_u.data(), x,
+                                      coordinate_dofs.data(),
+                                      ufc_cell.orientation);
+        expand(values_u, w_u, basis_u, value_size);
+      }
+      else if (u_function)
+      {
+        for (std::size_t i = 0; i < value_size; ++i)
+          values_u[i] = u_other(q, i);
+      }
+      else
+      {
+        const Array<double> _x(gdim, const_cast<double*>(x));
+        u.eval(_values_u, _x, ufc_cell);
+      }
+
+      double e2 = 0.0;
+      for (std::size_t i = 0; i < value_size; ++i)
+        e2 += (values_u[i] - values_h[i])*(values_u[i] - values_h[i]);
+      l2 += _weights[q]*e2;
+
+      // Gradients of uh and u
+      if (gradients)
+      {
+        element_h.evaluate_basis_derivatives_all(1, basis_h.data(), x,
+                                                 coordinate_dofs.data(),
+                                                 ufc_cell.orientation);
+        expand(grad_h, w_h, basis_h, value_size*gdim);
+        element_u->evaluate_basis_derivatives_all(1, basis_u.data(), x,
+                                                  coordinate_dofs.data(),
+                                                  ufc_cell.orientation);
+        expand(grad_u, w_u, basis_u, value_size*gdim);
+
+        double de2 = 0.0;
+        for (std::size_t i = 0; i < grad_h.size(); ++i)
+          de2 += (grad_u[i] - grad_h[i])*(grad_u[i] - grad_h[i]);
+        h10 += _weights[q]*de2;
+      }
+    }
+  }
+
+  l2 = MPI::sum(mesh.mpi_comm(), l2);
+  if (norm_type == "L2")
+    return std::sqrt(l2);
+  h10 = MPI::sum(mesh.mpi_comm(), h10);
+  if (norm_type == "H10")
+    return std::sqrt(h10);
+  return std::sqrt(l2 + h10);
+}
+//-----------------------------------------------------------------------------
+std::size_t ErrorNorm::num_points() const
+{
+  update();
+  return _weights.size();
+}
+//-----------------------------------------------------------------------------
+void ErrorNorm::update() const
+{
+  const Mesh& mesh = *_mesh;
+  if (!_offsets.empty() && _geometry_state == mesh.geometry().state()
+      && _topology_state == mesh.topology().state())
+  {
+    return;
+  }
+
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t n = SimplexQuadrature::num_points(tdim, _degree);
+
+  // Compute rule on each owned cell
+  const std::size_t num_cells = mesh.topology().ghost_offset(tdim);
+  _cells.resize(num_cells);
+  _offsets.resize(num_cells + 1);
+  _points.resize(num_cells*n*gdim);
+  _weights.resize(num_cells*n);
+  std::vector<double> coordinates;
+  std::size_t k = 0;
+  for (CellIterator cell(mesh); !cell.end(); ++cell, ++k)
+  {
+    cell->get_vertex_coordinates(coordinates);
+    SimplexQuadrature::compute_quadrature_rule(coordinates.data(), tdim,
+                                               gdim, _degree,
+                                               _points.data() + k*n*gdim,
+                                               _weights.data() + k*n);
+    _cells[k] = cell->index();
+    _offsets[k] = k*n;
+  }
+  _offsets[num_cells] = num_cells*n;
+
+  // Points have moved, cells of another mesh must be located again
+  _other_cells.clear();
+
+  _geometry_state = mesh.geometry().state();
+  _topology_state = mesh.topology().state();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,118 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __ERROR_NORM_H
+#define __ERROR_NORM_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Function;
+  class GenericFunction;
+  class Mesh;
+
+  /// This class computes norms of the error e = u - uh between a
+  /// function u and a Function uh on a given mesh, by quadrature of
+  /// the given degree on each cell. Both functions are evaluated at
+  /// the quadrature points and subtracted there, so no compiled form
+  /// and no intermediate (higher degree) function space is needed,
+  /// and the result is not affected by the cancellation of an
+  /// expanded integrand.
+  ///
+  /// The quadrature points and weights are computed once and reused
+  /// until the mesh changes. A Function u on another mesh is
+  /// evaluated at the points with located cells which are reused as
+  /// hints in the next call, so repeated norms of a function on a
+  /// fixed pair of meshes are cheap. The points must then be
+  /// contained in the local part of the other mesh (e.g. in serial).
+  ///
+  /// The supported norm types are "L2", "H10" (the L2 norm of the
+  /// gradient) and "H1". Gradients are computed from the finite
+  /// element basis and require u to be a Function on the same mesh
+  /// as uh. The mesh must be an affine simplex mesh.
+
+  class ErrorNorm
+  {
+  public:
+
+    /// Create error norm evaluator
+    ///
+    /// @param    mesh (_Mesh_)
+    ///         The mesh to integrate over.
+    /// @param    quadrature_degree (std::size_t)
+    ///         The degree of the quadrature rule (1 to 6).
+    ErrorNorm(std::shared_ptr<const Mesh> mesh,
+              std::size_t quadrature_degree);
+
+    /// Destructor
+    ~ErrorNorm();
+
+    /// Compute norm of error (collective)
+    ///
+    /// @param    u (_GenericFunction_)
+    ///         The (exact) function.
+    /// @param    uh (_Function_)
+    ///         The approximation, a Function on the mesh.
+    /// @param    norm_type (std::string)
+    ///         The norm type ("L2", "H10" or "H1").
+    ///
+    /// @return    double
+    ///         The norm of u - uh.
+    double compute(const GenericFunction& u, const Function& uh,
+                   std::string norm_type="L2") const;
+
+    /// Return number of local quadrature points
+    std::size_t num_points() const;
+
+  private:
+
+    // Compute quadrature points and weights on owned cells if not
+    // computed for the current mesh
+    void update() const;
+
+    // The mesh
+    std::shared_ptr<const Mesh> _mesh;
+
+    // Degree of quadrature
+    std::size_t _degree;
+
+    // Quadrature points (flattened, gdim per point) and weights on
+    // owned cells, the owned cells and the offsets of their points,
+    // and the mesh states for which they were computed
+    mutable std::vector<double> _points;
+    mutable std::vector<double> _weights;
+    mutable std::vector<std::size_t> _offsets;
+    mutable std::vector<unsigned int> _cells;
+    mutable std::size_t _geometry_state;
+    mutable std::size_t _topology_state;
+
+    // Cells of another mesh containing the quadrature points, and
+    // the id of that mesh
+    mutable std::vector<unsigned int> _other_cells;
+    mutable std::size_t _other_mesh_id;
+
+  };
+
+}
+
+#endif
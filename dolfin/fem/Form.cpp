@@ -21,10 +21,13 @@
 // First added:  2007-12-10
 // Last changed: 2015-11-08
 
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <dolfin/common/NoDeleter.h>
+#include <dolfin/fem/DofMap.h>
 #include <dolfin/fem/FiniteElement.h>
 #include <dolfin/function/Function.h>
 #include <dolfin/function/FunctionSpace.h>
@@ -35,9 +38,17 @@
 #include <dolfin/mesh/MeshData.h>
 #include <dolfin/mesh/MeshFunction.h>
 #include "Form.h"
+#include "UFC.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Guards the cached check identities and UFC data of all forms
+  // (a single lock keeps Form copyable, and it is held only briefly)
+  std::mutex cache_mutex;
+}
+
 //-----------------------------------------------------------------------------
 Form::Form(std::size_t rank, std::size_t num_coefficients)
   : Hierarchical<Form>(*this),  _function_spaces(rank),
@@ -202,6 +213,10 @@ void Form::set_coefficient(std::size_t i,
 {
   dolfin_assert(i < _coefficients.size());
   _coefficients[i] = coefficient;
+
+  // Invalidate interpolant of static coefficient
+  if (i < _static_interpolants.size())
+    _static_interpolants[i].reset();
 }
 //-----------------------------------------------------------------------------
 void Form::set_coefficient(std::string name,
@@ -279,6 +294,62 @@ std::vector<std::shared_ptr<const GenericFunction>> Form::coefficients() const
   return _coefficients;
 }
 //-----------------------------------------------------------------------------
+void Form::set_static_coefficient(std::size_t i, bool is_static)
+{
+  if (i >= _coefficients.size())
+  {
+    dolfin_error("Form.cpp",
+                 "declare static coefficient",
+                 "Illegal coefficient index %d for form with %d coefficients",
+                 i, _coefficients.size());
+  }
+
+  _static_coefficients.resize(_coefficients.size(), false);
+  _static_interpolants.resize(_coefficients.size());
+  _static_interpolant_state.resize(_coefficients.size());
+  _static_coefficients[i] = is_static;
+  _static_interpolants[i].reset();
+}
+//-----------------------------------------------------------------------------
+bool Form::is_static_coefficient(std::size_t i) const
+{
+  return i < _static_coefficients.size() and _static_coefficients[i];
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const Function>
+Form::static_coefficient_interpolant(std::size_t i) const
+{
+  if (!is_static_coefficient(i) or !_coefficients[i] or !_mesh or !_ufc_form)
+    return std::shared_ptr<const Function>();
+
+  // Functions are restricted directly
+  if (dynamic_cast<const Function*>(_coefficients[i].get()))
+    return std::shared_ptr<const Function>();
+
+  // Reuse interpolant if mesh has not changed
+  const std::pair<std::size_t, std::size_t>
+    state(_mesh->geometry().state(), _mesh->topology().state());
+  if (_static_interpolants[i] and _static_interpolant_state[i] == state)
+    return _static_interpolants[i];
+
+  // Create function space of coefficient element
+  const std::size_t k = _rank + i;
+  std::shared_ptr<const ufc::finite_element>
+    ufc_element(_ufc_form->create_finite_element(k));
+  std::shared_ptr<const ufc::dofmap> ufc_dofmap(_ufc_form->create_dofmap(k));
+  auto element = std::make_shared<const FiniteElement>(ufc_element);
+  auto dofmap = std::make_shared<const DofMap>(ufc_dofmap, *_mesh);
+  auto V = std::make_shared<const FunctionSpace>(_mesh, element, dofmap);
+
+  // Interpolate coefficient
+  auto u = std::make_shared<Function>(V);
+  u->interpolate(*_coefficients[i]);
+
+  _static_interpolants[i] = u;
+  _static_interpolant_state[i] = state;
+  return _static_interpolants[i];
+}
+//-----------------------------------------------------------------------------
 std::size_t Form::coefficient_number(const std::string & name) const
 {
   // TODO: Dissect name, assuming "wi", and return i.
@@ -384,6 +455,65 @@ void Form::check() const
   }
 }
 //-----------------------------------------------------------------------------
+bool Form::is_checked() const
+{
+  const std::vector<std::size_t> key = identity();
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return !_checked_identity.empty() and _checked_identity == key;
+}
+//-----------------------------------------------------------------------------
+void Form::set_checked() const
+{
+  const std::vector<std::size_t> key = identity();
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  _checked_identity = key;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<UFC> Form::ufc_data() const
+{
+  const std::vector<std::size_t> key = identity();
+
+  // Reuse cached data if it is valid and not in use by another
+  // assembly (all copies are handed out under the lock, so a use
+  // count of one means that only the cache holds it)
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (_ufc_data and &_ufc_data->dolfin_form == this
+        and _ufc_data_identity == key and _ufc_data.use_count() == 1)
+    {
+      _ufc_data->clear_prefetched_coefficients();
+      return _ufc_data;
+    }
+  }
+
+  // Create new data, and cache it unless valid cached data is in
+  // use (by a concurrent assembly of this form)
+  std::shared_ptr<UFC> ufc = std::make_shared<UFC>(*this);
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (!_ufc_data or &_ufc_data->dolfin_form != this
+      or _ufc_data_identity != key)
+  {
+    _ufc_data = ufc;
+    _ufc_data_identity = key;
+  }
+  return ufc;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t> Form::identity() const
+{
+  // Id of missing objects
+  const std::size_t none = std::numeric_limits<std::size_t>::max();
+
+  std::vector<std::size_t> key;
+  key.reserve(1 + _function_spaces.size() + _coefficients.size());
+  key.push_back(_mesh ? _mesh->id() : none);
+  for (auto& V : _function_spaces)
+    key.push_back(V ? V->id() : none);
+  for (auto& f : _coefficients)
+    key.push_back(f ? f->id() : none);
+  return key;
+}
+//-----------------------------------------------------------------------------
 Equation Form::operator==(const Form& rhs) const
 {
   Equation equation(reference_to_no_delete_pointer(*this),
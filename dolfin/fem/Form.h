@@ -41,10 +41,12 @@ namespace ufc
 namespace dolfin
 {
 
+  class Function;
   class FunctionSpace;
   class GenericFunction;
   class Mesh;
   template <typename T> class MeshFunction;
+  class UFC;
 
   /// Base class for UFC code generated by FFC for DOLFIN with option -l.
 
@@ -231,6 +233,40 @@ namespace dolfin
     ///         All coefficients.
     std::vector<std::shared_ptr<const GenericFunction>> coefficients() const;
 
+    /// Declare coefficient with given number static, i.e. not
+    /// changing between assemblies (e.g. a time-independent
+    /// _Expression_). A static coefficient that is not a _Function_
+    /// is interpolated once into the space of its finite element and
+    /// assembly restricts the interpolant instead of evaluating the
+    /// coefficient on each cell. The interpolant is recomputed when
+    /// the coefficient is reset or the mesh changes.
+    ///
+    /// @param[in] i (std::size_t)
+    ///         The coefficient number.
+    /// @param[in] is_static (bool)
+    ///         Whether the coefficient is static.
+    void set_static_coefficient(std::size_t i, bool is_static=true);
+
+    /// Check whether coefficient with given number is static
+    ///
+    /// @param[in] i (std::size_t)
+    ///         The coefficient number.
+    ///
+    /// @return    bool
+    ///         True if declared static.
+    bool is_static_coefficient(std::size_t i) const;
+
+    /// Return interpolant of static coefficient with given number,
+    /// computing it if necessary. Returns null if the coefficient is
+    /// not static, is a _Function_ or the form has no mesh.
+    ///
+    /// @param[in] i (std::size_t)
+    ///         The coefficient number.
+    ///
+    /// @return    _Function_
+    ///         The interpolant.
+    std::shared_ptr<const Function> static_coefficient_interpolant(std::size_t i) const;
+
     /// Return the number of the coefficient with this name
     ///
     /// @param[in]    name (std::string)
@@ -313,6 +349,32 @@ namespace dolfin
     /// Check function spaces and coefficients
     void check() const;
 
+    /// Check whether the form has passed AssemblerBase::check with
+    /// its current mesh, argument function spaces and coefficients
+    ///
+    /// @return    bool
+    ///         True if the form has been checked.
+    bool is_checked() const;
+
+    /// Record that the form has passed AssemblerBase::check with its
+    /// current mesh, argument function spaces and coefficients
+    void set_checked() const;
+
+    /// Return local assembly data for the form. The _UFC_ object is
+    /// created on first call and reused as long as the mesh, the
+    /// argument function spaces and the coefficients are the same
+    /// objects. Prefetched coefficient values (see
+    /// UFC::prefetch_coefficients) are cleared on each call. The
+    /// cached object is only returned while it is not in use; a
+    /// concurrent assembly of the same form (e.g. from several
+    /// Python threads) receives a new object, so a form may be
+    /// assembled by several threads at the same time as long as its
+    /// coefficients are not changed meanwhile.
+    ///
+    /// @return    _UFC_
+    ///         The local assembly data.
+    std::shared_ptr<UFC> ufc_data() const;
+
     /// Comparison operator, returning equation lhs == rhs
     Equation operator==(const Form& rhs) const;
 
@@ -346,6 +408,25 @@ namespace dolfin
 
     const std::size_t _rank;
 
+    // Static coefficients, their interpolants and the mesh
+    // (geometry, topology) state the interpolants were computed for
+    std::vector<bool> _static_coefficients;
+    mutable std::vector<std::shared_ptr<const Function>> _static_interpolants;
+    mutable std::vector<std::pair<std::size_t, std::size_t>>
+      _static_interpolant_state;
+
+    // Return the unique ids of the mesh, argument function spaces
+    // and coefficients. Ids are used rather than pointers, so that
+    // the cached identity neither keeps replaced objects alive nor
+    // matches new objects allocated at the same address.
+    std::vector<std::size_t> identity() const;
+
+    // Identity of the form when last checked, and cached local
+    // assembly data with the identity it was created for
+    mutable std::vector<std::size_t> _checked_identity;
+    mutable std::shared_ptr<UFC> _ufc_data;
+    mutable std::vector<std::size_t> _ufc_data_identity;
+
   };
 
 }
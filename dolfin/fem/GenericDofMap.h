@@ -162,6 +162,13 @@ namespace dolfin
         collapse(std::unordered_map<std::size_t, std::size_t>& collapsed_map,
                  const Mesh& mesh) const = 0;
 
+    /// Create a "collapsed" a dofmap (collapses from a sub-dofmap
+    /// view). Entry i of collapsed_map is the dof in the view that
+    /// corresponds to (local) dof i of the collapsed dofmap.
+    virtual std::shared_ptr<GenericDofMap>
+        collapse(std::vector<std::size_t>& collapsed_map,
+                 const Mesh& mesh) const = 0;
+
     /// Return list of dof indices on this process that belong to mesh
     /// entities of dimension dim
     virtual std::vector<dolfin::la_index> dofs(const Mesh& mesh,
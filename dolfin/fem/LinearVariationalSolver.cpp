@@ -20,12 +20,16 @@
 // First added:  2011-01-14 (2008-12-26 as VariationalProblem.cpp)
 // Last changed: 2012-07-30
 
+#include <boost/functional/hash.hpp>
+#include <dolfin/common/MPI.h>
 #include <dolfin/common/NoDeleter.h>
+#include <dolfin/function/Constant.h>
 #include <dolfin/function/Function.h>
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/la/GenericLinearAlgebraFactory.h>
 #include <dolfin/la/LinearSolver.h>
+#include <dolfin/mesh/Mesh.h>
 #include "Assembler.h"
 #include "SystemAssembler.h"
 #include "assemble.h"
@@ -36,10 +40,55 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Compute the state of the operator assembled from the bilinear
+  // form a with boundary conditions bcs. The state is empty if it
+  // cannot be determined, i.e. if a coefficient is neither a
+  // Function nor a Constant.
+  std::vector<std::size_t>
+  operator_state(const Form& a,
+                 const std::vector<std::shared_ptr<const DirichletBC>>& bcs,
+                 bool symmetric)
+  {
+    std::vector<std::size_t> state;
+    dolfin_assert(a.mesh());
+    const Mesh& mesh = *a.mesh();
+    state.push_back(reinterpret_cast<std::size_t>(&a));
+    state.push_back(mesh.id());
+    state.push_back(mesh.geometry().state());
+    state.push_back(mesh.topology().state());
+    state.push_back(symmetric);
+    for (std::size_t i = 0; i < bcs.size(); ++i)
+      state.push_back(reinterpret_cast<std::size_t>(bcs[i].get()));
+
+    // Hash coefficient values
+    std::vector<double> values;
+    boost::hash<std::vector<double>> dhash;
+    for (std::size_t i = 0; i < a.num_coefficients(); ++i)
+    {
+      std::shared_ptr<const GenericFunction> w = a.coefficient(i);
+      state.push_back(reinterpret_cast<std::size_t>(w.get()));
+      if (const Function* f = dynamic_cast<const Function*>(w.get()))
+      {
+        dolfin_assert(f->vector());
+        state.push_back(reinterpret_cast<std::size_t>(f->vector().get()));
+        f->vector()->get_local(values);
+      }
+      else if (const Constant* c = dynamic_cast<const Constant*>(w.get()))
+        values = c->values();
+      else
+        return std::vector<std::size_t>();
+      state.push_back(dhash(values));
+    }
+
+    return state;
+  }
+}
 //-----------------------------------------------------------------------------
 LinearVariationalSolver::
 LinearVariationalSolver(std::shared_ptr<LinearVariationalProblem> problem)
-  : _problem(problem)
+  : _problem(problem), _num_operator_assemblies(0)
 {
   // Set parameters
   parameters = default_parameters();
@@ -55,6 +104,25 @@ void LinearVariationalSolver::solve()
   const bool print_rhs      = parameters["print_rhs"];
   const bool symmetric      = parameters["symmetric"];
   const bool print_matrix   = parameters["print_matrix"];
+  const bool reuse_operator = parameters["reuse_operator"];
+
+  // Keep the matrix and the linear solver between calls if the
+  // preconditioner or factorization may be reused
+  const std::string lu_reuse = parameters("lu_solver")["reuse_policy"];
+  const std::string krylov_reuse
+    = parameters("krylov_solver")["reuse_policy"];
+  const bool reuse = (reuse_operator or lu_reuse != "none"
+                     or krylov_reuse != "none");
+  if (!reuse)
+  {
+    _matA.reset();
+    _solver.reset();
+  }
+  if (!reuse_operator)
+  {
+    _system_assembler.reset();
+    _operator_state.clear();
+  }
 
   // Get problem data
   dolfin_assert(_problem);
@@ -70,9 +138,27 @@ void LinearVariationalSolver::solve()
   // Create matrix and vector
   dolfin_assert(u->vector());
   MPI_Comm comm = u->vector()->mpi_comm();
-  std::shared_ptr<GenericMatrix> A = u->vector()->factory().create_matrix(comm);
+  if (!_matA)
+  {
+    _matA = u->vector()->factory().create_matrix(comm);
+    _operator_state.clear();
+  }
+  std::shared_ptr<GenericMatrix> A = _matA;
   std::shared_ptr<GenericVector> b = u->vector()->factory().create_vector(comm);
 
+  // Check whether the operator needs to be assembled (on all
+  // processes if it has changed on any)
+  bool assemble_operator = true;
+  if (reuse_operator)
+  {
+    std::vector<std::size_t> state = operator_state(*a, bcs, symmetric);
+    const std::size_t changed = (state.empty() or state != _operator_state);
+    assemble_operator = MPI::max(comm, changed) > 0;
+    _operator_state = state;
+  }
+  if (assemble_operator)
+    ++_num_operator_assemblies;
+
   // Different assembly depending on whether or not the system is symmetric
   if (symmetric)
   {
@@ -84,14 +170,22 @@ void LinearVariationalSolver::solve()
                    "Empty linear forms cannot be used with symmetric assembly");
     }
 
-    // Assemble linear system and apply boundary conditions
-    SystemAssembler assembler(a, L, bcs);
-    assembler.assemble(*A, *b);
+    // Assemble linear system and apply boundary conditions (keeping
+    // the assembler if the operator may be reused)
+    if (!_system_assembler or assemble_operator)
+      _system_assembler = std::make_shared<SystemAssembler>(a, L, bcs);
+    if (assemble_operator)
+      _system_assembler->assemble(*A, *b);
+    else
+      _system_assembler->assemble(*b);
+    if (!reuse_operator)
+      _system_assembler.reset();
   }
   else
   {
     // Assemble linear system
-    assemble(*A, *a);
+    if (assemble_operator)
+      assemble(*A, *a);
     if (L->ufc_form())
       assemble(*b, *L);
     else
@@ -105,11 +199,15 @@ void LinearVariationalSolver::solve()
       A->init_vector(*b, 0);
     }
 
-    // Apply boundary conditions
+    // Apply boundary conditions (to the right-hand side only if the
+    // operator is reused)
     for (std::size_t i = 0; i < bcs.size(); i++)
     {
       dolfin_assert(bcs[i]);
-      bcs[i]->apply(*A, *b);
+      if (assemble_operator)
+        bcs[i]->apply(*A, *b);
+      else
+        bcs[i]->apply(*b);
     }
   }
 
@@ -137,11 +235,20 @@ void LinearVariationalSolver::solve()
     else
       lu_method = solver_type;
 
+    // Create solver (unless kept from previous solve)
+    const std::string solver_key = "lu_solver " + lu_method;
+    if (!_solver or _solver_key != solver_key)
+    {
+      _solver = std::make_shared<LUSolver>(comm, lu_method);
+      _solver_key = solver_key;
+    }
+
     // Solve linear system
-    LUSolver solver(comm, lu_method);
-    solver.parameters.update(parameters("lu_solver"));
-    solver.parameters["symmetric"] = (bool) parameters["symmetric"];
-    solver.solve(*A, *u->vector(), *b);
+    Parameters p = parameters("lu_solver");
+    p["symmetric"] = (bool) parameters["symmetric"];
+    _solver->update_parameters(p);
+    _solver->set_operator(A);
+    _solver->solve(*u->vector(), *b);
   }
   else
   {
@@ -173,10 +280,26 @@ void LinearVariationalSolver::solve()
                    pc_type.c_str());
     }
 
+    // Create solver (unless kept from previous solve)
+    const std::string solver_key = "krylov_solver " + solver_type + " "
+      + pc_type;
+    if (!_solver or _solver_key != solver_key)
+    {
+      _solver = std::make_shared<KrylovSolver>(comm, solver_type, pc_type);
+      _solver_key = solver_key;
+    }
+
     // Solve linear system
-    KrylovSolver solver(comm, solver_type, pc_type);
-    solver.parameters.update(parameters("krylov_solver"));
-    solver.solve(*A, *u->vector(), *b);
+    _solver->update_parameters(parameters("krylov_solver"));
+    _solver->set_operator(A);
+    _solver->solve(*u->vector(), *b);
+  }
+
+  // Release matrix and solver unless they are to be reused
+  if (!reuse)
+  {
+    _matA.reset();
+    _solver.reset();
   }
 
   end();
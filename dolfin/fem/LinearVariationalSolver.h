@@ -23,6 +23,10 @@
 #ifndef __LINEAR_VARIATIONAL_SOLVER_H
 #define __LINEAR_VARIATIONAL_SOLVER_H
 
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
 #include <dolfin/common/Variable.h>
 #include <dolfin/la/LUSolver.h>
 #include <dolfin/la/KrylovSolver.h>
@@ -31,9 +35,23 @@ namespace dolfin
 {
 
   // Forward declarations
+  class GenericMatrix;
   class LinearVariationalProblem;
+  class SystemAssembler;
 
   /// This class implements a solver for linear variational problems.
+  ///
+  /// If the parameter "reuse_operator" is true, the assembled
+  /// matrix, the system assembler and the linear solver (and hence
+  /// its factorization or preconditioner) are kept between calls to
+  /// solve(), and the matrix is only reassembled if the bilinear
+  /// form, its coefficients, the mesh or the boundary conditions
+  /// have changed. Changes are detected from the mesh state
+  /// counters and the values of _Function_ and _Constant_
+  /// coefficients; a bilinear form with other coefficients (e.g. an
+  /// _Expression_) is reassembled in every call. Only the right-hand
+  /// side is assembled if the operator is unchanged, which suits
+  /// time-dependent problems with a constant operator.
 
   class LinearVariationalSolver : public Variable
   {
@@ -45,6 +63,10 @@ namespace dolfin
     /// Solve variational problem
     void solve();
 
+    /// Return the number of times the matrix has been assembled
+    std::size_t num_operator_assemblies() const
+    { return _num_operator_assemblies; }
+
     /// Default parameter values
     static Parameters default_parameters()
     {
@@ -53,6 +75,7 @@ namespace dolfin
       p.add("linear_solver", "default");
       p.add("preconditioner", "default");
       p.add("symmetric", false);
+      p.add("reuse_operator", false);
 
       p.add("print_rhs", false);
       p.add("print_matrix", false);
@@ -68,6 +91,20 @@ namespace dolfin
     // The linear problem
     std::shared_ptr<LinearVariationalProblem> _problem;
 
+    // Matrix and linear solver, kept between calls to solve() if the
+    // "reuse_policy" of the linear solver is not "none"
+    std::shared_ptr<GenericMatrix> _matA;
+    std::shared_ptr<GenericLinearSolver> _solver;
+    std::string _solver_key;
+
+    // System assembler and state of the operator (see
+    // "reuse_operator")
+    std::shared_ptr<SystemAssembler> _system_assembler;
+    std::vector<std::size_t> _operator_state;
+
+    // Number of times the matrix has been assembled
+    std::size_t _num_operator_assemblies;
+
   };
 
 }
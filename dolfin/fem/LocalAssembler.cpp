@@ -125,7 +125,10 @@ LocalAssembler::assemble_cell(Eigen::Matrix<double, Eigen::Dynamic,
     return;
   }
 
-  // Update to current cell
+  // Update to current cell. Restricting coefficients reads from
+  // global vectors, which is serialised when called from threads
+  // (see LocalSolver).
+  #pragma omp critical (dolfin_local_assembler)
   ufc.update(cell, coordinate_dofs, ufc_cell,
              integral->enabled_coefficients());
 
@@ -166,6 +169,7 @@ LocalAssembler::assemble_exterior_facet(Eigen::Matrix<double,
     return;
 
   // Update to current cell
+  #pragma omp critical (dolfin_local_assembler)
   ufc.update(cell, coordinate_dofs, ufc_cell,
              integral->enabled_coefficients());
 
@@ -271,6 +275,7 @@ LocalAssembler::assemble_interior_facet(Eigen::Matrix<double, Eigen::Dynamic,
   }
 
   // Update to current pair of cells and facets
+  #pragma omp critical (dolfin_local_assembler)
   ufc.update(cell0, *coordinate_dofs0, *ufc_cell0,
              cell1, *coordinate_dofs1, *ufc_cell1,
              integral->enabled_coefficients());
@@ -18,12 +18,20 @@
 // Modified by Steven Vandekerckhove, 2014
 // Modified by Tormod Landet, 2015
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <exception>
 #include <memory>
 #include <vector>
 #include <Eigen/Dense>
 
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
 #include <dolfin/common/ArrayView.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/types.h>
 #include <dolfin/fem/LocalAssembler.h>
@@ -35,6 +43,7 @@
 #include <dolfin/log/Progress.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "assemble.h"
 #include "Form.h"
 #include "GenericDofMap.h"
@@ -43,11 +52,44 @@
 
 using namespace dolfin;
 
+//-----------------------------------------------------------------------------
+struct LocalSolver::LocalData
+{
+  LocalData(const Form& a, const Form* L)
+    : ufc_a(a), ufc_L(L ? new UFC(*L) : nullptr)
+  {
+    // Do nothing
+  }
+
+  LocalData(const LocalData& data)
+    : ufc_a(data.ufc_a), ufc_L(data.ufc_L ? new UFC(*data.ufc_L) : nullptr)
+  {
+    // Do nothing
+  }
+
+  // UFC objects for LHS and (if assembled locally) RHS
+  UFC ufc_a;
+  std::unique_ptr<UFC> ufc_L;
+
+  // Cell data
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+
+  // Cell tensors
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                Eigen::RowMajor> A_e, b_e;
+
+  // Factorization when not cached
+  std::vector<double> A;
+  std::vector<int> pivots;
+};
+
 //-----------------------------------------------------------------------------
 LocalSolver::LocalSolver(std::shared_ptr<const Form> a,
                          std::shared_ptr<const Form> L,
                          SolverType solver_type)
-  : _a(a), _formL(L), _solver_type(solver_type)
+  : _a(a), _formL(L), _solver_type(solver_type),
+    _reuse_factorization(false)
 {
   dolfin_assert(a);
   dolfin_assert(a->rank() == 2);
@@ -56,7 +98,7 @@ LocalSolver::LocalSolver(std::shared_ptr<const Form> a,
 }
 //-----------------------------------------------------------------------------
 LocalSolver::LocalSolver(std::shared_ptr<const Form> a, SolverType solver_type)
-  : _a(a), _solver_type(solver_type)
+  : _a(a), _solver_type(solver_type), _reuse_factorization(false)
 {
   dolfin_assert(a);
   dolfin_assert(a->rank() == 2);
@@ -76,7 +118,7 @@ void LocalSolver::solve_global_rhs(Function& u) const
   GenericVector& x = *(u.vector());
 
   // Solve local problems
-  _solve_local(x, b.get(), nullptr);
+  _solve_local(&x, b.get(), nullptr);
 }
 //-----------------------------------------------------------------------------
 void LocalSolver::solve_local_rhs(Function& u) const
@@ -86,16 +128,16 @@ void LocalSolver::solve_local_rhs(Function& u) const
   GenericVector& x = *(u.vector());
 
   // Loop over all cells and assemble local LHS & RHS which are then solved
-  _solve_local(x, nullptr, nullptr);
+  _solve_local(&x, nullptr, nullptr);
 }
 //-----------------------------------------------------------------------------
 void LocalSolver::solve_local(GenericVector& x, const GenericVector& b,
                               const GenericDofMap& dofmap_b) const
 {
-  _solve_local(x, &b, &dofmap_b);
+  _solve_local(&x, &b, &dofmap_b);
 }
 //-----------------------------------------------------------------------------
-void LocalSolver::_solve_local(GenericVector& x, const GenericVector* global_b,
+void LocalSolver::_solve_local(GenericVector* x, const GenericVector* global_b,
                                const GenericDofMap* dofmap_L) const
 {
   // Check that we have valid bilinear form
@@ -103,221 +145,375 @@ void LocalSolver::_solve_local(GenericVector& x, const GenericVector* global_b,
   dolfin_assert(_a->rank() == 2);
 
   // Set timer
-  Timer timer("Solve local problems");
-
-  // Create UFC objects
-  UFC ufc_a(*_a);
-  std::unique_ptr<UFC> ufc_L;
+  Timer timer(x ? "Solve local problems" : "Factorise local problems");
 
   // Check that we have valid linear form or a dofmap for it
-  if (dofmap_L)
+  const Form* L = nullptr;
+  if (x and dofmap_L)
     dolfin_assert(global_b);
-  else
+  else if (x)
   {
     dolfin_assert(_formL);
     dolfin_assert(_formL->rank() == 1);
     dolfin_assert(_formL->function_space(0)->dofmap());
     dofmap_L = _formL->function_space(0)->dofmap().get();
-    ufc_L.reset(new UFC(*_formL));
+    if (!global_b)
+      L = _formL.get();
   }
 
   // Extract the mesh
   dolfin_assert(_a->function_space(0)->mesh());
   const Mesh& mesh = *_a->function_space(0)->mesh();
 
-  // Get bilinear form dofmaps
-  std::array<std::shared_ptr<const GenericDofMap>, 2> dofmaps_a
-    = {{_a->function_space(0)->dofmap(), _a->function_space(1)->dofmap()}};
-  dolfin_assert(dofmaps_a[0] and dofmaps_a[1]);
-
-  // Extract cell_domains etc from left-hand side form
-  const MeshFunction<std::size_t>* cell_domains
-    = _a->cell_domains().get();
-  const MeshFunction<std::size_t>* exterior_facet_domains
-    = _a->exterior_facet_domains().get();
-  const MeshFunction<std::size_t>* interior_facet_domains
-    = _a->interior_facet_domains().get();
-
-  // Eigen data structures and factorisations for cell data structures
-  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
-                Eigen::RowMajor> A_e, b_e;
-  Eigen::VectorXd x_e;
-  Eigen::PartialPivLU<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
-                                    Eigen::RowMajor>> lu;
-  Eigen::LLT<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
-                           Eigen::RowMajor>> cholesky;
-  bool use_cache = !(_cholesky_cache.empty() and _lu_cache.empty());
-
-  // Loop over cells and solve local problems
-  Progress p("Performing local (cell-wise) solve", mesh.num_cells());
-  ufc::cell ufc_cell;
-  std::vector<double> coordinate_dofs;
-  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  // Compute facet connectivity before iterating over cells
+  // concurrently
+  const std::size_t D = mesh.topology().dim();
+  if (_a->ufc_form()->has_exterior_facet_integrals()
+      or _a->ufc_form()->has_interior_facet_integrals()
+      or (L and (L->ufc_form()->has_exterior_facet_integrals()
+                 or L->ufc_form()->has_interior_facet_integrals())))
   {
-    // Get local-to-global dof maps for cell
-    auto dofs_a0 = dofmaps_a[0]->cell_dofs(cell->index());
-    auto dofs_a1 = dofmaps_a[1]->cell_dofs(cell->index());
-    auto dofs_L = dofmap_L->cell_dofs(cell->index());
-
-    // Check that the local matrix is square
-    if (dofs_a0.size() != dofs_a1.size())
-    {
-      dolfin_error("LocalSolver.cpp",
-                   "assemble local LHS",
-                   "Local LHS dimensions is non square (%d x %d) on cell %d",
-                   dofs_a0.size(), dofs_a1.size(), cell->index());
-    }
+    mesh.init(D - 1);
+    mesh.init(D, D - 1);
+    mesh.init(D - 1, D);
+  }
 
-    // Check that the local RHS matches the LHS
-    if (dofs_a0.size() != dofs_L.size())
-    {
-      dolfin_error("LocalSolver.cpp",
-                   "assemble local RHS",
-                   "Local RHS dimension %d is does not match first dimension "
-                   "%d of LHS on cell %d",
-                   dofs_L.size(), dofs_a0.size(), cell->index());
-    }
+  // Use cached factorisations, or compute (and cache if requested)
+  const bool factorized = !_factors.empty();
+  if (!factorized and (!x or _reuse_factorization))
+    _init_factor_cache(mesh);
 
-    // Update data to current cell
-    cell->get_coordinate_dofs(coordinate_dofs);
+  // Number of threads for the cell loop
+  const std::size_t num_threads = SubSystemsManager::num_threads();
 
-    // Assemble the linear form
-    x_e.resize(dofs_L.size());
-    b_e.resize(dofs_L.size(), 1);
+  // Create work data for each thread
+  std::vector<LocalData> local_data(num_threads, LocalData(*_a, L));
 
-    if (global_b)
+  // Loop over cells and solve local problems
+  Progress p(x ? "Performing local (cell-wise) solve"
+             : "Performing local (cell-wise) factorization", mesh.num_cells());
+  try
+  {
+    const std::size_t num_cells = mesh.num_cells();
+    if (num_threads == 1)
     {
-      // Copy global RHS data into local RHS vector
-      global_b->get_local(b_e.data(), dofs_L.size(), dofs_L.data());
+      for (std::size_t c = 0; c < num_cells; ++c)
+      {
+        _solve_cell(c, factorized, x, global_b, dofmap_L, local_data[0]);
+        p++;
+      }
     }
     else
     {
-      // Assemble local RHS vector
-      LocalAssembler::assemble(b_e, *ufc_L, coordinate_dofs, ufc_cell,
-                               *cell, _formL->cell_domains().get(),
-                               _formL->exterior_facet_domains().get(),
-                               _formL->interior_facet_domains().get());
-    }
+      // Iterate over contiguous blocks of cells concurrently. An
+      // exception cannot leave the parallel region, so the first one
+      // is stored and rethrown.
+      std::exception_ptr error;
+      const std::int64_t _num_cells = num_cells;
+      #pragma omp parallel num_threads(num_threads)
+      {
+#ifdef HAS_OPENMP
+        LocalData& data = local_data[omp_get_thread_num()];
+#else
+        LocalData& data = local_data[0];
+#endif
+        #pragma omp for schedule(static)
+        for (std::int64_t c = 0; c < _num_cells; ++c)
+        {
+          bool failed = false;
+          #pragma omp critical (dolfin_local_solver_error)
+          failed = (bool) error;
+          if (failed)
+            continue;
+
+          try
+          {
+            _solve_cell(c, factorized, x, global_b, dofmap_L, data);
+            #pragma omp critical (dolfin_local_assembler)
+            p++;
+          }
+          catch (...)
+          {
+            #pragma omp critical (dolfin_local_solver_error)
+            if (!error)
+              error = std::current_exception();
+          }
+        }
+      }
 
-    if (use_cache)
-    {
-      // Use cached factorisations
-      if (_solver_type == SolverType::Cholesky)
-        x_e = _cholesky_cache[cell->index()].solve(b_e);
-      else
-        x_e = _lu_cache[cell->index()].solve(b_e);
+      if (error)
+        std::rethrow_exception(error);
     }
-    else
+  }
+  catch (...)
+  {
+    // Do not keep incomplete factorizations
+    if (!factorized)
     {
-      // Assemble the bilinear form
-      A_e.resize(dofs_a0.size(), dofs_a1.size());
-      LocalAssembler::assemble(A_e, ufc_a, coordinate_dofs,
-                               ufc_cell, *cell, cell_domains,
-                               exterior_facet_domains, interior_facet_domains);
-
-      // Factorise and solve
-      if (_solver_type == SolverType::Cholesky)
-      {
-        cholesky.compute(A_e);
-        x_e = cholesky.solve(b_e);
-      }
-      else
-      {
-        lu.compute(A_e);
-        x_e = lu.solve(b_e);
-      }
+      _factors.clear();
+      _factor_offsets.clear();
+      _dof_offsets.clear();
+      _pivots.clear();
     }
-
-    // Insert solution in global vector
-    x.set_local(x_e.data(), dofs_a1.size(), dofs_a1.data());
-
-    // Update progress
-    p++;
+    throw;
   }
 
   // Finalise vector
-  x.apply("insert");
+  if (x)
+    x->apply("insert");
 }
-//----------------------------------------------------------------------------
-void LocalSolver::factorize()
+//-----------------------------------------------------------------------------
+void LocalSolver::_solve_cell(std::size_t cell_index, bool factorized,
+                              GenericVector* x, const GenericVector* global_b,
+                              const GenericDofMap* dofmap_L,
+                              LocalData& data) const
 {
-  // Check that we have valid bilinear and linear forms
-  dolfin_assert(_a);
-  dolfin_assert(_a->rank() == 2);
+  // Get local-to-global dof maps for cell
+  auto dofs_a0 = _a->function_space(0)->dofmap()->cell_dofs(cell_index);
+  auto dofs_a1 = _a->function_space(1)->dofmap()->cell_dofs(cell_index);
 
-  // Set timer
-  Timer timer("Factorise local problems");
+  // Check that the local matrix is square
+  if (dofs_a0.size() != dofs_a1.size())
+  {
+    dolfin_error("LocalSolver.cpp",
+                 "assemble local LHS",
+                 "Local LHS dimensions is non square (%d x %d) on cell %d",
+                 dofs_a0.size(), dofs_a1.size(), cell_index);
+  }
+  const std::size_t n = dofs_a0.size();
 
-  // Extract the mesh
-  dolfin_assert(_a->function_space(0)->mesh());
+  // Update data to current cell
   const Mesh& mesh = *_a->function_space(0)->mesh();
+  const Cell cell(mesh, cell_index);
+  cell.get_coordinate_dofs(data.coordinate_dofs);
 
-  // Resize cache
-  if (_solver_type == SolverType::Cholesky)
-    _cholesky_cache.resize(mesh.num_cells());
+  // Get storage for factorization, cached or per thread
+  double* A = nullptr;
+  int* pivots = nullptr;
+  if (!_factors.empty())
+  {
+    dolfin_assert(_dof_offsets[cell_index + 1] - _dof_offsets[cell_index] == n);
+    A = _factors.data() + _factor_offsets[cell_index];
+    if (!_pivots.empty())
+      pivots = _pivots.data() + _dof_offsets[cell_index];
+  }
   else
-    _lu_cache.resize(mesh.num_cells());
+  {
+    data.A.resize(n*n);
+    data.pivots.resize(n);
+    A = data.A.data();
+    pivots = data.pivots.data();
+  }
 
-  // Create UFC objects
-  UFC ufc_a(*_a);
+  // Assemble the bilinear form and factorise
+  if (!factorized)
+  {
+    data.A_e.resize(n, n);
+    LocalAssembler::assemble(data.A_e, data.ufc_a, data.coordinate_dofs,
+                             data.ufc_cell, cell, _a->cell_domains().get(),
+                             _a->exterior_facet_domains().get(),
+                             _a->interior_facet_domains().get());
+    std::copy(data.A_e.data(), data.A_e.data() + n*n, A);
+    _factorize(A, pivots, n, cell_index);
+  }
 
-  // Get dofmaps
-  std::array<std::shared_ptr<const GenericDofMap>, 2> dofmaps_a
-    = {{_a->function_space(0)->dofmap(), _a->function_space(1)->dofmap()}};
-  dolfin_assert(dofmaps_a[0] and dofmaps_a[1]);
+  if (!x)
+    return;
 
-  // Extract cell_domains etc from left-hand side form
-  const MeshFunction<std::size_t>* cell_domains
-    = _a->cell_domains().get();
-  const MeshFunction<std::size_t>* exterior_facet_domains
-    = _a->exterior_facet_domains().get();
-  const MeshFunction<std::size_t>* interior_facet_domains
-    = _a->interior_facet_domains().get();
+  // Check that the local RHS matches the LHS
+  dolfin_assert(dofmap_L);
+  auto dofs_L = dofmap_L->cell_dofs(cell_index);
+  if (n != (std::size_t) dofs_L.size())
+  {
+    dolfin_error("LocalSolver.cpp",
+                 "assemble local RHS",
+                 "Local RHS dimension %d is does not match first dimension "
+                 "%d of LHS on cell %d",
+                 dofs_L.size(), n, cell_index);
+  }
 
-  // Local dense matrix
-  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> A_e;
+  // Assemble the linear form
+  data.b_e.resize(n, 1);
+  if (global_b)
+  {
+    // Copy global RHS data into local RHS vector
+    #pragma omp critical (dolfin_local_assembler)
+    global_b->get_local(data.b_e.data(), n, dofs_L.data());
+  }
+  else
+  {
+    // Assemble local RHS vector
+    dolfin_assert(data.ufc_L);
+    LocalAssembler::assemble(data.b_e, *data.ufc_L, data.coordinate_dofs,
+                             data.ufc_cell, cell,
+                             _formL->cell_domains().get(),
+                             _formL->exterior_facet_domains().get(),
+                             _formL->interior_facet_domains().get());
+  }
 
-  // Loop over cells and solve local problems
-  Progress p("Performing local (cell-wise) factorization", mesh.num_cells());
-  ufc::cell ufc_cell;
-  std::vector<double> coordinate_dofs;
-  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  // Solve and insert solution in global vector
+  _solve_factorized(A, pivots, n, data.b_e.data());
+  #pragma omp critical (dolfin_local_assembler)
+  x->set_local(data.b_e.data(), n, dofs_a1.data());
+}
+//----------------------------------------------------------------------------
+void LocalSolver::factorize()
+{
+  // Compute and cache factorisations
+  clear_factorization();
+  _solve_local(nullptr, nullptr, nullptr);
+}
+//----------------------------------------------------------------------------
+void LocalSolver::clear_factorization()
+{
+  _factors.clear();
+  _factor_offsets.clear();
+  _dof_offsets.clear();
+  _pivots.clear();
+}
+//-----------------------------------------------------------------------------
+void LocalSolver::set_factorization_reuse(bool reuse)
+{
+  _reuse_factorization = reuse;
+}
+//-----------------------------------------------------------------------------
+void LocalSolver::_init_factor_cache(const Mesh& mesh) const
+{
+  // Compute offsets of cell matrices and pivots
+  const GenericDofMap& dofmap = *_a->function_space(0)->dofmap();
+  const std::size_t num_cells = mesh.num_cells();
+  _dof_offsets.resize(num_cells + 1);
+  _factor_offsets.resize(num_cells + 1);
+  _dof_offsets[0] = 0;
+  _factor_offsets[0] = 0;
+  for (std::size_t c = 0; c < num_cells; ++c)
   {
-    // Get local-to-global dof maps for cell
-    auto dofs_a0 = dofmaps_a[0]->cell_dofs(cell->index());
-    auto dofs_a1 = dofmaps_a[1]->cell_dofs(cell->index());
+    const std::size_t n = dofmap.num_element_dofs(c);
+    _dof_offsets[c + 1] = _dof_offsets[c] + n;
+    _factor_offsets[c + 1] = _factor_offsets[c] + n*n;
+  }
 
-    // Check that the local matrix is square
-    if (dofs_a0.size() != dofs_a1.size())
+  // Allocate storage
+  _factors.resize(_factor_offsets.back());
+  if (_solver_type == SolverType::LU)
+    _pivots.resize(_dof_offsets.back());
+  else
+    _pivots.clear();
+}
+//-----------------------------------------------------------------------------
+void LocalSolver::_factorize(double* A, int* pivots, std::size_t n,
+                             std::size_t cell_index) const
+{
+  if (_solver_type == SolverType::Cholesky)
+  {
+    // Cholesky factorization A = L L^T, L stored in lower triangle
+    for (std::size_t j = 0; j < n; ++j)
     {
-      dolfin_error("LocalSolver.cpp",
-                   "assemble local LHS",
-                   "Local LHS dimensions is non square (%d x %d) on cell %d",
-                   dofs_a0.size(), dofs_a1.size(), cell->index());
-    }
-
-    // Update data to current cell
-    cell->get_coordinate_dofs(coordinate_dofs);
-    A_e.resize(dofs_a0.size(), dofs_a1.size());
+      double d = A[j*n + j];
+      for (std::size_t k = 0; k < j; ++k)
+        d -= A[j*n + k]*A[j*n + k];
+      if (d <= 0.0)
+      {
+        dolfin_error("LocalSolver.cpp",
+                     "factorize local LHS",
+                     "Local LHS is not positive definite on cell %d",
+                     cell_index);
+      }
+      const double l_jj = std::sqrt(d);
+      A[j*n + j] = l_jj;
 
-    // Assemble the bilinear form
-    LocalAssembler::assemble(A_e, ufc_a, coordinate_dofs,
-                             ufc_cell, *cell, cell_domains,
-                             exterior_facet_domains, interior_facet_domains);
+      for (std::size_t i = j + 1; i < n; ++i)
+      {
+        double l_ij = A[i*n + j];
+        for (std::size_t k = 0; k < j; ++k)
+          l_ij -= A[i*n + k]*A[j*n + k];
+        A[i*n + j] = l_ij/l_jj;
+      }
+    }
+  }
+  else
+  {
+    // LU factorization with partial (row) pivoting, PA = LU with
+    // unit lower L
+    dolfin_assert(pivots);
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      // Find pivot and swap rows
+      std::size_t p = k;
+      for (std::size_t i = k + 1; i < n; ++i)
+      {
+        if (std::abs(A[i*n + k]) > std::abs(A[p*n + k]))
+          p = i;
+      }
+      pivots[k] = p;
+      if (p != k)
+        std::swap_ranges(A + k*n, A + (k + 1)*n, A + p*n);
 
-    if (_solver_type == SolverType::Cholesky)
-      _cholesky_cache[cell->index()].compute(A_e);
-    else
-      _lu_cache[cell->index()].compute(A_e);
+      const double a_kk = A[k*n + k];
+      if (a_kk == 0.0)
+      {
+        dolfin_error("LocalSolver.cpp",
+                     "factorize local LHS",
+                     "Local LHS is singular on cell %d", cell_index);
+      }
 
-    // Update progress
-    p++;
+      // Eliminate below pivot
+      for (std::size_t i = k + 1; i < n; ++i)
+      {
+        const double l_ik = A[i*n + k]/a_kk;
+        A[i*n + k] = l_ik;
+        for (std::size_t j = k + 1; j < n; ++j)
+          A[i*n + j] -= l_ik*A[k*n + j];
+      }
+    }
   }
 }
-//----------------------------------------------------------------------------
-void LocalSolver::clear_factorization()
+//-----------------------------------------------------------------------------
+void LocalSolver::_solve_factorized(const double* A, const int* pivots,
+                                    std::size_t n, double* b) const
 {
-  _cholesky_cache.clear();
-  _lu_cache.clear();
+  if (_solver_type == SolverType::Cholesky)
+  {
+    // Forward substitution L y = b
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      for (std::size_t k = 0; k < i; ++k)
+        b[i] -= A[i*n + k]*b[k];
+      b[i] /= A[i*n + i];
+    }
+
+    // Backward substitution L^T x = y
+    for (std::size_t i = n; i-- > 0;)
+    {
+      for (std::size_t k = i + 1; k < n; ++k)
+        b[i] -= A[k*n + i]*b[k];
+      b[i] /= A[i*n + i];
+    }
+  }
+  else
+  {
+    // Apply row permutation
+    dolfin_assert(pivots);
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      if ((std::size_t) pivots[k] != k)
+        std::swap(b[k], b[pivots[k]]);
+    }
+
+    // Forward substitution L y = Pb (unit diagonal)
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      for (std::size_t k = 0; k < i; ++k)
+        b[i] -= A[i*n + k]*b[k];
+    }
+
+    // Backward substitution U x = y
+    for (std::size_t i = n; i-- > 0;)
+    {
+      for (std::size_t k = i + 1; k < n; ++k)
+        b[i] -= A[i*n + k]*b[k];
+      b[i] /= A[i*n + i];
+    }
+  }
 }
 //-----------------------------------------------------------------------------
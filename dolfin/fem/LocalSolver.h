@@ -20,9 +20,7 @@
 
 #include <memory>
 #include <vector>
-#include <Eigen/Cholesky>
 #include <Eigen/Dense>
-#include <Eigen/LU>
 
 namespace dolfin
 {
@@ -31,6 +29,7 @@ namespace dolfin
   class Function;
   class GenericDofMap;
   class GenericVector;
+  class Mesh;
 
   /// Solve problems cell-wise
 
@@ -53,6 +52,13 @@ namespace dolfin
   /// factorize. You can chose upon initialization whether you want
   /// Cholesky or LU (default) factorisations.
   ///
+  /// The factorizations of all cells are stored in a single
+  /// contiguous buffer. With set_factorization_reuse(true), the
+  /// factorizations computed by a solve are kept and reused by the
+  /// following solves (e.g. over time steps), avoiding a separate
+  /// call to factorize. Cells are processed concurrently when the
+  /// global parameter "num_threads" is positive.
+  ///
   /// For forms with no coupling across cell edges, this function is
   /// identical to a global solve. For problems with coupling across
   /// cells it is not.
@@ -120,28 +126,59 @@ namespace dolfin
     /// Reset (clear) any stored factorizations
     void clear_factorization();
 
+    /// Keep the factorizations computed by the next solve and reuse
+    /// them until clear_factorization() is called. This should only
+    /// be used when the LHS form does not change between solves.
+    /// @param reuse (bool)
+    void set_factorization_reuse(bool reuse);
+
   private:
 
+    // Per-thread work data
+    struct LocalData;
+
     // Bilinear and linear forms
     std::shared_ptr<const Form> _a, _formL;
 
     // Solver type to use
     const SolverType _solver_type;
 
-    // Cached LU factorisations of matrices (_spd==false)
-    std::vector<Eigen::PartialPivLU<Eigen::Matrix<double, Eigen::Dynamic,
-                                                  Eigen::Dynamic,
-                                                  Eigen::RowMajor>>> _lu_cache;
-
-    // Cached Cholesky factorisations of matrices (_spd==true)
-    std::vector<Eigen::LLT<Eigen::Matrix<double, Eigen::Dynamic,
-                                         Eigen::Dynamic,
-                                         Eigen::RowMajor>>> _cholesky_cache;
-
-    // Helper function that does the actual calculations
-    void _solve_local(GenericVector& x,
+    // Reuse factorizations computed by a solve
+    bool _reuse_factorization;
+
+    // Cached factorisations of the cell matrices, stored row-major
+    // and contiguously (LU factors, or the lower Cholesky factor).
+    // Cell i starts at _factor_offsets[i] in _factors and its row
+    // pivots (LU only) at _dof_offsets[i] in _pivots. Mutable so that
+    // solves can fill the cache when reusing factorizations.
+    mutable std::vector<double> _factors;
+    mutable std::vector<std::size_t> _factor_offsets, _dof_offsets;
+    mutable std::vector<int> _pivots;
+
+    // Allocate the factorization cache for all cells of the mesh
+    void _init_factor_cache(const Mesh& mesh) const;
+
+    // Helper function that does the actual calculations. Computes
+    // the factorizations and, if x is given, solves the local
+    // problems
+    void _solve_local(GenericVector* x,
                       const GenericVector* global_b,
                       const GenericDofMap* dofmap_L) const;
+
+    // Assemble and factorize (unless cached) and solve (if x is
+    // given) local problem on cell
+    void _solve_cell(std::size_t cell_index, bool factorized,
+                     GenericVector* x, const GenericVector* global_b,
+                     const GenericDofMap* dofmap_L, LocalData& data) const;
+
+    // In-place LU factorization with partial pivoting (_solver_type
+    // LU) or Cholesky factorization of the n x n matrix A
+    void _factorize(double* A, int* pivots, std::size_t n,
+                    std::size_t cell_index) const;
+
+    // In-place solve with factorization computed by _factorize
+    void _solve_factorized(const double* A, const int* pivots,
+                           std::size_t n, double* b) const;
   };
 
 }
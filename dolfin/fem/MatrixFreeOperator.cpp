@@ -0,0 +1,325 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <sstream>
+#include <ufc.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/la/IndexMap.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Facet.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshFunction.h>
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "UFC.h"
+#include "MatrixFreeOperator.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Add cell contribution to y: Ae*xe if x is given, otherwise the
+  // diagonal of Ae
+  void add_cell_contribution(const std::vector<double>& Ae,
+                             std::size_t m, const dolfin::la_index* dofs0,
+                             std::size_t n, const dolfin::la_index* dofs1,
+                             const GenericVector* x, GenericVector& y,
+                             std::vector<double>& xe, std::vector<double>& ye)
+  {
+    ye.assign(m, 0.0);
+    if (x)
+    {
+      xe.resize(n);
+      x->get_local(xe.data(), n, dofs1);
+      for (std::size_t i = 0; i < m; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+          ye[i] += Ae[i*n + j]*xe[j];
+    }
+    else
+    {
+      for (std::size_t i = 0; i < m; ++i)
+        ye[i] = Ae[i*n + i];
+    }
+
+    y.add_local(ye.data(), m, dofs0);
+  }
+}
+
+//-----------------------------------------------------------------------------
+MatrixFreeOperator::MatrixFreeOperator(std::shared_ptr<const Form> a)
+  : LinearOperator(*create_vector(*a, 1), *create_vector(*a, 0)), _a(a),
+    _cell_partition_state(0)
+{
+  // Create ghosted work vectors
+  _x = create_vector(*a, 1);
+  _y = create_vector(*a, 0);
+}
+//-----------------------------------------------------------------------------
+MatrixFreeOperator::~MatrixFreeOperator()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::size_t MatrixFreeOperator::size(std::size_t dim) const
+{
+  dolfin_assert(dim < 2);
+  dolfin_assert(_a->function_space(dim));
+  return _a->function_space(dim)->dim();
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::mult(const GenericVector& x, GenericVector& y) const
+{
+  Timer timer("Apply matrix-free operator");
+  apply(&x, y);
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::get_diagonal(GenericVector& d) const
+{
+  if (*_a->function_space(0) != *_a->function_space(1))
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "compute diagonal of matrix-free operator",
+                 "Operator is not square (test and trial spaces differ)");
+  }
+
+  Timer timer("Compute diagonal of matrix-free operator");
+  apply(NULL, d);
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::init_vector(GenericVector& z, std::size_t dim) const
+{
+  dolfin_assert(dim < 2);
+  dolfin_assert(_a->function_space(dim)->dofmap());
+  z.init(_a->function_space(dim)->dofmap()->ownership_range());
+}
+//-----------------------------------------------------------------------------
+std::string MatrixFreeOperator::str(bool verbose) const
+{
+  std::stringstream s;
+  s << "<MatrixFreeOperator of size " << size(0) << " x " << size(1) << ">";
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::apply(const GenericVector* x, GenericVector& y) const
+{
+  dolfin_assert(_a);
+  const Form& a = *_a;
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *a.mesh();
+
+  // Create data structure for local assembly data
+  UFC ufc(a);
+  if (ufc.form.has_interior_facet_integrals()
+      || ufc.form.has_vertex_integrals())
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "apply matrix-free operator",
+                 "Only cell and exterior facet integrals are supported");
+  }
+
+  // Collect pointers to dof maps
+  dolfin_assert(a.function_space(0)->dofmap());
+  dolfin_assert(a.function_space(1)->dofmap());
+  const GenericDofMap& dofmap0 = *a.function_space(0)->dofmap();
+  const GenericDofMap& dofmap1 = *a.function_space(1)->dofmap();
+
+  // Copy owned values of x to ghosted work vector and start the
+  // ghost update
+  const GenericVector* xg = NULL;
+  if (x)
+  {
+    _x->copy_owned_values(*x);
+    _x->update_ghost_values_begin();
+    xg = _x.get();
+  }
+  _y->zero();
+
+  // Cells which only read owned entries of x are computed while the
+  // ghost values are in flight
+  partition_cells();
+  if (ufc.form.has_cell_integrals())
+    apply_cells(ufc, _interior_cells, xg);
+
+  // Complete ghost update and apply remaining cell integrals
+  if (x)
+    _x->update_ghost_values_end();
+  if (ufc.form.has_cell_integrals())
+    apply_cells(ufc, _boundary_cells, xg);
+
+  std::vector<double> xe, ye;
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+
+  // Apply exterior facet integrals
+  if (ufc.form.has_exterior_facet_integrals())
+  {
+    std::shared_ptr<const MeshFunction<std::size_t>> domains
+      = a.exterior_facet_domains();
+    const bool use_domains = domains && !domains->empty();
+    const ufc::exterior_facet_integral* integral
+      = ufc.default_exterior_facet_integral.get();
+
+    const std::size_t D = mesh.topology().dim();
+    mesh.init(D - 1);
+    mesh.init(D - 1, D);
+    for (FacetIterator facet(mesh); !facet.end(); ++facet)
+    {
+      // Only consider exterior facets
+      if (!facet->exterior())
+        continue;
+
+      // Get integral for sub domain (if any)
+      if (use_domains)
+        integral = ufc.get_exterior_facet_integral((*domains)[*facet]);
+      if (!integral)
+        continue;
+
+      // Get cell to which facet belongs
+      dolfin_assert(facet->num_entities(D) == 1);
+      Cell mesh_cell(mesh, facet->entities(D)[0]);
+      const std::size_t local_facet = mesh_cell.index(*facet);
+
+      // Update to current cell
+      mesh_cell.get_cell_data(ufc_cell, local_facet);
+      mesh_cell.get_coordinate_dofs(coordinate_dofs);
+      ufc.update(mesh_cell, coordinate_dofs, ufc_cell,
+                 integral->enabled_coefficients());
+
+      // Tabulate exterior facet tensor
+      integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                                coordinate_dofs.data(), local_facet,
+                                ufc_cell.orientation);
+
+      auto dofs0 = dofmap0.cell_dofs(mesh_cell.index());
+      auto dofs1 = dofmap1.cell_dofs(mesh_cell.index());
+      add_cell_contribution(ufc.A, dofs0.size(), dofs0.data(),
+                            dofs1.size(), dofs1.data(), xg, *_y, xe, ye);
+    }
+  }
+
+  // Finalize and copy result
+  _y->apply("add");
+  if (y.empty())
+    init_vector(y, 0);
+  y = *_y;
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::partition_cells() const
+{
+  dolfin_assert(_a->mesh());
+  const Mesh& mesh = *_a->mesh();
+  if (!_interior_cells.empty() || !_boundary_cells.empty())
+  {
+    if (_cell_partition_state == mesh.topology().state())
+      return;
+  }
+
+  dolfin_assert(_a->function_space(1)->dofmap());
+  const GenericDofMap& dofmap1 = *_a->function_space(1)->dofmap();
+  dolfin_assert(dofmap1.index_map());
+  const std::size_t owned_size
+    = dofmap1.index_map()->size(IndexMap::MapSize::OWNED);
+
+  _interior_cells.clear();
+  _boundary_cells.clear();
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    auto dofs1 = dofmap1.cell_dofs(cell->index());
+    bool interior = true;
+    for (std::size_t j = 0; j < (std::size_t) dofs1.size(); ++j)
+    {
+      if ((std::size_t) dofs1[j] >= owned_size)
+      {
+        interior = false;
+        break;
+      }
+    }
+
+    if (interior)
+      _interior_cells.push_back(cell->index());
+    else
+      _boundary_cells.push_back(cell->index());
+  }
+  _cell_partition_state = mesh.topology().state();
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::apply_cells(UFC& ufc,
+                                     const std::vector<std::size_t>& cells,
+                                     const GenericVector* x) const
+{
+  const Form& a = *_a;
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *a.mesh();
+  const GenericDofMap& dofmap0 = *a.function_space(0)->dofmap();
+  const GenericDofMap& dofmap1 = *a.function_space(1)->dofmap();
+
+  std::shared_ptr<const MeshFunction<std::size_t>> domains
+    = a.cell_domains();
+  const bool use_domains = domains && !domains->empty();
+  ufc::cell_integral* integral = ufc.default_cell_integral.get();
+
+  std::vector<double> xe, ye;
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+  for (std::size_t c = 0; c < cells.size(); ++c)
+  {
+    const Cell cell(mesh, cells[c]);
+
+    // Get integral for sub domain (if any)
+    if (use_domains)
+      integral = ufc.get_cell_integral((*domains)[cell]);
+    if (!integral)
+      continue;
+
+    // Update to current cell
+    cell.get_cell_data(ufc_cell);
+    cell.get_coordinate_dofs(coordinate_dofs);
+    ufc.update(cell, coordinate_dofs, ufc_cell,
+               integral->enabled_coefficients());
+
+    // Tabulate cell tensor
+    integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                              coordinate_dofs.data(),
+                              ufc_cell.orientation);
+
+    auto dofs0 = dofmap0.cell_dofs(cell.index());
+    auto dofs1 = dofmap1.cell_dofs(cell.index());
+    add_cell_contribution(ufc.A, dofs0.size(), dofs0.data(),
+                          dofs1.size(), dofs1.data(), x, *_y, xe, ye);
+  }
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<GenericVector>
+MatrixFreeOperator::create_vector(const Form& a, std::size_t i)
+{
+  if (a.rank() != 2)
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "create matrix-free operator",
+                 "Expecting a bilinear form (rank 2), not a form of rank %d",
+                 a.rank());
+  }
+
+  dolfin_assert(a.function_space(i));
+  Function u(a.function_space(i));
+  return u.vector();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,115 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __MATRIX_FREE_OPERATOR_H
+#define __MATRIX_FREE_OPERATOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin/la/LinearOperator.h>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Form;
+  class Function;
+  class GenericVector;
+  class UFC;
+
+  /// This class provides the action of the matrix of a bilinear
+  /// form without assembling the matrix. The product y = Ax is
+  /// computed cell by cell: the values of x on a cell are gathered,
+  /// multiplied by the cell tensor and the result is added to y.
+  /// Cell and exterior facet integrals are supported.
+  ///
+  /// The operator can be passed to Krylov solvers in place of an
+  /// assembled matrix. The diagonal of the operator may be computed
+  /// (without assembling the matrix) for Jacobi or Chebyshev
+  /// preconditioning; for the PETSc backend the diagonal is provided
+  /// to PETSc so that the "jacobi" preconditioner may be used
+  /// directly with the operator.
+  ///
+  /// In parallel, the ghost values of x are communicated while the
+  /// cells that only reference owned dofs of x are computed; the
+  /// cells touching ghost dofs are computed afterwards.
+
+  class MatrixFreeOperator : public LinearOperator
+  {
+  public:
+
+    /// Create matrix-free operator for bilinear form
+    ///
+    /// @param[in] a (Form)
+    ///         The bilinear form.
+    explicit MatrixFreeOperator(std::shared_ptr<const Form> a);
+
+    /// Destructor
+    ~MatrixFreeOperator();
+
+    /// Return size of given dimension
+    std::size_t size(std::size_t dim) const;
+
+    /// Compute matrix-vector product y = Ax
+    void mult(const GenericVector& x, GenericVector& y) const;
+
+    /// Compute diagonal of operator (requires a square operator)
+    void get_diagonal(GenericVector& d) const;
+
+    /// Initialize vector z to be compatible with the operator,
+    /// i.e. such that Az (dim = 1) or y in y = Ax (dim = 0) makes
+    /// sense.
+    void init_vector(GenericVector& z, std::size_t dim) const;
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // Compute y = Ax if x is given, otherwise compute diagonal
+    void apply(const GenericVector* x, GenericVector& y) const;
+
+    // Partition local cells into those whose trial dofs are all
+    // owned (interior) and those touching ghost dofs (boundary)
+    void partition_cells() const;
+
+    // Add cell integral contributions from the given cells
+    void apply_cells(UFC& ufc, const std::vector<std::size_t>& cells,
+                     const GenericVector* x) const;
+
+    // Create vector with layout of argument space i of form
+    static std::shared_ptr<GenericVector> create_vector(const Form& a,
+                                                        std::size_t i);
+
+    // The bilinear form
+    std::shared_ptr<const Form> _a;
+
+    // Ghosted work vectors for arguments x and y
+    std::shared_ptr<GenericVector> _x, _y;
+
+    // Cells which can be computed before ghost values of x arrive,
+    // and the remaining cells, with the mesh topology state for which
+    // the partition was computed
+    mutable std::vector<std::size_t> _interior_cells, _boundary_cells;
+    mutable std::size_t _cell_partition_state;
+
+  };
+
+}
+
+#endif
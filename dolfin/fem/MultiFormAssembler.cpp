@@ -0,0 +1,279 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <ufc.h>
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/function/GenericFunction.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/BlockBatch.h>
+#include <dolfin/la/GenericTensor.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshFunction.h>
+#include "Assembler.h"
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "UFC.h"
+#include "MultiFormAssembler.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+MultiFormAssembler::MultiFormAssembler() : _num_shared_restrictions(0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+MultiFormAssembler::~MultiFormAssembler()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void MultiFormAssembler::add(GenericTensor& A, const Form& a)
+{
+  Entry entry = {&a, &A, NULL};
+  _entries.push_back(entry);
+}
+//-----------------------------------------------------------------------------
+void MultiFormAssembler::add(std::vector<double>& values, const Form& a)
+{
+  if (a.rank() != 0)
+  {
+    dolfin_error("MultiFormAssembler.cpp",
+                 "add form to multi-form assembler",
+                 "Cell values can only be assembled for functionals, form has rank %d",
+                 a.rank());
+  }
+  Entry entry = {&a, NULL, &values};
+  _entries.push_back(entry);
+}
+//-----------------------------------------------------------------------------
+void MultiFormAssembler::assemble()
+{
+  _num_shared_restrictions = 0;
+  if (_entries.empty())
+    return;
+
+  Timer timer("Assemble multiple forms");
+  _profile.reset(collect_profile);
+
+  // All forms must be defined on the same mesh
+  dolfin_assert(_entries[0].form->mesh());
+  const Mesh& mesh = *_entries[0].form->mesh();
+  for (std::size_t k = 0; k < _entries.size(); ++k)
+  {
+    dolfin_assert(_entries[k].form->mesh());
+    if (_entries[k].form->mesh()->id() != mesh.id())
+    {
+      dolfin_error("MultiFormAssembler.cpp",
+                   "assemble multiple forms",
+                   "Form %d is defined on a different mesh than form 0", k);
+    }
+  }
+
+  // Prepare local data and targets of each form, and find the
+  // coefficient restrictions that can be shared: a coefficient
+  // function with the same element in several forms gets the same
+  // slot
+  const std::size_t num_forms = _entries.size();
+  std::vector<std::shared_ptr<UFC>> ufcs(num_forms);
+  std::vector<std::vector<const GenericDofMap*>> dofmaps(num_forms);
+  std::vector<std::shared_ptr<BlockBatch>> blocks(num_forms);
+  std::vector<std::vector<std::size_t>> slots(num_forms);
+  std::vector<std::vector<std::size_t>> dims(num_forms);
+  std::map<std::pair<const GenericFunction*, std::string>, std::size_t>
+    slot_map;
+  std::size_t num_slots = 0;
+  for (std::size_t k = 0; k < num_forms; ++k)
+  {
+    const Form& a = *_entries[k].form;
+    AssemblerBase::check(a);
+
+    ufcs[k] = a.ufc_data();
+    ufcs[k]->prefetch_coefficients();
+
+    if (_entries[k].tensor)
+    {
+      init_global_tensor(*_entries[k].tensor, a);
+      blocks[k] = std::make_shared<BlockBatch>(*_entries[k].tensor);
+    }
+    else
+      _entries[k].values->assign(mesh.num_cells(), 0.0);
+
+    for (std::size_t i = 0; i < a.rank(); ++i)
+      dofmaps[k].push_back(a.function_space(i)->dofmap().get());
+
+    const std::vector<std::shared_ptr<const GenericFunction>>
+      coefficients = a.coefficients();
+    for (std::size_t i = 0; i < coefficients.size(); ++i)
+    {
+      std::unique_ptr<ufc::finite_element>
+        element(a.ufc_form()->create_finite_element(a.rank() + i));
+      const std::pair<const GenericFunction*, std::string>
+        key(coefficients[i].get(), element->signature());
+      auto it = slot_map.find(key);
+      if (it == slot_map.end())
+        it = slot_map.insert(std::make_pair(key, num_slots++)).first;
+      slots[k].push_back(it->second);
+      dims[k].push_back(element->space_dimension());
+    }
+  }
+
+  // Restricted values of each slot on the current cell (pointer into
+  // the coefficient array of the form that restricted it), and the
+  // cell it was restricted on (plus one)
+  std::vector<const double*> slot_values(num_slots, NULL);
+  std::vector<std::size_t> slot_cell(num_slots, 0);
+
+  // Coefficients to restrict for each form on the current cell
+  std::vector<std::vector<bool>> restrict_mask(num_forms);
+  for (std::size_t k = 0; k < num_forms; ++k)
+    restrict_mask[k].resize(slots[k].size());
+
+  // Dofs of current cell
+  std::vector<std::vector<ArrayView<const dolfin::la_index>>> dofs(num_forms);
+  for (std::size_t k = 0; k < num_forms; ++k)
+    dofs[k].resize(_entries[k].form->rank());
+
+  // Assemble over cells, computing cell data once for all forms
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    bool have_cell_data = false;
+    for (std::size_t k = 0; k < num_forms; ++k)
+    {
+      const Form& a = *_entries[k].form;
+      UFC& ufc = *ufcs[k];
+      if (!ufc.form.has_cell_integrals())
+        continue;
+
+      // Get integral for sub domain (if any)
+      std::shared_ptr<const MeshFunction<std::size_t>> domains
+        = a.cell_domains();
+      ufc::cell_integral* integral = (domains && !domains->empty())
+        ? ufc.get_cell_integral((*domains)[*cell])
+        : ufc.default_cell_integral.get();
+      if (!integral)
+        continue;
+
+      // Get local-to-global dof maps for cell, skip if at least one
+      // dofmap is empty
+      bool empty_dofmap = false;
+      for (std::size_t i = 0; i < dofmaps[k].size(); ++i)
+      {
+        auto dmap = dofmaps[k][i]->cell_dofs(cell->index());
+        dofs[k][i] = ArrayView<const dolfin::la_index>(dmap.size(),
+                                                       dmap.data());
+        empty_dofmap = empty_dofmap || dofs[k][i].size() == 0;
+      }
+      if (empty_dofmap)
+        continue;
+
+      // Update to current cell (once for all forms)
+      if (!have_cell_data)
+      {
+        _profile.begin(AssemblyProfile::cells);
+        cell->get_cell_data(ufc_cell);
+        cell->get_coordinate_dofs(coordinate_dofs);
+        have_cell_data = true;
+      }
+      else
+        _profile.mark();
+
+      // Restrict coefficients not yet restricted on this cell by an
+      // earlier form, and copy the others
+      const std::vector<bool>& enabled = integral->enabled_coefficients();
+      std::vector<bool>& mask = restrict_mask[k];
+      for (std::size_t i = 0; i < mask.size(); ++i)
+        mask[i] = enabled[i] && slot_cell[slots[k][i]] != cell->index() + 1;
+      ufc.update(*cell, coordinate_dofs, ufc_cell, mask);
+      for (std::size_t i = 0; i < mask.size(); ++i)
+      {
+        if (!enabled[i])
+          continue;
+        const std::size_t s = slots[k][i];
+        if (mask[i])
+        {
+          slot_values[s] = ufc.w()[i];
+          slot_cell[s] = cell->index() + 1;
+        }
+        else
+        {
+          std::copy(slot_values[s], slot_values[s] + dims[k][i],
+                    ufc.w()[i]);
+          ++_num_shared_restrictions;
+        }
+      }
+      _profile.lap(AssemblyProfile::update);
+
+      // Tabulate cell tensor
+      integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                                coordinate_dofs.data(),
+                                ufc_cell.orientation);
+      _profile.lap(AssemblyProfile::tabulate_tensor);
+
+      // Add to target
+      if (_entries[k].values)
+        (*_entries[k].values)[cell->index()] = ufc.A[0];
+      else
+        blocks[k]->add_local(ufc.A.data(), dofs[k]);
+      _profile.lap(AssemblyProfile::add_local);
+    }
+  }
+  _profile.mark();
+  for (std::size_t k = 0; k < num_forms; ++k)
+    if (blocks[k])
+      blocks[k]->flush();
+  _profile.lap(AssemblyProfile::add_local);
+
+  // Assemble facet and vertex integrals form by form
+  Assembler assembler;
+  assembler.num_threads = num_threads;
+  assembler.coloring_type = coloring_type;
+  for (std::size_t k = 0; k < num_forms; ++k)
+  {
+    if (!_entries[k].tensor)
+      continue;
+    const Form& a = *_entries[k].form;
+    GenericTensor& A = *_entries[k].tensor;
+    UFC& ufc = *ufcs[k];
+    assembler.assemble_exterior_facets(A, a, ufc, a.exterior_facet_domains(),
+                                       NULL);
+    assembler.assemble_interior_facets(A, a, ufc, a.interior_facet_domains(),
+                                       a.cell_domains(), NULL);
+    assembler.assemble_vertices(A, a, ufc, a.vertex_domains());
+  }
+
+  // Finalize assembly of global tensors
+  if (finalize_tensor)
+  {
+    _profile.mark();
+    for (std::size_t k = 0; k < num_forms; ++k)
+      if (_entries[k].tensor)
+        _entries[k].tensor->apply("add");
+    _profile.lap(AssemblyProfile::apply);
+  }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __MULTI_FORM_ASSEMBLER_H
+#define __MULTI_FORM_ASSEMBLER_H
+
+#include <cstddef>
+#include <vector>
+#include "AssemblerBase.h"
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Form;
+  class GenericTensor;
+
+  /// This class assembles several forms on the same mesh in one
+  /// pass over the cells. The cell data and coordinate dofs are
+  /// computed once per cell for all forms, and a coefficient that
+  /// appears in several forms with the same element is restricted
+  /// once per cell and copied to the other forms. This reduces the
+  /// cost of assembling e.g. a residual, a few functionals and an
+  /// error indicator at each time step, which is often dominated by
+  /// mesh traversal and coefficient restriction.
+  ///
+  /// Each form is assembled into a global tensor (_Matrix_,
+  /// _Vector_ or _Scalar_) or, for functionals, into a value per
+  /// cell. Exterior facet, interior facet and vertex integrals are
+  /// assembled form by form after the fused cell pass, as by
+  /// _Assembler_. The forms and targets must remain alive until
+  /// assemble() has been called.
+  ///
+  /// @code{.cpp}
+  ///         MultiFormAssembler assembler;
+  ///         assembler.add(b, L);
+  ///         assembler.add(energy, E);
+  ///         assembler.add(indicators, eta);
+  ///         assembler.assemble();
+  /// @endcode
+
+  class MultiFormAssembler : public AssemblerBase
+  {
+  public:
+
+    /// Constructor
+    MultiFormAssembler();
+
+    /// Destructor
+    ~MultiFormAssembler();
+
+    /// Add form to be assembled into global tensor
+    ///
+    /// @param[out] A (GenericTensor)
+    ///         The tensor to assemble.
+    /// @param[in]  a (Form)
+    ///         The form to assemble the tensor from.
+    void add(GenericTensor& A, const Form& a);
+
+    /// Add functional to be assembled cell by cell. Only cell
+    /// integrals contribute to the values.
+    ///
+    /// @param[out] values (std::vector<double>)
+    ///         The value of the functional on each cell (resized to
+    ///         the number of cells).
+    /// @param[in]  a (Form)
+    ///         The functional.
+    void add(std::vector<double>& values, const Form& a);
+
+    /// Return number of added forms
+    std::size_t num_forms() const
+    { return _entries.size(); }
+
+    /// Remove all forms
+    void clear()
+    { _entries.clear(); }
+
+    /// Assemble all added forms
+    void assemble();
+
+    /// Return the number of coefficient restrictions that were
+    /// replaced by a copy of an earlier restriction of the same
+    /// coefficient on the same cell in the last call to assemble()
+    std::size_t num_shared_restrictions() const
+    { return _num_shared_restrictions; }
+
+  private:
+
+    // Form to assemble and its target
+    struct Entry
+    {
+      const Form* form;
+      GenericTensor* tensor;
+      std::vector<double>* values;
+    };
+
+    // Forms and targets
+    std::vector<Entry> _entries;
+
+    // Number of shared restrictions in last call to assemble()
+    std::size_t _num_shared_restrictions;
+
+  };
+
+}
+
+#endif
@@ -18,8 +18,13 @@
 // First added:  2013-09-12
 // Last changed: 2015-11-12
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
 #include <dolfin/function/MultiMeshFunctionSpace.h>
 
+#include <dolfin/la/BlockBatch.h>
 #include <dolfin/la/GenericTensor.h>
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericLinearAlgebraFactory.h>
@@ -38,6 +43,105 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // A pair of cut and cutting cells and the index of the quadrature
+  // rule of their intersection
+  struct CellPair
+  {
+    std::size_t rule;
+    unsigned int cut_cell;
+    std::size_t cutting_part;
+    unsigned int cutting_cell;
+  };
+
+  // Collect the pairs of cut and cutting cells on the given part
+  // with nonempty quadrature rules. The rules are stored in the
+  // order of the collision map.
+  void compute_cell_pairs(std::vector<CellPair>& pairs,
+                          const MultiMesh& multimesh,
+                          std::size_t part,
+                          const MultiMeshQuadratureRules& quadrature_rules)
+  {
+    pairs.clear();
+    std::size_t r = 0;
+    const auto& cmap = multimesh.collision_map_cut_cells(part);
+    for (auto it = cmap.begin(); it != cmap.end(); ++it)
+    {
+      const auto& cutting_cells = it->second;
+      for (auto jt = cutting_cells.begin(); jt != cutting_cells.end(); ++jt)
+      {
+        dolfin_assert(r < quadrature_rules.size());
+        if (quadrature_rules.num_points(r) > 0)
+        {
+          CellPair pair;
+          pair.rule = r;
+          pair.cut_cell = it->first;
+          pair.cutting_part = jt->first;
+          pair.cutting_cell = jt->second;
+          pairs.push_back(pair);
+        }
+        ++r;
+      }
+    }
+  }
+
+  // Coordinate dofs and dofs of the macro element of a pair of cut
+  // and cutting cells
+  struct MacroElementData
+  {
+    MacroElementData(std::size_t form_rank)
+      : macro_dof_ptrs(form_rank), macro_dofs(form_rank) {}
+
+    // Update to given pair of cells
+    void update(UFC& ufc, const MultiMeshForm& a, const MultiMesh& multimesh,
+                std::size_t part, const CellPair& pair)
+    {
+      const Cell cell_0(*multimesh.part(part), pair.cut_cell);
+      const Cell cell_1(*multimesh.part(pair.cutting_part), pair.cutting_cell);
+
+      // Update to current pair of cells
+      cell_0.get_cell_data(ufc_cell[0], 0);
+      cell_1.get_cell_data(ufc_cell[1], 0);
+      cell_0.get_coordinate_dofs(coordinate_dofs[0]);
+      cell_1.get_coordinate_dofs(coordinate_dofs[1]);
+      ufc.update(cell_0, coordinate_dofs[0], ufc_cell[0],
+                 cell_1, coordinate_dofs[1], ufc_cell[1]);
+
+      // Collect vertex coordinates
+      macro_coordinate_dofs.resize(coordinate_dofs[0].size() +
+                                   coordinate_dofs[1].size());
+      std::copy(coordinate_dofs[0].begin(), coordinate_dofs[0].end(),
+                macro_coordinate_dofs.begin());
+      std::copy(coordinate_dofs[1].begin(), coordinate_dofs[1].end(),
+                macro_coordinate_dofs.begin() + coordinate_dofs[0].size());
+
+      // Tabulate dofs for each dimension on macro element
+      for (std::size_t i = 0; i < macro_dofs.size(); i++)
+      {
+        const auto dofmaps = a.function_space(i)->dofmap();
+        const auto dofs_0 = dofmaps->part(part)->cell_dofs(cell_0.index());
+        const auto dofs_1
+          = dofmaps->part(pair.cutting_part)->cell_dofs(cell_1.index());
+
+        // Copy cell dofs into macro dof vector
+        macro_dofs[i].resize(dofs_0.size() + dofs_1.size());
+        std::copy(dofs_0.data(), dofs_0.data() + dofs_0.size(),
+                  macro_dofs[i].begin());
+        std::copy(dofs_1.data(), dofs_1.data() + dofs_1.size(),
+                  macro_dofs[i].begin() + dofs_0.size());
+        macro_dof_ptrs[i].set(macro_dofs[i].size(), macro_dofs[i].data());
+      }
+    }
+
+    ufc::cell ufc_cell[2];
+    std::vector<double> coordinate_dofs[2];
+    std::vector<double> macro_coordinate_dofs;
+    std::vector<ArrayView<const dolfin::la_index>> macro_dof_ptrs;
+    std::vector<std::vector<dolfin::la_index>> macro_dofs;
+  };
+}
+
 //-----------------------------------------------------------------------------
 MultiMeshAssembler::MultiMeshAssembler()
   : extend_cut_cell_integration(false)
@@ -101,6 +205,11 @@ void MultiMeshAssembler::_assemble_uncut_cells(GenericTensor& A,
   ufc::cell ufc_cell;
   std::vector<double> coordinate_dofs;
 
+  // Cell tensors are added to the global tensor in batches (local
+  // and global indices coincide for the multimesh tensor, see
+  // _init_global_tensor)
+  BlockBatch blocks(A);
+
   // Iterate over parts
   for (std::size_t part = 0; part < a.num_parts(); part++)
   {
@@ -153,9 +262,10 @@ void MultiMeshAssembler::_assemble_uncut_cells(GenericTensor& A,
                                 ufc_cell.orientation);
 
       // Add entries to global tensor
-      A.add(ufc_part.A.data(), dofs);
+      blocks.add_local(ufc_part.A.data(), dofs);
     }
   }
+  blocks.flush();
 }
 //-----------------------------------------------------------------------------
 void MultiMeshAssembler::_assemble_cut_cells(GenericTensor& A,
@@ -167,17 +277,8 @@ void MultiMeshAssembler::_assemble_cut_cells(GenericTensor& A,
   // Extract multimesh
   std::shared_ptr<const MultiMesh> multimesh = a.multimesh();
 
-  // Collect pointers to dof maps
-  std::vector<const MultiMeshDofMap*> dofmaps;
-  for (std::size_t i = 0; i < form_rank; i++)
-    dofmaps.push_back(a.function_space(i)->dofmap().get());
-
-  // Vector to hold dof map for a cell
-  std::vector<ArrayView<const dolfin::la_index>> dofs(form_rank);
-
-  // Initialize variables that will be reused throughout assembly
-  ufc::cell ufc_cell;
-  std::vector<double> coordinate_dofs;
+  // Number of threads used for tabulating cell tensors
+  const std::size_t num_threads = std::max<std::size_t>(1, assembly_threads());
 
   // Iterate over parts
   for (std::size_t part = 0; part < a.num_parts(); part++)
@@ -188,7 +289,7 @@ void MultiMeshAssembler::_assemble_cut_cells(GenericTensor& A,
     const Form& a_part = *a.part(part);
 
     // Create data structure for local assembly data
-    UFC ufc_part(a_part);
+    const UFC ufc_part(a_part);
 
     // Extract mesh
     dolfin_assert(a_part.mesh());
@@ -196,81 +297,96 @@ void MultiMeshAssembler::_assemble_cut_cells(GenericTensor& A,
 
     // FIXME: Handle subdomains
 
-    // Get integral
-    ufc::cutcell_integral* integral = ufc_part.default_cutcell_integral.get();
-
     // Skip if we don't have a cutcell integral
-    if (!integral) continue;
+    if (!ufc_part.default_cutcell_integral) continue;
 
-    // Get cut cells and quadrature rules
-    const std::vector<unsigned int>& cut_cells = multimesh->cut_cells(part);
-    const auto& quadrature_rules = multimesh->quadrature_rule_cut_cells(part);
+    // Get dof maps for current part
+    std::vector<std::shared_ptr<const GenericDofMap>> dofmaps(form_rank);
+    for (std::size_t i = 0; i < form_rank; ++i)
+      dofmaps[i] = a.function_space(i)->dofmap()->part(part);
 
-    // Iterate over cut cells
-    for (auto it = cut_cells.begin(); it != cut_cells.end(); ++it)
+    // Get cut cells and quadrature rules. Only quadrature points
+    // with positive weight are included if integration should be
+    // extended on cut cells.
+    const std::vector<unsigned int>& cut_cells = multimesh->cut_cells(part);
+    const MultiMeshQuadratureRules& quadrature_rules
+      = extend_cut_cell_integration
+      ? multimesh->flat_quadrature_rules_extended_cut_cells(part)
+      : multimesh->flat_quadrature_rules_cut_cells(part);
+    dolfin_assert(quadrature_rules.size() == cut_cells.size());
+    const std::size_t gdim = mesh_part.geometry().dim();
+    const int num_cut_cells = cut_cells.size();
+
+    // An exception cannot leave the parallel region, so the first
+    // one is stored and rethrown after it
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+    #pragma omp parallel num_threads(num_threads)
     {
-      // Create cell
-      Cell cell(mesh_part, *it);
-
-      // Update to current cell
-      cell.get_cell_data(ufc_cell);
-      cell.get_coordinate_dofs(coordinate_dofs);
-      ufc_part.update(cell, coordinate_dofs, ufc_cell);
-
-      // Get local-to-global dof maps for cell
-      for (std::size_t i = 0; i < form_rank; ++i)
+      // Thread-local assembly data
+      UFC ufc(ufc_part);
+      ufc::cutcell_integral* integral = ufc.default_cutcell_integral.get();
+      ufc::cell ufc_cell;
+      std::vector<double> coordinate_dofs;
+      std::vector<ArrayView<const dolfin::la_index>> dofs(form_rank);
+
+      // Iterate over cut cells
+      #pragma omp for schedule(guided, 20)
+      for (int r = 0; r < num_cut_cells; ++r)
       {
-        const auto dofmap = a.function_space(i)->dofmap()->part(part);
-        auto dmap = dofmap->cell_dofs(cell.index());
-        dofs[i].set(dmap.size(), dmap.data());
-      }
-
-      // Get quadrature rule for cut cell
-      const auto& qr = quadrature_rules.at(*it);
-
-      // Skip if there are no quadrature points
-      std::size_t num_quadrature_points = qr.second.size();
-      if (num_quadrature_points == 0)
-        continue;
-
-      // FIXME: Handle this inside the quadrature point generation,
-      // FIXME: perhaps by storing three different sets of points,
-      // FIXME: including cut cell, overlap and the whole cell.
+        // Skip remaining cut cells after an error
+        if (failed)
+          continue;
 
-      // Include only quadrature points with positive weight if
-      // integration should be extended on cut cells
-      std::pair<std::vector<double>, std::vector<double>> pr;
-      if (extend_cut_cell_integration)
-      {
-        const std::size_t gdim = mesh_part.geometry().dim();
-        for (std::size_t i = 0; i < num_quadrature_points; i++)
+        try
         {
-          if (qr.second[i] > 0.0)
+          // Skip if there are no quadrature points
+          const std::size_t num_quadrature_points
+            = quadrature_rules.num_points(r);
+          if (num_quadrature_points == 0)
+            continue;
+
+          // Create cell
+          const Cell cell(mesh_part, cut_cells[r]);
+
+          // Update to current cell
+          cell.get_cell_data(ufc_cell);
+          cell.get_coordinate_dofs(coordinate_dofs);
+          ufc.update(cell, coordinate_dofs, ufc_cell);
+
+          // Get local-to-global dof maps for cell
+          for (std::size_t i = 0; i < form_rank; ++i)
           {
-            pr.second.push_back(qr.second[i]);
-            for (std::size_t j = i*gdim; j < (i + 1)*gdim; j++)
-              pr.first.push_back(qr.first[j]);
+            auto dmap = dofmaps[i]->cell_dofs(cell.index());
+            dofs[i].set(dmap.size(), dmap.data());
           }
+
+          // Tabulate cell tensor
+          const std::size_t offset = quadrature_rules.offsets[r];
+          integral->tabulate_tensor(ufc.A.data(),
+                                    ufc.w(),
+                                    coordinate_dofs.data(),
+                                    num_quadrature_points,
+                                    quadrature_rules.points.data() + gdim*offset,
+                                    quadrature_rules.weights.data() + offset,
+                                    ufc_cell.orientation);
+
+          // Add entries to global tensor
+          #pragma omp critical (dolfin_multimesh_assembler_add)
+          A.add(ufc.A.data(), dofs);
+        }
+        catch (...)
+        {
+          #pragma omp critical (dolfin_multimesh_assembler_error)
+          if (!error)
+            error = std::current_exception();
+          failed = true;
         }
-        num_quadrature_points = pr.second.size();
-      }
-      else
-      {
-        pr = qr;
       }
-
-      // Tabulate cell tensor
-      integral->tabulate_tensor(ufc_part.A.data(),
-                                ufc_part.w(),
-                                coordinate_dofs.data(),
-                                num_quadrature_points,
-                                pr.first.data(),
-                                pr.second.data(),
-                                ufc_cell.orientation);
-
-      // Add entries to global tensor
-      A.add(ufc_part.A.data(), dofs);
     }
+
+    if (error)
+      std::rethrow_exception(error);
   }
 }
 //-----------------------------------------------------------------------------
@@ -283,22 +399,8 @@ void MultiMeshAssembler::_assemble_interface(GenericTensor& A,
   // Get form rank
   const std::size_t form_rank = a.rank();
 
-  // Collect pointers to dof maps
-  std::vector<const MultiMeshDofMap*> dofmaps;
-  for (std::size_t i = 0; i < form_rank; i++)
-    dofmaps.push_back(a.function_space(i)->dofmap().get());
-
-  // Vector to hold dof map for a cell
-  std::vector<const std::vector<dolfin::la_index>* > dofs(form_rank);
-
-  // Initialize variables that will be reused throughout assembly
-  ufc::cell ufc_cell[2];
-  std::vector<double> coordinate_dofs[2];
-  std::vector<double> macro_coordinate_dofs;
-
-  // Vector to hold dofs for cells, and a vector holding pointers to same
-  std::vector<ArrayView<const dolfin::la_index>> macro_dof_ptrs(form_rank);
-  std::vector<std::vector<dolfin::la_index>> macro_dofs(form_rank);
+  // Number of threads used for tabulating interface tensors
+  const std::size_t num_threads = std::max<std::size_t>(1, assembly_threads());
 
   // Iterate over parts
   for (std::size_t part = 0; part < a.num_parts(); part++)
@@ -310,166 +412,100 @@ void MultiMeshAssembler::_assemble_interface(GenericTensor& A,
     const Form& a_part = *a.part(part);
 
     // Create data structure for local assembly data
-    UFC ufc_part(a_part);
+    const UFC ufc_part(a_part);
 
     // FIXME: Handle subdomains
 
-    // Get integral
-    ufc::interface_integral* integral = ufc_part.default_interface_integral.get();
-
     // Skip if we don't have an interface integral
-    if (!integral) continue;
-
-    // Get quadrature rules
-    const auto& quadrature_rules = multimesh->quadrature_rule_interface(part);
-
-    // Get collision map
-    const auto& cmap = multimesh->collision_map_cut_cells(part);
-
-    // Get facet normals
-    const auto& facet_normals = multimesh->facet_normals(part);
-
-    // Iterate over all cut cells in collision map
-    for (auto it = cmap.begin(); it != cmap.end(); ++it)
+    if (!ufc_part.default_interface_integral) continue;
+
+    // Get quadrature rules and facet normals
+    const MultiMeshQuadratureRules& quadrature_rules
+      = multimesh->flat_quadrature_rules_interface(part);
+    const std::size_t gdim = a_part.mesh()->geometry().dim();
+    dolfin_assert(quadrature_rules.normals.size()
+                  == gdim*quadrature_rules.weights.size());
+
+    // Get pairs of cut and cutting cells with quadrature points
+    std::vector<CellPair> pairs;
+    compute_cell_pairs(pairs, *multimesh, part, quadrature_rules);
+    const int num_pairs = pairs.size();
+
+    // An exception cannot leave the parallel region, so the first
+    // one is stored and rethrown after it
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+    #pragma omp parallel num_threads(num_threads)
     {
-      // Get cut cell
-      const unsigned int cut_cell_index = it->first;
-      const Cell cut_cell(*multimesh->part(part), cut_cell_index);
-
-      // Iterate over cutting cells
-      const auto& cutting_cells = it->second;
-      for (auto jt = cutting_cells.begin(); jt != cutting_cells.end(); jt++)
+      // Thread-local assembly data
+      UFC ufc(ufc_part);
+      ufc::interface_integral* integral
+        = ufc.default_interface_integral.get();
+      MacroElementData data(form_rank);
+
+      // Iterate over pairs of cut and cutting cells
+      #pragma omp for schedule(guided, 20)
+      for (int p = 0; p < num_pairs; ++p)
       {
-        // Get cutting part and cutting cell
-        const std::size_t cutting_part = jt->first;
-        const std::size_t cutting_cell_index = jt->second;
-        const Cell cutting_cell(*multimesh->part(cutting_part),
-                                cutting_cell_index);
-
-        // Get quadrature rule for interface part defined by
-        // intersection of the cut and cutting cells
-        const std::size_t k = jt - cutting_cells.begin();
-        dolfin_assert(k < quadrature_rules.at(cut_cell_index).size());
-        const auto& qr = quadrature_rules.at(cut_cell_index)[k];
-
-        // FIXME: There might be quite a few cases when we skip cutting
-        // FIXME: cells because there are no quadrature points. Perhaps
-        // FIXME: we can rewrite this inner loop to avoid unnecessary
-        // FIXME: iterations.
-
-        // Skip if there are no quadrature points
-        const std::size_t num_quadrature_points = qr.second.size();
-        if (num_quadrature_points == 0)
+        // Skip remaining pairs of cells after an error
+        if (failed)
           continue;
 
-        // Create aliases for cells to simplify notation
-        const Cell& cell_0 = cut_cell;
-        const Cell& cell_1 = cutting_cell;
-
-        // Update to current pair of cells
-        cell_0.get_cell_data(ufc_cell[0], 0);
-        cell_1.get_cell_data(ufc_cell[1], 0);
-        cell_0.get_coordinate_dofs(coordinate_dofs[0]);
-        cell_1.get_coordinate_dofs(coordinate_dofs[1]);
-        ufc_part.update(cell_0, coordinate_dofs[0], ufc_cell[0],
-                        cell_1, coordinate_dofs[1], ufc_cell[1]);
-
-        // Collect vertex coordinates
-        macro_coordinate_dofs.resize(coordinate_dofs[0].size() +
-                                     coordinate_dofs[0].size());
-        std::copy(coordinate_dofs[0].begin(),
-                  coordinate_dofs[0].end(),
-                  macro_coordinate_dofs.begin());
-        std::copy(coordinate_dofs[1].begin(),
-                  coordinate_dofs[1].end(),
-                  macro_coordinate_dofs.begin()
-                  + coordinate_dofs[0].size());
-
-        // Tabulate dofs for each dimension on macro element
-        for (std::size_t i = 0; i < form_rank; i++)
+        try
         {
-          // Get dofs for cut mesh
-          const auto dofmap_0 = a.function_space(i)->dofmap()->part(part);
-          const auto dofs_0 = dofmap_0->cell_dofs(cell_0.index());
-
-          // Get dofs for cutting mesh
-          const auto dofmap_1
-            = a.function_space(i)->dofmap()->part(cutting_part);
-          const auto dofs_1 = dofmap_1->cell_dofs(cell_1.index());
-
-          // Create space in macro dof vector
-          macro_dofs[i].resize(dofs_0.size() + dofs_1.size());
-
-          // Copy cell dofs into macro dof vector
-          std::copy(dofs_0.data(), dofs_0.data() + dofs_0.size(),
-                    macro_dofs[i].begin());
-          std::copy(dofs_1.data(), dofs_1.data() + dofs_1.size(),
-                    macro_dofs[i].begin() + dofs_0.size());
-
-          // Update array view
-          macro_dof_ptrs[i]
-            = ArrayView<const dolfin::la_index>(macro_dofs[i].size(),
-                                                macro_dofs[i].data());
+          // Update to current pair of cells
+          const CellPair& pair = pairs[p];
+          data.update(ufc, a, *multimesh, part, pair);
+
+          // Get quadrature rule and facet normals for interface part
+          // defined by intersection of the cut and cutting cells
+          const std::size_t offset = quadrature_rules.offsets[pair.rule];
+          const std::size_t num_quadrature_points
+            = quadrature_rules.num_points(pair.rule);
+
+          // FIXME: Cell orientation not supported
+          const int cell_orientation = data.ufc_cell[0].orientation;
+
+          // Tabulate interface tensor on macro element
+          integral->tabulate_tensor(ufc.macro_A.data(),
+                                    ufc.macro_w(),
+                                    data.macro_coordinate_dofs.data(),
+                                    num_quadrature_points,
+                                    quadrature_rules.points.data() + gdim*offset,
+                                    quadrature_rules.weights.data() + offset,
+                                    quadrature_rules.normals.data() + gdim*offset,
+                                    cell_orientation);
+
+          // Add entries to global tensor
+          #pragma omp critical (dolfin_multimesh_assembler_add)
+          A.add(ufc.macro_A.data(), data.macro_dof_ptrs);
+        }
+        catch (...)
+        {
+          #pragma omp critical (dolfin_multimesh_assembler_error)
+          if (!error)
+            error = std::current_exception();
+          failed = true;
         }
-
-        // Get facet normals
-        const auto& n = facet_normals.at(cut_cell_index)[k];
-
-        // FIXME: We would like to use this assertion (but it fails
-        // for 2 meshes)
-        dolfin_assert(n.size() == a_part.mesh()->geometry().dim()*num_quadrature_points);
-
-        // FIXME: For now, use this assertion (which fails for 3 meshes)
-        //dolfin_assert(n.size() > 0);
-
-        // FIXME: Cell orientation not supported
-        const int cell_orientation = ufc_cell[0].orientation;
-
-        // Tabulate interface tensor on macro element
-        integral->tabulate_tensor(ufc_part.macro_A.data(),
-                                  ufc_part.macro_w(),
-                                  macro_coordinate_dofs.data(),
-                                  num_quadrature_points,
-                                  qr.first.data(),
-                                  qr.second.data(),
-                                  n.data(),
-                                  cell_orientation);
-
-        // Add entries to global tensor
-        A.add(ufc_part.macro_A.data(), macro_dof_ptrs);
       }
     }
+
+    if (error)
+      std::rethrow_exception(error);
   }
 }
 //-----------------------------------------------------------------------------
 void MultiMeshAssembler::_assemble_overlap(GenericTensor& A,
                                            const MultiMeshForm& a)
 {
-  // FIXME: This function and assemble_interface are very similar.
-  // FIXME: Refactor to improve code reuse.
-
   // Extract multimesh
   std::shared_ptr<const MultiMesh> multimesh = a.multimesh();
 
   // Get form rank
   const std::size_t form_rank = a.rank();
 
-  // Collect pointers to dof maps
-  std::vector<const MultiMeshDofMap*> dofmaps;
-  for (std::size_t i = 0; i < form_rank; i++)
-    dofmaps.push_back(a.function_space(i)->dofmap().get());
-
-  // Vector to hold dof map for a cell
-  std::vector<const std::vector<dolfin::la_index>* > dofs(form_rank);
-
-  // Initialize variables that will be reused throughout assembly
-  ufc::cell ufc_cell[2];
-  std::vector<double> coordinate_dofs[2];
-  std::vector<double> macro_coordinate_dofs;
-
-  // Vector to hold dofs for cells, and a vector holding pointers to same
-  std::vector<ArrayView<const dolfin::la_index>> macro_dof_ptrs(form_rank);
-  std::vector<std::vector<dolfin::la_index>> macro_dofs(form_rank);
+  // Number of threads used for tabulating overlap tensors
+  const std::size_t num_threads = std::max<std::size_t>(1, assembly_threads());
 
   // Iterate over parts
   for (std::size_t part = 0; part < a.num_parts(); part++)
@@ -480,118 +516,82 @@ void MultiMeshAssembler::_assemble_overlap(GenericTensor& A,
     const Form& a_part = *a.part(part);
 
     // Create data structure for local assembly data
-    UFC ufc_part(a_part);
+    const UFC ufc_part(a_part);
 
     // FIXME: Handle subdomains
 
-    // Get integral
-    ufc::overlap_integral* integral = ufc_part.default_overlap_integral.get();
-
     // Skip if we don't have an overlap integral
-    if (!integral) continue;
+    if (!ufc_part.default_overlap_integral) continue;
 
     // Get quadrature rules
-    const auto& quadrature_rules = multimesh->quadrature_rule_overlap(part);
-
-    // Get collision map
-    const auto& cmap = multimesh->collision_map_cut_cells(part);
-
-    // Iterate over all cut cells in collision map
-    for (auto it = cmap.begin(); it != cmap.end(); ++it)
+    const MultiMeshQuadratureRules& quadrature_rules
+      = multimesh->flat_quadrature_rules_overlap(part);
+    const std::size_t gdim = a_part.mesh()->geometry().dim();
+
+    // Get pairs of cut and cutting cells with quadrature points
+    std::vector<CellPair> pairs;
+    compute_cell_pairs(pairs, *multimesh, part, quadrature_rules);
+    const int num_pairs = pairs.size();
+
+    // An exception cannot leave the parallel region, so the first
+    // one is stored and rethrown after it
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+    #pragma omp parallel num_threads(num_threads)
     {
-      // Get cut cell
-      const unsigned int cut_cell_index = it->first;
-      const Cell cut_cell(*multimesh->part(part), cut_cell_index);
-
-      // Iterate over cutting cells
-      const auto& cutting_cells = it->second;
-      for (auto jt = cutting_cells.begin(); jt != cutting_cells.end(); jt++)
+      // Thread-local assembly data
+      UFC ufc(ufc_part);
+      ufc::overlap_integral* integral = ufc.default_overlap_integral.get();
+      MacroElementData data(form_rank);
+
+      // Iterate over pairs of cut and cutting cells
+      #pragma omp for schedule(guided, 20)
+      for (int p = 0; p < num_pairs; ++p)
       {
-        // Get cutting part and cutting cell
-        const std::size_t cutting_part = jt->first;
-        const std::size_t cutting_cell_index = jt->second;
-        const Cell cutting_cell(*multimesh->part(cutting_part), cutting_cell_index);
-
-        // Get quadrature rule for interface part defined by
-        // intersection of the cut and cutting cells
-        const std::size_t k = jt - cutting_cells.begin();
-        dolfin_assert(k < quadrature_rules.at(cut_cell_index).size());
-        const auto& qr = quadrature_rules.at(cut_cell_index)[k];
-
-        // FIXME: There might be quite a few cases when we skip cutting
-        // FIXME: cells because there are no quadrature points. Perhaps
-        // FIXME: we can rewrite this inner loop to avoid unnecessary
-        // FIXME: iterations.
-
-        // Skip if there are no quadrature points
-        const std::size_t num_quadrature_points = qr.second.size();
-        if (num_quadrature_points == 0)
+        // Skip remaining pairs of cells after an error
+        if (failed)
           continue;
 
-        // Create aliases for cells to simplify notation
-        const Cell& cell_0 = cut_cell;
-        const Cell& cell_1 = cutting_cell;
-
-        // Update to current pair of cells
-        cell_0.get_cell_data(ufc_cell[0], 0);
-        cell_1.get_cell_data(ufc_cell[1], 0);
-        cell_0.get_coordinate_dofs(coordinate_dofs[0]);
-        cell_1.get_coordinate_dofs(coordinate_dofs[1]);
-        ufc_part.update(cell_0, coordinate_dofs[0], ufc_cell[0],
-                        cell_1, coordinate_dofs[1], ufc_cell[1]);
-
-
-        // Collect vertex coordinates
-        macro_coordinate_dofs.resize(coordinate_dofs[0].size() +
-                                     coordinate_dofs[0].size());
-        std::copy(coordinate_dofs[0].begin(),
-                  coordinate_dofs[0].end(),
-                  macro_coordinate_dofs.begin());
-        std::copy(coordinate_dofs[1].begin(),
-                  coordinate_dofs[1].end(),
-                  macro_coordinate_dofs.begin() + coordinate_dofs[0].size());
-
-        // Tabulate dofs for each dimension on macro element
-        for (std::size_t i = 0; i < form_rank; i++)
+        try
         {
-          // Get dofs for cut mesh
-          const auto dofmap_0 = a.function_space(i)->dofmap()->part(part);
-          const auto dofs_0 = dofmap_0->cell_dofs(cell_0.index());
-
-          // Get dofs for cutting mesh
-          const auto dofmap_1 = a.function_space(i)->dofmap()->part(cutting_part);
-          const auto dofs_1 = dofmap_1->cell_dofs(cell_1.index());
-
-          // Create space in macro dof vector
-          macro_dofs[i].resize(dofs_0.size() + dofs_1.size());
-
-          // Copy cell dofs into macro dof vector
-          std::copy(dofs_0.data(), dofs_0.data() + dofs_0.size(),
-                    macro_dofs[i].begin());
-          std::copy(dofs_1.data(), dofs_1.data() + dofs_1.size() ,
-                    macro_dofs[i].begin() + dofs_0.size());
-
-          // Update array view
-          macro_dof_ptrs[i].set(macro_dofs[i].size(),
-                                macro_dofs[i].data());
+          // Update to current pair of cells
+          const CellPair& pair = pairs[p];
+          data.update(ufc, a, *multimesh, part, pair);
+
+          // Get quadrature rule for overlap part defined by
+          // intersection of the cut and cutting cells
+          const std::size_t offset = quadrature_rules.offsets[pair.rule];
+          const std::size_t num_quadrature_points
+            = quadrature_rules.num_points(pair.rule);
+
+          // FIXME: Cell orientation not supported
+          const int cell_orientation = data.ufc_cell[0].orientation;
+
+          // Tabulate overlap tensor on macro element
+          integral->tabulate_tensor(ufc.macro_A.data(),
+                                    ufc.macro_w(),
+                                    data.macro_coordinate_dofs.data(),
+                                    num_quadrature_points,
+                                    quadrature_rules.points.data() + gdim*offset,
+                                    quadrature_rules.weights.data() + offset,
+                                    cell_orientation);
+
+          // Add entries to global tensor
+          #pragma omp critical (dolfin_multimesh_assembler_add)
+          A.add(ufc.macro_A.data(), data.macro_dof_ptrs);
+        }
+        catch (...)
+        {
+          #pragma omp critical (dolfin_multimesh_assembler_error)
+          if (!error)
+            error = std::current_exception();
+          failed = true;
         }
-
-        // FIXME: Cell orientation not supported
-        const int cell_orientation = ufc_cell[0].orientation;
-
-        // Tabulate overlap tensor on macro element
-        integral->tabulate_tensor(ufc_part.macro_A.data(),
-                                  ufc_part.macro_w(),
-                                  macro_coordinate_dofs.data(),
-                                  num_quadrature_points,
-                                  qr.first.data(),
-                                  qr.second.data(),
-                                  cell_orientation);
-
-        // Add entries to global tensor
-        A.add(ufc_part.macro_A.data(), macro_dof_ptrs);
       }
     }
+
+    if (error)
+      std::rethrow_exception(error);
   }
 }
 //-----------------------------------------------------------------------------
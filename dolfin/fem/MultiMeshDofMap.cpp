@@ -102,11 +102,22 @@ void MultiMeshDofMap::build(const MultiMeshFunctionSpace& function_space,
     else
       _offset = offset;
 
-    // Add offset
+    // Add offset (to a new copy since cell dofs storage may be
+    // shared with the original dofmap)
     DofMap& dofmap = static_cast<DofMap&>(*new_dofmap);
     dofmap._multimesh_offset = _offset;
-    for (auto it = dofmap._dofmap.begin(); it != dofmap._dofmap.end(); ++it)
-      *it += _offset;
+    std::shared_ptr<std::vector<la_index>> cell_dofs
+      = std::make_shared<std::vector<la_index>>();
+    cell_dofs->reserve(dofmap.num_cells()*dofmap._cell_dimension);
+    for (std::size_t i = 0; i < dofmap.num_cells(); ++i)
+    {
+      auto dofs = dofmap.cell_dofs(i);
+      for (Eigen::Index j = 0; j < dofs.size(); ++j)
+        cell_dofs->push_back(dofs[j] + _offset);
+    }
+    dofmap._dofmap = cell_dofs;
+    dofmap._dofmap_offset = 0;
+    dofmap._dofmap_stride = dofmap._cell_dimension;
 
     // Increase offset
     offset += _original_dofmaps[part]->global_dimension();
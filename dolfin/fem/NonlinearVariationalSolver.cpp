@@ -188,13 +188,20 @@ NonlinearVariationalSolver::NonlinearDiscreteProblem::J(GenericMatrix& A,
   std::shared_ptr<const Form> F = _problem->residual_form();
   std::vector<std::shared_ptr<const DirichletBC>> bcs(_problem->bcs());
 
-  // Create assembler
+  // Create assembler on first call. The assembler is kept so that
+  // the assembly plan for the Jacobian is reused by later Newton
+  // iterations (the plan is not used by threaded assembly).
   dolfin_assert(J);
   dolfin_assert(F);
-  SystemAssembler assembler(J, F, bcs);
+  if (!_jacobian_assembler)
+  {
+    _jacobian_assembler.reset(new SystemAssembler(J, F, bcs));
+    _jacobian_assembler->use_assembly_plan
+      = (_jacobian_assembler->num_threads == 0);
+  }
 
   // Assemble left-hand side
-  assembler.assemble(A);
+  _jacobian_assembler->assemble(A);
 
   // Print matrix
   dolfin_assert(_solver);
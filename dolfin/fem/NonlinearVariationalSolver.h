@@ -101,6 +101,9 @@ namespace dolfin
       std::shared_ptr<const NonlinearVariationalProblem> _problem;
       std::shared_ptr<const NonlinearVariationalSolver> _solver;
 
+      // Assembler for the Jacobian
+      std::unique_ptr<SystemAssembler> _jacobian_assembler;
+
     };
 
     // The nonlinear problem
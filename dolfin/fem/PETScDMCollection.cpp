@@ -27,6 +27,7 @@
 #include <dolfin/fem/FiniteElement.h>
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/common/RangedIndexSet.h>
+#include <dolfin/mesh/MeshHierarchy.h>
 #include <petscmat.h>
 #include "PETScDMCollection.h"
 
@@ -133,6 +134,53 @@ namespace
 //-----------------------------------------------------------------------------
 PETScDMCollection::PETScDMCollection(std::vector<std::shared_ptr<const FunctionSpace>> function_spaces)
   : _spaces(function_spaces), _dms(function_spaces.size(), nullptr)
+{
+  init();
+}
+//-----------------------------------------------------------------------------
+PETScDMCollection::PETScDMCollection(std::vector<std::shared_ptr<const FunctionSpace>> function_spaces,
+                                     std::shared_ptr<const MeshHierarchy> hierarchy)
+  : _spaces(function_spaces), _dms(function_spaces.size(), nullptr),
+    _hierarchy(hierarchy)
+{
+  dolfin_assert(_hierarchy);
+
+  // Check that spaces are defined on the meshes of the hierarchy
+  if (_spaces.size() != _hierarchy->size())
+  {
+    dolfin_error("PETScDMCollection.cpp",
+                 "create PETScDMCollection",
+                 "Number of function spaces (%d) does not match size of mesh hierarchy (%d)",
+                 _spaces.size(), _hierarchy->size());
+  }
+  for (std::size_t i = 0; i < _spaces.size(); ++i)
+  {
+    dolfin_assert(_spaces[i]);
+    if (_spaces[i]->mesh()->id() != (*_hierarchy)[i]->id())
+    {
+      dolfin_error("PETScDMCollection.cpp",
+                   "create PETScDMCollection",
+                   "Function space %d is not defined on mesh %d of hierarchy",
+                   i, i);
+    }
+  }
+
+  init();
+
+  // Build transfer matrices from parent-child cell relations and
+  // attach to the fine DMs, where they are picked up by
+  // create_interpolation
+  for (std::size_t i = 1; i < _spaces.size(); ++i)
+  {
+    std::shared_ptr<PETScMatrix> P
+      = create_transfer_matrix(*_spaces[i - 1], *_spaces[i],
+                               *_hierarchy->parent_cells(i));
+    PetscObjectCompose((PetscObject)_dms[i], "dolfin_transfer_matrix",
+                       (PetscObject)P->mat());
+  }
+}
+//-----------------------------------------------------------------------------
+void PETScDMCollection::init()
 {
   for (std::size_t i = 0; i < _spaces.size(); ++i)
   {
@@ -607,6 +655,208 @@ std::shared_ptr<PETScMatrix> PETScDMCollection::create_transfer_matrix
   return ptr;
 }
 //-----------------------------------------------------------------------------
+std::shared_ptr<PETScMatrix> PETScDMCollection::create_transfer_matrix
+(const FunctionSpace& coarse_space,
+ const FunctionSpace& fine_space,
+ const std::vector<std::size_t>& parent_cells)
+{
+  // Get meshes
+  dolfin_assert(coarse_space.mesh());
+  dolfin_assert(fine_space.mesh());
+  const Mesh& meshc = *coarse_space.mesh();
+  const Mesh& meshf = *fine_space.mesh();
+  const std::size_t dim = meshc.geometry().dim();
+
+  if (parent_cells.size() != meshf.num_cells())
+  {
+    dolfin_error("PETScDMCollection.cpp",
+                 "create interpolation matrix",
+                 "Number of parent cells (%d) does not match number of fine cells (%d)",
+                 parent_cells.size(), meshf.num_cells());
+  }
+
+  // MPI communicator and size
+  const MPI_Comm mpi_comm = meshc.mpi_comm();
+  const unsigned int mpi_size = MPI::size(mpi_comm);
+
+  // Dofmaps and elements
+  std::shared_ptr<const GenericDofMap> coarsemap = coarse_space.dofmap();
+  std::shared_ptr<const GenericDofMap> finemap = fine_space.dofmap();
+  std::shared_ptr<const FiniteElement> el = coarse_space.element();
+  std::shared_ptr<const FiniteElement> elf = fine_space.element();
+  dolfin_assert(coarsemap and finemap and el and elf);
+
+  // Check that value shapes match
+  if (el->value_rank() != elf->value_rank())
+  {
+    dolfin_error("PETScDMCollection.cpp",
+                 "create interpolation matrix",
+                 "Ranks of function spaces do not match: %d, %d.",
+                 el->value_rank(), elf->value_rank());
+  }
+  std::size_t data_size = 1;
+  for (std::size_t i = 0; i < el->value_rank(); ++i)
+  {
+    if (el->value_dimension(i) != elf->value_dimension(i))
+    {
+      dolfin_error("PETScDMCollection.cpp",
+                   "create interpolation matrix",
+                   "Dimension %d of function space (%d) does not match dimension %d of function space (%d)",
+                   i, el->value_dimension(i), i, elf->value_dimension(i));
+    }
+    data_size *= el->value_dimension(i);
+  }
+
+  // Global and local dimensions of the transfer matrix (M-by-N,
+  // where M is the fine space dimension, N is the coarse space
+  // dimension)
+  const std::size_t M = fine_space.dim();
+  const std::size_t N = coarse_space.dim();
+  const std::size_t m = finemap->dofs().size();
+  const std::size_t n = coarsemap->dofs().size();
+
+  // Number of coarse dofs per cell, and number of fine dofs per cell
+  // and value component (dofs of each component are blocked)
+  const std::size_t eldim = el->space_dimension();
+  const std::size_t elfdim = elf->space_dimension();
+  dolfin_assert(elfdim % data_size == 0);
+  const std::size_t num_component_dofs = elfdim/data_size;
+
+  // Local-to-global maps and ownership ranges
+  std::vector<std::size_t> fine_local_to_global;
+  finemap->tabulate_local_to_global_dofs(fine_local_to_global);
+  std::vector<std::size_t> coarse_local_to_global;
+  coarsemap->tabulate_local_to_global_dofs(coarse_local_to_global);
+  const std::size_t local_size = finemap->ownership_range().second
+    - finemap->ownership_range().first;
+  const std::pair<std::size_t, std::size_t> coarse_range
+    = coarsemap->ownership_range();
+
+  // Rows (local fine dofs) with columns and values
+  std::vector<std::size_t> rows;
+  std::vector<dolfin::la_index> col_indices;
+  std::vector<double> values;
+  std::vector<dolfin::la_index> dnnz(m, 0);
+  std::vector<dolfin::la_index> onnz(m, 0);
+
+  // Visit each owned fine dof once
+  RangedIndexSet already_visited({0, local_size});
+
+  boost::multi_array<double, 2> coordinates;
+  std::vector<double> coordinate_dofs_f;
+  std::vector<double> coordinate_dofs_c;
+  std::vector<double> basis_values(eldim*data_size);
+  ufc::cell ufc_cell;
+
+  for (CellIterator cell(meshf); !cell.end(); ++cell)
+  {
+    // Tabulate fine dof coordinates on cell
+    cell->get_coordinate_dofs(coordinate_dofs_f);
+    elf->tabulate_dof_coordinates(coordinates, coordinate_dofs_f, *cell);
+    auto fine_dofs = finemap->cell_dofs(cell->index());
+
+    // Get parent cell
+    const std::size_t parent = parent_cells[cell->index()];
+    dolfin_assert(parent < meshc.num_cells());
+    const Cell coarse_cell(meshc, parent);
+    coarse_cell.get_coordinate_dofs(coordinate_dofs_c);
+    coarse_cell.get_cell_data(ufc_cell);
+    auto coarse_dofs = coarsemap->cell_dofs(parent);
+
+    for (Eigen::Index i = 0; i < fine_dofs.size(); ++i)
+    {
+      const std::size_t dof = fine_dofs[i];
+      if (dof >= local_size or !already_visited.insert(dof))
+        continue;
+
+      // Evaluate coarse basis functions at fine dof coordinate
+      el->evaluate_basis_all(basis_values.data(), &coordinates[i][0],
+                             coordinate_dofs_c.data(),
+                             ufc_cell.orientation);
+
+      // Value component associated with fine dof
+      const std::size_t k = i/num_component_dofs;
+      dolfin_assert(k < data_size);
+
+      rows.push_back(dof);
+      for (std::size_t j = 0; j < eldim; ++j)
+      {
+        const std::size_t coarse_dof = coarse_local_to_global[coarse_dofs[j]];
+        col_indices.push_back(coarse_dof);
+        values.push_back(basis_values[data_size*j + k]);
+        if (coarse_dof >= coarse_range.first
+            and coarse_dof < coarse_range.second)
+        {
+          ++dnnz[dof];
+        }
+        else
+          ++onnz[dof];
+      }
+    }
+  }
+
+  // Initialise PETSc Mat and error code
+  PetscErrorCode ierr;
+  Mat I;
+
+  // Create and initialise the transfer matrix as MATMPIAIJ/MATSEQAIJ
+  ierr = MatCreate(mpi_comm, &I); CHKERRABORT(PETSC_COMM_WORLD, ierr);
+  ierr = MatSetSizes(I, m, n, M, N); CHKERRABORT(PETSC_COMM_WORLD, ierr);
+  if (mpi_size > 1)
+  {
+    ierr = MatSetType(I, MATMPIAIJ); CHKERRABORT(PETSC_COMM_WORLD, ierr);
+    ierr = MatMPIAIJSetPreallocation(I, PETSC_DEFAULT, dnnz.data(),
+                                     PETSC_DEFAULT, onnz.data());
+    CHKERRABORT(PETSC_COMM_WORLD, ierr);
+  }
+  else
+  {
+    ierr = MatSetType(I, MATSEQAIJ); CHKERRABORT(PETSC_COMM_WORLD, ierr);
+    ierr = MatSeqAIJSetPreallocation(I, PETSC_DEFAULT, dnnz.data());
+    CHKERRABORT(PETSC_COMM_WORLD, ierr);
+  }
+
+  // Set transfer matrix values row by row
+  for (std::size_t r = 0; r < rows.size(); ++r)
+  {
+    PetscInt fine_dof = fine_local_to_global[rows[r]];
+    ierr = MatSetValues(I, 1, &fine_dof, eldim, col_indices.data() + r*eldim,
+                        values.data() + r*eldim, INSERT_VALUES);
+    CHKERRABORT(PETSC_COMM_WORLD, ierr);
+  }
+
+  // Assemble the transfer matrix
+  ierr = MatAssemblyBegin(I, MAT_FINAL_ASSEMBLY); CHKERRABORT(PETSC_COMM_WORLD, ierr);
+  ierr = MatAssemblyEnd(I, MAT_FINAL_ASSEMBLY); CHKERRABORT(PETSC_COMM_WORLD, ierr);
+
+  // Create shared pointer and return the pointer to the transfer
+  // matrix
+  std::shared_ptr<PETScMatrix> ptr = std::make_shared<PETScMatrix>(I);
+  ierr = MatDestroy(&I); CHKERRABORT(PETSC_COMM_WORLD, ierr);
+  return ptr;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<PETScMatrix> PETScDMCollection::transfer_matrix(int i)
+{
+  dolfin_assert(i >= -(int)_dms.size() and i < (int) _dms.size());
+  const int level = i < 0 ? _dms.size() + i : i;
+  if (level == 0)
+  {
+    dolfin_error("PETScDMCollection.cpp",
+                 "get transfer matrix",
+                 "There is no transfer matrix to the coarsest level");
+  }
+
+  // Get (cached) interpolation matrix
+  Mat P;
+  Vec v;
+  create_interpolation(_dms[level - 1], _dms[level], &P, &v);
+  std::shared_ptr<PETScMatrix> A = std::make_shared<PETScMatrix>(P);
+  MatDestroy(&P);
+
+  return A;
+}
+//-----------------------------------------------------------------------------
 void PETScDMCollection::find_exterior_points(MPI_Comm mpi_comm,
                                              std::shared_ptr<const BoundingBoxTree> treec,
                                              int dim, int data_size,
@@ -734,12 +984,24 @@ PetscErrorCode PETScDMCollection::create_interpolation(DM dmc, DM dmf, Mat *mat,
   DMShellGetContext(dmc, (void**)&V0);
   DMShellGetContext(dmf, (void**)&V1);
 
-  // Build interpolation matrix (V0 to V1)
-  dolfin_assert(V0); dolfin_assert(V1);
-  std::shared_ptr<PETScMatrix> P = create_transfer_matrix(*V0, *V1);
+  // Use interpolation matrix attached to the fine DM, if any (from
+  // parent-child cell relations or a previous call)
+  Mat P = NULL;
+  PetscObjectQuery((PetscObject)dmf, "dolfin_transfer_matrix",
+                   (PetscObject*)&P);
+  if (!P)
+  {
+    // Build interpolation matrix (V0 to V1) and attach to fine DM for
+    // reuse
+    dolfin_assert(V0); dolfin_assert(V1);
+    std::shared_ptr<PETScMatrix> A = create_transfer_matrix(*V0, *V1);
+    P = A->mat();
+    PetscObjectCompose((PetscObject)dmf, "dolfin_transfer_matrix",
+                       (PetscObject)P);
+  }
 
   // Copy PETSc matrix pointer and inrease reference count
-  *mat = P->mat();
+  *mat = P;
   PetscObjectReference((PetscObject)*mat);
 
   // Set optional vector to NULL
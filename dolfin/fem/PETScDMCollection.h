@@ -33,6 +33,7 @@ namespace dolfin
 
   class FunctionSpace;
   class BoundingBoxTree;
+  class MeshHierarchy;
 
   /// This class builds and stores of collection of PETSc DM objects
   /// from a hierarchy of FunctionSpaces objects. The DM objects are
@@ -49,6 +50,13 @@ namespace dolfin
     /// coarse to fine.
     PETScDMCollection(std::vector<std::shared_ptr<const FunctionSpace>> function_spaces);
 
+    /// Construct PETScDMCollection from a vector of FunctionSpaces
+    /// on the meshes of a MeshHierarchy (from coarse to fine). The
+    /// transfer matrices are built from the parent-child cell
+    /// relations recorded during refinement, without point location.
+    PETScDMCollection(std::vector<std::shared_ptr<const FunctionSpace>> function_spaces,
+                      std::shared_ptr<const MeshHierarchy> hierarchy);
+
     /// Destructor
     ~PETScDMCollection();
 
@@ -69,8 +77,26 @@ namespace dolfin
       create_transfer_matrix(const FunctionSpace& coarse_space,
                              const FunctionSpace& fine_space);
 
+    /// Create the interpolation matrix from the coarse to the fine
+    /// space (prolongation matrix), where parent_cells[i] is the
+    /// (local) cell of the coarse mesh containing cell i of the fine
+    /// mesh, as recorded during refinement. No point location or
+    /// communication of points is required.
+    static std::shared_ptr<PETScMatrix>
+      create_transfer_matrix(const FunctionSpace& coarse_space,
+                             const FunctionSpace& fine_space,
+                             const std::vector<std::size_t>& parent_cells);
+
+    /// Return the interpolation matrix from level i - 1 to level i
+    /// (prolongation matrix). The matrix is created on first use and
+    /// cached, and is reused by PETSc when setting up multigrid.
+    std::shared_ptr<PETScMatrix> transfer_matrix(int i);
+
   private:
 
+    // Initialise DM objects for all spaces
+    void init();
+
     // Find the nearest cells to points which lie outside the domain
     static void find_exterior_points(MPI_Comm mpi_comm,
                                      std::shared_ptr<const BoundingBoxTree> treec,
@@ -97,6 +123,9 @@ namespace dolfin
     // The PETSc DM objects
     std::vector<DM> _dms;
 
+    // Hierarchy of meshes of the spaces (if any)
+    std::shared_ptr<const MeshHierarchy> _hierarchy;
+
   };
 
 }
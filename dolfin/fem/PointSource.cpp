@@ -123,84 +123,123 @@ void PointSource::distribute_sources(const Mesh& mesh,
 {
   // Take a list of points, and assign to correct process
   const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t mpi_size = MPI::size(mpi_comm);
   const std::shared_ptr<BoundingBoxTree> tree = mesh.bounding_box_tree();
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
 
-  // Collect up any points/values which are not local
-  std::vector<double> remote_points;
+  // Keep local sources, and send the others to the processes whose
+  // bounding box contains them
+  std::vector<std::pair<Point, double>> remote_sources;
+  std::vector<std::vector<double>> points_send(mpi_size);
+  std::vector<std::vector<std::size_t>> sent_sources(mpi_size);
   for (auto & s : sources)
   {
     const Point& p = s.first;
-    double magnitude = s.second;
-
-    unsigned int cell_index = tree->compute_first_entity_collision(p);
-    if (cell_index == std::numeric_limits<unsigned int>::max())
+    const unsigned int cell_index = tree->compute_first_entity_collision(p);
+    if (cell_index != not_found)
     {
-      remote_points.insert(remote_points.end(), p.coordinates(),
-                           p.coordinates() + 3);
-      remote_points.push_back(magnitude);
+      _sources.push_back(s);
+      _cells.push_back(cell_index);
     }
     else
-      _sources.push_back({p, magnitude});
-  }
-
-  // Send all non-local points out to all other processes
-  const int mpi_size = MPI::size(mpi_comm);
-  const int mpi_rank = MPI::rank(mpi_comm);
-  std::vector<std::vector<double>> remote_points_all(mpi_size);
-  MPI::all_gather(mpi_comm, remote_points, remote_points_all);
-
-  // Flatten result back into remote_points vector
-  // All processes will have the same data
-  remote_points.clear();
-  for (auto &q : remote_points_all)
-    remote_points.insert(remote_points.end(), q.begin(), q.end());
-
-  // Go through all received points, looking for any which are local
-  std::vector<int> point_count;
-  for (auto q = remote_points.begin(); q != remote_points.end(); q += 4)
-  {
-    Point p(*q, *(q + 1), *(q + 2));
-    unsigned int cell_index = tree->compute_first_entity_collision(p);
-    point_count.push_back(cell_index != std::numeric_limits<unsigned int>::max());
+    {
+      const std::vector<unsigned int> processes
+        = tree->compute_process_collisions(p);
+      for (auto q : processes)
+      {
+        points_send[q].insert(points_send[q].end(), p.coordinates(),
+                              p.coordinates() + 3);
+        sent_sources[q].push_back(remote_sources.size());
+      }
+      remote_sources.push_back(s);
+    }
   }
 
-  // Send out the results of the search to all processes
-  std::vector<std::vector<int>> point_count_all(mpi_size);
-  MPI::all_gather(mpi_comm, point_count, point_count_all);
+  // Send points to candidate processes
+  std::vector<std::vector<double>> points_recv;
+  MPI::all_to_all(mpi_comm, points_send, points_recv);
 
-  // Check the point exists on some process, and prioritise lower rank
-  for (std::size_t i = 0; i < point_count.size(); ++i)
+  // Locate received points and return the result
+  std::vector<std::vector<unsigned int>> cells_recv(mpi_size);
+  for (std::size_t q = 0; q < mpi_size; ++q)
   {
-    bool found = false;
-    for (int j = 0; j < mpi_size; ++j)
+    for (std::size_t i = 0; i < points_recv[q].size(); i += 3)
     {
-      // Clear higher ranked 'finds' if already found on a lower rank
-      // process
-      if (found)
-        point_count_all[j][i] = 0;
-
-      if (point_count_all[j][i] != 0)
-        found = true;
+      const Point p(points_recv[q][i], points_recv[q][i + 1],
+                    points_recv[q][i + 2]);
+      cells_recv[q].push_back(tree->compute_first_entity_collision(p));
     }
-    if (!found)
+  }
+  std::vector<std::vector<unsigned int>> found;
+  MPI::all_to_all(mpi_comm, cells_recv, found);
+
+  // Assign each remote source to the lowest ranked process which
+  // found it
+  std::vector<std::size_t> owner(remote_sources.size(), mpi_size);
+  std::vector<std::size_t> position(remote_sources.size());
+  for (std::size_t q = 0; q < mpi_size; ++q)
+  {
+    dolfin_assert(found[q].size() == sent_sources[q].size());
+    for (std::size_t i = 0; i < found[q].size(); ++i)
     {
-      dolfin_error("PointSource.cpp",
-                   "apply point source to vector",
-                   "The point is outside of the domain"); // (%s)", p.str().c_str());
+      const std::size_t r = sent_sources[q][i];
+      if (found[q][i] != not_found and owner[r] == mpi_size)
+      {
+        owner[r] = q;
+        position[r] = i;
+      }
     }
   }
 
-  unsigned int i = 0;
-  for (auto q = remote_points.begin(); q != remote_points.end(); q += 4)
+  // Check the points exist on some process (on all processes
+  // simultaneously)
+  std::size_t num_outside = 0;
+  for (auto q : owner)
+    num_outside += (q == mpi_size);
+  if (MPI::max(mpi_comm, num_outside) > 0)
+  {
+    dolfin_error("PointSource.cpp",
+                 "apply point source to vector",
+                 "The point is outside of the domain");
+  }
+
+  // Send (position, magnitude) of remote sources to their owners
+  std::vector<std::vector<double>> claims_send(mpi_size);
+  for (std::size_t r = 0; r < remote_sources.size(); ++r)
+  {
+    claims_send[owner[r]].push_back(position[r]);
+    claims_send[owner[r]].push_back(remote_sources[r].second);
+  }
+  std::vector<std::vector<double>> claims_recv;
+  MPI::all_to_all(mpi_comm, claims_send, claims_recv);
+
+  for (std::size_t q = 0; q < mpi_size; ++q)
   {
-    if (point_count_all[mpi_rank][i] == 1)
+    for (std::size_t i = 0; i < claims_recv[q].size(); i += 2)
     {
-      const Point p(*q, *(q + 1), *(q + 2));
-      double val = *(q + 3);
-      _sources.push_back({p, val});
+      const std::size_t k = claims_recv[q][i];
+      const double* x = points_recv[q].data() + 3*k;
+      _sources.push_back({Point(x[0], x[1], x[2]), claims_recv[q][i + 1]});
+      _cells.push_back(cells_recv[q][k]);
     }
-    ++i;
   }
+
+  _geometry_state = mesh.geometry().state();
+}
+//-----------------------------------------------------------------------------
+void PointSource::update_cells(const Mesh& mesh)
+{
+  // Locate sources again if the mesh has moved
+  if (_geometry_state == mesh.geometry().state())
+    return;
+
+  const std::shared_ptr<BoundingBoxTree> tree = mesh.bounding_box_tree();
+  for (std::size_t i = 0; i < _sources.size(); ++i)
+    _cells[i] = tree->compute_first_entity_collision(_sources[i].first);
+
+  _geometry_state = mesh.geometry().state();
+  _vector_dofs.clear();
+  _vector_values.clear();
 }
 //-----------------------------------------------------------------------------
 void PointSource::apply(GenericVector& b)
@@ -217,60 +256,64 @@ void PointSource::apply(GenericVector& b)
 
   dolfin_assert(_function_space0->mesh());
   const Mesh& mesh = *_function_space0->mesh();
-  const std::shared_ptr<BoundingBoxTree> tree = mesh.bounding_box_tree();
-
-  // Variables for cell information
-  std::vector<double> coordinate_dofs;
-  ufc::cell ufc_cell;
-
-  // Variables for evaluating basis
-  dolfin_assert(_function_space0->element());
-  const std::size_t rank = _function_space0->element()->value_rank();
-  std::size_t size_basis = 1;
-  for (std::size_t i = 0; i < rank; ++i)
-    size_basis *= _function_space0->element()->value_dimension(i);
-  std::size_t dofs_per_cell = _function_space0->element()->space_dimension();
-  std::vector<double> basis(size_basis);
-  std::vector<double> values(dofs_per_cell);
-
-  // Variables for adding local information to vector
-  double basis_sum;
+  update_cells(mesh);
 
-  for (auto & s : _sources)
+  // Tabulate (dof, value) pairs of all sources on first application
+  if (_vector_dofs.empty() and !_sources.empty())
   {
-    Point& p = s.first;
-    double magnitude = s.second;
+    // Variables for cell information
+    std::vector<double> coordinate_dofs;
+    ufc::cell ufc_cell;
+
+    // Variables for evaluating basis
+    dolfin_assert(_function_space0->element());
+    const std::size_t rank = _function_space0->element()->value_rank();
+    std::size_t size_basis = 1;
+    for (std::size_t i = 0; i < rank; ++i)
+      size_basis *= _function_space0->element()->value_dimension(i);
+    std::size_t dofs_per_cell = _function_space0->element()->space_dimension();
+    std::vector<double> basis(size_basis);
+
+    // Variables for adding local information to vector
+    double basis_sum;
+
+    _vector_dofs.reserve(_sources.size()*dofs_per_cell);
+    _vector_values.reserve(_sources.size()*dofs_per_cell);
+    for (std::size_t s = 0; s < _sources.size(); ++s)
+    {
+      const Point& p = _sources[s].first;
+      const double magnitude = _sources[s].second;
 
-    unsigned int cell_index = tree->compute_first_entity_collision(p);
+      // Create cell
+      Cell cell(mesh, static_cast<std::size_t>(_cells[s]));
+      cell.get_coordinate_dofs(coordinate_dofs);
 
-    // Create cell
-    Cell cell(mesh, static_cast<std::size_t>(cell_index));
-    cell.get_coordinate_dofs(coordinate_dofs);
+      // Evaluate all basis functions at the point()
+      cell.get_cell_data(ufc_cell);
 
-    // Evaluate all basis functions at the point()
-    cell.get_cell_data(ufc_cell);
+      // Compute local-to-global mapping
+      dolfin_assert(_function_space0->dofmap());
+      auto dofs = _function_space0->dofmap()->cell_dofs(cell.index());
 
-    for (std::size_t i = 0; i < dofs_per_cell; ++i)
-    {
-      _function_space0->element()->evaluate_basis(i, basis.data(),
-	  					     p.coordinates(),
-						     coordinate_dofs.data(),
-						     ufc_cell.orientation);
-
-      basis_sum = 0.0;
-      for (const auto& v : basis)
-        basis_sum += v;
-      values[i] = magnitude*basis_sum;
+      for (std::size_t i = 0; i < dofs_per_cell; ++i)
+      {
+        _function_space0->element()->evaluate_basis(i, basis.data(),
+                                                    p.coordinates(),
+                                                    coordinate_dofs.data(),
+                                                    ufc_cell.orientation);
+
+        basis_sum = 0.0;
+        for (const auto& v : basis)
+          basis_sum += v;
+        _vector_dofs.push_back(dofs[i]);
+        _vector_values.push_back(magnitude*basis_sum);
+      }
     }
-
-    // Compute local-to-global mapping
-    dolfin_assert(_function_space0->dofmap());
-    auto dofs = _function_space0->dofmap()->cell_dofs(cell.index());
-
-    // Add values to vector
-    b.add_local(values.data(), dofs_per_cell, dofs.data());
   }
 
+  // Add values of all sources to vector
+  b.add_local(_vector_values.data(), _vector_values.size(),
+              _vector_dofs.data());
   b.apply("add");
 }
 //-----------------------------------------------------------------------------
@@ -304,9 +347,7 @@ void PointSource::apply(GenericMatrix& A)
   dolfin_assert(V1->dofmap());
 
   const auto mesh = V0->mesh();
-
-  const std::shared_ptr<BoundingBoxTree> tree = mesh->bounding_box_tree();
-  unsigned int cell_index;
+  update_cells(*mesh);
 
   // Variables for cell information
   std::vector<double> coordinate_dofs;
@@ -361,14 +402,13 @@ void PointSource::apply(GenericMatrix& A)
     }
   }
 
-  for (auto & s : _sources)
+  for (std::size_t s = 0; s < _sources.size(); ++s)
   {
-    Point& p = s.first;
-    double magnitude = s.second;
+    const Point& p = _sources[s].first;
+    const double magnitude = _sources[s].second;
 
     // Create cell
-    cell_index = tree->compute_first_entity_collision(p);
-    Cell cell(*mesh, static_cast<std::size_t>(cell_index));
+    Cell cell(*mesh, static_cast<std::size_t>(_cells[s]));
 
     // Cell information
     cell.get_coordinate_dofs(coordinate_dofs);
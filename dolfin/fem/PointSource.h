@@ -21,6 +21,7 @@
 #include <memory>
 #include <utility>
 #include <vector>
+#include <dolfin/common/types.h>
 #include <dolfin/geometry/Point.h>
 
 namespace dolfin
@@ -80,6 +81,10 @@ namespace dolfin
     void distribute_sources(const Mesh& mesh,
                             const std::vector<std::pair<Point, double>>& sources);
 
+    // Locate sources again if the mesh geometry has changed since
+    // they were located
+    void update_cells(const Mesh& mesh);
+
     // Check that function space is scalar
     static void check_space_supported(const FunctionSpace& V);
 
@@ -90,6 +95,17 @@ namespace dolfin
     // Source term - pair of points and magnitude
     std::vector<std::pair<Point, double>> _sources;
 
+    // Local cell containing each source, and mesh geometry state when
+    // the cells were computed
+    std::vector<unsigned int> _cells;
+    std::size_t _geometry_state;
+
+    // Local dofs and values added to a vector by all sources (the
+    // columns of a sparse source-to-dof matrix multiplied by the
+    // magnitudes), tabulated on first application
+    std::vector<dolfin::la_index> _vector_dofs;
+    std::vector<double> _vector_values;
+
   };
 
 }
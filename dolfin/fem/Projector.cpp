@@ -0,0 +1,190 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include <dolfin/common/Timer.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/DefaultFactory.h>
+#include <dolfin/la/GenericMatrix.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/la/LUSolver.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Mesh.h>
+#include "assemble.h"
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "LocalSolver.h"
+#include "Projector.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+Projector::Projector(std::shared_ptr<const Form> a, std::string method)
+  : _a(a), _method(method), _mesh_id(0), _geometry_state(0),
+    _topology_state(0), _num_assemblies(0)
+{
+  dolfin_assert(_a);
+  if (_a->rank() != 2)
+  {
+    dolfin_error("Projector.cpp",
+                 "create projector",
+                 "Expecting mass form of rank 2, form has rank %d",
+                 _a->rank());
+  }
+
+  if (!(*_a->function_space(0) == *_a->function_space(1)))
+  {
+    dolfin_error("Projector.cpp",
+                 "create projector",
+                 "Test and trial spaces of mass form differ");
+  }
+
+  if (_method != "lu" and _method != "lumped" and _method != "local")
+  {
+    dolfin_error("Projector.cpp",
+                 "create projector",
+                 "Unknown projection method \"%s\". Use \"lu\", \"lumped\" or \"local\"",
+                 _method.c_str());
+  }
+}
+//-----------------------------------------------------------------------------
+Projector::~Projector()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void Projector::project(Function& u, const Form& L)
+{
+  Timer timer("Projection");
+
+  // Check arguments
+  if (L.rank() != 1)
+  {
+    dolfin_error("Projector.cpp",
+                 "project function",
+                 "Expecting right-hand side form of rank 1, form has rank %d",
+                 L.rank());
+  }
+  dolfin_assert(u.function_space());
+  if (!(*u.function_space() == *_a->function_space(0))
+      or !(*L.function_space(0) == *_a->function_space(0)))
+  {
+    dolfin_error("Projector.cpp",
+                 "project function",
+                 "Function or right-hand side is not in the target space of the projector");
+  }
+
+  // Assemble (and factorize) mass matrix if needed
+  init();
+
+  // Assemble right-hand side
+  dolfin_assert(u.vector());
+  if (!_b)
+    _b = u.vector()->factory().create_vector(u.vector()->mpi_comm());
+  assemble(*_b, L);
+
+  // Solve
+  GenericVector& x = *u.vector();
+  if (_method == "lu")
+  {
+    dolfin_assert(_solver);
+    _solver->solve(x, *_b);
+  }
+  else if (_method == "lumped")
+  {
+    dolfin_assert(_inverse_diagonal);
+    x = *_b;
+    x *= *_inverse_diagonal;
+  }
+  else
+  {
+    dolfin_assert(_local_solver);
+    _local_solver->solve_local(x, *_b, *L.function_space(0)->dofmap());
+  }
+}
+//-----------------------------------------------------------------------------
+void Projector::init()
+{
+  dolfin_assert(_a->mesh());
+  const Mesh& mesh = *_a->mesh();
+  if (_num_assemblies > 0 and _mesh_id == mesh.id()
+      and _geometry_state == mesh.geometry().state()
+      and _topology_state == mesh.topology().state())
+  {
+    return;
+  }
+
+  if (_method == "local")
+  {
+    // Factorize element mass matrices
+    if (!_local_solver)
+    {
+      _local_solver = std::make_shared<LocalSolver>(_a);
+      _local_solver->set_factorization_reuse(true);
+    }
+    _local_solver->clear_factorization();
+    _local_solver->factorize();
+  }
+  else
+  {
+    // Assemble mass matrix
+    GenericLinearAlgebraFactory& factory = DefaultFactory::factory();
+    _A = factory.create_matrix(mesh.mpi_comm());
+    assemble(*_A, *_a);
+
+    if (_method == "lu")
+    {
+      // Create solver, the factorization is computed in the first
+      // solve and kept as long as the matrix is unchanged
+      _solver = std::make_shared<LUSolver>(mesh.mpi_comm(), "default");
+      _solver->set_operator(_A);
+    }
+    else
+    {
+      // Compute inverse row sums
+      std::shared_ptr<GenericVector> ones
+        = factory.create_vector(mesh.mpi_comm());
+      _A->init_vector(*ones, 1);
+      *ones = 1.0;
+      _inverse_diagonal = factory.create_vector(mesh.mpi_comm());
+      _A->init_vector(*_inverse_diagonal, 0);
+      _A->mult(*ones, *_inverse_diagonal);
+
+      std::vector<double> values;
+      _inverse_diagonal->get_local(values);
+      for (std::size_t i = 0; i < values.size(); ++i)
+      {
+        if (values[i] == 0.0)
+        {
+          dolfin_error("Projector.cpp",
+                       "compute lumped mass matrix",
+                       "Row sum %d of mass matrix is zero", i);
+        }
+        values[i] = 1.0/values[i];
+      }
+      _inverse_diagonal->set_local(values);
+      _inverse_diagonal->apply("insert");
+    }
+  }
+
+  _mesh_id = mesh.id();
+  _geometry_state = mesh.geometry().state();
+  _topology_state = mesh.topology().state();
+  ++_num_assemblies;
+}
+//-----------------------------------------------------------------------------
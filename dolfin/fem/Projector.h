@@ -0,0 +1,115 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __PROJECTOR_H
+#define __PROJECTOR_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Form;
+  class Function;
+  class GenericLinearSolver;
+  class GenericMatrix;
+  class GenericVector;
+  class LocalSolver;
+
+  /// This class computes L2 projections onto a fixed function space,
+  /// keeping the mass matrix and its factorization between
+  /// projections so that each projection costs the assembly of the
+  /// right-hand side and a solve with the existing factorization.
+  ///
+  /// The projector is created from the mass form a(w, u) = (w, u)
+  /// of the target space. Supported methods are
+  ///
+  ///     "lu"      Factorize the mass matrix (exact projection)
+  ///     "lumped"  Divide by the row sums of the mass matrix
+  ///               (approximate, no solve)
+  ///     "local"   Solve cell by cell with factorized element mass
+  ///               matrices (exact for discontinuous spaces)
+  ///
+  /// The mass matrix is assembled again if the mesh has changed.
+
+  class Projector
+  {
+  public:
+
+    /// Create projector
+    ///
+    /// @param    a (_Form_)
+    ///         The mass form of the target space.
+    /// @param    method (std::string)
+    ///         The method ("lu", "lumped" or "local").
+    Projector(std::shared_ptr<const Form> a, std::string method="lu");
+
+    /// Destructor
+    ~Projector();
+
+    /// Project onto target space
+    ///
+    /// @param[out] u (_Function_)
+    ///         The projection (in the target space).
+    /// @param[in]  L (_Form_)
+    ///         The right-hand side L(w) = (w, v) of the function v
+    ///         to project.
+    void project(Function& u, const Form& L);
+
+    /// Return method
+    std::string method() const
+    { return _method; }
+
+    /// Return number of times the mass matrix has been assembled
+    std::size_t num_assemblies() const
+    { return _num_assemblies; }
+
+  private:
+
+    // Assemble and factorize mass matrix if mesh has changed
+    void init();
+
+    // Mass form
+    std::shared_ptr<const Form> _a;
+
+    // Method
+    std::string _method;
+
+    // Mass matrix and its factorization ("lu"), inverse row sums
+    // ("lumped") or cell-wise solver ("local")
+    std::shared_ptr<GenericMatrix> _A;
+    std::shared_ptr<GenericLinearSolver> _solver;
+    std::shared_ptr<GenericVector> _inverse_diagonal;
+    std::shared_ptr<LocalSolver> _local_solver;
+
+    // Right-hand side vector
+    std::shared_ptr<GenericVector> _b;
+
+    // Mesh state of the mass matrix
+    std::size_t _mesh_id, _geometry_state, _topology_state;
+
+    // Number of assemblies of the mass matrix
+    std::size_t _num_assemblies;
+
+  };
+
+}
+
+#endif
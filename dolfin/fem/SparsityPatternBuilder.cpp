@@ -19,12 +19,16 @@
 // Modified by Anders Logg 2008-2014
 
 #include <algorithm>
+#include <numeric>
 
 #include <dolfin/common/ArrayView.h>
 #include <dolfin/common/MPI.h>
+#include <dolfin/common/SubSystemsManager.h>
+#include <dolfin/la/IndexMap.h>
 #include <dolfin/la/SparsityPattern.h>
 #include <dolfin/log/log.h>
 #include <dolfin/log/Progress.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Mesh.h>
@@ -86,6 +90,18 @@ SparsityPatternBuilder::build(SparsityPattern& sparsity_pattern,
   dofmaps[sparsity_pattern.primary_dim()]->tabulate_global_dofs(global_dofs0);
   sparsity_pattern.insert_full_rows_local(global_dofs0);
 
+  // Build compressed pattern directly if only cells contribute
+  // (exterior facet dofs are included in the cell dofs). Patterns of
+  // blocks are built by insertion.
+  if (init && cells && !interior_facets && !vertices
+      && sparsity_pattern.block_size() == 1)
+  {
+    build_cells_csr(sparsity_pattern, mesh, dofmaps, global_dofs0, diagonal);
+    if (finalize)
+      sparsity_pattern.apply();
+    return;
+  }
+
   // FIXME: We iterate over the entire mesh even if the function space
   // is restricted. This works out fine since the local dofmap
   // returned on each cell will be an empty vector, but we might think
@@ -268,6 +284,295 @@ SparsityPatternBuilder::build(SparsityPattern& sparsity_pattern,
     sparsity_pattern.apply();
 }
 //-----------------------------------------------------------------------------
+void SparsityPatternBuilder::estimate_num_nonzeros(
+  std::vector<std::size_t>& num_nonzeros_diagonal,
+  std::vector<std::size_t>& num_nonzeros_off_diagonal,
+  const Mesh& mesh,
+  const std::vector<const GenericDofMap*> dofmaps,
+  bool interior_facets,
+  bool diagonal)
+{
+  dolfin_assert(dofmaps.size() == 2);
+  const GenericDofMap& dofmap0 = *dofmaps[0];
+  const GenericDofMap& dofmap1 = *dofmaps[1];
+  const IndexMap& index_map0 = *dofmap0.index_map();
+  const IndexMap& index_map1 = *dofmap1.index_map();
+
+  const std::size_t num_rows = index_map0.size(IndexMap::MapSize::OWNED);
+  const std::size_t num_all_rows = index_map0.size(IndexMap::MapSize::ALL);
+  const std::size_t num_cols = index_map1.size(IndexMap::MapSize::OWNED);
+  const std::size_t N1 = index_map1.size(IndexMap::MapSize::GLOBAL);
+  const std::size_t offset0 = index_map0.local_range().first;
+
+  // Count owned (diagonal block) and unowned (off-diagonal block)
+  // column dofs of a cell
+  std::vector<std::size_t> cell_cols(2);
+  std::vector<std::size_t> diagonal_count(num_all_rows, 0);
+  std::vector<std::size_t> off_diagonal_count(num_all_rows, 0);
+  const std::size_t D = mesh.topology().dim();
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    auto dofs1 = dofmap1.cell_dofs(cell->index());
+    cell_cols[0] = 0;
+    cell_cols[1] = 0;
+    for (Eigen::Index j = 0; j < dofs1.size(); ++j)
+      ++cell_cols[(std::size_t) dofs1[j] < num_cols ? 0 : 1];
+
+    auto dofs0 = dofmap0.cell_dofs(cell->index());
+    for (Eigen::Index i = 0; i < dofs0.size(); ++i)
+    {
+      diagonal_count[dofs0[i]] += cell_cols[0];
+      off_diagonal_count[dofs0[i]] += cell_cols[1];
+    }
+  }
+
+  // Add couplings between the two cells of interior facets
+  if (interior_facets)
+  {
+    mesh.init(D - 1);
+    mesh.init(D - 1, D);
+    for (FacetIterator facet(mesh); !facet.end(); ++facet)
+    {
+      if (facet->num_entities(D) != 2)
+        continue;
+      for (std::size_t k = 0; k < 2; ++k)
+      {
+        auto dofs0 = dofmap0.cell_dofs(facet->entities(D)[k]);
+        auto dofs1 = dofmap1.cell_dofs(facet->entities(D)[1 - k]);
+        cell_cols[0] = 0;
+        cell_cols[1] = 0;
+        for (Eigen::Index j = 0; j < dofs1.size(); ++j)
+          ++cell_cols[(std::size_t) dofs1[j] < num_cols ? 0 : 1];
+        for (Eigen::Index i = 0; i < dofs0.size(); ++i)
+        {
+          diagonal_count[dofs0[i]] += cell_cols[0];
+          off_diagonal_count[dofs0[i]] += cell_cols[1];
+        }
+      }
+    }
+  }
+
+  // Send counts of unowned rows to their owners. The owner does not
+  // know the split into diagonal and off-diagonal block, so the
+  // total is added to both.
+  const MPI_Comm comm = mesh.mpi_comm();
+  const std::size_t num_processes = MPI::size(comm);
+  if (num_processes > 1)
+  {
+    const int bs0 = index_map0.block_size();
+    std::vector<std::vector<std::size_t>> send_counts(num_processes);
+    for (std::size_t i = num_rows; i < num_all_rows; ++i)
+    {
+      const std::size_t count = diagonal_count[i] + off_diagonal_count[i];
+      if (count == 0)
+        continue;
+      const std::size_t I = index_map0.local_to_global(i);
+      const int p = index_map0.global_index_owner(I/bs0);
+      send_counts[p].push_back(I);
+      send_counts[p].push_back(count);
+    }
+
+    std::vector<std::vector<std::size_t>> recv_counts(num_processes);
+    MPI::all_to_all(comm, send_counts, recv_counts);
+    for (std::size_t p = 0; p < num_processes; ++p)
+    {
+      for (std::size_t k = 0; k < recv_counts[p].size(); k += 2)
+      {
+        const std::size_t i = recv_counts[p][k] - offset0;
+        dolfin_assert(i < num_rows);
+        diagonal_count[i] += recv_counts[p][k + 1];
+        off_diagonal_count[i] += recv_counts[p][k + 1];
+      }
+    }
+  }
+
+  // Rows of globally supported dofs (reals) are full
+  std::vector<std::size_t> global_dofs;
+  dofmap0.tabulate_global_dofs(global_dofs);
+  for (auto row : global_dofs)
+  {
+    if (row < num_rows)
+    {
+      diagonal_count[row] = num_cols;
+      off_diagonal_count[row] = N1 - num_cols;
+    }
+  }
+
+  // Add diagonal entry and limit by block dimensions
+  num_nonzeros_diagonal.resize(num_rows);
+  num_nonzeros_off_diagonal.resize(num_rows);
+  for (std::size_t i = 0; i < num_rows; ++i)
+  {
+    if (diagonal && offset0 + i < N1)
+      ++diagonal_count[i];
+    num_nonzeros_diagonal[i] = std::min(diagonal_count[i], num_cols);
+    num_nonzeros_off_diagonal[i] = std::min(off_diagonal_count[i],
+                                            N1 - num_cols);
+  }
+}
+//-----------------------------------------------------------------------------
+void SparsityPatternBuilder::build_cells_csr(
+  SparsityPattern& sparsity_pattern,
+  const Mesh& mesh,
+  const std::vector<const GenericDofMap*>& dofmaps,
+  const std::vector<std::size_t>& full_rows,
+  bool diagonal)
+{
+  dolfin_assert(dofmaps.size() == 2);
+  const std::size_t primary_dim = sparsity_pattern.primary_dim();
+  const std::size_t primary_codim = primary_dim == 0 ? 1 : 0;
+  const GenericDofMap& dofmap0 = *dofmaps[primary_dim];
+  const GenericDofMap& dofmap1 = *dofmaps[primary_codim];
+  const IndexMap& index_map0 = *dofmap0.index_map();
+  const IndexMap& index_map1 = *dofmap1.index_map();
+
+  const std::size_t num_rows = index_map0.size(IndexMap::MapSize::OWNED);
+  const std::size_t offset0 = index_map0.local_range().first;
+  const std::pair<std::size_t, std::size_t> range1
+    = index_map1.local_range();
+  const std::size_t N1 = index_map1.size(IndexMap::MapSize::GLOBAL);
+  const bool has_off_diagonal = N1 > range1.second - range1.first;
+
+  // Global index of each local column
+  std::vector<std::size_t>
+    global_columns(index_map1.size(IndexMap::MapSize::ALL));
+  for (std::size_t j = 0; j < global_columns.size(); ++j)
+    global_columns[j] = index_map1.local_to_global(j);
+
+  // Full rows are stored separately by the sparsity pattern
+  std::vector<bool> is_full_row(num_rows, false);
+  for (auto row : full_rows)
+  {
+    if (row < num_rows)
+      is_full_row[row] = true;
+  }
+
+  // Count the cells of each local row. Entries in non-local rows are
+  // inserted as usual (to be communicated by apply()).
+  std::vector<std::size_t> row_offsets(num_rows + 1, 0);
+  std::vector<dolfin::la_index> non_local_rows;
+  std::vector<ArrayView<const dolfin::la_index>> dofs(2);
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    auto dofs0 = dofmap0.cell_dofs(cell->index());
+    non_local_rows.clear();
+    for (Eigen::Index i = 0; i < dofs0.size(); ++i)
+    {
+      const std::size_t row = dofs0[i];
+      if (row >= num_rows)
+        non_local_rows.push_back(dofs0[i]);
+      else if (!is_full_row[row])
+        ++row_offsets[row + 1];
+    }
+
+    if (!non_local_rows.empty())
+    {
+      auto dofs1 = dofmap1.cell_dofs(cell->index());
+      dofs[primary_dim].set(non_local_rows);
+      dofs[primary_codim].set(dofs1.size(), dofs1.data());
+      sparsity_pattern.insert_local(dofs);
+    }
+  }
+  std::partial_sum(row_offsets.begin(), row_offsets.end(),
+                   row_offsets.begin());
+
+  // Build list of cells for each local row
+  std::vector<std::uint32_t> row_cells(row_offsets.back());
+  {
+    std::vector<std::size_t> pos(row_offsets.begin(), row_offsets.end() - 1);
+    for (CellIterator cell(mesh); !cell.end(); ++cell)
+    {
+      auto dofs0 = dofmap0.cell_dofs(cell->index());
+      for (Eigen::Index i = 0; i < dofs0.size(); ++i)
+      {
+        const std::size_t row = dofs0[i];
+        if (row < num_rows && !is_full_row[row])
+          row_cells[pos[row]++] = cell->index();
+      }
+    }
+  }
+
+  // Number of threads (rows are processed independently)
+  const int num_threads = SubSystemsManager::num_threads();
+
+  // Compress rows in two passes: count the (unique) columns of the
+  // diagonal and off-diagonal blocks of each row, then fill
+  std::vector<std::size_t> diagonal_offsets(num_rows + 1, 0);
+  std::vector<std::size_t> off_diagonal_offsets(has_off_diagonal
+                                                ? num_rows + 1 : 0, 0);
+  std::vector<std::size_t> diagonal_columns, off_diagonal_columns;
+  for (std::size_t pass = 0; pass < 2; ++pass)
+  {
+    if (pass == 1)
+    {
+      std::partial_sum(diagonal_offsets.begin(), diagonal_offsets.end(),
+                       diagonal_offsets.begin());
+      diagonal_columns.resize(diagonal_offsets.back());
+      std::partial_sum(off_diagonal_offsets.begin(),
+                       off_diagonal_offsets.end(),
+                       off_diagonal_offsets.begin());
+      if (has_off_diagonal)
+        off_diagonal_columns.resize(off_diagonal_offsets.back());
+    }
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+      std::vector<std::size_t> columns;
+      #pragma omp for schedule(guided, 256)
+      for (std::size_t row = 0; row < num_rows; ++row)
+      {
+        if (is_full_row[row])
+          continue;
+
+        // Collect sorted, unique columns of row
+        columns.clear();
+        for (std::size_t k = row_offsets[row]; k < row_offsets[row + 1]; ++k)
+        {
+          auto dofs1 = dofmap1.cell_dofs(row_cells[k]);
+          for (Eigen::Index j = 0; j < dofs1.size(); ++j)
+            columns.push_back(global_columns[dofs1[j]]);
+        }
+        if (diagonal && offset0 + row < N1)
+          columns.push_back(offset0 + row);
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()),
+                      columns.end());
+
+        // Split into diagonal block (columns in local range) and
+        // off-diagonal block
+        auto diag_begin = std::lower_bound(columns.begin(), columns.end(),
+                                           range1.first);
+        auto diag_end = std::lower_bound(diag_begin, columns.end(),
+                                         range1.second);
+        if (pass == 0)
+        {
+          diagonal_offsets[row + 1] = diag_end - diag_begin;
+          if (has_off_diagonal)
+          {
+            off_diagonal_offsets[row + 1]
+              = columns.size() - (diag_end - diag_begin);
+          }
+        }
+        else
+        {
+          std::copy(diag_begin, diag_end,
+                    diagonal_columns.begin() + diagonal_offsets[row]);
+          if (has_off_diagonal)
+          {
+            auto pos = std::copy(columns.begin(), diag_begin,
+                                 off_diagonal_columns.begin()
+                                 + off_diagonal_offsets[row]);
+            std::copy(diag_end, columns.end(), pos);
+          }
+        }
+      }
+    }
+  }
+
+  sparsity_pattern.set_csr(diagonal_offsets, diagonal_columns,
+                           off_diagonal_offsets, off_diagonal_columns);
+}
+//-----------------------------------------------------------------------------
 void SparsityPatternBuilder::build_multimesh_sparsity_pattern(
   SparsityPattern& sparsity_pattern,
   const MultiMeshForm& form)
@@ -55,6 +55,22 @@ namespace dolfin
                       bool init=true,
                       bool finalize=true);
 
+    /// Compute upper bounds for the number of nonzeros in the
+    /// diagonal and off-diagonal blocks of each owned row of the
+    /// matrix of a bilinear form, without building the sparsity
+    /// pattern. The entries of a row are bounded by the sum of the
+    /// column dofs of the cells (and interior facet macro cells)
+    /// containing the row dof, so no column sets are stored.
+    /// Contributions to rows owned by other processes are
+    /// communicated to the owners.
+    static void
+      estimate_num_nonzeros(std::vector<std::size_t>& num_nonzeros_diagonal,
+                            std::vector<std::size_t>& num_nonzeros_off_diagonal,
+                            const Mesh& mesh,
+                            const std::vector<const GenericDofMap*> dofmaps,
+                            bool interior_facets,
+                            bool diagonal);
+
     /// Build sparsity pattern for assembly of given multimesh form
     static void
       build_multimesh_sparsity_pattern(SparsityPattern& sparsity_pattern,
@@ -62,6 +78,16 @@ namespace dolfin
 
   private:
 
+    // Build compressed sparsity pattern for cell integrals. Row
+    // lengths are counted before the rows are filled, so no per-row
+    // containers are allocated. Rows are processed concurrently if
+    // the global parameter "num_threads" is nonzero.
+    static void build_cells_csr(SparsityPattern& sparsity_pattern,
+                                const Mesh& mesh,
+                                const std::vector<const GenericDofMap*>& dofmaps,
+                                const std::vector<std::size_t>& full_rows,
+                                bool diagonal);
+
     // Build sparsity pattern for interface part of multimesh form
     static void _build_multimesh_sparsity_pattern_interface
       (SparsityPattern& sparsity_pattern,
@@ -0,0 +1,281 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <memory>
+#include <vector>
+#include <Eigen/Dense>
+
+#include <dolfin/common/Timer.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/GenericLinearAlgebraFactory.h>
+#include <dolfin/la/GenericMatrix.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/la/IndexMap.h>
+#include <dolfin/la/SparsityPattern.h>
+#include <dolfin/la/TensorLayout.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include "FiniteElement.h"
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "LocalAssembler.h"
+#include "SparsityPatternBuilder.h"
+#include "UFC.h"
+#include "StaticCondensation.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+StaticCondensation::StaticCondensation(std::shared_ptr<const Form> a,
+                                       std::shared_ptr<const Form> L,
+                                       std::size_t interior_space)
+  : _a(a), _L(L)
+{
+  dolfin_assert(a);
+  dolfin_assert(a->rank() == 2);
+  dolfin_assert(L);
+  dolfin_assert(L->rank() == 1);
+
+  // Check that the forms are defined on the same space
+  const FunctionSpace& W = *a->function_space(0);
+  if (!(W == *a->function_space(1)) or !(W == *L->function_space(0)))
+  {
+    dolfin_error("StaticCondensation.cpp",
+                 "create static condensation",
+                 "Bilinear and linear forms must be defined on the same function space");
+  }
+
+  // Check that the space has an interior and a trace sub space
+  dolfin_assert(W.element());
+  const FiniteElement& element = *W.element();
+  if (element.num_sub_elements() != 2 or interior_space > 1)
+  {
+    dolfin_error("StaticCondensation.cpp",
+                 "create static condensation",
+                 "Function space must have two sub spaces (interior and trace), "
+                 "found %d", element.num_sub_elements());
+  }
+
+  // Dofs of the sub spaces are consecutive in the cell dofs
+  const std::size_t trace_space = 1 - interior_space;
+  const std::size_t dim0 = element.create_sub_element(0)->space_dimension();
+  const std::size_t dim1 = element.create_sub_element(1)->space_dimension();
+  _offset_interior = (interior_space == 0) ? 0 : dim0;
+  _dim_interior = (interior_space == 0) ? dim0 : dim1;
+  _offset_trace = (trace_space == 0) ? 0 : dim0;
+  _dim_trace = (trace_space == 0) ? dim0 : dim1;
+
+  // Create space of the condensed system
+  _trace_space = W.sub(trace_space)->collapse();
+}
+//-----------------------------------------------------------------------------
+StaticCondensation::~StaticCondensation()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const FunctionSpace> StaticCondensation::trace_space() const
+{
+  return _trace_space;
+}
+//-----------------------------------------------------------------------------
+void StaticCondensation::assemble(GenericMatrix& S, GenericVector& g)
+{
+  Timer timer("Assemble condensed system");
+
+  // Extract the mesh
+  dolfin_assert(_a->mesh());
+  const Mesh& mesh = *_a->mesh();
+  const std::size_t D = mesh.topology().dim();
+  if (_a->ufc_form()->has_exterior_facet_integrals()
+      or _a->ufc_form()->has_interior_facet_integrals()
+      or _L->ufc_form()->has_exterior_facet_integrals()
+      or _L->ufc_form()->has_interior_facet_integrals())
+  {
+    mesh.init(D - 1);
+    mesh.init(D - 1, D);
+  }
+
+  // Initialise global tensors
+  init_tensor(S);
+  init_tensor(g);
+
+  // Create UFC objects
+  UFC ufc_a(*_a);
+  UFC ufc_L(*_L);
+
+  // Extract dofmap of condensed system
+  dolfin_assert(_trace_space->dofmap());
+  const GenericDofMap& dofmap_T = *_trace_space->dofmap();
+
+  // Allocate storage for back-substitution
+  const std::size_t nI = _dim_interior;
+  const std::size_t nT = _dim_trace;
+  const std::size_t n = nI + nT;
+  _X.resize(mesh.num_cells()*nI*nT);
+  _y.resize(mesh.num_cells()*nI);
+
+  // Cell tensors
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                        Eigen::RowMajor> Matrix;
+  Matrix A_e(n, n), b_e(n, 1), S_e(nT, nT);
+  Eigen::VectorXd g_e(nT);
+  Eigen::PartialPivLU<Matrix> lu;
+
+  // Loop over cells and condense cell systems
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    // Assemble cell system
+    cell->get_coordinate_dofs(coordinate_dofs);
+    LocalAssembler::assemble(A_e, ufc_a, coordinate_dofs, ufc_cell, *cell,
+                             _a->cell_domains().get(),
+                             _a->exterior_facet_domains().get(),
+                             _a->interior_facet_domains().get());
+    LocalAssembler::assemble(b_e, ufc_L, coordinate_dofs, ufc_cell, *cell,
+                             _L->cell_domains().get(),
+                             _L->exterior_facet_domains().get(),
+                             _L->interior_facet_domains().get());
+
+    // Compute A_II^{-1} A_IT and A_II^{-1} b_I
+    const std::size_t c = cell->index();
+    Eigen::Map<Matrix> X(_X.data() + c*nI*nT, nI, nT);
+    Eigen::Map<Eigen::VectorXd> y(_y.data() + c*nI, nI);
+    lu.compute(A_e.block(_offset_interior, _offset_interior, nI, nI));
+    X = lu.solve(A_e.block(_offset_interior, _offset_trace, nI, nT));
+    y = lu.solve(b_e.block(_offset_interior, 0, nI, 1));
+
+    // Compute Schur complement and condensed RHS
+    S_e = A_e.block(_offset_trace, _offset_trace, nT, nT)
+      - A_e.block(_offset_trace, _offset_interior, nT, nI)*X;
+    g_e = b_e.block(_offset_trace, 0, nT, 1)
+      - A_e.block(_offset_trace, _offset_interior, nT, nI)*y;
+
+    // Add to global system
+    auto dofs = dofmap_T.cell_dofs(c);
+    S.add_local(S_e.data(), nT, dofs.data(), nT, dofs.data());
+    g.add_local(g_e.data(), nT, dofs.data());
+  }
+
+  // Finalise assembly
+  S.apply("add");
+  g.apply("add");
+}
+//-----------------------------------------------------------------------------
+void StaticCondensation::backsubstitute(Function& u,
+                                        const GenericVector& x) const
+{
+  if (_y.empty())
+  {
+    dolfin_error("StaticCondensation.cpp",
+                 "back-substitute condensed solution",
+                 "Condensed system has not been assembled");
+  }
+
+  // Extract the mesh and dofmaps
+  dolfin_assert(_a->mesh());
+  const Mesh& mesh = *_a->mesh();
+  dolfin_assert(_a->function_space(0)->dofmap());
+  const GenericDofMap& dofmap = *_a->function_space(0)->dofmap();
+  const GenericDofMap& dofmap_T = *_trace_space->dofmap();
+
+  // Check solution vector
+  dolfin_assert(u.vector());
+  GenericVector& u_vector = *u.vector();
+  if (u_vector.size() != dofmap.global_dimension())
+  {
+    dolfin_error("StaticCondensation.cpp",
+                 "back-substitute condensed solution",
+                 "Function does not match function space of forms");
+  }
+
+  // Copy condensed solution into ghosted vector
+  Function x_T(_trace_space);
+  *x_T.vector() = x;
+
+  // Loop over cells and compute x_I = A_II^{-1} (b_I - A_IT x_T)
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                        Eigen::RowMajor> Matrix;
+  const std::size_t nI = _dim_interior;
+  const std::size_t nT = _dim_trace;
+  Eigen::VectorXd u_e(nI + nT);
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    Eigen::Map<const Matrix> X(_X.data() + c*nI*nT, nI, nT);
+    Eigen::Map<const Eigen::VectorXd> y(_y.data() + c*nI, nI);
+
+    auto dofs_T = dofmap_T.cell_dofs(c);
+    x_T.vector()->get_local(u_e.data() + _offset_trace, nT, dofs_T.data());
+    u_e.segment(_offset_interior, nI) = y - X*u_e.segment(_offset_trace, nT);
+
+    auto dofs = dofmap.cell_dofs(c);
+    u_vector.set_local(u_e.data(), nI + nT, dofs.data());
+  }
+
+  // Finalise vector
+  u_vector.apply("insert");
+}
+//-----------------------------------------------------------------------------
+void StaticCondensation::init_tensor(GenericTensor& A) const
+{
+  dolfin_assert(_trace_space->dofmap());
+  const GenericDofMap& dofmap = *_trace_space->dofmap();
+  const std::size_t rank = A.rank();
+
+  if (!A.empty())
+  {
+    // Check that dimensions match
+    for (std::size_t i = 0; i < rank; ++i)
+    {
+      if (A.size(i) != dofmap.global_dimension())
+      {
+        dolfin_error("StaticCondensation.cpp",
+                     "assemble condensed system",
+                     "Dim %d of tensor does not match trace space", i);
+      }
+    }
+    A.zero();
+    return;
+  }
+
+  // Create layout for initialising tensor
+  dolfin_assert(_trace_space->mesh());
+  const Mesh& mesh = *_trace_space->mesh();
+  std::shared_ptr<TensorLayout> tensor_layout
+    = A.factory().create_layout(mesh.mpi_comm(), rank);
+  dolfin_assert(tensor_layout);
+  std::vector<std::shared_ptr<const IndexMap>>
+    index_maps(rank, dofmap.index_map());
+  tensor_layout->init(index_maps, TensorLayout::Ghosts::UNGHOSTED);
+
+  // Build sparsity pattern of cell couplings
+  if (tensor_layout->sparsity_pattern())
+  {
+    std::vector<const GenericDofMap*> dofmaps(rank, &dofmap);
+    SparsityPatternBuilder::build(*tensor_layout->sparsity_pattern(),
+                                  mesh, dofmaps, true, false, false, false,
+                                  false);
+  }
+
+  // Initialize tensor
+  A.init(*tensor_layout);
+  A.zero();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __STATIC_CONDENSATION_H
+#define __STATIC_CONDENSATION_H
+
+#include <memory>
+#include <vector>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Form;
+  class Function;
+  class FunctionSpace;
+  class GenericMatrix;
+  class GenericTensor;
+  class GenericVector;
+
+  /// This class assembles a statically condensed system for forms
+  /// on a mixed function space with two sub spaces, one of which
+  /// holds interior (cell-local) dofs and the other trace dofs,
+  /// e.g. hybridised mixed or HDG methods. On each cell the element
+  /// system
+  ///
+  ///    [A_II  A_IT] [x_I]   [b_I]
+  ///    [A_TI  A_TT] [x_T] = [b_T]
+  ///
+  /// is assembled with LocalAssembler, the interior block A_II is
+  /// factorised and only the Schur complement
+  /// S = A_TT - A_TI A_II^{-1} A_IT and the right-hand side
+  /// g = b_T - A_TI A_II^{-1} b_I are added to the global system on
+  /// the (collapsed) trace space. After solving S x_T = g, the
+  /// interior dofs are recovered cell-wise by back-substitution.
+  ///
+  /// As for LocalSolver, the interior dofs must not couple across
+  /// cells. Dirichlet conditions are applied to the condensed system
+  /// with DirichletBCs defined on trace_space().
+
+  class StaticCondensation
+  {
+  public:
+
+    /// Create static condensation for bilinear and linear forms on
+    /// a mixed function space
+    ///
+    /// @param[in] a (Form)
+    ///         The bilinear form.
+    /// @param[in] L (Form)
+    ///         The linear form.
+    /// @param[in] interior_space (std::size_t)
+    ///         Index of the sub space holding the interior dofs.
+    StaticCondensation(std::shared_ptr<const Form> a,
+                       std::shared_ptr<const Form> L,
+                       std::size_t interior_space=0);
+
+    /// Destructor
+    ~StaticCondensation();
+
+    /// Return the (collapsed) function space of the condensed
+    /// system
+    std::shared_ptr<const FunctionSpace> trace_space() const;
+
+    /// Assemble the condensed system S x_T = g. The factorizations
+    /// needed for back-substitution are stored.
+    ///
+    /// @param[out] S (GenericMatrix)
+    ///         The condensed matrix.
+    /// @param[out] g (GenericVector)
+    ///         The condensed right-hand side.
+    void assemble(GenericMatrix& S, GenericVector& g);
+
+    /// Recover the full solution from the solution of the condensed
+    /// system
+    ///
+    /// @param[out] u (Function)
+    ///         The solution on the mixed space.
+    /// @param[in] x (GenericVector)
+    ///         The solution of the condensed system.
+    void backsubstitute(Function& u, const GenericVector& x) const;
+
+  private:
+
+    // Initialise tensor with layout of trace space
+    void init_tensor(GenericTensor& A) const;
+
+    // Bilinear and linear forms
+    std::shared_ptr<const Form> _a, _L;
+
+    // Trace space of the condensed system
+    std::shared_ptr<const FunctionSpace> _trace_space;
+
+    // Offsets and dimensions of interior and trace dofs in cell dofs
+    std::size_t _offset_interior, _offset_trace, _dim_interior, _dim_trace;
+
+    // A_II^{-1} A_IT and A_II^{-1} b_I for all cells, stored
+    // row-major and contiguously
+    std::vector<double> _X, _y;
+
+  };
+
+}
+
+#endif
@@ -22,13 +22,18 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
 #include <Eigen/Dense>
 
 #include <dolfin/common/ArrayView.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/types.h>
 #include <dolfin/function/GenericFunction.h>
 #include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/BlockBatch.h>
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/log/log.h>
@@ -36,9 +41,12 @@
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Facet.h>
+#include <dolfin/mesh/MeshColoring.h>
 #include <dolfin/mesh/MeshFunction.h>
+#include <dolfin/mesh/MeshInteriorFacets.h>
 #include <dolfin/mesh/SubDomain.h>
 #include "AssemblerBase.h"
+#include "AssemblyPlan.h"
 #include "DirichletBC.h"
 #include "FiniteElement.h"
 #include "Form.h"
@@ -182,8 +190,17 @@ void SystemAssembler::assemble(GenericMatrix* A, GenericVector* b,
                  "expected forms (a, L) to share a FunctionSpace");
   }
 
-  // Create data structures for local assembly data
-  UFC A_ufc(*_a), b_ufc(*_l);
+  // Start profile of this call
+  _profile.reset(collect_profile);
+
+  // Create data structures for local assembly data and gather
+  // Function coefficient values once
+  std::shared_ptr<UFC> A_ufc_data = _a->ufc_data();
+  std::shared_ptr<UFC> b_ufc_data = _l->ufc_data();
+  UFC& A_ufc = *A_ufc_data;
+  UFC& b_ufc = *b_ufc_data;
+  A_ufc.prefetch_coefficients();
+  b_ufc.prefetch_coefficients();
 
   // Raise error for Point integrals
   if (A_ufc.form.has_vertex_integrals() || b_ufc.form.has_vertex_integrals())
@@ -279,25 +296,68 @@ void SystemAssembler::assemble(GenericMatrix* A, GenericVector* b,
       && !ufc[1]->form.has_interior_facet_integrals())
   {
     // Assemble cell-wise (no interior facet integrals)
-    cell_wise_assembly(tensors, ufc, data, boundary_values,
-                       cell_domains, exterior_facet_domains);
+    const std::size_t threads = assembly_threads();
+    if (threads > 0)
+    {
+      // Threaded assembly takes precedence over the assembly plan
+      if (A && use_assembly_plan)
+        warn_ignored_by_threads("use_assembly_plan");
+
+      cell_wise_assembly_threaded(tensors, ufc, boundary_values,
+                                  cell_domains, exterior_facet_domains,
+                                  coloring_type, threads);
+    }
+    else
+    {
+      // Add cell tensors directly to matrix values if requested
+      AssemblyPlan* plan = NULL;
+      if (A && use_assembly_plan)
+      {
+        if (!_assembly_plan)
+          _assembly_plan = std::make_shared<AssemblyPlan>();
+        if (_assembly_plan->begin(*A, *_a))
+          plan = _assembly_plan.get();
+      }
+
+      cell_wise_assembly(tensors, ufc, data, boundary_values,
+                         cell_domains, exterior_facet_domains, plan,
+                         _profile);
+
+      if (plan)
+        plan->end(*A);
+    }
   }
   else
   {
     // Assemble facet-wise (including cell assembly)
-    facet_wise_assembly(tensors, ufc, data, boundary_values,
-                        cell_domains, exterior_facet_domains,
-                        interior_facet_domains);
+    const std::size_t threads = assembly_threads();
+    if (threads > 0)
+    {
+      facet_wise_assembly_threaded(tensors, ufc, boundary_values,
+                                   cell_domains, exterior_facet_domains,
+                                   interior_facet_domains, coloring_type,
+                                   threads);
+    }
+    else
+    {
+      facet_wise_assembly(tensors, ufc, data, boundary_values,
+                          cell_domains, exterior_facet_domains,
+                          interior_facet_domains, _profile);
+    }
   }
 
   // Finalise assembly
   if (finalize_tensor)
   {
+    _profile.mark();
     if (A)
       A->apply("add");
     if (b)
       b->apply("add");
+    _profile.lap(AssemblyProfile::apply);
   }
+
+  SubSystemsManager::mark_startup_phase("first assembly");
 }
 //-----------------------------------------------------------------------------
 void SystemAssembler::cell_wise_assembly(
@@ -306,7 +366,9 @@ void SystemAssembler::cell_wise_assembly(
   Scratch& data,
   const std::vector<DirichletBC::Map>& boundary_values,
   std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
-  std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains)
+  std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
+  AssemblyPlan* plan,
+  AssemblyProfile& profile)
 {
   // Extract mesh
   dolfin_assert(ufc[0]->dolfin_form.mesh());
@@ -349,6 +411,14 @@ void SystemAssembler::cell_wise_assembly(
   bool use_exterior_facet_domains
     = exterior_facet_domains && !exterior_facet_domains->empty();
 
+  // Cell tensors are added to the global tensors in batches
+  std::array<std::shared_ptr<BlockBatch>, 2> blocks;
+  for (std::size_t form = 0; form < 2; ++form)
+  {
+    if (tensors[form])
+      blocks[form] = std::make_shared<BlockBatch>(*tensors[form]);
+  }
+
   // Iterate over all cells
   ufc::cell ufc_cell;
   std::vector<double> coordinate_dofs;
@@ -357,6 +427,7 @@ void SystemAssembler::cell_wise_assembly(
   {
     // Check that cell is not a ghost
     dolfin_assert(!cell->is_ghost());
+    profile.begin(AssemblyProfile::cells);
 
     // Get cell vertex coordinates
     cell->get_coordinate_dofs(coordinate_dofs);
@@ -408,6 +479,7 @@ void SystemAssembler::cell_wise_assembly(
         // Update to current cell
         ufc[form]->update(*cell, coordinate_dofs, ufc_cell,
                           cell_integrals[form]->enabled_coefficients());
+        profile.lap(AssemblyProfile::update);
 
         // Tabulate cell tensor
         cell_integrals[form]->tabulate_tensor(ufc[form]->A.data(),
@@ -416,6 +488,7 @@ void SystemAssembler::cell_wise_assembly(
                                               ufc_cell.orientation);
         for (std::size_t i = 0; i < data.Ae[form].size(); ++i)
           data.Ae[form][i] += ufc[form]->A[i];
+        profile.lap(AssemblyProfile::tabulate_tensor);
       }
 
       // Compute exterior facet integral if present
@@ -462,6 +535,7 @@ void SystemAssembler::cell_wise_assembly(
             cell->get_cell_data(ufc_cell);
             ufc[form]->update(*cell, coordinate_dofs, ufc_cell,
                               exterior_facet_integrals[form]->enabled_coefficients());
+            profile.lap(AssemblyProfile::update);
 
             // Tabulate exterior facet tensor
             exterior_facet_integrals[form]->tabulate_tensor(ufc[form]->A.data(),
@@ -471,6 +545,7 @@ void SystemAssembler::cell_wise_assembly(
                                                             ufc_cell.orientation);
             for (std::size_t i = 0; i < data.Ae[form].size(); i++)
               data.Ae[form][i] += ufc[form]->A[i];
+            profile.lap(AssemblyProfile::tabulate_tensor);
           }
         }
       }
@@ -483,12 +558,581 @@ void SystemAssembler::cell_wise_assembly(
     // Add entries to global tensor
     for (std::size_t form = 0; form < 2; ++form)
     {
-      if (tensors[form])
-        tensors[form]->add_local(data.Ae[form].data(), cell_dofs[form]);
+      if (form == 0 && plan)
+        plan->add(cell->index(), data.Ae[0].data());
+      else if (tensors[form])
+        blocks[form]->add_local(data.Ae[form].data(), cell_dofs[form]);
     }
+    profile.lap(AssemblyProfile::add_local);
 
     p++;
   }
+
+  profile.mark();
+  for (std::size_t form = 0; form < 2; ++form)
+  {
+    if (blocks[form])
+      blocks[form]->flush();
+  }
+  profile.lap(AssemblyProfile::add_local);
+}
+//-----------------------------------------------------------------------------
+void SystemAssembler::cell_wise_assembly_threaded(
+  std::array<GenericTensor*, 2>& tensors,
+  std::array<UFC*, 2>& ufc,
+  const std::vector<DirichletBC::Map>& boundary_values,
+  std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
+  std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
+  std::string coloring_type,
+  std::size_t num_threads,
+  const std::vector<double>* cell_coordinate_dofs)
+{
+  Timer timer("Assemble system (cell-wise, threaded)");
+
+  // Extract mesh
+  dolfin_assert(ufc[0]->dolfin_form.mesh());
+  const Mesh& mesh = *(ufc[0]->dolfin_form.mesh());
+  const std::size_t D = mesh.topology().dim();
+
+  // Initialize entities if using external facet integrals
+  dolfin_assert(mesh.ordered());
+  const bool has_exterior_facet_integrals
+    = ufc[0]->form.has_exterior_facet_integrals()
+    || ufc[1]->form.has_exterior_facet_integrals();
+  if (has_exterior_facet_integrals)
+  {
+    mesh.init(D - 1);
+    mesh.init(D - 1, D);
+  }
+
+  // Collect pointers to dof maps
+  std::array<std::vector<const GenericDofMap*>, 2> dofmaps;
+  for (std::size_t i = 0; i < 2; ++i)
+    dofmaps[0].push_back(ufc[0]->dolfin_form.function_space(i)->dofmap().get());
+  dofmaps[1].push_back(ufc[1]->dolfin_form.function_space(0)->dofmap().get());
+
+  // Check whether cell tensors of one color can be added
+  // concurrently, otherwise insertion is serialised
+  std::array<bool, 2> concurrent = {{false, false}};
+  for (std::size_t form = 0; form < 2; ++form)
+  {
+    if (tensors[form])
+    {
+      concurrent[form] = AssemblerBase::concurrent_insertion(*tensors[form],
+                                                             dofmaps[form]);
+    }
+  }
+
+  // Check whether integrals are domain-dependent
+  const bool use_cell_domains = cell_domains && !cell_domains->empty();
+  const bool use_exterior_facet_domains
+    = exterior_facet_domains && !exterior_facet_domains->empty();
+
+  // Color cells
+  const std::vector<std::size_t> coloring
+    = {D, MeshColoring::type_to_dim(coloring_type, mesh), D};
+  const std::vector<std::vector<std::size_t>>& cells_of_color
+    = AssemblerBase::colored_entities(mesh, coloring);
+
+  // An exception cannot leave the parallel region, so the first
+  // one is stored and rethrown after it
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  #pragma omp parallel num_threads(num_threads)
+  {
+    // Thread-local assembly data
+    UFC A_ufc(*ufc[0]), b_ufc(*ufc[1]);
+    std::array<UFC*, 2> _ufc = { {&A_ufc, &b_ufc} };
+    Scratch data(ufc[0]->dolfin_form, ufc[1]->dolfin_form);
+    std::array<std::vector<ArrayView<const dolfin::la_index>>, 2> cell_dofs
+      = { {std::vector<ArrayView<const dolfin::la_index>>(2),
+           std::vector<ArrayView<const dolfin::la_index>>(1)} };
+    std::array<const ufc::cell_integral*, 2> cell_integrals
+      = { {_ufc[0]->default_cell_integral.get(),
+           _ufc[1]->default_cell_integral.get()} };
+    std::array<const ufc::exterior_facet_integral*, 2> exterior_facet_integrals
+      = { { _ufc[0]->default_exterior_facet_integral.get(),
+            _ufc[1]->default_exterior_facet_integral.get()} };
+    ufc::cell ufc_cell;
+    std::vector<double> coordinate_dofs;
+
+    for (std::size_t color = 0; color < cells_of_color.size(); ++color)
+    {
+      const std::vector<std::size_t>& cells = cells_of_color[color];
+      const int num_cells = cells.size();
+
+      // Cells of one color are assembled concurrently (implicit
+      // barrier between colors)
+      #pragma omp for schedule(guided, 20)
+      for (int c = 0; c < num_cells; ++c)
+      {
+        // Skip remaining cells after an error
+        if (failed)
+          continue;
+
+        try
+        {
+          const Cell cell(mesh, cells[c]);
+
+          // Ghost cells are not assembled
+          if (cell.is_ghost())
+            continue;
+
+          // Get cell vertex coordinates and UFC cell data
+          if (cell_coordinate_dofs)
+          {
+            const std::size_t n
+              = cell_coordinate_dofs->size()/mesh.num_cells();
+            coordinate_dofs.assign(cell_coordinate_dofs->begin() + cell.index()*n,
+                                   cell_coordinate_dofs->begin()
+                                   + (cell.index() + 1)*n);
+          }
+          else
+            cell.get_coordinate_dofs(coordinate_dofs);
+          cell.get_cell_data(ufc_cell);
+
+          // Loop over lhs and then rhs contributions
+          for (std::size_t form = 0; form < 2; ++form)
+          {
+            // Don't need to assemble rhs if only system matrix is
+            // required
+            if (form == 1 && !tensors[form])
+              continue;
+
+            // Get rank (lhs=2, rhs=1)
+            const std::size_t rank = (form == 0) ? 2 : 1;
+
+            // Zero data
+            std::fill(data.Ae[form].begin(), data.Ae[form].end(), 0.0);
+
+            // Get cell integrals for sub domain (if any)
+            if (use_cell_domains)
+            {
+              const std::size_t domain = (*cell_domains)[cell];
+              cell_integrals[form] = _ufc[form]->get_cell_integral(domain);
+            }
+
+            // Get local-to-global dof maps for cell
+            for (std::size_t dim = 0; dim < rank; ++dim)
+            {
+              auto dmap = dofmaps[form][dim]->cell_dofs(cell.index());
+              cell_dofs[form][dim].set(dmap.size(), dmap.data());
+            }
+
+            // Compute cell tensor (if required)
+            bool tensor_required;
+            if (rank == 2)
+            {
+              tensor_required = cell_matrix_required(tensors[form],
+                                                     cell_integrals[form],
+                                                     boundary_values,
+                                                     cell_dofs[form][1]);
+            }
+            else
+              tensor_required = tensors[form] && cell_integrals[form];
+
+            if (tensor_required)
+            {
+              _ufc[form]->update(cell, coordinate_dofs, ufc_cell,
+                                 cell_integrals[form]->enabled_coefficients());
+              cell_integrals[form]->tabulate_tensor(_ufc[form]->A.data(),
+                                                    _ufc[form]->w(),
+                                                    coordinate_dofs.data(),
+                                                    ufc_cell.orientation);
+              for (std::size_t i = 0; i < data.Ae[form].size(); ++i)
+                data.Ae[form][i] += _ufc[form]->A[i];
+            }
+
+            // Compute exterior facet integral if present
+            if (has_exterior_facet_integrals)
+            {
+              for (FacetIterator facet(cell); !facet.end(); ++facet)
+              {
+                // Only consider exterior facets
+                if (!facet->exterior())
+                  continue;
+
+                // Get exterior facet integrals for sub domain (if any)
+                if (use_exterior_facet_domains)
+                {
+                  const std::size_t domain = (*exterior_facet_domains)[*facet];
+                  exterior_facet_integrals[form]
+                    = _ufc[form]->get_exterior_facet_integral(domain);
+                }
+
+                // Skip if there are no integrals
+                if (!exterior_facet_integrals[form])
+                  continue;
+
+                // Extract local facet index
+                const std::size_t local_facet = cell.index(*facet);
+
+                // Determine if tensor needs to be computed
+                bool facet_tensor_required;
+                if (rank == 2)
+                {
+                  facet_tensor_required
+                    = cell_matrix_required(tensors[form],
+                                           exterior_facet_integrals[form],
+                                           boundary_values,
+                                           cell_dofs[form][1]);
+                }
+                else
+                  facet_tensor_required = tensors[form];
+
+                // Add exterior facet tensor
+                if (facet_tensor_required)
+                {
+                  _ufc[form]->update(cell, coordinate_dofs, ufc_cell,
+                                     exterior_facet_integrals[form]->enabled_coefficients());
+                  exterior_facet_integrals[form]->tabulate_tensor(_ufc[form]->A.data(),
+                                                                  _ufc[form]->w(),
+                                                                  coordinate_dofs.data(),
+                                                                  local_facet,
+                                                                  ufc_cell.orientation);
+                  for (std::size_t i = 0; i < data.Ae[form].size(); i++)
+                    data.Ae[form][i] += _ufc[form]->A[i];
+                }
+              }
+            }
+          }
+
+          // Modify local matrix/element for Dirichlet boundary conditions
+          apply_bc(data.Ae[0].data(), data.Ae[1].data(), boundary_values,
+                   cell_dofs[0][0], cell_dofs[0][1]);
+
+          // Add entries to global tensor
+          for (std::size_t form = 0; form < 2; ++form)
+          {
+            if (!tensors[form])
+              continue;
+
+            if (concurrent[form])
+              tensors[form]->add_local(data.Ae[form].data(), cell_dofs[form]);
+            else
+            {
+              #pragma omp critical (dolfin_assembler_add_local)
+              tensors[form]->add_local(data.Ae[form].data(), cell_dofs[form]);
+            }
+          }
+        }
+        catch (...)
+        {
+          #pragma omp critical (dolfin_assembler_error)
+          if (!error)
+            error = std::current_exception();
+          failed = true;
+        }
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+//-----------------------------------------------------------------------------
+void SystemAssembler::facet_wise_assembly_threaded(
+  std::array<GenericTensor*, 2>& tensors,
+  std::array<UFC*, 2>& ufc,
+  const std::vector<DirichletBC::Map>& boundary_values,
+  std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
+  std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
+  std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains,
+  std::string coloring_type,
+  std::size_t num_threads)
+{
+  Timer timer("Assemble system (facet-wise, threaded)");
+
+  // Extract mesh
+  dolfin_assert(ufc[0]->dolfin_form.mesh());
+  const Mesh& mesh = *(ufc[0]->dolfin_form.mesh());
+
+  // Sanity check of ghost mode (proper check in AssemblerBase::check)
+  dolfin_assert(mesh.ghost_mode() == "shared_vertex"
+                || mesh.ghost_mode() == "shared_facet"
+                || MPI::size(mesh.mpi_comm()) == 1);
+
+  // Compute facets and facet - cell connectivity if not already
+  // computed
+  const std::size_t D = mesh.topology().dim();
+  dolfin_assert(mesh.ordered());
+  mesh.init(D - 1);
+  mesh.init(D - 1, D);
+
+  // Get interior facets with their cells and local facet indices
+  const MeshInteriorFacets& interior_facets = *mesh.interior_facets();
+  const std::vector<unsigned int>& facet_cells = interior_facets.cells();
+  const std::vector<std::uint8_t>& local_facets
+    = interior_facets.local_facets();
+  const std::vector<std::uint8_t>& owned = interior_facets.owned();
+
+  // Gather cell coordinate dofs once, to be reused by the cell sweep
+  // and by each facet of a cell
+  std::vector<double> cell_coordinate_dofs;
+  compute_cell_coordinate_dofs(cell_coordinate_dofs, mesh, num_threads);
+  const std::size_t num_coordinate_dofs = (mesh.num_cells() == 0) ? 0
+    : cell_coordinate_dofs.size()/mesh.num_cells();
+
+  // Assemble cell and exterior facet integrals
+  cell_wise_assembly_threaded(tensors, ufc, boundary_values, cell_domains,
+                              exterior_facet_domains, coloring_type,
+                              num_threads, &cell_coordinate_dofs);
+
+  // If the lhs has interior facet integrals, the facet tensors are
+  // added as macro elements with Dirichlet conditions applied as for
+  // cells. Otherwise only the rhs facet tensor is added, with the
+  // Dirichlet rows zeroed since no lhs contribution is made for the
+  // facet.
+  const bool add_macro_element = ufc[0]->form.has_interior_facet_integrals();
+  const bool square = (boundary_values.size() == 1);
+
+  // Collect pointers to dof maps
+  std::array<std::vector<const GenericDofMap*>, 2> dofmaps;
+  for (std::size_t i = 0; i < 2; ++i)
+    dofmaps[0].push_back(ufc[0]->dolfin_form.function_space(i)->dofmap().get());
+  dofmaps[1].push_back(ufc[1]->dolfin_form.function_space(0)->dofmap().get());
+
+  // Check whether facet tensors of one color can be added
+  // concurrently, otherwise insertion is serialised
+  std::array<bool, 2> concurrent = {{false, false}};
+  for (std::size_t form = 0; form < 2; ++form)
+  {
+    if (tensors[form])
+    {
+      concurrent[form] = AssemblerBase::concurrent_insertion(*tensors[form],
+                                                             dofmaps[form]);
+    }
+  }
+
+  // Check whether integrals are domain-dependent
+  const bool use_cell_domains = cell_domains && !cell_domains->empty();
+  const bool use_interior_facet_domains
+    = interior_facet_domains && !interior_facet_domains->empty();
+
+  // Color facets
+  const std::vector<std::vector<std::size_t>>& facets_of_color
+    = AssemblerBase::colored_entities(mesh, facet_coloring_type(mesh));
+
+  // An exception cannot leave the parallel region, so the first
+  // one is stored and rethrown after it
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  #pragma omp parallel num_threads(num_threads)
+  {
+    // Thread-local assembly data
+    UFC A_ufc(*ufc[0]), b_ufc(*ufc[1]);
+    std::array<UFC*, 2> _ufc = { {&A_ufc, &b_ufc} };
+    std::array<const ufc::interior_facet_integral*, 2> interior_facet_integrals
+      = { { _ufc[0]->default_interior_facet_integral.get(),
+            _ufc[1]->default_interior_facet_integral.get()} };
+    std::array<ufc::cell, 2> ufc_cell;
+    std::array<std::vector<double>, 2> coordinate_dofs;
+    std::array<std::vector<std::vector<dolfin::la_index>>, 2> macro_dofs;
+    macro_dofs[0].resize(2);
+    macro_dofs[1].resize(1);
+    std::array<std::vector<ArrayView<const dolfin::la_index>>, 2> mdofs;
+    mdofs[0].resize(2);
+    mdofs[1].resize(1);
+
+    for (std::size_t color = 0; color < facets_of_color.size(); ++color)
+    {
+      const std::vector<std::size_t>& facets = facets_of_color[color];
+      const int num_facets = facets.size();
+
+      // Facets of one color are assembled concurrently (implicit
+      // barrier between colors)
+      #pragma omp for schedule(guided, 20)
+      for (int i = 0; i < num_facets; ++i)
+      {
+        // Skip remaining facets after an error
+        if (failed)
+          continue;
+
+        try
+        {
+          // Only consider interior facets which are not ghosts, and
+          // which are assembled by this process (facets on the process
+          // boundary are assembled by the lowest rank)
+          const int f = interior_facets.position(facets[i]);
+          if (f < 0 || !owned[f])
+            continue;
+
+          // Get cells incident with facet. Make sure cell marker for
+          // '+' side is larger than cell marker for '-' side. Note: by
+          // ffc convention, 0 is + and 1 is -
+          std::array<std::size_t, 2> k = {{(std::size_t) 2*f,
+                                           (std::size_t) 2*f + 1}};
+          if (use_cell_domains && (*cell_domains)[facet_cells[k[0]]]
+              < (*cell_domains)[facet_cells[k[1]]])
+          {
+            std::swap(k[0], k[1]);
+          }
+          const std::array<std::size_t, 2> cell_index
+            = {{facet_cells[k[0]], facet_cells[k[1]]}};
+          const std::array<Cell, 2> cell = {{Cell(mesh, cell_index[0]),
+                                             Cell(mesh, cell_index[1])}};
+
+          // Get facet integrals for sub domain (if any)
+          if (use_interior_facet_domains)
+          {
+            const std::size_t domain = (*interior_facet_domains)[facets[i]];
+            for (std::size_t form = 0; form < 2; ++form)
+            {
+              interior_facet_integrals[form]
+                = _ufc[form]->get_interior_facet_integral(domain);
+            }
+          }
+
+          // Tabulate dofs on macro element
+          for (std::size_t form = 0; form < 2; ++form)
+          {
+            for (std::size_t dim = 0; dim < macro_dofs[form].size(); ++dim)
+            {
+              auto cell_dofs0 = dofmaps[form][dim]->cell_dofs(cell_index[0]);
+              auto cell_dofs1 = dofmaps[form][dim]->cell_dofs(cell_index[1]);
+              macro_dofs[form][dim].resize(cell_dofs0.size()
+                                           + cell_dofs1.size());
+              std::copy(cell_dofs0.data(), cell_dofs0.data() + cell_dofs0.size(),
+                        macro_dofs[form][dim].begin());
+              std::copy(cell_dofs1.data(), cell_dofs1.data() + cell_dofs1.size(),
+                        macro_dofs[form][dim].begin() + cell_dofs0.size());
+              mdofs[form][dim].set(macro_dofs[form][dim]);
+            }
+          }
+
+          // Check which facet tensors are required
+          const std::array<bool, 2> tensor_required
+            = {{add_macro_element
+                && cell_matrix_required(tensors[0], interior_facet_integrals[0],
+                                        boundary_values, mdofs[0][1]),
+                tensors[1] && interior_facet_integrals[1]}};
+          if (!tensor_required[0] && !tensor_required[1])
+            continue;
+
+          // Get cell data, with coordinate dofs from the cell cache
+          for (std::size_t c = 0; c < 2; ++c)
+          {
+            cell[c].get_cell_data(ufc_cell[c], local_facets[k[c]]);
+            coordinate_dofs[c].assign(cell_coordinate_dofs.begin()
+                                      + cell_index[c]*num_coordinate_dofs,
+                                      cell_coordinate_dofs.begin()
+                                      + (cell_index[c] + 1)*num_coordinate_dofs);
+          }
+
+          // Compute facet tensors for lhs and rhs
+          for (std::size_t form = 0; form < 2; ++form)
+          {
+            std::fill(_ufc[form]->macro_A.begin(), _ufc[form]->macro_A.end(),
+                      0.0);
+            if (!tensor_required[form])
+              continue;
+
+            _ufc[form]->update(cell[0], coordinate_dofs[0], ufc_cell[0],
+                               cell[1], coordinate_dofs[1], ufc_cell[1],
+                               interior_facet_integrals[form]->enabled_coefficients());
+            interior_facet_integrals[form]->tabulate_tensor(_ufc[form]->macro_A.data(),
+                                                            _ufc[form]->macro_w(),
+                                                            coordinate_dofs[0].data(),
+                                                            coordinate_dofs[1].data(),
+                                                            ufc_cell[0].local_facet,
+                                                            ufc_cell[1].local_facet,
+                                                            ufc_cell[0].orientation,
+                                                            ufc_cell[1].orientation);
+          }
+
+          // Modify local tensors for bcs
+          if (tensor_required[0])
+          {
+            apply_bc(_ufc[0]->macro_A.data(), _ufc[1]->macro_A.data(),
+                     boundary_values, mdofs[0][0], mdofs[0][1]);
+          }
+          else if (square)
+          {
+            for (std::size_t i = 0; i < mdofs[1][0].size(); ++i)
+            {
+              if (boundary_values[0].find(mdofs[1][0][i])
+                  != boundary_values[0].end())
+              {
+                _ufc[1]->macro_A[i] = 0.0;
+              }
+            }
+          }
+
+          // Add entries to global tensor
+          for (std::size_t form = 0; form < 2; ++form)
+          {
+            if (!tensors[form] || !(tensor_required[form] || tensor_required[0]))
+              continue;
+
+            if (concurrent[form])
+              tensors[form]->add_local(_ufc[form]->macro_A.data(), mdofs[form]);
+            else
+            {
+              #pragma omp critical (dolfin_assembler_add_local)
+              tensors[form]->add_local(_ufc[form]->macro_A.data(), mdofs[form]);
+            }
+          }
+        }
+        catch (...)
+        {
+          #pragma omp critical (dolfin_assembler_error)
+          if (!error)
+            error = std::current_exception();
+          failed = true;
+        }
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+//-----------------------------------------------------------------------------
+void SystemAssembler::compute_cell_coordinate_dofs(
+  std::vector<double>& cell_coordinate_dofs,
+  const Mesh& mesh,
+  std::size_t num_threads)
+{
+  cell_coordinate_dofs.clear();
+  const std::int64_t num_cells = mesh.num_cells();
+  if (num_cells == 0)
+    return;
+
+  // Number of coordinate dofs per cell
+  std::vector<double> coordinate_dofs;
+  Cell(mesh, 0).get_coordinate_dofs(coordinate_dofs);
+  const std::size_t n = coordinate_dofs.size();
+  cell_coordinate_dofs.resize(num_cells*n);
+
+  // An exception cannot leave the parallel region, so the first
+  // one is stored and rethrown after it
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  #pragma omp parallel for num_threads(num_threads) \
+    firstprivate(coordinate_dofs) schedule(static)
+  for (std::int64_t c = 0; c < num_cells; ++c)
+  {
+    // Skip remaining cells after an error
+    if (failed)
+      continue;
+
+    try
+    {
+      Cell(mesh, c).get_coordinate_dofs(coordinate_dofs);
+      std::copy(coordinate_dofs.begin(), coordinate_dofs.end(),
+                cell_coordinate_dofs.begin() + c*n);
+    }
+    catch (...)
+    {
+      #pragma omp critical (dolfin_assembler_error)
+      if (!error)
+        error = std::current_exception();
+      failed = true;
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
 }
 //-----------------------------------------------------------------------------
 void SystemAssembler::facet_wise_assembly(
@@ -498,7 +1142,8 @@ void SystemAssembler::facet_wise_assembly(
   const std::vector<DirichletBC::Map>& boundary_values,
   std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
   std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
-  std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains)
+  std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains,
+  AssemblyProfile& profile)
 {
   // Extract mesh
   dolfin_assert(ufc[0]->dolfin_form.mesh());
@@ -515,8 +1160,12 @@ void SystemAssembler::facet_wise_assembly(
   mesh.init(D - 1);
   mesh.init(D - 1, D);
 
-  // Get my MPI rank
-  const int my_mpi_rank = MPI::rank(mesh.mpi_comm());
+  // Get interior facets with their cells and local facet indices
+  const MeshInteriorFacets& interior_facets = *mesh.interior_facets();
+  const std::vector<unsigned int>& facet_cells = interior_facets.cells();
+  const std::vector<std::uint8_t>& local_facets
+    = interior_facets.local_facets();
+  const std::vector<std::uint8_t>& owned = interior_facets.owned();
 
   // Collect pointers to dof maps
   std::array<std::vector<const GenericDofMap*>, 2> dofmaps;
@@ -585,45 +1234,36 @@ void SystemAssembler::facet_wise_assembly(
     // Interior facet
     if (num_cells == 2)
     {
-      // Get cells incident with facet (which is 0 and 1 here is arbitrary)
-      dolfin_assert(facet->num_entities(D) == 2);
-      std::array<std::size_t, 2> cell_indices = {{facet->entities(D)[0],
-                                                  facet->entities(D)[1]}};
+      profile.begin(AssemblyProfile::interior_facets);
+
+      // Get cells incident with facet (which is 0 and 1 here is
+      // arbitrary) and the local index of the facet in each cell
+      const int f = interior_facets.position(facet->index());
+      dolfin_assert(f >= 0);
+      std::array<std::size_t, 2> k = {{(std::size_t) 2*f,
+                                       (std::size_t) 2*f + 1}};
 
       // Make sure cell marker for '+' side is larger than cell marker
       // for '-' side.  Note: by ffc convention, 0 is + and 1 is -
-      if (use_cell_domains && (*cell_domains)[cell_indices[0]]
-          < (*cell_domains)[cell_indices[1]])
+      if (use_cell_domains && (*cell_domains)[facet_cells[k[0]]]
+          < (*cell_domains)[facet_cells[k[1]]])
       {
-        std::swap(cell_indices[0], cell_indices[1]);
+        std::swap(k[0], k[1]);
       }
 
       // Get cells incident with facet and associated data
       for (std::size_t c = 0; c < 2; ++c)
       {
-        cell[c] = Cell(mesh, cell_indices[c]);
+        cell[c] = Cell(mesh, facet_cells[k[c]]);
         cell_index[c] = cell[c].index();
-        local_facet[c] = cell[c].index(*facet);
+        local_facet[c] = local_facets[k[c]];
         cell[c].get_coordinate_dofs(coordinate_dofs[c]);
         cell[c].get_cell_data(ufc_cell[c], local_facet[c]);
 
         compute_cell_tensor[c] = !cell_tensor_computed[cell_index[c]];
       }
 
-      const bool process_facet = (cell[0].is_ghost() != cell[1].is_ghost());
-      bool facet_owner = true;
-      if (process_facet)
-      {
-        int ghost_rank = -1;
-        if (cell[0].is_ghost())
-          ghost_rank = cell[0].owner();
-        else
-          ghost_rank = cell[1].owner();
-        dolfin_assert(my_mpi_rank != ghost_rank);
-        dolfin_assert(ghost_rank != -1);
-        if (ghost_rank < my_mpi_rank)
-          facet_owner = false;
-      }
+      const bool facet_owner = owned[f];
 
       // Loop over lhs and then rhs contributions
       for (std::size_t form = 0; form < 2; ++form)
@@ -738,7 +1378,7 @@ void SystemAssembler::facet_wise_assembly(
                                     interior_facet_integrals,
                                     matrix_size,
                                     vector_size,
-                                    compute_cell_tensor);
+                                    compute_cell_tensor, profile);
 
       // Modify local tensors for bcs
       ArrayView<const la_index> mdofs0(macro_dofs[0][0]);
@@ -775,6 +1415,7 @@ void SystemAssembler::facet_wise_assembly(
         matrix_block_add(*tensors[0], data.Ae[0], ufc[0]->macro_A,
                          compute_cell_tensor, cell_dofs[0]);
       }
+      profile.lap(AssemblyProfile::add_local);
 
       // Mark cells as processed
       cell_tensor_computed[cell_index[0]] = true;
@@ -782,6 +1423,8 @@ void SystemAssembler::facet_wise_assembly(
     }
     else // Exterior facet
     {
+      profile.begin(AssemblyProfile::exterior_facets);
+
       // Get mesh cell to which mesh facet belongs (pick first, there
       // is only one)
       Cell cell(mesh, facet->entities(mesh.topology().dim())[0]);
@@ -848,7 +1491,7 @@ void SystemAssembler::facet_wise_assembly(
                                     cell, *facet,
                                     cell_integrals,
                                     exterior_facet_integrals,
-                                    compute_cell_tensor[0]);
+                                    compute_cell_tensor[0], profile);
 
       // Modify local matrix/element for Dirichlet boundary conditions
       apply_bc(data.Ae[0].data(), data.Ae[1].data(), boundary_values,
@@ -860,6 +1503,7 @@ void SystemAssembler::facet_wise_assembly(
         if (tensors[form])
           tensors[form]->add_local(data.Ae[form].data(), cell_dofs[form][0]);
       }
+      profile.lap(AssemblyProfile::add_local);
 
       // Mark cell as processed
       cell_tensor_computed[cell.index()] = true;
@@ -879,7 +1523,8 @@ void SystemAssembler::compute_exterior_facet_tensor(
   const Facet& facet,
   const std::array<const ufc::cell_integral*, 2>& cell_integrals,
   const std::array<const ufc::exterior_facet_integral*, 2>& exterior_facet_integrals,
-  const bool compute_cell_tensor)
+  const bool compute_cell_tensor,
+  AssemblyProfile& profile)
 {
   // Get local index of facet with respect to the cell
   const std::size_t local_facet = cell.index(facet);
@@ -901,6 +1546,7 @@ void SystemAssembler::compute_exterior_facet_tensor(
       // Update UFC object
       ufc[form]->update(cell, coordinate_dofs, ufc_cell,
                         exterior_facet_integrals[form]->enabled_coefficients());
+      profile.lap(AssemblyProfile::update);
       exterior_facet_integrals[form]->tabulate_tensor(ufc[form]->A.data(),
                                                       ufc[form]->w(),
                                                       coordinate_dofs.data(),
@@ -908,6 +1554,7 @@ void SystemAssembler::compute_exterior_facet_tensor(
                                                       ufc_cell.orientation);
       for (std::size_t i = 0; i < Ae[form].size(); i++)
         Ae[form][i] += ufc[form]->A[i];
+      profile.lap(AssemblyProfile::tabulate_tensor);
     }
 
     // Assemble cell integral (if required)
@@ -920,12 +1567,14 @@ void SystemAssembler::compute_exterior_facet_tensor(
       {
         ufc[form]->update(cell, coordinate_dofs, ufc_cell,
                           cell_integrals[form]->enabled_coefficients());
+        profile.lap(AssemblyProfile::update);
         cell_integrals[form]->tabulate_tensor(ufc[form]->A.data(),
                                               ufc[form]->w(),
                                               coordinate_dofs.data(),
                                               ufc_cell.orientation);
         for (std::size_t i = 0; i < Ae[form].size(); i++)
           Ae[form][i] += ufc[form]->A[i];
+        profile.lap(AssemblyProfile::tabulate_tensor);
       }
     }
   }
@@ -944,7 +1593,8 @@ void SystemAssembler::compute_interior_facet_tensor(
   const std::array<const ufc::interior_facet_integral*, 2>& interior_facet_integrals,
   const std::array<std::size_t, 2>& matrix_size,
   const std::size_t vector_size,
-  const std::array<bool, 2> compute_cell_tensor)
+  const std::array<bool, 2> compute_cell_tensor,
+  AssemblyProfile& profile)
 {
   // Compute facet contribution to tensor, if required
   // Loop over lhs and then rhs facet contributions
@@ -957,6 +1607,8 @@ void SystemAssembler::compute_interior_facet_tensor(
       ufc[form]->update(cell[0], coordinate_dofs[0], ufc_cell[0],
                         cell[1], coordinate_dofs[1], ufc_cell[1],
                         interior_facet_integrals[form]->enabled_coefficients());
+      profile.lap(AssemblyProfile::update);
+
       // Integrate over facet
       interior_facet_integrals[form]->tabulate_tensor(ufc[form]->macro_A.data(),
                                                       ufc[form]->macro_w(),
@@ -966,6 +1618,7 @@ void SystemAssembler::compute_interior_facet_tensor(
                                                       local_facet[1],
                                                       ufc_cell[0].orientation,
                                                       ufc_cell[1].orientation);
+      profile.lap(AssemblyProfile::tabulate_tensor);
     }
 
     // Compute cell contribution
@@ -978,10 +1631,12 @@ void SystemAssembler::compute_interior_facet_tensor(
         {
           ufc[form]->update(cell[c], coordinate_dofs[c], ufc_cell[c],
                             cell_integrals[form]->enabled_coefficients());
+          profile.lap(AssemblyProfile::update);
           cell_integrals[form]->tabulate_tensor(ufc[form]->A.data(),
                                                 ufc[form]->w(),
                                                 coordinate_dofs[c].data(),
                                                 ufc_cell[c].orientation);
+          profile.lap(AssemblyProfile::tabulate_tensor);
 
           // FIXME: Can the below two blocks be consolidated?
           const std::size_t nn = matrix_size[0];
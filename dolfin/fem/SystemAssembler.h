@@ -23,6 +23,7 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "DirichletBC.h"
@@ -41,6 +42,7 @@ namespace dolfin
 
   // Forward declarations
   template<typename T> class ArrayView;
+  class AssemblyPlan;
   class Cell;
   class Facet;
   class Form;
@@ -112,13 +114,57 @@ namespace dolfin
     // Boundary conditions
     std::vector<std::shared_ptr<const DirichletBC>> _bcs;
 
+    // Assembly plan for the bilinear form (used if use_assembly_plan
+    // is true)
+    std::shared_ptr<AssemblyPlan> _assembly_plan;
+
     static void cell_wise_assembly(
       std::array<GenericTensor*, 2>& tensors,
       std::array<UFC*, 2>& ufc,
       Scratch& data,
       const std::vector<DirichletBC::Map>& boundary_values,
       std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
-      std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains);
+      std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
+      AssemblyPlan* plan,
+      AssemblyProfile& profile);
+
+    // Cell-wise assembly with the cells of each color of a cell
+    // coloring assembled concurrently by num_threads threads. If
+    // cell_coordinate_dofs is not null, the cell coordinate dofs are
+    // read from it (see compute_cell_coordinate_dofs) instead of
+    // being gathered from the mesh.
+    static void cell_wise_assembly_threaded(
+      std::array<GenericTensor*, 2>& tensors,
+      std::array<UFC*, 2>& ufc,
+      const std::vector<DirichletBC::Map>& boundary_values,
+      std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
+      std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
+      std::string coloring_type,
+      std::size_t num_threads,
+      const std::vector<double>* cell_coordinate_dofs=NULL);
+
+    // Facet-wise assembly by num_threads threads. Cell and exterior
+    // facet integrals are assembled cell-wise over a cell coloring,
+    // and interior facet integrals over a facet coloring in which
+    // facets of the same color have no cells that share a vertex. The
+    // cell coordinate dofs are gathered once and reused for all
+    // facets of a cell.
+    static void facet_wise_assembly_threaded(
+      std::array<GenericTensor*, 2>& tensors,
+      std::array<UFC*, 2>& ufc,
+      const std::vector<DirichletBC::Map>& boundary_values,
+      std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
+      std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
+      std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains,
+      std::string coloring_type,
+      std::size_t num_threads);
+
+    // Gather the coordinate dofs of all cells into a flat array
+    // (cell-wise, fixed number of coordinate dofs per cell)
+    static void compute_cell_coordinate_dofs(
+      std::vector<double>& cell_coordinate_dofs,
+      const Mesh& mesh,
+      std::size_t num_threads);
 
     static void facet_wise_assembly(
       std::array<GenericTensor*, 2>& tensors,
@@ -127,7 +173,8 @@ namespace dolfin
       const std::vector<DirichletBC::Map>& boundary_values,
       std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
       std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
-      std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains);
+      std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains,
+      AssemblyProfile& profile);
 
     // Compute exterior facet (and possibly connected cell)
     // contribution
@@ -142,7 +189,8 @@ namespace dolfin
       const Facet& facet,
       const std::array<const ufc::cell_integral*, 2>& cell_integrals,
       const std::array<const ufc::exterior_facet_integral*, 2>& exterior_facet_integrals,
-      const bool compute_cell_tensor);
+      const bool compute_cell_tensor,
+      AssemblyProfile& profile);
 
     // Compute interior facet (and possibly connected cell)
     // contribution
@@ -159,7 +207,8 @@ namespace dolfin
       const std::array<const ufc::interior_facet_integral*, 2>& interior_facet_integrals,
       const std::array<std::size_t, 2>& matrix_size,
       const std::size_t vector_size,
-      const std::array<bool, 2> compute_cell_tensor);
+      const std::array<bool, 2> compute_cell_tensor,
+      AssemblyProfile& profile);
 
     // Modified matrix insertion for case when rhs has facet integrals
     // and lhs has no facet integrals
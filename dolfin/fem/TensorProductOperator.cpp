@@ -0,0 +1,581 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <ufc.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/common/constants.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/CellType.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshGeometry.h>
+#include "FiniteElement.h"
+#include "GenericDofMap.h"
+#include "TensorProductOperator.h"
+
+using namespace dolfin;
+
+namespace
+{
+  typedef std::vector<const std::vector<double>*> double_vector_pointers;
+
+  // Compute Gauss-Legendre points and weights on [0, 1]
+  void gauss_legendre(std::size_t q, std::vector<double>& points,
+                      std::vector<double>& weights)
+  {
+    points.resize(q);
+    weights.resize(q);
+    for (std::size_t i = 0; i < q; ++i)
+    {
+      // Newton iteration for root i of the Legendre polynomial P_q,
+      // starting from the Chebyshev approximation
+      double x = std::cos(DOLFIN_PI*(i + 0.75)/(q + 0.5));
+      double dp = 1.0;
+      for (std::size_t iter = 0; iter < 100; ++iter)
+      {
+        double p0 = 1.0, p1 = x;
+        for (std::size_t k = 2; k <= q; ++k)
+        {
+          const double p2 = ((2.0*k - 1.0)*x*p1 - (k - 1.0)*p0)/k;
+          p0 = p1;
+          p1 = p2;
+        }
+        dp = q*(x*p1 - p0)/(x*x - 1.0);
+        const double dx = p1/dp;
+        x -= dx;
+        if (std::abs(dx) < 1e-15)
+          break;
+      }
+
+      // Map from [-1, 1] to [0, 1] in increasing order
+      points[i] = 0.5*(1.0 - x);
+      weights[i] = 1.0/((1.0 - x*x)*dp*dp);
+    }
+  }
+  //---------------------------------------------------------------------------
+  // Evaluate one-dimensional Lagrange basis function i on the given
+  // nodes and its derivative at x
+  void lagrange(const std::vector<double>& nodes, std::size_t i, double x,
+                double& value, double& derivative)
+  {
+    value = 1.0;
+    derivative = 0.0;
+    for (std::size_t m = 0; m < nodes.size(); ++m)
+    {
+      if (m == i)
+        continue;
+      double term = 1.0/(nodes[i] - nodes[m]);
+      for (std::size_t j = 0; j < nodes.size(); ++j)
+      {
+        if (j != i && j != m)
+          term *= (x - nodes[j])/(nodes[i] - nodes[j]);
+      }
+      derivative += term;
+      value *= (x - nodes[m])/(nodes[i] - nodes[m]);
+    }
+  }
+  //---------------------------------------------------------------------------
+  // Apply the one-dimensional matrix A (rows x cols, row-major), or
+  // its transpose, along direction dir of the tensor u with the
+  // given shape and write the result to v. The first direction is
+  // the fastest varying.
+  void apply_1d(const std::vector<double>& A, std::size_t rows,
+                std::size_t cols, bool transpose, std::size_t dir,
+                std::size_t d, std::size_t* shape,
+                const std::vector<double>& u, std::vector<double>& v)
+  {
+    const std::size_t m = transpose ? cols : rows;
+    const std::size_t k = transpose ? rows : cols;
+    dolfin_assert(shape[dir] == k);
+
+    std::size_t inner = 1, outer = 1;
+    for (std::size_t a = 0; a < dir; ++a)
+      inner *= shape[a];
+    for (std::size_t a = dir + 1; a < d; ++a)
+      outer *= shape[a];
+
+    v.assign(inner*m*outer, 0.0);
+    for (std::size_t o = 0; o < outer; ++o)
+    {
+      for (std::size_t i = 0; i < m; ++i)
+      {
+        double* _v = v.data() + inner*(i + m*o);
+        for (std::size_t j = 0; j < k; ++j)
+        {
+          const double a = transpose ? A[j*cols + i] : A[i*cols + j];
+          if (a == 0.0)
+            continue;
+          const double* _u = u.data() + inner*(j + k*o);
+          for (std::size_t s = 0; s < inner; ++s)
+            _v[s] += a*_u[s];
+        }
+      }
+    }
+    shape[dir] = m;
+  }
+  //---------------------------------------------------------------------------
+  // Apply the tensor product of the one-dimensional matrices A[0],
+  // ..., A[d - 1] (each rows x cols), or of their transposes, to u
+  void apply_tensor(const double_vector_pointers& A,
+                    std::size_t rows, std::size_t cols, bool transpose,
+                    const std::vector<double>& u, std::vector<double>& v,
+                    std::vector<double>& work)
+  {
+    const std::size_t d = A.size();
+    std::size_t shape[3];
+    std::fill(shape, shape + d, transpose ? rows : cols);
+
+    work = u;
+    for (std::size_t a = 0; a < d; ++a)
+    {
+      apply_1d(*A[a], rows, cols, transpose, a, d, shape, work, v);
+      std::swap(work, v);
+    }
+    std::swap(work, v);
+  }
+  //---------------------------------------------------------------------------
+  // Compute inverse K of the d x d matrix J and return determinant
+  double invert(const double* J, std::size_t d, double* K)
+  {
+    double det = 0.0;
+    switch (d)
+    {
+    case 1:
+      det = J[0];
+      K[0] = 1.0/det;
+      break;
+    case 2:
+      det = J[0]*J[3] - J[1]*J[2];
+      K[0] = J[3]/det;
+      K[1] = -J[1]/det;
+      K[2] = -J[2]/det;
+      K[3] = J[0]/det;
+      break;
+    case 3:
+      K[0] = J[4]*J[8] - J[5]*J[7];
+      K[1] = J[2]*J[7] - J[1]*J[8];
+      K[2] = J[1]*J[5] - J[2]*J[4];
+      K[3] = J[5]*J[6] - J[3]*J[8];
+      K[4] = J[0]*J[8] - J[2]*J[6];
+      K[5] = J[2]*J[3] - J[0]*J[5];
+      K[6] = J[3]*J[7] - J[4]*J[6];
+      K[7] = J[1]*J[6] - J[0]*J[7];
+      K[8] = J[0]*J[4] - J[1]*J[3];
+      det = J[0]*K[0] + J[1]*K[3] + J[2]*K[6];
+      for (std::size_t i = 0; i < 9; ++i)
+        K[i] /= det;
+      break;
+    default:
+      dolfin_error("TensorProductOperator.cpp",
+                   "compute geometry of cell",
+                   "Unsupported dimension %d", d);
+    }
+    return det;
+  }
+}
+
+//-----------------------------------------------------------------------------
+TensorProductOperator::TensorProductOperator(
+  std::shared_ptr<const FunctionSpace> V,
+  double mass_coefficient,
+  double stiffness_coefficient,
+  std::size_t num_points)
+  : LinearOperator(*Function(V).vector(), *Function(V).vector()), _V(V),
+    _mass_coefficient(mass_coefficient),
+    _stiffness_coefficient(stiffness_coefficient), _dim(0), _n(0), _q(0)
+{
+  init_element(num_points);
+
+  // Create ghosted work vectors
+  _x = Function(V).vector();
+  _y = Function(V).vector();
+}
+//-----------------------------------------------------------------------------
+TensorProductOperator::~TensorProductOperator()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::size_t TensorProductOperator::size(std::size_t dim) const
+{
+  dolfin_assert(dim < 2);
+  return _V->dim();
+}
+//-----------------------------------------------------------------------------
+void TensorProductOperator::mult(const GenericVector& x,
+                                 GenericVector& y) const
+{
+  Timer timer("Apply tensor-product operator");
+  apply(&x, y);
+}
+//-----------------------------------------------------------------------------
+void TensorProductOperator::get_diagonal(GenericVector& d) const
+{
+  Timer timer("Compute diagonal of tensor-product operator");
+  apply(NULL, d);
+}
+//-----------------------------------------------------------------------------
+void TensorProductOperator::init_vector(GenericVector& z,
+                                        std::size_t dim) const
+{
+  dolfin_assert(dim < 2);
+  dolfin_assert(_V->dofmap());
+  z.init(_V->dofmap()->ownership_range());
+}
+//-----------------------------------------------------------------------------
+std::string TensorProductOperator::str(bool verbose) const
+{
+  std::stringstream s;
+  s << "<TensorProductOperator of size " << size(0) << " x " << size(1)
+    << " with " << _n << "^" << _dim << " dofs and " << _q << "^" << _dim
+    << " quadrature points per cell>";
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+void TensorProductOperator::init_element(std::size_t num_points)
+{
+  dolfin_assert(_V->mesh());
+  const Mesh& mesh = *_V->mesh();
+  const CellType::Type cell_type = mesh.type().cell_type();
+  if (cell_type != CellType::interval
+      && cell_type != CellType::quadrilateral
+      && cell_type != CellType::hexahedron)
+  {
+    dolfin_error("TensorProductOperator.cpp",
+                 "create tensor-product operator",
+                 "Mesh must consist of intervals, quadrilaterals or hexahedra");
+  }
+
+  _dim = mesh.topology().dim();
+  if (mesh.geometry().dim() != _dim || mesh.geometry().degree() != 1)
+  {
+    dolfin_error("TensorProductOperator.cpp",
+                 "create tensor-product operator",
+                 "Mesh geometry must be of degree 1 and have the topological "
+                 "dimension of the mesh");
+  }
+
+  dolfin_assert(_V->element());
+  const FiniteElement& element = *_V->element();
+  if (element.value_rank() != 0)
+  {
+    dolfin_error("TensorProductOperator.cpp",
+                 "create tensor-product operator",
+                 "Function space must be scalar valued");
+  }
+
+  // Tabulate dof coordinates on the reference cell
+  std::shared_ptr<const ufc::finite_element> ufc_element
+    = element.ufc_element();
+  const std::size_t space_dim = element.space_dimension();
+  std::vector<double> X(space_dim*_dim);
+  ufc_element->tabulate_reference_dof_coordinates(X.data());
+
+  // Extract one-dimensional nodes from first coordinate
+  std::vector<double> nodes;
+  for (std::size_t i = 0; i < space_dim; ++i)
+    nodes.push_back(X[i*_dim]);
+  std::sort(nodes.begin(), nodes.end());
+  std::vector<double>::iterator end = nodes.begin();
+  for (std::vector<double>::iterator it = nodes.begin(); it != nodes.end();
+       ++it)
+  {
+    if (end == nodes.begin() || std::abs(*it - *(end - 1)) > DOLFIN_EPS)
+      *end++ = *it;
+  }
+  nodes.erase(end, nodes.end());
+  _n = nodes.size();
+
+  std::size_t num_lex = 1;
+  for (std::size_t a = 0; a < _dim; ++a)
+    num_lex *= _n;
+  if (num_lex != space_dim)
+  {
+    dolfin_error("TensorProductOperator.cpp",
+                 "create tensor-product operator",
+                 "Element dofs do not form a tensor-product grid");
+  }
+
+  // Compute lexicographic index of each local dof
+  _lexicographic_dofs.assign(space_dim, space_dim);
+  for (std::size_t i = 0; i < space_dim; ++i)
+  {
+    std::size_t lex = 0, stride = 1;
+    for (std::size_t a = 0; a < _dim; ++a)
+    {
+      const double x = X[i*_dim + a];
+      std::size_t j = 0;
+      while (j < _n && std::abs(nodes[j] - x) > DOLFIN_EPS)
+        ++j;
+      if (j == _n)
+      {
+        dolfin_error("TensorProductOperator.cpp",
+                     "create tensor-product operator",
+                     "Element dofs do not form a tensor-product grid");
+      }
+      lex += stride*j;
+      stride *= _n;
+    }
+
+    if (_lexicographic_dofs[lex] != space_dim)
+    {
+      dolfin_error("TensorProductOperator.cpp",
+                   "create tensor-product operator",
+                   "Element has more than one dof at a point");
+    }
+    _lexicographic_dofs[lex] = i;
+  }
+
+  // Check that the element basis is the tensor product of the
+  // one-dimensional Lagrange basis on the nodes
+  const double p[3] = {0.31, 0.17, 0.53};
+  std::vector<double> values(space_dim);
+  ufc_element->evaluate_reference_basis(values.data(), 1, p);
+  for (std::size_t lex = 0; lex < space_dim; ++lex)
+  {
+    double value = 1.0;
+    std::size_t l = lex;
+    for (std::size_t a = 0; a < _dim; ++a)
+    {
+      double v, dv;
+      lagrange(nodes, l % _n, p[a], v, dv);
+      value *= v;
+      l /= _n;
+    }
+
+    if (std::abs(value - values[_lexicographic_dofs[lex]]) > 1e-10)
+    {
+      dolfin_error("TensorProductOperator.cpp",
+                   "create tensor-product operator",
+                   "Element is not a tensor-product Lagrange element");
+    }
+  }
+
+  // Tabulate one-dimensional basis at the Gauss points
+  _q = num_points > 0 ? num_points : _n;
+  gauss_legendre(_q, _points, _weights);
+  _B.resize(_q*_n);
+  _D.resize(_q*_n);
+  for (std::size_t j = 0; j < _q; ++j)
+    for (std::size_t i = 0; i < _n; ++i)
+      lagrange(nodes, i, _points[j], _B[j*_n + i], _D[j*_n + i]);
+}
+//-----------------------------------------------------------------------------
+void TensorProductOperator::compute_geometry(
+  const std::vector<double>& coordinate_dofs,
+  std::vector<double>& mass_factor,
+  std::vector<double>& stiffness_factor) const
+{
+  const std::size_t d = _dim;
+  std::size_t num_points = 1, num_vertices = 1;
+  for (std::size_t a = 0; a < d; ++a)
+  {
+    num_points *= _q;
+    num_vertices *= 2;
+  }
+  mass_factor.resize(num_points);
+  stiffness_factor.resize(num_points*d*d);
+
+  double J[9], K[9];
+  for (std::size_t k = 0; k < num_points; ++k)
+  {
+    // Point and weight
+    std::size_t jq[3];
+    double weight = 1.0;
+    std::size_t l = k;
+    for (std::size_t a = 0; a < d; ++a)
+    {
+      jq[a] = l % _q;
+      weight *= _weights[jq[a]];
+      l /= _q;
+    }
+
+    // Jacobian of the multilinear map; vertex v is at the corner
+    // given by the bits of v, first direction fastest
+    std::fill(J, J + d*d, 0.0);
+    for (std::size_t v = 0; v < num_vertices; ++v)
+    {
+      for (std::size_t b = 0; b < d; ++b)
+      {
+        double dN = 1.0;
+        for (std::size_t a = 0; a < d; ++a)
+        {
+          const bool upper = (v >> a) & 1;
+          const double xi = _points[jq[a]];
+          if (a == b)
+            dN *= upper ? 1.0 : -1.0;
+          else
+            dN *= upper ? xi : 1.0 - xi;
+        }
+        for (std::size_t i = 0; i < d; ++i)
+          J[i*d + b] += coordinate_dofs[v*d + i]*dN;
+      }
+    }
+
+    const double det = std::abs(invert(J, d, K));
+    mass_factor[k] = _mass_coefficient*weight*det;
+    for (std::size_t a = 0; a < d; ++a)
+    {
+      for (std::size_t b = 0; b < d; ++b)
+      {
+        double G = 0.0;
+        for (std::size_t i = 0; i < d; ++i)
+          G += K[a*d + i]*K[b*d + i];
+        stiffness_factor[(k*d + a)*d + b]
+          = _stiffness_coefficient*weight*det*G;
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void TensorProductOperator::apply(const GenericVector* x,
+                                  GenericVector& y) const
+{
+  dolfin_assert(_V->mesh());
+  const Mesh& mesh = *_V->mesh();
+  dolfin_assert(_V->dofmap());
+  const GenericDofMap& dofmap = *_V->dofmap();
+
+  const std::size_t d = _dim;
+  const std::size_t space_dim = _lexicographic_dofs.size();
+  std::size_t num_points = 1;
+  for (std::size_t a = 0; a < d; ++a)
+    num_points *= _q;
+
+  // Copy owned values of x to ghosted work vector
+  if (x)
+  {
+    _x->copy_owned_values(*x);
+    _x->update_ghost_values_begin();
+    _x->update_ghost_values_end();
+  }
+  _y->zero();
+
+  // Matrices for values (B in all directions) and for the gradient
+  // component in direction a (D in direction a, B otherwise)
+  const double_vector_pointers B(d, &_B);
+  std::vector<double_vector_pointers> grad(d, B);
+  for (std::size_t a = 0; a < d; ++a)
+    grad[a][a] = &_D;
+
+  std::vector<double> xe(space_dim), ye(space_dim);
+  std::vector<double> u(space_dim), w(space_dim);
+  std::vector<double> uq, work;
+  std::vector<std::vector<double>> gq(d), fq(d);
+  std::vector<double> mass_factor, stiffness_factor;
+  std::vector<double> coordinate_dofs;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    cell->get_coordinate_dofs(coordinate_dofs);
+    compute_geometry(coordinate_dofs, mass_factor, stiffness_factor);
+    auto dofs = dofmap.cell_dofs(cell->index());
+    dolfin_assert((std::size_t) dofs.size() == space_dim);
+
+    std::fill(w.begin(), w.end(), 0.0);
+    if (x)
+    {
+      // Gather cell values in lexicographic order
+      _x->get_local(xe.data(), space_dim, dofs.data());
+      for (std::size_t l = 0; l < space_dim; ++l)
+        u[l] = xe[_lexicographic_dofs[l]];
+
+      // Mass term
+      if (_mass_coefficient != 0.0)
+      {
+        apply_tensor(B, _q, _n, false, u, uq, work);
+        for (std::size_t k = 0; k < num_points; ++k)
+          uq[k] *= mass_factor[k];
+        apply_tensor(B, _q, _n, true, uq, xe, work);
+        for (std::size_t l = 0; l < space_dim; ++l)
+          w[l] += xe[l];
+      }
+
+      // Stiffness term
+      if (_stiffness_coefficient != 0.0)
+      {
+        for (std::size_t a = 0; a < d; ++a)
+        {
+          apply_tensor(grad[a], _q, _n, false, u, gq[a], work);
+          fq[a].assign(num_points, 0.0);
+        }
+        for (std::size_t k = 0; k < num_points; ++k)
+          for (std::size_t a = 0; a < d; ++a)
+            for (std::size_t b = 0; b < d; ++b)
+              fq[a][k] += stiffness_factor[(k*d + a)*d + b]*gq[b][k];
+        for (std::size_t a = 0; a < d; ++a)
+        {
+          apply_tensor(grad[a], _q, _n, true, fq[a], xe, work);
+          for (std::size_t l = 0; l < space_dim; ++l)
+            w[l] += xe[l];
+        }
+      }
+    }
+    else
+    {
+      // Diagonal: sum over quadrature points of the squared basis
+      // function values and gradients
+      for (std::size_t l = 0; l < space_dim; ++l)
+      {
+        std::size_t il[3];
+        std::size_t _l = l;
+        for (std::size_t a = 0; a < d; ++a)
+        {
+          il[a] = _l % _n;
+          _l /= _n;
+        }
+
+        for (std::size_t k = 0; k < num_points; ++k)
+        {
+          double phi = 1.0;
+          double dphi[3] = {1.0, 1.0, 1.0};
+          std::size_t _k = k;
+          for (std::size_t a = 0; a < d; ++a)
+          {
+            const std::size_t jq = _k % _q;
+            _k /= _q;
+            phi *= _B[jq*_n + il[a]];
+            for (std::size_t b = 0; b < d; ++b)
+              dphi[b] *= (a == b ? _D : _B)[jq*_n + il[a]];
+          }
+
+          w[l] += mass_factor[k]*phi*phi;
+          for (std::size_t a = 0; a < d; ++a)
+            for (std::size_t b = 0; b < d; ++b)
+              w[l] += stiffness_factor[(k*d + a)*d + b]*dphi[a]*dphi[b];
+        }
+      }
+    }
+
+    // Scatter from lexicographic order
+    for (std::size_t l = 0; l < space_dim; ++l)
+      ye[_lexicographic_dofs[l]] = w[l];
+    _y->add_local(ye.data(), space_dim, dofs.data());
+  }
+
+  // Finalize and copy result
+  _y->apply("add");
+  if (y.empty())
+    init_vector(y, 0);
+  y = *_y;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __TENSOR_PRODUCT_OPERATOR_H
+#define __TENSOR_PRODUCT_OPERATOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin/la/LinearOperator.h>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class FunctionSpace;
+  class GenericVector;
+
+  /// This class provides the matrix-free action of the operator
+  ///
+  ///     A = c_m M + c_k K,
+  ///
+  /// where M and K are the mass and stiffness matrices of a scalar
+  /// Lagrange (Q_k) space on a mesh of intervals, quadrilaterals or
+  /// hexahedra, by sum factorisation. The cell dofs are mapped to
+  /// lexicographic (tensor-product) order once for the element, so
+  /// that values and gradients at the tensor-product Gauss points
+  /// are computed with one-dimensional basis matrices, one direction
+  /// at a time. This costs O(k^{d+1}) operations per cell compared
+  /// to O(k^{2d}) for a cell tensor of a Q_k element in d
+  /// dimensions.
+  ///
+  /// The mesh geometry must be of degree 1 (bi- or trilinear
+  /// cells). By default, k + 1 Gauss points are used in each
+  /// direction, which integrates both M and K exactly on affine
+  /// cells.
+
+  class TensorProductOperator : public LinearOperator
+  {
+  public:
+
+    /// Create tensor-product operator c_m M + c_k K
+    ///
+    /// @param[in] V (FunctionSpace)
+    ///         The function space.
+    /// @param[in] mass_coefficient (double)
+    ///         The coefficient c_m of the mass matrix.
+    /// @param[in] stiffness_coefficient (double)
+    ///         The coefficient c_k of the stiffness matrix.
+    /// @param[in] num_points (std::size_t)
+    ///         The number of Gauss points in each direction
+    ///         (0 means degree + 1).
+    TensorProductOperator(std::shared_ptr<const FunctionSpace> V,
+                          double mass_coefficient,
+                          double stiffness_coefficient,
+                          std::size_t num_points=0);
+
+    /// Destructor
+    ~TensorProductOperator();
+
+    /// Return size of given dimension
+    std::size_t size(std::size_t dim) const;
+
+    /// Compute matrix-vector product y = Ax
+    void mult(const GenericVector& x, GenericVector& y) const;
+
+    /// Compute diagonal of operator
+    void get_diagonal(GenericVector& d) const;
+
+    /// Initialize vector z to be compatible with the operator
+    void init_vector(GenericVector& z, std::size_t dim) const;
+
+    /// Return the local (cell) dof for each lexicographic index
+    /// i_0 + n*i_1 + n^2*i_2, where n is the number of dofs in each
+    /// direction
+    const std::vector<std::size_t>& lexicographic_dofs() const
+    { return _lexicographic_dofs; }
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // Compute y = Ax if x is given, otherwise compute diagonal
+    void apply(const GenericVector* x, GenericVector& y) const;
+
+    // Compute lexicographic dof order and one-dimensional basis
+    // matrices from the element
+    void init_element(std::size_t num_points);
+
+    // Compute geometry factors at the quadrature points of a cell
+    // from the cell vertex coordinates
+    void compute_geometry(const std::vector<double>& coordinate_dofs,
+                          std::vector<double>& mass_factor,
+                          std::vector<double>& stiffness_factor) const;
+
+    // The function space
+    std::shared_ptr<const FunctionSpace> _V;
+
+    // Coefficients of mass and stiffness matrices
+    double _mass_coefficient, _stiffness_coefficient;
+
+    // Topological dimension, number of dofs and quadrature points
+    // in each direction
+    std::size_t _dim, _n, _q;
+
+    // Local dofs in lexicographic order
+    std::vector<std::size_t> _lexicographic_dofs;
+
+    // One-dimensional Gauss points and weights on [0, 1] and basis
+    // values and derivatives at the points (q x n, row-major)
+    std::vector<double> _points, _weights, _B, _D;
+
+    // Ghosted work vectors for x and y
+    std::shared_ptr<GenericVector> _x, _y;
+
+  };
+
+}
+
+#endif
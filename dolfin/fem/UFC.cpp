@@ -19,9 +19,15 @@
 // Modified by Garth N. Wells, 2010
 // Modified by Martin Alnaes, 2013-2015
 
+#include <algorithm>
 #include <dolfin/common/types.h>
+#include <dolfin/function/Constant.h>
+#include <dolfin/function/Function.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/function/GenericFunction.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/la/IndexMap.h>
+#include <dolfin/mesh/Cell.h>
 #include "GenericDofMap.h"
 #include "FiniteElement.h"
 #include "Form.h"
@@ -39,6 +45,11 @@ UFC::UFC(const Form& a) : form(*a.ufc_form()), coefficients(a.coefficients()),
 //-----------------------------------------------------------------------------
 UFC::UFC(const UFC& ufc) : form(ufc.form),
                            coefficients(ufc.dolfin_form.coefficients()),
+                           _coefficient_values(ufc._coefficient_values),
+                           _coefficient_dofmaps(ufc._coefficient_dofmaps),
+                           _coefficient_meshes(ufc._coefficient_meshes),
+                           _coefficient_constant(ufc._coefficient_constant),
+                           _static_interpolants(ufc._static_interpolants),
                            dolfin_form(ufc.dolfin_form)
 {
   this->init(ufc.dolfin_form);
@@ -162,9 +173,8 @@ void UFC::update(const Cell& c, const std::vector<double>& coordinate_dofs,
   {
     if (!enabled_coefficients[i])
       continue;
-    dolfin_assert(coefficients[i]);
-    coefficients[i]->restrict(_w[i].data(), coefficient_elements[i], c,
-                              coordinate_dofs.data(), ufc_cell);
+    restrict_coefficient(i, _w[i].data(), c, coordinate_dofs.data(),
+                         ufc_cell);
   }
 }
 //-----------------------------------------------------------------------------
@@ -179,13 +189,11 @@ void UFC::update(const Cell& c0, const std::vector<double>& coordinate_dofs0,
   {
     if (!enabled_coefficients[i])
       continue;
-    dolfin_assert(coefficients[i]);
     const std::size_t offset = coefficient_elements[i].space_dimension();
-    coefficients[i]->restrict(_macro_w[i].data(), coefficient_elements[i],
-                              c0, coordinate_dofs0.data(), ufc_cell0);
-    coefficients[i]->restrict(_macro_w[i].data() + offset,
-                              coefficient_elements[i],
-                              c1, coordinate_dofs1.data(), ufc_cell1);
+    restrict_coefficient(i, _macro_w[i].data(), c0, coordinate_dofs0.data(),
+                         ufc_cell0);
+    restrict_coefficient(i, _macro_w[i].data() + offset, c1,
+                         coordinate_dofs1.data(), ufc_cell1);
   }
 }
 //-----------------------------------------------------------------------------
@@ -195,9 +203,8 @@ void UFC::update(const Cell& c, const std::vector<double>& coordinate_dofs,
   // Restrict coefficients to facet
   for (std::size_t i = 0; i < coefficients.size(); ++i)
   {
-    dolfin_assert(coefficients[i]);
-    coefficients[i]->restrict(_w[i].data(), coefficient_elements[i], c,
-                              coordinate_dofs.data(), ufc_cell);
+    restrict_coefficient(i, _w[i].data(), c, coordinate_dofs.data(),
+                         ufc_cell);
   }
 }
 //-----------------------------------------------------------------------------
@@ -209,13 +216,108 @@ void UFC::update(const Cell& c0, const std::vector<double>& coordinate_dofs0,
   // Restrict coefficients to facet
   for (std::size_t i = 0; i < coefficients.size(); ++i)
   {
-    dolfin_assert(coefficients[i]);
     const std::size_t offset = coefficient_elements[i].space_dimension();
-    coefficients[i]->restrict(_macro_w[i].data(), coefficient_elements[i],
-                              c0, coordinate_dofs0.data(), ufc_cell0);
-    coefficients[i]->restrict(_macro_w[i].data() + offset,
-                              coefficient_elements[i],
-                              c1, coordinate_dofs1.data(), ufc_cell1);
+    restrict_coefficient(i, _macro_w[i].data(), c0, coordinate_dofs0.data(),
+                         ufc_cell0);
+    restrict_coefficient(i, _macro_w[i].data() + offset, c1,
+                         coordinate_dofs1.data(), ufc_cell1);
   }
 }
 //-----------------------------------------------------------------------------
+void UFC::prefetch_coefficients()
+{
+  const std::size_t num_coefficients = coefficients.size();
+  _coefficient_values.assign(num_coefficients, std::vector<double>());
+  _coefficient_dofmaps.assign(num_coefficients, nullptr);
+  _coefficient_meshes.assign(num_coefficients, nullptr);
+  _coefficient_constant.assign(num_coefficients, false);
+  _static_interpolants.assign(num_coefficients, nullptr);
+
+  for (std::size_t i = 0; i < num_coefficients; ++i)
+  {
+    // Constants on Real elements are the same on all cells
+    const Constant* constant
+      = dynamic_cast<const Constant*>(coefficients[i].get());
+    if (constant
+        and coefficient_elements[i].signature().find("'Real'")
+            != std::string::npos)
+    {
+      std::vector<double> values = constant->values();
+      if (values.size() == coefficient_elements[i].space_dimension())
+      {
+        _coefficient_values[i] = values;
+        _coefficient_constant[i] = true;
+        continue;
+      }
+    }
+
+    // Static coefficients are restricted from their interpolant
+    _static_interpolants[i] = dolfin_form.static_coefficient_interpolant(i);
+
+    // Only Functions in the space of the coefficient element
+    const Function* f = _static_interpolants[i]
+      ? _static_interpolants[i].get()
+      : dynamic_cast<const Function*>(coefficients[i].get());
+    if (!f)
+      continue;
+    dolfin_assert(f->function_space());
+    const FunctionSpace& V = *f->function_space();
+    if (!V.has_element(coefficient_elements[i]))
+      continue;
+
+    // Get owned and ghost values of vector
+    dolfin_assert(V.dofmap());
+    dolfin_assert(V.dofmap()->index_map());
+    dolfin_assert(f->vector());
+    const GenericVector& x = *f->vector();
+    const IndexMap& index_map = *V.dofmap()->index_map();
+    if (index_map.size(IndexMap::MapSize::OWNED) != x.local_size())
+      continue;
+    const std::size_t num_values = index_map.size(IndexMap::MapSize::ALL);
+    std::vector<dolfin::la_index> indices(num_values);
+    for (std::size_t j = 0; j < num_values; ++j)
+      indices[j] = j;
+    _coefficient_values[i].resize(num_values);
+    x.get_local(_coefficient_values[i].data(), num_values, indices.data());
+
+    _coefficient_dofmaps[i] = V.dofmap().get();
+    _coefficient_meshes[i] = V.mesh().get();
+  }
+}
+//-----------------------------------------------------------------------------
+void UFC::clear_prefetched_coefficients()
+{
+  _coefficient_values.clear();
+  _coefficient_dofmaps.clear();
+  _coefficient_meshes.clear();
+  _coefficient_constant.clear();
+  _static_interpolants.clear();
+}
+//-----------------------------------------------------------------------------
+void UFC::restrict_coefficient(std::size_t i, double* w, const Cell& c,
+                               const double* coordinate_dofs,
+                               const ufc::cell& ufc_cell) const
+{
+  // Copy values of constant coefficient
+  if (i < _coefficient_constant.size() and _coefficient_constant[i])
+  {
+    std::copy(_coefficient_values[i].begin(), _coefficient_values[i].end(), w);
+    return;
+  }
+
+  // Gather prefetched values (see Function::restrict)
+  if (i < _coefficient_dofmaps.size() and _coefficient_dofmaps[i]
+      and _coefficient_meshes[i] == &c.mesh())
+  {
+    auto dofs = _coefficient_dofmaps[i]->cell_dofs(c.index());
+    const std::vector<double>& values = _coefficient_values[i];
+    for (Eigen::Index j = 0; j < dofs.size(); ++j)
+      w[j] = values[dofs[j]];
+    return;
+  }
+
+  dolfin_assert(coefficients[i]);
+  coefficients[i]->restrict(w, coefficient_elements[i], c, coordinate_dofs,
+                            ufc_cell);
+}
+//-----------------------------------------------------------------------------
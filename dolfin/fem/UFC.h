@@ -33,7 +33,9 @@ namespace dolfin
   class Cell;
   class FiniteElement;
   class Form;
+  class Function;
   class FunctionSpace;
+  class GenericDofMap;
   class GenericFunction;
   class Mesh;
 
@@ -91,6 +93,23 @@ namespace dolfin
                 const std::vector<double>& coordinate_dofs1,
                 const ufc::cell& ufc_cell1);
 
+    /// Gather the (owned and ghost) values of all Function
+    /// coefficients in the space of the coefficient element once, so
+    /// that update() restricts them by direct indexing instead of
+    /// calling GenericFunction::restrict for each cell. The values
+    /// are not updated if the coefficient vectors change afterwards;
+    /// call again (or create a new UFC object) in that case.
+    ///
+    /// Coefficients declared static on the form (see
+    /// Form::set_static_coefficient) are gathered from their
+    /// interpolant, and _Constant_ coefficients on Real elements are
+    /// evaluated once and copied to each cell.
+    void prefetch_coefficients();
+
+    /// Discard coefficient values gathered by prefetch_coefficients,
+    /// so that update() restricts the coefficients directly
+    void clear_prefetched_coefficients();
+
     /// Pointer to coefficient data. Used to support UFC interface.
     const double* const * w() const
     { return w_pointer.data(); }
@@ -317,6 +336,23 @@ namespace dolfin
     // Coefficient functions
     const std::vector<std::shared_ptr<const GenericFunction>> coefficients;
 
+    // Restrict coefficient i to cell, using prefetched values if
+    // available
+    void restrict_coefficient(std::size_t i, double* w, const Cell& c,
+                              const double* coordinate_dofs,
+                              const ufc::cell& ufc_cell) const;
+
+    // Prefetched values, dofmaps and meshes of Function coefficients
+    // (dofmap is null for coefficients that are not prefetched)
+    std::vector<std::vector<double>> _coefficient_values;
+    std::vector<const GenericDofMap*> _coefficient_dofmaps;
+    std::vector<const Mesh*> _coefficient_meshes;
+
+    // Flags for constant coefficients (values are stored in
+    // _coefficient_values) and interpolants of static coefficients
+    std::vector<bool> _coefficient_constant;
+    std::vector<std::shared_ptr<const Function>> _static_interpolants;
+
   public:
 
     /// The form
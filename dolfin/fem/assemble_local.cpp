@@ -37,7 +37,8 @@ void dolfin::assemble_local(const Form& a,
                             std::vector<double>& tensor)
 {
   Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> A_e;
-  UFC ufc(a);
+  std::shared_ptr<UFC> ufc_data = a.ufc_data();
+  UFC& ufc = *ufc_data;
   ufc::cell ufc_cell;
   std::vector<double> coordinate_dofs;
 
@@ -86,7 +87,8 @@ dolfin::assemble_local(Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eig
                        const Form& a,
                        const Cell& cell)
 {
-  UFC ufc(a);
+  std::shared_ptr<UFC> ufc_data = a.ufc_data();
+  UFC& ufc = *ufc_data;
   ufc::cell ufc_cell;
   std::vector<double> coordinate_dofs;
 
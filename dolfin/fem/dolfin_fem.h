@@ -16,8 +16,14 @@
 #include <dolfin/fem/assemble_local.h>
 #include <dolfin/fem/LocalAssembler.h>
 #include <dolfin/fem/LocalSolver.h>
+#include <dolfin/fem/Projector.h>
+#include <dolfin/fem/StaticCondensation.h>
+#include <dolfin/fem/MatrixFreeOperator.h>
+#include <dolfin/fem/ErrorNorm.h>
+#include <dolfin/fem/TensorProductOperator.h>
 #include <dolfin/fem/solve.h>
 #include <dolfin/fem/Form.h>
+#include <dolfin/fem/AssemblyProfile.h>
 #include <dolfin/fem/AssemblerBase.h>
 #include <dolfin/fem/Assembler.h>
 #include <dolfin/fem/SparsityPatternBuilder.h>
@@ -27,6 +33,7 @@
 #include <dolfin/fem/NonlinearVariationalProblem.h>
 #include <dolfin/fem/NonlinearVariationalSolver.h>
 #include <dolfin/fem/MultiMeshAssembler.h>
+#include <dolfin/fem/MultiFormAssembler.h>
 #include <dolfin/fem/MultiMeshDirichletBC.h>
 #include <dolfin/fem/MultiMeshDofMap.h>
 #include <dolfin/fem/MultiMeshForm.h>
@@ -15,13 +15,24 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <cstdint>
+
+#ifdef HAS_PETSC
+#include <dolfin/la/PETScMatrix.h>
+#endif
+
 #include <dolfin/common/ArrayView.h>
+#include <dolfin/fem/FiniteElement.h>
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Vertex.h>
 #include <dolfin/mesh/MeshEntityIterator.h>
+#include <dolfin/la/DefaultFactory.h>
+#include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericVector.h>
+#include <dolfin/la/VectorSpaceBasis.h>
+#include <dolfin/log/log.h>
 
 #include "fem_utils.h"
 
@@ -296,7 +307,7 @@ Mesh dolfin::create_mesh(Function& coordinates)
     mesh1._cell_type.reset(CellType::create(mesh0._cell_type->cell_type()));
   else
     mesh1._cell_type.reset();
-  mesh1._ordered = mesh0._ordered;
+  mesh1._ordered = mesh0._ordered.load();
   mesh1._cell_orientations = mesh0._cell_orientations;
   mesh1._ghost_mode = mesh0._ghost_mode;
 
@@ -316,6 +327,138 @@ Mesh dolfin::create_mesh(Function& coordinates)
 
   // Assign coordinates
   set_coordinates(mesh1.geometry(), coordinates);
+  if (mesh1.geometry().degree() > 1)
+    mesh1.init_cell_points();
 
   return mesh1;
 }
+std::shared_ptr<VectorSpaceBasis>
+dolfin::rigid_body_modes(const FunctionSpace& V, bool orthonormalize)
+{
+  DefaultFactory factory;
+  return rigid_body_modes(V, factory, orthonormalize);
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<VectorSpaceBasis>
+dolfin::rigid_body_modes(const FunctionSpace& V,
+                         const GenericLinearAlgebraFactory& factory,
+                         bool orthonormalize)
+{
+  dolfin_assert(V.mesh());
+  dolfin_assert(V.element());
+  dolfin_assert(V.dofmap());
+  const Mesh& mesh = *V.mesh();
+  const std::size_t gdim = mesh.geometry().dim();
+  const FiniteElement& element = *V.element();
+  if ((gdim != 2 && gdim != 3) || element.value_rank() != 1
+      || element.value_dimension(0) != gdim
+      || element.num_sub_elements() != gdim)
+  {
+    dolfin_error("fem_utils.cpp",
+                 "build rigid body modes",
+                 "Function space must be a vector space with value size equal to the geometric dimension (2 or 3)");
+  }
+
+  // Coordinates of owned dofs
+  const GenericDofMap& dofmap = *V.dofmap();
+  const std::vector<double> x = V.tabulate_dof_coordinates();
+  const std::size_t local_size = x.size()/gdim;
+
+  // Component of each owned dof: dofs of a blocked dofmap are
+  // numbered by node, otherwise the components are found from the
+  // dofmaps of the subspaces
+  std::vector<std::uint8_t> component(local_size);
+  if (dofmap.block_size() == (int) gdim)
+  {
+    for (std::size_t i = 0; i < local_size; ++i)
+      component[i] = i % gdim;
+  }
+  else
+  {
+    for (std::size_t c = 0; c < gdim; ++c)
+    {
+      std::shared_ptr<const GenericDofMap> sub_dofmap
+        = V.sub(c)->dofmap();
+      for (std::size_t cell = 0; cell < mesh.num_cells(); ++cell)
+      {
+        auto dofs = sub_dofmap->cell_dofs(cell);
+        for (Eigen::Index i = 0; i < dofs.size(); ++i)
+          if ((std::size_t) dofs[i] < local_size)
+            component[dofs[i]] = c;
+      }
+    }
+  }
+
+  // Compute all modes in one pass, mode m stored at
+  // [m*local_size, (m + 1)*local_size)
+  const std::size_t num_modes = (gdim == 2) ? 3 : 6;
+  std::vector<double> values(num_modes*local_size, 0.0);
+  for (std::size_t i = 0; i < local_size; ++i)
+  {
+    const std::size_t c = component[i];
+    const double* p = x.data() + i*gdim;
+
+    // Translation in direction c
+    values[c*local_size + i] = 1.0;
+
+    // Rotations (-y, x, 0), (0, -z, y) and (z, 0, -x)
+    if (gdim == 2)
+      values[2*local_size + i] = (c == 0) ? -p[1] : p[0];
+    else
+    {
+      if (c == 0)
+      {
+        values[3*local_size + i] = -p[1];
+        values[5*local_size + i] = p[2];
+      }
+      else if (c == 1)
+      {
+        values[3*local_size + i] = p[0];
+        values[4*local_size + i] = -p[2];
+      }
+      else
+      {
+        values[4*local_size + i] = p[1];
+        values[5*local_size + i] = -p[0];
+      }
+    }
+  }
+
+  // Create basis vectors
+  const std::pair<std::size_t, std::size_t> range = dofmap.ownership_range();
+  dolfin_assert(range.second - range.first == local_size);
+  std::vector<std::shared_ptr<GenericVector>> basis(num_modes);
+  for (std::size_t m = 0; m < num_modes; ++m)
+  {
+    basis[m] = factory.create_vector(mesh.mpi_comm());
+    basis[m]->init(range);
+    basis[m]->set_local(std::vector<double>(values.begin() + m*local_size,
+                                            values.begin() + (m + 1)*local_size));
+    basis[m]->apply("insert");
+  }
+
+  std::shared_ptr<VectorSpaceBasis> modes
+    = std::make_shared<VectorSpaceBasis>(basis);
+  if (orthonormalize)
+    modes->orthonormalize();
+  return modes;
+}
+//-----------------------------------------------------------------------------
+void dolfin::set_rigid_body_near_nullspace(GenericMatrix& A,
+                                           const FunctionSpace& V)
+{
+  #ifdef HAS_PETSC
+  if (has_type<PETScMatrix>(A))
+  {
+    std::shared_ptr<VectorSpaceBasis> modes
+      = rigid_body_modes(V, A.factory(), true);
+    as_type<PETScMatrix>(A).set_near_nullspace(*modes);
+    return;
+  }
+  #endif
+
+  dolfin_error("fem_utils.cpp",
+               "set rigid body near nullspace",
+               "Near nullspaces are only supported for PETSc matrices");
+}
+//-----------------------------------------------------------------------------
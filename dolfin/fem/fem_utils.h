@@ -18,6 +18,7 @@
 #ifndef __FEM_UTILS_H
 #define __FEM_UTILS_H
 
+#include <memory>
 #include <vector>
 
 #include <dolfin/common/types.h>
@@ -28,7 +29,10 @@ namespace dolfin
   class Mesh;
   class FunctionSpace;
   class Function;
+  class GenericLinearAlgebraFactory;
+  class GenericMatrix;
   class MeshGeometry;
+  class VectorSpaceBasis;
 
   /// Return a map between dof indices and vertex indices
   ///
@@ -107,6 +111,42 @@ namespace dolfin
   /// @return Mesh
   ///         The mesh
   Mesh create_mesh(Function& coordinates);
+
+  /// Build the rigid body modes (translations and rotations) of a
+  /// vector function space, e.g. the near nullspace of linear
+  /// elasticity for smoothed aggregation algebraic multigrid. The
+  /// modes are computed from the dof coordinates in one pass over
+  /// the owned dofs and stored in a (blocked) _VectorSpaceBasis_.
+  ///
+  /// @param    V (_FunctionSpace_)
+  ///         Vector function space with value size equal to the
+  ///         geometric dimension (2 or 3), e.g. vector Lagrange
+  /// @param    orthonormalize (bool)
+  ///         Orthonormalize the basis
+  ///
+  /// @return   _VectorSpaceBasis_
+  ///         The gdim translations followed by the 1 (2D) or 3 (3D)
+  ///         rotations
+  std::shared_ptr<VectorSpaceBasis>
+    rigid_body_modes(const FunctionSpace& V, bool orthonormalize=true);
+
+  /// Build the rigid body modes of a vector function space (see
+  /// above) with vectors from the given factory
+  std::shared_ptr<VectorSpaceBasis>
+    rigid_body_modes(const FunctionSpace& V,
+                     const GenericLinearAlgebraFactory& factory,
+                     bool orthonormalize=true);
+
+  /// Build the orthonormal rigid body modes of a vector function
+  /// space and attach them as near nullspace to a matrix assembled
+  /// on the space (only for the PETSc backend)
+  ///
+  /// @param    A (_GenericMatrix_)
+  ///         The matrix (a _PETScMatrix_)
+  /// @param    V (_FunctionSpace_)
+  ///         Vector function space of the rows of A
+  void set_rigid_body_near_nullspace(GenericMatrix& A,
+                                     const FunctionSpace& V);
 }
 
 #endif
@@ -20,6 +20,7 @@
 // First added:  2009-09-28
 // Last changed: 2011-11-14
 
+#include <dolfin/fem/FiniteElement.h>
 #include <dolfin/log/log.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
@@ -28,6 +29,61 @@
 
 using namespace dolfin;
 
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                      Eigen::RowMajor> RowMatrixXd;
+
+namespace
+{
+  // ufc::function recording the points at which an element
+  // evaluates its degrees of freedom
+  class PointRecorder : public ufc::function
+  {
+  public:
+
+    PointRecorder(std::size_t value_size, std::size_t gdim,
+                  std::vector<double>& x)
+      : _values(value_size, 0.0), _gdim(gdim), _x(x) {}
+
+    void evaluate(double* values, const double* coordinates,
+                  const ufc::cell& c) const
+    {
+      _x.insert(_x.end(), coordinates, coordinates + _gdim);
+      std::copy(_values.begin(), _values.end(), values);
+    }
+
+  private:
+
+    const std::vector<double> _values;
+    const std::size_t _gdim;
+    std::vector<double>& _x;
+
+  };
+
+  // ufc::function returning precomputed values in the order in
+  // which the points were recorded
+  class PointReplayer : public ufc::function
+  {
+  public:
+
+    PointReplayer(const RowMatrixXd& values) : _values(values), _point(0) {}
+
+    void evaluate(double* values, const double* coordinates,
+                  const ufc::cell& c) const
+    {
+      dolfin_assert(_point < (std::size_t) _values.rows());
+      std::copy(_values.row(_point).data(),
+                _values.row(_point).data() + _values.cols(), values);
+      ++_point;
+    }
+
+  private:
+
+    const RowMatrixXd& _values;
+    mutable std::size_t _point;
+
+  };
+}
+
 //-----------------------------------------------------------------------------
 Expression::Expression()
 {
@@ -99,6 +155,40 @@ void Expression::eval(Eigen::Ref<Eigen::VectorXd> values,
                "Missing eval() function (must be overloaded)");
 }
 //-----------------------------------------------------------------------------
+void Expression::eval_block(Eigen::Ref<RowMatrixXd> values,
+                            Eigen::Ref<const RowMatrixXd> x,
+                            const ufc::cell& cell) const
+{
+  dolfin_assert(values.rows() == x.rows());
+
+  // Redirect to single point eval
+  for (Eigen::Index i = 0; i < x.rows(); ++i)
+  {
+    Eigen::Map<Eigen::VectorXd> _values(values.row(i).data(), values.cols());
+    const Eigen::Map<const Eigen::VectorXd> _x(x.row(i).data(), x.cols());
+    eval(_values, _x, cell);
+  }
+}
+//-----------------------------------------------------------------------------
+void Expression::eval_points(Eigen::Ref<RowMatrixXd> values,
+                             Eigen::Ref<const RowMatrixXd> x) const
+{
+  dolfin_assert(values.rows() == x.rows());
+
+  // Redirect to single point eval
+  for (Eigen::Index i = 0; i < x.rows(); ++i)
+  {
+    Eigen::Map<Eigen::VectorXd> _values(values.row(i).data(), values.cols());
+    const Eigen::Map<const Eigen::VectorXd> _x(x.row(i).data(), x.cols());
+    eval(_values, _x);
+  }
+}
+//-----------------------------------------------------------------------------
+bool Expression::has_eval_points() const
+{
+  return false;
+}
+//-----------------------------------------------------------------------------
 std::size_t Expression::value_rank() const
 {
   return _value_shape.size();
@@ -157,9 +247,73 @@ void Expression::restrict(double* w,
                           const double* coordinate_dofs,
                           const ufc::cell& ufc_cell) const
 {
-  // Restrict as UFC function (by calling eval)
-  restrict_as_ufc_function(w, element, dolfin_cell, coordinate_dofs,
-                           ufc_cell);
+  dolfin_assert(w);
+
+  // Collect the points at which the element evaluates its dofs
+  const std::size_t size = value_size();
+  const std::size_t gdim = ufc_cell.geometric_dimension;
+  std::vector<double> points;
+  PointRecorder recorder(size, gdim, points);
+  element.evaluate_dofs(w, recorder, coordinate_dofs, ufc_cell.orientation,
+                        ufc_cell);
+
+  // Evaluate at all points in one call
+  const std::size_t num_points = points.size()/gdim;
+  const Eigen::Map<const RowMatrixXd> x(points.data(), num_points, gdim);
+  RowMatrixXd values(num_points, size);
+  if (has_eval_points())
+    eval_points(values, x);
+  else
+    eval_block(values, x, ufc_cell);
+
+  // Evaluate dofs from the computed values
+  PointReplayer replayer(values);
+  element.evaluate_dofs(w, replayer, coordinate_dofs, ufc_cell.orientation,
+                        ufc_cell);
+}
+//-----------------------------------------------------------------------------
+void Expression::restrict_cells(std::vector<double>& w,
+                                const FiniteElement& element,
+                                const Mesh& mesh) const
+{
+  // Collect the points at which the element evaluates its dofs on
+  // all cells
+  const std::size_t size = value_size();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t space_dimension = element.space_dimension();
+  w.resize(space_dimension*mesh.num_cells());
+  std::vector<double> points;
+  PointRecorder recorder(size, gdim, points);
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+  std::size_t c = 0;
+  for (CellIterator cell(mesh); !cell.end(); ++cell, ++c)
+  {
+    cell->get_coordinate_dofs(coordinate_dofs);
+    cell->get_cell_data(ufc_cell);
+    element.evaluate_dofs(w.data() + c*space_dimension, recorder,
+                          coordinate_dofs.data(), ufc_cell.orientation,
+                          ufc_cell);
+  }
+  w.resize(space_dimension*c);
+
+  // Evaluate at all points in one call
+  const std::size_t num_points = points.size()/gdim;
+  const Eigen::Map<const RowMatrixXd> x(points.data(), num_points, gdim);
+  RowMatrixXd values(num_points, size);
+  eval_points(values, x);
+
+  // Evaluate dofs from the computed values (in the same order)
+  PointReplayer replayer(values);
+  c = 0;
+  for (CellIterator cell(mesh); !cell.end(); ++cell, ++c)
+  {
+    cell->get_coordinate_dofs(coordinate_dofs);
+    cell->get_cell_data(ufc_cell);
+    element.evaluate_dofs(w.data() + c*space_dimension, replayer,
+                          coordinate_dofs.data(), ufc_cell.orientation,
+                          ufc_cell);
+  }
 }
 //-----------------------------------------------------------------------------
 void Expression::compute_vertex_values(std::vector<double>& vertex_values,
@@ -167,7 +321,28 @@ void Expression::compute_vertex_values(std::vector<double>& vertex_values,
 {
   // Local data for vertex values
   const std::size_t size = value_size();
-  Array<double> local_vertex_values(size);
+  const std::size_t gdim = mesh.geometry().dim();
+
+  // Evaluate at all vertices in one call if the expression does not
+  // depend on the cell
+  if (has_eval_points())
+  {
+    const std::size_t num_vertices = mesh.num_vertices();
+    const Eigen::Map<const RowMatrixXd> x(mesh.geometry().x().data(),
+                                          num_vertices, gdim);
+    RowMatrixXd values(num_vertices, size);
+    eval_points(values, x);
+
+    // Copy to array (component-wise)
+    vertex_values.resize(size*num_vertices);
+    for (std::size_t v = 0; v < num_vertices; ++v)
+      for (std::size_t i = 0; i < size; i++)
+        vertex_values[i*num_vertices + v] = values(v, i);
+    return;
+  }
+  const std::size_t num_cell_vertices = mesh.type().num_vertices();
+  RowMatrixXd x(num_cell_vertices, gdim);
+  RowMatrixXd local_vertex_values(num_cell_vertices, size);
 
   // Resize vertex_values
   vertex_values.resize(size*mesh.num_vertices());
@@ -179,21 +354,22 @@ void Expression::compute_vertex_values(std::vector<double>& vertex_values,
     // Update cell data
     cell->get_cell_data(ufc_cell);
 
-    // Iterate over cell vertices
-    for (VertexIterator vertex(*cell); !vertex.end(); ++vertex)
-    {
-      // Wrap coordinate data
-      const Array<double> x(mesh.geometry().dim(),
-                            const_cast<double*>(vertex->x()));
+    // Collect coordinates of cell vertices
+    const unsigned int* vertices = cell->entities(0);
+    for (std::size_t v = 0; v < num_cell_vertices; ++v)
+      for (std::size_t j = 0; j < gdim; ++j)
+        x(v, j) = mesh.geometry().x(vertices[v], j);
 
-      // Evaluate at vertex
-      eval(local_vertex_values, x, ufc_cell);
+    // Evaluate at all vertices of cell
+    eval_block(local_vertex_values, x, ufc_cell);
 
-      // Copy to array
+    // Copy to array
+    for (std::size_t v = 0; v < num_cell_vertices; ++v)
+    {
       for (std::size_t i = 0; i < size; i++)
       {
-        const std::size_t global_index = i*mesh.num_vertices() + vertex->index();
-        vertex_values[global_index] = local_vertex_values[i];
+        const std::size_t global_index = i*mesh.num_vertices() + vertices[v];
+        vertex_values[global_index] = local_vertex_values(v, i);
       }
     }
   }
@@ -126,6 +126,51 @@ namespace dolfin
     virtual void eval(Eigen::Ref<Eigen::VectorXd> values,
                       Eigen::Ref<const Eigen::VectorXd> x) const override;
 
+    /// Evaluate at a block of points in given cell. This is called
+    /// by restrict() and compute_vertex_values() with all points of
+    /// a cell, and the default implementation calls eval() for each
+    /// point. Expressions may overload it with a loop over the
+    /// points that the compiler can vectorise.
+    ///
+    /// @param    values (Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>)
+    ///         The values (num_points x value_size).
+    /// @param    x (Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>)
+    ///         The coordinates of the points (num_points x gdim).
+    /// @param    cell (ufc::cell)
+    ///         The cell which contains the points.
+    virtual void eval_block(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic,
+                                                     Eigen::Dynamic,
+                                                     Eigen::RowMajor>> values,
+                            Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic,
+                                                           Eigen::Dynamic,
+                                                           Eigen::RowMajor>> x,
+                            const ufc::cell& cell) const;
+
+    /// Evaluate at a set of points (not associated with cells). If
+    /// has_eval_points() returns true, this is called by
+    /// compute_vertex_values() and interpolation with the points of
+    /// all cells of the mesh in one call. The default implementation
+    /// calls eval() for each point.
+    ///
+    /// @param    values (Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>)
+    ///         The values (num_points x value_size).
+    /// @param    x (Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>)
+    ///         The coordinates of the points (num_points x gdim).
+    virtual void eval_points(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic,
+                                                      Eigen::Dynamic,
+                                                      Eigen::RowMajor>> values,
+                             Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic,
+                                                            Eigen::Dynamic,
+                                                            Eigen::RowMajor>> x) const;
+
+    /// Return true if the expression does not depend on the cell and
+    /// should be evaluated over a mesh with eval_points() (default
+    /// false).
+    ///
+    /// @return bool
+    ///         True if eval_points() is used.
+    virtual bool has_eval_points() const;
+
     /// Return value rank.
     ///
     /// @return std::size_t
@@ -185,6 +230,20 @@ namespace dolfin
                           const double* coordinate_dofs,
                           const ufc::cell& ufc_cell) const override;
 
+    /// Restrict function to all cells of a mesh, evaluating it at
+    /// the points of all cells in one call to eval_points().
+    ///
+    /// @param    w (std::vector<double>)
+    ///         Expansion coefficients, element.space_dimension() for
+    ///         each cell in the order of CellIterator.
+    /// @param    element (_FiniteElement_)
+    ///         The element.
+    /// @param    mesh (_Mesh_)
+    ///         The mesh.
+    void restrict_cells(std::vector<double>& w,
+                        const FiniteElement& element,
+                        const Mesh& mesh) const;
+
     /// Compute values at all mesh vertices.
     ///
     /// @param    vertex_values (Array<double>)
@@ -20,6 +20,8 @@
 // Modified by Andre Massing 2009
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <map>
 #include <utility>
 #include <vector>
@@ -37,6 +39,7 @@
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/la/DefaultFactory.h>
 #include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Vertex.h>
 #include <dolfin/parameter/GlobalParameters.h>
@@ -152,18 +155,16 @@ const Function& Function::operator= (const Function& v)
   else
   {
     // Create new collapsed FunctionSpace
-    std::unordered_map<std::size_t, std::size_t> collapsed_map;
+    std::vector<std::size_t> collapsed_map;
     _function_space = v._function_space->collapse(collapsed_map);
 
     // Get row indices of original and new vectors
-    std::unordered_map<std::size_t, std::size_t>::const_iterator entry;
     std::vector<dolfin::la_index> new_rows(collapsed_map.size());
     std::vector<dolfin::la_index> old_rows(collapsed_map.size());
-    std::size_t i = 0;
-    for (entry = collapsed_map.begin(); entry != collapsed_map.end(); ++entry)
+    for (std::size_t i = 0; i < collapsed_map.size(); ++i)
     {
-      new_rows[i]   = entry->first;
-      old_rows[i++] = entry->second;
+      new_rows[i] = i;
+      old_rows[i] = collapsed_map[i];
     }
 
     // Gather values into a vector
@@ -201,6 +202,7 @@ Function& Function::operator[] (std::size_t i) const
 {
   // Check if sub-Function is in the cache, otherwise create and add
   // to cache
+  std::lock_guard<std::mutex> lock(_sub_functions_mutex);
   auto sub_function = _sub_functions.find(i);
   if (sub_function != _sub_functions.end())
     return *(sub_function->second);
@@ -226,21 +228,47 @@ void Function::operator=(const FunctionAXPY& axpy)
                  "FunctionAXPY is empty.");
   }
 
-  // Make an initial assign and scale
-  dolfin_assert(axpy.pairs()[0].second);
-  *this = *(axpy.pairs()[0].second);
-  if (axpy.pairs()[0].first != 1.0)
-    *_vector *= axpy.pairs()[0].first;
-
-  // Start from item 2 and axpy
-  std::vector<std::pair<double, std::shared_ptr<const Function>>>
-    ::const_iterator it;
-  for (it = axpy.pairs().begin()+1; it != axpy.pairs().end(); it++)
+  // Sum coefficients of terms that are this function, and collect
+  // the other terms
+  double a_this = 0.0;
+  bool has_this = false;
+  std::vector<double> a;
+  std::vector<std::shared_ptr<const GenericVector>> x;
+  for (auto it = axpy.pairs().begin(); it != axpy.pairs().end(); ++it)
   {
     dolfin_assert(it->second);
     dolfin_assert(it->second->vector());
-    _vector->axpy(it->first, *(it->second->vector()));
+    if (it->second.get() == this)
+    {
+      a_this += it->first;
+      has_this = true;
+    }
+    else
+    {
+      a.push_back(it->first);
+      x.push_back(it->second->vector());
+    }
   }
+
+  if (has_this)
+  {
+    // Update vector in place
+    if (a_this != 1.0)
+      *_vector *= a_this;
+  }
+  else
+  {
+    // Make an initial assign and scale
+    const Function& u0 = *(axpy.pairs()[0].second);
+    *this = u0;
+    if (a[0] != 1.0)
+      *_vector *= a[0];
+    a.erase(a.begin());
+    x.erase(x.begin());
+  }
+
+  // Add remaining terms in a single pass
+  _vector->maxpy(a, x);
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<GenericVector> Function::vector()
@@ -375,6 +403,188 @@ void Function::eval(Eigen::Ref<Eigen::VectorXd> values,
   eval(_values, _x, dolfin_cell, ufc_cell);
 }
 //-----------------------------------------------------------------------------
+void Function::eval(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic,
+                                             Eigen::Dynamic,
+                                             Eigen::RowMajor>> values,
+                    Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic,
+                                                   Eigen::Dynamic,
+                                                   Eigen::RowMajor>> x,
+                    std::vector<unsigned int>& cells) const
+{
+  Timer timer("Function eval (points)");
+
+  dolfin_assert(_function_space);
+  dolfin_assert(_function_space->mesh());
+  dolfin_assert(_function_space->element());
+  const Mesh& mesh = *_function_space->mesh();
+  const FiniteElement& element = *_function_space->element();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_points = x.rows();
+  const std::size_t value_size_loc = value_size();
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+
+  // Check arguments
+  if ((std::size_t) x.cols() != gdim)
+  {
+    dolfin_error("Function.cpp",
+                 "evaluate function at points",
+                 "Point array has %d columns, but the geometric dimension is %d",
+                 (int) x.cols(), (int) gdim);
+  }
+  if ((std::size_t) values.rows() != num_points
+      or (std::size_t) values.cols() != value_size_loc)
+  {
+    dolfin_error("Function.cpp",
+                 "evaluate function at points",
+                 "Value array has wrong shape (%d x %d), expecting (%d x %d)",
+                 (int) values.rows(), (int) values.cols(),
+                 (int) num_points, (int) value_size_loc);
+  }
+  if (cells.empty())
+    cells.assign(num_points, not_found);
+  else if (cells.size() != num_points)
+  {
+    dolfin_error("Function.cpp",
+                 "evaluate function at points",
+                 "Number of cell hints (%d) does not match number of points (%d)",
+                 (int) cells.size(), (int) num_points);
+  }
+
+  if (num_points == 0)
+    return;
+
+  // Bounding box of points, used to compute Morton codes
+  std::vector<double> xmin(gdim), xmax(gdim);
+  for (std::size_t d = 0; d < gdim; ++d)
+  {
+    xmin[d] = x.col(d).minCoeff();
+    xmax[d] = x.col(d).maxCoeff();
+  }
+
+  // Sort points by Morton code, so that consecutive point location
+  // queries visit nearby parts of the bounding box tree and
+  // consecutive points are likely to lie in the same cell
+  const std::size_t bits = 63/gdim;
+  const double scale = (double) ((std::uint64_t(1) << bits) - 1);
+  std::vector<std::pair<std::uint64_t, std::size_t>> order(num_points);
+  for (std::size_t p = 0; p < num_points; ++p)
+  {
+    std::uint64_t code = 0;
+    for (std::size_t d = 0; d < gdim; ++d)
+    {
+      const double h = xmax[d] - xmin[d];
+      const std::uint64_t q = h > 0.0
+        ? (std::uint64_t) ((x(p, d) - xmin[d])/h*scale) : 0;
+      for (std::size_t b = 0; b < bits; ++b)
+        code |= ((q >> b) & std::uint64_t(1)) << (b*gdim + d);
+    }
+    order[p] = std::make_pair(code, p);
+  }
+  std::sort(order.begin(), order.end());
+
+  // Vertex-cell connectivity, used for walking from a cell hint to a
+  // neighbouring cell
+  mesh.init(0, tdim);
+
+  // Locate points
+  std::shared_ptr<BoundingBoxTree> tree = mesh.bounding_box_tree();
+  unsigned int previous = not_found;
+  for (std::size_t k = 0; k < num_points; ++k)
+  {
+    const std::size_t p = order[k].second;
+    const Point point(gdim, x.row(p).data());
+    unsigned int id = not_found;
+
+    // Try cell hint and its vertex neighbours, then the cell of the
+    // previous point in Morton order
+    const unsigned int hint = cells[p];
+    if (hint < mesh.num_cells())
+    {
+      const Cell cell(mesh, hint);
+      if (cell.collides(point))
+        id = hint;
+      else
+      {
+        for (VertexIterator v(cell); !v.end() and id == not_found; ++v)
+        {
+          for (std::size_t c = 0; c < v->num_entities(tdim); ++c)
+          {
+            const unsigned int neighbour = v->entities(tdim)[c];
+            if (neighbour != hint and Cell(mesh, neighbour).collides(point))
+            {
+              id = neighbour;
+              break;
+            }
+          }
+        }
+      }
+    }
+    if (id == not_found and previous != not_found and previous != hint
+        and Cell(mesh, previous).collides(point))
+    {
+      id = previous;
+    }
+
+    // Fall back to bounding box tree search
+    if (id == not_found)
+      id = tree->compute_first_entity_collision(point);
+    if (id == not_found)
+    {
+      if (_allow_extrapolation)
+        id = tree->compute_closest_entity(point).first;
+      else
+      {
+        dolfin_error("Function.cpp",
+                     "evaluate function at points",
+                     "The point is not inside the domain. Consider calling \"Function::set_allow_extrapolation(true)\" on this Function to allow extrapolation");
+      }
+    }
+
+    cells[p] = id;
+    previous = id;
+  }
+
+  // Group points by cell
+  std::vector<std::pair<unsigned int, std::size_t>> cell_points(num_points);
+  for (std::size_t p = 0; p < num_points; ++p)
+    cell_points[p] = std::make_pair(cells[p], p);
+  std::sort(cell_points.begin(), cell_points.end());
+
+  // Work arrays, reused for all cells and points
+  const std::size_t space_dim = element.space_dimension();
+  std::vector<double> coefficients(space_dim);
+  std::vector<double> basis(space_dim*value_size_loc);
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+
+  // Evaluate, restricting to each cell once
+  for (std::size_t k = 0; k < num_points;)
+  {
+    const unsigned int id = cell_points[k].first;
+    const Cell cell(mesh, id);
+    cell.get_coordinate_dofs(coordinate_dofs);
+    cell.get_cell_data(ufc_cell);
+    restrict(coefficients.data(), element, cell, coordinate_dofs.data(),
+             ufc_cell);
+
+    for (; k < num_points and cell_points[k].first == id; ++k)
+    {
+      const std::size_t p = cell_points[k].second;
+      element.evaluate_basis_all(basis.data(), x.row(p).data(),
+                                 coordinate_dofs.data(),
+                                 ufc_cell.orientation);
+      for (std::size_t j = 0; j < value_size_loc; ++j)
+      {
+        double value = 0.0;
+        for (std::size_t i = 0; i < space_dim; ++i)
+          value += coefficients[i]*basis[i*value_size_loc + j];
+        values(p, j) = value;
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 void Function::interpolate(const GenericFunction& v)
 {
   dolfin_assert(_vector);
@@ -486,6 +696,15 @@ void Function::compute_vertex_values(std::vector<double>& vertex_values,
                  "Non-matching mesh");
   }
 
+  // Use the cached vertex interpolation of the function space (one
+  // gather for e.g. P1 Lagrange) when the mesh is the same object
+  if (&mesh == _function_space->mesh().get())
+  {
+    dolfin_assert(_vector);
+    _function_space->compute_vertex_values(vertex_values, *_vector);
+    return;
+  }
+
   // Get finite element
   dolfin_assert(_function_space->element());
   const FiniteElement& element = *_function_space->element();
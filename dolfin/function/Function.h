@@ -24,6 +24,7 @@
 #define __FUNCTION_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -61,6 +62,12 @@ namespace dolfin
   ///
   /// where :math:`\{\phi_i\}_{i=1}^{n}` is a basis for :math:`V_h`,
   /// and :math:`U` is a vector of expansion coefficients for :math:`u_h`.
+  ///
+  /// Evaluation (eval, restrict) and sub-function access are safe to
+  /// call from several threads at the same time, provided the mesh
+  /// has been prepared as described for _Mesh_ and the linear algebra
+  /// backend supports concurrent reads of the vector. Work arrays of
+  /// eval are local to each call.
 
   class Function : public GenericFunction, public Hierarchical<Function>
   {
@@ -239,6 +246,28 @@ namespace dolfin
               Eigen::Ref<const Eigen::VectorXd> x,
               const dolfin::Cell& dolfin_cell, const ufc::cell& ufc_cell) const;
 
+    /// Evaluate function at a set of points. Points are located in
+    /// bulk (in Morton order for locality in the bounding box tree)
+    /// and grouped per cell, so that the cell geometry and expansion
+    /// coefficients are computed once per cell.
+    ///
+    /// @param    values (Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>)
+    ///         The values (num_points x value_size).
+    /// @param    x (Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>)
+    ///         The coordinates (num_points x gdim).
+    /// @param    cells (std::vector<unsigned int>)
+    ///         On input, an optional hint for the cell containing each
+    ///         point (empty, or std::numeric_limits<unsigned int>::max()
+    ///         for no hint). On output, the cell containing each point.
+    ///         Passing the output of a previous call relocates moving
+    ///         points by a local walk from their previous cell.
+    void eval(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                                       Eigen::RowMajor>> values,
+              Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic,
+                                             Eigen::Dynamic,
+                                             Eigen::RowMajor>> x,
+              std::vector<unsigned int>& cells) const;
+
     /// Interpolate function (on possibly non-matching meshes)
     ///
     /// @param    v (GenericFunction)
@@ -358,6 +387,9 @@ namespace dolfin
     // Collection of sub-functions which share data with the function
     mutable boost::ptr_map<std::size_t, Function> _sub_functions;
 
+    // Lock for the collection of sub-functions
+    mutable std::mutex _sub_functions_mutex;
+
     // Initialize vector
     void init_vector();
 
@@ -24,6 +24,7 @@
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/la/GenericVector.h>
+#include <dolfin/la/LocalVectorArray.h>
 #include <dolfin/log/log.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
@@ -36,7 +37,8 @@ FunctionAssigner::FunctionAssigner(
  std::shared_ptr<const FunctionSpace> receiving_space,
  std::shared_ptr<const FunctionSpace> assigning_space)
   : _receiving_spaces(1, receiving_space),_assigning_spaces(1, assigning_space),
-    _receiving_indices(1), _assigning_indices(1), _transfer(1)
+    _receiving_indices(1), _assigning_indices(1),
+    _receiving_strides(1), _assigning_strides(1), _transfer(1)
 {
   // Get mesh
   const Mesh& mesh = _get_mesh();
@@ -51,6 +53,8 @@ FunctionAssigner::FunctionAssigner(
   : _receiving_spaces(receiving_spaces), _assigning_spaces(1, assigning_space),
     _receiving_indices(receiving_spaces.size()),
     _assigning_indices(receiving_spaces.size()),
+    _receiving_strides(receiving_spaces.size()),
+    _assigning_strides(receiving_spaces.size()),
     _transfer(receiving_spaces.size())
 {
   // Get mesh
@@ -83,6 +87,8 @@ FunctionAssigner::FunctionAssigner(
   :_receiving_spaces(1, receiving_space), _assigning_spaces(assigning_spaces),
    _receiving_indices(assigning_spaces.size()),
    _assigning_indices(assigning_spaces.size()),
+   _receiving_strides(assigning_spaces.size()),
+   _assigning_strides(assigning_spaces.size()),
    _transfer(assigning_spaces.size())
 {
   // Get mesh
@@ -310,15 +316,42 @@ void FunctionAssigner::_assign(
         && (receiving_vector == receiving_funcs[i]->_vector.get());
     }
 
-    // Get assigning values
-    assigning_funcs[i]->_vector->get_local(&_transfer[i][0],
-                                           _transfer[i].size(),
-             &_assigning_indices[i][0]);
+    // Get assigning values directly from the local (ghosted) array,
+    // using strided access for evenly spaced indices
+    if (!_transfer[i].empty())
+    {
+      const GenericVector& x = *assigning_funcs[i]->_vector;
+      const LocalVectorArray<const double> x_values(x, true);
+      std::vector<double>& transfer = _transfer[i];
+      if (_assigning_strides[i] != 0)
+      {
+        const dolfin::la_index offset = _assigning_indices[i][0];
+        const dolfin::la_index stride = _assigning_strides[i];
+        for (std::size_t j = 0; j < transfer.size(); ++j)
+          transfer[j] = x_values[offset + (dolfin::la_index) j*stride];
+      }
+      else
+      {
+        const std::vector<dolfin::la_index>& indices = _assigning_indices[i];
+        for (std::size_t j = 0; j < transfer.size(); ++j)
+          transfer[j] = x_values[indices[j]];
+      }
+    }
 
     // Set receiving values
-    receiving_funcs[i]->_vector->set_local(&_transfer[i][0],
-                                           _transfer[i].size(),
-                                           &_receiving_indices[i][0]);
+    if (_receiving_strides[i] != 0)
+    {
+      receiving_funcs[i]->_vector->set_local_strided(_transfer[i].data(),
+                                                     _transfer[i].size(),
+                                                     _receiving_indices[i][0],
+                                                     _receiving_strides[i]);
+    }
+    else
+    {
+      receiving_funcs[i]->_vector->set_local(_transfer[i].data(),
+                                             _transfer[i].size(),
+                                             _receiving_indices[i].data());
+    }
 
   }
 
@@ -491,8 +524,31 @@ void FunctionAssigner::_check_and_build_indices(
       _assigning_indices[i].push_back(it->second);
     }
 
+    // Detect evenly spaced indices (e.g. from block ordered dofmaps)
+    _receiving_strides[i] = _compute_stride(_receiving_indices[i]);
+    _assigning_strides[i] = _compute_stride(_assigning_indices[i]);
+
     // Resize transfer vector
     _transfer[i].resize(_receiving_indices[i].size());
   }
 }
 //-----------------------------------------------------------------------------
+la_index FunctionAssigner::_compute_stride(const std::vector<la_index>& indices)
+{
+  if (indices.empty())
+    return 0;
+  if (indices.size() == 1)
+    return 1;
+
+  const la_index stride = indices[1] - indices[0];
+  if (stride == 0)
+    return 0;
+  for (std::size_t k = 2; k < indices.size(); ++k)
+  {
+    if (indices[k] - indices[k - 1] != stride)
+      return 0;
+  }
+
+  return stride;
+}
+//-----------------------------------------------------------------------------
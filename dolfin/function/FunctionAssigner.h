@@ -142,6 +142,10 @@ namespace dolfin
 	  const std::vector<std::shared_ptr<const FunctionSpace> >& receiving_spaces,
 	  const std::vector<std::shared_ptr<const FunctionSpace> >& assigning_spaces);
 
+    // Return stride of indices if these are evenly spaced, otherwise
+    // zero
+    static la_index _compute_stride(const std::vector<la_index>& indices);
+
     // Shared pointers to the original FunctionSpaces
     std::vector<std::shared_ptr<const FunctionSpace>> _receiving_spaces;
     std::vector<std::shared_ptr<const FunctionSpace>> _assigning_spaces;
@@ -152,6 +156,11 @@ namespace dolfin
     // Indices for accessing values from assigning Functions
     std::vector<std::vector<la_index>> _assigning_indices;
 
+    // Stride of receiving and assigning indices when these are of the
+    // form indices[0] + k*stride (zero otherwise)
+    std::vector<la_index> _receiving_strides;
+    std::vector<la_index> _assigning_strides;
+
     // Vector for value transfer between assigning and receiving Function
     mutable std::vector<std::vector<double> > _transfer;
 
@@ -24,14 +24,22 @@
 // First added:  2008-09-11
 // Last changed: 2015-11-12
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <vector>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/utils.h>
+#include <dolfin/fem/BasisFunction.h>
 #include <dolfin/fem/FiniteElement.h>
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/la/GenericVector.h>
+#include <dolfin/la/LocalVectorArray.h>
 #include <dolfin/log/log.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Mesh.h>
+#include "Expression.h"
+#include "Function.h"
 #include "GenericFunction.h"
 #include "FunctionSpace.h"
 
@@ -42,19 +50,28 @@ FunctionSpace::FunctionSpace(std::shared_ptr<const Mesh> mesh,
                              std::shared_ptr<const FiniteElement> element,
                              std::shared_ptr<const GenericDofMap> dofmap)
   : Hierarchical<FunctionSpace>(*this),
-    _mesh(mesh), _element(element), _dofmap(dofmap), _root_space_id(id())
+    _mesh(mesh), _element(element), _dofmap(dofmap), _root_space_id(id()),
+    _has_vertex_interpolation(false),
+    _vertex_interpolation_topology_state(0),
+    _vertex_interpolation_geometry_state(0)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 FunctionSpace::FunctionSpace(std::shared_ptr<const Mesh> mesh)
-  : Hierarchical<FunctionSpace>(*this), _mesh(mesh), _root_space_id(id())
+  : Hierarchical<FunctionSpace>(*this), _mesh(mesh), _root_space_id(id()),
+    _has_vertex_interpolation(false),
+    _vertex_interpolation_topology_state(0),
+    _vertex_interpolation_geometry_state(0)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 FunctionSpace::FunctionSpace(const FunctionSpace& V)
-  : Hierarchical<FunctionSpace>(*this)
+  : Hierarchical<FunctionSpace>(*this),
+    _has_vertex_interpolation(false),
+    _vertex_interpolation_topology_state(0),
+    _vertex_interpolation_geometry_state(0)
 {
   // Assign data (will be shared)
   *this = V;
@@ -70,6 +87,23 @@ void FunctionSpace::attach(std::shared_ptr<const FiniteElement> element,
 {
   _element = element;
   _dofmap  = dofmap;
+
+  // Clear collapsed space and vertex interpolation caches
+  std::lock_guard<std::mutex> lock(_collapse_mutex);
+  _collapsed_space.reset();
+  _collapsed_dofs.clear();
+
+  std::lock_guard<std::mutex> vertex_lock(_vertex_interpolation_mutex);
+  _vertex_to_dof.clear();
+  _vertex_interpolation.clear();
+  _has_vertex_interpolation = false;
+
+  std::lock_guard<std::mutex> parent_lock(_parent_interpolation_mutex);
+  _parent_interpolation.clear();
+  _parent_interpolation_state.clear();
+
+  std::lock_guard<std::mutex> function_lock(_function_interpolation_mutex);
+  _function_interpolation.clear();
 }
 //-----------------------------------------------------------------------------
 const FunctionSpace& FunctionSpace::operator=(const FunctionSpace& V)
@@ -133,11 +167,60 @@ FunctionSpace::interpolate_from_parent(GenericVector& expansion_coefficients,
   // Initialize local arrays
   std::vector<double> cell_coefficients(_dofmap->max_element_dofs());
 
-  // Iterate over mesh and interpolate on each cell
-  std::vector<double> coordinate_dofs;
   std::size_t tdim = _mesh->topology().dim();
   const std::vector<std::size_t>& child_to_parent = _mesh->data().array("parent_cell", tdim);
 
+  // Apply the cached cell interpolation matrices to the coefficients
+  // of functions on the parent cells (shared by all functions in the
+  // same parent space)
+  const Function* u = dynamic_cast<const Function*>(&v);
+  if (u and u->vector())
+  {
+    std::lock_guard<std::mutex> lock(_parent_interpolation_mutex);
+    const Mesh& parent_mesh = *v_fs->mesh();
+    const std::vector<std::size_t> state
+      = {parent_mesh.id(), parent_mesh.geometry().state(),
+         parent_mesh.topology().state(), _mesh->geometry().state(),
+         _mesh->topology().state()};
+    if (state != _parent_interpolation_state
+        or v_fs->element()->signature() != _parent_interpolation_signature)
+    {
+      build_parent_interpolation(*v_fs);
+      _parent_interpolation_state = state;
+      _parent_interpolation_signature = v_fs->element()->signature();
+    }
+
+    // Access local (owned and ghost) coefficients of parent function
+    const LocalVectorArray<const double> values(*u->vector(), true);
+    const GenericDofMap& parent_dofmap = *v_fs->dofmap();
+    const std::size_t space_dim = _element->space_dimension();
+    const std::size_t parent_space_dim = v_fs->element()->space_dimension();
+    const double* A = _parent_interpolation.data();
+    for (CellIterator cell(*_mesh); !cell.end(); ++cell)
+    {
+      auto parent_dofs = parent_dofmap.cell_dofs(child_to_parent[cell->index()]);
+      const double* A_cell = A + cell->index()*space_dim*parent_space_dim;
+      for (std::size_t i = 0; i < space_dim; ++i)
+      {
+        const double* row = A_cell + i*parent_space_dim;
+        double value = 0.0;
+        for (std::size_t j = 0; j < parent_space_dim; ++j)
+          value += row[j]*values[parent_dofs[j]];
+        cell_coefficients[i] = value;
+      }
+
+      // Copy dofs to vector
+      auto cell_dofs = _dofmap->cell_dofs(cell->index());
+      expansion_coefficients.set_local(cell_coefficients.data(),
+                                       _dofmap->num_element_dofs(cell->index()),
+                                       cell_dofs.data());
+    }
+    return;
+  }
+
+  // Iterate over mesh and interpolate on each cell
+  std::vector<double> coordinate_dofs;
+
   for (CellIterator cell(*_mesh); !cell.end(); ++cell)
   {
     // Update to current cell
@@ -175,6 +258,26 @@ FunctionSpace::interpolate_from_parent(GenericVector& expansion_coefficients,
 void FunctionSpace::interpolate_from_any(GenericVector& expansion_coefficients,
                                          const GenericFunction& v) const
 {
+  // Evaluate expressions that do not depend on the cell at the
+  // points of all cells in one call
+  const Expression* e = dynamic_cast<const Expression*>(&v);
+  if (e && e->has_eval_points())
+  {
+    std::vector<double> coefficients;
+    e->restrict_cells(coefficients, *_element, *_mesh);
+    const std::size_t space_dimension = _element->space_dimension();
+    std::size_t c = 0;
+    for (CellIterator cell(*_mesh); !cell.end(); ++cell, ++c)
+    {
+      // Copy dofs to vector
+      auto cell_dofs = _dofmap->cell_dofs(cell->index());
+      expansion_coefficients.set_local(coefficients.data() + c*space_dimension,
+                                       _dofmap->num_element_dofs(cell->index()),
+                                       cell_dofs.data());
+    }
+    return;
+  }
+
   // Initialize local arrays
   std::vector<double> cell_coefficients(_dofmap->max_element_dofs());
 
@@ -202,6 +305,64 @@ void FunctionSpace::interpolate_from_any(GenericVector& expansion_coefficients,
 
 }
 //-----------------------------------------------------------------------------
+bool
+FunctionSpace::interpolate_from_function(GenericVector& expansion_coefficients,
+                                         const Function& u) const
+{
+  std::shared_ptr<const FunctionSpace> u_fs = u.function_space();
+  dolfin_assert(u_fs);
+  dolfin_assert(u_fs->element());
+  dolfin_assert(u_fs->dofmap());
+
+  // Cell matrices require the same number of dofs on all cells
+  const std::size_t space_dim = _element->space_dimension();
+  const std::size_t source_space_dim = u_fs->element()->space_dimension();
+  if (_dofmap->max_element_dofs() != space_dim
+      or u_fs->dofmap()->max_element_dofs() != source_space_dim)
+  {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(_function_interpolation_mutex);
+  FunctionInterpolation& data = _function_interpolation[u_fs->id()];
+  const std::vector<std::size_t> state
+    = {_mesh->geometry().state(), _mesh->topology().state()};
+  if (state != data.state or u_fs->element()->signature() != data.signature)
+  {
+    build_function_interpolation(data, *u_fs);
+    data.state = state;
+    data.signature = u_fs->element()->signature();
+  }
+
+  // Gather local (owned and ghost) coefficients of u and multiply by
+  // the cell matrices
+  const LocalVectorArray<const double> values(*u.vector(), true);
+  const std::int64_t num_cells = data.dofs.size()/space_dim;
+  std::vector<double> cell_coefficients(data.dofs.size());
+  const int num_threads = SubSystemsManager::num_threads();
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t c = 0; c < num_cells; ++c)
+  {
+    const dolfin::la_index* source_dofs
+      = data.source_dofs.data() + c*source_space_dim;
+    const double* A = data.matrices.data() + c*space_dim*source_space_dim;
+    for (std::size_t i = 0; i < space_dim; ++i)
+    {
+      const double* row = A + i*source_space_dim;
+      double value = 0.0;
+      for (std::size_t j = 0; j < source_space_dim; ++j)
+        value += row[j]*values[source_dofs[j]];
+      cell_coefficients[c*space_dim + i] = value;
+    }
+  }
+
+  // Scatter to expansion coefficients
+  expansion_coefficients.set_local(cell_coefficients.data(),
+                                   cell_coefficients.size(),
+                                   data.dofs.data());
+  return true;
+}
+//-----------------------------------------------------------------------------
 void FunctionSpace::interpolate(GenericVector& expansion_coefficients,
                                 const GenericFunction& v) const
 {
@@ -250,7 +411,17 @@ void FunctionSpace::interpolate(GenericVector& expansion_coefficients,
     interpolate_from_parent(expansion_coefficients, v);
   }
   else
-    interpolate_from_any(expansion_coefficients, v);
+  {
+    // Use cached interpolation operator for functions on the same
+    // mesh
+    const Function* u = dynamic_cast<const Function*>(&v);
+    if (!(u and u->vector() and v_fs and v_fs->mesh()
+          and v_fs->mesh()->id() == _mesh->id()
+          and interpolate_from_function(expansion_coefficients, *u)))
+    {
+      interpolate_from_any(expansion_coefficients, v);
+    }
+  }
 
   // Finalise changes
   expansion_coefficients.apply("insert");
@@ -271,6 +442,7 @@ FunctionSpace::extract_sub_space(const std::vector<std::size_t>& component) cons
   dolfin_assert(_dofmap);
 
   // Check if sub space is already in the cache
+  std::lock_guard<std::mutex> lock(_subspaces_mutex);
   std::map<std::vector<std::size_t>,
            std::shared_ptr<FunctionSpace>>::const_iterator subspace;
   subspace = _subspaces.find(component);
@@ -307,13 +479,6 @@ FunctionSpace::extract_sub_space(const std::vector<std::size_t>& component) cons
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<FunctionSpace> FunctionSpace::collapse() const
-{
-  std::unordered_map<std::size_t, std::size_t> collapsed_dofs;
-  return collapse(collapsed_dofs);
-}
-//-----------------------------------------------------------------------------
-std::shared_ptr<FunctionSpace>FunctionSpace::collapse(
-  std::unordered_map<std::size_t, std::size_t>& collapsed_dofs) const
 {
   dolfin_assert(_mesh);
 
@@ -324,14 +489,43 @@ std::shared_ptr<FunctionSpace>FunctionSpace::collapse(
                  "Function space is not a subspace");
   }
 
-  // Create collapsed DofMap
-  std::shared_ptr<GenericDofMap>
-    collapsed_dofmap(_dofmap->collapse(collapsed_dofs, *_mesh));
+  // Check if collapsed space is already in the cache
+  std::lock_guard<std::mutex> lock(_collapse_mutex);
+  if (!_collapsed_space)
+  {
+    // Create collapsed DofMap
+    std::shared_ptr<GenericDofMap>
+      collapsed_dofmap(_dofmap->collapse(_collapsed_dofs, *_mesh));
+
+    // Create new FunctionSpace
+    _collapsed_space.reset(new FunctionSpace(_mesh, _element,
+                                             collapsed_dofmap));
+  }
 
-  // Create new FunctionSpace and return
-  std::shared_ptr<FunctionSpace>
-    collapsed_sub_space(new FunctionSpace(_mesh, _element, collapsed_dofmap));
-  return collapsed_sub_space;
+  return _collapsed_space;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<FunctionSpace>
+FunctionSpace::collapse(std::vector<std::size_t>& collapsed_dofs) const
+{
+  std::shared_ptr<FunctionSpace> V = collapse();
+
+  std::lock_guard<std::mutex> lock(_collapse_mutex);
+  collapsed_dofs = _collapsed_dofs;
+  return V;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<FunctionSpace>FunctionSpace::collapse(
+  std::unordered_map<std::size_t, std::size_t>& collapsed_dofs) const
+{
+  std::shared_ptr<FunctionSpace> V = collapse();
+
+  std::lock_guard<std::mutex> lock(_collapse_mutex);
+  collapsed_dofs.clear();
+  collapsed_dofs.reserve(_collapsed_dofs.size());
+  for (std::size_t i = 0; i < _collapsed_dofs.size(); ++i)
+    collapsed_dofs[i] = _collapsed_dofs[i];
+  return V;
 }
 //-----------------------------------------------------------------------------
 std::vector<std::size_t> FunctionSpace::component() const
@@ -428,6 +622,271 @@ void FunctionSpace::set_x(GenericVector& x, double value,
   }
 }
 //-----------------------------------------------------------------------------
+void FunctionSpace::compute_vertex_values(std::vector<double>& vertex_values,
+                                          const GenericVector& x) const
+{
+  dolfin_assert(_mesh);
+  dolfin_assert(_element);
+  dolfin_assert(_dofmap);
+  const Mesh& mesh = *_mesh;
+
+  // Compute value size
+  std::size_t value_size = 1;
+  for (std::size_t i = 0; i < _element->value_rank(); ++i)
+    value_size *= _element->value_dimension(i);
+
+  const std::size_t num_vertices = mesh.num_vertices();
+  vertex_values.resize(value_size*num_vertices);
+
+  std::lock_guard<std::mutex> lock(_vertex_interpolation_mutex);
+
+  // Vertex-to-dof maps only depend on the topology, the cell
+  // interpolation matrices also on the geometry
+  if (!_has_vertex_interpolation
+      or _vertex_interpolation_topology_state != mesh.topology().state()
+      or (_vertex_to_dof.empty()
+          and _vertex_interpolation_geometry_state != mesh.geometry().state()))
+  {
+    build_vertex_interpolation();
+  }
+
+  // Access local (owned and ghost) expansion coefficients
+  const LocalVectorArray<const double> values(x, true);
+
+  if (!_vertex_to_dof.empty())
+  {
+    // Gather vertex values
+    dolfin_assert(_vertex_to_dof.size() == vertex_values.size());
+    for (std::size_t i = 0; i < _vertex_to_dof.size(); ++i)
+    {
+      dolfin_assert((std::size_t) _vertex_to_dof[i] < values.size());
+      vertex_values[i] = values[_vertex_to_dof[i]];
+    }
+    return;
+  }
+
+  // Apply the cell interpolation matrices (using last computed value
+  // if not continuous, e.g. discontinuous Galerkin methods)
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_cell_vertices = mesh.type().num_vertices(tdim);
+  const std::size_t num_rows = value_size*num_cell_vertices;
+  const std::size_t space_dim = _element->space_dimension();
+  const double* A = _vertex_interpolation.data();
+  for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
+  {
+    auto dofs = _dofmap->cell_dofs(cell->index());
+    dolfin_assert((std::size_t) dofs.size() == space_dim);
+    const unsigned int* vertices = cell->entities(0);
+    for (std::size_t v = 0; v < num_cell_vertices; ++v)
+    {
+      for (std::size_t i = 0; i < value_size; ++i)
+      {
+        const double* row = A + (v*value_size + i)*space_dim;
+        double value = 0.0;
+        for (std::size_t j = 0; j < space_dim; ++j)
+          value += row[j]*values[dofs[j]];
+        vertex_values[i*num_vertices + vertices[v]] = value;
+      }
+    }
+    A += num_rows*space_dim;
+  }
+}
+//-----------------------------------------------------------------------------
+void FunctionSpace::build_parent_interpolation(const FunctionSpace& parent) const
+{
+  dolfin_assert(_mesh);
+  dolfin_assert(_element);
+  dolfin_assert(parent.mesh());
+  dolfin_assert(parent.element());
+  const Mesh& mesh = *_mesh;
+  const Mesh& parent_mesh = *parent.mesh();
+  const std::size_t tdim = mesh.topology().dim();
+  const std::vector<std::size_t>& child_to_parent
+    = mesh.data().array("parent_cell", tdim);
+
+  // Tabulate the interpolation matrix of each cell by evaluating the
+  // dofs of the cell on each basis function of the parent cell
+  const std::size_t space_dim = _element->space_dimension();
+  const std::size_t parent_space_dim = parent.element()->space_dimension();
+  _parent_interpolation.resize(mesh.num_cells()*space_dim*parent_space_dim);
+  std::vector<double> column(space_dim);
+  std::vector<double> coordinate_dofs;
+  std::vector<double> parent_coordinate_dofs;
+  ufc::cell ufc_parent;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    cell->get_coordinate_dofs(coordinate_dofs);
+
+    // Get cell orientation
+    int cell_orientation = -1;
+    if (!mesh.cell_orientations().empty())
+    {
+      dolfin_assert(cell->index() < mesh.cell_orientations().size());
+      cell_orientation = mesh.cell_orientations()[cell->index()];
+    }
+
+    const Cell parent_cell(parent_mesh, child_to_parent[cell->index()]);
+    parent_cell.get_coordinate_dofs(parent_coordinate_dofs);
+    parent_cell.get_cell_data(ufc_parent);
+    BasisFunction phi(0, parent.element(), parent_coordinate_dofs);
+
+    double* A = _parent_interpolation.data()
+      + cell->index()*space_dim*parent_space_dim;
+    for (std::size_t j = 0; j < parent_space_dim; ++j)
+    {
+      phi.update_index(j);
+      _element->evaluate_dofs(column.data(), phi, coordinate_dofs.data(),
+                              cell_orientation, ufc_parent);
+      for (std::size_t i = 0; i < space_dim; ++i)
+        A[i*parent_space_dim + j] = column[i];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void
+FunctionSpace::build_function_interpolation(FunctionInterpolation& data,
+                                            const FunctionSpace& source) const
+{
+  dolfin_assert(_mesh);
+  dolfin_assert(_element);
+  dolfin_assert(source.element());
+  dolfin_assert(source.dofmap());
+  const Mesh& mesh = *_mesh;
+  const GenericDofMap& source_dofmap = *source.dofmap();
+
+  // Tabulate the dofs and the interpolation matrix of each owned
+  // cell by evaluating the dofs of the cell on each basis function
+  // of the source space
+  const std::size_t num_cells
+    = mesh.topology().ghost_offset(mesh.topology().dim());
+  const std::size_t space_dim = _element->space_dimension();
+  const std::size_t source_space_dim = source.element()->space_dimension();
+  data.dofs.resize(num_cells*space_dim);
+  data.source_dofs.resize(num_cells*source_space_dim);
+  data.matrices.resize(num_cells*space_dim*source_space_dim);
+  std::vector<double> column(space_dim);
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    const std::size_t c = cell->index();
+    dolfin_assert(c < num_cells);
+    cell->get_coordinate_dofs(coordinate_dofs);
+    cell->get_cell_data(ufc_cell);
+
+    auto cell_dofs = _dofmap->cell_dofs(c);
+    dolfin_assert((std::size_t) cell_dofs.size() == space_dim);
+    std::copy(cell_dofs.data(), cell_dofs.data() + space_dim,
+              data.dofs.begin() + c*space_dim);
+    auto source_cell_dofs = source_dofmap.cell_dofs(c);
+    dolfin_assert((std::size_t) source_cell_dofs.size() == source_space_dim);
+    std::copy(source_cell_dofs.data(),
+              source_cell_dofs.data() + source_space_dim,
+              data.source_dofs.begin() + c*source_space_dim);
+
+    BasisFunction phi(0, source.element(), coordinate_dofs);
+    double* A = data.matrices.data() + c*space_dim*source_space_dim;
+    for (std::size_t j = 0; j < source_space_dim; ++j)
+    {
+      phi.update_index(j);
+      _element->evaluate_dofs(column.data(), phi, coordinate_dofs.data(),
+                              ufc_cell.orientation, ufc_cell);
+      for (std::size_t i = 0; i < space_dim; ++i)
+        A[i*source_space_dim + j] = column[i];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void FunctionSpace::build_vertex_interpolation() const
+{
+  dolfin_assert(_mesh);
+  dolfin_assert(_element);
+  dolfin_assert(_dofmap);
+  const Mesh& mesh = *_mesh;
+  const FiniteElement& element = *_element;
+
+  std::size_t value_size = 1;
+  for (std::size_t i = 0; i < element.value_rank(); ++i)
+    value_size *= element.value_dimension(i);
+
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_cell_vertices = mesh.type().num_vertices(tdim);
+  const std::size_t num_rows = value_size*num_cell_vertices;
+  const std::size_t space_dim = element.space_dimension();
+
+  // Tabulate the vertex interpolation matrix of each cell by
+  // interpolating each basis function
+  _vertex_interpolation.resize(mesh.num_cells()*num_rows*space_dim);
+  std::vector<double> coefficients(space_dim, 0.0);
+  std::vector<double> cell_vertex_values(num_rows);
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+  bool is_gather = true;
+  for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
+  {
+    cell->get_coordinate_dofs(coordinate_dofs);
+    cell->get_cell_data(ufc_cell);
+
+    double* A = _vertex_interpolation.data()
+      + cell->index()*num_rows*space_dim;
+    for (std::size_t j = 0; j < space_dim; ++j)
+    {
+      coefficients[j] = 1.0;
+      element.interpolate_vertex_values(cell_vertex_values.data(),
+                                        coefficients.data(),
+                                        coordinate_dofs.data(),
+                                        ufc_cell.orientation);
+      coefficients[j] = 0.0;
+      for (std::size_t r = 0; r < num_rows; ++r)
+        A[r*space_dim + j] = cell_vertex_values[r];
+    }
+
+    // Check if every vertex value is a single dof value
+    for (std::size_t r = 0; r < num_rows and is_gather; ++r)
+    {
+      std::size_t num_unit = 0, num_zero = 0;
+      for (std::size_t j = 0; j < space_dim; ++j)
+      {
+        const double a = A[r*space_dim + j];
+        if (std::abs(a - 1.0) < DOLFIN_EPS)
+          ++num_unit;
+        else if (std::abs(a) < DOLFIN_EPS)
+          ++num_zero;
+      }
+      is_gather = (num_unit == 1 and num_zero == space_dim - 1);
+    }
+  }
+
+  // Convert to vertex-to-dof map if possible
+  _vertex_to_dof.clear();
+  if (is_gather)
+  {
+    const std::size_t num_vertices = mesh.num_vertices();
+    _vertex_to_dof.resize(value_size*num_vertices);
+    for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
+    {
+      auto dofs = _dofmap->cell_dofs(cell->index());
+      const unsigned int* vertices = cell->entities(0);
+      const double* A = _vertex_interpolation.data()
+        + cell->index()*num_rows*space_dim;
+      for (std::size_t v = 0; v < num_cell_vertices; ++v)
+      {
+        for (std::size_t i = 0; i < value_size; ++i)
+        {
+          const double* row = A + (v*value_size + i)*space_dim;
+          const std::size_t j = std::max_element(row, row + space_dim) - row;
+          _vertex_to_dof[i*num_vertices + vertices[v]] = dofs[j];
+        }
+      }
+    }
+    std::vector<double>().swap(_vertex_interpolation);
+  }
+
+  _has_vertex_interpolation = true;
+  _vertex_interpolation_topology_state = mesh.topology().state();
+  _vertex_interpolation_geometry_state = mesh.geometry().state();
+}
+//-----------------------------------------------------------------------------
 std::string FunctionSpace::str(bool verbose) const
 {
   std::stringstream s;
@@ -30,6 +30,8 @@
 #include <vector>
 
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <dolfin/common/Array.h>
 #include <dolfin/common/Variable.h>
@@ -49,6 +51,9 @@ namespace dolfin
   /// This class represents a finite element function space defined by
   /// a mesh, a finite element, and a local-to-global mapping of the
   /// degrees of freedom (dofmap).
+  ///
+  /// Const member functions, including extraction of (cached) sub
+  /// spaces, may be called from several threads at the same time.
 
   class FunctionSpace : public Variable, public Hierarchical<FunctionSpace>
   {
@@ -159,6 +164,15 @@ namespace dolfin
     /// Interpolate function v into function space, returning the
     /// vector of expansion coefficients
     ///
+    /// If v is a Function on the same mesh, the local interpolation
+    /// matrix of each cell (the dofs of this space evaluated on the
+    /// basis functions of the space of v) is computed at the first
+    /// call and cached for the space of v, so repeated interpolation
+    /// between the same spaces is a gather of the coefficients of v,
+    /// a product with the cell matrices and a scatter to the
+    /// expansion coefficients. The cache is rebuilt when the mesh
+    /// changes.
+    ///
     /// *Arguments*
     ///     expansion_coefficients (_GenericVector_)
     ///         The expansion coefficients.
@@ -223,13 +237,29 @@ namespace dolfin
     ///         True if V is contained or equal to this.
     bool contains(const FunctionSpace& V) const;
 
-    /// Collapse a subspace and return a new function space
+    /// Collapse a subspace and return a new function space. The
+    /// collapsed space is created once and cached, so repeated calls
+    /// return the same space.
     ///
     /// *Returns*
     ///     _FunctionSpace_
     ///         The new function space.
     std::shared_ptr<FunctionSpace> collapse() const;
 
+    /// Collapse a subspace and return a new function space and a map
+    /// from new to old dofs
+    ///
+    /// *Arguments*
+    ///     collapsed_dofs (std::vector<std::size_t>)
+    ///         The map from new to old dofs, indexed by the (local)
+    ///         dofs of the new space.
+    ///
+    /// *Returns*
+    ///     _FunctionSpace_
+    ///       The new function space.
+    std::shared_ptr<FunctionSpace>
+    collapse(std::vector<std::size_t>& collapsed_dofs) const;
+
     /// Collapse a subspace and return a new function space and a map
     /// from new to old dofs
     ///
@@ -306,6 +336,23 @@ namespace dolfin
     ///         The mesh.
     void set_x(GenericVector& x, double value, std::size_t component) const;
 
+    /// Compute the values at all mesh vertices of the function with
+    /// expansion coefficients x in this space. The vertex
+    /// interpolation operator is computed once and cached. Spaces
+    /// whose vertex values are degrees of freedom (e.g. P1 Lagrange)
+    /// use a vertex-to-dof map, so the values are a pure gather;
+    /// other spaces cache the interpolation matrix of each cell
+    /// (recomputed when the mesh moves).
+    ///
+    /// *Arguments*
+    ///     vertex_values (std::vector<double>)
+    ///         The values at all vertices, ordered component by
+    ///         component (as for Function::compute_vertex_values).
+    ///     x (_GenericVector_)
+    ///         The expansion coefficients (with ghost values).
+    void compute_vertex_values(std::vector<double>& vertex_values,
+                               const GenericVector& x) const;
+
     /// Return informal string representation (pretty-print)
     ///
     /// *Arguments*
@@ -331,6 +378,12 @@ namespace dolfin
     void interpolate_from_parent(GenericVector& expansion_coefficients,
                                  const GenericFunction& v) const;
 
+    // Specialised interpolate routine for a function on the same
+    // mesh, returns false if the space of u is not supported (dofmaps
+    // with a varying number of dofs per cell)
+    bool interpolate_from_function(GenericVector& expansion_coefficients,
+                                   const Function& u) const;
+
     // The mesh
     std::shared_ptr<const Mesh> _mesh;
 
@@ -350,6 +403,87 @@ namespace dolfin
     mutable std::map<std::vector<std::size_t>,
                      std::shared_ptr<FunctionSpace> > _subspaces;
 
+    // Lock for the cache of subspaces
+    mutable std::mutex _subspaces_mutex;
+
+    // Cache of collapsed space and map from its dofs to the dofs of
+    // this space
+    mutable std::shared_ptr<FunctionSpace> _collapsed_space;
+    mutable std::vector<std::size_t> _collapsed_dofs;
+
+    // Lock for the collapsed space cache
+    mutable std::mutex _collapse_mutex;
+
+    // Build (or rebuild for a changed mesh) the cached vertex
+    // interpolation operator
+    void build_vertex_interpolation() const;
+
+    // Cached vertex interpolation operator: the map from (component,
+    // vertex) to local dof if vertex values are dof values, otherwise
+    // the interpolation matrix of each cell (vertex values by cell
+    // dofs, row-major)
+    mutable std::vector<dolfin::la_index> _vertex_to_dof;
+    mutable std::vector<double> _vertex_interpolation;
+
+    // True if the vertex interpolation has been computed, and the
+    // mesh states for which it was computed
+    mutable bool _has_vertex_interpolation;
+    mutable std::size_t _vertex_interpolation_topology_state;
+    mutable std::size_t _vertex_interpolation_geometry_state;
+
+    // Lock for the vertex interpolation cache
+    mutable std::mutex _vertex_interpolation_mutex;
+
+    // Build (or rebuild for changed meshes or parent element) the
+    // cached interpolation operator from a parent space
+    void build_parent_interpolation(const FunctionSpace& parent) const;
+
+    // Cached interpolation operator from the parent space: the
+    // matrix of each cell that maps the coefficients of the parent
+    // cell to the coefficients of the cell (cell dofs by parent cell
+    // dofs, row-major)
+    mutable std::vector<double> _parent_interpolation;
+
+    // Mesh states (parent mesh id, geometry and topology states of
+    // parent mesh and mesh) and parent element signature for which
+    // the parent interpolation was computed
+    mutable std::vector<std::size_t> _parent_interpolation_state;
+    mutable std::string _parent_interpolation_signature;
+
+    // Lock for the parent interpolation cache
+    mutable std::mutex _parent_interpolation_mutex;
+
+    // Cached interpolation operator from a space on the same mesh
+    struct FunctionInterpolation
+    {
+      // Mesh states (geometry and topology) and element signature of
+      // the source space for which the operator was computed
+      std::vector<std::size_t> state;
+      std::string signature;
+
+      // Local dofs of the owned cells in the source space and in this
+      // space (cell by cell)
+      std::vector<dolfin::la_index> source_dofs;
+      std::vector<dolfin::la_index> dofs;
+
+      // Interpolation matrix of each cell (cell dofs by source cell
+      // dofs, row-major)
+      std::vector<double> matrices;
+    };
+
+    // Build (or rebuild for changed mesh) the cached interpolation
+    // operator from a space on the same mesh
+    void build_function_interpolation(FunctionInterpolation& data,
+                                      const FunctionSpace& source) const;
+
+    // Cached interpolation operators by id of the source space
+    mutable std::map<std::size_t, FunctionInterpolation>
+      _function_interpolation;
+
+    // Lock for the interpolation operators from spaces on the same
+    // mesh
+    mutable std::mutex _function_interpolation_mutex;
+
   };
 
 }
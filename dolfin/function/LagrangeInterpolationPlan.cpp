@@ -0,0 +1,299 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <ufc.h>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/fem/FiniteElement.h>
+#include <dolfin/fem/GenericDofMap.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
+#include <dolfin/geometry/Point.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include "Function.h"
+#include "FunctionSpace.h"
+#include "LagrangeInterpolator.h"
+#include "LagrangeInterpolationPlan.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+LagrangeInterpolationPlan::LagrangeInterpolationPlan(
+  std::shared_ptr<const FunctionSpace> V,
+  std::shared_ptr<const FunctionSpace> V0) : _V(V), _V0(V0)
+{
+  Timer timer("Build Lagrange interpolation plan");
+
+  dolfin_assert(_V);
+  dolfin_assert(_V0);
+  dolfin_assert(_V->element());
+  dolfin_assert(_V0->element());
+  dolfin_assert(_V0->dofmap());
+  dolfin_assert(_V->mesh());
+  dolfin_assert(_V0->mesh());
+  const FiniteElement& element = *_V->element();
+  const FiniteElement& element0 = *_V0->element();
+  const GenericDofMap& dofmap0 = *_V0->dofmap();
+  const Mesh& mesh0 = *_V0->mesh();
+
+  // Check that value shapes match
+  if (element.value_rank() != element0.value_rank())
+  {
+    dolfin_error("LagrangeInterpolationPlan.cpp",
+                 "create Lagrange interpolation plan",
+                 "Rank of source space (%d) does not match rank of target space (%d)",
+                 element0.value_rank(), element.value_rank());
+  }
+  for (std::size_t i = 0; i < element.value_rank(); ++i)
+  {
+    if (element.value_dimension(i) != element0.value_dimension(i))
+    {
+      dolfin_error("LagrangeInterpolationPlan.cpp",
+                   "create Lagrange interpolation plan",
+                   "Dimension %d of source space (%d) does not match dimension %d of target space (%d)",
+                   i, element0.value_dimension(i), i,
+                   element.value_dimension(i));
+    }
+  }
+  _value_size = 1;
+  for (std::size_t i = 0; i < element.value_rank(); ++i)
+    _value_size *= element.value_dimension(i);
+
+  const MPI_Comm mpi_comm = _V->mesh()->mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  const std::size_t gdim = mesh0.geometry().dim();
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+
+  // Collect the different interpolation points of the owned dofs of
+  // V, and the dofs (and their components) sharing each point
+  const std::map<std::vector<double>, std::vector<std::size_t>,
+                 LagrangeInterpolator::lt_coordinate>
+    coords_to_dofs = LagrangeInterpolator::tabulate_coordinates_to_dofs(*_V);
+  std::unordered_map<std::size_t, std::size_t> dof_component_map;
+  int component = -1;
+  LagrangeInterpolator::extract_dof_component_map(dof_component_map, *_V,
+                                                  &component);
+
+  std::vector<double> x;
+  x.reserve(coords_to_dofs.size()*gdim);
+  _point_dofs_offsets.assign(1, 0);
+  for (auto it = coords_to_dofs.begin(); it != coords_to_dofs.end(); ++it)
+  {
+    x.insert(x.end(), it->first.begin(), it->first.end());
+    for (auto d = it->second.begin(); d != it->second.end(); ++d)
+    {
+      _point_dofs.push_back(*d);
+      _point_dofs_components.push_back(dof_component_map[*d]);
+    }
+    _point_dofs_offsets.push_back(_point_dofs.size());
+  }
+  const std::size_t num_points = coords_to_dofs.size();
+
+  // Send each point to the processes whose part of the source mesh
+  // may contain it
+  std::shared_ptr<BoundingBoxTree> tree = mesh0.bounding_box_tree();
+  std::vector<std::vector<double>> send_x(num_processes);
+  std::vector<std::vector<std::size_t>> send_points(num_processes);
+  for (std::size_t p = 0; p < num_points; ++p)
+  {
+    const Point point(gdim, x.data() + p*gdim);
+    const std::vector<unsigned int> ranks
+      = tree->compute_process_collisions(point);
+    for (auto r = ranks.begin(); r != ranks.end(); ++r)
+    {
+      send_x[*r].insert(send_x[*r].end(), x.begin() + p*gdim,
+                        x.begin() + (p + 1)*gdim);
+      send_points[*r].push_back(p);
+    }
+  }
+  std::vector<std::vector<double>> recv_x;
+  MPI::all_to_all(mpi_comm, send_x, recv_x);
+
+  // Locate received points in the source mesh
+  std::vector<std::vector<unsigned int>> recv_cells(num_processes);
+  std::vector<std::vector<int>> send_found(num_processes);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    const std::size_t n = recv_x[r].size()/gdim;
+    recv_cells[r].resize(n);
+    send_found[r].resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const Point point(gdim, recv_x[r].data() + i*gdim);
+      recv_cells[r][i] = tree->compute_first_entity_collision(point);
+      send_found[r][i] = (recv_cells[r][i] != not_found);
+    }
+  }
+  std::vector<std::vector<int>> recv_found;
+  MPI::all_to_all(mpi_comm, send_found, recv_found);
+
+  // Choose the lowest rank that found a point as its owner. Points
+  // that are not found anywhere are not interpolated.
+  std::vector<std::size_t> owner(num_points, num_processes);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    dolfin_assert(recv_found[r].size() == send_points[r].size());
+    for (std::size_t i = 0; i < send_points[r].size(); ++i)
+    {
+      const std::size_t p = send_points[r][i];
+      if (recv_found[r][i] and owner[p] == num_processes)
+        owner[p] = r;
+    }
+  }
+
+  // Tell the processes which of the points they own
+  _requests.resize(num_processes);
+  std::vector<std::vector<int>> send_keep(num_processes);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    send_keep[r].resize(send_points[r].size());
+    for (std::size_t i = 0; i < send_points[r].size(); ++i)
+    {
+      const std::size_t p = send_points[r][i];
+      send_keep[r][i] = (owner[p] == r);
+      if (send_keep[r][i])
+        _requests[r].push_back(p);
+    }
+  }
+  std::vector<std::vector<int>> recv_keep;
+  MPI::all_to_all(mpi_comm, send_keep, recv_keep);
+
+  // Tabulate source basis functions at owned points, ordered by
+  // requesting process
+  const std::size_t space_dim = element0.space_dimension();
+  std::vector<double> basis(space_dim*_value_size);
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+  std::unordered_map<dolfin::la_index, std::size_t> source_positions;
+  _offsets.assign(num_processes + 1, 0);
+  _row_offsets.assign(1, 0);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    _offsets[r + 1] = _offsets[r];
+    for (std::size_t i = 0; i < recv_keep[r].size(); ++i)
+    {
+      if (!recv_keep[r][i])
+        continue;
+      ++_offsets[r + 1];
+
+      // Evaluate basis at point
+      const Cell cell(mesh0, recv_cells[r][i]);
+      cell.get_coordinate_dofs(coordinate_dofs);
+      cell.get_cell_data(ufc_cell);
+      element0.evaluate_basis_all(basis.data(), recv_x[r].data() + i*gdim,
+                                  coordinate_dofs.data(),
+                                  ufc_cell.orientation);
+
+      // Map cell dofs to positions in list of source dofs
+      auto cell_dofs = dofmap0.cell_dofs(cell.index());
+      std::vector<std::size_t> positions(space_dim);
+      for (std::size_t k = 0; k < space_dim; ++k)
+      {
+        auto ins = source_positions.insert(
+          std::make_pair(cell_dofs[k], _source_dofs.size()));
+        if (ins.second)
+          _source_dofs.push_back(cell_dofs[k]);
+        positions[k] = ins.first->second;
+      }
+
+      // Add one row per value component, skipping zero weights
+      for (std::size_t j = 0; j < _value_size; ++j)
+      {
+        for (std::size_t k = 0; k < space_dim; ++k)
+        {
+          const double w = basis[k*_value_size + j];
+          if (w != 0.0)
+          {
+            _columns.push_back(positions[k]);
+            _weights.push_back(w);
+          }
+        }
+        _row_offsets.push_back(_columns.size());
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void LagrangeInterpolationPlan::interpolate(Function& u,
+                                            const Function& u0) const
+{
+  Timer timer("Interpolate using Lagrange interpolation plan");
+
+  // Check function spaces
+  if (!u.in(*_V) or !u0.in(*_V0))
+  {
+    dolfin_error("LagrangeInterpolationPlan.cpp",
+                 "interpolate function",
+                 "Functions are not in the function spaces of the interpolation plan");
+  }
+
+  // Get local (including ghost) values of source function
+  dolfin_assert(u0.vector());
+  std::vector<double> w(_source_dofs.size());
+  u0.vector()->get_local(w.data(), _source_dofs.size(), _source_dofs.data());
+
+  // Evaluate at owned points (sparse matrix-vector product)
+  const std::size_t num_processes = _requests.size();
+  std::vector<std::vector<double>> send_values(num_processes);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    const std::size_t row_begin = _offsets[r]*_value_size;
+    const std::size_t row_end = _offsets[r + 1]*_value_size;
+    send_values[r].resize(row_end - row_begin);
+    for (std::size_t row = row_begin; row < row_end; ++row)
+    {
+      double value = 0.0;
+      for (std::size_t k = _row_offsets[row]; k < _row_offsets[row + 1]; ++k)
+        value += _weights[k]*w[_columns[k]];
+      send_values[r][row - row_begin] = value;
+    }
+  }
+
+  // Return values to requesting processes
+  std::vector<std::vector<double>> recv_values;
+  dolfin_assert(_V->mesh());
+  MPI::all_to_all(_V->mesh()->mpi_comm(), send_values, recv_values);
+
+  // Place values at the dofs of each point
+  dolfin_assert(u.vector());
+  std::vector<double> local_u_vector(u.vector()->local_size());
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    dolfin_assert(recv_values[r].size() == _requests[r].size()*_value_size);
+    for (std::size_t i = 0; i < _requests[r].size(); ++i)
+    {
+      const std::size_t p = _requests[r][i];
+      for (std::size_t k = _point_dofs_offsets[p];
+           k < _point_dofs_offsets[p + 1]; ++k)
+      {
+        dolfin_assert((std::size_t) _point_dofs[k] < local_u_vector.size());
+        local_u_vector[_point_dofs[k]]
+          = recv_values[r][i*_value_size + _point_dofs_components[k]];
+      }
+    }
+  }
+
+  // Set and finalize
+  u.vector()->set_local(local_u_vector);
+  u.vector()->apply("insert");
+}
+//-----------------------------------------------------------------------------
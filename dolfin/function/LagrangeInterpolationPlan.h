@@ -0,0 +1,100 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __LAGRANGE_INTERPOLATION_PLAN_H
+#define __LAGRANGE_INTERPOLATION_PLAN_H
+
+#include <memory>
+#include <vector>
+#include <dolfin/common/types.h>
+
+namespace dolfin
+{
+
+  class Function;
+  class FunctionSpace;
+
+  /// This class precomputes the interpolation of Functions from one
+  /// function space to a Lagrange function space on a possibly
+  /// non-matching (and differently distributed) mesh, see
+  /// LagrangeInterpolator. The interpolation points of the target
+  /// space are located once on the source mesh, the source basis
+  /// functions are tabulated at the points and the routing of values
+  /// between processes is stored. Each interpolation is then a
+  /// sparse matrix-vector product followed by one all-to-all
+  /// exchange.
+
+  class LagrangeInterpolationPlan
+  {
+  public:
+
+    /// Create interpolation plan (collective)
+    ///
+    /// @param    V (_FunctionSpace_)
+    ///         The (Lagrange) function space to interpolate to.
+    /// @param    V0 (_FunctionSpace_)
+    ///         The function space to interpolate from.
+    LagrangeInterpolationPlan(std::shared_ptr<const FunctionSpace> V,
+                              std::shared_ptr<const FunctionSpace> V0);
+
+    /// Interpolate function (collective)
+    ///
+    /// @param    u (_Function_)
+    ///         The resulting Function, in the space V of the plan.
+    /// @param    u0 (_Function_)
+    ///         The Function to be interpolated, in the space V0 of
+    ///         the plan.
+    void interpolate(Function& u, const Function& u0) const;
+
+  private:
+
+    // Function spaces to interpolate to and from
+    std::shared_ptr<const FunctionSpace> _V;
+    std::shared_ptr<const FunctionSpace> _V0;
+
+    // Value size
+    std::size_t _value_size;
+
+    // Owned dofs of V at each local interpolation point (CSR
+    // layout), and the value component of each dof
+    std::vector<std::size_t> _point_dofs_offsets;
+    std::vector<dolfin::local_index> _point_dofs;
+    std::vector<dolfin::local_index> _point_dofs_components;
+
+    // Local indices of interpolation points evaluated by each
+    // process, in the order in which that process returns values
+    std::vector<std::vector<dolfin::local_index>> _requests;
+
+    // Number of points evaluated on this process for each requesting
+    // process (offsets)
+    std::vector<std::size_t> _offsets;
+
+    // Local dofs of V0 needed to evaluate points on this process
+    std::vector<dolfin::la_index> _source_dofs;
+
+    // Interpolation matrix (CSR layout) with one row per evaluated
+    // point and value component, and columns referring to
+    // _source_dofs
+    std::vector<std::size_t> _row_offsets;
+    std::vector<dolfin::local_index> _columns;
+    std::vector<double> _weights;
+
+  };
+
+}
+
+#endif
@@ -59,6 +59,9 @@ namespace dolfin
 
   private:
 
+    // The interpolation plan reuses the tabulation functions below
+    friend class LagrangeInterpolationPlan;
+
     // Comparison operator for hashing coordinates. Note that two
     // coordinates are considered equal if equal to within specified
     // tolerance.
@@ -0,0 +1,462 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <Eigen/Dense>
+#include <ufc.h>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/fem/FiniteElement.h>
+#include <dolfin/fem/GenericDofMap.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
+#include <dolfin/geometry/Point.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshEntityIterator.h>
+#include <dolfin/mesh/Vertex.h>
+#include "Function.h"
+#include "FunctionSpace.h"
+#include "Particles.h"
+
+using namespace dolfin;
+
+namespace
+{
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                        Eigen::RowMajor> EigenRowMatrixXd;
+
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+}
+
+//-----------------------------------------------------------------------------
+Particles::Particles(std::shared_ptr<const Mesh> mesh)
+  : Variable("particles", "unnamed particles"), _mesh(mesh),
+    _cell_index_valid(false)
+{
+  dolfin_assert(_mesh);
+
+  // Build bounding box tree (collective) and vertex-cell connectivity
+  // for walking to neighbouring cells
+  _mesh->bounding_box_tree();
+  _mesh->init(0, _mesh->topology().dim());
+}
+//-----------------------------------------------------------------------------
+Particles::~Particles()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::size_t Particles::add_property(std::string name, std::size_t value_size)
+{
+  if (std::find(_names.begin(), _names.end(), name) != _names.end())
+  {
+    dolfin_error("Particles.cpp",
+                 "add particle property",
+                 "Property \"%s\" already exists", name.c_str());
+  }
+
+  _names.push_back(name);
+  _value_sizes.push_back(value_size);
+  _values.push_back(std::vector<double>(num_particles()*value_size, 0.0));
+  return _values.size() - 1;
+}
+//-----------------------------------------------------------------------------
+std::size_t Particles::property(std::string name) const
+{
+  auto it = std::find(_names.begin(), _names.end(), name);
+  if (it == _names.end())
+  {
+    dolfin_error("Particles.cpp",
+                 "access particle property",
+                 "Unknown property \"%s\"", name.c_str());
+  }
+  return it - _names.begin();
+}
+//-----------------------------------------------------------------------------
+void Particles::add_particles(const std::vector<double>& x)
+{
+  const std::size_t gdim = _mesh->geometry().dim();
+  if (x.size() % gdim != 0)
+  {
+    dolfin_error("Particles.cpp",
+                 "add particles",
+                 "Size of coordinate array (%d) is not a multiple of the geometric dimension (%d)",
+                 (int) x.size(), (int) gdim);
+  }
+
+  // Append particles with zero properties and locate them
+  const std::size_t begin = num_particles();
+  const std::size_t n = x.size()/gdim;
+  _x.insert(_x.end(), x.begin(), x.end());
+  _cells.resize(begin + n, not_found);
+  for (std::size_t k = 0; k < _values.size(); ++k)
+    _values[k].resize((begin + n)*_value_sizes[k], 0.0);
+  locate(begin);
+}
+//-----------------------------------------------------------------------------
+std::size_t Particles::relocate()
+{
+  Timer timer("Relocate particles");
+  return locate(0);
+}
+//-----------------------------------------------------------------------------
+const std::vector<std::size_t>& Particles::cell_offsets() const
+{
+  if (!_cell_index_valid)
+    build_cell_index();
+  return _cell_offsets;
+}
+//-----------------------------------------------------------------------------
+const std::vector<std::size_t>& Particles::cell_particles() const
+{
+  if (!_cell_index_valid)
+    build_cell_index();
+  return _cell_particles;
+}
+//-----------------------------------------------------------------------------
+void Particles::interpolate(const Function& u, std::size_t property)
+{
+  dolfin_assert(u.function_space());
+  dolfin_assert(u.function_space()->mesh());
+  if (u.function_space()->mesh()->id() != _mesh->id())
+  {
+    dolfin_error("Particles.cpp",
+                 "interpolate function to particles",
+                 "Function is not defined on the mesh of the particles");
+  }
+  const std::size_t value_size = u.value_size();
+  if (value_size != _value_sizes[property])
+  {
+    dolfin_error("Particles.cpp",
+                 "interpolate function to particles",
+                 "Value size of function (%d) differs from that of property \"%s\" (%d)",
+                 (int) value_size, _names[property].c_str(),
+                 (int) _value_sizes[property]);
+  }
+
+  const std::size_t n = num_particles();
+  if (n == 0)
+    return;
+
+  // Evaluate in bulk, with the particle cells as (exact) hints
+  const std::size_t gdim = _mesh->geometry().dim();
+  Eigen::Map<const EigenRowMatrixXd> x(_x.data(), n, gdim);
+  Eigen::Map<EigenRowMatrixXd> values(_values[property].data(), n,
+                                      value_size);
+  std::vector<unsigned int> cells(_cells);
+  u.eval(values, x, cells);
+}
+//-----------------------------------------------------------------------------
+void Particles::project(Function& u, std::size_t property) const
+{
+  Timer timer("Project particle property");
+
+  dolfin_assert(u.function_space());
+  dolfin_assert(u.function_space()->mesh());
+  const FunctionSpace& V = *u.function_space();
+  if (V.mesh()->id() != _mesh->id())
+  {
+    dolfin_error("Particles.cpp",
+                 "project particle property to function",
+                 "Function is not defined on the mesh of the particles");
+  }
+  const std::size_t value_size = u.value_size();
+  if (value_size != _value_sizes[property])
+  {
+    dolfin_error("Particles.cpp",
+                 "project particle property to function",
+                 "Value size of function (%d) differs from that of property \"%s\" (%d)",
+                 (int) value_size, _names[property].c_str(),
+                 (int) _value_sizes[property]);
+  }
+
+  dolfin_assert(V.element());
+  dolfin_assert(V.dofmap());
+  const FiniteElement& element = *V.element();
+  const GenericDofMap& dofmap = *V.dofmap();
+  const std::size_t space_dim = element.space_dimension();
+  const std::vector<double>& values = _values[property];
+  const std::size_t gdim = _mesh->geometry().dim();
+
+  // Accumulate basis weighted values and weights of particles
+  dolfin_assert(u.vector());
+  GenericVector& b = *u.vector();
+  std::shared_ptr<GenericVector> w = b.copy();
+  b.zero();
+  w->zero();
+
+  const std::vector<std::size_t>& offsets = cell_offsets();
+  const std::vector<std::size_t>& particles = cell_particles();
+  std::vector<double> basis(space_dim*value_size);
+  std::vector<double> b_cell(space_dim), w_cell(space_dim);
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+  for (std::size_t c = 0; c + 1 < offsets.size(); ++c)
+  {
+    if (offsets[c] == offsets[c + 1])
+      continue;
+
+    const Cell cell(*_mesh, c);
+    cell.get_coordinate_dofs(coordinate_dofs);
+    cell.get_cell_data(ufc_cell);
+    std::fill(b_cell.begin(), b_cell.end(), 0.0);
+    std::fill(w_cell.begin(), w_cell.end(), 0.0);
+    for (std::size_t k = offsets[c]; k < offsets[c + 1]; ++k)
+    {
+      const std::size_t p = particles[k];
+      element.evaluate_basis_all(basis.data(), _x.data() + p*gdim,
+                                 coordinate_dofs.data(),
+                                 ufc_cell.orientation);
+      for (std::size_t i = 0; i < space_dim; ++i)
+      {
+        for (std::size_t j = 0; j < value_size; ++j)
+        {
+          const double phi = basis[i*value_size + j];
+          b_cell[i] += phi*values[p*value_size + j];
+          w_cell[i] += phi;
+        }
+      }
+    }
+
+    auto dofs = dofmap.cell_dofs(c);
+    b.add_local(b_cell.data(), dofs.size(), dofs.data());
+    w->add_local(w_cell.data(), dofs.size(), dofs.data());
+  }
+  b.apply("add");
+  w->apply("add");
+
+  // Divide by weights
+  std::vector<double> b_values, w_values;
+  b.get_local(b_values);
+  w->get_local(w_values);
+  for (std::size_t i = 0; i < b_values.size(); ++i)
+    b_values[i] = (w_values[i] > 0.0) ? b_values[i]/w_values[i] : 0.0;
+  b.set_local(b_values);
+  b.apply("insert");
+}
+//-----------------------------------------------------------------------------
+unsigned int Particles::find_cell(const Point& point, unsigned int hint) const
+{
+  const Mesh& mesh = *_mesh;
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_owned_cells = mesh.topology().ghost_offset(tdim);
+
+  // Try hint and its vertex neighbours (particles usually move by
+  // less than a cell between relocations)
+  if (hint < num_owned_cells)
+  {
+    const Cell cell(mesh, hint);
+    if (cell.collides(point))
+      return hint;
+    for (VertexIterator v(cell); !v.end(); ++v)
+    {
+      for (std::size_t i = 0; i < v->num_entities(tdim); ++i)
+      {
+        const unsigned int c = v->entities(tdim)[i];
+        if (c != hint and c < num_owned_cells
+            and Cell(mesh, c).collides(point))
+        {
+          return c;
+        }
+      }
+    }
+  }
+
+  // Fall back to bounding box tree search (skipping ghost cells)
+  const std::vector<unsigned int> cells
+    = mesh.bounding_box_tree()->compute_entity_collisions(point);
+  for (std::size_t i = 0; i < cells.size(); ++i)
+    if (cells[i] < num_owned_cells)
+      return cells[i];
+
+  return not_found;
+}
+//-----------------------------------------------------------------------------
+std::size_t Particles::locate(std::size_t begin)
+{
+  const std::size_t gdim = _mesh->geometry().dim();
+  std::vector<std::size_t> outgoing;
+  for (std::size_t p = begin; p < num_particles(); ++p)
+  {
+    _cells[p] = find_cell(Point(gdim, _x.data() + p*gdim), _cells[p]);
+    if (_cells[p] == not_found)
+      outgoing.push_back(p);
+  }
+  _cell_index_valid = false;
+
+  return migrate(outgoing);
+}
+//-----------------------------------------------------------------------------
+std::size_t Particles::migrate(const std::vector<std::size_t>& outgoing)
+{
+  const MPI_Comm mpi_comm = _mesh->mpi_comm();
+  const int rank = MPI::rank(mpi_comm);
+  const std::size_t gdim = _mesh->geometry().dim();
+  std::shared_ptr<BoundingBoxTree> tree = _mesh->bounding_box_tree();
+
+  // Ask the other processes whose bounding box contains a particle
+  // whether they own a cell containing it
+  std::map<int, std::vector<double>> send_x;
+  std::map<int, std::vector<std::size_t>> send_particles;
+  for (std::size_t i = 0; i < outgoing.size(); ++i)
+  {
+    const std::size_t p = outgoing[i];
+    const std::vector<unsigned int> ranks
+      = tree->compute_process_collisions(Point(gdim, _x.data() + p*gdim));
+    for (std::size_t j = 0; j < ranks.size(); ++j)
+    {
+      if ((int) ranks[j] == rank)
+        continue;
+      std::vector<double>& x = send_x[ranks[j]];
+      x.insert(x.end(), _x.begin() + p*gdim, _x.begin() + (p + 1)*gdim);
+      send_particles[ranks[j]].push_back(p);
+    }
+  }
+  std::map<int, std::vector<double>> recv_x;
+  MPI::sparse_all_to_all(mpi_comm, send_x, recv_x);
+
+  std::map<int, std::vector<int>> send_found;
+  for (auto q = recv_x.begin(); q != recv_x.end(); ++q)
+  {
+    const std::size_t n = q->second.size()/gdim;
+    std::vector<int>& found = send_found[q->first];
+    found.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const Point point(gdim, q->second.data() + i*gdim);
+      found[i] = (find_cell(point, not_found) != not_found);
+    }
+  }
+  std::map<int, std::vector<int>> recv_found;
+  MPI::sparse_all_to_all(mpi_comm, send_found, recv_found);
+
+  // Send each particle (position followed by all properties) to the
+  // lowest rank that owns a cell containing it
+  std::map<std::size_t, int> owner;
+  for (auto q = recv_found.begin(); q != recv_found.end(); ++q)
+  {
+    const std::vector<std::size_t>& particles = send_particles[q->first];
+    dolfin_assert(q->second.size() == particles.size());
+    for (std::size_t i = 0; i < particles.size(); ++i)
+    {
+      if (!q->second[i])
+        continue;
+      auto it = owner.find(particles[i]);
+      if (it == owner.end())
+        owner[particles[i]] = q->first;
+      else
+        it->second = std::min(it->second, q->first);
+    }
+  }
+  std::size_t data_size = gdim;
+  for (std::size_t k = 0; k < _value_sizes.size(); ++k)
+    data_size += _value_sizes[k];
+  std::map<int, std::vector<double>> send_data;
+  for (auto it = owner.begin(); it != owner.end(); ++it)
+  {
+    const std::size_t p = it->first;
+    std::vector<double>& data = send_data[it->second];
+    data.insert(data.end(), _x.begin() + p*gdim, _x.begin() + (p + 1)*gdim);
+    for (std::size_t k = 0; k < _values.size(); ++k)
+    {
+      const std::size_t vs = _value_sizes[k];
+      data.insert(data.end(), _values[k].begin() + p*vs,
+                  _values[k].begin() + (p + 1)*vs);
+    }
+  }
+  std::map<int, std::vector<double>> recv_data;
+  MPI::sparse_all_to_all(mpi_comm, send_data, recv_data);
+
+  // Remove outgoing particles, keeping the order of the others
+  std::vector<bool> keep(num_particles(), true);
+  for (std::size_t i = 0; i < outgoing.size(); ++i)
+    keep[outgoing[i]] = false;
+  std::size_t n = 0;
+  for (std::size_t p = 0; p < keep.size(); ++p)
+  {
+    if (!keep[p])
+      continue;
+    std::copy(_x.begin() + p*gdim, _x.begin() + (p + 1)*gdim,
+              _x.begin() + n*gdim);
+    _cells[n] = _cells[p];
+    for (std::size_t k = 0; k < _values.size(); ++k)
+    {
+      const std::size_t vs = _value_sizes[k];
+      std::copy(_values[k].begin() + p*vs, _values[k].begin() + (p + 1)*vs,
+                _values[k].begin() + n*vs);
+    }
+    ++n;
+  }
+
+  // Append received particles
+  std::size_t num_received = 0;
+  for (auto q = recv_data.begin(); q != recv_data.end(); ++q)
+    num_received += q->second.size()/data_size;
+  _x.resize((n + num_received)*gdim);
+  _cells.resize(n + num_received);
+  for (std::size_t k = 0; k < _values.size(); ++k)
+    _values[k].resize((n + num_received)*_value_sizes[k]);
+  for (auto q = recv_data.begin(); q != recv_data.end(); ++q)
+  {
+    const std::vector<double>& data = q->second;
+    for (std::size_t pos = 0; pos < data.size(); pos += data_size, ++n)
+    {
+      std::copy(data.begin() + pos, data.begin() + pos + gdim,
+                _x.begin() + n*gdim);
+      _cells[n] = find_cell(Point(gdim, data.data() + pos), not_found);
+      dolfin_assert(_cells[n] != not_found);
+      std::size_t offset = pos + gdim;
+      for (std::size_t k = 0; k < _values.size(); ++k)
+      {
+        const std::size_t vs = _value_sizes[k];
+        std::copy(data.begin() + offset, data.begin() + offset + vs,
+                  _values[k].begin() + n*vs);
+        offset += vs;
+      }
+    }
+  }
+  _cell_index_valid = false;
+
+  // Number of particles that have left the domain
+  return outgoing.size() - owner.size();
+}
+//-----------------------------------------------------------------------------
+void Particles::build_cell_index() const
+{
+  // Counting sort of particles by cell
+  const std::size_t tdim = _mesh->topology().dim();
+  const std::size_t num_owned_cells = _mesh->topology().ghost_offset(tdim);
+  _cell_offsets.assign(num_owned_cells + 1, 0);
+  for (std::size_t p = 0; p < _cells.size(); ++p)
+    ++_cell_offsets[_cells[p] + 1];
+  for (std::size_t c = 0; c < num_owned_cells; ++c)
+    _cell_offsets[c + 1] += _cell_offsets[c];
+
+  _cell_particles.resize(_cells.size());
+  std::vector<std::size_t> position(_cell_offsets.begin(),
+                                    _cell_offsets.end() - 1);
+  for (std::size_t p = 0; p < _cells.size(); ++p)
+    _cell_particles[position[_cells[p]]++] = p;
+
+  _cell_index_valid = true;
+}
+//-----------------------------------------------------------------------------
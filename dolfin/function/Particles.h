@@ -0,0 +1,195 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __PARTICLES_H
+#define __PARTICLES_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin/common/Variable.h>
+
+namespace dolfin
+{
+
+  class Function;
+  class Mesh;
+  class Point;
+
+  /// This class stores particles on a distributed mesh, e.g. for
+  /// particle-in-cell methods or Lagrangian tracking. Each process
+  /// stores the particles inside its owned cells, with the cell of
+  /// each particle and any number of named properties (each with a
+  /// fixed number of components per particle). Positions and
+  /// properties are stored as separate contiguous arrays (num_particles
+  /// x components, row-wise).
+  ///
+  /// After the positions have been changed, relocate() finds the new
+  /// cells by walking from the previous cell to its neighbours, and
+  /// migrates particles that have left the local part of the mesh to
+  /// the processes whose cells contain them (using a sparse exchange
+  /// with the processes whose bounding box contains the particles).
+  /// Particles that leave the domain are removed.
+
+  class Particles : public Variable
+  {
+  public:
+
+    /// Create empty particle container on mesh (collective)
+    ///
+    /// @param    mesh (_Mesh_)
+    ///         The mesh.
+    explicit Particles(std::shared_ptr<const Mesh> mesh);
+
+    /// Destructor
+    ~Particles();
+
+    /// Add property with given number of components (values of
+    /// existing particles are set to zero)
+    ///
+    /// @param    name (std::string)
+    ///         Name of the property.
+    /// @param    value_size (std::size_t)
+    ///         Number of components per particle.
+    ///
+    /// @return std::size_t
+    ///         Index of the property.
+    std::size_t add_property(std::string name, std::size_t value_size);
+
+    /// Return index of property with given name
+    std::size_t property(std::string name) const;
+
+    /// Return number of properties
+    std::size_t num_properties() const
+    { return _values.size(); }
+
+    /// Return number of components of property
+    std::size_t value_size(std::size_t property) const
+    { return _value_sizes[property]; }
+
+    /// Add particles (collective). Each process may give any points,
+    /// which are moved to the process that owns the cell containing
+    /// them. Points outside the domain are ignored. The properties
+    /// of new particles are zero.
+    ///
+    /// @param    x (std::vector<double>)
+    ///         The coordinates (num_points x gdim, row-wise).
+    void add_particles(const std::vector<double>& x);
+
+    /// Find cells of particles after their positions have been
+    /// changed, and migrate particles to other processes if needed
+    /// (collective)
+    ///
+    /// @return std::size_t
+    ///         The number of particles on this process that have
+    ///         left the domain and been removed.
+    std::size_t relocate();
+
+    /// Return number of particles on this process
+    std::size_t num_particles() const
+    { return _cells.size(); }
+
+    /// Return positions of particles on this process (num_particles x
+    /// gdim). Call relocate() after changing positions.
+    std::vector<double>& positions()
+    { return _x; }
+
+    /// Return positions of particles on this process (const version)
+    const std::vector<double>& positions() const
+    { return _x; }
+
+    /// Return values of property (num_particles x value_size)
+    std::vector<double>& values(std::size_t property)
+    { return _values[property]; }
+
+    /// Return values of property (const version)
+    const std::vector<double>& values(std::size_t property) const
+    { return _values[property]; }
+
+    /// Return (local) cell of each particle
+    const std::vector<unsigned int>& cells() const
+    { return _cells; }
+
+    /// Return offsets into cell_particles() of the particles of each
+    /// owned cell, i.e. the particles of cell c are
+    /// cell_particles()[cell_offsets()[c]:cell_offsets()[c + 1]]
+    const std::vector<std::size_t>& cell_offsets() const;
+
+    /// Return particles ordered by cell (see cell_offsets())
+    const std::vector<std::size_t>& cell_particles() const;
+
+    /// Interpolate function to particles
+    ///
+    /// @param    u (_Function_)
+    ///         The function (on the mesh of the particles).
+    /// @param    property (std::size_t)
+    ///         The property, with the value size of u.
+    void interpolate(const Function& u, std::size_t property);
+
+    /// Project property to function (collective). Each dof value is
+    /// the average of the property over the particles in the support
+    /// of its basis function, weighted by the basis function (for
+    /// piecewise linears this is area weighting, or cloud-in-cell).
+    /// Dofs without particles in their support are set to zero.
+    ///
+    /// @param    u (_Function_)
+    ///         The function (in a Lagrange or discontinuous Lagrange
+    ///         space on the mesh of the particles).
+    /// @param    property (std::size_t)
+    ///         The property, with the value size of u.
+    void project(Function& u, std::size_t property) const;
+
+  private:
+
+    // Find owned cell containing point, trying hint and its vertex
+    // neighbours first
+    unsigned int find_cell(const Point& point, unsigned int hint) const;
+
+    // Find cells of particles from begin, and migrate particles not
+    // found on this process. Returns number of particles removed.
+    std::size_t locate(std::size_t begin);
+
+    // Send particles to processes that own their cell and receive
+    // particles from other processes
+    std::size_t migrate(const std::vector<std::size_t>& outgoing);
+
+    // Build the per-cell index
+    void build_cell_index() const;
+
+    // The mesh
+    std::shared_ptr<const Mesh> _mesh;
+
+    // Positions and cells of particles
+    std::vector<double> _x;
+    std::vector<unsigned int> _cells;
+
+    // Values of properties, and their names and value sizes
+    std::vector<std::vector<double>> _values;
+    std::vector<std::string> _names;
+    std::vector<std::size_t> _value_sizes;
+
+    // Per-cell index (built on demand)
+    mutable bool _cell_index_valid;
+    mutable std::vector<std::size_t> _cell_offsets;
+    mutable std::vector<std::size_t> _cell_particles;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,201 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <limits>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
+#include <dolfin/geometry/Point.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Mesh.h>
+#include "Function.h"
+#include "FunctionSpace.h"
+#include "PointEvaluator.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+PointEvaluator::PointEvaluator(std::shared_ptr<const Mesh> mesh,
+                               const std::vector<double>& x) : _mesh(mesh)
+{
+  Timer timer("Build point evaluation plan");
+
+  dolfin_assert(_mesh);
+  const MPI_Comm mpi_comm = _mesh->mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  const std::size_t gdim = _mesh->geometry().dim();
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+
+  if (x.size() % gdim != 0)
+  {
+    dolfin_error("PointEvaluator.cpp",
+                 "create point evaluator",
+                 "Size of coordinate array (%d) is not a multiple of the geometric dimension (%d)",
+                 (int) x.size(), (int) gdim);
+  }
+  _num_points = x.size()/gdim;
+
+  // Send each point to the processes whose bounding box contains it
+  std::shared_ptr<BoundingBoxTree> tree = _mesh->bounding_box_tree();
+  std::vector<std::vector<double>> send_x(num_processes);
+  std::vector<std::vector<std::size_t>> send_points(num_processes);
+  for (std::size_t p = 0; p < _num_points; ++p)
+  {
+    const Point point(gdim, x.data() + p*gdim);
+    const std::vector<unsigned int> ranks
+      = tree->compute_process_collisions(point);
+    for (auto r = ranks.begin(); r != ranks.end(); ++r)
+    {
+      send_x[*r].insert(send_x[*r].end(), x.begin() + p*gdim,
+                        x.begin() + (p + 1)*gdim);
+      send_points[*r].push_back(p);
+    }
+  }
+  std::vector<std::vector<double>> recv_x;
+  MPI::all_to_all(mpi_comm, send_x, recv_x);
+
+  // Locate received points on local mesh
+  std::vector<std::vector<unsigned int>> recv_cells(num_processes);
+  std::vector<std::vector<int>> send_found(num_processes);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    const std::size_t n = recv_x[r].size()/gdim;
+    recv_cells[r].resize(n);
+    send_found[r].resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const Point point(gdim, recv_x[r].data() + i*gdim);
+      recv_cells[r][i] = tree->compute_first_entity_collision(point);
+      send_found[r][i] = (recv_cells[r][i] != not_found);
+    }
+  }
+  std::vector<std::vector<int>> recv_found;
+  MPI::all_to_all(mpi_comm, send_found, recv_found);
+
+  // Choose the lowest rank that found a point as its owner
+  std::vector<std::size_t> owner(_num_points, num_processes);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    dolfin_assert(recv_found[r].size() == send_points[r].size());
+    for (std::size_t i = 0; i < send_points[r].size(); ++i)
+    {
+      const std::size_t p = send_points[r][i];
+      if (recv_found[r][i] and owner[p] == num_processes)
+        owner[p] = r;
+    }
+  }
+
+  // Check that all points have been found
+  std::size_t num_missing = 0;
+  for (std::size_t p = 0; p < _num_points; ++p)
+    num_missing += (owner[p] == num_processes);
+  num_missing = MPI::sum(mpi_comm, num_missing);
+  if (num_missing > 0)
+  {
+    dolfin_error("PointEvaluator.cpp",
+                 "create point evaluator",
+                 "%d point(s) are not inside the domain",
+                 (int) num_missing);
+  }
+
+  // Tell the processes which of the points they own
+  _requests.resize(num_processes);
+  std::vector<std::vector<int>> send_keep(num_processes);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    send_keep[r].resize(send_points[r].size());
+    for (std::size_t i = 0; i < send_points[r].size(); ++i)
+    {
+      const std::size_t p = send_points[r][i];
+      send_keep[r][i] = (owner[p] == r);
+      if (send_keep[r][i])
+        _requests[r].push_back(p);
+    }
+  }
+  std::vector<std::vector<int>> recv_keep;
+  MPI::all_to_all(mpi_comm, send_keep, recv_keep);
+
+  // Store owned points and their cells, ordered by requesting process
+  _offsets.assign(num_processes + 1, 0);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    _offsets[r + 1] = _offsets[r];
+    for (std::size_t i = 0; i < recv_keep[r].size(); ++i)
+      _offsets[r + 1] += recv_keep[r][i];
+  }
+  _x.resize(_offsets[num_processes], gdim);
+  _cells.resize(_offsets[num_processes]);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    std::size_t pos = _offsets[r];
+    for (std::size_t i = 0; i < recv_keep[r].size(); ++i)
+    {
+      if (!recv_keep[r][i])
+        continue;
+      for (std::size_t d = 0; d < gdim; ++d)
+        _x(pos, d) = recv_x[r][i*gdim + d];
+      _cells[pos++] = recv_cells[r][i];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void PointEvaluator::eval(std::vector<double>& values,
+                          const Function& u) const
+{
+  Timer timer("Evaluate function at distributed points");
+
+  dolfin_assert(u.function_space());
+  dolfin_assert(u.function_space()->mesh());
+  if (u.function_space()->mesh()->id() != _mesh->id())
+  {
+    dolfin_error("PointEvaluator.cpp",
+                 "evaluate function at points",
+                 "Function is not defined on the mesh of the point evaluator");
+  }
+
+  // Evaluate at owned points, using the cells found on construction
+  const std::size_t value_size = u.value_size();
+  EigenRowMatrixXd local_values(_x.rows(), value_size);
+  std::vector<unsigned int> cells(_cells);
+  u.eval(local_values, _x, cells);
+
+  // Return values to requesting processes
+  const std::size_t num_processes = _requests.size();
+  std::vector<std::vector<double>> send_values(num_processes);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    send_values[r].assign(local_values.data() + _offsets[r]*value_size,
+                          local_values.data() + _offsets[r + 1]*value_size);
+  }
+  std::vector<std::vector<double>> recv_values;
+  MPI::all_to_all(_mesh->mpi_comm(), send_values, recv_values);
+
+  // Unpack values
+  values.resize(_num_points*value_size);
+  for (std::size_t r = 0; r < num_processes; ++r)
+  {
+    dolfin_assert(recv_values[r].size() == _requests[r].size()*value_size);
+    for (std::size_t i = 0; i < _requests[r].size(); ++i)
+    {
+      std::copy(recv_values[r].begin() + i*value_size,
+                recv_values[r].begin() + (i + 1)*value_size,
+                values.begin() + _requests[r][i]*value_size);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
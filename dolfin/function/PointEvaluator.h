@@ -0,0 +1,94 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __POINT_EVALUATOR_H
+#define __POINT_EVALUATOR_H
+
+#include <memory>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace dolfin
+{
+
+  class Function;
+  class Mesh;
+
+  /// This class evaluates Functions at a fixed set of points in
+  /// parallel. Each process provides its own points, which need not
+  /// lie on the local part of the mesh. On construction, points are
+  /// routed to the process(es) whose bounding box contains them and
+  /// a single owning process is chosen for each point. The routing
+  /// plan is kept, so that each subsequent evaluation costs one
+  /// all-to-all exchange of values.
+
+  class PointEvaluator
+  {
+  public:
+
+    /// Create point evaluator (collective)
+    ///
+    /// @param    mesh (_Mesh_)
+    ///         The mesh.
+    /// @param    x (std::vector<double>)
+    ///         The coordinates of the points on this process
+    ///         (num_points x gdim, row-wise).
+    PointEvaluator(std::shared_ptr<const Mesh> mesh,
+                   const std::vector<double>& x);
+
+    /// Evaluate function at the points given on this process
+    /// (collective)
+    ///
+    /// @param    values (std::vector<double>)
+    ///         The values (num_points x value_size, row-wise).
+    /// @param    u (_Function_)
+    ///         The function, defined on the mesh of the evaluator.
+    void eval(std::vector<double>& values, const Function& u) const;
+
+    /// Return number of points on this process
+    ///
+    /// @return std::size_t
+    ///         The number of points.
+    std::size_t num_points() const
+    { return _num_points; }
+
+  private:
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                          Eigen::RowMajor> EigenRowMatrixXd;
+
+    // The mesh
+    std::shared_ptr<const Mesh> _mesh;
+
+    // Number of points on this process
+    std::size_t _num_points;
+
+    // Local indices of points evaluated by each process, in the
+    // order in which that process returns values
+    std::vector<std::vector<std::size_t>> _requests;
+
+    // Points evaluated on this process, ordered by requesting
+    // process, with containing cells and offsets per process
+    EigenRowMatrixXd _x;
+    std::vector<unsigned int> _cells;
+    std::vector<std::size_t> _offsets;
+
+  };
+
+}
+
+#endif
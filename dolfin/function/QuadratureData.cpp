@@ -0,0 +1,144 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <sstream>
+#include <dolfin/fem/FiniteElement.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/Vertex.h>
+#include "QuadratureData.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+QuadratureData::QuadratureData(std::shared_ptr<const Mesh> mesh,
+                               std::size_t num_points)
+  : QuadratureData(mesh, num_points, std::vector<std::size_t>())
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+QuadratureData::QuadratureData(std::shared_ptr<const Mesh> mesh,
+                               std::size_t num_points,
+                               std::vector<std::size_t> value_shape)
+  : _mesh(mesh), _num_points(num_points), _value_shape(value_shape)
+{
+  dolfin_assert(_mesh);
+  if (num_points == 0)
+  {
+    dolfin_error("QuadratureData.cpp",
+                 "create quadrature data",
+                 "Number of quadrature points must be positive");
+  }
+
+  std::size_t value_size = 1;
+  for (std::size_t i = 0; i < _value_shape.size(); ++i)
+    value_size *= _value_shape[i];
+  _block_size = value_size*_num_points;
+
+  // Allocate values for all cells (including ghosts)
+  _values.resize(_mesh->num_cells()*_block_size, 0.0);
+}
+//-----------------------------------------------------------------------------
+QuadratureData::~QuadratureData()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::size_t QuadratureData::value_dimension(std::size_t i) const
+{
+  if (i >= _value_shape.size())
+  {
+    dolfin_error("QuadratureData.cpp",
+                 "evaluate quadrature data",
+                 "Illegal axis %d for value dimension for value of rank %d",
+                 i, _value_shape.size());
+  }
+  return _value_shape[i];
+}
+//-----------------------------------------------------------------------------
+void QuadratureData::restrict(double* w, const FiniteElement& element,
+                              const Cell& dolfin_cell,
+                              const double* coordinate_dofs,
+                              const ufc::cell& ufc_cell) const
+{
+  // Check that element matches data layout
+  if (element.space_dimension() != _block_size)
+  {
+    dolfin_error("QuadratureData.cpp",
+                 "restrict quadrature data",
+                 "Dimension of element (%d) does not match number of values per cell (%d)",
+                 element.space_dimension(), _block_size);
+  }
+  dolfin_assert(dolfin_cell.mesh().id() == _mesh->id());
+
+  const double* values = cell_values(dolfin_cell.index());
+  std::copy(values, values + _block_size, w);
+}
+//-----------------------------------------------------------------------------
+void QuadratureData::compute_vertex_values(std::vector<double>& vertex_values,
+                                           const Mesh& mesh) const
+{
+  if (mesh.id() != _mesh->id())
+  {
+    dolfin_error("QuadratureData.cpp",
+                 "interpolate quadrature data values to vertices",
+                 "Non-matching mesh");
+  }
+
+  // Accumulate cell averages at vertices, component by component
+  const std::size_t value_size = _block_size/_num_points;
+  const std::size_t num_vertices = mesh.num_vertices();
+  vertex_values.assign(value_size*num_vertices, 0.0);
+  std::vector<std::size_t> num_cells(num_vertices, 0);
+  std::vector<double> average(value_size);
+  for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
+  {
+    const double* values = cell_values(cell->index());
+    for (std::size_t i = 0; i < value_size; ++i)
+    {
+      average[i] = 0.0;
+      for (std::size_t q = 0; q < _num_points; ++q)
+        average[i] += values[i*_num_points + q];
+      average[i] /= _num_points;
+    }
+
+    for (VertexIterator v(*cell); !v.end(); ++v)
+    {
+      num_cells[v->index()]++;
+      for (std::size_t i = 0; i < value_size; ++i)
+        vertex_values[i*num_vertices + v->index()] += average[i];
+    }
+  }
+
+  for (std::size_t i = 0; i < value_size; ++i)
+    for (std::size_t v = 0; v < num_vertices; ++v)
+      if (num_cells[v] > 0)
+        vertex_values[i*num_vertices + v] /= num_cells[v];
+}
+//-----------------------------------------------------------------------------
+std::string QuadratureData::str(bool verbose) const
+{
+  std::stringstream s;
+  s << "<QuadratureData with " << _num_points << " points per cell and "
+    << _block_size << " values per cell on " << _mesh->num_cells()
+    << " cells>";
+  return s.str();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,154 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __QUADRATURE_DATA_H
+#define __QUADRATURE_DATA_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "GenericFunction.h"
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Cell;
+  class FiniteElement;
+  class FunctionSpace;
+  class Mesh;
+
+  /// This class stores values at the quadrature points of all cells
+  /// of a mesh, e.g. the internal variables of history-dependent
+  /// material models (plasticity, damage). The values of each cell
+  /// are stored contiguously, as num_points values for each
+  /// component (component-major, matching the dof order of a
+  /// (vector) "Quadrature" element), and the cells in the local
+  /// order of the mesh, including ghost cells.
+  ///
+  /// The data may be used as a coefficient of a form with a
+  /// "Quadrature" element of the same degree, in which case the
+  /// values of a cell are copied directly into the coefficient
+  /// array of the kernel, without a dofmap, global vector or ghost
+  /// update. Values are updated in place through cell_values().
+
+  class QuadratureData : public GenericFunction
+  {
+  public:
+
+    /// Create scalar quadrature data
+    ///
+    /// @param    mesh (_Mesh_)
+    ///         The mesh.
+    /// @param    num_points (std::size_t)
+    ///         The number of quadrature points per cell.
+    QuadratureData(std::shared_ptr<const Mesh> mesh, std::size_t num_points);
+
+    /// Create quadrature data of given value shape
+    ///
+    /// @param    mesh (_Mesh_)
+    ///         The mesh.
+    /// @param    num_points (std::size_t)
+    ///         The number of quadrature points per cell.
+    /// @param    value_shape (std::vector<std::size_t>)
+    ///         The value shape at each point.
+    QuadratureData(std::shared_ptr<const Mesh> mesh, std::size_t num_points,
+                   std::vector<std::size_t> value_shape);
+
+    /// Destructor
+    ~QuadratureData();
+
+    /// Return mesh
+    std::shared_ptr<const Mesh> mesh() const
+    { return _mesh; }
+
+    /// Return number of quadrature points per cell
+    std::size_t num_points() const
+    { return _num_points; }
+
+    /// Return number of values per cell
+    std::size_t block_size() const
+    { return _block_size; }
+
+    /// Return values of given cell (block_size() values)
+    double* cell_values(std::size_t cell)
+    { return _values.data() + cell*_block_size; }
+
+    /// Return values of given cell (block_size() values) (const
+    /// version)
+    const double* cell_values(std::size_t cell) const
+    { return _values.data() + cell*_block_size; }
+
+    /// Return values of all cells
+    std::vector<double>& values()
+    { return _values; }
+
+    /// Return values of all cells (const version)
+    const std::vector<double>& values() const
+    { return _values; }
+
+    //--- Implementation of GenericFunction interface ---
+
+    /// Return value rank
+    virtual std::size_t value_rank() const override
+    { return _value_shape.size(); }
+
+    /// Return value dimension for given axis
+    virtual std::size_t value_dimension(std::size_t i) const override;
+
+    /// Return value shape
+    virtual std::vector<std::size_t> value_shape() const override
+    { return _value_shape; }
+
+    /// Restrict to local cell (copy values of cell)
+    virtual void restrict(double* w,
+                          const FiniteElement& element,
+                          const Cell& dolfin_cell,
+                          const double* coordinate_dofs,
+                          const ufc::cell& ufc_cell) const override;
+
+    /// Compute values at all mesh vertices (average over the points
+    /// of the cells sharing the vertex)
+    virtual void compute_vertex_values(std::vector<double>& vertex_values,
+                                       const Mesh& mesh) const override;
+
+    /// Return shared pointer to function space (NULL, quadrature data
+    /// has no function space)
+    virtual std::shared_ptr<const FunctionSpace> function_space() const override
+    { return std::shared_ptr<const FunctionSpace>(); }
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // The mesh
+    std::shared_ptr<const Mesh> _mesh;
+
+    // Number of points per cell, value shape and values per cell
+    std::size_t _num_points;
+    std::vector<std::size_t> _value_shape;
+    std::size_t _block_size;
+
+    // Values of all cells
+    std::vector<double> _values;
+
+  };
+
+}
+
+#endif
@@ -17,5 +17,9 @@
 #include <dolfin/function/FunctionAssigner.h>
 #include <dolfin/function/assign.h>
 #include <dolfin/function/LagrangeInterpolator.h>
+#include <dolfin/function/LagrangeInterpolationPlan.h>
+#include <dolfin/function/PointEvaluator.h>
+#include <dolfin/function/Particles.h>
+#include <dolfin/function/QuadratureData.h>
 
 #endif
@@ -27,6 +27,8 @@
 #include <dolfin/common/constants.h>
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/Timer.h>
+#include <dolfin/parameter/GlobalParameters.h>
+#include <dolfin/mesh/LocalMeshData.h>
 #include <dolfin/mesh/MeshPartitioning.h>
 #include <dolfin/mesh/MeshEditor.h>
 #include "BoxMesh.h"
@@ -52,13 +54,6 @@ void BoxMesh::build(Mesh& mesh, const std::array<Point,2 >& p,
 {
   Timer timer("Build BoxMesh");
 
-  // Receive mesh according to parallel policy
-  if (MPI::is_receiver(mesh.mpi_comm()))
-  {
-    MeshPartitioning::build_distributed_mesh(mesh);
-    return;
-  }
-
   // Extract data
   const Point& p0 = p[0];
   const Point& p1 = p[1];
@@ -98,34 +93,52 @@ void BoxMesh::build(Mesh& mesh, const std::array<Point,2 >& p,
 
   mesh.rename("mesh", "Mesh of the cuboid (a,b) x (c,d) x (e,f)");
 
+  // Build local slab on each process directly when no ghost layer is
+  // requested, bypassing rank-0 construction and graph partitioning
+  const std::string ghost_mode = dolfin::parameters["ghost_mode"];
+  const std::size_t mpi_size = MPI::size(mesh.mpi_comm());
+  if (mpi_size > 1 && nx*ny*nz >= mpi_size && ghost_mode == "none")
+  {
+    build_distributed(mesh, {{Point(a, c, e), Point(b, d, f)}}, n);
+    return;
+  }
+
+  // Receive mesh according to parallel policy
+  if (MPI::is_receiver(mesh.mpi_comm()))
+  {
+    MeshPartitioning::build_distributed_mesh(mesh);
+    return;
+  }
+
   // Open mesh for editing
   MeshEditor editor;
   editor.open(mesh, CellType::tetrahedron, 3, 3);
 
-  // Storage for vertex coordinates
-  std::vector<double> x(3);
-
   // Create vertices
-  editor.init_vertices_global((nx + 1)*(ny + 1)*(nz + 1),
-                              (nx + 1)*(ny + 1)*(nz + 1));
+  const std::size_t num_vertices = (nx + 1)*(ny + 1)*(nz + 1);
+  editor.init_vertices_global(num_vertices, num_vertices);
+  std::vector<double> x(3*num_vertices);
   std::size_t vertex = 0;
   for (std::size_t iz = 0; iz <= nz; iz++)
   {
-    x[2] = e + (static_cast<double>(iz))*(f-e) / static_cast<double>(nz);
+    const double z = e + (static_cast<double>(iz))*(f-e) / static_cast<double>(nz);
     for (std::size_t iy = 0; iy <= ny; iy++)
     {
-      x[1] = c + (static_cast<double>(iy))*(d-c) / static_cast<double>(ny);
+      const double y = c + (static_cast<double>(iy))*(d-c) / static_cast<double>(ny);
       for (std::size_t ix = 0; ix <= nx; ix++)
       {
-        x[0] = a + (static_cast<double>(ix))*(b-a) / static_cast<double>(nx);
-        editor.add_vertex(vertex, x);
+        x[3*vertex] = a + (static_cast<double>(ix))*(b-a) / static_cast<double>(nx);
+        x[3*vertex + 1] = y;
+        x[3*vertex + 2] = z;
         vertex++;
       }
     }
   }
+  editor.add_vertices(std::move(x));
 
   // Create tetrahedra
   editor.init_cells_global(6*nx*ny*nz, 6*nx*ny*nz);
+  std::vector<unsigned int> cell_vertices(24*nx*ny*nz);
   std::size_t cell = 0;
   boost::multi_array<std::size_t, 2> cells(boost::extents[6][4]);
   for (std::size_t iz = 0; iz < nz; iz++)
@@ -152,11 +165,13 @@ void BoxMesh::build(Mesh& mesh, const std::array<Point,2 >& p,
         cells[5][0] = v0; cells[5][1] = v2; cells[5][2] = v6; cells[5][3] = v7;
 
         // Add cells
-        for (auto _cell = cells.begin(); _cell != cells.end(); ++_cell)
-          editor.add_cell(cell++, *_cell);
+        for (std::size_t i = 0; i < 6; ++i, ++cell)
+          for (std::size_t j = 0; j < 4; ++j)
+            cell_vertices[4*cell + j] = cells[i][j];
       }
     }
   }
+  editor.add_cells(std::move(cell_vertices));
 
   // Close mesh editor
   editor.close();
@@ -169,3 +184,96 @@ void BoxMesh::build(Mesh& mesh, const std::array<Point,2 >& p,
   }
 }
 //-----------------------------------------------------------------------------
+void BoxMesh::build_distributed(Mesh& mesh, const std::array<Point, 2>& p,
+                                std::array<std::size_t, 3> n)
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const int mpi_rank = MPI::rank(mpi_comm);
+
+  const std::size_t nx = n[0];
+  const std::size_t ny = n[1];
+  const std::size_t nz = n[2];
+
+  const double a = p[0].x();
+  const double b = p[1].x();
+  const double c = p[0].y();
+  const double d = p[1].y();
+  const double e = p[0].z();
+  const double f = p[1].z();
+
+  LocalMeshData mesh_data(mpi_comm);
+  mesh_data.topology.dim = 3;
+  mesh_data.topology.cell_type = CellType::tetrahedron;
+  mesh_data.topology.num_vertices_per_cell = 4;
+  mesh_data.geometry.dim = 3;
+
+  // Vertices are owned in contiguous blocks of the global (x fastest)
+  // numbering, as expected by MeshPartitioning
+  const std::size_t num_global_vertices = (nx + 1)*(ny + 1)*(nz + 1);
+  const std::pair<std::size_t, std::size_t> vertex_range
+    = MPI::local_range(mpi_comm, num_global_vertices);
+  const std::size_t num_local_vertices = vertex_range.second - vertex_range.first;
+  mesh_data.geometry.num_global_vertices = num_global_vertices;
+  mesh_data.geometry.vertex_coordinates.resize(boost::extents[num_local_vertices][3]);
+  mesh_data.geometry.vertex_indices.resize(num_local_vertices);
+  for (std::size_t i = 0; i < num_local_vertices; ++i)
+  {
+    const std::size_t v = vertex_range.first + i;
+    const std::size_t ix = v % (nx + 1);
+    const std::size_t iy = (v/(nx + 1)) % (ny + 1);
+    const std::size_t iz = v/((nx + 1)*(ny + 1));
+    mesh_data.geometry.vertex_coordinates[i][0]
+      = a + (static_cast<double>(ix))*(b-a) / static_cast<double>(nx);
+    mesh_data.geometry.vertex_coordinates[i][1]
+      = c + (static_cast<double>(iy))*(d-c) / static_cast<double>(ny);
+    mesh_data.geometry.vertex_coordinates[i][2]
+      = e + (static_cast<double>(iz))*(f-e) / static_cast<double>(nz);
+    mesh_data.geometry.vertex_indices[i] = v;
+  }
+
+  // Each process takes a contiguous range of cubes. Since cubes are
+  // numbered x fastest, this is a geometric slab partition.
+  const std::pair<std::size_t, std::size_t> cube_range
+    = MPI::local_range(mpi_comm, nx*ny*nz);
+  const std::size_t num_local_cells = 6*(cube_range.second - cube_range.first);
+  mesh_data.topology.num_global_cells = 6*nx*ny*nz;
+  mesh_data.topology.cell_vertices.resize(boost::extents[num_local_cells][4]);
+  mesh_data.topology.global_cell_indices.resize(num_local_cells);
+  std::size_t cell = 0;
+  for (std::size_t q = cube_range.first; q < cube_range.second; ++q)
+  {
+    const std::size_t ix = q % nx;
+    const std::size_t iy = (q/nx) % ny;
+    const std::size_t iz = q/(nx*ny);
+
+    const std::size_t v0 = iz*(nx + 1)*(ny + 1) + iy*(nx + 1) + ix;
+    const std::size_t v1 = v0 + 1;
+    const std::size_t v2 = v0 + (nx + 1);
+    const std::size_t v3 = v1 + (nx + 1);
+    const std::size_t v4 = v0 + (nx + 1)*(ny + 1);
+    const std::size_t v5 = v1 + (nx + 1)*(ny + 1);
+    const std::size_t v6 = v2 + (nx + 1)*(ny + 1);
+    const std::size_t v7 = v3 + (nx + 1)*(ny + 1);
+
+    // Same six tetrahedra, in the same order, as the serial build
+    const std::size_t cells[6][4] = {{v0, v1, v3, v7},
+                                     {v0, v1, v7, v5},
+                                     {v0, v5, v7, v4},
+                                     {v0, v3, v2, v7},
+                                     {v0, v6, v4, v7},
+                                     {v0, v2, v6, v7}};
+    for (std::size_t k = 0; k < 6; ++k)
+    {
+      mesh_data.topology.global_cell_indices[cell] = 6*q + k;
+      std::copy(cells[k], cells[k] + 4,
+                mesh_data.topology.cell_vertices[cell].begin());
+      ++cell;
+    }
+  }
+
+  // Keep cells on this process
+  mesh_data.topology.cell_partition.assign(num_local_cells, mpi_rank);
+
+  MeshPartitioning::build_distributed_mesh(mesh, mesh_data, "none");
+}
+//-----------------------------------------------------------------------------
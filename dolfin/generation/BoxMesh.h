@@ -144,6 +144,11 @@ namespace dolfin
     static void build(Mesh& mesh, const std::array<Point, 2>& p,
                       std::array<std::size_t, 3> n);
 
+    // Build each process's slab of the mesh directly, with cells
+    // kept on the process that creates them
+    static void build_distributed(Mesh& mesh, const std::array<Point, 2>& p,
+                                  std::array<std::size_t, 3> n);
+
   };
 
 }
@@ -20,6 +20,8 @@
 
 #include <dolfin/common/constants.h>
 #include <dolfin/common/MPI.h>
+#include <dolfin/parameter/GlobalParameters.h>
+#include <dolfin/mesh/LocalMeshData.h>
 #include <dolfin/mesh/MeshEditor.h>
 #include <dolfin/mesh/MeshPartitioning.h>
 #include "RectangleMesh.h"
@@ -47,13 +49,6 @@ void RectangleMesh::build(Mesh& mesh, const std::array<Point, 2>& p,
                           std::array<std::size_t, 2> n,
                           std::string diagonal)
 {
-  // Receive mesh according to parallel policy
-  if (MPI::is_receiver(mesh.mpi_comm()))
-  {
-    MeshPartitioning::build_distributed_mesh(mesh);
-    return;
-  }
-
   // Check options
   if (diagonal != "left" && diagonal != "right" && diagonal != "right/left"
           && diagonal != "left/right" && diagonal != "crossed")
@@ -96,6 +91,23 @@ void RectangleMesh::build(Mesh& mesh, const std::array<Point, 2>& p,
 
   mesh.rename("mesh", "Mesh of the unit square (a,b) x (c,d)");
 
+  // Build local slab on each process directly when no ghost layer is
+  // requested, bypassing rank-0 construction and graph partitioning
+  const std::string ghost_mode = dolfin::parameters["ghost_mode"];
+  const std::size_t mpi_size = MPI::size(mesh.mpi_comm());
+  if (mpi_size > 1 && nx*ny >= mpi_size && ghost_mode == "none")
+  {
+    build_distributed(mesh, {{Point(a, c), Point(b, d)}}, n, diagonal);
+    return;
+  }
+
+  // Receive mesh according to parallel policy
+  if (MPI::is_receiver(mesh.mpi_comm()))
+  {
+    MeshPartitioning::build_distributed_mesh(mesh);
+    return;
+  }
+
   // Open mesh for editing
   MeshEditor editor;
   editor.open(mesh, CellType::triangle, 2, 2);
@@ -232,3 +244,129 @@ void RectangleMesh::build(Mesh& mesh, const std::array<Point, 2>& p,
   }
 }
 //-----------------------------------------------------------------------------
+void RectangleMesh::build_distributed(Mesh& mesh,
+                                      const std::array<Point, 2>& p,
+                                      std::array<std::size_t, 2> n,
+                                      std::string diagonal)
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const int mpi_rank = MPI::rank(mpi_comm);
+
+  const std::size_t nx = n[0];
+  const std::size_t ny = n[1];
+
+  const double a = p[0].x();
+  const double b = p[1].x();
+  const double c = p[0].y();
+  const double d = p[1].y();
+
+  const bool crossed = (diagonal == "crossed");
+  const std::size_t cells_per_square = crossed ? 4 : 2;
+
+  LocalMeshData mesh_data(mpi_comm);
+  mesh_data.topology.dim = 2;
+  mesh_data.topology.cell_type = CellType::triangle;
+  mesh_data.topology.num_vertices_per_cell = 3;
+  mesh_data.geometry.dim = 2;
+
+  // Vertices are owned in contiguous blocks of the global numbering
+  // (main vertices first, then midpoints for "crossed"), as expected
+  // by MeshPartitioning
+  const std::size_t num_main_vertices = (nx + 1)*(ny + 1);
+  const std::size_t num_global_vertices
+    = crossed ? num_main_vertices + nx*ny : num_main_vertices;
+  const std::pair<std::size_t, std::size_t> vertex_range
+    = MPI::local_range(mpi_comm, num_global_vertices);
+  const std::size_t num_local_vertices = vertex_range.second - vertex_range.first;
+  mesh_data.geometry.num_global_vertices = num_global_vertices;
+  mesh_data.geometry.vertex_coordinates.resize(boost::extents[num_local_vertices][2]);
+  mesh_data.geometry.vertex_indices.resize(num_local_vertices);
+  for (std::size_t i = 0; i < num_local_vertices; ++i)
+  {
+    const std::size_t v = vertex_range.first + i;
+    double ix, iy;
+    if (v < num_main_vertices)
+    {
+      ix = static_cast<double>(v % (nx + 1));
+      iy = static_cast<double>(v/(nx + 1));
+    }
+    else
+    {
+      const std::size_t m = v - num_main_vertices;
+      ix = static_cast<double>(m % nx) + 0.5;
+      iy = static_cast<double>(m/nx) + 0.5;
+    }
+    mesh_data.geometry.vertex_coordinates[i][0]
+      = a + ix*(b - a)/static_cast<double>(nx);
+    mesh_data.geometry.vertex_coordinates[i][1]
+      = c + iy*(d - c)/static_cast<double>(ny);
+    mesh_data.geometry.vertex_indices[i] = v;
+  }
+
+  // Each process takes a contiguous range of squares. Since squares
+  // are numbered x fastest, this is a geometric slab partition.
+  const std::pair<std::size_t, std::size_t> square_range
+    = MPI::local_range(mpi_comm, nx*ny);
+  const std::size_t num_local_cells
+    = cells_per_square*(square_range.second - square_range.first);
+  mesh_data.topology.num_global_cells = cells_per_square*nx*ny;
+  mesh_data.topology.cell_vertices.resize(boost::extents[num_local_cells][3]);
+  mesh_data.topology.global_cell_indices.resize(num_local_cells);
+  std::size_t cell = 0;
+  std::size_t cells[4][3];
+  for (std::size_t q = square_range.first; q < square_range.second; ++q)
+  {
+    const std::size_t ix = q % nx;
+    const std::size_t iy = q/nx;
+
+    const std::size_t v0 = iy*(nx + 1) + ix;
+    const std::size_t v1 = v0 + 1;
+    const std::size_t v2 = v0 + (nx + 1);
+    const std::size_t v3 = v1 + (nx + 1);
+
+    // Same cells, in the same order, as the serial build
+    if (crossed)
+    {
+      const std::size_t vmid = num_main_vertices + iy*nx + ix;
+      cells[0][0] = v0; cells[0][1] = v1; cells[0][2] = vmid;
+      cells[1][0] = v0; cells[1][1] = v2; cells[1][2] = vmid;
+      cells[2][0] = v1; cells[2][1] = v3; cells[2][2] = vmid;
+      cells[3][0] = v2; cells[3][1] = v3; cells[3][2] = vmid;
+    }
+    else
+    {
+      // Alternating diagonals start each row with the diagonal set by
+      // the row parity and flip at every square
+      bool left = (diagonal == "left");
+      if (diagonal == "right/left")
+        left = ((iy % 2 == 0) != (ix % 2 == 1));
+      else if (diagonal == "left/right")
+        left = ((iy % 2 == 1) != (ix % 2 == 1));
+
+      if (left)
+      {
+        cells[0][0] = v0; cells[0][1] = v1; cells[0][2] = v2;
+        cells[1][0] = v1; cells[1][1] = v2; cells[1][2] = v3;
+      }
+      else
+      {
+        cells[0][0] = v0; cells[0][1] = v1; cells[0][2] = v3;
+        cells[1][0] = v0; cells[1][1] = v2; cells[1][2] = v3;
+      }
+    }
+
+    for (std::size_t k = 0; k < cells_per_square; ++k)
+    {
+      mesh_data.topology.global_cell_indices[cell] = cells_per_square*q + k;
+      std::copy(cells[k], cells[k] + 3,
+                mesh_data.topology.cell_vertices[cell].begin());
+      ++cell;
+    }
+  }
+
+  // Keep cells on this process
+  mesh_data.topology.cell_partition.assign(num_local_cells, mpi_rank);
+
+  MeshPartitioning::build_distributed_mesh(mesh, mesh_data, "none");
+}
+//-----------------------------------------------------------------------------
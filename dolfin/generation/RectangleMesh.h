@@ -136,6 +136,12 @@ namespace dolfin
                       std::array<std::size_t, 2> n,
                       std::string diagonal="right");
 
+    // Build each process's slab of the mesh directly, with cells
+    // kept on the process that creates them
+    static void build_distributed(Mesh& mesh, const std::array<Point, 2>& p,
+                                  std::array<std::size_t, 2> n,
+                                  std::string diagonal);
+
   };
 
 }
@@ -0,0 +1,436 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <dolfin/common/constants.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/LocalMeshData.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshEditor.h>
+#include <dolfin/mesh/MeshPartitioning.h>
+#include <dolfin/parameter/GlobalParameters.h>
+#include "StructuredGrid.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Corners of the cells of a box, with corner bit a set for the
+  // upper side in direction a. Simplices are split as in
+  // RectangleMesh ("right") and BoxMesh, with sorted vertices.
+  const std::size_t triangle_corners[2][3] = {{0, 1, 3}, {0, 2, 3}};
+  const std::size_t tetrahedron_corners[6][4] = {{0, 1, 3, 7},
+                                                 {0, 1, 5, 7},
+                                                 {0, 4, 5, 7},
+                                                 {0, 2, 3, 7},
+                                                 {0, 4, 6, 7},
+                                                 {0, 2, 6, 7}};
+
+  // Compute (signed) measure of simplex spanned by points
+  double simplex_measure(const std::vector<Point>& x, std::size_t d)
+  {
+    if (d == 2)
+      return (x[1] - x[0]).cross(x[2] - x[0]).z();
+    dolfin_assert(d == 3);
+    return (x[1] - x[0]).dot((x[2] - x[0]).cross(x[3] - x[0]));
+  }
+}
+
+//-----------------------------------------------------------------------------
+StructuredGrid::StructuredGrid(MPI_Comm comm, const Point& p0,
+                               const Point& p1, std::size_t nx,
+                               std::size_t ny, std::size_t nz,
+                               CellType::Type cell_type)
+  : _mpi_comm(comm), _cell_type(cell_type), _dim(0)
+{
+  switch (cell_type)
+  {
+  case CellType::interval:
+    _dim = 1;
+    break;
+  case CellType::triangle:
+  case CellType::quadrilateral:
+    _dim = 2;
+    break;
+  case CellType::tetrahedron:
+  case CellType::hexahedron:
+    _dim = 3;
+    break;
+  default:
+    dolfin_error("StructuredGrid.cpp",
+                 "create structured grid",
+                 "Unsupported cell type");
+  }
+
+  const std::size_t n[3] = {nx, ny, nz};
+  for (std::size_t a = 0; a < 3; ++a)
+  {
+    _x0[a] = std::min(p0[a], p1[a]);
+    _x1[a] = std::max(p0[a], p1[a]);
+    _n[a] = a < _dim ? n[a] : 1;
+
+    if (a < _dim && std::abs(_x1[a] - _x0[a]) < DOLFIN_EPS)
+    {
+      dolfin_error("StructuredGrid.cpp",
+                   "create structured grid",
+                   "Grid has zero width in direction %d", a);
+    }
+    if (_n[a] < 1)
+    {
+      dolfin_error("StructuredGrid.cpp",
+                   "create structured grid",
+                   "Number of boxes must be at least 1 in each direction");
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+StructuredGrid::~StructuredGrid()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::size_t StructuredGrid::num_vertices() const
+{
+  std::size_t num = 1;
+  for (std::size_t a = 0; a < _dim; ++a)
+    num *= _n[a] + 1;
+  return num;
+}
+//-----------------------------------------------------------------------------
+std::size_t StructuredGrid::num_cells() const
+{
+  return cells_per_box()*_n[0]*_n[1]*_n[2];
+}
+//-----------------------------------------------------------------------------
+Point StructuredGrid::vertex(std::size_t v) const
+{
+  dolfin_assert(v < num_vertices());
+  Point x;
+  for (std::size_t a = 0; a < _dim; ++a)
+  {
+    const std::size_t i = v % (_n[a] + 1);
+    v /= _n[a] + 1;
+    x[a] = _x0[a] + (static_cast<double>(i))*(_x1[a] - _x0[a])
+      / static_cast<double>(_n[a]);
+  }
+  return x;
+}
+//-----------------------------------------------------------------------------
+void StructuredGrid::cell_vertices(std::vector<std::size_t>& vertices,
+                                   std::size_t c) const
+{
+  dolfin_assert(c < num_cells());
+  const std::size_t m = cells_per_box();
+  std::size_t indices[3];
+  box_indices(indices, c/m);
+  const std::size_t v0 = box_vertex(indices);
+
+  // Offsets of box corners
+  const std::size_t stride[3] = {1, _n[0] + 1, (_n[0] + 1)*(_n[1] + 1)};
+  std::size_t offset[8];
+  for (std::size_t k = 0; k < (1u << _dim); ++k)
+  {
+    offset[k] = 0;
+    for (std::size_t a = 0; a < _dim; ++a)
+      if ((k >> a) & 1)
+        offset[k] += stride[a];
+  }
+
+  const std::size_t k = c % m;
+  switch (_cell_type)
+  {
+  case CellType::triangle:
+    vertices.resize(3);
+    for (std::size_t i = 0; i < 3; ++i)
+      vertices[i] = v0 + offset[triangle_corners[k][i]];
+    break;
+  case CellType::tetrahedron:
+    vertices.resize(4);
+    for (std::size_t i = 0; i < 4; ++i)
+      vertices[i] = v0 + offset[tetrahedron_corners[k][i]];
+    break;
+  default:
+    vertices.resize(1u << _dim);
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+      vertices[i] = v0 + offset[i];
+  }
+}
+//-----------------------------------------------------------------------------
+void StructuredGrid::cell_neighbours(std::vector<std::size_t>& cells,
+                                     std::size_t c) const
+{
+  const std::size_t m = cells_per_box();
+  std::size_t indices[3];
+  box_indices(indices, c/m);
+
+  // Number of vertices of a facet
+  const bool simplex = (_cell_type == CellType::triangle
+                        || _cell_type == CellType::tetrahedron);
+  const std::size_t num_facet_vertices = simplex ? _dim : (1u << (_dim - 1));
+
+  std::vector<std::size_t> vertices, other;
+  cell_vertices(vertices, c);
+
+  // Facet neighbours are in the same box or a box sharing a face
+  std::vector<std::size_t> boxes(1, c/m);
+  for (std::size_t a = 0; a < _dim; ++a)
+  {
+    std::size_t stride = 1;
+    for (std::size_t b = 0; b < a; ++b)
+      stride *= _n[b];
+    if (indices[a] > 0)
+      boxes.push_back(c/m - stride);
+    if (indices[a] + 1 < _n[a])
+      boxes.push_back(c/m + stride);
+  }
+
+  cells.clear();
+  for (std::size_t b = 0; b < boxes.size(); ++b)
+  {
+    for (std::size_t k = 0; k < m; ++k)
+    {
+      const std::size_t other_cell = boxes[b]*m + k;
+      if (other_cell == c)
+        continue;
+
+      cell_vertices(other, other_cell);
+      std::size_t num_shared = 0;
+      for (std::size_t i = 0; i < other.size(); ++i)
+      {
+        if (std::find(vertices.begin(), vertices.end(), other[i])
+            != vertices.end())
+        {
+          ++num_shared;
+        }
+      }
+      if (num_shared == num_facet_vertices)
+        cells.push_back(other_cell);
+    }
+  }
+  std::sort(cells.begin(), cells.end());
+}
+//-----------------------------------------------------------------------------
+unsigned int StructuredGrid::locate(const Point& point) const
+{
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+
+  // Find box
+  std::size_t indices[3] = {0, 0, 0};
+  for (std::size_t a = 0; a < _dim; ++a)
+  {
+    const double t = (point[a] - _x0[a])/(_x1[a] - _x0[a])*_n[a];
+    if (t < -DOLFIN_EPS_LARGE || t > _n[a] + DOLFIN_EPS_LARGE)
+      return not_found;
+    indices[a] = std::min((std::size_t) std::max(t, 0.0), _n[a] - 1);
+  }
+  const std::size_t box
+    = indices[0] + _n[0]*(indices[1] + _n[1]*indices[2]);
+
+  // Boxes of tensor-product cells are cells
+  const std::size_t m = cells_per_box();
+  if (m == 1)
+    return box;
+
+  // Check simplices of box
+  std::vector<std::size_t> vertices;
+  std::vector<Point> x(_dim + 1);
+  for (std::size_t k = 0; k < m; ++k)
+  {
+    cell_vertices(vertices, box*m + k);
+    for (std::size_t i = 0; i <= _dim; ++i)
+      x[i] = vertex(vertices[i]);
+    const double measure = simplex_measure(x, _dim);
+
+    // Point is inside if replacing any vertex by the point does not
+    // change the orientation of the simplex
+    bool inside = true;
+    for (std::size_t i = 0; i <= _dim && inside; ++i)
+    {
+      const Point xi = x[i];
+      x[i] = point;
+      if (simplex_measure(x, _dim)/measure < -DOLFIN_EPS_LARGE)
+        inside = false;
+      x[i] = xi;
+    }
+
+    if (inside)
+      return box*m + k;
+  }
+
+  return not_found;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const Mesh> StructuredGrid::mesh() const
+{
+  if (!_mesh)
+  {
+    _mesh.reset(new Mesh(_mpi_comm.comm()));
+    build_mesh(*_mesh);
+  }
+  return _mesh;
+}
+//-----------------------------------------------------------------------------
+std::string StructuredGrid::str(bool verbose) const
+{
+  std::stringstream s;
+  s << "<StructuredGrid of " << _n[0];
+  for (std::size_t a = 1; a < _dim; ++a)
+    s << " x " << _n[a];
+  s << " boxes with " << num_cells() << " cells"
+    << (_mesh ? " (explicit mesh built)" : "") << ">";
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+std::size_t StructuredGrid::cells_per_box() const
+{
+  switch (_cell_type)
+  {
+  case CellType::triangle:
+    return 2;
+  case CellType::tetrahedron:
+    return 6;
+  default:
+    return 1;
+  }
+}
+//-----------------------------------------------------------------------------
+void StructuredGrid::box_indices(std::size_t indices[3], std::size_t box) const
+{
+  indices[0] = box % _n[0];
+  indices[1] = (box/_n[0]) % _n[1];
+  indices[2] = box/(_n[0]*_n[1]);
+}
+//-----------------------------------------------------------------------------
+std::size_t StructuredGrid::box_vertex(const std::size_t indices[3]) const
+{
+  return indices[0] + (_n[0] + 1)*(indices[1] + (_n[1] + 1)*indices[2]);
+}
+//-----------------------------------------------------------------------------
+void StructuredGrid::build_mesh(Mesh& mesh) const
+{
+  Timer timer("Build mesh of StructuredGrid");
+
+  // Build local slab on each process directly when no ghost layer is
+  // requested, as for BoxMesh
+  const std::string ghost_mode = dolfin::parameters["ghost_mode"];
+  const std::size_t mpi_size = MPI::size(mesh.mpi_comm());
+  if (mpi_size > 1 && _n[0]*_n[1]*_n[2] >= mpi_size && ghost_mode == "none")
+  {
+    build_mesh_distributed(mesh);
+    return;
+  }
+
+  // Receive mesh according to parallel policy
+  if (MPI::is_receiver(mesh.mpi_comm()))
+  {
+    MeshPartitioning::build_distributed_mesh(mesh);
+    return;
+  }
+
+  MeshEditor editor;
+  editor.open(mesh, _cell_type, _dim, _dim);
+
+  // Create vertices
+  const std::size_t num_grid_vertices = num_vertices();
+  editor.init_vertices_global(num_grid_vertices, num_grid_vertices);
+  std::vector<double> x(_dim);
+  for (std::size_t v = 0; v < num_grid_vertices; ++v)
+  {
+    const Point p = vertex(v);
+    std::copy(p.coordinates(), p.coordinates() + _dim, x.begin());
+    editor.add_vertex(v, x);
+  }
+
+  // Create cells
+  const std::size_t num_grid_cells = num_cells();
+  editor.init_cells_global(num_grid_cells, num_grid_cells);
+  std::vector<std::size_t> vertices;
+  for (std::size_t c = 0; c < num_grid_cells; ++c)
+  {
+    cell_vertices(vertices, c);
+    editor.add_cell(c, vertices);
+  }
+
+  editor.close();
+
+  // Broadcast mesh according to parallel policy
+  if (MPI::is_broadcaster(mesh.mpi_comm()))
+    MeshPartitioning::build_distributed_mesh(mesh);
+}
+//-----------------------------------------------------------------------------
+void StructuredGrid::build_mesh_distributed(Mesh& mesh) const
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const int mpi_rank = MPI::rank(mpi_comm);
+  const std::size_t m = cells_per_box();
+
+  std::unique_ptr<CellType> cell(CellType::create(_cell_type));
+  LocalMeshData mesh_data(mpi_comm);
+  mesh_data.topology.dim = _dim;
+  mesh_data.topology.cell_type = _cell_type;
+  mesh_data.topology.num_vertices_per_cell = cell->num_vertices();
+  mesh_data.geometry.dim = _dim;
+
+  // Vertices are owned in contiguous blocks of the grid numbering
+  const std::size_t num_global_vertices = num_vertices();
+  const std::pair<std::size_t, std::size_t> vertex_range
+    = MPI::local_range(mpi_comm, num_global_vertices);
+  const std::size_t num_local_vertices
+    = vertex_range.second - vertex_range.first;
+  mesh_data.geometry.num_global_vertices = num_global_vertices;
+  mesh_data.geometry.vertex_coordinates.resize(
+    boost::extents[num_local_vertices][_dim]);
+  mesh_data.geometry.vertex_indices.resize(num_local_vertices);
+  for (std::size_t i = 0; i < num_local_vertices; ++i)
+  {
+    const std::size_t v = vertex_range.first + i;
+    const Point p = vertex(v);
+    for (std::size_t a = 0; a < _dim; ++a)
+      mesh_data.geometry.vertex_coordinates[i][a] = p[a];
+    mesh_data.geometry.vertex_indices[i] = v;
+  }
+
+  // Each process takes a contiguous range of boxes (a geometric
+  // slab, since boxes are numbered x fastest)
+  const std::pair<std::size_t, std::size_t> box_range
+    = MPI::local_range(mpi_comm, _n[0]*_n[1]*_n[2]);
+  const std::size_t num_local_cells = m*(box_range.second - box_range.first);
+  mesh_data.topology.num_global_cells = num_cells();
+  mesh_data.topology.cell_vertices.resize(
+    boost::extents[num_local_cells][cell->num_vertices()]);
+  mesh_data.topology.global_cell_indices.resize(num_local_cells);
+  std::vector<std::size_t> vertices;
+  for (std::size_t i = 0; i < num_local_cells; ++i)
+  {
+    const std::size_t c = m*box_range.first + i;
+    cell_vertices(vertices, c);
+    mesh_data.topology.global_cell_indices[i] = c;
+    std::copy(vertices.begin(), vertices.end(),
+              mesh_data.topology.cell_vertices[i].begin());
+  }
+
+  // Keep cells on this process
+  mesh_data.topology.cell_partition.assign(num_local_cells, mpi_rank);
+
+  MeshPartitioning::build_distributed_mesh(mesh, mesh_data, "none");
+}
+//-----------------------------------------------------------------------------
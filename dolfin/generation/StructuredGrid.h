@@ -0,0 +1,174 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __STRUCTURED_GRID_H
+#define __STRUCTURED_GRID_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin/common/MPI.h>
+#include <dolfin/geometry/Point.h>
+#include <dolfin/mesh/CellType.h>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Mesh;
+
+  /// This class represents a Cartesian grid of nx (x ny (x nz))
+  /// boxes on the domain spanned by two points, with implicit
+  /// topology and geometry: vertex coordinates, cell vertices, cell
+  /// neighbours and the cell containing a point are computed on the
+  /// fly from the (i, j, k) indices of the boxes, so the storage is
+  /// independent of the grid size.
+  ///
+  /// Each box is a single interval, quadrilateral or hexahedron, or
+  /// is split into two triangles or six tetrahedra as in
+  /// RectangleMesh (diagonal "right") and BoxMesh. Vertices are
+  /// numbered with x fastest, and cells box by box in the same
+  /// order.
+  ///
+  /// An explicit _Mesh_ (for creating function spaces) is built the
+  /// first time mesh() is called. Its vertex and cell numbering (the
+  /// global indices in parallel) is the numbering of the grid.
+
+  class StructuredGrid
+  {
+  public:
+
+    /// Create grid
+    ///
+    /// @param[in] comm (MPI_Comm)
+    ///         MPI communicator for the mesh.
+    /// @param[in] p0 (_Point_)
+    ///         First point.
+    /// @param[in] p1 (_Point_)
+    ///         Second point (opposite corner).
+    /// @param[in] nx (std::size_t)
+    ///         Number of boxes in x-direction.
+    /// @param[in] ny (std::size_t)
+    ///         Number of boxes in y-direction (ignored in 1D).
+    /// @param[in] nz (std::size_t)
+    ///         Number of boxes in z-direction (ignored in 1D and 2D).
+    /// @param[in] cell_type (CellType::Type)
+    ///         Cell type.
+    StructuredGrid(MPI_Comm comm, const Point& p0, const Point& p1,
+                   std::size_t nx, std::size_t ny, std::size_t nz,
+                   CellType::Type cell_type);
+
+    /// Destructor
+    ~StructuredGrid();
+
+    /// Return topological (and geometric) dimension
+    std::size_t dim() const
+    { return _dim; }
+
+    /// Return cell type
+    CellType::Type cell_type() const
+    { return _cell_type; }
+
+    /// Return number of vertices
+    std::size_t num_vertices() const;
+
+    /// Return number of cells
+    std::size_t num_cells() const;
+
+    /// Return coordinates of vertex
+    ///
+    /// @param[in] v (std::size_t)
+    ///         Vertex index.
+    /// @return _Point_
+    Point vertex(std::size_t v) const;
+
+    /// Compute vertices of cell, in the local order of the cell in
+    /// the explicit mesh
+    ///
+    /// @param[out] vertices (std::vector<std::size_t>)
+    ///         Vertex indices.
+    /// @param[in] c (std::size_t)
+    ///         Cell index.
+    void cell_vertices(std::vector<std::size_t>& vertices,
+                       std::size_t c) const;
+
+    /// Compute cells sharing a facet with cell
+    ///
+    /// @param[out] cells (std::vector<std::size_t>)
+    ///         Indices of neighbouring cells.
+    /// @param[in] c (std::size_t)
+    ///         Cell index.
+    void cell_neighbours(std::vector<std::size_t>& cells,
+                         std::size_t c) const;
+
+    /// Compute cell containing point
+    ///
+    /// @param[in] point (_Point_)
+    ///         The point.
+    /// @return unsigned int
+    ///         Cell index, or std::numeric_limits<unsigned int>::max()
+    ///         if the point is outside the grid.
+    unsigned int locate(const Point& point) const;
+
+    /// Return explicit mesh of the grid, building it on first call
+    std::shared_ptr<const Mesh> mesh() const;
+
+    /// Check whether explicit mesh has been built
+    bool has_mesh() const
+    { return (bool) _mesh; }
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // Return number of cells per box
+    std::size_t cells_per_box() const;
+
+    // Compute box indices (ix, iy, iz) of box
+    void box_indices(std::size_t indices[3], std::size_t box) const;
+
+    // Return first vertex of box
+    std::size_t box_vertex(const std::size_t indices[3]) const;
+
+    // Build explicit mesh
+    void build_mesh(Mesh& mesh) const;
+
+    // Build each process's slab of the explicit mesh directly
+    void build_mesh_distributed(Mesh& mesh) const;
+
+    // MPI communicator
+    dolfin::MPI::Comm _mpi_comm;
+
+    // Cell type and dimension
+    CellType::Type _cell_type;
+    std::size_t _dim;
+
+    // Lower and upper corners and number of boxes in each direction
+    std::array<double, 3> _x0, _x1;
+    std::array<std::size_t, 3> _n;
+
+    // Explicit mesh (built on demand)
+    mutable std::shared_ptr<Mesh> _mesh;
+
+  };
+
+}
+
+#endif
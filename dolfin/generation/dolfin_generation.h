@@ -15,5 +15,6 @@
 #include <dolfin/generation/UnitHexMesh.h>
 #include <dolfin/generation/UnitDiscMesh.h>
 #include <dolfin/generation/SphericalShellMesh.h>
+#include <dolfin/generation/StructuredGrid.h>
 
 #endif
@@ -0,0 +1,303 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cstdint>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/SubSystemsManager.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/BoundaryMesh.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshEditor.h>
+#include <dolfin/mesh/MeshGeometry.h>
+#include <dolfin/mesh/MeshEntityIterator.h>
+#include <dolfin/mesh/Vertex.h>
+#include "Point.h"
+#include "BoundaryDistance.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Number of consecutive points processed by one thread, the first
+  // point of a block is the only one searched without warm start
+  // (unless guesses are given)
+  const std::int64_t block_size = 64;
+
+  // Closest point to p on segment ab
+  Point closest_point_interval(const Point& p, const Point& a, const Point& b)
+  {
+    const Point ab = b - a;
+    const double t = (p - a).dot(ab)/ab.squared_norm();
+    return a + std::min(std::max(t, 0.0), 1.0)*ab;
+  }
+
+  // Closest point to p on triangle abc, from Real-time collision
+  // detection by Christer Ericson (ClosestPtPointTriangle, Section
+  // 5.1.5), as in TriangleCell::squared_distance
+  Point closest_point_triangle(const Point& p, const Point& a,
+                               const Point& b, const Point& c)
+  {
+    const Point ab = b - a;
+    const Point ac = c - a;
+
+    // Vertex region outside a
+    const Point ap = p - a;
+    const double d1 = ab.dot(ap);
+    const double d2 = ac.dot(ap);
+    if (d1 <= 0.0 && d2 <= 0.0)
+      return a;
+
+    // Vertex region outside b
+    const Point bp = p - b;
+    const double d3 = ab.dot(bp);
+    const double d4 = ac.dot(bp);
+    if (d3 >= 0.0 && d4 <= d3)
+      return b;
+
+    // Edge region of ab
+    const double vc = d1*d4 - d3*d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+      return a + (d1/(d1 - d3))*ab;
+
+    // Vertex region outside c
+    const Point cp = p - c;
+    const double d5 = ab.dot(cp);
+    const double d6 = ac.dot(cp);
+    if (d6 >= 0.0 && d5 <= d6)
+      return c;
+
+    // Edge region of ac
+    const double vb = d5*d2 - d1*d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+      return a + (d2/(d2 - d6))*ac;
+
+    // Edge region of bc
+    const double va = d3*d6 - d5*d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+      return b + ((d4 - d3)/((d4 - d3) + (d5 - d6)))*(c - b);
+
+    // Inside triangle, project onto its plane
+    const double denom = 1.0/(va + vb + vc);
+    return a + (vb*denom)*ab + (vc*denom)*ac;
+  }
+
+  // Create point from coordinates
+  Point make_point(const double* x, std::size_t gdim)
+  {
+    Point p;
+    for (std::size_t i = 0; i < gdim; ++i)
+      p[i] = x[i];
+    return p;
+  }
+}
+
+//-----------------------------------------------------------------------------
+BoundaryDistance::BoundaryDistance(const Mesh& mesh)
+  : _facet_mesh(new Mesh(MPI_COMM_SELF))
+{
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const CellType::Type cell_type = mesh.type().cell_type();
+  if (cell_type != CellType::triangle && cell_type != CellType::tetrahedron)
+  {
+    dolfin_error("BoundaryDistance.cpp",
+                 "create boundary distance",
+                 "Boundary distance is only implemented for triangle and tetrahedron meshes");
+  }
+
+  // Get vertex coordinates of local exterior facets
+  BoundaryMesh boundary(mesh, "exterior");
+  std::vector<double> local_coordinates;
+  local_coordinates.reserve(boundary.num_cells()*tdim*gdim);
+  for (CellIterator f(boundary); !f.end(); ++f)
+  {
+    for (VertexIterator v(*f); !v.end(); ++v)
+    {
+      const double* x = v->x();
+      local_coordinates.insert(local_coordinates.end(), x, x + gdim);
+    }
+  }
+
+  // Gather facets of all processes
+  std::vector<std::vector<double>> coordinates;
+  MPI::all_gather(mesh.mpi_comm(), local_coordinates, coordinates);
+  std::size_t num_facets = 0;
+  for (std::size_t p = 0; p < coordinates.size(); ++p)
+    num_facets += coordinates[p].size()/(tdim*gdim);
+  if (num_facets == 0)
+  {
+    dolfin_error("BoundaryDistance.cpp",
+                 "create boundary distance",
+                 "Mesh has no exterior facets");
+  }
+
+  // Create local facet mesh, each facet with its own vertices
+  MeshEditor editor;
+  editor.open(*_facet_mesh, mesh.type().facet_type(), tdim - 1, gdim);
+  editor.init_vertices(num_facets*tdim);
+  editor.init_cells(num_facets);
+  std::vector<double> x(gdim);
+  std::vector<std::size_t> cell_vertices(tdim);
+  std::size_t v = 0;
+  std::size_t c = 0;
+  for (std::size_t p = 0; p < coordinates.size(); ++p)
+  {
+    const std::vector<double>& facet_coordinates = coordinates[p];
+    for (std::size_t i = 0; i < facet_coordinates.size(); i += tdim*gdim)
+    {
+      for (std::size_t j = 0; j < tdim; ++j)
+      {
+        std::copy(facet_coordinates.begin() + i + j*gdim,
+                  facet_coordinates.begin() + i + (j + 1)*gdim, x.begin());
+        editor.add_vertex(v, x);
+        cell_vertices[j] = v++;
+      }
+      editor.add_cell(c++, cell_vertices);
+    }
+  }
+  editor.close(false);
+
+  // Build tree for facets
+  _tree.build(*_facet_mesh);
+}
+//-----------------------------------------------------------------------------
+BoundaryDistance::~BoundaryDistance()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void BoundaryDistance::compute_distances(std::vector<double>& distances,
+                                         std::vector<unsigned int>& facets,
+                                         const std::vector<double>& points) const
+{
+  compute_closest_facets(distances, facets, points);
+}
+//-----------------------------------------------------------------------------
+void
+BoundaryDistance::compute_closest_points(std::vector<double>& closest_points,
+                                         std::vector<unsigned int>& facets,
+                                         const std::vector<double>& points) const
+{
+  std::vector<double> distances;
+  compute_closest_facets(distances, facets, points);
+
+  // Compute closest point on closest facet
+  const std::size_t gdim = _facet_mesh->geometry().dim();
+  const std::size_t tdim = _facet_mesh->topology().dim();
+  const MeshGeometry& geometry = _facet_mesh->geometry();
+  const std::vector<unsigned int>& cells
+    = _facet_mesh->topology()(tdim, 0)();
+  const std::int64_t num_points = points.size()/gdim;
+  closest_points.resize(points.size());
+  const int num_threads = SubSystemsManager::num_threads();
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t i = 0; i < num_points; ++i)
+  {
+    const Point p = make_point(points.data() + i*gdim, gdim);
+    const unsigned int* vertices = cells.data() + facets[i]*(tdim + 1);
+    const Point q = (tdim == 1)
+      ? closest_point_interval(p, geometry.point(vertices[0]),
+                               geometry.point(vertices[1]))
+      : closest_point_triangle(p, geometry.point(vertices[0]),
+                               geometry.point(vertices[1]),
+                               geometry.point(vertices[2]));
+    for (std::size_t j = 0; j < gdim; ++j)
+      closest_points[i*gdim + j] = q[j];
+  }
+}
+//-----------------------------------------------------------------------------
+void BoundaryDistance::compute(Function& u) const
+{
+  dolfin_assert(u.function_space());
+  if (u.value_rank() != 0)
+  {
+    dolfin_error("BoundaryDistance.cpp",
+                 "compute boundary distance",
+                 "Function must be scalar valued");
+  }
+
+  // Compute distances at (owned) dof coordinates
+  const std::vector<double> points
+    = u.function_space()->tabulate_dof_coordinates();
+  std::vector<double> distances;
+  std::vector<unsigned int> facets;
+  compute_closest_facets(distances, facets, points);
+
+  dolfin_assert(u.vector());
+  u.vector()->set_local(distances);
+  u.vector()->apply("insert");
+}
+//-----------------------------------------------------------------------------
+std::vector<double>
+BoundaryDistance::compute_vertex_distances(const Mesh& mesh) const
+{
+  std::vector<double> distances;
+  std::vector<unsigned int> facets;
+  compute_closest_facets(distances, facets, mesh.geometry().x());
+  return distances;
+}
+//-----------------------------------------------------------------------------
+void
+BoundaryDistance::compute_closest_facets(std::vector<double>& distances,
+                                         std::vector<unsigned int>& facets,
+                                         const std::vector<double>& points) const
+{
+  const std::size_t gdim = _facet_mesh->geometry().dim();
+  if (points.size() % gdim != 0)
+  {
+    dolfin_error("BoundaryDistance.cpp",
+                 "compute boundary distance",
+                 "Number of point coordinates (%d) is not a multiple of the geometric dimension (%d)",
+                 points.size(), gdim);
+  }
+  const std::int64_t num_points = points.size()/gdim;
+
+  // Use given facets as guesses if there is one for each point
+  const bool have_guesses = (facets.size() == (std::size_t) num_points);
+  if (!have_guesses)
+    facets.resize(num_points);
+  distances.resize(num_points);
+
+  // Search blocks of consecutive points in parallel, using the
+  // closest facet of the previous point in the block as guess
+  const std::int64_t num_blocks = (num_points + block_size - 1)/block_size;
+  const int num_threads = SubSystemsManager::num_threads();
+  #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+  for (std::int64_t b = 0; b < num_blocks; ++b)
+  {
+    const std::int64_t end = std::min(num_points, (b + 1)*block_size);
+    for (std::int64_t i = b*block_size; i < end; ++i)
+    {
+      const Point p = make_point(points.data() + i*gdim, gdim);
+      std::pair<unsigned int, double> closest;
+      if (have_guesses)
+        closest = _tree.compute_closest_entity(p, facets[i]);
+      else if (i == b*block_size)
+        closest = _tree.compute_closest_entity(p);
+      else
+        closest = _tree.compute_closest_entity(p, facets[i - 1]);
+      facets[i] = closest.first;
+      distances[i] = closest.second;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
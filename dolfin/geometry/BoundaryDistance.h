@@ -0,0 +1,137 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __BOUNDARY_DISTANCE_H
+#define __BOUNDARY_DISTANCE_H
+
+#include <memory>
+#include <vector>
+#include "BoundingBoxTree.h"
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Function;
+  class Mesh;
+
+  /// This class computes distances and closest points from many
+  /// points to the exterior boundary of a mesh, e.g. the wall
+  /// distance for turbulence models or gaps for contact problems.
+  ///
+  /// The boundary facets of all processes are gathered on each
+  /// process into a local facet mesh, and a bounding box tree is
+  /// built for the facets. The points are then processed in
+  /// parallel (with OpenMP if enabled), using the closest facet of
+  /// the previous point (or a given guess for each point) as the
+  /// initial search radius. For points that are ordered with
+  /// spatial locality, such as vertices or dofs of a mesh, this
+  /// reduces the search to a few tree nodes per point.
+  ///
+  /// The distances are unsigned. Facets are numbered by their
+  /// local index in facet_mesh().
+
+  class BoundaryDistance
+  {
+  public:
+
+    /// Create boundary distance for the exterior boundary of mesh
+    /// (collective).
+    ///
+    /// *Arguments*
+    ///     mesh (_Mesh_)
+    ///         The mesh (of simplex cells, of topological dimension
+    ///         2 or 3).
+    explicit BoundaryDistance(const Mesh& mesh);
+
+    /// Destructor
+    ~BoundaryDistance();
+
+    /// Compute distances from points to the boundary.
+    ///
+    /// *Arguments*
+    ///     distances (std::vector<double>)
+    ///         The distances (resized to the number of points).
+    ///     facets (std::vector<unsigned int>)
+    ///         The closest facet of each point. If of the same size
+    ///         as the number of points on input, the given facets
+    ///         are used as initial guesses, e.g. the result of a
+    ///         previous call for the same points before a small
+    ///         displacement.
+    ///     points (std::vector<double>)
+    ///         Coordinates of the points (x0, y0, x1, y1, ...).
+    void compute_distances(std::vector<double>& distances,
+                           std::vector<unsigned int>& facets,
+                           const std::vector<double>& points) const;
+
+    /// Compute closest points on the boundary.
+    ///
+    /// *Arguments*
+    ///     closest_points (std::vector<double>)
+    ///         Coordinates of the closest points (resized to the
+    ///         size of points).
+    ///     facets (std::vector<unsigned int>)
+    ///         The closest facet of each point (used as initial
+    ///         guesses as in compute_distances()).
+    ///     points (std::vector<double>)
+    ///         Coordinates of the points (x0, y0, x1, y1, ...).
+    void compute_closest_points(std::vector<double>& closest_points,
+                                std::vector<unsigned int>& facets,
+                                const std::vector<double>& points) const;
+
+    /// Set the values of a scalar function to the distance from its
+    /// dof coordinates to the boundary.
+    ///
+    /// *Arguments*
+    ///     u (_Function_)
+    ///         The function (in a scalar function space).
+    void compute(Function& u) const;
+
+    /// Return distances from the vertices of a mesh to the boundary
+    ///
+    /// *Arguments*
+    ///     mesh (_Mesh_)
+    ///         The mesh (normally the mesh from which the boundary
+    ///         distance was created).
+    ///
+    /// *Returns*
+    ///     std::vector<double>
+    ///         The distance of each vertex.
+    std::vector<double> compute_vertex_distances(const Mesh& mesh) const;
+
+    /// Return the facet mesh of the (global) boundary
+    const Mesh& facet_mesh() const
+    { return *_facet_mesh; }
+
+  private:
+
+    // Compute closest facets and distances
+    void compute_closest_facets(std::vector<double>& distances,
+                                std::vector<unsigned int>& facets,
+                                const std::vector<double>& points) const;
+
+    // Local mesh of all boundary facets
+    std::shared_ptr<Mesh> _facet_mesh;
+
+    // Bounding box tree of facets
+    BoundingBoxTree _tree;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,383 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <dolfin/common/constants.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshEntityIterator.h>
+#include "Point.h"
+#include "BoundingBoxGrid.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+BoundingBoxGrid::BoundingBoxGrid() : _mesh(0), _gdim(0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxGrid::build(const Mesh& mesh)
+{
+  _mesh = &mesh;
+  _gdim = mesh.geometry().dim();
+  const std::size_t num_cells = mesh.num_cells();
+  const MeshGeometry& geometry = mesh.geometry();
+
+  // Compute bounding boxes of cells and of the mesh
+  _bboxes.resize(2*_gdim*num_cells);
+  std::vector<double> x_max(_gdim, -std::numeric_limits<double>::max());
+  _x_min.assign(_gdim, std::numeric_limits<double>::max());
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    double* xmin = _bboxes.data() + 2*_gdim*cell->index();
+    double* xmax = xmin + _gdim;
+    const unsigned int* vertices = cell->entities(0);
+    const double* x = geometry.x(vertices[0]);
+    std::copy(x, x + _gdim, xmin);
+    std::copy(x, x + _gdim, xmax);
+    for (std::size_t i = 1; i < cell->num_entities(0); ++i)
+    {
+      x = geometry.x(vertices[i]);
+      for (std::size_t j = 0; j < _gdim; ++j)
+      {
+        xmin[j] = std::min(xmin[j], x[j]);
+        xmax[j] = std::max(xmax[j], x[j]);
+      }
+    }
+    for (std::size_t j = 0; j < _gdim; ++j)
+    {
+      _x_min[j] = std::min(_x_min[j], xmin[j]);
+      x_max[j] = std::max(x_max[j], xmax[j]);
+    }
+  }
+
+  // Pad bounding boxes to make point queries robust
+  double extent = 0.0;
+  for (std::size_t j = 0; j < _gdim && num_cells > 0; ++j)
+    extent = std::max(extent, x_max[j] - _x_min[j]);
+  const double eps = DOLFIN_EPS_LARGE*extent;
+  for (std::size_t i = 0; i < num_cells; ++i)
+  {
+    for (std::size_t j = 0; j < _gdim; ++j)
+    {
+      _bboxes[2*_gdim*i + j] -= eps;
+      _bboxes[2*_gdim*i + _gdim + j] += eps;
+    }
+  }
+
+  // Choose grid cell size such that the number of grid cells is
+  // about the number of mesh cells, ignoring axes along which the
+  // mesh is flat
+  _num_cells.assign(_gdim, 1);
+  _h.assign(_gdim, 1.0);
+  if (num_cells == 0)
+  {
+    _x_min.assign(_gdim, 0.0);
+    _offsets.assign(2, 0);
+    _cells.clear();
+    return;
+  }
+
+  double volume = 1.0;
+  std::size_t dim = 0;
+  for (std::size_t j = 0; j < _gdim; ++j)
+  {
+    _x_min[j] -= eps;
+    x_max[j] += eps;
+    if (x_max[j] - _x_min[j] > 2.0*eps + DOLFIN_EPS*extent)
+    {
+      volume *= x_max[j] - _x_min[j];
+      ++dim;
+    }
+  }
+  const double h = dim > 0 ? std::pow(volume/num_cells, 1.0/dim) : 1.0;
+  std::size_t num_grid_cells = 1;
+  for (std::size_t j = 0; j < _gdim; ++j)
+  {
+    const double length = x_max[j] - _x_min[j];
+    if (length > 2.0*eps + DOLFIN_EPS*extent)
+    {
+      _num_cells[j] = std::max<std::size_t>(1, std::ceil(length/h));
+      _num_cells[j] = std::min(_num_cells[j], num_cells);
+    }
+    _h[j] = length > 0.0 ? length/_num_cells[j] : 1.0;
+    num_grid_cells *= _num_cells[j];
+  }
+
+  // Count mesh cells overlapping each grid cell
+  std::vector<std::size_t> lo(_gdim), hi(_gdim);
+  _offsets.assign(num_grid_cells + 1, 0);
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    if (pass == 1)
+    {
+      // Compute offsets and allocate
+      for (std::size_t k = 0; k < num_grid_cells; ++k)
+        _offsets[k + 1] += _offsets[k];
+      _cells.resize(_offsets[num_grid_cells]);
+    }
+
+    std::vector<std::size_t> position(_offsets.begin(), _offsets.end() - 1);
+    for (std::size_t i = 0; i < num_cells; ++i)
+    {
+      // Compute range of grid cells overlapped by bounding box
+      const double* b = _bboxes.data() + 2*_gdim*i;
+      for (std::size_t j = 0; j < _gdim; ++j)
+      {
+        const double l = std::floor((b[j] - _x_min[j])/_h[j]);
+        const double u = std::floor((b[_gdim + j] - _x_min[j])/_h[j]);
+        lo[j] = std::min<std::size_t>(std::max(l, 0.0), _num_cells[j] - 1);
+        hi[j] = std::min<std::size_t>(std::max(u, 0.0), _num_cells[j] - 1);
+      }
+
+      // Iterate over grid cells in range
+      std::vector<std::size_t> c(lo);
+      while (true)
+      {
+        std::size_t k = 0;
+        for (std::size_t j = _gdim; j-- > 0;)
+          k = k*_num_cells[j] + c[j];
+        if (pass == 0)
+          ++_offsets[k + 1];
+        else
+          _cells[position[k]++] = i;
+
+        // Next grid cell
+        std::size_t j = 0;
+        for (; j < _gdim; ++j)
+        {
+          if (c[j] < hi[j])
+          {
+            ++c[j];
+            break;
+          }
+          c[j] = lo[j];
+        }
+        if (j == _gdim)
+          break;
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+std::vector<unsigned int>
+BoundingBoxGrid::compute_collisions(const Point& point) const
+{
+  _check_built();
+
+  std::vector<unsigned int> entities;
+  const double* x = point.coordinates();
+  const long int k = _grid_cell(x);
+  if (k < 0)
+    return entities;
+
+  for (std::size_t i = _offsets[k]; i < _offsets[k + 1]; ++i)
+  {
+    if (_bbox_contains(_cells[i], x))
+      entities.push_back(_cells[i]);
+  }
+
+  return entities;
+}
+//-----------------------------------------------------------------------------
+std::vector<unsigned int>
+BoundingBoxGrid::compute_entity_collisions(const Point& point) const
+{
+  _check_built();
+
+  std::vector<unsigned int> entities;
+  const double* x = point.coordinates();
+  const long int k = _grid_cell(x);
+  if (k < 0)
+    return entities;
+
+  for (std::size_t i = _offsets[k]; i < _offsets[k + 1]; ++i)
+  {
+    const unsigned int c = _cells[i];
+    if (_bbox_contains(c, x) and Cell(*_mesh, c).collides(point))
+      entities.push_back(c);
+  }
+
+  return entities;
+}
+//-----------------------------------------------------------------------------
+unsigned int
+BoundingBoxGrid::compute_first_entity_collision(const Point& point) const
+{
+  _check_built();
+
+  const double* x = point.coordinates();
+  const long int k = _grid_cell(x);
+  if (k >= 0)
+  {
+    for (std::size_t i = _offsets[k]; i < _offsets[k + 1]; ++i)
+    {
+      const unsigned int c = _cells[i];
+      if (_bbox_contains(c, x) and Cell(*_mesh, c).collides(point))
+        return c;
+    }
+  }
+
+  return std::numeric_limits<unsigned int>::max();
+}
+//-----------------------------------------------------------------------------
+std::pair<unsigned int, double>
+BoundingBoxGrid::compute_closest_entity(const Point& point) const
+{
+  _check_built();
+
+  unsigned int closest_entity = std::numeric_limits<unsigned int>::max();
+  double R2 = std::numeric_limits<double>::max();
+  if (_cells.empty())
+    return std::make_pair(closest_entity, R2);
+
+  // Grid cell containing point (clamped to the grid)
+  const double* x = point.coordinates();
+  std::vector<long int> c0(_gdim);
+  double h_min = std::numeric_limits<double>::max();
+  std::size_t max_ring = 0;
+  for (std::size_t j = 0; j < _gdim; ++j)
+  {
+    const double l = std::floor((x[j] - _x_min[j])/_h[j]);
+    c0[j] = std::min<double>(std::max(l, 0.0), _num_cells[j] - 1);
+    if (_num_cells[j] > 1)
+      h_min = std::min(h_min, _h[j]);
+    max_ring = std::max(max_ring, _num_cells[j]);
+  }
+
+  // Search rings of grid cells around the point until all cells
+  // outside the searched rings are further away than the closest
+  // cell found. Cells in ring r + 1 are at least r*h_min away.
+  std::vector<long int> c(_gdim);
+  for (std::size_t r = 0; r < max_ring; ++r)
+  {
+    if (closest_entity != std::numeric_limits<unsigned int>::max()
+        and r > 0 and (r - 1)*h_min*(r - 1)*h_min > R2)
+    {
+      break;
+    }
+
+    // Iterate over the box of grid cells around c0 and visit those
+    // in ring r
+    const long int ring = r;
+    for (std::size_t j = 0; j < _gdim; ++j)
+      c[j] = c0[j] - ring;
+    while (true)
+    {
+      bool inside = true;
+      bool on_ring = false;
+      std::size_t k = 0;
+      for (std::size_t j = _gdim; j-- > 0;)
+      {
+        if (c[j] < 0 or c[j] >= (long int) _num_cells[j])
+          inside = false;
+        if (std::abs(c[j] - c0[j]) == ring)
+          on_ring = true;
+        k = k*_num_cells[j] + (inside ? c[j] : 0);
+      }
+
+      if (inside and (on_ring or ring == 0))
+      {
+        for (std::size_t i = _offsets[k]; i < _offsets[k + 1]; ++i)
+        {
+          const unsigned int e = _cells[i];
+          if (_bbox_squared_distance(e, x) > R2)
+            continue;
+          const double r2 = Cell(*_mesh, e).squared_distance(point);
+          if (r2 < R2)
+          {
+            closest_entity = e;
+            R2 = r2;
+          }
+        }
+      }
+
+      // Next grid cell in box
+      std::size_t j = 0;
+      for (; j < _gdim; ++j)
+      {
+        if (c[j] < c0[j] + ring)
+        {
+          ++c[j];
+          break;
+        }
+        c[j] = c0[j] - ring;
+      }
+      if (j == _gdim)
+        break;
+    }
+  }
+
+  return std::make_pair(closest_entity, std::sqrt(R2));
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxGrid::_check_built() const
+{
+  if (!_mesh)
+  {
+    dolfin_error("BoundingBoxGrid.cpp",
+                 "compute collisions with bounding box grid",
+                 "Bounding box grid has not been built. You need to call grid.build()");
+  }
+}
+//-----------------------------------------------------------------------------
+long int BoundingBoxGrid::_grid_cell(const double* x) const
+{
+  long int k = 0;
+  for (std::size_t j = _gdim; j-- > 0;)
+  {
+    const double l = std::floor((x[j] - _x_min[j])/_h[j]);
+    if (l < 0.0 or l > _num_cells[j])
+      return -1;
+
+    // Points on the upper boundary belong to the last grid cell
+    const long int c = std::min<long int>(l, _num_cells[j] - 1);
+    k = k*_num_cells[j] + c;
+  }
+  return k;
+}
+//-----------------------------------------------------------------------------
+bool BoundingBoxGrid::_bbox_contains(unsigned int cell, const double* x) const
+{
+  const double* b = _bboxes.data() + 2*_gdim*cell;
+  for (std::size_t j = 0; j < _gdim; ++j)
+  {
+    if (x[j] < b[j] or x[j] > b[_gdim + j])
+      return false;
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------
+double BoundingBoxGrid::_bbox_squared_distance(unsigned int cell,
+                                               const double* x) const
+{
+  const double* b = _bboxes.data() + 2*_gdim*cell;
+  double r2 = 0.0;
+  for (std::size_t j = 0; j < _gdim; ++j)
+  {
+    if (x[j] < b[j])
+      r2 += (b[j] - x[j])*(b[j] - x[j]);
+    else if (x[j] > b[_gdim + j])
+      r2 += (x[j] - b[_gdim + j])*(x[j] - b[_gdim + j]);
+  }
+  return r2;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,153 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __BOUNDING_BOX_GRID_H
+#define __BOUNDING_BOX_GRID_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Mesh;
+  class Point;
+
+  /// This class implements a uniform grid of cell bounding boxes
+  /// for point location. Each grid cell stores the mesh cells whose
+  /// bounding boxes overlap it, so that point queries only need to
+  /// check the mesh cells of one grid cell. The size of the grid
+  /// cells is chosen such that the grid has about as many cells as
+  /// the mesh. This gives constant time point lookups for
+  /// structured and near uniform meshes, for which it is an
+  /// alternative to the tree search of BoundingBoxTree (see
+  /// Mesh::set_point_locator).
+
+  class BoundingBoxGrid
+  {
+  public:
+
+    /// Create empty grid
+    BoundingBoxGrid();
+
+    /// Build grid for the cells of mesh.
+    ///
+    /// *Arguments*
+    ///     mesh (_Mesh_)
+    ///         The mesh for which to compute the grid.
+    void build(const Mesh& mesh);
+
+    /// Compute all cells whose bounding boxes collide with _Point_.
+    ///
+    /// *Returns*
+    ///     std::vector<unsigned int>
+    ///         A list of local indices for cells whose bounding
+    ///         boxes collide with (intersect) the given point.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    std::vector<unsigned int>
+    compute_collisions(const Point& point) const;
+
+    /// Compute all collisions between cells and _Point_.
+    ///
+    /// *Returns*
+    ///     std::vector<unsigned int>
+    ///         A list of local indices for cells that collide with
+    ///         (intersect) the given point.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    std::vector<unsigned int>
+    compute_entity_collisions(const Point& point) const;
+
+    /// Compute first collision between cells and _Point_.
+    ///
+    /// *Returns*
+    ///     unsigned int
+    ///         The local index for the first found cell that
+    ///         collides with (intersects) the given point. If not
+    ///         found, std::numeric_limits<unsigned int>::max() is
+    ///         returned.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    unsigned int compute_first_entity_collision(const Point& point) const;
+
+    /// Compute closest cell and distance to _Point_.
+    ///
+    /// *Returns*
+    ///     unsigned int
+    ///         The local index for the cell that is closest to the
+    ///         point. If more than one cell is at the same distance
+    ///         one of them is returned.
+    ///     double
+    ///         The distance to the closest cell.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    std::pair<unsigned int, double>
+    compute_closest_entity(const Point& point) const;
+
+    /// Return number of grid cells along given axis
+    std::size_t size(std::size_t axis) const
+    { return _num_cells[axis]; }
+
+  private:
+
+    // Check that grid has been built
+    void _check_built() const;
+
+    // Return grid cell index of point, or -1 if outside grid
+    long int _grid_cell(const double* x) const;
+
+    // Check whether point is inside bounding box of cell
+    bool _bbox_contains(unsigned int cell, const double* x) const;
+
+    // Squared distance from point to bounding box of cell
+    double _bbox_squared_distance(unsigned int cell, const double* x) const;
+
+    // The mesh
+    const Mesh* _mesh;
+
+    // Geometric dimension
+    std::size_t _gdim;
+
+    // Lower corner of grid, inverse size of grid cells and number of
+    // grid cells along each axis
+    std::vector<double> _x_min;
+    std::vector<double> _h;
+    std::vector<std::size_t> _num_cells;
+
+    // Bounding boxes of mesh cells (min and max coordinates)
+    std::vector<double> _bboxes;
+
+    // Mesh cells overlapping each grid cell (CSR layout)
+    std::vector<std::size_t> _offsets;
+    std::vector<unsigned int> _cells;
+
+  };
+
+}
+
+#endif
@@ -25,12 +25,13 @@
 #include "BoundingBoxTree1D.h"
 #include "BoundingBoxTree2D.h"
 #include "BoundingBoxTree3D.h"
+#include "BoundingBoxGrid.h"
 #include "BoundingBoxTree.h"
 
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-BoundingBoxTree::BoundingBoxTree() : _mesh(0)
+BoundingBoxTree::BoundingBoxTree() : _tdim(0), _mesh(0), _geometry_state(0)
 {
   // Do nothing
 }
@@ -53,9 +54,44 @@ void BoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
   // Build tree
   dolfin_assert(_tree);
   _tree->build(mesh, tdim);
+  _grid.reset();
 
   // Store mesh
   _mesh = &mesh;
+  _tdim = tdim;
+  _geometry_state = mesh.geometry().state();
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::refit(bool update_process_tree)
+{
+  // Check that tree has been built for a mesh
+  if (!_mesh)
+  {
+    dolfin_error("BoundingBoxTree.cpp",
+                 "refit bounding box tree",
+                 "Bounding box tree has not been built for a mesh");
+  }
+
+  // Update tree
+  dolfin_assert(_tree);
+  _tree->refit(*_mesh, update_process_tree);
+  if (_grid)
+    _grid->build(*_mesh);
+  _geometry_state = _mesh->geometry().state();
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::build_grid()
+{
+  // Check that tree has been built for the cells of a mesh
+  if (!_mesh or _tdim != _mesh->topology().dim())
+  {
+    dolfin_error("BoundingBoxTree.cpp",
+                 "build bounding box grid",
+                 "Bounding box tree has not been built for the cells of a mesh");
+  }
+
+  _grid.reset(new BoundingBoxGrid());
+  _grid->build(*_mesh);
 }
 //-----------------------------------------------------------------------------
 void BoundingBoxTree::build(const std::vector<Point>& points, std::size_t gdim)
@@ -82,6 +118,7 @@ void BoundingBoxTree::build(const std::vector<Point>& points, std::size_t gdim)
   // Build tree
   dolfin_assert(_tree);
   _tree->build(points);
+  _grid.reset();
 }
 //-----------------------------------------------------------------------------
 std::vector<unsigned int>
@@ -113,6 +150,10 @@ BoundingBoxTree::compute_entity_collisions(const Point& point) const
   // Check that tree has been built
   _check_built();
 
+  // Use grid if available
+  if (_grid)
+    return _grid->compute_entity_collisions(point);
+
   // Delegate call to implementation
   dolfin_assert(_tree);
   dolfin_assert(_mesh);
@@ -144,6 +185,23 @@ std::pair<std::vector<unsigned int>, std::vector<unsigned int>>
   return _tree->compute_entity_collisions(*tree._tree, *_mesh, *tree._mesh);
 }
 //-----------------------------------------------------------------------------
+std::tuple<std::vector<unsigned int>, std::vector<unsigned int>,
+           std::vector<unsigned int>>
+BoundingBoxTree::compute_distributed_entity_collisions(
+  const BoundingBoxTree& tree) const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  dolfin_assert(tree._tree);
+  dolfin_assert(_mesh);
+  dolfin_assert(tree._mesh);
+  return _tree->compute_distributed_entity_collisions(*tree._tree, *_mesh,
+                                                      *tree._mesh);
+}
+//-----------------------------------------------------------------------------
 unsigned int
 BoundingBoxTree::compute_first_collision(const Point& point) const
 {
@@ -161,6 +219,10 @@ BoundingBoxTree::compute_first_entity_collision(const Point& point) const
   // Check that tree has been built
   _check_built();
 
+  // Use grid if available
+  if (_grid)
+    return _grid->compute_first_entity_collision(point);
+
   // Delegate call to implementation
   dolfin_assert(_tree);
   dolfin_assert(_mesh);
@@ -173,6 +235,10 @@ BoundingBoxTree::compute_closest_entity(const Point& point) const
   // Check that tree has been built
   _check_built();
 
+  // Use grid if available
+  if (_grid)
+    return _grid->compute_closest_entity(point);
+
   // Delegate call to implementation
   dolfin_assert(_tree);
   dolfin_assert(_mesh);
@@ -180,6 +246,19 @@ BoundingBoxTree::compute_closest_entity(const Point& point) const
 }
 //-----------------------------------------------------------------------------
 std::pair<unsigned int, double>
+BoundingBoxTree::compute_closest_entity(const Point& point,
+                                        unsigned int guess) const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  dolfin_assert(_mesh);
+  return _tree->compute_closest_entity(point, *_mesh, guess);
+}
+//-----------------------------------------------------------------------------
+std::pair<unsigned int, double>
 BoundingBoxTree::compute_closest_point(const Point& point) const
 {
   // Check that tree has been built
@@ -200,6 +279,16 @@ bool BoundingBoxTree::collides_entity(const Point& point) const
   return compute_first_entity_collision(point) != std::numeric_limits<unsigned int>::max();
 }
 //-----------------------------------------------------------------------------
+std::size_t BoundingBoxTree::nodes_visited()
+{
+  return GenericBoundingBoxTree::nodes_visited();
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::reset_nodes_visited()
+{
+  GenericBoundingBoxTree::reset_nodes_visited();
+}
+//-----------------------------------------------------------------------------
 void BoundingBoxTree::_check_built() const
 {
   if (!_tree)
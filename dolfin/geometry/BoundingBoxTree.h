@@ -24,6 +24,7 @@
 #include <limits>
 #include <vector>
 #include <memory>
+#include <tuple>
 
 namespace dolfin
 {
@@ -31,6 +32,7 @@ namespace dolfin
   // Forward declarations
   class Point;
   class GenericBoundingBoxTree;
+  class BoundingBoxGrid;
   class Mesh;
 
   /// This class implements a (distributed) axis aligned bounding box
@@ -73,6 +75,33 @@ namespace dolfin
     ///         The geometric dimension.
     void build(const std::vector<Point>& points, std::size_t gdim);
 
+    /// Update bounding boxes after the coordinates of the mesh for
+    /// which the tree was built have changed, without rebuilding the
+    /// tree. The mesh topology must be unchanged. The tree remains
+    /// valid but may be less efficient for large deformations.
+    ///
+    /// *Arguments*
+    ///     update_process_tree (bool)
+    ///         Also update the tree of process bounding boxes used
+    ///         by compute_process_collisions (collective).
+    void refit(bool update_process_tree=true);
+
+    /// Build a uniform grid of cell bounding boxes (see
+    /// _BoundingBoxGrid_), which is then used instead of the tree for
+    /// the point queries compute_entity_collisions,
+    /// compute_first_entity_collision and compute_closest_entity.
+    /// The tree must have been built for the cells of a mesh.
+    void build_grid();
+
+    /// Return state of mesh geometry when the tree was last built
+    /// or refitted (see MeshGeometry::state)
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The geometry state counter.
+    std::size_t geometry_state() const
+    { return _geometry_state; }
+
     /// Compute all collisions between bounding boxes and _Point_.
     ///
     /// *Returns*
@@ -168,6 +197,41 @@ namespace dolfin
     std::pair<std::vector<unsigned int>, std::vector<unsigned int> >
     compute_entity_collisions(const BoundingBoxTree& tree) const;
 
+    /// Compute all collisions between the owned cells of this tree
+    /// and the owned cells of another tree on all processes, for two
+    /// distributed meshes that are partitioned independently
+    /// (collective). Both trees must be built for the cells of
+    /// triangle meshes in 2D or tetrahedron meshes in 3D.
+    ///
+    /// The trees of process bounding boxes of the other tree are used
+    /// to send each owned cell only to the processes whose bounding
+    /// box it intersects, so that the communication and work scale
+    /// with the size of the overlap rather than with the size of the
+    /// meshes. Ghost cells are ignored, so each colliding pair of
+    /// cells is found exactly once.
+    ///
+    /// *Returns*
+    ///     std::vector<unsigned int>
+    ///         A list of local indices for cells in this tree that
+    ///         collide with cells in other tree.
+    ///     std::vector<unsigned int>
+    ///         A list of the processes owning the colliding cells in
+    ///         other tree.
+    ///     std::vector<unsigned int>
+    ///         A list of local indices (on these processes) for cells
+    ///         in other tree that collide with cells in this tree.
+    ///
+    /// The three lists have equal length, such that cell `i` in the
+    /// first list collides with the cell in the third list with
+    /// index `i` on the process given by the second list.
+    ///
+    /// *Arguments*
+    ///     tree (_BoundingBoxTree_)
+    ///         The bounding box tree.
+    std::tuple<std::vector<unsigned int>, std::vector<unsigned int>,
+               std::vector<unsigned int>>
+    compute_distributed_entity_collisions(const BoundingBoxTree& tree) const;
+
     /// Compute first collision between bounding boxes and _Point_.
     ///
     /// *Returns*
@@ -215,6 +279,28 @@ namespace dolfin
     std::pair<unsigned int, double>
     compute_closest_entity(const Point& point) const;
 
+    /// Compute closest entity to _Point_, starting the search from
+    /// the distance to a given entity. This is faster than the above
+    /// function when the closest entity of a nearby point is known,
+    /// e.g. when computing distances for a sequence of nearby
+    /// points.
+    ///
+    /// *Returns*
+    ///     unsigned int
+    ///         The local index for the entity that is closest to the
+    ///         point. If more than one entity is at the same distance,
+    ///         then the guess is returned if it is one of them.
+    ///     double
+    ///         The distance to the closest entity.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    ///     guess (unsigned int)
+    ///         The local index of the initial guess.
+    std::pair<unsigned int, double>
+    compute_closest_entity(const Point& point, unsigned int guess) const;
+
     /// Compute closest point to _Point_. This function assumes
     /// that the tree has been built for a point cloud.
     ///
@@ -259,6 +345,19 @@ namespace dolfin
     ///         True iff the point is inside the tree.
     bool collides_entity(const Point& point) const;
 
+    /// Return number of tree nodes visited by queries on the calling
+    /// thread since the last reset (for benchmarking). Tree-tree
+    /// queries count visited pairs of nodes. Queries answered by
+    /// the grid (see build_grid) are not counted.
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The number of visited nodes.
+    static std::size_t nodes_visited();
+
+    /// Reset number of visited tree nodes on the calling thread
+    static void reset_nodes_visited();
+
   private:
 
     // Check that tree has been built
@@ -267,12 +366,21 @@ namespace dolfin
     // Dimension-dependent implementation
     std::shared_ptr<GenericBoundingBoxTree> _tree;
 
+    // Optional uniform grid for point queries against cells
+    std::shared_ptr<BoundingBoxGrid> _grid;
+
+    // Topological dimension of entities in tree
+    std::size_t _tdim;
+
     // Pointer to the mesh. We all know that we don't really want
     // to store a pointer to the mesh here, but without it we will
     // be forced to make calls like
     // tree_A.compute_entity_intersections(tree_B, mesh_A, mesh_B).
     const Mesh* _mesh;
 
+    // State of mesh geometry when the tree was last built or refitted
+    std::size_t _geometry_state;
+
   };
 
 }
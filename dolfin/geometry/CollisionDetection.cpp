@@ -56,12 +56,92 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <dolfin/mesh/MeshEntity.h>
 #include "Point.h"
 #include "CollisionDetection.h"
 
 using namespace dolfin;
 
+namespace
+{
+  const std::size_t W = CollisionDetection::packet_size;
+
+  // Remove the candidates that are separated from the simplex along
+  // the axis n[d][k] of each candidate k. Returns true if any
+  // candidate remains.
+  bool separate(std::size_t gdim, const double n[3][W],
+                const double* simplex, const double* packet, int* alive)
+  {
+    const std::size_t num_vertices = gdim + 1;
+    const double inf = std::numeric_limits<double>::max();
+    double s_min[W], s_max[W], c_min[W], c_max[W];
+    for (std::size_t k = 0; k < W; ++k)
+    {
+      s_min[k] = inf;
+      s_max[k] = -inf;
+      c_min[k] = inf;
+      c_max[k] = -inf;
+    }
+
+    // Project vertices of simplex and candidates
+    for (std::size_t v = 0; v < num_vertices; ++v)
+    {
+      double s[W], c[W];
+      for (std::size_t k = 0; k < W; ++k)
+      {
+        s[k] = 0.0;
+        c[k] = 0.0;
+      }
+      for (std::size_t d = 0; d < gdim; ++d)
+      {
+        const double x = simplex[v*gdim + d];
+        const double* y = packet + (v*gdim + d)*W;
+        for (std::size_t k = 0; k < W; ++k)
+        {
+          s[k] += n[d][k]*x;
+          c[k] += n[d][k]*y[k];
+        }
+      }
+      for (std::size_t k = 0; k < W; ++k)
+      {
+        s_min[k] = std::min(s_min[k], s[k]);
+        s_max[k] = std::max(s_max[k], s[k]);
+        c_min[k] = std::min(c_min[k], c[k]);
+        c_max[k] = std::max(c_max[k], c[k]);
+      }
+    }
+
+    // Separated if the projected intervals are disjoint (with a
+    // tolerance relative to the projected values)
+    int any = 0;
+    for (std::size_t k = 0; k < W; ++k)
+    {
+      const double tol = DOLFIN_EPS*(std::abs(s_min[k]) + std::abs(s_max[k])
+                                     + std::abs(c_min[k]) + std::abs(c_max[k]));
+      alive[k] &= (c_max[k] >= s_min[k] - tol) & (c_min[k] <= s_max[k] + tol);
+      any |= alive[k];
+    }
+    return any != 0;
+  }
+
+  // Coordinates of edge (difference of vertices j and i) of simplex
+  // and of candidates
+  inline double edge(const double* simplex, std::size_t gdim, std::size_t i,
+                     std::size_t j, std::size_t d)
+  {
+    return simplex[j*gdim + d] - simplex[i*gdim + d];
+  }
+
+  inline double edge(const double* packet, std::size_t gdim, std::size_t i,
+                     std::size_t j, std::size_t d, std::size_t k)
+  {
+    return packet[(j*gdim + d)*W + k] - packet[(i*gdim + d)*W + k];
+  }
+}
+
 //-----------------------------------------------------------------------------
 bool CollisionDetection::collides(const MeshEntity& entity,
                                   const Point& point)
@@ -1156,3 +1236,121 @@ bool CollisionDetection::separating_plane_edge_A(
   return true;
 }
 //-----------------------------------------------------------------------------
+std::size_t
+CollisionDetection::collides_simplex_packet(std::size_t tdim,
+                                            const double* simplex,
+                                            const double* packet,
+                                            std::size_t num_candidates,
+                                            bool* collides)
+{
+  if (tdim != 2 and tdim != 3)
+  {
+    dolfin_error("CollisionDetection.cpp",
+                 "compute collisions with packet of simplices",
+                 "Only triangles in 2D and tetrahedra in 3D are supported");
+  }
+  dolfin_assert(num_candidates <= W);
+
+  int alive[W];
+  for (std::size_t k = 0; k < W; ++k)
+    alive[k] = k < num_candidates;
+
+  double n[3][W];
+  bool any = num_candidates > 0;
+  if (tdim == 2)
+  {
+    // Edge normals of simplex and of candidates
+    for (std::size_t i = 0; i < 3 and any; ++i)
+    {
+      const std::size_t j = (i + 1) % 3;
+      const double n0 = -edge(simplex, 2, i, j, 1);
+      const double n1 = edge(simplex, 2, i, j, 0);
+      for (std::size_t k = 0; k < W; ++k)
+      {
+        n[0][k] = n0;
+        n[1][k] = n1;
+      }
+      any = separate(2, n, simplex, packet, alive);
+    }
+    for (std::size_t i = 0; i < 3 and any; ++i)
+    {
+      const std::size_t j = (i + 1) % 3;
+      for (std::size_t k = 0; k < W; ++k)
+      {
+        n[0][k] = -edge(packet, 2, i, j, 1, k);
+        n[1][k] = edge(packet, 2, i, j, 0, k);
+      }
+      any = separate(2, n, simplex, packet, alive);
+    }
+  }
+  else
+  {
+    // Face normals of simplex and of candidates (face opposite
+    // vertex i has vertices f[i][0..2])
+    const std::size_t f[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+    for (std::size_t i = 0; i < 4 and any; ++i)
+    {
+      double a[3], b[3];
+      for (std::size_t d = 0; d < 3; ++d)
+      {
+        a[d] = edge(simplex, 3, f[i][0], f[i][1], d);
+        b[d] = edge(simplex, 3, f[i][0], f[i][2], d);
+      }
+      for (std::size_t k = 0; k < W; ++k)
+      {
+        n[0][k] = a[1]*b[2] - a[2]*b[1];
+        n[1][k] = a[2]*b[0] - a[0]*b[2];
+        n[2][k] = a[0]*b[1] - a[1]*b[0];
+      }
+      any = separate(3, n, simplex, packet, alive);
+    }
+    for (std::size_t i = 0; i < 4 and any; ++i)
+    {
+      for (std::size_t k = 0; k < W; ++k)
+      {
+        const double a0 = edge(packet, 3, f[i][0], f[i][1], 0, k);
+        const double a1 = edge(packet, 3, f[i][0], f[i][1], 1, k);
+        const double a2 = edge(packet, 3, f[i][0], f[i][1], 2, k);
+        const double b0 = edge(packet, 3, f[i][0], f[i][2], 0, k);
+        const double b1 = edge(packet, 3, f[i][0], f[i][2], 1, k);
+        const double b2 = edge(packet, 3, f[i][0], f[i][2], 2, k);
+        n[0][k] = a1*b2 - a2*b1;
+        n[1][k] = a2*b0 - a0*b2;
+        n[2][k] = a0*b1 - a1*b0;
+      }
+      any = separate(3, n, simplex, packet, alive);
+    }
+
+    // Cross products of edges of simplex and candidates (zero for
+    // parallel edges, which then do not separate)
+    const std::size_t e[6][2] = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+    for (std::size_t i = 0; i < 6 and any; ++i)
+    {
+      const double a0 = edge(simplex, 3, e[i][0], e[i][1], 0);
+      const double a1 = edge(simplex, 3, e[i][0], e[i][1], 1);
+      const double a2 = edge(simplex, 3, e[i][0], e[i][1], 2);
+      for (std::size_t j = 0; j < 6 and any; ++j)
+      {
+        for (std::size_t k = 0; k < W; ++k)
+        {
+          const double b0 = edge(packet, 3, e[j][0], e[j][1], 0, k);
+          const double b1 = edge(packet, 3, e[j][0], e[j][1], 1, k);
+          const double b2 = edge(packet, 3, e[j][0], e[j][1], 2, k);
+          n[0][k] = a1*b2 - a2*b1;
+          n[1][k] = a2*b0 - a0*b2;
+          n[2][k] = a0*b1 - a1*b0;
+        }
+        any = separate(3, n, simplex, packet, alive);
+      }
+    }
+  }
+
+  std::size_t num_collisions = 0;
+  for (std::size_t k = 0; k < num_candidates; ++k)
+  {
+    collides[k] = alive[k] != 0;
+    num_collisions += alive[k] != 0;
+  }
+  return num_collisions;
+}
+//-----------------------------------------------------------------------------
@@ -149,6 +149,40 @@ namespace dolfin
     static bool collides_edge_edge(const Point& a, const Point& b,
 				   const Point& c, const Point& d);
 
+    /// Number of candidates in a packet for collides_simplex_packet
+    static const std::size_t packet_size = 8;
+
+    /// Check whether a simplex collides with each simplex of a packet
+    /// of candidates, for triangles in 2D or tetrahedra in 3D. The
+    /// candidates are tested together by the separating axis test
+    /// (edge normals in 2D; face normals and cross products of edges
+    /// in 3D), with the loops over the candidates written over
+    /// structure-of-arrays coordinates so that they are vectorised,
+    /// and an early exit when all candidates are separated.
+    /// Touching simplices collide.
+    ///
+    /// @param    tdim (std::size_t)
+    ///         The topological and geometric dimension (2 or 3).
+    /// @param    simplex (double*)
+    ///         The vertex coordinates of the simplex, (tdim + 1) x tdim.
+    /// @param    packet (double*)
+    ///         The vertex coordinates of the candidates, where
+    ///         packet[(v*tdim + d)*packet_size + k] is coordinate d of
+    ///         vertex v of candidate k.
+    /// @param    num_candidates (std::size_t)
+    ///         The number of candidates (at most packet_size).
+    /// @param    collides (bool*)
+    ///         Set to true for the candidates colliding with the
+    ///         simplex.
+    ///
+    /// @return   std::size_t
+    ///         The number of colliding candidates.
+    static std::size_t collides_simplex_packet(std::size_t tdim,
+                                               const double* simplex,
+                                               const double* packet,
+                                               std::size_t num_candidates,
+                                               bool* collides);
+
 
     /// The implementation of collides_interval_point
     static bool collides_interval_point(const Point& p0, const Point& p1,
@@ -18,26 +18,90 @@
 // First added:  2013-05-02
 // Last changed: 2014-02-06
 
-// Define a maximum dimension used for a local array in the recursive
-// build function. Speeds things up compared to allocating it in each
-// recursion and is more convenient than sending it around.
-#define MAX_DIM 6
-
+// Minimum number of leaves in a subtree for building it as a
+// separate OpenMP task
+#define BUILD_TASK_SIZE 4096
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
 #include <dolfin/common/MPI.h>
+#include <dolfin/common/SubSystemsManager.h>
+#include <dolfin/common/constants.h>
 #include <dolfin/geometry/Point.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/MeshEntity.h>
 #include <dolfin/mesh/MeshEntityIterator.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "BoundingBoxTree1D.h" // used for internal point search tree
 #include "BoundingBoxTree2D.h" // used for internal point search tree
 #include "BoundingBoxTree3D.h" // used for internal point search tree
+#include "CollisionDetection.h"
 #include "GenericBoundingBoxTree.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Number of nodes visited by queries on calling thread
+  thread_local std::size_t num_nodes_visited = 0;
+
+  // Check whether mesh is a triangle mesh in 2D or a tetrahedron
+  // mesh in 3D
+  bool is_simplex_mesh(const Mesh& mesh)
+  {
+    const std::size_t tdim = mesh.topology().dim();
+    const CellType::Type cell_type = mesh.type().cell_type();
+    return tdim == mesh.geometry().dim()
+      and ((tdim == 2 and cell_type == CellType::triangle)
+           or (tdim == 3 and cell_type == CellType::tetrahedron));
+  }
+
+  // Get vertex coordinates of all cells of simplex mesh
+  void get_simplex_coordinates(std::vector<double>& coordinates,
+                               const Mesh& mesh)
+  {
+    const std::size_t tdim = mesh.topology().dim();
+    const std::size_t gdim = mesh.geometry().dim();
+    const std::size_t num_cells = mesh.num_cells();
+    const MeshConnectivity& cells = mesh.topology()(tdim, 0);
+    coordinates.resize(num_cells*(tdim + 1)*gdim);
+    double* y = coordinates.data();
+    for (std::size_t c = 0; c < num_cells; ++c)
+    {
+      const unsigned int* vertices = cells(c);
+      for (std::size_t v = 0; v <= tdim; ++v)
+      {
+        const double* x = mesh.geometry().x(vertices[v]);
+        y = std::copy(x, x + gdim, y);
+      }
+    }
+  }
+
+  // Remove candidate pairs that do not collide, keeping the order
+  void remove_non_collisions(const std::vector<char>& collides,
+                             std::vector<unsigned int>& entities_A,
+                             std::vector<unsigned int>& entities_B)
+  {
+    std::size_t num_collisions = 0;
+    for (std::size_t i = 0; i < collides.size(); ++i)
+    {
+      if (collides[i])
+      {
+        entities_A[num_collisions] = entities_A[i];
+        entities_B[num_collisions] = entities_B[i];
+        ++num_collisions;
+      }
+    }
+    entities_A.resize(num_collisions);
+    entities_B.resize(num_collisions);
+  }
+}
+
 //-----------------------------------------------------------------------------
-GenericBoundingBoxTree::GenericBoundingBoxTree() : _tdim(0)
+GenericBoundingBoxTree::GenericBoundingBoxTree() : _tdim(0), _wide_width(0)
 {
   // Do nothing
 }
@@ -92,21 +156,98 @@ void GenericBoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
   const std::size_t _gdim = gdim();
   const unsigned int num_leaves = mesh.num_entities(tdim);
   std::vector<double> leaf_bboxes(2*_gdim*num_leaves);
-  for (MeshEntityIterator it(mesh, tdim); !it.end(); ++it)
-    compute_bbox_of_entity(leaf_bboxes.data() + 2*_gdim*it->index(), *it, _gdim);
+  compute_leaf_bboxes(leaf_bboxes, mesh);
 
   // Create leaf partition (to be sorted)
   std::vector<unsigned int> leaf_partition(num_leaves);
   for (unsigned int i = 0; i < num_leaves; ++i)
     leaf_partition[i] = i;
 
-  // Recursively build the bounding box tree from the leaves
-  _build(leaf_bboxes, leaf_partition.begin(), leaf_partition.end(), _gdim);
+  // Recursively build the bounding box tree from the leaves. Each
+  // subtree is written to a known range of nodes, so that subtrees
+  // can be built in parallel.
+  if (num_leaves > 0)
+  {
+    _bboxes.resize(2*num_leaves - 1);
+    _bbox_coordinates.resize(2*_gdim*(2*num_leaves - 1));
+    #ifdef HAS_OPENMP
+    const int num_threads = SubSystemsManager::num_threads();
+    #pragma omp parallel num_threads(num_threads)
+    #pragma omp single
+    #endif
+    _build(leaf_bboxes, leaf_partition.begin(), leaf_partition.end(), _gdim,
+           0);
+  }
 
   log(PROGRESS,
       "Computed bounding box tree with %d nodes for %d entities.",
       num_bboxes(), num_leaves);
 
+  // Build wide tree for point queries if requested
+  build_wide_tree();
+
+  // Build global tree of process bounding boxes
+  build_global_tree(mesh);
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::refit(const Mesh& mesh, bool update_global)
+{
+  // Check that the tree has been built for the entities of this mesh
+  const std::size_t _gdim = gdim();
+  const unsigned int num_leaves = (num_bboxes() + 1)/2;
+  if (_tdim == 0 or num_bboxes() == 0
+      or mesh.num_entities(_tdim) != num_leaves)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "refit bounding box tree",
+                 "Tree has not been built for entities of dimension %d of this mesh",
+                 (int) _tdim);
+  }
+
+  // Recompute leaf bounding boxes
+  std::vector<double> leaf_bboxes(2*_gdim*num_leaves);
+  compute_leaf_bboxes(leaf_bboxes, mesh);
+
+  // Update nodes bottom-up. Children are stored before their parent,
+  // so a single sweep suffices.
+  for (unsigned int node = 0; node < num_bboxes(); ++node)
+  {
+    const BBox& bbox = _bboxes[node];
+    double* b = _bbox_coordinates.data() + 2*_gdim*node;
+    if (is_leaf(bbox, node))
+    {
+      const double* leaf = leaf_bboxes.data() + 2*_gdim*bbox.child_1;
+      std::copy(leaf, leaf + 2*_gdim, b);
+    }
+    else
+    {
+      const double* b0 = _bbox_coordinates.data() + 2*_gdim*bbox.child_0;
+      const double* b1 = _bbox_coordinates.data() + 2*_gdim*bbox.child_1;
+      for (std::size_t d = 0; d < _gdim; ++d)
+      {
+        b[d] = std::min(b0[d], b1[d]);
+        b[_gdim + d] = std::max(b0[_gdim + d], b1[_gdim + d]);
+      }
+    }
+  }
+
+  log(PROGRESS, "Refitted bounding box tree with %d nodes.", num_bboxes());
+
+  // Point search tree is built from cell midpoints, so rebuild on
+  // demand
+  _point_search_tree.reset();
+
+  // Update wide and global trees
+  build_wide_tree();
+  if (update_global)
+    build_global_tree(mesh);
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::build_global_tree(const Mesh& mesh)
+{
+  _global_tree.reset();
+
+  const std::size_t _gdim = gdim();
   const std::size_t mpi_size = MPI::size(mesh.mpi_comm());
   if (mpi_size > 1)
   {
@@ -120,8 +261,11 @@ void GenericBoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
       global_leaves[i] = i;
 
     _global_tree = create(_gdim);
+    _global_tree->_bboxes.resize(2*mpi_size - 1);
+    _global_tree->_bbox_coordinates.resize(2*_gdim*(2*mpi_size - 1));
     _global_tree->_build(recv_bbox,
-                         global_leaves.begin(), global_leaves.end(), _gdim);
+                         global_leaves.begin(), global_leaves.end(), _gdim,
+                         0);
 
     info("Computed global bounding box tree with %d boxes.",
          _global_tree->num_bboxes());
@@ -144,18 +288,41 @@ void GenericBoundingBoxTree::build(const std::vector<Point>& points)
     leaf_partition[i] = i;
 
   // Recursively build the bounding box tree from the leaves
-  _build(points, leaf_partition.begin(), leaf_partition.end(), gdim());
+  if (num_leaves > 0)
+  {
+    _bboxes.resize(2*num_leaves - 1);
+    _bbox_coordinates.resize(2*gdim()*(2*num_leaves - 1));
+    #ifdef HAS_OPENMP
+    const int num_threads = SubSystemsManager::num_threads();
+    #pragma omp parallel num_threads(num_threads)
+    #pragma omp single
+    #endif
+    _build(points, leaf_partition.begin(), leaf_partition.end(), gdim(), 0);
+  }
 
   info("Computed bounding box tree with %d nodes for %d points.",
        num_bboxes(), num_leaves);
+
+  // Build wide tree for point queries if requested
+  build_wide_tree();
 }
 //-----------------------------------------------------------------------------
 std::vector<unsigned int>
 GenericBoundingBoxTree::compute_collisions(const Point& point) const
 {
-  // Call recursive find function
   std::vector<unsigned int> entities;
-  _compute_collisions(*this, point, num_bboxes() - 1, entities, 0);
+  switch (_wide_width)
+  {
+  case 4:
+    _wide_compute_collisions<4>(point, entities, 0);
+    break;
+  case 8:
+    _wide_compute_collisions<8>(point, entities, 0);
+    break;
+  default:
+    // Call recursive find function
+    _compute_collisions(*this, point, num_bboxes() - 1, entities, 0);
+  }
 
   return entities;
 }
@@ -192,9 +359,19 @@ GenericBoundingBoxTree::compute_entity_collisions(const Point& point,
                  "Point-in-entity is only implemented for cells");
   }
 
-  // Call recursive find function to compute bounding box candidates
   std::vector<unsigned int> entities;
-  _compute_collisions(*this, point, num_bboxes() - 1, entities, &mesh);
+  switch (_wide_width)
+  {
+  case 4:
+    _wide_compute_collisions<4>(point, entities, &mesh);
+    break;
+  case 8:
+    _wide_compute_collisions<8>(point, entities, &mesh);
+    break;
+  default:
+    // Call recursive find function to compute bounding box candidates
+    _compute_collisions(*this, point, num_bboxes() - 1, entities, &mesh);
+  }
 
   return entities;
 }
@@ -226,19 +403,194 @@ GenericBoundingBoxTree::compute_entity_collisions(
   std::vector<unsigned int> entities_A;
   std::vector<unsigned int> entities_B;
 
-  // Call recursive find function
+  // Call recursive find function to compute bounding box candidates,
+  // then check the candidates
   _compute_collisions(A, B,
                       A.num_bboxes() - 1, B.num_bboxes() - 1,
-                      entities_A, entities_B, &mesh_A, &mesh_B);
+                      entities_A, entities_B, 0, 0);
+  _filter_entity_collisions(mesh_A, mesh_B, entities_A, entities_B);
 
   return std::make_pair(entities_A, entities_B);
 }
 //-----------------------------------------------------------------------------
+std::tuple<std::vector<unsigned int>, std::vector<unsigned int>,
+           std::vector<unsigned int>>
+GenericBoundingBoxTree::compute_distributed_entity_collisions(
+  const GenericBoundingBoxTree& tree,
+  const Mesh& mesh_A,
+  const Mesh& mesh_B) const
+{
+  // Introduce new variables for clarity
+  const GenericBoundingBoxTree& A(*this);
+  const GenericBoundingBoxTree& B(tree);
+
+  const MPI_Comm comm = mesh_A.mpi_comm();
+  const std::size_t tdim = mesh_A.topology().dim();
+  const std::size_t gdim = mesh_A.geometry().dim();
+  if (!is_simplex_mesh(mesh_A) or !is_simplex_mesh(mesh_B)
+      or mesh_B.topology().dim() != tdim)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute distributed collisions between mesh entities",
+                 "Only implemented for two triangle meshes in 2D or two tetrahedron meshes in 3D");
+  }
+  if (A._tdim != tdim or B._tdim != tdim)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute distributed collisions between mesh entities",
+                 "Trees must be built for the cells of the meshes");
+  }
+  if (MPI::size(comm) != MPI::size(mesh_B.mpi_comm()))
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute distributed collisions between mesh entities",
+                 "Meshes must be distributed over the same processes");
+  }
+
+  // Find the processes whose part of mesh B may collide with the
+  // cells of A, using the tree of process bounding boxes of B
+  std::vector<unsigned int> cells_A;
+  std::vector<unsigned int> processes;
+  if (A.num_bboxes() > 0 and B._global_tree)
+  {
+    _compute_collisions(A, *B._global_tree,
+                        A.num_bboxes() - 1, B._global_tree->num_bboxes() - 1,
+                        cells_A, processes, 0, 0);
+  }
+  else if (A.num_bboxes() > 0)
+  {
+    // Single process
+    cells_A.resize(mesh_A.num_cells());
+    for (std::size_t c = 0; c < cells_A.size(); ++c)
+      cells_A[c] = c;
+    processes.assign(cells_A.size(), 0);
+  }
+
+  // Send owned cells of A (index and vertex coordinates) to these
+  // processes
+  const std::size_t num_owned_A = mesh_A.topology().ghost_offset(tdim);
+  const MeshConnectivity& cell_vertices_A = mesh_A.topology()(tdim, 0);
+  std::map<int, std::vector<unsigned int>> send_cells;
+  std::map<int, std::vector<double>> send_coordinates;
+  for (std::size_t i = 0; i < cells_A.size(); ++i)
+  {
+    if (cells_A[i] >= num_owned_A)
+      continue;
+    send_cells[processes[i]].push_back(cells_A[i]);
+    std::vector<double>& coordinates = send_coordinates[processes[i]];
+    const unsigned int* vertices = cell_vertices_A(cells_A[i]);
+    for (std::size_t v = 0; v <= tdim; ++v)
+    {
+      const double* x = mesh_A.geometry().x(vertices[v]);
+      coordinates.insert(coordinates.end(), x, x + gdim);
+    }
+  }
+  std::map<int, std::vector<unsigned int>> recv_cells;
+  std::map<int, std::vector<double>> recv_coordinates;
+  MPI::sparse_all_to_all(comm, send_cells, recv_cells);
+  MPI::sparse_all_to_all(comm, send_coordinates, recv_coordinates);
+
+  // Collect received simplices and their origin
+  std::vector<double> simplices;
+  std::vector<int> source_process;
+  std::vector<unsigned int> source_cell;
+  for (auto it = recv_cells.begin(); it != recv_cells.end(); ++it)
+  {
+    const std::vector<double>& coordinates = recv_coordinates[it->first];
+    dolfin_assert(coordinates.size() == it->second.size()*(tdim + 1)*gdim);
+    simplices.insert(simplices.end(), coordinates.begin(), coordinates.end());
+    source_process.insert(source_process.end(), it->second.size(), it->first);
+    source_cell.insert(source_cell.end(), it->second.begin(),
+                       it->second.end());
+  }
+
+  // Build tree of received simplices and find their collisions with
+  // owned cells of B
+  std::map<int, std::vector<unsigned int>> send_collisions;
+  const unsigned int num_received = source_cell.size();
+  if (num_received > 0 and B.num_bboxes() > 0)
+  {
+    std::vector<double> leaf_bboxes(2*gdim*num_received);
+    for (unsigned int i = 0; i < num_received; ++i)
+    {
+      const double* x = simplices.data() + i*(tdim + 1)*gdim;
+      double* b = leaf_bboxes.data() + 2*gdim*i;
+      std::copy(x, x + gdim, b);
+      std::copy(x, x + gdim, b + gdim);
+      for (std::size_t v = 1; v <= tdim; ++v)
+      {
+        for (std::size_t d = 0; d < gdim; ++d)
+        {
+          b[d] = std::min(b[d], x[v*gdim + d]);
+          b[gdim + d] = std::max(b[gdim + d], x[v*gdim + d]);
+        }
+      }
+    }
+    std::vector<unsigned int> leaves(num_received);
+    for (unsigned int i = 0; i < num_received; ++i)
+      leaves[i] = i;
+
+    std::shared_ptr<GenericBoundingBoxTree> received = create(gdim);
+    received->_tdim = tdim;
+    received->_bboxes.resize(2*num_received - 1);
+    received->_bbox_coordinates.resize(2*gdim*(2*num_received - 1));
+    received->_build(leaf_bboxes, leaves.begin(), leaves.end(), gdim, 0);
+
+    std::vector<unsigned int> entities_R;
+    std::vector<unsigned int> entities_B;
+    _compute_collisions(*received, B,
+                        received->num_bboxes() - 1, B.num_bboxes() - 1,
+                        entities_R, entities_B, 0, 0);
+
+    // Skip ghost cells of B, so that each pair is found once
+    const std::size_t num_owned_B = mesh_B.topology().ghost_offset(tdim);
+    std::vector<char> owned(entities_B.size());
+    for (std::size_t i = 0; i < entities_B.size(); ++i)
+      owned[i] = entities_B[i] < num_owned_B;
+    remove_non_collisions(owned, entities_R, entities_B);
+
+    _filter_simplex_collisions(simplices, mesh_B, entities_R, entities_B);
+
+    // Return collisions (cell of A, cell of B) to the owners of A
+    for (std::size_t i = 0; i < entities_R.size(); ++i)
+    {
+      std::vector<unsigned int>& collisions
+        = send_collisions[source_process[entities_R[i]]];
+      collisions.push_back(source_cell[entities_R[i]]);
+      collisions.push_back(entities_B[i]);
+    }
+  }
+  std::map<int, std::vector<unsigned int>> recv_collisions;
+  MPI::sparse_all_to_all(comm, send_collisions, recv_collisions);
+
+  std::tuple<std::vector<unsigned int>, std::vector<unsigned int>,
+             std::vector<unsigned int>> collisions;
+  for (auto it = recv_collisions.begin(); it != recv_collisions.end(); ++it)
+  {
+    for (std::size_t i = 0; i < it->second.size(); i += 2)
+    {
+      std::get<0>(collisions).push_back(it->second[i]);
+      std::get<1>(collisions).push_back(it->first);
+      std::get<2>(collisions).push_back(it->second[i + 1]);
+    }
+  }
+
+  return collisions;
+}
+//-----------------------------------------------------------------------------
 unsigned int
 GenericBoundingBoxTree::compute_first_collision(const Point& point) const
 {
-  // Call recursive find function
-  return _compute_first_collision(*this, point, num_bboxes() - 1);
+  switch (_wide_width)
+  {
+  case 4:
+    return _wide_compute_first_collision<4>(point, 0);
+  case 8:
+    return _wide_compute_first_collision<8>(point, 0);
+  default:
+    // Call recursive find function
+    return _compute_first_collision(*this, point, num_bboxes() - 1);
+  }
 }
 //-----------------------------------------------------------------------------
 unsigned int
@@ -253,8 +605,17 @@ GenericBoundingBoxTree::compute_first_entity_collision(const Point& point,
                  "Point-in-entity is only implemented for cells");
   }
 
-  // Call recursive find function
-  return _compute_first_entity_collision(*this, point, num_bboxes() - 1, mesh);
+  switch (_wide_width)
+  {
+  case 4:
+    return _wide_compute_first_collision<4>(point, &mesh);
+  case 8:
+    return _wide_compute_first_collision<8>(point, &mesh);
+  default:
+    // Call recursive find function
+    return _compute_first_entity_collision(*this, point, num_bboxes() - 1,
+                                           mesh);
+  }
 }
 //-----------------------------------------------------------------------------
 std::pair<unsigned int, double>
@@ -280,9 +641,19 @@ GenericBoundingBoxTree::compute_closest_entity(const Point& point,
   unsigned int closest_entity = std::numeric_limits<unsigned int>::max();
   double R2 = r*r;
 
-  // Call recursive find function
-  _compute_closest_entity(*this, point, num_bboxes() - 1,
-                          mesh, closest_entity, R2);
+  switch (_wide_width)
+  {
+  case 4:
+    _wide_compute_closest<4>(point, &mesh, closest_entity, R2);
+    break;
+  case 8:
+    _wide_compute_closest<8>(point, &mesh, closest_entity, R2);
+    break;
+  default:
+    // Call recursive find function
+    _compute_closest_entity(*this, point, num_bboxes() - 1,
+                            mesh, closest_entity, R2);
+  }
 
   // Sanity check
   dolfin_assert(closest_entity < std::numeric_limits<unsigned int>::max());
@@ -292,6 +663,47 @@ GenericBoundingBoxTree::compute_closest_entity(const Point& point,
 }
 //-----------------------------------------------------------------------------
 std::pair<unsigned int, double>
+GenericBoundingBoxTree::compute_closest_entity(const Point& point,
+                                               const Mesh& mesh,
+                                               unsigned int guess) const
+{
+  // Closest entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute closest entity of point",
+                 "Closest-entity is only implemented for cells");
+  }
+  if (guess >= mesh.num_cells())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute closest entity of point",
+                 "Initial guess %d is not a cell of the mesh", guess);
+  }
+
+  // Initialize index and distance to closest entity with the guess
+  // (which is kept unless a closer entity is found)
+  unsigned int closest_entity = guess;
+  double R2 = Cell(mesh, guess).squared_distance(point);
+
+  switch (_wide_width)
+  {
+  case 4:
+    _wide_compute_closest<4>(point, &mesh, closest_entity, R2);
+    break;
+  case 8:
+    _wide_compute_closest<8>(point, &mesh, closest_entity, R2);
+    break;
+  default:
+    _compute_closest_entity(*this, point, num_bboxes() - 1,
+                            mesh, closest_entity, R2);
+  }
+
+  std::pair<unsigned int, double> ret(closest_entity, sqrt(R2));
+  return ret;
+}
+//-----------------------------------------------------------------------------
+std::pair<unsigned int, double>
 GenericBoundingBoxTree::compute_closest_point(const Point& point) const
 {
   // Closest point only implemented for point cloud
@@ -310,8 +722,18 @@ GenericBoundingBoxTree::compute_closest_point(const Point& point) const
   double R2 = compute_squared_distance_point(point.coordinates(),
                                              closest_point);
 
-  // Call recursive find function
-  _compute_closest_point(*this, point, num_bboxes() - 1, closest_point, R2);
+  switch (_wide_width)
+  {
+  case 4:
+    _wide_compute_closest<4>(point, 0, closest_point, R2);
+    break;
+  case 8:
+    _wide_compute_closest<8>(point, 0, closest_point, R2);
+    break;
+  default:
+    // Call recursive find function
+    _compute_closest_point(*this, point, num_bboxes() - 1, closest_point, R2);
+  }
 
   std::pair<unsigned int, double> ret(closest_point, sqrt(R2));
   return ret;
@@ -319,40 +741,332 @@ GenericBoundingBoxTree::compute_closest_point(const Point& point) const
 //-----------------------------------------------------------------------------
 // Implementation of protected functions
 //-----------------------------------------------------------------------------
+std::size_t GenericBoundingBoxTree::nodes_visited()
+{
+  return num_nodes_visited;
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::reset_nodes_visited()
+{
+  num_nodes_visited = 0;
+}
+//-----------------------------------------------------------------------------
 void GenericBoundingBoxTree::clear()
 {
   _tdim = 0;
   _bboxes.clear();
   _bbox_coordinates.clear();
   _point_search_tree.reset();
+  _wide_width = 0;
+  _wide_bounds.clear();
+  _wide_children.clear();
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::build_wide_tree()
+{
+  _wide_width = 0;
+  _wide_bounds.clear();
+  _wide_children.clear();
+
+  const std::string layout = parameters["bounding_box_tree_layout"];
+  if (layout == "binary" or _bboxes.empty())
+    return;
+  const unsigned int W = (layout == "wide4") ? 4 : 8;
+  const std::size_t _gdim = gdim();
+  const double max = std::numeric_limits<double>::max();
+
+  // Stack of (binary node, wide node) pairs to process, starting with
+  // the root (added last in the binary tree)
+  std::vector<std::pair<unsigned int, unsigned int>> stack;
+  stack.push_back(std::make_pair(num_bboxes() - 1, 0));
+  _wide_bounds.resize(2*_gdim*W);
+  _wide_children.resize(W, 0);
+
+  std::vector<unsigned int> slots;
+  while (!stack.empty())
+  {
+    const unsigned int bnode = stack.back().first;
+    const unsigned int wnode = stack.back().second;
+    stack.pop_back();
+
+    // Collect up to W descendants of binary node, opening internal
+    // nodes breadth-first to keep the wide tree balanced
+    slots.clear();
+    const BBox& bbox = get_bbox(bnode);
+    if (is_leaf(bbox, bnode))
+      slots.push_back(bnode);
+    else
+    {
+      slots.push_back(bbox.child_0);
+      slots.push_back(bbox.child_1);
+    }
+    std::size_t i = 0;
+    while (slots.size() < W and i < slots.size())
+    {
+      const unsigned int node = slots[i];
+      const BBox& b = get_bbox(node);
+      if (is_leaf(b, node))
+      {
+        ++i;
+        continue;
+      }
+      slots.erase(slots.begin() + i);
+      slots.push_back(b.child_0);
+      slots.push_back(b.child_1);
+    }
+
+    // Fill slots of wide node, leaving unused slots empty
+    for (std::size_t k = 0; k < W; ++k)
+    {
+      int child = 0;
+      if (k < slots.size())
+      {
+        const unsigned int node = slots[k];
+        const BBox& b = get_bbox(node);
+        if (is_leaf(b, node))
+          child = -static_cast<int>(b.child_1) - 1;
+        else
+        {
+          child = _wide_children.size()/W;
+          _wide_bounds.resize(_wide_bounds.size() + 2*_gdim*W);
+          _wide_children.resize(_wide_children.size() + W, 0);
+          stack.push_back(std::make_pair(node, child));
+        }
+      }
+
+      double* bounds = _wide_bounds.data() + 2*_gdim*W*wnode;
+      const double* b = get_bbox_coordinates(k < slots.size() ? slots[k] : 0);
+      for (std::size_t d = 0; d < _gdim; ++d)
+      {
+        if (k < slots.size())
+        {
+          const double eps = DOLFIN_EPS_LARGE*(b[_gdim + d] - b[d]);
+          bounds[2*d*W + k] = b[d] - eps;
+          bounds[(2*d + 1)*W + k] = b[_gdim + d] + eps;
+        }
+        else
+        {
+          bounds[2*d*W + k] = max;
+          bounds[(2*d + 1)*W + k] = -max;
+        }
+      }
+      _wide_children[W*wnode + k] = child;
+    }
+  }
+
+  _wide_width = W;
+  log(PROGRESS, "Computed %d-wide bounding box tree with %d nodes.",
+      W, (int) (_wide_children.size()/W));
+}
+//-----------------------------------------------------------------------------
+template <unsigned int W>
+void GenericBoundingBoxTree::_wide_compute_collisions(
+  const Point& point,
+  std::vector<unsigned int>& entities,
+  const Mesh* mesh) const
+{
+  const std::size_t _gdim = gdim();
+  const double* x = point.coordinates();
+
+  // Explicit stack of wide nodes (tree depth is bounded by the
+  // binary tree depth, which is at most 64 for median splits)
+  int stack[64*W];
+  std::size_t top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    const int node = stack[--top];
+    ++num_nodes_visited;
+
+    // Test point against all child boxes
+    const double* b = _wide_bounds.data() + 2*_gdim*W*node;
+    int hit[W];
+    for (std::size_t k = 0; k < W; ++k)
+      hit[k] = 1;
+    for (std::size_t d = 0; d < _gdim; ++d)
+    {
+      const double* lo = b + 2*d*W;
+      const double* hi = lo + W;
+      for (std::size_t k = 0; k < W; ++k)
+        hit[k] &= (lo[k] <= x[d]) & (x[d] <= hi[k]);
+    }
+
+    // Descend into children (in reverse, so first child is
+    // processed first) and add leaves
+    const int* children = _wide_children.data() + W*node;
+    for (std::size_t k = W; k-- > 0;)
+    {
+      if (!hit[k])
+        continue;
+      if (children[k] >= 0)
+      {
+        dolfin_assert(top < 64*W);
+        stack[top++] = children[k];
+      }
+      else
+      {
+        const unsigned int entity_index = -(children[k] + 1);
+        if (!mesh or Cell(*mesh, entity_index).collides(point))
+          entities.push_back(entity_index);
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+template <unsigned int W>
+unsigned int GenericBoundingBoxTree::_wide_compute_first_collision(
+  const Point& point,
+  const Mesh* mesh) const
+{
+  const std::size_t _gdim = gdim();
+  const double* x = point.coordinates();
+
+  int stack[64*W];
+  std::size_t top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    const int node = stack[--top];
+    ++num_nodes_visited;
+
+    // Test point against all child boxes
+    const double* b = _wide_bounds.data() + 2*_gdim*W*node;
+    int hit[W];
+    for (std::size_t k = 0; k < W; ++k)
+      hit[k] = 1;
+    for (std::size_t d = 0; d < _gdim; ++d)
+    {
+      const double* lo = b + 2*d*W;
+      const double* hi = lo + W;
+      for (std::size_t k = 0; k < W; ++k)
+        hit[k] &= (lo[k] <= x[d]) & (x[d] <= hi[k]);
+    }
+
+    // Return first leaf hit, otherwise descend into children
+    const int* children = _wide_children.data() + W*node;
+    for (std::size_t k = 0; k < W; ++k)
+    {
+      if (!hit[k] or children[k] >= 0)
+        continue;
+      const unsigned int entity_index = -(children[k] + 1);
+      if (!mesh or Cell(*mesh, entity_index).collides(point))
+        return entity_index;
+    }
+    for (std::size_t k = W; k-- > 0;)
+    {
+      if (hit[k] and children[k] >= 0)
+      {
+        dolfin_assert(top < 64*W);
+        stack[top++] = children[k];
+      }
+    }
+  }
+
+  // Point not found
+  return std::numeric_limits<unsigned int>::max();
+}
+//-----------------------------------------------------------------------------
+template <unsigned int W>
+void GenericBoundingBoxTree::_wide_compute_closest(const Point& point,
+                                                   const Mesh* mesh,
+                                                   unsigned int& closest,
+                                                   double& R2) const
+{
+  const std::size_t _gdim = gdim();
+  const double* x = point.coordinates();
+
+  // Explicit stack of wide nodes and their squared distances
+  int stack[64*W];
+  double stack_r2[64*W];
+  std::size_t top = 0;
+  stack[top] = 0;
+  stack_r2[top++] = 0.0;
+  while (top > 0)
+  {
+    --top;
+    const int node = stack[top];
+    ++num_nodes_visited;
+
+    // If bounding box is outside radius, then don't search further
+    if (stack_r2[top] > R2)
+      continue;
+
+    // Compute squared distance to all child boxes
+    const double* b = _wide_bounds.data() + 2*_gdim*W*node;
+    double r2[W];
+    for (std::size_t k = 0; k < W; ++k)
+      r2[k] = 0.0;
+    for (std::size_t d = 0; d < _gdim; ++d)
+    {
+      const double* lo = b + 2*d*W;
+      const double* hi = lo + W;
+      for (std::size_t k = 0; k < W; ++k)
+      {
+        const double t = std::max(std::max(lo[k] - x[d], x[d] - hi[k]), 0.0);
+        r2[k] += t*t;
+      }
+    }
+
+    // Shrink radius with leaves inside radius and descend into
+    // other children. For point clouds, the (unpadded) leaf box is
+    // the point itself.
+    const int* children = _wide_children.data() + W*node;
+    for (std::size_t k = W; k-- > 0;)
+    {
+      if (r2[k] > R2)
+        continue;
+      if (children[k] >= 0)
+      {
+        dolfin_assert(top < 64*W);
+        stack[top] = children[k];
+        stack_r2[top++] = r2[k];
+      }
+      else
+      {
+        const unsigned int entity_index = -(children[k] + 1);
+        const double r2_entity = mesh
+          ? Cell(*mesh, entity_index).squared_distance(point) : r2[k];
+        if (r2_entity < R2)
+        {
+          closest = entity_index;
+          R2 = r2_entity;
+        }
+      }
+    }
+  }
 }
 //-----------------------------------------------------------------------------
 unsigned int
 GenericBoundingBoxTree::_build(const std::vector<double>& leaf_bboxes,
                                const std::vector<unsigned int>::iterator& begin,
                                const std::vector<unsigned int>::iterator& end,
-                               std::size_t gdim)
+                               std::size_t gdim,
+                               unsigned int start)
 {
   dolfin_assert(begin < end);
 
-  // Create empty bounding box data
-  BBox bbox;
+  // Nodes are stored in post-order, so the subtree for the leaves
+  // [begin, end) occupies 2*(end - begin) - 1 nodes from start, with
+  // its root last
+  const unsigned int node = start + 2*(end - begin) - 2;
+  BBox& bbox = _bboxes[node];
+  double* b = _bbox_coordinates.data() + 2*gdim*node;
 
   // Reached leaf
   if (end - begin == 1)
   {
     // Get bounding box coordinates for leaf
     const unsigned int entity_index = *begin;
-    const double* b = leaf_bboxes.data() + 2*gdim*entity_index;
+    const double* leaf = leaf_bboxes.data() + 2*gdim*entity_index;
+    std::copy(leaf, leaf + 2*gdim, b);
 
     // Store bounding box data
-    bbox.child_0 = num_bboxes(); // child_0 == node denotes a leaf
+    bbox.child_0 = node;         // child_0 == node denotes a leaf
     bbox.child_1 = entity_index; // index of entity contained in leaf
-    return add_bbox(bbox, b, gdim);
+    return node;
   }
 
   // Compute bounding box of all bounding boxes
-  double b[MAX_DIM];
   std::size_t axis;
   compute_bbox_of_bboxes(b, axis, leaf_bboxes, begin, end);
 
@@ -360,37 +1074,53 @@ GenericBoundingBoxTree::_build(const std::vector<double>& leaf_bboxes,
   std::vector<unsigned int>::iterator middle = begin + (end - begin) / 2;
   sort_bboxes(axis, leaf_bboxes, begin, middle, end);
 
-  // Split bounding boxes into two groups and call recursively
-  bbox.child_0 = _build(leaf_bboxes, begin, middle, gdim);
-  bbox.child_1 = _build(leaf_bboxes, middle, end, gdim);
-
-  // Store bounding box data. Note that root box will be added last.
-  return add_bbox(bbox, b, gdim);
+  // Split bounding boxes into two groups and call recursively. Large
+  // subtrees are built as separate tasks.
+  const unsigned int start_1 = start + 2*(middle - begin) - 1;
+  bbox.child_0 = start_1 - 1;
+  bbox.child_1 = node - 1;
+  #ifdef HAS_OPENMP
+  #pragma omp task if (end - begin > BUILD_TASK_SIZE)
+  #endif
+  _build(leaf_bboxes, begin, middle, gdim, start);
+  _build(leaf_bboxes, middle, end, gdim, start_1);
+  #ifdef HAS_OPENMP
+  #pragma omp taskwait
+  #endif
+
+  return node;
 }
 //-----------------------------------------------------------------------------
 unsigned int
 GenericBoundingBoxTree::_build(const std::vector<Point>& points,
                                const std::vector<unsigned int>::iterator& begin,
                                const std::vector<unsigned int>::iterator& end,
-                               std::size_t gdim)
+                               std::size_t gdim,
+                               unsigned int start)
 {
   dolfin_assert(begin < end);
 
-  // Create empty bounding box data
-  BBox bbox;
+  // See above for the node numbering of subtrees
+  const unsigned int node = start + 2*(end - begin) - 2;
+  BBox& bbox = _bboxes[node];
+  double* b = _bbox_coordinates.data() + 2*gdim*node;
 
   // Reached leaf
   if (end - begin == 1)
   {
-    // Store bounding box data
+    // Store point coordinates (twice)
     const unsigned int point_index = *begin;
-    bbox.child_0 = num_bboxes(); // child_0 == node denotes a leaf
-    bbox.child_1 = point_index;  // index of entity contained in leaf
-    return add_point(bbox, points[point_index], gdim);
+    const double* x = points[point_index].coordinates();
+    std::copy(x, x + gdim, b);
+    std::copy(x, x + gdim, b + gdim);
+
+    // Store bounding box data
+    bbox.child_0 = node;        // child_0 == node denotes a leaf
+    bbox.child_1 = point_index; // index of entity contained in leaf
+    return node;
   }
 
   // Compute bounding box of all points
-  double b[MAX_DIM];
   std::size_t axis;
   compute_bbox_of_points(b, axis, points, begin, end);
 
@@ -399,11 +1129,19 @@ GenericBoundingBoxTree::_build(const std::vector<Point>& points,
   sort_points(axis, points, begin, middle, end);
 
   // Split bounding boxes into two groups and call recursively
-  bbox.child_0 = _build(points, begin, middle, gdim);
-  bbox.child_1 = _build(points, middle, end, gdim);
-
-  // Store bounding box data. Note that root box will be added last.
-  return add_bbox(bbox, b, gdim);
+  const unsigned int start_1 = start + 2*(middle - begin) - 1;
+  bbox.child_0 = start_1 - 1;
+  bbox.child_1 = node - 1;
+  #ifdef HAS_OPENMP
+  #pragma omp task if (end - begin > BUILD_TASK_SIZE)
+  #endif
+  _build(points, begin, middle, gdim, start);
+  _build(points, middle, end, gdim, start_1);
+  #ifdef HAS_OPENMP
+  #pragma omp taskwait
+  #endif
+
+  return node;
 }
 //-----------------------------------------------------------------------------
 void
@@ -415,6 +1153,7 @@ GenericBoundingBoxTree::_compute_collisions(const GenericBoundingBoxTree& tree,
 {
   // Get bounding box for current node
   const BBox& bbox = tree.get_bbox(node);
+  ++num_nodes_visited;
 
   // If point is not in bounding box, then don't search further
   if (!tree.point_in_bbox(point.coordinates(), node))
@@ -461,6 +1200,7 @@ GenericBoundingBoxTree::_compute_collisions(const GenericBoundingBoxTree& A,
   // Get bounding boxes for current nodes
   const BBox& bbox_A = A.get_bbox(node_A);
   const BBox& bbox_B = B.get_bbox(node_B);
+  ++num_nodes_visited;
 
   // If bounding boxes don't collide, then don't search further
   if (!B.bbox_in_bbox(A.get_bbox_coordinates(node_A), node_B))
@@ -539,6 +1279,100 @@ GenericBoundingBoxTree::_compute_collisions(const GenericBoundingBoxTree& A,
   // way the logic is easier to follow.
 }
 //-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::_filter_entity_collisions(
+  const Mesh& mesh_A,
+  const Mesh& mesh_B,
+  std::vector<unsigned int>& entities_A,
+  std::vector<unsigned int>& entities_B)
+{
+  dolfin_assert(entities_A.size() == entities_B.size());
+
+  // Test packets of candidates if both meshes are triangle meshes in
+  // 2D or tetrahedron meshes in 3D
+  const std::size_t tdim = mesh_A.topology().dim();
+  if (is_simplex_mesh(mesh_A) and is_simplex_mesh(mesh_B)
+      and mesh_B.topology().dim() == tdim)
+  {
+    std::vector<double> simplices_A;
+    get_simplex_coordinates(simplices_A, mesh_A);
+    _filter_simplex_collisions(simplices_A, mesh_B, entities_A, entities_B);
+    return;
+  }
+
+  // Otherwise check candidates one by one
+  std::vector<char> collides(entities_A.size());
+  for (std::size_t i = 0; i < entities_A.size(); ++i)
+  {
+    Cell cell_A(mesh_A, entities_A[i]);
+    Cell cell_B(mesh_B, entities_B[i]);
+    collides[i] = cell_A.collides(cell_B);
+  }
+  remove_non_collisions(collides, entities_A, entities_B);
+}
+//-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::_filter_simplex_collisions(
+  const std::vector<double>& simplices_A,
+  const Mesh& mesh_B,
+  std::vector<unsigned int>& entities_A,
+  std::vector<unsigned int>& entities_B)
+{
+  dolfin_assert(entities_A.size() == entities_B.size());
+  dolfin_assert(is_simplex_mesh(mesh_B));
+  const std::size_t num_candidates = entities_A.size();
+  const std::size_t tdim = mesh_B.topology().dim();
+  const std::size_t gdim = mesh_B.geometry().dim();
+  const std::size_t num_vertices = tdim + 1;
+  const std::size_t simplex_size = num_vertices*gdim;
+  const std::size_t num_simplices_A = simplices_A.size()/simplex_size;
+
+  // Sort candidates by entity of A (counting sort)
+  std::vector<std::size_t> offsets(num_simplices_A + 1, 0);
+  for (std::size_t i = 0; i < num_candidates; ++i)
+  {
+    dolfin_assert(entities_A[i] < num_simplices_A);
+    ++offsets[entities_A[i] + 1];
+  }
+  for (std::size_t c = 0; c < num_simplices_A; ++c)
+    offsets[c + 1] += offsets[c];
+  std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+  std::vector<std::size_t> order(num_candidates);
+  for (std::size_t i = 0; i < num_candidates; ++i)
+    order[position[entities_A[i]]++] = i;
+
+  // Test each entity of A against packets of its candidates
+  const std::size_t W = CollisionDetection::packet_size;
+  const MeshConnectivity& cells_B = mesh_B.topology()(tdim, 0);
+  std::vector<double> packet(simplex_size*W, 0.0);
+  bool packet_collides[W];
+  std::vector<char> collides(num_candidates, 0);
+  for (std::size_t c = 0; c < num_simplices_A; ++c)
+  {
+    const double* simplex = simplices_A.data() + c*simplex_size;
+    for (std::size_t start = offsets[c]; start < offsets[c + 1]; start += W)
+    {
+      const std::size_t n = std::min(W, offsets[c + 1] - start);
+      for (std::size_t k = 0; k < n; ++k)
+      {
+        const unsigned int* vertices_B = cells_B(entities_B[order[start + k]]);
+        for (std::size_t v = 0; v < num_vertices; ++v)
+        {
+          const double* x = mesh_B.geometry().x(vertices_B[v]);
+          for (std::size_t d = 0; d < gdim; ++d)
+            packet[(v*gdim + d)*W + k] = x[d];
+        }
+      }
+
+      CollisionDetection::collides_simplex_packet(tdim, simplex,
+                                                  packet.data(), n,
+                                                  packet_collides);
+      for (std::size_t k = 0; k < n; ++k)
+        collides[order[start + k]] = packet_collides[k];
+    }
+  }
+
+  remove_non_collisions(collides, entities_A, entities_B);
+}
+//-----------------------------------------------------------------------------
 unsigned int
 GenericBoundingBoxTree::_compute_first_collision(const GenericBoundingBoxTree& tree,
                                                  const Point& point,
@@ -549,6 +1383,7 @@ GenericBoundingBoxTree::_compute_first_collision(const GenericBoundingBoxTree& t
 
   // Get bounding box for current node
   const BBox& bbox = tree.get_bbox(node);
+  ++num_nodes_visited;
 
   // If point is not in bounding box, then don't search further
   if (!tree.point_in_bbox(point.coordinates(), node))
@@ -586,6 +1421,7 @@ GenericBoundingBoxTree::_compute_first_entity_collision(const GenericBoundingBox
 
   // Get bounding box for current node
   const BBox& bbox = tree.get_bbox(node);
+  ++num_nodes_visited;
 
   // If point is not in bounding box, then don't search further
   if (!tree.point_in_bbox(point.coordinates(), node))
@@ -636,6 +1472,7 @@ GenericBoundingBoxTree::_compute_closest_entity(const GenericBoundingBoxTree& tr
 {
   // Get bounding box for current node
   const BBox& bbox = tree.get_bbox(node);
+  ++num_nodes_visited;
 
   // If bounding box is outside radius, then don't search further
   const double r2 = tree.compute_squared_distance_bbox(point.coordinates(), node);
@@ -676,6 +1513,7 @@ GenericBoundingBoxTree::_compute_closest_point(const GenericBoundingBoxTree& tre
 {
   // Get bounding box for current node
   const BBox& bbox = tree.get_bbox(node);
+  ++num_nodes_visited;
 
   // If box is leaf, then compute distance and shrink radius
   if (tree.is_leaf(bbox, node))
@@ -702,9 +1540,29 @@ GenericBoundingBoxTree::_compute_closest_point(const GenericBoundingBoxTree& tre
   }
 }
 //-----------------------------------------------------------------------------
+void GenericBoundingBoxTree::compute_leaf_bboxes(std::vector<double>& leaf_bboxes,
+                                                 const Mesh& mesh) const
+{
+  const std::size_t _gdim = gdim();
+  const std::int64_t num_leaves = mesh.num_entities(_tdim);
+  dolfin_assert(leaf_bboxes.size() == 2*_gdim*num_leaves);
+
+  #ifdef HAS_OPENMP
+  const int num_threads = SubSystemsManager::num_threads();
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  #endif
+  for (std::int64_t i = 0; i < num_leaves; ++i)
+  {
+    const MeshEntity entity(mesh, _tdim, i);
+    compute_bbox_of_entity(leaf_bboxes.data() + 2*_gdim*i, entity, _gdim);
+  }
+}
+//-----------------------------------------------------------------------------
 void GenericBoundingBoxTree::build_point_search_tree(const Mesh& mesh) const
 {
-  // Don't build search tree if it already exists
+  // Don't build search tree if it already exists (the lock makes
+  // concurrent distance queries safe)
+  std::lock_guard<std::mutex> lock(_point_search_tree_mutex);
   if (_point_search_tree)
     return;
   info("Building point search tree to accelerate distance queries.");
@@ -22,8 +22,10 @@
 #define __GENERIC_BOUNDING_BOX_TREE_H
 
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <set>
+#include <tuple>
 #include <vector>
 #include <dolfin/geometry/Point.h>
 
@@ -56,6 +58,11 @@ namespace dolfin
     /// Build bounding box tree for point cloud
     void build(const std::vector<Point>& points);
 
+    /// Update bounding boxes of tree built for mesh entities after
+    /// the mesh coordinates have changed, keeping the tree structure
+    /// (collective if update_global is true)
+    void refit(const Mesh& mesh, bool update_global=true);
+
     /// Compute all collisions between bounding boxes and _Point_
     std::vector<unsigned int>
     compute_collisions(const Point& point) const;
@@ -78,6 +85,14 @@ namespace dolfin
     compute_entity_collisions(const GenericBoundingBoxTree& tree,
                               const Mesh& mesh_A, const Mesh& mesh_B) const;
 
+    /// Compute all collisions between owned entities and owned
+    /// entities of _BoundingBoxTree_ on all processes (collective)
+    std::tuple<std::vector<unsigned int>, std::vector<unsigned int>,
+               std::vector<unsigned int>>
+    compute_distributed_entity_collisions(const GenericBoundingBoxTree& tree,
+                                          const Mesh& mesh_A,
+                                          const Mesh& mesh_B) const;
+
     /// Compute first collision between bounding boxes and _Point_
     unsigned int compute_first_collision(const Point& point) const;
 
@@ -89,12 +104,27 @@ namespace dolfin
     std::pair<unsigned int, double> compute_closest_entity(const Point& point,
                                                            const Mesh& mesh) const;
 
+    /// Compute closest entity and distance to _Point_, using the
+    /// distance to entity guess as the initial search radius (warm
+    /// start, e.g. the closest entity of a nearby point)
+    std::pair<unsigned int, double> compute_closest_entity(const Point& point,
+                                                           const Mesh& mesh,
+                                                           unsigned int guess) const;
+
     /// Compute closest point and distance to _Point_
     std::pair<unsigned int, double> compute_closest_point(const Point& point) const;
 
     /// Print out for debugging
     std::string str(bool verbose=false);
 
+    /// Return number of tree nodes (or node pairs for tree-tree
+    /// queries) visited by queries on the calling thread since the
+    /// last reset
+    static std::size_t nodes_visited();
+
+    /// Reset number of visited tree nodes on the calling thread
+    static void reset_nodes_visited();
+
   protected:
 
     /// Bounding box data. Leaf nodes are indicated by setting child_0
@@ -120,25 +150,77 @@ namespace dolfin
     /// Point search tree used to accelerate distance queries
     mutable std::shared_ptr<GenericBoundingBoxTree> _point_search_tree;
 
+    /// Lock for building the point search tree on demand
+    mutable std::mutex _point_search_tree_mutex;
+
     /// Global tree for mesh ownership of each process (same on all processes)
     std::shared_ptr<GenericBoundingBoxTree> _global_tree;
 
+    /// Width of flattened wide tree (0 if not built). Each node of the
+    /// wide tree stores the boxes of up to _wide_width children in
+    /// SoA layout: for each axis, the lower bounds of all children
+    /// followed by the upper bounds. Bounds are padded by the same
+    /// tolerance as point_in_bbox, and unused slots hold empty boxes.
+    unsigned int _wide_width;
+
+    /// Child box bounds of wide tree nodes
+    std::vector<double> _wide_bounds;
+
+    /// Children of wide tree nodes. Non-negative values are node
+    /// indices, negative values -(i + 1) denote leaf entity i.
+    std::vector<int> _wide_children;
+
     /// Clear existing data if any
     void clear();
 
+    /// Build flattened wide tree from binary tree (if requested by
+    /// parameter "bounding_box_tree_layout")
+    void build_wide_tree();
+
+    //--- Iterative search functions for wide tree ---
+
+    // Compute collisions with point, optionally checking entities
+    template <unsigned int W>
+    void _wide_compute_collisions(const Point& point,
+                                  std::vector<unsigned int>& entities,
+                                  const Mesh* mesh) const;
+
+    // Compute first collision with point, optionally checking entities
+    template <unsigned int W>
+    unsigned int _wide_compute_first_collision(const Point& point,
+                                               const Mesh* mesh) const;
+
+    // Compute closest entity (if mesh is given) or point
+    template <unsigned int W>
+    void _wide_compute_closest(const Point& point,
+                               const Mesh* mesh,
+                               unsigned int& closest,
+                               double& R2) const;
+
     //--- Recursive build functions ---
 
-    /// Build bounding box tree for entities (recursive)
+    /// Build bounding box tree for entities (recursive). The subtree
+    /// is stored in the (preallocated) nodes starting at start.
     unsigned int _build(const std::vector<double>& leaf_bboxes,
                         const std::vector<unsigned int>::iterator& begin,
                         const std::vector<unsigned int>::iterator& end,
-                        std::size_t gdim);
+                        std::size_t gdim,
+                        unsigned int start);
 
-    /// Build bounding box tree for points (recursive)
+    /// Build bounding box tree for points (recursive). The subtree is
+    /// stored in the (preallocated) nodes starting at start.
     unsigned int _build(const std::vector<Point>& points,
                         const std::vector<unsigned int>::iterator& begin,
                         const std::vector<unsigned int>::iterator& end,
-                        std::size_t gdim);
+                        std::size_t gdim,
+                        unsigned int start);
+
+    /// Build global tree of process bounding boxes (collective)
+    void build_global_tree(const Mesh& mesh);
+
+    /// Compute bounding boxes of all leaf entities
+    void compute_leaf_bboxes(std::vector<double>& leaf_bboxes,
+                             const Mesh& mesh) const;
 
     //--- Recursive search functions ---
 
@@ -164,6 +246,24 @@ namespace dolfin
                         const Mesh* mesh_A,
                         const Mesh* mesh_B);
 
+    // Remove candidate collisions between cells of two meshes that
+    // are not collisions, testing packets of candidates together for
+    // simplex meshes
+    static void
+    _filter_entity_collisions(const Mesh& mesh_A,
+                              const Mesh& mesh_B,
+                              std::vector<unsigned int>& entities_A,
+                              std::vector<unsigned int>& entities_B);
+
+    // Remove candidate collisions between simplices of A, given by
+    // their vertex coordinates, and cells of simplex mesh B that are
+    // not collisions
+    static void
+    _filter_simplex_collisions(const std::vector<double>& simplices_A,
+                               const Mesh& mesh_B,
+                               std::vector<unsigned int>& entities_A,
+                               std::vector<unsigned int>& entities_B);
+
     // Compute first collision (recursive)
     static unsigned int
     _compute_first_collision(const GenericBoundingBoxTree& tree,
@@ -210,21 +310,6 @@ namespace dolfin
                      const std::vector<unsigned int>::iterator& middle,
                      const std::vector<unsigned int>::iterator& end);
 
-    /// Add bounding box and coordinates
-    inline unsigned int add_bbox(const BBox& bbox,
-                                 const double* b,
-                                 std::size_t gdim)
-    {
-      // Add bounding box
-      _bboxes.push_back(bbox);
-
-      // Add bounding box coordinates
-      for (std::size_t i = 0; i < 2*gdim; ++i)
-        _bbox_coordinates.push_back(b[i]);
-
-      return _bboxes.size() - 1;
-    }
-
     /// Return bounding box for given node
     inline const BBox& get_bbox(unsigned int node) const
     {
@@ -237,24 +322,6 @@ namespace dolfin
       return _bboxes.size();
     }
 
-    /// Add bounding box and point coordinates
-    inline unsigned int add_point(const BBox& bbox,
-                                  const Point& point,
-                                  std::size_t gdim)
-    {
-      // Add bounding box
-      _bboxes.push_back(bbox);
-
-      // Add point coordinates (twice)
-      const double* x = point.coordinates();
-      for (std::size_t i = 0; i < gdim; ++i)
-        _bbox_coordinates.push_back(x[i]);
-      for (std::size_t i = 0; i < gdim; ++i)
-        _bbox_coordinates.push_back(x[i]);
-
-      return _bboxes.size() - 1;
-    }
-
     /// Check whether bounding box is a leaf node
     inline bool is_leaf(const BBox& bbox, unsigned int node) const
     {
@@ -18,9 +18,11 @@
 // First added:  2014-02-03
 // Last changed: 2014-05-28
 
+#include <algorithm>
 #include <dolfin/mesh/MeshEntity.h>
 #include "IntersectionTriangulation.h"
 #include "CollisionDetection.h"
+#include "predicates.h"
 
 using namespace dolfin;
 
@@ -146,15 +148,17 @@ IntersectionTriangulation::triangulate_intersection_triangle_triangle
   const unsigned int* vertices_0 = c0.entities(0);
   const unsigned int* vertices_1 = c1.entities(0);
 
-  std::vector<Point> tri_0(3), tri_1(3);
-
+  Point tri_0[3], tri_1[3];
   for (std::size_t i = 0; i < 3; ++i)
   {
     tri_0[i] = geometry_0.point(vertices_0[i]);
     tri_1[i] = geometry_1.point(vertices_1[i]);
   }
 
-  return triangulate_intersection_triangle_triangle(tri_0, tri_1);
+  double triangulation[max_triangle_triangle_size];
+  const std::size_t num_triangles
+    = triangulate_intersection_triangle_triangle(tri_0, tri_1, triangulation);
+  return std::vector<double>(triangulation, triangulation + 6*num_triangles);
 }
 //-----------------------------------------------------------------------------
 std::vector<double>
@@ -410,6 +414,21 @@ std::vector<double>
 IntersectionTriangulation::triangulate_intersection_triangle_triangle
 (const std::vector<Point>& tri_0,
  const std::vector<Point>& tri_1)
+{
+  dolfin_assert(tri_0.size() == 3);
+  dolfin_assert(tri_1.size() == 3);
+  double triangulation[max_triangle_triangle_size];
+  const std::size_t num_triangles
+    = triangulate_intersection_triangle_triangle(tri_0.data(), tri_1.data(),
+                                                 triangulation);
+  return std::vector<double>(triangulation, triangulation + 6*num_triangles);
+}
+//-----------------------------------------------------------------------------
+std::size_t
+IntersectionTriangulation::triangulate_intersection_triangle_triangle
+(const Point* tri_0,
+ const Point* tri_1,
+ double* triangulation)
 {
   // This algorithm computes the (convex) polygon resulting from the
   // intersection of two triangles. It then triangulates the polygon
@@ -423,71 +442,83 @@ IntersectionTriangulation::triangulate_intersection_triangle_triangle
   // (p-q).norm() < same_point_tol)
   const double same_point_tol = DOLFIN_EPS_LARGE;
 
+  // Degenerate triangles have no area of intersection
+  const double orientation_0 = orient2d(tri_0[0], tri_0[1], tri_0[2]);
+  const double orientation_1 = orient2d(tri_1[0], tri_1[1], tri_1[2]);
+  if (orientation_0 == 0.0 or orientation_1 == 0.0)
+    return 0;
 
-  // Create empty list of collision points
-  std::vector<Point> points;
+  // Collision points: at most 6 vertices and 9 edge-edge
+  // intersections (before removing duplicates)
+  Point points[15];
+  std::size_t num_points = 0;
 
-  // Find all vertex-cell collisions
+  // Find all vertex-cell collisions (including vertices on the
+  // boundary of the other triangle)
   for (std::size_t i = 0; i < 3; i++)
   {
-    // Note: this routine is changed to being public:
-    if (CollisionDetection::collides_triangle_point(tri_1[0],
-                                                    tri_1[1],
-                                                    tri_1[2],
-                                                    tri_0[i]))
-      points.push_back(tri_0[i]);
-
-    if (CollisionDetection::collides_triangle_point(tri_0[0],
-                                                    tri_0[1],
-                                                    tri_0[2],
-                                                    tri_1[i]))
-      points.push_back(tri_1[i]);
+    if (orientation_1*orient2d(tri_1[0], tri_1[1], tri_0[i]) >= 0.0 and
+        orientation_1*orient2d(tri_1[1], tri_1[2], tri_0[i]) >= 0.0 and
+        orientation_1*orient2d(tri_1[2], tri_1[0], tri_0[i]) >= 0.0)
+      points[num_points++] = tri_0[i];
+
+    if (orientation_0*orient2d(tri_0[0], tri_0[1], tri_1[i]) >= 0.0 and
+        orientation_0*orient2d(tri_0[1], tri_0[2], tri_1[i]) >= 0.0 and
+        orientation_0*orient2d(tri_0[2], tri_0[0], tri_1[i]) >= 0.0)
+      points[num_points++] = tri_1[i];
   }
 
-  // Find all edge-edge collisions (not needed?)
+  // Find all proper edge-edge crossings. Edges that touch at a
+  // vertex or overlap are covered by the vertex-cell collisions.
   for (std::size_t i0 = 0; i0 < 3; i0++)
   {
-    const std::size_t j0 = (i0 + 1) % 3;
-    const Point p0 = tri_0[i0];
-    const Point q0 = tri_0[j0];
+    const Point& p0 = tri_0[i0];
+    const Point& q0 = tri_0[(i0 + 1) % 3];
     for (std::size_t i1 = 0; i1 < 3; i1++)
     {
-      const std::size_t j1 = (i1 + 1) % 3;
-      const Point p1 = tri_1[i1];
-      const Point q1 = tri_1[j1];
-      Point point;
-      if (intersection_edge_edge(p0, q0, p1, q1, point))
-        points.push_back(point);
+      const Point& p1 = tri_1[i1];
+      const Point& q1 = tri_1[(i1 + 1) % 3];
+      const double d_p0 = orient2d(p1, q1, p0);
+      const double d_q0 = orient2d(p1, q1, q0);
+      if ((d_p0 > 0.0 and d_q0 < 0.0) or (d_p0 < 0.0 and d_q0 > 0.0))
+      {
+        const double d_p1 = orient2d(p0, q0, p1);
+        const double d_q1 = orient2d(p0, q0, q1);
+        if ((d_p1 > 0.0 and d_q1 < 0.0) or (d_p1 < 0.0 and d_q1 > 0.0))
+          points[num_points++] = p0 + (d_p0/(d_p0 - d_q0))*(q0 - p0);
+      }
     }
   }
 
-  // Remove duplicate points
-  std::vector<Point> tmp;
-  tmp.reserve(points.size());
-
-  for (std::size_t i = 0; i < points.size(); ++i)
+  // Remove duplicate points (in place)
+  std::size_t num_unique = 0;
+  for (std::size_t i = 0; i < num_points; ++i)
   {
     bool different = true;
-    for (std::size_t j = i+1; j < points.size(); ++j)
+    for (std::size_t j = i+1; j < num_points; ++j)
       if ((points[i] - points[j]).norm() < same_point_tol)
       {
 	different = false;
 	break;
       }
     if (different)
-      tmp.push_back(points[i]);
+      points[num_unique++] = points[i];
   }
-  points = tmp;
+  num_points = num_unique;
 
   // Special case: no points found
-  std::vector<double> triangulation;
-  if (points.size() < 3)
-    return triangulation;
+  if (num_points < 3)
+    return 0;
+
+  // A convex polygon has at most 6 vertices. More points can only
+  // remain from rounding of edge-edge intersections near vertices,
+  // and are dropped to stay within the capacity of the buffer.
+  num_points = std::min(num_points, (std::size_t) 6);
 
   // Find left-most point (smallest x-coordinate)
   std::size_t i_min = 0;
   double x_min = points[0].x();
-  for (std::size_t i = 1; i < points.size(); i++)
+  for (std::size_t i = 1; i < num_points; i++)
   {
     const double x = points[i].x();
     if (x < x_min)
@@ -498,8 +529,9 @@ IntersectionTriangulation::triangulate_intersection_triangle_triangle
   }
 
   // Compute signed squared cos of angle with (0, 1) from i_min to all points
-  std::vector<std::pair<double, std::size_t>> order;
-  for (std::size_t i = 0; i < points.size(); i++)
+  std::pair<double, std::size_t> order[6];
+  std::size_t num_order = 0;
+  for (std::size_t i = 0; i < num_points; i++)
   {
     // Skip left-most point used as origin
     if (i == i_min)
@@ -512,28 +544,28 @@ IntersectionTriangulation::triangulate_intersection_triangle_triangle
     const double cos2 = (v.y() < 0.0 ? -1.0 : 1.0)*v.y()*v.y() / v.squared_norm();
 
     // Store for sorting
-    order.push_back(std::make_pair(cos2, i));
+    order[num_order++] = std::make_pair(cos2, i);
   }
 
   // Sort points based on angle
-  std::sort(order.begin(), order.end());
+  std::sort(order, order + num_order);
 
   // Triangulate polygon by connecting i_min with the ordered points
-  triangulation.reserve((points.size() - 2)*3*2);
   const Point& p0 = points[i_min];
-  for (std::size_t i = 0; i < points.size() - 2; i++)
+  for (std::size_t i = 0; i < num_points - 2; i++)
   {
     const Point& p1 = points[order[i].second];
     const Point& p2 = points[order[i + 1].second];
-    triangulation.push_back(p0.x());
-    triangulation.push_back(p0.y());
-    triangulation.push_back(p1.x());
-    triangulation.push_back(p1.y());
-    triangulation.push_back(p2.x());
-    triangulation.push_back(p2.y());
+    double* t = triangulation + 6*i;
+    t[0] = p0.x();
+    t[1] = p0.y();
+    t[2] = p1.x();
+    t[3] = p1.y();
+    t[4] = p2.x();
+    t[5] = p2.y();
   }
 
-  return triangulation;
+  return num_points - 2;
 }
 //-----------------------------------------------------------------------------
 std::vector<double>
@@ -29,6 +29,7 @@ namespace dolfin
 
   // Forward declarations
   class MeshEntity;
+  class Point;
 
   /// This class implements algorithms for computing triangulations of
   /// pairwise intersections of simplices.
@@ -97,6 +98,33 @@ namespace dolfin
     triangulate_intersection_triangle_triangle(const MeshEntity& triangle_0,
                                                const MeshEntity& triangle_1);
 
+    /// Maximum number of values in the triangulation of the
+    /// intersection of two triangles: the intersection is a convex
+    /// polygon with at most 6 vertices, triangulated by at most 4
+    /// triangles of 3 vertices with 2 coordinates
+    static const std::size_t max_triangle_triangle_size = 24;
+
+    /// Compute triangulation of intersection of two triangles in 2D
+    /// into a caller-provided buffer, without allocating memory. The
+    /// combinatorial decisions (which vertices lie in the other
+    /// triangle, which edges cross) are made with the robust
+    /// predicate orient2d.
+    ///
+    /// @param    tri_0 (_Point_ [3])
+    ///         The vertices of the first triangle.
+    /// @param    tri_1 (_Point_ [3])
+    ///         The vertices of the second triangle.
+    /// @param    triangulation (double [max_triangle_triangle_size])
+    ///         The triangles (flattened array of num_triangles x 3 x
+    ///         2 coordinates).
+    ///
+    /// @return    std::size_t
+    ///         The number of triangles.
+    static std::size_t
+    triangulate_intersection_triangle_triangle(const Point* tri_0,
+                                               const Point* tri_1,
+                                               double* triangulation);
+
     /// Compute triangulation of intersection of a tetrahedron and a triangle
     ///
     /// @param    tetrahedron (_MeshEntity_)
@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2014-02-24
-// Last changed: 2014-04-28
+// Last changed: 2017-10-14
 
 #ifndef __SIMPLEX_QUADRATURE_H
 #define __SIMPLEX_QUADRATURE_H
@@ -31,6 +31,10 @@ namespace dolfin
   class Cell;
 
   /// Quadrature on simplices
+  ///
+  /// The rules on the reference simplices are computed once per
+  /// topological dimension and order, and mapped to a physical
+  /// simplex by the affine map from barycentric coordinates.
 
   class SimplexQuadrature
   {
@@ -74,6 +78,49 @@ namespace dolfin
                             std::size_t gdim,
                             std::size_t order);
 
+    /// Return number of points of quadrature rule for simplex.
+    ///
+    /// *Arguments*
+    ///     tdim (std::size_t)
+    ///         The topological dimension of the simplex.
+    ///     order (std::size_t)
+    ///         The order of convergence of the quadrature rule.
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The number of quadrature points.
+    static std::size_t num_points(std::size_t tdim, std::size_t order);
+
+    /// Compute quadrature rule for simplex into given arrays, without
+    /// allocating memory.
+    ///
+    /// *Arguments*
+    ///     coordinates (double *)
+    ///         A flattened array of simplex coordinates of
+    ///         dimension num_vertices x gdim = (tdim + 1)*gdim.
+    ///     tdim (std::size_t)
+    ///         The topological dimension of the simplex.
+    ///     gdim (std::size_t)
+    ///         The geometric dimension.
+    ///     order (std::size_t)
+    ///         The order of convergence of the quadrature rule.
+    ///     points (double *)
+    ///         Array of size num_points(tdim, order) x gdim for the
+    ///         quadrature points.
+    ///     weights (double *)
+    ///         Array of size num_points(tdim, order) for the
+    ///         quadrature weights.
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The number of quadrature points.
+    static std::size_t compute_quadrature_rule(const double* coordinates,
+                                               std::size_t tdim,
+                                               std::size_t gdim,
+                                               std::size_t order,
+                                               double* points,
+                                               double* weights);
+
     /// Compute quadrature rule for interval.
     ///
     /// *Arguments*
@@ -5,9 +5,12 @@
 
 #include <dolfin/geometry/Point.h>
 #include <dolfin/geometry/BoundingBoxTree.h>
+#include <dolfin/geometry/BoundingBoxGrid.h>
+#include <dolfin/geometry/BoundaryDistance.h>
 #include <dolfin/geometry/GenericBoundingBoxTree.h>
 #include <dolfin/geometry/BoundingBoxTree3D.h>
 #include <dolfin/geometry/MeshPointIntersection.h>
 #include <dolfin/geometry/intersect.h>
+#include <dolfin/geometry/predicates.h>
 
 #endif
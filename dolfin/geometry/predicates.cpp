@@ -0,0 +1,173 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// The error bounds and the expansion arithmetic follow J. R.
+// Shewchuk, Adaptive Precision Floating-Point Arithmetic and Fast
+// Robust Geometric Predicates, Discrete & Computational Geometry
+// 18:305-363, 1997.
+
+#include <cmath>
+#include <limits>
+#include "Point.h"
+#include "predicates.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Unit roundoff
+  const double epsilon = 0.5*std::numeric_limits<double>::epsilon();
+
+  // Relative error bounds of the floating-point determinants
+  const double orient2d_error_bound = (3.0 + 16.0*epsilon)*epsilon;
+  const double orient3d_error_bound = (7.0 + 56.0*epsilon)*epsilon;
+
+  // Compute x + y = a + b exactly, with x = fl(a + b)
+  inline void two_sum(double a, double b, double& x, double& y)
+  {
+    x = a + b;
+    const double b_virtual = x - a;
+    const double a_virtual = x - b_virtual;
+    y = (a - a_virtual) + (b - b_virtual);
+  }
+
+  // Add b to the nonoverlapping expansion e of length n (components
+  // in increasing magnitude, no zeros) in place, and return the new
+  // length
+  inline int grow_expansion(double* e, int n, double b)
+  {
+    double q = b;
+    int m = 0;
+    for (int i = 0; i < n; ++i)
+    {
+      double sum, error;
+      two_sum(q, e[i], sum, error);
+      q = sum;
+      if (error != 0.0)
+        e[m++] = error;
+    }
+    if (q != 0.0 or m == 0)
+      e[m++] = q;
+    return m;
+  }
+
+  // Sum of terms (with sign), added exactly to the expansion e of
+  // length n
+  inline int add_product(double* e, int n, double sign, double a, double b)
+  {
+    // a*b = p + q exactly
+    const double p = a*b;
+    const double q = std::fma(a, b, -p);
+    n = grow_expansion(e, n, sign*p);
+    return grow_expansion(e, n, sign*q);
+  }
+
+  inline int add_product(double* e, int n, double sign, double a, double b,
+                         double c)
+  {
+    // a*b*c = (p + q)*c = p*c + q*c exactly
+    const double p = a*b;
+    const double q = std::fma(a, b, -p);
+    n = add_product(e, n, sign, p, c);
+    return add_product(e, n, sign, q, c);
+  }
+
+  // Add det[p, q] (x and y coordinates) times sign exactly
+  inline int add_det2(double* e, int n, double sign, const Point& p,
+                      const Point& q)
+  {
+    n = add_product(e, n, sign, p.x(), q.y());
+    return add_product(e, n, -sign, p.y(), q.x());
+  }
+
+  // Add det[p, q, r] times sign exactly
+  inline int add_det3(double* e, int n, double sign, const Point& p,
+                      const Point& q, const Point& r)
+  {
+    n = add_product(e, n, sign, p.x(), q.y(), r.z());
+    n = add_product(e, n, -sign, p.x(), q.z(), r.y());
+    n = add_product(e, n, -sign, p.y(), q.x(), r.z());
+    n = add_product(e, n, sign, p.y(), q.z(), r.x());
+    n = add_product(e, n, sign, p.z(), q.x(), r.y());
+    return add_product(e, n, -sign, p.z(), q.y(), r.x());
+  }
+
+  // Compute orientation exactly, as determinant of the matrix with
+  // rows [a, 1], [b, 1], [c, 1] expanded along the last column. The
+  // largest component of the expansion has the sign of the result.
+  double orient2d_exact(const Point& a, const Point& b, const Point& c)
+  {
+    double e[16];
+    int n = 0;
+    n = add_det2(e, n, 1.0, b, c);
+    n = add_det2(e, n, -1.0, a, c);
+    n = add_det2(e, n, 1.0, a, b);
+    return e[n - 1];
+  }
+
+  double orient3d_exact(const Point& a, const Point& b, const Point& c,
+                        const Point& d)
+  {
+    double e[128];
+    int n = 0;
+    n = add_det3(e, n, -1.0, b, c, d);
+    n = add_det3(e, n, 1.0, a, c, d);
+    n = add_det3(e, n, -1.0, a, b, d);
+    n = add_det3(e, n, 1.0, a, b, c);
+    return e[n - 1];
+  }
+}
+
+//-----------------------------------------------------------------------------
+double dolfin::orient2d(const Point& a, const Point& b, const Point& c)
+{
+  const double det_left = (a.x() - c.x())*(b.y() - c.y());
+  const double det_right = (a.y() - c.y())*(b.x() - c.x());
+  const double det = det_left - det_right;
+
+  const double bound
+    = orient2d_error_bound*(std::abs(det_left) + std::abs(det_right));
+  if (std::abs(det) > bound)
+    return det;
+
+  return orient2d_exact(a, b, c);
+}
+//-----------------------------------------------------------------------------
+double dolfin::orient3d(const Point& a, const Point& b, const Point& c,
+                        const Point& d)
+{
+  const double adx = a.x() - d.x(), ady = a.y() - d.y(), adz = a.z() - d.z();
+  const double bdx = b.x() - d.x(), bdy = b.y() - d.y(), bdz = b.z() - d.z();
+  const double cdx = c.x() - d.x(), cdy = c.y() - d.y(), cdz = c.z() - d.z();
+
+  const double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy;
+  const double cdxady = cdx*ady, adxcdy = adx*cdy;
+  const double adxbdy = adx*bdy, bdxady = bdx*ady;
+
+  const double det = adz*(bdxcdy - cdxbdy) + bdz*(cdxady - adxcdy)
+    + cdz*(adxbdy - bdxady);
+
+  const double permanent
+    = (std::abs(bdxcdy) + std::abs(cdxbdy))*std::abs(adz)
+    + (std::abs(cdxady) + std::abs(adxcdy))*std::abs(bdz)
+    + (std::abs(adxbdy) + std::abs(bdxady))*std::abs(cdz);
+  if (std::abs(det) > orient3d_error_bound*permanent)
+    return det;
+
+  return orient3d_exact(a, b, c, d);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,68 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __DOLFIN_PREDICATES_H
+#define __DOLFIN_PREDICATES_H
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Point;
+
+  /// Compute the orientation of the points a, b and c in the plane
+  /// (using their x and y coordinates).
+  ///
+  /// The determinant det[a - c, b - c] is computed in floating-point
+  /// arithmetic and returned if its sign is certain from an a priori
+  /// error bound. Otherwise the sign is determined in exact
+  /// arithmetic, so that the sign of the returned value is always
+  /// correct.
+  ///
+  /// @param    a (_Point_)
+  /// @param    b (_Point_)
+  /// @param    c (_Point_)
+  ///
+  /// @return    double
+  ///         Positive if a, b and c are in counterclockwise order,
+  ///         negative if clockwise, and zero if they are collinear.
+  double orient2d(const Point& a, const Point& b, const Point& c);
+
+  /// Compute the orientation of the points a, b, c and d in space.
+  ///
+  /// The determinant det[a - d, b - d, c - d] is computed in
+  /// floating-point arithmetic and returned if its sign is certain
+  /// from an a priori error bound. Otherwise the sign is determined
+  /// in exact arithmetic, so that the sign of the returned value is
+  /// always correct.
+  ///
+  /// @param    a (_Point_)
+  /// @param    b (_Point_)
+  /// @param    c (_Point_)
+  /// @param    d (_Point_)
+  ///
+  /// @return    double
+  ///         Positive if d lies below the plane through a, b and c
+  ///         (where a, b and c appear counterclockwise seen from
+  ///         above), negative if above, and zero if the points are
+  ///         coplanar.
+  double orient3d(const Point& a, const Point& b, const Point& c,
+                  const Point& d);
+
+}
+
+#endif
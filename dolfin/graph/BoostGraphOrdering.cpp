@@ -25,6 +25,7 @@
 #include <boost/graph/properties.hpp>
 
 #include <dolfin/common/Timer.h>
+#include "CSRGraph.h"
 #include "Graph.h"
 #include "BoostGraphOrdering.h"
 
@@ -116,6 +117,50 @@ std::vector<int> BoostGraphOrdering::compute_cuthill_mckee(
   return map;
 }
 //-----------------------------------------------------------------------------
+std::vector<int>
+BoostGraphOrdering::compute_cuthill_mckee(const CSRGraph<int>& graph,
+                                          bool reverse)
+{
+  Timer timer("Boost Cuthill-McKee graph ordering (from dolfin::CSRGraph)");
+
+  // Number of vertices
+  const std::size_t n = graph.size();
+
+  // Typedef for Boost compressed sparse row graph
+  typedef boost::compressed_sparse_row_graph<boost::directedS> BoostGraph;
+
+  // Build Boost graph
+  const BoostGraph boost_graph = build_csr_directed_graph<BoostGraph>(graph);
+
+  // Check if graph has no edges
+  std::vector<int> map(n);
+  if (boost::num_edges(boost_graph) == 0)
+  {
+    // Graph has no edges, so no need to re-order
+    for (std::size_t i = 0; i < map.size(); ++i)
+      map[i] = i;
+  }
+  else
+  {
+    // Boost vertex -> index map
+    const boost::property_map<BoostGraph, boost::vertex_index_t>::type
+      boost_index_map = get(boost::vertex_index, boost_graph);
+
+    // Compute graph re-ordering
+    std::vector<int> inv_perm(n);
+    if (!reverse)
+      boost::cuthill_mckee_ordering(boost_graph, inv_perm.begin());
+    else
+      boost::cuthill_mckee_ordering(boost_graph, inv_perm.rbegin());
+
+    // Build old-to-new vertex map
+    for (std::size_t i = 0; i < map.size(); ++i)
+      map[boost_index_map[inv_perm[i]]] = i;
+  }
+
+  return map;
+}
+//-----------------------------------------------------------------------------
 template<typename T, typename X>
 T BoostGraphOrdering::build_undirected_graph(const X& graph)
 {
@@ -171,22 +216,20 @@ T BoostGraphOrdering::build_csr_directed_graph(const X& graph)
 {
   Timer timer("Build Boost CSR graph");
 
-  // Count number of edges
-  Graph::const_iterator vertex;
+  // Number of vertices
+  const std::size_t n = graph.size();
+
+  // Count number of edges (works for dolfin::Graph and CSRGraph)
   std::size_t num_edges = 0;
-  for (vertex = graph.begin(); vertex != graph.end(); ++vertex)
-    num_edges += vertex->size();
+  for (std::size_t vertex = 0; vertex < n; ++vertex)
+    num_edges += graph[vertex].size();
 
   // Build list of graph edges
   std::vector<std::pair<std::size_t, std::size_t>> edges;
   edges.reserve(num_edges);
-  graph_set_type::const_iterator edge;
-  for (vertex = graph.begin(); vertex != graph.end(); ++vertex)
-    for (edge = vertex->begin(); edge != vertex->end(); ++edge)
-      edges.push_back(std::make_pair(vertex - graph.begin(), *edge));
-
-  // Number of vertices
-  const std::size_t n = graph.size();
+  for (std::size_t vertex = 0; vertex < n; ++vertex)
+    for (auto edge : graph[vertex])
+      edges.push_back(std::make_pair(vertex, edge));
 
   // Build and return Boost graph
   return T(boost::edges_are_unsorted_multi_pass, edges.begin(), edges.end(), n);
@@ -29,6 +29,8 @@
 namespace dolfin
 {
 
+  template<typename T> class CSRGraph;
+
   /// This class computes graph re-orderings. It uses Boost Graph.
 
   class BoostGraphOrdering
@@ -47,6 +49,11 @@ namespace dolfin
       compute_cuthill_mckee(const std::set<std::pair<std::size_t, std::size_t>>& edges,
                             std::size_t size, bool reverse=false);
 
+    /// Compute re-ordering (map[old] -> new) using Cuthill-McKee
+    /// algorithm for a graph in compressed sparse row format
+    static std::vector<int> compute_cuthill_mckee(const CSRGraph<int>& graph,
+                                                  bool reverse=false);
+
   private:
 
     // Build Boost undirected graph
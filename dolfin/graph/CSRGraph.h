@@ -120,6 +120,21 @@ namespace dolfin
       calculate_node_distribution();
     }
 
+    /// Create a CSR Graph from node offsets and edges, which are
+    /// moved into the graph (node_offsets holds the index of the
+    /// first edge of each node, plus a final entry marking the end)
+    CSRGraph(MPI_Comm mpi_comm, std::vector<T>&& node_offsets,
+             std::vector<T>&& edges)
+      : _edges(std::move(edges)), _node_offsets(std::move(node_offsets)),
+        _mpi_comm(mpi_comm)
+    {
+      dolfin_assert(!_node_offsets.empty());
+      dolfin_assert((std::size_t) _node_offsets.back() == _edges.size());
+
+      // Compute node offsets
+      calculate_node_distribution();
+    }
+
     /// Destructor
     ~CSRGraph() {}
 
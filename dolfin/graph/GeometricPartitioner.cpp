@@ -0,0 +1,451 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/log/log.h>
+#include "GeometricPartitioner.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Element-wise reductions of an array over all processes
+  void all_reduce_min(MPI_Comm mpi_comm, std::vector<double>& values)
+  {
+#ifdef HAS_MPI
+    std::vector<double> out(values.size());
+    MPI_Allreduce(values.data(), out.data(), values.size(), MPI_DOUBLE,
+                  MPI_MIN, mpi_comm);
+    values = out;
+#endif
+  }
+  //---------------------------------------------------------------------------
+  void all_reduce_max(MPI_Comm mpi_comm, std::vector<double>& values)
+  {
+#ifdef HAS_MPI
+    std::vector<double> out(values.size());
+    MPI_Allreduce(values.data(), out.data(), values.size(), MPI_DOUBLE,
+                  MPI_MAX, mpi_comm);
+    values = out;
+#endif
+  }
+  //---------------------------------------------------------------------------
+  void all_reduce_sum(MPI_Comm mpi_comm, std::vector<double>& values)
+  {
+#ifdef HAS_MPI
+    std::vector<double> out(values.size());
+    MPI_Allreduce(values.data(), out.data(), values.size(), MPI_DOUBLE,
+                  MPI_SUM, mpi_comm);
+    values = out;
+#endif
+  }
+}
+
+//-----------------------------------------------------------------------------
+void GeometricPartitioner::compute_partition(
+  const MPI_Comm mpi_comm,
+  std::vector<int>& cell_partition,
+  const boost::multi_array<std::int64_t, 2>& cell_vertices,
+  const std::vector<std::size_t>& cell_weight,
+  const boost::multi_array<double, 2>& vertex_coordinates,
+  const std::string method)
+{
+  Timer timer("Compute geometric partition (" + method + ")");
+
+  if (method != "RCB" && method != "SFC")
+  {
+    dolfin_error("GeometricPartitioner.cpp",
+                 "compute geometric partition",
+                 "Unknown method \"%s\". Must be \"RCB\" or \"SFC\"",
+                 method.c_str());
+  }
+
+  const std::size_t num_local_cells = cell_vertices.shape()[0];
+  cell_partition.assign(num_local_cells, 0);
+  if (MPI::size(mpi_comm) == 1)
+    return;
+
+  // Cell weights
+  std::vector<double> weight(num_local_cells, 1.0);
+  if (!cell_weight.empty())
+  {
+    dolfin_assert(cell_weight.size() == num_local_cells);
+    std::copy(cell_weight.begin(), cell_weight.end(), weight.begin());
+  }
+
+  // Some processes may hold no vertices, so agree on geometric
+  // dimension
+  const std::size_t gdim
+    = MPI::max(mpi_comm, (std::size_t) vertex_coordinates.shape()[1]);
+
+  const std::vector<double> midpoints
+    = compute_midpoints(mpi_comm, cell_vertices, vertex_coordinates);
+
+  if (method == "RCB")
+    rcb(mpi_comm, midpoints, gdim, weight, cell_partition);
+  else
+    sfc(mpi_comm, midpoints, gdim, weight, cell_partition);
+}
+//-----------------------------------------------------------------------------
+std::vector<double> GeometricPartitioner::compute_midpoints(
+  const MPI_Comm mpi_comm,
+  const boost::multi_array<std::int64_t, 2>& cell_vertices,
+  const boost::multi_array<double, 2>& vertex_coordinates)
+{
+  const std::size_t mpi_size = MPI::size(mpi_comm);
+  const std::size_t mpi_rank = MPI::rank(mpi_comm);
+  const std::size_t num_local_cells = cell_vertices.shape()[0];
+  const std::size_t num_cell_vertices = cell_vertices.shape()[1];
+  const std::size_t gdim
+    = MPI::max(mpi_comm, (std::size_t) vertex_coordinates.shape()[1]);
+
+  // Compute range of vertices held by each process
+  std::vector<std::size_t> ranges;
+  MPI::all_gather(mpi_comm, (std::size_t) vertex_coordinates.shape()[0],
+                  ranges);
+  for (std::size_t i = 1; i < ranges.size(); ++i)
+    ranges[i] += ranges[i - 1];
+  ranges.insert(ranges.begin(), 0);
+
+  // Get sorted list of required vertices, and request them from
+  // their owners. Since ownership ranges are sorted, the received
+  // coordinates (concatenated in process order) are in the same order
+  // as the required vertices.
+  std::vector<std::int64_t> required_vertices(cell_vertices.data(),
+                                              cell_vertices.data()
+                                              + cell_vertices.num_elements());
+  std::sort(required_vertices.begin(), required_vertices.end());
+  required_vertices.erase(std::unique(required_vertices.begin(),
+                                      required_vertices.end()),
+                          required_vertices.end());
+
+  std::vector<std::vector<std::int64_t>> send_indices(mpi_size);
+  for (auto v : required_vertices)
+  {
+    const std::size_t owner
+      = std::upper_bound(ranges.begin(), ranges.end(), v) - ranges.begin() - 1;
+    dolfin_assert(owner < mpi_size);
+    send_indices[owner].push_back(v);
+  }
+
+  std::vector<std::vector<std::int64_t>> recv_indices;
+  MPI::all_to_all(mpi_comm, send_indices, recv_indices);
+
+  std::vector<std::vector<double>> send_coordinates(mpi_size);
+  for (std::size_t p = 0; p < mpi_size; ++p)
+  {
+    for (auto v : recv_indices[p])
+    {
+      const std::size_t local_index = v - ranges[mpi_rank];
+      send_coordinates[p].insert(send_coordinates[p].end(),
+                                 vertex_coordinates[local_index].begin(),
+                                 vertex_coordinates[local_index].end());
+    }
+  }
+
+  std::vector<double> required_coordinates;
+  MPI::all_to_all(mpi_comm, send_coordinates, required_coordinates);
+  dolfin_assert(required_coordinates.size()
+                == gdim*required_vertices.size());
+
+  // Compute midpoints
+  std::vector<double> midpoints(gdim*num_local_cells, 0.0);
+  for (std::size_t c = 0; c < num_local_cells; ++c)
+  {
+    for (std::size_t i = 0; i < num_cell_vertices; ++i)
+    {
+      const std::size_t pos
+        = std::lower_bound(required_vertices.begin(), required_vertices.end(),
+                           cell_vertices[c][i]) - required_vertices.begin();
+      for (std::size_t j = 0; j < gdim; ++j)
+        midpoints[c*gdim + j] += required_coordinates[pos*gdim + j];
+    }
+    for (std::size_t j = 0; j < gdim; ++j)
+      midpoints[c*gdim + j] /= static_cast<double>(num_cell_vertices);
+  }
+
+  return midpoints;
+}
+//-----------------------------------------------------------------------------
+void GeometricPartitioner::rcb(const MPI_Comm mpi_comm,
+                               const std::vector<double>& midpoints,
+                               std::size_t gdim,
+                               const std::vector<double>& weight,
+                               std::vector<int>& cell_partition)
+{
+  // Number of bisection steps for each cut (relative precision
+  // 2^-32 of the group bounding box)
+  const std::size_t num_bisection_steps = 32;
+
+  const std::size_t mpi_size = MPI::size(mpi_comm);
+  const std::size_t num_local_cells = weight.size();
+
+  // Processes are recursively split into groups. A group consists of
+  // the processes [g, g + group_size[g]), and cell_partition holds the
+  // first process of the group of each cell.
+  std::vector<std::size_t> group_size(mpi_size, 0);
+  group_size[0] = mpi_size;
+  cell_partition.assign(num_local_cells, 0);
+
+  while (*std::max_element(group_size.begin(), group_size.end()) > 1)
+  {
+    // Compute bounding box of each group
+    std::vector<double> xmin(mpi_size*gdim, std::numeric_limits<double>::max());
+    std::vector<double> xmax(mpi_size*gdim, std::numeric_limits<double>::lowest());
+    std::vector<double> group_weight(mpi_size, 0.0);
+    for (std::size_t c = 0; c < num_local_cells; ++c)
+    {
+      const std::size_t g = cell_partition[c];
+      group_weight[g] += weight[c];
+      for (std::size_t j = 0; j < gdim; ++j)
+      {
+        xmin[g*gdim + j] = std::min(xmin[g*gdim + j], midpoints[c*gdim + j]);
+        xmax[g*gdim + j] = std::max(xmax[g*gdim + j], midpoints[c*gdim + j]);
+      }
+    }
+    all_reduce_min(mpi_comm, xmin);
+    all_reduce_max(mpi_comm, xmax);
+    all_reduce_sum(mpi_comm, group_weight);
+
+    // Cut each group normal to the longest side of its bounding box
+    std::vector<std::size_t> axis(mpi_size, 0);
+    std::vector<double> lower(mpi_size, 0.0), upper(mpi_size, 0.0);
+    for (std::size_t g = 0; g < mpi_size; ++g)
+    {
+      if (group_size[g] < 2 || xmin[g*gdim] > xmax[g*gdim])
+        continue;
+      for (std::size_t j = 1; j < gdim; ++j)
+      {
+        if (xmax[g*gdim + j] - xmin[g*gdim + j]
+            > xmax[g*gdim + axis[g]] - xmin[g*gdim + axis[g]])
+        {
+          axis[g] = j;
+        }
+      }
+      lower[g] = xmin[g*gdim + axis[g]];
+      upper[g] = xmax[g*gdim + axis[g]];
+    }
+
+    // Find cut positions by bisection, such that the weight below
+    // the cut is proportional to the number of processes in the
+    // lower half of the group
+    std::vector<double> cut(mpi_size);
+    for (std::size_t step = 0; step < num_bisection_steps; ++step)
+    {
+      for (std::size_t g = 0; g < mpi_size; ++g)
+        cut[g] = 0.5*(lower[g] + upper[g]);
+
+      std::vector<double> weight_below(mpi_size, 0.0);
+      for (std::size_t c = 0; c < num_local_cells; ++c)
+      {
+        const std::size_t g = cell_partition[c];
+        if (group_size[g] > 1 && midpoints[c*gdim + axis[g]] < cut[g])
+          weight_below[g] += weight[c];
+      }
+      all_reduce_sum(mpi_comm, weight_below);
+
+      for (std::size_t g = 0; g < mpi_size; ++g)
+      {
+        if (group_size[g] < 2)
+          continue;
+        const std::size_t n0 = group_size[g]/2;
+        const double target = group_weight[g]*static_cast<double>(n0)
+          /static_cast<double>(group_size[g]);
+        if (weight_below[g] < target)
+          lower[g] = cut[g];
+        else
+          upper[g] = cut[g];
+      }
+    }
+
+    // Move cells above the cut to the upper half of their group
+    for (std::size_t c = 0; c < num_local_cells; ++c)
+    {
+      const std::size_t g = cell_partition[c];
+      if (group_size[g] > 1 && midpoints[c*gdim + axis[g]] >= cut[g])
+        cell_partition[c] = g + group_size[g]/2;
+    }
+
+    // Split groups
+    std::vector<std::size_t> new_group_size(group_size);
+    for (std::size_t g = 0; g < mpi_size; ++g)
+    {
+      if (group_size[g] < 2)
+        continue;
+      const std::size_t n0 = group_size[g]/2;
+      new_group_size[g] = n0;
+      new_group_size[g + n0] = group_size[g] - n0;
+    }
+    group_size = new_group_size;
+  }
+}
+//-----------------------------------------------------------------------------
+void GeometricPartitioner::sfc(const MPI_Comm mpi_comm,
+                               const std::vector<double>& midpoints,
+                               std::size_t gdim,
+                               const std::vector<double>& weight,
+                               std::vector<int>& cell_partition)
+{
+  // Number of samples of the local key distribution contributed by
+  // each process to the choice of splitters
+  const std::size_t num_samples = 32;
+
+  const std::size_t mpi_size = MPI::size(mpi_comm);
+  const std::size_t num_local_cells = weight.size();
+
+  // Global bounding box of midpoints
+  std::vector<double> xmin(gdim, std::numeric_limits<double>::max());
+  std::vector<double> xmax(gdim, std::numeric_limits<double>::lowest());
+  for (std::size_t c = 0; c < num_local_cells; ++c)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      xmin[j] = std::min(xmin[j], midpoints[c*gdim + j]);
+      xmax[j] = std::max(xmax[j], midpoints[c*gdim + j]);
+    }
+  }
+  all_reduce_min(mpi_comm, xmin);
+  all_reduce_max(mpi_comm, xmax);
+
+  // Compute Hilbert keys of midpoints, using 64 bit keys
+  const int bits = (gdim == 3) ? 21 : 32;
+  const double max_coordinate
+    = static_cast<double>((std::uint64_t(1) << bits) - 1);
+  std::vector<std::pair<std::size_t, std::size_t>> keys(num_local_cells);
+  std::vector<std::uint32_t> x(gdim);
+  for (std::size_t c = 0; c < num_local_cells; ++c)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      const double extent = xmax[j] - xmin[j];
+      const double s = (extent > 0.0) ? (midpoints[c*gdim + j] - xmin[j])/extent
+        : 0.0;
+      x[j] = static_cast<std::uint32_t>(s*max_coordinate);
+    }
+    keys[c] = std::make_pair(hilbert_index(x, bits), c);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // Sample local keys at equally spaced quantiles of the local weight
+  const double local_weight = std::accumulate(weight.begin(), weight.end(), 0.0);
+  std::vector<std::size_t> sample_keys(num_samples, 0);
+  std::vector<double> sample_weights(num_samples, 0.0);
+  double cumulative_weight = 0.0;
+  std::size_t pos = 0;
+  for (std::size_t k = 0; k < num_samples && num_local_cells > 0; ++k)
+  {
+    const double target = (k + 0.5)*local_weight/num_samples;
+    while (pos + 1 < num_local_cells
+           && cumulative_weight + weight[keys[pos].second] < target)
+    {
+      cumulative_weight += weight[keys[pos].second];
+      ++pos;
+    }
+    sample_keys[k] = keys[pos].first;
+    sample_weights[k] = local_weight/num_samples;
+  }
+
+  std::vector<std::size_t> all_sample_keys;
+  std::vector<double> all_sample_weights;
+  MPI::all_gather(mpi_comm, sample_keys, all_sample_keys);
+  MPI::all_gather(mpi_comm, sample_weights, all_sample_weights);
+
+  // Choose splitters at equally spaced quantiles of the global weight
+  std::vector<std::pair<std::size_t, double>> samples(all_sample_keys.size());
+  for (std::size_t i = 0; i < samples.size(); ++i)
+    samples[i] = std::make_pair(all_sample_keys[i], all_sample_weights[i]);
+  std::sort(samples.begin(), samples.end());
+  const double total_weight = std::accumulate(all_sample_weights.begin(),
+                                              all_sample_weights.end(), 0.0);
+  std::vector<std::size_t> splitters;
+  cumulative_weight = 0.0;
+  for (const auto& sample : samples)
+  {
+    cumulative_weight += sample.second;
+    while (splitters.size() + 1 < mpi_size
+           && cumulative_weight
+           >= total_weight*(splitters.size() + 1)/mpi_size)
+    {
+      splitters.push_back(sample.first);
+    }
+  }
+  splitters.resize(mpi_size - 1, std::numeric_limits<std::size_t>::max());
+
+  // Assign cells to processes by key range
+  for (const auto& key : keys)
+  {
+    cell_partition[key.second]
+      = std::upper_bound(splitters.begin(), splitters.end(), key.first)
+      - splitters.begin();
+  }
+}
+//-----------------------------------------------------------------------------
+std::size_t GeometricPartitioner::hilbert_index(std::vector<std::uint32_t> x,
+                                                int bits)
+{
+  const std::size_t n = x.size();
+  if (n == 1)
+    return x[0];
+
+  // Convert coordinates to transposed Hilbert index (J. Skilling,
+  // "Programming the Hilbert curve", AIP Conf. Proc. 707, 2004)
+  const std::uint32_t m = std::uint32_t(1) << (bits - 1);
+
+  // Inverse undo excess work
+  for (std::uint32_t q = m; q > 1; q >>= 1)
+  {
+    const std::uint32_t p = q - 1;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      if (x[i] & q)
+        x[0] ^= p;
+      else
+      {
+        const std::uint32_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  for (std::size_t i = 1; i < n; ++i)
+    x[i] ^= x[i - 1];
+  std::uint32_t t = 0;
+  for (std::uint32_t q = m; q > 1; q >>= 1)
+  {
+    if (x[n - 1] & q)
+      t ^= q - 1;
+  }
+  for (std::size_t i = 0; i < n; ++i)
+    x[i] ^= t;
+
+  // Interleave bits of transposed index
+  std::size_t index = 0;
+  for (int b = bits - 1; b >= 0; --b)
+    for (std::size_t i = 0; i < n; ++i)
+      index = (index << 1) | ((x[i] >> b) & 1);
+
+  return index;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,83 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __GEOMETRIC_PARTITIONER_H
+#define __GEOMETRIC_PARTITIONER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/multi_array.hpp>
+#include <dolfin/common/MPI.h>
+
+namespace dolfin
+{
+
+  /// This class provides geometric partitioning of cells by their
+  /// midpoints. No dual graph is built, so partitioning is much
+  /// cheaper than with a graph partitioner, at the cost of a larger
+  /// edge cut.
+
+  class GeometricPartitioner
+  {
+  public:
+
+    /// Compute cell partition from cell midpoints. The output vector
+    /// cell_partition contains the desired destination process
+    /// numbers for each cell. The method is "RCB" (recursive
+    /// coordinate bisection) or "SFC" (sorting of the midpoints along
+    /// a Hilbert space-filling curve). Vertex coordinates must be
+    /// distributed across processes in contiguous blocks of global
+    /// vertex indices, in process order. If cell_weight is not empty,
+    /// the sum of weights is balanced instead of the number of cells.
+    static void
+      compute_partition(const MPI_Comm mpi_comm,
+                        std::vector<int>& cell_partition,
+                        const boost::multi_array<std::int64_t, 2>& cell_vertices,
+                        const std::vector<std::size_t>& cell_weight,
+                        const boost::multi_array<double, 2>& vertex_coordinates,
+                        const std::string method);
+
+  private:
+
+    // Compute midpoints (flattened, gdim values per cell), fetching
+    // the coordinates of off-process vertices
+    static std::vector<double>
+      compute_midpoints(const MPI_Comm mpi_comm,
+                        const boost::multi_array<std::int64_t, 2>& cell_vertices,
+                        const boost::multi_array<double, 2>& vertex_coordinates);
+
+    // Recursive coordinate bisection
+    static void rcb(const MPI_Comm mpi_comm, const std::vector<double>& midpoints,
+                    std::size_t gdim, const std::vector<double>& weight,
+                    std::vector<int>& cell_partition);
+
+    // Partition along Hilbert curve with parallel sample sort
+    static void sfc(const MPI_Comm mpi_comm, const std::vector<double>& midpoints,
+                    std::size_t gdim, const std::vector<double>& weight,
+                    std::vector<int>& cell_partition);
+
+    // Hilbert curve index of point with integer coordinates x (with
+    // given number of bits per coordinate)
+    static std::size_t hilbert_index(std::vector<std::uint32_t> x, int bits);
+
+  };
+
+}
+
+#endif
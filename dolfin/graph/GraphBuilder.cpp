@@ -21,14 +21,20 @@
 // Last changed: 2013-01-31
 
 #include <algorithm>
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
 #include <numeric>
 #include <set>
 #include <utility>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
+#include <boost/functional/hash.hpp>
 
 #include <dolfin/log/log.h>
+#include <dolfin/common/MonotonicArena.h>
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/ArrayView.h>
@@ -86,36 +92,47 @@ Graph GraphBuilder::local_graph(const Mesh& mesh,
   const std::size_t num_vertices = mesh.num_entities(coloring_type[0]);
   Graph graph(num_vertices);
 
+  // Entity lists are allocated from an arena, which is released
+  // after each vertex so that its memory is reused
+  typedef std::unordered_set<std::size_t, std::hash<std::size_t>,
+                             std::equal_to<std::size_t>,
+                             ArenaAllocator<std::size_t>> EntitySet;
+  MonotonicArena arena;
+
   // Build graph
   for (MeshEntityIterator vertex_entity(mesh, coloring_type[0]);
        !vertex_entity.end(); ++vertex_entity)
   {
     const std::size_t vertex_entity_index = vertex_entity->index();
 
-    std::unordered_set<std::size_t> entity_list0;
-    std::unordered_set<std::size_t> entity_list1;
-    entity_list0.insert(vertex_entity_index);
-
-    // Build list of entities, moving between levels
-    for (std::size_t level = 1; level < coloring_type.size(); ++level)
     {
-      for (std::unordered_set<std::size_t>::const_iterator entity_index
-             = entity_list0.begin(); entity_index != entity_list0.end();
-           ++entity_index)
+      EntitySet entity_list0(arena);
+      EntitySet entity_list1(arena);
+      entity_list0.insert(vertex_entity_index);
+
+      // Build list of entities, moving between levels
+      for (std::size_t level = 1; level < coloring_type.size(); ++level)
       {
-        const MeshEntity entity(mesh, coloring_type[level -1], *entity_index);
-        for (MeshEntityIterator neighbor(entity, coloring_type[level]);
-             !neighbor.end(); ++neighbor)
+        for (auto entity_index = entity_list0.begin();
+             entity_index != entity_list0.end(); ++entity_index)
         {
-          entity_list1.insert(neighbor->index());
+          const MeshEntity entity(mesh, coloring_type[level -1],
+                                  *entity_index);
+          for (MeshEntityIterator neighbor(entity, coloring_type[level]);
+               !neighbor.end(); ++neighbor)
+          {
+            entity_list1.insert(neighbor->index());
+          }
         }
+        entity_list0.swap(entity_list1);
+        entity_list1.clear();
       }
-      entity_list0 = entity_list1;
-      entity_list1.clear();
-    }
 
-    // Add edges to graph
-    graph[vertex_entity_index].insert(entity_list0.begin(), entity_list0.end());
+      // Add edges to graph
+      graph[vertex_entity_index].insert(entity_list0.begin(),
+                                        entity_list0.end());
+    }
+    arena.release();
   }
 
   return graph;
@@ -153,32 +170,289 @@ Graph GraphBuilder::local_graph(const Mesh& mesh,
   return graph;
 }
 //-----------------------------------------------------------------------------
-std::pair<std::int32_t, std::int32_t>
+template<typename T>
+std::unique_ptr<CSRGraph<T>>
 GraphBuilder::compute_dual_graph(const MPI_Comm mpi_comm,
                                  const boost::multi_array<std::int64_t, 2>& cell_vertices,
                                  const CellType& cell_type,
-                                 const std::int64_t num_global_vertices,
-                                 std::vector<std::vector<std::size_t>>& local_graph,
                                  std::set<std::int64_t>& ghost_vertices)
 {
   log(PROGRESS, "Build mesh dual graph");
 
-  // Compute local part of dual graph
-  FacetCellMap facet_cell_map;
-  std::int32_t num_local_edges = compute_local_dual_graph(mpi_comm, cell_vertices,
-                                                          cell_type, local_graph,
-                                                          facet_cell_map);
+  const std::int8_t tdim = cell_type.dim();
+  const std::int8_t num_entity_vertices = cell_type.num_vertices(tdim - 1);
+  switch (num_entity_vertices)
+  {
+  case 1:
+    return compute_dual_graph_keyed<T, 1>(mpi_comm, cell_vertices, cell_type,
+                                          ghost_vertices);
+  case 2:
+    return compute_dual_graph_keyed<T, 2>(mpi_comm, cell_vertices, cell_type,
+                                          ghost_vertices);
+  case 3:
+    return compute_dual_graph_keyed<T, 3>(mpi_comm, cell_vertices, cell_type,
+                                          ghost_vertices);
+  case 4:
+    return compute_dual_graph_keyed<T, 4>(mpi_comm, cell_vertices, cell_type,
+                                          ghost_vertices);
+  default:
+    dolfin_error("GraphBuilder.cpp",
+                 "compute dual graph",
+                 "Entities with %d vertices not supported",
+                 num_entity_vertices);
+    return nullptr;
+  }
+}
+//-----------------------------------------------------------------------------
+/// @cond
+// Explicit instantiation for the index types of ParMETIS and SCOTCH
+template std::unique_ptr<CSRGraph<int>>
+GraphBuilder::compute_dual_graph<int>(const MPI_Comm,
+                                      const boost::multi_array<std::int64_t, 2>&,
+                                      const CellType&, std::set<std::int64_t>&);
+template std::unique_ptr<CSRGraph<long>>
+GraphBuilder::compute_dual_graph<long>(const MPI_Comm,
+                                       const boost::multi_array<std::int64_t, 2>&,
+                                       const CellType&, std::set<std::int64_t>&);
+template std::unique_ptr<CSRGraph<long long>>
+GraphBuilder::compute_dual_graph<long long>(const MPI_Comm,
+                                            const boost::multi_array<std::int64_t, 2>&,
+                                            const CellType&, std::set<std::int64_t>&);
+/// @endcond
+//-----------------------------------------------------------------------------
+template<typename T, int N>
+std::unique_ptr<CSRGraph<T>>
+GraphBuilder::compute_dual_graph_keyed(const MPI_Comm mpi_comm,
+                                       const boost::multi_array<std::int64_t, 2>& cell_vertices,
+                                       const CellType& cell_type,
+                                       std::set<std::int64_t>& ghost_vertices)
+{
+  Timer timer("Compute mesh dual graph");
+
+  const std::int8_t tdim = cell_type.dim();
+  const std::int32_t num_local_cells = cell_vertices.shape()[0];
+  const std::int8_t num_vertices_per_cell = cell_type.num_entities(0);
+  const std::int8_t num_facets_per_cell = cell_type.num_entities(tdim - 1);
+
+  dolfin_assert(N == cell_type.num_vertices(tdim - 1));
+  dolfin_assert(num_vertices_per_cell == (int) cell_vertices.shape()[1]);
+
+  // Global number of first local cell
+  const std::int64_t cell_offset
+    = MPI::global_offset(mpi_comm, num_local_cells, true);
+
+  // Create map from cell vertices to entity vertices
+  boost::multi_array<unsigned int, 2>
+    facet_vertices(boost::extents[num_facets_per_cell][N]);
+  std::vector<unsigned int> v(num_vertices_per_cell);
+  std::iota(v.begin(), v.end(), 0);
+  cell_type.create_entities(facet_vertices, tdim - 1, v.data());
+
+  // Build flat list of all facets (keyed on sorted global vertex
+  // indices), with local cell index attached, and sort
+  std::vector<std::pair<std::array<std::int64_t, N>, std::int32_t>>
+    facets(num_facets_per_cell*num_local_cells);
+  std::size_t counter = 0;
+  for (std::int32_t i = 0; i < num_local_cells; ++i)
+  {
+    for (std::int8_t j = 0; j < num_facets_per_cell; ++j)
+    {
+      auto& facet = facets[counter].first;
+      for (std::int8_t k = 0; k < N; ++k)
+        facet[k] = cell_vertices[i][facet_vertices[j][k]];
+      std::sort(facet.begin(), facet.end());
+      facets[counter].second = i;
+      ++counter;
+    }
+  }
+  std::sort(facets.begin(), facets.end());
+
+  // Edges (local cell, global cell). Matching facets give local edges
+  // (both ways), unmatched facets are compacted to the front of the
+  // facet list.
+  std::vector<std::pair<std::int32_t, std::int64_t>> edges;
+  edges.reserve(facets.size());
+  std::size_t num_unmatched = 0;
+  for (std::size_t i = 0; i < facets.size(); ++i)
+  {
+    if (i + 1 < facets.size() && facets[i].first == facets[i + 1].first)
+    {
+      edges.push_back({facets[i].second, facets[i + 1].second + cell_offset});
+      edges.push_back({facets[i + 1].second, facets[i].second + cell_offset});
+      ++i;
+    }
+    else
+      facets[num_unmatched++] = facets[i];
+  }
+  facets.resize(num_unmatched);
+
+  ghost_vertices.clear();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  if (num_processes > 1)
+  {
+    // Send unmatched facets (vertices and global cell index) to the
+    // match-making process given by the hash of the facet. Sort
+    // facets by destination first, so that the buffers are built in
+    // one pass.
+    std::vector<std::pair<std::int32_t, std::size_t>> facet_dest(num_unmatched);
+    for (std::size_t i = 0; i < num_unmatched; ++i)
+    {
+      const std::size_t hash
+        = boost::hash_range(facets[i].first.begin(), facets[i].first.end());
+      facet_dest[i] = {hash % num_processes, i};
+    }
+    std::sort(facet_dest.begin(), facet_dest.end());
+
+    std::vector<int> destinations, sources;
+    std::vector<std::vector<std::int64_t>> send_buffer;
+    for (const auto& fd : facet_dest)
+    {
+      if (destinations.empty() || destinations.back() != fd.first)
+      {
+        destinations.push_back(fd.first);
+        send_buffer.push_back(std::vector<std::int64_t>());
+      }
+      const auto& facet = facets[fd.second];
+      send_buffer.back().insert(send_buffer.back().end(),
+                                facet.first.begin(), facet.first.end());
+      send_buffer.back().push_back(facet.second + cell_offset);
+    }
+    facet_dest.clear();
+    facets.clear();
+    facets.shrink_to_fit();
+
+    std::vector<std::vector<std::int64_t>> received_buffer;
+    sparse_exchange(mpi_comm, destinations, sources, send_buffer,
+                    received_buffer, false);
+    send_buffer.clear();
+
+    // Match received facets by sorting, keeping the index of the
+    // sending process and the global cell index
+    std::vector<std::pair<std::array<std::int64_t, N>,
+                          std::pair<std::int32_t, std::int64_t>>>
+      received_facets;
+    for (std::size_t p = 0; p < received_buffer.size(); ++p)
+    {
+      const std::vector<std::int64_t>& data_p = received_buffer[p];
+      for (auto it = data_p.begin(); it != data_p.end(); it += (N + 1))
+      {
+        received_facets.push_back({std::array<std::int64_t, N>(),
+                                   {p, *(it + N)}});
+        std::copy(it, it + N, received_facets.back().first.begin());
+      }
+      std::vector<std::int64_t>().swap(received_buffer[p]);
+    }
+    std::sort(received_facets.begin(), received_facets.end());
+
+    // Send matches back (pairs of own cell, connected cell)
+    std::vector<std::vector<std::int64_t>> send_matches(sources.size());
+    for (std::size_t i = 1; i < received_facets.size(); ++i)
+    {
+      const auto& f0 = received_facets[i - 1];
+      const auto& f1 = received_facets[i];
+      if (f0.first == f1.first)
+      {
+        send_matches[f0.second.first].push_back(f0.second.second);
+        send_matches[f0.second.first].push_back(f1.second.second);
+        send_matches[f1.second.first].push_back(f1.second.second);
+        send_matches[f1.second.first].push_back(f0.second.second);
+        ++i;
+      }
+    }
+    received_facets.clear();
 
-  // Compute nonlocal part
-  std::int32_t num_nonlocal_edges
-    = compute_nonlocal_dual_graph(mpi_comm, cell_vertices, cell_type,
-                                  num_global_vertices, local_graph, facet_cell_map,
-                                  ghost_vertices);
+    std::vector<std::vector<std::int64_t>> received_matches;
+    sparse_exchange(mpi_comm, destinations, sources, send_matches,
+                    received_matches, true);
 
-  // Shrink to fit
-  local_graph.shrink_to_fit();
+    // Add non-local edges
+    for (const auto& matches : received_matches)
+    {
+      for (std::size_t i = 0; i < matches.size(); i += 2)
+      {
+        dolfin_assert(matches[i] >= cell_offset);
+        dolfin_assert(matches[i] - cell_offset < num_local_cells);
+        edges.push_back({matches[i] - cell_offset, matches[i + 1]});
+        ghost_vertices.insert(matches[i + 1]);
+      }
+    }
+  }
 
-  return {num_local_edges, num_nonlocal_edges};
+  // Build CSR graph directly from edge list (counting sort by cell)
+  std::vector<T> node_offsets(num_local_cells + 1, 0);
+  for (const auto& e : edges)
+    ++node_offsets[e.first + 1];
+  std::partial_sum(node_offsets.begin(), node_offsets.end(),
+                   node_offsets.begin());
+  std::vector<T> graph_edges(edges.size());
+  std::vector<T> pos(node_offsets.begin(), node_offsets.end() - 1);
+  for (const auto& e : edges)
+    graph_edges[pos[e.first]++] = e.second;
+  pos.clear();
+  edges.clear();
+  edges.shrink_to_fit();
+
+  return std::unique_ptr<CSRGraph<T>>(new CSRGraph<T>(mpi_comm,
+                                                      std::move(node_offsets),
+                                                      std::move(graph_edges)));
+}
+//-----------------------------------------------------------------------------
+void GraphBuilder::sparse_exchange(const MPI_Comm mpi_comm,
+                                   std::vector<int>& destinations,
+                                   std::vector<int>& sources,
+                                   const std::vector<std::vector<std::int64_t>>& in_values,
+                                   std::vector<std::vector<std::int64_t>>& out_values,
+                                   bool reply)
+{
+#ifdef HAS_MPI
+  MPI_Comm graph_comm;
+  if (!reply)
+  {
+    // Create pattern from destinations. MPI finds the sources, and
+    // may reorder the neighbours, so query and reorder the send
+    // buffers accordingly.
+    dolfin_assert(in_values.size() == destinations.size());
+    const int rank = MPI::rank(mpi_comm);
+    const int degree = destinations.size();
+    MPI_Dist_graph_create(mpi_comm, 1, &rank, &degree, destinations.data(),
+                          MPI_UNWEIGHTED, MPI_INFO_NULL, 0, &graph_comm);
+
+    int indegree = 0, outdegree = 0, weighted = 0;
+    MPI_Dist_graph_neighbors_count(graph_comm, &indegree, &outdegree,
+                                   &weighted);
+    dolfin_assert(outdegree == degree);
+    std::vector<int> graph_sources(indegree), graph_destinations(outdegree);
+    MPI_Dist_graph_neighbors(graph_comm, indegree, graph_sources.data(),
+                             MPI_UNWEIGHTED, outdegree,
+                             graph_destinations.data(), MPI_UNWEIGHTED);
+
+    std::map<int, std::size_t> position;
+    for (std::size_t i = 0; i < destinations.size(); ++i)
+      position[destinations[i]] = i;
+    std::vector<std::vector<std::int64_t>> ordered_values(outdegree);
+    for (int i = 0; i < outdegree; ++i)
+      ordered_values[i] = in_values[position[graph_destinations[i]]];
+
+    destinations = graph_destinations;
+    sources = graph_sources;
+    MPI::neighbor_all_to_all(graph_comm, ordered_values, out_values);
+    MPI_Comm_free(&graph_comm);
+  }
+  else
+  {
+    // Reverse the pattern of a previous exchange
+    dolfin_assert(in_values.size() == sources.size());
+    MPI_Dist_graph_create_adjacent(mpi_comm, destinations.size(),
+                                   destinations.data(), MPI_UNWEIGHTED,
+                                   sources.size(), sources.data(),
+                                   MPI_UNWEIGHTED, MPI_INFO_NULL, 0,
+                                   &graph_comm);
+    MPI::neighbor_all_to_all(graph_comm, in_values, out_values);
+    MPI_Comm_free(&graph_comm);
+  }
+#else
+  out_values = in_values;
+#endif
 }
 //-----------------------------------------------------------------------------
 std::int32_t GraphBuilder::compute_local_dual_graph(
@@ -337,141 +611,3 @@ std::int32_t GraphBuilder::compute_local_dual_graph_keyed(
   return num_local_edges;
 }
 //-----------------------------------------------------------------------------
-std::int32_t GraphBuilder::compute_nonlocal_dual_graph(
-  const MPI_Comm mpi_comm,
-  const boost::multi_array<std::int64_t, 2>& cell_vertices,
-  const CellType& cell_type,
-  const std::int64_t num_global_vertices,
-  std::vector<std::vector<std::size_t>>& local_graph,
-  FacetCellMap& facet_cell_map,
-  std::set<std::int64_t>& ghost_vertices)
-{
-  log(PROGRESS, "Build nonlocal part of mesh dual graph");
-  Timer timer("Compute non-local part of mesh dual graph");
-
-  // Get number of MPI processes, and return if mesh is not distributed
-  const int num_processes = MPI::size(mpi_comm);
-  if (num_processes == 1)
-    return 0;
-
-  // At this stage facet_cell map only contains facets->cells with
-  // edge facets either interprocess or external boundaries
-
-  const int tdim = cell_type.dim();
-
-  // List of cell vertices
-  const std::int32_t num_local_cells = cell_vertices.shape()[0];
-  const std::int8_t num_vertices_per_cell = cell_type.num_entities(0);
-  const std::int8_t num_vertices_per_facet = cell_type.num_vertices(tdim - 1);
-
-  dolfin_assert(num_local_cells == (int) cell_vertices.shape()[0]);
-  dolfin_assert(num_vertices_per_cell == (int) cell_vertices.shape()[1]);
-
-  // Compute local edges (cell-cell connections) using global
-  // (internal to this function, not the user numbering) numbering
-
-  // Get offset for this process
-  const std::int64_t offset = MPI::global_offset(mpi_comm, num_local_cells,
-                                                 true);
-
-  // Send facet-cell map to intermediary match-making processes
-  std::vector<std::vector<std::size_t>> send_buffer(num_processes);
-  std::vector<std::vector<std::size_t>> received_buffer(num_processes);
-
-  // Pack map data and send to match-maker process
-  for (auto &it : facet_cell_map)
-  {
-    // FIXME: Could use a better index? First vertex is slightly
-    //        skewed towards low values - may not be important
-
-    // Use first vertex of facet to partition into blocks
-    const int dest_proc = MPI::index_owner(mpi_comm, (it.first)[0],
-                                           num_global_vertices);
-
-    // Pack map into vectors to send
-    send_buffer[dest_proc].insert(send_buffer[dest_proc].end(),
-                                  it.first.begin(), it.first.end());
-
-    // Add offset to cell numbers sent off process
-    send_buffer[dest_proc].push_back(it.second + offset);
-  }
-
-  // FIXME: This does not look memory scalable. Switch to 'post-office' model.
-  // Send data
-  MPI::all_to_all(mpi_comm, send_buffer, received_buffer);
-
-  // Clear send buffer
-  send_buffer = std::vector<std::vector<std::size_t>>(num_processes);
-
-  // Map to connect processes and cells, using facet as key
-  typedef boost::unordered_map<std::vector<std::size_t>,
-              std::pair<std::size_t, std::size_t>> MatchMap;
-  MatchMap matchmap;
-
-  // Look for matches to send back to other processes
-  std::pair<std::vector<std::size_t>,
-            std::pair<std::size_t, std::size_t>> key;
-  key.first.resize(num_vertices_per_facet);
-  for (int p = 0; p < num_processes; ++p)
-  {
-    // Unpack into map
-    const std::vector<std::size_t>& data_p = received_buffer[p];
-    for (auto it = data_p.begin(); it != data_p.end();
-         it += (num_vertices_per_facet + 1))
-    {
-      // Build map key
-      std::copy(it, it + num_vertices_per_facet, key.first.begin());
-      key.second.first = p;
-      key.second.second = *(it + num_vertices_per_facet);
-
-      // Perform map insertion/look-up
-      std::pair<MatchMap::iterator, bool> data = matchmap.insert(key);
-
-      // If data is already in the map, extract data and remove from
-      // map
-      if (!data.second)
-      {
-        // Found a match of two facets - send back to owners
-        const std::size_t proc1 = data.first->second.first;
-        const std::size_t proc2 = p;
-        const std::size_t cell1 = data.first->second.second;
-        const std::size_t cell2 = key.second.second;
-        send_buffer[proc1].push_back(cell1);
-        send_buffer[proc1].push_back(cell2);
-        send_buffer[proc2].push_back(cell2);
-        send_buffer[proc2].push_back(cell1);
-
-        // Remove facet - saves memory and search time
-        matchmap.erase(data.first);
-      }
-    }
-  }
-
-  // Send matches to other processes
-  std::vector<std::size_t> cell_list;
-  MPI::all_to_all(mpi_comm, send_buffer, cell_list);
-
-  // Clear ghost vertices
-  ghost_vertices.clear();
-
-  // Insert connected cells into local map
-  std::int32_t num_nonlocal_edges = 0;
-  for (std::size_t i = 0; i < cell_list.size(); i += 2)
-  {
-    dolfin_assert((std::int64_t) cell_list[i] >= offset);
-    dolfin_assert((std::int64_t)  (cell_list[i] - offset)
-                  < (std::int64_t) local_graph.size());
-
-    auto& edges = local_graph[cell_list[i] - offset];
-    auto it = std::find(edges.begin(), edges.end(), cell_list[i + 1]);
-    if (it == local_graph[cell_list[i] - offset].end())
-    {
-      edges.push_back(cell_list[i + 1]);
-      ++num_nonlocal_edges;
-    }
-    ghost_vertices.insert(cell_list[i + 1]);
-  }
-
-  return num_nonlocal_edges;
-}
-//-----------------------------------------------------------------------------
@@ -22,12 +22,14 @@
 #define __GRAPH_BUILDER_H
 
 #include <cstdint>
+#include <memory>
 #include <utility>
 #include <set>
 #include <boost/unordered_map.hpp>
 #include <vector>
 #include <boost/multi_array.hpp>
 #include <dolfin/common/MPI.h>
+#include "CSRGraph.h"
 #include "Graph.h"
 
 namespace dolfin
@@ -58,15 +60,14 @@ namespace dolfin
                              std::size_t dim1);
 
     /// Build distributed dual graph (cell-cell connections) from
-    /// minimal mesh data, and return (num local edges, num
-    /// non-local edges)
-    static
-      std::pair<std::int32_t, std::int32_t>
+    /// minimal mesh data. Cells are numbered globally by process
+    /// order. The global numbers of off-process cells connected to
+    /// local cells are returned in ghost_vertices.
+    template<typename T>
+      static std::unique_ptr<CSRGraph<T>>
       compute_dual_graph(const MPI_Comm mpi_comm,
                          const boost::multi_array<std::int64_t, 2>& cell_vertices,
                          const CellType& cell_type,
-                         const std::int64_t num_global_vertices,
-                         std::vector<std::vector<std::size_t>>& local_graph,
                          std::set<std::int64_t>& ghost_vertices);
   private:
 
@@ -94,17 +95,29 @@ namespace dolfin
                                      std::vector<std::vector<std::size_t>>& local_graph,
                                      FacetCellMap& facet_cell_map);
 
-    // Build nonlocal part of dual graph for mesh and return number of
-    // non-local edges. Note: GraphBuilder::compute_local_dual_graph
-    // should be called before this function is called.
-    static std::int32_t
-      compute_nonlocal_dual_graph(const MPI_Comm mpi_comm,
-                                  const boost::multi_array<std::int64_t, 2>& cell_vertices,
-                                  const CellType& cell_type,
-                                  const std::int64_t num_global_vertices,
-                                  std::vector<std::vector<std::size_t>>& local_graph,
-                                  FacetCellMap& facet_cell_map,
-                                  std::set<std::int64_t>& ghost_vertices);
+    // Build distributed dual graph for cells with facets of N
+    // vertices. Facets are matched locally by sorting, and unmatched
+    // facets are matched on a process chosen by hashing the facet,
+    // communicating only with processes that exchange facets.
+    template<typename T, int N>
+      static std::unique_ptr<CSRGraph<T>>
+      compute_dual_graph_keyed(const MPI_Comm mpi_comm,
+                               const boost::multi_array<std::int64_t, 2>& cell_vertices,
+                               const CellType& cell_type,
+                               std::set<std::int64_t>& ghost_vertices);
+
+    // Exchange data with the processes on a (temporary) sparse
+    // communication pattern. in_values[i] is sent to process
+    // destinations[i], and out_values[j] is received from process
+    // sources[j]. If reply is true, in_values[i] is sent to
+    // sources[i] and out_values[j] received from destinations[j],
+    // reusing the pattern of a previous exchange.
+    static void sparse_exchange(const MPI_Comm mpi_comm,
+                                std::vector<int>& destinations,
+                                std::vector<int>& sources,
+                                const std::vector<std::vector<std::int64_t>>& in_values,
+                                std::vector<std::vector<std::int64_t>>& out_values,
+                                bool reply);
 
   };
 
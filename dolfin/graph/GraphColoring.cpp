@@ -24,8 +24,15 @@
 // Included here to avoid a C++ problem with some MPI implementations
 #include <dolfin/common/MPI.h>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <dolfin/common/Array.h>
+#include <dolfin/common/SubSystemsManager.h>
+#include <dolfin/common/Timer.h>
 #include <dolfin/log/log.h>
 #include <dolfin/parameter/GlobalParameters.h>
 #include "BoostGraphColoring.h"
@@ -47,12 +54,240 @@ std::size_t GraphColoring::compute_local_vertex_coloring(const Graph& graph,
     return BoostGraphColoring::compute_local_vertex_coloring(graph, colors);
   else if (colorer == "Zoltan")
     return ZoltanInterface::compute_local_vertex_coloring(graph, colors);
+  else if (colorer == "JonesPlassmann")
+  {
+    std::vector<std::int64_t> global_indices(graph.size());
+    std::iota(global_indices.begin(), global_indices.end(), 0);
+    const std::map<std::int32_t, std::set<unsigned int>> no_shared_vertices;
+    return compute_vertex_coloring_jones_plassmann(MPI_COMM_SELF, graph,
+                                                   global_indices,
+                                                   graph.size(),
+                                                   no_shared_vertices,
+                                                   true, colors);
+  }
   else
   {
     dolfin_error("GraphColoring.cpp",
                  "compute mesh coloring",
-                 "Unknown coloring type. Known types are \"Boost\" and \"Zoltan\"");
+                 "Unknown coloring type. Known types are \"Boost\", \"Zoltan\" and \"JonesPlassmann\"");
     return 0;
   }
 }
+//-----------------------------------------------------------------------------
+std::size_t GraphColoring::compute_vertex_coloring_jones_plassmann(
+  MPI_Comm mpi_comm,
+  const Graph& graph,
+  const std::vector<std::int64_t>& global_indices,
+  std::size_t num_owned,
+  const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices,
+  bool balance,
+  std::vector<std::size_t>& colors)
+{
+  Timer timer("Compute Jones-Plassmann graph coloring");
+
+  const std::size_t num_vertices = graph.size();
+  dolfin_assert(global_indices.size() == num_vertices);
+  dolfin_assert(num_owned <= num_vertices);
+  const std::size_t uncolored = std::numeric_limits<std::size_t>::max();
+  const int num_threads = SubSystemsManager::num_threads();
+
+  // Vertex priorities: hash of global index (splitmix64 finaliser),
+  // with the global index to break ties
+  std::vector<std::pair<std::uint64_t, std::int64_t>> priority(num_vertices);
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t v = 0; v < (std::int64_t) num_vertices; ++v)
+  {
+    std::uint64_t z = global_indices[v] + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+    priority[v] = std::make_pair(z ^ (z >> 31), global_indices[v]);
+  }
+
+  // Map from global index to local index of ghost vertices
+  std::unordered_map<std::int64_t, std::size_t> ghost_local_index;
+  for (std::size_t v = num_owned; v < num_vertices; ++v)
+    ghost_local_index[global_indices[v]] = v;
+
+  // Ghosts which have not been colored but may be ignored (only if
+  // their owner does not communicate their color)
+  std::vector<char> ignore_ghost(num_vertices, 0);
+
+  colors.assign(num_vertices, uncolored);
+  std::vector<std::size_t> remaining(num_owned);
+  std::iota(remaining.begin(), remaining.end(), 0);
+  std::vector<char> selected;
+  std::size_t previous_num_remaining = uncolored;
+  while (true)
+  {
+    const std::size_t num_remaining
+      = MPI::sum(mpi_comm, (std::size_t) remaining.size());
+    if (num_remaining == 0)
+      break;
+
+    // If no process made progress, a ghost is waiting for a color
+    // that its owner will not send. Stop waiting for such ghosts.
+    if (num_remaining == previous_num_remaining)
+    {
+      for (std::size_t v = num_owned; v < num_vertices; ++v)
+        ignore_ghost[v] = (colors[v] == uncolored);
+    }
+    previous_num_remaining = num_remaining;
+
+    // Select uncolored vertices with higher priority than all their
+    // uncolored neighbours (an independent set)
+    const std::int64_t num_local_remaining = remaining.size();
+    selected.assign(num_local_remaining, 0);
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 256)
+    for (std::int64_t i = 0; i < num_local_remaining; ++i)
+    {
+      const std::size_t v = remaining[i];
+      char is_max = 1;
+      for (auto u = graph[v].begin(); u != graph[v].end(); ++u)
+      {
+        if (colors[*u] == uncolored && !ignore_ghost[*u]
+            && priority[v] < priority[*u])
+        {
+          is_max = 0;
+          break;
+        }
+      }
+      selected[i] = is_max;
+    }
+
+    // Color the selected vertices with the smallest color not used
+    // by a neighbour. Neighbours of a selected vertex are not
+    // selected, so their colors do not change in this loop.
+    #pragma omp parallel num_threads(num_threads)
+    {
+      std::vector<char> used;
+      #pragma omp for schedule(dynamic, 256)
+      for (std::int64_t i = 0; i < num_local_remaining; ++i)
+      {
+        if (!selected[i])
+          continue;
+        const std::size_t v = remaining[i];
+        used.assign(graph[v].size() + 1, 0);
+        for (auto u = graph[v].begin(); u != graph[v].end(); ++u)
+        {
+          if (colors[*u] < used.size())
+            used[colors[*u]] = 1;
+        }
+        colors[v] = std::find(used.begin(), used.end(), 0) - used.begin();
+      }
+    }
+
+    // Send colors of newly colored shared vertices to the processes
+    // on which they are ghosts, and remove colored vertices from the
+    // list of remaining vertices
+    std::map<int, std::vector<std::int64_t>> send_colors, recv_colors;
+    std::size_t num_kept = 0;
+    for (std::int64_t i = 0; i < num_local_remaining; ++i)
+    {
+      const std::size_t v = remaining[i];
+      if (!selected[i])
+      {
+        remaining[num_kept++] = v;
+        continue;
+      }
+
+      auto sharing = shared_vertices.find(v);
+      if (sharing != shared_vertices.end())
+      {
+        for (auto p = sharing->second.begin(); p != sharing->second.end(); ++p)
+        {
+          send_colors[*p].push_back(global_indices[v]);
+          send_colors[*p].push_back(colors[v]);
+        }
+      }
+    }
+    remaining.resize(num_kept);
+
+    // Receive colors of ghost vertices
+    MPI::sparse_all_to_all(mpi_comm, send_colors, recv_colors);
+    for (auto r = recv_colors.begin(); r != recv_colors.end(); ++r)
+    {
+      for (std::size_t i = 0; i < r->second.size(); i += 2)
+      {
+        auto ghost = ghost_local_index.find(r->second[i]);
+        if (ghost != ghost_local_index.end())
+          colors[ghost->second] = r->second[i + 1];
+      }
+    }
+  }
+
+  // Ghosts whose color was never received are given a color
+  // consistent with their local neighbours
+  for (std::size_t v = num_owned; v < num_vertices; ++v)
+  {
+    if (colors[v] != uncolored)
+      continue;
+    std::vector<char> used(graph[v].size() + 1, 0);
+    for (auto u = graph[v].begin(); u != graph[v].end(); ++u)
+    {
+      if (colors[*u] < used.size())
+        used[colors[*u]] = 1;
+    }
+    colors[v] = std::find(used.begin(), used.end(), 0) - used.begin();
+  }
+
+  // Number of colors on this process
+  std::size_t num_colors = 0;
+  for (std::size_t v = 0; v < num_vertices; ++v)
+    num_colors = std::max(num_colors, colors[v] + 1);
+
+  // Balance color classes. Only owned vertices with owned neighbours
+  // which are not shared are moved, so that no communication is
+  // needed.
+  if (balance && num_owned > 0 && num_colors > 1)
+  {
+    std::vector<std::size_t> class_size(num_colors, 0);
+    for (std::size_t v = 0; v < num_owned; ++v)
+      ++class_size[colors[v]];
+    const std::size_t target = (num_owned + num_colors - 1)/num_colors;
+
+    std::vector<char> used(num_colors);
+    for (std::size_t v = 0; v < num_owned; ++v)
+    {
+      const std::size_t c = colors[v];
+      if (class_size[c] <= target
+          || shared_vertices.find(v) != shared_vertices.end())
+      {
+        continue;
+      }
+
+      std::fill(used.begin(), used.end(), 0);
+      bool movable = true;
+      for (auto u = graph[v].begin(); u != graph[v].end(); ++u)
+      {
+        if ((std::size_t) *u >= num_owned)
+        {
+          movable = false;
+          break;
+        }
+        used[colors[*u]] = 1;
+      }
+      if (!movable)
+        continue;
+
+      // Move to the smallest permitted class below the target size
+      std::size_t best = c;
+      for (std::size_t k = 0; k < num_colors; ++k)
+      {
+        if (!used[k] && class_size[k] < target
+            && (best == c || class_size[k] < class_size[best]))
+        {
+          best = k;
+        }
+      }
+      if (best != c)
+      {
+        --class_size[c];
+        ++class_size[best];
+        colors[v] = best;
+      }
+    }
+  }
+
+  return num_colors;
+}
 //----------------------------------------------------------------------------
@@ -23,7 +23,11 @@
 
 
 #include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
 #include <vector>
+#include <dolfin/common/MPI.h>
 #include "Graph.h"
 
 namespace dolfin
@@ -41,6 +45,38 @@ namespace dolfin
       compute_local_vertex_coloring(const Graph& graph,
                                     std::vector<std::size_t>& colors);
 
+    /// Compute vertex colors with the Jones-Plassmann algorithm.
+    /// Vertices are colored in rounds. In each round, the uncolored
+    /// vertices whose priority exceeds that of all their uncolored
+    /// neighbours form an independent set, and each takes the
+    /// smallest color not used by its neighbours. Rounds are threaded
+    /// (see SubSystemsManager::num_threads). Priorities are a hash of
+    /// the global vertex indices, so the coloring does not depend on
+    /// the local numbering or the number of threads.
+    ///
+    /// Vertices num_owned, ..., graph.size() - 1 are ghosts, which
+    /// are colored by their owning process: shared_vertices maps
+    /// each owned vertex that is a ghost on other processes to these
+    /// processes, and colors are communicated after each round. The
+    /// ghost layer must contain the graph neighbours of the shared
+    /// vertices for the colors of ghosts to be consistent. The
+    /// function is collective on mpi_comm.
+    ///
+    /// If balance is true, owned vertices away from the process
+    /// boundary are afterwards moved from over-full to under-full
+    /// color classes (where the coloring permits), to even out the
+    /// sizes of the color classes. Returns the number of colors used
+    /// on this process.
+    static std::size_t
+      compute_vertex_coloring_jones_plassmann(
+        MPI_Comm mpi_comm,
+        const Graph& graph,
+        const std::vector<std::int64_t>& global_indices,
+        std::size_t num_owned,
+        const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices,
+        bool balance,
+        std::vector<std::size_t>& colors);
+
   };
 }
 
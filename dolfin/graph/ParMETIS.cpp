@@ -118,6 +118,8 @@ void ParMETIS::compute_partition(const MPI_Comm mpi_comm,
                                  std::vector<int>& cell_partition,
                                  std::map<std::int64_t, std::vector<int>>& ghost_procs,
                                  const boost::multi_array<std::int64_t, 2>& cell_vertices,
+                                 const std::vector<std::size_t>& cell_weight,
+                                 const std::size_t num_cell_weights,
                                  const std::size_t num_global_vertices,
                                  const CellType& cell_type,
                                  const std::string mode)
@@ -146,35 +148,58 @@ void ParMETIS::compute_partition(const MPI_Comm mpi_comm,
   else
   {
     // Compute dual graph with DOLFIN
-    std::vector<std::vector<std::size_t>> local_graph;
     std::set<std::int64_t> ghost_vertices;
-    GraphBuilder::compute_dual_graph(mpi_comm, cell_vertices, cell_type,
-                                     num_global_vertices, local_graph,
-                                     ghost_vertices);
-
-    csr_graph = std::make_shared<CSRGraph<idx_t>>(mpi_comm, local_graph);
+    csr_graph = GraphBuilder::compute_dual_graph<idx_t>(mpi_comm, cell_vertices,
+                                                        cell_type,
+                                                        ghost_vertices);
+  }
 
+  // Copy cell weights (num_cell_weights balance constraints per
+  // cell). All processes must agree on whether weights are used.
+  std::vector<idx_t> node_weights;
+  const std::size_t ncon = std::max(num_cell_weights, (std::size_t) 1);
+  if (dolfin::MPI::max(mpi_comm, cell_weight.size()) > 0)
+  {
+    if (cell_weight.size() != ncon*cell_vertices.shape()[0])
+    {
+      dolfin_error("ParMETIS.cpp",
+                   "compute mesh partitioning using ParMETIS",
+                   "Number of cell weights (%d) does not match number of cells (%d) times number of constraints (%d)",
+                   cell_weight.size(), cell_vertices.shape()[0], ncon);
+    }
+    node_weights.assign(cell_weight.begin(), cell_weight.end());
   }
 
   // Partition graph
   dolfin_assert(csr_graph);
   if (mode == "partition")
-    partition(comm.comm(), *csr_graph, cell_partition, ghost_procs);
+  {
+    partition(comm.comm(), *csr_graph, node_weights, ncon, cell_partition,
+              ghost_procs);
+  }
   else if (mode == "adaptive_repartition")
-    adaptive_repartition(comm.comm(), *csr_graph, cell_partition);
+  {
+    adaptive_repartition(comm.comm(), *csr_graph, node_weights, ncon,
+                         cell_partition, ghost_procs);
+  }
   else if (mode == "refine")
-    refine(comm.comm(), *csr_graph, cell_partition);
+  {
+    refine(comm.comm(), *csr_graph, node_weights, ncon, cell_partition,
+           ghost_procs);
+  }
   else
   {
     dolfin_error("ParMETIS.cpp",
                  "compute mesh partitioning using ParMETIS",
-                 "partition model %s is unknown. Must be \"partition\", \"adactive_partition\" or \"refine\"",
+                 "partition model %s is unknown. Must be \"partition\", \"adaptive_repartition\" or \"refine\"",
                  mode.c_str());
   }
 }
 //-----------------------------------------------------------------------------
 template <typename T>
 void ParMETIS::partition(MPI_Comm mpi_comm, CSRGraph<T>& csr_graph,
+                         const std::vector<T>& node_weights,
+                         std::size_t num_node_weights,
                          std::vector<int>& cell_partition,
                          std::map<std::int64_t, std::vector<int>>& ghost_procs)
 {
@@ -189,12 +214,13 @@ void ParMETIS::partition(MPI_Comm mpi_comm, CSRGraph<T>& csr_graph,
   // Number of partitions (one for each process)
   idx_t nparts = dolfin::MPI::size(mpi_comm);
 
-  // Strange weight arrays needed by ParMETIS
-  idx_t ncon = 1;
+  // Number of balance constraints and (optional) vertex weights
+  idx_t ncon = num_node_weights;
+  std::vector<idx_t> vwgt(node_weights.begin(), node_weights.end());
+  idx_t* elmwgt = vwgt.empty() ? NULL : vwgt.data();
 
   // Prepare remaining arguments for ParMETIS
-  idx_t* elmwgt = NULL;
-  idx_t wgtflag = 0;
+  idx_t wgtflag = vwgt.empty() ? 0 : 2;
   idx_t edgecut = 0;
   idx_t numflag = 0;
   std::vector<real_t> tpwgts(ncon*nparts, 1.0/static_cast<real_t>(nparts));
@@ -215,108 +241,8 @@ void ParMETIS::partition(MPI_Comm mpi_comm, CSRGraph<T>& csr_graph,
   dolfin_assert(err == METIS_OK);
   timer1.stop();
 
-  Timer timer2("Compute graph halo data (ParMETIS)");
-
-  // Work out halo cells for current division of dual graph
-  const auto& elmdist = csr_graph.node_distribution();
-  const auto& xadj = csr_graph.nodes();
-  const auto& adjncy = csr_graph.edges();
-  const std::int32_t num_processes = dolfin::MPI::size(mpi_comm);
-  const std::int32_t process_number = dolfin::MPI::rank(mpi_comm);
-  const idx_t elm_begin = elmdist[process_number];
-  const idx_t elm_end = elmdist[process_number + 1];
-  const std::int32_t ncells = elm_end - elm_begin;
-
-  std::map<idx_t, std::set<std::int32_t>> halo_cell_to_remotes;
-  // local indexing "i"
-  for(int i = 0; i < ncells; i++)
-  {
-    for(auto other_cell : csr_graph[i]) //idx_t j = xadj[i]; j != xadj[i + 1]; ++j)
-    {
-      //      const idx_t other_cell = adjncy[j];
-      if (other_cell < elm_begin || other_cell >= elm_end)
-      {
-        const int remote
-          = std::upper_bound(elmdist.begin(), elmdist.end(), other_cell)
-          - elmdist.begin() - 1;
-
-        dolfin_assert(remote < num_processes);
-        if (halo_cell_to_remotes.find(i) == halo_cell_to_remotes.end())
-          halo_cell_to_remotes[i] = std::set<std::int32_t>();
-        halo_cell_to_remotes[i].insert(remote);
-      }
-    }
-  }
-
-  // Do halo exchange of cell partition data
-  std::vector<std::vector<std::int64_t>> send_cell_partition(num_processes);
-  std::vector<std::int64_t> recv_cell_partition;
-  for(const auto& hcell : halo_cell_to_remotes)
-  {
-    for(auto proc : hcell.second)
-    {
-      dolfin_assert(proc < num_processes);
-
-      // global cell number
-      send_cell_partition[proc].push_back(hcell.first + elm_begin);
-
-      //partitioning
-      send_cell_partition[proc].push_back(part[hcell.first]);
-    }
-  }
-
-  // Actual halo exchange
-  dolfin::MPI::all_to_all(mpi_comm, send_cell_partition, recv_cell_partition);
-
-  // Construct a map from all currently foreign cells to their new
-  // partition number
-  std::map<std::int64_t, std::int32_t> cell_ownership;
-  for (auto p = recv_cell_partition.begin(); p != recv_cell_partition.end(); p += 2)
-  {
-    cell_ownership[*p] = *(p + 1);
-  }
-
-  // Generate mapping for where new boundary cells need to be sent
-  for(std::int32_t i = 0; i < ncells; i++)
-  {
-    const std::size_t proc_this = part[i];
-    for (idx_t j = xadj[i]; j < xadj[i + 1]; ++j)
-    {
-      const idx_t other_cell = adjncy[j];
-      std::size_t proc_other;
-
-      if (other_cell < elm_begin || other_cell >= elm_end)
-      { // remote cell - should be in map
-        const auto find_other_proc = cell_ownership.find(other_cell);
-        dolfin_assert(find_other_proc != cell_ownership.end());
-        proc_other = find_other_proc->second;
-      }
-      else
-        proc_other = part[other_cell - elm_begin];
-
-      if (proc_this != proc_other)
-      {
-        auto map_it = ghost_procs.find(i);
-        if (map_it == ghost_procs.end())
-        {
-          std::vector<std::int32_t> sharing_processes;
-          sharing_processes.push_back(proc_this);
-          sharing_processes.push_back(proc_other);
-          ghost_procs.insert({i, sharing_processes});
-        }
-        else
-        {
-          // Add to vector if not already there
-          auto it = std::find(map_it->second.begin(), map_it->second.end(), proc_other);
-          if (it == map_it->second.end())
-            map_it->second.push_back(proc_other);
-        }
-
-      }
-    }
-  }
-
-  timer2.stop();
+  // Compute halo cells for new partition
+  compute_ghost_procs(mpi_comm, csr_graph, part, ghost_procs);
 
   // Copy cell partition data
   cell_partition.assign(part.begin(), part.end());
@@ -325,7 +251,10 @@ void ParMETIS::partition(MPI_Comm mpi_comm, CSRGraph<T>& csr_graph,
 template <typename T>
 void ParMETIS::adaptive_repartition(MPI_Comm mpi_comm,
                                     CSRGraph<T>& csr_graph,
-                                    std::vector<int>& cell_partition)
+                                    const std::vector<T>& node_weights,
+                                    std::size_t num_node_weights,
+                                    std::vector<int>& cell_partition,
+                                    std::map<std::int64_t, std::vector<int>>& ghost_procs)
 {
   Timer timer("Compute graph partition (ParMETIS Adaptive Repartition)");
 
@@ -342,7 +271,12 @@ void ParMETIS::adaptive_repartition(MPI_Comm mpi_comm,
   Timer timer1("ParMETIS: call ParMETIS_V3_AdaptiveRepart");
   const double itr = parameters["ParMETIS_repartitioning_weight"];
   real_t _itr = itr;
-  std::vector<idx_t> part(csr_graph.size());
+
+  // Partitioning array, input is the current distribution of cells
+  // (ParMETIS migrates cells relative to this). Prefill with
+  // process_number.
+  const std::int32_t process_number = dolfin::MPI::rank(mpi_comm);
+  std::vector<idx_t> part(csr_graph.size(), process_number);
   std::vector<idx_t> vsize(part.size(), 1);
   dolfin_assert(!part.empty());
 
@@ -350,9 +284,10 @@ void ParMETIS::adaptive_repartition(MPI_Comm mpi_comm,
   idx_t nparts = dolfin::MPI::size(mpi_comm);
 
   // Remaining ParMETIS parameters
-  idx_t ncon = 1;
-  idx_t* elmwgt = NULL;
-  idx_t wgtflag = 0;
+  idx_t ncon = num_node_weights;
+  std::vector<idx_t> vwgt(node_weights.begin(), node_weights.end());
+  idx_t* elmwgt = vwgt.empty() ? NULL : vwgt.data();
+  idx_t wgtflag = vwgt.empty() ? 0 : 2;
   idx_t edgecut = 0;
   idx_t numflag = 0;
   std::vector<real_t> tpwgts(ncon*nparts, 1.0/static_cast<real_t>(nparts));
@@ -370,6 +305,9 @@ void ParMETIS::adaptive_repartition(MPI_Comm mpi_comm,
   dolfin_assert(err == METIS_OK);
   timer1.stop();
 
+  // Compute halo cells for new partition
+  compute_ghost_procs(mpi_comm, csr_graph, part, ghost_procs);
+
   // Copy cell partition data
   cell_partition.assign(part.begin(), part.end());
 }
@@ -377,7 +315,10 @@ void ParMETIS::adaptive_repartition(MPI_Comm mpi_comm,
 template<typename T>
 void ParMETIS::refine(MPI_Comm mpi_comm,
                       CSRGraph<T>& csr_graph,
-                      std::vector<int>& cell_partition)
+                      const std::vector<T>& node_weights,
+                      std::size_t num_node_weights,
+                      std::vector<int>& cell_partition,
+                      std::map<std::int64_t, std::vector<int>>& ghost_procs)
 {
   Timer timer("Compute graph partition (ParMETIS Refine)");
 
@@ -404,9 +345,10 @@ void ParMETIS::refine(MPI_Comm mpi_comm,
   // Number of partitions (one for each process)
   idx_t nparts = dolfin::MPI::size(mpi_comm);
   // Remaining ParMETIS parameters
-  idx_t ncon = 1;
-  idx_t* elmwgt = NULL;
-  idx_t wgtflag = 0;
+  idx_t ncon = num_node_weights;
+  std::vector<idx_t> vwgt(node_weights.begin(), node_weights.end());
+  idx_t* elmwgt = vwgt.empty() ? NULL : vwgt.data();
+  idx_t wgtflag = vwgt.empty() ? 0 : 2;
   idx_t edgecut = 0;
   idx_t numflag = 0;
   std::vector<real_t> tpwgts(ncon*nparts, 1.0/static_cast<real_t>(nparts));
@@ -424,16 +366,128 @@ void ParMETIS::refine(MPI_Comm mpi_comm,
   dolfin_assert(err == METIS_OK);
   timer1.stop();
 
+  // Compute halo cells for new partition
+  compute_ghost_procs(mpi_comm, csr_graph, part, ghost_procs);
+
   // Copy cell partition data
   cell_partition.assign(part.begin(), part.end());
 }
 //-----------------------------------------------------------------------------
+template<typename T>
+void ParMETIS::compute_ghost_procs(MPI_Comm mpi_comm,
+                                   const CSRGraph<T>& csr_graph,
+                                   const std::vector<T>& part,
+                                   std::map<std::int64_t, std::vector<int>>& ghost_procs)
+{
+  Timer timer("Compute graph halo data (ParMETIS)");
+
+  // Work out halo cells for current division of dual graph
+  const auto& elmdist = csr_graph.node_distribution();
+  const auto& xadj = csr_graph.nodes();
+  const auto& adjncy = csr_graph.edges();
+  const std::int32_t num_processes = dolfin::MPI::size(mpi_comm);
+  const std::int32_t process_number = dolfin::MPI::rank(mpi_comm);
+  const idx_t elm_begin = elmdist[process_number];
+  const idx_t elm_end = elmdist[process_number + 1];
+  const std::int32_t ncells = elm_end - elm_begin;
+
+  std::map<idx_t, std::set<std::int32_t>> halo_cell_to_remotes;
+  // local indexing "i"
+  for(int i = 0; i < ncells; i++)
+  {
+    for(auto other_cell : csr_graph[i]) //idx_t j = xadj[i]; j != xadj[i + 1]; ++j)
+    {
+      //      const idx_t other_cell = adjncy[j];
+      if (other_cell < elm_begin || other_cell >= elm_end)
+      {
+        const int remote
+          = std::upper_bound(elmdist.begin(), elmdist.end(), other_cell)
+          - elmdist.begin() - 1;
+
+        dolfin_assert(remote < num_processes);
+        if (halo_cell_to_remotes.find(i) == halo_cell_to_remotes.end())
+          halo_cell_to_remotes[i] = std::set<std::int32_t>();
+        halo_cell_to_remotes[i].insert(remote);
+      }
+    }
+  }
+
+  // Do halo exchange of cell partition data
+  std::vector<std::vector<std::int64_t>> send_cell_partition(num_processes);
+  std::vector<std::int64_t> recv_cell_partition;
+  for(const auto& hcell : halo_cell_to_remotes)
+  {
+    for(auto proc : hcell.second)
+    {
+      dolfin_assert(proc < num_processes);
+
+      // global cell number
+      send_cell_partition[proc].push_back(hcell.first + elm_begin);
+
+      //partitioning
+      send_cell_partition[proc].push_back(part[hcell.first]);
+    }
+  }
+
+  // Actual halo exchange
+  dolfin::MPI::all_to_all(mpi_comm, send_cell_partition, recv_cell_partition);
+
+  // Construct a map from all currently foreign cells to their new
+  // partition number
+  std::map<std::int64_t, std::int32_t> cell_ownership;
+  for (auto p = recv_cell_partition.begin(); p != recv_cell_partition.end(); p += 2)
+  {
+    cell_ownership[*p] = *(p + 1);
+  }
+
+  // Generate mapping for where new boundary cells need to be sent
+  for(std::int32_t i = 0; i < ncells; i++)
+  {
+    const std::size_t proc_this = part[i];
+    for (idx_t j = xadj[i]; j < xadj[i + 1]; ++j)
+    {
+      const idx_t other_cell = adjncy[j];
+      std::size_t proc_other;
+
+      if (other_cell < elm_begin || other_cell >= elm_end)
+      { // remote cell - should be in map
+        const auto find_other_proc = cell_ownership.find(other_cell);
+        dolfin_assert(find_other_proc != cell_ownership.end());
+        proc_other = find_other_proc->second;
+      }
+      else
+        proc_other = part[other_cell - elm_begin];
+
+      if (proc_this != proc_other)
+      {
+        auto map_it = ghost_procs.find(i);
+        if (map_it == ghost_procs.end())
+        {
+          std::vector<std::int32_t> sharing_processes;
+          sharing_processes.push_back(proc_this);
+          sharing_processes.push_back(proc_other);
+          ghost_procs.insert({i, sharing_processes});
+        }
+        else
+        {
+          // Add to vector if not already there
+          auto it = std::find(map_it->second.begin(), map_it->second.end(), proc_other);
+          if (it == map_it->second.end())
+            map_it->second.push_back(proc_other);
+        }
+
+      }
+    }
+  }
+}
 //-----------------------------------------------------------------------------
 #else
 void ParMETIS::compute_partition(const MPI_Comm mpi_comm,
                                  std::vector<int>& cell_partition,
                                  std::map<std::int64_t, std::vector<int>>& ghost_procs,
                                  const boost::multi_array<std::int64_t, 2>& cell_vertices,
+                                 const std::vector<std::size_t>& cell_weight,
+                                 const std::size_t num_cell_weights,
                                  const std::size_t num_global_vertices,
                                  const CellType& cell_type,
                                  const std::string mode)
@@ -48,11 +48,16 @@ namespace dolfin
     /// "adaptive_repartition" or "refine". For meshes that have
     /// already been partitioned or are already well partitioned, it
     /// can be advantageous to use "adaptive_repartition" or "refine".
+    /// If cell_weight is not empty, it holds num_cell_weights
+    /// weights (balance constraints) for each cell, stored cell by
+    /// cell, and ParMETIS balances each constraint separately.
     static void
       compute_partition(const MPI_Comm mpi_comm,
                         std::vector<int>& cell_partition,
                         std::map<std::int64_t, std::vector<int>>& ghost_procs,
                         const boost::multi_array<std::int64_t, 2>& cell_vertices,
+                        const std::vector<std::size_t>& cell_weight,
+                        const std::size_t num_cell_weights,
                         const std::size_t num_global_vertices,
                         const CellType& cell_type,
                         const std::string mode="partition");
@@ -66,6 +71,8 @@ namespace dolfin
     template <typename T>
       static void partition(MPI_Comm mpi_comm,
                             CSRGraph<T>& csr_graph,
+                            const std::vector<T>& node_weights,
+                            std::size_t num_node_weights,
                             std::vector<int>& cell_partition,
                             std::map<std::int64_t, std::vector<int>>& ghost_procs);
 
@@ -74,13 +81,28 @@ namespace dolfin
     template <typename T>
       static void adaptive_repartition(MPI_Comm mpi_comm,
                                        CSRGraph<T>& csr_graph,
-                                       std::vector<int>& cell_partition);
+                                       const std::vector<T>& node_weights,
+                                       std::size_t num_node_weights,
+                                       std::vector<int>& cell_partition,
+                                       std::map<std::int64_t, std::vector<int>>& ghost_procs);
 
     // ParMETIS refine repartition. CSRGraph should be const, but
     // ParMETIS accesses it non-const, so has to be non-const here
     template <typename T>
       static void refine(MPI_Comm mpi_comm, CSRGraph<T>& csr_graph,
-                         std::vector<int>& cell_partition);
+                         const std::vector<T>& node_weights,
+                         std::size_t num_node_weights,
+                         std::vector<int>& cell_partition,
+                         std::map<std::int64_t, std::vector<int>>& ghost_procs);
+
+    // Compute processes sharing each cell on the boundary of the
+    // new partition (halo cells), given the new destination process
+    // of each local cell
+    template <typename T>
+      static void compute_ghost_procs(MPI_Comm mpi_comm,
+                                      const CSRGraph<T>& csr_graph,
+                                      const std::vector<T>& part,
+                                      std::map<std::int64_t, std::vector<int>>& ghost_procs);
 #endif
 
 
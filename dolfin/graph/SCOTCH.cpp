@@ -59,21 +59,11 @@ void SCOTCH::compute_partition(const MPI_Comm mpi_comm,
 {
 
 
-  // Create data structures to hold graph
-  std::unique_ptr<CSRGraph<SCOTCH_Num>> csr_graph;
+  // Compute dual graph (for this parition)
   std::set<std::int64_t> ghost_vertices;
-
-  // Build dual graph. Use scoping to clean up memory
-  {
-    // Compute dual graph (for this parition)
-    std::vector<std::vector<std::size_t>> local_graph;
-    GraphBuilder::compute_dual_graph(mpi_comm, cell_vertices, cell_type,
-                                     num_global_vertices, local_graph,
-                                     ghost_vertices);
-
-    csr_graph.reset(new CSRGraph<SCOTCH_Num>(MPI_COMM_SELF,
-                                             local_graph));
-  }
+  std::unique_ptr<CSRGraph<SCOTCH_Num>> csr_graph
+    = GraphBuilder::compute_dual_graph<SCOTCH_Num>(mpi_comm, cell_vertices,
+                                                   cell_type, ghost_vertices);
 
   // Compute partitions
   dolfin_assert(csr_graph);
@@ -6,6 +6,7 @@
 #include <dolfin/graph/Graph.h>
 #include <dolfin/graph/GraphBuilder.h>
 #include <dolfin/graph/BoostGraphOrdering.h>
+#include <dolfin/graph/GeometricPartitioner.h>
 #include <dolfin/graph/SCOTCH.h>
 
 #endif
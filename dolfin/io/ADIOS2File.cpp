@@ -0,0 +1,285 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifdef HAS_ADIOS2
+
+#include <adios2.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshEntityIterator.h>
+#include <dolfin/mesh/MeshFunction.h>
+#include "ADIOS2File.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Put local array with given number of columns in current step,
+  // defining the variable in the first step
+  template<typename T>
+  void put_local_array(adios2::IO& io, adios2::Engine& engine,
+                       const std::string name, const std::vector<T>& data,
+                       std::size_t num_columns)
+  {
+    dolfin_assert(num_columns > 0);
+    dolfin_assert(data.size() % num_columns == 0);
+    const adios2::Dims count = {data.size()/num_columns, num_columns};
+    adios2::Variable<T> variable = io.InquireVariable<T>(name);
+    if (variable)
+      variable.SetSelection({adios2::Dims(), count});
+    else
+      variable = io.DefineVariable<T>(name, {}, {}, count);
+    engine.Put(variable, data.data(), adios2::Mode::Sync);
+  }
+}
+
+//-----------------------------------------------------------------------------
+ADIOS2File::ADIOS2File(MPI_Comm comm, const std::string filename,
+                       const std::string engine)
+  : _mpi_comm(comm), _filename(filename), _engine_type(engine),
+    _rewrite_mesh(engine.compare(0, 2, "BP") != 0), _step_open(false),
+    _time(0.0), _num_steps(0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+ADIOS2File::~ADIOS2File()
+{
+  close();
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::set_engine_parameter(std::string key, std::string value)
+{
+  if (_engine)
+  {
+    dolfin_error("ADIOS2File.cpp",
+                 "set ADIOS2 engine parameter",
+                 "Engine parameters must be set before the first call to write()");
+  }
+  _engine_parameters[key] = value;
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::flush()
+{
+  if (_step_open)
+  {
+    dolfin_assert(_engine);
+    _engine->EndStep();
+    _step_open = false;
+    ++_num_steps;
+  }
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::close()
+{
+  flush();
+  if (_engine)
+  {
+    _engine->Close();
+    _engine.reset();
+  }
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::write(const Mesh& mesh, double t)
+{
+  begin_step(t);
+  write_mesh(mesh);
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::write(const Function& u, double t)
+{
+  dolfin_assert(u.function_space()->mesh());
+  const Mesh& mesh = *u.function_space()->mesh();
+
+  begin_step(t);
+  write_mesh(mesh);
+
+  // Compute vertex values (component-major) and interleave them
+  std::vector<double> vertex_values;
+  u.compute_vertex_values(vertex_values, mesh);
+  const std::size_t num_vertices = mesh.num_vertices();
+  const std::size_t value_size = u.value_size();
+  std::vector<double> values(num_vertices*value_size);
+  for (std::size_t i = 0; i < num_vertices; ++i)
+    for (std::size_t j = 0; j < value_size; ++j)
+      values[i*value_size + j] = vertex_values[j*num_vertices + i];
+
+  put_local_array(*_io, *_engine, u.name(), values, value_size);
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::write(const MeshFunction<int>& mf, double t)
+{
+  write_mesh_function<int, int>(mf, t);
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::write(const MeshFunction<std::size_t>& mf, double t)
+{
+  write_mesh_function<std::size_t, std::size_t>(mf, t);
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::write(const MeshFunction<double>& mf, double t)
+{
+  write_mesh_function<double, double>(mf, t);
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::write(const MeshFunction<bool>& mf, double t)
+{
+  write_mesh_function<bool, std::int32_t>(mf, t);
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::begin_step(double t)
+{
+  // Open engine (collective) at first write
+  if (!_engine)
+  {
+    if (!_adios)
+      _adios.reset(new adios2::ADIOS(_mpi_comm.comm()));
+    _io.reset(new adios2::IO(_adios->DeclareIO(_filename)));
+    _io->SetEngine(_engine_type);
+    _io->SetParameters(_engine_parameters);
+    _engine.reset(new adios2::Engine(_io->Open(_filename,
+                                               adios2::Mode::Write)));
+  }
+
+  // Complete current step if time differs
+  if (_step_open and t != _time)
+    flush();
+
+  if (!_step_open)
+  {
+    _engine->BeginStep();
+    _step_open = true;
+    _time = t;
+
+    // Write time (single value, from process 0)
+    adios2::Variable<double> time = _io->InquireVariable<double>("time");
+    if (!time)
+      time = _io->DefineVariable<double>("time");
+    if (_mpi_comm.rank() == 0)
+      _engine->Put(time, _time, adios2::Mode::Sync);
+  }
+}
+//-----------------------------------------------------------------------------
+void ADIOS2File::write_mesh(const Mesh& mesh)
+{
+  dolfin_assert(_step_open);
+
+  // Skip mesh if written in its current state (and in this step if
+  // the mesh is rewritten with every step)
+  const std::string name = mesh.name();
+  std::vector<std::size_t> state = {mesh.id(), mesh.geometry().state(),
+                                    mesh.topology().state()};
+  if (_rewrite_mesh)
+    state.push_back(_num_steps);
+  auto it = _mesh_states.find(name);
+  if (it != _mesh_states.end() and it->second == state)
+    return;
+  _mesh_states[name] = state;
+
+  if (mesh.geometry().degree() != 1)
+  {
+    dolfin_error("ADIOS2File.cpp",
+                 "write mesh to ADIOS2 file",
+                 "Only affine meshes are supported");
+  }
+
+  // Define cell type attribute once
+  if (!_io->InquireAttribute<std::string>(name + "/cell_type"))
+  {
+    _io->DefineAttribute<std::string>(name + "/cell_type",
+      CellType::type2string(mesh.type().cell_type()));
+  }
+
+  const MeshTopology& topology = mesh.topology();
+  const std::size_t tdim = topology.dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_vertices = mesh.num_vertices();
+  const std::size_t num_cells = topology.ghost_offset(tdim);
+  const std::size_t num_vertices_per_cell = mesh.type().num_vertices(tdim);
+
+  // Vertex coordinates and global indices
+  put_local_array(*_io, *_engine, name + "/geometry", mesh.geometry().x(),
+                  gdim);
+  std::vector<std::int64_t> vertex_indices(num_vertices);
+  for (std::size_t i = 0; i < num_vertices; ++i)
+  {
+    vertex_indices[i] = topology.have_global_indices(0)
+      ? topology.global_indices(0)[i] : i;
+  }
+  put_local_array(*_io, *_engine, name + "/vertex_indices", vertex_indices, 1);
+
+  // Vertices (VTK ordering) and global indices of owned cells
+  std::vector<std::int64_t> cell_vertices;
+  cell_vertices.reserve(num_cells*num_vertices_per_cell);
+  std::vector<std::int64_t> cell_indices(num_cells);
+  const std::vector<std::int8_t> perm = mesh.type().vtk_mapping();
+  for (CellIterator c(mesh); !c.end(); ++c)
+  {
+    const unsigned int* vertices = c->entities(0);
+    for (std::size_t i = 0; i < num_vertices_per_cell; ++i)
+      cell_vertices.push_back(vertices[perm[i]]);
+    cell_indices[c->index()] = topology.have_global_indices(tdim)
+      ? c->global_index() : c->index();
+  }
+  put_local_array(*_io, *_engine, name + "/topology", cell_vertices,
+                  num_vertices_per_cell);
+  put_local_array(*_io, *_engine, name + "/cell_indices", cell_indices, 1);
+}
+//-----------------------------------------------------------------------------
+template<typename T, typename S>
+void ADIOS2File::write_mesh_function(const MeshFunction<T>& mf, double t)
+{
+  dolfin_assert(mf.mesh());
+  const Mesh& mesh = *mf.mesh();
+  const std::size_t dim = mf.dim();
+  const std::size_t tdim = mesh.topology().dim();
+
+  begin_step(t);
+  write_mesh(mesh);
+
+  // Values of owned cells, or of all local entities of lower
+  // dimension
+  const std::size_t num_entities = (dim == tdim)
+    ? mesh.topology().ghost_offset(tdim) : mesh.num_entities(dim);
+  std::vector<S> values(num_entities);
+  for (std::size_t i = 0; i < num_entities; ++i)
+    values[i] = static_cast<S>(mf[i]);
+  put_local_array(*_io, *_engine, mf.name(), values, 1);
+
+  // Vertices of entities which are neither vertices nor cells
+  if (dim > 0 and dim < tdim)
+  {
+    mesh.init(dim, 0);
+    const std::size_t num_entity_vertices = mesh.type().num_vertices(dim);
+    std::vector<std::int64_t> entity_vertices;
+    entity_vertices.reserve(num_entities*num_entity_vertices);
+    for (MeshEntityIterator e(mesh, dim, "all"); !e.end(); ++e)
+    {
+      const unsigned int* vertices = e->entities(0);
+      for (std::size_t i = 0; i < num_entity_vertices; ++i)
+        entity_vertices.push_back(vertices[i]);
+    }
+    put_local_array(*_io, *_engine, mf.name() + "/topology", entity_vertices,
+                    num_entity_vertices);
+  }
+}
+//-----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,215 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __DOLFIN_ADIOS2FILE_H
+#define __DOLFIN_ADIOS2FILE_H
+
+#ifdef HAS_ADIOS2
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Variable.h>
+
+namespace adios2
+{
+  class ADIOS;
+  class Engine;
+  class IO;
+}
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Function;
+  class Mesh;
+  template<typename T> class MeshFunction;
+
+  /// Write time series of Meshes, Functions and MeshFunctions with
+  /// ADIOS2 (https://github.com/ornladios/ADIOS2)
+
+  /// This class writes the data of each time step as an ADIOS2 step
+  /// with the given engine, e.g. "BP4" or "BP5" for files, or "SST"
+  /// for memory-to-memory staging to a concurrently running reader.
+  /// Each process writes its part of the data as a block of local
+  /// arrays, so no data is redistributed between processes, and the
+  /// engine performs the aggregation (e.g. asynchronously with the
+  /// BP5 engine parameter "AsyncWrite").
+  ///
+  /// Functions and MeshFunctions written with the same time are
+  /// written to the same step. A step is completed when data for a
+  /// new time is written, or by flush() and close(). With file
+  /// engines ("BP4", "BP5"), the mesh is written with the first step
+  /// and again only when it has changed; with staging engines, where
+  /// a reader only sees the current step, it is written with every
+  /// step. The variables of a step are
+  ///
+  ///     time                     Time of the step (single value)
+  ///     <mesh>/geometry          Vertex coordinates (num_vertices x gdim)
+  ///     <mesh>/topology          Vertices of owned cells, in VTK
+  ///                              ordering (num_cells x num_cell_vertices)
+  ///     <mesh>/vertex_indices    Global indices of vertices
+  ///     <mesh>/cell_indices      Global indices of owned cells
+  ///     <u>                      Values of Function u at vertices
+  ///                              (num_vertices x value_size)
+  ///     <f>                      Values of MeshFunction f on its
+  ///                              entities (owned cells for cell
+  ///                              functions, all local vertices for
+  ///                              vertex functions)
+  ///     <f>/topology             Vertices of the entities of f, for
+  ///                              entities of dimension 0 < d < tdim
+  ///
+  /// where <mesh>, <u> and <f> are the names of the objects, and the
+  /// attribute <mesh>/cell_type holds the cell type of <mesh>.
+
+  class ADIOS2File : public Variable
+  {
+  public:
+
+    /// Create file or stream
+    ///
+    /// @param    comm (MPI_Comm)
+    ///         The MPI communicator.
+    /// @param    filename (std::string)
+    ///         Name of file (or stream for staging engines).
+    /// @param    engine (std::string)
+    ///         ADIOS2 engine type, e.g. "BP4", "BP5" or "SST".
+    ADIOS2File(MPI_Comm comm, const std::string filename,
+               const std::string engine="BP4");
+
+    /// Destructor
+    ~ADIOS2File();
+
+    /// Set parameter of the ADIOS2 engine, e.g. ("NumAggregators",
+    /// "4") or ("AsyncWrite", "true") for the BP5 engine. Engine
+    /// parameters must be set before the first call to write().
+    void set_engine_parameter(std::string key, std::string value);
+
+    /// Complete current step
+    void flush();
+
+    /// Complete current step and close the file or stream
+    void close();
+
+    /// Write mesh
+    ///
+    /// @param    mesh (_Mesh_)
+    ///         The mesh.
+    /// @param    t (double)
+    ///         The time.
+    void write(const Mesh& mesh, double t=0.0);
+
+    /// Write values of function at vertices (and its mesh if it has
+    /// not been written or has changed)
+    ///
+    /// @param    u (_Function_)
+    ///         The function.
+    /// @param    t (double)
+    ///         The time.
+    void write(const Function& u, double t);
+
+    /// Write mesh function (and its mesh if it has not been written
+    /// or has changed)
+    ///
+    /// @param    mf (_MeshFunction<int>_)
+    ///         The mesh function.
+    /// @param    t (double)
+    ///         The time.
+    void write(const MeshFunction<int>& mf, double t);
+
+    /// Write mesh function (and its mesh if it has not been written
+    /// or has changed)
+    ///
+    /// @param    mf (_MeshFunction<std::size_t>_)
+    ///         The mesh function.
+    /// @param    t (double)
+    ///         The time.
+    void write(const MeshFunction<std::size_t>& mf, double t);
+
+    /// Write mesh function (and its mesh if it has not been written
+    /// or has changed)
+    ///
+    /// @param    mf (_MeshFunction<double>_)
+    ///         The mesh function.
+    /// @param    t (double)
+    ///         The time.
+    void write(const MeshFunction<double>& mf, double t);
+
+    /// Write mesh function (and its mesh if it has not been written
+    /// or has changed). The values are written as 32-bit integers.
+    ///
+    /// @param    mf (_MeshFunction<bool>_)
+    ///         The mesh function.
+    /// @param    t (double)
+    ///         The time.
+    void write(const MeshFunction<bool>& mf, double t);
+
+    /// Return number of completed steps
+    std::size_t num_steps() const
+    { return _num_steps; }
+
+  private:
+
+    // Open engine if needed and begin a step for time t, completing
+    // the current step if it has a different time
+    void begin_step(double t);
+
+    // Write mesh if it has not been written in its current state
+    void write_mesh(const Mesh& mesh);
+
+    // Write mesh function, with values converted to type S
+    template<typename T, typename S>
+      void write_mesh_function(const MeshFunction<T>& mf, double t);
+
+    // MPI communicator
+    dolfin::MPI::Comm _mpi_comm;
+
+    // Filename and engine type
+    const std::string _filename;
+    const std::string _engine_type;
+
+    // Engine parameters
+    std::map<std::string, std::string> _engine_parameters;
+
+    // ADIOS2 objects
+    std::unique_ptr<adios2::ADIOS> _adios;
+    std::unique_ptr<adios2::IO> _io;
+    std::unique_ptr<adios2::Engine> _engine;
+
+    // True if the mesh is written with every step
+    bool _rewrite_mesh;
+
+    // True if a step is open, and its time
+    bool _step_open;
+    double _time;
+
+    // Number of completed steps
+    std::size_t _num_steps;
+
+    // State (id, geometry and topology state) of written meshes
+    std::map<std::string, std::vector<std::size_t>> _mesh_states;
+
+  };
+
+}
+
+#endif
+#endif
@@ -0,0 +1,274 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifdef HAS_ASCENT
+
+#include <ascent.hpp>
+#include <conduit.hpp>
+#include <dolfin/common/Timer.h>
+#include <dolfin/fem/GenericDofMap.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include "AscentAdaptor.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Blueprint element shape of cell type
+  std::string blueprint_shape(CellType::Type cell_type)
+  {
+    switch (cell_type)
+    {
+    case CellType::point:
+      return "point";
+    case CellType::interval:
+      return "line";
+    case CellType::triangle:
+      return "tri";
+    case CellType::quadrilateral:
+      return "quad";
+    case CellType::tetrahedron:
+      return "tet";
+    case CellType::hexahedron:
+      return "hex";
+    default:
+      dolfin_error("AscentAdaptor.cpp",
+                   "publish mesh to Ascent",
+                   "Unknown cell type (%d)", cell_type);
+    }
+    return "";
+  }
+}
+
+//-----------------------------------------------------------------------------
+AscentAdaptor::AscentAdaptor(MPI_Comm comm, const std::string actions_file)
+  : _mpi_comm(comm), _actions_file(actions_file)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+AscentAdaptor::~AscentAdaptor()
+{
+  close();
+}
+//-----------------------------------------------------------------------------
+void AscentAdaptor::set_mesh(std::shared_ptr<const Mesh> mesh)
+{
+  dolfin_assert(mesh);
+  for (std::size_t i = 0; i < _functions.size(); ++i)
+  {
+    if (_functions[i]->function_space()->mesh()->id() != mesh->id())
+    {
+      dolfin_error("AscentAdaptor.cpp",
+                   "set mesh of Ascent adaptor",
+                   "Function \"%s\" is defined on a different mesh",
+                   _functions[i]->name().c_str());
+    }
+  }
+  _mesh = mesh;
+}
+//-----------------------------------------------------------------------------
+void AscentAdaptor::add(std::shared_ptr<const Function> u)
+{
+  dolfin_assert(u);
+  dolfin_assert(u->function_space()->mesh());
+  if (!_mesh)
+    _mesh = u->function_space()->mesh();
+  else if (u->function_space()->mesh()->id() != _mesh->id())
+  {
+    dolfin_error("AscentAdaptor.cpp",
+                 "add function to Ascent adaptor",
+                 "Function \"%s\" is defined on a different mesh",
+                 u->name().c_str());
+  }
+  _functions.push_back(u);
+}
+//-----------------------------------------------------------------------------
+void AscentAdaptor::execute(double t, std::size_t cycle)
+{
+  publish(t, cycle);
+
+  // Empty actions, Ascent reads the actions file
+  Timer timer("Ascent execute");
+  conduit::Node actions;
+  _ascent->execute(actions);
+}
+//-----------------------------------------------------------------------------
+void AscentAdaptor::execute(double t, std::size_t cycle,
+                            const std::string actions)
+{
+  publish(t, cycle);
+
+  Timer timer("Ascent execute");
+  conduit::Node actions_node;
+  actions_node.parse(actions, "yaml");
+  _ascent->execute(actions_node);
+}
+//-----------------------------------------------------------------------------
+void AscentAdaptor::close()
+{
+  if (_ascent)
+  {
+    _ascent->close();
+    _ascent.reset();
+  }
+  _data.reset();
+}
+//-----------------------------------------------------------------------------
+void AscentAdaptor::publish(double t, std::size_t cycle)
+{
+  if (!_mesh)
+  {
+    dolfin_error("AscentAdaptor.cpp",
+                 "publish data to Ascent",
+                 "No mesh has been set");
+  }
+  const Mesh& mesh = *_mesh;
+  if (mesh.geometry().degree() != 1)
+  {
+    dolfin_error("AscentAdaptor.cpp",
+                 "publish data to Ascent",
+                 "Only affine meshes are supported");
+  }
+
+  Timer timer("Ascent publish");
+
+  // Open Ascent (collective) at first call
+  if (!_ascent)
+  {
+    conduit::Node options;
+    options["mpi_comm"] = (conduit::int32) MPI_Comm_c2f(_mpi_comm.comm());
+    options["actions_file"] = _actions_file;
+    _ascent.reset(new ascent::Ascent);
+    _ascent->open(options);
+    _data.reset(new conduit::Node);
+  }
+
+  conduit::Node& data = *_data;
+  data.reset();
+  data["state/time"] = t;
+  data["state/cycle"] = (conduit::uint64) cycle;
+  data["state/domain_id"] = (conduit::uint64) _mpi_comm.rank();
+
+  // Vertex coordinates (interleaved, referenced with stride). Conduit
+  // does not modify external data.
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_vertices = mesh.num_vertices();
+  double* x = const_cast<double*>(mesh.geometry().x().data());
+  const char* axes[3] = {"x", "y", "z"};
+  data["coordsets/coords/type"] = "explicit";
+  for (std::size_t i = 0; i < gdim; ++i)
+  {
+    data["coordsets/coords/values/" + std::string(axes[i])]
+      .set_external(x, num_vertices, i*sizeof(double), gdim*sizeof(double));
+  }
+
+  // Vertices of owned cells (ghost cells are numbered last), which
+  // are referenced directly if the DOLFIN ordering is the VTK
+  // ordering used by Blueprint
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_cells = mesh.topology().ghost_offset(tdim);
+  const std::size_t num_cell_vertices = mesh.type().num_vertices(tdim);
+  const std::vector<unsigned int>& cell_vertices
+    = mesh.topology()(tdim, 0)();
+  const std::vector<std::int8_t> perm = mesh.type().vtk_mapping();
+  bool vtk_ordering = true;
+  for (std::size_t i = 0; i < perm.size(); ++i)
+    vtk_ordering = vtk_ordering and perm[i] == (std::int8_t) i;
+
+  unsigned int* connectivity
+    = const_cast<unsigned int*>(cell_vertices.data());
+  if (!vtk_ordering)
+  {
+    _cell_vertices.resize(num_cells*num_cell_vertices);
+    for (std::size_t c = 0; c < num_cells; ++c)
+    {
+      for (std::size_t i = 0; i < num_cell_vertices; ++i)
+      {
+        _cell_vertices[c*num_cell_vertices + i]
+          = cell_vertices[c*num_cell_vertices + perm[i]];
+      }
+    }
+    connectivity = _cell_vertices.data();
+  }
+
+  data["topologies/mesh/type"] = "unstructured";
+  data["topologies/mesh/coordset"] = "coords";
+  data["topologies/mesh/elements/shape"]
+    = blueprint_shape(mesh.type().cell_type());
+  data["topologies/mesh/elements/connectivity"]
+    .set_external(connectivity, num_cells*num_cell_vertices);
+
+  // Function values, component by component
+  for (std::size_t k = 0; k < _functions.size(); ++k)
+  {
+    const Function& u = *_functions[k];
+    const std::size_t value_size = u.value_size();
+    std::vector<double>& values = _values[u.name()];
+
+    std::size_t num_values = 0;
+    conduit::Node& field = data["fields/" + u.name()];
+    field["topology"] = "mesh";
+    dolfin_assert(u.function_space()->dofmap());
+    const GenericDofMap& dofmap = *u.function_space()->dofmap();
+    if (dofmap.max_element_dofs() == value_size)
+    {
+      // Values on owned cells
+      num_values = num_cells;
+      std::vector<dolfin::la_index> dofs(value_size*num_cells);
+      for (CellIterator cell(mesh); !cell.end(); ++cell)
+      {
+        auto cell_dofs = dofmap.cell_dofs(cell->index());
+        for (std::size_t j = 0; j < value_size; ++j)
+          dofs[j*num_cells + cell->index()] = cell_dofs[j];
+      }
+      values.resize(dofs.size());
+      u.vector()->get_local(values.data(), dofs.size(), dofs.data());
+      field["association"] = "element";
+    }
+    else
+    {
+      num_values = num_vertices;
+      u.compute_vertex_values(values, mesh);
+      field["association"] = "vertex";
+    }
+
+    if (value_size == 1)
+      field["values"].set_external(values.data(), num_values);
+    else
+    {
+      for (std::size_t j = 0; j < value_size; ++j)
+      {
+        const std::string component = value_size <= 3
+          ? std::string(axes[j]) : std::to_string(j);
+        field["values/" + component].set_external(values.data()
+                                                  + j*num_values,
+                                                  num_values);
+      }
+    }
+  }
+
+  _ascent->publish(data);
+}
+//-----------------------------------------------------------------------------
+
+#endif
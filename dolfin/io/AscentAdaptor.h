@@ -0,0 +1,162 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __DOLFIN_ASCENT_ADAPTOR_H
+#define __DOLFIN_ASCENT_ADAPTOR_H
+
+#ifdef HAS_ASCENT
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Variable.h>
+
+namespace ascent
+{
+  class Ascent;
+}
+
+namespace conduit
+{
+  class Node;
+}
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Function;
+  class Mesh;
+
+  /// In situ visualisation of a Mesh and Functions with Ascent
+  /// (https://github.com/Alpine-DAV/ascent)
+
+  /// This class describes the local part of a mesh and the values
+  /// of functions on it as a Conduit Blueprint mesh, publishes it to
+  /// Ascent and executes the Ascent actions (renders, pipelines,
+  /// extracts), typically once every few steps of a time loop. No
+  /// data is written to file unless the actions do so.
+  ///
+  /// The vertex coordinates and, for simplex meshes, the cell
+  /// vertices of the owned cells are passed to Ascent without
+  /// copying. Functions are published by their values at vertices
+  /// (component by component), or, if they have one dof per value
+  /// component per cell (e.g. DG0), by their values on the owned
+  /// cells. Each process publishes one Blueprint domain, and the mesh
+  /// and functions must not change during execute().
+  ///
+  /// The actions are read by Ascent from the actions file (default
+  /// "ascent_actions.yaml") at each call to execute(), or may be
+  /// given as a YAML string.
+  ///
+  /// @code{.cpp}
+  ///         AscentAdaptor adaptor(mesh->mpi_comm());
+  ///         adaptor.set_mesh(mesh);
+  ///         adaptor.add(u);
+  ///         for (std::size_t step = 0; step < num_steps; ++step)
+  ///         {
+  ///           ...
+  ///           if (step % 10 == 0)
+  ///             adaptor.execute(t, step);
+  ///         }
+  /// @endcode
+
+  class AscentAdaptor : public Variable
+  {
+  public:
+
+    /// Create adaptor
+    ///
+    /// @param    comm (MPI_Comm)
+    ///         The MPI communicator.
+    /// @param    actions_file (std::string)
+    ///         Name of Ascent actions file (YAML or JSON).
+    AscentAdaptor(MPI_Comm comm,
+                  const std::string actions_file="ascent_actions.yaml");
+
+    /// Destructor
+    ~AscentAdaptor();
+
+    /// Set the mesh to publish
+    ///
+    /// @param    mesh (_Mesh_)
+    ///         The mesh (Blueprint topology "mesh").
+    void set_mesh(std::shared_ptr<const Mesh> mesh);
+
+    /// Add function to publish as a field with the name of the
+    /// function. The mesh is set to the mesh of the function if it
+    /// has not been set.
+    ///
+    /// @param    u (_Function_)
+    ///         The function (on the mesh of the adaptor).
+    void add(std::shared_ptr<const Function> u);
+
+    /// Publish the mesh and the current values of the functions, and
+    /// execute the actions of the actions file
+    ///
+    /// @param    t (double)
+    ///         The time.
+    /// @param    cycle (std::size_t)
+    ///         The step number.
+    void execute(double t, std::size_t cycle);
+
+    /// Publish the mesh and the current values of the functions, and
+    /// execute the given actions
+    ///
+    /// @param    t (double)
+    ///         The time.
+    /// @param    cycle (std::size_t)
+    ///         The step number.
+    /// @param    actions (std::string)
+    ///         The Ascent actions (YAML).
+    void execute(double t, std::size_t cycle, const std::string actions);
+
+    /// Close Ascent
+    void close();
+
+  private:
+
+    // Open Ascent if needed and publish mesh and function values
+    void publish(double t, std::size_t cycle);
+
+    // MPI communicator
+    dolfin::MPI::Comm _mpi_comm;
+
+    // Actions file
+    const std::string _actions_file;
+
+    // Mesh and functions to publish
+    std::shared_ptr<const Mesh> _mesh;
+    std::vector<std::shared_ptr<const Function>> _functions;
+
+    // Ascent instance and published Blueprint data
+    std::unique_ptr<ascent::Ascent> _ascent;
+    std::unique_ptr<conduit::Node> _data;
+
+    // Cell vertices in VTK ordering (for non-simplex cells) and
+    // values of the functions, referenced by the published data
+    std::vector<unsigned int> _cell_vertices;
+    std::map<std::string, std::vector<double>> _values;
+
+  };
+
+}
+
+#endif
+#endif
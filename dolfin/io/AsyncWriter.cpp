@@ -0,0 +1,141 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <exception>
+#include <dolfin/log/log.h>
+#include "AsyncWriter.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+void AsyncWriter::TaskList::add(std::unique_ptr<Task> task)
+{
+  _tasks.push_back(std::move(task));
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::TaskList::run()
+{
+  for (auto task = _tasks.begin(); task != _tasks.end(); ++task)
+    (*task)->run();
+}
+//-----------------------------------------------------------------------------
+AsyncWriter::AsyncWriter(std::size_t max_tasks)
+  : _max_tasks(std::max(max_tasks, (std::size_t) 1)), _busy(false),
+    _stop(false)
+{
+  _thread = std::thread(&AsyncWriter::run, this);
+}
+//-----------------------------------------------------------------------------
+AsyncWriter::~AsyncWriter()
+{
+  // Let background thread complete queued tasks and stop
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _task_queued.notify_all();
+  _thread.join();
+
+  if (!_error.empty())
+    warning("Asynchronous output failed: %s", _error.c_str());
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::push(std::unique_ptr<Task> task)
+{
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    check_error();
+
+    // Wait for space in queue
+    while (_tasks.size() >= _max_tasks && _error.empty())
+      _task_done.wait(lock);
+    check_error();
+
+    _tasks.push_back(std::move(task));
+  }
+  _task_queued.notify_one();
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::flush()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  while ((!_tasks.empty() || _busy) && _error.empty())
+    _task_done.wait(lock);
+  check_error();
+}
+//-----------------------------------------------------------------------------
+std::size_t AsyncWriter::num_pending() const
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _tasks.size() + (_busy ? 1 : 0);
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::run()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true)
+  {
+    // Wait for task
+    while (_tasks.empty() && !_stop)
+      _task_queued.wait(lock);
+    if (_tasks.empty())
+      break;
+
+    // Take task from queue and execute without holding the lock
+    std::unique_ptr<Task> task = std::move(_tasks.front());
+    _tasks.pop_front();
+    _busy = true;
+    lock.unlock();
+
+    std::string error;
+    try
+    {
+      task->run();
+    }
+    catch (std::exception& e)
+    {
+      error = e.what();
+    }
+    task.reset();
+
+    lock.lock();
+    _busy = false;
+
+    // Discard remaining tasks after an error (they may depend on
+    // the failed task)
+    if (!error.empty())
+    {
+      _error = error;
+      _tasks.clear();
+    }
+    _task_done.notify_all();
+  }
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::check_error()
+{
+  if (!_error.empty())
+  {
+    const std::string error = _error;
+    _error.clear();
+    dolfin_error("AsyncWriter.cpp",
+                 "execute asynchronous output task",
+                 "%s", error.c_str());
+  }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __DOLFIN_ASYNC_WRITER_H
+#define __DOLFIN_ASYNC_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dolfin
+{
+
+  /// This class executes output tasks in order on a dedicated
+  /// background thread. Tasks are queued by push(), which blocks
+  /// while the queue is full, and flush() waits until all queued
+  /// tasks have been executed.
+  ///
+  /// Tasks that call MPI must be queued in the same order on all
+  /// processes and must only use communicators that are not used
+  /// concurrently by other threads. Since other threads keep making
+  /// MPI calls, such tasks require MPI to be initialised with
+  /// MPI_THREAD_MULTIPLE, and tasks calling HDF5 require a
+  /// thread-safe HDF5 library; callers must check this (see
+  /// SubSystemsManager::mpi_thread_level()) and write synchronously
+  /// otherwise. Errors raised by a task are reported by the next
+  /// call to push() or flush().
+
+  class AsyncWriter
+  {
+  public:
+
+    /// Output task
+    class Task
+    {
+    public:
+
+      /// Destructor
+      virtual ~Task() {}
+
+      /// Execute task
+      virtual void run() = 0;
+
+    };
+
+    /// List of tasks executed in order as a single task
+    class TaskList : public Task
+    {
+    public:
+
+      /// Add task to list
+      void add(std::unique_ptr<Task> task);
+
+      /// Execute all tasks in list
+      void run();
+
+      /// Return number of tasks in list
+      std::size_t size() const
+      { return _tasks.size(); }
+
+    private:
+
+      // Tasks
+      std::vector<std::unique_ptr<Task>> _tasks;
+
+    };
+
+    /// Create writer with queue holding at most max_tasks pending
+    /// tasks
+    explicit AsyncWriter(std::size_t max_tasks=2);
+
+    /// Destructor (waits for pending tasks to complete)
+    ~AsyncWriter();
+
+    /// Queue task for execution (blocks while the queue is full)
+    void push(std::unique_ptr<Task> task);
+
+    /// Wait until all queued tasks have been executed
+    void flush();
+
+    /// Return number of tasks that are queued or running
+    std::size_t num_pending() const;
+
+  private:
+
+    // Execute tasks until stopped (run on background thread)
+    void run();
+
+    // Raise error stored by background thread (if any). Must be
+    // called with mutex held.
+    void check_error();
+
+    // Maximum number of queued tasks
+    const std::size_t _max_tasks;
+
+    // Queued tasks
+    std::deque<std::unique_ptr<Task>> _tasks;
+
+    // True while a task is being executed
+    bool _busy;
+
+    // True when background thread should stop
+    bool _stop;
+
+    // Error message from failed task
+    std::string _error;
+
+    // Mutex protecting the queue and state
+    mutable std::mutex _mutex;
+
+    // Signalled when a task is queued or the writer is stopped
+    std::condition_variable _task_queued;
+
+    // Signalled when a task completes
+    std::condition_variable _task_done;
+
+    // Background thread
+    std::thread _thread;
+
+  };
+
+}
+
+#endif
@@ -71,6 +71,9 @@ namespace dolfin
     ///         // Using compressed binary format
     ///         File comp_file("solution.pvd", "compressed");
     ///
+    ///         // Using raw binary appended data, compressed in blocks
+    ///         File raw_file("solution.pvd", "appended_compressed");
+    ///
     File(const std::string filename, std::string encoding="ascii");
 
     /// Create a file with given name with MPI communicator
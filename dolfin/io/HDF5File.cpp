@@ -19,13 +19,17 @@
 
 #ifdef HAS_HDF5
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <set>
 #include <string>
 #include <boost/unordered_map.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/multi_array.hpp>
 
 #include <dolfin/common/constants.h>
@@ -35,7 +39,10 @@
 #include <dolfin/fem/GenericDofMap.h>
 #include <dolfin/function/Function.h>
 #include <dolfin/function/FunctionSpace.h>
+#include <dolfin/function/QuadratureData.h>
+#include <dolfin/la/EigenVector.h>
 #include <dolfin/la/GenericVector.h>
+#include <dolfin/la/PETScVector.h>
 #include <dolfin/log/log.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/LocalMeshData.h>
@@ -57,13 +64,19 @@ using namespace dolfin;
 //-----------------------------------------------------------------------------
 HDF5File::HDF5File(MPI_Comm comm, const std::string filename,
                    const std::string file_mode)
-  : _hdf5_file_id(0), _mpi_comm(comm)
+  : _hdf5_file_id(0), _mpi_comm(comm), _aggregation_comm(MPI_COMM_NULL),
+    _aggregation(0)
 {
   // See https://www.hdfgroup.org/hdf5-quest.html#gzero on zero for
   // _hdf5_file_id(0)
 
-  // HDF5 chunking
-  parameters.add("chunking", false);
+  // HDF5 chunking, compression and transfer mode
+  add_dataset_parameters(parameters);
+
+  // Gather data onto one writing process per group of N processes
+  // (N > 1), or per shared memory node (-1), before parallel output.
+  // Reduces the number of processes accessing the file.
+  parameters.add("aggregation", 0);
 
   // Create directory, if required (create on rank 0)
   if (_mpi_comm.rank() == 0)
@@ -112,6 +125,9 @@ void HDF5File::close()
   if (_hdf5_file_id > 0)
     HDF5Interface::close_file(_hdf5_file_id);
   _hdf5_file_id = 0;
+
+  free_aggregation_comm();
+  _vector_redistributions.clear();
 }
 //-----------------------------------------------------------------------------
 void HDF5File::flush()
@@ -120,6 +136,72 @@ void HDF5File::flush()
   HDF5Interface::flush_file(_hdf5_file_id);
 }
 //-----------------------------------------------------------------------------
+void HDF5File::add_dataset_parameters(Parameters& parameters)
+{
+  // Chunked dataset layout, with given number of rows per chunk (0
+  // for default)
+  parameters.add("chunking", false);
+  parameters.add("chunk_size", 0);
+
+  // Compression filters: deflate level 1-9 (0 for none), byte
+  // shuffle, SZIP and a registered filter plugin by id (-1 for none)
+  parameters.add("compression_level", 0, 0, 9);
+  parameters.add("shuffle", false);
+  parameters.add("szip", false);
+  parameters.add("filter_id", -1);
+
+  // Collective (rather than independent) MPI-IO transfers
+  parameters.add("collective_io", true);
+}
+//-----------------------------------------------------------------------------
+HDF5Interface::DatasetOptions
+HDF5File::dataset_options(const Parameters& parameters)
+{
+  HDF5Interface::DatasetOptions options;
+  options.chunking = parameters["chunking"];
+  const int chunk_size = parameters["chunk_size"];
+  options.chunk_size = chunk_size;
+  options.compression_level = parameters["compression_level"];
+  options.shuffle = parameters["shuffle"];
+  options.szip = parameters["szip"];
+  options.filter_id = parameters["filter_id"];
+  options.collective_io = parameters["collective_io"];
+  return options;
+}
+//-----------------------------------------------------------------------------
+MPI_Comm HDF5File::aggregation_comm()
+{
+  const int aggregation = parameters["aggregation"];
+  if (aggregation != _aggregation)
+  {
+    free_aggregation_comm();
+    if (aggregation < -1)
+    {
+      dolfin_error("HDF5File.cpp",
+                   "aggregate output",
+                   "Unknown aggregation %d (use N > 1 processes, or -1 for shared memory nodes)",
+                   aggregation);
+    }
+    else if (aggregation == -1)
+      _aggregation_comm = MPI::split(_mpi_comm.comm(), 0);
+    else if (aggregation > 1 and _mpi_comm.size() > 1)
+      _aggregation_comm = MPI::split(_mpi_comm.comm(), aggregation);
+    _aggregation = aggregation;
+  }
+
+  return _aggregation_comm;
+}
+//-----------------------------------------------------------------------------
+void HDF5File::free_aggregation_comm()
+{
+#ifdef HAS_MPI
+  if (_aggregation_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&_aggregation_comm);
+#endif
+  _aggregation_comm = MPI_COMM_NULL;
+  _aggregation = 0;
+}
+//-----------------------------------------------------------------------------
 void HDF5File::write(const std::vector<Point>& points,
                      const std::string dataset_name)
 {
@@ -160,17 +242,40 @@ void HDF5File::write(const GenericVector& x, const std::string dataset_name)
   dolfin_assert(x.size() > 0);
   dolfin_assert(_hdf5_file_id > 0);
 
-  // Get all local data
-  std::vector<double> local_data;
-  x.get_local(local_data);
-
-  // Write data to file
+  // Write data to file, directly from the vector storage if
+  // possible, otherwise from a copy of the local values
   std::pair<std::size_t, std::size_t> local_range = x.local_range();
-  const bool chunking = parameters["chunking"];
   const std::vector<std::int64_t> global_size(1, x.size());
   const bool mpi_io = _mpi_comm.size() > 1 ? true : false;
-  HDF5Interface::write_dataset(_hdf5_file_id, dataset_name, local_data,
-                               local_range, global_size, mpi_io, chunking);
+  HDF5Interface::DatasetOptions options = dataset_options(parameters);
+  options.aggregation_comm = aggregation_comm();
+#ifdef HAS_PETSC
+  if (has_type<const PETScVector>(x))
+  {
+    const PETScVector& _x = as_type<const PETScVector>(x);
+    const double* local_data = NULL;
+    PetscErrorCode ierr = VecGetArrayRead(_x.vec(), &local_data);
+    if (ierr != 0) _x.petsc_error(ierr, __FILE__, "VecGetArrayRead");
+    HDF5Interface::write_dataset(_hdf5_file_id, dataset_name, local_data,
+                                 local_range, global_size, mpi_io, options);
+    ierr = VecRestoreArrayRead(_x.vec(), &local_data);
+    if (ierr != 0) _x.petsc_error(ierr, __FILE__, "VecRestoreArrayRead");
+  }
+  else
+#endif
+  if (has_type<const EigenVector>(x))
+  {
+    const EigenVector& _x = as_type<const EigenVector>(x);
+    HDF5Interface::write_dataset(_hdf5_file_id, dataset_name, _x.data(),
+                                 local_range, global_size, mpi_io, options);
+  }
+  else
+  {
+    std::vector<double> local_data;
+    x.get_local(local_data);
+    HDF5Interface::write_dataset(_hdf5_file_id, dataset_name, local_data,
+                                 local_range, global_size, mpi_io, options);
+  }
 
   // Add partitioning attribute to dataset
   std::vector<std::size_t> partitions;
@@ -252,12 +357,35 @@ void HDF5File::read(GenericVector& x, const std::string dataset_name,
   // Get local range
   const std::pair<std::size_t, std::size_t> local_range = x.local_range();
 
-  // Read data from file
-  std::vector<double> data;
-  HDF5Interface::read_dataset(_hdf5_file_id, dataset_name, local_range, data);
-
-  // Set data
-  x.set_local(data);
+  // Read data from file, directly into the vector storage if
+  // possible, otherwise through a copy of the local values
+  const std::size_t local_size = local_range.second - local_range.first;
+#ifdef HAS_PETSC
+  if (has_type<PETScVector>(x))
+  {
+    PETScVector& _x = as_type<PETScVector>(x);
+    double* data = NULL;
+    PetscErrorCode ierr = VecGetArray(_x.vec(), &data);
+    if (ierr != 0) _x.petsc_error(ierr, __FILE__, "VecGetArray");
+    HDF5Interface::read_dataset(_hdf5_file_id, dataset_name, local_range,
+                                data, local_size);
+    ierr = VecRestoreArray(_x.vec(), &data);
+    if (ierr != 0) _x.petsc_error(ierr, __FILE__, "VecRestoreArray");
+  }
+  else
+#endif
+  if (has_type<EigenVector>(x))
+  {
+    HDF5Interface::read_dataset(_hdf5_file_id, dataset_name, local_range,
+                                as_type<EigenVector>(x).data(), local_size);
+  }
+  else
+  {
+    std::vector<double> data;
+    HDF5Interface::read_dataset(_hdf5_file_id, dataset_name, local_range,
+                                data);
+    x.set_local(data);
+  }
   x.apply("insert");
 }
 //-----------------------------------------------------------------------------
@@ -480,6 +608,374 @@ void HDF5File::write(const Mesh& mesh, std::size_t cell_dim,
   }
 }
 //-----------------------------------------------------------------------------
+void HDF5File::write_distributed_mesh(const Mesh& mesh, const std::string name)
+{
+  Timer t("HDF5: write distributed mesh");
+  dolfin_assert(_hdf5_file_id > 0);
+
+  if (mesh.geometry().degree() != 1)
+  {
+    dolfin_error("HDF5File.cpp",
+                 "write distributed mesh",
+                 "Only affine meshes are supported");
+  }
+
+  const MeshTopology& topology = mesh.topology();
+  const std::size_t tdim = topology.dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const bool mpi_io = _mpi_comm.size() > 1 ? true : false;
+
+  // Dimensions of the data stored for all processes: computed
+  // entities (with cell-entity connectivity), globally numbered
+  // entities and shared entities
+  std::vector<std::size_t> entity_dims, global_index_dims, shared_entity_dims;
+  for (std::size_t d = 0; d <= tdim; ++d)
+  {
+    const bool has_entities = d == 0 or d == tdim
+      or (topology.size(d) > 0 and !topology(tdim, d).empty());
+    if (MPI::min(_mpi_comm.comm(), (int) has_entities) == 0)
+      continue;
+    entity_dims.push_back(d);
+
+    if (MPI::min(_mpi_comm.comm(), (int) topology.have_global_indices(d)) == 1)
+      global_index_dims.push_back(d);
+    if (MPI::min(_mpi_comm.comm(), (int) topology.have_shared_entities(d)) == 1)
+      shared_entity_dims.push_back(d);
+  }
+
+  // Local sizes of the data of this process. For each dimension: the
+  // number of entities, the ghost offset and the size of the shared
+  // entity data, followed by the number of ghost cell owners.
+  const std::size_t num_sizes = 3*(tdim + 1) + 1;
+  std::vector<std::int64_t> sizes(num_sizes, 0);
+  std::vector<std::vector<std::int64_t>> shared_data(tdim + 1);
+  for (auto d : entity_dims)
+  {
+    sizes[3*d] = topology.size(d);
+    sizes[3*d + 1] = topology.ghost_offset(d);
+  }
+  for (auto d : shared_entity_dims)
+  {
+    for (auto& shared : topology.shared_entities(d))
+    {
+      shared_data[d].push_back(shared.first);
+      shared_data[d].push_back(shared.second.size());
+      shared_data[d].insert(shared_data[d].end(), shared.second.begin(),
+                            shared.second.end());
+    }
+    sizes[3*d + 2] = shared_data[d].size();
+  }
+  sizes[num_sizes - 1] = topology.cell_owner().size();
+
+  const std::string sizes_dataset = name + "/sizes";
+  write_data(sizes_dataset, sizes,
+             {(std::int64_t) _mpi_comm.size(), (std::int64_t) num_sizes},
+             mpi_io);
+
+  // Write vertex coordinates
+  const std::vector<double>& x = mesh.geometry().x();
+  write_data(name + "/coordinates", x,
+             {(std::int64_t) MPI::sum(_mpi_comm.comm(), x.size()/gdim),
+              (std::int64_t) gdim}, mpi_io);
+
+  // Global number of rows of the entity data
+  std::vector<std::int64_t> num_rows(tdim + 1, 0);
+  for (auto d : entity_dims)
+    num_rows[d] = MPI::sum(_mpi_comm.comm(), sizes[3*d]);
+
+  for (auto d : entity_dims)
+  {
+    const std::string dim_str = std::to_string(d);
+
+    // Write entity vertices and cell entities (local indices)
+    if (d > 0)
+    {
+      const std::vector<std::int64_t>
+        entity_vertices(topology(d, 0)().begin(), topology(d, 0)().end());
+      write_data(name + "/entity_vertices_" + dim_str, entity_vertices,
+                 {num_rows[d], (std::int64_t) mesh.type().num_vertices(d)},
+                 mpi_io);
+    }
+    if (d > 0 and d < tdim)
+    {
+      const std::vector<std::int64_t>
+        cell_entities(topology(tdim, d)().begin(), topology(tdim, d)().end());
+      write_data(name + "/cell_entities_" + dim_str, cell_entities,
+                 {num_rows[tdim], (std::int64_t) mesh.type().num_entities(d)},
+                 mpi_io);
+    }
+
+    // Write global entity indices
+    if (std::find(global_index_dims.begin(), global_index_dims.end(), d)
+        != global_index_dims.end())
+    {
+      write_data(name + "/global_indices_" + dim_str,
+                 topology.global_indices(d), {num_rows[d]}, mpi_io);
+    }
+
+    // Write shared entities
+    if (std::find(shared_entity_dims.begin(), shared_entity_dims.end(), d)
+        != shared_entity_dims.end())
+    {
+      const std::int64_t num_shared
+        = MPI::sum(_mpi_comm.comm(), shared_data[d].size());
+      if (num_shared > 0)
+      {
+        write_data(name + "/shared_entities_" + dim_str, shared_data[d],
+                   {num_shared}, mpi_io);
+      }
+    }
+  }
+
+  // Write owners of ghost cells
+  const std::int64_t num_ghost_cells
+    = MPI::sum(_mpi_comm.comm(), topology.cell_owner().size());
+  if (num_ghost_cells > 0)
+  {
+    const std::vector<std::int64_t> cell_owner(topology.cell_owner().begin(),
+                                               topology.cell_owner().end());
+    write_data(name + "/cell_owner", cell_owner, {num_ghost_cells}, mpi_io);
+  }
+
+  // Add mesh description attributes
+  HDF5Interface::add_attribute(_hdf5_file_id, sizes_dataset, "celltype",
+                               CellType::type2string(mesh.type().cell_type()));
+  HDF5Interface::add_attribute(_hdf5_file_id, sizes_dataset, "gdim", gdim);
+  HDF5Interface::add_attribute(_hdf5_file_id, sizes_dataset, "ghost_mode",
+                               mesh.ghost_mode());
+  HDF5Interface::add_attribute(_hdf5_file_id, sizes_dataset, "num_processes",
+                               (std::size_t) _mpi_comm.size());
+  std::vector<std::size_t> global_size;
+  for (std::size_t d = 0; d <= tdim; ++d)
+    global_size.push_back(topology.size_global(d));
+  HDF5Interface::add_attribute(_hdf5_file_id, sizes_dataset, "global_size",
+                               global_size);
+  HDF5Interface::add_attribute(_hdf5_file_id, sizes_dataset, "entity_dims",
+                               entity_dims);
+  HDF5Interface::add_attribute(_hdf5_file_id, sizes_dataset,
+                               "global_index_dims", global_index_dims);
+  HDF5Interface::add_attribute(_hdf5_file_id, sizes_dataset,
+                               "shared_entity_dims", shared_entity_dims);
+}
+//-----------------------------------------------------------------------------
+void HDF5File::read_distributed_mesh(Mesh& mesh, const std::string name) const
+{
+  Timer t("HDF5: read distributed mesh");
+  dolfin_assert(_hdf5_file_id > 0);
+
+  const std::string sizes_dataset = name + "/sizes";
+  if (!HDF5Interface::has_dataset(_hdf5_file_id, sizes_dataset))
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read distributed mesh",
+                 "Dataset \"%s\" not found", sizes_dataset.c_str());
+  }
+
+  // Check that the mesh was written with the same number of processes
+  std::size_t num_processes = 0;
+  HDF5Interface::get_attribute(_hdf5_file_id, sizes_dataset, "num_processes",
+                               num_processes);
+  if (num_processes != _mpi_comm.size())
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read distributed mesh",
+                 "Mesh was written with %d processes, but read with %d. Use HDF5File::read to repartition the mesh",
+                 num_processes, _mpi_comm.size());
+  }
+
+  // Read mesh description
+  std::string cell_type_str, ghost_mode;
+  std::size_t gdim = 0;
+  std::vector<std::size_t> global_size, entity_dims, global_index_dims,
+    shared_entity_dims;
+  HDF5Interface::get_attribute(_hdf5_file_id, sizes_dataset, "celltype",
+                               cell_type_str);
+  HDF5Interface::get_attribute(_hdf5_file_id, sizes_dataset, "gdim", gdim);
+  HDF5Interface::get_attribute(_hdf5_file_id, sizes_dataset, "ghost_mode",
+                               ghost_mode);
+  HDF5Interface::get_attribute(_hdf5_file_id, sizes_dataset, "global_size",
+                               global_size);
+  HDF5Interface::get_attribute(_hdf5_file_id, sizes_dataset, "entity_dims",
+                               entity_dims);
+  HDF5Interface::get_attribute(_hdf5_file_id, sizes_dataset,
+                               "global_index_dims", global_index_dims);
+  HDF5Interface::get_attribute(_hdf5_file_id, sizes_dataset,
+                               "shared_entity_dims", shared_entity_dims);
+
+  std::unique_ptr<CellType> cell_type(CellType::create(cell_type_str));
+  dolfin_assert(cell_type);
+  const std::size_t tdim = cell_type->dim();
+  dolfin_assert(global_size.size() == tdim + 1);
+
+  // Read local sizes of all processes, and compute the offsets of the
+  // data of this process
+  const std::size_t num_sizes = 3*(tdim + 1) + 1;
+  std::vector<std::int64_t> all_sizes;
+  HDF5Interface::read_dataset(_hdf5_file_id, sizes_dataset,
+                              {0, (std::int64_t) num_processes}, all_sizes);
+  dolfin_assert(all_sizes.size() == num_processes*num_sizes);
+  const std::size_t rank = _mpi_comm.rank();
+  std::vector<std::int64_t> sizes(all_sizes.begin() + rank*num_sizes,
+                                  all_sizes.begin() + (rank + 1)*num_sizes);
+  std::vector<std::int64_t> offsets(num_sizes, 0);
+  for (std::size_t p = 0; p < rank; ++p)
+    for (std::size_t i = 0; i < num_sizes; ++i)
+      offsets[i] += all_sizes[p*num_sizes + i];
+
+  // Row range of this process for data of entity dimension d, shared
+  // entities of dimension d, and ghost cell owners
+  const std::int64_t num_vertices = sizes[0];
+  const std::int64_t num_cells = sizes[3*tdim];
+  const std::pair<std::int64_t, std::int64_t> vertex_range
+    = {offsets[0], offsets[0] + num_vertices};
+  const std::pair<std::int64_t, std::int64_t> cell_range
+    = {offsets[3*tdim], offsets[3*tdim] + num_cells};
+
+  // Read vertex coordinates and global indices, and cells
+  std::vector<double> x;
+  std::vector<std::int64_t> vertex_indices, cell_indices, cell_vertices;
+  HDF5Interface::read_dataset(_hdf5_file_id, name + "/coordinates",
+                              vertex_range, x);
+  HDF5Interface::read_dataset(_hdf5_file_id, name + "/global_indices_0",
+                              vertex_range, vertex_indices);
+  HDF5Interface::read_dataset(_hdf5_file_id,
+                              name + "/global_indices_" + std::to_string(tdim),
+                              cell_range, cell_indices);
+  HDF5Interface::read_dataset(_hdf5_file_id,
+                              name + "/entity_vertices_" + std::to_string(tdim),
+                              cell_range, cell_vertices);
+
+  // Build local mesh (including ghosts) with the stored numbering
+  MeshEditor editor;
+  editor.open(mesh, cell_type->cell_type(), tdim, gdim);
+
+  editor.init_vertices_global(num_vertices, global_size[0]);
+  Point point(gdim);
+  for (std::int64_t i = 0; i < num_vertices; ++i)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+      point[j] = x[i*gdim + j];
+    editor.add_vertex_global(i, vertex_indices[i], point);
+  }
+
+  editor.init_cells_global(num_cells, global_size[tdim]);
+  const std::size_t num_cell_vertices = cell_type->num_vertices();
+  std::vector<std::size_t> cell(num_cell_vertices);
+  for (std::int64_t i = 0; i < num_cells; ++i)
+  {
+    std::copy(cell_vertices.begin() + i*num_cell_vertices,
+              cell_vertices.begin() + (i + 1)*num_cell_vertices,
+              cell.begin());
+    editor.add_cell(i, cell_indices[i], cell);
+  }
+
+  // Cells are stored ordered, so no reordering takes place here
+  editor.close();
+
+  MeshTopology& topology = mesh.topology();
+  mesh._ghost_mode = ghost_mode;
+
+  // Restore computed entities and their connectivity
+  for (auto d : entity_dims)
+  {
+    const std::string dim_str = std::to_string(d);
+    const std::int64_t num_entities = sizes[3*d];
+    const std::pair<std::int64_t, std::int64_t> range
+      = {offsets[3*d], offsets[3*d] + num_entities};
+
+    if (d > 0 and d < tdim)
+    {
+      topology.init(d, num_entities, global_size[d]);
+
+      std::vector<std::int64_t> entity_vertices, cell_entities;
+      HDF5Interface::read_dataset(_hdf5_file_id,
+                                  name + "/entity_vertices_" + dim_str,
+                                  range, entity_vertices);
+      HDF5Interface::read_dataset(_hdf5_file_id,
+                                  name + "/cell_entities_" + dim_str,
+                                  cell_range, cell_entities);
+
+      const std::size_t num_entity_vertices = cell_type->num_vertices(d);
+      MeshConnectivity& entity_connectivity = topology(d, 0);
+      entity_connectivity.init(num_entities, num_entity_vertices);
+      for (std::int64_t e = 0; e < num_entities; ++e)
+      {
+        const std::vector<std::size_t>
+          v(entity_vertices.begin() + e*num_entity_vertices,
+            entity_vertices.begin() + (e + 1)*num_entity_vertices);
+        entity_connectivity.set(e, v);
+      }
+
+      const std::size_t num_cell_entities = cell_type->num_entities(d);
+      MeshConnectivity& cell_connectivity = topology(tdim, d);
+      cell_connectivity.init(num_cells, num_cell_entities);
+      for (std::int64_t c = 0; c < num_cells; ++c)
+      {
+        const std::vector<std::size_t>
+          e(cell_entities.begin() + c*num_cell_entities,
+            cell_entities.begin() + (c + 1)*num_cell_entities);
+        cell_connectivity.set(c, e);
+      }
+
+      if (std::find(global_index_dims.begin(), global_index_dims.end(), d)
+          != global_index_dims.end())
+      {
+        std::vector<std::int64_t> global_indices;
+        HDF5Interface::read_dataset(_hdf5_file_id,
+                                    name + "/global_indices_" + dim_str,
+                                    range, global_indices);
+        topology.init_global_indices(d, num_entities);
+        for (std::int64_t e = 0; e < num_entities; ++e)
+          topology.set_global_index(d, e, global_indices[e]);
+      }
+    }
+
+    // Set ghost offset
+    topology.init_ghost(d, sizes[3*d + 1]);
+
+    // Restore shared entities
+    if (std::find(shared_entity_dims.begin(), shared_entity_dims.end(), d)
+        != shared_entity_dims.end())
+    {
+      std::map<std::int32_t, std::set<unsigned int>>& shared_entities
+        = topology.shared_entities(d);
+      shared_entities.clear();
+
+      const std::string shared_dataset = name + "/shared_entities_" + dim_str;
+      if (HDF5Interface::has_dataset(_hdf5_file_id, shared_dataset))
+      {
+        std::vector<std::int64_t> shared_data;
+        HDF5Interface::read_dataset(_hdf5_file_id, shared_dataset,
+                                    {offsets[3*d + 2],
+                                     offsets[3*d + 2] + sizes[3*d + 2]},
+                                    shared_data);
+        for (std::size_t i = 0; i < shared_data.size();
+             i += shared_data[i + 1] + 2)
+        {
+          std::set<unsigned int>& sharing_processes
+            = shared_entities[shared_data[i]];
+          sharing_processes.insert(shared_data.begin() + i + 2,
+                                   shared_data.begin() + i + 2
+                                   + shared_data[i + 1]);
+        }
+      }
+    }
+  }
+
+  // Restore owners of ghost cells
+  std::vector<unsigned int>& cell_owner = topology.cell_owner();
+  cell_owner.clear();
+  if (HDF5Interface::has_dataset(_hdf5_file_id, name + "/cell_owner"))
+  {
+    std::vector<std::int64_t> owners;
+    HDF5Interface::read_dataset(_hdf5_file_id, name + "/cell_owner",
+                                {offsets[num_sizes - 1],
+                                 offsets[num_sizes - 1] + sizes[num_sizes - 1]},
+                                owners);
+    cell_owner.assign(owners.begin(), owners.end());
+  }
+}
+//-----------------------------------------------------------------------------
 void HDF5File::write(const MeshFunction<std::size_t>& meshfunction,
                      const std::string name)
 {
@@ -942,6 +1438,159 @@ void HDF5File::write(const Function& u, const std::string name)
   write(*u.vector(), name + "/vector_0");
 }
 //-----------------------------------------------------------------------------
+void HDF5File::write(const QuadratureData& data, const std::string name)
+{
+  dolfin_assert(_hdf5_file_id > 0);
+  const Mesh& mesh = *data.mesh();
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_owned_cells = mesh.topology().ghost_offset(tdim);
+  const std::size_t block_size = data.block_size();
+
+  // Values and global indices of owned cells
+  const std::vector<double> values(data.values().begin(),
+                                   data.values().begin()
+                                   + num_owned_cells*block_size);
+  const std::vector<std::int64_t>& global_indices
+    = mesh.topology().global_indices(tdim);
+  const std::vector<std::int64_t>
+    cell_indices(global_indices.begin(),
+                 global_indices.begin() + num_owned_cells);
+
+  const std::int64_t num_global_cells
+    = MPI::sum(_mpi_comm.comm(), num_owned_cells);
+  const bool mpi_io = _mpi_comm.size() > 1 ? true : false;
+  std::vector<std::int64_t> global_size = {num_global_cells,
+                                           (std::int64_t) block_size};
+  write_data(name + "/values", values, global_size, mpi_io);
+  global_size.resize(1);
+  write_data(name + "/cell_indices", cell_indices, global_size, mpi_io);
+
+  HDF5Interface::add_attribute(_hdf5_file_id, name + "/values", "num_points",
+                               data.num_points());
+}
+//-----------------------------------------------------------------------------
+void HDF5File::read(QuadratureData& data, const std::string name) const
+{
+  dolfin_assert(_hdf5_file_id > 0);
+  const std::string values_name = name + "/values";
+  const std::string indices_name = name + "/cell_indices";
+  if (!HDF5Interface::has_dataset(_hdf5_file_id, values_name)
+      || !HDF5Interface::has_dataset(_hdf5_file_id, indices_name))
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read quadrature data",
+                 "Datasets \"%s\" and \"%s\" not found",
+                 values_name.c_str(), indices_name.c_str());
+  }
+
+  // Check layout
+  const Mesh& mesh = *data.mesh();
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t block_size = data.block_size();
+  const std::vector<std::int64_t> shape
+    = HDF5Interface::get_dataset_shape(_hdf5_file_id, values_name);
+  std::size_t num_points = 0;
+  HDF5Interface::get_attribute(_hdf5_file_id, values_name, "num_points",
+                               num_points);
+  if (shape.size() != 2 || (std::size_t) shape[1] != block_size
+      || num_points != data.num_points())
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read quadrature data",
+                 "Number of points or values per cell does not match file");
+  }
+  const std::size_t num_global_cells = shape[0];
+  if (num_global_cells != mesh.size_global(tdim))
+  {
+    dolfin_error("HDF5File.cpp",
+                 "read quadrature data",
+                 "Number of cells in file (%d) does not match mesh (%d)",
+                 num_global_cells, mesh.size_global(tdim));
+  }
+
+  // Read a block of cells
+  const std::pair<std::int64_t, std::int64_t> range
+    = MPI::local_range(_mpi_comm.comm(), num_global_cells);
+  std::vector<double> file_values;
+  std::vector<std::int64_t> file_indices;
+  HDF5Interface::read_dataset(_hdf5_file_id, values_name, range, file_values);
+  HDF5Interface::read_dataset(_hdf5_file_id, indices_name, range,
+                              file_indices);
+  dolfin_assert(file_values.size() == file_indices.size()*block_size);
+
+  // Send values to the process owning the global cell index in the
+  // linear (rendezvous) distribution, and likewise the requests for
+  // the values of the local cells
+  const std::size_t num_processes = _mpi_comm.size();
+  const std::vector<std::int64_t>& global_indices
+    = mesh.topology().global_indices(tdim);
+  std::vector<std::vector<std::int64_t>> send_indices(num_processes),
+    recv_indices(num_processes);
+  std::vector<std::vector<double>> send_values(num_processes),
+    recv_values(num_processes);
+  for (std::size_t i = 0; i < file_indices.size(); ++i)
+  {
+    const unsigned int p = MPI::index_owner(_mpi_comm.comm(), file_indices[i],
+                                            num_global_cells);
+    send_indices[p].push_back(file_indices[i]);
+    send_values[p].insert(send_values[p].end(),
+                          file_values.begin() + i*block_size,
+                          file_values.begin() + (i + 1)*block_size);
+  }
+  MPI::all_to_all(_mpi_comm.comm(), send_indices, recv_indices);
+  MPI::all_to_all(_mpi_comm.comm(), send_values, recv_values);
+
+  const std::size_t offset = range.first;
+  std::vector<double> owned_values((range.second - range.first)*block_size);
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    for (std::size_t i = 0; i < recv_indices[p].size(); ++i)
+    {
+      const std::size_t pos = recv_indices[p][i] - offset;
+      std::copy(recv_values[p].begin() + i*block_size,
+                recv_values[p].begin() + (i + 1)*block_size,
+                owned_values.begin() + pos*block_size);
+    }
+  }
+
+  // Request values of local cells (including ghosts)
+  std::vector<std::vector<std::int64_t>> request(num_processes);
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    const unsigned int p = MPI::index_owner(_mpi_comm.comm(),
+                                            global_indices[c],
+                                            num_global_cells);
+    request[p].push_back(global_indices[c]);
+  }
+  MPI::all_to_all(_mpi_comm.comm(), request, recv_indices);
+
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    send_values[p].clear();
+    for (std::size_t i = 0; i < recv_indices[p].size(); ++i)
+    {
+      const std::size_t pos = recv_indices[p][i] - offset;
+      send_values[p].insert(send_values[p].end(),
+                            owned_values.begin() + pos*block_size,
+                            owned_values.begin() + (pos + 1)*block_size);
+    }
+  }
+  MPI::all_to_all(_mpi_comm.comm(), send_values, recv_values);
+
+  // Copy values in the order of the requests
+  std::vector<std::size_t> position(num_processes, 0);
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    const unsigned int p = MPI::index_owner(_mpi_comm.comm(),
+                                            global_indices[c],
+                                            num_global_cells);
+    std::copy(recv_values[p].begin() + position[p]*block_size,
+              recv_values[p].begin() + (position[p] + 1)*block_size,
+              data.cell_values(c));
+    position[p]++;
+  }
+}
+//-----------------------------------------------------------------------------
 void HDF5File::read(Function& u, const std::string name)
 {
   Timer t0("HDF5: read Function");
@@ -1073,10 +1722,36 @@ void HDF5File::read(Function& u, const std::string name)
   HDF5Interface::read_dataset(_hdf5_file_id, vector_dataset_name,
                               input_vector_range, input_values);
 
-  HDF5Utility::set_local_vector_values(_mpi_comm.comm(), x, mesh, input_cells,
-                                       input_cell_dofs, x_cell_dofs,
-                                       input_values, input_vector_range, dofmap);
-
+  // Reuse the redistribution of a previous read into the same
+  // function space if the cells and cell dofs read from file are the
+  // same on all processes
+  std::size_t data_hash = boost::hash_range(input_cells.begin(),
+                                            input_cells.end());
+  boost::hash_combine(data_hash, boost::hash_range(input_cell_dofs.begin(),
+                                                   input_cell_dofs.end()));
+  boost::hash_combine(data_hash, boost::hash_range(x_cell_dofs.begin(),
+                                                   x_cell_dofs.end()));
+  boost::hash_combine(data_hash, input_vector_range.first);
+  boost::hash_combine(data_hash, input_vector_range.second);
+  const std::tuple<std::size_t, std::size_t, std::size_t>
+    key(mesh.id(), u.function_space()->id(), data_hash);
+
+  auto it = _vector_redistributions.find(key);
+  const int found = (it != _vector_redistributions.end());
+  if (MPI::min(_mpi_comm.comm(), found) == 0)
+  {
+    Timer t1("HDF5: build Function redistribution");
+    HDF5Utility::VectorRedistribution& redistribution
+      = _vector_redistributions[key];
+    HDF5Utility::build_vector_redistribution(_mpi_comm.comm(), x, mesh,
+                                             input_cells, input_cell_dofs,
+                                             x_cell_dofs, input_vector_range,
+                                             dofmap, redistribution);
+    it = _vector_redistributions.find(key);
+  }
+
+  HDF5Utility::redistribute_vector_values(_mpi_comm.comm(), it->second,
+                                          input_values, x);
 }
 //-----------------------------------------------------------------------------
 void HDF5File::write(const MeshValueCollection<std::size_t>& mesh_values,
@@ -1109,14 +1784,12 @@ void HDF5File::write(const MeshValueCollection<bool>& mesh_values,
   // HDF5 does not implement bool, use int and copy
 
   MeshValueCollection<int> mvc_int(mesh_values.mesh(), mesh_values.dim());
-  const std::map<std::pair<std::size_t, std::size_t>, bool>& values
-    = mesh_values.values();
-  for (auto mesh_value_it = values.begin(); mesh_value_it != values.end();
-       ++mesh_value_it)
-  {
-    mvc_int.set_value(mesh_value_it->first.first, mesh_value_it->first.second,
-                      mesh_value_it->second ? 1 : 0);
-  }
+  const std::vector<std::pair<std::size_t, std::size_t>>& entities
+    = mesh_values.entities();
+  const std::vector<bool>& values = mesh_values.entity_values();
+  mvc_int.reserve(entities.size());
+  for (std::size_t i = 0; i < entities.size(); ++i)
+    mvc_int.append(entities[i].first, entities[i].second, values[i] ? 1 : 0);
 
   write_mesh_value_collection(mvc_int, name);
 }
@@ -1129,16 +1802,16 @@ void HDF5File::read(MeshValueCollection<bool>& mesh_values,
   MeshValueCollection<int> mvc_int(mesh_values.mesh(), mesh_values.dim());
   read_mesh_value_collection(mvc_int, name);
 
-  const std::map<std::pair<std::size_t, std::size_t>, int>& values
-    = mvc_int.values();
-  for (auto mesh_value_it = values.begin(); mesh_value_it != values.end();
-       ++mesh_value_it)
+  const std::vector<std::pair<std::size_t, std::size_t>>& entities
+    = mvc_int.entities();
+  const std::vector<int>& values = mvc_int.entity_values();
+  mesh_values.reserve(entities.size());
+  for (std::size_t i = 0; i < entities.size(); ++i)
   {
-    mesh_values.set_value(mesh_value_it->first.first,
-                          mesh_value_it->first.second,
-                          (mesh_value_it->second != 0));
+    mesh_values.append(entities[i].first, entities[i].second,
+                       (values[i] != 0));
   }
-
+  mesh_values.finalize();
 }
 //-----------------------------------------------------------------------------
 template <typename T>
@@ -1150,8 +1823,9 @@ void HDF5File::write_mesh_value_collection(const MeshValueCollection<T>& mesh_va
   const std::size_t dim = mesh_values.dim();
   std::shared_ptr<const Mesh> mesh = mesh_values.mesh();
 
-  const std::map<std::pair<std::size_t, std::size_t>, T>& values
-    = mesh_values.values();
+  const std::vector<std::pair<std::size_t, std::size_t>>& entities
+    = mesh_values.entities();
+  const std::vector<T>& values = mesh_values.entity_values();
 
   std::unique_ptr<CellType>
     entity_type(CellType::create(mesh->type().entity_type(dim)));
@@ -1165,17 +1839,17 @@ void HDF5File::write_mesh_value_collection(const MeshValueCollection<T>& mesh_va
 
   const std::size_t tdim = mesh->topology().dim();
   mesh->init(tdim, dim);
-  for (auto &p : values)
+  for (std::size_t i = 0; i < entities.size(); ++i)
   {
-    MeshEntity cell = Cell(*mesh, p.first.first);
+    MeshEntity cell = Cell(*mesh, entities[i].first);
     if (dim != tdim)
     {
-      const unsigned int entity_local_idx = cell.entities(dim)[p.first.second];
+      const unsigned int entity_local_idx = cell.entities(dim)[entities[i].second];
       cell = MeshEntity(*mesh, dim, entity_local_idx);
     }
     for (VertexIterator v(cell); !v.end(); ++v)
       topology.push_back(v->global_index());
-    value_data.push_back(p.second);
+    value_data.push_back(values[i]);
   }
 
   const bool mpi_io = _mpi_comm.size() > 1 ? true : false;
@@ -1199,21 +1873,23 @@ void HDF5File::write_mesh_value_collection_old(
 {
   dolfin_assert(_hdf5_file_id > 0);
 
-  const std::map<std::pair<std::size_t, std::size_t>, T>& values
-    = mesh_values.values();
+  const std::vector<std::pair<std::size_t, std::size_t>>& positions
+    = mesh_values.entities();
+  const std::vector<T>& values = mesh_values.entity_values();
 
   const Mesh& mesh = *mesh_values.mesh();
   const std::vector<std::int64_t>& global_cell_index
     = mesh.topology().global_indices(mesh.topology().dim());
 
-  std::vector<T> data_values;
+  std::vector<T> data_values(values.begin(), values.end());
   std::vector<std::size_t> entities;
   std::vector<std::size_t> cells;
-  for (auto p = values.begin(); p != values.end(); ++p)
+  entities.reserve(positions.size());
+  cells.reserve(positions.size());
+  for (std::size_t i = 0; i < positions.size(); ++i)
   {
-    cells.push_back(global_cell_index[p->first.first]);
-    entities.push_back(p->first.second);
-    data_values.push_back(p->second);
+    cells.push_back(global_cell_index[positions[i].first]);
+    entities.push_back(positions[i].second);
   }
 
   std::vector<std::int64_t> global_size(1, MPI::sum(_mpi_comm.comm(),
@@ -1424,10 +2100,12 @@ void HDF5File::read_mesh_value_collection(MeshValueCollection<T>& mesh_vc,
     dolfin_assert(recv_entities[i].size() == recv_data[i].size());
     for (std::size_t j = 0; j != recv_data[i].size(); ++j)
     {
-      mesh_vc.set_value(recv_entities[i][j], recv_data[i][j]);
+      mesh_vc.append(recv_entities[i][j], recv_data[i][j]);
     }
   }
 
+  // Sort values and remove duplicates
+  mesh_vc.finalize();
 }
 //-----------------------------------------------------------------------------
 template <typename T>
@@ -1447,6 +2125,7 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
 
   std::size_t dim = 0;
   HDF5Interface::get_attribute(_hdf5_file_id, name, "dimension", dim);
+  mesh_vc.init(mesh_vc.mesh(), dim);
 
   const std::string values_name = name + "/values";
   const std::string entities_name = name + "/entities";
@@ -1511,10 +2190,6 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
     const auto& global_cell_index =
       mesh.topology().global_indices(mesh.topology().dim());
 
-    // Reference to actual map of MeshValueCollection
-    std::map<std::pair<std::size_t, std::size_t>, T>& mvc_map
-      = mesh_vc.values();
-
     // Find cells which are on this process,
     // under the assumption that global_cell_index is ordered.
     dolfin_assert(std::is_sorted(global_cell_index.begin(),
@@ -1548,7 +2223,7 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
         // Here we do not increment j because cells_data_index is
         // ordered but not *strictly* ordered.
         std::size_t lidx = i - global_cell_index.begin();
-        mvc_map[std::make_pair(lidx, entities_data[*j])] = values_data[*j];
+        mesh_vc.append(lidx, entities_data[*j], values_data[*j]);
         ++j;
       }
     }
@@ -1598,10 +2273,6 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
     MPI::all_to_all(_mpi_comm.comm(), send_local, recv_local);
     MPI::all_to_all(_mpi_comm.comm(), send_values, recv_values);
 
-    // Reference to actual map of MeshValueCollection
-    std::map<std::pair<std::size_t, std::size_t>, T>& mvc_map
-      = mesh_vc.values();
-
     for (std::size_t i = 0; i < num_processes; ++i)
     {
       const std::vector<std::size_t>& local_index = recv_local[i];
@@ -1611,12 +2282,12 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
       dolfin_assert(local_index.size() == local_values.size());
 
       for (std::size_t j = 0; j < local_index.size(); ++j)
-      {
-        mvc_map[std::make_pair(local_index[j], local_entities[j])]
-          = local_values[j];
-      }
+        mesh_vc.append(local_index[j], local_entities[j], local_values[j]);
     }
   }
+
+  // Sort values and remove duplicates
+  mesh_vc.finalize();
 }
 //-----------------------------------------------------------------------------
 void HDF5File::read(Mesh& input_mesh, const std::string data_path,
@@ -22,7 +22,9 @@
 
 #ifdef HAS_HDF5
 
+#include <map>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -31,6 +33,7 @@
 #include <dolfin/geometry/Point.h>
 #include "HDF5Attribute.h"
 #include "HDF5Interface.h"
+#include "HDF5Utility.h"
 
 namespace dolfin
 {
@@ -43,6 +46,7 @@ namespace dolfin
   template<typename T> class MeshFunction;
   template<typename T> class MeshValueCollection;
   class HDF5Attribute;
+  class QuadratureData;
 
   class HDF5File : public Variable
   {
@@ -63,6 +67,15 @@ namespace dolfin
     /// Flush buffered I/O to disk
     void flush();
 
+    /// Add the dataset layout, compression and transfer parameters
+    /// ("chunking", "chunk_size", "compression_level", "shuffle",
+    /// "szip", "filter_id" and "collective_io") to a parameter set
+    static void add_dataset_parameters(Parameters& parameters);
+
+    /// Get the dataset options defined by the dataset parameters
+    static HDF5Interface::DatasetOptions
+    dataset_options(const Parameters& parameters);
+
     /// Write points to file
     void write(const std::vector<Point>& points, const std::string name);
 
@@ -85,6 +98,17 @@ namespace dolfin
     void write(const Mesh& mesh, const std::size_t cell_dim,
                const std::string name);
 
+    /// Write the distributed Mesh as it is stored on each process
+    /// (including ghosts, global indices, shared entities and any
+    /// computed entities), so that it can be read back on the same
+    /// number of processes with read_distributed_mesh without
+    /// repartitioning or recomputing the topology
+    void write_distributed_mesh(const Mesh& mesh, const std::string name);
+
+    /// Read a Mesh written with write_distributed_mesh. Must be
+    /// called with the same number of processes as when writing.
+    void read_distributed_mesh(Mesh& mesh, const std::string name) const;
+
     /// Write Function to file in a format suitable for re-reading
     void write(const Function& u, const std::string name);
 
@@ -98,8 +122,24 @@ namespace dolfin
     /// 'name' refers to a HDF5 dataset within a group, then it is
     /// assumed that it is a Vector, and the Function will be filled
     /// from that Vector
+    ///
+    /// The redistribution of the values (which involves several
+    /// all-to-all communications) is stored per mesh and function
+    /// space, and reused by subsequent reads of data with the same
+    /// cells and cell dofs (e.g. of Functions written from the same
+    /// function space) until the file is closed.
     void read(Function& u, const std::string name);
 
+    /// Write QuadratureData to file. The values are stored by global
+    /// cell index, so that they can be read back on a mesh with the
+    /// same global cell numbering (e.g. the mesh read from the same
+    /// file) with any number of processes.
+    void write(const QuadratureData& data, const std::string name);
+
+    /// Read QuadratureData from file. The number of points and
+    /// values per cell must match those of the file.
+    void read(QuadratureData& data, const std::string name) const;
+
     /// Read Mesh from file, using attribute data (e.g., cell type)
     /// stored in the HDF5 file. Optionally re-use any partition data
     /// in the file. This function requires all necessary data for
@@ -237,11 +277,30 @@ namespace dolfin
                       const std::vector<std::int64_t> global_size,
                       bool use_mpi_io);
 
+    // Get communicator of the processes aggregating their output on
+    // one writer (MPI_COMM_NULL if not aggregating), as set by
+    // parameters["aggregation"]
+    MPI_Comm aggregation_comm();
+
+    // Free the aggregation communicator
+    void free_aggregation_comm();
+
     // HDF5 file descriptor/handle
     hid_t _hdf5_file_id;
 
     // MPI communicator
     dolfin::MPI::Comm _mpi_comm;
+
+    // Aggregation communicator and the value of
+    // parameters["aggregation"] it was created for
+    MPI_Comm _aggregation_comm;
+    int _aggregation;
+
+    // Redistributions of Function values computed by read(Function&),
+    // by mesh id, function space id and hash of the cells and cell
+    // dofs read from file
+    std::map<std::tuple<std::size_t, std::size_t, std::size_t>,
+             HDF5Utility::VectorRedistribution> _vector_redistributions;
   };
 
   //---------------------------------------------------------------------------
@@ -268,14 +327,15 @@ namespace dolfin
                                               offset + num_local_items);
 
     // Write data to HDF5 file
-    const bool chunking = parameters["chunking"];
+    HDF5Interface::DatasetOptions options = dataset_options(parameters);
+    options.aggregation_comm = aggregation_comm();
     // Ensure dataset starts with '/'
     std::string dset_name(dataset_name);
     if (dset_name[0] != '/')
       dset_name = "/" + dataset_name;
 
     HDF5Interface::write_dataset(_hdf5_file_id, dset_name, data,
-                                 range, global_size, use_mpi_io, chunking);
+                                 range, global_size, use_mpi_io, options);
   }
   //---------------------------------------------------------------------------
 
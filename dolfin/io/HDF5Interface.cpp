@@ -20,6 +20,8 @@
 // First Added: 2012-09-21
 // Last Changed: 2013-10-24
 
+#include <map>
+#include <mutex>
 #include <boost/filesystem.hpp>
 #include <dolfin/common/MPI.h>
 #include <dolfin/log/log.h>
@@ -33,6 +35,14 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Default dataset options of open files. The mutex guards access
+  // from background output threads.
+  std::mutex dataset_options_mutex;
+  std::map<hid_t, HDF5Interface::DatasetOptions> dataset_options;
+}
+
 //-----------------------------------------------------------------------------
 hid_t HDF5Interface::open_file(MPI_Comm mpi_comm, const std::string filename,
                                const std::string mode,
@@ -101,6 +111,11 @@ hid_t HDF5Interface::open_file(MPI_Comm mpi_comm, const std::string filename,
 //-----------------------------------------------------------------------------
 void HDF5Interface::close_file(const hid_t hdf5_file_handle)
 {
+  {
+    std::lock_guard<std::mutex> lock(dataset_options_mutex);
+    dataset_options.erase(hdf5_file_handle);
+  }
+
   herr_t status = H5Fclose(hdf5_file_handle);
   dolfin_assert(status != HDF5_FAIL);
 }
@@ -111,6 +126,22 @@ void HDF5Interface::flush_file(const hid_t hdf5_file_handle)
   dolfin_assert(status != HDF5_FAIL);
 }
 //-----------------------------------------------------------------------------
+void HDF5Interface::set_dataset_options(const hid_t hdf5_file_handle,
+                                        const DatasetOptions& options)
+{
+  std::lock_guard<std::mutex> lock(dataset_options_mutex);
+  dataset_options[hdf5_file_handle] = options;
+}
+//-----------------------------------------------------------------------------
+HDF5Interface::DatasetOptions
+HDF5Interface::get_dataset_options(const hid_t hdf5_file_handle)
+{
+  std::lock_guard<std::mutex> lock(dataset_options_mutex);
+  std::map<hid_t, DatasetOptions>::const_iterator it
+    = dataset_options.find(hdf5_file_handle);
+  return it == dataset_options.end() ? DatasetOptions() : it->second;
+}
+//-----------------------------------------------------------------------------
 std::string HDF5Interface::get_filename(hid_t hdf5_file_handle)
 {
   // Get length of filename
@@ -22,6 +22,7 @@
 
 #ifdef HAS_HDF5
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -46,6 +47,46 @@ namespace dolfin
   #define HDF5_FAIL -1
   public:
 
+    /// Layout, compression and transfer options for writing datasets
+    struct DatasetOptions
+    {
+      DatasetOptions() : chunking(false), chunk_size(0),
+        compression_level(0), shuffle(false), szip(false),
+        filter_id(-1), collective_io(true),
+        aggregation_comm(MPI_COMM_NULL) {}
+
+      /// Use chunked layout (implied by any filter)
+      bool chunking;
+
+      /// Number of rows (first dimension) per chunk. If zero, half of
+      /// the rows, between 1024 and 1048576, are used
+      std::int64_t chunk_size;
+
+      /// Deflate (gzip) compression level 1-9, or 0 for none
+      int compression_level;
+
+      /// Apply the byte shuffle filter before compression
+      bool shuffle;
+
+      /// Apply SZIP compression
+      bool szip;
+
+      /// Identifier of a registered filter plugin, e.g. 32001
+      /// (Blosc) or 32013 (ZFP), or -1 for none
+      int filter_id;
+
+      /// Client data for the filter plugin
+      std::vector<unsigned int> filter_values;
+
+      /// Use collective rather than independent MPI-IO transfers
+      bool collective_io;
+
+      /// Communicator of groups of processes whose data is gathered
+      /// onto the first process of the group, which then writes it
+      /// in parallel I/O (MPI_COMM_NULL for no aggregation)
+      MPI_Comm aggregation_comm;
+    };
+
     /// Open HDF5 and return file descriptor
     static hid_t open_file(MPI_Comm mpi_comm, const std::string filename,
                            const std::string mode, const bool use_mpi_io);
@@ -59,13 +100,23 @@ namespace dolfin
 
     static std::string get_filename(hid_t hdf5_file_handle);
 
+    /// Set the default dataset options for a file, used by
+    /// write_dataset when no options are given. The options are
+    /// discarded when the file is closed.
+    static void set_dataset_options(const hid_t hdf5_file_handle,
+                                    const DatasetOptions& options);
+
+    /// Get the default dataset options for a file
+    static DatasetOptions get_dataset_options(const hid_t hdf5_file_handle);
+
     /// Write data to existing HDF file as defined by range blocks on
     /// each process
     /// data: data to be written, flattened into 1D vector
     /// range: the local range on this processor
     /// global_size: the global multidimensional shape of the array
     /// use_mpio: whether using MPI or not
-    /// use_chunking: whether using chunking or not
+    /// use_chunking: whether using chunking or not (in addition to
+    /// the default dataset options of the file)
     template <typename T>
     static void write_dataset(const hid_t file_handle,
                               const std::string dataset_path,
@@ -74,6 +125,29 @@ namespace dolfin
                               const std::vector<std::int64_t> global_size,
                               bool use_mpio, bool use_chunking);
 
+    /// Write data to existing HDF file as defined by range blocks on
+    /// each process, with the given layout, compression and transfer
+    /// options
+    template <typename T>
+    static void write_dataset(const hid_t file_handle,
+                              const std::string dataset_path,
+                              const std::vector<T>& data,
+                              const std::pair<std::int64_t, std::int64_t> range,
+                              const std::vector<std::int64_t> global_size,
+                              bool use_mpio, const DatasetOptions& options);
+
+    /// Write data to existing HDF file as defined by range blocks on
+    /// each process, directly from an array (e.g. the storage of a
+    /// linear algebra backend vector) of (range.second -
+    /// range.first)*global_size[1] values
+    template <typename T>
+    static void write_dataset(const hid_t file_handle,
+                              const std::string dataset_path,
+                              const T* data,
+                              const std::pair<std::int64_t, std::int64_t> range,
+                              const std::vector<std::int64_t> global_size,
+                              bool use_mpio, const DatasetOptions& options);
+
     /// Read data from a HDF5 dataset "dataset_path" as defined by
     /// range blocks on each process range: the local range on this
     /// processor data: a flattened 1D array of values. If range = {-1, -1},
@@ -84,6 +158,48 @@ namespace dolfin
                              const std::pair<std::int64_t, std::int64_t> range,
                              std::vector<T>& data);
 
+    /// Read data from a HDF5 dataset "dataset_path" as defined by
+    /// range blocks on each process directly into an array of given
+    /// size, which must match the number of values in the range
+    template <typename T>
+    static void read_dataset(const hid_t file_handle,
+                             const std::string dataset_path,
+                             const std::pair<std::int64_t, std::int64_t> range,
+                             T* data, std::size_t size);
+
+    /// Append a row to an extendible rank 2 dataset with rows of
+    /// length row_size, creating the dataset if it does not exist.
+    /// Each process writes the columns [range.first, range.second)
+    /// of the new row. The dataset is chunked by rows, so that single
+    /// rows are appended and read without touching the rest of the
+    /// data. Returns the index of the new row.
+    template <typename T>
+    static std::int64_t append_row(const hid_t file_handle,
+                                   const std::string dataset_path,
+                                   const T* data,
+                                   const std::pair<std::int64_t, std::int64_t> range,
+                                   std::int64_t row_size, bool use_mpi_io);
+
+    /// Write a row of an extendible rank 2 dataset (see append_row),
+    /// extending the dataset if the row does not exist yet. Existing
+    /// rows are overwritten.
+    template <typename T>
+    static void write_row(const hid_t file_handle,
+                          const std::string dataset_path,
+                          std::int64_t row, const T* data,
+                          const std::pair<std::int64_t, std::int64_t> range,
+                          std::int64_t row_size, bool use_mpi_io);
+
+    /// Read the columns [range.first, range.second) of a row of a
+    /// rank 2 dataset into an array of size range.second -
+    /// range.first
+    template <typename T>
+    static void read_row(const hid_t file_handle,
+                         const std::string dataset_path,
+                         std::int64_t row,
+                         const std::pair<std::int64_t, std::int64_t> range,
+                         T* data, bool use_mpi_io);
+
     /// Check for existence of group in HDF5 file
     static bool has_group(const hid_t hdf5_file_handle,
                           const std::string group_name);
@@ -165,6 +281,16 @@ namespace dolfin
 
   private:
 
+    // Gather the data and row ranges of a group of processes on the
+    // first process of the group, in dataset order, and merge the
+    // ranges into contiguous blocks (empty on the other processes)
+    template <typename T>
+    static void
+    aggregate_dataset(MPI_Comm comm, const std::vector<T>& data,
+                      const std::pair<std::int64_t, std::int64_t> range,
+                      std::int64_t row_size, std::vector<T>& aggregated_data,
+                      std::vector<std::pair<std::int64_t, std::int64_t>>& blocks);
+
     static herr_t attribute_iteration_function(hid_t loc_id,
                                                const char* name,
                                                const H5A_info_t* info,
@@ -236,6 +362,37 @@ namespace dolfin
                                const std::pair<std::int64_t, std::int64_t> range,
                                const std::vector<int64_t> global_size,
                                bool use_mpi_io, bool use_chunking)
+  {
+    DatasetOptions options = get_dataset_options(file_handle);
+    options.chunking = options.chunking or use_chunking;
+    write_dataset(file_handle, dataset_path, data, range, global_size,
+                  use_mpi_io, options);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  inline void
+  HDF5Interface::write_dataset(const hid_t file_handle,
+                               const std::string dataset_path,
+                               const std::vector<T>& data,
+                               const std::pair<std::int64_t, std::int64_t> range,
+                               const std::vector<int64_t> global_size,
+                               bool use_mpi_io, const DatasetOptions& options)
+  {
+    dolfin_assert(global_size.size() < 2
+                  or (std::int64_t) data.size()
+                  == (range.second - range.first)*global_size[1]);
+    write_dataset(file_handle, dataset_path, data.data(), range, global_size,
+                  use_mpi_io, options);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  inline void
+  HDF5Interface::write_dataset(const hid_t file_handle,
+                               const std::string dataset_path,
+                               const T* data,
+                               const std::pair<std::int64_t, std::int64_t> range,
+                               const std::vector<int64_t> global_size,
+                               bool use_mpi_io, const DatasetOptions& options)
   {
     // Data rank
     const std::size_t rank = global_size.size();
@@ -251,16 +408,33 @@ namespace dolfin
     // Get HDF5 data type
     const hid_t h5type = hdf5_type<T>();
 
+    // Dataset dimensions
+    const std::vector<hsize_t> dimsf(global_size.begin(), global_size.end());
+
+    // Blocks of rows to write from this process (all blocks of the
+    // aggregation group on the writing process, if aggregating)
+    std::vector<std::pair<std::int64_t, std::int64_t>> blocks(1, range);
+    std::vector<T> aggregated_data;
+    const bool aggregate = use_mpi_io
+      and options.aggregation_comm != MPI_COMM_NULL;
+    if (aggregate)
+    {
+      const std::int64_t row_size = rank > 1 ? global_size[1] : 1;
+      const std::vector<T>
+        values(data, data + (range.second - range.first)*row_size);
+      aggregate_dataset(options.aggregation_comm, values, range, row_size,
+                        aggregated_data, blocks);
+    }
+    const T* local_data = aggregate ? aggregated_data.data() : data;
+
     // Hyperslab selection parameters
     std::vector<hsize_t> count(global_size.begin(), global_size.end());
-    count[0] = range.second - range.first;
+    count[0] = 0;
+    for (auto block : blocks)
+      count[0] += block.second - block.first;
 
     // Data offsets
     std::vector<hsize_t> offset(rank, 0);
-    offset[0] = range.first;
-
-    // Dataset dimensions
-    const std::vector<hsize_t> dimsf(global_size.begin(), global_size.end());
 
     // Generic status report
     herr_t status;
@@ -269,20 +443,102 @@ namespace dolfin
     const hid_t filespace0 = H5Screate_simple(rank, dimsf.data(), NULL);
     dolfin_assert(filespace0 != HDF5_FAIL);
 
+    // Filters require chunked layout (which is not possible for empty
+    // datasets)
+    const bool use_filters = options.compression_level > 0
+      or options.shuffle or options.szip or options.filter_id >= 0;
+    const bool use_chunking = (options.chunking or use_filters)
+      and dimsf[0] > 0;
+
+    if (use_chunking and use_filters and use_mpi_io)
+    {
+     #if H5_VERSION_GE(1, 10, 2)
+      if (!options.collective_io)
+      {
+        dolfin_error("HDF5Interface.h",
+                     "write dataset to HDF5 file",
+                     "Parallel compression requires collective I/O");
+      }
+     #else
+      dolfin_error("HDF5Interface.h",
+                   "write dataset to HDF5 file",
+                   "Parallel compression requires HDF5 1.10.2 or later");
+     #endif
+    }
+
     // Set chunking parameters
     hid_t chunking_properties;
     if (use_chunking)
     {
-      // Set chunk size and limit to 1kB min/1MB max
-      hsize_t chunk_size = dimsf[0]/2;
-      if (chunk_size > 1048576)
-        chunk_size = 1048576;
-      if (chunk_size < 1024)
-        chunk_size = 1024;
-
-      hsize_t chunk_dims[2] = {chunk_size, dimsf[1]};
+      // Set chunk size, by default limited to 1024 min/1048576 max
+      // rows, and not larger than the dataset
+      hsize_t chunk_size = options.chunk_size;
+      if (chunk_size == 0)
+      {
+        chunk_size = dimsf[0]/2;
+        if (chunk_size > 1048576)
+          chunk_size = 1048576;
+        if (chunk_size < 1024)
+          chunk_size = 1024;
+      }
+      if (chunk_size > dimsf[0])
+        chunk_size = dimsf[0];
+
+      hsize_t chunk_dims[2] = {chunk_size, rank > 1 ? dimsf[1] : 1};
       chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
-      H5Pset_chunk(chunking_properties, rank, chunk_dims);
+      dolfin_assert(chunking_properties != HDF5_FAIL);
+      status = H5Pset_chunk(chunking_properties, rank, chunk_dims);
+      dolfin_assert(status != HDF5_FAIL);
+
+      // Add filters, in the order they are applied
+      if (options.shuffle)
+      {
+        status = H5Pset_shuffle(chunking_properties);
+        dolfin_assert(status != HDF5_FAIL);
+      }
+
+      if (options.compression_level > 0)
+      {
+        if (!H5Zfilter_avail(H5Z_FILTER_DEFLATE))
+        {
+          dolfin_error("HDF5Interface.h",
+                       "write dataset to HDF5 file",
+                       "HDF5 library does not support deflate compression");
+        }
+        status = H5Pset_deflate(chunking_properties,
+                                options.compression_level);
+        dolfin_assert(status != HDF5_FAIL);
+      }
+
+      if (options.szip)
+      {
+        if (!H5Zfilter_avail(H5Z_FILTER_SZIP))
+        {
+          dolfin_error("HDF5Interface.h",
+                       "write dataset to HDF5 file",
+                       "HDF5 library does not support SZIP compression");
+        }
+        status = H5Pset_szip(chunking_properties, H5_SZIP_NN_OPTION_MASK,
+                             16);
+        dolfin_assert(status != HDF5_FAIL);
+      }
+
+      if (options.filter_id >= 0)
+      {
+        const H5Z_filter_t filter_id = options.filter_id;
+        if (!H5Zfilter_avail(filter_id))
+        {
+          dolfin_error("HDF5Interface.h",
+                       "write dataset to HDF5 file",
+                       "HDF5 filter %d is not available (check HDF5_PLUGIN_PATH)",
+                       options.filter_id);
+        }
+        status = H5Pset_filter(chunking_properties, filter_id,
+                               H5Z_FLAG_MANDATORY,
+                               options.filter_values.size(),
+                               options.filter_values.data());
+        dolfin_assert(status != HDF5_FAIL);
+      }
     }
     else
       chunking_properties = H5P_DEFAULT;
@@ -305,18 +561,34 @@ namespace dolfin
     const hid_t memspace = H5Screate_simple(rank, count.data(), NULL);
     dolfin_assert(memspace != HDF5_FAIL);
 
-    // Create a file dataspace within the global space - a hyperslab
+    // Create a file dataspace within the global space - a union of
+    // hyperslabs, one for each block
     const hid_t filespace1 = H5Dget_space(dset_id);
-    status = H5Sselect_hyperslab(filespace1, H5S_SELECT_SET, offset.data(),
-                                 NULL, count.data(), NULL);
-    dolfin_assert(status != HDF5_FAIL);
+    if (blocks.empty())
+    {
+      status = H5Sselect_none(filespace1);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+      std::vector<hsize_t> block_count(count);
+      offset[0] = blocks[i].first;
+      block_count[0] = blocks[i].second - blocks[i].first;
+      status = H5Sselect_hyperslab(filespace1,
+                                   i == 0 ? H5S_SELECT_SET : H5S_SELECT_OR,
+                                   offset.data(), NULL, block_count.data(),
+                                   NULL);
+      dolfin_assert(status != HDF5_FAIL);
+    }
 
     // Set parallel access
     const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
     if (use_mpi_io)
     {
      #ifdef H5_HAVE_PARALLEL
-      status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+      status = H5Pset_dxpl_mpio(plist_id, options.collective_io
+                                ? H5FD_MPIO_COLLECTIVE
+                                : H5FD_MPIO_INDEPENDENT);
       dolfin_assert(status != HDF5_FAIL);
      #else
       dolfin_error("HDF5Interface.h",
@@ -327,7 +599,7 @@ namespace dolfin
 
     // Write local dataset into selected hyperslab
     status = H5Dwrite(dset_id, h5type, memspace, filespace1, plist_id,
-                      data.data());
+                      local_data);
     dolfin_assert(status != HDF5_FAIL);
 
     if (use_chunking)
@@ -356,10 +628,84 @@ namespace dolfin
   //---------------------------------------------------------------------------
   template <typename T>
   inline void
+  HDF5Interface::aggregate_dataset(MPI_Comm comm, const std::vector<T>& data,
+                                   const std::pair<std::int64_t, std::int64_t> range,
+                                   std::int64_t row_size,
+                                   std::vector<T>& aggregated_data,
+                                   std::vector<std::pair<std::int64_t, std::int64_t>>& blocks)
+  {
+    // Gather row ranges and data of the group
+    const std::vector<std::int64_t> local_range = {range.first, range.second};
+    std::vector<std::int64_t> ranges;
+    std::vector<T> group_data;
+    MPI::gather(comm, local_range, ranges);
+    MPI::gather(comm, data, group_data);
+
+    aggregated_data.clear();
+    blocks.clear();
+    if (MPI::rank(comm) != 0)
+      return;
+
+    // Offsets of the data of each process in the gathered data
+    const std::size_t num_processes = ranges.size()/2;
+    std::vector<std::size_t> data_offsets(num_processes + 1, 0);
+    for (std::size_t i = 0; i < num_processes; ++i)
+    {
+      data_offsets[i + 1] = data_offsets[i]
+        + (ranges[2*i + 1] - ranges[2*i])*row_size;
+    }
+    dolfin_assert(data_offsets.back() == group_data.size());
+
+    // Order processes by position in the dataset
+    std::vector<std::pair<std::int64_t, std::size_t>> order(num_processes);
+    for (std::size_t i = 0; i < num_processes; ++i)
+      order[i] = std::make_pair(ranges[2*i], i);
+    std::sort(order.begin(), order.end());
+
+    // Copy data in dataset order, merging adjacent row ranges
+    aggregated_data.reserve(group_data.size());
+    for (auto p : order)
+    {
+      const std::size_t i = p.second;
+      if (ranges[2*i] == ranges[2*i + 1])
+        continue;
+
+      aggregated_data.insert(aggregated_data.end(),
+                             group_data.begin() + data_offsets[i],
+                             group_data.begin() + data_offsets[i + 1]);
+      if (!blocks.empty() and blocks.back().second == ranges[2*i])
+        blocks.back().second = ranges[2*i + 1];
+      else
+        blocks.push_back(std::make_pair(ranges[2*i], ranges[2*i + 1]));
+    }
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  inline void
   HDF5Interface::read_dataset(const hid_t file_handle,
                               const std::string dataset_path,
                               const std::pair<std::int64_t, std::int64_t> range,
                               std::vector<T>& data)
+  {
+    // Resize local data to read into
+    std::vector<std::int64_t> shape = get_dataset_shape(file_handle,
+                                                        dataset_path);
+    if (!shape.empty() and range.first != -1 and range.second != -1)
+      shape[0] = range.second - range.first;
+    std::size_t data_size = 1;
+    for (std::size_t i = 0; i < shape.size(); ++i)
+      data_size *= shape[i];
+    data.resize(data_size);
+
+    read_dataset(file_handle, dataset_path, range, data.data(), data_size);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  inline void
+  HDF5Interface::read_dataset(const hid_t file_handle,
+                              const std::string dataset_path,
+                              const std::pair<std::int64_t, std::int64_t> range,
+                              T* data, std::size_t size)
   {
     // Open the dataset
     const hid_t dset_id = H5Dopen2(file_handle, dataset_path.c_str(),
@@ -406,16 +752,22 @@ namespace dolfin
     const hid_t memspace = H5Screate_simple(rank, count.data(), NULL);
     dolfin_assert (memspace != HDF5_FAIL);
 
-    // Resize local data to read into
+    // Check size of local data to read into
     std::size_t data_size = 1;
     for (std::size_t i = 0; i < count.size(); ++i)
       data_size *= count[i];
-    data.resize(data_size);
+    if (data_size != size)
+    {
+      dolfin_error("HDF5Interface.h",
+                   "read dataset from HDF5 file",
+                   "Size mismatch between dataset range (%d) and array (%d)",
+                   data_size, size);
+    }
 
     // Read data on each process
     const hid_t h5type = hdf5_type<T>();
     status = H5Dread(dset_id, h5type, memspace, dataspace, H5P_DEFAULT,
-                     data.data());
+                     data);
     dolfin_assert(status != HDF5_FAIL);
 
     // Close dataspace
@@ -432,6 +784,198 @@ namespace dolfin
   }
   //---------------------------------------------------------------------------
   template <typename T>
+  inline std::int64_t
+  HDF5Interface::append_row(const hid_t file_handle,
+                            const std::string dataset_path,
+                            const T* data,
+                            const std::pair<std::int64_t, std::int64_t> range,
+                            std::int64_t row_size, bool use_mpi_io)
+  {
+    const std::int64_t row = has_dataset(file_handle, dataset_path)
+      ? get_dataset_shape(file_handle, dataset_path)[0] : 0;
+    write_row(file_handle, dataset_path, row, data, range, row_size,
+              use_mpi_io);
+    return row;
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  inline void
+  HDF5Interface::write_row(const hid_t file_handle,
+                           const std::string dataset_path,
+                           std::int64_t row, const T* data,
+                           const std::pair<std::int64_t, std::int64_t> range,
+                           std::int64_t row_size, bool use_mpi_io)
+  {
+    herr_t status;
+    const hid_t h5type = hdf5_type<T>();
+
+    // Open dataset, or create an empty extendible dataset
+    hid_t dset_id;
+    if (has_dataset(file_handle, dataset_path))
+    {
+      dset_id = H5Dopen2(file_handle, dataset_path.c_str(), H5P_DEFAULT);
+      dolfin_assert(dset_id != HDF5_FAIL);
+    }
+    else
+    {
+      // Check that group exists and recursively create if required
+      const std::string group_name(dataset_path, 0, dataset_path.rfind('/'));
+      add_group(file_handle, group_name);
+
+      const hsize_t dims[2] = {0, (hsize_t) row_size};
+      const hsize_t max_dims[2] = {H5S_UNLIMITED, (hsize_t) row_size};
+      const hid_t filespace = H5Screate_simple(2, dims, max_dims);
+      dolfin_assert(filespace != HDF5_FAIL);
+
+      // One row per chunk, limited to 1048576 values
+      const std::int64_t chunk_size
+        = std::max<std::int64_t>(1, std::min<std::int64_t>(row_size, 1048576));
+      const hsize_t chunk_dims[2] = {1, (hsize_t) chunk_size};
+      const hid_t chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
+      dolfin_assert(chunking_properties != HDF5_FAIL);
+      status = H5Pset_chunk(chunking_properties, 2, chunk_dims);
+      dolfin_assert(status != HDF5_FAIL);
+
+      dset_id = H5Dcreate2(file_handle, dataset_path.c_str(), h5type,
+                           filespace, H5P_DEFAULT, chunking_properties,
+                           H5P_DEFAULT);
+      dolfin_assert(dset_id != HDF5_FAIL);
+
+      status = H5Pclose(chunking_properties);
+      dolfin_assert(status != HDF5_FAIL);
+      status = H5Sclose(filespace);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+
+    // Get current shape and check row size
+    hid_t filespace = H5Dget_space(dset_id);
+    dolfin_assert(filespace != HDF5_FAIL);
+    dolfin_assert(H5Sget_simple_extent_ndims(filespace) == 2);
+    hsize_t dims[2];
+    H5Sget_simple_extent_dims(filespace, dims, NULL);
+    status = H5Sclose(filespace);
+    dolfin_assert(status != HDF5_FAIL);
+    if ((std::int64_t) dims[1] != row_size)
+    {
+      dolfin_error("HDF5Interface.h",
+                   "append row to HDF5 dataset",
+                   "Row size mismatch (%ld and %ld) in dataset \"%s\"",
+                   (long) dims[1], (long) row_size, dataset_path.c_str());
+    }
+
+    // Extend dataset to include row (collective)
+    if ((std::int64_t) dims[0] <= row)
+    {
+      dims[0] = row + 1;
+      status = H5Dset_extent(dset_id, dims);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+
+    // Select local part of new row
+    filespace = H5Dget_space(dset_id);
+    dolfin_assert(filespace != HDF5_FAIL);
+    const hsize_t offset[2] = {(hsize_t) row, (hsize_t) range.first};
+    const hsize_t count[2] = {1, (hsize_t) (range.second - range.first)};
+    if (count[1] == 0)
+      status = H5Sselect_none(filespace);
+    else
+    {
+      status = H5Sselect_hyperslab(filespace, H5S_SELECT_SET, offset, NULL,
+                                   count, NULL);
+    }
+    dolfin_assert(status != HDF5_FAIL);
+    const hid_t memspace = H5Screate_simple(2, count, NULL);
+    dolfin_assert(memspace != HDF5_FAIL);
+
+    // Set parallel access
+    const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+    if (use_mpi_io)
+    {
+     #ifdef H5_HAVE_PARALLEL
+      status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+      dolfin_assert(status != HDF5_FAIL);
+     #else
+      dolfin_error("HDF5Interface.h",
+                   "use MPI",
+                   "HDF5 library has not been configured with MPI");
+     #endif
+    }
+
+    // Write local part of row
+    status = H5Dwrite(dset_id, h5type, memspace, filespace, plist_id, data);
+    dolfin_assert(status != HDF5_FAIL);
+
+    status = H5Pclose(plist_id);
+    dolfin_assert(status != HDF5_FAIL);
+    status = H5Sclose(memspace);
+    dolfin_assert(status != HDF5_FAIL);
+    status = H5Sclose(filespace);
+    dolfin_assert(status != HDF5_FAIL);
+    status = H5Dclose(dset_id);
+    dolfin_assert(status != HDF5_FAIL);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  inline void
+  HDF5Interface::read_row(const hid_t file_handle,
+                          const std::string dataset_path,
+                          std::int64_t row,
+                          const std::pair<std::int64_t, std::int64_t> range,
+                          T* data, bool use_mpi_io)
+  {
+    herr_t status;
+
+    const hid_t dset_id = H5Dopen2(file_handle, dataset_path.c_str(),
+                                   H5P_DEFAULT);
+    dolfin_assert(dset_id != HDF5_FAIL);
+
+    // Select local part of row
+    const hid_t filespace = H5Dget_space(dset_id);
+    dolfin_assert(filespace != HDF5_FAIL);
+    dolfin_assert(H5Sget_simple_extent_ndims(filespace) == 2);
+    const hsize_t offset[2] = {(hsize_t) row, (hsize_t) range.first};
+    const hsize_t count[2] = {1, (hsize_t) (range.second - range.first)};
+    if (count[1] == 0)
+      status = H5Sselect_none(filespace);
+    else
+    {
+      status = H5Sselect_hyperslab(filespace, H5S_SELECT_SET, offset, NULL,
+                                   count, NULL);
+    }
+    dolfin_assert(status != HDF5_FAIL);
+    const hid_t memspace = H5Screate_simple(2, count, NULL);
+    dolfin_assert(memspace != HDF5_FAIL);
+
+    // Set parallel access
+    const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+    if (use_mpi_io)
+    {
+     #ifdef H5_HAVE_PARALLEL
+      status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+      dolfin_assert(status != HDF5_FAIL);
+     #else
+      dolfin_error("HDF5Interface.h",
+                   "use MPI",
+                   "HDF5 library has not been configured with MPI");
+     #endif
+    }
+
+    // Read local part of row
+    const hid_t h5type = hdf5_type<T>();
+    status = H5Dread(dset_id, h5type, memspace, filespace, plist_id, data);
+    dolfin_assert(status != HDF5_FAIL);
+
+    status = H5Pclose(plist_id);
+    dolfin_assert(status != HDF5_FAIL);
+    status = H5Sclose(memspace);
+    dolfin_assert(status != HDF5_FAIL);
+    status = H5Sclose(filespace);
+    dolfin_assert(status != HDF5_FAIL);
+    status = H5Dclose(dset_id);
+    dolfin_assert(status != HDF5_FAIL);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
   inline void HDF5Interface::get_attribute(hid_t hdf5_file_handle,
                                            const std::string dataset_path,
                                            const std::string attribute_name,
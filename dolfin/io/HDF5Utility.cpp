@@ -349,7 +349,24 @@ void HDF5Utility::set_local_vector_values(
   const std::pair<dolfin::la_index, dolfin::la_index> input_vector_range,
   const GenericDofMap& dofmap)
 {
-
+  VectorRedistribution redistribution;
+  build_vector_redistribution(mpi_comm, x, mesh, cells, cell_dofs,
+                              x_cell_dofs, input_vector_range, dofmap,
+                              redistribution);
+  redistribute_vector_values(mpi_comm, redistribution, vector, x);
+}
+//-----------------------------------------------------------------------------
+void HDF5Utility::build_vector_redistribution(
+  const MPI_Comm mpi_comm,
+  const GenericVector& x,
+  const Mesh& mesh,
+  const std::vector<size_t>& cells,
+  const std::vector<dolfin::la_index>& cell_dofs,
+  const std::vector<std::size_t>& x_cell_dofs,
+  const std::pair<dolfin::la_index, dolfin::la_index> input_vector_range,
+  const GenericDofMap& dofmap,
+  VectorRedistribution& redistribution)
+{
   // Calculate one (global cell, local_dof_index) to associate with
   // each item in the vector on this process
   std::vector<std::size_t> global_cells;
@@ -379,10 +396,13 @@ void HDF5Utility::set_local_vector_values(
   const std::pair<dolfin::la_index, dolfin::la_index>
       vector_range = x.local_range();
 
-  std::vector<std::vector<double>> receive_values(num_processes);
+  // Send global dof of each value to the owner of the dof, and keep
+  // the position of the value in the input block
+  std::vector<std::vector<std::size_t>>& send_positions
+    = redistribution.send_positions;
+  send_positions.assign(num_processes, std::vector<std::size_t>());
   std::vector<std::vector<dolfin::la_index>> receive_indices(num_processes);
   {
-    std::vector<std::vector<double>> send_values(num_processes);
     std::vector<std::vector<dolfin::la_index>> send_indices(num_processes);
     const std::size_t
         n_vector_vals = input_vector_range.second - input_vector_range.first;
@@ -398,27 +418,67 @@ void HDF5Utility::set_local_vector_values(
           = std::upper_bound(all_vec_range.begin(), all_vec_range.end(),
                              global_dof[i]) - all_vec_range.begin();
       dolfin_assert(dest < num_processes);
-      dolfin_assert(i < vector.size());
       send_indices[dest].push_back(global_dof[i]);
-      send_values[dest].push_back(vector[i]);
+      send_positions[dest].push_back(i);
     }
 
-    MPI::all_to_all(mpi_comm, send_values, receive_values);
     MPI::all_to_all(mpi_comm, send_indices, receive_indices);
   }
 
-  std::vector<double> vector_values(vector_range.second - vector_range.first);
+  // Local positions of the received values
+  std::vector<std::vector<std::size_t>>& receive_positions
+    = redistribution.receive_positions;
+  receive_positions.assign(num_processes, std::vector<std::size_t>());
   for (std::size_t i = 0; i != num_processes; ++i)
   {
-    const std::vector<double> &rval = receive_values[i];
-    const std::vector<dolfin::la_index> &rindex = receive_indices[i];
-    dolfin_assert(rval.size() == rindex.size());
-    for (std::size_t j = 0; j != rindex.size(); ++j) {
+    const std::vector<dolfin::la_index>& rindex = receive_indices[i];
+    receive_positions[i].resize(rindex.size());
+    for (std::size_t j = 0; j != rindex.size(); ++j)
+    {
       dolfin_assert(rindex[j] >= vector_range.first);
       dolfin_assert(rindex[j] < vector_range.second);
-      vector_values[rindex[j] - vector_range.first] = rval[j];
+      receive_positions[i][j] = rindex[j] - vector_range.first;
     }
   }
+}
+//-----------------------------------------------------------------------------
+void HDF5Utility::redistribute_vector_values(
+  const MPI_Comm mpi_comm,
+  const VectorRedistribution& redistribution,
+  const std::vector<double>& vector,
+  GenericVector& x)
+{
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  dolfin_assert(redistribution.send_positions.size() == num_processes);
+  dolfin_assert(redistribution.receive_positions.size() == num_processes);
+
+  std::vector<std::vector<double>> receive_values(num_processes);
+  {
+    std::vector<std::vector<double>> send_values(num_processes);
+    for (std::size_t i = 0; i != num_processes; ++i)
+    {
+      const std::vector<std::size_t>& positions
+        = redistribution.send_positions[i];
+      send_values[i].resize(positions.size());
+      for (std::size_t j = 0; j != positions.size(); ++j)
+      {
+        dolfin_assert(positions[j] < vector.size());
+        send_values[i][j] = vector[positions[j]];
+      }
+    }
+    MPI::all_to_all(mpi_comm, send_values, receive_values);
+  }
+
+  std::vector<double> vector_values(x.local_size());
+  for (std::size_t i = 0; i != num_processes; ++i)
+  {
+    const std::vector<double>& rval = receive_values[i];
+    const std::vector<std::size_t>& rpos
+      = redistribution.receive_positions[i];
+    dolfin_assert(rval.size() == rpos.size());
+    for (std::size_t j = 0; j != rpos.size(); ++j)
+      vector_values[rpos[j]] = rval[j];
+  }
 
   x.set_local(vector_values);
   x.apply("insert");
@@ -25,12 +25,14 @@
 #include <string>
 #include <vector>
 
+#include "dolfin/common/MPI.h"
 #include "dolfin/common/types.h"
 
 namespace dolfin
 {
   class LocalMeshData;
   class GenericDofMap;
+  class GenericVector;
   class Mesh;
 
   /// This class contains some algorithms which do not explicitly
@@ -84,7 +86,45 @@ namespace dolfin
     /// in serial
     static void build_local_mesh(Mesh& mesh, const LocalMeshData& mesh_data);
 
-    /// Missing docstring
+    /// Communication pattern for distributing the values of a
+    /// vector read from file in blocks of "input_vector_range" to
+    /// the owners of the corresponding dofs of a vector
+    struct VectorRedistribution
+    {
+      /// Positions in the input block of the values sent to each
+      /// process
+      std::vector<std::vector<std::size_t>> send_positions;
+
+      /// Local positions in the vector of the values received from
+      /// each process
+      std::vector<std::vector<std::size_t>> receive_positions;
+    };
+
+    /// Compute the redistribution of the values of a vector read
+    /// from file, given the cells and cell dofs read from file (see
+    /// set_local_vector_values)
+    static void build_vector_redistribution(
+      MPI_Comm mpi_comm,
+      const GenericVector& x,
+      const Mesh& mesh,
+      const std::vector<size_t>& cells,
+      const std::vector<dolfin::la_index>& cell_dofs,
+      const std::vector<std::size_t>& x_cell_dofs,
+      std::pair<dolfin::la_index, dolfin::la_index> input_vector_range,
+      const GenericDofMap& dofmap,
+      VectorRedistribution& redistribution);
+
+    /// Distribute values of a vector read from file with the given
+    /// redistribution and set them in the vector
+    static void redistribute_vector_values(
+      MPI_Comm mpi_comm,
+      const VectorRedistribution& redistribution,
+      const std::vector<double>& vector,
+      GenericVector& x);
+
+    /// Set the values of vector x from the values of a vector read
+    /// from file in blocks of "input_vector_range", redistributing
+    /// them by the global cells and cell dofs read from file
     static void set_local_vector_values(
       MPI_Comm mpi_comm,
       GenericVector& x,
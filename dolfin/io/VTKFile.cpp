@@ -44,17 +44,8 @@ using namespace dolfin;
 //----------------------------------------------------------------------------
 VTKFile::VTKFile(const std::string filename, std::string encoding)
   : GenericFile(filename, "VTK"),
-    _encoding(encoding), binary(false), compress(false)
+    _encoding(encoding), binary(false), compress(false), appended(false)
 {
-  if (encoding != "ascii" && encoding != "base64" && encoding != "compressed")
-  {
-    dolfin_error("VTKFile.cpp",
-                 "create VTK file",
-                 "Unknown encoding (\"%s\"). "
-                 "Known encodings are \"ascii\", \"base64\" and \"compressed\"",
-                 encoding.c_str());
-  }
-
   if (encoding == "ascii")
   {
     encode_string = "ascii";
@@ -67,12 +58,27 @@ VTKFile::VTKFile(const std::string filename, std::string encoding)
     if (encoding == "compressed")
       compress = true;
   }
+  else if (encoding == "appended" || encoding == "appended_compressed")
+  {
+    encode_string = "binary";
+    binary = true;
+    appended = true;
+    if (encoding == "appended_compressed")
+    {
+      #ifdef HAS_ZLIB
+      compress = true;
+      #else
+      warning("zlib must be configured to enable compressed VTK output. Using uncompressed appended data instead.");
+      #endif
+    }
+  }
   else
   {
     dolfin_error("VTKFile.cpp",
                  "create VTK file",
                  "Unknown encoding (\"%s\"). "
-                 "Known encodings are \"ascii\", \"base64\" and \"compressed\"",
+                 "Known encodings are \"ascii\", \"base64\", \"compressed\", "
+                 "\"appended\" and \"appended_compressed\"",
                  encoding.c_str());
   }
 }
@@ -155,7 +161,7 @@ void VTKFile::write_function(const Function& u, double time)
 
   // Write mesh
   VTKWriter::write_mesh(mesh, mesh.topology().dim(), vtu_filename, binary,
-                        compress);
+                        compress, appended);
 
   // Write results
   results_write(u, vtu_filename);
@@ -190,7 +196,7 @@ void VTKFile::write_mesh(const Mesh& mesh, double time)
 
   // Write local mesh to vtu file
   VTKWriter::write_mesh(mesh, mesh.topology().dim(), vtu_filename, binary,
-                        compress);
+                        compress, appended);
 
   // Parallel-specific files
   const std::size_t num_processes = MPI::size(mpi_comm);
@@ -220,6 +226,8 @@ std::string VTKFile::init(const Mesh& mesh, std::size_t cell_dim) const
                                       MPI::size(mpi_comm),
                                       counter, ".vtu");
   clear_file(vtu_filename);
+  if (appended)
+    clear_file(VTKWriter::appended_data_filename(vtu_filename));
 
   // Number of cells and vertices
   const std::size_t num_cells = mesh.topology().ghost_offset(cell_dim);
@@ -284,7 +292,7 @@ void VTKFile::results_write(const Function& u, std::string vtu_filename) const
   dolfin_assert(u.function_space()->dofmap());
   const GenericDofMap& dofmap= *u.function_space()->dofmap();
   if (dofmap.max_element_dofs() == cell_based_dim)
-    VTKWriter::write_cell_data(u, vtu_filename, binary, compress);
+    VTKWriter::write_cell_data(u, vtu_filename, binary, compress, appended);
   else
     write_point_data(u, mesh, vtu_filename);
 }
@@ -310,27 +318,25 @@ void VTKFile::write_point_data(const GenericFunction& u, const Mesh& mesh,
   u.compute_vertex_values(values, mesh);
   dolfin_assert(values.size() == size);
 
+  std::stringstream attributes;
+  attributes << "type=\"Float64\"  Name=\"" << u.name() << "\"";
   if (rank == 0)
-  {
     fp << "<PointData  Scalars=\"" << u.name() << "\"> " << std::endl;
-    fp << "<DataArray  type=\"Float64\"  Name=\"" << u.name()
-       << "\"  format=\""<< encode_string <<"\">";
-  }
   else if (rank == 1)
   {
     fp << "<PointData  Vectors=\"" << u.name() << "\"> " << std::endl;
-    fp << "<DataArray  type=\"Float64\"  Name=\"" << u.name()
-       << "\"  NumberOfComponents=\"3\" format=\""<< encode_string <<"\">";
+    attributes << "  NumberOfComponents=\"3\"";
   }
   else if (rank == 2)
   {
     fp << "<PointData  Tensors=\"" << u.name() << "\"> " << std::endl;
-    fp << "<DataArray  type=\"Float64\"  Name=\"" << u.name()
-       << "\"  NumberOfComponents=\"9\" format=\""<< encode_string <<"\">";
+    attributes << "  NumberOfComponents=\"9\"";
   }
 
-  if (_encoding == "ascii")
+  if (!binary)
   {
+    fp << "<DataArray  " << attributes.str() << "  format=\"ascii\">";
+
     std::ostringstream ss;
     ss << std::scientific;
     ss << std::setprecision(16);
@@ -367,8 +373,9 @@ void VTKFile::write_point_data(const GenericFunction& u, const Mesh& mesh,
 
     // Send to file
     fp << ss.str();
+    fp << "</DataArray> " << std::endl;
   }
-  else if (_encoding == "base64" || _encoding == "compressed")
+  else
   {
     // Number of zero paddings per point
     std::size_t padding_per_point = 0;
@@ -389,11 +396,11 @@ void VTKFile::write_point_data(const GenericFunction& u, const Mesh& mesh,
         data[index*num_data_per_point + i] = values[index + i*num_vertices];
     }
 
-    // Create encoded stream
-    fp << VTKWriter::encode_stream(data, compress) << std::endl;
+    // Write encoded or appended data
+    VTKWriter::write_data_array(fp, attributes.str(), data, vtu_filename,
+                                compress, appended);
   }
 
-  fp << "</DataArray> " << std::endl;
   fp << "</PointData> " << std::endl;
 }
 //----------------------------------------------------------------------------
@@ -444,20 +451,8 @@ void VTKFile::pvtu_write_mesh(pugi::xml_node xml_node) const
   data_node.append_attribute("type") = "Float64";
   data_node.append_attribute("NumberOfComponents") = "3";
 
-  // Cell data
-  pugi::xml_node cell_data_node = xml_node.append_child("PCellData");
-
-  data_node = cell_data_node.append_child("PDataArray");
-  data_node.append_attribute("type") = "UInt32";
-  data_node.append_attribute("Name") = "connectivity";
-
-  data_node = cell_data_node.append_child("PDataArray");
-  data_node.append_attribute("type") = "UInt32";
-  data_node.append_attribute("Name") = "offsets";
-
-  data_node = cell_data_node.append_child("PDataArray");
-  data_node.append_attribute("type") = "UInt8";
-  data_node.append_attribute("Name") = "types";
+  // Cell connectivity, offsets and types are part of each piece and
+  // are not declared as PCellData
 }
 //----------------------------------------------------------------------------
 void VTKFile::pvtu_write_function(std::size_t dim, std::size_t rank,
@@ -627,13 +622,18 @@ void VTKFile::vtk_header_open(std::size_t num_vertices, std::size_t num_cells,
 
   // Compression string
   std::string compressor = "";
-  if (_encoding == "compressed")
+  if (compress)
     compressor = "compressor=\"vtkZLibDataCompressor\"";
 
+  // Appended data uses 64-bit headers so that arrays may exceed 4GB
+  std::string header_type = "";
+  if (appended)
+    header_type = "header_type=\"UInt64\"";
+
   // Write headers
   file << "<?xml version=\"1.0\"?>" << std::endl;
   file << "<VTKFile type=\"UnstructuredGrid\"  version=\"0.1\" " << endianness
-       <<  " " << compressor << ">" << std::endl;
+       <<  " " << compressor << " " << header_type << ">" << std::endl;
   file << "<UnstructuredGrid>" << std::endl;
   file << "<Piece  NumberOfPoints=\"" << num_vertices << "\" NumberOfCells=\""
        << num_cells << "\">" << std::endl;
@@ -655,8 +655,17 @@ void VTKFile::vtk_header_close(std::string vtu_filename) const
   }
 
   // Close headers
-  file << "</Piece>" << std::endl << "</UnstructuredGrid>" << std::endl
-       << "</VTKFile>";
+  file << "</Piece>" << std::endl << "</UnstructuredGrid>" << std::endl;
+
+  // Copy appended data section into file
+  if (appended)
+  {
+    file.close();
+    VTKWriter::write_appended_data(vtu_filename);
+    file.open(vtu_filename.c_str(), std::ios::app);
+  }
+
+  file << "</VTKFile>";
 
   // Close file
   file.close();
@@ -699,7 +708,8 @@ void VTKFile::mesh_function_write(T& meshfunction, double time)
   std::string vtu_filename = init(mesh, cell_dim);
 
   // Write mesh
-  VTKWriter::write_mesh(mesh, cell_dim, vtu_filename, binary, compress);
+  VTKWriter::write_mesh(mesh, cell_dim, vtu_filename, binary, compress,
+                        appended);
 
   // Open file to write data
   std::ofstream fp(vtu_filename.c_str(), std::ios_base::app);
@@ -46,7 +46,10 @@ namespace dolfin
   {
   public:
 
-    /// Create VTK file
+    /// Create VTK file. Known encodings are "ascii", "base64" and
+    /// "compressed" (inline data), and "appended" and
+    /// "appended_compressed" (raw binary data in an appended data
+    /// section, the latter zlib compressed in blocks)
     VTKFile(const std::string filename, std::string encoding);
 
     // Destructor
@@ -143,6 +146,7 @@ namespace dolfin
 
     bool binary;
     bool compress;
+    bool appended;
 
   };
 
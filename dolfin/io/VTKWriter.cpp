@@ -19,6 +19,7 @@
 // Modified by Johannes Ring 2012
 
 #include <cstdint>
+#include <cstdio>
 #include <fstream>
 #include <ostream>
 #include <sstream>
@@ -41,18 +42,21 @@
 
 using namespace dolfin;
 
+const std::size_t VTKWriter::block_size;
+
 //----------------------------------------------------------------------------
 void VTKWriter::write_mesh(const Mesh& mesh, std::size_t cell_dim,
-                           std::string filename, bool binary, bool compress)
+                           std::string filename, bool binary, bool compress,
+                           bool appended)
 {
   if (binary)
-    write_base64_mesh(mesh, cell_dim, filename, compress);
+    write_binary_mesh(mesh, cell_dim, filename, compress, appended);
   else
     write_ascii_mesh(mesh, cell_dim, filename);
 }
 //----------------------------------------------------------------------------
 void VTKWriter::write_cell_data(const Function& u, std::string filename,
-                                bool binary, bool compress)
+                                bool binary, bool compress, bool appended)
 {
   // For brevity
   dolfin_assert(u.function_space()->mesh());
@@ -62,12 +66,6 @@ void VTKWriter::write_cell_data(const Function& u, std::string filename,
   const std::size_t tdim = mesh.topology().dim();
   const std::size_t num_cells = mesh.topology().ghost_offset(tdim);
 
-  std::string encode_string;
-  if (!binary)
-    encode_string = "ascii";
-  else
-    encode_string = "binary";
-
   // Get rank of Function
   const std::size_t rank = u.value_rank();
   if(rank > 2)
@@ -85,12 +83,10 @@ void VTKWriter::write_cell_data(const Function& u, std::string filename,
   fp.precision(16);
 
   // Write headers
+  std::stringstream attributes;
+  attributes << "type=\"Float64\"  Name=\"" << u.name() << "\"";
   if (rank == 0)
-  {
     fp << "<CellData  Scalars=\"" << u.name() << "\"> " << std::endl;
-    fp << "<DataArray  type=\"Float64\"  Name=\"" << u.name()
-       << "\"  format=\"" << encode_string <<"\">";
-  }
   else if (rank == 1)
   {
     if(!(data_dim == 2 || data_dim == 3))
@@ -100,8 +96,7 @@ void VTKWriter::write_cell_data(const Function& u, std::string filename,
                    "Don't know how to handle vector function with dimension other than 2 or 3");
     }
     fp << "<CellData  Vectors=\"" << u.name() << "\"> " << std::endl;
-    fp << "<DataArray  type=\"Float64\"  Name=\"" << u.name()
-       << "\"  NumberOfComponents=\"3\" format=\""<< encode_string <<"\">";
+    attributes << "  NumberOfComponents=\"3\"";
   }
   else if (rank == 2)
   {
@@ -112,8 +107,7 @@ void VTKWriter::write_cell_data(const Function& u, std::string filename,
                    "Don't know how to handle tensor function with dimension other than 4 or 9");
     }
     fp << "<CellData  Tensors=\"" << u.name() << "\"> " << std::endl;
-    fp << "<DataArray  type=\"Float64\"  Name=\"" << u.name()
-       << "\"  NumberOfComponents=\"9\" format=\""<< encode_string <<"\">";
+    attributes << "  NumberOfComponents=\"9\"";
   }
 
   // Allocate memory for function values at cell centres
@@ -143,13 +137,17 @@ void VTKWriter::write_cell_data(const Function& u, std::string filename,
 
   // Get cell data
   if (!binary)
+  {
+    fp << "<DataArray  " << attributes.str() << "  format=\"ascii\">";
     fp << ascii_cell_data(mesh, offset, values, data_dim, rank);
+    fp << "</DataArray> " << std::endl;
+  }
   else
   {
-    fp << base64_cell_data(mesh, offset, values, data_dim, rank, compress)
-       << std::endl;
+    write_data_array(fp, attributes.str(),
+                     binary_cell_data(mesh, offset, values, data_dim, rank),
+                     filename, compress, appended);
   }
-  fp << "</DataArray> " << std::endl;
   fp << "</CellData> " << std::endl;
 }
 //----------------------------------------------------------------------------
@@ -196,11 +194,11 @@ std::string VTKWriter::ascii_cell_data(const Mesh& mesh,
   return ss.str();
 }
 //----------------------------------------------------------------------------
-std::string VTKWriter::base64_cell_data(const Mesh& mesh,
-                                        const std::vector<std::size_t>& offset,
-                                        const std::vector<double>& values,
-                                        std::size_t data_dim, std::size_t rank,
-                                        bool compress)
+std::vector<double>
+VTKWriter::binary_cell_data(const Mesh& mesh,
+                            const std::vector<std::size_t>& offset,
+                            const std::vector<double>& values,
+                            std::size_t data_dim, std::size_t rank)
 {
   const std::size_t num_cells = mesh.num_cells();
 
@@ -225,7 +223,7 @@ std::string VTKWriter::base64_cell_data(const Mesh& mesh,
     ++cell_offset;
   }
 
-  return encode_stream(data, compress);
+  return data;
 }
 //----------------------------------------------------------------------------
 void VTKWriter::write_ascii_mesh(const Mesh& mesh, std::size_t cell_dim,
@@ -293,8 +291,9 @@ void VTKWriter::write_ascii_mesh(const Mesh& mesh, std::size_t cell_dim,
   file.close();
 }
 //-----------------------------------------------------------------------------
-void VTKWriter::write_base64_mesh(const Mesh& mesh, std::size_t cell_dim,
-                                  std::string filename, bool compress)
+void VTKWriter::write_binary_mesh(const Mesh& mesh, std::size_t cell_dim,
+                                  std::string filename, bool compress,
+                                  bool appended)
 {
   const std::size_t num_cells = mesh.topology().size(cell_dim);
   const std::size_t num_cell_vertices = mesh.type().num_vertices(cell_dim);
@@ -314,8 +313,6 @@ void VTKWriter::write_base64_mesh(const Mesh& mesh, std::size_t cell_dim,
 
   // Write vertex positions
   file << "<Points>" << std::endl;
-  file << "<DataArray  type=\"Float64\"  NumberOfComponents=\"3\"  format=\""
-       << "binary" << "\">" << std::endl;
   std::vector<double> vertex_data(3*mesh.num_vertices());
   std::vector<double>::iterator vertex_entry = vertex_data.begin();
   for (VertexIterator v(mesh); !v.end(); ++v)
@@ -325,14 +322,12 @@ void VTKWriter::write_base64_mesh(const Mesh& mesh, std::size_t cell_dim,
     *vertex_entry++ = p.y();
     *vertex_entry++ = p.z();
   }
-  // Create encoded stream
-  file <<  encode_stream(vertex_data, compress) << std::endl;
-  file << "</DataArray>" << std::endl <<  "</Points>" << std::endl;
+  write_data_array(file, "type=\"Float64\"  NumberOfComponents=\"3\"",
+                   vertex_data, filename, compress, appended);
+  file << "</Points>" << std::endl;
 
   // Write cell connectivity
   file << "<Cells>" << std::endl;
-  file << "<DataArray  type=\"UInt32\"  Name=\"connectivity\"  format=\""
-       << "binary" << "\">" << std::endl;
   const int size = num_cells*num_cell_vertices;
   std::vector<std::uint32_t> cell_data(size);
   std::vector<std::uint32_t>::iterator cell_entry = cell_data.begin();
@@ -345,41 +340,63 @@ void VTKWriter::write_base64_mesh(const Mesh& mesh, std::size_t cell_dim,
     for (unsigned int i = 0; i != c->num_entities(0); ++i)
       *cell_entry++ = c->entities(0)[perm[i]];
   }
-
-  // Create encoded stream
-  file << encode_stream(cell_data, compress) << std::endl;
-  file << "</DataArray>" << std::endl;
+  write_data_array(file, "type=\"UInt32\"  Name=\"connectivity\"",
+                   cell_data, filename, compress, appended);
 
   // Write offset into connectivity array for the end of each cell
-  file << "<DataArray  type=\"UInt32\"  Name=\"offsets\"  format=\""
-       << "binary" << "\">" << std::endl;
-  std::vector<std::uint32_t> offset_data(num_cells*num_cell_vertices);
+  std::vector<std::uint32_t> offset_data(num_cells);
   std::vector<std::uint32_t>::iterator offset_entry = offset_data.begin();
   for (std::size_t offsets = 1; offsets <= num_cells; offsets++)
     *offset_entry++ = offsets*num_cell_vertices;
-
-  // Create encoded stream
-  file << encode_stream(offset_data, compress) << std::endl;
-  file << "</DataArray>" << std::endl;
+  write_data_array(file, "type=\"UInt32\"  Name=\"offsets\"",
+                   offset_data, filename, compress, appended);
 
   // Write cell type
-  file << "<DataArray  type=\"UInt8\"  Name=\"types\"  format=\"" << "binary"
-       << "\">" << std::endl;
-  std::vector<std::uint8_t> type_data(num_cells);
-  std::vector<std::uint8_t>::iterator type_entry = type_data.begin();
-  for (std::size_t types = 0; types < num_cells; types++)
-    *type_entry++ = _vtk_cell_type;
-
-  // Create encoded stream
-  file << encode_stream(type_data, compress) << std::endl;
-
-  file  << "</DataArray>" << std::endl;
+  std::vector<std::uint8_t> type_data(num_cells, _vtk_cell_type);
+  write_data_array(file, "type=\"UInt8\"  Name=\"types\"",
+                   type_data, filename, compress, appended);
   file  << "</Cells>" << std::endl;
 
   // Close file
   file.close();
 }
 //----------------------------------------------------------------------------
+std::string VTKWriter::appended_data_filename(std::string file)
+{
+  return file + ".appended";
+}
+//----------------------------------------------------------------------------
+void VTKWriter::write_appended_data(std::string file)
+{
+  const std::string appended_file = appended_data_filename(file);
+  std::ifstream data(appended_file.c_str(), std::ios::binary);
+  if (!data.is_open())
+  {
+    dolfin_error("VTKWriter.cpp",
+                 "write appended data to VTK file",
+                 "Unable to open file \"%s\"", appended_file.c_str());
+  }
+
+  std::ofstream fp(file.c_str(), std::ios::app | std::ios::binary);
+  if (!fp.is_open())
+  {
+    dolfin_error("VTKWriter.cpp",
+                 "write appended data to VTK file",
+                 "Unable to open file \"%s\"", file.c_str());
+  }
+
+  // Raw data starts after the underscore, and is copied through the
+  // stream buffers without being loaded into memory
+  fp << "<AppendedData  encoding=\"raw\">" << std::endl << "_";
+  if (data.peek() != std::ifstream::traits_type::eof())
+    fp << data.rdbuf();
+  fp << std::endl << "</AppendedData>" << std::endl;
+
+  fp.close();
+  data.close();
+  std::remove(appended_file.c_str());
+}
+//----------------------------------------------------------------------------
 std::uint8_t VTKWriter::vtk_cell_type(const Mesh& mesh,
                                       std::size_t cell_dim)
 {
@@ -21,9 +21,12 @@
 #ifndef __VTK_WRITER_H
 #define __VTK_WRITER_H
 
+#include <algorithm>
 #include <cstdint>
+#include <fstream>
 #include <string>
 #include <vector>
+#include <dolfin/log/log.h>
 #include "Encoder.h"
 
 namespace dolfin
@@ -38,19 +41,51 @@ namespace dolfin
   {
   public:
 
-    /// Mesh writer
+    /// Mesh writer. If appended is true, binary data is written raw
+    /// to the appended data section of the file
     static void write_mesh(const Mesh& mesh, std::size_t cell_dim,
                            std::string file,
-                           bool binary, bool compress);
+                           bool binary, bool compress,
+                           bool appended=false);
 
     /// Cell data writer
     static void write_cell_data(const Function& u, std::string file,
-                                bool binary, bool compress);
+                                bool binary, bool compress,
+                                bool appended=false);
 
     /// Form (compressed) base64 encoded string for VTK
     template<typename T>
     static std::string encode_stream(const std::vector<T>& data,
                                      bool compress);
+
+    /// Write binary DataArray element. The data is either encoded
+    /// inline as (compressed) base64, or appended raw to the appended
+    /// data section and referenced by its offset
+    template<typename T>
+    static void write_data_array(std::ofstream& fp, std::string attributes,
+                                 const std::vector<T>& data,
+                                 std::string file, bool compress,
+                                 bool appended);
+
+    /// Append raw data to the appended data section of a VTK file
+    /// and return its offset in the section. The data is written
+    /// directly from the array, or compressed in blocks of
+    /// block_size bytes, so no encoded copy of the whole array is
+    /// formed
+    template<typename T>
+    static std::size_t append_data(const std::vector<T>& data,
+                                   std::string file, bool compress);
+
+    /// Name of the temporary file holding the appended data section
+    /// of a VTK file while the file is being written
+    static std::string appended_data_filename(std::string file);
+
+    /// Copy the appended data section to the end of a VTK file and
+    /// remove the temporary appended data file
+    static void write_appended_data(std::string file);
+
+    /// Size (bytes) of the blocks used for compressed appended data
+    static const std::size_t block_size = 32768;
   //friend class VTKFile;
 
   private:
@@ -61,20 +96,21 @@ namespace dolfin
                                        const std::vector<double>& values,
                                        std::size_t dim, std::size_t rank);
 
-    // Write cell data (base64)
-    static std::string base64_cell_data(const Mesh& mesh,
-                                        const std::vector<std::size_t>& offset,
-                                        const std::vector<double>& values,
-                                        std::size_t dim, std::size_t rank,
-                                        bool compress);
+    // Pad cell data to 3D for binary output
+    static std::vector<double>
+      binary_cell_data(const Mesh& mesh,
+                       const std::vector<std::size_t>& offset,
+                       const std::vector<double>& values,
+                       std::size_t dim, std::size_t rank);
 
     // Mesh writer (ascii)
     static void write_ascii_mesh(const Mesh& mesh, std::size_t cell_dim,
                                  std::string file);
 
-    // Mesh writer (base64)
-    static void write_base64_mesh(const Mesh& mesh, std::size_t cell_dim,
-                                  std::string file, bool compress);
+    // Mesh writer (base64 or appended raw)
+    static void write_binary_mesh(const Mesh& mesh, std::size_t cell_dim,
+                                  std::string file, bool compress,
+                                  bool appended);
 
     // Get VTK cell type
     static std::uint8_t vtk_cell_type(const Mesh& mesh, std::size_t cell_dim);
@@ -152,6 +188,96 @@ namespace dolfin
   }
   #endif
   //--------------------------------------------------------------------------
+  template<typename T>
+  void VTKWriter::write_data_array(std::ofstream& fp, std::string attributes,
+                                   const std::vector<T>& data,
+                                   std::string file, bool compress,
+                                   bool appended)
+  {
+    if (appended)
+    {
+      const std::size_t offset = append_data(data, file, compress);
+      fp << "<DataArray  " << attributes << "  format=\"appended\"  offset=\""
+         << offset << "\"/>" << std::endl;
+    }
+    else
+    {
+      fp << "<DataArray  " << attributes << "  format=\"binary\">"
+         << std::endl;
+      fp << encode_stream(data, compress) << std::endl;
+      fp << "</DataArray>" << std::endl;
+    }
+  }
+  //--------------------------------------------------------------------------
+  template<typename T>
+  std::size_t VTKWriter::append_data(const std::vector<T>& data,
+                                     std::string file, bool compress)
+  {
+    // Open appended data file at its end
+    const std::string appended_file = appended_data_filename(file);
+    std::fstream fp(appended_file.c_str(), std::ios::in | std::ios::out
+                    | std::ios::binary | std::ios::ate);
+    if (!fp.is_open())
+    {
+      dolfin_error("VTKWriter.h",
+                   "append data to VTK file",
+                   "Unable to open file \"%s\"", appended_file.c_str());
+    }
+
+    const std::size_t offset = fp.tellp();
+    const char* bytes = reinterpret_cast<const char*>(data.data());
+    const std::uint64_t num_bytes = data.size()*sizeof(T);
+
+    #ifdef HAS_ZLIB
+    if (compress)
+    {
+      // Header: number of blocks, block size, size of last partial
+      // block (0 if full) and compressed size of each block
+      const std::uint64_t num_blocks = (num_bytes + block_size - 1)/block_size;
+      std::vector<std::uint64_t> header(3 + num_blocks, 0);
+      header[0] = num_blocks;
+      header[1] = block_size;
+      header[2] = num_bytes % block_size;
+
+      // Reserve space for header, compressed sizes are filled in below
+      fp.write(reinterpret_cast<const char*>(header.data()),
+               header.size()*sizeof(std::uint64_t));
+
+      // Compress and write one block at a time
+      std::vector<unsigned char> buffer(compressBound(block_size));
+      for (std::uint64_t b = 0; b < num_blocks; ++b)
+      {
+        const std::uint64_t size
+          = std::min<std::uint64_t>(block_size, num_bytes - b*block_size);
+        uLongf compressed_size = buffer.size();
+        if (::compress((Bytef*) buffer.data(), &compressed_size,
+                       (const Bytef*) (bytes + b*block_size), size) != Z_OK)
+        {
+          dolfin_error("VTKWriter.h",
+                       "append data to VTK file",
+                       "Zlib error while compressing data");
+        }
+        fp.write(reinterpret_cast<const char*>(buffer.data()),
+                 compressed_size);
+        header[3 + b] = compressed_size;
+      }
+
+      // Rewrite header with compressed block sizes
+      fp.seekp(offset);
+      fp.write(reinterpret_cast<const char*>(header.data()),
+               header.size()*sizeof(std::uint64_t));
+
+      return offset;
+    }
+    #endif
+
+    // Header (number of bytes) followed by the raw data
+    fp.write(reinterpret_cast<const char*>(&num_bytes), sizeof(num_bytes));
+    fp.write(bytes, num_bytes);
+
+    return offset;
+  }
+  //--------------------------------------------------------------------------
 
 }
 
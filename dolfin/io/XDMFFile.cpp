@@ -17,7 +17,11 @@
 //
 // Modified by Garth N. Wells, 2012
 
+#include <cstring>
+#include <fstream>
 #include <iomanip>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <ostream>
 #include <sstream>
@@ -27,16 +31,23 @@
 #include <boost/container/vector.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
 #include "pugixml.hpp"
 
 #include <dolfin/common/MPI.h>
+#include <dolfin/common/SubSystemsManager.h>
+#include <dolfin/common/Timer.h>
 #include <dolfin/common/defines.h>
 #include <dolfin/common/utils.h>
 #include <dolfin/function/Function.h>
 #include <dolfin/function/FunctionSpace.h>
+#include <dolfin/fem/Form.h>
 #include <dolfin/fem/GenericDofMap.h>
+#include <dolfin/fem/assemble.h>
+#include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/la/GenericVector.h>
+#include <dolfin/log/log.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/DistributedMeshTools.h>
 #include <dolfin/mesh/Edge.h>
@@ -55,10 +66,157 @@
 
 using namespace dolfin;
 
+namespace
+{
+#ifdef HAS_HDF5
+  // Asynchronous output task writing a dataset (and its partition
+  // attribute) to an open HDF5 file
+  template<typename T>
+  class HDF5DatasetTask : public AsyncWriter::Task
+  {
+  public:
+
+    // The dataset options of the file at creation of the task are
+    // used for writing
+    HDF5DatasetTask(hid_t h5_id, std::string h5_path,
+                    std::vector<T> data,
+                    std::pair<std::int64_t, std::int64_t> range,
+                    std::vector<std::int64_t> shape, bool use_mpi_io,
+                    std::vector<std::size_t> partitions)
+      : _h5_id(h5_id), _h5_path(h5_path), _data(std::move(data)), _range(range),
+        _shape(shape), _use_mpi_io(use_mpi_io), _partitions(partitions),
+        _options(HDF5Interface::get_dataset_options(h5_id)) {}
+
+    void run()
+    {
+      HDF5Interface::write_dataset(_h5_id, _h5_path, _data, _range, _shape,
+                                   _use_mpi_io, _options);
+      HDF5Interface::add_attribute(_h5_id, _h5_path, "partition",
+                                   _partitions);
+    }
+
+  private:
+
+    const hid_t _h5_id;
+    const std::string _h5_path;
+    const std::vector<T> _data;
+    const std::pair<std::int64_t, std::int64_t> _range;
+    const std::vector<std::int64_t> _shape;
+    const bool _use_mpi_io;
+    const std::vector<std::size_t> _partitions;
+    const HDF5Interface::DatasetOptions _options;
+
+  };
+
+  // Client data of the ZFP (fixed accuracy mode) or SZ (absolute
+  // error bound) HDF5 filter plugin for the given tolerance
+  std::vector<unsigned int> lossy_filter_values(const std::string filter,
+                                                double tolerance)
+  {
+    // The tolerance is passed as the two words of a double
+    unsigned int tolerance_words[2];
+    static_assert(sizeof(tolerance_words) == sizeof(double),
+                  "Unexpected size of double");
+    std::memcpy(tolerance_words, &tolerance, sizeof(double));
+
+    if (filter == "zfp")
+    {
+      // Mode (H5Z_ZFP_MODE_ACCURACY), unused, tolerance
+      return {3, 0, tolerance_words[0], tolerance_words[1]};
+    }
+    else
+    {
+      // Error bound mode (ABS), absolute, relative, point-wise
+      // relative and PSNR bounds
+      return {0, tolerance_words[0], tolerance_words[1], 0, 0, 0, 0, 0, 0};
+    }
+  }
+#endif
+
+  // Write a string to a file, either replacing the file (offset < 0)
+  // or overwriting it in place from the given offset
+  void write_text_file(const std::string filename,
+                       const std::string& contents, std::int64_t offset)
+  {
+    std::ofstream file;
+    if (offset < 0)
+      file.open(filename.c_str());
+    else
+    {
+      file.open(filename.c_str(),
+                std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(offset);
+    }
+
+    if (!file.good())
+    {
+      dolfin_error("XDMFFile.cpp",
+                   "write XDMF file",
+                   "Unable to open file \"%s\"", filename.c_str());
+    }
+    file << contents;
+  }
+
+  // Asynchronous output task writing a string to a file
+  class TextFileTask : public AsyncWriter::Task
+  {
+  public:
+
+    TextFileTask(std::string filename, std::string contents,
+                 std::int64_t offset=-1)
+      : _filename(filename), _contents(contents), _offset(offset) {}
+
+    void run()
+    { write_text_file(_filename, _contents, _offset); }
+
+  private:
+
+    const std::string _filename;
+    const std::string _contents;
+    const std::int64_t _offset;
+
+  };
+
+  // Closing tags following the last time step of the last time
+  // series, as serialised by pugixml with an indent of two spaces
+  const std::string xml_time_series_trailer
+    = "    </Grid>\n  </Domain>\n</Xdmf>\n";
+
+  // Return the dof layout of a function on this process: the
+  // ownership range of its vector and a hash of the global indices
+  // and global dofs of the owned cells. A checkpoint written with the
+  // same layout on each process can be read without redistribution.
+  std::vector<std::size_t> checkpoint_layout(const Mesh& mesh,
+                                             const GenericDofMap& dofmap,
+                                             const GenericVector& x)
+  {
+    std::vector<std::size_t> local_to_global_map;
+    dofmap.tabulate_local_to_global_dofs(local_to_global_map);
+
+    const std::size_t tdim = mesh.topology().dim();
+    const std::size_t num_cells = mesh.topology().ghost_offset(tdim);
+    const std::vector<std::int64_t>& global_cells
+      = mesh.topology().global_indices(tdim);
+
+    std::size_t hash = 0;
+    for (std::size_t i = 0; i < num_cells; ++i)
+    {
+      boost::hash_combine(hash, global_cells.empty() ? i : global_cells[i]);
+      auto cell_dofs = dofmap.cell_dofs(i);
+      for (Eigen::Index j = 0; j < cell_dofs.size(); ++j)
+        boost::hash_combine(hash, local_to_global_map[cell_dofs[j]]);
+    }
+
+    const std::pair<std::int64_t, std::int64_t> range = x.local_range();
+    return {(std::size_t) range.first, (std::size_t) range.second, hash};
+  }
+}
+
 //-----------------------------------------------------------------------------
 XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename)
   : _mpi_comm(comm), _filename(filename),
-    _counter(0), _xml_doc(new pugi::xml_document)
+    _counter(0), _xml_doc(new pugi::xml_document), _xml_step_offset(-1),
+    _xml_step_size(0), _reductions_started(false)
 {
   // Rewrite the mesh at every time step in a time series. Should be
   // turned off if the mesh remains constant.
@@ -73,26 +231,81 @@ XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename)
   // HDF5 file whilst running, at some performance cost.
   parameters.add("flush_output", false);
 
+  // Write time series of Functions asynchronously on a background
+  // thread, queueing at most async_queue_size time steps (HDF5
+  // encoding only, and only if MPI provides MPI_THREAD_MULTIPLE and
+  // HDF5 is thread safe)
+  parameters.add("async_output", false);
+  parameters.add("async_queue_size", 2);
+
+  // Write only the XML of the latest time step of a time series,
+  // in place at the end of the file, rather than the whole document
+  parameters.add("incremental_xml", true);
+
+  // Write time series of Functions only every k-th time step, and
+  // compute statistics of the Function vector at every time step
+  parameters.add("decimation", 1, 1, std::numeric_limits<int>::max());
+  parameters.add("statistics", false);
+
+  // Write meshes and checkpoints as one HDF5 file per process
+  // (HDF5 encoding only)
+  parameters.add("file_per_process", false);
+
+  // Write Function values for visualisation (not geometry, topology
+  // or checkpoints) in single precision, and/or with error-bounded
+  // lossy compression by the ZFP (filter id 32013) or SZ (32017)
+  // HDF5 filter plugin with the given absolute tolerance (HDF5
+  // encoding only)
+  parameters.add("value_precision", "double", {"double", "single"});
+  parameters.add("lossy_compression", "none", {"none", "zfp", "sz"});
+  parameters.add("lossy_tolerance", 1.0e-6);
+
+#ifdef HAS_HDF5
+  // Layout, compression and transfer mode of HDF5 datasets
+  HDF5File::add_dataset_parameters(parameters);
+#endif
 }
 //-----------------------------------------------------------------------------
 XDMFFile::~XDMFFile()
 {
+  // Complete queued output (errors are reported as warnings)
+  _async_writer.reset();
+
   close();
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::close()
 {
+  // Wait for queued output
+  flush();
+
 #ifdef HAS_HDF5
   // Close the HDF5 file
   _hdf5_file.reset();
 #endif
 }
 //-----------------------------------------------------------------------------
+void XDMFFile::flush()
+{
+  if (_async_writer)
+    _async_writer->flush();
+}
+//-----------------------------------------------------------------------------
 void XDMFFile::write(const Mesh& mesh, const Encoding encoding)
 {
+  // Wait for queued output
+  flush();
+
   // Check that encoding is supported
   check_encoding(encoding);
 
+  // Write one piece per process
+  if (encoding == Encoding::HDF5 and parameters["file_per_process"])
+  {
+    write_pieces(mesh);
+    return;
+  }
+
   // Open a HDF5 file if using HDF5 encoding (truncate)
   hid_t h5_id = -1;
 #ifdef HAS_HDF5
@@ -105,6 +318,8 @@ void XDMFFile::write(const Mesh& mesh, const Encoding encoding)
 
     // Get file handle
     h5_id = h5_file->h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
   }
 #endif
 
@@ -127,7 +342,10 @@ void XDMFFile::write(const Mesh& mesh, const Encoding encoding)
 
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
+  {
+    Timer t("XDMF: update XML");
     _xml_doc->save_file(_filename.c_str(), "  ");
+  }
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write_checkpoint(const Function& u,
@@ -135,12 +353,22 @@ void XDMFFile::write_checkpoint(const Function& u,
                                 double time_step,
                                 const Encoding encoding)
 {
+  // Wait for queued output
+  flush();
+
   check_encoding(encoding);
   check_function_name(function_name);
 
   log(PROGRESS, "Writing function \"%s\" to XDMF file \"%s\" with "
       "time step %f.", function_name.c_str(), _filename.c_str(), time_step);
 
+  // Write one piece per process
+  if (encoding == Encoding::HDF5 and parameters["file_per_process"])
+  {
+    write_checkpoint_pieces(u, function_name, time_step);
+    return;
+  }
+
   // If XML file exists load it to member _xml_doc
   if (boost::filesystem::exists(_filename))
   {
@@ -210,6 +438,8 @@ void XDMFFile::write_checkpoint(const Function& u,
     }
     dolfin_assert(_hdf5_file);
     h5_id = _hdf5_file->h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
   }
 #endif
   // From this point _xml_doc points to a valid XDMF XML document
@@ -274,6 +504,7 @@ void XDMFFile::write_checkpoint(const Function& u,
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
   {
+    Timer t("XDMF: update XML");
     log(PROGRESS, "Saving XML file \"%s\" (only on rank = 0)",
         _filename.c_str());
 
@@ -295,6 +526,9 @@ void XDMFFile::write_checkpoint(const Function& u,
 //-----------------------------------------------------------------------------
 void XDMFFile::write(const Function& u, const Encoding encoding)
 {
+  // Wait for queued output
+  flush();
+
   check_encoding(encoding);
 
   // If counter is non-zero, a time series has been saved before
@@ -323,6 +557,8 @@ void XDMFFile::write(const Function& u, const Encoding encoding)
 
     // Get file handle
     h5_id = h5_file->h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
   }
 #endif
 
@@ -373,12 +609,16 @@ void XDMFFile::write(const Function& u, const Encoding encoding)
   const std::int64_t num_values =  cell_centred ?
     mesh.size_global(mesh.topology().dim()) : num_points;
 
-  add_data_item(_mpi_comm.comm(), attribute_node, h5_id,
-                "/VisualisationVector/0", data_values, {num_values, width});
+  add_value_data_item(_mpi_comm.comm(), attribute_node, h5_id,
+                      "/VisualisationVector/0", data_values,
+                      {num_values, width});
 
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
+  {
+    Timer t("XDMF: update XML");
     _xml_doc->save_file(_filename.c_str(), "  ");
+  }
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write(const Function& u, double time_step,
@@ -386,12 +626,35 @@ void XDMFFile::write(const Function& u, double time_step,
 {
   check_encoding(encoding);
 
+  // Compute in-situ reductions, and skip output of decimated steps
+  const std::size_t step = _num_steps[u.name()]++;
+  write_reductions(u, time_step, step);
+  const int decimation = parameters["decimation"];
+  if (step % decimation != 0)
+    return;
+
   const Mesh& mesh = *u.function_space()->mesh();
 
+  // Collect HDF5 output in a task list if writing asynchronously
+  std::unique_ptr<AsyncWriter::TaskList> tasks;
+  if (parameters["async_output"] and encoding == Encoding::HDF5
+      and (_async_writer or async_output_supported()))
+  {
+    if (!_async_writer)
+    {
+      const int queue_size = parameters["async_queue_size"];
+      _async_writer.reset(new AsyncWriter(queue_size));
+    }
+    tasks.reset(new AsyncWriter::TaskList);
+  }
+  else
+    flush();
+
   // Clear the pugi doc the first time
   if (_counter == 0)
   {
     _xml_doc->reset();
+    _xml_step_offset = -1;
 
     // Create XDMF header
     _xml_doc->append_child(pugi::node_doctype).set_value("Xdmf SYSTEM \"Xdmf.dtd\" []");
@@ -421,6 +684,8 @@ void XDMFFile::write(const Function& u, double time_step,
     }
     dolfin_assert(_hdf5_file);
     h5_id = _hdf5_file->h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
   }
 #endif
 
@@ -441,11 +706,23 @@ void XDMFFile::write(const Function& u, double time_step,
   timegrid_node = domain_node.find_child_by_attribute("Grid", "Name", tg_name.c_str());
 
   // Ensure that we have a time series grid node
+  const bool incremental_xml = parameters["incremental_xml"];
   if (timegrid_node)
   {
-    // Get existing mesh grid node with the correct time step if it exist (otherwise null)
-    std::string xpath = std::string("Grid[Time/@Value=\"") + time_step_str + std::string("\"]");
-    mesh_node = timegrid_node.select_node(xpath.c_str()).node();
+    // Get existing mesh grid node with the correct time step if it
+    // exist (otherwise null). Only the latest time step is checked in
+    // incremental mode, to keep the cost per time step constant.
+    if (incremental_xml)
+    {
+      pugi::xml_node last_node = timegrid_node.last_child();
+      if (time_step_str == last_node.child("Time").attribute("Value").value())
+        mesh_node = last_node;
+    }
+    else
+    {
+      std::string xpath = std::string("Grid[Time/@Value=\"") + time_step_str + std::string("\"]");
+      mesh_node = timegrid_node.select_node(xpath.c_str()).node();
+    }
     dolfin_assert(std::string(timegrid_node.attribute("CollectionType").value()) == "Temporal");
   }
   else
@@ -461,13 +738,14 @@ void XDMFFile::write(const Function& u, double time_step,
 
   // Only add mesh grid node at this time step if no other function has
   // previously added it (and parameters["functions_share_mesh"] == true)
-  if (!mesh_node)
+  const bool new_step = !mesh_node;
+  if (new_step)
   {
     // Add the mesh grid node to to the time series grid node
     if (new_timegrid or parameters["rewrite_function_mesh"])
     {
       add_mesh(_mpi_comm.comm(), timegrid_node, h5_id, mesh,
-        "/Mesh/" + std::to_string(_counter));
+        "/Mesh/" + std::to_string(_counter), tasks.get());
     }
     else
     {
@@ -518,18 +796,76 @@ void XDMFFile::write(const Function& u, double time_step,
   const std::string dataset_name = "/VisualisationVector/"
                                    + std::to_string(_counter);
 
-  add_data_item(_mpi_comm.comm(), attribute_node, h5_id,
-                dataset_name, data_values, {num_values, width});
+  add_value_data_item(_mpi_comm.comm(), attribute_node, h5_id,
+                      dataset_name, data_values, {num_values, width},
+                      tasks.get());
 
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  {
+    Timer t("XDMF: update XML");
+    std::ostringstream step_xml;
+    mesh_node.print(step_xml, "  ", pugi::format_default,
+                    pugi::encoding_auto, 3);
+    const std::size_t step_size = step_xml.str().size();
+
+    // The time step is at the end of the file if it is the last one
+    // of the last time series
+    const bool step_at_end = timegrid_node == domain_node.last_child()
+      and mesh_node == timegrid_node.last_child();
+
+    std::string xml;
+    std::int64_t xml_offset = -1;
+    if (incremental_xml and step_at_end and !new_timegrid
+        and _xml_step_offset >= 0)
+    {
+      // Write the time step after the previous one (or over it, if
+      // adding a function to the same time step) and close the
+      // document
+      xml_offset = _xml_step_offset;
+      if (new_step)
+        xml_offset += _xml_step_size;
+      xml = step_xml.str() + xml_time_series_trailer;
+      _xml_step_offset = xml_offset;
+    }
+    else
+    {
+      // Rewrite the whole document, and record where the time step
+      // starts if it can be updated incrementally
+      std::ostringstream doc_xml;
+      _xml_doc->save(doc_xml, "  ");
+      xml = doc_xml.str();
+      _xml_step_offset = -1;
+      if (step_at_end)
+      {
+        _xml_step_offset = xml.size() - xml_time_series_trailer.size()
+          - step_size;
+        dolfin_assert(xml.compare(_xml_step_offset, std::string::npos,
+                                  step_xml.str() + xml_time_series_trailer) == 0);
+      }
+    }
+    _xml_step_size = step_size;
+
+    // Write file directly, or after the HDF5 data if asynchronous
+    if (tasks)
+    {
+      tasks->add(std::unique_ptr<AsyncWriter::Task>(
+                   new TextFileTask(_filename, xml, xml_offset)));
+    }
+    else
+      write_text_file(_filename, xml, xml_offset);
+  }
+
+  // Queue output of this time step
+  if (tasks)
+    _async_writer->push(std::move(tasks));
 
 #ifdef HAS_HDF5
   // Close the HDF5 file if in "flush" mode
   if (encoding == Encoding::HDF5 and parameters["flush_output"])
   {
     dolfin_assert(_hdf5_file);
+    flush();
     _hdf5_file.reset();
   }
 #endif
@@ -537,6 +873,121 @@ void XDMFFile::write(const Function& u, double time_step,
   ++_counter;
 }
 //-----------------------------------------------------------------------------
+void XDMFFile::add_probe(std::string name, const Point& point)
+{
+  _probes.push_back({name, point});
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::add_functional(const Function& u, std::string name,
+                              std::shared_ptr<const Form> functional)
+{
+  dolfin_assert(functional);
+  if (functional->rank() != 0)
+  {
+    dolfin_error("XDMFFile.cpp",
+                 "add functional to XDMF file",
+                 "Form \"%s\" has rank %d, expecting a functional (rank 0)",
+                 name.c_str(), functional->rank());
+  }
+  _functionals.push_back(std::make_tuple(u.id(), name, functional));
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::write_reductions(const Function& u, double t, std::size_t step)
+{
+  // Values as (quantity, value)
+  std::vector<std::pair<std::string, double>> values;
+
+  // Statistics of the Function vector
+  if (parameters["statistics"])
+  {
+    dolfin_assert(u.vector());
+    const GenericVector& x = *u.vector();
+    values.push_back({"min", x.min()});
+    values.push_back({"max", x.max()});
+    values.push_back({"norm_l2", x.norm("l2")});
+    values.push_back({"norm_linf", x.norm("linf")});
+  }
+
+  // Point probes, evaluated on the process owning a cell containing
+  // the point (averaged if the point is on a process boundary)
+  if (!_probes.empty())
+  {
+    dolfin_assert(u.function_space()->mesh());
+    const Mesh& mesh = *u.function_space()->mesh();
+    const std::size_t tdim = mesh.topology().dim();
+    const std::size_t gdim = mesh.geometry().dim();
+    const std::size_t num_cells = mesh.topology().ghost_offset(tdim);
+    const std::size_t value_size = u.value_size();
+    for (auto& probe : _probes)
+    {
+      std::vector<double> probe_values(value_size, 0.0);
+      double count = 0.0;
+      const unsigned int cell_index
+        = mesh.bounding_box_tree()->compute_first_entity_collision(probe.second);
+      if (cell_index < num_cells)
+      {
+        const Cell cell(mesh, cell_index);
+        ufc::cell ufc_cell;
+        cell.get_cell_data(ufc_cell);
+        Array<double> _values(value_size, probe_values.data());
+        Array<double> x(gdim, probe.second.coordinates());
+        u.eval(_values, x, cell, ufc_cell);
+        count = 1.0;
+      }
+
+      count = MPI::sum(_mpi_comm.comm(), count);
+      for (std::size_t i = 0; i < value_size; ++i)
+      {
+        std::string quantity = probe.first;
+        if (value_size > 1)
+          quantity += "_" + std::to_string(i);
+        const double value = MPI::sum(_mpi_comm.comm(), probe_values[i]);
+        values.push_back({quantity, count > 0.0 ? value/count
+                          : std::numeric_limits<double>::quiet_NaN()});
+      }
+    }
+  }
+
+  // Functionals of u
+  for (auto& functional : _functionals)
+  {
+    if (std::get<0>(functional) == u.id())
+    {
+      values.push_back({std::get<1>(functional),
+                        assemble(*std::get<2>(functional))});
+    }
+  }
+
+  if (values.empty())
+    return;
+
+  // Append rows to table, creating it on first use
+  if (_mpi_comm.rank() == 0)
+  {
+    boost::filesystem::path path(_filename);
+    const std::string filename
+      = path.replace_extension().string() + "_reductions.csv";
+    std::ofstream file(filename.c_str(), _reductions_started ? std::ios::app
+                       : std::ios::trunc);
+    if (!file.is_open())
+    {
+      dolfin_error("XDMFFile.cpp",
+                   "write reductions to table",
+                   "Unable to open file \"%s\"", filename.c_str());
+    }
+
+    if (!_reductions_started)
+      file << "function,step,time,quantity,value" << std::endl;
+    file.precision(16);
+    for (auto& value : values)
+    {
+      file << u.name() << "," << step << "," << t << "," << value.first
+           << "," << value.second << std::endl;
+    }
+  }
+  _reductions_started = true;
+}
+//-----------------------------------------------------------------------------
 void XDMFFile::write(const MeshFunction<bool>& meshfunction,
                      const Encoding encoding)
 {
@@ -589,6 +1040,9 @@ template <typename T>
 void XDMFFile::write_mesh_value_collection(const MeshValueCollection<T>& mvc,
                                            const Encoding encoding)
 {
+  // Wait for queued output
+  flush();
+
   check_encoding(encoding);
 
   // Provide some very basic functionality for saving
@@ -641,6 +1095,8 @@ void XDMFFile::write_mesh_value_collection(const MeshValueCollection<T>& mvc,
 
     // Get file handle
     h5_id = h5_file->h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
   }
 #endif
 
@@ -695,8 +1151,9 @@ void XDMFFile::write_mesh_value_collection(const MeshValueCollection<T>& mvc,
     = vtk_cell_type_str(mesh->type().entity_type(cell_dim), mesh->geometry().degree());
   const std::int64_t num_vertices_per_cell = mesh->type().num_vertices(cell_dim);
 
-  const std::map<std::pair<std::size_t, std::size_t>, T>& values
-    = mvc.values();
+  const std::vector<std::pair<std::size_t, std::size_t>>& entities
+    = mvc.entities();
+  const std::vector<T>& values = mvc.entity_values();
   const std::int64_t num_cells = values.size();
   const std::int64_t num_cells_global = MPI::sum(mesh->mpi_comm(), num_cells);
 
@@ -714,17 +1171,17 @@ void XDMFFile::write_mesh_value_collection(const MeshValueCollection<T>& mvc,
   value_data.reserve(num_cells);
 
   mesh->init(tdim, cell_dim);
-  for (auto &p : values)
+  for (std::size_t i = 0; i < entities.size(); ++i)
   {
-    MeshEntity cell = Cell(*mesh, p.first.first);
+    MeshEntity cell = Cell(*mesh, entities[i].first);
     if (cell_dim != tdim)
     {
-      const unsigned int entity_local_idx = cell.entities(cell_dim)[p.first.second];
+      const unsigned int entity_local_idx = cell.entities(cell_dim)[entities[i].second];
       cell = MeshEntity(*mesh, cell_dim, entity_local_idx);
     }
     for (VertexIterator v(cell); !v.end(); ++v)
       topology_data.push_back(v->global_index());
-    value_data.push_back(p.second);
+    value_data.push_back(values[i]);
   }
 
   const std::string mvc_dataset_name = "/MeshValueCollection/" + std::to_string(_counter);
@@ -751,7 +1208,10 @@ void XDMFFile::write_mesh_value_collection(const MeshValueCollection<T>& mvc,
 
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
+  {
+    Timer t("XDMF: update XML");
     _xml_doc->save_file(_filename.c_str(), "  ");
+  }
 
   ++_counter;
 }
@@ -763,8 +1223,13 @@ void XDMFFile::read(MeshValueCollection<bool>& mvc, std::string name)
   read_mesh_value_collection(mvc_int, name);
 
   mvc.init(mvc.mesh(), mvc_int.dim());
-  for (const auto &p : mvc_int.values())
-    mvc.set_value(p.first.first, p.first.second, (bool)p.second);
+  const std::vector<std::pair<std::size_t, std::size_t>>& entities
+    = mvc_int.entities();
+  const std::vector<int>& values = mvc_int.entity_values();
+  mvc.reserve(entities.size());
+  for (std::size_t i = 0; i < entities.size(); ++i)
+    mvc.append(entities[i].first, entities[i].second, (bool)values[i]);
+  mvc.finalize();
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::read(MeshValueCollection<int>& mvc, std::string name)
@@ -786,10 +1251,12 @@ template <typename T>
 void XDMFFile::read_mesh_value_collection
 (MeshValueCollection<T>& mvc, std::string name)
 {
+  // Wait for queued output
+  flush();
+
   // Load XML doc from file
   pugi::xml_document xml_doc;
-  pugi::xml_parse_result result = xml_doc.load_file(_filename.c_str());
-  dolfin_assert(result);
+  load_xml_document(xml_doc);
 
   // Get XDMF node
   pugi::xml_node xdmf_node = xml_doc.child("Xdmf");
@@ -958,15 +1425,21 @@ void XDMFFile::read_mesh_value_collection
     dolfin_assert(recv_entities[i].size() == recv_data[i].size());
     for (std::size_t j = 0; j != recv_data[i].size(); ++j)
     {
-      mvc.set_value(recv_entities[i][j], recv_data[i][j]);
+      mvc.append(recv_entities[i][j], recv_data[i][j]);
     }
   }
 
+  // Sort values and remove duplicates
+  mvc.finalize();
+
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write(const std::vector<Point>& points,
                      const Encoding encoding)
 {
+  // Wait for queued output
+  flush();
+
   // Check that encoding is supported
   check_encoding(encoding);
 
@@ -982,6 +1455,8 @@ void XDMFFile::write(const std::vector<Point>& points,
 
     // Get file handle
     h5_id = h5_file->h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
   }
 #endif
 
@@ -997,7 +1472,10 @@ void XDMFFile::write(const std::vector<Point>& points,
 
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
+  {
+    Timer t("XDMF: update XML");
     _xml_doc->save_file(_filename.c_str(), "  ");
+  }
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::add_points(MPI_Comm comm, pugi::xml_node& xdmf_node,
@@ -1041,6 +1519,9 @@ void XDMFFile::write(const std::vector<Point>& points,
                      const std::vector<double>& values,
                      const Encoding encoding)
 {
+  // Wait for queued output
+  flush();
+
   // Write clouds of points to XDMF/HDF5 with values
   dolfin_assert(points.size() == values.size());
 
@@ -1062,6 +1543,8 @@ void XDMFFile::write(const std::vector<Point>& points,
 
     // Get file handle
     h5_id = h5_file->h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
   }
 #endif
 
@@ -1091,7 +1574,10 @@ void XDMFFile::write(const std::vector<Point>& points,
 
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
+  {
+    Timer t("XDMF: update XML");
     _xml_doc->save_file(_filename.c_str(), "  ");
+  }
 }
 //----------------------------------------------------------------------------
 void XDMFFile::read(MeshFunction<bool>& meshfunction, std::string name)
@@ -1124,7 +1610,8 @@ void XDMFFile::read(MeshFunction<double>& meshfunction, std::string name)
 //----------------------------------------------------------------------------
 void XDMFFile::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
                         hid_t h5_id, const Mesh& mesh,
-                        const std::string path_prefix)
+                        const std::string path_prefix,
+                        AsyncWriter::TaskList* tasks)
 {
   log(PROGRESS, "Adding mesh to node \"%s\"", xml_node.path('/').c_str());
 
@@ -1139,13 +1626,545 @@ void XDMFFile::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
   const std::int64_t num_global_cells = mesh.size_global(tdim);
   if (num_global_cells < 1e9)
     add_topology_data<std::int32_t>(comm, grid_node, h5_id, path_prefix,
-                                    mesh, tdim);
+                                    mesh, tdim, tasks);
   else
     add_topology_data<std::int64_t>(comm, grid_node, h5_id, path_prefix,
-                                    mesh, tdim);
+                                    mesh, tdim, tasks);
 
   // Add geometry node and attributes (including writing data)
-  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh);
+  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh, tasks);
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::write_pieces(const Mesh& mesh)
+{
+  // Reset pugi doc
+  _xml_doc->reset();
+
+  // Add XDMF node and version attribute
+  _xml_doc->append_child(pugi::node_doctype).set_value("Xdmf SYSTEM \"Xdmf.dtd\" []");
+  pugi::xml_node xdmf_node = _xml_doc->append_child("Xdmf");
+  dolfin_assert(xdmf_node);
+  xdmf_node.append_attribute("Version") = "3.0";
+  xdmf_node.append_attribute("xmlns:xi") = "http://www.w3.org/2001/XInclude";
+
+  // Add domain node and spatial collection of pieces
+  pugi::xml_node domain_node = xdmf_node.append_child("Domain");
+  dolfin_assert(domain_node);
+  pugi::xml_node collection_node = domain_node.append_child("Grid");
+  dolfin_assert(collection_node);
+  collection_node.append_attribute("Name") = mesh.name().c_str();
+  collection_node.append_attribute("GridType") = "Collection";
+  collection_node.append_attribute("CollectionType") = "Spatial";
+
+#ifdef HAS_HDF5
+  // Write piece of this process to its own HDF5 file (truncate)
+  pugi::xml_document piece_doc;
+  {
+    HDF5File h5_file(MPI_COMM_SELF,
+                     get_piece_filename(_filename, _mpi_comm.rank()), "w");
+    HDF5Interface::set_dataset_options(h5_file.h5_id(),
+                                       HDF5File::dataset_options(parameters));
+    add_mesh_piece(piece_doc, h5_file.h5_id(), mesh, "/Mesh");
+  }
+
+  // Collect pieces on process 0
+  gather_pieces(_mpi_comm.comm(), collection_node, piece_doc);
+#endif
+
+  // Save XML file (on process 0 only)
+  if (_mpi_comm.rank() == 0)
+  {
+    Timer t("XDMF: update XML");
+    _xml_doc->save_file(_filename.c_str(), "  ");
+  }
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::write_checkpoint_pieces(const Function& u,
+                                       std::string function_name,
+                                       double time_step)
+{
+  // Load existing XML document, or create new document and truncate
+  // the HDF5 files if it does not have the expected structure
+  bool truncate_hdf = true;
+  if (boost::filesystem::exists(_filename))
+  {
+    pugi::xml_parse_result result = _xml_doc->load_file(_filename.c_str());
+    dolfin_assert(result);
+    truncate_hdf = _xml_doc->select_node("/Xdmf/Domain").node().empty();
+  }
+
+  if (truncate_hdf)
+  {
+    _xml_doc->reset();
+    pugi::xml_node xdmf_node = _xml_doc->append_child("Xdmf");
+    dolfin_assert(xdmf_node);
+    xdmf_node.append_attribute("Version") = "3.0";
+    pugi::xml_node domain_node = xdmf_node.append_child("Domain");
+    dolfin_assert(domain_node);
+  }
+
+  // Find or create temporal grid of function
+  pugi::xml_node func_temporal_grid_node =
+    _xml_doc->select_node(
+      ("/Xdmf/Domain/Grid[@CollectionType='Temporal' and "
+       "@Name='" + function_name + "']").c_str()
+    ).node();
+  if (func_temporal_grid_node.empty())
+  {
+    func_temporal_grid_node
+      = _xml_doc->select_node("/Xdmf/Domain").node().append_child("Grid");
+    func_temporal_grid_node.append_attribute("GridType") = "Collection";
+    func_temporal_grid_node.append_attribute("CollectionType") = "Temporal";
+    func_temporal_grid_node.append_attribute("Name") = function_name.c_str();
+  }
+
+  // Add spatial collection of pieces for this time step
+  const std::size_t counter
+    = func_temporal_grid_node.select_nodes("Grid").size();
+  const std::string function_time_name
+    = function_name + "_" + std::to_string(counter);
+  pugi::xml_node collection_node
+    = func_temporal_grid_node.append_child("Grid");
+  dolfin_assert(collection_node);
+  collection_node.append_attribute("Name") = function_time_name.c_str();
+  collection_node.append_attribute("GridType") = "Collection";
+  collection_node.append_attribute("CollectionType") = "Spatial";
+  pugi::xml_node time_node = collection_node.append_child("Time");
+  time_node.append_attribute("Value") = std::to_string(time_step).c_str();
+
+#ifdef HAS_HDF5
+  // Write piece of this process to its own HDF5 file
+  pugi::xml_document piece_doc;
+  {
+    HDF5File h5_file(MPI_COMM_SELF,
+                     get_piece_filename(_filename, _mpi_comm.rank()),
+                     truncate_hdf ? "w" : "a");
+    const hid_t h5_id = h5_file.h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
+
+    const std::string h5_path = function_name + "/" + function_time_name;
+    const Mesh& mesh = *u.function_space()->mesh();
+    pugi::xml_node piece_node = add_mesh_piece(piece_doc, h5_id, mesh,
+                                               h5_path);
+    add_function_piece(piece_node, h5_id, h5_path, u, function_name);
+  }
+
+  // Collect pieces on process 0
+  gather_pieces(_mpi_comm.comm(), collection_node, piece_doc);
+#endif
+
+  // Save XML file (on process 0 only)
+  if (_mpi_comm.rank() == 0)
+  {
+    Timer t("XDMF: update XML");
+    _xml_doc->save_file(_filename.c_str(), "  ");
+  }
+}
+//-----------------------------------------------------------------------------
+pugi::xml_node XDMFFile::add_mesh_piece(pugi::xml_node& xml_node,
+                                        hid_t h5_id, const Mesh& mesh,
+                                        const std::string path_prefix)
+{
+  if (mesh.geometry().degree() != 1)
+  {
+    dolfin_error("XDMFFile.cpp",
+                 "write mesh piece",
+                 "Only affine meshes can be written with one file per process");
+  }
+
+  const MeshTopology& topology = mesh.topology();
+  const int tdim = topology.dim();
+  const std::int64_t num_cells = topology.ghost_offset(tdim);
+  const std::int64_t num_vertices = mesh.num_vertices();
+  const int num_vertices_per_cell = mesh.type().num_vertices(tdim);
+  const std::string group_name = path_prefix + "/" + mesh.name();
+
+  // Add grid node of piece
+  pugi::xml_node grid_node = xml_node.append_child("Grid");
+  dolfin_assert(grid_node);
+  grid_node.append_attribute("Name") = mesh.name().c_str();
+  grid_node.append_attribute("GridType") = "Uniform";
+
+  // Add topology of owned cells, in terms of local vertex indices
+  pugi::xml_node topology_node = grid_node.append_child("Topology");
+  dolfin_assert(topology_node);
+  topology_node.append_attribute("NumberOfElements")
+    = std::to_string(num_cells).c_str();
+  topology_node.append_attribute("TopologyType")
+    = vtk_cell_type_str(mesh.type().cell_type(), 1).c_str();
+  topology_node.append_attribute("NodesPerElement") = num_vertices_per_cell;
+
+  std::vector<std::int32_t> topology_data;
+  topology_data.reserve(num_cells*num_vertices_per_cell);
+  const std::vector<std::int8_t> perm = mesh.type().vtk_mapping();
+  for (CellIterator c(mesh); !c.end(); ++c)
+  {
+    const unsigned int* vertices = c->entities(0);
+    for (int i = 0; i < num_vertices_per_cell; ++i)
+      topology_data.push_back(vertices[perm[i]]);
+  }
+  add_data_item(MPI_COMM_SELF, topology_node, h5_id,
+                group_name + "/topology", topology_data,
+                {num_cells, num_vertices_per_cell}, "UInt");
+
+  // Add coordinates of all local vertices
+  int gdim = mesh.geometry().dim();
+  std::vector<double> x = mesh.geometry().x();
+  if (gdim == 1)
+  {
+    // Pad the coordinates with zeros for a dummy Y
+    gdim = 2;
+    std::vector<double> _x(2*x.size(), 0.0);
+    for (std::size_t i = 0; i < x.size(); ++i)
+      _x[2*i] = x[i];
+    std::swap(x, _x);
+  }
+
+  pugi::xml_node geometry_node = grid_node.append_child("Geometry");
+  dolfin_assert(geometry_node);
+  geometry_node.append_attribute("GeometryType") = (gdim == 3) ? "XYZ" : "XY";
+  add_data_item(MPI_COMM_SELF, geometry_node, h5_id,
+                group_name + "/geometry", x, {num_vertices, gdim});
+
+  // Add global indices of the vertices and cells of the piece
+  std::vector<std::size_t> vertex_indices(num_vertices);
+  for (std::int64_t i = 0; i < num_vertices; ++i)
+  {
+    vertex_indices[i] = topology.have_global_indices(0)
+      ? topology.global_indices(0)[i] : i;
+  }
+  std::vector<std::size_t> cell_indices(num_cells);
+  for (std::int64_t i = 0; i < num_cells; ++i)
+  {
+    cell_indices[i] = topology.have_global_indices(tdim)
+      ? topology.global_indices(tdim)[i] : i;
+  }
+
+  pugi::xml_node vertex_attribute_node = grid_node.append_child("Attribute");
+  dolfin_assert(vertex_attribute_node);
+  vertex_attribute_node.append_attribute("Name") = "vertex_indices";
+  vertex_attribute_node.append_attribute("AttributeType") = "Scalar";
+  vertex_attribute_node.append_attribute("Center") = "Node";
+  add_data_item(MPI_COMM_SELF, vertex_attribute_node, h5_id,
+                group_name + "/vertex_indices", vertex_indices,
+                {num_vertices, 1}, "UInt");
+
+  pugi::xml_node cell_attribute_node = grid_node.append_child("Attribute");
+  dolfin_assert(cell_attribute_node);
+  cell_attribute_node.append_attribute("Name") = "cell_indices";
+  cell_attribute_node.append_attribute("AttributeType") = "Scalar";
+  cell_attribute_node.append_attribute("Center") = "Cell";
+  add_data_item(MPI_COMM_SELF, cell_attribute_node, h5_id,
+                group_name + "/cell_indices", cell_indices,
+                {num_cells, 1}, "UInt");
+
+  return grid_node;
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::add_function_piece(pugi::xml_node& xml_node, hid_t h5_id,
+                                  std::string h5_path, const Function& u,
+                                  std::string function_name)
+{
+  dolfin_assert(u.function_space()->mesh());
+  const Mesh& mesh = *u.function_space()->mesh();
+  dolfin_assert(u.function_space()->dofmap());
+  const GenericDofMap& dofmap = *u.function_space()->dofmap();
+  dolfin_assert(u.vector());
+  const GenericVector& x = *u.vector();
+
+  // Collect values of the dofs of each owned cell (including ghost
+  // dofs), with the global cell indices
+  const int tdim = mesh.topology().dim();
+  const std::int64_t num_cells = mesh.topology().ghost_offset(tdim);
+  std::vector<std::size_t> cells(num_cells);
+  std::vector<std::size_t> x_cell_dofs(num_cells + 1, 0);
+  std::vector<double> cell_values;
+  for (CellIterator c(mesh); !c.end(); ++c)
+  {
+    const std::size_t i = c->index();
+    cells[i] = mesh.topology().have_global_indices(tdim)
+      ? c->global_index() : i;
+
+    auto dofs = dofmap.cell_dofs(i);
+    const std::size_t offset = cell_values.size();
+    cell_values.resize(offset + dofs.size());
+    x.get_local(cell_values.data() + offset, dofs.size(), dofs.data());
+    x_cell_dofs[i + 1] = cell_values.size();
+  }
+
+  // Add attribute node with the cell indices, offsets and values
+  pugi::xml_node attribute_node = xml_node.append_child("Attribute");
+  dolfin_assert(attribute_node);
+  attribute_node.append_attribute("Name") = function_name.c_str();
+  attribute_node.append_attribute("AttributeType")
+    = rank_to_string(u.value_rank()).c_str();
+  attribute_node.append_attribute("Center") = "Other";
+
+  add_data_item(MPI_COMM_SELF, attribute_node, h5_id, h5_path + "/cells",
+                cells, {num_cells, 1}, "UInt");
+  add_data_item(MPI_COMM_SELF, attribute_node, h5_id,
+                h5_path + "/x_cell_dofs", x_cell_dofs, {num_cells + 1, 1},
+                "UInt");
+  add_data_item(MPI_COMM_SELF, attribute_node, h5_id,
+                h5_path + "/cell_values", cell_values,
+                {(std::int64_t) cell_values.size(), 1}, "Float");
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::gather_pieces(MPI_Comm comm, pugi::xml_node& xml_node,
+                             const pugi::xml_document& piece_doc)
+{
+  // Serialise piece of this process and gather on process 0
+  std::stringstream s;
+  piece_doc.save(s, "  ", pugi::format_default | pugi::format_no_declaration);
+  std::vector<std::string> pieces;
+  MPI::gather(comm, s.str(), pieces);
+
+  // Append pieces (in order of process rank)
+  for (std::size_t p = 0; p < pieces.size(); ++p)
+  {
+    pugi::xml_parse_result result
+      = xml_node.append_buffer(pieces[p].data(), pieces[p].size());
+    dolfin_assert(result);
+  }
+}
+//-----------------------------------------------------------------------------
+pugi::xml_node XDMFFile::get_piece(MPI_Comm comm,
+                                   const pugi::xml_node& collection_node)
+{
+  std::vector<pugi::xml_node> pieces;
+  for (pugi::xml_node node = collection_node.child("Grid"); node;
+       node = node.next_sibling("Grid"))
+  {
+    pieces.push_back(node);
+  }
+
+  if (pieces.size() != MPI::size(comm))
+  {
+    dolfin_error("XDMFFile.cpp",
+                 "read XDMF file with one piece per process",
+                 "Number of pieces (%d) does not match number of processes (%d)",
+                 pieces.size(), MPI::size(comm));
+  }
+
+  return pieces[MPI::rank(comm)];
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::read_pieces(Mesh& mesh, const pugi::xml_node& piece_node,
+                           const boost::filesystem::path& parent_path) const
+{
+  MPI_Comm comm = _mpi_comm.comm();
+  dolfin_assert(piece_node);
+
+  // Get cell type
+  pugi::xml_node topology_node = piece_node.child("Topology");
+  dolfin_assert(topology_node);
+  const auto cell_type_str = get_cell_type(topology_node);
+  dolfin_assert(cell_type_str.second == 1);
+  std::unique_ptr<CellType> cell_type(CellType::create(cell_type_str.first));
+  dolfin_assert(cell_type);
+  const int num_vertices_per_cell = cell_type->num_entities(0);
+
+  // Determine geometric dimension
+  pugi::xml_node geometry_node = piece_node.child("Geometry");
+  dolfin_assert(geometry_node);
+  const std::string geometry_type
+    = geometry_node.attribute("GeometryType").value();
+  const int gdim = (geometry_type == "XYZ") ? 3 : 2;
+
+  // Read piece of this process
+  const std::vector<std::int32_t> topology_data
+    = get_dataset<std::int32_t>(MPI_COMM_SELF, topology_node.child("DataItem"),
+                                parent_path);
+  const std::vector<double> geometry_data
+    = get_dataset<double>(MPI_COMM_SELF, geometry_node.child("DataItem"),
+                          parent_path);
+  pugi::xml_node vertex_indices_node = piece_node.find_child_by_attribute(
+    "Attribute", "Name", "vertex_indices").child("DataItem");
+  pugi::xml_node cell_indices_node = piece_node.find_child_by_attribute(
+    "Attribute", "Name", "cell_indices").child("DataItem");
+  dolfin_assert(vertex_indices_node);
+  dolfin_assert(cell_indices_node);
+  const std::vector<std::size_t> vertex_indices
+    = get_dataset<std::size_t>(MPI_COMM_SELF, vertex_indices_node, parent_path);
+  const std::vector<std::size_t> cell_indices
+    = get_dataset<std::size_t>(MPI_COMM_SELF, cell_indices_node, parent_path);
+  dolfin_assert(topology_data.size()
+                == cell_indices.size()*num_vertices_per_cell);
+  dolfin_assert(geometry_data.size() == vertex_indices.size()*gdim);
+
+  LocalMeshData local_mesh_data(comm);
+
+  // -- Topology --
+
+  // Set cells of piece, with global vertex indices in DOLFIN ordering
+  const std::size_t num_local_cells = cell_indices.size();
+  local_mesh_data.topology.dim = cell_type->dim();
+  local_mesh_data.topology.cell_type = cell_type->cell_type();
+  local_mesh_data.topology.num_vertices_per_cell = num_vertices_per_cell;
+  local_mesh_data.topology.num_global_cells = MPI::sum(comm, num_local_cells);
+  local_mesh_data.topology.cell_vertices.resize(
+    boost::extents[num_local_cells][num_vertices_per_cell]);
+  const std::vector<std::int8_t> perm = cell_type->vtk_mapping();
+  for (std::size_t i = 0; i < num_local_cells; ++i)
+  {
+    for (int j = 0; j < num_vertices_per_cell; ++j)
+    {
+      local_mesh_data.topology.cell_vertices[i][j]
+        = vertex_indices[topology_data[i*num_vertices_per_cell + perm[j]]];
+    }
+  }
+  local_mesh_data.topology.global_cell_indices.assign(cell_indices.begin(),
+                                                      cell_indices.end());
+
+  // -- Geometry --
+
+  // Compute global number of vertices
+  std::int64_t num_global_vertices = 0;
+  for (std::size_t i = 0; i < vertex_indices.size(); ++i)
+  {
+    num_global_vertices = std::max(num_global_vertices,
+                                   (std::int64_t) vertex_indices[i] + 1);
+  }
+  num_global_vertices = MPI::max(comm, num_global_vertices);
+  local_mesh_data.geometry.dim = gdim;
+  local_mesh_data.geometry.num_global_vertices = num_global_vertices;
+
+  // Send vertex coordinates to the process that holds the range of
+  // global indices (vertices shared between pieces are sent by each
+  // piece)
+  const std::size_t mpi_size = MPI::size(comm);
+  std::vector<std::vector<std::size_t>> send_indices(mpi_size);
+  std::vector<std::vector<double>> send_coordinates(mpi_size);
+  for (std::size_t i = 0; i < vertex_indices.size(); ++i)
+  {
+    const unsigned int p = MPI::index_owner(comm, vertex_indices[i],
+                                            num_global_vertices);
+    send_indices[p].push_back(vertex_indices[i]);
+    send_coordinates[p].insert(send_coordinates[p].end(),
+                               geometry_data.begin() + i*gdim,
+                               geometry_data.begin() + (i + 1)*gdim);
+  }
+
+  std::vector<std::vector<std::size_t>> received_indices;
+  std::vector<std::vector<double>> received_coordinates;
+  MPI::all_to_all(comm, send_indices, received_indices);
+  MPI::all_to_all(comm, send_coordinates, received_coordinates);
+
+  const std::pair<std::int64_t, std::int64_t> vertex_range
+    = MPI::local_range(comm, num_global_vertices);
+  const std::int64_t num_local_vertices
+    = vertex_range.second - vertex_range.first;
+  local_mesh_data.geometry.vertex_coordinates.resize(
+    boost::extents[num_local_vertices][gdim]);
+  for (std::size_t p = 0; p < received_indices.size(); ++p)
+  {
+    for (std::size_t i = 0; i < received_indices[p].size(); ++i)
+    {
+      const std::int64_t local_index
+        = received_indices[p][i] - vertex_range.first;
+      dolfin_assert(local_index >= 0 and local_index < num_local_vertices);
+      std::copy(received_coordinates[p].begin() + i*gdim,
+                received_coordinates[p].begin() + (i + 1)*gdim,
+                local_mesh_data.geometry.vertex_coordinates[local_index].begin());
+    }
+  }
+  local_mesh_data.geometry.vertex_indices.resize(num_local_vertices);
+  std::iota(local_mesh_data.geometry.vertex_indices.begin(),
+            local_mesh_data.geometry.vertex_indices.end(),
+            vertex_range.first);
+
+  // Build mesh, keeping the cells of each piece on its process
+  if (mpi_size == 1)
+    HDF5Utility::build_local_mesh(mesh, local_mesh_data);
+  else
+  {
+    local_mesh_data.topology.cell_partition.assign(num_local_cells,
+                                                   MPI::rank(comm));
+    const std::string ghost_mode = dolfin::parameters["ghost_mode"];
+    MeshPartitioning::build_distributed_mesh(mesh, local_mesh_data,
+                                             ghost_mode);
+  }
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::read_checkpoint_piece(Function& u,
+                                     const pugi::xml_node& piece_node,
+                                     std::string function_name,
+                                     const boost::filesystem::path& parent_path)
+{
+  dolfin_assert(piece_node);
+  pugi::xml_node attribute_node = piece_node.find_child_by_attribute(
+    "Attribute", "Name", function_name.c_str());
+  dolfin_assert(attribute_node);
+
+  // Read global cell indices, offsets and values of the cell dofs
+  const std::vector<std::size_t> cells
+    = get_dataset<std::size_t>(MPI_COMM_SELF,
+                               attribute_node.select_node("DataItem[position()=1]").node(),
+                               parent_path);
+  const std::vector<std::size_t> x_cell_dofs
+    = get_dataset<std::size_t>(MPI_COMM_SELF,
+                               attribute_node.select_node("DataItem[position()=2]").node(),
+                               parent_path);
+  const std::vector<double> cell_values
+    = get_dataset<double>(MPI_COMM_SELF,
+                          attribute_node.select_node("DataItem[position()=3]").node(),
+                          parent_path);
+  dolfin_assert(x_cell_dofs.size() == cells.size() + 1);
+
+  // Get existing mesh and dofmap
+  dolfin_assert(u.function_space()->mesh());
+  const Mesh& mesh = *u.function_space()->mesh();
+  dolfin_assert(u.function_space()->dofmap());
+  const GenericDofMap& dofmap = *u.function_space()->dofmap();
+  dolfin_assert(u.vector());
+  GenericVector& x = *u.vector();
+
+  // Map from global to local cell indices
+  const std::size_t tdim = mesh.topology().dim();
+  std::map<std::size_t, std::size_t> global_to_local;
+  for (CellIterator c(mesh, "all"); !c.end(); ++c)
+  {
+    global_to_local[mesh.topology().have_global_indices(tdim)
+                    ? c->global_index() : c->index()] = c->index();
+  }
+
+  // Set values of owned dofs of the cells of the piece
+  const std::size_t local_size = x.local_size();
+  std::vector<dolfin::la_index> rows;
+  std::vector<double> values;
+  for (std::size_t i = 0; i < cells.size(); ++i)
+  {
+    auto it = global_to_local.find(cells[i]);
+    if (it == global_to_local.end())
+    {
+      dolfin_error("XDMFFile.cpp",
+                   "read function from XDMF file with one piece per process",
+                   "Cell %d of piece is not on this process. The mesh must be read from the same file",
+                   cells[i]);
+    }
+
+    auto dofs = dofmap.cell_dofs(it->second);
+    if ((std::size_t) dofs.size() != x_cell_dofs[i + 1] - x_cell_dofs[i])
+    {
+      dolfin_error("XDMFFile.cpp",
+                   "read function from XDMF file with one piece per process",
+                   "Number of dofs of cell %d does not match function space",
+                   cells[i]);
+    }
+
+    for (Eigen::Index j = 0; j < dofs.size(); ++j)
+    {
+      if (dofs[j] < (dolfin::la_index) local_size)
+      {
+        rows.push_back(dofs[j]);
+        values.push_back(cell_values[x_cell_dofs[i] + j]);
+      }
+    }
+  }
+
+  x.set_local(values.data(), values.size(), rows.data());
+  x.apply("insert");
 }
 //----------------------------------------------------------------------------
 void XDMFFile::add_function(MPI_Comm mpi_comm, pugi::xml_node& xml_node,
@@ -1290,26 +2309,30 @@ void XDMFFile::add_function(MPI_Comm mpi_comm, pugi::xml_node& xml_node,
                 h5_path + "/cells", cells,
                 {num_cells_global, 1}, "UInt");
 
+  // Save dof layout of each process (for reading without
+  // redistribution on the same partition)
+  const std::vector<std::size_t> layout
+    = checkpoint_layout(mesh, dofmap, u_vector);
+  add_data_item(mpi_comm, fe_attribute_node, h5_id,
+                h5_path + "/layout", layout,
+                {(std::int64_t) MPI::size(mpi_comm), (std::int64_t) layout.size()},
+                "UInt");
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::read(Mesh& mesh) const
 {
+  // Wait for queued output
+  if (_async_writer)
+    _async_writer->flush();
+
   // Extract parent filepath (required by HDF5 when XDMF stores relative path
   // of the HDF5 files(s) and the XDMF is not opened from its own directory)
   boost::filesystem::path xdmf_filename(_filename);
   const boost::filesystem::path parent_path = xdmf_filename.parent_path();
 
-  if (!boost::filesystem::exists(xdmf_filename))
-  {
-    dolfin_error("XDMFFile.cpp",
-                 "open XDMF file",
-                 "XDMF file \"%s\" does not exist", _filename.c_str());
-  }
-
   // Load XML doc from file
   pugi::xml_document xml_doc;
-  pugi::xml_parse_result result = xml_doc.load_file(_filename.c_str());
-  dolfin_assert(result);
+  load_xml_document(xml_doc);
 
   // Get XDMF node
   pugi::xml_node xdmf_node = xml_doc.child("Xdmf");
@@ -1323,6 +2346,13 @@ void XDMFFile::read(Mesh& mesh) const
   pugi::xml_node grid_node = domain_node.child("Grid");
   dolfin_assert(grid_node);
 
+  // Read mesh written with one piece per process
+  if (std::string(grid_node.attribute("CollectionType").value()) == "Spatial")
+  {
+    read_pieces(mesh, get_piece(_mpi_comm.comm(), grid_node), parent_path);
+    return;
+  }
+
   // Get topology node
   pugi::xml_node topology_node = grid_node.child("Topology");
   dolfin_assert(topology_node);
@@ -1406,6 +2436,9 @@ void XDMFFile::read(Mesh& mesh) const
 void XDMFFile::read_checkpoint(Function& u, std::string func_name,
                                std::int64_t counter)
 {
+  // Wait for queued output
+  flush();
+
   check_function_name(func_name);
 
   log(PROGRESS, "Reading function \"%s\" from XDMF file \"%s\" with "
@@ -1416,19 +2449,9 @@ void XDMFFile::read_checkpoint(Function& u, std::string func_name,
   boost::filesystem::path xdmf_filename(_filename);
   const boost::filesystem::path parent_path = xdmf_filename.parent_path();
 
-  if (!boost::filesystem::exists(xdmf_filename))
-  {
-    dolfin_error("XDMFFile.cpp",
-                 "open XDMF file",
-                 "XDMF file \"%s\" does not exist", _filename.c_str());
-  }
-
-  // Read XML nodes = parse XML document
-
   // Load XML doc from file
   pugi::xml_document xml_doc;
-  pugi::xml_parse_result result = xml_doc.load_file(_filename.c_str());
-  dolfin_assert(result);
+  load_xml_document(xml_doc);
 
   // Find grid with name equal to the name of function we're about
   // to save and given counter
@@ -1450,6 +2473,14 @@ void XDMFFile::read_checkpoint(Function& u, std::string func_name,
 
   dolfin_assert(grid_node);
 
+  // Read checkpoint written with one piece per process
+  if (std::string(grid_node.attribute("CollectionType").value()) == "Spatial")
+  {
+    read_checkpoint_piece(u, get_piece(_mpi_comm.comm(), grid_node), func_name,
+                          parent_path);
+    return;
+  }
+
   pugi::xml_node fe_attribute_node
     = grid_node.select_node(
       "Attribute[@ItemType=\"FiniteElementFunction\"]"
@@ -1488,6 +2519,40 @@ void XDMFFile::read_checkpoint(Function& u, std::string func_name,
   const Mesh &mesh = *u.function_space()->mesh();
   dolfin_assert(u.function_space()->dofmap());
   const GenericDofMap &dofmap = *u.function_space()->dofmap();
+  GenericVector& x = *u.vector();
+
+  // If the checkpoint was written with the same partition and dof
+  // layout on every process, read the owned slice of the vector
+  // directly
+  pugi::xml_node layout_dataitem
+    = fe_attribute_node.select_node("DataItem[position()=5]").node();
+  if (layout_dataitem)
+  {
+    const std::vector<std::int64_t> layout_shape
+      = get_dataset_shape(layout_dataitem);
+    bool same_layout = layout_shape.size() == 2
+      and layout_shape[0] == (std::int64_t) _mpi_comm.size();
+    if (same_layout)
+    {
+      const std::vector<std::size_t> layout
+        = get_dataset<std::size_t>(_mpi_comm.comm(), layout_dataitem,
+                                   parent_path);
+      same_layout = (layout == checkpoint_layout(mesh, dofmap, x))
+        and x.local_size() > 0;
+    }
+
+    if (MPI::min(_mpi_comm.comm(), (int) same_layout) == 1)
+    {
+      log(PROGRESS, "Reading function vector without redistribution.");
+      const std::pair<std::int64_t, std::int64_t> range = x.local_range();
+      const std::vector<double> values
+        = get_dataset<double>(_mpi_comm.comm(), vector_dataitem, parent_path,
+                              range);
+      x.set_local(values);
+      x.apply("insert");
+      return;
+    }
+  }
 
   // Read cell ordering
   std::vector<std::size_t> cells
@@ -1526,8 +2591,6 @@ void XDMFFile::read_checkpoint(Function& u, std::string func_name,
     = get_dataset<double>(_mpi_comm.comm(), vector_dataitem, parent_path,
                           input_vector_range);
 
-  GenericVector& x = *u.vector();
-
   HDF5Utility::set_local_vector_values(_mpi_comm.comm(), x, mesh, cells,
                                        cell_dofs, x_cell_dofs, vector,
                                        input_vector_range, dofmap);
@@ -1772,7 +2835,8 @@ XDMFFile::build_local_mesh_data(LocalMeshData& local_mesh_data,
 template<typename T>
 void XDMFFile::add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                  hid_t h5_id, const std::string path_prefix,
-                                 const Mesh& mesh, int cell_dim)
+                                 const Mesh& mesh, int cell_dim,
+                                 AsyncWriter::TaskList* tasks)
 {
   // Get number of cells (global) and vertices per cell from mesh
   const std::int64_t num_cells = mesh.topology().size_global(cell_dim);
@@ -1810,12 +2874,13 @@ void XDMFFile::add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
   const std::string number_type = "UInt";
 
   add_data_item(comm, topology_node, h5_id, h5_path,
-                topology_data, shape, number_type);
+                topology_data, shape, number_type, tasks);
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                  hid_t h5_id, const std::string path_prefix,
-                                 const Mesh& mesh)
+                                 const Mesh& mesh,
+                                 AsyncWriter::TaskList* tasks)
 {
   const MeshGeometry& mesh_geometry = mesh.geometry();
   int gdim = mesh_geometry.dim();
@@ -1835,6 +2900,7 @@ void XDMFFile::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
   geometry_node.append_attribute("GeometryType") = geometry_type.c_str();
 
   // Pack geometry data
+  Timer t("XDMF: gather data");
   std::vector<double> x;
   if (degree == 1)
     x = DistributedMeshTools::reorder_vertices_by_global_indices(mesh);
@@ -1851,20 +2917,22 @@ void XDMFFile::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
       _x[2*i] = x[i];
     std::swap(x, _x);
   }
+  t.stop();
 
   // Add geometry DataItem node
   const std::string group_name = path_prefix + "/" + mesh.name();
   const std::string h5_path = group_name + "/geometry";
   const std::vector<std::int64_t> shape = {num_points, gdim};
 
-  add_data_item(comm, geometry_node, h5_id, h5_path, x, shape);
+  add_data_item(comm, geometry_node, h5_id, h5_path, x, shape, "", tasks);
 }
 //-----------------------------------------------------------------------------
 template<typename T>
 void XDMFFile::add_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
                              hid_t h5_id, const std::string h5_path, const T& x,
                              const std::vector<std::int64_t> shape,
-                             const std::string number_type)
+                             const std::string number_type,
+                             AsyncWriter::TaskList* tasks)
 {
 
   log(DBG, "Adding data item to node %s", xml_node.path().c_str());
@@ -1885,6 +2953,7 @@ void XDMFFile::add_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
   // Add format attribute
   if (h5_id < 0)
   {
+    Timer t("XDMF: encode data");
     data_item_node.append_attribute("Format") = "XML";
     dolfin_assert(shape.size() == 2);
     data_item_node.append_child(pugi::node_pcdata)
@@ -1922,16 +2991,33 @@ void XDMFFile::add_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
     const std::pair<std::int64_t, std::int64_t> local_range
       = {offset, offset + local_shape0};
 
-    const bool use_mpi_io = (MPI::size(comm) > 1);
-    HDF5Interface::write_dataset(h5_id, h5_path, x, local_range, shape, use_mpi_io,
-                                 false);
-
-    // Add partitioning attribute to dataset
+    // Compute partitioning attribute of dataset
     std::vector<std::size_t> partitions;
     std::vector<std::size_t> offset_tmp(1, offset);
     MPI::gather(comm, offset_tmp, partitions);
     MPI::broadcast(comm, partitions);
-    HDF5Interface::add_attribute(h5_id, h5_path, "partition", partitions);
+
+    const bool use_mpi_io = (MPI::size(comm) > 1);
+    if (tasks)
+    {
+      // Copy data and defer writing
+      typedef typename T::value_type value_type;
+      std::vector<value_type> data(x.begin(), x.end());
+      tasks->add(std::unique_ptr<AsyncWriter::Task>(
+                   new HDF5DatasetTask<value_type>(h5_id, h5_path,
+                                                   std::move(data),
+                                                   local_range, shape,
+                                                   use_mpi_io, partitions)));
+    }
+    else
+    {
+      Timer t("XDMF: write data");
+      HDF5Interface::write_dataset(h5_id, h5_path, x, local_range, shape,
+                                   use_mpi_io, false);
+
+      // Add partitioning attribute to dataset
+      HDF5Interface::add_attribute(h5_id, h5_path, "partition", partitions);
+    }
 
 #else
     // Should never reach this point
@@ -1942,6 +3028,59 @@ void XDMFFile::add_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
   }
 }
 //----------------------------------------------------------------------------
+void XDMFFile::add_value_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
+                                   hid_t h5_id, const std::string h5_path,
+                                   const std::vector<double>& x,
+                                   const std::vector<std::int64_t> shape,
+                                   AsyncWriter::TaskList* tasks) const
+{
+  const std::string precision = parameters["value_precision"];
+  const std::string compression = parameters["lossy_compression"];
+  if (h5_id < 0 or (precision == "double" and compression == "none"))
+  {
+    add_data_item(comm, xml_node, h5_id, h5_path, x, shape, "", tasks);
+    return;
+  }
+
+#ifdef HAS_HDF5
+  // Replace lossless filters of the file by the lossy filter for
+  // this dataset
+  const HDF5Interface::DatasetOptions file_options
+    = HDF5Interface::get_dataset_options(h5_id);
+  HDF5Interface::DatasetOptions options = file_options;
+  if (compression != "none")
+  {
+    const double tolerance = parameters["lossy_tolerance"];
+    if (tolerance <= 0.0)
+    {
+      dolfin_error("XDMFFile.cpp",
+                   "write function values with lossy compression",
+                   "Tolerance must be positive");
+    }
+    options.compression_level = 0;
+    options.shuffle = false;
+    options.szip = false;
+    options.filter_id = (compression == "zfp") ? 32013 : 32017;
+    options.filter_values = lossy_filter_values(compression, tolerance);
+  }
+  HDF5Interface::set_dataset_options(h5_id, options);
+
+  if (precision == "single")
+  {
+    Timer t("XDMF: encode data");
+    const std::vector<float> x_single(x.begin(), x.end());
+    t.stop();
+    add_data_item(comm, xml_node, h5_id, h5_path, x_single, shape, "Float",
+                  tasks);
+    xml_node.last_child().append_attribute("Precision") = "4";
+  }
+  else
+    add_data_item(comm, xml_node, h5_id, h5_path, x, shape, "", tasks);
+
+  HDF5Interface::set_dataset_options(h5_id, file_options);
+#endif
+}
+//----------------------------------------------------------------------------
 std::set<unsigned int>
 XDMFFile::compute_nonlocal_entities(const Mesh& mesh, int cell_dim)
 {
@@ -1988,6 +3127,8 @@ XDMFFile::compute_nonlocal_entities(const Mesh& mesh, int cell_dim)
 template<typename T>
 std::vector<T> XDMFFile::compute_topology_data(const Mesh& mesh, int cell_dim)
 {
+  Timer t("XDMF: gather data");
+
   // Create vector to store topology data
   const int num_vertices_per_cell = mesh.type().num_vertices(cell_dim);
   std::vector<T> topology_data;
@@ -2060,6 +3201,8 @@ std::vector<T> XDMFFile::compute_topology_data(const Mesh& mesh, int cell_dim)
 template<typename T>
 std::vector<T> XDMFFile::compute_quadratic_topology(const Mesh& mesh)
 {
+  Timer t("XDMF: gather data");
+
   const MeshGeometry& geom = mesh.geometry();
 
   if (geom.degree() != 2 or MPI::size(mesh.mpi_comm()) != 1)
@@ -2078,27 +3221,22 @@ std::vector<T> XDMFFile::compute_quadratic_topology(const Mesh& mesh)
   else
     edge_mapping = {5, 2, 4, 3, 1, 0};
 
-  // Get number of points per cell
-  const CellType& celltype = mesh.type();
-  std::size_t npoint = celltype.num_entities(0) + celltype.num_entities(1);
+  // Get points of each cell (vertices followed by edges)
+  mesh.init_cell_points();
+  const std::size_t num_vertices = mesh.type().num_entities(0);
+  const std::size_t npoint = geom.num_cell_points();
+  dolfin_assert(npoint == num_vertices + edge_mapping.size());
   std::vector<T> topology_data;
   topology_data.reserve(npoint*mesh.size(tdim));
 
   for (CellIterator c(mesh); !c.end(); ++c)
   {
-    // Add indices for vertices and edges
-    for (unsigned int dim = 0; dim != 2; ++dim)
-    {
-      for (unsigned int i = 0; i != celltype.num_entities(dim); ++i)
-      {
-        std::size_t im = (dim == 0) ? i : edge_mapping[i];
-        const std::size_t entity_index
-          = (dim == tdim) ? c->index() : c->entities(dim)[im];
-        const std::size_t local_idx
-          = geom.get_entity_index(dim, 0, entity_index);
-        topology_data.push_back(local_idx);
-      }
-    }
+    // Add indices for vertices and edges, with edges in VTK order
+    const unsigned int* points = geom.cell_points(c->index());
+    for (std::size_t i = 0; i != num_vertices; ++i)
+      topology_data.push_back(points[i]);
+    for (std::size_t i = 0; i != edge_mapping.size(); ++i)
+      topology_data.push_back(points[num_vertices + edge_mapping[i]]);
   }
   return topology_data;
 }
@@ -2106,6 +3244,8 @@ std::vector<T> XDMFFile::compute_quadratic_topology(const Mesh& mesh)
 template<typename T>
 std::vector<T> XDMFFile::compute_value_data(const MeshFunction<T>& meshfunction)
 {
+  Timer t("XDMF: gather data");
+
   // Create vector to store data
   std::vector<T> value_data;
   value_data.reserve(meshfunction.size());
@@ -2410,14 +3550,51 @@ std::array<std::string, 2> XDMFFile::get_hdf5_paths(const pugi::xml_node& datait
   return {{paths[0], paths[1]}};
 }
 //-----------------------------------------------------------------------------
+void XDMFFile::load_xml_document(pugi::xml_document& xml_doc) const
+{
+  // Read file on one process only, so that the file system sees one
+  // open instead of one per process
+  std::vector<char> buffer;
+  if (_mpi_comm.rank() == 0)
+  {
+    std::ifstream file(_filename.c_str(), std::ios::binary);
+    if (file)
+    {
+      buffer.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    }
+  }
+  MPI::broadcast(_mpi_comm.comm(), buffer);
+
+  if (buffer.empty())
+  {
+    dolfin_error("XDMFFile.cpp",
+                 "open XDMF file",
+                 "XDMF file \"%s\" does not exist or is empty",
+                 _filename.c_str());
+  }
+
+  pugi::xml_parse_result result = xml_doc.load_buffer(buffer.data(),
+                                                      buffer.size());
+  if (!result)
+  {
+    dolfin_error("XDMFFile.cpp",
+                 "read XDMF file",
+                 "Unable to parse XDMF file \"%s\" (%s)",
+                 _filename.c_str(), result.description());
+  }
+}
+//-----------------------------------------------------------------------------
 template<typename T>
 void XDMFFile::read_mesh_function(MeshFunction<T>& meshfunction,
                                   std::string name)
 {
+  // Wait for queued output
+  flush();
+
   // Load XML doc from file
   pugi::xml_document xml_doc;
-  pugi::xml_parse_result result = xml_doc.load_file(_filename.c_str());
-  dolfin_assert(result);
+  load_xml_document(xml_doc);
 
   // Get XDMF node
   pugi::xml_node xdmf_node = xml_doc.child("Xdmf");
@@ -2658,10 +3835,21 @@ std::string XDMFFile::get_hdf5_filename(std::string xdmf_filename)
   return p.string();
 }
 //----------------------------------------------------------------------------
+std::string XDMFFile::get_piece_filename(std::string xdmf_filename,
+                                         int piece)
+{
+  boost::filesystem::path p(xdmf_filename);
+  p.replace_extension();
+  return p.string() + "_p" + std::to_string(piece) + ".h5";
+}
+//----------------------------------------------------------------------------
 template<typename T>
 void XDMFFile::write_mesh_function(const MeshFunction<T>& meshfunction,
                                    Encoding encoding)
 {
+  // Wait for queued output
+  flush();
+
   check_encoding(encoding);
 
   if (meshfunction.size() == 0)
@@ -2714,6 +3902,8 @@ void XDMFFile::write_mesh_function(const MeshFunction<T>& meshfunction,
 
     // Get file handle
     h5_id = h5_file->h5_id();
+    HDF5Interface::set_dataset_options(h5_id,
+                                       HDF5File::dataset_options(parameters));
   }
 #endif
 
@@ -2793,7 +3983,10 @@ void XDMFFile::write_mesh_function(const MeshFunction<T>& meshfunction,
 
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
+  {
+    Timer t("XDMF: update XML");
     _xml_doc->save_file(_filename.c_str(), "  ");
+  }
 
   // Increment the counter, so we can save multiple MeshFunctions in one file
   ++_counter;
@@ -2801,6 +3994,8 @@ void XDMFFile::write_mesh_function(const MeshFunction<T>& meshfunction,
 //-----------------------------------------------------------------------------
 std::vector<double> XDMFFile::get_cell_data_values(const Function& u)
 {
+  Timer t("XDMF: gather data");
+
   dolfin_assert(u.function_space()->dofmap());
   dolfin_assert(u.vector());
 
@@ -2878,6 +4073,8 @@ bool XDMFFile::has_cell_centred_data(const Function& u)
 //-----------------------------------------------------------------------------
 std::vector<double> XDMFFile::get_point_data_values(const Function& u)
 {
+  Timer t("XDMF: gather data");
+
   const auto mesh = u.function_space()->mesh();
 
   std::vector<double> data_values;
@@ -2917,6 +4114,8 @@ std::vector<double> XDMFFile::get_point_data_values(const Function& u)
 //-----------------------------------------------------------------------------
 std::vector<double> XDMFFile::get_p2_data_values(const Function& u)
 {
+  Timer t("XDMF: gather data");
+
   const auto mesh = u.function_space()->mesh();
   dolfin_assert(mesh->geometry().degree() == 2);
 
@@ -3144,3 +4343,33 @@ std::string XDMFFile::rank_to_string(std::size_t value_rank)
   return "Tensor";
 }
 //-----------------------------------------------------------------------------
+bool XDMFFile::async_output_supported()
+{
+  // The background thread makes collective MPI-IO and HDF5 calls
+  // while the calling thread continues to use MPI and HDF5
+  std::string reason;
+#ifdef HAS_MPI
+  const int provided = SubSystemsManager::mpi_thread_level();
+  if (provided != -1 and provided < MPI_THREAD_MULTIPLE)
+    reason = "MPI does not provide MPI_THREAD_MULTIPLE";
+#endif
+#ifdef HAS_HDF5
+  hbool_t threadsafe = 0;
+  if (H5is_library_threadsafe(&threadsafe) < 0 or !threadsafe)
+    reason = "HDF5 is not thread safe";
+#endif
+
+  if (reason.empty())
+    return true;
+
+  // Warn once
+  static bool warning_issued = false;
+  if (!warning_issued)
+  {
+    warning("Parameter \"async_output\" of XDMFFile is ignored since %s. "
+            "Writing output synchronously", reason.c_str());
+    warning_issued = true;
+  }
+  return false;
+}
+//-----------------------------------------------------------------------------
@@ -21,8 +21,10 @@
 #define __DOLFIN_XDMFFILE_H
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -34,7 +36,9 @@ typedef int hid_t;
 
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/Variable.h>
+#include <dolfin/geometry/Point.h>
 #include <dolfin/mesh/CellType.h>
+#include "AsyncWriter.h"
 
 namespace boost
 {
@@ -54,6 +58,7 @@ namespace dolfin
 {
 
   // Forward declarations
+  class Form;
   class Function;
 #ifdef HAS_HDF5
   class HDF5File;
@@ -62,7 +67,6 @@ namespace dolfin
   class Mesh;
   template<typename T> class MeshFunction;
   template<typename T> class MeshValueCollection;
-  class Point;
 
   /// Read and write Mesh, Function, MeshFunction and other objects in XDMF
 
@@ -112,10 +116,34 @@ namespace dolfin
     /// The file is automatically closed at the end of the with block
     void close();
 
+    /// Wait until all queued asynchronous output has been written
+    ///
+    /// If the parameter "async_output" is true, time series output
+    /// of Functions (write(u, t)) returns once the data has been
+    /// gathered, and the HDF5 datasets and XML file are written by a
+    /// background thread. At most "async_queue_size" time steps are
+    /// queued; further calls block until a queued step has been
+    /// written. All other functions of this class, and close(), wait
+    /// for queued output first. Since the background thread makes
+    /// MPI and HDF5 calls, asynchronous output requires MPI to
+    /// provide MPI_THREAD_MULTIPLE (the default "mpi_thread_level")
+    /// and a thread-safe HDF5 library; otherwise a warning is issued
+    /// and output is written synchronously. Call flush() before
+    /// accessing other HDF5 files while output is pending.
+    void flush();
+
     /// Save a mesh to XDMF format, either using an associated HDF5
     /// file, or storing the data inline as XML Create function on
     /// given function space
     ///
+    /// If the parameter "file_per_process" is true (HDF5 encoding
+    /// only), each process writes the cells it owns and their
+    /// vertices to its own HDF5 file <name>_p<rank>.h5, without any
+    /// collective (MPI-IO) HDF5 calls, and the XDMF file describes
+    /// the mesh as a spatial collection of the pieces. The mesh can
+    /// be read back with the same number of processes, each process
+    /// reading its own piece.
+    ///
     /// @param    mesh (_Mesh_)
     ///         A mesh to save.
     /// @param    encoding (_Encoding_)
@@ -144,6 +172,13 @@ namespace dolfin
     /// @param    encoding (_Encoding_)
     ///         Encoding to use: HDF5 or ASCII
     ///
+    /// If the parameter "file_per_process" is true (HDF5 encoding
+    /// only), each process writes its piece of the mesh and the
+    /// values of the function on its cells to its own HDF5 file (see
+    /// write(const Mesh&)). Such a checkpoint can be read with the
+    /// same number of processes into a function on the mesh read
+    /// from the same file.
+    ///
     void write_checkpoint(const Function& u,
                           std::string function_name,
                           double time_step = 0.0,
@@ -152,6 +187,20 @@ namespace dolfin
     /// Save a Function to XDMF file for visualisation, using an
     /// associated HDF5 file, or storing the data inline as XML.
     ///
+    /// With HDF5 encoding, the Function values (but not the mesh)
+    /// can be written with reduced accuracy to reduce the output
+    /// size, controlled by the parameters
+    ///
+    /// * value_precision (default "double"):
+    ///   "single" writes the values as 32-bit floats.
+    ///
+    /// * lossy_compression (default "none"):
+    ///   "zfp" or "sz" compresses the values with the ZFP or SZ HDF5
+    ///   filter plugin (which must be found in HDF5_PLUGIN_PATH),
+    ///   with an absolute error of at most lossy_tolerance (default
+    ///   1e-6). The lossless filters of the file are not applied to
+    ///   the values.
+    ///
     /// @param    u (_Function_)
     ///         A function to save.
     /// @param    encoding (_Encoding_)
@@ -176,6 +225,29 @@ namespace dolfin
     ///   the same mesh. If true the files created will be smaller and
     ///   also behave better in Paraview, at least in version 5.3.0
     ///
+    /// * incremental_xml (default true):
+    ///   Controls whether only the XML of the latest time step is
+    ///   written to the end of the file, instead of rewriting the
+    ///   whole document at every step. A shared mesh is only looked
+    ///   up at the latest time step in this mode.
+    ///
+    /// * decimation (default 1):
+    ///   Write the Function only at every k-th call for the same
+    ///   Function name. Reductions are computed at every call.
+    ///
+    /// * statistics (default false):
+    ///   Compute the min, max, l2 and linf norms of the Function
+    ///   vector at every call.
+    ///
+    /// The parameters value_precision, lossy_compression and
+    /// lossy_tolerance apply as for write(const Function&).
+    ///
+    /// Statistics, probes (see add_probe) and functionals (see
+    /// add_functional) are computed in parallel and written by
+    /// process 0 to a table "<name>_reductions.csv" next to the XDMF
+    /// file, with one row per value and columns function, step,
+    /// time, quantity and value.
+    ///
     /// @param    u (_Function_)
     ///         A function to save.
     /// @param    t (_double_)
@@ -186,6 +258,32 @@ namespace dolfin
     void write(const Function& u, double t,
                Encoding encoding=default_encoding);
 
+    /// Add a point probe. Every Function written with write(u, t) is
+    /// evaluated at the point, and the value (or each component,
+    /// suffixed by _i) written to the reductions table. The value is
+    /// NaN if the point is outside the mesh.
+    ///
+    /// @param    name (_std::string_)
+    ///         Name of the probe in the reductions table
+    /// @param    point (_Point_)
+    ///         Point to evaluate at
+    ///
+    void add_probe(std::string name, const Point& point);
+
+    /// Add a functional, assembled whenever u is written with
+    /// write(u, t) and written to the reductions table. Typical
+    /// functionals are integrals of u over (sub)domains.
+    ///
+    /// @param    u (_Function_)
+    ///         The Function the functional is evaluated for
+    /// @param    name (_std::string_)
+    ///         Name of the functional in the reductions table
+    /// @param    functional (_Form_)
+    ///         Rank 0 form
+    ///
+    void add_functional(const Function& u, std::string name,
+                        std::shared_ptr<const Form> functional);
+
     /// Save MeshFunction to file using an associated HDF5 file, or
     /// storing the data inline as XML.
     ///
@@ -433,7 +531,51 @@ namespace dolfin
     // write data
     static void add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
                          hid_t h5_id, const Mesh& mesh,
-                         const std::string path_prefix);
+                         const std::string path_prefix,
+                         AsyncWriter::TaskList* tasks=NULL);
+
+    // Write mesh as one piece per process (parameter
+    // "file_per_process")
+    void write_pieces(const Mesh& mesh);
+
+    // Write checkpoint as one piece per process (parameter
+    // "file_per_process")
+    void write_checkpoint_pieces(const Function& u, std::string function_name,
+                                 double time_step);
+
+    // Add Grid of the cells owned by this process to xml_node and
+    // write data to the (process local) HDF5 file h5_id. Returns the
+    // Grid node.
+    static pugi::xml_node add_mesh_piece(pugi::xml_node& xml_node,
+                                         hid_t h5_id, const Mesh& mesh,
+                                         const std::string path_prefix);
+
+    // Add values of function on the cells owned by this process to
+    // the Grid node of a piece
+    static void add_function_piece(pugi::xml_node& xml_node, hid_t h5_id,
+                                   std::string h5_path, const Function& u,
+                                   std::string function_name);
+
+    // Append the pieces (children of piece_doc) of all processes to
+    // xml_node on process 0
+    static void gather_pieces(MPI_Comm comm, pugi::xml_node& xml_node,
+                              const pugi::xml_document& piece_doc);
+
+    // Return Grid node of the piece of this process in a spatial
+    // collection, checking that the number of pieces matches the
+    // number of processes
+    static pugi::xml_node get_piece(MPI_Comm comm,
+                                    const pugi::xml_node& collection_node);
+
+    // Build mesh from the piece of each process
+    void read_pieces(Mesh& mesh, const pugi::xml_node& piece_node,
+                     const boost::filesystem::path& parent_path) const;
+
+    // Read function values from the piece of this process
+    static void read_checkpoint_piece(Function& u,
+                                      const pugi::xml_node& piece_node,
+                                      std::string function_name,
+                                      const boost::filesystem::path& parent_path);
 
     // Add function to a XML node
     static void add_function(MPI_Comm comm, pugi::xml_node& xml_node,
@@ -450,22 +592,37 @@ namespace dolfin
     template<typename T>
     static void add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                   hid_t h5_id, const std::string path_prefix,
-                                  const Mesh& mesh, int tdim);
+                                  const Mesh& mesh, int tdim,
+                                  AsyncWriter::TaskList* tasks=NULL);
 
     // Add geometry node and data to xml_node
     static void add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                   hid_t h5_id, const std::string path_prefix,
-                                  const Mesh& mesh);
+                                  const Mesh& mesh,
+                                  AsyncWriter::TaskList* tasks=NULL);
 
     // Add DataItem node to an XML node. If HDF5 is open (h5_id > 0)
     // the data is written to the HDFF5 file with the path
     // 'h5_path'. Otherwise, data is witten to the XML node and
-    // 'h5_path' is ignored
+    // 'h5_path' is ignored. If tasks is not NULL, a copy of the data
+    // is added to the task list and written to HDF5 when the tasks
+    // are executed.
     template<typename T>
     static void add_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
                               hid_t h5_id, const std::string h5_path, const T& x,
                               const std::vector<std::int64_t> dimensions,
-                              const std::string number_type="");
+                              const std::string number_type="",
+                              AsyncWriter::TaskList* tasks=NULL);
+
+    // Add DataItem node of Function values for visualisation, written
+    // with the precision and lossy compression given by the
+    // parameters "value_precision", "lossy_compression" and
+    // "lossy_tolerance"
+    void add_value_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
+                             hid_t h5_id, const std::string h5_path,
+                             const std::vector<double>& x,
+                             const std::vector<std::int64_t> shape,
+                             AsyncWriter::TaskList* tasks=NULL) const;
 
     // Calculate set of entities of dimension cell_dim which are
     // duplicated on other processes and should not be output on this
@@ -485,6 +642,10 @@ namespace dolfin
     template<typename T>
     std::vector<T> compute_value_data(const MeshFunction<T>& meshfunction);
 
+    // Load the XML document of the file (collective). The file is
+    // read by one process and broadcast to the others.
+    void load_xml_document(pugi::xml_document& xml_doc) const;
+
     // Get DOLFIN cell type string from XML topology node
     static std::pair<std::string, int>
       get_cell_type(const pugi::xml_node& topology_node);
@@ -509,6 +670,10 @@ namespace dolfin
 
     static std::string get_hdf5_filename(std::string xdmf_filename);
 
+    // Return name of HDF5 file of a piece in "file_per_process" mode
+    static std::string get_piece_filename(std::string xdmf_filename,
+                                          int piece);
+
     // Generic MeshFunction reader
     template<typename T>
     void read_mesh_function(MeshFunction<T>& meshfunction, std::string name="");
@@ -563,6 +728,10 @@ namespace dolfin
     // Vector, Tensor)
     static std::string rank_to_string(std::size_t value_rank);
 
+    // Compute statistics, probes and functionals of u at step and
+    // append them to the reductions table
+    void write_reductions(const Function& u, double t, std::size_t step);
+
     // MPI communicator
     dolfin::MPI::Comm _mpi_comm;
 
@@ -577,10 +746,38 @@ namespace dolfin
     // Counter for time series
     std::size_t _counter;
 
+    // Background writer for asynchronous output (created on first
+    // use)
+    std::unique_ptr<AsyncWriter> _async_writer;
+
+    // Return true if output can be written by a background thread
+    // (MPI provides MPI_THREAD_MULTIPLE and HDF5 is thread safe),
+    // otherwise warn (once)
+    static bool async_output_supported();
+
     // The XML document currently representing the XDMF
     // which needs to be kept open for time series etc.
     std::unique_ptr<pugi::xml_document> _xml_doc;
 
+    // Position and size in the XML file of the last time step written
+    // by write(Function, t) (offset -1 if the file must be rewritten)
+    std::int64_t _xml_step_offset;
+    std::size_t _xml_step_size;
+
+    // Point probes (name, point)
+    std::vector<std::pair<std::string, Point>> _probes;
+
+    // Functionals (Function id, name, form)
+    std::vector<std::tuple<std::size_t, std::string,
+                           std::shared_ptr<const Form>>> _functionals;
+
+    // Number of calls to write(u, t) for each Function name
+    std::map<std::string, std::size_t> _num_steps;
+
+    // True once the reductions table has been truncated and its
+    // header written
+    bool _reductions_started;
+
   };
 
 #ifndef DOXYGEN_IGNORE
@@ -590,13 +787,15 @@ namespace dolfin
                                hid_t h5_id, const std::string h5_path,
                                const std::vector<bool>& x,
                                const std::vector<std::int64_t> shape,
-                               const std::string number_type)
+                               const std::string number_type,
+                               AsyncWriter::TaskList* tasks)
   {
     // HDF5 cannot accept 'bool' so copy to 'int'
     std::vector<int> x_int(x.size());
     for (std::size_t i = 0; i < x.size(); ++i)
       x_int[i] = (int)x[i];
-    add_data_item(comm, xml_node, h5_id, h5_path, x_int, shape, number_type);
+    add_data_item(comm, xml_node, h5_id, h5_path, x_int, shape, number_type,
+                  tasks);
   }
 #endif
 
@@ -27,6 +27,7 @@
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/file.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 
 #include "pugixml.hpp"
@@ -75,39 +76,49 @@ XMLFile::~XMLFile()
 //-----------------------------------------------------------------------------
 void XMLFile::read(Mesh& input_mesh)
 {
-  if (MPI::rank(input_mesh.mpi_comm()) == 0)
-  {
-    // Create XML doc and get DOLFIN node
-    pugi::xml_document xml_doc;
-    load_xml_doc(xml_doc);
-    pugi::xml_node dolfin_node = get_dolfin_xml_node(xml_doc);
-
-    // Read mesh
-    XMLMesh::read(input_mesh, dolfin_node);
-  }
-
   if (MPI::size(input_mesh.mpi_comm()) > 1)
   {
-    // Distribute local data
+    // Stream file on the main process straight into distributed
+    // local mesh data, without building a document tree or a serial
+    // mesh
     input_mesh.domains().clear();
-    LocalMeshData local_mesh_data(input_mesh);
-
-    // FIXME: To be removed when advanced parallel XML IO is removed
-    // Add mesh domain data
+    LocalMeshData local_mesh_data(input_mesh.mpi_comm());
+    boost::iostreams::filtering_istream xml_stream;
     if (MPI::rank(input_mesh.mpi_comm()) == 0)
     {
-      // Create XML doc and get DOLFIN node
-      pugi::xml_document xml_doc;
-      load_xml_doc(xml_doc);
-      pugi::xml_node dolfin_node = get_dolfin_xml_node(xml_doc);
-      XMLMesh::read_domain_data(local_mesh_data, dolfin_node);
+      // Check that file exists
+      if (!boost::filesystem::is_regular_file(_filename))
+      {
+        dolfin_error("XMLFile.cpp",
+                     "read data from XML file",
+                     "Unable to open file \"%s\"", _filename.c_str());
+      }
+
+      // Decompress while reading if necessary
+      const boost::filesystem::path path(_filename);
+      if (boost::filesystem::extension(path) == ".gz")
+        xml_stream.push(boost::iostreams::gzip_decompressor());
+      xml_stream.push(boost::iostreams::file_source(_filename,
+                                                    std::ios_base::in
+                                                    |std::ios_base::binary));
     }
+    XMLMesh::read(local_mesh_data, xml_stream);
 
     // Partition and build mesh
     const std::string ghost_mode = dolfin::parameters["ghost_mode"];
     MeshPartitioning::build_distributed_mesh(input_mesh, local_mesh_data,
                                              ghost_mode);
   }
+  else
+  {
+    // Create XML doc and get DOLFIN node
+    pugi::xml_document xml_doc;
+    load_xml_doc(xml_doc);
+    pugi::xml_node dolfin_node = get_dolfin_xml_node(xml_doc);
+
+    // Read mesh
+    XMLMesh::read(input_mesh, dolfin_node);
+  }
 }
 //-----------------------------------------------------------------------------
 void XMLFile::write(const Mesh& output_mesh)
@@ -20,11 +20,14 @@
 // First added:  2002-12-06
 // Last changed: 2014-02-06
 
+#include <cstdlib>
 #include <map>
 #include <memory>
 #include <iomanip>
 #include <iostream>
+#include <streambuf>
 #include <string>
+#include <utility>
 #include <vector>
 #include <boost/format.hpp>
 
@@ -32,6 +35,7 @@
 
 #include "dolfin/common/MPI.h"
 #include "dolfin/common/NoDeleter.h"
+#include "dolfin/common/Timer.h"
 #include "dolfin/geometry/Point.h"
 #include "dolfin/la/GenericVector.h"
 #include "dolfin/mesh/Cell.h"
@@ -48,6 +52,220 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Pull parser for DOLFIN XML mesh files. It returns one element at
+  // a time, reading the stream sequentially without building a
+  // document tree, so memory use does not depend on the file size.
+  // Only what the mesh format needs is supported: comments,
+  // declarations and text content are skipped and attribute values
+  // are not entity-decoded.
+  class XMLMeshStreamParser
+  {
+  public:
+
+    enum Event { start_element, end_element, empty_element, end_document };
+
+    explicit XMLMeshStreamParser(std::istream& xml_stream)
+      : _buffer(*xml_stream.rdbuf()), _num_attributes(0) {}
+
+    // Read next event
+    Event next()
+    {
+      typedef std::streambuf::traits_type traits;
+      while (true)
+      {
+        // Skip to start of next tag
+        int c = _buffer.sbumpc();
+        while (c != traits::eof() && c != '<')
+          c = _buffer.sbumpc();
+        if (c == traits::eof())
+          return end_document;
+
+        c = _buffer.sgetc();
+        if (c == '?' || c == '!')
+        {
+          // Skip declaration, comment or doctype
+          skip_markup();
+          continue;
+        }
+
+        _num_attributes = 0;
+        if (c == '/')
+        {
+          _buffer.sbumpc();
+          read_token(_name);
+          skip_to('>');
+          return end_element;
+        }
+
+        // Read element name and attributes
+        read_token(_name);
+        while (true)
+        {
+          c = skip_whitespace();
+          if (c == '>')
+          {
+            _buffer.sbumpc();
+            return start_element;
+          }
+          else if (c == '/')
+          {
+            skip_to('>');
+            return empty_element;
+          }
+          else if (c == traits::eof())
+            error("Unexpected end of file in element <%s>", _name.c_str());
+
+          if (_num_attributes == _attributes.size())
+            _attributes.push_back(std::make_pair(std::string(),
+                                                 std::string()));
+          std::pair<std::string, std::string>& attribute
+            = _attributes[_num_attributes++];
+          read_token(attribute.first);
+          if (skip_whitespace() != '=')
+            error("Expected '=' after attribute \"%s\"",
+                  attribute.first.c_str());
+          _buffer.sbumpc();
+
+          const int quote = skip_whitespace();
+          if (quote != '"' && quote != '\'')
+            error("Expected quoted value for attribute \"%s\"",
+                  attribute.first.c_str());
+          _buffer.sbumpc();
+          attribute.second.clear();
+          for (c = _buffer.sbumpc(); c != quote; c = _buffer.sbumpc())
+          {
+            if (c == traits::eof())
+              error("Unexpected end of file in element <%s>", _name.c_str());
+            attribute.second.push_back(c);
+          }
+        }
+      }
+    }
+
+    // Read next start or empty element, skipping end elements
+    void next_element(const std::string& name)
+    {
+      Event event = next();
+      while (event == end_element)
+        event = next();
+      if (event == end_document)
+        error("Unexpected end of file, expecting <%s>", name.c_str());
+      if (_name != name)
+        error("Expecting XML node <%s> but got <%s>", name.c_str(),
+              _name.c_str());
+    }
+
+    // Read until start of given element
+    void find_element(const std::string& name)
+    {
+      Event event = next();
+      while (event != end_document
+             && !(event != end_element && _name == name))
+      {
+        event = next();
+      }
+      if (event == end_document)
+        error("Unable to find XML node <%s>", name.c_str());
+    }
+
+    // Name of current element
+    const std::string& name() const
+    { return _name; }
+
+    // Value of attribute of current element
+    const std::string& attribute(const std::string& name) const
+    {
+      for (std::size_t i = 0; i < _num_attributes; ++i)
+      {
+        if (_attributes[i].first == name)
+          return _attributes[i].second;
+      }
+      error("Missing attribute \"%s\" in XML node <%s>", name.c_str(),
+            _name.c_str());
+      return _attributes[0].second;
+    }
+
+    // Value of attribute of current element as unsigned integer
+    std::size_t attribute_uint(const std::string& name) const
+    { return std::strtoull(attribute(name).c_str(), nullptr, 10); }
+
+    // Value of attribute of current element as double
+    double attribute_double(const std::string& name) const
+    { return std::strtod(attribute(name).c_str(), nullptr); }
+
+  private:
+
+    int skip_whitespace()
+    {
+      int c = _buffer.sgetc();
+      while (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+        c = _buffer.snextc();
+      return c;
+    }
+
+    void skip_to(char end)
+    {
+      int c = _buffer.sbumpc();
+      while (c != end && c != std::streambuf::traits_type::eof())
+        c = _buffer.sbumpc();
+    }
+
+    void skip_markup()
+    {
+      // Comments may contain '>', so look for "-->"
+      _buffer.sbumpc();
+      if (_buffer.sgetc() != '-')
+      {
+        skip_to('>');
+        return;
+      }
+      int dashes = 0;
+      for (int c = _buffer.sbumpc(); c != std::streambuf::traits_type::eof();
+           c = _buffer.sbumpc())
+      {
+        if (c == '>' && dashes >= 2)
+          return;
+        dashes = (c == '-') ? dashes + 1 : 0;
+      }
+    }
+
+    void read_token(std::string& token)
+    {
+      token.clear();
+      int c = _buffer.sgetc();
+      while (c != std::streambuf::traits_type::eof() && c != ' '
+             && c != '\t' && c != '\n' && c != '\r' && c != '='
+             && c != '/' && c != '>')
+      {
+        token.push_back(c);
+        c = _buffer.snextc();
+      }
+    }
+
+    template<typename... Args>
+    static void error(const char* msg, Args... args)
+    {
+      dolfin_error("XMLMesh.cpp",
+                   "read mesh from XML stream",
+                   msg, args...);
+    }
+
+    // Stream buffer being parsed
+    std::streambuf& _buffer;
+
+    // Name of current element
+    std::string _name;
+
+    // Attributes of current element (storage is reused between
+    // elements)
+    std::vector<std::pair<std::string, std::string>> _attributes;
+    std::size_t _num_attributes;
+
+  };
+}
+
 //-----------------------------------------------------------------------------
 void XMLMesh::read(Mesh& mesh, const pugi::xml_node xml_dolfin)
 {
@@ -70,6 +288,169 @@ void XMLMesh::read(Mesh& mesh, const pugi::xml_node xml_dolfin)
   read_domains(mesh.domains(), mesh, mesh_node);
 }
 //-----------------------------------------------------------------------------
+void XMLMesh::read(LocalMeshData& mesh_data, std::istream& xml_stream)
+{
+  Timer timer("Read mesh from XML stream");
+
+  const MPI_Comm mpi_comm = mesh_data.mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  const bool root = MPI::is_broadcaster(mpi_comm);
+  mesh_data.clear();
+
+  std::unique_ptr<XMLMeshStreamParser> parser;
+  if (root)
+    parser.reset(new XMLMeshStreamParser(xml_stream));
+
+  // Read cell type, geometric dimension and number of vertices
+  std::string cell_type_str;
+  std::vector<std::int64_t> header;
+  if (root)
+  {
+    parser->find_element("dolfin");
+    parser->find_element("mesh");
+    cell_type_str = parser->attribute("celltype");
+    std::unique_ptr<CellType> cell_type(CellType::create(cell_type_str));
+    header.push_back(parser->attribute_uint("dim"));
+    header.push_back(cell_type->dim());
+    parser->find_element("vertices");
+    header.push_back(parser->attribute_uint("size"));
+    header.push_back(cell_type->num_vertices());
+    header.push_back(cell_type->cell_type());
+  }
+  MPI::broadcast(mpi_comm, header);
+  dolfin_assert(header.size() == 5);
+  mesh_data.geometry.dim = header[0];
+  mesh_data.topology.dim = header[1];
+  mesh_data.geometry.num_global_vertices = header[2];
+  mesh_data.topology.num_vertices_per_cell = header[3];
+  mesh_data.topology.cell_type = (CellType::Type) header[4];
+
+  const std::size_t gdim = mesh_data.geometry.dim;
+  const std::vector<std::string> x_str = {"x", "y", "z"};
+
+  // Read vertices, one process range at a time, and send each range
+  // to its owner as soon as it has been parsed
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    std::vector<std::vector<double>> send_coordinates(num_processes);
+    std::vector<std::vector<std::int64_t>> send_indices(num_processes);
+    if (root)
+    {
+      const std::pair<std::int64_t, std::int64_t> range
+        = MPI::local_range(mpi_comm, p,
+                           mesh_data.geometry.num_global_vertices);
+      send_coordinates[p].reserve(gdim*(range.second - range.first));
+      send_indices[p].reserve(range.second - range.first);
+      for (std::int64_t i = range.first; i < range.second; ++i)
+      {
+        parser->next_element("vertex");
+        send_indices[p].push_back(parser->attribute_uint("index"));
+        for (std::size_t j = 0; j < gdim; ++j)
+          send_coordinates[p].push_back(parser->attribute_double(x_str[j]));
+      }
+    }
+
+    std::vector<double> coordinates;
+    std::vector<std::int64_t> indices;
+    MPI::scatter(mpi_comm, send_coordinates, coordinates);
+    MPI::scatter(mpi_comm, send_indices, indices);
+    if (p == MPI::rank(mpi_comm))
+    {
+      mesh_data.geometry.unpack_vertex_coordinates(coordinates);
+      mesh_data.geometry.vertex_indices = indices;
+    }
+  }
+
+  // Read number of cells
+  if (root)
+  {
+    parser->find_element("cells");
+    mesh_data.topology.num_global_cells = parser->attribute_uint("size");
+  }
+  MPI::broadcast(mpi_comm, mesh_data.topology.num_global_cells);
+
+  // Create list of vertex index attribute names
+  const std::size_t num_vertices_per_cell
+    = mesh_data.topology.num_vertices_per_cell;
+  std::vector<std::string> v_str(num_vertices_per_cell);
+  for (std::size_t i = 0; i < num_vertices_per_cell; ++i)
+    v_str[i] = "v" + std::to_string(i);
+
+  // Read cells (global index followed by vertices), one process
+  // range at a time
+  for (std::size_t p = 0; p < num_processes; ++p)
+  {
+    std::vector<std::vector<std::int64_t>> send_cells(num_processes);
+    if (root)
+    {
+      const std::pair<std::int64_t, std::int64_t> range
+        = MPI::local_range(mpi_comm, p, mesh_data.topology.num_global_cells);
+      send_cells[p].reserve((num_vertices_per_cell + 1)
+                            *(range.second - range.first));
+      for (std::int64_t i = range.first; i < range.second; ++i)
+      {
+        parser->next_element(cell_type_str);
+        send_cells[p].push_back(parser->attribute_uint("index"));
+        for (std::size_t j = 0; j < num_vertices_per_cell; ++j)
+          send_cells[p].push_back(parser->attribute_uint(v_str[j]));
+      }
+    }
+
+    std::vector<std::int64_t> cells;
+    MPI::scatter(mpi_comm, send_cells, cells);
+    if (p == MPI::rank(mpi_comm))
+      mesh_data.topology.unpack_cell_vertices(cells);
+  }
+
+  // Read mesh domains (if any) on the main process. Mesh data is not
+  // read.
+  if (root)
+  {
+    bool in_domains = false;
+    std::vector<std::pair<std::pair<std::size_t, std::size_t>,
+                          std::size_t>>* domain_data = nullptr;
+    XMLMeshStreamParser::Event event = parser->next();
+    while (event != XMLMeshStreamParser::end_document
+           && !(event == XMLMeshStreamParser::end_element
+                && parser->name() == "mesh"))
+    {
+      const std::string& name = parser->name();
+      if (event == XMLMeshStreamParser::end_element)
+      {
+        if (name == "domains")
+          in_domains = false;
+        else if (name == "mesh_value_collection")
+          domain_data = nullptr;
+      }
+      else if (name == "domains")
+        in_domains = (event == XMLMeshStreamParser::start_element);
+      else if (in_domains && name == "mesh_value_collection")
+      {
+        // Check that the type is uint
+        const std::string type = parser->attribute("type");
+        if (type != "uint")
+        {
+          dolfin_error("XMLMesh.cpp",
+                       "read mesh domains from XML file",
+                       "Mesh domains must be marked as uint, not %s",
+                       type.c_str());
+        }
+        const std::size_t dim = parser->attribute_uint("dim");
+        domain_data = &mesh_data.domain_data[dim];
+        if (event == XMLMeshStreamParser::empty_element)
+          domain_data = nullptr;
+      }
+      else if (domain_data && name == "value")
+      {
+        domain_data->push_back({{parser->attribute_uint("cell_index"),
+                                 parser->attribute_uint("local_entity")},
+                                parser->attribute_uint("value")});
+      }
+      event = parser->next();
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 void XMLMesh::write(const Mesh& mesh, pugi::xml_node xml_node)
 {
   // Add mesh node
@@ -292,29 +673,28 @@ void XMLMesh::read_domains(MeshDomains& domains, const Mesh& mesh,
     XMLMeshValueCollection::read(mvc, type, *it);
 
     // Get mesh value collection data
-    const std::map<std::pair<std::size_t, std::size_t>, std::size_t>&
-      values = mvc.values();
+    const std::vector<std::pair<std::size_t, std::size_t>>& entities
+      = mvc.entities();
+    const std::vector<std::size_t>& values = mvc.entity_values();
 
     // Get mesh domain data and fill
     std::map<std::size_t, std::size_t>& markers
       = domains.markers(dim);
-    std::map<std::pair<std::size_t, std::size_t>,
-             std::size_t>::const_iterator entry;
     if (dim != mesh.topology().dim())
     {
-      for (entry = values.begin(); entry != values.end(); ++entry)
+      for (std::size_t i = 0; i < entities.size(); ++i)
       {
-        const Cell cell(mesh, entry->first.first);
+        const Cell cell(mesh, entities[i].first);
         const std::size_t entity_index
-          = cell.entities(dim)[entry->first.second];
-        markers[entity_index] = entry->second;
+          = cell.entities(dim)[entities[i].second];
+        markers[entity_index] = values[i];
       }
     }
     else
     {
-      // Special case for cells
-      for (entry = values.begin(); entry != values.end(); ++entry)
-        markers[entry->first.first] = entry->second;
+      // Special case for cells (sorted by cell index)
+      for (std::size_t i = 0; i < entities.size(); ++i)
+        markers.insert(markers.end(), {entities[i].first, values[i]});
     }
   }
 }
@@ -23,6 +23,7 @@
 #ifndef __XML_MESH_H
 #define __XML_MESH_H
 
+#include <istream>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -49,6 +50,15 @@ namespace dolfin
     /// Read mesh from XML
     static void read(Mesh& mesh, const pugi::xml_node mesh_node);
 
+    /// Read mesh from an XML stream into local mesh data. The stream
+    /// is parsed sequentially on the main process, without building
+    /// a document tree, and each process range of vertices and cells
+    /// is sent to its owner as soon as it has been read. Mesh domains
+    /// are read on the main process; mesh data is ignored. Collective
+    /// on the communicator of mesh_data; xml_stream is only read on
+    /// the main process.
+    static void read(LocalMeshData& mesh_data, std::istream& xml_stream);
+
     /// Write mesh to XML
     static void write(const Mesh& mesh, pugi::xml_node mesh_node);
 
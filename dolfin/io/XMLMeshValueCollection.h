@@ -95,7 +95,7 @@ namespace dolfin
         const std::size_t local_entity
           = it->attribute("local_entity").as_uint();
         const std::size_t value = it->attribute("value").as_uint();
-        mesh_value_collection.set_value(cell_index, local_entity, value);
+        mesh_value_collection.append(cell_index, local_entity, value);
       }
     }
     else if (type == "int")
@@ -107,7 +107,7 @@ namespace dolfin
         const std::size_t local_entity
           = it->attribute("local_entity").as_uint();
         const int value = it->attribute("value").as_int();
-        mesh_value_collection.set_value(cell_index, local_entity, value);
+        mesh_value_collection.append(cell_index, local_entity, value);
       }
     }
     else if (type == "double")
@@ -119,7 +119,7 @@ namespace dolfin
         const std::size_t local_entity
           = it->attribute("local_entity").as_uint();
         const double value = it->attribute("value").as_double();
-        mesh_value_collection.set_value(cell_index, local_entity, value);
+        mesh_value_collection.append(cell_index, local_entity, value);
       }
     }
     else if (type == "bool")
@@ -131,7 +131,7 @@ namespace dolfin
         const std::size_t local_entity
           = it->attribute("local_entity").as_uint();
         const bool value = it->attribute("value").as_bool();
-        mesh_value_collection.set_value(cell_index, local_entity, value);
+        mesh_value_collection.append(cell_index, local_entity, value);
       }
     }
     else
@@ -140,6 +140,9 @@ namespace dolfin
                    "read mesh value collection from XML file",
                    "Unhandled value type \"%s\"", type.c_str());
     }
+
+    // Sort values and remove duplicates
+    mesh_value_collection.finalize();
   }
   //---------------------------------------------------------------------------
   template<typename T>
@@ -160,19 +163,18 @@ namespace dolfin
       = (unsigned int) mesh_value_collection.size();
 
     // Add data
-    const std::map<std::pair<std::size_t, std::size_t>, T>&
-      values = mesh_value_collection.values();
-    typename std::map<std::pair<std::size_t,
-      std::size_t>, T>::const_iterator it;
-    for (it = values.begin(); it != values.end(); ++it)
+    const std::vector<std::pair<std::size_t, std::size_t>>& entities
+      = mesh_value_collection.entities();
+    const std::vector<T>& values = mesh_value_collection.entity_values();
+    for (std::size_t i = 0; i < entities.size(); ++i)
     {
       pugi::xml_node entity_node = mf_node.append_child("value");
       entity_node.append_attribute("cell_index")
-        = (unsigned int) it->first.first;
+        = (unsigned int) entities[i].first;
       entity_node.append_attribute("local_entity")
-        = (unsigned int) it->first.second;
+        = (unsigned int) entities[i].second;
       entity_node.append_attribute("value")
-        = std::to_string(it->second).c_str();
+        = std::to_string(values[i]).c_str();
     }
   }
   //---------------------------------------------------------------------------
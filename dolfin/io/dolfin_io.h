@@ -8,6 +8,8 @@
 #include <dolfin/io/XDMFFile.h>
 #include <dolfin/io/HDF5File.h>
 #include <dolfin/io/HDF5Attribute.h>
+#include <dolfin/io/ADIOS2File.h>
+#include <dolfin/io/AscentAdaptor.h>
 #include <dolfin/io/X3DOM.h>
 
 #endif
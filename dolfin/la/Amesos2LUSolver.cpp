@@ -121,9 +121,8 @@ void Amesos2LUSolver::set_operator(std::shared_ptr<const TpetraMatrix> A)
                  "cannot set operator if matrix has not been initialized");
   }
 
-  _solver->setA(_matA->mat());
-  // ierr = KSPSetOperators(_ksp, _matA->mat(), _matA->mat());
-
+  // The matrix is passed to the Amesos2 solver in solve(), where it
+  // is decided whether the symbolic factorization can be kept
 }
 //-----------------------------------------------------------------------------
 const GenericLinearOperator& Amesos2LUSolver::get_operator() const
@@ -168,6 +167,11 @@ std::size_t Amesos2LUSolver::solve(GenericVector& x, const GenericVector& b)
                  "\"%s\" not supported", _method_name.c_str());
   }
 
+  // Keep the symbolic factorization (ordering and symbolic
+  // analysis) if the graph of the matrix is the same as for the
+  // previous factorization, and redo only the numeric factorization
+  Teuchos::RCP<const TpetraMatrix::graph_type> graph
+    = _matA->mat()->getCrsGraph();
   if (_solver.is_null())
   {
     _solver = Amesos2::create(_method_name, _matA->mat(),
@@ -176,9 +180,14 @@ std::size_t Amesos2LUSolver::solve(GenericVector& x, const GenericVector& b)
   }
   else
   {
+    if (graph == _graph)
+      _solver->setA(_matA->mat(), Amesos2::SYMBFACT);
+    else
+      _solver->setA(_matA->mat());
     _solver->setX(_x.vec());
     _solver->setB(Teuchos::rcp_dynamic_cast<const TpetraVector::vector_type>(_b.vec()));
   }
+  _graph = graph;
   _solver->solve();
 
   return 1;
@@ -96,6 +96,11 @@ namespace dolfin
     // Operator (the matrix)
     std::shared_ptr<const TpetraMatrix> _matA;
 
+    // Graph (sparsity pattern) of the matrix of the last
+    // factorization. The symbolic factorization is reused while the
+    // graph is unchanged.
+    Teuchos::RCP<const TpetraMatrix::graph_type> _graph;
+
     // Method name
     std::string _method_name;
   };
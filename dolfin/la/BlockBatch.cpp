@@ -0,0 +1,79 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <dolfin/log/log.h>
+#include "GenericTensor.h"
+#include "BlockBatch.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+BlockBatch::BlockBatch(GenericTensor& A, std::size_t max_size)
+  : _tensor(A), _max_size(max_size), _num_blocks(0)
+{
+  dolfin_assert(max_size > 0);
+}
+//-----------------------------------------------------------------------------
+void BlockBatch::add_local(
+  const double* block,
+  const std::vector<ArrayView<const dolfin::la_index>>& rows)
+{
+  // Add current batch if the block dimensions change
+  bool same_dims = (rows.size() == _dims.size());
+  for (std::size_t i = 0; same_dims && i < rows.size(); ++i)
+    same_dims = (rows[i].size() == _dims[i]);
+  if (!same_dims)
+  {
+    flush();
+    _dims.resize(rows.size());
+    _rows.resize(rows.size());
+    _row_views.resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i)
+      _dims[i] = rows[i].size();
+  }
+
+  // Buffer values and indices
+  std::size_t block_size = 1;
+  for (std::size_t i = 0; i < rows.size(); ++i)
+  {
+    block_size *= rows[i].size();
+    _rows[i].insert(_rows[i].end(), rows[i].begin(), rows[i].end());
+  }
+  _values.insert(_values.end(), block, block + block_size);
+  ++_num_blocks;
+
+  // Add batch if full
+  if (_num_blocks == _max_size)
+    flush();
+}
+//-----------------------------------------------------------------------------
+void BlockBatch::flush()
+{
+  if (_num_blocks == 0)
+    return;
+
+  for (std::size_t i = 0; i < _rows.size(); ++i)
+    _row_views[i].set(_rows[i]);
+  _tensor.add_local_blocks(_values.data(), _num_blocks, _row_views);
+
+  // Clear batch (keeping storage)
+  _num_blocks = 0;
+  _values.clear();
+  for (std::size_t i = 0; i < _rows.size(); ++i)
+    _rows[i].clear();
+}
+//-----------------------------------------------------------------------------
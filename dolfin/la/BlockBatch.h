@@ -0,0 +1,79 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __BLOCK_BATCH_H
+#define __BLOCK_BATCH_H
+
+#include <cstddef>
+#include <vector>
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/common/types.h>
+
+namespace dolfin
+{
+
+  class GenericTensor;
+
+  /// This class collects blocks of values (e.g. element tensors)
+  /// with their local indices and adds them to a tensor in batches
+  /// using GenericTensor::add_local_blocks, which reduces the number
+  /// of (virtual) calls into the linear algebra backend. Blocks of a
+  /// batch must have the same dimensions; a batch is added when it
+  /// is full or when a block of different dimensions is added.
+
+  class BlockBatch
+  {
+  public:
+
+    /// Create batch of at most max_size blocks for tensor A
+    BlockBatch(GenericTensor& A, std::size_t max_size=64);
+
+    /// Add block of values using local indices (the values are
+    /// added to the tensor with the batch)
+    void add_local(const double* block,
+                   const std::vector<ArrayView<const dolfin::la_index>>& rows);
+
+    /// Add the blocks of the current batch to the tensor. This must
+    /// be called before the tensor is finalised.
+    void flush();
+
+    /// Number of blocks in the current batch
+    std::size_t size() const
+    { return _num_blocks; }
+
+  private:
+
+    // The tensor
+    GenericTensor& _tensor;
+
+    // Maximum number of blocks in a batch
+    const std::size_t _max_size;
+
+    // Number of blocks in current batch and their dimensions
+    std::size_t _num_blocks;
+    std::vector<std::size_t> _dims;
+
+    // Values and indices (for each dimension) of the blocks
+    std::vector<double> _values;
+    std::vector<std::vector<dolfin::la_index>> _rows;
+    std::vector<ArrayView<const dolfin::la_index>> _row_views;
+
+  };
+
+}
+
+#endif
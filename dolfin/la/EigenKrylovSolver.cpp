@@ -163,6 +163,11 @@ std::size_t EigenKrylovSolver::solve(EigenVector& x, const EigenVector& b)
   log(PROGRESS, "Eigen Krylov solver starting to solve %i x %i system.",
       _matA->size(0), _matA->size(1));
 
+  // Eigen computes the (RowMajor) matrix-vector products of the
+  // solvers with OpenMP threads when DOLFIN is built with OpenMP
+  const int eigen_num_threads = Eigen::nbThreads();
+  Eigen::setNbThreads(EigenVector::num_threads(_matA->size(0)));
+
   std::size_t num_iterations = 0;
 
   if (_method == "cg")
@@ -274,6 +279,8 @@ std::size_t EigenKrylovSolver::solve(EigenVector& x, const EigenVector& b)
     }
   }
 
+  Eigen::setNbThreads(eigen_num_threads);
+
   return num_iterations;
 }
 //-----------------------------------------------------------------------------
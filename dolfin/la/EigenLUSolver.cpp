@@ -15,6 +15,7 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <dolfin/common/types.h>
 #include <Eigen/SparseLU>
 #ifdef HAS_CHOLMOD
@@ -56,6 +57,53 @@
 
 using namespace dolfin;
 
+// Factorization of a column-major sparse matrix, with the symbolic
+// and numeric phases separated
+class EigenLUSolver::Factorization
+{
+public:
+
+  virtual ~Factorization() {}
+
+  // Compute symbolic analysis of A
+  virtual void analyze_pattern() = 0;
+
+  // Compute numeric factorization of A
+  virtual void factorize() = 0;
+
+  // Solve with factorization
+  virtual void solve(Eigen::VectorXd& x, const Eigen::VectorXd& b) = 0;
+
+  // Status of last operation
+  virtual Eigen::ComputationInfo info() const = 0;
+
+  // The matrix (compressed, column-major)
+  Eigen::SparseMatrix<double, Eigen::ColMajor> A;
+
+};
+
+// Factorization by a given Eigen solver
+template <typename Solver>
+class EigenLUSolver::SolverFactorization : public EigenLUSolver::Factorization
+{
+public:
+
+  void analyze_pattern()
+  { solver.analyzePattern(A); }
+
+  void factorize()
+  { solver.factorize(A); }
+
+  void solve(Eigen::VectorXd& x, const Eigen::VectorXd& b)
+  { x = solver.solve(b); }
+
+  Eigen::ComputationInfo info() const
+  { return solver.info(); }
+
+  Solver solver;
+
+};
+
 // List of available LU solvers
 const std::map<std::string, std::string>
 EigenLUSolver::_methods_descr
@@ -92,6 +140,7 @@ Parameters EigenLUSolver::default_parameters()
 }
 //-----------------------------------------------------------------------------
 EigenLUSolver::EigenLUSolver(std::string method)
+  : _num_symbolic_factorizations(0)
 {
   // Set parameter values
   parameters = default_parameters();
@@ -100,7 +149,8 @@ EigenLUSolver::EigenLUSolver(std::string method)
 }
 //-----------------------------------------------------------------------------
 EigenLUSolver::EigenLUSolver(std::shared_ptr<const EigenMatrix> A,
-                             std::string method) : _matA(A)
+                             std::string method)
+  : _matA(A), _num_symbolic_factorizations(0)
 {
   // Check dimensions
   if (A->size(0) != A->size(1))
@@ -152,70 +202,71 @@ const GenericLinearOperator& EigenLUSolver::get_operator() const
 //-----------------------------------------------------------------------------
 std::size_t EigenLUSolver::solve(GenericVector& x, const GenericVector& b)
 {
-  if (_method == "sparselu")
-  {
-    Eigen::SparseLU<Eigen::SparseMatrix<double, Eigen::ColMajor>,
-                    Eigen::COLAMDOrdering<int>> solver;
-    call_solver(solver, x, b);
-  }
-  else if (_method == "cholesky")
+  // Create factorization (kept between solves with the same method)
+  if (!_factorization or _factorization_method != _method)
   {
-    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor>,
-                          Eigen::Lower> solver;
-    call_solver(solver, x, b);
-  }
+    if (_method == "sparselu")
+    {
+      create_factorization<Eigen::SparseLU<Eigen::SparseMatrix<double, Eigen::ColMajor>,
+                                           Eigen::COLAMDOrdering<int>>>();
+    }
+    else if (_method == "cholesky")
+    {
+      create_factorization<Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor>,
+                                                 Eigen::Lower>>();
+    }
 #ifdef HAS_CHOLMOD
-  else if (_method == "cholmod")
-  {
-    Eigen::CholmodDecomposition<Eigen::SparseMatrix<double, Eigen::ColMajor>,
-                                Eigen::Lower> solver;
-    solver.setMode(Eigen::CholmodLDLt);
-    call_solver(solver, x, b);
-  }
+    else if (_method == "cholmod")
+    {
+      typedef Eigen::CholmodDecomposition<Eigen::SparseMatrix<double, Eigen::ColMajor>,
+                                          Eigen::Lower> Solver;
+      create_factorization<Solver>();
+      static_cast<SolverFactorization<Solver>&>(*_factorization)
+        .solver.setMode(Eigen::CholmodLDLt);
+    }
 #endif
 #ifdef EIGEN_PASTIX_SUPPORT
-  else if (_method == "pastix")
-  {
-    Eigen::PastixLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> solver;
-    call_solver(solver, x, b);
-  }
+    else if (_method == "pastix")
+      create_factorization<Eigen::PastixLU<Eigen::SparseMatrix<double, Eigen::ColMajor>>>();
 #endif
 #ifdef EIGEN_PARDISO_SUPPORT
-  else if (_method == "pardiso")
-  {
-    Eigen::PardisoLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> solver;
-    call_solver(solver, x, b);
-  }
+    else if (_method == "pardiso")
+      create_factorization<Eigen::PardisoLU<Eigen::SparseMatrix<double, Eigen::ColMajor>>>();
 #endif
 #ifdef EIGEN_SUPERLU_SUPPORT
-  else if (_method == "superlu")
-  {
-    Eigen::SuperLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> solver;
-    call_solver(solver, x, b);
-  }
+    else if (_method == "superlu")
+      create_factorization<Eigen::SuperLU<Eigen::SparseMatrix<double, Eigen::ColMajor>>>();
 #endif
 #ifdef HAS_UMFPACK
-  else if (_method == "umfpack")
-  {
-    Eigen::UmfPackLU<Eigen::SparseMatrix<double, Eigen::ColMajor>> solver;
-    call_solver(solver, x, b);
-  }
+    else if (_method == "umfpack")
+      create_factorization<Eigen::UmfPackLU<Eigen::SparseMatrix<double, Eigen::ColMajor>>>();
 #endif
-  else
-    dolfin_error("EigenLUSolver.cpp", "solve A.x =b",
-                 "Unknown method \"%s\"", _method.c_str());
+    else
+      dolfin_error("EigenLUSolver.cpp", "solve A.x =b",
+                   "Unknown method \"%s\"", _method.c_str());
+  }
+
+  call_solver(x, b);
 
   return 1;
 }
 //-----------------------------------------------------------------------------
 template <typename Solver>
-void EigenLUSolver::call_solver(Solver& solver, GenericVector& x,
-                                const GenericVector& b)
+void EigenLUSolver::create_factorization()
+{
+  _factorization = std::make_shared<SolverFactorization<Solver>>();
+  _factorization_method = _method;
+  _outer_index.clear();
+  _inner_index.clear();
+}
+//-----------------------------------------------------------------------------
+void EigenLUSolver::call_solver(GenericVector& x, const GenericVector& b)
 {
   const std::string timer_title = "Eigen LU solver (" + _method + ")";
   Timer timer(timer_title);
 
   dolfin_assert(_matA);
+  dolfin_assert(_factorization);
 
   // Downcast matrix and vectors
   const EigenVector& _b = as_type<const EigenVector>(b);
@@ -236,18 +287,44 @@ void EigenLUSolver::call_solver(Solver& solver, GenericVector& x,
   // Copy to format suitable for solver
   // Eigen wants ColMajor matrices for solver
   // FIXME: Do we want this? It could affect re-assembly performance
-  typename Solver::MatrixType _A;
-  _A = _matA->mat();
+  Eigen::SparseMatrix<double, Eigen::ColMajor>& A = _factorization->A;
+  A = _matA->mat();
 
   // Compress matrix
   // Most solvers require a compressed matrix
-  _A.makeCompressed();
+  A.makeCompressed();
 
-  // Factorize matrix
-  solver.compute(_A);
+  // Compute symbolic analysis unless the sparsity pattern is the
+  // same as for the previous factorization
+  const int* outer = A.outerIndexPtr();
+  const int* inner = A.innerIndexPtr();
+  const std::size_t num_outer = A.outerSize() + 1;
+  const std::size_t nnz = A.nonZeros();
+  const bool same_pattern = _outer_index.size() == num_outer
+    and _inner_index.size() == nnz
+    and std::equal(outer, outer + num_outer, _outer_index.begin())
+    and std::equal(inner, inner + nnz, _inner_index.begin());
+  if (!same_pattern)
+  {
+    _factorization->analyze_pattern();
+    if (_factorization->info() != Eigen::Success)
+    {
+      dolfin_error("EigenLUSolver.cpp",
+                   "compute symbolic matrix factorisation",
+                   "The provided data did not satisfy the prerequisites");
+    }
+    _outer_index.assign(outer, outer + num_outer);
+    _inner_index.assign(inner, inner + nnz);
+    ++_num_symbolic_factorizations;
+  }
 
-  if (solver.info() != Eigen::Success)
+  // Factorize matrix
+  _factorization->factorize();
+  if (_factorization->info() != Eigen::Success)
   {
+    // Discard the analysis, it may not be valid for the next matrix
+    _outer_index.clear();
+    _inner_index.clear();
     dolfin_error("EigenLUSolver.cpp",
                  "compute matrix factorisation",
                  "The provided data did not satisfy the prerequisites");
@@ -256,8 +333,8 @@ void EigenLUSolver::call_solver(Solver& solver, GenericVector& x,
   // Solve linear system
   dolfin_assert(_b.vec());
   dolfin_assert(_x.vec());
-  *(_x.vec()) = solver.solve(*(_b.vec()));
-  if (solver.info() != Eigen::Success)
+  _factorization->solve(*(_x.vec()), *(_b.vec()));
+  if (_factorization->info() != Eigen::Success)
   {
     dolfin_error("EigenLUSolver.cpp",
                  "solve A.x = b",
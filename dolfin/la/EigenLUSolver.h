@@ -20,6 +20,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <dolfin/common/types.h>
 #include <Eigen/Dense>
@@ -35,6 +37,12 @@ namespace dolfin
 
   /// This class implements the direct solution (LU factorization) for
   /// linear systems of the form Ax = b.
+  ///
+  /// The Eigen solver is kept between solves, and the symbolic
+  /// analysis (fill-reducing ordering) of the matrix is reused as
+  /// long as its sparsity pattern is unchanged, so that repeated
+  /// solves (e.g. in a Newton loop) only compute the numeric
+  /// factorization.
 
   class EigenLUSolver : public GenericLinearSolver
   {
@@ -73,6 +81,10 @@ namespace dolfin
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
+    /// Return the number of symbolic analyses (orderings) computed
+    std::size_t num_symbolic_factorizations() const
+    { return _num_symbolic_factorizations; }
+
     /// Return a list of available solver methods
     static std::map<std::string, std::string> methods();
 
@@ -85,9 +97,17 @@ namespace dolfin
 
   private:
 
-    // Call generic solve
+    // Factorization computed by one of the Eigen solvers
+    class Factorization;
+    template <typename Solver> class SolverFactorization;
+
+    // Create factorization for current method
     template <typename Solver>
-    void call_solver(Solver& solver, GenericVector& x, const GenericVector& b);
+    void create_factorization();
+
+    // Factorize matrix (reusing the symbolic analysis if the
+    // sparsity pattern is unchanged) and solve
+    void call_solver(GenericVector& x, const GenericVector& b);
 
     // Available LU solvers and descriptions
     static const std::map<std::string, std::string> _methods_descr;
@@ -101,6 +121,17 @@ namespace dolfin
     // Operator (the matrix)
     std::shared_ptr<const EigenMatrix> _matA;
 
+    // Factorization and method it was created for
+    std::shared_ptr<Factorization> _factorization;
+    std::string _factorization_method;
+
+    // Sparsity pattern (compressed column-major) of the last analysed
+    // matrix
+    std::vector<int> _outer_index, _inner_index;
+
+    // Number of symbolic analyses
+    std::size_t _num_symbolic_factorizations;
+
   };
 
 }
@@ -15,6 +15,11 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "EigenFactory.h"
 #include "SparsityPattern.h"
 #include "EigenMatrix.h"
@@ -165,6 +170,55 @@ void EigenMatrix::add(const double* block, std::size_t m,
   }
 }
 //---------------------------------------------------------------------------
+void EigenMatrix::add_local_blocks(
+  const double* blocks, std::size_t num_blocks,
+  const std::vector<ArrayView<const dolfin::la_index>>& rows)
+{
+  if (num_blocks == 0)
+    return;
+
+  dolfin_assert(rows.size() == 2);
+  const std::size_t m = rows[0].size()/num_blocks;
+  const std::size_t n = rows[1].size()/num_blocks;
+
+  // Columns of a block (with position in block) in increasing order
+  std::vector<std::pair<dolfin::la_index, std::size_t>> sorted_cols(n);
+
+  for (std::size_t k = 0; k < num_blocks; ++k)
+  {
+    const dolfin::la_index* block_rows = rows[0].data() + k*m;
+    const dolfin::la_index* block_cols = rows[1].data() + k*n;
+    const double* block = blocks + k*m*n;
+
+    for (std::size_t j = 0; j < n; ++j)
+      sorted_cols[j] = std::make_pair(block_cols[j], j);
+    std::sort(sorted_cols.begin(), sorted_cols.end());
+
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      // Merge sorted columns with the (sorted) entries of the row
+      const dolfin::la_index row = block_rows[i];
+      eigen_matrix_type::InnerIterator it(_matA, row);
+      for (std::size_t j = 0; j < n; ++j)
+      {
+        const dolfin::la_index col = sorted_cols[j].first;
+        while (it && it.index() < col)
+          ++it;
+
+        const double value = block[i*n + sorted_cols[j].second];
+        if (it && it.index() == col)
+          it.valueRef() += value;
+        else
+        {
+          // Entry is not in the pattern; insert and restart merge
+          _matA.coeffRef(row, col) += value;
+          it = eigen_matrix_type::InnerIterator(_matA, row);
+        }
+      }
+    }
+  }
+}
+//---------------------------------------------------------------------------
 void EigenMatrix::get(double* block, std::size_t m,
                       const dolfin::la_index* rows,
                       std::size_t n, const dolfin::la_index* cols) const
@@ -251,7 +305,32 @@ void EigenMatrix::mult(const GenericVector& x, GenericVector& y) const
 
   dolfin_assert(xx.vec());
   dolfin_assert(yy.vec());
-  *yy.vec() = _matA*(*xx.vec());
+
+  // Compute product row by row with OpenMP threads (rows of the
+  // RowMajor storage are independent)
+  const std::size_t nt = EigenVector::num_threads(size(0));
+  if (nt > 1)
+  {
+    const int* outer = _matA.outerIndexPtr();
+    const int* inner_nnz = _matA.innerNonZeroPtr();
+    const int* cols = _matA.innerIndexPtr();
+    const double* values = _matA.valuePtr();
+    const double* _x = xx.vec()->data();
+    double* _y = yy.vec()->data();
+    const std::int64_t num_rows = size(0);
+
+    #pragma omp parallel for num_threads(nt) schedule(static)
+    for (std::int64_t i = 0; i < num_rows; ++i)
+    {
+      const int end = inner_nnz ? outer[i] + inner_nnz[i] : outer[i + 1];
+      double y_i = 0.0;
+      for (int k = outer[i]; k < end; ++k)
+        y_i += values[k]*_x[cols[k]];
+      _y[i] = y_i;
+    }
+  }
+  else
+    *yy.vec() = _matA*(*xx.vec());
 }
 //-----------------------------------------------------------------------------
 void EigenMatrix::get_diagonal(GenericVector& x) const
@@ -354,6 +433,13 @@ EigenMatrix:: data() const
                          _matA.valuePtr(), _matA.nonZeros());
 }
 //----------------------------------------------------------------------------
+std::size_t EigenMatrix::memory_usage() const
+{
+  return sizeof(*this)
+    + _matA.nonZeros()*(sizeof(double) + sizeof(int))
+    + (_matA.outerSize() + 1)*sizeof(int);
+}
+//----------------------------------------------------------------------------
 std::string EigenMatrix::str(bool verbose) const
 {
   std::stringstream s;
@@ -391,8 +477,15 @@ void EigenMatrix::init(const TensorLayout& tensor_layout)
   dolfin_assert(sparsity_pattern);
 
   // Reserve space for non-zeroes and get non-zero pattern
-  std::vector<std::size_t> num_nonzeros_per_row;
-  sparsity_pattern->num_nonzeros_diagonal(num_nonzeros_per_row);
+  // (Eigen has no block sparse storage, so a pattern of blocks is
+  // expanded to its entries)
+  const std::size_t bs = sparsity_pattern->block_size();
+  std::vector<std::size_t> num_nonzeros_per_block_row, num_nonzeros_per_row;
+  sparsity_pattern->num_nonzeros_diagonal(num_nonzeros_per_block_row);
+  num_nonzeros_per_row.reserve(bs*num_nonzeros_per_block_row.size());
+  for (auto num_nonzeros : num_nonzeros_per_block_row)
+    num_nonzeros_per_row.insert(num_nonzeros_per_row.end(), bs,
+                                bs*num_nonzeros);
   _matA.reserve(num_nonzeros_per_row);
 
   const std::vector<std::vector<std::size_t>> pattern
@@ -404,8 +497,12 @@ void EigenMatrix::init(const TensorLayout& tensor_layout)
   // Add entries for RowMajor matrix
   for (std::size_t i = 0; i != pattern.size(); ++i)
   {
-    for (auto j : pattern[i])
-      _matA.insert(i, j) = 0.0;
+    for (std::size_t k = 0; k < bs; ++k)
+    {
+      for (auto j : pattern[i])
+        for (std::size_t l = 0; l < bs; ++l)
+          _matA.insert(bs*i + k, bs*j + l) = 0.0;
+    }
   }
 }
 //---------------------------------------------------------------------------
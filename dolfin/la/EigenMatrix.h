@@ -92,6 +92,9 @@ namespace dolfin
     virtual MPI_Comm mpi_comm() const
     { return _mpi_comm.comm(); }
 
+    /// Return estimate of memory used on this process in bytes
+    virtual std::size_t memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const;
 
@@ -137,6 +140,14 @@ namespace dolfin
                            const dolfin::la_index* cols)
     { add(block, m, rows, n, cols); }
 
+    /// Add a batch of blocks of values using local indices (see
+    /// GenericTensor::add_local_blocks). The columns of each block
+    /// are sorted once and merged with each (sorted) row of the
+    /// matrix in a single pass.
+    virtual void
+      add_local_blocks(const double* blocks, std::size_t num_blocks,
+                       const std::vector<ArrayView<const dolfin::la_index>>& rows);
+
     /// Add multiple of given matrix (AXPY operation)
     virtual void axpy(double a, const GenericMatrix& A,
                       bool same_nonzero_pattern);
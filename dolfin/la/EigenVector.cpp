@@ -16,6 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -24,12 +25,32 @@
 #include <dolfin/log/log.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/Array.h>
+#include <dolfin/common/NoDeleter.h>
+#include <dolfin/common/SubSystemsManager.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "EigenVector.h"
 #include "EigenFactory.h"
 #include "GenericLinearAlgebraFactory.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Return offset and size of chunk c when splitting n entries into
+  // num_chunks contiguous chunks
+  std::pair<std::size_t, std::size_t>
+  chunk(std::size_t n, std::size_t num_chunks, std::size_t c)
+  {
+    const std::size_t size = n/num_chunks;
+    const std::size_t remainder = n % num_chunks;
+    const std::size_t offset = c*size + std::min(c, remainder);
+    return std::make_pair(offset, size + (c < remainder ? 1 : 0));
+  }
+}
+
+const std::size_t EigenVector::min_entries_per_thread;
+const std::size_t EigenVector::block_size;
+
 //-----------------------------------------------------------------------------
 EigenVector::EigenVector() : EigenVector(MPI_COMM_SELF)
 {
@@ -110,6 +131,24 @@ void EigenVector::get_local(double* block, std::size_t m,
     block[i] = (*_x)(rows[i]);
 }
 //-----------------------------------------------------------------------------
+void EigenVector::get_local_strided(double* block, std::size_t m,
+                                    dolfin::la_index offset,
+                                    dolfin::la_index stride) const
+{
+  const double* x = _x->data() + offset;
+  for (std::size_t i = 0; i < m; i++)
+    block[i] = x[(dolfin::la_index) i*stride];
+}
+//-----------------------------------------------------------------------------
+void EigenVector::set_local_strided(const double* block, std::size_t m,
+                                    dolfin::la_index offset,
+                                    dolfin::la_index stride)
+{
+  double* x = _x->data() + offset;
+  for (std::size_t i = 0; i < m; i++)
+    x[(dolfin::la_index) i*stride] = block[i];
+}
+//-----------------------------------------------------------------------------
 void EigenVector::get_local(std::vector<double>& values) const
 {
   values.resize(size());
@@ -180,6 +219,36 @@ void EigenVector::zero()
 double EigenVector::norm(std::string norm_type) const
 {
   dolfin_assert(_x);
+  const std::size_t nt = num_threads(_x->size());
+  if (nt > 1 && (norm_type == "l1" || norm_type == "l2"))
+  {
+    // Sum of |x_i| or x_i^2 over contiguous chunks
+    const bool l1 = (norm_type == "l1");
+    double _sum = 0.0;
+    #pragma omp parallel for num_threads(nt) schedule(static) reduction(+:_sum)
+    for (std::size_t c = 0; c < nt; ++c)
+    {
+      const auto r = chunk(_x->size(), nt, c);
+      if (l1)
+        _sum += _x->segment(r.first, r.second).lpNorm<1>();
+      else
+        _sum += _x->segment(r.first, r.second).squaredNorm();
+    }
+    return l1 ? _sum : std::sqrt(_sum);
+  }
+  else if (nt > 1 && norm_type == "linf")
+  {
+    double _max = 0.0;
+    #pragma omp parallel for num_threads(nt) schedule(static) reduction(max:_max)
+    for (std::size_t c = 0; c < nt; ++c)
+    {
+      const auto r = chunk(_x->size(), nt, c);
+      _max = std::max(_max,
+                      _x->segment(r.first, r.second).lpNorm<Eigen::Infinity>());
+    }
+    return _max;
+  }
+
   if (norm_type == "l1")
     return _x->lpNorm<1>();
   else if (norm_type == "l2")
@@ -242,7 +311,52 @@ void EigenVector::axpy(double a, const GenericVector& y)
 
   auto _y = as_type<const EigenVector>(y).vec();
   dolfin_assert(_y);
-  (*_x) = _x->array() + a * _y->array();
+  const std::size_t nt = num_threads(_x->size());
+  if (nt > 1)
+  {
+    #pragma omp parallel for num_threads(nt) schedule(static)
+    for (std::size_t c = 0; c < nt; ++c)
+    {
+      const auto r = chunk(_x->size(), nt, c);
+      _x->segment(r.first, r.second) += a*_y->segment(r.first, r.second);
+    }
+  }
+  else
+    (*_x) = _x->array() + a * _y->array();
+}
+//-----------------------------------------------------------------------------
+void EigenVector::maxpy(const std::vector<double>& a,
+                        const std::vector<std::shared_ptr<const GenericVector>>& x)
+{
+  dolfin_assert(_x);
+  dolfin_assert(a.size() == x.size());
+  std::vector<const Eigen::VectorXd*> y(x.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    dolfin_assert(x[i]);
+    if (size() != x[i]->size())
+    {
+      dolfin_error("EigenVector.cpp",
+                   "perform maxpy operation with Eigen vector",
+                   "Vectors are not of the same size");
+    }
+    y[i] = as_type<const EigenVector>(*x[i]).vec().get();
+  }
+
+  // Add all vectors to one block of this vector at a time so that
+  // the block stays in cache
+  const std::size_t n = _x->size();
+  const std::size_t num_blocks = (n + block_size - 1)/block_size;
+  const std::size_t nt = num_threads(n);
+  #pragma omp parallel for num_threads(nt) schedule(static)
+  for (std::size_t b = 0; b < num_blocks; ++b)
+  {
+    const std::size_t offset = b*block_size;
+    const std::size_t size = std::min(block_size, n - offset);
+    auto _xb = _x->segment(offset, size);
+    for (std::size_t i = 0; i < y.size(); ++i)
+      _xb += a[i]*y[i]->segment(offset, size);
+  }
 }
 //-----------------------------------------------------------------------------
 void EigenVector::abs()
@@ -256,9 +370,70 @@ double EigenVector::inner(const GenericVector& y) const
   dolfin_assert(_x);
   auto _y = as_type<const EigenVector>(y).vec();
   dolfin_assert(_y);
+  const std::size_t nt = num_threads(_x->size());
+  if (nt > 1)
+  {
+    double _inner = 0.0;
+    #pragma omp parallel for num_threads(nt) schedule(static) reduction(+:_inner)
+    for (std::size_t c = 0; c < nt; ++c)
+    {
+      const auto r = chunk(_x->size(), nt, c);
+      _inner += _x->segment(r.first, r.second).dot(_y->segment(r.first, r.second));
+    }
+    return _inner;
+  }
   return _x->dot(*_y);
 }
 //-----------------------------------------------------------------------------
+std::vector<double>
+EigenVector::mdot(const std::vector<std::shared_ptr<const GenericVector>>& x) const
+{
+  dolfin_assert(_x);
+  const std::size_t m = x.size();
+  std::vector<const Eigen::VectorXd*> y(m);
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    dolfin_assert(x[i]);
+    y[i] = as_type<const EigenVector>(*x[i]).vec().get();
+    dolfin_assert(y[i]);
+  }
+
+  // Compute the inner products one block of this vector at a time,
+  // with partial sums for each thread
+  const std::size_t n = _x->size();
+  const std::size_t nt = num_threads(n);
+  std::vector<double> partial(nt*m, 0.0);
+  #pragma omp parallel for num_threads(nt) schedule(static)
+  for (std::size_t c = 0; c < nt; ++c)
+  {
+    const auto r = chunk(n, nt, c);
+    for (std::size_t offset = r.first; offset < r.first + r.second;
+         offset += block_size)
+    {
+      const std::size_t size = std::min(block_size,
+                                        r.first + r.second - offset);
+      const auto _xb = _x->segment(offset, size);
+      for (std::size_t i = 0; i < m; ++i)
+        partial[c*m + i] += _xb.dot(y[i]->segment(offset, size));
+    }
+  }
+
+  std::vector<double> values(m, 0.0);
+  for (std::size_t c = 0; c < nt; ++c)
+    for (std::size_t i = 0; i < m; ++i)
+      values[i] += partial[c*m + i];
+  return values;
+}
+//-----------------------------------------------------------------------------
+std::pair<double, double> EigenVector::inner_norm(const GenericVector& y) const
+{
+  // Inner products with y and with this vector in one pass
+  std::vector<std::shared_ptr<const GenericVector>> x
+    = {reference_to_no_delete_pointer(y), reference_to_no_delete_pointer(*this)};
+  const std::vector<double> values = mdot(x);
+  return std::make_pair(values[0], std::sqrt(values[1]));
+}
+//-----------------------------------------------------------------------------
 const GenericVector& EigenVector::operator= (const GenericVector& v)
 {
   *this = as_type<const EigenVector>(v);
@@ -291,7 +466,18 @@ const EigenVector& EigenVector::operator= (double a)
 const EigenVector& EigenVector::operator*= (const double a)
 {
   dolfin_assert(_x);
-  (*_x) *= a;
+  const std::size_t nt = num_threads(_x->size());
+  if (nt > 1)
+  {
+    #pragma omp parallel for num_threads(nt) schedule(static)
+    for (std::size_t c = 0; c < nt; ++c)
+    {
+      const auto r = chunk(_x->size(), nt, c);
+      _x->segment(r.first, r.second) *= a;
+    }
+  }
+  else
+    (*_x) *= a;
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -312,9 +498,7 @@ const EigenVector& EigenVector::operator/= (const double a)
 //-----------------------------------------------------------------------------
 const EigenVector& EigenVector::operator+= (const GenericVector& y)
 {
-  auto _y = as_type<const EigenVector>(y).vec();
-  dolfin_assert(_y);
-  *_x = _x->array() + _y->array();
+  axpy(1.0, y);
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -326,9 +510,7 @@ const EigenVector& EigenVector::operator+= (double a)
 //-----------------------------------------------------------------------------
 const EigenVector& EigenVector::operator-= (const GenericVector& y)
 {
-  auto _y = as_type<const EigenVector>(y).vec();
-  dolfin_assert(_y);
-  *_x = _x->array() - _y->array();
+  axpy(-1.0, y);
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -338,6 +520,20 @@ const EigenVector& EigenVector::operator-= (double a)
   return *this;
 }
 //-----------------------------------------------------------------------------
+std::size_t EigenVector::num_threads(std::size_t n)
+{
+  const std::size_t requested = SubSystemsManager::num_threads();
+  if (requested < 2)
+    return 1;
+  return std::max(std::size_t(1),
+                  std::min(requested, n/min_entries_per_thread));
+}
+//-----------------------------------------------------------------------------
+std::size_t EigenVector::memory_usage() const
+{
+  return sizeof(*this) + (_x ? _x->size()*sizeof(double) : 0);
+}
+//-----------------------------------------------------------------------------
 std::string EigenVector::str(bool verbose) const
 {
   std::stringstream s;
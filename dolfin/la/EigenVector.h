@@ -76,6 +76,9 @@ namespace dolfin
     virtual MPI_Comm mpi_comm() const
     { return _mpi_comm.comm(); }
 
+    /// Return estimate of memory used on this process in bytes
+    virtual std::size_t memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const;
 
@@ -184,6 +187,16 @@ namespace dolfin
     /// Get all values on local process
     virtual void get_local(std::vector<double>& values) const;
 
+    /// Get block of values using strided local indices
+    virtual void get_local_strided(double* block, std::size_t m,
+                                   dolfin::la_index offset,
+                                   dolfin::la_index stride) const;
+
+    /// Set block of values using strided local indices
+    virtual void set_local_strided(const double* block, std::size_t m,
+                                   dolfin::la_index offset,
+                                   dolfin::la_index stride);
+
     /// Set all values on local process
     virtual void set_local(const std::vector<double>& values);
 
@@ -204,12 +217,26 @@ namespace dolfin
     /// Add multiple of given vector (AXPY operation)
     virtual void axpy(double a, const GenericVector& x);
 
+    /// Add multiples of given vectors in a single pass (fused AXPY
+    /// operation)
+    virtual void maxpy(const std::vector<double>& a,
+                       const std::vector<std::shared_ptr<const GenericVector>>& x);
+
     /// Replace all entries in the vector by their absolute values
     virtual void abs();
 
     /// Return inner product with given vector
     virtual double inner(const GenericVector& x) const;
 
+    /// Return inner products with given vectors, computed in a single
+    /// pass
+    virtual std::vector<double>
+      mdot(const std::vector<std::shared_ptr<const GenericVector>>& x) const;
+
+    /// Return inner product with given vector and l2 norm of this
+    /// vector
+    virtual std::pair<double, double> inner_norm(const GenericVector& x) const;
+
     /// Compute norm of vector
     virtual double norm(std::string norm_type) const;
 
@@ -282,12 +309,37 @@ namespace dolfin
     /// Assignment operator
     const EigenVector& operator= (const EigenVector& x);
 
+    /// Get direct access to the local values (there are no ghost
+    /// values)
+    virtual double* get_local_array(std::size_t& size, bool ghosted)
+    { size = this->size(); return data(); }
+
+    /// Get direct read-only access to the local values
+    virtual const double*
+      get_local_array(std::size_t& size, bool ghosted) const
+    { size = this->size(); return data(); }
+
     /// Return pointer to underlying data
     double* data();
 
     /// Return pointer to underlying data (const version)
     const double* data() const;
 
+    /// Return number of OpenMP threads used by the Eigen backend for
+    /// operations on n entries (rows). This is given by the global
+    /// parameter "num_threads", reduced so that each thread works on
+    /// at least min_entries_per_thread entries, and is one when
+    /// DOLFIN is built without OpenMP.
+    static std::size_t num_threads(std::size_t n);
+
+    /// Minimum number of entries (rows) per thread for threaded
+    /// (OpenMP) vector and matrix-vector operations
+    static const std::size_t min_entries_per_thread = 10000;
+
+    /// Number of entries per block for the fused (multi-vector)
+    /// operations maxpy and mdot
+    static const std::size_t block_size = 1024;
+
   private:
 
     static void check_mpi_size(const MPI_Comm comm)
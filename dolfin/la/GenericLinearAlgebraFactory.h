@@ -94,6 +94,13 @@ namespace dolfin
     krylov_solver_preconditioners() const
     { return std::map<std::string, std::string>(); }
 
+    /// Return true if matrices can be initialised from the row
+    /// counts of a tensor layout (see TensorLayout::set_num_nonzeros)
+    /// without a sparsity pattern. This function should be
+    /// overloaded by subclass if supported.
+    virtual bool supports_row_count_preallocation() const
+    { return false; }
+
   protected:
 
     // Dummy class that can be returned for linear algebra backends
@@ -18,9 +18,35 @@
 #include "GenericLinearOperator.h"
 #include "GenericLinearSolver.h"
 #include "GenericMatrix.h"
+#include "GenericVector.h"
 
 using namespace dolfin;
 
+//-----------------------------------------------------------------------------
+std::size_t
+GenericLinearSolver::solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                           const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  if (x.size() != b.size())
+  {
+    dolfin_error("GenericLinearSolver.cpp",
+                 "solve linear systems for multiple right-hand sides",
+                 "Number of solution vectors (%d) does not match number of right-hand sides (%d)",
+                 x.size(), b.size());
+  }
+
+  // The operator is unchanged between the solves, so the
+  // factorization or preconditioner is set up only once
+  std::size_t num_iterations = 0;
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    dolfin_assert(x[i]);
+    dolfin_assert(b[i]);
+    num_iterations += solve(*x[i], *b[i]);
+  }
+
+  return num_iterations;
+}
 //-----------------------------------------------------------------------------
 const GenericMatrix& GenericLinearSolver::require_matrix(const GenericLinearOperator& A)
 {
@@ -60,3 +86,43 @@ GenericLinearSolver::require_matrix(std::shared_ptr<const GenericLinearOperator>
   return _matA;
 }
 //-----------------------------------------------------------------------------
+std::size_t
+GenericLinearSolver::iterative_refinement(GenericLinearSolver& solver,
+                                          const GenericLinearOperator& A,
+                                          GenericVector& x,
+                                          const GenericVector& b,
+                                          std::size_t max_steps,
+                                          double tolerance)
+{
+  const double b_norm = b.norm("l2");
+  if (b_norm == 0.0)
+    return 0;
+
+  // Residual, product Ax and correction
+  std::shared_ptr<GenericVector> r = b.copy();
+  std::shared_ptr<GenericVector> Ax = b.copy();
+  std::shared_ptr<GenericVector> d = x.copy();
+
+  std::size_t step = 0;
+  for (; step < max_steps; ++step)
+  {
+    // Compute residual r = b - Ax
+    A.mult(x, *Ax);
+    *r = b;
+    r->axpy(-1.0, *Ax);
+
+    const double r_norm = r->norm("l2");
+    log(PROGRESS, "Iterative refinement step %d: relative residual %g",
+        step, r_norm/b_norm);
+    if (r_norm <= tolerance*b_norm)
+      break;
+
+    // Solve for correction and update solution
+    d->zero();
+    solver.solve(*d, *r);
+    x.axpy(1.0, *d);
+  }
+
+  return step;
+}
+//-----------------------------------------------------------------------------
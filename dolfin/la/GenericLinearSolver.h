@@ -65,6 +65,15 @@ namespace dolfin
     /// Solve linear system Ax = b
     virtual std::size_t solve(GenericVector& x, const GenericVector& b) = 0;
 
+    /// Solve linear systems Ax_i = b_i for several right-hand sides
+    /// with the same operator, reusing the factorization or
+    /// preconditioner. The default implementation solves for one
+    /// right-hand side at a time. Returns the total number of
+    /// iterations.
+    virtual std::size_t
+      solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+            const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     // FIXME: This should not be needed. Need to cleanup linear solver
     // name jungle: default, lu, iterative, direct, krylov, etc
     /// Return parameter type: "krylov_solver" or "lu_solver"
@@ -99,6 +108,19 @@ namespace dolfin
     static std::shared_ptr<const GenericMatrix>
       require_matrix(std::shared_ptr<const GenericLinearOperator> A);
 
+    /// Improve the solution x of Ax = b by iterative refinement. The
+    /// residual r = b - Ax is computed in full (double) precision and
+    /// the correction d, solved from Ad = r with the (possibly low
+    /// accuracy) solver, is added to x. This is repeated at most
+    /// max_steps times or until |r| <= tolerance |b|. Returns the
+    /// number of refinement steps.
+    static std::size_t iterative_refinement(GenericLinearSolver& solver,
+                                            const GenericLinearOperator& A,
+                                            GenericVector& x,
+                                            const GenericVector& b,
+                                            std::size_t max_steps,
+                                            double tolerance);
+
   };
 
 }
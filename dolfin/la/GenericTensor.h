@@ -103,6 +103,35 @@ namespace dolfin
                            const dolfin::la_index* num_rows,
                            const dolfin::la_index * const * rows) = 0;
 
+    /// Add a batch of blocks of values using local indices. The
+    /// blocks have the same dimensions and are stored one after the
+    /// other in blocks. The indices of the blocks along dimension i
+    /// are stored one after the other in rows[i], i.e. block k has
+    /// the rows[i].size()/num_blocks indices starting at position
+    /// k*rows[i].size()/num_blocks. Backends may override this to
+    /// insert all blocks in one pass.
+    virtual void add_local_blocks(
+      const double* blocks, std::size_t num_blocks,
+      const std::vector<ArrayView<const dolfin::la_index>>& rows)
+    {
+      if (num_blocks == 0)
+        return;
+
+      std::size_t block_size = 1;
+      std::vector<ArrayView<const dolfin::la_index>> block_rows(rows.size());
+      for (std::size_t i = 0; i < rows.size(); ++i)
+        block_size *= rows[i].size()/num_blocks;
+      for (std::size_t k = 0; k < num_blocks; ++k)
+      {
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+          const std::size_t n = rows[i].size()/num_blocks;
+          block_rows[i].set(n, rows[i].data() + k*n);
+        }
+        add_local(blocks + k*block_size, block_rows);
+      }
+    }
+
     /// Set all entries to zero and keep any sparse structure
     virtual void zero() = 0;
 
@@ -112,6 +141,11 @@ namespace dolfin
     /// Return MPI communicator
     //virtual MPI_Comm mpi_comm() const = 0;
 
+    /// Return estimate of memory used by tensor on this process in
+    /// bytes. Backends which cannot report it return 0.
+    virtual std::size_t memory_usage() const
+    { return 0; }
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const = 0;
 
@@ -29,6 +29,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <dolfin/common/ArrayView.h>
@@ -144,6 +145,14 @@ namespace dolfin
                 const std::vector<ArrayView<const dolfin::la_index>>& rows)
     { add_local(block, rows[0].size(), rows[0].data()); }
 
+    /// Add a batch of blocks of values using local indices (see
+    /// GenericTensor::add_local_blocks). For vectors the blocks are
+    /// added in one call.
+    virtual void
+      add_local_blocks(const double* blocks, std::size_t num_blocks,
+                       const std::vector<ArrayView<const dolfin::la_index>>& rows)
+    { add_local(blocks, rows[0].size(), rows[0].data()); }
+
     /// Set all entries to zero and keep any sparse structure
     virtual void zero() = 0;
 
@@ -209,6 +218,30 @@ namespace dolfin
     virtual void add_local(const double* block, std::size_t m,
                            const dolfin::la_index* rows) = 0;
 
+    /// Get block of values using the local indices offset +
+    /// i*stride, i = 0, ..., m - 1 (ghosts are accessible)
+    virtual void get_local_strided(double* block, std::size_t m,
+                                   dolfin::la_index offset,
+                                   dolfin::la_index stride) const
+    {
+      std::vector<dolfin::la_index> rows(m);
+      for (std::size_t i = 0; i < m; ++i)
+        rows[i] = offset + (dolfin::la_index) i*stride;
+      get_local(block, m, rows.data());
+    }
+
+    /// Set block of values using the local indices offset +
+    /// i*stride, i = 0, ..., m - 1
+    virtual void set_local_strided(const double* block, std::size_t m,
+                                   dolfin::la_index offset,
+                                   dolfin::la_index stride)
+    {
+      std::vector<dolfin::la_index> rows(m);
+      for (std::size_t i = 0; i < m; ++i)
+        rows[i] = offset + (dolfin::la_index) i*stride;
+      set_local(block, m, rows.data());
+    }
+
     /// Get all values on local process
     virtual void get_local(std::vector<double>& values) const = 0;
 
@@ -233,12 +266,44 @@ namespace dolfin
     /// Add multiple of given vector (AXPY operation)
     virtual void axpy(double a, const GenericVector& x) = 0;
 
+    /// Add multiples of given vectors, this += sum_i a[i]*x[i], in a
+    /// single pass over this vector (fused AXPY operation)
+    virtual void maxpy(const std::vector<double>& a,
+                       const std::vector<std::shared_ptr<const GenericVector>>& x)
+    {
+      dolfin_assert(a.size() == x.size());
+      for (std::size_t i = 0; i < x.size(); ++i)
+      {
+        dolfin_assert(x[i]);
+        axpy(a[i], *x[i]);
+      }
+    }
+
     /// Replace all entries in the vector by their absolute values
     virtual void abs() = 0;
 
     /// Return inner product with given vector
     virtual double inner(const GenericVector& x) const = 0;
 
+    /// Return inner products with given vectors, computed in a single
+    /// pass (and a single global reduction)
+    virtual std::vector<double>
+      mdot(const std::vector<std::shared_ptr<const GenericVector>>& x) const
+    {
+      std::vector<double> values(x.size());
+      for (std::size_t i = 0; i < x.size(); ++i)
+      {
+        dolfin_assert(x[i]);
+        values[i] = inner(*x[i]);
+      }
+      return values;
+    }
+
+    /// Return inner product with given vector and l2 norm of this
+    /// vector, computed with a single global reduction
+    virtual std::pair<double, double> inner_norm(const GenericVector& x) const
+    { return std::make_pair(inner(x), norm("l2")); }
+
     /// Return norm of vector
     virtual double norm(std::string norm_type) const = 0;
 
@@ -306,6 +371,45 @@ namespace dolfin
     /// Assignment operator
     virtual const GenericVector& operator= (const GenericVector& x) = 0;
 
+    /// Copy the entries owned by this process from x without
+    /// updating ghost values. Ghost values are stale until
+    /// update_ghost_values_begin() and update_ghost_values_end() have
+    /// been called. The default implementation assigns x.
+    virtual void copy_owned_values(const GenericVector& x)
+    { *this = x; }
+
+    /// Start updating ghost values from their owners. Purely local
+    /// work may be done before calling update_ghost_values_end().
+    /// Does nothing for backends without ghost values.
+    virtual void update_ghost_values_begin() {}
+
+    /// Complete the ghost value update started by
+    /// update_ghost_values_begin()
+    virtual void update_ghost_values_end() {}
+
+    /// Get direct access to the local values (owned values first,
+    /// followed by the ghost values if ghosted is true). Returns the
+    /// number of accessible values in size. Every call must be paired
+    /// with restore_local_array(). Returns a null pointer if the
+    /// backend does not support direct access (the default). Use
+    /// LocalVectorArray for exception-safe access.
+    virtual double* get_local_array(std::size_t& size, bool ghosted)
+    { size = 0; return nullptr; }
+
+    /// Get direct read-only access to the local values (see
+    /// get_local_array)
+    virtual const double*
+      get_local_array(std::size_t& size, bool ghosted) const
+    { size = 0; return nullptr; }
+
+    /// Release access obtained with get_local_array(). Changes to
+    /// ghost values are not communicated to their owners.
+    virtual void restore_local_array(double* data, bool ghosted) {}
+
+    /// Release read-only access obtained with get_local_array()
+    virtual void restore_local_array(const double* data,
+                                     bool ghosted) const {}
+
     /// Assignment operator
     virtual const GenericVector& operator= (double a) = 0;
 
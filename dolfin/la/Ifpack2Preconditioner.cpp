@@ -61,6 +61,13 @@ Ifpack2Preconditioner::~Ifpack2Preconditioner()
 //-----------------------------------------------------------------------------
 void Ifpack2Preconditioner::init(std::shared_ptr<const TpetraMatrix> P)
 {
+  // Same matrix (and hence same graph): recompute numeric setup only
+  if (!_prec.is_null() and _matrix == P->mat())
+  {
+    _prec->compute();
+    return;
+  }
+
   Ifpack2::Factory prec_factory;
 
   _prec = prec_factory.create(_name, P->mat());
@@ -68,6 +75,7 @@ void Ifpack2Preconditioner::init(std::shared_ptr<const TpetraMatrix> P)
   _prec->setParameters(*plist);
   _prec->initialize();
   _prec->compute();
+  _matrix = P->mat();
 }
 //-----------------------------------------------------------------------------
 void Ifpack2Preconditioner::set(BelosKrylovSolver& solver)
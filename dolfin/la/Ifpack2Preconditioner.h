@@ -75,6 +75,11 @@ namespace dolfin
     // Tpetra Operator or Matrix
     Teuchos::RCP<prec_type> _prec;
 
+    // Matrix the preconditioner was created for. Tpetra matrices
+    // have a static graph, so the symbolic setup (initialize) is
+    // reused when init is called again with the same matrix.
+    Teuchos::RCP<const TpetraMatrix::matrix_type> _matrix;
+
   };
 
 }
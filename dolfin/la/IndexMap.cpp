@@ -113,6 +113,11 @@ void IndexMap::set_local_to_global(const std::vector<std::size_t>& indices)
 {
   _local_to_global = indices;
 
+  // Neighbourhood depends on unowned indices
+  _neighbourhood_comm.reset();
+  _neighbourhood_sources.clear();
+  _neighbourhood_destinations.clear();
+
   for (const auto &node : _local_to_global)
   {
     const std::size_t p = global_index_owner(node);
@@ -144,3 +149,75 @@ MPI_Comm IndexMap::mpi_comm() const
   return _mpi_comm.comm();
 }
 //----------------------------------------------------------------------------
+MPI_Comm IndexMap::neighbourhood_comm() const
+{
+  if (_neighbourhood_comm)
+    return _neighbourhood_comm->comm();
+
+  // Destinations are the owners of unowned indices
+  _neighbourhood_destinations.assign(_off_process_owner.begin(),
+                                     _off_process_owner.end());
+  std::sort(_neighbourhood_destinations.begin(),
+            _neighbourhood_destinations.end());
+  _neighbourhood_destinations.erase(
+    std::unique(_neighbourhood_destinations.begin(),
+                _neighbourhood_destinations.end()),
+    _neighbourhood_destinations.end());
+
+  // Sources are the processes which have this process as a
+  // destination
+  const std::size_t num_processes = _mpi_comm.size();
+  std::vector<std::vector<int>> send(num_processes);
+  for (auto p : _neighbourhood_destinations)
+    send[p].push_back(1);
+  std::vector<std::vector<int>> recv;
+  MPI::all_to_all(_mpi_comm.comm(), send, recv);
+  _neighbourhood_sources.clear();
+  for (std::size_t p = 0; p < recv.size(); ++p)
+  {
+    if (!recv[p].empty())
+      _neighbourhood_sources.push_back(p);
+  }
+
+  #ifdef HAS_MPI
+  // Create communicator with distributed graph topology (keeping the
+  // ranks of the parent communicator)
+  MPI_Comm graph_comm;
+  MPI_Dist_graph_create_adjacent(_mpi_comm.comm(),
+                                 _neighbourhood_sources.size(),
+                                 _neighbourhood_sources.data(),
+                                 MPI_UNWEIGHTED,
+                                 _neighbourhood_destinations.size(),
+                                 _neighbourhood_destinations.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, 0,
+                                 &graph_comm);
+  _neighbourhood_comm = std::make_shared<MPI::Comm>(graph_comm);
+  MPI_Comm_free(&graph_comm);
+  #else
+  _neighbourhood_comm = std::make_shared<MPI::Comm>(_mpi_comm.comm());
+  #endif
+
+  return _neighbourhood_comm->comm();
+}
+//----------------------------------------------------------------------------
+const std::vector<int>& IndexMap::neighbourhood_sources() const
+{
+  neighbourhood_comm();
+  return _neighbourhood_sources;
+}
+//----------------------------------------------------------------------------
+const std::vector<int>& IndexMap::neighbourhood_destinations() const
+{
+  neighbourhood_comm();
+  return _neighbourhood_destinations;
+}
+//----------------------------------------------------------------------------
+std::size_t IndexMap::memory_usage() const
+{
+  return sizeof(*this) + _all_ranges.capacity()*sizeof(std::size_t)
+    + _local_to_global.capacity()*sizeof(std::size_t)
+    + _off_process_owner.capacity()*sizeof(int)
+    + _neighbourhood_sources.capacity()*sizeof(int)
+    + _neighbourhood_destinations.capacity()*sizeof(int);
+}
+//----------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 #ifndef __INDEX_MAP_H
 #define __INDEX_MAP_H
 
+#include <memory>
 #include <utility>
 #include <vector>
 #include <dolfin/common/MPI.h>
@@ -91,6 +92,25 @@ namespace dolfin
     /// Return MPI communicator
     MPI_Comm mpi_comm() const;
 
+    /// Return communicator with a distributed graph topology
+    /// connecting this process to the owners of its unowned indices
+    /// (destinations) and to the processes with unowned copies of
+    /// its owned indices (sources). The communicator is created on
+    /// the first call, which is collective, and reused by later
+    /// calls until the local-to-global map is changed.
+    MPI_Comm neighbourhood_comm() const;
+
+    /// Return sources of the neighbourhood communicator (processes
+    /// with unowned copies of owned indices)
+    const std::vector<int>& neighbourhood_sources() const;
+
+    /// Return destinations of the neighbourhood communicator (owners
+    /// of unowned indices)
+    const std::vector<int>& neighbourhood_destinations() const;
+
+    /// Return estimate of memory used on this process in bytes
+    std::size_t memory_usage() const;
+
   private:
 
     // MPI Communicator
@@ -112,6 +132,12 @@ namespace dolfin
     // Block size
     int _block_size;
 
+    // Neighbourhood communicator and its sources and destinations
+    // (computed on demand)
+    mutable std::shared_ptr<MPI::Comm> _neighbourhood_comm;
+    mutable std::vector<int> _neighbourhood_sources;
+    mutable std::vector<int> _neighbourhood_destinations;
+
   };
 
   // Function which may appear in a hot loop
@@ -42,6 +42,22 @@ Parameters KrylovSolver::default_parameters()
   p.add<bool>("error_on_nonconvergence");
   p.add<bool>("nonzero_initial_guess");
 
+  // Iterative refinement of the solution, e.g. around a solve with a
+  // loose relative tolerance (zero steps means none)
+  p.add("iterative_refinement_steps", 0, 0, 100);
+  p.add("iterative_refinement_tolerance", 1e-12);
+
+  // Preconditioner reuse when the operator changes: rebuild always
+  // ("none"), after "reuse_steps" solves ("steps"), when the number
+  // of iterations has grown by more than the fraction
+  // "reuse_iteration_growth" ("iterations") or reuse the symbolic
+  // setup only ("symbolic")
+  std::set<std::string> reuse_policies
+    = {"none", "steps", "iterations", "symbolic"};
+  p.add("reuse_policy", "none", reuse_policies);
+  p.add("reuse_steps", 5, 1, 1000000);
+  p.add("reuse_iteration_growth", 0.5);
+
   return p;
 }
 //-----------------------------------------------------------------------------
@@ -87,6 +103,7 @@ KrylovSolver::set_operator(std::shared_ptr<const GenericLinearOperator> A)
   dolfin_assert(solver);
   solver->parameters.update(parameters);
   solver->set_operator(A);
+  _matA = A;
 }
 //-----------------------------------------------------------------------------
 void
@@ -96,6 +113,7 @@ KrylovSolver::set_operators(std::shared_ptr<const GenericLinearOperator> A,
   dolfin_assert(solver);
   solver->parameters.update(parameters);
   solver->set_operators(A, P);
+  _matA = A;
 }
 //-----------------------------------------------------------------------------
 std::size_t KrylovSolver::solve(GenericVector& x, const GenericVector& b)
@@ -103,7 +121,18 @@ std::size_t KrylovSolver::solve(GenericVector& x, const GenericVector& b)
   dolfin_assert(solver);
   Timer timer("Krylov solver");
   solver->parameters.update(parameters);
-  return solver->solve(x, b);
+  std::size_t num_iterations = solver->solve(x, b);
+
+  // Refine solution
+  const int num_steps = parameters["iterative_refinement_steps"];
+  if (num_steps > 0)
+  {
+    dolfin_assert(_matA);
+    iterative_refinement(*solver, *_matA, x, b, num_steps,
+                         parameters["iterative_refinement_tolerance"]);
+  }
+
+  return num_iterations;
 }
 //-----------------------------------------------------------------------------
 std::size_t KrylovSolver::solve(const GenericLinearOperator& A,
@@ -112,7 +141,41 @@ std::size_t KrylovSolver::solve(const GenericLinearOperator& A,
   dolfin_assert(solver);
   Timer timer("Krylov solver");
   solver->parameters.update(parameters);
-  return solver->solve(A, x, b);
+  std::size_t num_iterations = solver->solve(A, x, b);
+
+  // Refine solution (the solver operator is now A)
+  const int num_steps = parameters["iterative_refinement_steps"];
+  if (num_steps > 0)
+  {
+    iterative_refinement(*solver, A, x, b, num_steps,
+                         parameters["iterative_refinement_tolerance"]);
+  }
+
+  return num_iterations;
+}
+//-----------------------------------------------------------------------------
+std::size_t
+KrylovSolver::solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                    const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  dolfin_assert(solver);
+  Timer timer("Krylov solver");
+  solver->parameters.update(parameters);
+  std::size_t num_iterations = solver->solve(x, b);
+
+  // Refine solutions
+  const int num_steps = parameters["iterative_refinement_steps"];
+  if (num_steps > 0)
+  {
+    dolfin_assert(_matA);
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+      iterative_refinement(*solver, *_matA, *x[i], *b[i], num_steps,
+                           parameters["iterative_refinement_tolerance"]);
+    }
+  }
+
+  return num_iterations;
 }
 //-----------------------------------------------------------------------------
 void KrylovSolver::init(std::string method, std::string preconditioner,
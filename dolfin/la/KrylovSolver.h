@@ -76,6 +76,10 @@ namespace dolfin
     std::size_t solve(const GenericLinearOperator& A,
                       GenericVector& x, const GenericVector& b);
 
+    /// Solve linear systems Ax_i = b_i for several right-hand sides
+    std::size_t solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                      const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Default parameter values
     static Parameters default_parameters();
 
@@ -103,6 +107,9 @@ namespace dolfin
     // Solver
     std::shared_ptr<GenericLinearSolver> solver;
 
+    // Operator (used for iterative refinement)
+    std::shared_ptr<const GenericLinearOperator> _matA;
+
   };
 }
 
@@ -62,6 +62,7 @@ void LUSolver::set_operator(std::shared_ptr<const GenericLinearOperator> A)
   dolfin_assert(solver);
   solver->parameters.update(parameters);
   solver->set_operator(A);
+  _matA = A;
 }
 //-----------------------------------------------------------------------------
 std::size_t LUSolver::solve(GenericVector& x, const GenericVector& b)
@@ -70,7 +71,18 @@ std::size_t LUSolver::solve(GenericVector& x, const GenericVector& b)
 
   Timer timer("LU solver");
   solver->parameters.update(parameters);
-  return solver->solve(x, b);
+  std::size_t num_iterations = solver->solve(x, b);
+
+  // Refine solution
+  const int num_steps = parameters["iterative_refinement_steps"];
+  if (num_steps > 0)
+  {
+    dolfin_assert(_matA);
+    iterative_refinement(*solver, *_matA, x, b, num_steps,
+                         parameters["iterative_refinement_tolerance"]);
+  }
+
+  return num_iterations;
 }
 //-----------------------------------------------------------------------------
 std::size_t LUSolver::solve(const GenericLinearOperator& A, GenericVector& x,
@@ -80,7 +92,42 @@ std::size_t LUSolver::solve(const GenericLinearOperator& A, GenericVector& x,
 
   Timer timer("LU solver");
   solver->parameters.update(parameters);
-  return solver->solve(A, x, b);
+  std::size_t num_iterations = solver->solve(A, x, b);
+
+  // Refine solution (the solver operator is now A)
+  const int num_steps = parameters["iterative_refinement_steps"];
+  if (num_steps > 0)
+  {
+    iterative_refinement(*solver, A, x, b, num_steps,
+                         parameters["iterative_refinement_tolerance"]);
+  }
+
+  return num_iterations;
+}
+//-----------------------------------------------------------------------------
+std::size_t
+LUSolver::solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  dolfin_assert(solver);
+
+  Timer timer("LU solver");
+  solver->parameters.update(parameters);
+  std::size_t num_iterations = solver->solve(x, b);
+
+  // Refine solutions
+  const int num_steps = parameters["iterative_refinement_steps"];
+  if (num_steps > 0)
+  {
+    dolfin_assert(_matA);
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+      iterative_refinement(*solver, *_matA, *x[i], *b[i], num_steps,
+                           parameters["iterative_refinement_tolerance"]);
+    }
+  }
+
+  return num_iterations;
 }
 //-----------------------------------------------------------------------------
 void LUSolver::init(MPI_Comm comm, std::string method)
@@ -20,6 +20,7 @@
 
 #include <string>
 #include <memory>
+#include <set>
 #include "GenericLinearSolver.h"
 #include <dolfin/common/MPI.h>
 
@@ -64,6 +65,10 @@ namespace dolfin
     std::size_t solve(const GenericLinearOperator& A, GenericVector& x,
                       const GenericVector& b);
 
+    /// Solve linear systems Ax_i = b_i for several right-hand sides
+    std::size_t solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                      const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Default parameter values
     static Parameters default_parameters()
     {
@@ -73,6 +78,21 @@ namespace dolfin
       p.add("symmetric", false);
       p.add("same_nonzero_pattern", false);   // deprecated
       p.add("reuse_factorization", false);   // deprecated
+
+      // Iterative refinement of the solution (zero steps means none)
+      p.add("iterative_refinement_steps", 0, 0, 100);
+      p.add("iterative_refinement_tolerance", 1e-12);
+
+      // Factorization reuse when the operator changes (see
+      // KrylovSolver). A reused factorization is exact only for the
+      // operator it was computed for, so reuse is usually combined
+      // with iterative refinement
+      std::set<std::string> reuse_policies
+        = {"none", "steps", "iterations", "symbolic"};
+      p.add("reuse_policy", "none", reuse_policies);
+      p.add("reuse_steps", 5, 1, 1000000);
+      p.add("reuse_iteration_growth", 0.5);
+
       return p;
     }
 
@@ -96,6 +116,9 @@ namespace dolfin
     // Solver
     std::shared_ptr<GenericLinearSolver> solver;
 
+    // Operator (used for iterative refinement)
+    std::shared_ptr<const GenericLinearOperator> _matA;
+
   };
 }
 
@@ -57,6 +57,15 @@ namespace dolfin
     /// Compute matrix-vector product y = Ax
     virtual void mult(const GenericVector& x, GenericVector& y) const = 0;
 
+    /// Get diagonal of operator. Users may overload this function
+    /// to enable diagonal (Jacobi) preconditioning of the operator.
+    virtual void get_diagonal(GenericVector& x) const
+    {
+      dolfin_error("LinearOperator.h",
+                   "get diagonal of linear operator",
+                   "get_diagonal() is not implemented for this operator");
+    }
+
     /// Return the MPI communicator
     virtual MPI_Comm mpi_comm() const
     { dolfin_assert(_matA); return _matA->mpi_comm(); }
@@ -138,6 +138,15 @@ std::size_t LinearSolver::solve(GenericVector& x, const GenericVector& b)
   return solver->solve(x, b);
 }
 //-----------------------------------------------------------------------------
+std::size_t
+LinearSolver::solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                    const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  dolfin_assert(solver);
+  solver->parameters.update(parameters);
+  return solver->solve(x, b);
+}
+//-----------------------------------------------------------------------------
 bool LinearSolver::in_list(const std::string& method,
                            const std::map<std::string, std::string>& methods)
 {
@@ -73,6 +73,10 @@ namespace dolfin
     /// Solve linear system Ax = b
     std::size_t solve(GenericVector& x, const GenericVector& b);
 
+    /// Solve linear systems Ax_i = b_i for several right-hand sides
+    std::size_t solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                      const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Default parameter values
     static Parameters default_parameters()
     {
@@ -0,0 +1,118 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __LOCAL_VECTOR_ARRAY_H
+#define __LOCAL_VECTOR_ARRAY_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <dolfin/log/log.h>
+#include "GenericVector.h"
+
+namespace dolfin
+{
+
+  /// This class provides direct (zero-copy) access to the local
+  /// values of a vector for the lifetime of the object. The owned
+  /// values come first, followed by the ghost values if the array is
+  /// ghosted. Use LocalVectorArray<double> for read-write access and
+  /// LocalVectorArray<const double> for read-only access.
+  ///
+  /// Changes to ghost values are local; they are not communicated to
+  /// the owning processes. For read-only access to a vector whose
+  /// backend does not provide direct access, the owned values are
+  /// copied.
+
+  template<typename T>
+  class LocalVectorArray
+  {
+  public:
+
+    /// Vector type (const for read-only access)
+    typedef typename std::conditional<std::is_const<T>::value,
+                                      const GenericVector,
+                                      GenericVector>::type vector_type;
+
+    /// Create array view of the local values of x, including ghost
+    /// values if ghosted is true
+    explicit LocalVectorArray(vector_type& x, bool ghosted=false)
+      : _x(x), _ghosted(ghosted), _size(0), _data(nullptr), _direct(true)
+    {
+      _data = _x.get_local_array(_size, _ghosted);
+      if (!_data)
+      {
+        _direct = false;
+        if (!std::is_const<T>::value or _ghosted)
+        {
+          dolfin_error("LocalVectorArray.h",
+                       "access local vector values",
+                       "Direct access is not supported by the linear "
+                       "algebra backend");
+        }
+        _x.get_local(_copy);
+        _size = _copy.size();
+        _data = _copy.data();
+      }
+    }
+
+    /// Destructor (releases access to the vector values)
+    ~LocalVectorArray()
+    {
+      if (_direct)
+        _x.restore_local_array(_data, _ghosted);
+    }
+
+    /// Return number of accessible values
+    std::size_t size() const
+    { return _size; }
+
+    /// Return pointer to the local values
+    T* data() const
+    { return _data; }
+
+    /// Access value of given local entry
+    T& operator[] (std::size_t i) const
+    { return _data[i]; }
+
+  private:
+
+    // Not copyable
+    LocalVectorArray(const LocalVectorArray&);
+    LocalVectorArray& operator=(const LocalVectorArray&);
+
+    // The vector
+    vector_type& _x;
+
+    // True if ghost values are accessible
+    const bool _ghosted;
+
+    // Number of accessible values and pointer to them
+    std::size_t _size;
+    T* _data;
+
+    // False if the values are a copy (backend without direct access)
+    bool _direct;
+
+    // Copy of the values when direct access is not supported
+    std::vector<double> _copy;
+
+  };
+
+}
+
+#endif
@@ -90,6 +90,10 @@ namespace dolfin
     MPI_Comm mpi_comm() const
     { return matrix->mpi_comm(); }
 
+    /// Return estimate of memory used on this process in bytes
+    virtual std::size_t memory_usage() const
+    { return matrix->memory_usage(); }
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const
     { return "<Matrix wrapper of " + matrix->str(verbose) + ">"; }
@@ -139,6 +143,12 @@ namespace dolfin
                            std::size_t n, const dolfin::la_index* cols)
     { matrix->add_local(block, m, rows, n, cols); }
 
+    /// Add a batch of blocks of values using local indices
+    virtual void
+      add_local_blocks(const double* blocks, std::size_t num_blocks,
+                       const std::vector<ArrayView<const dolfin::la_index>>& rows)
+    { matrix->add_local_blocks(blocks, num_blocks, rows); }
+
     /// Add multiple of given matrix (AXPY operation)
     virtual void axpy(double a, const GenericMatrix& A,
                       bool same_nonzero_pattern)
@@ -40,17 +40,31 @@ MueluPreconditioner::~MueluPreconditioner()
 //-----------------------------------------------------------------------------
 void MueluPreconditioner::init(std::shared_ptr<const TpetraMatrix> P)
 {
+  // FIXME: why does it need to be non-const when Ifpack2 uses const?
+  std::shared_ptr<TpetraMatrix> P_non_const
+    = std::const_pointer_cast<TpetraMatrix>(P);
+
+  // Same matrix (and hence same static graph): update the existing
+  // hierarchy, reusing as much of the setup as "reuse: type" allows
+  if (!_prec.is_null() and _matrix == P->mat())
+  {
+    MueLu::ReuseTpetraPreconditioner(P_non_const->mat(), *_prec);
+    return;
+  }
+
   // Generate Trilinos parameters from dolfin parameters
   Teuchos::RCP<Teuchos::ParameterList> paramList(new Teuchos::ParameterList);
   TrilinosParameters::insert_parameters(parameters, paramList);
 
-  // FIXME: why does it need to be non-const when Ifpack2 uses const?
-  std::shared_ptr<TpetraMatrix> P_non_const
-    = std::const_pointer_cast<TpetraMatrix>(P);
+  // Keep symbolic information (aggregates) for reuse unless set by
+  // the user
+  if (!paramList->isParameter("reuse: type"))
+    paramList->set("reuse: type", "S");
 
   _prec = MueLu::CreateTpetraPreconditioner(
                 Teuchos::rcp_dynamic_cast<op_type>(P_non_const->mat()),
                 *paramList);
+  _matrix = P->mat();
 }
 //-----------------------------------------------------------------------------
 void MueluPreconditioner::set(BelosKrylovSolver& solver)
@@ -72,6 +72,11 @@ namespace dolfin
     // or Matrix
     Teuchos::RCP<prec_type> _prec;
 
+    // Matrix the preconditioner was created for (the hierarchy is
+    // reused, see "reuse: type", when init is called again with the
+    // same matrix)
+    Teuchos::RCP<const TpetraMatrix::matrix_type> _matrix;
+
   };
 
 }
@@ -22,6 +22,9 @@
 
 #ifdef HAS_PETSC
 
+#include <string>
+#include <petscsys.h>
+#include "PETScObject.h"
 #include "SparsityPattern.h"
 #include "PETScLUSolver.h"
 #include "PETScMatrix.h"
@@ -51,7 +54,24 @@ PETScFactory::create_layout(MPI_Comm comm, std::size_t rank) const
   TensorLayout::Sparsity sparsity = TensorLayout::Sparsity::DENSE;
   if (rank > 1)
     sparsity = TensorLayout::Sparsity::SPARSE;
-  return std::make_shared<TensorLayout>(comm, 0, sparsity);
+
+  // Build a pattern of blocks if a block matrix type (baij, sbaij)
+  // has been requested through the PETSc options database
+  TensorLayout::Blocking blocking = TensorLayout::Blocking::UNBLOCKED;
+  char mat_type[256];
+  PetscBool is_set = PETSC_FALSE;
+  PetscErrorCode ierr = PetscOptionsGetString(NULL, NULL, "-mat_type",
+                                              mat_type, sizeof(mat_type),
+                                              &is_set);
+  if (ierr != 0)
+    PETScObject::petsc_error(ierr, __FILE__, "PetscOptionsGetString");
+  if (rank > 1 && is_set && std::string(mat_type).find("baij")
+      != std::string::npos)
+  {
+    blocking = TensorLayout::Blocking::BLOCKED;
+  }
+
+  return std::make_shared<TensorLayout>(comm, 0, sparsity, blocking);
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<GenericLinearOperator>
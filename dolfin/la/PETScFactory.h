@@ -80,6 +80,10 @@ namespace dolfin
     /// Return a list of available preconditioners
     std::map<std::string, std::string> krylov_solver_preconditioners() const;
 
+    /// PETSc matrices can be preallocated from row counts
+    bool supports_row_count_preallocation() const
+    { return true; }
+
     /// Return singleton instance
     static PETScFactory& instance()
     { return factory; }
@@ -21,12 +21,15 @@
 
 #ifdef HAS_PETSC
 
+#include <algorithm>
+#include <chrono>
 #include <petsclog.h>
 
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/fem/PETScDMCollection.h>
+#include <dolfin/log/SolverTelemetry.h>
 #include "GenericMatrix.h"
 #include "GenericVector.h"
 #include "KrylovSolver.h"
@@ -48,6 +51,11 @@ const std::map<std::string, const KSPType> PETScKrylovSolver::_methods
     {"tfqmr",      KSPTFQMR},
     {"richardson", KSPRICHARDSON},
     {"bicgstab",   KSPBCGS},
+    {"pipecg",     KSPPIPECG},
+    {"pgmres",     KSPPGMRES},
+    #if PETSC_VERSION_MAJOR > 3 || (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8)
+    {"pipegcr",    KSPPIPEGCR},
+    #endif
     #if PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR <= 7 && PETSC_VERSION_RELEASE == 1
     {"nash",       KSPNASH},
     {"stcg",       KSPSTCG}
@@ -64,7 +72,12 @@ PETScKrylovSolver::_methods_descr
   {"minres",     "Minimal residual method"},
   {"tfqmr",      "Transpose-free quasi-minimal residual method"},
   {"richardson", "Richardson method"},
-  {"bicgstab",   "Biconjugate gradient stabilized method"} };
+  {"bicgstab",   "Biconjugate gradient stabilized method"},
+  {"pipecg",     "Pipelined conjugate gradient method"},
+  #if PETSC_VERSION_MAJOR > 3 || (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8)
+  {"pipegcr",    "Pipelined generalized conjugate residual method"},
+  #endif
+  {"pgmres",     "Pipelined generalized minimal residual method"} };
 
 //-----------------------------------------------------------------------------
 std::map<std::string, std::string> PETScKrylovSolver::methods()
@@ -91,7 +104,9 @@ Parameters PETScKrylovSolver::default_parameters()
 //-----------------------------------------------------------------------------
 PETScKrylovSolver::PETScKrylovSolver(MPI_Comm comm, std::string method,
                                      std::string preconditioner)
-  : _ksp(NULL), preconditioner_set(false)
+  : _ksp(NULL), preconditioner_set(false), _reuse_count(0),
+    _reuse_iterations(0), _last_iterations(0), _pc_matrix(NULL),
+    _pc_state(0)
 {
    // Check that the requested method is known
   if (_methods.find(method) == _methods.end())
@@ -131,7 +146,8 @@ PETScKrylovSolver::PETScKrylovSolver(std::string method,
 PETScKrylovSolver::PETScKrylovSolver(MPI_Comm comm, std::string method,
   std::shared_ptr<PETScPreconditioner> preconditioner)
   : _ksp(NULL), _preconditioner(preconditioner),
-  preconditioner_set(false)
+  preconditioner_set(false), _reuse_count(0), _reuse_iterations(0),
+  _last_iterations(0), _pc_matrix(NULL), _pc_state(0)
 {
   // Set parameter values
   parameters = default_parameters();
@@ -158,7 +174,12 @@ PETScKrylovSolver::PETScKrylovSolver(std::string method,
 }
 //-----------------------------------------------------------------------------
 PETScKrylovSolver::PETScKrylovSolver(KSP ksp) : _ksp(ksp),
-                                                preconditioner_set(true)
+                                                preconditioner_set(true),
+                                                _reuse_count(0),
+                                                _reuse_iterations(0),
+                                                _last_iterations(0),
+                                                _pc_matrix(NULL),
+                                                _pc_state(0)
 {
   // Set parameter values
   this->parameters = default_parameters();
@@ -315,6 +336,9 @@ std::size_t PETScKrylovSolver::solve(PETScVector& x, const PETScVector& b,
     set_norm_type(get_norm_type(convergence_norm_type));
   }
 
+  // Decide whether to rebuild the preconditioner
+  apply_reuse_policy();
+
   // Initialize solution vector, if necessary
   if (x.empty())
   {
@@ -334,17 +358,90 @@ std::size_t PETScKrylovSolver::solve(PETScVector& x, const PETScVector& b,
         M, N);
   }
 
+  // If the operator is on a device and x or b are host vectors
+  // (e.g. ghosted vectors), solve with device copies of x and b so
+  // that the data is transferred once per solve
+  Vec _x = x.vec();
+  Vec _b = b.vec();
+  MatType mat_type = nullptr;
+  VecType x_type = nullptr, b_type = nullptr;
+  MatGetType(_A, &mat_type);
+  VecGetType(_x, &x_type);
+  VecGetType(_b, &b_type);
+  const bool stage = mat_type and is_device_type(mat_type)
+    and !(is_device_type(x_type) and is_device_type(b_type));
+  if (stage)
+  {
+    ierr = MatCreateVecs(_A, &_x, &_b);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatCreateVecs");
+    ierr = VecCopy(b.vec(), _b);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "VecCopy");
+    ierr = VecCopy(x.vec(), _x);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "VecCopy");
+  }
+
+  // Set up preconditioner separately to measure setup time, and
+  // record residual history (if telemetry is enabled)
+  const bool telemetry = SolverTelemetry::enabled();
+  SolverRecord record;
+  if (telemetry)
+  {
+    record.solver = "krylov";
+    record.name = get_options_prefix().empty() ? name()
+      : get_options_prefix();
+
+    // The preconditioner is rebuilt if the preconditioner matrix
+    // has changed, unless it is reused
+    PetscObjectState state;
+    ierr = PetscObjectStateGet((PetscObject)_P, &state);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectStateGet");
+    PetscBool reuse = PETSC_FALSE;
+    ierr = KSPGetReusePreconditioner(_ksp, &reuse);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPGetReusePreconditioner");
+    record.preconditioner_rebuilt = _P != _pc_matrix
+      or (!reuse and state != _pc_state);
+    _pc_matrix = _P;
+    _pc_state = state;
+
+    PetscInt max_it = 0;
+    ierr = KSPGetTolerances(_ksp, NULL, NULL, NULL, &max_it);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPGetTolerances");
+    _residual_history.resize(max_it + 1);
+    ierr = KSPSetResidualHistory(_ksp, _residual_history.data(),
+                                 _residual_history.size(), PETSC_TRUE);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPSetResidualHistory");
+
+    const auto t0 = std::chrono::steady_clock::now();
+    ierr = KSPSetUp(_ksp);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPSetUp");
+    const std::chrono::duration<double> t
+      = std::chrono::steady_clock::now() - t0;
+    record.setup_time = t.count();
+  }
+  const auto solve_start = std::chrono::steady_clock::now();
+
   // Solve system
   if (!transpose)
   {
-    ierr =  KSPSolve(_ksp, b.vec(), x.vec());
+    ierr =  KSPSolve(_ksp, _b, _x);
     if (ierr != 0) petsc_error(ierr, __FILE__, "KSPSolve");
   }
   else
   {
-    ierr =  KSPSolveTranspose(_ksp, b.vec(), x.vec());
+    ierr =  KSPSolveTranspose(_ksp, _b, _x);
     if (ierr != 0) petsc_error(ierr, __FILE__, "KSPSolve");
   }
+  const std::chrono::duration<double> solve_time
+    = std::chrono::steady_clock::now() - solve_start;
+
+  // Copy solution back to host vector
+  if (stage)
+  {
+    ierr = VecCopy(_x, x.vec());
+    if (ierr != 0) petsc_error(ierr, __FILE__, "VecCopy");
+    VecDestroy(&_x);
+    VecDestroy(&_b);
+  }
 
   // Update ghost values in solution vector
   x.update_ghost_values();
@@ -354,11 +451,35 @@ std::size_t PETScKrylovSolver::solve(PETScVector& x, const PETScVector& b,
   ierr = KSPGetIterationNumber(_ksp, &num_iterations);
   if (ierr != 0) petsc_error(ierr, __FILE__, "KSPGetIterationNumber");
 
+  // Record iterations for the reuse policy
+  if (_reuse_count == 0)
+    _reuse_iterations = num_iterations;
+  _last_iterations = num_iterations;
+  ++_reuse_count;
+
   // Check if the solution converged and print error/warning if not
   // converged
   KSPConvergedReason reason;
   ierr = KSPGetConvergedReason(_ksp, &reason);
   if (ierr != 0) petsc_error(ierr, __FILE__, "KSPGetConvergedReason");
+
+  // Record telemetry (before raising an error on non-convergence)
+  if (telemetry)
+  {
+    PetscReal* history = NULL;
+    PetscInt num_history = 0;
+    ierr = KSPGetResidualHistory(_ksp, &history, &num_history);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPGetResidualHistory");
+    record.residuals.assign(_residual_history.begin(),
+                            _residual_history.begin() + num_history);
+    record.iterations = num_iterations;
+    record.converged = reason > 0;
+    record.reason = KSPConvergedReasons[reason];
+    record.solve_time = solve_time.count();
+    record.time = SolverTelemetry::time();
+    SolverTelemetry::record(record);
+  }
+
   if (reason < 0)
   {
     // Get solver residual norm
@@ -439,10 +560,42 @@ void PETScKrylovSolver::set_norm_type(norm_type type)
                  "Unknown norm type");
   }
 
+  // The pipelined CG/GCR methods overlap the (unpreconditioned)
+  // residual norm reduction with the matrix-vector product and do
+  // not support the preconditioned norm
+  if (ksp_norm_type == KSP_NORM_PRECONDITIONED and pipelined())
+  {
+    PetscBool is_pgmres = PETSC_FALSE;
+    PetscObjectTypeCompare((PetscObject)_ksp, KSPPGMRES, &is_pgmres);
+    if (!is_pgmres)
+    {
+      warning("Preconditioned norm not supported by pipelined Krylov method. "
+              "Using unpreconditioned norm");
+      ksp_norm_type = KSP_NORM_UNPRECONDITIONED;
+    }
+  }
+
   dolfin_assert(_ksp);
   KSPSetNormType(_ksp, ksp_norm_type);
 }
 //-----------------------------------------------------------------------------
+bool PETScKrylovSolver::pipelined() const
+{
+  dolfin_assert(_ksp);
+  PetscBool is_pipelined = PETSC_FALSE;
+  #if PETSC_VERSION_MAJOR > 3 || (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8)
+  PetscErrorCode ierr
+    = PetscObjectTypeCompareAny((PetscObject)_ksp, &is_pipelined, KSPPIPECG,
+                                KSPPGMRES, KSPPIPEGCR, "");
+  #else
+  PetscErrorCode ierr
+    = PetscObjectTypeCompareAny((PetscObject)_ksp, &is_pipelined, KSPPIPECG,
+                                KSPPGMRES, "");
+  #endif
+  if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectTypeCompareAny");
+  return is_pipelined == PETSC_TRUE;
+}
+//-----------------------------------------------------------------------------
 void PETScKrylovSolver::set_dm(DM dm)
 {
   dolfin_assert(_ksp);
@@ -601,6 +754,51 @@ std::size_t PETScKrylovSolver::_solve(const PETScBaseMatrix& A, PETScVector& x,
   return num_iter;
 }
 //-----------------------------------------------------------------------------
+void PETScKrylovSolver::apply_reuse_policy()
+{
+  const std::string policy = parameters["reuse_policy"];
+  if (policy == "none")
+    return;
+
+  // Reuse the preconditioner (or factorization) built for an earlier
+  // operator
+  bool reuse = false;
+  if (_reuse_count == 0)
+    reuse = false;
+  else if (policy == "steps")
+  {
+    const int max_steps = parameters["reuse_steps"];
+    reuse = _reuse_count < (std::size_t) max_steps;
+  }
+  else if (policy == "iterations")
+  {
+    const double growth = parameters["reuse_iteration_growth"];
+    reuse = (double) _last_iterations
+      <= (1.0 + growth)*(double) std::max(_reuse_iterations,
+                                          (std::size_t) 1);
+  }
+  else if (policy == "symbolic")
+  {
+    // Rebuild the numerical preconditioner, but keep the symbolic
+    // factorization (LU/Cholesky, reused by PETSc if the nonzero
+    // pattern is unchanged) or the AMG interpolation (GAMG)
+    PC pc;
+    PetscErrorCode ierr = KSPGetPC(_ksp, &pc);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "KSPGetPC");
+    PetscBool is_gamg = PETSC_FALSE;
+    PetscObjectTypeCompare((PetscObject)pc, PCGAMG, &is_gamg);
+    if (is_gamg and _reuse_count > 0)
+    {
+      ierr = PCGAMGSetReuseInterpolation(pc, PETSC_TRUE);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "PCGAMGSetReuseInterpolation");
+    }
+  }
+
+  if (!reuse)
+    _reuse_count = 0;
+  set_reuse_preconditioner(reuse);
+}
+//-----------------------------------------------------------------------------
 void PETScKrylovSolver::write_report(int num_iterations,
                                      KSPConvergedReason reason)
 {
@@ -28,6 +28,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include <petscksp.h>
 #include <dolfin/common/types.h>
 #include "GenericLinearSolver.h"
@@ -105,6 +106,10 @@ namespace dolfin
     /// underlying PETSc objects.
     void set_operators(const PETScBaseMatrix& A, const PETScBaseMatrix& P);
 
+    /// Solve linear systems Ax_i = b_i for several right-hand sides
+    /// (the preconditioner is set up once)
+    using GenericLinearSolver::solve;
+
     /// Solve linear system Ax = b and return number of iterations
     std::size_t solve(GenericVector& x, const GenericVector& b);
 
@@ -186,6 +191,13 @@ namespace dolfin
     /// Activate/deactivate DM
     void set_dm_active(bool val);
 
+    /// Return true if the Krylov method is pipelined (pipecg,
+    /// pgmres, pipegcr), i.e. the global reductions are overlapped
+    /// with the matrix-vector product and preconditioner
+    /// application. The overlap requires an MPI-3 implementation of
+    /// MPI_Iallreduce.
+    bool pipelined() const;
+
     friend class PETScSNESSolver;
     friend class PETScTAOSolver;
 
@@ -198,6 +210,10 @@ namespace dolfin
     std::size_t _solve(const PETScBaseMatrix& A, PETScVector& x,
                        const PETScVector& b);
 
+    // Set the preconditioner reuse flag from the "reuse_policy"
+    // parameter before a solve
+    void apply_reuse_policy();
+
     // Report the number of iterations
     void write_report(int num_iterations, KSPConvergedReason reason);
 
@@ -218,6 +234,18 @@ namespace dolfin
 
     bool preconditioner_set;
 
+    // Number of solves since the preconditioner was built, and the
+    // iteration counts of the first and the last of these solves
+    std::size_t _reuse_count, _reuse_iterations, _last_iterations;
+
+    // Preconditioner matrix and its PETSc object state at the last
+    // solve (to detect preconditioner rebuilds for telemetry)
+    Mat _pc_matrix;
+    PetscObjectState _pc_state;
+
+    // Storage for residual history (used if telemetry is enabled)
+    std::vector<PetscReal> _residual_history;
+
   };
 
 }
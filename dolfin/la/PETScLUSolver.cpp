@@ -17,6 +17,7 @@
 
 #ifdef HAS_PETSC
 
+#include <algorithm>
 #include <petscksp.h>
 #include <petscpc.h>
 #include <dolfin/common/constants.h>
@@ -246,6 +247,13 @@ std::size_t PETScLUSolver::solve(GenericVector& x, const GenericVector& b,
         A.size(0), A.size(1), solver_type);
   }
 
+  // Pass factorization reuse policy to the wrapped solver
+  const std::string reuse_policy = parameters["reuse_policy"];
+  _solver.parameters["reuse_policy"] = reuse_policy;
+  _solver.parameters["reuse_steps"] = (int) parameters["reuse_steps"];
+  _solver.parameters["reuse_iteration_growth"]
+    = (double) parameters["reuse_iteration_growth"];
+
   return _solver.solve(x, b);
 }
 //-----------------------------------------------------------------------------
@@ -265,6 +273,127 @@ std::size_t PETScLUSolver::solve(const PETScMatrix& A, PETScVector& x,
   return solve(x, b);
 }
 //-----------------------------------------------------------------------------
+std::size_t
+PETScLUSolver::solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                     const std::vector<std::shared_ptr<const GenericVector>>& b)
+{
+  if (x.size() != b.size())
+  {
+    dolfin_error("PETScLUSolver.cpp",
+                 "solve linear systems for multiple right-hand sides",
+                 "Number of solution vectors (%d) does not match number of right-hand sides (%d)",
+                 x.size(), b.size());
+  }
+  if (x.empty())
+    return 0;
+
+  // Factorize (or update factorization according to the reuse
+  // policy) and solve for the first right-hand side
+  dolfin_assert(x[0] and b[0]);
+  std::size_t num_iterations = solve(*x[0], *b[0]);
+  if (x.size() == 1)
+    return num_iterations;
+
+  PetscErrorCode ierr;
+
+  // Get factored matrix
+  PC pc;
+  ierr = KSPGetPC(_solver.ksp(), &pc);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "KSPGetPC");
+  Mat F;
+  ierr = PCFactorGetMatrix(pc, &F);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "PCFactorGetMatrix");
+
+  // Solve one right-hand side at a time if the solver package does
+  // not support multiple right-hand sides
+  PetscBool has_mat_solve = PETSC_FALSE;
+  ierr = MatHasOperation(F, MATOP_MAT_SOLVE, &has_mat_solve);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatHasOperation");
+  if (has_mat_solve == PETSC_FALSE)
+  {
+    for (std::size_t i = 1; i < x.size(); ++i)
+    {
+      dolfin_assert(x[i] and b[i]);
+      num_iterations += solve(*x[i], *b[i]);
+    }
+    return num_iterations;
+  }
+
+  // Get operator and its dimensions
+  Mat _A, _P;
+  ierr = KSPGetOperators(_solver.ksp(), &_A, &_P);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "KSPGetOperators");
+  PetscInt m_local, M;
+  ierr = MatGetLocalSize(_A, &m_local, NULL);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatGetLocalSize");
+  ierr = MatGetSize(_A, &M, NULL);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatGetSize");
+
+  // Create dense (column-major) matrices to hold the remaining
+  // right-hand sides and solutions
+  const PetscInt k = x.size() - 1;
+  Mat B, X;
+  ierr = MatCreateDense(mpi_comm(), m_local, PETSC_DECIDE, M, k, NULL, &B);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatCreateDense");
+  ierr = MatCreateDense(mpi_comm(), m_local, PETSC_DECIDE, M, k, NULL, &X);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatCreateDense");
+
+  // Copy right-hand sides into columns of B
+  PetscScalar* B_values = NULL;
+  ierr = MatDenseGetArray(B, &B_values);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatDenseGetArray");
+  for (PetscInt j = 0; j < k; ++j)
+  {
+    dolfin_assert(b[j + 1]);
+    const PETScVector& _b = as_type<const PETScVector>(*b[j + 1]);
+    dolfin_assert((PetscInt) _b.local_size() == m_local);
+    const PetscScalar* b_values = NULL;
+    ierr = VecGetArrayRead(_b.vec(), &b_values);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "VecGetArrayRead");
+    std::copy(b_values, b_values + m_local, B_values + j*m_local);
+    ierr = VecRestoreArrayRead(_b.vec(), &b_values);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "VecRestoreArrayRead");
+  }
+  ierr = MatDenseRestoreArray(B, &B_values);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatDenseRestoreArray");
+  ierr = MatAssemblyBegin(B, MAT_FINAL_ASSEMBLY);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatAssemblyBegin");
+  ierr = MatAssemblyEnd(B, MAT_FINAL_ASSEMBLY);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatAssemblyEnd");
+
+  // Solve for all remaining right-hand sides with one call
+  ierr = MatMatSolve(F, B, X);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatMatSolve");
+
+  // Copy columns of X into solution vectors
+  PETScBaseMatrix A(_A);
+  PetscScalar* X_values = NULL;
+  ierr = MatDenseGetArray(X, &X_values);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatDenseGetArray");
+  for (PetscInt j = 0; j < k; ++j)
+  {
+    dolfin_assert(x[j + 1]);
+    PETScVector& _x = as_type<PETScVector>(*x[j + 1]);
+    if (_x.empty())
+      A.init_vector(_x, 1);
+    dolfin_assert((PetscInt) _x.local_size() == m_local);
+    PetscScalar* x_values = NULL;
+    ierr = VecGetArray(_x.vec(), &x_values);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "VecGetArray");
+    std::copy(X_values + j*m_local, X_values + (j + 1)*m_local, x_values);
+    ierr = VecRestoreArray(_x.vec(), &x_values);
+    if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "VecRestoreArray");
+    _x.update_ghost_values();
+  }
+  ierr = MatDenseRestoreArray(X, &X_values);
+  if (ierr != 0) PETScObject::petsc_error(ierr, __FILE__, "MatDenseRestoreArray");
+
+  MatDestroy(&B);
+  MatDestroy(&X);
+
+  return num_iterations;
+}
+//-----------------------------------------------------------------------------
 void PETScLUSolver::set_options_prefix(std::string options_prefix)
 {
   _solver.set_options_prefix(options_prefix);
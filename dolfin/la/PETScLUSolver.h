@@ -84,6 +84,12 @@ namespace dolfin
     std::size_t solve(const PETScMatrix& A, PETScVector& x,
                       const PETScVector& b);
 
+    /// Solve linear systems Ax_i = b_i for several right-hand sides
+    /// with one factorization (using MatMatSolve when supported by
+    /// the LU solver package)
+    std::size_t solve(const std::vector<std::shared_ptr<GenericVector>>& x,
+                      const std::vector<std::shared_ptr<const GenericVector>>& b);
+
     /// Sets the prefix used by PETSc when searching the options
     /// database
     void set_options_prefix(std::string options_prefix);
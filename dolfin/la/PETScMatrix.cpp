@@ -30,10 +30,12 @@
 #include <iostream>
 #include <numeric>
 #include <sstream>
+#include <string>
 
 #include <dolfin/log/log.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/MPI.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "PETScFactory.h"
 #include "PETScVector.h"
 #include "SparsityPattern.h"
@@ -128,41 +130,89 @@ void PETScMatrix::init(const TensorLayout& tensor_layout)
   if (block_size != tensor_layout.index_map(1)->block_size())
     block_size = 1;
 
-  // Get number of nonzeros for each row from sparsity pattern
+  // Get number of nonzeros for each row from the row counts of the
+  // layout, if set, or else from sparsity pattern
   std::vector<std::size_t> num_nonzeros_diagonal, num_nonzeros_off_diagonal;
-  sparsity_pattern->num_nonzeros_diagonal(num_nonzeros_diagonal);
-  sparsity_pattern->num_nonzeros_off_diagonal(num_nonzeros_off_diagonal);
+  const bool row_counts = tensor_layout.has_num_nonzeros();
+  if (row_counts)
+  {
+    num_nonzeros_diagonal = tensor_layout.num_nonzeros_diagonal();
+    num_nonzeros_off_diagonal = tensor_layout.num_nonzeros_off_diagonal();
+  }
+  else
+  {
+    dolfin_assert(sparsity_pattern);
+    sparsity_pattern->num_nonzeros_diagonal(num_nonzeros_diagonal);
+    sparsity_pattern->num_nonzeros_off_diagonal(num_nonzeros_off_diagonal);
+  }
 
   // Set matrix size
   ierr = MatSetSizes(_matA, m, n, M, N);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetSizes");
 
+  // Create matrix on device if requested. Entries are inserted on
+  // the host and copied to the device when first used after apply().
+  const std::string device_type = device_mat_type();
+  if (!device_type.empty())
+  {
+    ierr = MatSetType(_matA, device_type.c_str());
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetType");
+  }
+
   // Apply PETSc options from the options database to the matrix (this
   // includes changing the matrix type to one specified by the user)
   ierr = MatSetFromOptions(_matA);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetFromOptions");
 
   // Build data to initialixe sparsity pattern (modify for block size)
-  std::vector<PetscInt> _num_nonzeros_diagonal(num_nonzeros_diagonal.size()/block_size),
-    _num_nonzeros_off_diagonal(num_nonzeros_off_diagonal.size()/block_size);
-
-  for (std::size_t i = 0; i < _num_nonzeros_diagonal.size(); ++i)
+  std::vector<PetscInt> _num_nonzeros_diagonal, _num_nonzeros_off_diagonal;
+  if (!row_counts and sparsity_pattern->block_size() > 1)
   {
-    _num_nonzeros_diagonal[i]
-      = dolfin_ceil_div(num_nonzeros_diagonal[block_size*i], block_size);
+    // Pattern is stored per block, so counts are already per block
+    // row
+    dolfin_assert((int) sparsity_pattern->block_size() == block_size);
+    _num_nonzeros_diagonal.assign(num_nonzeros_diagonal.begin(),
+                                  num_nonzeros_diagonal.end());
+    _num_nonzeros_off_diagonal.assign(num_nonzeros_off_diagonal.begin(),
+                                      num_nonzeros_off_diagonal.end());
   }
-  for (std::size_t i = 0; i < _num_nonzeros_off_diagonal.size(); ++i)
+  else
   {
-    _num_nonzeros_off_diagonal[i]
-      = dolfin_ceil_div(num_nonzeros_off_diagonal[block_size*i], block_size);
+    _num_nonzeros_diagonal.resize(num_nonzeros_diagonal.size()/block_size);
+    _num_nonzeros_off_diagonal.resize(num_nonzeros_off_diagonal.size()/block_size);
+    for (std::size_t i = 0; i < _num_nonzeros_diagonal.size(); ++i)
+    {
+      _num_nonzeros_diagonal[i]
+        = dolfin_ceil_div(num_nonzeros_diagonal[block_size*i], block_size);
+    }
+    for (std::size_t i = 0; i < _num_nonzeros_off_diagonal.size(); ++i)
+    {
+      _num_nonzeros_off_diagonal[i]
+        = dolfin_ceil_div(num_nonzeros_off_diagonal[block_size*i], block_size);
+    }
   }
 
-  // Allocate space (using data from sparsity pattern)
+  // Allocate space (using data from sparsity pattern). The full block
+  // row counts are an upper bound for the upper triangular counts
+  // used by SBAIJ.
   ierr = MatXAIJSetPreallocation(_matA, block_size,
                                  _num_nonzeros_diagonal.data(),
-                                 _num_nonzeros_off_diagonal.data(), NULL, NULL);
+                                 _num_nonzeros_off_diagonal.data(),
+                                 _num_nonzeros_diagonal.data(),
+                                 _num_nonzeros_off_diagonal.data());
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatXIJSetPreallocation");
 
+  // Symmetric block storage keeps the upper triangle only, so ignore
+  // the lower triangular part of assembled element tensors
+  MatType mat_type;
+  ierr = MatGetType(_matA, &mat_type);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatGetType");
+  if (std::string(mat_type).find("sbaij") != std::string::npos)
+  {
+    ierr = MatSetOption(_matA, MAT_IGNORE_LOWER_TRIANGULAR, PETSC_TRUE);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetOption");
+  }
+
 
   // Create pointers to PETSc IndexSet for local-to-globa map
   ISLocalToGlobalMapping petsc_local_to_global0, petsc_local_to_global1;
@@ -215,6 +265,14 @@ void PETScMatrix::init(const TensorLayout& tensor_layout)
   // Keep nonzero structure after calling MatZeroRows
   ierr = MatSetOption(_matA, MAT_KEEP_NONZERO_PATTERN, PETSC_TRUE);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetOption");
+
+  // Reuse communication pattern of first assembly for off-process
+  // entries
+  if (parameters["reuse_off_process_pattern"])
+  {
+    ierr = MatSetOption(_matA, MAT_SUBSET_OFF_PROC_ENTRIES, PETSC_TRUE);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetOption");
+  }
 }
 //-----------------------------------------------------------------------------
 bool PETScMatrix::empty() const
@@ -274,6 +332,29 @@ void PETScMatrix::add_local(const double* block,
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetValuesLocal");
 }
 //-----------------------------------------------------------------------------
+void PETScMatrix::add_local_blocks(
+  const double* blocks, std::size_t num_blocks,
+  const std::vector<ArrayView<const dolfin::la_index>>& rows)
+{
+  dolfin_assert(_matA);
+  if (num_blocks == 0)
+    return;
+
+  dolfin_assert(rows.size() == 2);
+  const std::size_t m = rows[0].size()/num_blocks;
+  const std::size_t n = rows[1].size()/num_blocks;
+
+  // Insert blocks directly (no virtual dispatch per block)
+  PetscErrorCode ierr;
+  for (std::size_t k = 0; k < num_blocks; ++k)
+  {
+    ierr = MatSetValuesLocal(_matA, m, rows[0].data() + k*m,
+                             n, rows[1].data() + k*n, blocks + k*m*n,
+                             ADD_VALUES);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetValuesLocal");
+  }
+}
+//-----------------------------------------------------------------------------
 void PETScMatrix::axpy(double a, const GenericMatrix& A,
                        bool same_nonzero_pattern)
 {
@@ -634,6 +715,54 @@ void PETScMatrix::set_from_options()
   MatSetFromOptions(_matA);
 }
 //-----------------------------------------------------------------------------
+std::tuple<const PetscInt*, const PetscInt*, const double*, std::size_t>
+PETScMatrix::data() const
+{
+  dolfin_assert(_matA);
+  PetscErrorCode ierr;
+
+  // Compressed row storage is only accessible for sequential AIJ
+  // matrices
+  PetscBool is_seqaij = PETSC_FALSE;
+  ierr = PetscObjectTypeCompare((PetscObject) _matA, MATSEQAIJ, &is_seqaij);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectTypeCompare");
+  if (!is_seqaij)
+  {
+    dolfin_error("PETScMatrix.cpp",
+                 "return pointers to compressed row storage of PETSc matrix",
+                 "Matrix type is not MATSEQAIJ");
+  }
+
+  // Get row offsets and column indices (these are the arrays of the
+  // matrix for MATSEQAIJ)
+  PetscInt m = 0;
+  const PetscInt* rows = NULL;
+  const PetscInt* cols = NULL;
+  PetscBool done = PETSC_FALSE;
+  ierr = MatGetRowIJ(_matA, 0, PETSC_FALSE, PETSC_FALSE, &m, &rows, &cols,
+                     &done);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatGetRowIJ");
+  if (!done)
+  {
+    dolfin_error("PETScMatrix.cpp",
+                 "return pointers to compressed row storage of PETSc matrix",
+                 "MatGetRowIJ failed");
+  }
+  ierr = MatRestoreRowIJ(_matA, 0, PETSC_FALSE, PETSC_FALSE, &m, &rows, &cols,
+                         &done);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatRestoreRowIJ");
+
+  // Get values
+  PetscScalar* values = NULL;
+  ierr = MatSeqAIJGetArray(_matA, &values);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatSeqAIJGetArray");
+  const double* _values = values;
+  ierr = MatSeqAIJRestoreArray(_matA, &values);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatSeqAIJRestoreArray");
+
+  return std::make_tuple(rows, cols, _values, (std::size_t) rows[m]);
+}
+//-----------------------------------------------------------------------------
 const PETScMatrix& PETScMatrix::operator= (const PETScMatrix& A)
 {
   if (!A.mat())
@@ -717,6 +846,17 @@ void PETScMatrix::binary_dump(std::string file_name) const
   if (ierr != 0) petsc_error(ierr, __FILE__, "PetscViewerDestroy");
 }
 //-----------------------------------------------------------------------------
+std::size_t PETScMatrix::memory_usage() const
+{
+  if (!_matA)
+    return 0;
+
+  MatInfo info;
+  PetscErrorCode ierr = MatGetInfo(_matA, MAT_LOCAL, &info);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatGetInfo");
+  return sizeof(*this) + static_cast<std::size_t>(info.memory);
+}
+//-----------------------------------------------------------------------------
 std::string PETScMatrix::str(bool verbose) const
 {
   dolfin_assert(_matA);
@@ -33,6 +33,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 
 #include <petscmat.h>
 #include <petscsys.h>
@@ -108,6 +109,9 @@ namespace dolfin
     /// Return MPI communicator
     MPI_Comm mpi_comm() const;
 
+    /// Return estimate of memory used on this process in bytes
+    virtual std::size_t memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const;
 
@@ -152,6 +156,12 @@ namespace dolfin
                            std::size_t m, const dolfin::la_index* rows,
                            std::size_t n, const dolfin::la_index* cols);
 
+    /// Add a batch of blocks of values using local indices (see
+    /// GenericTensor::add_local_blocks)
+    virtual void
+      add_local_blocks(const double* blocks, std::size_t num_blocks,
+                       const std::vector<ArrayView<const dolfin::la_index>>& rows);
+
     /// Add multiple of given matrix (AXPY operation)
     virtual void axpy(double a, const GenericMatrix& A,
                       bool same_nonzero_pattern);
@@ -223,6 +233,14 @@ namespace dolfin
     /// Call PETSc function MatSetFromOptions on the PETSc Mat object
     void set_from_options();
 
+    /// Return pointers to the compressed row storage (row offsets,
+    /// column indices and values) and the number of nonzeros of a
+    /// sequential (MATSEQAIJ) matrix. The pointers refer to the
+    /// storage of the matrix and are valid until its sparsity
+    /// pattern is changed.
+    std::tuple<const PetscInt*, const PetscInt*, const double*, std::size_t>
+      data() const;
+
     /// Assignment operator
     const PETScMatrix& operator= (const PETScMatrix& A);
 
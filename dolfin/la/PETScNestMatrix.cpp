@@ -0,0 +1,198 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifdef HAS_PETSC
+
+#include <cmath>
+#include <sstream>
+#include <dolfin/log/log.h>
+#include "GenericMatrix.h"
+#include "GenericVector.h"
+#include "PETScVector.h"
+#include "PETScNestMatrix.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+PETScNestMatrix::PETScNestMatrix(
+  std::vector<std::shared_ptr<const GenericMatrix>> mats, bool use_mat_nest)
+  : _num_blocks(0), _matrices(mats)
+{
+  // Check that the blocks form a square array
+  const std::size_t m = std::round(std::sqrt((double) mats.size()));
+  if (m == 0 || m*m != mats.size())
+  {
+    dolfin_error("PETScNestMatrix.cpp",
+                 "create PETSc nested matrix",
+                 "Number of blocks (%d) is not a square number", mats.size());
+  }
+  _num_blocks = m;
+
+  // Get PETSc Mat objects of the blocks and the communicator
+  std::vector<Mat> petsc_mats(mats.size(), NULL);
+  MPI_Comm comm = MPI_COMM_NULL;
+  for (std::size_t i = 0; i < mats.size(); ++i)
+  {
+    if (mats[i])
+    {
+      petsc_mats[i] = as_type<const PETScMatrix>(*mats[i]).mat();
+      comm = mats[i]->mpi_comm();
+    }
+  }
+  if (comm == MPI_COMM_NULL)
+  {
+    dolfin_error("PETScNestMatrix.cpp",
+                 "create PETSc nested matrix",
+                 "All blocks are empty");
+  }
+
+  // Replace the (empty) matrix created by the base class with the
+  // nested matrix
+  PetscErrorCode ierr;
+  ierr = MatDestroy(&_matA);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatDestroy");
+  ierr = MatCreateNest(comm, m, NULL, m, NULL, petsc_mats.data(), &_matA);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatCreateNest");
+
+  // Keep index sets of the block rows and columns
+  _is_rows.resize(m);
+  _is_cols.resize(m);
+  ierr = MatNestGetISs(_matA, _is_rows.data(), _is_cols.data());
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatNestGetISs");
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    PetscObjectReference((PetscObject) _is_rows[i]);
+    PetscObjectReference((PetscObject) _is_cols[i]);
+  }
+
+  // Copy blocks into a monolithic matrix if requested
+  if (!use_mat_nest)
+  {
+    Mat A;
+    ierr = MatConvert(_matA, MATAIJ, MAT_INITIAL_MATRIX, &A);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatConvert");
+    ierr = MatDestroy(&_matA);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatDestroy");
+    _matA = A;
+  }
+}
+//-----------------------------------------------------------------------------
+PETScNestMatrix::~PETScNestMatrix()
+{
+  for (std::size_t i = 0; i < _is_rows.size(); ++i)
+  {
+    ISDestroy(&_is_rows[i]);
+    ISDestroy(&_is_cols[i]);
+  }
+}
+//-----------------------------------------------------------------------------
+void PETScNestMatrix::init_vectors(
+  GenericVector& z,
+  std::vector<std::shared_ptr<const GenericVector>> z_sub,
+  std::size_t dim) const
+{
+  dolfin_assert(_matA);
+  if (z_sub.size() != _num_blocks)
+  {
+    dolfin_error("PETScNestMatrix.cpp",
+                 "initialize vectors for PETSc nested matrix",
+                 "Number of sub-vectors (%d) does not match number of blocks (%d)",
+                 z_sub.size(), _num_blocks);
+  }
+
+  PETScVector& _z = as_type<PETScVector>(z);
+  std::vector<Vec> petsc_vecs(_num_blocks);
+  for (std::size_t i = 0; i < _num_blocks; ++i)
+    petsc_vecs[i] = as_type<const PETScVector>(*z_sub[i]).vec();
+
+  PetscErrorCode ierr;
+  MatType mat_type;
+  ierr = MatGetType(_matA, &mat_type);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatGetType");
+
+  Vec x;
+  if (std::string(mat_type) == MATNEST)
+  {
+    // Nested vector referencing the sub-vectors
+    ierr = VecCreateNest(mpi_comm(), _num_blocks, NULL, petsc_vecs.data(),
+                         &x);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "VecCreateNest");
+  }
+  else
+  {
+    // Monolithic vector with the values of the sub-vectors copied to
+    // the rows of the blocks
+    const std::vector<IS>& is = (dim == 0) ? _is_rows : _is_cols;
+    if (dim == 0)
+      ierr = MatCreateVecs(_matA, NULL, &x);
+    else
+      ierr = MatCreateVecs(_matA, &x, NULL);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatCreateVecs");
+
+    for (std::size_t i = 0; i < _num_blocks; ++i)
+    {
+      Vec sub;
+      ierr = VecGetSubVector(x, is[i], &sub);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "VecGetSubVector");
+      ierr = VecCopy(petsc_vecs[i], sub);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "VecCopy");
+      ierr = VecRestoreSubVector(x, is[i], &sub);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "VecRestoreSubVector");
+    }
+  }
+
+  // Store vector in z (which takes a reference)
+  _z.reset(x);
+  ierr = VecDestroy(&x);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "VecDestroy");
+}
+//-----------------------------------------------------------------------------
+void PETScNestMatrix::get_block_dofs(std::vector<dolfin::la_index>& dofs,
+                                     std::size_t idx) const
+{
+  if (idx >= _num_blocks)
+  {
+    dolfin_error("PETScNestMatrix.cpp",
+                 "get dofs of block of PETSc nested matrix",
+                 "Block index %d out of range (%d blocks)", idx, _num_blocks);
+  }
+
+  PetscErrorCode ierr;
+  PetscInt n;
+  const PetscInt* indices;
+  ierr = ISGetLocalSize(_is_rows[idx], &n);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "ISGetLocalSize");
+  ierr = ISGetIndices(_is_rows[idx], &indices);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "ISGetIndices");
+  dofs.assign(indices, indices + n);
+  ierr = ISRestoreIndices(_is_rows[idx], &indices);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "ISRestoreIndices");
+}
+//-----------------------------------------------------------------------------
+std::string PETScNestMatrix::str(bool verbose) const
+{
+  if (verbose)
+    return PETScMatrix::str(verbose);
+
+  std::stringstream s;
+  s << "<PETScNestMatrix with " << _num_blocks << " x " << _num_blocks
+    << " blocks of total size " << size(0) << " x " << size(1) << ">";
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+
+#endif
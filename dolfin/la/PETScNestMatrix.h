@@ -0,0 +1,102 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __PETSC_NEST_MATRIX_H
+#define __PETSC_NEST_MATRIX_H
+
+#ifdef HAS_PETSC
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <petscmat.h>
+#include <petscvec.h>
+
+#include <dolfin/common/types.h>
+#include "PETScMatrix.h"
+
+namespace dolfin
+{
+
+  class GenericMatrix;
+  class GenericVector;
+
+  /// This class is a PETSc matrix of matrix blocks (type MATNEST),
+  /// e.g. the blocks of a mixed problem assembled over the separate
+  /// sub-spaces. The blocks are referenced, not copied, so each
+  /// block keeps its own sparsity pattern and can be reassembled in
+  /// place. Field split preconditioners use the index sets of the
+  /// blocks as fields.
+
+  class PETScNestMatrix : public PETScMatrix
+  {
+  public:
+
+    /// Create nested matrix from a list of m x m blocks (row-major
+    /// order). Blocks may be null (zero blocks), but each block row
+    /// and column must contain at least one block. If use_mat_nest is
+    /// false, the blocks are copied into a monolithic (MATAIJ)
+    /// matrix instead.
+    PETScNestMatrix(std::vector<std::shared_ptr<const GenericMatrix>> mats,
+                    bool use_mat_nest=true);
+
+    /// Copy constructor (deleted, the block index sets are shared)
+    PETScNestMatrix(const PETScNestMatrix& A) = delete;
+
+    /// Destructor
+    ~PETScNestMatrix();
+
+    /// Return number of block rows (or columns)
+    std::size_t num_blocks() const
+    { return _num_blocks; }
+
+    /// Initialize z to be compatible with the matrix-vector product
+    /// y = Ax as a nested vector (type VECNEST) of the vectors z_sub
+    /// (which are referenced, not copied), one per block row (dim =
+    /// 0) or column (dim = 1). If the matrix is not of type MATNEST,
+    /// the sub-vectors are copied into a monolithic vector.
+    void init_vectors(GenericVector& z,
+                      std::vector<std::shared_ptr<const GenericVector>> z_sub,
+                      std::size_t dim=1) const;
+
+    /// Get the global indices of the rows of the block row idx in the
+    /// nested matrix (owned by this process), e.g. to define fields
+    /// of a field split preconditioner
+    void get_block_dofs(std::vector<dolfin::la_index>& dofs,
+                        std::size_t idx) const;
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // Number of block rows and columns
+    std::size_t _num_blocks;
+
+    // Blocks (kept alive for the lifetime of the nested matrix)
+    std::vector<std::shared_ptr<const GenericMatrix>> _matrices;
+
+    // Index sets of the block rows and columns
+    std::vector<IS> _is_rows, _is_cols;
+
+  };
+
+}
+
+#endif
+
+#endif
@@ -21,6 +21,7 @@
 
 #include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "PETScObject.h"
 
 using namespace dolfin;
@@ -53,5 +54,66 @@ void PETScObject::petsc_error(int error_code,
                 "PETSc error code is: %d (%s)", error_code, desc);
 }
 //-----------------------------------------------------------------------------
+std::string PETScObject::device_vec_type()
+{
+  const std::string device = dolfin::parameters["petsc_device"];
+  if (device == "cuda")
+  {
+    #if defined(PETSC_HAVE_CUDA) && (PETSC_VERSION_MAJOR > 3 || (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8))
+    return VECCUDA;
+    #else
+    dolfin_error("PETScObject.cpp",
+                 "create PETSc vector on device",
+                 "PETSc has not been configured with CUDA (version 3.8 or later required)");
+    #endif
+  }
+  else if (device == "viennacl")
+  {
+    #ifdef PETSC_HAVE_VIENNACL
+    return VECVIENNACL;
+    #else
+    dolfin_error("PETScObject.cpp",
+                 "create PETSc vector on device",
+                 "PETSc has not been configured with ViennaCL");
+    #endif
+  }
+
+  return "";
+}
+//-----------------------------------------------------------------------------
+std::string PETScObject::device_mat_type()
+{
+  const std::string device = dolfin::parameters["petsc_device"];
+  if (device == "cuda")
+  {
+    #if defined(PETSC_HAVE_CUDA) && (PETSC_VERSION_MAJOR > 3 || (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8))
+    return MATAIJCUSPARSE;
+    #else
+    dolfin_error("PETScObject.cpp",
+                 "create PETSc matrix on device",
+                 "PETSc has not been configured with CUDA (version 3.8 or later required)");
+    #endif
+  }
+  else if (device == "viennacl")
+  {
+    #ifdef PETSC_HAVE_VIENNACL
+    return MATAIJVIENNACL;
+    #else
+    dolfin_error("PETScObject.cpp",
+                 "create PETSc matrix on device",
+                 "PETSc has not been configured with ViennaCL");
+    #endif
+  }
+
+  return "";
+}
+//-----------------------------------------------------------------------------
+bool PETScObject::is_device_type(std::string petsc_type)
+{
+  return petsc_type.find("cuda") != std::string::npos
+    or petsc_type.find("cusparse") != std::string::npos
+    or petsc_type.find("viennacl") != std::string::npos;
+}
+//-----------------------------------------------------------------------------
 
 #endif
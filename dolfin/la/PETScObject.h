@@ -44,6 +44,17 @@ namespace dolfin
     static void petsc_error(int error_code,
                             std::string filename,
                             std::string petsc_function);
+
+    /// Return the PETSc Vec type for the device selected by the
+    /// global parameter "petsc_device" (empty for the host)
+    static std::string device_vec_type();
+
+    /// Return the PETSc Mat type for the device selected by the
+    /// global parameter "petsc_device" (empty for the host)
+    static std::string device_mat_type();
+
+    /// Return true if the PETSc Vec or Mat type is a device type
+    static bool is_device_type(std::string petsc_type);
   };
 }
 
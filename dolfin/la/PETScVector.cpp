@@ -23,6 +23,7 @@
 
 #ifdef HAS_PETSC
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
@@ -31,6 +32,7 @@
 #include <dolfin/common/Array.h>
 #include <dolfin/common/MPI.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "SparsityPattern.h"
 #include "PETScVector.h"
 #include "PETScFactory.h"
@@ -43,6 +45,47 @@ const std::map<std::string, NormType> PETScVector::norm_types
 
 #define CHECK_ERROR(NAME) do { if (ierr != 0) petsc_error(ierr, __FILE__, NAME); } while(0)
 
+#if PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 9 && PETSC_VERSION_MINOR <= 11 && defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+#define DOLFIN_HAVE_SHARED_MEMORY_SCATTER
+#endif
+
+namespace
+{
+  // Select the scatter type of the ghost update created by
+  // VecMPISetGhost according to the global parameter
+  // "ghost_update_type". The PETSc option is only set if it has not
+  // been set by the user, and true is returned if it must be cleared
+  // after the vector has been created.
+  bool set_ghost_scatter_type()
+  {
+    const std::string type = dolfin::parameters["ghost_update_type"];
+    if (type != "shared_memory")
+      return false;
+
+    #ifdef DOLFIN_HAVE_SHARED_MEMORY_SCATTER
+    PetscErrorCode ierr;
+    PetscBool is_set = PETSC_FALSE;
+    ierr = PetscOptionsHasName(NULL, NULL, "-vecscatter_type", &is_set);
+    if (ierr != 0)
+      PETScObject::petsc_error(ierr, __FILE__, "PetscOptionsHasName");
+    if (is_set)
+      return false;
+    ierr = PetscOptionsSetValue(NULL, "-vecscatter_type", VECSCATTERMPI3);
+    if (ierr != 0)
+      PETScObject::petsc_error(ierr, __FILE__, "PetscOptionsSetValue");
+    return true;
+    #else
+    static bool warned = false;
+    if (!warned)
+    {
+      warning("Shared-memory ghost updates require PETSc 3.9-3.11 configured with MPI-3 shared memory, using messages");
+      warned = true;
+    }
+    return false;
+    #endif
+  }
+}
+
 
 //-----------------------------------------------------------------------------
 PETScVector::PETScVector() : PETScVector(MPI_COMM_WORLD)
@@ -145,6 +188,68 @@ void PETScVector::get_local(std::vector<double>& values) const
   CHECK_ERROR("VecRestoreArrayRead");
 }
 //-----------------------------------------------------------------------------
+void PETScVector::get_local_strided(double* block, std::size_t m,
+                                    dolfin::la_index offset,
+                                    dolfin::la_index stride) const
+{
+  if (m == 0)
+    return;
+
+  // Use ghosted access unless all entries are owned
+  const dolfin::la_index first = std::min(offset, offset + (dolfin::la_index) (m - 1)*stride);
+  const dolfin::la_index last = std::max(offset, offset + (dolfin::la_index) (m - 1)*stride);
+  if (first < 0 or last >= (dolfin::la_index) local_size())
+  {
+    GenericVector::get_local_strided(block, m, offset, stride);
+    return;
+  }
+
+  // Get pointer to PETSc vector data
+  dolfin_assert(_x);
+  const PetscScalar* data;
+  PetscErrorCode ierr = VecGetArrayRead(_x, &data);
+  CHECK_ERROR("VecGetArrayRead");
+
+  // Copy strided data into block
+  for (std::size_t i = 0; i < m; ++i)
+    block[i] = data[offset + (dolfin::la_index) i*stride];
+
+  // Restore array
+  ierr = VecRestoreArrayRead(_x, &data);
+  CHECK_ERROR("VecRestoreArrayRead");
+}
+//-----------------------------------------------------------------------------
+void PETScVector::set_local_strided(const double* block, std::size_t m,
+                                    dolfin::la_index offset,
+                                    dolfin::la_index stride)
+{
+  if (m == 0)
+    return;
+
+  // Use VecSetValuesLocal unless all entries are owned
+  const dolfin::la_index first = std::min(offset, offset + (dolfin::la_index) (m - 1)*stride);
+  const dolfin::la_index last = std::max(offset, offset + (dolfin::la_index) (m - 1)*stride);
+  if (first < 0 or last >= (dolfin::la_index) local_size())
+  {
+    GenericVector::set_local_strided(block, m, offset, stride);
+    return;
+  }
+
+  // Get pointer to PETSc vector data
+  dolfin_assert(_x);
+  PetscScalar* data;
+  PetscErrorCode ierr = VecGetArray(_x, &data);
+  CHECK_ERROR("VecGetArray");
+
+  // Copy block into strided data
+  for (std::size_t i = 0; i < m; ++i)
+    data[offset + (dolfin::la_index) i*stride] = block[i];
+
+  // Restore array
+  ierr = VecRestoreArray(_x, &data);
+  CHECK_ERROR("VecRestoreArray");
+}
+//-----------------------------------------------------------------------------
 void PETScVector::set_local(const std::vector<double>& values)
 {
   dolfin_assert(_x);
@@ -445,6 +550,181 @@ void PETScVector::update_ghost_values()
   CHECK_ERROR("VecGhostRestoreLocalForm");
 }
 //-----------------------------------------------------------------------------
+void PETScVector::copy_owned_values(const GenericVector& x)
+{
+  const PETScVector& v = as_type<const PETScVector>(x);
+  if (size() != v.size() || local_range() != v.local_range())
+  {
+    dolfin_error("PETScVector.cpp",
+                 "copy owned values",
+                 "Vectors must have the same parallel layout");
+  }
+
+  if (this != &v)
+  {
+    dolfin_assert(v._x);
+    dolfin_assert(_x);
+    PetscErrorCode ierr = VecCopy(v._x, _x);
+    CHECK_ERROR("VecCopy");
+  }
+}
+//-----------------------------------------------------------------------------
+void PETScVector::update_ghost_values_begin()
+{
+  dolfin_assert(_x);
+  PetscErrorCode ierr;
+
+  Vec xg;
+  ierr = VecGhostGetLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostGetLocalForm");
+  if (xg)
+  {
+    ierr = VecGhostUpdateBegin(_x, INSERT_VALUES, SCATTER_FORWARD);
+    CHECK_ERROR("VecGhostUpdateBegin");
+  }
+  ierr = VecGhostRestoreLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostRestoreLocalForm");
+}
+//-----------------------------------------------------------------------------
+void PETScVector::update_ghost_values_end()
+{
+  dolfin_assert(_x);
+  PetscErrorCode ierr;
+
+  Vec xg;
+  ierr = VecGhostGetLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostGetLocalForm");
+  if (xg)
+  {
+    ierr = VecGhostUpdateEnd(_x, INSERT_VALUES, SCATTER_FORWARD);
+    CHECK_ERROR("VecGhostUpdateEnd");
+  }
+  ierr = VecGhostRestoreLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostRestoreLocalForm");
+}
+//-----------------------------------------------------------------------------
+double* PETScVector::get_local_array(std::size_t& size, bool ghosted)
+{
+  dolfin_assert(_x);
+  PetscErrorCode ierr;
+
+  // Use the local form (owned followed by ghost values) if requested
+  // and available. The local form is held until restore_local_array.
+  Vec xg = NULL;
+  if (ghosted)
+  {
+    ierr = VecGhostGetLocalForm(_x, &xg);
+    CHECK_ERROR("VecGhostGetLocalForm");
+  }
+  Vec x = xg ? xg : _x;
+
+  PetscInt n = 0;
+  ierr = VecGetLocalSize(x, &n);
+  CHECK_ERROR("VecGetLocalSize");
+
+  PetscScalar* data = NULL;
+  ierr = VecGetArray(x, &data);
+  CHECK_ERROR("VecGetArray");
+
+  size = n;
+  return data;
+}
+//-----------------------------------------------------------------------------
+const double* PETScVector::get_local_array(std::size_t& size,
+                                           bool ghosted) const
+{
+  dolfin_assert(_x);
+  PetscErrorCode ierr;
+
+  // Use the local form (owned followed by ghost values) if requested
+  // and available. The local form is held until restore_local_array.
+  Vec xg = NULL;
+  if (ghosted)
+  {
+    ierr = VecGhostGetLocalForm(_x, &xg);
+    CHECK_ERROR("VecGhostGetLocalForm");
+  }
+  Vec x = xg ? xg : _x;
+
+  PetscInt n = 0;
+  ierr = VecGetLocalSize(x, &n);
+  CHECK_ERROR("VecGetLocalSize");
+
+  const PetscScalar* data = NULL;
+  ierr = VecGetArrayRead(x, &data);
+  CHECK_ERROR("VecGetArrayRead");
+
+  size = n;
+  return data;
+}
+//-----------------------------------------------------------------------------
+void PETScVector::restore_local_array(double* data, bool ghosted)
+{
+  dolfin_assert(_x);
+  PetscErrorCode ierr;
+
+  Vec xg = NULL;
+  if (ghosted)
+  {
+    ierr = VecGhostGetLocalForm(_x, &xg);
+    CHECK_ERROR("VecGhostGetLocalForm");
+  }
+
+  PetscScalar* _data = data;
+  if (xg)
+  {
+    ierr = VecRestoreArray(xg, &_data);
+    CHECK_ERROR("VecRestoreArray");
+
+    // Release the local form obtained here and the one held since
+    // get_local_array
+    Vec xg_held = xg;
+    ierr = VecGhostRestoreLocalForm(_x, &xg);
+    CHECK_ERROR("VecGhostRestoreLocalForm");
+    ierr = VecGhostRestoreLocalForm(_x, &xg_held);
+    CHECK_ERROR("VecGhostRestoreLocalForm");
+  }
+  else
+  {
+    ierr = VecRestoreArray(_x, &_data);
+    CHECK_ERROR("VecRestoreArray");
+  }
+}
+//-----------------------------------------------------------------------------
+void PETScVector::restore_local_array(const double* data,
+                                      bool ghosted) const
+{
+  dolfin_assert(_x);
+  PetscErrorCode ierr;
+
+  Vec xg = NULL;
+  if (ghosted)
+  {
+    ierr = VecGhostGetLocalForm(_x, &xg);
+    CHECK_ERROR("VecGhostGetLocalForm");
+  }
+
+  const PetscScalar* _data = data;
+  if (xg)
+  {
+    ierr = VecRestoreArrayRead(xg, &_data);
+    CHECK_ERROR("VecRestoreArrayRead");
+
+    // Release the local form obtained here and the one held since
+    // get_local_array
+    Vec xg_held = xg;
+    ierr = VecGhostRestoreLocalForm(_x, &xg);
+    CHECK_ERROR("VecGhostRestoreLocalForm");
+    ierr = VecGhostRestoreLocalForm(_x, &xg_held);
+    CHECK_ERROR("VecGhostRestoreLocalForm");
+  }
+  else
+  {
+    ierr = VecRestoreArrayRead(_x, &_data);
+    CHECK_ERROR("VecRestoreArrayRead");
+  }
+}
+//-----------------------------------------------------------------------------
 const PETScVector& PETScVector::operator+= (const GenericVector& x)
 {
   axpy(1.0, x);
@@ -529,6 +809,48 @@ double PETScVector::inner(const GenericVector& y) const
   return a;
 }
 //-----------------------------------------------------------------------------
+std::vector<double>
+PETScVector::mdot(const std::vector<std::shared_ptr<const GenericVector>>& x) const
+{
+  dolfin_assert(_x);
+  std::vector<double> values(x.size(), 0.0);
+  if (x.empty())
+    return values;
+
+  std::vector<Vec> y(x.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    dolfin_assert(x[i]);
+    y[i] = as_type<const PETScVector>(*x[i]).vec();
+    dolfin_assert(y[i]);
+  }
+
+  PetscErrorCode ierr = VecMDot(_x, y.size(), y.data(), values.data());
+  CHECK_ERROR("VecMDot");
+  return values;
+}
+//-----------------------------------------------------------------------------
+std::pair<double, double> PETScVector::inner_norm(const GenericVector& y) const
+{
+  dolfin_assert(_x);
+  const PETScVector& _y = as_type<const PETScVector>(y);
+  dolfin_assert(_y._x);
+
+  // Split-phase reductions, which PETSc combines into a single
+  // global reduction
+  double a = 0.0, norm = 0.0;
+  PetscErrorCode ierr = VecDotBegin(_y._x, _x, &a);
+  CHECK_ERROR("VecDotBegin");
+  ierr = VecNormBegin(_x, NORM_2, &norm);
+  CHECK_ERROR("VecNormBegin");
+  ierr = VecDotEnd(_y._x, _x, &a);
+  CHECK_ERROR("VecDotEnd");
+  ierr = VecNormEnd(_x, NORM_2, &norm);
+  CHECK_ERROR("VecNormEnd");
+
+  return std::make_pair(a, norm);
+}
+//-----------------------------------------------------------------------------
 void PETScVector::axpy(double a, const GenericVector& y)
 {
   dolfin_assert(_x);
@@ -549,6 +871,35 @@ void PETScVector::axpy(double a, const GenericVector& y)
   update_ghost_values();
 }
 //-----------------------------------------------------------------------------
+void PETScVector::maxpy(const std::vector<double>& a,
+                        const std::vector<std::shared_ptr<const GenericVector>>& x)
+{
+  dolfin_assert(_x);
+  dolfin_assert(a.size() == x.size());
+  if (x.empty())
+    return;
+
+  std::vector<Vec> y(x.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    dolfin_assert(x[i]);
+    y[i] = as_type<const PETScVector>(*x[i]).vec();
+    dolfin_assert(y[i]);
+    if (size() != x[i]->size())
+    {
+      dolfin_error("PETScVector.cpp",
+                   "perform maxpy operation with PETSc vector",
+                   "Vectors are not of the same size");
+    }
+  }
+
+  PetscErrorCode ierr = VecMAXPY(_x, y.size(), a.data(), y.data());
+  CHECK_ERROR("VecMAXPY");
+
+  // Update ghost values
+  update_ghost_values();
+}
+//-----------------------------------------------------------------------------
 void PETScVector::abs()
 {
   dolfin_assert(_x);
@@ -658,6 +1009,33 @@ double PETScVector::sum(const Array<std::size_t>& rows) const
   return dolfin::MPI::sum(mpi_comm(), local_sum);
 }
 //-----------------------------------------------------------------------------
+std::size_t PETScVector::memory_usage() const
+{
+  if (!_x)
+    return 0;
+
+  // Include ghost entries of ghosted vectors
+  PetscErrorCode ierr;
+  Vec xg;
+  PetscInt n = 0;
+  ierr = VecGhostGetLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostGetLocalForm");
+  if (xg)
+  {
+    ierr = VecGetLocalSize(xg, &n);
+    CHECK_ERROR("VecGetLocalSize");
+  }
+  else
+  {
+    ierr = VecGetLocalSize(_x, &n);
+    CHECK_ERROR("VecGetLocalSize");
+  }
+  ierr = VecGhostRestoreLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostRestoreLocalForm");
+
+  return sizeof(*this) + n*sizeof(PetscScalar);
+}
+//-----------------------------------------------------------------------------
 std::string PETScVector::str(bool verbose) const
 {
   dolfin_assert(_x);
@@ -886,6 +1264,17 @@ void PETScVector::_init(std::pair<std::size_t, std::size_t> range,
 
   PetscErrorCode ierr;
 
+  // Create vector on device if requested (PETSc device vectors cannot
+  // have ghost entries, so ghosted vectors stay on the host). Values
+  // are set on the host and copied to the device when first used
+  // after apply().
+  const std::string device_type = device_vec_type();
+  if (!device_type.empty() and ghost_indices.empty())
+  {
+    ierr = VecSetType(_x, device_type.c_str());
+    CHECK_ERROR("VecSetType");
+  }
+
   // Set from PETSc options. This will set the vector type.
   ierr = VecSetFromOptions(_x);
   CHECK_ERROR("VecSetFromOptions");
@@ -907,8 +1296,17 @@ void PETScVector::_init(std::pair<std::size_t, std::size_t> range,
   // VECMPI and ghost entry vector is not empty)
   if (strcmp(vec_type, VECMPI) == 0)
   {
+    // Use shared memory for ghost updates between processes on the
+    // same node if requested (the scatter is created here)
+    const bool clear_scatter_type
+      = !ghost_indices.empty() and set_ghost_scatter_type();
     ierr = VecMPISetGhost(_x, ghost_indices.size(), ghost_indices.data());
     CHECK_ERROR("VecMPISetGhost");
+    if (clear_scatter_type)
+    {
+      ierr = PetscOptionsClearValue(NULL, "-vecscatter_type");
+      CHECK_ERROR("PetscOptionsClearValue");
+    }
   }
   else if (!ghost_indices.empty())
   {
@@ -946,6 +1344,16 @@ void PETScVector::_init(std::pair<std::size_t, std::size_t> range,
   // Clean-up PETSc local-to-global map
   ierr = ISLocalToGlobalMappingDestroy(&petsc_local_to_global);
   CHECK_ERROR("ISLocalToGlobalMappingDestroy");
+
+  // Reuse communication pattern of first assembly for off-process
+  // entries
+  #if PETSC_VERSION_MAJOR > 3 || (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8)
+  if (parameters["reuse_off_process_pattern"])
+  {
+    ierr = VecSetOption(_x, VEC_SUBSET_OFF_PROC_ENTRIES, PETSC_TRUE);
+    CHECK_ERROR("VecSetOption");
+  }
+  #endif
 }
 //-----------------------------------------------------------------------------
 
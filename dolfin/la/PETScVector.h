@@ -95,6 +95,9 @@ namespace dolfin
     /// Return MPI communicator
     virtual MPI_Comm mpi_comm() const;
 
+    /// Return estimate of memory used on this process in bytes
+    virtual std::size_t memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const;
 
@@ -161,6 +164,16 @@ namespace dolfin
     /// Get all values on local process
     virtual void get_local(std::vector<double>& values) const;
 
+    /// Get block of values using strided local indices
+    virtual void get_local_strided(double* block, std::size_t m,
+                                   dolfin::la_index offset,
+                                   dolfin::la_index stride) const;
+
+    /// Set block of values using strided local indices
+    virtual void set_local_strided(const double* block, std::size_t m,
+                                   dolfin::la_index offset,
+                                   dolfin::la_index stride);
+
     /// Set all values on local process
     virtual void set_local(const std::vector<double>& values);
 
@@ -186,12 +199,26 @@ namespace dolfin
     /// Add multiple of given vector (AXPY operation)
     virtual void axpy(double a, const GenericVector& x);
 
+    /// Add multiples of given vectors in a single pass (fused AXPY
+    /// operation)
+    virtual void maxpy(const std::vector<double>& a,
+                       const std::vector<std::shared_ptr<const GenericVector>>& x);
+
     /// Replace all entries in the vector by their absolute values
     virtual void abs();
 
     /// Return inner product with given vector
     virtual double inner(const GenericVector& v) const;
 
+    /// Return inner products with given vectors, computed in a single
+    /// pass
+    virtual std::vector<double>
+      mdot(const std::vector<std::shared_ptr<const GenericVector>>& x) const;
+
+    /// Return inner product with given vector and l2 norm of this
+    /// vector
+    virtual std::pair<double, double> inner_norm(const GenericVector& x) const;
+
     /// Return norm of vector
     virtual double norm(std::string norm_type) const;
 
@@ -237,6 +264,29 @@ namespace dolfin
     /// Update values shared from remote processes
     virtual void update_ghost_values();
 
+    /// Copy owned entries from x without updating ghost values
+    virtual void copy_owned_values(const GenericVector& x);
+
+    /// Start non-blocking update of ghost values
+    virtual void update_ghost_values_begin();
+
+    /// Complete update of ghost values
+    virtual void update_ghost_values_end();
+
+    /// Get direct access to the local values, including ghosts (via
+    /// the local form) if ghosted is true
+    virtual double* get_local_array(std::size_t& size, bool ghosted);
+
+    /// Get direct read-only access to the local values
+    virtual const double*
+      get_local_array(std::size_t& size, bool ghosted) const;
+
+    /// Release access obtained with get_local_array()
+    virtual void restore_local_array(double* data, bool ghosted);
+
+    /// Release read-only access obtained with get_local_array()
+    virtual void restore_local_array(const double* data, bool ghosted) const;
+
     //--- Special functions ---
 
     /// Return linear algebra backend factory
@@ -17,6 +17,7 @@
 
 #ifdef HAS_SLEPC
 
+#include <algorithm>
 #include <slepcversion.h>
 #include <dolfin/log/log.h>
 #include <dolfin/common/MPI.h>
@@ -29,16 +30,18 @@
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-SLEPcEigenSolver::SLEPcEigenSolver(MPI_Comm comm)
+SLEPcEigenSolver::SLEPcEigenSolver(MPI_Comm comm) : _initial_space_set(false)
 {
   // Set up solver environment
+  SubSystemsManager::init_slepc();
   EPSCreate(comm, &_eps);
 
   // Set default parameter values
   parameters = default_parameters();
 }
 //-----------------------------------------------------------------------------
-SLEPcEigenSolver::SLEPcEigenSolver(EPS eps) : _eps(eps)
+SLEPcEigenSolver::SLEPcEigenSolver(EPS eps)
+  : _eps(eps), _initial_space_set(false)
 {
   PetscErrorCode ierr;
   if (_eps)
@@ -77,7 +80,7 @@ SLEPcEigenSolver::SLEPcEigenSolver(MPI_Comm comm,
 //-----------------------------------------------------------------------------
 SLEPcEigenSolver::SLEPcEigenSolver(std::shared_ptr<const PETScMatrix> A,
                                    std::shared_ptr<const PETScMatrix> B)
-  : _matA(A), _matB(B), _eps(nullptr)
+  : _matA(A), _matB(B), _eps(nullptr), _initial_space_set(false)
 
 {
   // TODO: deprecate
@@ -91,6 +94,7 @@ SLEPcEigenSolver::SLEPcEigenSolver(std::shared_ptr<const PETScMatrix> A,
   }
 
   // Set up solver environment
+  SubSystemsManager::init_slepc();
   EPSCreate(A->mpi_comm(), &_eps);
 
   // Set operators
@@ -107,7 +111,7 @@ SLEPcEigenSolver::SLEPcEigenSolver(std::shared_ptr<const PETScMatrix> A,
 SLEPcEigenSolver::SLEPcEigenSolver(MPI_Comm comm,
                                    std::shared_ptr<const PETScMatrix> A,
                                    std::shared_ptr<const PETScMatrix> B)
-  : _matA(A), _matB(B), _eps(nullptr)
+  : _matA(A), _matB(B), _eps(nullptr), _initial_space_set(false)
 {
   // TODO: deprecate
 
@@ -123,6 +127,7 @@ SLEPcEigenSolver::SLEPcEigenSolver(MPI_Comm comm,
   parameters = default_parameters();
 
   // Set up solver environment
+  SubSystemsManager::init_slepc();
   EPSCreate(comm, &_eps);
 
   // Set operators
@@ -142,9 +147,17 @@ SLEPcEigenSolver::~SLEPcEigenSolver()
 void SLEPcEigenSolver::set_operators(std::shared_ptr<const PETScMatrix> A,
                                      std::shared_ptr<const PETScMatrix> B)
 {
-  // Set operators
+  // Store operators
+  _matA = A;
+  _matB = B;
+
+  // Set operators. The spectral transform (and the factorization of
+  // the shifted operator) is kept by the EPS object; with
+  // "reuse_factorization" only the numeric factorization is
+  // recomputed in the next solve.
   dolfin_assert(_eps);
-  if (B)
+  dolfin_assert(_matA);
+  if (_matB)
      EPSSetOperators(_eps, _matA->mat(), _matB->mat());
   else
     EPSSetOperators(_eps, _matA->mat(), NULL);
@@ -189,6 +202,21 @@ void SLEPcEigenSolver::solve(std::size_t n)
     }
   }
 
+  // Use eigenvectors from previous solve as initial space if no
+  // other initial space has been set
+  const bool warm_start = parameters["warm_start"];
+  if (warm_start and !_initial_space_set and !_eigenspace.empty()
+      and _eigenspace[0]->size() == _matA->size(1))
+  {
+    std::vector<Vec> petsc_vecs(_eigenspace.size());
+    for (std::size_t i = 0; i < _eigenspace.size(); ++i)
+      petsc_vecs[i] = _eigenspace[i]->vec();
+    PetscErrorCode ierr = EPSSetInitialSpace(_eps, petsc_vecs.size(),
+                                             petsc_vecs.data());
+    if (ierr != 0) petsc_error(ierr, __FILE__, "EPSSetInitialSpace");
+  }
+  _initial_space_set = false;
+
   // Solve eigenvalue problem
   EPSSolve(_eps);
 
@@ -206,6 +234,23 @@ void SLEPcEigenSolver::solve(std::size_t n)
   EPSGetType(_eps, &eps_type);
   log(PROGRESS, "Eigenvalue solver (%s) converged in %d iterations.",
       eps_type, num_iterations);
+
+  // Keep converged eigenvectors for warm start of next solve
+  _eigenspace.clear();
+  if (warm_start)
+  {
+    PetscInt num_conv = 0;
+    EPSGetConverged(_eps, &num_conv);
+    const std::size_t num_vectors = std::min((std::size_t) num_conv, n);
+    for (std::size_t i = 0; i < num_vectors; ++i)
+    {
+      auto x = std::make_shared<PETScVector>();
+      _matA->init_vector(*x, 1);
+      PetscErrorCode ierr = EPSGetEigenvector(_eps, i, x->vec(), NULL);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "EPSGetEigenvector");
+      _eigenspace.push_back(x);
+    }
+  }
 }
 //-----------------------------------------------------------------------------
 void SLEPcEigenSolver::get_eigenvalue(double& lr, double& lc,
@@ -309,6 +354,7 @@ void SLEPcEigenSolver::set_initial_space(const VectorSpaceBasis& initial_space)
   PetscErrorCode ierr = EPSSetInitialSpace(_eps, petsc_vecs.size(),
                                            petsc_vecs.data());
   if (ierr != 0) petsc_error(ierr, __FILE__, "EPSSetInitialSpace");
+  _initial_space_set = true;
 }
 //-----------------------------------------------------------------------------
 void SLEPcEigenSolver::set_options_prefix(std::string options_prefix)
@@ -368,6 +414,16 @@ void SLEPcEigenSolver::read_parameters()
                    "For an spectral transform, the spectral shift parameter must be set");
     }
   }
+
+  // Keep the nonzero pattern of the shifted operator so that its
+  // symbolic factorization is reused when the operators change
+  dolfin_assert(_eps);
+  ST st;
+  EPSGetST(_eps, &st);
+  if (parameters["reuse_factorization"])
+    STSetMatStructure(st, SAME_NONZERO_PATTERN);
+  else
+    STSetMatStructure(st, DIFFERENT_NONZERO_PATTERN);
 }
 //-----------------------------------------------------------------------------
 void SLEPcEigenSolver::set_problem_type(std::string type)
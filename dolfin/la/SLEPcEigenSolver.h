@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <slepceps.h>
 #include "dolfin/common/types.h"
 #include "dolfin/common/MPI.h"
@@ -114,6 +115,22 @@ namespace dolfin
   /// This parameter controls the spectral shift used by the spectral
   /// transform and must be provided if a spectral transform is
   /// given. The possible values are real numbers.
+  ///
+  /// 8. "reuse_factorization"
+  ///
+  /// If true, the nonzero pattern of the (shifted) operators is
+  /// assumed not to change when new operators are set with
+  /// set_operators(), so that the spectral transform and its
+  /// factorization are kept and only the numeric factorization is
+  /// recomputed. Default is false.
+  ///
+  /// 9. "warm_start"
+  ///
+  /// If true, the eigenvectors computed by a solve are used as the
+  /// initial space of the next solve (unless an initial space is set
+  /// explicitly with set_initial_space()). This is useful for
+  /// sequences of closely related problems, e.g. parameter sweeps.
+  /// Default is false.
 
   class SLEPcEigenSolver : public Variable, public PETScObject
   {
@@ -204,6 +221,8 @@ namespace dolfin
       p.add<std::string>("spectral_transform");
       p.add<double>("spectral_shift");
       p.add<bool>("verbose");
+      p.add("reuse_factorization", false);
+      p.add("warm_start", false);
 
       return p;
     }
@@ -234,6 +253,14 @@ namespace dolfin
     // SLEPc solver pointer
     EPS _eps;
 
+    // Eigenvectors from the previous solve (used as initial space if
+    // "warm_start" is true)
+    std::vector<std::shared_ptr<PETScVector>> _eigenspace;
+
+    // True if an initial space has been set explicitly for the next
+    // solve
+    bool _initial_space_set;
+
   };
 
 }
@@ -23,6 +23,7 @@
 // Last changed: 2014-11-26
 
 #include <algorithm>
+#include <iterator>
 
 #include <dolfin/common/MPI.h>
 #include <dolfin/log/LogStream.h>
@@ -31,17 +32,82 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Merge sorted and unique (row, column) pairs into CSR arrays
+  void merge_csr(std::vector<std::size_t>& offsets,
+                 std::vector<std::size_t>& columns,
+                 std::vector<std::pair<std::size_t, std::size_t>>& entries)
+  {
+    if (entries.empty())
+      return;
+
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+    const std::size_t num_rows = offsets.size() - 1;
+    std::vector<std::size_t> new_offsets(num_rows + 1, 0);
+    std::vector<std::size_t> new_columns;
+    new_columns.reserve(columns.size() + entries.size());
+
+    auto e = entries.begin();
+    std::vector<std::size_t> row_entries;
+    for (std::size_t i = 0; i < num_rows; ++i)
+    {
+      row_entries.clear();
+      for (; e != entries.end() && e->first == i; ++e)
+        row_entries.push_back(e->second);
+      std::set_union(columns.begin() + offsets[i],
+                     columns.begin() + offsets[i + 1],
+                     row_entries.begin(), row_entries.end(),
+                     std::back_inserter(new_columns));
+      new_offsets[i + 1] = new_columns.size();
+    }
+
+    offsets.swap(new_offsets);
+    columns.swap(new_columns);
+  }
+
+  // Create index map of blocks (with block size one) from an index
+  // map with block size greater than one. This function is
+  // collective.
+  std::shared_ptr<const IndexMap> block_index_map(const IndexMap& index_map)
+  {
+    const std::size_t block_size = index_map.block_size();
+    std::shared_ptr<IndexMap> block_map
+      = std::make_shared<IndexMap>(index_map.mpi_comm(),
+                                   index_map.size(IndexMap::MapSize::OWNED)
+                                   /block_size, 1);
+    block_map->set_local_to_global(index_map.local_to_global_unowned());
+    return block_map;
+  }
+
+  // Map indices to sorted and unique block indices
+  void block_indices(const ArrayView<const dolfin::la_index>& indices,
+                     std::size_t block_size,
+                     std::vector<dolfin::la_index>& blocks)
+  {
+    blocks.resize(indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i)
+      blocks[i] = indices[i]/block_size;
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+  }
+}
+
 //-----------------------------------------------------------------------------
-SparsityPattern::SparsityPattern(MPI_Comm comm, std::size_t primary_dim)
-  : _primary_dim(primary_dim), _mpi_comm(comm)
+SparsityPattern::SparsityPattern(MPI_Comm comm, std::size_t primary_dim,
+                                 bool block_storage)
+  : _primary_dim(primary_dim), _mpi_comm(comm),
+    _block_storage(block_storage), _block_size(1), _csr(false)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 SparsityPattern::SparsityPattern(MPI_Comm comm,
   const std::vector<std::shared_ptr<const IndexMap>> index_maps,
-  std::size_t primary_dim)
-  : _primary_dim(primary_dim), _mpi_comm(comm)
+  std::size_t primary_dim, bool block_storage)
+  : _primary_dim(primary_dim), _mpi_comm(comm),
+    _block_storage(block_storage), _block_size(1), _csr(false)
 {
   init(index_maps);
 }
@@ -51,7 +117,16 @@ void SparsityPattern::init(const std::vector<std::shared_ptr<const IndexMap>> in
   // Only rank 2 sparsity patterns are supported
   dolfin_assert(index_maps.size() == 2);
 
+  // Store pattern of blocks if the block sizes agree
+  _block_size = 1;
   _index_maps = index_maps;
+  if (_block_storage && index_maps[0]->block_size() > 1
+      && index_maps[0]->block_size() == index_maps[1]->block_size())
+  {
+    _block_size = index_maps[0]->block_size();
+    for (std::size_t i = 0; i < 2; ++i)
+      _index_maps[i] = block_index_map(*index_maps[i]);
+  }
 
   const std::size_t _primary_dim = primary_dim();
 
@@ -60,6 +135,11 @@ void SparsityPattern::init(const std::vector<std::shared_ptr<const IndexMap>> in
   off_diagonal.clear();
   non_local.clear();
   full_rows.clear();
+  _csr = false;
+  _diagonal_offsets.clear();
+  _diagonal_columns.clear();
+  _off_diagonal_offsets.clear();
+  _off_diagonal_columns.clear();
 
   // Check that primary dimension is valid
   if (_primary_dim > 1)
@@ -178,6 +258,16 @@ void SparsityPattern::insert_entries(
   ArrayView<const dolfin::la_index> map_i = entries[_primary_dim];
   ArrayView<const dolfin::la_index> map_j = entries[primary_codim];
 
+  // Insert blocks containing the entries for block storage
+  std::vector<dolfin::la_index> blocks_i, blocks_j;
+  if (_block_size > 1)
+  {
+    block_indices(map_i, _block_size, blocks_i);
+    block_indices(map_j, _block_size, blocks_j);
+    map_i.set(blocks_i.size(), blocks_i.data());
+    map_j.set(blocks_j.size(), blocks_j.data());
+  }
+
   const IndexMap& index_map0 = *_index_maps[ _primary_dim];
   const IndexMap& index_map1 = *_index_maps[primary_codim];
   const std::size_t local_size0 = index_map0.size(IndexMap::MapSize::OWNED);
@@ -197,6 +287,13 @@ void SparsityPattern::insert_entries(
   // where i == I and j == J.
 
   // Check local range
+  if (_csr && _mpi_comm.size() == 1)
+  {
+    dolfin_error("SparsityPattern.cpp",
+                 "insert entries in sparsity pattern",
+                 "Pattern of local rows is compressed and cannot be modified");
+  }
+
   if (_mpi_comm.size() == 1)
   {
     // Sequential mode, do simple insertion if not full row
@@ -223,6 +320,13 @@ void SparsityPattern::insert_entries(
 
       if (I < (dolfin::la_index) local_size0)
       {
+        if (_csr)
+        {
+          dolfin_error("SparsityPattern.cpp",
+                       "insert entries in sparsity pattern",
+                       "Pattern of local rows is compressed and cannot be modified");
+        }
+
         // Store local entry in diagonal or off-diagonal block
         for (const auto &j_index : map_j)
         {
@@ -263,11 +367,31 @@ void SparsityPattern::insert_full_rows_local(
   full_rows.set().reserve(rows.size());
   for (const auto row : rows)
   {
-    dolfin_assert(row < ghosted_size0);
-    full_rows.insert(row);
+    dolfin_assert(row/_block_size < ghosted_size0);
+    full_rows.insert(row/_block_size);
   }
 }
 //-----------------------------------------------------------------------------
+void SparsityPattern::set_csr(std::vector<std::size_t>& diagonal_offsets,
+                              std::vector<std::size_t>& diagonal_columns,
+                              std::vector<std::size_t>& off_diagonal_offsets,
+                              std::vector<std::size_t>& off_diagonal_columns)
+{
+  dolfin_assert(diagonal_offsets.size() == diagonal.size() + 1);
+  dolfin_assert(off_diagonal_offsets.empty()
+                || off_diagonal_offsets.size() == diagonal.size() + 1);
+
+  // Release row sets
+  std::vector<set_type>().swap(diagonal);
+  std::vector<set_type>().swap(off_diagonal);
+
+  _csr = true;
+  _diagonal_offsets.swap(diagonal_offsets);
+  _diagonal_columns.swap(diagonal_columns);
+  _off_diagonal_offsets.swap(off_diagonal_offsets);
+  _off_diagonal_columns.swap(off_diagonal_columns);
+}
+//-----------------------------------------------------------------------------
 std::size_t SparsityPattern::rank() const
 {
   return 2;
@@ -285,6 +409,8 @@ std::size_t SparsityPattern::num_nonzeros() const
   std::size_t nz = 0;
 
   // Contribution from diagonal and off-diagonal
+  if (_csr)
+    nz += _diagonal_columns.size() + _off_diagonal_columns.size();
   for (const auto& slice : diagonal)
     nz += slice.size();
   for (const auto& slice : off_diagonal)
@@ -304,12 +430,22 @@ std::size_t SparsityPattern::num_nonzeros() const
 //-----------------------------------------------------------------------------
 void SparsityPattern::num_nonzeros_diagonal(std::vector<std::size_t>& num_nonzeros) const
 {
-  // Resize vector
-  num_nonzeros.resize(diagonal.size());
+  if (_csr)
+  {
+    // Get number of nonzeros per generalised row from offsets
+    num_nonzeros.resize(_diagonal_offsets.size() - 1);
+    for (std::size_t i = 0; i < num_nonzeros.size(); ++i)
+      num_nonzeros[i] = _diagonal_offsets[i + 1] - _diagonal_offsets[i];
+  }
+  else
+  {
+    // Resize vector
+    num_nonzeros.resize(diagonal.size());
 
-  // Get number of nonzeros per generalised row
-  for (auto slice = diagonal.begin(); slice != diagonal.end(); ++slice)
-    num_nonzeros[slice - diagonal.begin()] = slice->size();
+    // Get number of nonzeros per generalised row
+    for (auto slice = diagonal.begin(); slice != diagonal.end(); ++slice)
+      num_nonzeros[slice - diagonal.begin()] = slice->size();
+  }
 
   // Get number of nonzeros per full row
   if (full_rows.size() > 0)
@@ -326,16 +462,37 @@ void SparsityPattern::num_nonzeros_diagonal(std::vector<std::size_t>& num_nonzer
 //-----------------------------------------------------------------------------
 void SparsityPattern::num_nonzeros_off_diagonal(std::vector<std::size_t>& num_nonzeros) const
 {
-  // Resize vector
-  num_nonzeros.resize(off_diagonal.size());
+  if (_csr)
+  {
+    // Return if there is no off-diagonal
+    num_nonzeros.clear();
+    if (_off_diagonal_offsets.empty())
+      return;
+
+    // Compute number of nonzeros per generalised row from offsets
+    num_nonzeros.resize(_off_diagonal_offsets.size() - 1);
+    for (std::size_t i = 0; i < num_nonzeros.size(); ++i)
+    {
+      num_nonzeros[i]
+        = _off_diagonal_offsets[i + 1] - _off_diagonal_offsets[i];
+    }
+  }
+  else
+  {
+    // Resize vector
+    num_nonzeros.resize(off_diagonal.size());
 
-  // Return if there is no off-diagonal
-  if (off_diagonal.empty())
-    return;
+    // Return if there is no off-diagonal
+    if (off_diagonal.empty())
+      return;
 
-  // Compute number of nonzeros per generalised row
-  for (auto slice = off_diagonal.begin(); slice != off_diagonal.end(); ++slice)
-    num_nonzeros[slice - off_diagonal.begin()] = slice->size();
+    // Compute number of nonzeros per generalised row
+    for (auto slice = off_diagonal.begin(); slice != off_diagonal.end();
+         ++slice)
+    {
+      num_nonzeros[slice - off_diagonal.begin()] = slice->size();
+    }
+  }
 
   // Get number of nonzeros per full row
   if (full_rows.size() > 0)
@@ -355,7 +512,7 @@ void SparsityPattern::num_nonzeros_off_diagonal(std::vector<std::size_t>& num_no
 void SparsityPattern::num_local_nonzeros(std::vector<std::size_t>& num_nonzeros) const
 {
   num_nonzeros_diagonal(num_nonzeros);
-  if (!off_diagonal.empty())
+  if (!off_diagonal.empty() || !_off_diagonal_offsets.empty())
   {
     std::vector<std::size_t> tmp;
     num_nonzeros_off_diagonal(tmp);
@@ -380,9 +537,6 @@ void SparsityPattern::apply()
     = _index_maps[_primary_dim]->size(IndexMap::MapSize::OWNED);
   const std::size_t offset0 = local_range0.first;
 
-  const std::size_t num_processes = _mpi_comm.size();
-  const std::size_t proc_number = _mpi_comm.rank();
-
   // Print some useful information
   if (get_log_level() <= DBG)
     info_statistics();
@@ -390,9 +544,16 @@ void SparsityPattern::apply()
   // Communicate non-local blocks if any
   if (_mpi_comm.size() > 1)
   {
-    // Figure out correct process for each non-local entry
+    // Figure out correct process for each non-local entry. Entries
+    // are only sent to the owners of unowned indices (the
+    // neighbourhood of the index map, which is computed once and
+    // reused).
     dolfin_assert(non_local.size() % 2 == 0);
-    std::vector<std::vector<std::size_t>> non_local_send(num_processes);
+    const IndexMap& index_map0 = *_index_maps[_primary_dim];
+    const std::vector<int>& destinations
+      = index_map0.neighbourhood_destinations();
+    std::vector<std::vector<std::size_t>>
+      non_local_send(destinations.size());
 
     const std::vector<int>& off_process_owner
       = _index_maps[_primary_dim]->off_process_owner();
@@ -413,8 +574,8 @@ void SparsityPattern::apply()
       dolfin_assert(i_offset < off_process_owner.size());
       const std::size_t p = off_process_owner[i_offset];
 
-      dolfin_assert(p < num_processes);
-      dolfin_assert(p != proc_number);
+      dolfin_assert(p < _mpi_comm.size());
+      dolfin_assert(p != _mpi_comm.rank());
 
       // Get global I index
       la_index I = 0;
@@ -432,17 +593,32 @@ void SparsityPattern::apply()
       }
 
       // Buffer local/global index pair to send
-      non_local_send[p].push_back(I);
-      non_local_send[p].push_back(J);
+      const std::size_t dest
+        = std::lower_bound(destinations.begin(), destinations.end(), (int) p)
+        - destinations.begin();
+      dolfin_assert(dest < destinations.size());
+      non_local_send[dest].push_back(I);
+      non_local_send[dest].push_back(J);
     }
 
-    // Communicate non-local entries to other processes
+    // Communicate non-local entries to neighbouring processes
+    std::vector<std::vector<std::size_t>> non_local_recv;
+    MPI::neighbor_all_to_all(index_map0.neighbourhood_comm(),
+                             non_local_send, non_local_recv);
     std::vector<std::size_t> non_local_received;
-    MPI::all_to_all(_mpi_comm.comm(), non_local_send, non_local_received);
+    for (const auto& recv : non_local_recv)
+    {
+      non_local_received.insert(non_local_received.end(), recv.begin(),
+                                recv.end());
+    }
 
     // Insert non-local entries received from other processes
     dolfin_assert(non_local_received.size() % 2 == 0);
 
+    // Received entries for compressed pattern
+    std::vector<std::pair<std::size_t, std::size_t>> diagonal_received;
+    std::vector<std::pair<std::size_t, std::size_t>> off_diagonal_received;
+
     for (std::size_t i = 0; i < non_local_received.size(); i += 2)
     {
       // Get global row and column
@@ -467,38 +643,78 @@ void SparsityPattern::apply()
       if (local_range1.first <= J &&
           J < local_range1.second)
       {
-        dolfin_assert(i_index < diagonal.size());
-        diagonal[i_index].insert(J);
+        if (_csr)
+          diagonal_received.push_back({i_index, J});
+        else
+        {
+          dolfin_assert(i_index < diagonal.size());
+          diagonal[i_index].insert(J);
+        }
       }
       else
       {
-        dolfin_assert(i_index < off_diagonal.size());
-        off_diagonal[i_index].insert(J);
+        if (_csr)
+          off_diagonal_received.push_back({i_index, J});
+        else
+        {
+          dolfin_assert(i_index < off_diagonal.size());
+          off_diagonal[i_index].insert(J);
+        }
       }
     }
+
+    // Merge received entries into compressed pattern
+    if (_csr)
+    {
+      merge_csr(_diagonal_offsets, _diagonal_columns, diagonal_received);
+      dolfin_assert(off_diagonal_received.empty()
+                    || !_off_diagonal_offsets.empty());
+      merge_csr(_off_diagonal_offsets, _off_diagonal_columns,
+                off_diagonal_received);
+    }
   }
 
   // Clear non-local entries
   non_local.clear();
 }
 //-----------------------------------------------------------------------------
+std::size_t SparsityPattern::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this)
+    + full_rows.set().capacity()*sizeof(std::size_t)
+    + non_local.capacity()*sizeof(std::size_t)
+    + _diagonal_offsets.capacity()*sizeof(std::size_t)
+    + _diagonal_columns.capacity()*sizeof(std::size_t)
+    + _off_diagonal_offsets.capacity()*sizeof(std::size_t)
+    + _off_diagonal_columns.capacity()*sizeof(std::size_t);
+  for (auto& row : diagonal)
+    bytes += sizeof(row) + row.set().capacity()*sizeof(std::size_t);
+  for (auto& row : off_diagonal)
+    bytes += sizeof(row) + row.set().capacity()*sizeof(std::size_t);
+  return bytes;
+}
+//-----------------------------------------------------------------------------
 std::string SparsityPattern::str(bool verbose) const
 {
   // Print each row
   std::stringstream s;
-  for (std::size_t i = 0; i < diagonal.size(); i++)
+  const std::vector<std::vector<std::size_t>> d
+    = diagonal_pattern(Type::unsorted);
+  const std::vector<std::vector<std::size_t>> od
+    = off_diagonal_pattern(Type::unsorted);
+  for (std::size_t i = 0; i < d.size(); i++)
   {
     if (primary_dim() == 0)
       s << "Row " << i << ":";
     else
       s << "Col " << i << ":";
 
-    for (const auto& entry : diagonal[i])
+    for (const auto& entry : d[i])
       s << " " << entry;
 
-    if (!off_diagonal.empty())
+    if (!od.empty())
     {
-      for (const auto& entry : off_diagonal[i])
+      for (const auto& entry : od[i])
         s << " " << entry;
     }
 
@@ -511,9 +727,23 @@ std::string SparsityPattern::str(bool verbose) const
 std::vector<std::vector<std::size_t>>
 SparsityPattern::diagonal_pattern(Type type) const
 {
-  std::vector<std::vector<std::size_t>> v(diagonal.size());
-  for (std::size_t i = 0; i < diagonal.size(); ++i)
-    v[i].insert(v[i].begin(), diagonal[i].begin(), diagonal[i].end());
+  std::vector<std::vector<std::size_t>> v;
+  if (_csr)
+  {
+    // Rows of compressed pattern are sorted
+    v.resize(_diagonal_offsets.size() - 1);
+    for (std::size_t i = 0; i < v.size(); ++i)
+    {
+      v[i].assign(_diagonal_columns.begin() + _diagonal_offsets[i],
+                  _diagonal_columns.begin() + _diagonal_offsets[i + 1]);
+    }
+  }
+  else
+  {
+    v.resize(diagonal.size());
+    for (std::size_t i = 0; i < diagonal.size(); ++i)
+      v[i].insert(v[i].begin(), diagonal[i].begin(), diagonal[i].end());
+  }
 
   if (type == Type::sorted)
   {
@@ -544,9 +774,25 @@ SparsityPattern::diagonal_pattern(Type type) const
 std::vector<std::vector<std::size_t>>
   SparsityPattern::off_diagonal_pattern(Type type) const
 {
-  std::vector<std::vector<std::size_t>> v(off_diagonal.size());
-  for (std::size_t i = 0; i < off_diagonal.size(); ++i)
-    v[i].insert(v[i].begin(), off_diagonal[i].begin(), off_diagonal[i].end());
+  std::vector<std::vector<std::size_t>> v;
+  if (_csr)
+  {
+    // Rows of compressed pattern are sorted
+    if (!_off_diagonal_offsets.empty())
+      v.resize(_off_diagonal_offsets.size() - 1);
+    for (std::size_t i = 0; i < v.size(); ++i)
+    {
+      v[i].assign(_off_diagonal_columns.begin() + _off_diagonal_offsets[i],
+                  _off_diagonal_columns.begin()
+                  + _off_diagonal_offsets[i + 1]);
+    }
+  }
+  else
+  {
+    v.resize(off_diagonal.size());
+    for (std::size_t i = 0; i < off_diagonal.size(); ++i)
+      v[i].insert(v[i].begin(), off_diagonal[i].begin(), off_diagonal[i].end());
+  }
 
   if (type == Type::sorted)
   {
@@ -580,12 +826,12 @@ std::vector<std::vector<std::size_t>>
 void SparsityPattern::info_statistics() const
 {
   // Count nonzeros in diagonal block
-  std::size_t num_nonzeros_diagonal = 0;
+  std::size_t num_nonzeros_diagonal = _diagonal_columns.size();
   for (std::size_t i = 0; i < diagonal.size(); ++i)
     num_nonzeros_diagonal += diagonal[i].size();
 
   // Count nonzeros in off-diagonal block
-  std::size_t num_nonzeros_off_diagonal = 0;
+  std::size_t num_nonzeros_off_diagonal = _off_diagonal_columns.size();
   for (std::size_t i = 0; i < off_diagonal.size(); ++i)
     num_nonzeros_off_diagonal += off_diagonal[i].size();
 
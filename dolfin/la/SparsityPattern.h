@@ -55,17 +55,28 @@ namespace dolfin
     /// Whether SparsityPattern is sorted
     enum class Type {sorted, unsorted};
 
-    /// Create empty sparsity pattern
-    SparsityPattern(MPI_Comm comm, std::size_t primary_dim);
+    /// Create empty sparsity pattern. If block_storage is true, the
+    /// pattern is stored per block when the index maps have the same
+    /// block size (see block_size())
+    SparsityPattern(MPI_Comm comm, std::size_t primary_dim,
+                    bool block_storage=false);
 
     /// Create sparsity pattern for a generic tensor
     SparsityPattern(MPI_Comm comm,
                     std::vector<std::shared_ptr<const IndexMap>> index_maps,
-                    std::size_t primary_dim);
+                    std::size_t primary_dim,
+                    bool block_storage=false);
 
     /// Initialize sparsity pattern for a generic tensor
     void init(std::vector<std::shared_ptr<const IndexMap>> index_maps);
 
+    /// Return block size of the pattern. If greater than one, entries
+    /// are still inserted using (scalar) indices, but the pattern
+    /// stores one entry per block, and the local ranges, numbers of
+    /// nonzeros and patterns returned are in terms of blocks
+    std::size_t block_size() const
+    { return _block_size; }
+
     /// Insert a global entry - will be fixed by apply()
     void insert_global(dolfin::la_index i, dolfin::la_index j);
 
@@ -88,6 +99,24 @@ namespace dolfin
     /// complexity of dense rows insertion
     void insert_full_rows_local(const std::vector<std::size_t>& rows);
 
+    /// Set the non-zero pattern of the local rows (or columns,
+    /// according to primary dimension) from compressed sparse row
+    /// (CSR) arrays of global column indices for the diagonal and
+    /// off-diagonal blocks. The columns of each row must be sorted
+    /// and unique. The pattern is thereafter stored in CSR form and
+    /// further insertion is only possible for non-local rows. The
+    /// arrays are swapped into the sparsity pattern (and are empty
+    /// on return). The off-diagonal arrays may be empty if there is
+    /// no off-diagonal block.
+    void set_csr(std::vector<std::size_t>& diagonal_offsets,
+                 std::vector<std::size_t>& diagonal_columns,
+                 std::vector<std::size_t>& off_diagonal_offsets,
+                 std::vector<std::size_t>& off_diagonal_columns);
+
+    /// Return true if pattern is stored in compressed sparse row form
+    bool is_csr() const
+    { return _csr; }
+
     /// Return rank
     std::size_t rank() const;
 
@@ -126,6 +155,9 @@ namespace dolfin
     MPI_Comm mpi_comm() const
     { return _mpi_comm.comm(); }
 
+    /// Return estimate of memory used on this process in bytes
+    std::size_t memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
@@ -160,9 +192,14 @@ namespace dolfin
     // MPI communicator
     dolfin::MPI::Comm _mpi_comm;
 
-    // IndexMaps for each dimension
+    // IndexMaps for each dimension (of blocks if _block_size > 1)
     std::vector<std::shared_ptr<const IndexMap>> _index_maps;
 
+    // Store pattern per block if the index maps have the same block
+    // size, and the block size in use
+    const bool _block_storage;
+    std::size_t _block_size;
+
     // Sparsity patterns for diagonal and off-diagonal blocks
     std::vector<set_type> diagonal;
     std::vector<set_type> off_diagonal;
@@ -177,6 +214,13 @@ namespace dolfin
     // Sparsity pattern for non-local entries stored as [i0, j0, i1, j1, ...]
     std::vector<std::size_t> non_local;
 
+    // Sparsity patterns for diagonal and off-diagonal blocks in
+    // compressed sparse row form (used in place of diagonal and
+    // off_diagonal if _csr is true)
+    bool _csr;
+    std::vector<std::size_t> _diagonal_offsets, _diagonal_columns;
+    std::vector<std::size_t> _off_diagonal_offsets, _off_diagonal_columns;
+
   };
 
 }
@@ -27,24 +27,33 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 TensorLayout::TensorLayout(MPI_Comm comm, std::size_t pdim,
-                           Sparsity sparsity_pattern)
+                           Sparsity sparsity_pattern, Blocking blocking)
   : primary_dim(pdim), _mpi_comm(comm)
 {
   // Create empty sparsity pattern
   if (sparsity_pattern == TensorLayout::Sparsity::SPARSE)
-    _sparsity_pattern = std::make_shared<SparsityPattern>(comm, primary_dim);
+  {
+    const bool block_storage = (blocking == Blocking::BLOCKED);
+    _sparsity_pattern = std::make_shared<SparsityPattern>(comm, primary_dim,
+                                                          block_storage);
+  }
 }
 //-----------------------------------------------------------------------------
 TensorLayout::TensorLayout(MPI_Comm comm,
                            std::vector<std::shared_ptr<const IndexMap>> index_maps,
                            std::size_t pdim,
                            Sparsity sparsity_pattern,
-                           Ghosts ghosted)
+                           Ghosts ghosted,
+                           Blocking blocking)
   : primary_dim(pdim), _mpi_comm(comm), _index_maps(index_maps),
     _ghosted(ghosted)
 {
   if (sparsity_pattern == TensorLayout::Sparsity::SPARSE)
-    _sparsity_pattern = std::make_shared<SparsityPattern>(comm, primary_dim);
+  {
+    const bool block_storage = (blocking == Blocking::BLOCKED);
+    _sparsity_pattern = std::make_shared<SparsityPattern>(comm, primary_dim,
+                                                          block_storage);
+  }
 
   // Only rank 2 sparsity patterns are supported
   dolfin_assert(!(_sparsity_pattern && index_maps.size() != 2));
@@ -49,16 +49,22 @@ namespace dolfin
     /// Ghosted or unghosted layout
     enum class Ghosts : bool { GHOSTED = true, UNGHOSTED = false };
 
+    /// Sparsity pattern stored per block (for block sparse matrix
+    /// formats) or per entry
+    enum class Blocking : bool { BLOCKED = true, UNBLOCKED = false };
+
     /// Create empty tensor layout
     TensorLayout(MPI_Comm comm, std::size_t primary_dim,
-                 Sparsity sparsity_pattern);
+                 Sparsity sparsity_pattern,
+                 Blocking blocking=Blocking::UNBLOCKED);
 
     /// Create a tensor layout
     TensorLayout(MPI_Comm mpi_comm,
                  std::vector<std::shared_ptr<const IndexMap>> index_maps,
                  std::size_t primary_dim,
                  Sparsity sparsity_pattern,
-                 Ghosts ghosted);
+                 Ghosts ghosted,
+                 Blocking blocking=Blocking::UNBLOCKED);
 
     /// Initialize tensor layout
     void init(std::vector<std::shared_ptr<const IndexMap>> index_maps,
@@ -82,6 +88,34 @@ namespace dolfin
     std::shared_ptr<const SparsityPattern> sparsity_pattern() const
     { return _sparsity_pattern; }
 
+    /// Set upper bounds for the number of nonzeros in the diagonal
+    /// and off-diagonal blocks of each local row. Backends that
+    /// support it (see
+    /// GenericLinearAlgebraFactory::supports_row_count_preallocation)
+    /// preallocate a matrix from these counts instead of from the
+    /// sparsity pattern, which then need not be built.
+    void set_num_nonzeros(std::vector<std::size_t> num_nonzeros_diagonal,
+                          std::vector<std::size_t> num_nonzeros_off_diagonal)
+    {
+      _num_nonzeros_diagonal.swap(num_nonzeros_diagonal);
+      _num_nonzeros_off_diagonal.swap(num_nonzeros_off_diagonal);
+      _has_num_nonzeros = true;
+    }
+
+    /// Return true if row counts have been set by set_num_nonzeros()
+    bool has_num_nonzeros() const
+    { return _has_num_nonzeros; }
+
+    /// Return upper bounds for the number of nonzeros in the
+    /// diagonal block of each local row
+    const std::vector<std::size_t>& num_nonzeros_diagonal() const
+    { return _num_nonzeros_diagonal; }
+
+    /// Return upper bounds for the number of nonzeros in the
+    /// off-diagonal block of each local row
+    const std::vector<std::size_t>& num_nonzeros_off_diagonal() const
+    { return _num_nonzeros_off_diagonal; }
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
@@ -119,6 +153,11 @@ namespace dolfin
     // Ghosted tensor (typically vector) required
     Ghosts _ghosted = Ghosts::UNGHOSTED;
 
+    // Row counts for preallocation without sparsity pattern
+    bool _has_num_nonzeros = false;
+    std::vector<std::size_t> _num_nonzeros_diagonal;
+    std::vector<std::size_t> _num_nonzeros_off_diagonal;
+
   };
 
 }
@@ -178,7 +178,20 @@ void TpetraMatrix::init(const TensorLayout& tensor_layout)
 
   crs_graph->fillComplete(domain_map, range_map);
 
+  // Create matrix with static graph. Reassembly sums into existing
+  // entries only and the graph is never recomputed.
   _matA = Teuchos::rcp(new matrix_type(crs_graph));
+
+  // Build map from local column indices to column map of the graph
+  Teuchos::RCP<const map_type> col_map = crs_graph->getColMap();
+  const std::size_t num_cols
+    = index_map[1]->size(IndexMap::MapSize::ALL);
+  _column_local_index.resize(num_cols);
+  for (std::size_t i = 0; i < num_cols; ++i)
+  {
+    _column_local_index[i] = col_map->getLocalElement(
+      (dolfin::la_index) index_map[1]->local_to_global(i));
+  }
 }
 //-----------------------------------------------------------------------------
 std::size_t TpetraMatrix::size(std::size_t dim) const
@@ -369,17 +382,45 @@ void TpetraMatrix::add_local(const double* block,
   dolfin_assert(!_matA.is_null());
   dolfin_assert(!_matA->isFillComplete());
 
-  // Map local columns to global
+  // Map local columns to local indices of the column map of the
+  // graph (all columns of owned rows are in the column map)
+  const int invalid = Teuchos::OrdinalTraits<int>::invalid();
+  std::vector<int> _local_col_idx(n);
+  bool local_cols = true;
+  for (std::size_t i = 0 ; i != n; ++i)
+  {
+    dolfin_assert(cols[i] < (dolfin::la_index) _column_local_index.size());
+    _local_col_idx[i] = _column_local_index[cols[i]];
+    if (_local_col_idx[i] == invalid)
+      local_cols = false;
+  }
+  Teuchos::ArrayView<const int> local_col_idx(_local_col_idx);
+
+  // Map local columns to global (for off-process rows)
   std::vector<dolfin::la_index> _global_col_idx;
   _global_col_idx.reserve(n);
   for (std::size_t i = 0 ; i != n; ++i)
     _global_col_idx.push_back(index_map[1]->local_to_global(cols[i]));
   Teuchos::ArrayView<const dolfin::la_index> global_col_idx(_global_col_idx);
 
+  // Rows of the (non-overlapping) row map are numbered as the owned
+  // rows of the index map
+  const std::size_t num_owned_rows
+    = index_map[0]->size(IndexMap::MapSize::OWNED);
+
   for (std::size_t i = 0 ; i != m; ++i)
   {
     Teuchos::ArrayView<const double> data(block + i*n, n);
 
+    // Owned row: sum into static graph using local indices only
+    if (local_cols and (std::size_t) rows[i] < num_owned_rows)
+    {
+      std::size_t nvalid = _matA->sumIntoLocalValues(rows[i],
+                                                     local_col_idx, data);
+      dolfin_assert(nvalid == n);
+      continue;
+    }
+
     const dolfin::la_index global_row_idx
       = index_map[0]->local_to_global(rows[i]);
     if (global_row_idx != Teuchos::OrdinalTraits<dolfin::la_index>::invalid())
@@ -714,7 +755,13 @@ void TpetraMatrix::apply(std::string mode)
 
   dolfin_assert(!_matA.is_null());
   if (mode == "add" or mode == "insert" or mode == "flush")
-    _matA->fillComplete();
+  {
+    // Nothing to do if the matrix has not been changed since the
+    // last call (the graph is static, so fillComplete only
+    // communicates off-process entries and updates the values)
+    if (!_matA->isFillComplete())
+      _matA->fillComplete();
+  }
   else
   {
     dolfin_error("TpetraMatrix.cpp",
@@ -27,6 +27,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <Teuchos_GlobalMPISession.hpp>
 #include <Teuchos_oblackholestream.hpp>
@@ -231,6 +232,11 @@ namespace dolfin
     // entries needed in add_local() and set_local()
     std::array<std::shared_ptr<const IndexMap>, 2> index_map;
 
+    // Local (DOLFIN) column index to local index in the column map
+    // of the (static) graph, so that add_local() can sum into owned
+    // rows with local indices only
+    std::vector<int> _column_local_index;
+
   };
 
 }
@@ -242,15 +242,54 @@ void TpetraVector::update_ghost_values()
   //            _x_ghosted->getDataNonConst(0).begin());
 }
 //-----------------------------------------------------------------------------
+double* TpetraVector::get_local_array(std::size_t& size, bool ghosted)
+{
+  dolfin_assert(!_x_ghosted.is_null());
+
+  // _x is a view of the leading (owned) part of _x_ghosted
+  _local_array = _x_ghosted->getDataNonConst(0);
+  size = ghosted ? _x_ghosted->getLocalLength() : _x->getLocalLength();
+  return _local_array.get();
+}
+//-----------------------------------------------------------------------------
+const double* TpetraVector::get_local_array(std::size_t& size,
+                                            bool ghosted) const
+{
+  dolfin_assert(!_x_ghosted.is_null());
+
+  // _x is a view of the leading (owned) part of _x_ghosted
+  _local_array_const = _x_ghosted->getData(0);
+  size = ghosted ? _x_ghosted->getLocalLength() : _x->getLocalLength();
+  return _local_array_const.get();
+}
+//-----------------------------------------------------------------------------
+void TpetraVector::restore_local_array(double* data, bool ghosted)
+{
+  dolfin_assert(data == _local_array.get());
+  _local_array = Teuchos::null;
+}
+//-----------------------------------------------------------------------------
+void TpetraVector::restore_local_array(const double* data,
+                                       bool ghosted) const
+{
+  dolfin_assert(data == _local_array_const.get());
+  _local_array_const = Teuchos::null;
+}
+//-----------------------------------------------------------------------------
 void TpetraVector::get_local(double* block, std::size_t m,
                              const dolfin::la_index* rows) const
 {
   dolfin_assert(!_x_ghosted.is_null());
-  Teuchos::ArrayRCP<const double> arr = _x_ghosted->getData(0);
+
+  // Access host view of (ghosted) vector, copying from the device
+  // once for the whole block if modified there
+  _x_ghosted->sync<Kokkos::HostSpace>();
+  auto x_host = _x_ghosted->getLocalView<Kokkos::HostSpace>();
+  const dolfin::la_index num_local = x_host.dimension_0();
   for (std::size_t i = 0; i!=m; ++i)
   {
-    if (_x_ghosted->getMap()->isNodeLocalElement(rows[i]))
-      block[i] = arr[rows[i]];
+    if (rows[i] >= 0 and rows[i] < num_local)
+      block[i] = x_host(rows[i], 0);
     else
     {
       dolfin_error("TpetraVector.cpp",
@@ -281,10 +320,17 @@ void TpetraVector::set_local(const double* block, std::size_t m,
                              const dolfin::la_index* rows)
 {
   dolfin_assert(!_x.is_null());
+
+  // Modify values through host view and mark the view as modified
+  // (values are copied to the device, if any, when next needed there)
+  _x->sync<Kokkos::HostSpace>();
+  _x->modify<Kokkos::HostSpace>();
+  auto x_host = _x->getLocalView<Kokkos::HostSpace>();
+  const dolfin::la_index num_local = x_host.dimension_0();
   for (std::size_t i = 0; i != m; ++i)
   {
-    if(_x->getMap()->isNodeLocalElement(rows[i]))
-      _x->replaceLocalValue(rows[i], 0, block[i]);
+    if (rows[i] >= 0 and rows[i] < num_local)
+      x_host(rows[i], 0) = block[i];
     else
       warning("Not setting on row %d", rows[i]);
   }
@@ -311,10 +357,15 @@ void TpetraVector::add_local(const double* block, std::size_t m,
 {
   dolfin_assert(!_x_ghosted.is_null());
 
+  // Add through host view (see set_local)
+  _x_ghosted->sync<Kokkos::HostSpace>();
+  _x_ghosted->modify<Kokkos::HostSpace>();
+  auto x_host = _x_ghosted->getLocalView<Kokkos::HostSpace>();
+  const dolfin::la_index num_local = x_host.dimension_0();
   for (std::size_t i = 0; i != m; ++i)
   {
-    if(_x_ghosted->getMap()->isNodeLocalElement(rows[i]))
-      _x_ghosted->sumIntoLocalValue(rows[i], 0, block[i]);
+    if (rows[i] >= 0 and rows[i] < num_local)
+      x_host(rows[i], 0) += block[i];
     else
     {
       dolfin_error("TpetraVector.cpp",
@@ -328,8 +379,9 @@ void TpetraVector::get_local(std::vector<double>& values) const
 {
   dolfin_assert(!_x.is_null());
   values.resize(local_size());
-  Teuchos::ArrayRCP<const double> arr = _x->getData(0);
-  std::copy(arr.get(), arr.get() + values.size(), values.begin());
+  _x->sync<Kokkos::HostSpace>();
+  auto x_host = _x->getLocalView<Kokkos::HostSpace>();
+  std::copy(x_host.data(), x_host.data() + values.size(), values.begin());
 }
 //-----------------------------------------------------------------------------
 void TpetraVector::set_local(const std::vector<double>& values)
@@ -346,8 +398,10 @@ void TpetraVector::set_local(const std::vector<double>& values)
   if (num_values == 0)
     return;
 
-  Teuchos::ArrayRCP<double> arr = _x->getDataNonConst(0);
-  std::copy(values.begin(), values.end(), arr.get());
+  _x->sync<Kokkos::HostSpace>();
+  _x->modify<Kokkos::HostSpace>();
+  auto x_host = _x->getLocalView<Kokkos::HostSpace>();
+  std::copy(values.begin(), values.end(), x_host.data());
 }
 //-----------------------------------------------------------------------------
 void TpetraVector::add_local(const Array<double>& values)
@@ -362,8 +416,11 @@ void TpetraVector::add_local(const Array<double>& values)
                  "Size of values array is not equal to local vector size");
   }
 
+  _x->sync<Kokkos::HostSpace>();
+  _x->modify<Kokkos::HostSpace>();
+  auto x_host = _x->getLocalView<Kokkos::HostSpace>();
   for (std::size_t i = 0; i != num_values; ++i)
-    _x->sumIntoLocalValue(i, 0, values[i]);
+    x_host(i, 0) += values[i];
 }
 //-----------------------------------------------------------------------------
 void TpetraVector::gather(GenericVector& y,
@@ -49,6 +49,13 @@ namespace dolfin
   /// The interface is intentionally simple. For advanced usage,
   /// access the Teuchos::RCP<Tpetra::MultiVector> using the function
   /// vec() and use the standard Tpetra interface.
+  ///
+  /// The vector uses the default Tpetra node (and hence the Kokkos
+  /// execution space, e.g. OpenMP or CUDA, that Trilinos was
+  /// configured with). Local insertion and extraction access the
+  /// host view of the Kokkos dual view once per block, so data are
+  /// copied between host and device only when modified on the other
+  /// side.
 
   class TpetraVector : public GenericVector
   {
@@ -231,6 +238,25 @@ namespace dolfin
     /// Update ghost values in vector
     virtual void update_ghost_values();
 
+    /// Complete update of ghost values (the import is blocking, so
+    /// all communication is done here)
+    virtual void update_ghost_values_end()
+    { update_ghost_values(); }
+
+    /// Get direct access to the local values (owned values followed
+    /// by ghost values if ghosted is true)
+    virtual double* get_local_array(std::size_t& size, bool ghosted);
+
+    /// Get direct read-only access to the local values
+    virtual const double*
+      get_local_array(std::size_t& size, bool ghosted) const;
+
+    /// Release access obtained with get_local_array()
+    virtual void restore_local_array(double* data, bool ghosted);
+
+    /// Release read-only access obtained with get_local_array()
+    virtual void restore_local_array(const double* data, bool ghosted) const;
+
     //--- Special functions ---
 
     /// Return linear algebra backend factory
@@ -266,6 +292,10 @@ namespace dolfin
     // Tpetra multivector with extra rows for ghost values
     Teuchos::RCP<vector_type> _x_ghosted;
 
+    // Local data held while accessed through get_local_array
+    Teuchos::ArrayRCP<double> _local_array;
+    mutable Teuchos::ArrayRCP<const double> _local_array_const;
+
     // MPI Communicator
     Teuchos::RCP<const Teuchos::MpiComm<int>> _comm;
 
@@ -82,6 +82,10 @@ namespace dolfin
     virtual MPI_Comm mpi_comm() const
     { return vector->mpi_comm(); }
 
+    /// Return estimate of memory used on this process in bytes
+    virtual std::size_t memory_usage() const
+    { return vector->memory_usage(); }
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const
     { return "<Vector wrapper of " + vector->str(verbose) + ">"; }
@@ -162,10 +166,57 @@ namespace dolfin
     virtual void get_local(std::vector<double>& values) const
     { vector->get_local(values); }
 
+    /// Get block of values using strided local indices
+    virtual void get_local_strided(double* block, std::size_t m,
+                                   dolfin::la_index offset,
+                                   dolfin::la_index stride) const
+    { vector->get_local_strided(block, m, offset, stride); }
+
+    /// Set block of values using strided local indices
+    virtual void set_local_strided(const double* block, std::size_t m,
+                                   dolfin::la_index offset,
+                                   dolfin::la_index stride)
+    { vector->set_local_strided(block, m, offset, stride); }
+
     /// Set all values on local process
     virtual void set_local(const std::vector<double>& values)
     { vector->set_local(values); }
 
+    /// Copy owned entries from x without updating ghost values
+    virtual void copy_owned_values(const GenericVector& x)
+    { vector->copy_owned_values(x); }
+
+    /// Start updating ghost values
+    virtual void update_ghost_values_begin()
+    { vector->update_ghost_values_begin(); }
+
+    /// Complete update of ghost values
+    virtual void update_ghost_values_end()
+    { vector->update_ghost_values_end(); }
+
+    /// Get direct access to the local values
+    virtual double* get_local_array(std::size_t& size, bool ghosted)
+    { return vector->get_local_array(size, ghosted); }
+
+    /// Get direct read-only access to the local values
+    virtual const double*
+      get_local_array(std::size_t& size, bool ghosted) const
+    {
+      const GenericVector& x = *vector;
+      return x.get_local_array(size, ghosted);
+    }
+
+    /// Release access obtained with get_local_array()
+    virtual void restore_local_array(double* data, bool ghosted)
+    { vector->restore_local_array(data, ghosted); }
+
+    /// Release read-only access obtained with get_local_array()
+    virtual void restore_local_array(const double* data, bool ghosted) const
+    {
+      const GenericVector& x = *vector;
+      x.restore_local_array(data, ghosted);
+    }
+
     /// Add values to each entry on local process
     virtual void add_local(const Array<double>& values)
     { vector->add_local(values); }
@@ -189,6 +240,11 @@ namespace dolfin
     virtual void axpy(double a, const GenericVector& x)
     { vector->axpy(a, x); }
 
+    /// Add multiples of given vectors (fused AXPY operation)
+    virtual void maxpy(const std::vector<double>& a,
+                       const std::vector<std::shared_ptr<const GenericVector>>& x)
+    { vector->maxpy(a, x); }
+
     /// Replace all entries in the vector by their absolute values
     virtual void abs()
     { vector->abs(); }
@@ -197,6 +253,15 @@ namespace dolfin
     virtual double inner(const GenericVector& x) const
     { return vector->inner(x); }
 
+    /// Return inner products with given vectors
+    virtual std::vector<double>
+      mdot(const std::vector<std::shared_ptr<const GenericVector>>& x) const
+    { return vector->mdot(x); }
+
+    /// Return inner product with given vector and l2 norm
+    virtual std::pair<double, double> inner_norm(const GenericVector& x) const
+    { return vector->inner_norm(x); }
+
     /// Return norm of vector
     virtual double norm(std::string norm_type) const
     { return vector->norm(norm_type); }
@@ -19,6 +19,7 @@
 // Last changed: 2013-05-29
 
 #include <cmath>
+#include <dolfin/common/MPI.h>
 #include <dolfin/common/constants.h>
 #include "GenericVector.h"
 #include "VectorSpaceBasis.h"
@@ -27,25 +28,58 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 VectorSpaceBasis::VectorSpaceBasis(const std::vector<std::shared_ptr<
-                                   GenericVector>> basis) : _basis(basis)
+                                   GenericVector>> basis) : _basis(basis),
+                                                            _local_size(0)
 {
-  // Do nothing
+  if (_basis.empty())
+    return;
+
+  // Store locally owned values contiguously
+  dolfin_assert(_basis[0]);
+  _local_size = _basis[0]->local_size();
+  _values.resize(_basis.size()*_local_size);
+  std::vector<double> values;
+  for (std::size_t i = 0; i < _basis.size(); ++i)
+  {
+    dolfin_assert(_basis[i]);
+    if (_basis[i]->local_size() != _local_size)
+    {
+      dolfin_error("VectorSpaceBasis.cpp",
+                   "create vector space basis",
+                   "Basis vectors must have the same parallel layout");
+    }
+    _basis[i]->get_local(values);
+    std::copy(values.begin(), values.end(),
+              _values.begin() + i*_local_size);
+  }
 }
 //-----------------------------------------------------------------------------
 void VectorSpaceBasis::orthonormalize(double tol)
 {
-  // Loop over each vector in basis
+  std::vector<double> values(_local_size);
   for (std::size_t i = 0; i < _basis.size(); ++i)
   {
+    double* x = _values.data() + i*_local_size;
+
     // Orthogonalize vector i with respect to previously
-    // orthonormalized vectors
+    // orthonormalized vectors, twice, with the squared norm of the
+    // result computed with the second set of inner products
+    subtract(inner(i, x, false), x);
+    std::vector<double> dots = inner(i, x, true);
+    subtract(std::vector<double>(dots.begin(), dots.end() - 1), x);
+
+    // Norm after second orthogonalization (Pythagoras)
+    double norm_sq = dots.back();
     for (std::size_t j = 0; j < i; ++j)
+      norm_sq -= dots[j]*dots[j];
+    if (norm_sq < 1.0e-4*dots.back())
     {
-      const double dot_ij = _basis[i]->inner(*_basis[j]);
-      _basis[i]->axpy(-dot_ij, *_basis[j]);
+      // Cancellation, compute norm directly
+      norm_sq = inner(0, x, true).back();
     }
+    const double norm = std::sqrt(std::max(norm_sq, 0.0));
 
-    if (_basis[i]->norm("l2") < tol)
+    if (norm < tol)
     {
       dolfin_error("VectorSpaceBasis.cpp",
                    "orthonormalize vector basis",
@@ -53,7 +87,13 @@ void VectorSpaceBasis::orthonormalize(double tol)
     }
 
     // Normalise basis function
-    (*_basis[i]) /= _basis[i]->norm("l2");
+    for (std::size_t k = 0; k < _local_size; ++k)
+      x[k] /= norm;
+
+    // Update basis vector
+    std::copy(x, x + _local_size, values.begin());
+    _basis[i]->set_local(values);
+    _basis[i]->apply("insert");
   }
 }
 //-----------------------------------------------------------------------------
@@ -61,13 +101,12 @@ bool VectorSpaceBasis::is_orthonormal(double tol) const
 {
   for (std::size_t i = 0; i < _basis.size(); i++)
   {
-    for (std::size_t j = i; j < _basis.size(); j++)
+    const std::vector<double> dots
+      = inner(i + 1, _values.data() + i*_local_size, false);
+    for (std::size_t j = 0; j <= i; j++)
     {
-      dolfin_assert(_basis[i]);
-      dolfin_assert(_basis[j]);
       const double delta_ij = (i == j) ? 1.0 : 0.0;
-      const double dot_ij = _basis[i]->inner(*_basis[j]);
-      if (std::abs(delta_ij - dot_ij) > tol)
+      if (std::abs(delta_ij - dots[j]) > tol)
         return false;
     }
   }
@@ -79,16 +118,12 @@ bool VectorSpaceBasis::is_orthogonal(double tol) const
 {
   for (std::size_t i = 0; i < _basis.size(); i++)
   {
-    for (std::size_t j = i; j < _basis.size(); j++)
+    const std::vector<double> dots
+      = inner(i, _values.data() + i*_local_size, false);
+    for (std::size_t j = 0; j < i; j++)
     {
-      dolfin_assert(_basis[i]);
-      dolfin_assert(_basis[j]);
-      if (i != j)
-      {
-        const double dot_ij = _basis[i]->inner(*_basis[j]);
-        if (std::abs(dot_ij) > tol)
-          return false;
-      }
+      if (std::abs(dots[j]) > tol)
+        return false;
     }
   }
 
@@ -97,11 +132,66 @@ bool VectorSpaceBasis::is_orthogonal(double tol) const
 //-----------------------------------------------------------------------------
 void VectorSpaceBasis::orthogonalize(GenericVector& x) const
 {
-  for (std::size_t i = 0; i < _basis.size(); i++)
+  if (_basis.empty())
+    return;
+
+  if (x.local_size() != _local_size)
   {
-    dolfin_assert(_basis[i]);
-    const double dot = _basis[i]->inner(x);
-    x.axpy(-dot, *_basis[i]);
+    dolfin_error("VectorSpaceBasis.cpp",
+                 "orthogonalize vector",
+                 "Vector and basis must have the same parallel layout");
+  }
+
+  // Compute all inner products with one reduction, then subtract
+  std::vector<double> values;
+  x.get_local(values);
+  subtract(inner(_basis.size(), values.data(), false), values.data());
+  x.set_local(values);
+  x.apply("insert");
+}
+//-----------------------------------------------------------------------------
+std::vector<double> VectorSpaceBasis::inner(std::size_t n, const double* x,
+                                            bool add_norm) const
+{
+  std::vector<double> dots(n + (add_norm ? 1 : 0), 0.0);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const double* b = _values.data() + i*_local_size;
+    double dot = 0.0;
+    for (std::size_t k = 0; k < _local_size; ++k)
+      dot += b[k]*x[k];
+    dots[i] = dot;
+  }
+  if (add_norm)
+  {
+    double norm_sq = 0.0;
+    for (std::size_t k = 0; k < _local_size; ++k)
+      norm_sq += x[k]*x[k];
+    dots[n] = norm_sq;
+  }
+
+  // Sum over processes
+  #ifdef HAS_MPI
+  if (!_basis.empty() && !dots.empty())
+  {
+    std::vector<double> global_dots(dots.size());
+    MPI_Allreduce(dots.data(), global_dots.data(), dots.size(), MPI_DOUBLE,
+                  MPI_SUM, _basis[0]->mpi_comm());
+    dots = global_dots;
+  }
+  #endif
+
+  return dots;
+}
+//-----------------------------------------------------------------------------
+void VectorSpaceBasis::subtract(const std::vector<double>& a, double* x) const
+{
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    const double* b = _values.data() + i*_local_size;
+    const double a_i = a[i];
+    for (std::size_t k = 0; k < _local_size; ++k)
+      x[k] -= a_i*b[k];
   }
 }
 //-----------------------------------------------------------------------------
@@ -29,6 +29,12 @@ namespace dolfin
   /// This class defines a basis for vector spaces, typically used for
   /// expressing nullspaces of singular operators and 'near
   /// nullspaces' used in smoothed aggregation algebraic multigrid.
+  ///
+  /// The locally owned entries of the basis vectors are also stored
+  /// contiguously (one vector after the other), so that inner
+  /// products with all basis vectors are computed in one pass with a
+  /// single global reduction. The basis vectors must therefore not
+  /// be modified other than through this class after construction.
 
   class VectorSpaceBasis
   {
@@ -42,7 +48,10 @@ namespace dolfin
 
     /// Apply the Gram-Schmidt process to orthonormalize the
     /// basis. Throws an error if a (near) linear dependency is
-    /// detected. Error is thrown if <x_i, x_i> < tol.
+    /// detected. Error is thrown if <x_i, x_i> < tol. Each vector is
+    /// orthogonalized against the previous vectors twice (classical
+    /// Gram-Schmidt with reorthogonalization), with blocked inner
+    /// products, so two global reductions are needed per vector.
     void orthonormalize(double tol=1.0e-10);
 
     /// Test if basis is orthonormal
@@ -51,7 +60,9 @@ namespace dolfin
     /// Test if basis is orthogonal
     bool is_orthogonal(double tol=1.0e-10) const;
 
-    /// Orthogonalize x with respect to basis
+    /// Orthogonalize x with respect to the (orthonormal) basis. The
+    /// inner products with all basis vectors are computed with one
+    /// global reduction.
     void orthogonalize(GenericVector& x) const;
 
     /// Number of vectors in the basis
@@ -60,11 +71,32 @@ namespace dolfin
     /// Get a particular basis vector
     std::shared_ptr<const GenericVector> operator[] (std::size_t i) const;
 
+    /// Return the locally owned entries of all basis vectors, stored
+    /// contiguously: entry j of basis vector i is at
+    /// [i*local_size + j]
+    const std::vector<double>& local_values() const
+    { return _values; }
+
   private:
 
+    // Compute inner products of basis vectors 0, ..., n - 1 with the
+    // local values x (one global reduction). If add_norm is true, the
+    // squared norm of x is appended.
+    std::vector<double> inner(std::size_t n, const double* x,
+                              bool add_norm) const;
+
+    // Compute x -= sum_i a[i] basis[i] for i < a.size()
+    void subtract(const std::vector<double>& a, double* x) const;
+
     // Basis vectors
     const std::vector<std::shared_ptr<GenericVector>> _basis;
 
+    // Locally owned entries of the basis vectors (contiguous)
+    std::vector<double> _values;
+
+    // Number of locally owned entries per basis vector
+    std::size_t _local_size;
+
   };
 }
 
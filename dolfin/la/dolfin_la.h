@@ -12,6 +12,7 @@
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/la/VectorSpaceBasis.h>
+#include <dolfin/la/LocalVectorArray.h>
 #include <dolfin/la/GenericLinearSolver.h>
 
 #include <dolfin/la/PETScOptions.h>
@@ -21,6 +22,7 @@
 #include <dolfin/la/EigenMatrix.h>
 
 #include <dolfin/la/PETScMatrix.h>
+#include <dolfin/la/PETScNestMatrix.h>
 #include <dolfin/la/PETScLinearOperator.h>
 #include <dolfin/la/PETScPreconditioner.h>
 #include <dolfin/la/TpetraMatrix.h>
@@ -41,6 +43,7 @@
 
 #include <dolfin/la/TensorLayout.h>
 #include <dolfin/la/SparsityPattern.h>
+#include <dolfin/la/BlockBatch.h>
 
 #include <dolfin/la/IndexMap.h>
 
@@ -264,14 +264,18 @@ void Logger::register_timing(std::string task,
   dolfin_assert(elapsed >=
     std::make_tuple(double(0.0), double(0.0), double(0.0)));
 
-  // Print a message
-  std::stringstream line;
-  line << "Elapsed wall, usr, sys time: "
-       << std::get<0>(elapsed) << ", "
-       << std::get<1>(elapsed) << ", "
-       << std::get<2>(elapsed)
-       << " ("  << task << ")";
-  log(line.str(), TRACE);
+  // Print a message (only format it when it will be printed, since
+  // timers may be stopped very often)
+  if (_log_level <= TRACE)
+  {
+    std::stringstream line;
+    line << "Elapsed wall, usr, sys time: "
+         << std::get<0>(elapsed) << ", "
+         << std::get<1>(elapsed) << ", "
+         << std::get<2>(elapsed)
+         << " ("  << task << ")";
+    log(line.str(), TRACE);
+  }
 
   // Store values for summary
   const auto timing = std::tuple_cat(std::make_tuple(std::size_t(1)), elapsed);
@@ -289,6 +293,19 @@ void Logger::register_timing(std::string task,
   }
 }
 //-----------------------------------------------------------------------------
+void Logger::register_counters(std::string task,
+                               const HardwareCounters::Counts& counts)
+{
+  auto it = _counters.find(task);
+  if (it == _counters.end())
+    _counters[task] = counts;
+  else
+  {
+    for (std::size_t i = 0; i < counts.size(); ++i)
+      it->second[i] += counts[i];
+  }
+}
+//-----------------------------------------------------------------------------
 void Logger::list_timings(TimingClear clear, std::set<TimingType> type)
 {
   // Format and reduce to rank 0
@@ -330,7 +347,11 @@ void Logger::dump_timings_to_xml(std::string filename, TimingClear clear)
 std::map<TimingType, std::string> Logger::_TimingType_descr
   = { { TimingType::wall,   "wall" },
       { TimingType::user,   "usr"  },
-      { TimingType::system, "sys"  } };
+      { TimingType::system, "sys"  },
+      { TimingType::cycles, "cycles" },
+      { TimingType::instructions, "instr" },
+      { TimingType::cache_references, "LLC refs" },
+      { TimingType::cache_misses, "LLC miss" } };
 //-----------------------------------------------------------------------------
 Table Logger::timings(TimingClear clear,
                       std::set<TimingType> type)
@@ -345,8 +366,22 @@ Table Logger::timings(TimingClear clear,
                                       std::get<2>(it.second),
                                       std::get<3>(it.second) };
     table(task, "reps") = num_timings;
+    const auto counts = _counters.find(task);
     for (const auto& t : type)
     {
+      // Hardware counts, when recorded for the task
+      if (static_cast<int>(t) >= 3)
+      {
+        if (counts == _counters.end())
+          continue;
+        const double total
+          = static_cast<double>(counts->second[static_cast<int>(t) - 3]);
+        const double average = total / static_cast<double>(num_timings);
+        table(task, Logger::_TimingType_descr[t] + " avg") = average;
+        table(task, Logger::_TimingType_descr[t] + " tot") = total;
+        continue;
+      }
+
       const double total_time = times[static_cast<int>(t)];
       const double average_time = total_time / static_cast<double>(num_timings);
       table(task, Logger::_TimingType_descr[t] + " avg") = average_time;
@@ -357,7 +392,10 @@ Table Logger::timings(TimingClear clear,
 
   // Clear timings
   if (static_cast<bool>(clear))
+  {
     _timings.clear();
+    _counters.clear();
+  }
 
   return table;
 }
@@ -380,7 +418,10 @@ std::tuple<std::size_t, double, double, double>
 
   // Clear timing
   if (static_cast<bool>(clear))
+  {
     _timings.erase(it);
+    _counters.erase(task);
+  }
 
   return result;
 }
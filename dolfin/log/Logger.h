@@ -30,6 +30,7 @@
 #include <thread>
 #include <tuple>
 
+#include <dolfin/common/HardwareCounters.h>
 #include <dolfin/common/timing.h>
 #include <dolfin/common/MPI.h>
 #include "Table.h"
@@ -105,6 +106,10 @@ namespace dolfin
     void register_timing(std::string task,
                          std::tuple<double, double, double> elapsed);
 
+    /// Register hardware counts (for later summary)
+    void register_counters(std::string task,
+                           const HardwareCounters::Counts& counts);
+
     /// Return a summary of timings and tasks in a Table, optionally
     /// clearing stored timings
     Table timings(TimingClear clear, std::set<TimingType> type);
@@ -167,6 +172,9 @@ namespace dolfin
     std::map<std::string, std::tuple<std::size_t, double, double, double>>
        _timings;
 
+    // Hardware counts for tasks, map from string to total counts
+    std::map<std::string, HardwareCounters::Counts> _counters;
+
     // Thread used for monitoring memory usage
     std::unique_ptr<std::thread> _thread_monitor_memory_usage;
 
@@ -0,0 +1,73 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include "log.h"
+#include "MemoryReport.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+MemoryReport::MemoryReport()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void MemoryReport::add(std::string subsystem, std::size_t bytes)
+{
+  _bytes[subsystem] += bytes;
+}
+//-----------------------------------------------------------------------------
+std::size_t MemoryReport::bytes(std::string subsystem) const
+{
+  auto it = _bytes.find(subsystem);
+  return it == _bytes.end() ? 0 : it->second;
+}
+//-----------------------------------------------------------------------------
+Table MemoryReport::table() const
+{
+  const double mb = 1024.0*1024.0;
+  Table t("Memory usage (MB)");
+  std::size_t total = 0;
+  for (auto& it : _bytes)
+  {
+    t(it.first, "memory") = static_cast<double>(it.second)/mb;
+    total += it.second;
+  }
+  t("total", "memory") = static_cast<double>(total)/mb;
+
+  return t;
+}
+//-----------------------------------------------------------------------------
+void MemoryReport::list(MPI_Comm comm) const
+{
+  // Reduce to rank 0
+  const Table t = table();
+  const Table t_max = MPI::max(comm, t);
+  const Table t_min = MPI::min(comm, t);
+  const Table t_avg = MPI::avg(comm, t);
+  const Table t_sum = MPI::sum(comm, t);
+
+  // Print just on rank 0
+  if (MPI::rank(comm) == 0)
+  {
+    info(t_max.str(true));
+    info(t_min.str(true));
+    info(t_avg.str(true));
+    info(t_sum.str(true));
+  }
+}
+//-----------------------------------------------------------------------------
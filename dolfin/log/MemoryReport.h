@@ -0,0 +1,73 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __MEMORY_REPORT_H
+#define __MEMORY_REPORT_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <dolfin/common/MPI.h>
+#include "Table.h"
+
+namespace dolfin
+{
+
+  /// This class collects memory footprints (in bytes) grouped by
+  /// subsystem and reports them per process and reduced over
+  /// processes. The footprints are typically obtained from the
+  /// memory_usage() member functions of _Mesh_, _MeshTopology_,
+  /// _DofMap_, _SparsityPattern_ and _GenericTensor_, e.g.
+  ///
+  ///   MemoryReport report;
+  ///   report.add("mesh", mesh.memory_usage());
+  ///   report.add("dofmap", dofmap.memory_usage());
+  ///   report.add("matrix", A.memory_usage());
+  ///   report.list(mesh.mpi_comm());
+
+  class MemoryReport
+  {
+  public:
+
+    /// Create empty report
+    MemoryReport();
+
+    /// Add bytes to given subsystem
+    void add(std::string subsystem, std::size_t bytes);
+
+    /// Return bytes added to given subsystem
+    std::size_t bytes(std::string subsystem) const;
+
+    /// Return table with memory in MB of each subsystem (and the
+    /// total) on this process
+    Table table() const;
+
+    /// Print ``MPI_MAX``, ``MPI_MIN``, ``MPI_AVG`` and ``MPI_SUM``
+    /// reductions of table on rank 0. Collective on given
+    /// communicator.
+    void list(MPI_Comm comm) const;
+
+  private:
+
+    // Bytes per subsystem
+    std::map<std::string, std::size_t> _bytes;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,202 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <dolfin/log/log.h>
+#include "SolverTelemetry.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Buffered records, stored as a ring buffer starting at first
+  struct Telemetry
+  {
+    bool enabled = false;
+    std::chrono::steady_clock::time_point origin;
+    std::vector<SolverRecord> records;
+    std::size_t capacity = 0;
+    std::size_t first = 0;
+    std::size_t sequence = 0;
+    std::map<std::size_t, SolverTelemetry::Callback> callbacks;
+    std::size_t next_callback = 0;
+  };
+
+  std::mutex telemetry_mutex;
+
+  Telemetry& telemetry()
+  {
+    static Telemetry t;
+    return t;
+  }
+
+  std::string escape(const std::string& s)
+  {
+    std::string e;
+    for (auto c : s)
+    {
+      if (c == '"' || c == '\\')
+        e += '\\';
+      e += c;
+    }
+    return e;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void SolverTelemetry::enable(std::size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(telemetry_mutex);
+  Telemetry& t = telemetry();
+  t.enabled = true;
+  t.origin = std::chrono::steady_clock::now();
+  t.records.clear();
+  t.capacity = std::max(capacity, (std::size_t) 1);
+  t.first = 0;
+  t.sequence = 0;
+}
+//-----------------------------------------------------------------------------
+void SolverTelemetry::disable()
+{
+  std::lock_guard<std::mutex> lock(telemetry_mutex);
+  telemetry().enabled = false;
+}
+//-----------------------------------------------------------------------------
+bool SolverTelemetry::enabled()
+{
+  std::lock_guard<std::mutex> lock(telemetry_mutex);
+  return telemetry().enabled;
+}
+//-----------------------------------------------------------------------------
+void SolverTelemetry::record(SolverRecord record)
+{
+  std::map<std::size_t, Callback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(telemetry_mutex);
+    Telemetry& t = telemetry();
+    if (!t.enabled)
+      return;
+
+    record.sequence = t.sequence++;
+    if (t.records.size() < t.capacity)
+      t.records.push_back(record);
+    else
+    {
+      // Overwrite oldest record
+      t.records[t.first] = record;
+      t.first = (t.first + 1) % t.capacity;
+    }
+    callbacks = t.callbacks;
+  }
+
+  // Call callbacks outside lock so they may query telemetry
+  for (auto& callback : callbacks)
+    callback.second(record);
+}
+//-----------------------------------------------------------------------------
+std::size_t SolverTelemetry::add_callback(Callback callback)
+{
+  std::lock_guard<std::mutex> lock(telemetry_mutex);
+  Telemetry& t = telemetry();
+  t.callbacks[t.next_callback] = callback;
+  return t.next_callback++;
+}
+//-----------------------------------------------------------------------------
+void SolverTelemetry::remove_callback(std::size_t id)
+{
+  std::lock_guard<std::mutex> lock(telemetry_mutex);
+  telemetry().callbacks.erase(id);
+}
+//-----------------------------------------------------------------------------
+double SolverTelemetry::time()
+{
+  std::lock_guard<std::mutex> lock(telemetry_mutex);
+  const std::chrono::duration<double> t
+    = std::chrono::steady_clock::now() - telemetry().origin;
+  return t.count();
+}
+//-----------------------------------------------------------------------------
+std::size_t SolverTelemetry::size()
+{
+  std::lock_guard<std::mutex> lock(telemetry_mutex);
+  return telemetry().records.size();
+}
+//-----------------------------------------------------------------------------
+std::vector<SolverRecord> SolverTelemetry::drain()
+{
+  std::lock_guard<std::mutex> lock(telemetry_mutex);
+  Telemetry& t = telemetry();
+
+  std::vector<SolverRecord> records;
+  records.reserve(t.records.size());
+  for (std::size_t i = 0; i < t.records.size(); ++i)
+    records.push_back(t.records[(t.first + i) % t.records.size()]);
+
+  t.records.clear();
+  t.first = 0;
+
+  return records;
+}
+//-----------------------------------------------------------------------------
+std::string SolverTelemetry::json(const SolverRecord& r)
+{
+  std::stringstream s;
+  s << std::setprecision(10);
+  s << "{\"solver\": \"" << escape(r.solver) << "\""
+    << ", \"name\": \"" << escape(r.name) << "\""
+    << ", \"sequence\": " << r.sequence
+    << ", \"time\": " << r.time
+    << ", \"iterations\": " << r.iterations
+    << ", \"linear_iterations\": " << r.linear_iterations
+    << ", \"converged\": " << (r.converged ? "true" : "false")
+    << ", \"reason\": \"" << escape(r.reason) << "\""
+    << ", \"setup_time\": " << r.setup_time
+    << ", \"solve_time\": " << r.solve_time
+    << ", \"preconditioner_rebuilt\": "
+    << (r.preconditioner_rebuilt ? "true" : "false")
+    << ", \"residuals\": [";
+  for (std::size_t i = 0; i < r.residuals.size(); ++i)
+    s << (i == 0 ? "" : ", ") << r.residuals[i];
+  s << "]}";
+
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+void SolverTelemetry::write(std::string filename, MPI_Comm comm)
+{
+  const std::vector<SolverRecord> records = drain();
+  if (MPI::rank(comm) != 0)
+    return;
+
+  std::ofstream file(filename.c_str(), std::ios::app);
+  if (!file.good())
+  {
+    dolfin_error("SolverTelemetry.cpp",
+                 "write solver telemetry",
+                 "Unable to open file \"%s\" for writing", filename.c_str());
+  }
+
+  for (auto& r : records)
+    file << json(r) << "\n";
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,139 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __SOLVER_TELEMETRY_H
+#define __SOLVER_TELEMETRY_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include <dolfin/common/MPI.h>
+
+namespace dolfin
+{
+
+  /// Structured record of one linear or nonlinear solve
+
+  struct SolverRecord
+  {
+    /// Type of solver ("krylov" or "newton")
+    std::string solver;
+
+    /// Name of solver (label of the _Variable_ or PETSc options
+    /// prefix)
+    std::string name;
+
+    /// Sequence number of record since telemetry was enabled
+    std::size_t sequence = 0;
+
+    /// Time (seconds) at which the solve finished, relative to when
+    /// telemetry was enabled
+    double time = 0.0;
+
+    /// Number of iterations
+    std::size_t iterations = 0;
+
+    /// Total number of linear solver iterations (Newton only)
+    std::size_t linear_iterations = 0;
+
+    /// True if the solve converged
+    bool converged = false;
+
+    /// Converged or diverged reason reported by the solver
+    std::string reason;
+
+    /// Time (seconds) spent in setup: preconditioner setup (Krylov)
+    /// or assembly of residual and Jacobian (Newton)
+    double setup_time = 0.0;
+
+    /// Time (seconds) spent in iterations: Krylov iterations
+    /// (Krylov) or linear solves (Newton)
+    double solve_time = 0.0;
+
+    /// True if the preconditioner was rebuilt for this solve (Krylov
+    /// only)
+    bool preconditioner_rebuilt = false;
+
+    /// Residual norm at each iteration, starting with the initial
+    /// residual
+    std::vector<double> residuals;
+  };
+
+  /// This class collects _SolverRecord_ s from _PETScKrylovSolver_
+  /// and _NewtonSolver_ in a bounded ring buffer (keeping the most
+  /// recent records) and passes each record to registered
+  /// callbacks. The buffer can be drained as records or appended to
+  /// a file in JSON lines format (one JSON object per record), e.g.
+  /// periodically during a long run:
+  ///
+  ///   SolverTelemetry::enable(10000);
+  ///   ...
+  ///   SolverTelemetry::write("telemetry.jsonl", MPI_COMM_WORLD);
+  ///
+  /// Records are collected on each process. Nothing is recorded
+  /// unless telemetry is enabled.
+
+  class SolverTelemetry
+  {
+  public:
+
+    /// Callback called with each new record
+    typedef std::function<void(const SolverRecord&)> Callback;
+
+    /// Enable collection with buffer for given number of records,
+    /// discarding any buffered records
+    static void enable(std::size_t capacity=1000);
+
+    /// Disable collection (buffered records are kept)
+    static void disable();
+
+    /// Return true if telemetry is enabled
+    static bool enabled();
+
+    /// Add record to buffer and pass it to callbacks. Called by
+    /// solvers; ignored if telemetry is disabled.
+    static void record(SolverRecord record);
+
+    /// Register callback and return its id
+    static std::size_t add_callback(Callback callback);
+
+    /// Remove callback with given id
+    static void remove_callback(std::size_t id);
+
+    /// Return time (seconds) relative to when telemetry was enabled
+    static double time();
+
+    /// Return number of buffered records
+    static std::size_t size();
+
+    /// Return buffered records (oldest first) and clear buffer
+    static std::vector<SolverRecord> drain();
+
+    /// Return record as JSON object on one line
+    static std::string json(const SolverRecord& record);
+
+    /// Drain buffer on all processes and append records of process
+    /// 0 to file in JSON lines format. Collective on given
+    /// communicator.
+    static void write(std::string filename, MPI_Comm comm);
+
+  };
+
+}
+
+#endif
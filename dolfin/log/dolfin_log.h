@@ -6,7 +6,9 @@
 #include <dolfin/log/log.h>
 #include <dolfin/log/Event.h>
 #include <dolfin/log/LogStream.h>
+#include <dolfin/log/MemoryReport.h>
 #include <dolfin/log/Progress.h>
+#include <dolfin/log/SolverTelemetry.h>
 #include <dolfin/log/Table.h>
 #include <dolfin/log/LogLevel.h>
 
@@ -21,13 +21,21 @@
 // Modified by Oeyvind Evju, 2013
 //
 // First added:  2006-06-21
-// Last changed: 2014-02-06
+// Last changed: 2017-10-14
 
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "BoundaryMesh.h"
 #include "Cell.h"
 #include "Facet.h"
 #include "Mesh.h"
+#include "MeshConnectivity.h"
 #include "MeshData.h"
 #include "MeshEditor.h"
 #include "MeshEntity.h"
@@ -39,6 +47,14 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Number of threads for facet classification (set by the global
+  // parameter "num_threads")
+  int boundary_threads()
+  { return SubSystemsManager::num_threads(); }
+}
+
 //-----------------------------------------------------------------------------
 void BoundaryComputation::compute_boundary(const Mesh& mesh,
                                            const std::string type,
@@ -64,8 +80,9 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
   }
 
   // Get my MPI process rank and number of MPI processes
-  const std::size_t my_rank = MPI::rank(mesh.mpi_comm());
-  const std::size_t num_processes = MPI::size(mesh.mpi_comm());
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t my_rank = MPI::rank(mpi_comm);
+  const std::size_t num_processes = MPI::size(mpi_comm);
 
   // Open boundary mesh for editing
   const std::size_t D = mesh.topology().dim();
@@ -75,91 +92,85 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
   // Generate facet - cell connectivity if not generated
   mesh.init(D - 1, D);
 
-  // Temporary arrays for assignment of indices to vertices on the boundary
-  std::map<std::size_t, std::size_t> boundary_vertices;
-
-  // Map of index "owners" (process responsible for assigning global index)
-  std::map< std::size_t, std::size_t > global_index_owner;
+  // Connectivity arrays of the mesh
+  const MeshTopology& topology = mesh.topology();
+  const MeshConnectivity& facet_cells = topology(D - 1, D);
+  const MeshConnectivity& facet_vertices = topology(D - 1, 0);
+  const std::vector<std::int64_t>& global_vertex_indices
+    = topology.global_indices(0);
+  const std::size_t num_facet_vertices = mesh.type().num_vertices(D - 1);
+  const std::int32_t num_facets = topology.ghost_offset(D - 1);
+  const std::int32_t num_all_facets = topology.size(D - 1);
 
   // Shared vertices for full mesh
-  // FIXME: const_cast
   const std::map<std::int32_t, std::set<unsigned int>>&
-    shared_vertices = const_cast<Mesh&>(mesh).topology().shared_entities(0);
+    shared_vertices = topology.shared_entities(0);
 
   // Shared vertices for boundary mesh
   std::map<std::int32_t, std::set<unsigned int>> shared_boundary_vertices;
   if (exterior)
   {
-    // Extract shared vertices if vertex is identified as part of globally
-    // exterior facet.
-    std::vector<std::size_t> boundary_global_indices;
+    // Mark vertices of globally exterior facets
+    std::vector<bool> exterior_vertex(mesh.num_vertices(), false);
+    for (std::int32_t f = 0; f < num_all_facets; ++f)
+    {
+      if (facet_cells.size_global(f) == 1)
+      {
+        const unsigned int* vertices = facet_vertices(f);
+        for (std::size_t i = 0; i < num_facet_vertices; ++i)
+          exterior_vertex[vertices[i]] = true;
+      }
+    }
+
+    // Send shared vertices that are part of a globally exterior facet
+    // to the processes sharing them
+    std::vector<std::vector<std::int64_t>> send_boundary_vertices(num_processes);
     for (std::map<std::int32_t, std::set<unsigned int>>::const_iterator
-        sv_it=shared_vertices.begin(); sv_it != shared_vertices.end(); ++sv_it)
+           sv_it = shared_vertices.begin(); sv_it != shared_vertices.end();
+         ++sv_it)
     {
-      std::size_t local_mesh_index = sv_it->first;
-      Vertex v(mesh, local_mesh_index);
+      if (!exterior_vertex[sv_it->first])
+        continue;
 
-      for (FacetIterator f(v); !f.end(); ++f)
+      shared_boundary_vertices.insert(*sv_it);
+      for (std::set<unsigned int>::const_iterator p = sv_it->second.begin();
+           p != sv_it->second.end(); ++p)
       {
-        if (f->num_global_entities(D) == 1)
-        {
-          const std::size_t global_mesh_index
-            = mesh.topology().global_indices(0)[local_mesh_index];
-          shared_boundary_vertices[local_mesh_index] = sv_it->second;
-          boundary_global_indices.push_back(global_mesh_index);
-          break;
-        }
+        send_boundary_vertices[*p].push_back(global_vertex_indices[sv_it->first]);
       }
     }
+    std::vector<std::vector<std::int64_t>> recv_boundary_vertices;
+    MPI::all_to_all(mpi_comm, send_boundary_vertices, recv_boundary_vertices);
+    for (std::size_t p = 0; p < num_processes; ++p)
+    {
+      std::sort(recv_boundary_vertices[p].begin(),
+                recv_boundary_vertices[p].end());
+    }
 
-    // Distribute all shared boundary vertices
-    std::vector<std::vector<std::size_t>> boundary_global_indices_all;
-    MPI::all_gather(mesh.mpi_comm(), boundary_global_indices,
-                     boundary_global_indices_all);
-
-    // Identify and clean up discrepancies between shared vertices of full mesh
-    // and shared vertices of boundary mesh
+    // Keep only the sharing processes which also identify the vertex
+    // as a boundary vertex
     for (auto sbv_it = shared_boundary_vertices.begin();
          sbv_it != shared_boundary_vertices.end(); )
     {
-      std::size_t local_mesh_index = sbv_it->first;
-      const std::size_t global_mesh_index
-        = mesh.topology().global_indices(0)[local_mesh_index];
-
-      // Check if this vertex is identified as boundary vertex on
-      // other processes sharing this vertex
-      std::set<unsigned int> &other_processes = sbv_it->second;
-      for (auto  op_it=other_processes.begin();
+      const std::int64_t global_mesh_index
+        = global_vertex_indices[sbv_it->first];
+      std::set<unsigned int>& other_processes = sbv_it->second;
+      for (auto op_it = other_processes.begin();
            op_it != other_processes.end(); )
       {
-        // Check if vertex is identified as boundary vertex on process *op_it
-        bool is_boundary_vertex
-          = (std::find(boundary_global_indices_all[*op_it].begin(),
-                      boundary_global_indices_all[*op_it].end(),
-                      global_mesh_index)
-             != boundary_global_indices_all[*op_it].end());
-
-        // Erase item if this is not identified as a boundary vertex
-        // on process *op_it, and increment iterator
-        if (!is_boundary_vertex)
+        const std::vector<std::int64_t>& received
+          = recv_boundary_vertices[*op_it];
+        if (!std::binary_search(received.begin(), received.end(),
+                                global_mesh_index))
         {
-          // Erase item while carefully avoiding invalidating the
-          // iterator: First increment it to get the next, valid
-          // iterator, and then erase what it pointed to from
-          // other_processes
           other_processes.erase(op_it++);
         }
         else
           ++op_it;
       }
 
-      // Erase item from map if no other processes identify this
-      // vertex as a boundary vertex, and increment iterator
-      if (other_processes.size() == 0)
-      {
-        // Erase carefully as above
+      if (other_processes.empty())
         shared_boundary_vertices.erase(sbv_it++);
-      }
       else
         ++sbv_it;
     }
@@ -170,88 +181,79 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
     shared_boundary_vertices = shared_vertices;
   }
 
-  // Determine boundary facet, count boundary vertices and facets, and
-  // assign vertex indices
-  std::size_t num_boundary_vertices = 0;
-  std::size_t num_owned_vertices = 0;
-  std::size_t num_boundary_cells = 0;
-
-  MeshFunction<bool> boundary_facet(reference_to_no_delete_pointer(mesh),
-                                    D - 1, false);
-  for (FacetIterator f(mesh); !f.end(); ++f)
+  // Classify facets, working directly on the facet-cell connectivity
+  std::vector<char> boundary_facet(num_facets, 0);
+  const int num_threads = boundary_threads();
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int32_t f = 0; f < num_facets; ++f)
   {
     // Boundary facets are connected to exactly one cell
-    if (f->num_entities(D) == 1)
+    if (facet_cells.size(f) == 1)
     {
-      const bool global_exterior_facet =  (f->num_global_entities(D) == 1);
-      if (global_exterior_facet && exterior)
-        boundary_facet[*f] = true;
-      else if (!global_exterior_facet && interior)
-        boundary_facet[*f] = true;
-
-      if (boundary_facet[*f])
+      const bool global_exterior_facet = (facet_cells.size_global(f) == 1);
+      if ((global_exterior_facet && exterior)
+          || (!global_exterior_facet && interior))
       {
-        // Count boundary vertices and assign indices
-        for (VertexIterator v(*f); !v.end(); ++v)
-        {
-          const std::size_t local_mesh_index = v->index();
-
-          if (boundary_vertices.find(local_mesh_index)
-              == boundary_vertices.end())
-          {
-            const std::size_t local_boundary_index = num_boundary_vertices;
-            boundary_vertices[local_mesh_index] = local_boundary_index;
-
-            // Determine "owner" of global_mesh_index
-            std::size_t owner = my_rank;
-
-            std::map<std::int32_t, std::set<unsigned int>>::const_iterator
-              other_processes_it
-              = shared_boundary_vertices.find(local_mesh_index);
-            if (other_processes_it != shared_boundary_vertices.end() && D > 1)
-            {
-              const std::set<unsigned int>& other_processes
-                = other_processes_it->second;
-              const std::size_t min_process
-                = *std::min_element(other_processes.begin(),
-                                    other_processes.end());
-              boundary.topology().shared_entities(0)[local_boundary_index]
-                = other_processes;
-
-              // FIXME: More sophisticated ownership determination
-              if (min_process < owner)
-                owner = min_process;
-            }
-            const std::size_t global_mesh_index
-              = mesh.topology().global_indices(0)[local_mesh_index];
-            global_index_owner[global_mesh_index] = owner;
-
-            // Update counts
-            if (owner == my_rank)
-              num_owned_vertices++;
-            num_boundary_vertices++;
-          }
-        }
-
-        // Count boundary cells (facets of the mesh)
-        num_boundary_cells++;
+        boundary_facet[f] = 1;
       }
     }
   }
 
-  // Initiate boundary topology
-  /*
-  boundary.topology().init(0, num_boundary_vertices,
-                           MPI::sum(mesh.mpi_comm(), num_owned_vertices));
-  boundary.topology().init(D - 1, num_boundary_cells,
-                           MPI::sum(mesh.mpi_comm(), num_boundary_cells));
-  */
+  // Count boundary vertices and facets, and assign local vertex
+  // indices and vertex owners ("owner" is the process responsible
+  // for assigning the global boundary index)
+  std::vector<std::int32_t> boundary_vertices(mesh.num_vertices(), -1);
+  std::vector<std::size_t> mesh_vertices;
+  std::vector<std::size_t> vertex_owner;
+  std::size_t num_owned_vertices = 0;
+  std::size_t num_boundary_cells = 0;
+  for (std::int32_t f = 0; f < num_facets; ++f)
+  {
+    if (!boundary_facet[f])
+      continue;
+
+    const unsigned int* vertices = facet_vertices(f);
+    for (std::size_t i = 0; i < num_facet_vertices; ++i)
+    {
+      const std::size_t local_mesh_index = vertices[i];
+      if (boundary_vertices[local_mesh_index] >= 0)
+        continue;
+
+      const std::size_t local_boundary_index = mesh_vertices.size();
+      boundary_vertices[local_mesh_index] = local_boundary_index;
+      mesh_vertices.push_back(local_mesh_index);
+
+      // Determine "owner" of vertex
+      std::size_t owner = my_rank;
+      std::map<std::int32_t, std::set<unsigned int>>::const_iterator
+        other_processes_it = shared_boundary_vertices.find(local_mesh_index);
+      if (other_processes_it != shared_boundary_vertices.end() && D > 1)
+      {
+        const std::set<unsigned int>& other_processes
+          = other_processes_it->second;
+        boundary.topology().shared_entities(0)[local_boundary_index]
+          = other_processes;
+
+        // FIXME: More sophisticated ownership determination
+        const std::size_t min_process = *other_processes.begin();
+        if (min_process < owner)
+          owner = min_process;
+      }
+      vertex_owner.push_back(owner);
+      if (owner == my_rank)
+        num_owned_vertices++;
+    }
+
+    // Count boundary cells (facets of the mesh)
+    num_boundary_cells++;
+  }
+  const std::size_t num_boundary_vertices = mesh_vertices.size();
 
   // Specify number of vertices and cells
   editor.init_vertices_global(num_boundary_vertices,
-                              MPI::sum(mesh.mpi_comm(), num_owned_vertices));
-  editor.init_cells_global(num_boundary_cells, MPI::sum(mesh.mpi_comm(),
-                                                        num_boundary_cells));
+                              MPI::sum(mpi_comm, num_owned_vertices));
+  editor.init_cells_global(num_boundary_cells,
+                           MPI::sum(mpi_comm, num_boundary_cells));
 
   // Write vertex map
   MeshFunction<std::size_t>& vertex_map = boundary.entity_map(0);
@@ -260,96 +262,79 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
     vertex_map.init(reference_to_no_delete_pointer(boundary), 0,
                     num_boundary_vertices);
   }
-  std::map<std::size_t, std::size_t>::const_iterator it;
-  for (it = boundary_vertices.begin(); it != boundary_vertices.end(); ++it)
-    vertex_map[it->second] = it->first;
-
-  // Get vertex ownership distribution, and find index to start global
-  // numbering from
-  std::vector<std::size_t> ownership_distribution(num_processes);
-  MPI::all_gather(mesh.mpi_comm(), num_owned_vertices, ownership_distribution);
-  std::size_t start_index = 0;
-  for (std::size_t j = 0; j < my_rank; j++)
-    start_index += ownership_distribution[j];
+  for (std::size_t i = 0; i < num_boundary_vertices; ++i)
+    vertex_map[i] = mesh_vertices[i];
 
   // Set global indices of owned vertices, request global indices for
-  // vertices owned elsewhere
-  std::map<std::size_t, std::size_t> global_indices;
-  std::vector<std::vector<std::size_t>> request_global_indices(num_processes);
-
+  // vertices owned elsewhere. Only shared vertices can be requested.
+  const std::size_t start_index
+    = MPI::global_offset(mpi_comm, num_owned_vertices, true);
+  std::vector<std::size_t> global_indices(num_boundary_vertices);
+  std::map<std::int64_t, std::size_t> shared_global_indices;
+  std::vector<std::vector<std::int64_t>> request_global_indices(num_processes);
+  std::vector<std::vector<std::size_t>> request_vertices(num_processes);
   std::size_t current_index = start_index;
-  for (std::size_t local_boundary_index = 0;
-       local_boundary_index<num_boundary_vertices; local_boundary_index++)
+  for (std::size_t i = 0; i < num_boundary_vertices; ++i)
   {
-    const std::size_t local_mesh_index = vertex_map[local_boundary_index];
-    const std::size_t global_mesh_index
-      = mesh.topology().global_indices(0)[local_mesh_index];
-
-    const std::size_t owner = global_index_owner[global_mesh_index];
-    if (owner != my_rank)
-      request_global_indices[owner].push_back(global_mesh_index);
+    const std::int64_t global_mesh_index
+      = global_vertex_indices[mesh_vertices[i]];
+    if (vertex_owner[i] != my_rank)
+    {
+      request_global_indices[vertex_owner[i]].push_back(global_mesh_index);
+      request_vertices[vertex_owner[i]].push_back(i);
+    }
     else
-      global_indices[global_mesh_index] = current_index++;
+    {
+      global_indices[i] = current_index++;
+      if (shared_boundary_vertices.find(mesh_vertices[i])
+          != shared_boundary_vertices.end())
+      {
+        shared_global_indices[global_mesh_index] = global_indices[i];
+      }
+    }
   }
 
   // Send and receive requests from other processes
-  std::vector<std::vector<std::size_t>> global_index_requests(num_processes);
-  MPI::all_to_all(mesh.mpi_comm(), request_global_indices,
-                  global_index_requests);
+  std::vector<std::vector<std::int64_t>> global_index_requests;
+  MPI::all_to_all(mpi_comm, request_global_indices, global_index_requests);
 
   // Find response to requests of global indices
   std::vector<std::vector<std::size_t>> respond_global_indices(num_processes);
-  for (std::size_t i = 0; i < num_processes; i++)
+  for (std::size_t p = 0; p < num_processes; p++)
   {
-    const std::size_t N = global_index_requests[i].size();
-    respond_global_indices[i].resize(N);
-
+    const std::size_t N = global_index_requests[p].size();
+    respond_global_indices[p].resize(N);
     for (std::size_t j = 0; j < N; j++)
-      respond_global_indices[i][j]
-        = global_indices[global_index_requests[i][j]];
+    {
+      std::map<std::int64_t, std::size_t>::const_iterator it
+        = shared_global_indices.find(global_index_requests[p][j]);
+      dolfin_assert(it != shared_global_indices.end());
+      respond_global_indices[p][j] = it->second;
+    }
   }
 
   // Scatter responses back to requesting processes
-  std::vector<std::vector<std::size_t>> global_index_responses(num_processes);
-  MPI::all_to_all(mesh.mpi_comm(), respond_global_indices,
-                  global_index_responses);
-
-  // Update global_indices
-  for (std::size_t i = 0; i < num_processes; i++)
+  std::vector<std::vector<std::size_t>> global_index_responses;
+  MPI::all_to_all(mpi_comm, respond_global_indices, global_index_responses);
+  for (std::size_t p = 0; p < num_processes; p++)
   {
-    const std::size_t N = global_index_responses[i].size();
     // Check that responses are the same size as the requests made
-    dolfin_assert(global_index_responses[i].size()
-                  == request_global_indices[i].size());
-    for (std::size_t j = 0; j < N; j++)
-    {
-      const std::size_t global_mesh_index = request_global_indices[i][j];
-      const std::size_t global_boundary_index = global_index_responses[i][j];
-      global_indices[global_mesh_index] = global_boundary_index;
-    }
+    dolfin_assert(global_index_responses[p].size()
+                  == request_vertices[p].size());
+    for (std::size_t j = 0; j < global_index_responses[p].size(); j++)
+      global_indices[request_vertices[p][j]] = global_index_responses[p][j];
   }
 
   // Create vertices
-  for (std::size_t local_boundary_index = 0;
-       local_boundary_index < num_boundary_vertices; local_boundary_index++)
+  for (std::size_t i = 0; i < num_boundary_vertices; i++)
   {
-    const std::size_t local_mesh_index = vertex_map[local_boundary_index];
-    const std::size_t global_mesh_index
-      = mesh.topology().global_indices(0)[local_mesh_index];
-    const std::size_t global_boundary_index = global_indices[global_mesh_index];
-
-    Vertex v(mesh, local_mesh_index);
-
-    editor.add_vertex_global(local_boundary_index, global_boundary_index,
-                             v.point());
+    editor.add_vertex_global(i, global_indices[i],
+                             mesh.geometry().point(mesh_vertices[i]));
   }
 
   // Find global index to start cell numbering from for current process
-  std::vector<std::size_t> cell_distribution(num_processes);
-  MPI::all_gather(mesh.mpi_comm(), num_boundary_cells, cell_distribution);
-  std::size_t start_cell_index = 0;
-  for (std::size_t i = 0; i < my_rank; i++)
-    start_cell_index += cell_distribution[i];
+  const std::size_t start_cell_index
+    = MPI::global_offset(mpi_comm, num_boundary_cells, true);
 
   // Create cells (facets) and map between boundary mesh cells and facets parent
   MeshFunction<std::size_t>& cell_map = boundary.entity_map(D - 1);
@@ -358,30 +343,29 @@ void BoundaryComputation::compute_boundary(const Mesh& mesh,
     cell_map.init(reference_to_no_delete_pointer(boundary), D - 1,
                   num_boundary_cells);
   }
-  std::vector<std::size_t>
-    cell(boundary.type().num_vertices(boundary.topology().dim()));
+  std::vector<std::size_t> cell(num_facet_vertices);
   std::size_t current_cell = 0;
-  for (FacetIterator f(mesh); !f.end(); ++f)
+  for (std::int32_t f = 0; f < num_facets; ++f)
   {
-    if (boundary_facet[*f])
-    {
-      // Compute new vertex numbers for cell
-      const unsigned int* vertices = f->entities(0);
-      for (std::size_t i = 0; i < cell.size(); i++)
-        cell[i] = boundary_vertices[vertices[i]];
-
-      // Reorder vertices so facet is right-oriented w.r.t. facet
-      // normal
-      reorder(cell, *f);
-
-      // Create mapping from boundary cell to mesh facet if requested
-      if (!cell_map.empty())
-        cell_map[current_cell] = f->index();
-
-      // Add cell
-      editor.add_cell(current_cell, start_cell_index+current_cell, cell);
-      current_cell++;
-    }
+    if (!boundary_facet[f])
+      continue;
+
+    // Compute new vertex numbers for cell
+    const unsigned int* vertices = facet_vertices(f);
+    for (std::size_t i = 0; i < num_facet_vertices; i++)
+      cell[i] = boundary_vertices[vertices[i]];
+
+    // Reorder vertices so facet is right-oriented w.r.t. facet
+    // normal
+    reorder(cell, Facet(mesh, f));
+
+    // Create mapping from boundary cell to mesh facet if requested
+    if (!cell_map.empty())
+      cell_map[current_cell] = f;
+
+    // Add cell
+    editor.add_cell(current_cell, start_cell_index + current_cell, cell);
+    current_cell++;
   }
 
   // Close mesh editor. Note the argument order=false to prevent
@@ -310,33 +310,14 @@ namespace dolfin
           for (std::size_t j = 0; j < gdim; ++j)
             coordinates[i*gdim + j] = geom.x(vertices[i])[j];
       }
-      else if (geom_degree == 2)
-      {
-        const std::size_t tdim = _mesh->topology().dim();
-        const std::size_t num_edges = this->num_entities(1);
-        const unsigned int* edges = this->entities(1);
-
-        coordinates.resize((num_vertices + num_edges)*gdim);
-
-        for (std::size_t i = 0; i < num_vertices; ++i)
-          for (std::size_t j = 0; j < gdim; j++)
-            coordinates[i*gdim + j] = geom.x(vertices[i])[j];
-
-        for (std::size_t i = 0; i < num_edges; ++i)
-        {
-          const std::size_t entity_index
-              = (tdim == 1) ? index() : edges[i];
-          const std::size_t point_index
-            = geom.get_entity_index(1, 0, entity_index);
-          for (std::size_t j = 0; j < gdim; ++j)
-            coordinates[(i + num_vertices)*gdim + j] = geom.x(point_index)[j];
-        }
-      }
       else
       {
-        dolfin_error("Cell.h", "get coordinate_dofs", "Unsupported mesh degree");
+        // Higher-order geometry: read points from the precomputed
+        // cell-to-point map (computed once, if not up to date)
+        _mesh->init_cell_points();
+        coordinates.resize(geom.num_cell_points()*gdim);
+        geom.get_coordinate_dofs(index(), coordinates.data());
       }
-
     }
 
     // FIXME: This function is part of a UFC transition
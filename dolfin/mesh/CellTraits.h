@@ -0,0 +1,114 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CELL_TRAITS_H
+#define __CELL_TRAITS_H
+
+#include <cstddef>
+#include "CellType.h"
+
+namespace dolfin
+{
+
+  /// Compile-time properties of a cell type, mirroring the
+  /// corresponding (virtual) functions of _CellType_. Algorithms
+  /// that loop over many entities can dispatch once on the cell
+  /// type and use these constants in the loop body, so that loops
+  /// over entity vertices have fixed trip counts and entity data can
+  /// be held in fixed-size arrays.
+  ///
+  /// For a cell type T, CellTraits<T> provides
+  ///
+  ///     dim                     Topological dimension
+  ///     num_vertices            Number of vertices of the cell
+  ///     num_entities(d)         Number of entities of dimension d
+  ///     num_entity_vertices(d)  Number of vertices of an entity of
+  ///                             dimension d
+  ///
+  /// where the functions are constexpr.
+
+  template <CellType::Type T> struct CellTraits;
+
+  /// Traits of point cells
+  template <> struct CellTraits<CellType::point>
+  {
+    static const std::size_t dim = 0;
+    static const std::size_t num_vertices = 1;
+    static constexpr std::size_t num_entities(std::size_t d)
+    { return d == 0 ? 1 : 0; }
+    static constexpr std::size_t num_entity_vertices(std::size_t d)
+    { return d == 0 ? 1 : 0; }
+  };
+
+  /// Traits of interval cells
+  template <> struct CellTraits<CellType::interval>
+  {
+    static const std::size_t dim = 1;
+    static const std::size_t num_vertices = 2;
+    static constexpr std::size_t num_entities(std::size_t d)
+    { return d == 0 ? 2 : (d == 1 ? 1 : 0); }
+    static constexpr std::size_t num_entity_vertices(std::size_t d)
+    { return d == 0 ? 1 : (d == 1 ? 2 : 0); }
+  };
+
+  /// Traits of triangle cells
+  template <> struct CellTraits<CellType::triangle>
+  {
+    static const std::size_t dim = 2;
+    static const std::size_t num_vertices = 3;
+    static constexpr std::size_t num_entities(std::size_t d)
+    { return d == 0 ? 3 : (d == 1 ? 3 : (d == 2 ? 1 : 0)); }
+    static constexpr std::size_t num_entity_vertices(std::size_t d)
+    { return d <= 2 ? d + 1 : 0; }
+  };
+
+  /// Traits of quadrilateral cells
+  template <> struct CellTraits<CellType::quadrilateral>
+  {
+    static const std::size_t dim = 2;
+    static const std::size_t num_vertices = 4;
+    static constexpr std::size_t num_entities(std::size_t d)
+    { return d == 0 ? 4 : (d == 1 ? 4 : (d == 2 ? 1 : 0)); }
+    static constexpr std::size_t num_entity_vertices(std::size_t d)
+    { return d == 0 ? 1 : (d == 1 ? 2 : (d == 2 ? 4 : 0)); }
+  };
+
+  /// Traits of tetrahedron cells
+  template <> struct CellTraits<CellType::tetrahedron>
+  {
+    static const std::size_t dim = 3;
+    static const std::size_t num_vertices = 4;
+    static constexpr std::size_t num_entities(std::size_t d)
+    { return d == 0 ? 4 : (d == 1 ? 6 : (d == 2 ? 4 : (d == 3 ? 1 : 0))); }
+    static constexpr std::size_t num_entity_vertices(std::size_t d)
+    { return d <= 3 ? d + 1 : 0; }
+  };
+
+  /// Traits of hexahedron cells
+  template <> struct CellTraits<CellType::hexahedron>
+  {
+    static const std::size_t dim = 3;
+    static const std::size_t num_vertices = 8;
+    static constexpr std::size_t num_entities(std::size_t d)
+    { return d == 0 ? 8 : (d == 1 ? 12 : (d == 2 ? 6 : (d == 3 ? 1 : 0))); }
+    static constexpr std::size_t num_entity_vertices(std::size_t d)
+    { return d == 0 ? 1 : (d == 1 ? 2 : (d == 2 ? 4 : (d == 3 ? 8 : 0))); }
+  };
+
+}
+
+#endif
@@ -0,0 +1,163 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CELL_VERTEX_VIEW_H
+#define __CELL_VERTEX_VIEW_H
+
+#include <cstddef>
+#include <vector>
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/log/log.h>
+#include "Mesh.h"
+#include "MeshConnectivity.h"
+#include "MeshGeometry.h"
+#include "MeshTopology.h"
+
+namespace dolfin
+{
+
+  /// This class provides a lightweight, non-owning view of the
+  /// cell-vertex connectivity and the vertex coordinates of a mesh
+  /// with affine geometry. It gives direct access to the contiguous
+  /// arrays stored in MeshConnectivity and MeshGeometry, so that
+  /// loops over cells can be written without creating MeshEntity
+  /// objects or copying coordinates:
+  ///
+  /// @code{.cpp}
+  ///         CellVertexView view(mesh);
+  ///         for (std::size_t c = 0; c < view.ghost_offset(); ++c)
+  ///         {
+  ///           ArrayView<const unsigned int> v = view.vertices(c);
+  ///           for (std::size_t i = 0; i < v.size(); ++i)
+  ///             sum += view.x(v[i])[0];
+  ///         }
+  /// @endcode
+  ///
+  /// The view is invalidated if the mesh topology or geometry is
+  /// modified.
+
+  class CellVertexView
+  {
+  public:
+
+    /// Create view of the cell-vertex connectivity of a mesh
+    explicit CellVertexView(const Mesh& mesh)
+    {
+      // Only affine (vertex) geometry is supported
+      if (mesh.geometry().degree() != 1)
+      {
+        dolfin_error("CellVertexView.h",
+                     "create cell-vertex view",
+                     "Only meshes with affine geometry are supported");
+      }
+
+      const std::size_t tdim = mesh.topology().dim();
+      const MeshConnectivity& connectivity = mesh.topology()(tdim, 0);
+
+      _num_cells = mesh.topology().size(tdim);
+      _ghost_offset = mesh.topology().ghost_offset(tdim);
+      _gdim = mesh.geometry().dim();
+      _offsets = connectivity.offsets().empty() ? NULL
+        : connectivity.offsets().data();
+      _valence = connectivity.valence();
+      if (!_offsets && _valence == 0 && _num_cells > 0)
+      {
+        dolfin_error("CellVertexView.h",
+                     "create cell-vertex view",
+                     "Cell-vertex connectivity is encoded");
+      }
+      _connections = connectivity().empty() ? NULL
+        : connectivity().data();
+      _coordinates = mesh.geometry().x().empty() ? NULL
+        : mesh.geometry().x().data();
+    }
+
+    /// Return number of cells (including ghost cells)
+    std::size_t size() const
+    { return _num_cells; }
+
+    /// Return index of first ghost cell, i.e. the number of regular
+    /// cells
+    std::size_t ghost_offset() const
+    { return _ghost_offset; }
+
+    /// Return geometric dimension
+    std::size_t gdim() const
+    { return _gdim; }
+
+    /// Return number of vertices of given cell
+    std::size_t num_vertices(std::size_t cell) const
+    {
+      dolfin_assert(cell < _num_cells);
+      return offset(cell + 1) - offset(cell);
+    }
+
+    /// Return vertex indices of given cell
+    ArrayView<const unsigned int> vertices(std::size_t cell) const
+    {
+      dolfin_assert(cell < _num_cells);
+      return ArrayView<const unsigned int>(offset(cell + 1) - offset(cell),
+                                           _connections + offset(cell));
+    }
+
+    /// Return coordinates of given vertex
+    const double* x(std::size_t vertex) const
+    { return _coordinates + vertex*_gdim; }
+
+    /// Copy coordinate dofs of given cell into array of length
+    /// num_vertices(cell)*gdim()
+    void get_coordinate_dofs(std::size_t cell, double* coordinate_dofs) const
+    {
+      dolfin_assert(cell < _num_cells);
+      const unsigned int* v = _connections + offset(cell);
+      const std::size_t num_vertices = offset(cell + 1) - offset(cell);
+      for (std::size_t i = 0; i < num_vertices; ++i)
+      {
+        const double* x = _coordinates + v[i]*_gdim;
+        for (std::size_t j = 0; j < _gdim; ++j)
+          coordinate_dofs[i*_gdim + j] = x[j];
+      }
+    }
+
+  private:
+
+    // Return position of first vertex of cell in connectivity array
+    std::size_t offset(std::size_t cell) const
+    { return _offsets ? _offsets[cell] : cell*_valence; }
+
+    // Number of cells and index of first ghost cell
+    std::size_t _num_cells, _ghost_offset;
+
+    // Geometric dimension
+    std::size_t _gdim;
+
+    // Offsets into connectivity array (CSR row pointer), or null if
+    // the connectivity is compressed with constant valence
+    const unsigned int* _offsets;
+    std::size_t _valence;
+
+    // Cell-vertex connectivity (CSR column indices)
+    const unsigned int* _connections;
+
+    // Vertex coordinates
+    const double* _coordinates;
+
+  };
+
+}
+
+#endif
@@ -20,16 +20,20 @@
 // First added:  2011-09-17
 // Last changed: 2014-07-02
 
+#include <boost/functional/hash.hpp>
 #include <boost/multi_array.hpp>
 
 #include "dolfin/common/MPI.h"
+#include "dolfin/common/SubSystemsManager.h"
 #include "dolfin/common/Timer.h"
 #include "dolfin/graph/Graph.h"
 #include "dolfin/graph/SCOTCH.h"
 #include "dolfin/log/log.h"
 #include "BoundaryMesh.h"
+#include "Cell.h"
 #include "Facet.h"
 #include "Mesh.h"
+#include "MeshConnectivity.h"
 #include "MeshEntityIterator.h"
 #include "MeshFunction.h"
 #include "Vertex.h"
@@ -38,6 +42,16 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Hash of an entity key (sorted global vertex indices)
+  struct EntityHash
+  {
+    std::size_t operator()(const std::vector<std::size_t>& entity) const
+    { return boost::hash_range(entity.begin(), entity.end()); }
+  };
+}
+
 //-----------------------------------------------------------------------------
 void DistributedMeshTools::number_entities(const Mesh& mesh, std::size_t d)
 {
@@ -139,32 +153,6 @@ std::size_t DistributedMeshTools::number_entities(
   for (s = slave_entities.begin(); s != slave_entities.end(); ++s)
     exclude[s->first] = true;
 
-  // Build entity global [vertex list]-to-[local entity index]
-  // map. Exclude any slave entities.
-  std::map<std::vector<std::size_t>, unsigned int> entities;
-  std::pair<std::vector<std::size_t>, unsigned int> entity;
-  for (MeshEntityIterator e(mesh, d, "all"); !e.end(); ++e)
-  {
-    const std::size_t local_index = e->index();
-    if (!exclude[local_index])
-    {
-      entity.second = local_index;
-      entity.first = std::vector<std::size_t>();
-      for (VertexIterator vertex(*e); !vertex.end(); ++vertex)
-        entity.first.push_back(vertex->global_index());
-      std::sort(entity.first.begin(), entity.first.end());
-      entities.insert(entity);
-    }
-  }
-
-  // Get vertex global indices
-  const std::vector<std::int64_t>& global_vertex_indices
-    = mesh.topology().global_indices(0);
-
-  // Get shared vertices (local index, [sharing processes])
-  const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices_local
-    = mesh.topology().shared_entities(0);
-
   // Compute ownership of entities of dimension d ([entity vertices], data):
   //  [0]: owned and shared (will be numbered by this process, and number
   //       communicated to other processes)
@@ -172,9 +160,7 @@ std::size_t DistributedMeshTools::number_entities(
   //       communicated to this processes)
   std::array<std::map<Entity, EntityData>, 2> entity_ownership;
   std::vector<std::size_t> owned_entities;
-  compute_entity_ownership(mpi_comm, entities, shared_vertices_local,
-                           global_vertex_indices, d, owned_entities,
-                           entity_ownership);
+  compute_entity_ownership(mesh, d, exclude, owned_entities, entity_ownership);
 
   // Split shared entities for convenience
   const std::map<Entity, EntityData>& owned_shared_entities
@@ -214,9 +200,9 @@ std::size_t DistributedMeshTools::number_entities(
   }
 
   // Communicate indices for shared entities (owned by this process)
-  // and get indices for shared but not owned entities
-  std::vector<std::vector<std::size_t>> send_values(num_processes);
-  std::vector<std::size_t> destinations;
+  // and get indices for shared but not owned entities. Only the
+  // sharing processes communicate, so use sparse exchange.
+  std::map<int, std::vector<std::size_t>> send_values;
   for (it1 = owned_shared_entities.begin();
        it1 != owned_shared_entities.end(); ++it1)
   {
@@ -237,28 +223,30 @@ std::size_t DistributedMeshTools::number_entities(
     {
       // Store interleaved: entity index, number of vertices, global
       // vertex indices
-      std::size_t p = entity_processes[j];
-      send_values[p].push_back(global_entity_index);
-      send_values[p].push_back(e.size());
-      send_values[p].insert(send_values[p].end(), e.begin(), e.end());
+      std::vector<std::size_t>& values = send_values[entity_processes[j]];
+      values.push_back(global_entity_index);
+      values.push_back(e.size());
+      values.insert(values.end(), e.begin(), e.end());
     }
   }
 
   // Send data
-  std::vector<std::vector<std::size_t>> received_values;
-  MPI::all_to_all(mpi_comm, send_values, received_values);
+  std::map<int, std::vector<std::size_t>> received_values;
+  MPI::sparse_all_to_all(mpi_comm, send_values, received_values);
 
   // Fill in global entity indices received from lower ranked
   // processes
-  for (std::size_t p = 0; p < num_processes; ++p)
+  for (auto r = received_values.begin(); r != received_values.end(); ++r)
   {
-    for (std::size_t i = 0; i < received_values[p].size();)
+    const int p = r->first;
+    const std::vector<std::size_t>& values = r->second;
+    for (std::size_t i = 0; i < values.size();)
     {
-      const std::size_t global_index = received_values[p][i++];
-      const std::size_t entity_size = received_values[p][i++];
+      const std::size_t global_index = values[i++];
+      const std::size_t entity_size = values[i++];
       Entity e;
       for (std::size_t j = 0; j < entity_size; ++j)
-        e.push_back(received_values[p][i++]);
+        e.push_back(values[i++]);
 
       // Access unowned entity data
       std::map<Entity, EntityData>::const_iterator recv_entity;
@@ -654,26 +642,15 @@ std::unordered_map<unsigned int,
 }
 //-----------------------------------------------------------------------------
 void DistributedMeshTools::compute_entity_ownership(
-  const MPI_Comm mpi_comm,
-  const std::map<std::vector<std::size_t>, unsigned int>& entities,
-  const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices_local,
-  const std::vector<std::int64_t>& global_vertex_indices,
+  const Mesh& mesh,
   std::size_t d,
+  const std::vector<bool>& exclude,
   std::vector<std::size_t>& owned_entities,
   std::array<std::map<Entity, EntityData>, 2>& shared_entities)
 {
   log(PROGRESS, "Compute ownership for mesh entities of dimension %d.", d);
   Timer timer("Compute mesh entity ownership");
 
-  // Build global-to-local indices map for shared vertices
-  std::map<std::size_t, std::set<unsigned int>> shared_vertices;
-  std::map<std::int32_t, std::set<unsigned int>>::const_iterator v;
-  for (v = shared_vertices_local.begin(); v != shared_vertices_local.end(); ++v)
-  {
-    dolfin_assert(v->first < (int) global_vertex_indices.size());
-    shared_vertices.insert({global_vertex_indices[v->first], v->second});
-  }
-
   // Entity ownership list ([entity vertices], data):
   //  [0]: owned and shared (will be numbered by this process, and number
   //       communicated to other processes)
@@ -682,8 +659,8 @@ void DistributedMeshTools::compute_entity_ownership(
 
   // Compute preliminary ownership lists (shared_entities) without
   // communication
-  compute_preliminary_entity_ownership(mpi_comm, shared_vertices, entities,
-                                       owned_entities, shared_entities);
+  compute_preliminary_entity_ownership(mesh, d, exclude, owned_entities,
+                                       shared_entities);
 
   // Qualify boundary entities. We need to find out if the shared
   // (shared with lower ranked process) entities are entities of a
@@ -691,13 +668,14 @@ void DistributedMeshTools::compute_entity_ownership(
   // ranked process for the entity in question, and is therefore
   // responsible for communicating values to the higher ranked
   // processes (if any).
-  compute_final_entity_ownership(mpi_comm, owned_entities, shared_entities);
+  compute_final_entity_ownership(mesh.mpi_comm(), mesh.type().num_vertices(d),
+                                 owned_entities, shared_entities);
 }
 //-----------------------------------------------------------------------------
 void DistributedMeshTools::compute_preliminary_entity_ownership(
-  const MPI_Comm mpi_comm,
-  const std::map<std::size_t, std::set<unsigned int>>& shared_vertices,
-  const std::map<Entity, unsigned int>& entities,
+  const Mesh& mesh,
+  std::size_t d,
+  const std::vector<bool>& exclude,
   std::vector<std::size_t>& owned_entities,
   std::array<std::map<Entity, EntityData>, 2>& shared_entities)
 {
@@ -711,76 +689,110 @@ void DistributedMeshTools::compute_preliminary_entity_ownership(
   unowned_shared_entities.clear();
 
   // Get my process number
-  const std::size_t process_number = MPI::rank(mpi_comm);
+  const std::size_t process_number = MPI::rank(mesh.mpi_comm());
 
-  // Iterate over all local entities
-  std::map<std::vector<std::size_t>,  unsigned int>::const_iterator it;
-  for (it = entities.begin(); it != entities.end(); ++it)
+  // Sharing processes of each local vertex (NULL if not shared)
+  const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices
+    = mesh.topology().shared_entities(0);
+  std::vector<const std::set<unsigned int>*>
+    vertex_processes(mesh.num_vertices(), NULL);
+  for (auto v = shared_vertices.begin(); v != shared_vertices.end(); ++v)
   {
-    const Entity& entity = it->first;
-    const std::size_t local_entity_index = it->second;
+    dolfin_assert(v->first < (int) vertex_processes.size());
+    vertex_processes[v->first] = &(v->second);
+  }
 
-    // Compute which processes entity is shared with
-    std::vector< unsigned int> entity_processes;
-    if (is_shared(entity, shared_vertices))
-    {
-      // Processes sharing first vertex of entity
-      std::vector<std::size_t>
-        intersection(shared_vertices.find(entity[0])->second.begin(),
-                     shared_vertices.find(entity[0])->second.end());
-      std::vector<std::size_t>::iterator intersection_end = intersection.end();
-
-      // Loop over entity vertices
-      for (std::size_t i = 1; i < entity.size(); ++i)
-      {
-        // Global vertex index
-        const std::size_t v = entity[i];
-
-        // Sharing processes
-        const std::set< unsigned int>& shared_vertices_v
-          = shared_vertices.find(v)->second;
-
-        intersection_end
-          = std::set_intersection(intersection.begin(), intersection_end,
-                                  shared_vertices_v.begin(),
-                                  shared_vertices_v.end(),
-                                  intersection.begin());
-      }
-      entity_processes = std::vector< unsigned int>(intersection.begin(),
-                                                    intersection_end);
-    }
+  const std::vector<std::int64_t>& global_vertex_indices
+    = mesh.topology().global_indices(0);
+  const MeshConnectivity& connectivity = mesh.topology()(d, 0);
+  const std::int64_t num_entities = mesh.num_entities(d);
+  const std::size_t num_entity_vertices = mesh.type().num_vertices(d);
+  const int num_threads = SubSystemsManager::num_threads();
+
+  // An entity can only be shared if all its vertices are shared.
+  // Entities with an unshared vertex are owned exclusively.
+  std::vector<char> maybe_shared(num_entities, 0);
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t i = 0; i < num_entities; ++i)
+  {
+    if (exclude[i])
+      continue;
 
-    // Check if entity is master, slave or shared but not owned (shared
-    // with lower ranked process)
-    bool shared_but_not_owned = false;
-    for (std::size_t i = 0; i < entity_processes.size(); ++i)
+    const unsigned int* vertices = connectivity(i);
+    char all_shared = 1;
+    for (std::size_t j = 0; j < num_entity_vertices; ++j)
     {
-      if (entity_processes[i] < process_number)
+      if (!vertex_processes[vertices[j]])
       {
-        shared_but_not_owned = true;
+        all_shared = 0;
         break;
       }
     }
+    maybe_shared[i] = all_shared;
+  }
+
+  std::vector<std::size_t> candidates;
+  for (std::int64_t i = 0; i < num_entities; ++i)
+  {
+    if (exclude[i])
+      continue;
+    if (maybe_shared[i])
+      candidates.push_back(i);
+    else
+      owned_entities.push_back(i);
+  }
 
-    if (entity_processes.empty())
+  // For candidate entities, compute the entity key (sorted global
+  // vertex indices, fixed width) and the processes sharing all
+  // vertices
+  const std::int64_t num_candidates = candidates.size();
+  std::vector<std::size_t> keys(num_candidates*num_entity_vertices);
+  std::vector<std::vector<unsigned int>> entity_processes(num_candidates);
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t c = 0; c < num_candidates; ++c)
+  {
+    const unsigned int* vertices = connectivity(candidates[c]);
+    std::size_t* key = keys.data() + c*num_entity_vertices;
+    for (std::size_t j = 0; j < num_entity_vertices; ++j)
+      key[j] = global_vertex_indices[vertices[j]];
+    std::sort(key, key + num_entity_vertices);
+
+    // Intersect sharing processes of the entity vertices
+    const std::set<unsigned int>& first = *vertex_processes[vertices[0]];
+    std::vector<unsigned int>& procs = entity_processes[c];
+    procs.assign(first.begin(), first.end());
+    for (std::size_t j = 1; j < num_entity_vertices && !procs.empty(); ++j)
     {
-      owned_entities.push_back(local_entity_index);
+      const std::set<unsigned int>& p = *vertex_processes[vertices[j]];
+      procs.erase(std::set_intersection(procs.begin(), procs.end(),
+                                        p.begin(), p.end(), procs.begin()),
+                  procs.end());
     }
-    else if (shared_but_not_owned)
+  }
+
+  // Check if entity is exclusively owned, shared and owned, or shared
+  // but not owned (shared with lower ranked process)
+  for (std::int64_t c = 0; c < num_candidates; ++c)
+  {
+    const std::vector<unsigned int>& procs = entity_processes[c];
+    if (procs.empty())
     {
-      unowned_shared_entities[entity] = EntityData(local_entity_index,
-                                                   entity_processes);
+      owned_entities.push_back(candidates[c]);
+      continue;
     }
+
+    const Entity entity(keys.begin() + c*num_entity_vertices,
+                        keys.begin() + (c + 1)*num_entity_vertices);
+    if (procs.front() < process_number)
+      unowned_shared_entities[entity] = EntityData(candidates[c], procs);
     else
-    {
-      owned_shared_entities[entity] = EntityData(local_entity_index,
-                                                 entity_processes);
-    }
+      owned_shared_entities[entity] = EntityData(candidates[c], procs);
   }
 }
 //-----------------------------------------------------------------------------
 void DistributedMeshTools::compute_final_entity_ownership(
   const MPI_Comm mpi_comm,
+  std::size_t num_entity_vertices,
   std::vector<std::size_t>& owned_entities,
   std::array<std::map<Entity, EntityData>, 2>& shared_entities)
 {
@@ -788,111 +800,74 @@ void DistributedMeshTools::compute_final_entity_ownership(
   std::map<Entity, EntityData>& owned_shared_entities = shared_entities[0];
   std::map<Entity, EntityData>& unowned_shared_entities = shared_entities[1];
 
-  // Get MPI number of processes and process number
-  const std::size_t num_processes = MPI::size(mpi_comm);
+  // Get process number
   const std::size_t process_number = MPI::rank(mpi_comm);
 
-  // Communicate common entities, starting with the entities we think
-  // are shared but not owned
-  std::vector<std::vector<std::size_t>>
-    send_common_entity_values(num_processes);
-  for (std::map<Entity, EntityData>::const_iterator it
-         = unowned_shared_entities.begin(); it != unowned_shared_entities.end();
-       ++it)
+  // Send the keys of the entities we think are shared (owned or not)
+  // to the processes that might share them. Keys have fixed width,
+  // so they are sent back to back.
+  std::map<int, std::vector<std::size_t>> send_keys;
+  for (std::size_t k = 0; k < 2; ++k)
   {
-    // Get entity vertices (global vertex indices)
-    const Entity& entity = it->first;
-
-    // Get entity processes (processes that might share the entity)
-    const std::vector<unsigned int>& entity_processes = it->second.processes;
-
-    // Prepare data for sending
-    for (std::size_t j = 0; j < entity_processes.size(); ++j)
-    {
-      const std::size_t p = entity_processes[j];
-      send_common_entity_values[p].push_back(entity.size());
-      send_common_entity_values[p].insert(send_common_entity_values[p].end(),
-                                          entity.begin(), entity.end());
-    }
-  }
-
-  // Communicate common entities, add the entities we think are owned
-  // and shared
-  for (std::map<Entity, EntityData>::const_iterator it
-         = owned_shared_entities.begin();
-       it != owned_shared_entities.end(); ++it)
-  {
-    // Get entity vertices (global vertex indices)
-    const Entity& entity = it->first;
-
-    // Get entity processes (processes that might share the entity)
-    const std::vector<unsigned int>& entity_processes = it->second.processes;
-
-    // Prepare data for sending
-    for (std::size_t j = 0; j < entity_processes.size(); ++j)
+    for (auto it = shared_entities[k].begin(); it != shared_entities[k].end();
+         ++it)
     {
-      const unsigned int p = entity_processes[j];
-      dolfin_assert(process_number < p);
-      send_common_entity_values[p].push_back(entity.size());
-      send_common_entity_values[p].insert(send_common_entity_values[p].end(),
-                                          entity.begin(), entity.end());
+      const Entity& entity = it->first;
+      const std::vector<unsigned int>& entity_processes = it->second.processes;
+      for (std::size_t j = 0; j < entity_processes.size(); ++j)
+      {
+        dolfin_assert(k == 1 || process_number < entity_processes[j]);
+        std::vector<std::size_t>& keys = send_keys[entity_processes[j]];
+        keys.insert(keys.end(), entity.begin(), entity.end());
+      }
     }
   }
 
-  // Communicate common entities
-  std::vector<std::vector<std::size_t>> received_common_entity_values;
-  MPI::all_to_all(mpi_comm, send_common_entity_values,
-                  received_common_entity_values);
+  // Communicate common entities (sharing processes only)
+  std::map<int, std::vector<std::size_t>> received_keys;
+  MPI::sparse_all_to_all(mpi_comm, send_keys, received_keys);
 
-  // Check if entities received are really entities
-  std::vector<std::vector<std::size_t>> send_is_entity_values(num_processes);
-  for (std::size_t p = 0; p < num_processes; ++p)
+  // Check if entities received are really entities on this process
+  // (in which case they are in the owned or unowned shared entities),
+  // and reply with one flag per received key
+  std::map<int, std::vector<std::size_t>> send_is_entity;
+  Entity entity(num_entity_vertices);
+  for (auto r = received_keys.begin(); r != received_keys.end(); ++r)
   {
-    for (std::size_t i = 0; i < received_common_entity_values[p].size();)
+    const std::vector<std::size_t>& keys = r->second;
+    std::vector<std::size_t>& is_entity = send_is_entity[r->first];
+    is_entity.reserve(keys.size()/num_entity_vertices);
+    for (std::size_t i = 0; i < keys.size(); i += num_entity_vertices)
     {
-      // Get entity
-      const std::size_t entity_size = received_common_entity_values[p][i++];
-      Entity entity;
-      for (std::size_t j = 0; j < entity_size; ++j)
-        entity.push_back(received_common_entity_values[p][i++]);
-
-      // Check if received really is an entity on this process (in
-      // which case it will be in owned or unowned entities)
-      bool is_entity = false;
-      if (unowned_shared_entities.find(entity) != unowned_shared_entities.end()
-          || owned_shared_entities.find(entity) != owned_shared_entities.end())
-      {
-        is_entity = true;
-      }
-
-      // Add information about entity (whether it's actually an
-      // entity) to send to other processes
-      send_is_entity_values[p].push_back(entity_size);
-      for (std::size_t j = 0; j < entity_size; ++j)
-        send_is_entity_values[p].push_back(entity[j]);
-      send_is_entity_values[p].push_back(is_entity);
+      entity.assign(keys.begin() + i, keys.begin() + i + num_entity_vertices);
+      is_entity.push_back(unowned_shared_entities.find(entity)
+                          != unowned_shared_entities.end()
+                          || owned_shared_entities.find(entity)
+                          != owned_shared_entities.end());
     }
   }
 
-  // Send data back (list of requested entities that are really
-  // entities)
-  std::vector<std::vector<std::size_t>> received_is_entity_values;
-  MPI::all_to_all(mpi_comm, send_is_entity_values, received_is_entity_values);
+  // Send data back (flags for the requested entities)
+  std::map<int, std::vector<std::size_t>> received_is_entity;
+  MPI::sparse_all_to_all(mpi_comm, send_is_entity, received_is_entity);
 
   // Create map from entities to processes where it is an entity
-  std::map<Entity, std::vector<unsigned int>> entity_processes;
-  for (std::size_t p = 0; p < num_processes; ++p)
+  // (processes are in ascending order)
+  std::unordered_map<Entity, std::vector<unsigned int>, EntityHash>
+    entity_processes;
+  for (auto r = received_is_entity.begin(); r != received_is_entity.end(); ++r)
   {
-    for (std::size_t i = 0; i < received_is_entity_values[p].size();)
+    const unsigned int p = r->first;
+    const std::vector<std::size_t>& is_entity = r->second;
+    const std::vector<std::size_t>& keys = send_keys[p];
+    dolfin_assert(keys.size() == is_entity.size()*num_entity_vertices);
+    for (std::size_t i = 0; i < is_entity.size(); ++i)
     {
-      const std::size_t entity_size = received_is_entity_values[p][i++];
-      Entity entity;
-      for (std::size_t j = 0; j < entity_size; ++j)
-        entity.push_back(received_is_entity_values[p][i++]);
-      const std::size_t is_entity = received_is_entity_values[p][i++];
-      if (is_entity == 1)
+      if (is_entity[i] == 1)
       {
         // Add entity since it is actually an entity for process p
+        entity.assign(keys.begin() + i*num_entity_vertices,
+                      keys.begin() + (i + 1)*num_entity_vertices);
         entity_processes[entity].push_back(p);
       }
     }
@@ -900,89 +875,56 @@ void DistributedMeshTools::compute_final_entity_ownership(
 
   // Fix the list of entities we do not own (numbered by lower ranked
   // process)
-  std::vector<std::vector<std::size_t>> unignore_entities;
-  std::map<Entity, EntityData>::iterator entity;
-  for (entity = unowned_shared_entities.begin();
-       entity != unowned_shared_entities.end(); ++entity)
+  for (auto it = unowned_shared_entities.begin();
+       it != unowned_shared_entities.end();)
   {
-    const Entity& entity_vertices = entity->first;
-    EntityData& entity_data = entity->second;
+    const Entity& entity_vertices = it->first;
+    EntityData& entity_data = it->second;
     const unsigned int local_entity_index = entity_data.local_index;
-    if (entity_processes.find(entity_vertices) != entity_processes.end())
+    auto common = entity_processes.find(entity_vertices);
+    if (common != entity_processes.end())
     {
-      const std::vector<unsigned int>& common_processes
-        = entity_processes[entity_vertices];
+      const std::vector<unsigned int>& common_processes = common->second;
       dolfin_assert(!common_processes.empty());
-      const std::size_t min_proc = *(std::min_element(common_processes.begin(),
-                                                      common_processes.end()));
-
-      if (process_number < min_proc)
+      if (process_number < common_processes.front())
       {
         // Move from unowned to owned
-        owned_shared_entities[entity_vertices] = EntityData(local_entity_index,
-                                                            common_processes);
-
-        // Add entity to list of entities that should be removed from
-        // the unowned entity list.
-        unignore_entities.push_back(entity_vertices);
+        owned_shared_entities[entity_vertices]
+          = EntityData(local_entity_index, common_processes);
+        it = unowned_shared_entities.erase(it);
       }
       else
+      {
         entity_data.processes = common_processes;
+        ++it;
+      }
     }
     else
     {
       // Move from unowned to owned exclusively
       owned_entities.push_back(local_entity_index);
-
-      // Add entity to list of entities that should be removed from the
-      // shared but not owned entity list
-      unignore_entities.push_back(entity_vertices);
+      it = unowned_shared_entities.erase(it);
     }
   }
 
-  // Remove unowned shared entities that should not be shared
-  for (std::size_t i = 0; i < unignore_entities.size(); ++i)
-    unowned_shared_entities.erase(unignore_entities[i]);
-
   // Fix the list of entities we share
-  std::vector<std::vector<std::size_t>> unshare_entities;
-  for (std::map<Entity, EntityData>::iterator it
-         = owned_shared_entities.begin();
-       it != owned_shared_entities.end(); ++it)
+  for (auto it = owned_shared_entities.begin();
+       it != owned_shared_entities.end();)
   {
-    const Entity& e = it->first;
-    const unsigned int local_entity_index = it->second.local_index;
-    if (entity_processes.find(e) == entity_processes.end())
+    auto common = entity_processes.find(it->first);
+    if (common == entity_processes.end())
     {
-      // Move from shared to owned elusively
-      owned_entities.push_back(local_entity_index);
-      unshare_entities.push_back(e);
+      // Move from shared to owned exclusively
+      owned_entities.push_back(it->second.local_index);
+      it = owned_shared_entities.erase(it);
     }
     else
     {
       // Update processor list of shared entities
-      it->second.processes = entity_processes[e];
+      it->second.processes = common->second;
+      ++it;
     }
   }
-
-  // Remove shared entities that should not be shared
-  for (std::size_t i = 0; i < unshare_entities.size(); ++i)
-    owned_shared_entities.erase(unshare_entities[i]);
-}
-//-----------------------------------------------------------------------------
-bool DistributedMeshTools::is_shared(const Entity& entity,
-         const std::map<std::size_t, std::set<unsigned int>>& shared_vertices)
-{
-  // Iterate over entity vertices
-  Entity::const_iterator e;
-  for (e = entity.begin(); e != entity.end(); ++e)
-  {
-    // Return false if an entity vertex is not in the list (map) of
-    // shared entities
-    if (shared_vertices.find(*e) == shared_vertices.end())
-      return false;
-  }
-  return true;
 }
 //-----------------------------------------------------------------------------
 std::pair<std::size_t, std::size_t>
@@ -1254,3 +1196,118 @@ void DistributedMeshTools::reorder_values_by_global_indices(MPI_Comm mpi_comm,
   }
 }
 //-----------------------------------------------------------------------------
+std::map<std::string, std::size_t>
+DistributedMeshTools::partition_diagnostics(const Mesh& mesh)
+{
+  const std::size_t D = mesh.topology().dim();
+  const std::size_t num_cells = mesh.num_cells();
+  const std::size_t ghost_offset = mesh.topology().ghost_offset(D);
+
+  // Make sure facets, and their shared entities, are available
+  mesh.init(D - 1);
+  number_entities(mesh, D - 1);
+
+  // Processes in the communication graph: processes sharing a vertex
+  // and owners of ghost cells
+  std::set<unsigned int> neighbours;
+  std::size_t num_shared_vertices = 0;
+  std::size_t halo_volume = 0;
+  if (mesh.topology().have_shared_entities(0))
+  {
+    const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices
+      = mesh.topology().shared_entities(0);
+    num_shared_vertices = shared_vertices.size();
+    for (auto v = shared_vertices.begin(); v != shared_vertices.end(); ++v)
+    {
+      halo_volume += v->second.size();
+      neighbours.insert(v->second.begin(), v->second.end());
+    }
+  }
+
+  const std::vector<unsigned int>& cell_owner = mesh.topology().cell_owner();
+  neighbours.insert(cell_owner.begin(), cell_owner.end());
+
+  std::size_t num_shared_facets = 0;
+  if (mesh.topology().have_shared_entities(D - 1))
+    num_shared_facets = mesh.topology().shared_entities(D - 1).size();
+
+  std::map<std::string, std::size_t> diagnostics;
+  diagnostics["owned cells"] = ghost_offset;
+  diagnostics["ghost cells"] = num_cells - ghost_offset;
+  diagnostics["shared vertices"] = num_shared_vertices;
+  diagnostics["shared facets"] = num_shared_facets;
+  diagnostics["neighbours"] = neighbours.size();
+  diagnostics["halo volume"] = halo_volume;
+
+  return diagnostics;
+}
+//-----------------------------------------------------------------------------
+Table DistributedMeshTools::partition_report(const Mesh& mesh)
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  const std::map<std::string, std::size_t> diagnostics
+    = partition_diagnostics(mesh);
+
+  // Gather values from all processes (map ordering is the same on
+  // all processes)
+  std::vector<std::size_t> local_values;
+  for (auto d = diagnostics.begin(); d != diagnostics.end(); ++d)
+    local_values.push_back(d->second);
+  std::vector<std::size_t> values;
+  MPI::all_gather(mpi_comm, local_values, values);
+  dolfin_assert(values.size() == num_processes*diagnostics.size());
+
+  Table table("Partition diagnostics");
+  std::size_t j = 0;
+  for (auto d = diagnostics.begin(); d != diagnostics.end(); ++d, ++j)
+  {
+    std::size_t max_value = 0;
+    std::size_t sum = 0;
+    for (std::size_t p = 0; p < num_processes; ++p)
+    {
+      const std::size_t value = values[p*diagnostics.size() + j];
+      table.set("process " + std::to_string(p), d->first, value);
+      max_value = std::max(max_value, value);
+      sum += value;
+    }
+
+    const double avg = static_cast<double>(sum)/num_processes;
+    table.set("max", d->first, max_value);
+    table.set("avg", d->first, avg);
+    table.set("imbalance", d->first, avg > 0.0 ? max_value/avg : 1.0);
+  }
+
+  return table;
+}
+//-----------------------------------------------------------------------------
+CellFunction<std::size_t>
+DistributedMeshTools::partition_function(std::shared_ptr<const Mesh> mesh,
+                                         std::string quantity)
+{
+  dolfin_assert(mesh);
+
+  std::size_t value = 0;
+  if (quantity == "rank")
+  {
+    // Call for collective behaviour on all processes
+    partition_diagnostics(*mesh);
+    value = MPI::rank(mesh->mpi_comm());
+  }
+  else
+  {
+    const std::map<std::string, std::size_t> diagnostics
+      = partition_diagnostics(*mesh);
+    auto d = diagnostics.find(quantity);
+    if (d == diagnostics.end())
+    {
+      dolfin_error("DistributedMeshTools.cpp",
+                   "create partition function",
+                   "Unknown partition quantity \"%s\"", quantity.c_str());
+    }
+    value = d->second;
+  }
+
+  return CellFunction<std::size_t>(mesh, value);
+}
+//-----------------------------------------------------------------------------
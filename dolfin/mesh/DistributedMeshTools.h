@@ -23,17 +23,21 @@
 
 #include <array>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <set>
+#include <string>
 #include <utility>
 #include <unordered_map>
 #include <vector>
 #include <dolfin/common/MPI.h>
+#include <dolfin/log/Table.h>
 
 namespace dolfin
 {
 
   class Mesh;
+  template <typename T> class CellFunction;
 
   /// This class provides various functionality for working with
   /// distributed meshes.
@@ -95,6 +99,29 @@ namespace dolfin
                           const std::size_t width,
                           const std::vector<std::int64_t>& global_indices);
 
+    /// Compute partition diagnostics for this process (collective).
+    /// Returned quantities are "owned cells", "ghost cells", "shared
+    /// vertices", "shared facets", "neighbours" (degree of the
+    /// process communication graph) and "halo volume" (number of
+    /// (shared vertex, remote process) pairs). Shared facets are
+    /// computed if necessary.
+    static std::map<std::string, std::size_t>
+      partition_diagnostics(const Mesh& mesh);
+
+    /// Gather partition diagnostics from all processes into a table
+    /// with one row per process, together with rows for the maximum,
+    /// the average and the imbalance factor (maximum/average) of each
+    /// quantity (collective)
+    static Table partition_report(const Mesh& mesh);
+
+    /// Create a CellFunction holding, on all local cells, the value
+    /// of a partition diagnostic quantity (see partition_diagnostics)
+    /// for this process, for visualisation. The quantity "rank" gives
+    /// the process number (collective).
+    static CellFunction<std::size_t>
+      partition_function(std::shared_ptr<const Mesh> mesh,
+                         std::string quantity);
+
   private:
 
     // Data structure for a mesh entity (list of vertices, using
@@ -125,41 +152,40 @@ namespace dolfin
       std::vector<unsigned int> processes;
     };
 
-    // Compute ownership of entities ([entity vertices], data)
-    //  [0]: owned exclusively (will be numbered by this process)
-    //  [1]: owned and shared (will be numbered by this process, and number
+    // Compute ownership of the entities of dimension d which are
+    // not excluded ([entity vertices], data)
+    //  owned_entities: owned exclusively (will be numbered by this
+    //       process)
+    //  [0]: owned and shared (will be numbered by this process, and number
     //       communicated to other processes)
-    //  [2]: not owned but shared (will be numbered by another process,
+    //  [1]: not owned but shared (will be numbered by another process,
     //       and number communicated to this processes)
     static void compute_entity_ownership(
-      const MPI_Comm mpi_comm,
-      const std::map<std::vector<std::size_t>, unsigned int>& entities,
-      const std::map<std::int32_t, std::set<unsigned int> >& shared_vertices_local,
-      const std::vector<std::int64_t>& global_vertex_indices,
+      const Mesh& mesh,
       std::size_t d,
+      const std::vector<bool>& exclude,
       std::vector<std::size_t>& owned_entities,
       std::array<std::map<Entity, EntityData>, 2>& shared_entities);
 
-    // Build preliminary 'guess' of shared entities. This function does
-    // not involve any inter-process communication.
+    // Build preliminary 'guess' of shared entities from the sharing
+    // processes of the entity vertices. This function does not
+    // involve any inter-process communication, and is threaded.
     static void compute_preliminary_entity_ownership(
-      const MPI_Comm mpi_comm,
-      const std::map<std::size_t, std::set<unsigned int> >& shared_vertices,
-      const std::map<Entity, unsigned int>& entities,
+      const Mesh& mesh,
+      std::size_t d,
+      const std::vector<bool>& exclude,
       std::vector<std::size_t>& owned_entities,
       std::array<std::map<Entity, EntityData>, 2>& entity_ownership);
 
-    // Communicate with other processes to finalise entity ownership
+    // Communicate with the sharing processes to finalise entity
+    // ownership (entities have num_entity_vertices vertices)
     static void
       compute_final_entity_ownership(const MPI_Comm mpi_comm,
+                                     std::size_t num_entity_vertices,
                                      std::vector<std::size_t>& owned_entities,
                                      std::array<std::map<Entity,
                                      EntityData>, 2>& entity_ownership);
 
-    // Check if all entity vertices are the shared vertices in overlap
-    static bool is_shared(const std::vector<std::size_t>& entity_vertices,
-                const std::map<std::size_t, std::set<unsigned int> >& shared_vertices);
-
     // Compute and return (number of global entities, process offset)
     static std::pair<std::size_t, std::size_t>
       compute_num_global_entities(const MPI_Comm mpi_comm,
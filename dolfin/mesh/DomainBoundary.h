@@ -45,6 +45,10 @@ namespace dolfin
     virtual bool inside(const Array<double>& x, bool on_boundary) const
     { return on_boundary; }
 
+    /// Return true (inside() is thread safe)
+    virtual bool thread_safe() const
+    { return true; }
+
   };
 
 }
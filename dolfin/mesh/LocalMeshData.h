@@ -130,7 +130,7 @@ namespace dolfin
     struct Topology
     {
       /// Constructor
-      Topology() : dim(-1), num_global_cells(-1) {}
+      Topology() : dim(-1), num_global_cells(-1), num_cell_weights(1) {}
 
       /// Topological dimension
       int dim;
@@ -150,9 +150,14 @@ namespace dolfin
       /// Optional process owner for each cell in global_cell_indices
       std::vector<int> cell_partition;
 
-      /// Optional weight for each cell for partitioning
+      /// Optional weights for each cell for partitioning, stored cell
+      /// by cell with num_cell_weights entries per cell
       std::vector<std::size_t> cell_weight;
 
+      /// Number of weights (balance constraints) per cell in
+      /// cell_weight
+      std::size_t num_cell_weights;
+
       // FIXME: this should replace the need for num_vertices_per_cell
       //        and tdim
       /// Cell type
@@ -168,6 +173,7 @@ namespace dolfin
         global_cell_indices.clear();
         cell_partition.clear();
         cell_weight.clear();
+        num_cell_weights = 1;
       }
 
       /// Unpack received cell vertices
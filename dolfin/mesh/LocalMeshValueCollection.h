@@ -96,21 +96,18 @@ namespace dolfin
       send_indices.resize(num_processes);
       send_v.resize(num_processes);
 
-      const std::map<std::pair<std::size_t, std::size_t>, T>& vals
-        = values.values();
+      const std::vector<std::pair<std::size_t, std::size_t>>& entities
+        = values.entities();
+      const std::vector<T>& vals = values.entity_values();
       for (std::size_t p = 0; p < num_processes; p++)
       {
         const std::pair<std::size_t, std::size_t> local_range
           = MPI::local_range(_mpi_comm.comm(), p, vals.size());
-        typename std::map<std::pair<std::size_t,
-          std::size_t>, T>::const_iterator it = vals.begin();
-        std::advance(it, local_range.first);
         for (std::size_t i = local_range.first; i < local_range.second; ++i)
         {
-          send_indices[p].push_back(it->first.first);
-          send_indices[p].push_back(it->first.second);
-          send_v[p].push_back(it->second);
-          std::advance(it, 1);
+          send_indices[p].push_back(entities[i].first);
+          send_indices[p].push_back(entities[i].second);
+          send_v[p].push_back(vals[i]);
         }
       }
     }
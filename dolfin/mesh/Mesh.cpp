@@ -43,6 +43,9 @@
 #include "Facet.h"
 #include "LocalMeshData.h"
 #include "MeshColoring.h"
+#include "MeshGeometryCache.h"
+#include "MeshInteriorFacets.h"
+#include "MeshExteriorFacets.h"
 #include "MeshOrdering.h"
 #include "MeshPartitioning.h"
 #include "MeshRenumbering.h"
@@ -62,7 +65,8 @@ Mesh::Mesh() : Mesh(MPI_COMM_WORLD)
 //-----------------------------------------------------------------------------
 Mesh::Mesh(MPI_Comm comm) : Variable("mesh", "DOLFIN mesh"),
                             Hierarchical<Mesh>(*this), _ordered(false),
-                            _mpi_comm(comm), _ghost_mode("none")
+                            _mpi_comm(comm), _ghost_mode("none"),
+                            _point_locator("tree")
 {
   // Do nothing
 }
@@ -70,7 +74,7 @@ Mesh::Mesh(MPI_Comm comm) : Variable("mesh", "DOLFIN mesh"),
 Mesh::Mesh(const Mesh& mesh) : Variable("mesh", "DOLFIN mesh"),
                                Hierarchical<Mesh>(*this), _ordered(false),
                                _mpi_comm(mesh.mpi_comm()),
-                               _ghost_mode("none")
+                               _ghost_mode("none"), _point_locator("tree")
 {
   *this = mesh;
 }
@@ -82,7 +86,7 @@ Mesh::Mesh(std::string filename) : Mesh(MPI_COMM_WORLD, filename)
 //-----------------------------------------------------------------------------
 Mesh::Mesh(MPI_Comm comm, std::string filename)
   : Variable("mesh", "DOLFIN mesh"), Hierarchical<Mesh>(*this), _ordered(false),
-  _mpi_comm(comm), _ghost_mode("none")
+  _mpi_comm(comm), _ghost_mode("none"), _point_locator("tree")
 {
   File file(_mpi_comm.comm(), filename);
   file >> *this;
@@ -90,7 +94,8 @@ Mesh::Mesh(MPI_Comm comm, std::string filename)
 //-----------------------------------------------------------------------------
 Mesh::Mesh(MPI_Comm comm, LocalMeshData& local_mesh_data)
   : Variable("mesh", "DOLFIN mesh"), Hierarchical<Mesh>(*this),
-  _ordered(false), _mpi_comm(comm), _ghost_mode("none")
+  _ordered(false), _mpi_comm(comm), _ghost_mode("none"),
+  _point_locator("tree")
 {
   const std::string ghost_mode = parameters["ghost_mode"];
   MeshPartitioning::build_distributed_mesh(*this, local_mesh_data, ghost_mode);
@@ -112,9 +117,17 @@ const Mesh& Mesh::operator=(const Mesh& mesh)
     _cell_type.reset(CellType::create(mesh._cell_type->cell_type()));
   else
     _cell_type.reset();
-  _ordered = mesh._ordered;
+  _ordered = mesh._ordered.load();
   _cell_orientations = mesh._cell_orientations;
   _ghost_mode = mesh._ghost_mode;
+  _point_locator = mesh._point_locator;
+
+  // Bounding box tree, geometry cache and facet tables are built on
+  // demand
+  _tree.reset();
+  _geometry_cache.reset();
+  _interior_facets.reset();
+  _exterior_facets.reset();
 
   // Rename
   rename(mesh.name(), mesh.label());
@@ -158,6 +171,11 @@ std::size_t Mesh::init(std::size_t dim) const
   if (dim == 0 || dim == _topology.dim())
     return _topology.size(dim);
 
+  // Compute under lock, unless computed by another thread meanwhile
+  std::lock_guard<std::recursive_mutex> lock(_init_mutex);
+  if (_topology.size(dim) > 0)
+    return _topology.size(dim);
+
   // Check that mesh is ordered
   if (!ordered())
   {
@@ -196,6 +214,11 @@ void Mesh::init(std::size_t d0, std::size_t d1) const
   if (!_topology(d0, d1).empty())
     return;
 
+  // Compute under lock, unless computed by another thread meanwhile
+  std::lock_guard<std::recursive_mutex> lock(_init_mutex);
+  if (!_topology(d0, d1).empty())
+    return;
+
   // Check that mesh is ordered
   if (!ordered())
   {
@@ -231,6 +254,63 @@ void Mesh::init_global(std::size_t dim) const
   DistributedMeshTools::number_entities(*this, dim);
 }
 //-----------------------------------------------------------------------------
+void Mesh::init_cell_points() const
+{
+  // Skip if map is up to date
+  if (_geometry.num_cell_points() > 0
+      && _geometry.cell_points_state() == _topology.state())
+  {
+    return;
+  }
+
+  const std::size_t degree = _geometry.degree();
+  if (degree > 2)
+  {
+    dolfin_error("Mesh.cpp",
+                 "compute cell-to-point map of mesh geometry",
+                 "Mesh geometry of degree %d is not supported", degree);
+  }
+
+  // Points of quadratic geometries are located on vertices and edges
+  // (cells of interval meshes)
+  const std::size_t tdim = _topology.dim();
+  if (degree == 2 && tdim > 1)
+    init(tdim, 1);
+
+  const std::size_t num_cells = _topology.size(tdim);
+  const std::size_t num_vertices = type().num_vertices(tdim);
+  const std::size_t num_edges = (degree == 2) ? type().num_entities(1) : 0;
+  const std::size_t num_cell_points = num_vertices + num_edges;
+  const MeshConnectivity& cell_vertices = _topology(tdim, 0);
+
+  std::vector<unsigned int> cell_points(num_cells*num_cell_points);
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    unsigned int* points = cell_points.data() + c*num_cell_points;
+    std::copy(cell_vertices(c), cell_vertices(c) + num_vertices, points);
+    if (num_edges == 0)
+      continue;
+
+    if (tdim == 1)
+      points[num_vertices] = _geometry.get_entity_index(1, 0, c);
+    else
+    {
+      const unsigned int* edges = _topology(tdim, 1)(c);
+      for (std::size_t i = 0; i < num_edges; ++i)
+      {
+        points[num_vertices + i]
+          = _geometry.get_entity_index(1, 0, edges[i]);
+      }
+    }
+  }
+
+  // The map is cached data of the geometry, hence the const_cast (as
+  // for connectivity in init())
+  Mesh* mesh = const_cast<Mesh*>(this);
+  mesh->_geometry.set_cell_points(num_cell_points, std::move(cell_points),
+                                  _topology.state());
+}
+//-----------------------------------------------------------------------------
 void Mesh::clean()
 {
   const std::size_t D = topology().dim();
@@ -252,8 +332,12 @@ void Mesh::order()
   // Remember that the mesh has been ordered
   _ordered = true;
 
-  // Clear any cell_orientations (as these depend on the ordering)
+  // Clear any cell_orientations, geometric quantities and facet
+  // tables (as these depend on the ordering)
   _cell_orientations.clear();
+  _geometry_cache.reset();
+  _interior_facets.reset();
+  _exterior_facets.reset();
 }
 //-----------------------------------------------------------------------------
 bool Mesh::ordered() const
@@ -262,6 +346,7 @@ bool Mesh::ordered() const
   if (_ordered)
     return true;
 
+  std::lock_guard<std::recursive_mutex> lock(_init_mutex);
   _ordered = MeshOrdering::ordered(*this);
   return _ordered;
 }
@@ -336,16 +421,84 @@ Mesh::color(std::vector<std::size_t> coloring_type) const
 //-----------------------------------------------------------------------------
 std::shared_ptr<BoundingBoxTree> Mesh::bounding_box_tree() const
 {
+  std::lock_guard<std::recursive_mutex> lock(_init_mutex);
+
   // Allocate and build tree if necessary
   if (!_tree)
   {
     _tree.reset(new BoundingBoxTree());
     _tree->build(*this);
+    if (_point_locator == "grid")
+      _tree->build_grid();
+  }
+  else if (_tree->geometry_state() != _geometry.state())
+  {
+    // Refit local tree to moved coordinates (not collective)
+    _tree->refit(false);
   }
 
   return _tree;
 }
 //-----------------------------------------------------------------------------
+std::shared_ptr<const MeshGeometryCache> Mesh::geometry_cache() const
+{
+  std::lock_guard<std::recursive_mutex> lock(_init_mutex);
+
+  // Recompute if coordinates have changed or mesh has been rebuilt
+  if (!_geometry_cache
+      || _geometry_cache->geometry_state() != _geometry.state()
+      || _geometry_cache->topology_state() != _topology.state())
+  {
+    _geometry_cache = std::make_shared<MeshGeometryCache>(*this);
+  }
+
+  return _geometry_cache;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const MeshInteriorFacets> Mesh::interior_facets() const
+{
+  std::lock_guard<std::recursive_mutex> lock(_init_mutex);
+
+  // Recompute if mesh has been rebuilt
+  if (!_interior_facets
+      || _interior_facets->topology_state() != _topology.state())
+  {
+    _interior_facets = std::make_shared<MeshInteriorFacets>(*this);
+  }
+
+  return _interior_facets;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const MeshExteriorFacets> Mesh::exterior_facets() const
+{
+  std::lock_guard<std::recursive_mutex> lock(_init_mutex);
+
+  // Recompute if mesh has been rebuilt
+  if (!_exterior_facets
+      || _exterior_facets->topology_state() != _topology.state())
+  {
+    _exterior_facets = std::make_shared<MeshExteriorFacets>(*this);
+  }
+
+  return _exterior_facets;
+}
+//-----------------------------------------------------------------------------
+void Mesh::set_point_locator(std::string locator)
+{
+  if (locator != "tree" and locator != "grid")
+  {
+    dolfin_error("Mesh.cpp",
+                 "set point locator",
+                 "Unknown point locator \"%s\", expecting \"tree\" or \"grid\"",
+                 locator.c_str());
+  }
+
+  // Tree is rebuilt on demand
+  if (locator != _point_locator)
+    _tree.reset();
+  _point_locator = locator;
+}
+//-----------------------------------------------------------------------------
 double Mesh::hmin() const
 {
   double h = std::numeric_limits<double>::max();
@@ -396,6 +549,12 @@ std::size_t Mesh::hash() const
   return (kt + kg)*(kt + kg + 1)/2 + kg;
 }
 //-----------------------------------------------------------------------------
+std::size_t Mesh::memory_usage() const
+{
+  return sizeof(*this) + _topology.memory_usage() + _geometry.memory_usage()
+    + _cell_orientations.capacity()*sizeof(int);
+}
+//-----------------------------------------------------------------------------
 std::string Mesh::str(bool verbose) const
 {
   std::stringstream s;
@@ -28,7 +28,9 @@
 #ifndef __MESH_H
 #define __MESH_H
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -53,6 +55,9 @@ namespace dolfin
   class Point;
   class SubDomain;
   class BoundingBoxTree;
+  class MeshGeometryCache;
+  class MeshInteriorFacets;
+  class MeshExteriorFacets;
 
   /// A _Mesh_ consists of a set of connected and numbered mesh entities.
   ///
@@ -79,6 +84,18 @@ namespace dolfin
   /// created by a call to mesh.init(1). Similarly, connectivities
   /// such as all edges connected to a given vertex must also be
   /// explicitly created (in this case by a call to mesh.init(0, 1)).
+  ///
+  /// Thread safety: const member functions may be called from
+  /// several threads at the same time. Data created on demand
+  /// (entities and connectivity by init(), the bounding box tree, the
+  /// geometry cache and the ordering check) is created under a lock
+  /// of the mesh, so concurrent first requests are serialised.
+  /// Entities and connectivity must not be created while other
+  /// threads iterate over the same dimensions: call init(dim),
+  /// init(d0, d1) and bounding_box_tree() for the data that will be
+  /// used before starting threads that read the mesh. Non-const
+  /// member functions must not be called concurrently with any other
+  /// member function.
 
   class Mesh : public Variable, public Hierarchical<Mesh>
   {
@@ -269,14 +286,63 @@ namespace dolfin
     /// Get bounding box tree for mesh. The bounding box tree is
     /// initialized and built upon the first call to this
     /// function. The bounding box tree can be used to compute
-    /// collisions between the mesh and other objects. It is the
-    /// responsibility of the caller to use (and possibly rebuild) the
-    /// tree. It is stored as a (mutable) member of the mesh to enable
-    /// sharing of the bounding box tree data structure.
+    /// collisions between the mesh and other objects. If the mesh
+    /// coordinates have changed since the tree was built, the boxes
+    /// of the local tree are refitted (see BoundingBoxTree::refit).
+    /// The tree of process bounding boxes is only updated by a
+    /// collective refit, as done by ALE::move. It is stored as a
+    /// (mutable) member of the mesh to enable sharing of the bounding
+    /// box tree data structure.
     ///
     /// @return std::shared_ptr<BoundingBoxTree>
     std::shared_ptr<BoundingBoxTree> bounding_box_tree() const;
 
+    /// Return cache of geometric quantities of the mesh (cell
+    /// volumes, circumradii and Jacobians, facet areas and normals).
+    /// The cache is computed upon the first call to this function
+    /// and recomputed when the mesh coordinates have changed since.
+    /// A returned cache is never modified, so it stays consistent
+    /// with the coordinates at the time of the call.
+    ///
+    /// @return std::shared_ptr<const MeshGeometryCache>
+    std::shared_ptr<const MeshGeometryCache> geometry_cache() const;
+
+    /// Return table of the interior facets of the mesh with their
+    /// cells and local facet indices, as used in interior facet
+    /// assembly. The table is computed upon the first call to this
+    /// function and recomputed when the mesh topology has changed
+    /// since.
+    ///
+    /// @return std::shared_ptr<const MeshInteriorFacets>
+    std::shared_ptr<const MeshInteriorFacets> interior_facets() const;
+
+    /// Return table of the exterior facets of the mesh as cells and
+    /// local facet indices, as used in exterior facet assembly. The
+    /// table is computed from the cell-vertex connectivity (without
+    /// computing the facets of the mesh) upon the first call to this
+    /// function (collective) and recomputed when the mesh topology
+    /// has changed since.
+    ///
+    /// @return std::shared_ptr<const MeshExteriorFacets>
+    std::shared_ptr<const MeshExteriorFacets> exterior_facets() const;
+
+    /// Select the method used by the bounding box tree of the mesh
+    /// to locate points in cells. The default "tree" descends the
+    /// bounding box tree, while "grid" uses a uniform grid of cell
+    /// bounding boxes (see BoundingBoxGrid), which gives constant
+    /// time lookups for structured and near uniform meshes.
+    ///
+    /// @param locator (std::string)
+    ///         The point locator ("tree" or "grid").
+    void set_point_locator(std::string locator);
+
+    /// Return the method used to locate points in cells (see
+    /// set_point_locator).
+    ///
+    /// @return std::string
+    std::string point_locator() const
+    { return _point_locator; }
+
     /// Get mesh data.
     ///
     /// @return MeshData&
@@ -323,6 +389,13 @@ namespace dolfin
     /// Compute global indices for entity dimension dim
     void init_global(std::size_t dim) const;
 
+    /// Compute the cell-to-point map of the geometry (see
+    /// MeshGeometry::cell_points), giving direct access to the
+    /// coordinate dofs of each cell for geometries of any supported
+    /// degree. The map is only recomputed if the topology has changed
+    /// since it was last computed.
+    void init_cell_points() const;
+
     /// Clean out all auxiliary topology data. This clears all
     /// topological data, except the connectivity between cells and
     /// vertices.
@@ -471,6 +544,14 @@ namespace dolfin
     ///
     std::size_t hash() const;
 
+    /// Estimate of memory used by the mesh on this process.
+    ///
+    /// @return std::size_t
+    ///         Bytes used by topology (including computed
+    ///         connectivities), geometry and cell orientations.
+    ///
+    std::size_t memory_usage() const;
+
     /// Informal string representation.
     ///
     /// @param verbose (bool)
@@ -516,8 +597,10 @@ namespace dolfin
 
     // Friends
     friend class MeshEditor;
+    friend class ALE;
     friend class TopologyComputation;
     friend class MeshPartitioning;
+    friend class HDF5File;
 
     // Mesh topology
     MeshTopology _topology;
@@ -536,11 +619,28 @@ namespace dolfin
     // and is allocated and built when bounding_box_tree() is called.
     mutable std::shared_ptr<BoundingBoxTree> _tree;
 
+    // Cache of geometric quantities, computed when geometry_cache()
+    // is called
+    mutable std::shared_ptr<const MeshGeometryCache> _geometry_cache;
+
+    // Table of interior facets, computed when interior_facets() is
+    // called
+    mutable std::shared_ptr<const MeshInteriorFacets> _interior_facets;
+
+    // Table of exterior facets, computed when exterior_facets() is
+    // called
+    mutable std::shared_ptr<const MeshExteriorFacets> _exterior_facets;
+
     // Cell type
     std::unique_ptr<CellType> _cell_type;
 
     // True if mesh has been ordered
-    mutable bool _ordered;
+    mutable std::atomic<bool> _ordered;
+
+    // Lock for data created on demand by const member functions
+    // (recursive since computing connectivity initialises other
+    // connectivity)
+    mutable std::recursive_mutex _init_mutex;
 
     // Orientation of cells relative to a global direction
     std::vector<int> _cell_orientations;
@@ -551,6 +651,9 @@ namespace dolfin
     // Ghost mode used for partitioning
     std::string _ghost_mode;
 
+    // Method used by bounding box tree for point location
+    std::string _point_locator;
+
   };
 }
 
@@ -23,6 +23,8 @@
 
 #include <map>
 #include <memory>
+#include <numeric>
+#include <set>
 #include <utility>
 #include <dolfin/common/Array.h>
 #include <dolfin/common/utils.h>
@@ -30,6 +32,7 @@
 #include <dolfin/graph/GraphBuilder.h>
 #include <dolfin/graph/GraphColoring.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "Cell.h"
 #include "Edge.h"
 #include "Facet.h"
@@ -116,7 +119,41 @@ MeshColoring::compute_colors(const Mesh& mesh,
   else
     graph = GraphBuilder::local_graph(mesh, coloring_type);
 
-  // Color graph
+  // Color graph. The Jones-Plassmann coloring of cells is consistent
+  // across processes: ghost cells take the color computed by their
+  // owner.
+  const std::string colorer = parameters["graph_coloring_library"];
+  if (colorer == "JonesPlassmann")
+  {
+    const std::size_t dim = coloring_type[0];
+    const std::size_t D = mesh.topology().dim();
+    std::vector<std::int64_t> global_indices;
+    if (mesh.topology().have_global_indices(dim))
+      global_indices = mesh.topology().global_indices(dim);
+    else
+    {
+      global_indices.resize(graph.size());
+      std::iota(global_indices.begin(), global_indices.end(), 0);
+    }
+
+    const std::map<std::int32_t, std::set<unsigned int>> no_shared_entities;
+    if (dim == D)
+    {
+      const std::map<std::int32_t, std::set<unsigned int>>& shared_cells
+        = mesh.topology().have_shared_entities(D)
+        ? mesh.topology().shared_entities(D) : no_shared_entities;
+      return GraphColoring::compute_vertex_coloring_jones_plassmann(
+        mesh.mpi_comm(), graph, global_indices,
+        mesh.topology().ghost_offset(D), shared_cells, true, colors);
+    }
+    else
+    {
+      return GraphColoring::compute_vertex_coloring_jones_plassmann(
+        MPI_COMM_SELF, graph, global_indices, graph.size(),
+        no_shared_entities, true, colors);
+    }
+  }
+
   return GraphColoring::compute_local_vertex_coloring(graph, colors);
 }
 //-----------------------------------------------------------------------------
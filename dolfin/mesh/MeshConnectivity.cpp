@@ -29,7 +29,7 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 MeshConnectivity::MeshConnectivity(std::size_t d0, std::size_t d1)
-  : _d0(d0), _d1(d1)
+  : _d0(d0), _d1(d1), _storage(std::make_shared<Storage>())
 {
   // Do nothing
 }
@@ -48,20 +48,33 @@ MeshConnectivity::~MeshConnectivity()
 const MeshConnectivity&
 MeshConnectivity::operator= (const MeshConnectivity& connectivity)
 {
-  // Copy data
+  // Share data, copied on modification
   _d0 = connectivity._d0;
   _d1 = connectivity._d1;
-  _connections = connectivity._connections;
-  _num_global_connections = connectivity._num_global_connections;
-  index_to_position = connectivity.index_to_position;
+  _storage = connectivity._storage;
 
   return *this;
 }
 //-----------------------------------------------------------------------------
 void MeshConnectivity::clear()
 {
-  std::vector<unsigned int>().swap(_connections);
-  std::vector<unsigned int>().swap(index_to_position);
+  if (_storage.use_count() > 1)
+  {
+    // Start from fresh data, keeping global number of connections
+    std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+    storage->num_global_connections = _storage->num_global_connections;
+    _storage = storage;
+  }
+  else
+  {
+    std::vector<unsigned int>().swap(_storage->connections);
+    std::vector<unsigned int>().swap(_storage->index_to_position);
+    std::vector<std::uint8_t>().swap(_storage->encoded);
+    std::vector<unsigned int>().swap(_storage->encoded_offsets);
+    _storage->num_entities = 0;
+    _storage->valence = 0;
+    _storage->num_encoded_connections = 0;
+  }
 }
 //-----------------------------------------------------------------------------
 void MeshConnectivity::init(std::size_t num_entities,
@@ -74,8 +87,10 @@ void MeshConnectivity::init(std::size_t num_entities,
   const std::size_t size = num_entities*num_connections;
 
   // Allocate
-  _connections.resize(size);
-  std::fill(_connections.begin(), _connections.end(), 0);
+  std::vector<unsigned int>& connections = _storage->connections;
+  std::vector<unsigned int>& index_to_position = _storage->index_to_position;
+  connections.resize(size);
+  std::fill(connections.begin(), connections.end(), 0);
   index_to_position.resize(num_entities + 1);
 
   // Initialize data
@@ -89,6 +104,7 @@ void MeshConnectivity::init(std::vector<std::size_t>& num_connections)
   clear();
 
   // Initialize offsets and compute total size
+  std::vector<unsigned int>& index_to_position = _storage->index_to_position;
   const std::size_t num_entities = num_connections.size();
   index_to_position.resize(num_entities + 1);
   std::size_t size = 0;
@@ -100,21 +116,27 @@ void MeshConnectivity::init(std::vector<std::size_t>& num_connections)
   index_to_position[num_entities] = size;
 
   // Initialize connections
-  _connections.resize(size);
-  std::fill(_connections.begin(), _connections.end(), 0);
+  _storage->connections.resize(size);
+  std::fill(_storage->connections.begin(), _storage->connections.end(), 0);
 }
 //-----------------------------------------------------------------------------
 void MeshConnectivity::set(std::size_t entity, std::size_t connection,
                            std::size_t pos)
 {
+  detach();
+  const std::vector<unsigned int>& index_to_position
+    = _storage->index_to_position;
   dolfin_assert((entity + 1) < index_to_position.size());
   dolfin_assert(pos < index_to_position[entity + 1]
                 - index_to_position[entity]);
-  _connections[index_to_position[entity] + pos] = connection;
+  _storage->connections[index_to_position[entity] + pos] = connection;
 }
 //-----------------------------------------------------------------------------
 void MeshConnectivity::set(std::size_t entity, std::size_t* connections)
 {
+  detach();
+  const std::vector<unsigned int>& index_to_position
+    = _storage->index_to_position;
   dolfin_assert((entity + 1) < index_to_position.size());
   dolfin_assert(connections);
 
@@ -122,14 +144,177 @@ void MeshConnectivity::set(std::size_t entity, std::size_t* connections)
   const std::size_t num_connections
     = index_to_position[entity + 1] - index_to_position[entity];
   std::copy(connections, connections + num_connections,
-            _connections.begin() + index_to_position[entity]);
+            _storage->connections.begin() + index_to_position[entity]);
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::compress(bool encode)
+{
+  const std::vector<unsigned int>& offsets = _storage->index_to_position;
+  if (offsets.size() < 2)
+    return;
+
+  // Check whether all entities have the same number of connections
+  const std::size_t num_entities = offsets.size() - 1;
+  const std::size_t valence = num_entities > 0 ? offsets[1] - offsets[0] : 0;
+  bool constant = valence > 0;
+  for (std::size_t e = 1; e < num_entities && constant; e++)
+    constant = (offsets[e + 1] - offsets[e] == valence);
+  if (!constant && !encode)
+    return;
+
+  // Compress a copy if the data is shared
+  std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+  storage->num_global_connections = _storage->num_global_connections;
+  storage->num_entities = num_entities;
+
+  if (constant)
+  {
+    // Drop offsets
+    storage->connections = _storage->connections;
+    storage->valence = valence;
+  }
+  else
+  {
+    // Encode number of connections and differences of consecutive
+    // connections, with the sign bit folded into the lowest bit
+    // (zigzag) so that small differences of either sign are short
+    std::vector<std::uint8_t>& encoded = storage->encoded;
+    storage->encoded_offsets.resize(num_entities);
+    encoded.reserve(_storage->connections.size() + num_entities);
+    for (std::size_t e = 0; e < num_entities; e++)
+    {
+      storage->encoded_offsets[e] = encoded.size();
+      std::uint64_t x = offsets[e + 1] - offsets[e];
+      std::int64_t previous = 0;
+      for (std::size_t i = offsets[e]; ; i++)
+      {
+        // Write varint, seven bits per byte
+        while (x >= 0x80)
+        {
+          encoded.push_back((std::uint8_t) (x | 0x80));
+          x >>= 7;
+        }
+        encoded.push_back((std::uint8_t) x);
+
+        if (i == offsets[e + 1])
+          break;
+        const std::int64_t delta = (std::int64_t) _storage->connections[i]
+          - previous;
+        previous = _storage->connections[i];
+        x = ((std::uint64_t) delta << 1) ^ (std::uint64_t) (delta >> 63);
+      }
+    }
+    encoded.shrink_to_fit();
+    storage->num_encoded_connections = _storage->connections.size();
+  }
+
+  _storage = storage;
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::expand()
+{
+  if (!_storage->index_to_position.empty() || _storage->num_entities == 0)
+    return;
+
+  std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+  storage->num_global_connections = _storage->num_global_connections;
+  std::vector<unsigned int>& offsets = storage->index_to_position;
+  const std::size_t num_entities = _storage->num_entities;
+  offsets.resize(num_entities + 1);
+
+  if (_storage->valence > 0)
+  {
+    // Restore offsets
+    storage->connections = _storage->connections;
+    for (std::size_t e = 0; e <= num_entities; e++)
+      offsets[e] = e*_storage->valence;
+  }
+  else
+  {
+    // Decode connections
+    storage->connections.reserve(_storage->num_encoded_connections);
+    for (std::size_t e = 0; e < num_entities; e++)
+    {
+      offsets[e] = storage->connections.size();
+      for (ConnectionIterator c(*this, e); !c.end(); ++c)
+        storage->connections.push_back(*c);
+    }
+    offsets[num_entities] = storage->connections.size();
+  }
+
+  _storage = storage;
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::assign(std::vector<unsigned int> connections,
+                              std::size_t num_connections)
+{
+  dolfin_assert(num_connections > 0);
+  dolfin_assert(connections.size() % num_connections == 0);
+
+  // Clear old data if any
+  clear();
+
+  // Take over connections and initialize offsets
+  const std::size_t num_entities = connections.size()/num_connections;
+  _storage->connections.swap(connections);
+  std::vector<unsigned int>& index_to_position = _storage->index_to_position;
+  index_to_position.resize(num_entities + 1);
+  for (std::size_t e = 0; e < index_to_position.size(); e++)
+    index_to_position[e] = e*num_connections;
 }
 //-----------------------------------------------------------------------------
 std::size_t MeshConnectivity::hash() const
 {
-  // Compute local hash key
+  // Compute local hash key (of the uncompressed connections)
   boost::hash<std::vector<unsigned int>> uhash;
-  return uhash(_connections);
+  if (!encoded())
+    return uhash(_storage->connections);
+
+  std::vector<unsigned int> connections;
+  connections.reserve(size());
+  for (std::size_t e = 0; e < _storage->num_entities; e++)
+    for (ConnectionIterator c(*this, e); !c.end(); ++c)
+      connections.push_back(*c);
+  return uhash(connections);
+}
+//-----------------------------------------------------------------------------
+std::size_t MeshConnectivity::memory_usage() const
+{
+  return sizeof(*this) + sizeof(Storage)
+    + _storage->connections.capacity()*sizeof(unsigned int)
+    + _storage->num_global_connections.capacity()*sizeof(unsigned int)
+    + _storage->index_to_position.capacity()*sizeof(unsigned int)
+    + _storage->encoded.capacity()*sizeof(std::uint8_t)
+    + _storage->encoded_offsets.capacity()*sizeof(unsigned int);
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::detach()
+{
+  if (_storage.use_count() > 1)
+    _storage = std::make_shared<Storage>(*_storage);
+  expand();
+}
+//-----------------------------------------------------------------------------
+std::size_t MeshConnectivity::encoded_size(std::size_t entity) const
+{
+  // Read number of connections (first varint of entity)
+  const std::uint8_t* b
+    = _storage->encoded.data() + _storage->encoded_offsets[entity];
+  std::size_t x = 0;
+  for (std::size_t shift = 0; ; shift += 7, ++b)
+  {
+    x |= (std::size_t) (*b & 0x7f) << shift;
+    if (!(*b & 0x80))
+      return x;
+  }
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::encoded_access_error() const
+{
+  dolfin_error("MeshConnectivity.cpp",
+               "access connections",
+               "Connections %d -- %d are encoded, use ConnectionIterator or call expand() first",
+               _d0, _d1);
 }
 //-----------------------------------------------------------------------------
 std::string MeshConnectivity::str(bool verbose) const
@@ -139,21 +324,20 @@ std::string MeshConnectivity::str(bool verbose) const
   if (verbose)
   {
     s << str(false) << std::endl << std::endl;
-    for (std::size_t e = 0; e < index_to_position.size() - 1; e++)
+    const std::size_t num_entities = _storage->index_to_position.empty()
+      ? _storage->num_entities : _storage->index_to_position.size() - 1;
+    for (std::size_t e = 0; e < num_entities; e++)
     {
       s << "  " << e << ":";
-      for (std::size_t i = index_to_position[e]; i < index_to_position[e + 1];
-           i++)
-      {
-        s << " " << _connections[i];
-      }
+      for (ConnectionIterator c(*this, e); !c.end(); ++c)
+        s << " " << *c;
       s << std::endl;
     }
   }
   else
   {
     s << "<MeshConnectivity " << _d0 << " -- " << _d1 << " of size "
-      << _connections.size() << ">";
+      << size() << ">";
   }
 
   return s.str();
@@ -21,7 +21,10 @@
 #ifndef __MESH_CONNECTIVITY_H
 #define __MESH_CONNECTIVITY_H
 
+#include <cstdint>
+#include <memory>
 #include <vector>
+#include <dolfin/common/ArrayView.h>
 #include <dolfin/log/log.h>
 
 namespace dolfin
@@ -35,6 +38,23 @@ namespace dolfin
   /// number of entities and the number of connections for each entity,
   /// which may either be equal for all entities or different, or by
   /// giving the entire (sparse) connectivity pattern.
+  ///
+  /// Copies of a connectivity share their data, which is detached
+  /// (copied) only when one of the copies is modified. Copying a
+  /// mesh therefore does not duplicate its connectivity.
+  ///
+  /// The storage may be made compact by calling compress(). If all
+  /// entities have the same number of connections (e.g. cell-vertex
+  /// and cell-facet connectivity), the offsets are dropped and
+  /// computed from the entity index; this is transparent to all
+  /// functions except offsets(), which returns an empty array. If the
+  /// number of connections varies (e.g. vertex-cell connectivity),
+  /// the connections may in addition be encoded as variable-length
+  /// (varint) differences of consecutive connections. Encoded
+  /// connections must be read with ConnectionIterator, since there is
+  /// no contiguous array to return a pointer to; the functions
+  /// returning pointers raise an error. Modifying the connectivity
+  /// restores the uncompressed storage.
 
   class MeshConnectivity
   {
@@ -54,41 +74,95 @@ namespace dolfin
 
     /// Return true if the total number of connections is equal to zero
     bool empty() const
-    { return _connections.empty(); }
+    { return _storage->connections.empty() && _storage->encoded.empty(); }
 
     /// Return total number of connections
     std::size_t size() const
-    { return _connections.size(); }
+    {
+      return _storage->encoded.empty()
+        ? _storage->connections.size() : _storage->num_encoded_connections;
+    }
 
     /// Return number of connections for given entity
     std::size_t size(std::size_t entity) const
     {
-      return (entity + 1) < index_to_position.size()
-          ? index_to_position[entity + 1] - index_to_position[entity] : 0;
+      const std::vector<unsigned int>& offsets = _storage->index_to_position;
+      if ((entity + 1) < offsets.size())
+        return offsets[entity + 1] - offsets[entity];
+      else if (entity >= _storage->num_entities)
+        return 0;
+      else if (_storage->valence > 0)
+        return _storage->valence;
+      else
+        return encoded_size(entity);
     }
 
     /// Return global number of connections for given entity
     std::size_t size_global(std::size_t entity) const
     {
-      if (_num_global_connections.empty())
+      if (_storage->num_global_connections.empty())
         return size(entity);
       else
       {
-        dolfin_assert(entity < _num_global_connections.size());
-        return _num_global_connections[entity];
+        dolfin_assert(entity < _storage->num_global_connections.size());
+        return _storage->num_global_connections[entity];
       }
     }
 
     /// Return array of connections for given entity
     const unsigned int* operator() (std::size_t entity) const
     {
-      return (entity + 1) < index_to_position.size()
-        ? &_connections[index_to_position[entity]] : 0;
+      const std::vector<unsigned int>& offsets = _storage->index_to_position;
+      if ((entity + 1) < offsets.size())
+        return &_storage->connections[offsets[entity]];
+      else if (entity >= _storage->num_entities)
+        return 0;
+      else if (_storage->valence > 0)
+        return &_storage->connections[entity*_storage->valence];
+      encoded_access_error();
+      return 0;
     }
 
     /// Return contiguous array of connections for all entities
     const std::vector<unsigned int>& operator() () const
-    { return _connections; }
+    {
+      if (!_storage->encoded.empty())
+        encoded_access_error();
+      return _storage->connections;
+    }
+
+    /// Return view of connections for given entity
+    ArrayView<const unsigned int> connections(std::size_t entity) const
+    {
+      const unsigned int* c = (*this)(entity);
+      return c ? ArrayView<const unsigned int>(size(entity), c)
+        : ArrayView<const unsigned int>();
+    }
+
+    /// Return offsets into the contiguous array of connections, such
+    /// that the connections of entity i are located in the range
+    /// [offsets()[i], offsets()[i + 1]). The offsets are empty if the
+    /// storage is compressed (see valence()).
+    const std::vector<unsigned int>& offsets() const
+    { return _storage->index_to_position; }
+
+    /// Return the number of connections of each entity if the
+    /// storage is compressed with implicit offsets, otherwise zero
+    std::size_t valence() const
+    { return _storage->valence; }
+
+    /// Return true if the connections are stored in encoded form
+    /// (see compress())
+    bool encoded() const
+    { return !_storage->encoded.empty(); }
+
+    /// Compress storage. Offsets are dropped if all entities have
+    /// the same number of connections. Otherwise, the connections
+    /// are encoded if encode is true.
+    void compress(bool encode=false);
+
+    /// Restore uncompressed storage
+    void expand();
 
     /// Clear all data
     void clear();
@@ -109,13 +183,15 @@ namespace dolfin
     template<typename T>
     void set(std::size_t entity, const T& connections)
     {
-      dolfin_assert((entity + 1) < index_to_position.size());
+      detach();
+      const std::vector<unsigned int>& offsets = _storage->index_to_position;
+      dolfin_assert((entity + 1) < offsets.size());
       dolfin_assert(connections.size()
-                    == index_to_position[entity + 1]-index_to_position[entity]);
+                    == offsets[entity + 1] - offsets[entity]);
 
       // Copy data
       std::copy(connections.begin(), connections.end(),
-                _connections.begin() + index_to_position[entity]);
+                _storage->connections.begin() + offsets[entity]);
     }
 
     /// Set all connections for given entity
@@ -131,52 +207,199 @@ namespace dolfin
       clear();
 
       // Initialize offsets and compute total size
-      index_to_position.resize(connections.size() + 1);
+      _storage->index_to_position.resize(connections.size() + 1);
       std::int32_t size = 0;
       for (std::size_t e = 0; e < connections.size(); e++)
       {
-        index_to_position[e] = size;
+        _storage->index_to_position[e] = size;
         size += connections[e].size();
       }
-      index_to_position[connections.size()] = size;
+      _storage->index_to_position[connections.size()] = size;
 
       // Initialize connections
-      _connections.reserve(size);
+      _storage->connections.reserve(size);
       for (auto e = connections.begin(); e != connections.end(); ++e)
-        _connections.insert(_connections.end(), e->begin(), e->end());
+      {
+        _storage->connections.insert(_storage->connections.end(),
+                                     e->begin(), e->end());
+      }
 
-      _connections.shrink_to_fit();
+      _storage->connections.shrink_to_fit();
     }
 
+    /// Set connections for all entities from a contiguous array with
+    /// the same number of connections for each entity, taking over
+    /// the array (no copy is made if it is passed as an rvalue)
+    ///
+    /// @param    connections (std::vector<unsigned int>)
+    ///         The connections of entity i at positions
+    ///         [i*num_connections, (i + 1)*num_connections).
+    /// @param    num_connections (std::size_t)
+    ///         The number of connections per entity.
+    void assign(std::vector<unsigned int> connections,
+                std::size_t num_connections);
+
     /// Set global number of connections for all local entities
     void
       set_global_size(const std::vector<unsigned int>& num_global_connections)
     {
+      detach();
       dolfin_assert(num_global_connections.size()
-                    == index_to_position.size() - 1);
-      _num_global_connections = num_global_connections;
+                    == _storage->index_to_position.size() - 1);
+      _storage->num_global_connections = num_global_connections;
     }
 
     /// Hash of connections
     std::size_t hash() const;
 
+    /// Return estimate of memory used on this process in bytes
+    std::size_t memory_usage() const;
+
+    /// Return true if the connection data is shared with a copy of
+    /// this connectivity
+    bool shares_storage() const
+    { return _storage.use_count() > 1; }
+
+    /// Copy the connection data if it is shared with a copy of this
+    /// connectivity, and restore uncompressed storage. This is done
+    /// automatically by all functions modifying the connectivity,
+    /// but must be called before modifying connections in place
+    /// through operator().
+    void detach();
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
   private:
 
+    friend class ConnectionIterator;
+
+    // Return number of connections of entity from encoded storage
+    std::size_t encoded_size(std::size_t entity) const;
+
+    // Raise error for pointer access to encoded connections
+    void encoded_access_error() const;
+
+    // Connection data, shared between copies
+    struct Storage
+    {
+      Storage() : num_entities(0), valence(0), num_encoded_connections(0) {}
+
+      // Connections for all entities stored as a contiguous array
+      // (empty if encoded)
+      std::vector<unsigned int> connections;
+
+      // Global number of connections for all entities (possibly not
+      // computed)
+      std::vector<unsigned int> num_global_connections;
+
+      // Position of first connection for each entity (using local
+      // index), empty if compressed
+      std::vector<unsigned int> index_to_position;
+
+      // Number of entities and constant number of connections per
+      // entity, used if compressed with implicit offsets
+      std::size_t num_entities;
+      std::size_t valence;
+
+      // Encoded connections: for each entity, the number of
+      // connections followed by the zigzag-encoded differences of
+      // consecutive connections, each as a varint. The position of
+      // entity i is encoded_offsets[i].
+      std::vector<std::uint8_t> encoded;
+      std::vector<unsigned int> encoded_offsets;
+      std::size_t num_encoded_connections;
+    };
+
     // Dimensions (only used for pretty-printing)
     std::size_t _d0, _d1;
 
-    // Connections for all entities stored as a contiguous array
-    std::vector<unsigned int> _connections;
+    // Connection data (never null)
+    std::shared_ptr<Storage> _storage;
+
+  };
+
+  /// Iterator over the connections of an entity, which is valid for
+  /// all storage modes of _MeshConnectivity_ (including encoded
+  /// connections):
+  ///
+  /// @code{.cpp}
+  ///         for (ConnectionIterator c(connectivity, i); !c.end(); ++c)
+  ///           sum += *c;
+  /// @endcode
+
+  class ConnectionIterator
+  {
+  public:
+
+    /// Create iterator over connections of given entity
+    ConnectionIterator(const MeshConnectivity& connectivity,
+                       std::size_t entity)
+      : _p(0), _bytes(0), _remaining(0), _value(0)
+    {
+      if (connectivity.encoded())
+      {
+        _bytes = connectivity._storage->encoded.data()
+          + connectivity._storage->encoded_offsets[entity];
+        _remaining = read_varint();
+        if (_remaining > 0)
+          _value = read_delta();
+      }
+      else
+      {
+        _p = connectivity(entity);
+        _remaining = connectivity.size(entity);
+        if (_remaining > 0)
+          _value = *_p;
+      }
+    }
+
+    /// Step to next connection
+    ConnectionIterator& operator++()
+    {
+      dolfin_assert(_remaining > 0);
+      if (--_remaining > 0)
+        _value = _bytes ? _value + read_delta() : *(++_p);
+      return *this;
+    }
+
+    /// Return current connection
+    unsigned int operator*() const
+    { return _value; }
+
+    /// Check if iterator has reached the end
+    bool end() const
+    { return _remaining == 0; }
+
+  private:
+
+    // Read varint and advance
+    std::size_t read_varint()
+    {
+      std::size_t x = 0;
+      for (std::size_t shift = 0; ; shift += 7)
+      {
+        const std::uint8_t b = *_bytes++;
+        x |= (std::size_t) (b & 0x7f) << shift;
+        if (!(b & 0x80))
+          return x;
+      }
+    }
+
+    // Read zigzag-encoded difference and advance
+    std::int64_t read_delta()
+    {
+      const std::size_t z = read_varint();
+      return (std::int64_t) (z >> 1) ^ -((std::int64_t) (z & 1));
+    }
 
-    // Global number of connections for all entities (possibly not
-    // computed)
-    std::vector<unsigned int> _num_global_connections;
+    // Position in uncompressed or encoded storage
+    const unsigned int* _p;
+    const std::uint8_t* _bytes;
 
-    // Position of first connection for each entity (using local index)
-    std::vector<unsigned int> index_to_position;
+    // Number of remaining connections and current connection
+    std::size_t _remaining;
+    unsigned int _value;
 
   };
 
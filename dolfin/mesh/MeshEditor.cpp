@@ -20,6 +20,8 @@
 // First added:  2006-05-16
 // Last changed: 2014-02-06
 
+#include <algorithm>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/log/log.h>
 #include <dolfin/geometry/Point.h>
 #include "Mesh.h"
@@ -253,6 +255,30 @@ void MeshEditor::add_vertex_global(std::size_t local_index,
   _mesh->_topology.set_global_index(0, local_index, global_index);
 }
 //-----------------------------------------------------------------------------
+void MeshEditor::add_vertices(std::vector<double> x)
+{
+  std::vector<std::int64_t> global_indices(_num_vertices);
+  for (std::size_t i = 0; i < global_indices.size(); ++i)
+    global_indices[i] = i;
+  add_vertices_global(std::move(x), std::move(global_indices));
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::add_vertices_global(std::vector<double> x,
+                                     std::vector<std::int64_t> global_indices)
+{
+  // Check that no vertices have been added and that sizes match
+  add_vertices_common(x.size(), global_indices.size());
+
+  // Take over coordinates if the geometry holds only the vertices,
+  // otherwise copy them into the vertex block
+  std::vector<double>& coordinates = _mesh->_geometry.x();
+  if (coordinates.size() == x.size())
+    coordinates.swap(x);
+  else
+    std::copy(x.begin(), x.end(), coordinates.begin());
+  _mesh->_topology.set_global_indices(0, std::move(global_indices));
+}
+//-----------------------------------------------------------------------------
 void MeshEditor::add_entity_point(std::size_t entity_dim, std::size_t order,
                                   std::size_t index, const Point& p)
 {
@@ -292,6 +318,26 @@ void MeshEditor::add_cell(std::size_t c, std::size_t v0, std::size_t v1,
   add_cell(c, c, _vertices);
 }
 //-----------------------------------------------------------------------------
+void MeshEditor::add_cells(std::vector<unsigned int> cells)
+{
+  std::vector<std::int64_t> global_indices(_num_cells);
+  for (std::size_t i = 0; i < global_indices.size(); ++i)
+    global_indices[i] = i;
+  add_cells_global(std::move(cells), std::move(global_indices));
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::add_cells_global(std::vector<unsigned int> cells,
+                                  std::vector<std::int64_t> global_indices)
+{
+  // Check that no cells have been added and that sizes match
+  add_cells_common(cells, global_indices.size());
+
+  // Take over cell vertices and global indices
+  const std::size_t num_cell_vertices = _vertices.size();
+  _mesh->_topology(_tdim, 0).assign(std::move(cells), num_cell_vertices);
+  _mesh->_topology.set_global_indices(_tdim, std::move(global_indices));
+}
+//-----------------------------------------------------------------------------
 void MeshEditor::close(bool order)
 {
   // Order mesh if requested
@@ -299,8 +345,15 @@ void MeshEditor::close(bool order)
   if (order && !_mesh->ordered())
     _mesh->order();
 
+  // Precompute cell-to-point map of higher-order geometries for fast
+  // access to cell coordinate dofs
+  if (_mesh->geometry().degree() > 1)
+    _mesh->init_cell_points();
+
   // Clear data
   clear();
+
+  SubSystemsManager::mark_startup_phase("first mesh");
 }
 //-----------------------------------------------------------------------------
 void MeshEditor::add_vertex_common(std::size_t v, std::size_t gdim)
@@ -384,6 +437,83 @@ void MeshEditor::add_cell_common(std::size_t c, std::size_t tdim)
   next_cell++;
 }
 //-----------------------------------------------------------------------------
+void MeshEditor::add_vertices_common(std::size_t num_coordinates,
+                                     std::size_t num_global_indices)
+{
+  // Check if we are currently editing a mesh
+  if (!_mesh)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "add vertices to mesh using mesh editor",
+                 "No mesh opened, unable to edit");
+  }
+
+  // Check that vertices are added only once
+  if (next_vertex > 0)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "add vertices to mesh using mesh editor",
+                 "%d vertices already specified", next_vertex);
+  }
+
+  // Check sizes
+  if (num_coordinates != _num_vertices*_gdim
+      || num_global_indices != _num_vertices)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "add vertices to mesh using mesh editor",
+                 "Size of coordinate array (%d) or global indices (%d) does not match number of vertices (%d) and dimension (%d)",
+                 num_coordinates, num_global_indices, _num_vertices, _gdim);
+  }
+
+  next_vertex = _num_vertices;
+}
+//-----------------------------------------------------------------------------
+void MeshEditor::add_cells_common(const std::vector<unsigned int>& cells,
+                                  std::size_t num_global_indices)
+{
+  // Check if we are currently editing a mesh
+  if (!_mesh)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "add cells to mesh using mesh editor",
+                 "No mesh opened, unable to edit");
+  }
+
+  // Check that cells are added only once
+  if (next_cell > 0)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "add cells to mesh using mesh editor",
+                 "%d cells already specified", next_cell);
+  }
+
+  // Check sizes
+  if (cells.size() != _num_cells*_vertices.size()
+      || num_global_indices != _num_cells)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "add cells to mesh using mesh editor",
+                 "Size of cell array (%d) or global indices (%d) does not match number of cells (%d) and vertices per cell (%d)",
+                 cells.size(), num_global_indices, _num_cells,
+                 _vertices.size());
+  }
+
+  // Check vertices (single pass over the array)
+  unsigned int max_vertex = 0;
+  for (std::size_t i = 0; i < cells.size(); ++i)
+    max_vertex = std::max(max_vertex, cells[i]);
+  if (_num_vertices > 0 && !cells.empty() && max_vertex >= _num_vertices)
+  {
+    dolfin_error("MeshEditor.cpp",
+                 "add cells to mesh using mesh editor",
+                 "Vertex index (%d) out of range [0, %d)", max_vertex,
+                 _num_vertices);
+  }
+
+  next_cell = _num_cells;
+}
+//-----------------------------------------------------------------------------
 void MeshEditor::clear()
 {
   _tdim = 0;
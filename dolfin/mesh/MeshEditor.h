@@ -21,6 +21,7 @@
 #ifndef __MESH_EDITOR_H
 #define __MESH_EDITOR_H
 
+#include <cstdint>
 #include <vector>
 #include "CellType.h"
 #include "Mesh.h"
@@ -231,6 +232,31 @@ namespace dolfin
     void add_vertex_global(std::size_t local_index, std::size_t global_index,
                            const std::vector<double>& x);
 
+    /// Add all vertices at once from a contiguous array of
+    /// coordinates. This avoids the per-vertex overhead of
+    /// add_vertex() and takes over the array if it is passed as an
+    /// rvalue. The global vertex indices are the local indices.
+    ///
+    /// @param    x (std::vector<double>)
+    ///         The coordinates (num_vertices x gdim, row-major).
+    ///
+    /// @code{.cpp}
+    ///
+    ///         editor.init_vertices(num_vertices);
+    ///         editor.add_vertices(std::move(x));
+    /// @endcode
+    void add_vertices(std::vector<double> x);
+
+    /// Add all vertices at once from a contiguous array of
+    /// coordinates, with given global indices
+    ///
+    /// @param    x (std::vector<double>)
+    ///         The coordinates (num_vertices x gdim, row-major).
+    /// @param    global_indices (std::vector<std::int64_t>)
+    ///         The global vertex indices.
+    void add_vertices_global(std::vector<double> x,
+                             std::vector<std::int64_t> global_indices);
+
     /// Add a point in a given entity of dimension entity_dim
     void add_entity_point(std::size_t entity_dim, std::size_t order,
                           std::size_t index, const Point& p);
@@ -319,6 +345,27 @@ namespace dolfin
       _mesh->_topology.set_global_index(_tdim, local_index, global_index);
     }
 
+    /// Add all cells at once from a contiguous array of cell
+    /// vertices. This avoids the per-cell overhead of add_cell() and
+    /// takes over the array if it is passed as an rvalue. The global
+    /// cell indices are the local indices.
+    ///
+    /// @param    cells (std::vector<unsigned int>)
+    ///         The vertex indices (local indices) of all cells
+    ///         (num_cells x num_vertices_per_cell, row-major).
+    void add_cells(std::vector<unsigned int> cells);
+
+    /// Add all cells at once from a contiguous array of cell
+    /// vertices, with given global indices
+    ///
+    /// @param    cells (std::vector<unsigned int>)
+    ///         The vertex indices (local indices) of all cells
+    ///         (num_cells x num_vertices_per_cell, row-major).
+    /// @param    global_indices (std::vector<std::int64_t>)
+    ///         The global cell indices.
+    void add_cells_global(std::vector<unsigned int> cells,
+                          std::vector<std::int64_t> global_indices);
+
     /// Close mesh, finish editing, and order entities locally
     ///
     /// @param    order (bool)
@@ -344,6 +391,14 @@ namespace dolfin
     // Add cell, common part
     void add_cell_common(std::size_t v, std::size_t dim);
 
+    // Add all vertices, common part (checks)
+    void add_vertices_common(std::size_t num_coordinates,
+                             std::size_t num_global_indices);
+
+    // Add all cells, common part (checks)
+    void add_cells_common(const std::vector<unsigned int>& cells,
+                          std::size_t num_global_indices);
+
     // Compute boundary indicators (exterior facets)
     void compute_boundary_indicators();
 
@@ -0,0 +1,190 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+#include <boost/multi_array.hpp>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/log/log.h>
+#include "CellType.h"
+#include "Mesh.h"
+#include "MeshConnectivity.h"
+#include "MeshTopology.h"
+#include "MeshExteriorFacets.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Sorted vertex indices of a facet (unused entries are -1)
+  typedef std::array<std::int64_t, 4> FacetKey;
+}
+
+//-----------------------------------------------------------------------------
+MeshExteriorFacets::MeshExteriorFacets(const Mesh& mesh)
+  : _topology_state(mesh.topology().state())
+{
+  Timer timer("Compute exterior facets");
+
+  const std::size_t D = mesh.topology().dim();
+  dolfin_assert(D > 0);
+  const MeshTopology& topology = mesh.topology();
+  const CellType& cell_type = mesh.type();
+  const std::size_t num_cell_facets = cell_type.num_entities(D - 1);
+  const std::size_t num_facet_vertices = cell_type.num_vertices(D - 1);
+  dolfin_assert(num_facet_vertices <= 4);
+  const MeshConnectivity& cell_vertices = topology(D, 0);
+  const std::size_t num_cells = mesh.num_cells();
+
+  // Key of each facet of each cell, with the cell and local facet
+  // (as cell*num_cell_facets + local facet)
+  std::vector<std::pair<FacetKey, std::size_t>> keys;
+  keys.reserve(num_cells*num_cell_facets);
+  boost::multi_array<unsigned int, 2> facet_vertices;
+  FacetKey key;
+  key.fill(-1);
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    cell_type.create_entities(facet_vertices, D - 1, cell_vertices(c));
+    for (std::size_t i = 0; i < num_cell_facets; ++i)
+    {
+      std::copy(facet_vertices[i].begin(), facet_vertices[i].end(),
+                key.begin());
+      std::sort(key.begin(), key.begin() + num_facet_vertices);
+      keys.push_back(std::make_pair(key, c*num_cell_facets + i));
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // Facets of owned cells which appear only once are on the boundary
+  // of the local mesh
+  const std::size_t cell_ghost_offset = topology.ghost_offset(D);
+  std::vector<std::size_t> candidates;
+  std::vector<FacetKey> candidate_keys;
+  for (std::size_t i = 0; i < keys.size();)
+  {
+    std::size_t j = i + 1;
+    while (j < keys.size() && keys[j].first == keys[i].first)
+      ++j;
+    if (j == i + 1 && keys[i].second/num_cell_facets < cell_ghost_offset)
+    {
+      candidates.push_back(keys[i].second);
+      candidate_keys.push_back(keys[i].first);
+    }
+    i = j;
+  }
+  std::vector<bool> exterior(candidates.size(), true);
+
+  // Remove facets on process boundaries (without ghost cells, the
+  // cell on the other side is on another process)
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  if (MPI::size(mpi_comm) > 1 && mesh.ghost_mode() == "none")
+  {
+    const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices
+      = topology.shared_entities(0);
+    const std::vector<std::int64_t>& global_vertices
+      = topology.global_indices(0);
+
+    // Send global key of each candidate to the processes sharing all
+    // its vertices
+    std::map<int, std::vector<std::int64_t>> send_keys;
+    std::map<FacetKey, std::size_t> global_candidates;
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      std::set<unsigned int> procs;
+      bool shared = true;
+      for (std::size_t k = 0; k < num_facet_vertices && shared; ++k)
+      {
+        auto it = shared_vertices.find(candidate_keys[i][k]);
+        if (it == shared_vertices.end())
+          shared = false;
+        else if (k == 0)
+          procs = it->second;
+        else
+        {
+          std::set<unsigned int> common;
+          std::set_intersection(procs.begin(), procs.end(),
+                                it->second.begin(), it->second.end(),
+                                std::inserter(common, common.begin()));
+          procs.swap(common);
+        }
+        shared = shared && !procs.empty();
+      }
+      if (!shared)
+        continue;
+
+      FacetKey global_key;
+      global_key.fill(-1);
+      for (std::size_t k = 0; k < num_facet_vertices; ++k)
+        global_key[k] = global_vertices[candidate_keys[i][k]];
+      std::sort(global_key.begin(), global_key.begin() + num_facet_vertices);
+      global_candidates[global_key] = i;
+      for (auto p = procs.begin(); p != procs.end(); ++p)
+      {
+        std::vector<std::int64_t>& data = send_keys[*p];
+        data.insert(data.end(), global_key.begin(),
+                    global_key.begin() + num_facet_vertices);
+      }
+    }
+
+    // A facet whose key is received from another process is a local
+    // boundary facet there too, i.e. a facet on the process boundary
+    std::map<int, std::vector<std::int64_t>> recv_keys;
+    MPI::sparse_all_to_all(mpi_comm, send_keys, recv_keys);
+    for (auto r = recv_keys.begin(); r != recv_keys.end(); ++r)
+    {
+      const std::vector<std::int64_t>& data = r->second;
+      for (std::size_t k = 0; k < data.size(); k += num_facet_vertices)
+      {
+        FacetKey global_key;
+        global_key.fill(-1);
+        std::copy(data.begin() + k, data.begin() + k + num_facet_vertices,
+                  global_key.begin());
+        auto it = global_candidates.find(global_key);
+        if (it != global_candidates.end())
+          exterior[it->second] = false;
+      }
+    }
+  }
+
+  // Store exterior facets in cell order
+  std::vector<std::size_t> facets;
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+    if (exterior[i])
+      facets.push_back(candidates[i]);
+  std::sort(facets.begin(), facets.end());
+  _cells.resize(facets.size());
+  _local_facets.resize(facets.size());
+  for (std::size_t i = 0; i < facets.size(); ++i)
+  {
+    _cells[i] = facets[i]/num_cell_facets;
+    _local_facets[i] = facets[i] % num_cell_facets;
+  }
+}
+//-----------------------------------------------------------------------------
+std::size_t MeshExteriorFacets::memory_usage() const
+{
+  return sizeof(*this) + sizeof(unsigned int)*_cells.capacity()
+    + sizeof(std::uint8_t)*_local_facets.capacity();
+}
+//-----------------------------------------------------------------------------
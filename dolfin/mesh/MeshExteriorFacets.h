@@ -0,0 +1,87 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __MESH_EXTERIOR_FACETS_H
+#define __MESH_EXTERIOR_FACETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dolfin
+{
+
+  class Mesh;
+
+  /// This class stores the exterior facets of a mesh (the facets on
+  /// the global boundary of owned cells) as pairs of a cell and the
+  /// local index of the facet in the cell. It is computed from the
+  /// cell-vertex connectivity only, by matching the sorted vertices
+  /// of the facets of all cells, so that exterior facet assembly and
+  /// Dirichlet boundary conditions on the boundary do not need the
+  /// facets and facet-cell connectivity of the mesh, which are
+  /// expensive to compute and store for 3D meshes. It is created on
+  /// demand by Mesh::exterior_facets, which recomputes it when the
+  /// mesh topology changes.
+  ///
+  /// Facets on a process boundary are found by the exchange of the
+  /// vertex keys of local boundary facets whose vertices are all
+  /// shared with the same process (for meshes without ghost cells;
+  /// with ghost cells the neighbouring cells are local).
+
+  class MeshExteriorFacets
+  {
+  public:
+
+    /// Compute exterior facets of mesh (collective)
+    explicit MeshExteriorFacets(const Mesh& mesh);
+
+    /// Return the topology state of the mesh when the table was
+    /// computed (see MeshTopology::state)
+    std::size_t topology_state() const
+    { return _topology_state; }
+
+    /// Return number of exterior facets
+    std::size_t size() const
+    { return _cells.size(); }
+
+    /// Return the cell of each exterior facet
+    const std::vector<unsigned int>& cells() const
+    { return _cells; }
+
+    /// Return local index of each exterior facet in its cell
+    const std::vector<std::uint8_t>& local_facets() const
+    { return _local_facets; }
+
+    /// Return estimate of memory used in bytes
+    std::size_t memory_usage() const;
+
+  private:
+
+    // Topology state of mesh when table was computed
+    std::size_t _topology_state;
+
+    // Cells and local facet indices of exterior facets
+    std::vector<unsigned int> _cells;
+    std::vector<std::uint8_t> _local_facets;
+
+  };
+
+}
+
+#endif
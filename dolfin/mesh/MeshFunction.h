@@ -162,13 +162,25 @@ namespace dolfin
     ///         The size.
     std::size_t size() const;
 
+    /// Return state counter of values. The counter is increased
+    /// whenever the values are (or may be) changed, e.g. through the
+    /// non-const access operators, and can be used to detect
+    /// modified mesh functions.
+    ///
+    /// @return std::size_t
+    ///         The state counter.
+    std::size_t state() const
+    { return _state; }
+
     /// Return array of values (const. version)
     ///
     /// return T
     ///         The values.
     const T* values() const;
 
-    /// Return array of values
+    /// Return array of values. Since the values may be changed
+    /// through the returned pointer, this counts as a change of
+    /// state.
     ///
     /// return T
     ///         The values.
@@ -307,6 +319,9 @@ namespace dolfin
 
     // Number of mesh entities
     std::size_t _size;
+
+    // State counter, increased on any change of values
+    std::size_t _state;
   };
 
   template<> std::string MeshFunction<double>::str(bool verbose) const;
@@ -324,7 +339,8 @@ namespace dolfin
   template <typename T>
   MeshFunction<T>::MeshFunction(std::shared_ptr<const Mesh> mesh)
     : Variable("f", "unnamed MeshFunction"),
-      Hierarchical<MeshFunction<T>>(*this), _mesh(mesh), _dim(0), _size(0)
+      Hierarchical<MeshFunction<T>>(*this), _mesh(mesh), _dim(0), _size(0),
+      _state(0)
   {
     // Do nothing
   }
@@ -333,7 +349,8 @@ namespace dolfin
   MeshFunction<T>::MeshFunction(std::shared_ptr<const Mesh> mesh,
                                 std::size_t dim)
     : Variable("f", "unnamed MeshFunction"),
-      Hierarchical<MeshFunction<T>>(*this), _mesh(mesh), _dim(0), _size(0)
+      Hierarchical<MeshFunction<T>>(*this), _mesh(mesh), _dim(0), _size(0),
+      _state(0)
   {
     init(dim);
   }
@@ -351,7 +368,8 @@ namespace dolfin
     MeshFunction<T>::MeshFunction(std::shared_ptr<const Mesh> mesh,
                                   const std::string filename)
     : Variable("f", "unnamed MeshFunction"),
-    Hierarchical<MeshFunction<T>>(*this), _mesh(mesh), _dim(0), _size(0)
+    Hierarchical<MeshFunction<T>>(*this), _mesh(mesh), _dim(0), _size(0),
+    _state(0)
   {
     File file(mesh->mpi_comm(), filename);
     file >> *this;
@@ -371,7 +389,8 @@ namespace dolfin
   MeshFunction<T>::MeshFunction(std::shared_ptr<const Mesh> mesh,
                                 std::size_t dim, const MeshDomains& domains)
     : Variable("f", "unnamed MeshFunction"),
-      Hierarchical<MeshFunction<T>>(*this), _mesh(mesh), _dim(0), _size(0)
+      Hierarchical<MeshFunction<T>>(*this), _mesh(mesh), _dim(0), _size(0),
+      _state(0)
   {
     dolfin_assert(_mesh);
 
@@ -407,7 +426,7 @@ namespace dolfin
   template <typename T>
   MeshFunction<T>::MeshFunction(const MeshFunction<T>& f) :
     Variable("f", "unnamed MeshFunction"),
-    Hierarchical<MeshFunction<T>>(*this), _dim(0), _size(0)
+    Hierarchical<MeshFunction<T>>(*this), _dim(0), _size(0), _state(0)
   {
     *this = f;
   }
@@ -421,6 +440,7 @@ namespace dolfin
     _dim  = f._dim;
     _size = f._size;
     std::copy(f._values.get(), f._values.get() + _size, _values.get());
+    ++_state;
 
     Hierarchical<MeshFunction<T>>::operator=(f);
 
@@ -448,16 +468,17 @@ namespace dolfin
     set_all(std::numeric_limits<T>::max());
 
     // Iterate over all values
-    std::unordered_set<std::size_t> entities_values_set;
-    typename std::map<std::pair<std::size_t, std::size_t>, T>::const_iterator it;
-    const std::map<std::pair<std::size_t, std::size_t>, T>& values
-      = mesh_value_collection.values();
-    for (it = values.begin(); it != values.end(); ++it)
+    std::vector<bool> entity_is_set(_size, false);
+    std::size_t num_set = 0;
+    const std::vector<std::pair<std::size_t, std::size_t>>& entities
+      = mesh_value_collection.entities();
+    const std::vector<T>& values = mesh_value_collection.entity_values();
+    for (std::size_t i = 0; i < entities.size(); ++i)
     {
       // Get value collection entry data
-      const std::size_t cell_index = it->first.first;
-      const std::size_t local_entity = it->first.second;
-      const T value = it->second;
+      const std::size_t cell_index = entities[i].first;
+      const std::size_t local_entity = entities[i].second;
+      const T value = values[i];
 
       std::size_t entity_index = 0;
       if (d != D)
@@ -476,12 +497,16 @@ namespace dolfin
       dolfin_assert(entity_index < _size);
       _values[entity_index] = value;
 
-      // Add entity index to set (used to check that all values are set)
-      entities_values_set.insert(entity_index);
+      // Mark entity (used to check that all values are set)
+      if (!entity_is_set[entity_index])
+      {
+        entity_is_set[entity_index] = true;
+        ++num_set;
+      }
     }
 
     // Check that all values have been set, if not issue a debug message
-    if (entities_values_set.size() != _size)
+    if (num_set != _size)
       dolfin_debug("Mesh value collection does not contain all values for all entities");
 
     return *this;
@@ -521,6 +546,7 @@ namespace dolfin
   template <typename T>
     T* MeshFunction<T>::values()
   {
+    ++_state;
     return _values.get();
   }
   //---------------------------------------------------------------------------
@@ -531,6 +557,7 @@ namespace dolfin
     dolfin_assert(&entity.mesh() == _mesh.get());
     dolfin_assert(entity.dim() == _dim);
     dolfin_assert(entity.index() < _size);
+    ++_state;
     return _values[entity.index()];
   }
   //---------------------------------------------------------------------------
@@ -549,6 +576,7 @@ namespace dolfin
   {
     dolfin_assert(_values);
     dolfin_assert(index < _size);
+    ++_state;
     return _values[index];
   }
   //---------------------------------------------------------------------------
@@ -620,6 +648,7 @@ namespace dolfin
     _mesh = mesh;
     _dim = dim;
     _size = size;
+    ++_state;
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -628,6 +657,7 @@ namespace dolfin
     dolfin_assert(_values);
     dolfin_assert(index < _size);
     _values[index] = value;
+    ++_state;
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -636,6 +666,7 @@ namespace dolfin
     dolfin_assert(_values);
     dolfin_assert(_size == values.size());
     std::copy(values.begin(), values.end(), _values.get());
+    ++_state;
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -643,6 +674,7 @@ namespace dolfin
   {
     dolfin_assert(_values);
     std::fill(_values.get(), _values.get() + _size, value);
+    ++_state;
   }
   //---------------------------------------------------------------------------
   template <typename T>
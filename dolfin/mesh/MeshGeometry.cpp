@@ -22,6 +22,7 @@
 // Last changed: 2010-04-29
 
 #include <sstream>
+#include <utility>
 #include <boost/functional/hash.hpp>
 
 #include <dolfin/log/log.h>
@@ -30,12 +31,16 @@
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-MeshGeometry::MeshGeometry() : _dim(0), _degree(1)
+MeshGeometry::MeshGeometry() : _dim(0), _degree(1), _state(0),
+                               _num_cell_points(0), _cell_points_state(0)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
-MeshGeometry::MeshGeometry(const MeshGeometry& geometry) : _dim(0)
+MeshGeometry::MeshGeometry(const MeshGeometry& geometry) : _dim(0),
+                                                            _state(0),
+                                                            _num_cell_points(0),
+                                                            _cell_points_state(0)
 {
   *this = geometry;
 }
@@ -53,6 +58,10 @@ const MeshGeometry& MeshGeometry::operator= (const MeshGeometry& geometry)
   // Copy remaining data
   coordinates = geometry.coordinates;
   entity_offsets = geometry.entity_offsets;
+  _num_cell_points = geometry._num_cell_points;
+  _cell_points = geometry._cell_points;
+  _cell_points_state = geometry._cell_points_state;
+  ++_state;
 
   return *this;
 }
@@ -110,12 +119,28 @@ void MeshGeometry::init_entities(const std::vector<std::size_t>& num_entities)
     }
   }
   coordinates.resize(_dim*offset);
+
+  // Point numbering has changed, so cell-to-point map is invalid
+  _num_cell_points = 0;
+  _cell_points.clear();
 }
 //-----------------------------------------------------------------------------
 void MeshGeometry::set(std::size_t local_index,
                        const double* x)
 {
   std::copy(x, x +_dim, coordinates.begin() + local_index*_dim);
+  ++_state;
+}
+//-----------------------------------------------------------------------------
+void MeshGeometry::set_cell_points(std::size_t num_cell_points,
+                                   std::vector<unsigned int> cell_points,
+                                   std::size_t topology_state)
+{
+  dolfin_assert(num_cell_points > 0);
+  dolfin_assert(cell_points.size() % num_cell_points == 0);
+  _num_cell_points = num_cell_points;
+  _cell_points = std::move(cell_points);
+  _cell_points_state = topology_state;
 }
 //-----------------------------------------------------------------------------
 std::size_t MeshGeometry::hash() const
@@ -126,6 +151,15 @@ std::size_t MeshGeometry::hash() const
   return local_hash;
 }
 //-----------------------------------------------------------------------------
+std::size_t MeshGeometry::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this) + coordinates.capacity()*sizeof(double)
+    + _cell_points.capacity()*sizeof(unsigned int);
+  for (auto& offsets : entity_offsets)
+    bytes += offsets.capacity()*sizeof(std::size_t);
+  return bytes;
+}
+//-----------------------------------------------------------------------------
 std::string MeshGeometry::str(bool verbose) const
 {
   std::stringstream s;
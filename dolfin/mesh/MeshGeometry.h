@@ -110,9 +110,11 @@ namespace dolfin
       return &coordinates[n*_dim];
     }
 
-    /// Return array of values for all coordinates
+    /// Return array of values for all coordinates. Since the
+    /// coordinates may be changed through the returned reference,
+    /// this counts as a change of state.
     std::vector<double>& x()
-    { return coordinates; }
+    { ++_state; return coordinates; }
 
     /// Return array of values for all coordinates
     const std::vector<double>& x() const
@@ -163,6 +165,44 @@ namespace dolfin
     /// Set value of coordinate
     void set(std::size_t local_index, const double* x);
 
+    /// Return number of points (coordinate dofs) per cell in the
+    /// cell-to-point map, or zero if the map has not been initialised
+    /// (see Mesh::init_cell_points)
+    std::size_t num_cell_points() const
+    { return _num_cell_points; }
+
+    /// Return topology state of the mesh for which the cell-to-point
+    /// map was computed (see MeshTopology::state)
+    std::size_t cell_points_state() const
+    { return _cell_points_state; }
+
+    /// Return indices of the points of given cell, ordered as the
+    /// coordinate dofs of the cell
+    const unsigned int* cell_points(std::size_t cell) const
+    {
+      dolfin_assert((cell + 1)*_num_cell_points <= _cell_points.size());
+      return &_cell_points[cell*_num_cell_points];
+    }
+
+    /// Set cell-to-point map, stored as a contiguous array of size
+    /// num_cells*num_cell_points
+    void set_cell_points(std::size_t num_cell_points,
+                         std::vector<unsigned int> cell_points,
+                         std::size_t topology_state);
+
+    /// Copy coordinate dofs of given cell into array of length
+    /// num_cell_points()*dim() using the cell-to-point map
+    void get_coordinate_dofs(std::size_t cell, double* coordinate_dofs) const
+    {
+      const unsigned int* points = cell_points(cell);
+      for (std::size_t i = 0; i < _num_cell_points; ++i)
+      {
+        const double* x = &coordinates[points[i]*_dim];
+        for (std::size_t j = 0; j < _dim; ++j)
+          coordinate_dofs[i*_dim + j] = x[j];
+      }
+    }
+
     /// Hash of coordinate values
     ///
     /// *Returns*
@@ -171,6 +211,19 @@ namespace dolfin
     ///
     std::size_t hash() const;
 
+    /// Return state counter of coordinates. The counter is increased
+    /// whenever the coordinates are (or may be) changed, and can be
+    /// used to detect moved meshes.
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The state counter.
+    std::size_t state() const
+    { return _state; }
+
+    /// Return estimate of memory used on this process in bytes
+    std::size_t memory_usage() const;
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
@@ -188,6 +241,15 @@ namespace dolfin
     // Coordinates for all points stored as a contiguous array
     std::vector<double> coordinates;
 
+    // State counter, increased on any change of coordinates
+    std::size_t _state;
+
+    // Cell-to-point map (num_cells x _num_cell_points, row major) and
+    // topology state for which it was computed
+    std::size_t _num_cell_points;
+    std::vector<unsigned int> _cell_points;
+    std::size_t _cell_points_state;
+
   };
 
 }
@@ -0,0 +1,301 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+
+#include <dolfin/log/log.h>
+#include "Cell.h"
+#include "CellType.h"
+#include "Facet.h"
+#include "Mesh.h"
+#include "MeshConnectivity.h"
+#include "MeshGeometry.h"
+#include "MeshTopology.h"
+#include "MeshGeometryCache.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Determinant of n x n matrix (n <= 3), stored row-major
+  double determinant(const double* A, std::size_t n)
+  {
+    switch (n)
+    {
+    case 0:
+      return 1.0;
+    case 1:
+      return A[0];
+    case 2:
+      return A[0]*A[3] - A[1]*A[2];
+    case 3:
+      return A[0]*(A[4]*A[8] - A[5]*A[7])
+        - A[1]*(A[3]*A[8] - A[5]*A[6])
+        + A[2]*(A[3]*A[7] - A[4]*A[6]);
+    default:
+      dolfin_error("MeshGeometryCache.cpp",
+                   "compute determinant",
+                   "Matrix dimension (%d) out of range", n);
+    }
+    return 0.0;
+  }
+
+  // Compute Gram matrix G = E^T E of the m vectors E[j] (of length
+  // gdim, stored contiguously) and return sqrt(det(G))
+  double gram_root(const double* E, std::size_t m, std::size_t gdim,
+                   double* G)
+  {
+    for (std::size_t i = 0; i < m; ++i)
+    {
+      for (std::size_t j = 0; j < m; ++j)
+      {
+        double s = 0.0;
+        for (std::size_t k = 0; k < gdim; ++k)
+          s += E[i*gdim + k]*E[j*gdim + k];
+        G[i*m + j] = s;
+      }
+    }
+    return std::sqrt(std::max(determinant(G, m), 0.0));
+  }
+}
+
+//-----------------------------------------------------------------------------
+MeshGeometryCache::MeshGeometryCache(const Mesh& mesh)
+  : _geometry_state(mesh.geometry().state()),
+    _topology_state(mesh.topology().state())
+{
+  const std::size_t tdim = mesh.topology().dim();
+  if (tdim == 0)
+    return;
+
+  // Cell-facet and facet-cell connectivity are needed for facet
+  // quantities
+  mesh.init(tdim - 1, tdim);
+  mesh.init(tdim, tdim - 1);
+  _topology_state = mesh.topology().state();
+
+  const CellType::Type type = mesh.type().cell_type();
+  if (type == CellType::interval || type == CellType::triangle
+      || type == CellType::tetrahedron)
+  {
+    compute_simplex(mesh);
+  }
+  else
+    compute_general(mesh);
+}
+//-----------------------------------------------------------------------------
+std::size_t MeshGeometryCache::memory_usage() const
+{
+  return sizeof(*this)
+    + sizeof(double)*(_cell_volumes.capacity()
+                      + _cell_circumradii.capacity()
+                      + _cell_radius_ratios.capacity()
+                      + _jacobians.capacity()
+                      + _jacobian_determinants.capacity()
+                      + _facet_areas.capacity()
+                      + _facet_normals.capacity());
+}
+//-----------------------------------------------------------------------------
+void MeshGeometryCache::compute_simplex(const Mesh& mesh)
+{
+  const MeshTopology& topology = mesh.topology();
+  const std::size_t tdim = topology.dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_cells = topology.size(tdim);
+  const std::size_t num_facets = topology.size(tdim - 1);
+  const std::vector<double>& x = mesh.geometry().x();
+  const MeshConnectivity& cell_vertices = topology(tdim, 0);
+  const MeshConnectivity& cell_facets = topology(tdim, tdim - 1);
+  const MeshConnectivity& facet_vertices = topology(tdim - 1, 0);
+  const MeshConnectivity& facet_cells = topology(tdim - 1, tdim);
+
+  // Volumes of reference cell and reference facet (1/tdim! and
+  // 1/(tdim - 1)!)
+  double facet_factorial = 1.0;
+  for (std::size_t i = 2; i < tdim; ++i)
+    facet_factorial *= i;
+  const double factorial = facet_factorial*tdim;
+
+  // Work arrays: edge vectors (transposed Jacobian), Gram matrix,
+  // Cramer's rule matrix and circumcentre coefficients
+  std::vector<double> E(tdim*gdim), G(tdim*tdim), Gj(tdim*tdim), a(tdim);
+
+  // Facet areas and normals. A facet is a point for intervals.
+  _facet_areas.assign(num_facets, 1.0);
+  _facet_normals.resize(num_facets*gdim);
+  for (std::size_t f = 0; f < num_facets; ++f)
+  {
+    const unsigned int* fv = facet_vertices(f);
+    const double* x0 = &x[fv[0]*gdim];
+
+    // Gram-Schmidt orthonormalisation of facet edges
+    for (std::size_t j = 1; j < tdim; ++j)
+    {
+      double* e = &E[(j - 1)*gdim];
+      for (std::size_t k = 0; k < gdim; ++k)
+        e[k] = x[fv[j]*gdim + k] - x0[k];
+    }
+    if (tdim > 1)
+      _facet_areas[f] = gram_root(E.data(), tdim - 1, gdim, G.data())/facet_factorial;
+    for (std::size_t j = 0; j + 1 < tdim; ++j)
+    {
+      double* e = &E[j*gdim];
+      for (std::size_t i = 0; i < j; ++i)
+      {
+        const double* q = &E[i*gdim];
+        double s = 0.0;
+        for (std::size_t k = 0; k < gdim; ++k)
+          s += e[k]*q[k];
+        for (std::size_t k = 0; k < gdim; ++k)
+          e[k] -= s*q[k];
+      }
+      double norm = 0.0;
+      for (std::size_t k = 0; k < gdim; ++k)
+        norm += e[k]*e[k];
+      norm = std::sqrt(norm);
+      for (std::size_t k = 0; k < gdim; ++k)
+        e[k] /= norm;
+    }
+
+    // Vertex of the first attached cell opposite to the facet
+    const std::size_t c = facet_cells(f)[0];
+    const unsigned int* cv = cell_vertices(c);
+    std::size_t opposite = 0;
+    for (std::size_t i = 0; i <= tdim; ++i)
+    {
+      if (std::find(fv, fv + tdim, cv[i]) == fv + tdim)
+      {
+        opposite = cv[i];
+        break;
+      }
+    }
+
+    // Normal is the part of (facet vertex - opposite vertex)
+    // orthogonal to the facet
+    double* n = &_facet_normals[f*gdim];
+    for (std::size_t k = 0; k < gdim; ++k)
+      n[k] = x0[k] - x[opposite*gdim + k];
+    for (std::size_t j = 0; j + 1 < tdim; ++j)
+    {
+      const double* q = &E[j*gdim];
+      double s = 0.0;
+      for (std::size_t k = 0; k < gdim; ++k)
+        s += n[k]*q[k];
+      for (std::size_t k = 0; k < gdim; ++k)
+        n[k] -= s*q[k];
+    }
+    double norm = 0.0;
+    for (std::size_t k = 0; k < gdim; ++k)
+      norm += n[k]*n[k];
+    norm = std::sqrt(norm);
+    for (std::size_t k = 0; k < gdim; ++k)
+      n[k] /= norm;
+  }
+
+  // Cell Jacobians, volumes, circumradii and radius ratios
+  _jacobians.resize(num_cells*gdim*tdim);
+  _jacobian_determinants.resize(num_cells);
+  _cell_volumes.resize(num_cells);
+  _cell_circumradii.resize(num_cells);
+  _cell_radius_ratios.resize(num_cells);
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    const unsigned int* cv = cell_vertices(c);
+    const double* x0 = &x[cv[0]*gdim];
+
+    // Edge vectors from the first vertex, J_ij = E_ji
+    double* J = &_jacobians[c*gdim*tdim];
+    for (std::size_t j = 0; j < tdim; ++j)
+    {
+      for (std::size_t i = 0; i < gdim; ++i)
+      {
+        const double e = x[cv[j + 1]*gdim + i] - x0[i];
+        E[j*gdim + i] = e;
+        J[i*tdim + j] = e;
+      }
+    }
+
+    // Determinant (pseudo determinant for manifolds)
+    const double gram = gram_root(E.data(), tdim, gdim, G.data());
+    const double detJ = (gdim == tdim) ? determinant(J, tdim) : gram;
+    _jacobian_determinants[c] = detJ;
+    const double volume = gram/factorial;
+    _cell_volumes[c] = volume;
+
+    // Circumcentre x0 + E^T a solves 2 G a = diag(G), by Cramer's
+    // rule
+    if (gram == 0.0)
+    {
+      _cell_circumradii[c] = 0.0;
+      _cell_radius_ratios[c] = 0.0;
+      continue;
+    }
+    const double detG = gram*gram;
+    for (std::size_t j = 0; j < tdim; ++j)
+    {
+      Gj = G;
+      for (std::size_t i = 0; i < tdim; ++i)
+        Gj[i*tdim + j] = 0.5*G[i*tdim + i];
+      a[j] = determinant(Gj.data(), tdim)/detG;
+    }
+    double R2 = 0.0;
+    for (std::size_t k = 0; k < gdim; ++k)
+    {
+      double r = 0.0;
+      for (std::size_t j = 0; j < tdim; ++j)
+        r += a[j]*E[j*gdim + k];
+      R2 += r*r;
+    }
+    const double R = std::sqrt(R2);
+    _cell_circumradii[c] = R;
+
+    // Radius ratio tdim*r/R with inradius r = tdim*V/(facet area)
+    const unsigned int* cf = cell_facets(c);
+    double area = 0.0;
+    for (std::size_t i = 0; i <= tdim; ++i)
+      area += _facet_areas[cf[i]];
+    _cell_radius_ratios[c] = tdim*tdim*volume/(area*R);
+  }
+}
+//-----------------------------------------------------------------------------
+void MeshGeometryCache::compute_general(const Mesh& mesh)
+{
+  const MeshTopology& topology = mesh.topology();
+  const std::size_t tdim = topology.dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_cells = topology.size(tdim);
+  const std::size_t num_facets = topology.size(tdim - 1);
+
+  _cell_volumes.resize(num_cells);
+  for (std::size_t c = 0; c < num_cells; ++c)
+    _cell_volumes[c] = Cell(mesh, c).volume();
+
+  _facet_areas.resize(num_facets);
+  _facet_normals.resize(num_facets*gdim);
+  for (std::size_t f = 0; f < num_facets; ++f)
+  {
+    const Facet facet(mesh, f);
+    const Cell cell(mesh, facet.entities(tdim)[0]);
+    const std::size_t local_facet = cell.index(facet);
+    _facet_areas[f] = cell.facet_area(local_facet);
+    const Point n = cell.normal(local_facet);
+    for (std::size_t k = 0; k < gdim; ++k)
+      _facet_normals[f*gdim + k] = n[k];
+  }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,130 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __MESH_GEOMETRY_CACHE_H
+#define __MESH_GEOMETRY_CACHE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace dolfin
+{
+
+  class Mesh;
+
+  /// This class stores geometric quantities of all cells and facets
+  /// of a mesh (including ghosts) in contiguous arrays, computed in
+  /// one pass over the mesh connectivity and coordinates. It is
+  /// created on demand by Mesh::geometry_cache, which recomputes it
+  /// when the mesh coordinates change, so that repeated loops over
+  /// cell volumes, facet normals or Jacobians (mesh quality, error
+  /// indicators) do not recompute them entity by entity.
+  ///
+  /// Jacobians, their determinants and circumradii are only
+  /// available for simplex cells (affine geometry); the
+  /// corresponding arrays are empty for other cells.
+
+  class MeshGeometryCache
+  {
+  public:
+
+    /// Compute geometric quantities of mesh
+    explicit MeshGeometryCache(const Mesh& mesh);
+
+    /// Return the geometry state of the mesh when the cache was
+    /// computed (see MeshGeometry::state)
+    std::size_t geometry_state() const
+    { return _geometry_state; }
+
+    /// Return the topology state of the mesh when the cache was
+    /// computed (see MeshTopology::state)
+    std::size_t topology_state() const
+    { return _topology_state; }
+
+    /// Return the number of cells when the cache was computed
+    std::size_t num_cells() const
+    { return _cell_volumes.size(); }
+
+    /// Return volume of each cell
+    const std::vector<double>& cell_volumes() const
+    { return _cell_volumes; }
+
+    /// Return circumradius of each cell (simplices only)
+    const std::vector<double>& cell_circumradii() const
+    { return _cell_circumradii; }
+
+    /// Return topological dimension times the ratio of inradius to
+    /// circumradius of each cell (simplices only), see
+    /// Cell::radius_ratio
+    const std::vector<double>& cell_radius_ratios() const
+    { return _cell_radius_ratios; }
+
+    /// Return Jacobian of the affine map from the reference cell of
+    /// each cell (simplices only), stored row-major as gdim x tdim
+    /// values per cell
+    const std::vector<double>& jacobians() const
+    { return _jacobians; }
+
+    /// Return determinant of the Jacobian of each cell (simplices
+    /// only). For manifolds (gdim > tdim) this is the pseudo
+    /// determinant sqrt(det(J^T J)).
+    const std::vector<double>& jacobian_determinants() const
+    { return _jacobian_determinants; }
+
+    /// Return area of each facet
+    const std::vector<double>& facet_areas() const
+    { return _facet_areas; }
+
+    /// Return unit normal of each facet, pointing out of the first
+    /// cell attached to the facet (see Facet::normal), stored as gdim
+    /// values per facet
+    const std::vector<double>& facet_normals() const
+    { return _facet_normals; }
+
+    /// Return estimate of memory used in bytes
+    std::size_t memory_usage() const;
+
+  private:
+
+    // Compute quantities for simplex cells from coordinates
+    void compute_simplex(const Mesh& mesh);
+
+    // Compute quantities for other cells through the cell type
+    void compute_general(const Mesh& mesh);
+
+    // Geometry state of mesh when cache was computed
+    std::size_t _geometry_state;
+
+    // Topology state of mesh when cache was computed
+    std::size_t _topology_state;
+
+    // Cell quantities
+    std::vector<double> _cell_volumes;
+    std::vector<double> _cell_circumradii;
+    std::vector<double> _cell_radius_ratios;
+    std::vector<double> _jacobians;
+    std::vector<double> _jacobian_determinants;
+
+    // Facet quantities
+    std::vector<double> _facet_areas;
+    std::vector<double> _facet_normals;
+
+  };
+
+}
+
+#endif
@@ -67,14 +67,18 @@ MeshHierarchy::coarsen(const MeshFunction<bool>& coarsen_markers) const
   dolfin_assert(mesh);
 
   // Make sure there is a parent MeshHierarchy
-  dolfin_assert(_parent != NULL);
+  if (!_parent)
+  {
+    dolfin_error("MeshHierarchy.cpp",
+                 "coarsen MeshHierarchy",
+                 "Cannot coarsen the coarsest mesh of a hierarchy");
+  }
   std::shared_ptr<const Mesh> parent_mesh = _parent->_meshes.back();
   dolfin_assert(parent_mesh);
 
   // Make sure markers are on finest mesh
   dolfin_assert(coarsen_markers.mesh()->id() == mesh->id());
 
-  // FIXME: copy across boundaries in parallel
   std::set<std::size_t> coarsening_vertices;
   if (coarsen_markers.dim() == 0)
   {
@@ -97,6 +101,34 @@ MeshHierarchy::coarsen(const MeshFunction<bool>& coarsen_markers) const
     }
   }
 
+  // Make the set of coarsening vertices consistent across processes,
+  // by sending marked shared vertices to the sharing processes.
+  // Otherwise, a parent edge may be marked for refinement on one
+  // process and not on another, which would be resolved by the
+  // parallel refinement by keeping the edge refined.
+  const std::size_t mpi_size = MPI::size(mesh->mpi_comm());
+  if (mpi_size > 1)
+  {
+    const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices
+      = mesh->topology().shared_entities(0);
+    std::vector<std::vector<std::size_t>> send_vertices(mpi_size);
+    const std::vector<std::int64_t>& global_indices
+      = mesh->topology().global_indices(0);
+    for (auto const &sv : shared_vertices)
+    {
+      const std::size_t global_index = global_indices[sv.first];
+      if (coarsening_vertices.find(global_index) != coarsening_vertices.end())
+      {
+        for (auto const &p : sv.second)
+          send_vertices[p].push_back(global_index);
+      }
+    }
+
+    std::vector<std::size_t> recv_vertices;
+    MPI::all_to_all(mesh->mpi_comm(), send_vertices, recv_vertices);
+    coarsening_vertices.insert(recv_vertices.begin(), recv_vertices.end());
+  }
+
   // Set up refinement markers to re-refine the parent mesh
   EdgeFunction<bool> edge_markers(parent_mesh, false);
   const std::map<std::size_t, std::size_t>& edge_to_vertex
@@ -161,6 +193,31 @@ std::vector<std::size_t> MeshHierarchy::weight() const
   return cell_weights;
 }
 //-----------------------------------------------------------------------------
+std::shared_ptr<const std::vector<std::size_t>>
+MeshHierarchy::parent_cells(std::size_t i) const
+{
+  if (i == 0 or i >= size())
+  {
+    dolfin_error("MeshHierarchy.cpp",
+                 "get parent cells",
+                 "Level %d is not in range [1:%d]", i, size());
+  }
+
+  // Find hierarchy with Mesh i as finest mesh
+  const MeshHierarchy* hierarchy = this;
+  while (hierarchy->size() > i + 1)
+  {
+    dolfin_assert(hierarchy->_parent);
+    hierarchy = hierarchy->_parent.get();
+  }
+
+  dolfin_assert(hierarchy->_relation);
+  dolfin_assert(hierarchy->_relation->parent_cell);
+  dolfin_assert(hierarchy->_relation->parent_cell->size()
+                == _meshes[i]->num_cells());
+  return hierarchy->_relation->parent_cell;
+}
+//-----------------------------------------------------------------------------
 std::shared_ptr<Mesh> MeshHierarchy::rebalance() const
 {
   // Make a new MeshHierarchy, with the same meshes, but rebalanced across
@@ -169,59 +226,17 @@ std::shared_ptr<Mesh> MeshHierarchy::rebalance() const
   // FIXME: this needs to be extended to all meshes in the Hierarchy
   // and reconstruction of the MeshRelations between them... work in progress
 
-#ifndef HAS_SCOTCH
-  dolfin_error("MeshHierarchy.cpp",
-               "rebalance MeshHierarchy",
-               "Rebalancing requires SCOTCH library at present");
-#endif
-
   const Mesh& coarse_mesh = *coarsest();
   if (MPI::size(coarse_mesh.mpi_comm()) == 1)
     dolfin_error("MeshHierarchy.cpp",
                  "rebalance MeshHierarchy", "Not applicable in serial");
 
-  LocalMeshData local_mesh_data(coarse_mesh.mpi_comm());
-  local_mesh_data.topology.cell_weight = weight();
-
+  // Weight each coarse cell by its number of fine descendants (ghost
+  // cells, which are numbered last, are not repartitioned)
+  std::vector<std::size_t> cell_weight = weight();
   const std::size_t tdim = coarse_mesh.topology().dim();
-  local_mesh_data.topology.dim = tdim;
-  const std::size_t gdim = coarse_mesh.geometry().dim();
-  local_mesh_data.geometry.dim = gdim;
-  local_mesh_data.topology.num_vertices_per_cell = tdim + 1;
-
-  // Cells
-
-  local_mesh_data.topology.num_global_cells = coarse_mesh.size_global(tdim);
-  const std::size_t num_local_cells = coarse_mesh.size(tdim);
-  local_mesh_data.topology.global_cell_indices.resize(num_local_cells);
-  local_mesh_data.topology.cell_vertices.resize(boost::extents[num_local_cells][local_mesh_data.topology.num_vertices_per_cell]);
-
-  for (CellIterator c(coarse_mesh); !c.end(); ++c)
-  {
-    const std::size_t cell_index = c->index();
-    local_mesh_data.topology.global_cell_indices[cell_index] = c->global_index();
-    for (VertexIterator v(*c); !v.end(); ++v)
-      local_mesh_data.topology.cell_vertices[cell_index][v.pos()] = v->global_index();
-  }
-
-  // Vertices - must be reordered into global order
-
-  const std::size_t num_local_vertices = coarse_mesh.size(0);
-  local_mesh_data.geometry.num_global_vertices = coarse_mesh.size_global(0);
-  local_mesh_data.geometry.vertex_indices.resize(num_local_vertices);
-  for (VertexIterator v(coarse_mesh); !v.end(); ++v)
-    local_mesh_data.geometry.vertex_indices[v->index()] = v->global_index();
-  local_mesh_data.geometry.vertex_coordinates.resize(boost::extents[num_local_vertices][gdim]);
-
-  const std::vector<double> vertex_coords =
-    DistributedMeshTools::reorder_vertices_by_global_indices(coarse_mesh);
-  std::copy(vertex_coords.begin(), vertex_coords.end(),
-            local_mesh_data.geometry.vertex_coordinates.data());
-
-  std::shared_ptr<Mesh> mesh(new Mesh(coarse_mesh.mpi_comm()));
-  const std::string ghost_mode = dolfin::parameters["ghost_mode"];
-  MeshPartitioning::build_distributed_mesh(*mesh, local_mesh_data, ghost_mode);
+  cell_weight.resize(coarse_mesh.topology().ghost_offset(tdim));
 
-  return mesh;
+  return MeshPartitioning::repartition(coarse_mesh, cell_weight);
 }
 //-----------------------------------------------------------------------------
@@ -79,7 +79,12 @@ namespace dolfin
     std::shared_ptr<const MeshHierarchy> unrefine() const
     { return _parent; }
 
-    /// Coarsen finest mesh by one level, based on markers (level n->n)
+    /// Coarsen finest mesh by one level, based on markers (level
+    /// n->n). The refinement which created the finest mesh is undone
+    /// around the marked entities in a single pass, by refining the
+    /// parent mesh again without the edges whose new vertices are
+    /// marked. Works in parallel, and the new mesh is distributed with
+    /// the same ghost mode as in refinement.
     std::shared_ptr<const MeshHierarchy> coarsen
       (const MeshFunction<bool>& markers) const;
 
@@ -91,6 +96,11 @@ namespace dolfin
     /// Rebalance across processes
     std::shared_ptr<Mesh> rebalance() const;
 
+    /// Return the parent cell in Mesh i - 1 of each cell of Mesh i,
+    /// as recorded during refinement, for i in range [1:size()]
+    std::shared_ptr<const std::vector<std::size_t>>
+      parent_cells(std::size_t i) const;
+
   private:
 
     // Basic store of mesh pointers for easy access
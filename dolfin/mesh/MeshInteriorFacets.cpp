@@ -0,0 +1,103 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <dolfin/common/MPI.h>
+#include <dolfin/log/log.h>
+#include "CellType.h"
+#include "Mesh.h"
+#include "MeshConnectivity.h"
+#include "MeshTopology.h"
+#include "MeshInteriorFacets.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+MeshInteriorFacets::MeshInteriorFacets(const Mesh& mesh)
+  : _topology_state(mesh.topology().state())
+{
+  // Compute facets and facet - cell and cell - facet connectivity
+  const std::size_t D = mesh.topology().dim();
+  dolfin_assert(D > 0);
+  mesh.init(D - 1);
+  mesh.init(D - 1, D);
+  mesh.init(D, D - 1);
+
+  const MeshTopology& topology = mesh.topology();
+  const MeshConnectivity& facet_cells = topology(D - 1, D);
+  const MeshConnectivity& cell_facets = topology(D, D - 1);
+  const std::size_t cell_ghost_offset = topology.ghost_offset(D);
+  const std::vector<unsigned int>& cell_owner = topology.cell_owner();
+  const unsigned int my_mpi_rank = MPI::rank(mesh.mpi_comm());
+
+  // Collect interior facets which are not ghosts, with their cells
+  const std::size_t num_facets = mesh.num_entities(D - 1);
+  const std::size_t num_regular_facets = topology.ghost_offset(D - 1);
+  _positions.assign(num_facets, -1);
+  for (std::size_t f = 0; f < num_regular_facets; ++f)
+  {
+    if (facet_cells.size(f) != 2)
+      continue;
+
+    const unsigned int* cells = facet_cells(f);
+    _positions[f] = _facets.size();
+    _facets.push_back(f);
+    _cells.push_back(cells[0]);
+    _cells.push_back(cells[1]);
+
+    // Facets on the process boundary are assembled by the lowest
+    // rank
+    const bool ghost0 = cells[0] >= cell_ghost_offset;
+    const bool ghost1 = cells[1] >= cell_ghost_offset;
+    bool owned = true;
+    if (ghost0 != ghost1)
+    {
+      const unsigned int ghost_rank = ghost0
+        ? cell_owner[cells[0] - cell_ghost_offset]
+        : cell_owner[cells[1] - cell_ghost_offset];
+      dolfin_assert(ghost_rank != my_mpi_rank);
+      owned = (ghost_rank > my_mpi_rank);
+    }
+    _owned.push_back(owned);
+  }
+
+  // Find local index of each facet in its cells
+  _local_facets.assign(_cells.size(), 0);
+  const std::size_t num_cell_facets = mesh.type().num_entities(D - 1);
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    const unsigned int* facets = cell_facets(c);
+    for (std::size_t i = 0; i < num_cell_facets; ++i)
+    {
+      const int pos = _positions[facets[i]];
+      if (pos < 0)
+        continue;
+      const std::size_t k = (_cells[2*pos] == c) ? 0 : 1;
+      dolfin_assert(_cells[2*pos + k] == c);
+      _local_facets[2*pos + k] = i;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+std::size_t MeshInteriorFacets::memory_usage() const
+{
+  return sizeof(*this)
+    + sizeof(unsigned int)*(_facets.capacity() + _cells.capacity())
+    + sizeof(std::uint8_t)*(_local_facets.capacity() + _owned.capacity())
+    + sizeof(int)*_positions.capacity();
+}
+//-----------------------------------------------------------------------------
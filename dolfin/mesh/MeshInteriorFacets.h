@@ -0,0 +1,107 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __MESH_INTERIOR_FACETS_H
+#define __MESH_INTERIOR_FACETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dolfin
+{
+
+  class Mesh;
+
+  /// This class stores the interior facets of a mesh (excluding
+  /// ghost facets) with their two cells and local facet indices in
+  /// flat arrays, so that interior facet assembly can stream over
+  /// the facets without computing the cells of each facet, searching
+  /// for the local indices of the facet, or checking the ownership of
+  /// the cells. It is created on demand by Mesh::interior_facets,
+  /// which recomputes it when the mesh topology changes.
+  ///
+  /// The two cells of facet i are cells()[2*i] and cells()[2*i + 1]
+  /// (in the order of the facet-cell connectivity), with the local
+  /// index of the facet in each cell in local_facets(). A facet
+  /// tensor is added to the global tensor on this process only if
+  /// owned()[i] is nonzero: facets on a process boundary are added
+  /// by the lowest rank owning one of the cells.
+
+  class MeshInteriorFacets
+  {
+  public:
+
+    /// Compute interior facets of mesh
+    explicit MeshInteriorFacets(const Mesh& mesh);
+
+    /// Return the topology state of the mesh when the table was
+    /// computed (see MeshTopology::state)
+    std::size_t topology_state() const
+    { return _topology_state; }
+
+    /// Return number of interior facets
+    std::size_t size() const
+    { return _facets.size(); }
+
+    /// Return mesh index of each interior facet
+    const std::vector<unsigned int>& facets() const
+    { return _facets; }
+
+    /// Return the two cells of each interior facet
+    const std::vector<unsigned int>& cells() const
+    { return _cells; }
+
+    /// Return local index of each interior facet in its two cells
+    const std::vector<std::uint8_t>& local_facets() const
+    { return _local_facets; }
+
+    /// Return nonzero for the interior facets assembled by this
+    /// process
+    const std::vector<std::uint8_t>& owned() const
+    { return _owned; }
+
+    /// Return position of a mesh facet in the table, or -1 if the
+    /// facet is not an interior facet (or a ghost)
+    int position(std::size_t facet) const
+    { return _positions[facet]; }
+
+    /// Return estimate of memory used in bytes
+    std::size_t memory_usage() const;
+
+  private:
+
+    // Topology state of mesh when table was computed
+    std::size_t _topology_state;
+
+    // Interior facets, their cells and local facet indices
+    std::vector<unsigned int> _facets;
+    std::vector<unsigned int> _cells;
+    std::vector<std::uint8_t> _local_facets;
+
+    // Flags for facets assembled by this process
+    std::vector<std::uint8_t> _owned;
+
+    // Position of each mesh facet in the table (-1 if not included)
+    std::vector<int> _positions;
+
+  };
+
+}
+
+#endif
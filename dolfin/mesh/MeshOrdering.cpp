@@ -23,11 +23,36 @@
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/log/log.h>
 #include "Cell.h"
+#include "CellTraits.h"
 #include "Mesh.h"
 #include "MeshOrdering.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Check that the vertices of all cells of type T are in ascending
+  // order of global index
+  template<CellType::Type T>
+  bool cell_vertices_ordered(const Mesh& mesh,
+                             const std::vector<std::int64_t>& global_indices)
+  {
+    const std::size_t tdim = mesh.topology().dim();
+    const MeshConnectivity& cv = mesh.topology()(tdim, 0);
+    const std::size_t num_cells = mesh.topology().size(tdim);
+    for (std::size_t c = 0; c < num_cells; ++c)
+    {
+      const unsigned int* v = cv(c);
+      for (std::size_t i = 1; i < CellTraits<T>::num_vertices; ++i)
+      {
+        if (global_indices[v[i - 1]] >= global_indices[v[i]])
+          return false;
+      }
+    }
+    return true;
+  }
+}
+
 //-----------------------------------------------------------------------------
 void MeshOrdering::order(Mesh& mesh)
 {
@@ -46,6 +71,13 @@ void MeshOrdering::order(Mesh& mesh)
   if (mesh.topology().dim() == 0)
     return;
 
+  // Entities are reordered in place, so connectivity data must not be
+  // shared with copies of the mesh
+  const std::size_t D = mesh.topology().dim();
+  for (std::size_t d0 = 0; d0 <= D; ++d0)
+    for (std::size_t d1 = 0; d1 <= D; ++d1)
+      mesh.topology()(d0, d1).detach();
+
   // Iterate over all cells and order the mesh entities locally
   for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
     cell->order(local_to_global_vertex_indices);
@@ -62,6 +94,38 @@ bool MeshOrdering::ordered(const Mesh& mesh)
   const auto& local_to_global_vertex_indices
     = mesh.topology().global_indices(0);
 
+  // When no entities of positive dimension and codimension exist,
+  // only the cell vertices need to be checked, which is done in a
+  // loop specialised for the cell type
+  const MeshTopology& topology = mesh.topology();
+  const std::size_t D = topology.dim();
+  bool have_entities = false;
+  for (std::size_t d = 1; d + 1 < D; ++d)
+    have_entities = have_entities || !topology(d, 0).empty();
+  if (!have_entities)
+  {
+    switch (mesh.type().cell_type())
+    {
+    case CellType::interval:
+      return cell_vertices_ordered<CellType::interval>(
+        mesh, local_to_global_vertex_indices);
+    case CellType::triangle:
+      return cell_vertices_ordered<CellType::triangle>(
+        mesh, local_to_global_vertex_indices);
+    case CellType::quadrilateral:
+      return cell_vertices_ordered<CellType::quadrilateral>(
+        mesh, local_to_global_vertex_indices);
+    case CellType::tetrahedron:
+      return cell_vertices_ordered<CellType::tetrahedron>(
+        mesh, local_to_global_vertex_indices);
+    case CellType::hexahedron:
+      return cell_vertices_ordered<CellType::hexahedron>(
+        mesh, local_to_global_vertex_indices);
+    default:
+      break;
+    }
+  }
+
   // Check if all cells are ordered
   for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
   {
@@ -23,7 +23,9 @@
 //
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -32,9 +34,12 @@
 #include <boost/multi_array.hpp>
 
 #include <dolfin/log/log.h>
+#include <dolfin/common/MonotonicArena.h>
 #include <dolfin/common/MPI.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/geometry/Point.h>
+#include <dolfin/graph/GeometricPartitioner.h>
 #include <dolfin/graph/GraphBuilder.h>
 #include <dolfin/graph/ParMETIS.h>
 #include <dolfin/graph/SCOTCH.h>
@@ -117,7 +122,8 @@ void MeshPartitioning::build_distributed_mesh(Mesh& mesh,
   Timer timer("Build distributed mesh from local mesh data");
 
   // Store used ghost mode
-  // NOTE: This is the only place in DOLFIN which eventually sets
+  // NOTE: This and the overload taking a given partition are the
+  //       only places in DOLFIN which eventually set
   //       mesh._ghost_mode != "none"
   mesh._ghost_mode = ghost_mode;
 
@@ -164,6 +170,309 @@ void MeshPartitioning::build_distributed_mesh(Mesh& mesh,
   // boundary and facets on a partition boundary (see
   // https://bugs.launchpad.net/dolfin/+bug/733834).
   DistributedMeshTools::init_facet_cell_connections(mesh);
+
+  SubSystemsManager::mark_startup_phase("first distributed mesh");
+}
+//-----------------------------------------------------------------------------
+void MeshPartitioning::build_distributed_mesh(Mesh& mesh,
+                  const LocalMeshData& local_data,
+                  const std::vector<int>& cell_partition,
+                  const std::map<std::int64_t, std::vector<int>>& ghost_procs,
+                  const std::string ghost_mode)
+{
+  log(PROGRESS, "Building distributed mesh from given partition");
+
+  Timer timer("Build distributed mesh from local mesh data");
+
+  dolfin_assert(cell_partition.size()
+                == local_data.topology.global_cell_indices.size());
+
+  // Store used ghost mode
+  mesh._ghost_mode = ghost_mode;
+
+  // Build mesh from local mesh data and provided cell partition
+  build(mesh, local_data, cell_partition, ghost_procs, ghost_mode);
+
+  // Create MeshDomains from local_data
+  build_mesh_domains(mesh, local_data);
+
+  // Initialise number of globally connected cells to each facet
+  DistributedMeshTools::init_facet_cell_connections(mesh);
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<Mesh>
+MeshPartitioning::repartition(const Mesh& mesh,
+                              const std::vector<std::size_t>& cell_weight,
+                              std::size_t num_cell_weights)
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  if (MPI::size(mpi_comm) == 1)
+    return std::make_shared<Mesh>(mesh);
+
+  const std::size_t tdim = mesh.topology().dim();
+
+  // Only local (non-ghost) cells are repartitioned
+  const std::size_t num_local_cells = mesh.topology().ghost_offset(tdim);
+  if (!cell_weight.empty()
+      && cell_weight.size() != num_cell_weights*num_local_cells)
+  {
+    dolfin_error("MeshPartitioning.cpp",
+                 "repartition mesh",
+                 "Number of cell weights (%d) does not match number of local cells (%d) times number of constraints (%d)",
+                 cell_weight.size(), num_local_cells, num_cell_weights);
+  }
+
+  LocalMeshData local_mesh_data(mpi_comm);
+  extract_local_mesh_data(mesh, local_mesh_data);
+  local_mesh_data.topology.cell_weight = cell_weight;
+  local_mesh_data.topology.num_cell_weights = num_cell_weights;
+
+  std::shared_ptr<Mesh> new_mesh(new Mesh(mpi_comm));
+  build_distributed_mesh(*new_mesh, local_mesh_data, mesh.ghost_mode());
+
+  return new_mesh;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<Mesh>
+MeshPartitioning::redistribute(const Mesh& mesh,
+                               const std::vector<int>& cell_partition)
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  if (MPI::size(mpi_comm) == 1)
+    return std::make_shared<Mesh>(mesh);
+
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_local_cells = mesh.topology().ghost_offset(tdim);
+  if (cell_partition.size() != num_local_cells)
+  {
+    dolfin_error("MeshPartitioning.cpp",
+                 "redistribute mesh",
+                 "Number of cell destinations (%d) does not match number of local cells (%d)",
+                 cell_partition.size(), num_local_cells);
+  }
+  const int mpi_size = MPI::size(mpi_comm);
+  for (auto p : cell_partition)
+  {
+    if (p < 0 or p >= mpi_size)
+    {
+      dolfin_error("MeshPartitioning.cpp",
+                   "redistribute mesh",
+                   "Cell destination %d is not a valid process", p);
+    }
+  }
+
+  LocalMeshData local_mesh_data(mpi_comm);
+  extract_local_mesh_data(mesh, local_mesh_data);
+
+  // Ghost cells are the facet neighbours of cells sent to other
+  // processes
+  std::map<std::int64_t, std::vector<int>> ghost_procs;
+  const std::string ghost_mode = mesh.ghost_mode();
+  if (ghost_mode != "none")
+    compute_ghost_procs(mesh, cell_partition, ghost_procs);
+
+  std::shared_ptr<Mesh> new_mesh(new Mesh(mpi_comm));
+  build_distributed_mesh(*new_mesh, local_mesh_data, cell_partition,
+                         ghost_procs, ghost_mode);
+
+  return new_mesh;
+}
+//-----------------------------------------------------------------------------
+void MeshPartitioning::extract_local_mesh_data(const Mesh& mesh,
+                                               LocalMeshData& local_mesh_data)
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_local_cells = mesh.topology().ghost_offset(tdim);
+
+  local_mesh_data.topology.dim = tdim;
+  local_mesh_data.topology.cell_type = mesh.type().cell_type();
+  local_mesh_data.topology.num_vertices_per_cell
+    = mesh.type().num_vertices(tdim);
+  local_mesh_data.geometry.dim = gdim;
+
+  // Cells
+  local_mesh_data.topology.num_global_cells = mesh.size_global(tdim);
+  local_mesh_data.topology.global_cell_indices.resize(num_local_cells);
+  local_mesh_data.topology.cell_vertices.resize(boost::extents[num_local_cells][local_mesh_data.topology.num_vertices_per_cell]);
+  for (CellIterator c(mesh); !c.end(); ++c)
+  {
+    const std::size_t cell_index = c->index();
+    local_mesh_data.topology.global_cell_indices[cell_index] = c->global_index();
+    for (VertexIterator v(*c); !v.end(); ++v)
+      local_mesh_data.topology.cell_vertices[cell_index][v.pos()] = v->global_index();
+  }
+
+  // Vertices, in contiguous blocks of the global numbering
+  const std::vector<double> vertex_coords
+    = DistributedMeshTools::reorder_vertices_by_global_indices(mesh);
+  const std::size_t num_local_vertices = vertex_coords.size()/gdim;
+  const std::size_t vertex_offset
+    = MPI::global_offset(mpi_comm, num_local_vertices, true);
+  local_mesh_data.geometry.num_global_vertices = mesh.size_global(0);
+  local_mesh_data.geometry.vertex_indices.resize(num_local_vertices);
+  for (std::size_t i = 0; i < num_local_vertices; ++i)
+    local_mesh_data.geometry.vertex_indices[i] = vertex_offset + i;
+  local_mesh_data.geometry.vertex_coordinates.resize(boost::extents[num_local_vertices][gdim]);
+  std::copy(vertex_coords.begin(), vertex_coords.end(),
+            local_mesh_data.geometry.vertex_coordinates.data());
+}
+//-----------------------------------------------------------------------------
+void MeshPartitioning::compute_ghost_procs(const Mesh& mesh,
+                            const std::vector<int>& cell_partition,
+                            std::map<std::int64_t, std::vector<int>>& ghost_procs)
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_local_cells = mesh.topology().ghost_offset(tdim);
+
+  // Facets with their global indices and sharing processes
+  mesh.init(tdim - 1);
+  mesh.init(tdim - 1, tdim);
+  DistributedMeshTools::number_entities(mesh, tdim - 1);
+
+  // Send the destinations of the local cells adjacent to each shared
+  // facet to the sharing processes
+  std::map<int, std::vector<std::int64_t>> send_dest;
+  std::map<std::int64_t, std::size_t> global_to_local_facet;
+  if (mesh.topology().have_shared_entities(tdim - 1))
+  {
+    const std::map<std::int32_t, std::set<unsigned int>>& shared_facets
+      = mesh.topology().shared_entities(tdim - 1);
+    for (auto shared = shared_facets.begin(); shared != shared_facets.end();
+         ++shared)
+    {
+      const Facet facet(mesh, shared->first);
+      global_to_local_facet[facet.global_index()] = shared->first;
+      for (std::size_t i = 0; i < facet.num_entities(tdim); ++i)
+      {
+        const std::size_t c = facet.entities(tdim)[i];
+        if (c >= num_local_cells)
+          continue;
+        for (auto p : shared->second)
+        {
+          send_dest[p].push_back(facet.global_index());
+          send_dest[p].push_back(cell_partition[c]);
+        }
+      }
+    }
+  }
+  std::map<int, std::vector<std::int64_t>> recv_dest;
+  MPI::sparse_all_to_all(mpi_comm, send_dest, recv_dest);
+
+  // Destinations of cells on other processes, by local facet
+  std::map<std::size_t, std::vector<int>> remote_dest;
+  for (auto& r : recv_dest)
+  {
+    for (std::size_t j = 0; j < r.second.size(); j += 2)
+    {
+      const auto local = global_to_local_facet.find(r.second[j]);
+      dolfin_assert(local != global_to_local_facet.end());
+      remote_dest[local->second].push_back(r.second[j + 1]);
+    }
+  }
+
+  // A cell is ghosted on the destinations of its facet neighbours
+  std::set<int> procs;
+  for (CellIterator c(mesh); !c.end(); ++c)
+  {
+    const std::size_t cell_index = c->index();
+    procs.clear();
+    for (FacetIterator f(*c); !f.end(); ++f)
+    {
+      for (std::size_t i = 0; i < f->num_entities(tdim); ++i)
+      {
+        const std::size_t c1 = f->entities(tdim)[i];
+        if (c1 != cell_index and c1 < num_local_cells)
+          procs.insert(cell_partition[c1]);
+      }
+      const auto remote = remote_dest.find(f->index());
+      if (remote != remote_dest.end())
+        procs.insert(remote->second.begin(), remote->second.end());
+    }
+    procs.erase(cell_partition[cell_index]);
+
+    if (!procs.empty())
+    {
+      std::vector<int>& cell_procs = ghost_procs[cell_index];
+      cell_procs.push_back(cell_partition[cell_index]);
+      cell_procs.insert(cell_procs.end(), procs.begin(), procs.end());
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<Mesh> MeshPartitioning::repartition(
+  const std::vector<std::shared_ptr<const MeshFunction<double>>>& cell_weights)
+{
+  if (cell_weights.empty())
+  {
+    dolfin_error("MeshPartitioning.cpp",
+                 "repartition mesh",
+                 "No cell weights given");
+  }
+
+  dolfin_assert(cell_weights[0]);
+  const Mesh& mesh = *cell_weights[0]->mesh();
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t num_local_cells = mesh.topology().ghost_offset(tdim);
+  const std::size_t num_cell_weights = cell_weights.size();
+
+  // Resolution of integer weights for the partitioners
+  const double max_integer_weight = 100.0;
+
+  std::vector<std::size_t> cell_weight(num_cell_weights*num_local_cells);
+  for (std::size_t k = 0; k < num_cell_weights; ++k)
+  {
+    dolfin_assert(cell_weights[k]);
+    const MeshFunction<double>& weight = *cell_weights[k];
+    if (weight.mesh()->id() != mesh.id() || weight.dim() != tdim)
+    {
+      dolfin_error("MeshPartitioning.cpp",
+                   "repartition mesh",
+                   "Cell weights must be cell functions on the same mesh");
+    }
+
+    double max_weight = 0.0;
+    for (std::size_t i = 0; i < num_local_cells; ++i)
+    {
+      if (weight[i] < 0.0)
+      {
+        dolfin_error("MeshPartitioning.cpp",
+                     "repartition mesh",
+                     "Cell weights must be non-negative");
+      }
+      max_weight = std::max(max_weight, weight[i]);
+    }
+    max_weight = MPI::max(mesh.mpi_comm(), max_weight);
+
+    // Constraint with only zero weights: weight all cells equally
+    const double scale
+      = max_weight > 0.0 ? max_integer_weight/max_weight : 0.0;
+    for (std::size_t i = 0; i < num_local_cells; ++i)
+    {
+      cell_weight[i*num_cell_weights + k]
+        = (scale > 0.0) ? (std::size_t) std::round(scale*weight[i]) : 1;
+    }
+  }
+
+  return repartition(mesh, cell_weight, num_cell_weights);
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t>
+MeshPartitioning::combined_cell_weight(const LocalMeshData& mesh_data)
+{
+  const std::vector<std::size_t>& cell_weight = mesh_data.topology.cell_weight;
+  const std::size_t num_cell_weights = mesh_data.topology.num_cell_weights;
+  if (num_cell_weights < 2)
+    return cell_weight;
+
+  dolfin_assert(cell_weight.size() % num_cell_weights == 0);
+  std::vector<std::size_t> combined_weight(cell_weight.size()/num_cell_weights, 0);
+  for (std::size_t i = 0; i < cell_weight.size(); ++i)
+    combined_weight[i/num_cell_weights] += cell_weight[i];
+
+  return combined_weight;
 }
 //-----------------------------------------------------------------------------
 void
@@ -185,19 +494,57 @@ MeshPartitioning::partition_cells(const MPI_Comm& mpi_comm,
   // Compute cell partition using partitioner from parameter system
   if (partitioner == "SCOTCH")
   {
+    const std::string approach = parameters["partitioning_approach"];
+    if (approach != "PARTITION")
+    {
+      warning("Partitioning approach \"%s\" is not supported by SCOTCH, using \"PARTITION\".",
+              approach.c_str());
+    }
+
+    // SCOTCH balances a single weight per cell, so multiple
+    // constraints are combined into their sum
+    if (mesh_data.topology.num_cell_weights > 1)
+    {
+      warning("SCOTCH does not support multi-constraint partitioning, balancing the sum of the %d cell weights.",
+              mesh_data.topology.num_cell_weights);
+    }
+
     SCOTCH::compute_partition(mpi_comm, cell_partition, ghost_procs,
                               mesh_data.topology.cell_vertices,
-                              mesh_data.topology.cell_weight,
+                              combined_cell_weight(mesh_data),
                               mesh_data.geometry.num_global_vertices,
                               mesh_data.topology.num_global_cells,
                               *cell_type);
   }
   else if (partitioner == "ParMETIS")
   {
+    // Select ParMETIS mode from partitioning approach. With
+    // "REPARTITION", the current distribution of cells is taken as
+    // the starting point and only the cells needed to restore the
+    // balance are migrated.
+    const std::string approach = parameters["partitioning_approach"];
+    std::string mode = "partition";
+    if (approach == "REPARTITION")
+      mode = "adaptive_repartition";
+    else if (approach == "REFINE")
+      mode = "refine";
+
     ParMETIS::compute_partition(mpi_comm, cell_partition, ghost_procs,
                                 mesh_data.topology.cell_vertices,
+                                mesh_data.topology.cell_weight,
+                                mesh_data.topology.num_cell_weights,
                                 mesh_data.geometry.num_global_vertices,
-                                *cell_type);
+                                *cell_type, mode);
+  }
+  else if (partitioner == "RCB" || partitioner == "SFC")
+  {
+    // Geometric partitioners balance the sum of the cell weights and
+    // do not compute ghost cell information
+    GeometricPartitioner::compute_partition(mpi_comm, cell_partition,
+                                            mesh_data.topology.cell_vertices,
+                                            combined_cell_weight(mesh_data),
+                                            mesh_data.geometry.vertex_coordinates,
+                                            partitioner);
   }
   else
   {
@@ -263,6 +610,29 @@ void MeshPartitioning::build(Mesh& mesh, const LocalMeshData& mesh_data,
     shared_cells.clear();
   }
 
+  // Add further layers of ghost cells, each connected to the previous
+  // layer in the same way (by vertex or by facet)
+  const int num_ghost_layers = parameters["ghost_layers"];
+  if (ghost_mode != "none" and num_ghost_layers > 1)
+  {
+    std::unique_ptr<CellType>
+      cell_type(CellType::create(mesh_data.topology.cell_type));
+    dolfin_assert(cell_type);
+    const int num_connecting_vertices = (ghost_mode == "shared_facet")
+      ? cell_type->num_vertices(tdim - 1) : 1;
+
+    int layer_begin = num_regular_cells;
+    for (int layer = 1; layer < num_ghost_layers; ++layer)
+    {
+      const int layer_end = new_cell_vertices.shape()[0];
+      distribute_ghost_layer(mesh.mpi_comm(), num_regular_cells, layer_begin,
+                             num_connecting_vertices, shared_cells,
+                             new_cell_vertices, new_global_cell_indices,
+                             new_cell_partition);
+      layer_begin = layer_end;
+    }
+  }
+
   #ifdef HAS_SCOTCH
   if (parameters["reorder_cells_gps"])
   {
@@ -511,16 +881,24 @@ void MeshPartitioning::distribute_cell_layer(MPI_Comm mpi_comm,
   const int mpi_size = MPI::size(mpi_comm);
   const int mpi_rank = MPI::rank(mpi_comm);
 
+  // Temporary maps are allocated from an arena and freed on return
+  MonotonicArena arena;
+  typedef std::vector<std::int64_t, ArenaAllocator<std::int64_t>> CellList;
+
   // Get set of vertices in ghost cells
-  std::map<std::int64_t, std::vector<std::int64_t>> sh_vert_to_cell;
+  std::map<std::int64_t, CellList, std::less<std::int64_t>,
+           ArenaAllocator<std::pair<const std::int64_t, CellList>>>
+    sh_vert_to_cell(arena);
 
   // Make global-to-local map of shared cells
-  std::map<std::int64_t, int> cell_global_to_local;
+  std::map<std::int64_t, int, std::less<std::int64_t>,
+           ArenaAllocator<std::pair<const std::int64_t, int>>>
+    cell_global_to_local(arena);
   for (int i = num_regular_cells; i < (int) cell_vertices.size(); ++i)
   {
     // Add map entry for each vertex
     for(auto p = cell_vertices[i].begin(); p != cell_vertices[i].end(); ++p)
-      sh_vert_to_cell.insert({*p, std::vector<std::int64_t>()});
+      sh_vert_to_cell.insert({*p, CellList(arena)});
 
     cell_global_to_local.insert({global_cell_indices[i], i});
   }
@@ -583,16 +961,13 @@ void MeshPartitioning::distribute_cell_layer(MPI_Comm mpi_comm,
     for (auto q = recv_i.begin(); q != recv_i.end(); q += num_cell_vertices + 1)
     {
       const std::size_t vertex_index = *(q + 1);
-      std::vector<std::int64_t> cell_set = {i};
-      cell_set.insert(cell_set.end(), q, q + num_cell_vertices + 1);
 
       // Packing: [owner, cell_index, this_vertex, [other_vertices]]
       // Look for vertex in map, and add the attached cell
-      auto it = sh_vert_to_cell.find(vertex_index);
-      if (it == sh_vert_to_cell.end())
-        sh_vert_to_cell.insert({vertex_index, cell_set});
-      else
-        it->second.insert(it->second.end(), cell_set.begin(), cell_set.end());
+      CellList& cell_set
+        = sh_vert_to_cell.insert({vertex_index, CellList(arena)}).first->second;
+      cell_set.push_back(i);
+      cell_set.insert(cell_set.end(), q, q + num_cell_vertices + 1);
     }
   }
 
@@ -696,6 +1071,182 @@ void MeshPartitioning::distribute_cell_layer(MPI_Comm mpi_comm,
   cell_partition.shrink_to_fit();
 }
 //-----------------------------------------------------------------------------
+void MeshPartitioning::distribute_ghost_layer(MPI_Comm mpi_comm,
+  const int num_regular_cells,
+  const int layer_begin,
+  const int num_connecting_vertices,
+  std::map<std::int32_t, std::set<unsigned int>>& shared_cells,
+  boost::multi_array<std::int64_t, 2>& cell_vertices,
+  std::vector<std::int64_t>& global_cell_indices,
+  std::vector<int>& cell_partition)
+{
+  Timer timer("Distribute ghost layer");
+
+  const int mpi_size = MPI::size(mpi_comm);
+  const unsigned int mpi_rank = MPI::rank(mpi_comm);
+  const int num_cells = cell_vertices.shape()[0];
+  const int num_cell_vertices = cell_vertices.shape()[1];
+
+  // Global-to-local map for all cells currently on this process
+  std::map<std::int64_t, int> cell_global_to_local;
+  for (int i = 0; i < num_cells; ++i)
+    cell_global_to_local.insert({global_cell_indices[i], i});
+
+  // Ask the owner of each cell in the outermost ghost layer for its
+  // neighbours. The owner holds at least one layer of ghosts around
+  // its regular cells, so knows all of them.
+  std::vector<std::vector<std::int64_t>> send_buffer(mpi_size);
+  std::vector<std::vector<std::int64_t>> recv_buffer(mpi_size);
+  for (int i = layer_begin; i < num_cells; ++i)
+    send_buffer[cell_partition[i]].push_back(global_cell_indices[i]);
+  MPI::all_to_all(mpi_comm, send_buffer, recv_buffer);
+
+  // Map from vertex to attached local cells, restricted to vertices of
+  // the requested cells
+  std::map<std::int64_t, std::vector<int>> vertex_to_cells;
+  for (int p = 0; p < mpi_size; ++p)
+  {
+    for (auto q = recv_buffer[p].begin(); q != recv_buffer[p].end(); ++q)
+    {
+      auto it = cell_global_to_local.find(*q);
+      dolfin_assert(it != cell_global_to_local.end());
+      dolfin_assert(it->second < num_regular_cells);
+      for (int j = 0; j < num_cell_vertices; ++j)
+        vertex_to_cells.insert({cell_vertices[it->second][j],
+              std::vector<int>()});
+    }
+  }
+  for (int i = 0; i < num_cells; ++i)
+  {
+    for (int j = 0; j < num_cell_vertices; ++j)
+    {
+      auto it = vertex_to_cells.find(cell_vertices[i][j]);
+      if (it != vertex_to_cells.end())
+        it->second.push_back(i);
+    }
+  }
+
+  // Send back each neighbour of the requested cells, packed as
+  // [cell_global_index, owner, [vertices]]
+  std::vector<std::vector<std::int64_t>> send_cells(mpi_size);
+  for (int p = 0; p < mpi_size; ++p)
+  {
+    std::set<int> neighbours;
+    for (auto q = recv_buffer[p].begin(); q != recv_buffer[p].end(); ++q)
+    {
+      const int c = cell_global_to_local[*q];
+
+      // Count vertices shared with each adjacent cell
+      std::map<int, int> num_shared_vertices;
+      for (int j = 0; j < num_cell_vertices; ++j)
+      {
+        const std::vector<int>& cells = vertex_to_cells[cell_vertices[c][j]];
+        for (auto d = cells.begin(); d != cells.end(); ++d)
+          if (*d != c)
+            ++num_shared_vertices[*d];
+      }
+
+      for (auto d = num_shared_vertices.begin();
+           d != num_shared_vertices.end(); ++d)
+      {
+        if (d->second >= num_connecting_vertices
+            and cell_partition[d->first] != p)
+        {
+          neighbours.insert(d->first);
+        }
+      }
+    }
+
+    std::vector<std::int64_t>& send_p = send_cells[p];
+    for (auto d = neighbours.begin(); d != neighbours.end(); ++d)
+    {
+      send_p.push_back(global_cell_indices[*d]);
+      send_p.push_back(cell_partition[*d]);
+      send_p.insert(send_p.end(), cell_vertices[*d].begin(),
+                    cell_vertices[*d].end());
+    }
+  }
+  MPI::all_to_all(mpi_comm, send_cells, recv_buffer);
+
+  // Append cells which are not already on this process, and notify
+  // their owners
+  send_buffer = std::vector<std::vector<std::int64_t>>(mpi_size);
+  std::vector<std::int64_t> new_cell_vertices;
+  for (int p = 0; p < mpi_size; ++p)
+  {
+    const std::vector<std::int64_t>& recv_p = recv_buffer[p];
+    for (auto q = recv_p.begin(); q != recv_p.end(); q += num_cell_vertices + 2)
+    {
+      const std::int64_t cell_index = *q;
+      const int owner = *(q + 1);
+      if (cell_global_to_local.find(cell_index) != cell_global_to_local.end())
+        continue;
+
+      cell_global_to_local.insert({cell_index, global_cell_indices.size()});
+      global_cell_indices.push_back(cell_index);
+      cell_partition.push_back(owner);
+      new_cell_vertices.insert(new_cell_vertices.end(), q + 2,
+                               q + 2 + num_cell_vertices);
+      shared_cells.insert({global_cell_indices.size() - 1,
+            std::set<unsigned int>()});
+      send_buffer[owner].push_back(cell_index);
+    }
+  }
+
+  const int num_new_cells = global_cell_indices.size() - num_cells;
+  cell_vertices.resize(boost::extents[num_cells + num_new_cells][num_cell_vertices]);
+  for (int i = 0; i < num_new_cells; ++i)
+  {
+    std::copy(new_cell_vertices.begin() + i*num_cell_vertices,
+              new_cell_vertices.begin() + (i + 1)*num_cell_vertices,
+              cell_vertices[num_cells + i].begin());
+  }
+
+  MPI::all_to_all(mpi_comm, send_buffer, recv_buffer);
+
+  // Owners record the new holders of their cells
+  std::set<int> changed_cells;
+  for (int p = 0; p < mpi_size; ++p)
+  {
+    for (auto q = recv_buffer[p].begin(); q != recv_buffer[p].end(); ++q)
+    {
+      const int c = cell_global_to_local[*q];
+      shared_cells[c].insert(p);
+      changed_cells.insert(c);
+    }
+  }
+
+  // Send the complete set of holders of each changed cell to all
+  // holders, packed as [cell_global_index, num_holders, [holders]]
+  send_buffer = std::vector<std::vector<std::int64_t>>(mpi_size);
+  for (auto c = changed_cells.begin(); c != changed_cells.end(); ++c)
+  {
+    const std::set<unsigned int>& holders = shared_cells[*c];
+    for (auto p = holders.begin(); p != holders.end(); ++p)
+    {
+      std::vector<std::int64_t>& send_p = send_buffer[*p];
+      send_p.push_back(global_cell_indices[*c]);
+      send_p.push_back(holders.size() + 1);
+      send_p.push_back(mpi_rank);
+      send_p.insert(send_p.end(), holders.begin(), holders.end());
+    }
+  }
+  MPI::all_to_all(mpi_comm, send_buffer, recv_buffer);
+
+  for (int p = 0; p < mpi_size; ++p)
+  {
+    const std::vector<std::int64_t>& recv_p = recv_buffer[p];
+    for (auto q = recv_p.begin(); q != recv_p.end(); q += *(q + 1) + 2)
+    {
+      const int c = cell_global_to_local[*q];
+      std::set<unsigned int>& sharing_procs = shared_cells[c];
+      for (auto r = q + 2; r != q + 2 + *(q + 1); ++r)
+        if (*r != (std::int64_t) mpi_rank)
+          sharing_procs.insert(*r);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 std::int32_t
 MeshPartitioning::distribute_cells(
   const MPI_Comm mpi_comm,
@@ -842,11 +1393,11 @@ MeshPartitioning::distribute_cells(
       new_cell_partition[idx] = owner;
       if (num_ghosts != 0)
       {
-        std::set<unsigned int> proc_set(tmp_it, tmp_it + num_ghosts);
-
-        // Remove self from set of sharing processes
+        // Insert sharing processes directly (no temporary set), and
+        // remove self
+        std::set<unsigned int>& proc_set = shared_cells[idx];
+        proc_set.insert(tmp_it, tmp_it + num_ghosts);
         proc_set.erase(mpi_rank);
-        shared_cells.insert({idx, proc_set});
         tmp_it += num_ghosts;
       }
 
@@ -1012,22 +1563,20 @@ void MeshPartitioning::build_shared_vertices(MPI_Comm mpi_comm,
 
   const int mpi_size = MPI::size(mpi_comm);
 
-  // Generate vertex sharing information
-  std::map<std::size_t, std::set<unsigned int>> vertex_to_proc;
+  // Generate vertex sharing information (allocated from an arena
+  // and freed on return)
+  MonotonicArena arena;
+  typedef std::set<unsigned int, std::less<unsigned int>,
+                   ArenaAllocator<unsigned int>> ProcSet;
+  std::map<std::size_t, ProcSet, std::less<std::size_t>,
+           ArenaAllocator<std::pair<const std::size_t, ProcSet>>>
+    vertex_to_proc(arena);
   for (int p = 0; p < mpi_size; ++p)
   {
     for (auto q = received_vertex_indices[p].begin();
          q != received_vertex_indices[p].end(); ++q)
     {
-      auto map_it = vertex_to_proc.find(*q);
-      if (map_it == vertex_to_proc.end())
-      {
-        std::set<unsigned int> proc_set;
-        proc_set.insert(p);
-        vertex_to_proc.insert({*q, proc_set});
-      }
-      else
-        map_it->second.insert(p);
+      vertex_to_proc.insert({*q, ProcSet(arena)}).first->second.insert(p);
     }
   }
 
@@ -1091,14 +1640,14 @@ void MeshPartitioning::build_local_mesh(Mesh& mesh,
 
   // Add vertices
   editor.init_vertices_global(vertex_coordinates.size(), num_global_vertices);
-  Point point(gdim);
   dolfin_assert(vertex_indices.size() == vertex_coordinates.size());
-  for (std::size_t i = 0; i < vertex_coordinates.size(); ++i)
-  {
-    for (std::int8_t j = 0; j < gdim; ++j)
-      point[j] = vertex_coordinates[i][j];
-    editor.add_vertex_global(i, vertex_indices[i], point);
-  }
+  dolfin_assert(vertex_coordinates.num_elements()
+                == vertex_coordinates.size()*gdim);
+  editor.add_vertices_global(
+    std::vector<double>(vertex_coordinates.data(),
+                        vertex_coordinates.data()
+                        + vertex_coordinates.num_elements()),
+    vertex_indices);
 
   // Create CellType
   std::unique_ptr<CellType> _cell_type(CellType::create(cell_type));
@@ -1108,7 +1657,7 @@ void MeshPartitioning::build_local_mesh(Mesh& mesh,
   editor.init_cells_global(cell_global_vertices.size(), num_global_cells);
 
   const std::int8_t num_cell_vertices = _cell_type->num_vertices();
-  std::vector<std::size_t> cell(num_cell_vertices);
+  std::vector<unsigned int> cells(cell_global_vertices.size()*num_cell_vertices);
   for (std::size_t i = 0; i < cell_global_vertices.size(); ++i)
   {
     for (std::int8_t j = 0; j < num_cell_vertices; ++j)
@@ -1116,11 +1665,10 @@ void MeshPartitioning::build_local_mesh(Mesh& mesh,
       // Get local cell vertex
       auto iter = vertex_global_to_local.find(cell_global_vertices[i][j]);
       dolfin_assert(iter != vertex_global_to_local.end());
-      cell[j] = iter->second;
+      cells[i*num_cell_vertices + j] = iter->second;
     }
-
-    editor.add_cell(i, global_cell_indices[i], cell);
   }
+  editor.add_cells_global(std::move(cells), global_cell_indices);
 
   // Close mesh: Note that this must be done after creating the global
   // vertex map or otherwise the ordering in mesh.close() will be
@@ -1187,23 +1735,24 @@ void MeshPartitioning::build_mesh_domains(Mesh& mesh,
     }
 
     // Get data from mesh value collection
-    const std::map<std::pair<std::size_t, std::size_t>, std::size_t>& values
-      = mvc.values();
+    const std::vector<std::pair<std::size_t, std::size_t>>& entities
+      = mvc.entities();
+    const std::vector<std::size_t>& values = mvc.entity_values();
 
     // Get map from mesh domains
     std::map<std::size_t, std::size_t>& markers = mesh.domains().markers(d);
-    for (auto it = values.begin(); it != values.end(); ++it)
+    for (std::size_t i = 0; i < entities.size(); ++i)
     {
-      const std::size_t cell_index = it->first.first;
-      const std::size_t local_entity_index = it->first.second;
+      const std::size_t cell_index = entities[i].first;
+      const std::size_t local_entity_index = entities[i].second;
 
       if (d == D)
-        markers[0] = it->second;
+        markers.insert(markers.end(), {cell_index, values[i]});
       else
       {
         const Cell cell(mesh, cell_index);
         const MeshEntity e(mesh, d, cell.entities(d)[local_entity_index]);
-        markers[e.index()] = it->second;
+        markers[e.index()] = values[i];
       }
     }
   }
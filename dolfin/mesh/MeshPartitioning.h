@@ -28,6 +28,7 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <boost/multi_array.hpp>
@@ -78,6 +79,42 @@ namespace dolfin
     static void build_distributed_mesh(Mesh& mesh, const LocalMeshData& data,
                                        const std::string ghost_mode);
 
+    /// Build a distributed mesh from 'local mesh data' with a given
+    /// destination process for each cell and the ghost processes
+    /// ('local cell index -> [owner, ghost processes]') of the cells
+    /// on partition boundaries. No partitioner is called, so the
+    /// caller is responsible for consistent ghost information.
+    static void build_distributed_mesh(Mesh& mesh, const LocalMeshData& data,
+                                       const std::vector<int>& cell_partition,
+                                       const std::map<std::int64_t, std::vector<int>>& ghost_procs,
+                                       const std::string ghost_mode);
+
+    /// Repartition a distributed mesh so that the cell weights are
+    /// balanced across processes, and return the new mesh. The
+    /// weights of the local (non-ghost) cells are stored cell by
+    /// cell, with num_cell_weights weights (balance constraints) per
+    /// cell. ParMETIS balances each constraint separately, SCOTCH
+    /// balances their sum.
+    static std::shared_ptr<Mesh>
+      repartition(const Mesh& mesh, const std::vector<std::size_t>& cell_weight,
+                  std::size_t num_cell_weights=1);
+
+    /// Repartition a distributed mesh so that the cell weights are
+    /// balanced across processes, and return the new mesh. Each
+    /// (cell) MeshFunction is one balance constraint. Weights must
+    /// be non-negative and are rounded to integers after scaling each
+    /// constraint so that its largest weight is 100.
+    static std::shared_ptr<Mesh>
+      repartition(const std::vector<std::shared_ptr<const MeshFunction<double>>>& cell_weights);
+
+    /// Redistribute a distributed mesh, moving each local (non-ghost)
+    /// cell to the process given by cell_partition, and return the
+    /// new mesh. Global cell and vertex indices are preserved, and
+    /// the ghost mode of the mesh is kept. Mesh domains are not
+    /// transferred (see MeshRedistribution for moving data).
+    static std::shared_ptr<Mesh>
+      redistribute(const Mesh& mesh, const std::vector<int>& cell_partition);
+
     /// Build a MeshValueCollection based on LocalMeshValueCollection
     template<typename T>
       static void
@@ -98,6 +135,24 @@ namespace dolfin
                          std::vector<int>& cell_partition,
                          std::map<std::int64_t, std::vector<int>>& ghost_procs);
 
+    // Fill local mesh data (process-local cells and contiguous blocks
+    // of vertices) from a distributed mesh
+    static void extract_local_mesh_data(const Mesh& mesh,
+                                        LocalMeshData& local_mesh_data);
+
+    // Compute the ghost processes ('local cell index -> [owner, ghost
+    // processes]') of the local cells of a distributed mesh for a
+    // new cell partition, from facet adjacency
+    static void
+      compute_ghost_procs(const Mesh& mesh,
+                          const std::vector<int>& cell_partition,
+                          std::map<std::int64_t, std::vector<int>>& ghost_procs);
+
+    // Return one weight per cell for partitioners that balance a
+    // single constraint, summing multiple cell weights
+    static std::vector<std::size_t>
+      combined_cell_weight(const LocalMeshData& mesh_data);
+
     // Build a distributed mesh from local mesh data with a computed
     // partition
     static void build(Mesh& mesh, const LocalMeshData& data,
@@ -117,6 +172,23 @@ namespace dolfin
                                std::vector<std::int64_t>& global_cell_indices,
                                std::vector<int>& cell_partition);
 
+    // Add one further layer of ghost cells around the ghost cells
+    // numbered from layer_begin onwards, which are requested from the
+    // owning processes. Cells are connected if they share at least
+    // num_connecting_vertices vertices. New cells are appended to
+    // cell_vertices, global_cell_indices and cell_partition, and
+    // shared_cells is updated on all processes holding an affected
+    // cell.
+    static
+    void distribute_ghost_layer(MPI_Comm mpi_comm,
+                                const int num_regular_cells,
+                                const int layer_begin,
+                                const int num_connecting_vertices,
+                                std::map<std::int32_t, std::set<unsigned int>>& shared_cells,
+                                boost::multi_array<std::int64_t, 2>& cell_vertices,
+                                std::vector<std::int64_t>& global_cell_indices,
+                                std::vector<int>& cell_partition);
+
     // FIXME: make clearer what goes in and what comes out
     // Reorder cells by Gibbs-Poole-Stockmeyer algorithm (via SCOTCH). Returns
     // the tuple (new_shared_cells, new_cell_vertices,new_global_cell_indices).
@@ -258,6 +330,7 @@ namespace dolfin
     // Get local mesh data for domains
     const std::vector< std::pair<std::pair<std::size_t, std::size_t>, T>>&
       ldata = local_value_data;
+    markers.reserve(ldata.size());
 
     // Get local local-to-global map
     if (!mesh.topology().have_global_indices(D))
@@ -291,7 +364,7 @@ namespace dolfin
         const std::size_t local_cell_index = data->second;
         const std::size_t entity_local_index = ldata[i].first.second;
         const T value = ldata[i].second;
-        markers.set_value(local_cell_index, entity_local_index, value);
+        markers.append(local_cell_index, entity_local_index, value);
 
         // If shared with other processes, add to off process list
         if (sharing_map.find(local_cell_index) != sharing_map.end())
@@ -370,9 +443,11 @@ namespace dolfin
       const std::size_t local_entity_index = received_data0[2*i + 1];
       const T value = received_data1[i];
       dolfin_assert(local_cell_entity < mesh.num_cells());
-      markers.set_value(local_cell_entity, local_entity_index, value);
+      markers.append(local_cell_entity, local_entity_index, value);
     }
 
+    // Sort values and remove duplicates
+    markers.finalize();
   }
   //---------------------------------------------------------------------------
 
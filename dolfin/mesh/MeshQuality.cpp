@@ -18,16 +18,36 @@
 // First added:  2013-10-07
 // Last changed:
 
+#include <limits>
+#include <memory>
 #include <sstream>
 #include <dolfin/common/MPI.h>
 #include "Cell.h"
 #include "Mesh.h"
 #include "MeshFunction.h"
+#include "MeshGeometryCache.h"
 #include "MeshQuality.h"
 #include "Vertex.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Return geometry cache of mesh, checking that it holds radius
+  // ratios
+  std::shared_ptr<const MeshGeometryCache> radius_ratio_cache(const Mesh& mesh)
+  {
+    std::shared_ptr<const MeshGeometryCache> cache = mesh.geometry_cache();
+    if (mesh.num_cells() > 0 && cache->cell_radius_ratios().empty())
+    {
+      dolfin_error("MeshQuality.cpp",
+                   "compute cell radius ratio",
+                   "Radius ratio is only defined for simplicial cells");
+    }
+    return cache;
+  }
+}
+
 //-----------------------------------------------------------------------------
 dolfin::CellFunction<double>
 MeshQuality::radius_ratios(std::shared_ptr<const Mesh> mesh)
@@ -35,22 +55,25 @@ MeshQuality::radius_ratios(std::shared_ptr<const Mesh> mesh)
   // Create CellFunction
   CellFunction<double> cf(mesh, 0.0);
 
-  // Compute radius ration
+  // Copy radius ratios of local cells from geometry cache
+  std::shared_ptr<const MeshGeometryCache> cache = radius_ratio_cache(*mesh);
+  const std::vector<double>& ratios = cache->cell_radius_ratios();
   for (CellIterator cell(*mesh); !cell.end(); ++cell)
-    cf[*cell] = cell->radius_ratio();
+    cf[*cell] = ratios[cell->index()];
 
   return cf;
 }
 //-----------------------------------------------------------------------------
 std::pair<double, double> MeshQuality::radius_ratio_min_max(const Mesh& mesh)
 {
-  CellIterator cell(mesh);
-  double qmin = cell->radius_ratio();
-  double qmax = cell->radius_ratio();
-  for (; !cell.end(); ++cell)
+  std::shared_ptr<const MeshGeometryCache> cache = radius_ratio_cache(mesh);
+  const std::vector<double>& ratios = cache->cell_radius_ratios();
+  double qmin = std::numeric_limits<double>::max();
+  double qmax = 0.0;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
   {
-    qmin = std::min(qmin, cell->radius_ratio());
-    qmax = std::max(qmax, cell->radius_ratio());
+    qmin = std::min(qmin, ratios[cell->index()]);
+    qmax = std::max(qmax, ratios[cell->index()]);
   }
 
   qmin = MPI::min(mesh.mpi_comm(), qmin);
@@ -74,9 +97,11 @@ MeshQuality::radius_ratio_histogram_data(const Mesh& mesh,
   std::cout << static_cast<double>(num_bins) << std::endl;
 
 
+  std::shared_ptr<const MeshGeometryCache> cache = radius_ratio_cache(mesh);
+  const std::vector<double>& ratios = cache->cell_radius_ratios();
   for (CellIterator cell(mesh); !cell.end(); ++cell)
   {
-    const double ratio = cell->radius_ratio();
+    const double ratio = ratios[cell->index()];
 
     // Compute 'bin' index, and handle special case that ratio = 1.0
     const std::size_t slot
@@ -0,0 +1,270 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/fem/FiniteElement.h>
+#include <dolfin/fem/GenericDofMap.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/la/LocalVectorArray.h>
+#include <dolfin/log/log.h>
+#include "Cell.h"
+#include "MeshEntityIterator.h"
+#include "MeshPartitioning.h"
+#include "Vertex.h"
+#include "MeshRedistribution.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+MeshRedistribution::MeshRedistribution(std::shared_ptr<const Mesh> mesh,
+                                       const std::vector<int>& cell_partition)
+  : _old_mesh(mesh)
+{
+  Timer timer("Redistribute mesh");
+  dolfin_assert(_old_mesh);
+  _new_mesh = MeshPartitioning::redistribute(*_old_mesh, cell_partition);
+}
+//-----------------------------------------------------------------------------
+void MeshRedistribution::redistribute(const Function& u,
+                                      Function& u_new) const
+{
+  Timer timer("Redistribute function");
+
+  dolfin_assert(u.function_space());
+  dolfin_assert(u_new.function_space());
+  const FunctionSpace& V = *u.function_space();
+  const FunctionSpace& V_new = *u_new.function_space();
+  dolfin_assert(V.mesh() and V_new.mesh());
+  if (V.mesh()->id() != _old_mesh->id()
+      or V_new.mesh()->id() != _new_mesh->id())
+  {
+    dolfin_error("MeshRedistribution.cpp",
+                 "redistribute function",
+                 "Functions must be defined on the original and the redistributed mesh");
+  }
+
+  dolfin_assert(V.element() and V_new.element());
+  if (std::string(V.element()->signature())
+      != std::string(V_new.element()->signature()))
+  {
+    dolfin_error("MeshRedistribution.cpp",
+                 "redistribute function",
+                 "Function spaces have different elements");
+  }
+
+  dolfin_assert(V.dofmap() and V_new.dofmap());
+  const GenericDofMap& dofmap = *V.dofmap();
+  const GenericDofMap& dofmap_new = *V_new.dofmap();
+  const std::size_t space_dim = V.element()->space_dimension();
+
+  // Cell-wise values of u, in the local dof order of each cell
+  // (which only depends on the global vertex indices, and is
+  // therefore the same on both meshes)
+  std::vector<std::int64_t> send_keys;
+  std::vector<std::int64_t> send_values;
+  {
+    dolfin_assert(u.vector());
+    const GenericVector& x = *u.vector();
+    const LocalVectorArray<const double> x_values(x, true);
+    const std::size_t tdim = _old_mesh->topology().dim();
+    const std::size_t num_cells = _old_mesh->topology().ghost_offset(tdim);
+    send_keys.reserve(num_cells);
+    send_values.reserve(num_cells*space_dim);
+    for (CellIterator cell(*_old_mesh); !cell.end(); ++cell)
+    {
+      send_keys.push_back(cell->global_index());
+      auto dofs = dofmap.cell_dofs(cell->index());
+      dolfin_assert((std::size_t) dofs.size() == space_dim);
+      for (std::size_t j = 0; j < space_dim; ++j)
+        send_values.push_back(pack(x_values[dofs[j]]));
+    }
+  }
+
+  // Request the values of all cells of the redistributed mesh
+  std::vector<std::int64_t> request_keys;
+  request_keys.reserve(_new_mesh->num_cells());
+  for (CellIterator cell(*_new_mesh, "all"); !cell.end(); ++cell)
+    request_keys.push_back(cell->global_index());
+
+  std::vector<std::int64_t> values;
+  std::vector<bool> found;
+  const std::size_t tdim = _old_mesh->topology().dim();
+  exchange(1, space_dim, _old_mesh->size_global(tdim), send_keys,
+           send_values, request_keys, values, found);
+
+  // Set owned values of u_new and update ghosts
+  dolfin_assert(u_new.vector());
+  {
+    const LocalVectorArray<double> x_new(*u_new.vector());
+    for (CellIterator cell(*_new_mesh, "all"); !cell.end(); ++cell)
+    {
+      const std::size_t c = cell->index();
+      if (!found[c])
+        continue;
+      auto dofs = dofmap_new.cell_dofs(c);
+      dolfin_assert((std::size_t) dofs.size() == space_dim);
+      for (std::size_t j = 0; j < space_dim; ++j)
+      {
+        if ((std::size_t) dofs[j] < x_new.size())
+          x_new[dofs[j]] = unpack<double>(values[c*space_dim + j]);
+      }
+    }
+  }
+  u_new.vector()->apply("insert");
+}
+//-----------------------------------------------------------------------------
+void MeshRedistribution::entity_keys(const Mesh& mesh, std::size_t dim,
+                                     std::vector<std::int64_t>& keys)
+{
+  mesh.init(dim);
+  const std::size_t num_entities = mesh.num_entities(dim);
+
+  if (dim == 0)
+  {
+    keys.resize(num_entities);
+    for (VertexIterator v(mesh, "all"); !v.end(); ++v)
+      keys[v->index()] = v->global_index();
+    return;
+  }
+
+  const std::size_t num_entity_vertices = mesh.type().num_vertices(dim);
+  keys.resize(num_entities*num_entity_vertices);
+  const std::vector<std::int64_t>& global_vertices
+    = mesh.topology().global_indices(0);
+  for (MeshEntityIterator e(mesh, dim, "all"); !e.end(); ++e)
+  {
+    std::int64_t* key = keys.data() + e->index()*num_entity_vertices;
+    const unsigned int* vertices = e->entities(0);
+    for (std::size_t i = 0; i < num_entity_vertices; ++i)
+      key[i] = global_vertices[vertices[i]];
+    std::sort(key, key + num_entity_vertices);
+  }
+}
+//-----------------------------------------------------------------------------
+void MeshRedistribution::exchange(std::size_t key_size,
+                                  std::size_t value_size,
+                                  std::size_t num_global,
+                                  const std::vector<std::int64_t>& send_keys,
+                                  const std::vector<std::int64_t>& send_values,
+                                  const std::vector<std::int64_t>& request_keys,
+                                  std::vector<std::int64_t>& values,
+                                  std::vector<bool>& found) const
+{
+  const MPI_Comm mpi_comm = _old_mesh->mpi_comm();
+  const std::size_t entry_size = key_size + value_size;
+
+  // Send entries to the directory processes
+  const std::size_t num_entries = send_values.size()/value_size;
+  dolfin_assert(send_keys.size() == num_entries*key_size);
+  std::map<int, std::vector<std::int64_t>> send_entries;
+  for (std::size_t i = 0; i < num_entries; ++i)
+  {
+    const int p = MPI::index_owner(mpi_comm, send_keys[i*key_size],
+                                   num_global);
+    std::vector<std::int64_t>& entries = send_entries[p];
+    entries.insert(entries.end(), send_keys.begin() + i*key_size,
+                   send_keys.begin() + (i + 1)*key_size);
+    entries.insert(entries.end(), send_values.begin() + i*value_size,
+                   send_values.begin() + (i + 1)*value_size);
+  }
+  std::map<int, std::vector<std::int64_t>> recv_entries;
+  MPI::sparse_all_to_all(mpi_comm, send_entries, recv_entries);
+
+  // Build directory (entries received more than once are
+  // consistent)
+  std::map<std::vector<std::int64_t>, std::vector<std::int64_t>> directory;
+  std::vector<std::int64_t> key(key_size);
+  for (const auto& r : recv_entries)
+  {
+    dolfin_assert(r.second.size() % entry_size == 0);
+    for (std::size_t j = 0; j < r.second.size(); j += entry_size)
+    {
+      key.assign(r.second.begin() + j, r.second.begin() + j + key_size);
+      directory[key].assign(r.second.begin() + j + key_size,
+                            r.second.begin() + j + entry_size);
+    }
+  }
+
+  // Send requests to the directory processes
+  const std::size_t num_requests = request_keys.size()/key_size;
+  std::vector<int> request_owner(num_requests);
+  std::map<int, std::vector<std::int64_t>> send_requests;
+  for (std::size_t i = 0; i < num_requests; ++i)
+  {
+    const int p = MPI::index_owner(mpi_comm, request_keys[i*key_size],
+                                   num_global);
+    request_owner[i] = p;
+    std::vector<std::int64_t>& requests = send_requests[p];
+    requests.insert(requests.end(), request_keys.begin() + i*key_size,
+                    request_keys.begin() + (i + 1)*key_size);
+  }
+  std::map<int, std::vector<std::int64_t>> recv_requests;
+  MPI::sparse_all_to_all(mpi_comm, send_requests, recv_requests);
+
+  // Answer requests, one flag followed by the values per key
+  std::map<int, std::vector<std::int64_t>> send_answers;
+  for (const auto& r : recv_requests)
+  {
+    std::vector<std::int64_t>& answers = send_answers[r.first];
+    answers.reserve((r.second.size()/key_size)*(value_size + 1));
+    for (std::size_t j = 0; j < r.second.size(); j += key_size)
+    {
+      key.assign(r.second.begin() + j, r.second.begin() + j + key_size);
+      const auto entry = directory.find(key);
+      if (entry != directory.end())
+      {
+        answers.push_back(1);
+        answers.insert(answers.end(), entry->second.begin(),
+                       entry->second.end());
+      }
+      else
+      {
+        answers.push_back(0);
+        answers.insert(answers.end(), value_size, 0);
+      }
+    }
+  }
+  std::map<int, std::vector<std::int64_t>> recv_answers;
+  MPI::sparse_all_to_all(mpi_comm, send_answers, recv_answers);
+
+  // Unpack answers in request order
+  values.assign(num_requests*value_size, 0);
+  found.assign(num_requests, false);
+  std::map<int, std::size_t> position;
+  for (std::size_t i = 0; i < num_requests; ++i)
+  {
+    const int p = request_owner[i];
+    const std::vector<std::int64_t>& answers = recv_answers[p];
+    std::size_t& pos = position[p];
+    dolfin_assert(pos + value_size < answers.size() + 1);
+    if (answers[pos] != 0)
+    {
+      found[i] = true;
+      std::copy(answers.begin() + pos + 1,
+                answers.begin() + pos + 1 + value_size,
+                values.begin() + i*value_size);
+    }
+    pos += value_size + 1;
+  }
+}
+//-----------------------------------------------------------------------------
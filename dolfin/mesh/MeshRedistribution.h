@@ -0,0 +1,241 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __MESH_REDISTRIBUTION_H
+#define __MESH_REDISTRIBUTION_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "Mesh.h"
+#include "MeshFunction.h"
+#include "MeshValueCollection.h"
+
+namespace dolfin
+{
+
+  class Function;
+
+  /// This class moves a distributed mesh to a new cell partition,
+  /// together with data defined on it: MeshFunctions,
+  /// MeshValueCollections and Functions.
+  ///
+  /// The new mesh is built by MeshPartitioning::redistribute. Global
+  /// cell and vertex indices are preserved, so data on mesh entities
+  /// is matched by the global indices of their vertices, and
+  /// Function values cell by cell. Data is exchanged through a
+  /// distributed directory (the process owning the smallest global
+  /// vertex or the global cell index of each entry) using sparse
+  /// (neighbourhood) communication.
+
+  class MeshRedistribution
+  {
+  public:
+
+    /// Redistribute mesh so that each local (non-ghost) cell is
+    /// moved to the process given by cell_partition (collective)
+    MeshRedistribution(std::shared_ptr<const Mesh> mesh,
+                       const std::vector<int>& cell_partition);
+
+    /// Return the original mesh
+    std::shared_ptr<const Mesh> old_mesh() const
+    { return _old_mesh; }
+
+    /// Return the redistributed mesh
+    std::shared_ptr<Mesh> mesh() const
+    { return _new_mesh; }
+
+    /// Return MeshFunction on the redistributed mesh with the values
+    /// of f (collective). Entities without a value on any process
+    /// are set to default_value.
+    template <typename T>
+      std::shared_ptr<MeshFunction<T>>
+      redistribute(const MeshFunction<T>& f, const T& default_value=T()) const;
+
+    /// Return MeshValueCollection on the redistributed mesh with the
+    /// values of c (collective)
+    template <typename T>
+      std::shared_ptr<MeshValueCollection<T>>
+      redistribute(const MeshValueCollection<T>& c) const;
+
+    /// Copy the values of u to u_new, where u_new is defined on the
+    /// redistributed mesh in a function space with the same element
+    /// as u (collective)
+    void redistribute(const Function& u, Function& u_new) const;
+
+  private:
+
+    // Compute the keys identifying the entities of dimension dim of
+    // mesh: the global vertex index for vertices, otherwise the
+    // sorted global indices of the entity vertices
+    static void entity_keys(const Mesh& mesh, std::size_t dim,
+                            std::vector<std::int64_t>& keys);
+
+    // Exchange values through a distributed directory. The entries
+    // (send_keys, send_values) are stored on the process owning the
+    // first key component (in [0, num_global)), and the values of
+    // request_keys are looked up. Missing entries are flagged false
+    // in found.
+    void exchange(std::size_t key_size, std::size_t value_size,
+                  std::size_t num_global,
+                  const std::vector<std::int64_t>& send_keys,
+                  const std::vector<std::int64_t>& send_values,
+                  const std::vector<std::int64_t>& request_keys,
+                  std::vector<std::int64_t>& values,
+                  std::vector<bool>& found) const;
+
+    // Pack value into (and unpack from) a 64-bit integer for
+    // communication
+    template <typename T>
+      static std::int64_t pack(const T& value)
+    {
+      static_assert(sizeof(T) <= sizeof(std::int64_t),
+                    "Value type too large");
+      std::int64_t packed = 0;
+      std::memcpy(&packed, &value, sizeof(T));
+      return packed;
+    }
+
+    template <typename T>
+      static T unpack(std::int64_t packed)
+    {
+      T value;
+      std::memcpy(&value, &packed, sizeof(T));
+      return value;
+    }
+
+    // Original and redistributed mesh
+    std::shared_ptr<const Mesh> _old_mesh;
+    std::shared_ptr<Mesh> _new_mesh;
+
+  };
+
+  //---------------------------------------------------------------------------
+  // Implementation of MeshRedistribution
+  //---------------------------------------------------------------------------
+  template <typename T>
+    std::shared_ptr<MeshFunction<T>>
+    MeshRedistribution::redistribute(const MeshFunction<T>& f,
+                                     const T& default_value) const
+  {
+    dolfin_assert(f.mesh());
+    if (f.mesh()->id() != _old_mesh->id())
+    {
+      dolfin_error("MeshRedistribution.h",
+                   "redistribute mesh function",
+                   "MeshFunction is not defined on the original mesh");
+    }
+
+    const std::size_t dim = f.dim();
+    const std::size_t key_size = (dim == 0) ? 1
+      : _old_mesh->type().num_vertices(dim);
+
+    // Entries from the original mesh
+    std::vector<std::int64_t> send_keys;
+    entity_keys(*_old_mesh, dim, send_keys);
+    std::vector<std::int64_t> send_values(f.size());
+    for (std::size_t i = 0; i < f.size(); ++i)
+    {
+      const T value = f[i];
+      send_values[i] = pack(value);
+    }
+
+    // Look up values of the entities of the new mesh
+    std::vector<std::int64_t> request_keys;
+    entity_keys(*_new_mesh, dim, request_keys);
+    std::vector<std::int64_t> values;
+    std::vector<bool> found;
+    exchange(key_size, 1, _old_mesh->size_global(0), send_keys, send_values,
+             request_keys, values, found);
+
+    std::shared_ptr<MeshFunction<T>>
+      f_new(new MeshFunction<T>(_new_mesh, dim, default_value));
+    for (std::size_t i = 0; i < f_new->size(); ++i)
+    {
+      if (found[i])
+        (*f_new)[i] = unpack<T>(values[i]);
+    }
+
+    return f_new;
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+    std::shared_ptr<MeshValueCollection<T>>
+    MeshRedistribution::redistribute(const MeshValueCollection<T>& c) const
+  {
+    dolfin_assert(c.mesh());
+    if (c.mesh()->id() != _old_mesh->id())
+    {
+      dolfin_error("MeshRedistribution.h",
+                   "redistribute mesh value collection",
+                   "MeshValueCollection is not defined on the original mesh");
+    }
+
+    const std::size_t dim = c.dim();
+    const std::size_t tdim = _old_mesh->topology().dim();
+    const std::size_t key_size = (dim == 0) ? 1
+      : _old_mesh->type().num_vertices(dim);
+
+    // Entries from the original mesh, identified by the entity
+    // (cell_index, local_entity)
+    std::vector<std::int64_t> entity_key;
+    entity_keys(*_old_mesh, dim, entity_key);
+    if (dim != tdim)
+      _old_mesh->init(tdim, dim);
+    const std::vector<std::pair<std::size_t, std::size_t>>& entities
+      = c.entities();
+    const std::vector<T>& entity_values = c.entity_values();
+    std::vector<std::int64_t> send_keys;
+    std::vector<std::int64_t> send_values(entities.size());
+    send_keys.reserve(key_size*entities.size());
+    for (std::size_t i = 0; i < entities.size(); ++i)
+    {
+      const std::size_t cell_index = entities[i].first;
+      const std::size_t entity_index = (dim == tdim) ? cell_index
+        : _old_mesh->topology()(tdim, dim)(cell_index)[entities[i].second];
+      send_keys.insert(send_keys.end(),
+                       entity_key.begin() + entity_index*key_size,
+                       entity_key.begin() + (entity_index + 1)*key_size);
+      const T value = entity_values[i];
+      send_values[i] = pack(value);
+    }
+
+    // Look up values of the entities of the new mesh
+    std::vector<std::int64_t> request_keys;
+    entity_keys(*_new_mesh, dim, request_keys);
+    std::vector<std::int64_t> values;
+    std::vector<bool> found;
+    exchange(key_size, 1, _old_mesh->size_global(0), send_keys, send_values,
+             request_keys, values, found);
+
+    std::shared_ptr<MeshValueCollection<T>>
+      c_new(new MeshValueCollection<T>(_new_mesh, dim));
+    for (std::size_t i = 0; i < found.size(); ++i)
+    {
+      if (found[i])
+        c_new->append(i, unpack<T>(values[i]));
+    }
+
+    return c_new;
+  }
+  //---------------------------------------------------------------------------
+
+}
+
+#endif
@@ -51,6 +51,10 @@ namespace dolfin
     // as calculated during ParallelRefinement process
     std::shared_ptr<const std::map<std::size_t, std::size_t> > edge_to_global_vertex;
 
+    // Map from cell of child Mesh to (local) parent cell in parent
+    // Mesh, as calculated during refinement
+    std::shared_ptr<const std::vector<std::size_t> > parent_cell;
+
   };
 }
 
@@ -21,20 +21,78 @@
 // Last changed: 2014-02-06
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
 #include <vector>
 
 #include <dolfin/log/log.h>
+#include <dolfin/common/MPI.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/utils.h>
+#include <dolfin/graph/BoostGraphOrdering.h>
+#include <dolfin/graph/Graph.h>
+#include <dolfin/graph/GraphBuilder.h>
 #include "Cell.h"
 #include "Mesh.h"
 #include "MeshEditor.h"
 #include "MeshTopology.h"
+#include "MeshDomains.h"
+#include "MeshEntityIterator.h"
 #include "MeshGeometry.h"
 #include "MeshRenumbering.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Compute index along Hilbert curve of point with integer
+  // coordinates X (n coordinates of nbits bits each). The coordinates
+  // are overwritten. See J. Skilling, Programming the Hilbert curve,
+  // AIP Conf. Proc. 707, 381 (2004).
+  std::uint64_t hilbert_index(std::uint32_t* X, std::size_t n, int nbits)
+  {
+    const std::uint32_t M = 1u << (nbits - 1);
+
+    // Inverse undo excess work
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+      const std::uint32_t P = Q - 1;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        if (X[i] & Q)
+          X[0] ^= P;
+        else
+        {
+          const std::uint32_t t = (X[0] ^ X[i]) & P;
+          X[0] ^= t;
+          X[i] ^= t;
+        }
+      }
+    }
+
+    // Gray encode
+    for (std::size_t i = 1; i < n; ++i)
+      X[i] ^= X[i - 1];
+    std::uint32_t t = 0;
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+      if (X[n - 1] & Q)
+        t ^= Q - 1;
+    }
+    for (std::size_t i = 0; i < n; ++i)
+      X[i] ^= t;
+
+    // Interleave bits of transposed index
+    std::uint64_t h = 0;
+    for (int b = nbits - 1; b >= 0; --b)
+      for (std::size_t i = 0; i < n; ++i)
+        h = (h << 1) | ((X[i] >> b) & 1u);
+
+    return h;
+  }
+}
+
 //-----------------------------------------------------------------------------
 dolfin::Mesh MeshRenumbering::renumber_by_color(const Mesh& mesh,
                                  const std::vector<std::size_t> coloring_type)
@@ -155,6 +213,204 @@ dolfin::Mesh MeshRenumbering::renumber_by_color(const Mesh& mesh,
   return new_mesh;
 }
 //-----------------------------------------------------------------------------
+dolfin::Mesh MeshRenumbering::reorder_entities(const Mesh& mesh,
+                                               std::string method)
+{
+  // Start timer
+  Timer timer("Reorder mesh entities");
+
+  if (MPI::size(mesh.mpi_comm()) > 1)
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "reorder mesh entities",
+                 "Reordering of distributed meshes is not supported");
+  }
+
+  if (mesh.geometry().degree() != 1)
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "reorder mesh entities",
+                 "Reordering of meshes with higher-order geometry is not supported");
+  }
+
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_vertices = mesh.num_vertices();
+  const std::size_t num_cells = mesh.num_cells();
+  const std::size_t vertices_per_cell = mesh.type().num_vertices();
+  const MeshConnectivity& cell_vertices = mesh.topology()(tdim, 0);
+  const std::vector<double>& x = mesh.geometry().x();
+
+  // Compute new cell order (new_cells[new index] = old index)
+  std::vector<std::size_t> new_cells(num_cells);
+  if (method == "rcm")
+  {
+    // Reverse Cuthill-McKee ordering of cells sharing a vertex
+    const Graph graph = GraphBuilder::local_graph(mesh, tdim, 0);
+    const std::vector<int> cell_map
+      = BoostGraphOrdering::compute_cuthill_mckee(graph, true);
+    dolfin_assert(cell_map.size() == num_cells);
+    for (std::size_t c = 0; c < num_cells; ++c)
+      new_cells[cell_map[c]] = c;
+  }
+  else if (method == "hilbert")
+  {
+    // Compute bounding box of mesh
+    std::vector<double> xmin(gdim, std::numeric_limits<double>::max());
+    std::vector<double> xmax(gdim, std::numeric_limits<double>::lowest());
+    for (std::size_t v = 0; v < num_vertices; ++v)
+    {
+      for (std::size_t j = 0; j < gdim; ++j)
+      {
+        xmin[j] = std::min(xmin[j], x[v*gdim + j]);
+        xmax[j] = std::max(xmax[j], x[v*gdim + j]);
+      }
+    }
+
+    // Number of bits per coordinate direction (index fits in 64 bits)
+    const int nbits = std::min(32, 63/(int) gdim);
+    const double scale = (double) ((std::uint64_t(1) << nbits) - 1);
+
+    // Compute Hilbert index of cell midpoints and sort
+    std::vector<std::pair<std::uint64_t, std::size_t>> keys(num_cells);
+    std::vector<std::uint32_t> X(gdim);
+    for (std::size_t c = 0; c < num_cells; ++c)
+    {
+      const unsigned int* vertices = cell_vertices(c);
+      for (std::size_t j = 0; j < gdim; ++j)
+      {
+        double midpoint = 0.0;
+        for (std::size_t i = 0; i < vertices_per_cell; ++i)
+          midpoint += x[vertices[i]*gdim + j];
+        midpoint /= vertices_per_cell;
+
+        const double h = xmax[j] - xmin[j];
+        const double s = (h > 0.0) ? (midpoint - xmin[j])/h : 0.0;
+        X[j] = (std::uint32_t) (std::max(0.0, std::min(1.0, s))*scale);
+      }
+      keys[c] = std::make_pair(hilbert_index(X.data(), gdim, nbits), c);
+    }
+    std::sort(keys.begin(), keys.end());
+    for (std::size_t c = 0; c < num_cells; ++c)
+      new_cells[c] = keys[c].second;
+  }
+  else
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "reorder mesh entities",
+                 "Unknown ordering method \"%s\" (use \"rcm\" or \"hilbert\")",
+                 method.c_str());
+  }
+
+  // Number vertices in order of first access by reordered cells
+  // (new_vertices[new index] = old index)
+  const std::size_t unset = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> vertex_map(num_vertices, unset);
+  std::vector<std::size_t> new_vertices;
+  new_vertices.reserve(num_vertices);
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    const unsigned int* vertices = cell_vertices(new_cells[c]);
+    for (std::size_t i = 0; i < vertices_per_cell; ++i)
+    {
+      if (vertex_map[vertices[i]] == unset)
+      {
+        vertex_map[vertices[i]] = new_vertices.size();
+        new_vertices.push_back(vertices[i]);
+      }
+    }
+  }
+
+  // Append vertices not attached to any cell
+  for (std::size_t v = 0; v < num_vertices; ++v)
+  {
+    if (vertex_map[v] == unset)
+    {
+      vertex_map[v] = new_vertices.size();
+      new_vertices.push_back(v);
+    }
+  }
+
+  // Create new mesh
+  Mesh new_mesh;
+  MeshEditor editor;
+  editor.open(new_mesh, mesh.type().cell_type(), tdim, gdim);
+  editor.init_vertices_global(num_vertices, num_vertices);
+  std::vector<double> p(gdim);
+  for (std::size_t v = 0; v < num_vertices; ++v)
+  {
+    std::copy(x.begin() + new_vertices[v]*gdim,
+              x.begin() + (new_vertices[v] + 1)*gdim, p.begin());
+    editor.add_vertex(v, p);
+  }
+
+  editor.init_cells_global(num_cells, num_cells);
+  std::vector<std::size_t> cell(vertices_per_cell);
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    const unsigned int* vertices = cell_vertices(new_cells[c]);
+    for (std::size_t i = 0; i < vertices_per_cell; ++i)
+      cell[i] = vertex_map[vertices[i]];
+    editor.add_cell(c, cell);
+  }
+  editor.close(mesh.ordered());
+
+  // Store maps to parent entities
+  new_mesh.data().create_array("parent_vertex_indices", 0) = new_vertices;
+  new_mesh.data().create_array("parent_cell_indices", tdim) = new_cells;
+
+  // Transfer subdomain markers
+  const MeshDomains& domains = mesh.domains();
+  new_mesh.domains().init(domains.max_dim());
+  std::vector<std::size_t> cell_map(num_cells);
+  for (std::size_t c = 0; c < num_cells; ++c)
+    cell_map[new_cells[c]] = c;
+  for (std::size_t dim = 0; dim <= domains.max_dim(); ++dim)
+  {
+    if (domains.num_marked(dim) == 0)
+      continue;
+
+    const std::map<std::size_t, std::size_t>& markers = domains.markers(dim);
+    std::map<std::size_t, std::size_t>& new_markers
+      = new_mesh.domains().markers(dim);
+    if (dim == 0 || dim == tdim)
+    {
+      const std::vector<std::size_t>& entity_map
+        = (dim == 0) ? vertex_map : cell_map;
+      for (auto m = markers.begin(); m != markers.end(); ++m)
+        new_markers[entity_map[m->first]] = m->second;
+    }
+    else
+    {
+      // Map entities by their sorted (new) vertex indices
+      new_mesh.init(dim);
+      std::map<std::vector<std::size_t>, std::size_t> entity_map;
+      std::vector<std::size_t> key;
+      for (MeshEntityIterator e(new_mesh, dim, "all"); !e.end(); ++e)
+      {
+        key.assign(e->entities(0), e->entities(0) + e->num_entities(0));
+        std::sort(key.begin(), key.end());
+        entity_map.insert(std::make_pair(key, e->index()));
+      }
+
+      mesh.init(dim);
+      for (auto m = markers.begin(); m != markers.end(); ++m)
+      {
+        const MeshEntity e(mesh, dim, m->first);
+        key.resize(e.num_entities(0));
+        for (std::size_t i = 0; i < key.size(); ++i)
+          key[i] = vertex_map[e.entities(0)[i]];
+        std::sort(key.begin(), key.end());
+        auto it = entity_map.find(key);
+        dolfin_assert(it != entity_map.end());
+        new_markers[it->second] = m->second;
+      }
+    }
+  }
+
+  return new_mesh;
+}
+//-----------------------------------------------------------------------------
 void MeshRenumbering::compute_renumbering(const Mesh& mesh,
                                           const std::vector<std::size_t>& coloring_type,
                                           std::vector<double>& new_coordinates,
@@ -18,18 +18,25 @@
 // Modified by Garth N. Wells, 2011.
 //
 // First added:  2010-11-27
-// Last changed: 2011-01-16
+// Last changed: 2017-10-14
 
 #ifndef __MESH_RENUMBERING_H
 #define __MESH_RENUMBERING_H
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
+#include <dolfin/log/log.h>
+#include "Mesh.h"
+#include "MeshData.h"
+#include "MeshEntityIterator.h"
+#include "MeshFunction.h"
 
 namespace dolfin
 {
 
-  class Mesh;
-
   /// This class implements renumbering algorithms for meshes.
 
   class MeshRenumbering
@@ -51,6 +58,91 @@ namespace dolfin
     static Mesh renumber_by_color(const Mesh& mesh,
                                   std::vector<std::size_t> coloring);
 
+    /// Reorder the cells and vertices of a mesh to improve data
+    /// locality. The cells are ordered by the reverse Cuthill-McKee
+    /// ordering of the cell-cell (via vertices) graph, or along a
+    /// Hilbert space-filling curve through the cell midpoints. The
+    /// vertices are then numbered in the order in which they are
+    /// first visited by the reordered cells, so that cells that are
+    /// close in the ordering also access nearby coordinates.
+    ///
+    /// The returned mesh stores the maps to the original entities
+    /// in the mesh data arrays "parent_cell_indices" and
+    /// "parent_vertex_indices", and the subdomain markers of the
+    /// original mesh are transferred. Use reorder_mesh_function to
+    /// transfer MeshFunctions. This function is not supported in
+    /// parallel or for higher-order geometry.
+    ///
+    /// @param  mesh (Mesh)
+    ///         Mesh to be reordered.
+    /// @param  method (std::string)
+    ///         Ordering method ("rcm" or "hilbert").
+    /// @return Mesh
+    static Mesh reorder_entities(const Mesh& mesh, std::string method="rcm");
+
+    /// Transfer MeshFunction on the original mesh to a mesh created
+    /// by reorder_entities
+    ///
+    /// @param  mesh (Mesh)
+    ///         Mesh returned by reorder_entities.
+    /// @param  f (MeshFunction<T>)
+    ///         MeshFunction on the original mesh.
+    /// @return MeshFunction<T>
+    template <typename T>
+    static MeshFunction<T>
+    reorder_mesh_function(std::shared_ptr<const Mesh> mesh,
+                          const MeshFunction<T>& f)
+    {
+      const std::size_t dim = f.dim();
+      const std::size_t tdim = mesh->topology().dim();
+      dolfin_assert(f.mesh());
+      const Mesh& parent_mesh = *f.mesh();
+      const std::vector<std::size_t>& parent_vertices
+        = mesh->data().array("parent_vertex_indices", 0);
+      if (parent_vertices.size() != mesh->num_vertices())
+      {
+        dolfin_error("MeshRenumbering.h",
+                     "reorder mesh function",
+                     "Mesh has not been created by reorder_entities");
+      }
+
+      // Cell and vertex functions map directly
+      MeshFunction<T> g(mesh, dim);
+      if (dim == 0 || dim == tdim)
+      {
+        const std::vector<std::size_t>& parent_entities = (dim == 0)
+          ? parent_vertices : mesh->data().array("parent_cell_indices", tdim);
+        for (std::size_t i = 0; i < parent_entities.size(); ++i)
+          g[i] = f[parent_entities[i]];
+        return g;
+      }
+
+      // Map other entities by their sorted (parent) vertices
+      parent_mesh.init(dim);
+      std::map<std::vector<std::size_t>, std::size_t> entity_map;
+      std::vector<std::size_t> key;
+      for (MeshEntityIterator e(parent_mesh, dim, "all"); !e.end(); ++e)
+      {
+        key.assign(e->entities(0), e->entities(0) + e->num_entities(0));
+        std::sort(key.begin(), key.end());
+        entity_map.insert(std::make_pair(key, e->index()));
+      }
+
+      mesh->init(dim);
+      for (MeshEntityIterator e(*mesh, dim, "all"); !e.end(); ++e)
+      {
+        key.resize(e->num_entities(0));
+        for (std::size_t i = 0; i < key.size(); ++i)
+          key[i] = parent_vertices[e->entities(0)[i]];
+        std::sort(key.begin(), key.end());
+        auto it = entity_map.find(key);
+        dolfin_assert(it != entity_map.end());
+        g[*e] = f[it->second];
+      }
+
+      return g;
+    }
+
   private:
 
     static void compute_renumbering(const Mesh& mesh,
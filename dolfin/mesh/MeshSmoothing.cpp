@@ -18,19 +18,28 @@
 // Modified by Garth N. Wells, 2010
 //
 // First added:  2008-07-16
-// Last changed: 2011-03-17
+// Last changed: 2017-10-14
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <vector>
 
 #include <dolfin/ale/ALE.h>
 #include <dolfin/common/Array.h>
 #include <dolfin/common/constants.h>
+#include <dolfin/common/MPI.h>
+#include <dolfin/common/SubSystemsManager.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "Mesh.h"
 #include "BoundaryMesh.h"
 #include "Vertex.h"
 #include "Edge.h"
 #include "Facet.h"
 #include "Cell.h"
+#include "DistributedMeshTools.h"
 #include "MeshData.h"
 #include "SubDomain.h"
 #include "MeshSmoothing.h"
@@ -49,108 +58,249 @@ void MeshSmoothing::smooth(Mesh& mesh, std::size_t num_iterations)
                  "This function does not support higher-order mesh geometry");
   }
 
-  // Make sure we have cell-facet connectivity
-  mesh.init(mesh.topology().dim(), mesh.topology().dim() - 1);
+  const std::size_t D = mesh.topology().dim();
+  const std::size_t d = mesh.geometry().dim();
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t mpi_size = MPI::size(mpi_comm);
+  const unsigned int mpi_rank = MPI::rank(mpi_comm);
 
-  // Make sure we have vertex-edge connectivity
+  // Make sure we have cell-facet, vertex-edge and vertex-cell
+  // connectivity
+  mesh.init(D, D - 1);
   mesh.init(0, 1);
+  mesh.init(0, D);
 
   // Make sure the mesh is ordered
   mesh.order();
 
+  // Number of threads (set by the global parameter "num_threads")
+  const int num_threads = SubSystemsManager::num_threads();
+
   // Mark vertices on the boundary so we may skip them
+  const std::int32_t num_vertices = mesh.num_vertices();
   BoundaryMesh boundary(mesh, "exterior");
-  const MeshFunction<std::size_t> vertex_map = boundary.entity_map(0);
-  MeshFunction<bool> on_boundary(reference_to_no_delete_pointer(mesh), 0);
-  on_boundary = false;
-  if (boundary.num_vertices() > 0)
+  const MeshFunction<std::size_t>& vertex_map = boundary.entity_map(0);
+  std::vector<char> on_boundary(num_vertices, 0);
+  for (std::size_t i = 0; i < boundary.num_vertices(); ++i)
+    on_boundary[vertex_map[i]] = 1;
+
+  // Shared vertices are moved by the lowest ranked process sharing
+  // them, which sends the new coordinates to the other processes.
+  // Edges on process boundaries are also counted only by the lowest
+  // ranked process, so that partial sums over the star of a shared
+  // vertex may be added up.
+  const std::map<std::int32_t, std::set<unsigned int>>& shared_vertices
+    = mesh.topology().shared_entities(0);
+  const std::vector<std::int64_t>& global_indices
+    = mesh.topology().global_indices(0);
+  std::map<std::int64_t, std::int32_t> global_to_local;
+  std::vector<char> owned(num_vertices, 1);
+  std::vector<char> count_edge(mesh.num_edges(), 1);
+  if (mpi_size > 1)
   {
-    for (VertexIterator v(boundary); !v.end(); ++v)
-      on_boundary[vertex_map[*v]] = true;
+    for (std::map<std::int32_t, std::set<unsigned int>>::const_iterator
+           sv = shared_vertices.begin(); sv != shared_vertices.end(); ++sv)
+    {
+      global_to_local[global_indices[sv->first]] = sv->first;
+      if (*sv->second.begin() < mpi_rank)
+        owned[sv->first] = 0;
+    }
+
+    DistributedMeshTools::number_entities(mesh, 1);
+    const std::map<std::int32_t, std::set<unsigned int>>& shared_edges
+      = mesh.topology().shared_entities(1);
+    for (std::map<std::int32_t, std::set<unsigned int>>::const_iterator
+           se = shared_edges.begin(); se != shared_edges.end(); ++se)
+    {
+      if (*se->second.begin() < mpi_rank)
+        count_edge[se->first] = 0;
+    }
+
+    // A shared vertex is on the boundary if any process finds so
+    std::vector<std::vector<std::int64_t>> send_boundary(mpi_size);
+    for (std::map<std::int32_t, std::set<unsigned int>>::const_iterator
+           sv = shared_vertices.begin(); sv != shared_vertices.end(); ++sv)
+    {
+      if (!on_boundary[sv->first])
+        continue;
+      for (std::set<unsigned int>::const_iterator p = sv->second.begin();
+           p != sv->second.end(); ++p)
+      {
+        send_boundary[*p].push_back(global_indices[sv->first]);
+      }
+    }
+    std::vector<std::vector<std::int64_t>> recv_boundary;
+    MPI::all_to_all(mpi_comm, send_boundary, recv_boundary);
+    for (std::size_t p = 0; p < mpi_size; ++p)
+      for (std::size_t j = 0; j < recv_boundary[p].size(); ++j)
+        on_boundary[global_to_local[recv_boundary[p][j]]] = 1;
   }
 
-  // Iterate over all vertices
-  const std::size_t d = mesh.geometry().dim();
-  std::vector<double> xx(d);
+  // Partial sums of neighbour coordinates, neighbour counts and
+  // closest distances to the boundary of the star of each vertex
+  std::vector<double> xx(num_vertices*d);
+  std::vector<double> num_neighbors(num_vertices);
+  std::vector<double> rmin(num_vertices);
+  std::vector<double> x_new;
+
   for (std::size_t iteration = 0; iteration < num_iterations; iteration++)
   {
-    for (VertexIterator v(mesh); !v.end(); ++v)
+    // Compute local contributions from the current coordinates
+    const std::vector<double>& x
+      = static_cast<const MeshGeometry&>(mesh.geometry()).x();
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int32_t v = 0; v < num_vertices; ++v)
     {
       // Skip vertices on the boundary
-      if (on_boundary[*v])
+      if (on_boundary[v])
         continue;
 
-      // Get coordinates of vertex
-      const Point p = v->point();
-
-      // Compute center of mass of neighboring vertices
-      for (std::size_t i = 0; i < d; i++) xx[i] = 0.0;
-      std::size_t num_neighbors = 0;
-      for (EdgeIterator e(*v); !e.end(); ++e)
+      // Sum coordinates of neighboring vertices
+      const Vertex vertex(mesh, v);
+      double* sum = &xx[v*d];
+      std::fill(sum, sum + d, 0.0);
+      std::size_t count = 0;
+      for (EdgeIterator e(vertex); !e.end(); ++e)
       {
+        if (!count_edge[e->index()])
+          continue;
+
         // Get the other vertex
         dolfin_assert(e->num_entities(0) == 2);
         std::size_t other_index = e->entities(0)[0];
-        if (other_index == v->index())
+        if (other_index == (std::size_t) v)
           other_index = e->entities(0)[1];
 
-        // Create the vertex
-        Vertex vn(mesh, other_index);
-
-        // Skip the vertex itself
-        if (v->index() == vn.index())
-          continue;
-        num_neighbors += 1;
-
         // Compute center of mass
-        const double* xn = vn.x();
+        const double* xn = &x[other_index*d];
         for (std::size_t i = 0; i < d; i++)
-          xx[i] += xn[i];
+          sum[i] += xn[i];
+        count++;
       }
-      for (std::size_t i = 0; i < d; i++)
-        xx[i] /= static_cast<double>(num_neighbors);
+      num_neighbors[v] = count;
 
       // Compute closest distance to boundary of star
-      double rmin = 0.0;
-      for (CellIterator c(*v); !c.end(); ++c)
+      const Point p = vertex.point();
+      double r_star = std::numeric_limits<double>::max();
+      for (CellIterator c(vertex); !c.end(); ++c)
       {
         // Get local number of vertex relative to facet
-        const std::size_t local_vertex = c->index(*v);
+        const std::size_t local_vertex = c->index(vertex);
 
         // Get normal of corresponding facet
-        Point n = c->normal(local_vertex);
+        const Point n = c->normal(local_vertex);
 
         // Get first vertex in facet
-        Facet f(mesh, c->entities(mesh.topology().dim() - 1)[local_vertex]);
+        const Facet f(mesh, c->entities(D - 1)[local_vertex]);
         VertexIterator fv(f);
 
         // Compute length of projection of v - fv onto normal
-        const double r = std::abs(n.dot(p - fv->point()));
-        if (rmin == 0.0)
-          rmin = r;
-        else
-          rmin = std::min(rmin, r);
+        r_star = std::min(r_star, std::abs(n.dot(p - fv->point())));
       }
+      rmin[v] = r_star;
+    }
 
-      // Move vertex at most a distance rmin / 2
+    // Add up contributions to shared vertices from other processes
+    if (mpi_size > 1)
+    {
+      std::vector<std::vector<double>> send_values(mpi_size);
+      std::vector<std::vector<std::int64_t>> send_vertices(mpi_size);
+      for (std::map<std::int32_t, std::set<unsigned int>>::const_iterator
+             sv = shared_vertices.begin(); sv != shared_vertices.end(); ++sv)
+      {
+        const std::int32_t v = sv->first;
+        if (on_boundary[v])
+          continue;
+        for (std::set<unsigned int>::const_iterator p = sv->second.begin();
+             p != sv->second.end(); ++p)
+        {
+          send_vertices[*p].push_back(global_indices[v]);
+          send_values[*p].push_back(num_neighbors[v]);
+          send_values[*p].push_back(rmin[v]);
+          send_values[*p].insert(send_values[*p].end(), &xx[v*d],
+                                 &xx[v*d] + d);
+        }
+      }
+      std::vector<std::vector<std::int64_t>> recv_vertices;
+      std::vector<std::vector<double>> recv_values;
+      MPI::all_to_all(mpi_comm, send_vertices, recv_vertices);
+      MPI::all_to_all(mpi_comm, send_values, recv_values);
+      for (std::size_t p = 0; p < mpi_size; ++p)
+      {
+        for (std::size_t j = 0; j < recv_vertices[p].size(); ++j)
+        {
+          const std::int32_t v = global_to_local[recv_vertices[p][j]];
+          const double* values = &recv_values[p][j*(d + 2)];
+          num_neighbors[v] += values[0];
+          rmin[v] = std::min(rmin[v], values[1]);
+          for (std::size_t i = 0; i < d; ++i)
+            xx[v*d + i] += values[2 + i];
+        }
+      }
+    }
+
+    // Move owned vertices towards the center of mass of their
+    // neighbors
+    x_new = x;
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int32_t v = 0; v < num_vertices; ++v)
+    {
+      if (on_boundary[v] || !owned[v] || num_neighbors[v] == 0.0)
+        continue;
+
+      const double* p = &x[v*d];
       double r = 0.0;
       for (std::size_t i = 0; i < d; i++)
       {
-        const double dx = xx[i] - p[i];
+        const double dx = xx[v*d + i]/num_neighbors[v] - p[i];
         r += dx*dx;
       }
       r = std::sqrt(r);
       if (r < DOLFIN_EPS)
         continue;
-      rmin = std::min(0.5*rmin, r);
 
-      std::vector<double> new_vertex(mesh.geometry().x(v->index()),
-                                     mesh.geometry().x(v->index()) + d);
+      // Move vertex at most a distance rmin / 2
+      const double step = std::min(0.5*rmin[v], r);
       for (std::size_t i = 0; i < d; i++)
-        new_vertex[i] += rmin*(xx[i] - p[i])/r;
-      mesh.geometry().set(v->index(), new_vertex.data());
+        x_new[v*d + i] += step*(xx[v*d + i]/num_neighbors[v] - p[i])/r;
+    }
 
+    // Send new coordinates of shared vertices from their owners
+    if (mpi_size > 1)
+    {
+      std::vector<std::vector<double>> send_coordinates(mpi_size);
+      std::vector<std::vector<std::int64_t>> send_vertices(mpi_size);
+      for (std::map<std::int32_t, std::set<unsigned int>>::const_iterator
+             sv = shared_vertices.begin(); sv != shared_vertices.end(); ++sv)
+      {
+        const std::int32_t v = sv->first;
+        if (!owned[v] || on_boundary[v])
+          continue;
+        for (std::set<unsigned int>::const_iterator p = sv->second.begin();
+             p != sv->second.end(); ++p)
+        {
+          send_vertices[*p].push_back(global_indices[v]);
+          send_coordinates[*p].insert(send_coordinates[*p].end(),
+                                      &x_new[v*d], &x_new[v*d] + d);
+        }
+      }
+      std::vector<std::vector<std::int64_t>> recv_vertices;
+      std::vector<std::vector<double>> recv_coordinates;
+      MPI::all_to_all(mpi_comm, send_vertices, recv_vertices);
+      MPI::all_to_all(mpi_comm, send_coordinates, recv_coordinates);
+      for (std::size_t p = 0; p < mpi_size; ++p)
+      {
+        for (std::size_t j = 0; j < recv_vertices[p].size(); ++j)
+        {
+          const std::int32_t v = global_to_local[recv_vertices[p][j]];
+          std::copy(&recv_coordinates[p][j*d], &recv_coordinates[p][j*d] + d,
+                    &x_new[v*d]);
+        }
+      }
     }
+
+    // Update coordinates
+    mesh.geometry().x() = x_new;
   }
 
   if (num_iterations > 1)
@@ -28,7 +28,7 @@
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-MeshTopology::MeshTopology()
+MeshTopology::MeshTopology() : _state(0)
 {
   // Do nothing
 }
@@ -39,7 +39,7 @@ MeshTopology::MeshTopology(const MeshTopology& topology)
     global_num_entities(topology.global_num_entities),
     _global_indices(topology._global_indices),
     _shared_entities(topology._shared_entities),
-    connectivity(topology.connectivity)
+    connectivity(topology.connectivity), _state(0)
 {
   // Do nothing
 }
@@ -61,6 +61,7 @@ MeshTopology& MeshTopology::operator= (const MeshTopology& topology)
   _global_indices = topology._global_indices;
   _shared_entities = topology._shared_entities;
   connectivity = topology.connectivity;
+  ++_state;
 
   return *this;
 }
@@ -107,12 +108,15 @@ void MeshTopology::clear()
   _global_indices.clear();
   _shared_entities.clear();
   connectivity.clear();
+  ++_state;
 }
 //-----------------------------------------------------------------------------
 void MeshTopology::clear(std::size_t d0, std::size_t d1)
 {
   dolfin_assert(d0 < connectivity.size());
   dolfin_assert(d1 < connectivity[d0].size());
+  if (d1 == 0 && !connectivity[d0][d1].empty())
+    ++_state;
   connectivity[d0][d1].clear();
 }
 //-----------------------------------------------------------------------------
@@ -140,6 +144,8 @@ void MeshTopology::init(std::size_t dim, std::size_t local_size,
                         std::size_t global_size)
 {
   dolfin_assert(dim < num_entities.size());
+  if (num_entities[dim] != 0)
+    ++_state;
   num_entities[dim] = local_size;
 
   dolfin_assert(dim < global_num_entities.size());
@@ -160,8 +166,10 @@ void MeshTopology::init_ghost(std::size_t dim, std::size_t index)
 void MeshTopology::init_global_indices(std::size_t dim, std::size_t size)
 {
   dolfin_assert(dim < _global_indices.size());
+  if (!_global_indices[dim].empty())
+    ++_state;
   _global_indices[dim]
-    = std::vector<std::int64_t>(size, -1);
+    = std::vector<dolfin::global_index>(size, -1);
 }
 //-----------------------------------------------------------------------------
 dolfin::MeshConnectivity& MeshTopology::operator() (std::size_t d0,
@@ -169,6 +177,8 @@ dolfin::MeshConnectivity& MeshTopology::operator() (std::size_t d0,
 {
   dolfin_assert(d0 < connectivity.size());
   dolfin_assert(d1 < connectivity[d0].size());
+  if (d1 == 0 && !connectivity[d0][d1].empty())
+    ++_state;
   return connectivity[d0][d1];
 }
 //-----------------------------------------------------------------------------
@@ -205,6 +215,28 @@ size_t MeshTopology::hash() const
   return (*this)(dim(), 0).hash();
 }
 //-----------------------------------------------------------------------------
+std::size_t MeshTopology::memory_usage() const
+{
+  std::size_t bytes = sizeof(*this)
+    + num_entities.capacity()*sizeof(unsigned int)
+    + ghost_offset_index.capacity()*sizeof(std::size_t)
+    + global_num_entities.capacity()*sizeof(std::size_t)
+    + _cell_owner.capacity()*sizeof(unsigned int);
+  for (auto& indices : _global_indices)
+    bytes += indices.capacity()*sizeof(dolfin::global_index);
+  for (auto& c : connectivity)
+    for (auto& connections : c)
+      bytes += connections.memory_usage();
+  return bytes;
+}
+//-----------------------------------------------------------------------------
+void MeshTopology::compress(bool encode)
+{
+  for (auto& c : connectivity)
+    for (auto& connections : c)
+      connections.compress(encode);
+}
+//-----------------------------------------------------------------------------
 std::string MeshTopology::str(bool verbose) const
 {
   const std::size_t _dim = num_entities.size() - 1;
@@ -25,6 +25,7 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include <dolfin/common/types.h>
 #include "MeshConnectivity.h"
 
 namespace dolfin
@@ -93,16 +94,27 @@ namespace dolfin
     /// Set global index for entity of dimension dim and with local
     /// index
     void set_global_index(std::size_t dim, std::size_t local_index,
-                          std::int64_t global_index)
+                          dolfin::global_index global_index)
     {
       dolfin_assert(dim < _global_indices.size());
       dolfin_assert(local_index < _global_indices[dim].size());
       _global_indices[dim][local_index] = global_index;
     }
 
+    /// Set global indices for all entities of dimension dim, taking
+    /// over the given array (of length size(dim))
+    void set_global_indices(std::size_t dim,
+                            std::vector<dolfin::global_index> global_indices)
+    {
+      dolfin_assert(dim < _global_indices.size());
+      dolfin_assert(global_indices.size() == _global_indices[dim].size());
+      _global_indices[dim].swap(global_indices);
+    }
+
     /// Get local-to-global index map for entities of topological
     /// dimension d
-    const std::vector<std::int64_t>& global_indices(std::size_t d) const
+    const std::vector<dolfin::global_index>&
+      global_indices(std::size_t d) const
     {
       dolfin_assert(d < _global_indices.size());
       return _global_indices[d];
@@ -143,7 +155,10 @@ namespace dolfin
     const std::vector<unsigned int>& cell_owner() const
     { return _cell_owner;  }
 
-    /// Return connectivity for given pair of topological dimensions
+    /// Return connectivity for given pair of topological
+    /// dimensions. Since the entity-vertex connectivity may be
+    /// changed through the returned reference, accessing a non-empty
+    /// (d0, 0) connectivity counts as a change of state.
     dolfin::MeshConnectivity& operator() (std::size_t d0, std::size_t d1);
 
     /// Return connectivity for given pair of topological dimensions
@@ -153,6 +168,32 @@ namespace dolfin
     /// Return hash based on the hash of cell-vertex connectivity
     size_t hash() const;
 
+    /// Return state counter of topology. The counter is increased
+    /// whenever existing topology data (entity numbers, entity-vertex
+    /// connectivity or global indices) is (or may be) changed, and
+    /// can be used to detect modified meshes. Computing connectivity
+    /// that was not present before does not change the state. Unlike
+    /// hash(), this requires no computation or communication.
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The state counter.
+    std::size_t state() const
+    { return _state; }
+
+    /// Return estimate of memory used on this process in bytes,
+    /// including all computed connectivities
+    std::size_t memory_usage() const;
+
+    /// Compress storage of all computed connectivities (see
+    /// MeshConnectivity::compress). This does not change the state.
+    ///
+    /// *Arguments*
+    ///     encode (bool)
+    ///         Encode connectivities with varying number of
+    ///         connections per entity.
+    void compress(bool encode=false);
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
@@ -182,7 +223,7 @@ namespace dolfin
     std::vector<std::size_t> global_num_entities;
 
     // Global indices for mesh entities (empty if not set)
-    std::vector<std::vector<std::int64_t> > _global_indices;
+    std::vector<std::vector<dolfin::global_index>> _global_indices;
 
     // For entities of a given dimension d , maps each shared entity
     // (local index) to a list of the processes sharing the vertex
@@ -197,6 +238,9 @@ namespace dolfin
     // Connectivity for pairs of topological dimensions
     std::vector<std::vector<MeshConnectivity> > connectivity;
 
+    // State counter, increased on any change of existing topology data
+    std::size_t _state;
+
   };
 
 }
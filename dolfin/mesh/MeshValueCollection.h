@@ -23,9 +23,12 @@
 #ifndef __MESH_VALUE_COLLECTION_H
 #define __MESH_VALUE_COLLECTION_H
 
+#include <algorithm>
 #include <map>
+#include <numeric>
 #include <utility>
 #include <memory>
+#include <vector>
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/common/Variable.h>
 #include <dolfin/log/log.h>
@@ -45,6 +48,12 @@ namespace dolfin
   /// entities through the corresponding cell index and local entity
   /// number (relative to the cell), not by global entity index, which
   /// means that data may be stored robustly to file.
+  ///
+  /// Values are stored as parallel arrays of (cell index, local
+  /// entity) positions and values, sorted by position. Large
+  /// collections should be built with append() followed by
+  /// finalize(), which sorts and removes duplicate positions once,
+  /// rather than with repeated calls to set_value().
 
   template <typename T>
   class MeshValueCollection : public Variable
@@ -171,6 +180,41 @@ namespace dolfin
     ///         an existing value.
     bool set_value(std::size_t entity_index, const T& value);
 
+    /// Append marker value for given entity defined by a cell index
+    /// and a local entity index, without sorting. The collection is
+    /// sorted by the next call to finalize(), or by any function
+    /// accessing the values. If a position is appended more than
+    /// once, the last value appended is kept.
+    ///
+    /// @param    cell_index (std::size_t)
+    ///         The index of the cell.
+    /// @param    local_entity (std::size_t)
+    ///         The local index of the entity relative to the cell.
+    /// @param    value (T)
+    ///         The value of the marker.
+    void append(std::size_t cell_index, std::size_t local_entity,
+                const T& value);
+
+    /// Append value for given entity index, without sorting (see
+    /// append(cell_index, local_entity, value))
+    ///
+    /// @param    entity_index (std::size_t)
+    ///         Index of the entity.
+    /// @param    value (T).
+    ///         The value of the marker.
+    void append(std::size_t entity_index, const T& value);
+
+    /// Reserve storage for a number of values
+    ///
+    /// @param    n (std::size_t)
+    ///         The number of values.
+    void reserve(std::size_t n);
+
+    /// Sort values added by append() and remove duplicate positions.
+    /// This is called on demand by functions accessing the values,
+    /// but may be called explicitly to control when the work is done.
+    void finalize() const;
+
     /// Get marker value for given entity defined by a cell index and
     /// a local entity index
     ///
@@ -183,13 +227,21 @@ namespace dolfin
     ///         The value of the marker.
     T get_value(std::size_t cell_index, std::size_t local_entity);
 
-    /// Get all values
+    /// Get all entity positions, sorted
     ///
-    /// @return    std::map<std::pair<std::size_t, std::size_t>, T>
-    ///         A map from positions to values.
-    std::map<std::pair<std::size_t, std::size_t>, T>& values();
+    /// @return    std::vector<std::pair<std::size_t, std::size_t>>
+    ///         The (cell index, local entity) positions.
+    const std::vector<std::pair<std::size_t, std::size_t>>& entities() const;
+
+    /// Get all values, in the order of entities()
+    ///
+    /// @return    std::vector<T>
+    ///         The values.
+    const std::vector<T>& entity_values() const;
 
-    /// Get all values (const version)
+    /// Get all values as a map. The map is a copy of the data, built
+    /// on first call and rebuilt after the collection is modified;
+    /// prefer entities() and entity_values() for large collections.
     ///
     /// @return    std::map<std::pair<std::size_t, std::size_t>, T>
     ///         A map from positions to values.
@@ -209,14 +261,39 @@ namespace dolfin
 
   private:
 
+    // Compute (cell index, local entity) position of entity
+    std::pair<std::size_t, std::size_t>
+      entity_position(std::size_t entity_index) const;
+
+    // Order of array entries by position
+    struct PositionLess
+    {
+      explicit PositionLess(const std::vector<std::pair<std::size_t,
+                            std::size_t>>& positions)
+        : positions(positions) {}
+
+      bool operator()(std::size_t i, std::size_t j) const
+      { return positions[i] < positions[j]; }
+
+      const std::vector<std::pair<std::size_t, std::size_t>>& positions;
+    };
+
     // Associated mesh
     std::shared_ptr<const Mesh> _mesh;
 
     // Topological dimension
     int _dim;
 
-    // The values
-    std::map<std::pair<std::size_t, std::size_t>, T> _values;
+    // Entity positions and values. Entries [0, _num_sorted) are
+    // sorted and unique, later entries have been appended (mutable
+    // to allow sorting on access)
+    mutable std::vector<std::pair<std::size_t, std::size_t>> _entities;
+    mutable std::vector<T> _data;
+    mutable std::size_t _num_sorted;
+
+    // Map built by values()
+    mutable std::map<std::pair<std::size_t, std::size_t>, T> _values;
+    mutable bool _values_valid;
 
   };
 
@@ -225,14 +302,16 @@ namespace dolfin
   //---------------------------------------------------------------------------
   template <typename T>
   MeshValueCollection<T>::MeshValueCollection()
-    : Variable("m", "unnamed MeshValueCollection"), _dim(-1)
+    : Variable("m", "unnamed MeshValueCollection"), _dim(-1),
+      _num_sorted(0), _values_valid(false)
   {
     // Do nothing
   }
   //---------------------------------------------------------------------------
   template <typename T>
   MeshValueCollection<T>::MeshValueCollection(std::shared_ptr<const Mesh>
-                                              mesh) : _mesh(mesh), _dim(-1)
+                                              mesh)
+    : _mesh(mesh), _dim(-1), _num_sorted(0), _values_valid(false)
   {
     // Do nothing
   }
@@ -240,7 +319,8 @@ namespace dolfin
   template <typename T>
   MeshValueCollection<T>::MeshValueCollection(std::shared_ptr<const Mesh>
                                               mesh, std::size_t dim)
-    : Variable("m", "unnamed MeshValueCollection"), _mesh(mesh), _dim(dim)
+    : Variable("m", "unnamed MeshValueCollection"), _mesh(mesh), _dim(dim),
+      _num_sorted(0), _values_valid(false)
   {
     // Do nothing
   }
@@ -249,7 +329,7 @@ namespace dolfin
   MeshValueCollection<T>::MeshValueCollection(const MeshFunction<T>&
                                               mesh_function)
     : Variable("m", "unnamed MeshValueCollection"), _mesh(mesh_function.mesh()),
-      _dim(mesh_function.dim())
+      _dim(mesh_function.dim()), _num_sorted(0), _values_valid(false)
   {
     dolfin_assert(_mesh);
     const std::size_t D = _mesh->topology().dim();
@@ -260,8 +340,7 @@ namespace dolfin
       for (std::size_t cell_index = 0; cell_index < mesh_function.size();
            ++cell_index)
       {
-        const std::pair<std::size_t, std::size_t> key(cell_index, 0);
-        _values.insert({key, mesh_function[cell_index]});
+        append(cell_index, 0, mesh_function[cell_index]);
       }
     }
     else
@@ -283,10 +362,7 @@ namespace dolfin
           // Find the local entity index
           const std::size_t local_entity = cell.index(entity);
 
-          // Insert into map
-          const std::pair<std::size_t, std::size_t> key(cell.index(),
-                                                        local_entity);
-          _values.insert({key, mesh_function[entity_index]});
+          append(cell.index(), local_entity, mesh_function[entity_index]);
         }
       }
     }
@@ -296,7 +372,7 @@ namespace dolfin
     MeshValueCollection<T>::MeshValueCollection(std::shared_ptr<const Mesh> mesh,
                                                 const std::string filename)
     : Variable("m", "unnamed MeshValueCollection"),
-      _mesh(mesh), _dim(-1)
+      _mesh(mesh), _dim(-1), _num_sorted(0), _values_valid(false)
   {
     File file(filename);
     file >> *this;
@@ -309,6 +385,7 @@ namespace dolfin
   {
     _mesh = mesh_function.mesh();
     _dim = mesh_function.dim();
+    clear();
 
     dolfin_assert(_mesh);
     const std::size_t D = _mesh->topology().dim();
@@ -321,8 +398,7 @@ namespace dolfin
       for (std::size_t cell_index = 0; cell_index < mesh_function.size();
            ++cell_index)
       {
-        const std::pair<std::size_t, std::size_t> key(cell_index, 0);
-        _values.insert({key, mesh_function[cell_index]});
+        append(cell_index, 0, mesh_function[cell_index]);
       }
     }
     else
@@ -344,10 +420,7 @@ namespace dolfin
           // Find the local entity index
           const std::size_t local_entity = cell.index(entity);
 
-          // Insert into map
-          const std::pair<std::size_t, std::size_t> key(cell.index(),
-                                                        local_entity);
-          _values.insert({key, mesh_function[entity_index]});
+          append(cell.index(), local_entity, mesh_function[entity_index]);
         }
       }
     }
@@ -360,9 +433,14 @@ namespace dolfin
   MeshValueCollection<T>::operator=(const MeshValueCollection<T>&
                                     mesh_value_collection)
   {
+    mesh_value_collection.finalize();
     _mesh = mesh_value_collection._mesh;
     _dim = mesh_value_collection.dim();
-    _values = mesh_value_collection.values();
+    _entities = mesh_value_collection._entities;
+    _data = mesh_value_collection._data;
+    _num_sorted = mesh_value_collection._num_sorted;
+    _values.clear();
+    _values_valid = false;
 
     return *this;
   }
@@ -374,7 +452,7 @@ namespace dolfin
     mesh->init(dim);
     _mesh = mesh;
     _dim = dim;
-    _values.clear();
+    clear();
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -395,13 +473,14 @@ namespace dolfin
   template <typename T>
   bool MeshValueCollection<T>::empty() const
   {
-    return _values.empty();
+    return _entities.empty();
   }
   //---------------------------------------------------------------------------
   template <typename T>
   std::size_t MeshValueCollection<T>::size() const
   {
-    return _values.size();
+    finalize();
+    return _entities.size();
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -424,74 +503,112 @@ namespace dolfin
                    "A mesh has not been associated with this MeshValueCollection");
     }
 
+    finalize();
+    _values_valid = false;
+
+    // Find position in sorted arrays
     const std::pair<std::size_t, std::size_t> pos(cell_index, local_entity);
-    std::pair<typename std::map<std::pair<std::size_t, std::size_t>, T>::iterator, bool>
-      it = _values.insert({pos, value});
+    const auto it = std::lower_bound(_entities.begin(), _entities.end(), pos);
+    const std::size_t i = it - _entities.begin();
 
-    // If an item with same key already exists the value has not been
-    // set and we need to update it
-    if (!it.second)
-      it.first->second = value;
+    // If an item with same key already exists we need to update it
+    if (it != _entities.end() && *it == pos)
+    {
+      _data[i] = value;
+      return false;
+    }
 
-    return it.second;
+    _entities.insert(it, pos);
+    _data.insert(_data.begin() + i, value);
+    ++_num_sorted;
+
+    return true;
   }
   //---------------------------------------------------------------------------
   template <typename T>
   bool MeshValueCollection<T>::set_value(std::size_t entity_index,
                                          const T& value)
   {
+    const std::pair<std::size_t, std::size_t> pos
+      = entity_position(entity_index);
+    return set_value(pos.first, pos.second, value);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void MeshValueCollection<T>::append(std::size_t cell_index,
+                                      std::size_t local_entity,
+                                      const T& value)
+  {
+    dolfin_assert(_dim >= 0);
     if (!_mesh)
     {
       dolfin_error("MeshValueCollection.h",
-                   "set value",
+                   "append value",
                    "A mesh has not been associated with this MeshValueCollection");
     }
 
-    dolfin_assert(_dim >= 0);
+    const std::pair<std::size_t, std::size_t> pos(cell_index, local_entity);
 
-    // Special case when d = D
-    const std::size_t D = _mesh->topology().dim();
-    if (_dim == (int) D)
+    // Values appended in increasing order keep the arrays sorted
+    if (_num_sorted == _entities.size()
+        && (_entities.empty() || _entities.back() < pos))
     {
-      // Set local entity index to zero when we mark a cell
-      const std::pair<std::size_t, std::size_t> pos(entity_index, 0);
-      std::pair<typename std::map<std::pair<std::size_t,
-        std::size_t>, T>::iterator, bool> it;
-      it = _values.insert({pos, value});
-
-      // If an item with same key already exists the value has not been
-      // set and we need to update it
-      if (!it.second)
-        it.first->second = value;
-
-      return it.second;
+      ++_num_sorted;
     }
 
-    // Get mesh connectivity d --> D
-    _mesh->init(_dim, D);
-    const MeshConnectivity& connectivity = _mesh->topology()(_dim, D);
-
-    // Find the cell
-    dolfin_assert(!connectivity.empty());
-    dolfin_assert(connectivity.size(entity_index) > 0);
-    const MeshEntity entity(*_mesh, _dim, entity_index);
-    const Cell cell(*_mesh, connectivity(entity_index)[0]); // choose first
-
-    // Find the local entity index
-    const std::size_t local_entity = cell.index(entity);
-
-    // Add value
-    const std::pair<std::size_t, std::size_t> pos(cell.index(), local_entity);
-    std::pair<typename std::map<std::pair<std::size_t,
-      std::size_t>, T>::iterator, bool> it;
-    it = _values.insert({pos, value});
-
-    // If an item with same key already exists the value has not been
-    // set and we need to update it
-    if (!it.second)
-      it.first->second = value;
+    _entities.push_back(pos);
+    _data.push_back(value);
+    _values_valid = false;
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void MeshValueCollection<T>::append(std::size_t entity_index,
+                                      const T& value)
+  {
+    const std::pair<std::size_t, std::size_t> pos
+      = entity_position(entity_index);
+    append(pos.first, pos.second, value);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void MeshValueCollection<T>::reserve(std::size_t n)
+  {
+    _entities.reserve(n);
+    _data.reserve(n);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void MeshValueCollection<T>::finalize() const
+  {
+    if (_num_sorted == _entities.size())
+      return;
+
+    // Sort entry order by position. The sort is stable, so of
+    // entries with the same position the last appended comes last.
+    std::vector<std::size_t> order(_entities.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), PositionLess(_entities));
+
+    // Copy to sorted arrays, keeping the last value for each position
+    std::vector<std::pair<std::size_t, std::size_t>> entities;
+    std::vector<T> data;
+    entities.reserve(order.size());
+    data.reserve(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+      const std::size_t j = order[i];
+      if (!entities.empty() && entities.back() == _entities[j])
+        data.back() = _data[j];
+      else
+      {
+        entities.push_back(_entities[j]);
+        data.push_back(_data[j]);
+      }
+    }
 
-    return it.second;
+    _entities.swap(entities);
+    _data.swap(data);
+    _num_sorted = _entities.size();
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -499,13 +616,11 @@ namespace dolfin
 				      std::size_t local_entity)
   {
     dolfin_assert(_dim >= 0);
+    finalize();
 
     const std::pair<std::size_t, std::size_t> pos(cell_index, local_entity);
-    const typename std::map<std::pair<std::size_t,
-      std::size_t>, T>::const_iterator
-      it = _values.find(pos);
-
-    if (it == _values.end())
+    const auto it = std::lower_bound(_entities.begin(), _entities.end(), pos);
+    if (it == _entities.end() || *it != pos)
     {
       dolfin_error("MeshValueCollection.h",
                    "extract value",
@@ -513,27 +628,84 @@ namespace dolfin
                    cell_index, local_entity);
     }
 
-    return it->second;
+    return _data[it - _entities.begin()];
   }
   //---------------------------------------------------------------------------
   template <typename T>
-  std::map<std::pair<std::size_t, std::size_t>, T>&
-    MeshValueCollection<T>::values()
+  const std::vector<std::pair<std::size_t, std::size_t>>&
+  MeshValueCollection<T>::entities() const
   {
-    return _values;
+    finalize();
+    return _entities;
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  const std::vector<T>& MeshValueCollection<T>::entity_values() const
+  {
+    finalize();
+    return _data;
   }
   //---------------------------------------------------------------------------
   template <typename T>
   const std::map<std::pair<std::size_t, std::size_t>, T>&
   MeshValueCollection<T>::values() const
   {
+    finalize();
+    if (!_values_valid)
+    {
+      // Entries are sorted, so insert with hint at end
+      _values.clear();
+      for (std::size_t i = 0; i < _entities.size(); ++i)
+        _values.insert(_values.end(), {_entities[i], _data[i]});
+      _values_valid = true;
+    }
+
     return _values;
   }
   //---------------------------------------------------------------------------
   template <typename T>
   void MeshValueCollection<T>::clear()
   {
+    _entities.clear();
+    _data.clear();
+    _num_sorted = 0;
     _values.clear();
+    _values_valid = false;
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  std::pair<std::size_t, std::size_t>
+  MeshValueCollection<T>::entity_position(std::size_t entity_index) const
+  {
+    if (!_mesh)
+    {
+      dolfin_error("MeshValueCollection.h",
+                   "set value",
+                   "A mesh has not been associated with this MeshValueCollection");
+    }
+
+    dolfin_assert(_dim >= 0);
+
+    // Special case when d = D: set local entity index to zero when we
+    // mark a cell
+    const std::size_t D = _mesh->topology().dim();
+    if (_dim == (int) D)
+      return std::make_pair(entity_index, 0);
+
+    // Get mesh connectivity d --> D
+    _mesh->init(_dim, D);
+    const MeshConnectivity& connectivity = _mesh->topology()(_dim, D);
+
+    // Find the cell
+    dolfin_assert(!connectivity.empty());
+    dolfin_assert(connectivity.size(entity_index) > 0);
+    const MeshEntity entity(*_mesh, _dim, entity_index);
+    const Cell cell(*_mesh, connectivity(entity_index)[0]); // choose first
+
+    // Find the local entity index
+    const std::size_t local_entity = cell.index(entity);
+
+    return std::make_pair(cell.index(), local_entity);
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -20,10 +20,12 @@
 // First added:  2013-08-05
 // Last changed: 2016-03-02
 
+#include <algorithm>
 #include <cmath>
 
 #include <dolfin/log/log.h>
 #include <dolfin/common/NoDeleter.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/geometry/SimplexQuadrature.h>
 #include "Cell.h"
@@ -35,13 +37,14 @@
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-MultiMesh::MultiMesh()
+MultiMesh::MultiMesh() : _quadrature_order(2)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 MultiMesh::MultiMesh(std::vector<std::shared_ptr<const Mesh>> meshes,
                      std::size_t quadrature_order)
+  : _quadrature_order(quadrature_order)
 {
   // Add and build
   for (auto mesh : meshes)
@@ -51,6 +54,7 @@ MultiMesh::MultiMesh(std::vector<std::shared_ptr<const Mesh>> meshes,
 //-----------------------------------------------------------------------------
 MultiMesh::MultiMesh(std::shared_ptr<const Mesh> mesh_0,
                      std::size_t quadrature_order)
+  : _quadrature_order(quadrature_order)
 {
   // Add and build
   add(mesh_0);
@@ -60,6 +64,7 @@ MultiMesh::MultiMesh(std::shared_ptr<const Mesh> mesh_0,
 MultiMesh::MultiMesh(std::shared_ptr<const Mesh> mesh_0,
                      std::shared_ptr<const Mesh> mesh_1,
                      std::size_t quadrature_order)
+  : _quadrature_order(quadrature_order)
 {
   // Add and build
   add(mesh_0);
@@ -71,6 +76,7 @@ MultiMesh::MultiMesh(std::shared_ptr<const Mesh> mesh_0,
                      std::shared_ptr<const Mesh> mesh_1,
                      std::shared_ptr<const Mesh> mesh_2,
                      std::size_t quadrature_order)
+  : _quadrature_order(quadrature_order)
 {
   // Add and build
   add(mesh_0);
@@ -129,36 +135,139 @@ MultiMesh::quadrature_rule_cut_cells(std::size_t part) const
 
 {
   dolfin_assert(part < num_parts());
-  return _quadrature_rules_cut_cells[part];
+
+  // Build map from flat storage if necessary
+  auto& qr = _quadrature_rules_cut_cells[part];
+  const MultiMeshQuadratureRules& rules = _flat_quadrature_rules_cut_cells[part];
+  if (qr.empty() and rules.size() > 0)
+  {
+    const std::size_t gdim = _meshes[part]->geometry().dim();
+    for (std::size_t c = 0; c < rules.size(); ++c)
+      qr[_cut_cells[part][c]] = _extract_quadrature_rule(rules, c, gdim);
+  }
+
+  return qr;
 }
 //-----------------------------------------------------------------------------
 quadrature_rule
 MultiMesh::quadrature_rule_cut_cell(std::size_t part,
                                     unsigned int cell_index) const
 {
-  auto q = quadrature_rule_cut_cells(part);
-  return q[cell_index];
+  dolfin_assert(part < num_parts());
+
+  // Find cell in (sorted) list of cut cells
+  const std::vector<unsigned int>& cut_cells = _cut_cells[part];
+  auto it = std::lower_bound(cut_cells.begin(), cut_cells.end(), cell_index);
+  if (it == cut_cells.end() or *it != cell_index)
+    return quadrature_rule();
+
+  const std::size_t gdim = _meshes[part]->geometry().dim();
+  return _extract_quadrature_rule(_flat_quadrature_rules_cut_cells[part],
+                                  it - cut_cells.begin(), gdim);
 }
 //-----------------------------------------------------------------------------
 const std::map<unsigned int, std::vector<quadrature_rule>>&
   MultiMesh::quadrature_rule_overlap(std::size_t part) const
 {
   dolfin_assert(part < num_parts());
-  return _quadrature_rules_overlap[part];
+
+  // Build map from flat storage if necessary
+  auto& qr = _quadrature_rules_overlap[part];
+  const MultiMeshQuadratureRules& rules = _flat_quadrature_rules_overlap[part];
+  if (qr.empty() and rules.size() > 0)
+  {
+    const std::size_t gdim = _meshes[part]->geometry().dim();
+    std::size_t k = 0;
+    const auto& cmap = collision_map_cut_cells(part);
+    for (auto it = cmap.begin(); it != cmap.end(); ++it)
+    {
+      std::vector<quadrature_rule>& cell_qr = qr[it->first];
+      for (std::size_t j = 0; j < it->second.size(); ++j)
+        cell_qr.push_back(_extract_quadrature_rule(rules, k++, gdim));
+    }
+  }
+
+  return qr;
 }
 //-----------------------------------------------------------------------------
 const std::map<unsigned int, std::vector<quadrature_rule>>&
   MultiMesh::quadrature_rule_interface(std::size_t part) const
 {
   dolfin_assert(part < num_parts());
-  return _quadrature_rules_interface[part];
+
+  // Build map from flat storage if necessary
+  auto& qr = _quadrature_rules_interface[part];
+  const MultiMeshQuadratureRules& rules = _flat_quadrature_rules_interface[part];
+  if (qr.empty() and rules.size() > 0)
+  {
+    const std::size_t gdim = _meshes[part]->geometry().dim();
+    std::size_t k = 0;
+    const auto& cmap = collision_map_cut_cells(part);
+    for (auto it = cmap.begin(); it != cmap.end(); ++it)
+    {
+      std::vector<quadrature_rule>& cell_qr = qr[it->first];
+      for (std::size_t j = 0; j < it->second.size(); ++j)
+        cell_qr.push_back(_extract_quadrature_rule(rules, k++, gdim));
+    }
+  }
+
+  return qr;
 }
 //-----------------------------------------------------------------------------
 const std::map<unsigned int, std::vector<std::vector<double>>>&
   MultiMesh::facet_normals(std::size_t part) const
 {
   dolfin_assert(part < num_parts());
-  return _facet_normals[part];
+
+  // Build map from flat storage if necessary
+  auto& n = _facet_normals[part];
+  const MultiMeshQuadratureRules& rules = _flat_quadrature_rules_interface[part];
+  if (n.empty() and rules.size() > 0)
+  {
+    const std::size_t gdim = _meshes[part]->geometry().dim();
+    std::size_t k = 0;
+    const auto& cmap = collision_map_cut_cells(part);
+    for (auto it = cmap.begin(); it != cmap.end(); ++it)
+    {
+      std::vector<std::vector<double>>& cell_n = n[it->first];
+      for (std::size_t j = 0; j < it->second.size(); ++j, ++k)
+      {
+        cell_n.push_back(std::vector<double>(
+                           rules.normals.begin() + gdim*rules.offsets[k],
+                           rules.normals.begin() + gdim*rules.offsets[k + 1]));
+      }
+    }
+  }
+
+  return n;
+}
+//-----------------------------------------------------------------------------
+const MultiMeshQuadratureRules&
+MultiMesh::flat_quadrature_rules_cut_cells(std::size_t part) const
+{
+  dolfin_assert(part < num_parts());
+  return _flat_quadrature_rules_cut_cells[part];
+}
+//-----------------------------------------------------------------------------
+const MultiMeshQuadratureRules&
+MultiMesh::flat_quadrature_rules_extended_cut_cells(std::size_t part) const
+{
+  dolfin_assert(part < num_parts());
+  return _flat_quadrature_rules_extended_cut_cells[part];
+}
+//-----------------------------------------------------------------------------
+const MultiMeshQuadratureRules&
+MultiMesh::flat_quadrature_rules_overlap(std::size_t part) const
+{
+  dolfin_assert(part < num_parts());
+  return _flat_quadrature_rules_overlap[part];
+}
+//-----------------------------------------------------------------------------
+const MultiMeshQuadratureRules&
+MultiMesh::flat_quadrature_rules_interface(std::size_t part) const
+{
+  dolfin_assert(part < num_parts());
+  return _flat_quadrature_rules_interface[part];
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<const BoundingBoxTree>
@@ -185,6 +294,7 @@ void MultiMesh::add(std::shared_ptr<const Mesh> mesh)
 void MultiMesh::build(std::size_t quadrature_order)
 {
   begin(PROGRESS, "Building multimesh.");
+  _quadrature_order = quadrature_order;
 
   // Build boundary meshes
   _build_boundary_meshes();
@@ -209,6 +319,117 @@ void MultiMesh::build(std::size_t quadrature_order)
   end();
 }
 //-----------------------------------------------------------------------------
+void MultiMesh::update(std::size_t part)
+{
+  if (part >= num_parts())
+  {
+    dolfin_error("MultiMesh.cpp",
+                 "update multimesh",
+                 "Part %d does not exist, multimesh has %d part(s)",
+                 part, num_parts());
+  }
+
+  // Build from scratch if not built
+  if (_trees.size() != num_parts()
+      or _domain_collisions.size() != num_parts())
+  {
+    build(_quadrature_order);
+    return;
+  }
+
+  begin(PROGRESS, "Updating multimesh for moved part %d.", part);
+
+  // Update coordinates of boundary mesh and refit bounding box trees
+  const Mesh& mesh = *_meshes[part];
+  BoundaryMesh& boundary_mesh = *_boundary_meshes[part];
+  const std::size_t gdim = mesh.geometry().dim();
+  const MeshFunction<std::size_t>& vertex_map = boundary_mesh.entity_map(0);
+  std::vector<double>& x = boundary_mesh.geometry().x();
+  for (std::size_t v = 0; v < vertex_map.size(); ++v)
+  {
+    const double* y = mesh.geometry().x(vertex_map[v]);
+    std::copy(y, y + gdim, x.begin() + v*gdim);
+  }
+  _trees[part]->refit();
+  if (boundary_mesh.num_vertices() > 0)
+    _boundary_trees[part]->refit();
+
+  // Save quadrature rules of parts with cut cells that may change
+  // (the moved part and the parts below it)
+  std::vector<PreviousRules> previous(num_parts());
+  std::vector<std::vector<unsigned int>> previous_cut_cells(num_parts());
+  std::vector<std::map<unsigned int,
+                       std::vector<std::pair<std::size_t, unsigned int>>>>
+    previous_collision_maps(num_parts());
+  for (std::size_t i = 0; i < num_parts(); ++i)
+  {
+    previous[i].rebuild = i <= part;
+    if (!previous[i].rebuild)
+      continue;
+
+    previous_cut_cells[i].swap(_cut_cells[i]);
+    previous_collision_maps[i].swap(_collision_maps_cut_cells[i]);
+    previous[i].overlap_offsets.assign(1, 0);
+    for (auto it = previous_collision_maps[i].begin();
+         it != previous_collision_maps[i].end(); ++it)
+    {
+      previous[i].overlap_offsets.push_back(previous[i].overlap_offsets.back()
+                                            + it->second.size());
+    }
+    std::swap(previous[i].rules_cut_cells, _flat_quadrature_rules_cut_cells[i]);
+    std::swap(previous[i].rules_overlap, _flat_quadrature_rules_overlap[i]);
+    std::swap(previous[i].rules_interface,
+              _flat_quadrature_rules_interface[i]);
+  }
+
+  // Recompute collisions involving the moved part
+  for (std::size_t i = 0; i < part; ++i)
+    _compute_collisions(i, part);
+  for (std::size_t j = part + 1; j < num_parts(); ++j)
+    _compute_collisions(part, j);
+  for (std::size_t i = 0; i <= part; ++i)
+    _build_collision_map(i);
+
+  // Find cut cells in the parts below the moved part whose cutting
+  // cells did not change and do not belong to the moved part
+  std::size_t num_reused = 0;
+  for (std::size_t i = 0; i <= part; ++i)
+  {
+    const auto& cmap = _collision_maps_cut_cells[i];
+    previous[i].cut_cells.assign(cmap.size(), -1);
+    if (i == part)
+      continue;
+
+    const std::vector<unsigned int>& old_cut_cells = previous_cut_cells[i];
+    const auto& old_cmap = previous_collision_maps[i];
+    std::size_t c = 0;
+    for (auto it = cmap.begin(); it != cmap.end(); ++it, ++c)
+    {
+      auto old_it = old_cmap.find(it->first);
+      if (old_it == old_cmap.end() or old_it->second != it->second)
+        continue;
+
+      bool moved = false;
+      for (std::size_t k = 0; k < it->second.size(); ++k)
+        moved = moved or it->second[k].first == part;
+      if (moved)
+        continue;
+
+      previous[i].cut_cells[c]
+        = std::lower_bound(old_cut_cells.begin(), old_cut_cells.end(),
+                           it->first) - old_cut_cells.begin();
+      ++num_reused;
+    }
+  }
+  log(PROGRESS, "Reusing quadrature rules of %d cut cells.", num_reused);
+
+  // Rebuild quadrature rules of the changed parts
+  _build_quadrature_rules_overlap(_quadrature_order, &previous);
+  _build_quadrature_rules_cut_cells(_quadrature_order, &previous);
+
+  end();
+}
+//-----------------------------------------------------------------------------
 void MultiMesh::clear()
 {
   _boundary_meshes.clear();
@@ -217,11 +438,18 @@ void MultiMesh::clear()
   _uncut_cells.clear();
   _cut_cells.clear();
   _covered_cells.clear();
+  _boundary_collisions.clear();
+  _domain_collisions.clear();
   _collision_maps_cut_cells.clear();
   _collision_maps_cut_cells_boundary.clear();
   _quadrature_rules_cut_cells.clear();
   _quadrature_rules_overlap.clear();
   _quadrature_rules_interface.clear();
+  _facet_normals.clear();
+  _flat_quadrature_rules_cut_cells.clear();
+  _flat_quadrature_rules_extended_cut_cells.clear();
+  _flat_quadrature_rules_overlap.clear();
+  _flat_quadrature_rules_interface.clear();
 }
 //-----------------------------------------------------------------------------
 void MultiMesh::_build_boundary_meshes()
@@ -275,150 +503,180 @@ void MultiMesh::_build_collision_maps()
   begin(PROGRESS, "Building collision maps.");
 
   // Clear collision maps
-  _uncut_cells.clear();
-  _cut_cells.clear();
-  _covered_cells.clear();
+  _uncut_cells.assign(num_parts(), std::vector<unsigned int>());
+  _cut_cells.assign(num_parts(), std::vector<unsigned int>());
+  _covered_cells.assign(num_parts(), std::vector<unsigned int>());
   _collision_maps_cut_cells.clear();
+  _collision_maps_cut_cells.resize(num_parts());
   _collision_maps_cut_cells_boundary.clear();
 
-  // Iterate over all parts
+  // Compute collisions between all pairs of parts
+  _boundary_collisions.assign(num_parts(),
+    std::vector<std::vector<unsigned int>>(num_parts()));
+  _domain_collisions.assign(num_parts(),
+    std::vector<std::pair<std::vector<unsigned int>,
+                          std::vector<unsigned int>>>(num_parts()));
   for (std::size_t i = 0; i < num_parts(); i++)
-  {
-    // Extract uncut, cut and covered cells:
-    //
-    // 0: uncut   = cell not colliding with any higher domain
-    // 1: cut     = cell colliding with some higher boundary and is not covered
-    // 2: covered = cell colliding with some higher domain but not its boundary
-
-    // Create vector of markers for cells in part `i` (0, 1, or 2)
-    std::vector<char> markers(_meshes[i]->num_cells(), 0);
-
-    // Create local array for marking boundary collisions for cells in
-    // part `i`. Note that in contrast to the markers above which are
-    // global to part `i`, these markers are local to the collision
-    // between part `i` and part `j`.
-    std::vector<bool> collides_with_boundary(_meshes[i]->num_cells());
-
-    // Create empty collision map for cut cells in part `i`
-    std::map<unsigned int, std::vector<std::pair<std::size_t, unsigned int>>>
-      collision_map_cut_cells;
-
-    // Iterate over covering parts (with higher part number)
     for (std::size_t j = i + 1; j < num_parts(); j++)
-    {
-      log(PROGRESS, "Computing collisions for mesh %d overlapped by mesh %d.", i, j);
+      _compute_collisions(i, j);
+
+  // Build collision map for each part
+  for (std::size_t i = 0; i < num_parts(); i++)
+    _build_collision_map(i);
+
+  end();
+}
+//-----------------------------------------------------------------------------
+void MultiMesh::_compute_collisions(std::size_t i, std::size_t j)
+{
+  dolfin_assert(i < j);
+  log(PROGRESS, "Computing collisions for mesh %d overlapped by mesh %d.", i, j);
 
-      // Reset boundary collision markers
-      std::fill(collides_with_boundary.begin(), collides_with_boundary.end(), false);
+  // Compute domain-boundary collisions
+  _boundary_collisions[i][j]
+    = _trees[i]->compute_collisions(*_boundary_trees[j]).first;
 
-      // Compute domain-boundary collisions
-      const auto& boundary_collisions = _trees[i]->compute_collisions(*_boundary_trees[j]);
+  // Compute domain-domain collisions
+  _domain_collisions[i][j] = _trees[i]->compute_collisions(*_trees[j]);
+}
+//-----------------------------------------------------------------------------
+void MultiMesh::_build_collision_map(std::size_t i)
+{
+  // Extract uncut, cut and covered cells:
+  //
+  // 0: uncut   = cell not colliding with any higher domain
+  // 1: cut     = cell colliding with some higher boundary and is not covered
+  // 2: covered = cell colliding with some higher domain but not its boundary
+
+  // Create vector of markers for cells in part `i` (0, 1, or 2)
+  std::vector<char> markers(_meshes[i]->num_cells(), 0);
+
+  // Create local array for marking boundary collisions for cells in
+  // part `i`. Note that in contrast to the markers above which are
+  // global to part `i`, these markers are local to the collision
+  // between part `i` and part `j`.
+  std::vector<bool> collides_with_boundary(_meshes[i]->num_cells());
+
+  // Create empty collision map for cut cells in part `i`
+  std::map<unsigned int, std::vector<std::pair<std::size_t, unsigned int>>>
+    collision_map_cut_cells;
+
+  // Iterate over covering parts (with higher part number)
+  for (std::size_t j = i + 1; j < num_parts(); j++)
+  {
+    // Reset boundary collision markers
+    std::fill(collides_with_boundary.begin(), collides_with_boundary.end(), false);
+
+    // Iterate over boundary collisions
+    const std::vector<unsigned int>& boundary_collisions
+      = _boundary_collisions[i][j];
+    for (auto it = boundary_collisions.begin();
+         it != boundary_collisions.end(); ++it)
+    {
+      // Mark that cell collides with boundary
+      collides_with_boundary[*it] = true;
 
-      // Iterate over boundary collisions
-      for (auto it = boundary_collisions.first.begin();
-           it != boundary_collisions.first.end(); ++it)
+      // Mark as cut cell if not previously covered
+      if (markers[*it] != 2)
       {
-        // Mark that cell collides with boundary
-        collides_with_boundary[*it] = true;
+        // Mark as cut cell
+        markers[*it] = 1;
 
-        // Mark as cut cell if not previously covered
-        if (markers[*it] != 2)
+        // Add empty list of collisions into map if it does not exist
+        if (collision_map_cut_cells.find(*it) == collision_map_cut_cells.end())
         {
-          // Mark as cut cell
-          markers[*it] = 1;
-
-          // Add empty list of collisions into map if it does not exist
-          if (collision_map_cut_cells.find(*it) == collision_map_cut_cells.end())
-          {
-            std::vector<std::pair<std::size_t, unsigned int>> collisions;
-            collision_map_cut_cells[*it] = collisions;
-          }
+          std::vector<std::pair<std::size_t, unsigned int>> collisions;
+          collision_map_cut_cells[*it] = collisions;
         }
       }
+    }
 
-      // Compute domain-domain collisions
-      const auto& domain_collisions = _trees[i]->compute_collisions(*_trees[j]);
+    // Iterate over domain collisions
+    const auto& domain_collisions = _domain_collisions[i][j];
+    dolfin_assert(domain_collisions.first.size() == domain_collisions.second.size());
+    for (std::size_t k = 0; k < domain_collisions.first.size(); k++)
+    {
+      // Get the two colliding cells
+      auto cell_i = domain_collisions.first[k];
+      auto cell_j = domain_collisions.second[k];
 
-      // Iterate over domain collisions
-      dolfin_assert(domain_collisions.first.size() == domain_collisions.second.size());
-      for (std::size_t k = 0; k < domain_collisions.first.size(); k++)
+      // Store collision in collision map if we have a cut cell
+      if (markers[cell_i] == 1)
       {
-        // Get the two colliding cells
-        auto cell_i = domain_collisions.first[k];
-        auto cell_j = domain_collisions.second[k];
+        auto it = collision_map_cut_cells.find(cell_i);
+        dolfin_assert(it != collision_map_cut_cells.end());
+        it->second.push_back(std::make_pair(j, cell_j));
+      }
 
-        // Store collision in collision map if we have a cut cell
+      // Mark cell as covered if it does not collide with boundary
+      if (!collides_with_boundary[cell_i])
+      {
+        // Remove from collision map if previously marked as as cut cell
         if (markers[cell_i] == 1)
         {
-          auto it = collision_map_cut_cells.find(cell_i);
-          dolfin_assert(it != collision_map_cut_cells.end());
-          it->second.push_back(std::make_pair(j, cell_j));
+          dolfin_assert(collision_map_cut_cells.find(cell_i) != collision_map_cut_cells.end());
+          collision_map_cut_cells.erase(cell_i);
         }
 
-        // Mark cell as covered if it does not collide with boundary
-        if (!collides_with_boundary[cell_i])
-        {
-          // Remove from collision map if previously marked as as cut cell
-          if (markers[cell_i] == 1)
-          {
-            dolfin_assert(collision_map_cut_cells.find(cell_i) != collision_map_cut_cells.end());
-            collision_map_cut_cells.erase(cell_i);
-          }
-
-          // Mark as covered cell (may already be marked)
-          markers[cell_i] = 2;
-        }
+        // Mark as covered cell (may already be marked)
+        markers[cell_i] = 2;
       }
     }
+  }
 
-    // Extract uncut, cut and covered cells from markers
-    std::vector<unsigned int> uncut_cells;
-    std::vector<unsigned int> cut_cells;
-    std::vector<unsigned int> covered_cells;
-    for (unsigned int c = 0; c < _meshes[i]->num_cells(); c++)
+  // Extract uncut, cut and covered cells from markers
+  std::vector<unsigned int> uncut_cells;
+  std::vector<unsigned int> cut_cells;
+  std::vector<unsigned int> covered_cells;
+  for (unsigned int c = 0; c < _meshes[i]->num_cells(); c++)
+  {
+    switch (markers[c])
     {
-      switch (markers[c])
-      {
-      case 0:
-        uncut_cells.push_back(c);
-        break;
-      case 1:
-        cut_cells.push_back(c);
-        break;
-      default:
-        covered_cells.push_back(c);
-      }
+    case 0:
+      uncut_cells.push_back(c);
+      break;
+    case 1:
+      cut_cells.push_back(c);
+      break;
+    default:
+      covered_cells.push_back(c);
     }
-
-    // Store data for this mesh
-    _uncut_cells.push_back(uncut_cells);
-    _cut_cells.push_back(cut_cells);
-    _covered_cells.push_back(covered_cells);
-    _collision_maps_cut_cells.push_back(collision_map_cut_cells);
-
-    // Report results
-    log(PROGRESS, "Part %d has %d uncut cells, %d cut cells, and %d covered cells.",
-        i, uncut_cells.size(), cut_cells.size(), covered_cells.size());
   }
 
-  end();
+  // Store data for this mesh
+  _uncut_cells[i] = uncut_cells;
+  _cut_cells[i] = cut_cells;
+  _covered_cells[i] = covered_cells;
+  _collision_maps_cut_cells[i] = collision_map_cut_cells;
+
+  // Report results
+  log(PROGRESS, "Part %d has %d uncut cells, %d cut cells, and %d covered cells.",
+      i, uncut_cells.size(), cut_cells.size(), covered_cells.size());
 }
 //-----------------------------------------------------------------------------
-void MultiMesh::_build_quadrature_rules_overlap(std::size_t quadrature_order)
+void MultiMesh::_build_quadrature_rules_overlap(
+  std::size_t quadrature_order,
+  const std::vector<PreviousRules>* previous)
 {
   begin(PROGRESS, "Building quadrature rules of cut cells' overlap.");
 
-  // Clear quadrature rules
-  _quadrature_rules_overlap.clear();
-  _quadrature_rules_interface.clear();
-
-  // Resize quadrature rules
+  // Clear quadrature rules and facet normals of rebuilt parts (maps
+  // are built on demand)
   _quadrature_rules_overlap.resize(num_parts());
   _quadrature_rules_interface.resize(num_parts());
-
-  // Clear and resize facet normals
-  _facet_normals.clear();
   _facet_normals.resize(num_parts());
+  _flat_quadrature_rules_overlap.resize(num_parts());
+  _flat_quadrature_rules_interface.resize(num_parts());
+  for (std::size_t part = 0; part < num_parts(); ++part)
+  {
+    if (previous and !(*previous)[part].rebuild)
+      continue;
+    _quadrature_rules_overlap[part].clear();
+    _quadrature_rules_interface[part].clear();
+    _facet_normals[part].clear();
+    _flat_quadrature_rules_overlap[part] = MultiMeshQuadratureRules();
+    _flat_quadrature_rules_interface[part] = MultiMeshQuadratureRules();
+  }
 
   // FIXME: test prebuild map from boundary facets to full mesh cells
   // for all meshes: Loop over all boundary mesh facets to find the
@@ -448,6 +706,11 @@ void MultiMesh::_build_quadrature_rules_overlap(std::size_t quadrature_order)
     const MeshConnectivity& full_facet_cell_map
       = _meshes[part]->topology()(tdim_boundary, tdim);
 
+    // Compute connectivity used for the cells below before the
+    // threaded loop
+    _meshes[part]->init(tdim, tdim_boundary);
+    _meshes[part]->init(tdim_boundary, 0);
+
     for (std::size_t boundary_facet = 0;
          boundary_facet < boundary_cell_map.size(); ++boundary_facet)
     {
@@ -464,285 +727,405 @@ void MultiMesh::_build_quadrature_rules_overlap(std::size_t quadrature_order)
   }
 
   // Iterate over all parts
+  const int num_threads = SubSystemsManager::num_threads();
   for (std::size_t cut_part = 0; cut_part < num_parts(); cut_part++)
   {
-    // Iterate over cut cells for current part
+    if (previous and !(*previous)[cut_part].rebuild)
+      continue;
+
+    // Collect cut cells for current part
     const auto& cmap = collision_map_cut_cells(cut_part);
+    std::vector<unsigned int> cut_cells;
+    std::vector<const std::vector<std::pair<std::size_t, unsigned int>>*>
+      cutting_cells;
     for (auto it = cmap.begin(); it != cmap.end(); ++it)
     {
-      // Get cut cell
-      const unsigned int cut_cell_index = it->first;
-      const Cell cut_cell(*(_meshes[cut_part]), cut_cell_index);
+      cut_cells.push_back(it->first);
+      cutting_cells.push_back(&it->second);
+    }
 
-      // Get dimensions
-      const std::size_t tdim = cut_cell.mesh().topology().dim();
-      const std::size_t gdim = cut_cell.mesh().geometry().dim();
+    // Compute quadrature rules for cut cells in parallel
+    const std::size_t num_cut_cells = cut_cells.size();
+    std::vector<std::vector<quadrature_rule>> overlap_qr(num_cut_cells);
+    std::vector<std::vector<quadrature_rule>> interface_qr(num_cut_cells);
+    std::vector<std::vector<std::vector<double>>> interface_n(num_cut_cells);
+    #ifdef HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+    #endif
+    for (std::size_t c = 0; c < num_cut_cells; ++c)
+    {
+      // Reuse previous rules if possible
+      if (previous and (*previous)[cut_part].cut_cells[c] >= 0)
+      {
+        const PreviousRules& p = (*previous)[cut_part];
+        const std::size_t gdim = _meshes[cut_part]->geometry().dim();
+        const std::size_t old_c = p.cut_cells[c];
+        for (std::size_t k = p.overlap_offsets[old_c];
+             k < p.overlap_offsets[old_c + 1]; ++k)
+        {
+          overlap_qr[c].push_back(_extract_quadrature_rule(p.rules_overlap,
+                                                           k, gdim));
+          interface_qr[c].push_back(_extract_quadrature_rule(p.rules_interface,
+                                                             k, gdim));
+          const auto normals = p.rules_interface.normals.begin();
+          interface_n[c].push_back(std::vector<double>(
+            normals + gdim*p.rules_interface.offsets[k],
+            normals + gdim*p.rules_interface.offsets[k + 1]));
+        }
+        continue;
+      }
 
-      // Data structure for the volume triangulation of the cut_cell
-      std::vector<double> volume_triangulation;
+      _build_quadrature_rules_overlap(overlap_qr[c], interface_qr[c],
+                                      interface_n[c], cut_part, cut_cells[c],
+                                      *cutting_cells[c], full_to_bdry,
+                                      quadrature_order);
+    }
 
-      // Data structure for the overlap quadrature rule
-      std::vector<quadrature_rule> overlap_qr;
+    // Store quadrature rules and facet normals in flat arrays
+    MultiMeshQuadratureRules& overlap
+      = _flat_quadrature_rules_overlap[cut_part];
+    MultiMeshQuadratureRules& interface
+      = _flat_quadrature_rules_interface[cut_part];
+    overlap.offsets.assign(1, 0);
+    interface.offsets.assign(1, 0);
+    for (std::size_t c = 0; c < num_cut_cells; ++c)
+    {
+      for (std::size_t k = 0; k < overlap_qr[c].size(); ++k)
+      {
+        _append_quadrature_rule(overlap, overlap_qr[c][k]);
+        _append_quadrature_rule(interface, interface_qr[c][k]);
+        interface.normals.insert(interface.normals.end(),
+                                 interface_n[c][k].begin(),
+                                 interface_n[c][k].end());
+      }
+    }
+  }
 
-      // Data structure for the interface quadrature rule
-      std::vector<quadrature_rule> interface_qr;
+  end();
+}
+//-----------------------------------------------------------------------------
+void MultiMesh::_build_quadrature_rules_overlap(
+  std::vector<quadrature_rule>& overlap_qr,
+  std::vector<quadrature_rule>& interface_qr,
+  std::vector<std::vector<double>>& interface_n,
+  std::size_t cut_part,
+  unsigned int cut_cell_index,
+  const std::vector<std::pair<std::size_t, unsigned int>>& cutting_cells,
+  const std::vector<std::vector<std::vector<std::pair<std::size_t, std::size_t>>>>& full_to_bdry,
+  std::size_t quadrature_order) const
+{
+  // Get cut cell
+  const Cell cut_cell(*(_meshes[cut_part]), cut_cell_index);
 
-      // Data structure for the facet normals of the interface. The
-      // numbering matches the numbering of interface_qr. This means
-      // we have one normal for each quadrature point, since this is
-      // how the data are grouped during assembly: for each pair of
-      // colliding cells, we build a list of quadrature points and a
-      // corresponding list of facet normals.
-      std::vector<std::vector<double>> interface_n;
+  // Get dimensions
+  const std::size_t tdim = cut_cell.mesh().topology().dim();
+  const std::size_t gdim = cut_cell.mesh().geometry().dim();
 
-      // Data structure for the interface triangulation
-      std::vector<double> interface_triangulation;
+  // Data structure for the volume triangulation of the cut_cell
+  std::vector<double> volume_triangulation;
 
-      // Data structure for normals to the interface. The numbering
-      // should match the numbering of interface_triangulation.
-      std::vector<Point> triangulation_normals;
+  // The facet normals of the interface are numbered as
+  // interface_qr. This means we have one normal for each quadrature
+  // point, since this is how the data are grouped during assembly:
+  // for each pair of colliding cells, we build a list of quadrature
+  // points and a corresponding list of facet normals.
 
-      // Iterate over cutting cells
-      const auto& cutting_cells = it->second;
-      for (auto jt = cutting_cells.begin(); jt != cutting_cells.end(); jt++)
-      {
-        // Get cutting part and cutting cell
-        const std::size_t cutting_part = jt->first;
-        const std::size_t cutting_cell_index = jt->second;
-        const Cell cutting_cell(*(_meshes[cutting_part]), cutting_cell_index);
+  // Data structure for the interface triangulation
+  std::vector<double> interface_triangulation;
 
-        // Topology of this cut part
-        const std::size_t tdim_boundary = _boundary_meshes[cutting_part]->topology().dim();
+  // Data structure for normals to the interface. The numbering
+  // should match the numbering of interface_triangulation.
+  std::vector<Point> triangulation_normals;
 
-        // Must have the same topology at the moment (FIXME)
-        dolfin_assert(cutting_cell.mesh().topology().dim() == tdim);
+  // Iterate over cutting cells
+  for (auto jt = cutting_cells.begin(); jt != cutting_cells.end(); jt++)
+  {
+    // Get cutting part and cutting cell
+    const std::size_t cutting_part = jt->first;
+    const std::size_t cutting_cell_index = jt->second;
+    const Cell cutting_cell(*(_meshes[cutting_part]), cutting_cell_index);
 
-        // Data structure for local interface triangulation
-        std::vector<double> local_interface_triangulation;
+    // Topology of this cut part
+    const std::size_t tdim_boundary = _boundary_meshes[cutting_part]->topology().dim();
 
-        // Data structure for the local interface normals. The
-        // numbering should match the numbering of
-        // local_interface_triangulation.
-        std::vector<Point> local_triangulation_normals;
+    // Must have the same topology at the moment (FIXME)
+    dolfin_assert(cutting_cell.mesh().topology().dim() == tdim);
 
-        // Data structure for the overlap part quadrature rule
-        quadrature_rule overlap_part_qr;
+    // Data structure for local interface triangulation
+    std::vector<double> local_interface_triangulation;
 
-        // Data structure for the interface part quadrature rule
-        quadrature_rule interface_part_qr;
+    // Data structure for the local interface normals. The
+    // numbering should match the numbering of
+    // local_interface_triangulation.
+    std::vector<Point> local_triangulation_normals;
 
-        // Data structure for the interface part facet normals. The
-        // numbering matches the numbering of interface_part_qr.
-        std::vector<double> interface_part_n;
+    // Data structure for the overlap part quadrature rule
+    quadrature_rule overlap_part_qr;
 
-        // Iterate over boundary cells
-        for (auto boundary_cell_index : full_to_bdry[cutting_part][cutting_cell_index])
-        {
-          // Get the boundary facet as a cell in the boundary mesh
-          const Cell boundary_cell(*_boundary_meshes[cutting_part],
-                                   boundary_cell_index.first);
-
-          // Get the boundary facet as a facet in the full mesh
-          const Facet boundary_facet(*_meshes[cutting_part],
-                                     boundary_cell_index.second);
-
-          // Triangulate intersection of cut cell and boundary cell
-          const auto triangulation_cut_boundary
-            = cut_cell.triangulate_intersection(boundary_cell);
-
-          // The normals to triangulation_cut_boundary
-          std::vector<Point> normals_cut_boundary;
-
-          // Add quadrature rule and normals for triangulation
-          if (triangulation_cut_boundary.size())
-          {
-            dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
-
-            const auto num_qr_points
-              = _add_quadrature_rule(interface_part_qr,
-                                     triangulation_cut_boundary,
-                                     tdim_boundary, gdim,
-                                     quadrature_order, 1);
-
-            const std::size_t local_facet_index = cutting_cell.index(boundary_facet);
-            const Point n = -cutting_cell.normal(local_facet_index);
-            for (std::size_t i = 0; i < num_qr_points.size(); ++i)
-            {
-              _add_normal(interface_part_n,
-                          n,
-                          num_qr_points[i],
-                          gdim);
-              normals_cut_boundary.push_back(n);
-            }
-
-            dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
-          }
-
-          // Triangulate intersection of boundary cell and previous volume triangulation
-          const auto triangulation_boundary_prev_volume
-            = IntersectionTriangulation::triangulate_intersection(boundary_cell,
-                                                                  volume_triangulation,
-                                                                  tdim);
-
-          // Add quadrature rule and normals for triangulation
-          if (triangulation_boundary_prev_volume.size())
-          {
-            dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
-
-            const auto num_qr_points
-              = _add_quadrature_rule(interface_part_qr,
-                                     triangulation_boundary_prev_volume,
-                                     tdim_boundary, gdim,
-                                     quadrature_order, -1);
-
-            const std::size_t local_facet_index = cutting_cell.index(boundary_facet);
-            const Point n = -cutting_cell.normal(local_facet_index);
-            for (std::size_t i = 0; i < num_qr_points.size(); ++i)
-              _add_normal(interface_part_n,
-                          n,
-                          num_qr_points[i],
-                          gdim);
-
-            dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
-          }
-
-          // Update triangulation
-          local_interface_triangulation.insert(local_interface_triangulation.end(),
-                                               triangulation_cut_boundary.begin(),
-                                               triangulation_cut_boundary.end());
-
-          // Update interface facet normals
-          local_triangulation_normals.insert(local_triangulation_normals.end(),
-                                             normals_cut_boundary.begin(),
-                                             normals_cut_boundary.end());
-        }
+    // Data structure for the interface part quadrature rule
+    quadrature_rule interface_part_qr;
 
-        // Triangulate the intersection of the previous interface
-        // triangulation and the cutting cell (to remove)
-        std::vector<double> triangulation_prev_cutting;
-        std::vector<Point> normals_prev_cutting;
-        IntersectionTriangulation::triangulate_intersection(cutting_cell,
-                                                            interface_triangulation,
-                                                            triangulation_normals,
-                                                            triangulation_prev_cutting,
-                                                            normals_prev_cutting,
-                                                            tdim_boundary);
-
-        // Add quadrature rule for triangulation
-        if (triangulation_prev_cutting.size())
-        {
-          dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
+    // Data structure for the interface part facet normals. The
+    // numbering matches the numbering of interface_part_qr.
+    std::vector<double> interface_part_n;
 
-          const auto num_qr_points
-            = _add_quadrature_rule(interface_part_qr,
-                                   triangulation_prev_cutting,
-                                   tdim_boundary, gdim,
-                                   quadrature_order, -1);
+    // Iterate over boundary cells
+    for (auto boundary_cell_index : full_to_bdry[cutting_part][cutting_cell_index])
+    {
+      // Get the boundary facet as a cell in the boundary mesh
+      const Cell boundary_cell(*_boundary_meshes[cutting_part],
+                               boundary_cell_index.first);
 
-          for (std::size_t i = 0; i < num_qr_points.size(); ++i)
-            _add_normal(interface_part_n,
-                        normals_prev_cutting[i],
-                        num_qr_points[i],
-                        gdim);
+      // Get the boundary facet as a facet in the full mesh
+      const Facet boundary_facet(*_meshes[cutting_part],
+                                 boundary_cell_index.second);
 
-          dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
+      // Triangulate intersection of cut cell and boundary cell
+      const auto triangulation_cut_boundary
+        = cut_cell.triangulate_intersection(boundary_cell);
+
+      // The normals to triangulation_cut_boundary
+      std::vector<Point> normals_cut_boundary;
+
+      // Add quadrature rule and normals for triangulation
+      if (triangulation_cut_boundary.size())
+      {
+        dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
+
+        const auto num_qr_points
+          = _add_quadrature_rule(interface_part_qr,
+                                 triangulation_cut_boundary,
+                                 tdim_boundary, gdim,
+                                 quadrature_order, 1);
+
+        const std::size_t local_facet_index = cutting_cell.index(boundary_facet);
+        const Point n = -cutting_cell.normal(local_facet_index);
+        for (std::size_t i = 0; i < num_qr_points.size(); ++i)
+        {
+          _add_normal(interface_part_n,
+                      n,
+                      num_qr_points[i],
+                      gdim);
+          normals_cut_boundary.push_back(n);
         }
 
-        // Update triangulation
-        interface_triangulation.insert(interface_triangulation.end(),
-                                       local_interface_triangulation.begin(),
-                                       local_interface_triangulation.end());
-
-        // Update normals
-        triangulation_normals.insert(triangulation_normals.end(),
-                                     local_triangulation_normals.begin(),
-                                     local_triangulation_normals.end());
-
-        // Do the volume segmentation
-
-        // Compute volume triangulation of intersection of cut and cutting cells
-        const auto triangulation_cut_cutting
-          = cut_cell.triangulate_intersection(cutting_cell);
-
-        // Compute triangulation of intersection of cutting cell and
-        // the (previous) volume triangulation
-        const auto triangulation_cutting_prev
-          = IntersectionTriangulation::triangulate_intersection(cutting_cell,
-                                                                volume_triangulation,
-                                                                tdim);
-
-        // Add these new triangulations
-        volume_triangulation.insert(volume_triangulation.end(),
-                                    triangulation_cut_cutting.begin(),
-                                    triangulation_cut_cutting.end());
-
-        // Add quadrature rule with weights corresponding to the two
-        // triangulations
-        _add_quadrature_rule(overlap_part_qr,
-                             triangulation_cut_cutting,
-                             tdim, gdim, quadrature_order, 1);
-        _add_quadrature_rule(overlap_part_qr,
-                             triangulation_cutting_prev,
-                             tdim, gdim, quadrature_order, -1);
-
-        // Add quadrature rule for overlap part
-        overlap_qr.push_back(overlap_part_qr);
-
-        // Add quadrature rule for interface part
-        interface_qr.push_back(interface_part_qr);
-
-        // Add facet normal for interface part
-        interface_n.push_back(interface_part_n);
+        dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
       }
 
-      // Store quadrature rules for cut cell
-      _quadrature_rules_overlap[cut_part][cut_cell_index] = overlap_qr;
-      _quadrature_rules_interface[cut_part][cut_cell_index] = interface_qr;
+      // Triangulate intersection of boundary cell and previous volume triangulation
+      const auto triangulation_boundary_prev_volume
+        = IntersectionTriangulation::triangulate_intersection(boundary_cell,
+                                                              volume_triangulation,
+                                                              tdim);
 
-      // Store facet normals for cut cell
-      _facet_normals[cut_part][cut_cell_index] = interface_n;
+      // Add quadrature rule and normals for triangulation
+      if (triangulation_boundary_prev_volume.size())
+      {
+        dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
+
+        const auto num_qr_points
+          = _add_quadrature_rule(interface_part_qr,
+                                 triangulation_boundary_prev_volume,
+                                 tdim_boundary, gdim,
+                                 quadrature_order, -1);
+
+        const std::size_t local_facet_index = cutting_cell.index(boundary_facet);
+        const Point n = -cutting_cell.normal(local_facet_index);
+        for (std::size_t i = 0; i < num_qr_points.size(); ++i)
+          _add_normal(interface_part_n,
+                      n,
+                      num_qr_points[i],
+                      gdim);
+
+        dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
+      }
+
+      // Update triangulation
+      local_interface_triangulation.insert(local_interface_triangulation.end(),
+                                           triangulation_cut_boundary.begin(),
+                                           triangulation_cut_boundary.end());
+
+      // Update interface facet normals
+      local_triangulation_normals.insert(local_triangulation_normals.end(),
+                                         normals_cut_boundary.begin(),
+                                         normals_cut_boundary.end());
     }
-  }
 
-  end();
+    // Triangulate the intersection of the previous interface
+    // triangulation and the cutting cell (to remove)
+    std::vector<double> triangulation_prev_cutting;
+    std::vector<Point> normals_prev_cutting;
+    IntersectionTriangulation::triangulate_intersection(cutting_cell,
+                                                        interface_triangulation,
+                                                        triangulation_normals,
+                                                        triangulation_prev_cutting,
+                                                        normals_prev_cutting,
+                                                        tdim_boundary);
+
+    // Add quadrature rule for triangulation
+    if (triangulation_prev_cutting.size())
+    {
+      dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
+
+      const auto num_qr_points
+        = _add_quadrature_rule(interface_part_qr,
+                               triangulation_prev_cutting,
+                               tdim_boundary, gdim,
+                               quadrature_order, -1);
+
+      for (std::size_t i = 0; i < num_qr_points.size(); ++i)
+        _add_normal(interface_part_n,
+                    normals_prev_cutting[i],
+                    num_qr_points[i],
+                    gdim);
+
+      dolfin_assert(interface_part_n.size() == interface_part_qr.first.size());
+    }
+
+    // Update triangulation
+    interface_triangulation.insert(interface_triangulation.end(),
+                                   local_interface_triangulation.begin(),
+                                   local_interface_triangulation.end());
+
+    // Update normals
+    triangulation_normals.insert(triangulation_normals.end(),
+                                 local_triangulation_normals.begin(),
+                                 local_triangulation_normals.end());
+
+    // Do the volume segmentation
+
+    // Compute volume triangulation of intersection of cut and cutting cells
+    const auto triangulation_cut_cutting
+      = cut_cell.triangulate_intersection(cutting_cell);
+
+    // Compute triangulation of intersection of cutting cell and
+    // the (previous) volume triangulation
+    const auto triangulation_cutting_prev
+      = IntersectionTriangulation::triangulate_intersection(cutting_cell,
+                                                            volume_triangulation,
+                                                            tdim);
+
+    // Add these new triangulations
+    volume_triangulation.insert(volume_triangulation.end(),
+                                triangulation_cut_cutting.begin(),
+                                triangulation_cut_cutting.end());
+
+    // Add quadrature rule with weights corresponding to the two
+    // triangulations
+    _add_quadrature_rule(overlap_part_qr,
+                         triangulation_cut_cutting,
+                         tdim, gdim, quadrature_order, 1);
+    _add_quadrature_rule(overlap_part_qr,
+                         triangulation_cutting_prev,
+                         tdim, gdim, quadrature_order, -1);
+
+    // Add quadrature rule for overlap part
+    overlap_qr.push_back(overlap_part_qr);
+
+    // Add quadrature rule for interface part
+    interface_qr.push_back(interface_part_qr);
+
+    // Add facet normal for interface part
+    interface_n.push_back(interface_part_n);
+  }
 }
 //-----------------------------------------------------------------------------
-void MultiMesh::_build_quadrature_rules_cut_cells(std::size_t quadrature_order)
+void MultiMesh::_build_quadrature_rules_cut_cells(
+  std::size_t quadrature_order,
+  const std::vector<PreviousRules>* previous)
 {
   begin(PROGRESS, "Building quadrature rules of cut cells.");
 
-  // Clear quadrature rules
-  _quadrature_rules_cut_cells.clear();
+  // Clear quadrature rules of rebuilt parts (maps are built on
+  // demand)
   _quadrature_rules_cut_cells.resize(num_parts());
+  _flat_quadrature_rules_cut_cells.resize(num_parts());
+  _flat_quadrature_rules_extended_cut_cells.resize(num_parts());
+  for (std::size_t part = 0; part < num_parts(); ++part)
+  {
+    if (previous and !(*previous)[part].rebuild)
+      continue;
+    _quadrature_rules_cut_cells[part].clear();
+    _flat_quadrature_rules_cut_cells[part] = MultiMeshQuadratureRules();
+    _flat_quadrature_rules_extended_cut_cells[part]
+      = MultiMeshQuadratureRules();
+  }
 
   // Iterate over all parts
+  const int num_threads = SubSystemsManager::num_threads();
   for (std::size_t cut_part = 0; cut_part < num_parts(); cut_part++)
   {
-    // Iterate over cut cells for current part
+    if (previous and !(*previous)[cut_part].rebuild)
+      continue;
+
+    // Get dimension
+    const std::size_t gdim = _meshes[cut_part]->geometry().dim();
+
+    // Compute offsets of overlap quadrature rules for each cut cell
     const auto& cmap = collision_map_cut_cells(cut_part);
+    const std::vector<unsigned int>& cut_cells = _cut_cells[cut_part];
+    dolfin_assert(cut_cells.size() == cmap.size());
+    std::vector<std::size_t> overlap_offsets(1, 0);
     for (auto it = cmap.begin(); it != cmap.end(); ++it)
+      overlap_offsets.push_back(overlap_offsets.back() + it->second.size());
+
+    // Compute quadrature rules for cut cells in parallel
+    const MultiMeshQuadratureRules& overlap
+      = _flat_quadrature_rules_overlap[cut_part];
+    const std::size_t num_cut_cells = cut_cells.size();
+    std::vector<quadrature_rule> qr(num_cut_cells);
+    #ifdef HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+    #endif
+    for (std::size_t c = 0; c < num_cut_cells; ++c)
     {
-      // Get cut cell
-      const unsigned int cut_cell_index = it->first;
-      const Cell cut_cell(*(_meshes[cut_part]), cut_cell_index);
-
-      // Get dimension
-      const std::size_t gdim = cut_cell.mesh().geometry().dim();
+      // Reuse previous rule if possible
+      if (previous and (*previous)[cut_part].cut_cells[c] >= 0)
+      {
+        const PreviousRules& p = (*previous)[cut_part];
+        qr[c] = _extract_quadrature_rule(p.rules_cut_cells, p.cut_cells[c],
+                                         gdim);
+        continue;
+      }
 
       // Compute quadrature rule for the cell itself.
-      auto qr = SimplexQuadrature::compute_quadrature_rule(cut_cell,
-                                                           quadrature_order);
-
-      // Get the quadrature rule for the overlapping part
-      const auto& qr_overlap = _quadrature_rules_overlap[cut_part][cut_cell_index];
+      const Cell cut_cell(*(_meshes[cut_part]), cut_cells[c]);
+      qr[c] = SimplexQuadrature::compute_quadrature_rule(cut_cell,
+                                                         quadrature_order);
 
       // Add the quadrature rule for the overlapping part to the
       // quadrature rule of the cut cell with flipped sign
-      for (std::size_t k = 0; k < qr_overlap.size(); k++)
-        _add_quadrature_rule(qr, qr_overlap[k], gdim, -1);
+      for (std::size_t k = overlap_offsets[c]; k < overlap_offsets[c + 1]; k++)
+      {
+        _add_quadrature_rule(qr[c], _extract_quadrature_rule(overlap, k, gdim),
+                             gdim, -1);
+      }
+    }
 
-      // Store quadrature rule for cut cell
-      _quadrature_rules_cut_cells[cut_part][cut_cell_index] = qr;
+    // Store quadrature rules for cut cells in flat arrays
+    MultiMeshQuadratureRules& rules = _flat_quadrature_rules_cut_cells[cut_part];
+    rules.offsets.assign(1, 0);
+    for (std::size_t c = 0; c < num_cut_cells; ++c)
+      _append_quadrature_rule(rules, qr[c]);
+
+    // Store the points of positive weight, which are used when
+    // integration on cut cells is extended to the overlap
+    MultiMeshQuadratureRules& extended
+      = _flat_quadrature_rules_extended_cut_cells[cut_part];
+    extended.offsets.assign(1, 0);
+    for (std::size_t c = 0; c < num_cut_cells; ++c)
+    {
+      for (std::size_t i = rules.offsets[c]; i < rules.offsets[c + 1]; ++i)
+      {
+        if (rules.weights[i] > 0.0)
+        {
+          extended.weights.push_back(rules.weights[i]);
+          extended.points.insert(extended.points.end(),
+                                 rules.points.begin() + i*gdim,
+                                 rules.points.begin() + (i + 1)*gdim);
+        }
+      }
+      extended.offsets.push_back(extended.weights.size());
     }
   }
 
@@ -762,16 +1145,23 @@ MultiMesh::_add_quadrature_rule(quadrature_rule& qr,
   const std::size_t num_simplices = triangulation.size() / offset;
   std::vector<std::size_t> num_points(num_simplices);
 
+  // Quadrature rule for simplex (reused for all simplices)
+  const std::size_t num_simplex_points
+    = SimplexQuadrature::num_points(tdim, quadrature_order);
+  quadrature_rule dqr;
+  dqr.first.resize(num_simplex_points*gdim);
+  dqr.second.resize(num_simplex_points);
+
   for (std::size_t k = 0; k < num_simplices; k++)
   {
     // Get coordinates for current simplex in triangulation
     const double* x = &triangulation[0] + k*offset;
 
     // Compute quadrature rule for simplex
-    const auto dqr = SimplexQuadrature::compute_quadrature_rule(x,
-                                                               tdim,
-                                                               gdim,
-                                                               quadrature_order);
+    SimplexQuadrature::compute_quadrature_rule(x, tdim, gdim,
+                                               quadrature_order,
+                                               dqr.first.data(),
+                                               dqr.second.data());
 
     // Add quadrature rule
     num_points[k] = _add_quadrature_rule(qr, dqr, gdim, factor);
@@ -809,6 +1199,31 @@ std::size_t MultiMesh::_add_quadrature_rule(quadrature_rule& qr,
   return num_points;
 }
 //-----------------------------------------------------------------------------
+void MultiMesh::_append_quadrature_rule(MultiMeshQuadratureRules& rules,
+                                        const quadrature_rule& qr)
+{
+  if (rules.offsets.empty())
+    rules.offsets.push_back(0);
+  rules.points.insert(rules.points.end(), qr.first.begin(), qr.first.end());
+  rules.weights.insert(rules.weights.end(), qr.second.begin(),
+                       qr.second.end());
+  rules.offsets.push_back(rules.weights.size());
+}
+//-----------------------------------------------------------------------------
+quadrature_rule
+MultiMesh::_extract_quadrature_rule(const MultiMeshQuadratureRules& rules,
+                                    std::size_t i,
+                                    std::size_t gdim)
+{
+  dolfin_assert(i < rules.size());
+  quadrature_rule qr;
+  qr.first.assign(rules.points.begin() + gdim*rules.offsets[i],
+                  rules.points.begin() + gdim*rules.offsets[i + 1]);
+  qr.second.assign(rules.weights.begin() + rules.offsets[i],
+                   rules.weights.begin() + rules.offsets[i + 1]);
+  return qr;
+}
+//-----------------------------------------------------------------------------
 void MultiMesh::_add_normal(std::vector<double>& normals,
                          const Point& normal,
                          const std::size_t npts,
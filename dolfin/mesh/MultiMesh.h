@@ -40,6 +40,37 @@ namespace dolfin
   /// Typedefs
   typedef std::pair<std::vector<double>, std::vector<double> > quadrature_rule;
 
+  /// A list of quadrature rules stored in flat arrays. The points,
+  /// weights and (for interface rules) facet normals of rule i are
+  /// the entries
+  ///
+  ///     points[gdim*offsets[i]] ... points[gdim*offsets[i + 1] - 1]
+  ///     weights[offsets[i]] ... weights[offsets[i + 1] - 1]
+  ///     normals[gdim*offsets[i]] ... normals[gdim*offsets[i + 1] - 1]
+  struct MultiMeshQuadratureRules
+  {
+    /// Offsets of rules in list of weights (size num_rules + 1)
+    std::vector<std::size_t> offsets;
+
+    /// Flattened array of quadrature points (num_points x gdim)
+    std::vector<double> points;
+
+    /// Quadrature weights
+    std::vector<double> weights;
+
+    /// Flattened array of facet normals (num_points x gdim), or
+    /// empty if not defined
+    std::vector<double> normals;
+
+    /// Return number of quadrature rules
+    std::size_t size() const
+    { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    /// Return number of quadrature points of rule i
+    std::size_t num_points(std::size_t i) const
+    { return offsets[i + 1] - offsets[i]; }
+  };
+
   /// This class represents a collection of meshes with arbitrary
   /// overlaps. A multimesh may be created from a set of standard
   /// meshes spaces by repeatedly calling add(), followed by a call to
@@ -248,6 +279,66 @@ namespace dolfin
     const std::map<unsigned int, std::vector<std::vector<double> > >&
     facet_normals(std::size_t part) const;
 
+    /// Return quadrature rules for cut cells on the given part,
+    /// stored in flat arrays. Rule j is the rule of cut cell
+    /// cut_cells(part)[j]. This is the storage used during assembly;
+    /// quadrature_rule_cut_cells() returns the same rules as a map.
+    ///
+    /// *Arguments*
+    ///     part (std::size_t)
+    ///         The part number
+    ///
+    /// *Returns*
+    ///     _MultiMeshQuadratureRules_
+    ///         The quadrature rules.
+    const MultiMeshQuadratureRules&
+    flat_quadrature_rules_cut_cells(std::size_t part) const;
+
+    /// Return quadrature rules for cut cells on the given part
+    /// restricted to the points of positive weight, stored in flat
+    /// arrays and ordered as for flat_quadrature_rules_cut_cells().
+    /// These rules integrate over the whole cut cell, including the
+    /// part covered by cells from higher ranked meshes.
+    ///
+    /// *Arguments*
+    ///     part (std::size_t)
+    ///         The part number
+    ///
+    /// *Returns*
+    ///     _MultiMeshQuadratureRules_
+    ///         The quadrature rules.
+    const MultiMeshQuadratureRules&
+    flat_quadrature_rules_extended_cut_cells(std::size_t part) const;
+
+    /// Return quadrature rules for the overlap on the given part,
+    /// stored in flat arrays. There is one rule for each pair of cut
+    /// and cutting cells, ordered as the cut cells and the lists of
+    /// cutting cells in the collision map.
+    ///
+    /// *Arguments*
+    ///     part (std::size_t)
+    ///         The part number
+    ///
+    /// *Returns*
+    ///     _MultiMeshQuadratureRules_
+    ///         The quadrature rules.
+    const MultiMeshQuadratureRules&
+    flat_quadrature_rules_overlap(std::size_t part) const;
+
+    /// Return quadrature rules and facet normals for the interface
+    /// on the given part, stored in flat arrays and ordered as for
+    /// flat_quadrature_rules_overlap().
+    ///
+    /// *Arguments*
+    ///     part (std::size_t)
+    ///         The part number
+    ///
+    /// *Returns*
+    ///     _MultiMeshQuadratureRules_
+    ///         The quadrature rules.
+    const MultiMeshQuadratureRules&
+    flat_quadrature_rules_interface(std::size_t part) const;
+
     /// Return the bounding box tree for the mesh of the given part
     ///
     /// *Arguments*
@@ -283,14 +374,52 @@ namespace dolfin
     /// Build multimesh
     void build(std::size_t quadrature_order=2);
 
+    /// Update multimesh after the vertex coordinates of one part
+    /// have changed (with unchanged topology), for example when a
+    /// part moves in each time step. The bounding box trees of the
+    /// part are refitted and only the collisions involving the part
+    /// are recomputed. The quadrature rules of cut cells in lower
+    /// parts are reused if their cutting cells did not change and do
+    /// not belong to the moved part, so the cost is proportional to
+    /// the part of the interface that moved. The quadrature order of
+    /// the last call to build() is used.
+    ///
+    /// *Arguments*
+    ///     part (std::size_t)
+    ///         The number of the part that has moved.
+    void update(std::size_t part);
+
     /// Clear multimesh
     void clear();
 
   private:
 
+    // Quadrature rules of a part from the previous build, reused by
+    // update() for cut cells whose cutting cells did not change
+    struct PreviousRules
+    {
+      // True if the rules of the part are rebuilt
+      bool rebuild;
+
+      // Number of each cut cell in the previous list of cut cells, or
+      // -1 if its rules must be recomputed
+      std::vector<int> cut_cells;
+
+      // Offsets of the overlap rules of each previous cut cell
+      std::vector<std::size_t> overlap_offsets;
+
+      // Previous rules of cut cells, overlap and interface
+      MultiMeshQuadratureRules rules_cut_cells;
+      MultiMeshQuadratureRules rules_overlap;
+      MultiMeshQuadratureRules rules_interface;
+    };
+
     // List of meshes
     std::vector<std::shared_ptr<const Mesh> > _meshes;
 
+    // Quadrature order of last build
+    std::size_t _quadrature_order;
+
     // List of boundary meshes
     std::vector<std::shared_ptr<BoundaryMesh> > _boundary_meshes;
 
@@ -333,11 +462,11 @@ namespace dolfin
     //     j = the cell number (in the list of covered cells)
     std::vector<std::vector<unsigned int> > _covered_cells;
 
-    // Developer note 1: The data structures _collision_map_cut_cells
-    // and _quadrature_rules_cut_cells may be changed from maps to
-    // vectors and indexed by the number of the cut cell (in the list
-    // of cut cells), instead of indexed by the local cell index as
-    // here, if we find that this is important for performance.
+    // Developer note 1: The quadrature rules are stored in flat
+    // arrays indexed by the number of the cut cell (in the list of
+    // cut cells), see MultiMeshQuadratureRules. The maps from local
+    // cell indices to quadrature rules below are only built on
+    // demand by the corresponding access functions.
     //
     // Developer note 2: Quadrature points are naturally a part of a
     // form (or a term in a form) and not a part of a mesh. However,
@@ -359,6 +488,23 @@ namespace dolfin
                          std::vector<std::pair<std::size_t, unsigned int> > > >
     _collision_maps_cut_cells;
 
+    // Bounding box collisions between parts, stored for update().
+    // Access data by
+    //
+    //     c = _boundary_collisions[i][j]
+    //     d = _domain_collisions[i][j]
+    //
+    // where
+    //
+    //     c = cell indices of part i colliding with the boundary of part j
+    //     d = pairs of colliding cells of part i and part j
+    //     i = the part (mesh) number
+    //     j = the covering part number (j > i)
+    std::vector<std::vector<std::vector<unsigned int>>> _boundary_collisions;
+    std::vector<std::vector<std::pair<std::vector<unsigned int>,
+                                      std::vector<unsigned int>>>>
+    _domain_collisions;
+
     // FIXME: test saving collision with boundary in its own data
     // structure (this saves only the boundary part)
     std::vector<std::map<unsigned int,
@@ -375,7 +521,7 @@ namespace dolfin
     //     q.second = quadrature points, flattened num_points x gdim array
     //            i = the part (mesh) number
     //            j = the cell number (local cell index)
-    std::vector<std::map<unsigned int, quadrature_rule> >
+    mutable std::vector<std::map<unsigned int, quadrature_rule> >
     _quadrature_rules_cut_cells;
 
     // Quadrature rules for overlap. Access data by
@@ -389,7 +535,7 @@ namespace dolfin
     //            i = the part (mesh) number
     //            j = the cell number (local cell index)
     //            k = the collision number (in the list of cutting cells)
-    std::vector<std::map<unsigned int, std::vector<quadrature_rule> > >
+    mutable std::vector<std::map<unsigned int, std::vector<quadrature_rule> > >
     _quadrature_rules_overlap;
 
     // Quadrature rules for interface. Access data by
@@ -403,7 +549,7 @@ namespace dolfin
     //            i = the part (mesh) number
     //            j = the cell number (local cell index)
     //            k = the collision number (in the list of cutting cells)
-    std::vector<std::map<unsigned int, std::vector<quadrature_rule> > >
+    mutable std::vector<std::map<unsigned int, std::vector<quadrature_rule> > >
     _quadrature_rules_interface;
 
     // Facet normals for interface. Access data by
@@ -417,9 +563,16 @@ namespace dolfin
     //     i = the part (mesh) number
     //     j = the cell number (local cell index)
     //     k = the collision number (in the list of cutting cells)
-    std::vector<std::map<unsigned int, std::vector<std::vector<double> > > >
+    mutable std::vector<std::map<unsigned int, std::vector<std::vector<double> > > >
     _facet_normals;
 
+    // Quadrature rules for cut cells, overlap and interface (with
+    // facet normals) stored in flat arrays for each part
+    std::vector<MultiMeshQuadratureRules> _flat_quadrature_rules_cut_cells;
+    std::vector<MultiMeshQuadratureRules> _flat_quadrature_rules_extended_cut_cells;
+    std::vector<MultiMeshQuadratureRules> _flat_quadrature_rules_overlap;
+    std::vector<MultiMeshQuadratureRules> _flat_quadrature_rules_interface;
+
     // Build boundary meshes
     void _build_boundary_meshes();
 
@@ -428,14 +581,50 @@ namespace dolfin
 
     // Build collision maps
     void _build_collision_maps();
+
+    // Compute bounding box collisions between part i and the boundary
+    // and domain of part j > i
+    void _compute_collisions(std::size_t i, std::size_t j);
+
+    // Build uncut, cut and covered cells and collision map of part i
+    // from the collisions with higher parts
+    void _build_collision_map(std::size_t i);
     //void _build_collision_maps_same_topology();
     //void _build_collision_maps_different_topology();
 
-    // Build quadrature rules for the cut cells
-    void _build_quadrature_rules_cut_cells(std::size_t quadrature_order);
-
-    // Build quadrature rules for the overlap
-    void _build_quadrature_rules_overlap(std::size_t quadrature_order);
+    // Build quadrature rules for the cut cells (of the parts marked
+    // for rebuild in previous, if given)
+    void _build_quadrature_rules_cut_cells(
+      std::size_t quadrature_order,
+      const std::vector<PreviousRules>* previous=NULL);
+
+    // Build quadrature rules for the overlap (of the parts marked for
+    // rebuild in previous, if given)
+    void _build_quadrature_rules_overlap(
+      std::size_t quadrature_order,
+      const std::vector<PreviousRules>* previous=NULL);
+
+    // Build quadrature rules for the overlap and interface of a
+    // single cut cell, with one rule for each cutting cell
+    void _build_quadrature_rules_overlap(
+      std::vector<quadrature_rule>& overlap_qr,
+      std::vector<quadrature_rule>& interface_qr,
+      std::vector<std::vector<double>>& interface_n,
+      std::size_t cut_part,
+      unsigned int cut_cell_index,
+      const std::vector<std::pair<std::size_t, unsigned int>>& cutting_cells,
+      const std::vector<std::vector<std::vector<std::pair<std::size_t, std::size_t>>>>& full_to_bdry,
+      std::size_t quadrature_order) const;
+
+    // Append quadrature rule to flat list of rules
+    static void _append_quadrature_rule(MultiMeshQuadratureRules& rules,
+                                        const quadrature_rule& qr);
+
+    // Extract quadrature rule i from flat list of rules
+    static quadrature_rule
+    _extract_quadrature_rule(const MultiMeshQuadratureRules& rules,
+                             std::size_t i,
+                             std::size_t gdim);
 
     // Add quadrature rule for simplices in the triangulation
     // array. Returns the number of points generated for each simplex.
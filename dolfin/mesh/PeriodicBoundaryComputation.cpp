@@ -18,6 +18,9 @@
 // First added:  2013-01-10
 // Last changed:
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <limits>
 #include <map>
 #include <unordered_map>
@@ -35,39 +38,6 @@
 
 using namespace dolfin;
 
-// Comparison operator for hashing coordinates. Note that two
-// coordinates are considered equal if equal to within specified
-// tolerance.
-struct lt_coordinate
-{
-  lt_coordinate(double tolerance) : TOL(tolerance) {}
-
-  bool operator() (const std::vector<double>& x,
-                   const std::vector<double>& y) const
-  {
-    std::size_t n = std::max(x.size(), y.size());
-    for (std::size_t i = 0; i < n; ++i)
-    {
-      double xx = 0.0;
-      double yy = 0.0;
-      if (i < x.size())
-        xx = x[i];
-      if (i < y.size())
-        yy = y[i];
-
-      if (xx < (yy - TOL))
-        return true;
-      else if (xx > (yy + TOL))
-        return false;
-    }
-    return false;
-  }
-
-  // Tolerance
-  const double TOL;
-
-};
-
 //-----------------------------------------------------------------------------
 std::map<unsigned int, std::pair<unsigned int, unsigned int>>
   PeriodicBoundaryComputation::compute_periodic_pairs(const Mesh& mesh,
@@ -76,6 +46,8 @@ std::map<unsigned int, std::pair<unsigned int, unsigned int>>
 {
   // MPI communication
   const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  const std::size_t process_number = MPI::rank(mpi_comm);
 
   // Get geometric and topological dimensions
   const std::size_t gdim = mesh.geometry().dim();
@@ -89,16 +61,18 @@ std::map<unsigned int, std::pair<unsigned int, unsigned int>>
   Array<double> _x(gdim, x.data());
   Array<double> _y(gdim, y.data());
 
-  std::vector<std::size_t> slave_entities;
-  std::vector<std::vector<double>> slave_mapped_coords;
+  // Bucket size for hashing midpoints. Points that are equal to
+  // within the map tolerance lie in the same or in adjacent buckets.
+  const double tol = sub_domain.map_tolerance;
+  const double h = std::max(4.0*tol, std::numeric_limits<double>::min());
 
-  // Min/max coordinates of facet midpoints [min_x, max_x]. Used to
-  // build bounding box of all master entity midpoints on this process
-  std::vector<double> x_min_max;
-
-  // Map from master entity midpoint coordinate to local facet index
-  std::map<std::vector<double>, unsigned int, lt_coordinate>
-    master_coord_to_entity_index((lt_coordinate(sub_domain.map_tolerance)));
+  // Records sent to the processes owning the buckets of master
+  // entity midpoints and mapped slave entity midpoints: (type, local
+  // index, coordinates), with type 0 for masters and 1 for slaves
+  const std::size_t record_size = gdim + 2;
+  std::vector<std::vector<double>> send_buffer(num_processes);
+  std::vector<std::size_t> buckets;
+  std::vector<std::size_t> owners;
 
   // Initialise facet-cell connectivity
   mesh.init(tdim - 1, tdim);
@@ -127,21 +101,13 @@ std::map<unsigned int, std::pair<unsigned int, unsigned int>>
         // Check if entity lies on a 'master' or 'slave' boundary
         if (sub_domain.inside(_x, true))
         {
-          // Build bounding box data for master entity midpoints
-          if (x_min_max.empty())
-          {
-            x_min_max = x;
-            x_min_max.insert(x_min_max.end(), x.begin(), x.end());
-          }
-
-          for (std::size_t i = 0; i < gdim; ++i)
-          {
-            x_min_max[i]        = std::min(x_min_max[i], x[i]);
-            x_min_max[gdim + i] = std::max(x_min_max[gdim + i], x[i]);
-          }
-
-          // Insert (midpoint coordinates, local index) into map
-          master_coord_to_entity_index.insert({x, e->index()});
+          // Send master to the owner of its bucket
+          compute_buckets(x.data(), gdim, h, tol, buckets);
+          std::vector<double>& send_p
+            = send_buffer[buckets[0] % num_processes];
+          send_p.push_back(0.0);
+          send_p.push_back(e->index());
+          send_p.insert(send_p.end(), x.begin(), x.end());
         }
         else
         {
@@ -168,106 +134,119 @@ std::map<unsigned int, std::pair<unsigned int, unsigned int>>
           // Check if entity lies on a 'slave' boundary
           if (sub_domain.inside(_y, true))
           {
-            // Store slave local index and midpoint coordinates
-            slave_entities.push_back(e->index());
-            slave_mapped_coords.push_back(y);
+            // Send mapped slave to the owners of all buckets that may
+            // contain the master (once per process)
+            compute_buckets(y.data(), gdim, h, tol, buckets);
+            owners.clear();
+            for (std::size_t i = 0; i < buckets.size(); ++i)
+              owners.push_back(buckets[i] % num_processes);
+            std::sort(owners.begin(), owners.end());
+            owners.erase(std::unique(owners.begin(), owners.end()),
+                         owners.end());
+            for (std::size_t i = 0; i < owners.size(); ++i)
+            {
+              std::vector<double>& send_p = send_buffer[owners[i]];
+              send_p.push_back(1.0);
+              send_p.push_back(e->index());
+              send_p.insert(send_p.end(), y.begin(), y.end());
+            }
           }
         }
       }
     }
   }
 
-  // Communicate bounding boxes for master entities
-  std::vector<std::vector<double>> bounding_boxes;
-  MPI::all_gather(mpi_comm, x_min_max, bounding_boxes);
-
-  // Number of MPI processes
-  std::size_t num_processes = MPI::size(mpi_comm);
-
-  // Build send buffer of mapped slave midpoint coordinate to
-  // processes that may own the master entity
-  std::vector<std::vector<double>> slave_mapped_coords_send(num_processes);
-  std::vector<std::vector<unsigned int>> sent_slave_indices(num_processes);
-  for (std::size_t i = 0; i < slave_entities.size(); ++i)
+  // Send masters and mapped slaves to bucket owners
+  std::vector<std::vector<double>> recv_buffer;
+  MPI::all_to_all(mpi_comm, send_buffer, recv_buffer);
+  dolfin_assert(recv_buffer.size() == num_processes);
+  send_buffer.clear();
+
+  // Index received masters by bucket (process, offset in receive
+  // buffer). Distinct buckets with equal hash are told apart by the
+  // coordinate comparison below.
+  std::unordered_multimap<std::size_t, std::pair<std::size_t, std::size_t>>
+    bucket_to_master;
+  for (std::size_t p = 0; p < num_processes; ++p)
   {
-    for (std::size_t p = 0; p < num_processes; ++p)
+    const std::vector<double>& recv_p = recv_buffer[p];
+    for (std::size_t i = 0; i < recv_p.size(); i += record_size)
     {
-      // Slave mapped coordinates from process p
-      std::vector<double>& slave_mapped_coords_send_p
-        = slave_mapped_coords_send[p];
-
-      // Check if mapped slave falls within master entity bounding box
-      // on process p
-      if (in_bounding_box(slave_mapped_coords[i], bounding_boxes[p],
-                          sub_domain.map_tolerance))
+      if (recv_p[i] == 0.0)
       {
-        sent_slave_indices[p].push_back(slave_entities[i]);
-        slave_mapped_coords_send_p.insert(slave_mapped_coords_send_p.end(),
-                                          slave_mapped_coords[i].begin(),
-                                          slave_mapped_coords[i].end());
+        compute_buckets(&recv_p[i + 2], gdim, h, tol, buckets);
+        bucket_to_master.insert({buckets[0], {p, i}});
       }
     }
   }
 
-  // Send slave midpoints to possible owners of corresponding master
-  // entity
-  std::vector<std::vector<double>> slave_mapped_coords_recv;
-  MPI::all_to_all(mpi_comm,  slave_mapped_coords_send,
-                  slave_mapped_coords_recv);
-  dolfin_assert(slave_mapped_coords_recv.size() == num_processes);
-
-  // Check if this process owns the master facet for a received (mapped)
-  // slave
-  std::vector<double> coordinates(gdim);
-  std::vector<std::vector<unsigned int>> master_local_entity(num_processes);
-  for (std::size_t p = 0; p < num_processes; ++p)
+  // Match received slaves with masters in the buckets owned by this
+  // process and send (slave local index, master process, master
+  // local index) back to the slave process. If a master entity is
+  // shared, the lowest owning process is chosen.
+  std::vector<std::vector<unsigned int>> match_send(num_processes);
+  for (std::size_t q = 0; q < num_processes; ++q)
   {
-    const std::vector<double>& slave_mapped_coords_p
-      = slave_mapped_coords_recv[p];
-    for (std::size_t i = 0; i < slave_mapped_coords_p.size(); i += gdim)
+    const std::vector<double>& recv_q = recv_buffer[q];
+    for (std::size_t i = 0; i < recv_q.size(); i += record_size)
     {
-      // Unpack received mapped slave midpoint coordinate
-      std::copy(&slave_mapped_coords_p[i],
-                &slave_mapped_coords_p[i] + gdim, coordinates.begin());
-
-      // Check is this process has a master entity that is paired with
-      // a received slave entity
-      std::map<std::vector<double>, unsigned int>::const_iterator
-        it = master_coord_to_entity_index.find(coordinates);
-
-      // If this process owns the master, insert master entity index,
-      // else insert std::numeric_limits<unsigned int>::max()
-      if (it !=  master_coord_to_entity_index.end())
-        master_local_entity[p].push_back(it->second);
-      else
-        master_local_entity[p].push_back(std::numeric_limits<unsigned int>::max());
+      if (recv_q[i] != 1.0)
+        continue;
+
+      const double* y_slave = &recv_q[i + 2];
+      std::size_t master_process = num_processes;
+      unsigned int master_index = 0;
+      compute_buckets(y_slave, gdim, h, tol, buckets);
+      for (std::size_t b = 0; b < buckets.size(); ++b)
+      {
+        if (buckets[b] % num_processes != process_number)
+          continue;
+
+        auto range = bucket_to_master.equal_range(buckets[b]);
+        for (auto m = range.first; m != range.second; ++m)
+        {
+          const std::size_t p = m->second.first;
+          const double* x_master = &recv_buffer[p][m->second.second + 2];
+          bool match = true;
+          for (std::size_t k = 0; k < gdim; ++k)
+            match = match and std::abs(x_master[k] - y_slave[k]) <= tol;
+
+          if (match and p < master_process)
+          {
+            master_process = p;
+            master_index = recv_buffer[p][m->second.second + 1];
+          }
+        }
+      }
+
+      if (master_process < num_processes)
+      {
+        match_send[q].push_back(recv_q[i + 1]);
+        match_send[q].push_back(master_process);
+        match_send[q].push_back(master_index);
+      }
     }
   }
 
-  // Send local index of master entity back to owner of slave entity
-  std::vector<std::vector<unsigned int>> master_entity_local_index_recv;
-  MPI::all_to_all(mpi_comm, master_local_entity,
-                  master_entity_local_index_recv);
+  // Send matches back to slave processes
+  std::vector<std::vector<unsigned int>> match_recv;
+  MPI::all_to_all(mpi_comm, match_send, match_recv);
 
-  // Build map from slave facets on this process to master facet (local
-  // facet index, process owner)
+  // Build map from slave entities on this process to master entity
+  // (process owner, local index on owner). A slave may be matched by
+  // more than one bucket owner; keep the lowest master process.
   std::map<unsigned int, std::pair<unsigned int, unsigned int>>
     slave_to_master_entity;
-  std::size_t num_local_slave_entities = 0;
-  for (std::size_t p = 0; p < num_processes; ++p)
+  for (std::size_t p = 0; p < match_recv.size(); ++p)
   {
-    const std::vector<unsigned int> master_entity_index_p
-      = master_entity_local_index_recv[p];
-    const std::vector<unsigned int> sent_slaves_p = sent_slave_indices[p];
-    dolfin_assert(master_entity_index_p.size() == sent_slaves_p.size());
-
-    for (std::size_t i = 0; i < master_entity_index_p.size(); ++i)
+    const std::vector<unsigned int>& match_p = match_recv[p];
+    dolfin_assert(match_p.size() % 3 == 0);
+    for (std::size_t i = 0; i < match_p.size(); i += 3)
     {
-      if (master_entity_index_p[i] < std::numeric_limits<unsigned int>::max())
-      {
-        ++num_local_slave_entities;
-        slave_to_master_entity.insert({sent_slaves_p[i], {p, master_entity_index_p[i]}});
-      }
+      auto it = slave_to_master_entity.insert({match_p[i],
+            {match_p[i + 1], match_p[i + 2]}});
+      if (!it.second and match_p[i + 1] < it.first->second.first)
+        it.first->second = {match_p[i + 1], match_p[i + 2]};
     }
   }
 
@@ -358,25 +337,52 @@ PeriodicBoundaryComputation::masters_slaves(std::shared_ptr<const Mesh> mesh,
   return mf;
 }
 //-----------------------------------------------------------------------------
-bool
-PeriodicBoundaryComputation::in_bounding_box(const std::vector<double>& point,
-                                       const std::vector<double>& bounding_box,
-                                       const double tol)
+void
+PeriodicBoundaryComputation::compute_buckets(const double* x,
+                                             std::size_t gdim, double h,
+                                             double tol,
+                                             std::vector<std::size_t>& buckets)
 {
-  // Return false if bounding box is empty
-  if (bounding_box.empty())
-    return false;
-
-  const std::size_t gdim = point.size();
-  dolfin_assert(bounding_box.size() == 2*gdim);
+  // Bucket containing x, and the adjacent bucket in each direction
+  // if x lies within tol of the bucket boundary
+  dolfin_assert(gdim <= 3);
+  double lower[3], adjacent[3];
+  std::size_t directions[3];
+  std::size_t num_directions = 0;
   for (std::size_t i = 0; i < gdim; ++i)
   {
-    if (!(point[i] >= (bounding_box[i] - tol)
-          && point[i] <= (bounding_box[gdim + i] + tol)))
+    lower[i] = std::floor(x[i]/h);
+    if (x[i] - lower[i]*h <= tol)
     {
-      return false;
+      adjacent[i] = lower[i] - 1.0;
+      directions[num_directions++] = i;
     }
+    else if ((lower[i] + 1.0)*h - x[i] <= tol)
+    {
+      adjacent[i] = lower[i] + 1.0;
+      directions[num_directions++] = i;
+    }
+  }
+
+  // Hash all combinations of lower and adjacent bucket indices (the
+  // first is the bucket containing x)
+  const std::size_t num_buckets = 1 << num_directions;
+  buckets.resize(num_buckets);
+  double bucket[3];
+  std::hash<double> hash;
+  for (std::size_t b = 0; b < num_buckets; ++b)
+  {
+    std::copy(lower, lower + gdim, bucket);
+    for (std::size_t j = 0; j < num_directions; ++j)
+    {
+      if (b & (1 << j))
+        bucket[directions[j]] = adjacent[directions[j]];
+    }
+
+    std::size_t seed = 0;
+    for (std::size_t i = 0; i < gdim; ++i)
+      seed ^= hash(bucket[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    buckets[b] = seed;
   }
-  return true;
 }
 //-----------------------------------------------------------------------------
@@ -62,10 +62,12 @@ namespace dolfin
 
   private:
 
-    // Return true is point lies within bounding box
-    static bool in_bounding_box(const std::vector<double>& point,
-                                const std::vector<double>& bounding_box,
-                                const double tol);
+    // Compute hashes of the buckets (cubes of size h) that may
+    // contain a point equal to x to within tol. The first bucket
+    // contains x.
+    static void compute_buckets(const double* x, std::size_t gdim,
+                                double h, double tol,
+                                std::vector<std::size_t>& buckets);
 
   };
 
@@ -20,10 +20,11 @@
 // First added:  2007-04-24
 // Last changed: 2011-08-31
 
+#include <algorithm>
+#include <cstdint>
 #include <dolfin/common/Array.h>
-#include <dolfin/common/RangedIndexSet.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/log/log.h>
-#include <dolfin/log/Progress.h>
 #include "Mesh.h"
 #include "MeshData.h"
 #include "MeshEntity.h"
@@ -62,6 +63,26 @@ bool SubDomain::inside(Eigen::Ref<const Eigen::VectorXd> x, bool on_boundary) co
   return false;
 }
 //-----------------------------------------------------------------------------
+void SubDomain::inside_points(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, 1>> values,
+                              Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic,
+                                                             Eigen::Dynamic,
+                                                             Eigen::RowMajor>> x,
+                              bool on_boundary) const
+{
+  dolfin_assert(values.size() == x.rows());
+
+  // Redirect to single point inside, with threads if inside() is
+  // thread safe
+  const int num_threads = thread_safe() ? SubSystemsManager::num_threads() : 1;
+  const std::int64_t num_points = x.rows();
+  #pragma omp parallel for num_threads(num_threads) schedule(static) if(num_threads > 1)
+  for (std::int64_t i = 0; i < num_points; ++i)
+  {
+    const Array<double> _x(x.cols(), const_cast<double*>(x.row(i).data()));
+    values[i] = inside(_x, on_boundary);
+  }
+}
+//-----------------------------------------------------------------------------
 void SubDomain::map(const Array<double>& x, Array<double>& y) const
 {
   Eigen::Map<const Eigen::VectorXd> _x(x.data(), x.size());
@@ -183,97 +204,13 @@ void SubDomain::apply_markers(S& sub_domains,
 {
   log(TRACE, "Computing sub domain markers for sub domain %d.", sub_domain);
 
-  // Get the dimension of the entities we are marking
-  const std::size_t dim = sub_domains.dim();
-
-  // Compute connectivities for boundary detection, if necessary
-  const std::size_t D = mesh.topology().dim();
-  if (dim < D)
-  {
-    mesh.init(dim);
-    if (dim != D - 1)
-      mesh.init(dim, D - 1);
-    mesh.init(D - 1, D);
-  }
-
-  // Set geometric dimension (needed for SWIG interface)
-  _geometric_dimension = mesh.geometry().dim();
-
-  // Speed up the computation by only checking each vertex once (or
-  // twice if it is on the boundary for some but not all facets).
-  RangedIndexSet boundary_visited(mesh.num_vertices());
-  RangedIndexSet interior_visited(mesh.num_vertices());
-  std::vector<bool> boundary_inside(mesh.num_vertices());
-  std::vector<bool> interior_inside(mesh.num_vertices());
-
-  // Always false when marking cells
-  bool on_boundary = false;
+  // Compute entities inside sub domain
+  std::vector<std::size_t> entities;
+  compute_entities_inside(entities, sub_domains.dim(), mesh, check_midpoint);
 
-  // Compute sub domain markers
-  Progress p("Computing sub domain markers", mesh.num_entities(dim));
-  for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
-  {
-    // Check if entity is on the boundary if entity is a facet
-    if (dim == D - 1)
-      on_boundary = (entity->num_global_entities(D) == 1);
-    // Or, if entity is of topological dimension less than D - 1, check if any connected
-    // facet is on the boundary
-    else if (dim < D - 1)
-    {
-      on_boundary = false;
-      for (std::size_t f(0); f < entity->num_entities(D - 1); ++f)
-      {
-        std::size_t facet_id = entity->entities(D - 1)[f];
-        Facet facet(mesh, facet_id);
-        if (facet.num_global_entities(D) == 1)
-        {
-          on_boundary = true;
-          break;
-        }
-      }
-    }
-
-    // Select the visited-cache to use for this entity
-    RangedIndexSet&    is_visited = (on_boundary ? boundary_visited : interior_visited);
-    std::vector<bool>& is_inside  = (on_boundary ? boundary_inside  : interior_inside);
-
-    // Start by assuming all points are inside
-    bool all_points_inside = true;
-
-    // Check all incident vertices if dimension is > 0 (not a vertex)
-    if (entity->dim() > 0)
-    {
-      for (VertexIterator vertex(*entity); !vertex.end(); ++vertex)
-      {
-        if (is_visited.insert(vertex->index()))
-        {
-          Array<double> x(_geometric_dimension, const_cast<double*>(vertex->x()));
-          is_inside[vertex->index()] = inside(x, on_boundary);
-        }
-
-        if (!is_inside[vertex->index()])
-        {
-          all_points_inside = false;
-          break;
-        }
-      }
-    }
-
-    // Check midpoint (works also in the case when we have a single vertex)
-    if (all_points_inside && check_midpoint)
-    {
-      Array<double> x(_geometric_dimension,
-                      const_cast<double*>(entity->midpoint().coordinates()));
-      if (!inside(x, on_boundary))
-        all_points_inside = false;
-    }
-
-    // Mark entity with all vertices inside
-    if (all_points_inside)
-      sub_domains.set_value(entity->index(), sub_domain);
-
-    p++;
-  }
+  // Mark entities
+  for (std::size_t i = 0; i < entities.size(); ++i)
+    sub_domains.set_value(entities[i], sub_domain);
 }
 //-----------------------------------------------------------------------------
 template<typename T>
@@ -283,11 +220,22 @@ void SubDomain::apply_markers(std::map<std::size_t, std::size_t>& sub_domains,
                               const Mesh& mesh,
                               bool check_midpoint) const
 {
-  // FIXME: This function can probably be folded into the above
-  //        function operator[] in std::map and MeshFunction.
-
   log(TRACE, "Computing sub domain markers for sub domain %d.", sub_domain);
 
+  // Compute entities inside sub domain
+  std::vector<std::size_t> entities;
+  compute_entities_inside(entities, dim, mesh, check_midpoint);
+
+  // Mark entities
+  for (std::size_t i = 0; i < entities.size(); ++i)
+    sub_domains[entities[i]] = sub_domain;
+}
+//-----------------------------------------------------------------------------
+void SubDomain::compute_entities_inside(std::vector<std::size_t>& entities,
+                                        std::size_t dim,
+                                        const Mesh& mesh,
+                                        bool check_midpoint) const
+{
   // Compute connectivities for boundary detection, if necessary
   const std::size_t D = mesh.topology().dim();
   if (dim < D)
@@ -300,84 +248,160 @@ void SubDomain::apply_markers(std::map<std::size_t, std::size_t>& sub_domains,
 
   // Set geometric dimension (needed for SWIG interface)
   _geometric_dimension = mesh.geometry().dim();
+  const std::size_t gdim = _geometric_dimension;
 
-  // Speed up the computation by only checking each vertex once (or
-  // twice if it is on the boundary for some but not all facets).
-  RangedIndexSet boundary_visited(mesh.num_vertices());
-  RangedIndexSet interior_visited(mesh.num_vertices());
-  std::vector<bool> boundary_inside(mesh.num_vertices());
-  std::vector<bool> interior_inside(mesh.num_vertices());
+  // Number of threads for entity loops and (thread safe) subdomains
+  const int num_threads = SubSystemsManager::num_threads();
 
-  // Always false when marking cells
-  bool on_boundary = false;
-
-  // Compute sub domain markers
-  Progress p("Computing sub domain markers", mesh.num_entities(dim));
-  for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
+  // Check which entities are on the boundary (always false when
+  // marking cells)
+  const std::int64_t num_entities = mesh.topology().ghost_offset(dim);
+  std::vector<char> on_boundary(num_entities, 0);
+  if (dim < D)
   {
-    // Check if entity is on the boundary if entity is a facet
-    if (dim == D - 1)
-      on_boundary = (entity->num_global_entities(D) == 1);
-    // Or, if entity is of topological dimension less than D - 1, check if any connected
-    // facet is on the boundary
-    else if (dim < D - 1)
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int64_t e = 0; e < num_entities; ++e)
     {
-      on_boundary = false;
-      for (std::size_t f(0); f < entity->num_entities(D - 1); ++f)
+      const MeshEntity entity(mesh, dim, e);
+
+      // Check if entity is on the boundary if entity is a facet
+      if (dim == D - 1)
+        on_boundary[e] = (entity.num_global_entities(D) == 1);
+      // Or, if entity is of topological dimension less than D - 1,
+      // check if any connected facet is on the boundary
+      else
       {
-        std::size_t facet_id = entity->entities(D - 1)[f];
-        Facet facet(mesh, facet_id);
-        if (facet.num_global_entities(D) == 1)
+        for (std::size_t f = 0; f < entity.num_entities(D - 1); ++f)
         {
-          on_boundary = true;
-          break;
+          const Facet facet(mesh, entity.entities(D - 1)[f]);
+          if (facet.num_global_entities(D) == 1)
+          {
+            on_boundary[e] = 1;
+            break;
+          }
         }
       }
     }
+  }
 
-    // Select the visited-cache to use for this entity
-    RangedIndexSet&    is_visited = (on_boundary ? boundary_visited : interior_visited);
-    std::vector<bool>& is_inside  = (on_boundary ? boundary_inside  : interior_inside);
-
-    // Start by assuming all points are inside
-    bool all_points_inside = true;
+  // Collect the incident vertices of all entities if dimension is >
+  // 0 (not a vertex). Each vertex is checked once (or twice if it is
+  // on the boundary for some but not all facets), with all vertices
+  // for the same value of on_boundary checked in one call.
+  std::vector<int> vertex_points[2];
+  std::vector<double> x[2];
+  std::vector<bool> is_inside[2];
+  const std::size_t num_entity_vertices = mesh.type().num_vertices(dim);
+  if (dim > 0)
+  {
+    mesh.init(dim, 0);
+    const MeshConnectivity& connectivity = mesh.topology()(dim, 0);
+    for (std::size_t b = 0; b < 2; ++b)
+      vertex_points[b].assign(mesh.num_vertices(), -1);
 
-    // Check all incident vertices if dimension is > 0 (not a vertex)
-    if (entity->dim() > 0)
+    for (std::int64_t e = 0; e < num_entities; ++e)
     {
-      for (VertexIterator vertex(*entity); !vertex.end(); ++vertex)
+      const std::size_t b = on_boundary[e];
+      const unsigned int* vertices = connectivity(e);
+      for (std::size_t i = 0; i < num_entity_vertices; ++i)
       {
-        if (is_visited.insert(vertex->index()))
+        int& point = vertex_points[b][vertices[i]];
+        if (point < 0)
         {
-          Array<double> x(_geometric_dimension, const_cast<double*>(vertex->x()));
-          is_inside[vertex->index()] = inside(x, on_boundary);
+          point = x[b].size()/gdim;
+          const double* _x = mesh.geometry().x(vertices[i]);
+          x[b].insert(x[b].end(), _x, _x + gdim);
         }
+      }
+    }
 
-        if (!is_inside[vertex->index()])
+    for (std::size_t b = 0; b < 2; ++b)
+      check_points(is_inside[b], x[b], b == 1);
+  }
+
+  // Find entities with all vertices inside
+  std::vector<char> all_points_inside(num_entities, 1);
+  if (dim > 0)
+  {
+    const MeshConnectivity& connectivity = mesh.topology()(dim, 0);
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int64_t e = 0; e < num_entities; ++e)
+    {
+      const std::size_t b = on_boundary[e];
+      const unsigned int* vertices = connectivity(e);
+      for (std::size_t i = 0; i < num_entity_vertices; ++i)
+      {
+        if (!is_inside[b][vertex_points[b][vertices[i]]])
         {
-          all_points_inside = false;
+          all_points_inside[e] = 0;
           break;
         }
       }
     }
+  }
+
+  std::vector<std::size_t> candidates;
+  for (std::int64_t e = 0; e < num_entities; ++e)
+    if (all_points_inside[e])
+      candidates.push_back(e);
+
+  // Check midpoints (works also in the case when we have a single
+  // vertex)
+  entities.clear();
+  if (!check_midpoint)
+  {
+    entities = candidates;
+    return;
+  }
+
+  std::vector<std::size_t> midpoint_entities[2];
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+  {
+    const std::size_t b = on_boundary[candidates[i]];
+    midpoint_entities[b].push_back(candidates[i]);
+  }
 
-    // Check midpoint (works also in the case when we have a single vertex)
-    if (all_points_inside && check_midpoint)
+  for (std::size_t b = 0; b < 2; ++b)
+  {
+    const std::vector<std::size_t>& _entities = midpoint_entities[b];
+    const std::int64_t num_midpoints = _entities.size();
+    x[b].resize(num_midpoints*gdim);
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int64_t i = 0; i < num_midpoints; ++i)
     {
-      Array<double> x(_geometric_dimension,
-                      const_cast<double*>(entity->midpoint().coordinates()));
-      if (!inside(x, on_boundary))
-        all_points_inside = false;
+      const Point midpoint = MeshEntity(mesh, dim, _entities[i]).midpoint();
+      std::copy(midpoint.coordinates(), midpoint.coordinates() + gdim,
+                x[b].begin() + i*gdim);
     }
 
-    // Mark entity with all vertices inside
-    if (all_points_inside)
-      sub_domains[entity->index()] =  sub_domain;
-
-    p++;
+    check_points(is_inside[b], x[b], b == 1);
+    for (std::int64_t i = 0; i < num_midpoints; ++i)
+    {
+      if (is_inside[b][i])
+        entities.push_back(_entities[i]);
+    }
   }
 }
 //-----------------------------------------------------------------------------
+void SubDomain::check_points(std::vector<bool>& values,
+                             const std::vector<double>& x,
+                             bool on_boundary) const
+{
+  const std::size_t gdim = _geometric_dimension;
+  const std::size_t num_points = x.size()/gdim;
+  values.resize(num_points);
+  if (num_points == 0)
+    return;
+
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                        Eigen::RowMajor> RowMatrixXd;
+  const Eigen::Map<const RowMatrixXd> _x(x.data(), num_points, gdim);
+  Eigen::Array<bool, Eigen::Dynamic, 1> _values(num_points);
+  inside_points(_values, _x, on_boundary);
+  for (std::size_t i = 0; i < num_points; ++i)
+    values[i] = _values[i];
+}
+//-----------------------------------------------------------------------------
 void SubDomain::set_property(std::string name, double value)
 {
   dolfin_error("SubDomain.cpp",
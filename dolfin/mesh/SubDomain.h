@@ -23,6 +23,7 @@
 
 #include <cstddef>
 #include <map>
+#include <vector>
 #include <dolfin/common/constants.h>
 #include <Eigen/Dense>
 
@@ -75,6 +76,36 @@ namespace dolfin
     ///         True for points inside the subdomain.
     virtual bool inside(Eigen::Ref<const Eigen::VectorXd> x, bool on_boundary) const;
 
+    /// Check which of a set of points are inside the subdomain. This
+    /// is called by mark() with all points that are checked for the
+    /// same value of on_boundary, and the default implementation
+    /// calls inside() for each point. Subdomains may overload it to
+    /// check all points in one call, e.g. with NumPy in Python.
+    ///
+    /// @param    values (Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, 1>>)
+    ///         True for the points inside the subdomain (num_points).
+    /// @param    x (Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>)
+    ///         The coordinates of the points (num_points x gdim).
+    /// @param   on_boundary (bool)
+    ///         True for points on the boundary.
+    virtual void inside_points(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, 1>> values,
+                               Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic,
+                                                              Eigen::Dynamic,
+                                                              Eigen::RowMajor>> x,
+                               bool on_boundary) const;
+
+    /// Return true if inside() may be called concurrently from
+    /// several threads. If so, the default inside_points() checks
+    /// the points with the number of threads given by the global
+    /// parameter "num_threads". The default is false; subdomains
+    /// without mutable state (e.g. compiled subdomains) may overload
+    /// it to return true.
+    ///
+    /// @return    bool
+    ///         True if inside() is thread safe.
+    virtual bool thread_safe() const
+    { return false; }
+
     /// Map coordinate x in domain H to coordinate y in domain G (used for
     /// periodic boundary conditions)
     ///
@@ -281,6 +312,19 @@ namespace dolfin
 
   private:
 
+    // Compute the entities of given dimension with all vertices (and
+    // optionally the midpoint) inside the subdomain
+    void compute_entities_inside(std::vector<std::size_t>& entities,
+                                 std::size_t dim,
+                                 const Mesh& mesh,
+                                 bool check_midpoint) const;
+
+    // Check which of the given points (flattened num_points x gdim
+    // array) are inside the subdomain
+    void check_points(std::vector<bool>& values,
+                      const std::vector<double>& x,
+                      bool on_boundary) const;
+
     /// Apply marker of type T (most likely an std::size_t) to object of class
     /// S (most likely MeshFunction or MeshValueCollection)
     template<typename S, typename T>
@@ -16,18 +16,25 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2009-02-11
-// Last changed: 2014-02-06
+// Last changed: 2017-10-14
 
+#include <algorithm>
 #include <limits>
 #include <map>
+#include <set>
 #include <vector>
 
+#include <dolfin/common/MPI.h>
 #include <dolfin/log/log.h>
 #include "Cell.h"
+#include "DistributedMeshTools.h"
+#include "Facet.h"
+#include "LocalMeshData.h"
 #include "Mesh.h"
 #include "MeshEditor.h"
 #include "MeshEntityIterator.h"
 #include "MeshFunction.h"
+#include "MeshPartitioning.h"
 #include "SubDomain.h"
 #include "SubMesh.h"
 #include "Vertex.h"
@@ -35,8 +42,68 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Look up entries of a distributed array, where each process holds
+  // the block of local_values following the blocks of the lower
+  // ranked processes, at the given global positions
+  std::vector<std::int64_t>
+  distributed_lookup(MPI_Comm mpi_comm,
+                     const std::vector<std::int64_t>& local_values,
+                     const std::vector<std::int64_t>& global_positions)
+  {
+    const std::size_t mpi_size = dolfin::MPI::size(mpi_comm);
+    const std::size_t mpi_rank = dolfin::MPI::rank(mpi_comm);
+
+    // Offsets of the blocks of each process
+    std::vector<std::int64_t> num_values;
+    dolfin::MPI::all_gather(mpi_comm, (std::int64_t) local_values.size(), num_values);
+    std::vector<std::int64_t> offsets(mpi_size + 1, 0);
+    for (std::size_t p = 0; p < mpi_size; ++p)
+      offsets[p + 1] = offsets[p] + num_values[p];
+
+    // Send requests to the processes holding the entries
+    std::vector<std::vector<std::int64_t>> send_positions(mpi_size);
+    std::vector<std::vector<std::size_t>> request_index(mpi_size);
+    for (std::size_t i = 0; i < global_positions.size(); ++i)
+    {
+      const std::size_t p
+        = std::upper_bound(offsets.begin(), offsets.end(),
+                           global_positions[i]) - offsets.begin() - 1;
+      dolfin_assert(p < mpi_size);
+      send_positions[p].push_back(global_positions[i]);
+      request_index[p].push_back(i);
+    }
+    std::vector<std::vector<std::int64_t>> recv_positions;
+    dolfin::MPI::all_to_all(mpi_comm, send_positions, recv_positions);
+
+    // Reply with the requested entries
+    std::vector<std::vector<std::int64_t>> send_values(mpi_size);
+    for (std::size_t p = 0; p < mpi_size; ++p)
+    {
+      send_values[p].reserve(recv_positions[p].size());
+      for (std::size_t j = 0; j < recv_positions[p].size(); ++j)
+      {
+        const std::int64_t pos = recv_positions[p][j] - offsets[mpi_rank];
+        dolfin_assert(pos >= 0 && pos < num_values[mpi_rank]);
+        send_values[p].push_back(local_values[pos]);
+      }
+    }
+    std::vector<std::vector<std::int64_t>> recv_values;
+    dolfin::MPI::all_to_all(mpi_comm, send_values, recv_values);
+
+    std::vector<std::int64_t> values(global_positions.size());
+    for (std::size_t p = 0; p < mpi_size; ++p)
+      for (std::size_t j = 0; j < recv_values[p].size(); ++j)
+        values[request_index[p][j]] = recv_values[p][j];
+
+    return values;
+  }
+}
+
 //-----------------------------------------------------------------------------
 SubMesh::SubMesh(const Mesh& mesh, const SubDomain& sub_domain)
+  : Mesh(mesh.mpi_comm())
 {
   // Create mesh function and mark sub domain
   MeshFunction<std::size_t> sub_domains(reference_to_no_delete_pointer(mesh),
@@ -55,7 +122,7 @@ SubMesh::SubMesh(const Mesh& mesh, const SubDomain& sub_domain)
 //-----------------------------------------------------------------------------
 SubMesh::SubMesh(const Mesh& mesh,
                  const MeshFunction<std::size_t>& sub_domains,
-                 std::size_t sub_domain)
+                 std::size_t sub_domain) : Mesh(mesh.mpi_comm())
 {
   // Copy data into std::vector
   const std::vector<std::size_t> _sub_domains(sub_domains.values(),
@@ -67,6 +134,7 @@ SubMesh::SubMesh(const Mesh& mesh,
 }
 //----------------------------------------------------------------------------
 SubMesh::SubMesh(const Mesh& mesh, std::size_t sub_domain)
+  : Mesh(mesh.mpi_comm())
 {
   // Topological dimension
   const std::size_t D = mesh.topology().dim();
@@ -102,6 +170,13 @@ void SubMesh::init(const Mesh& mesh,
                    const std::vector<std::size_t>& sub_domains,
                    std::size_t sub_domain)
 {
+  // Distributed meshes are extracted without gathering cells
+  if (MPI::size(mesh.mpi_comm()) > 1)
+  {
+    init_distributed(mesh, sub_domains, sub_domain);
+    return;
+  }
+
   // Open mesh for editing
   MeshEditor editor;
   const std::size_t D = mesh.topology().dim();
@@ -192,10 +267,6 @@ void SubMesh::init(const Mesh& mesh,
        it != parent_to_submesh_vertex_indices.end(); ++it)
   {
     Vertex vertex(mesh, it->first);
-    if (MPI::size(mesh.mpi_comm()) > 1)
-      not_working_in_parallel("SubMesh::init");
-
-    // FIXME: Get global vertex index
     editor.add_vertex(it->second, vertex.point());
     parent_vertex_indices[it->second] = it->first;
   }
@@ -320,3 +391,304 @@ void SubMesh::init(const Mesh& mesh,
 
 }
 //-----------------------------------------------------------------------------
+void SubMesh::init_distributed(const Mesh& mesh,
+                               const std::vector<std::size_t>& sub_domains,
+                               std::size_t sub_domain)
+{
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t mpi_size = MPI::size(mpi_comm);
+  const std::size_t mpi_rank = MPI::rank(mpi_comm);
+  const std::size_t D = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_vertices_per_cell = mesh.type().num_vertices(D);
+  const std::string ghost_mode = mesh.ghost_mode();
+
+  for (std::size_t d = 0; d <= mesh.domains().max_dim(); ++d)
+  {
+    if (mesh.domains().num_marked(d) > 0)
+    {
+      warning("Mesh domains of the parent mesh are not transferred to a distributed SubMesh");
+      break;
+    }
+  }
+
+  // Owned parent cells in sub mesh. Each stays on its process and
+  // is numbered globally after the cells of lower ranked processes.
+  const std::size_t num_owned_cells = mesh.topology().ghost_offset(D);
+  std::vector<std::size_t> parent_cells;
+  for (std::size_t c = 0; c < num_owned_cells; ++c)
+  {
+    if (sub_domains[c] == sub_domain)
+      parent_cells.push_back(c);
+  }
+  const std::size_t num_sub_cells = parent_cells.size();
+  const std::size_t cell_offset
+    = MPI::global_offset(mpi_comm, num_sub_cells, true);
+  const std::size_t num_global_cells = MPI::sum(mpi_comm, num_sub_cells);
+
+  // Send the vertices of the sub mesh cells, with coordinates, to
+  // the process owning the range of their parent global index
+  const std::size_t num_parent_vertices = mesh.size_global(0);
+  std::vector<bool> vertex_used(mesh.num_vertices(), false);
+  std::vector<std::vector<std::int64_t>> send_vertices(mpi_size);
+  std::vector<std::vector<double>> send_coordinates(mpi_size);
+  std::vector<std::vector<std::size_t>> send_local_vertices(mpi_size);
+  for (std::size_t i = 0; i < num_sub_cells; ++i)
+  {
+    const Cell cell(mesh, parent_cells[i]);
+    for (VertexIterator v(cell); !v.end(); ++v)
+    {
+      if (vertex_used[v->index()])
+        continue;
+      vertex_used[v->index()] = true;
+
+      const std::int64_t global_index = v->global_index();
+      const std::size_t p
+        = MPI::index_owner(mpi_comm, global_index, num_parent_vertices);
+      send_vertices[p].push_back(global_index);
+      send_local_vertices[p].push_back(v->index());
+      const double* x = v->x();
+      send_coordinates[p].insert(send_coordinates[p].end(), x, x + gdim);
+    }
+  }
+  std::vector<std::vector<std::int64_t>> recv_vertices;
+  std::vector<std::vector<double>> recv_coordinates;
+  MPI::all_to_all(mpi_comm, send_vertices, recv_vertices);
+  MPI::all_to_all(mpi_comm, send_coordinates, recv_coordinates);
+
+  // Number the received vertices contiguously, in the order of their
+  // parent global index
+  std::vector<std::int64_t> owned_parent_vertices;
+  for (std::size_t p = 0; p < mpi_size; ++p)
+  {
+    owned_parent_vertices.insert(owned_parent_vertices.end(),
+                                 recv_vertices[p].begin(),
+                                 recv_vertices[p].end());
+  }
+  std::sort(owned_parent_vertices.begin(), owned_parent_vertices.end());
+  owned_parent_vertices.erase(std::unique(owned_parent_vertices.begin(),
+                                          owned_parent_vertices.end()),
+                              owned_parent_vertices.end());
+  const std::size_t num_owned_vertices = owned_parent_vertices.size();
+  const std::size_t vertex_offset
+    = MPI::global_offset(mpi_comm, num_owned_vertices, true);
+  const std::size_t num_global_vertices
+    = MPI::sum(mpi_comm, num_owned_vertices);
+
+  LocalMeshData local_data(mpi_comm);
+  local_data.geometry.dim = gdim;
+  local_data.geometry.num_global_vertices = num_global_vertices;
+  local_data.geometry.vertex_indices.resize(num_owned_vertices);
+  local_data.geometry.vertex_coordinates.resize(boost::extents[num_owned_vertices][gdim]);
+  for (std::size_t i = 0; i < num_owned_vertices; ++i)
+    local_data.geometry.vertex_indices[i] = vertex_offset + i;
+
+  // Store coordinates and reply with the new global vertex indices
+  std::vector<std::vector<std::int64_t>> send_numbers(mpi_size);
+  for (std::size_t p = 0; p < mpi_size; ++p)
+  {
+    for (std::size_t j = 0; j < recv_vertices[p].size(); ++j)
+    {
+      const std::size_t pos
+        = std::lower_bound(owned_parent_vertices.begin(),
+                           owned_parent_vertices.end(),
+                           recv_vertices[p][j])
+        - owned_parent_vertices.begin();
+      for (std::size_t k = 0; k < gdim; ++k)
+      {
+        local_data.geometry.vertex_coordinates[pos][k]
+          = recv_coordinates[p][j*gdim + k];
+      }
+      send_numbers[p].push_back(vertex_offset + pos);
+    }
+  }
+  std::vector<std::vector<std::int64_t>> recv_numbers;
+  MPI::all_to_all(mpi_comm, send_numbers, recv_numbers);
+
+  std::vector<std::int64_t> sub_vertex_index(mesh.num_vertices(), -1);
+  for (std::size_t p = 0; p < mpi_size; ++p)
+  {
+    dolfin_assert(recv_numbers[p].size() == send_local_vertices[p].size());
+    for (std::size_t j = 0; j < recv_numbers[p].size(); ++j)
+      sub_vertex_index[send_local_vertices[p][j]] = recv_numbers[p][j];
+  }
+
+  // Cell topology in the new global vertex numbering
+  local_data.topology.dim = D;
+  local_data.topology.cell_type = mesh.type().cell_type();
+  local_data.topology.num_vertices_per_cell = num_vertices_per_cell;
+  local_data.topology.num_global_cells = num_global_cells;
+  local_data.topology.global_cell_indices.resize(num_sub_cells);
+  local_data.topology.cell_vertices.resize(boost::extents[num_sub_cells][num_vertices_per_cell]);
+  for (std::size_t i = 0; i < num_sub_cells; ++i)
+  {
+    local_data.topology.global_cell_indices[i] = cell_offset + i;
+    const Cell cell(mesh, parent_cells[i]);
+    for (VertexIterator v(cell); !v.end(); ++v)
+    {
+      dolfin_assert(sub_vertex_index[v->index()] >= 0);
+      local_data.topology.cell_vertices[i][v.pos()]
+        = sub_vertex_index[v->index()];
+    }
+  }
+
+  // Ghost processes of sub mesh cells adjacent by facet to sub mesh
+  // cells owned by other processes
+  std::map<std::int64_t, std::vector<int>> ghost_procs;
+  if (ghost_mode != "none")
+  {
+    mesh.init(D - 1, D);
+    DistributedMeshTools::number_entities(mesh, D - 1);
+    const std::map<std::int32_t, std::set<unsigned int>>& shared_facets
+      = mesh.topology().shared_entities(D - 1);
+    const std::vector<unsigned int>& cell_owner = mesh.topology().cell_owner();
+
+    std::vector<std::set<int>> neighbour_procs(num_sub_cells);
+    std::vector<std::vector<std::int64_t>> send_facets(mpi_size);
+    for (std::size_t i = 0; i < num_sub_cells; ++i)
+    {
+      const Cell cell(mesh, parent_cells[i]);
+      for (FacetIterator f(cell); !f.end(); ++f)
+      {
+        if (f->num_entities(D) == 2)
+        {
+          // Neighbour is present on this process
+          const std::size_t neighbour = (f->entities(D)[0] == cell.index())
+            ? f->entities(D)[1] : f->entities(D)[0];
+          if (neighbour >= num_owned_cells
+              && sub_domains[neighbour] == sub_domain)
+          {
+            neighbour_procs[i].insert(cell_owner[neighbour - num_owned_cells]);
+          }
+        }
+        else
+        {
+          // Ask processes sharing the facet whether their cell is in
+          // the sub mesh
+          std::map<std::int32_t, std::set<unsigned int>>::const_iterator
+            shared = shared_facets.find(f->index());
+          if (shared == shared_facets.end())
+            continue;
+          for (std::set<unsigned int>::const_iterator p
+                 = shared->second.begin(); p != shared->second.end(); ++p)
+          {
+            send_facets[*p].push_back(f->global_index());
+            send_facets[*p].push_back(i);
+          }
+        }
+      }
+    }
+    std::vector<std::vector<std::int64_t>> recv_facets;
+    MPI::all_to_all(mpi_comm, send_facets, recv_facets);
+
+    // Map from global to local index of shared facets
+    std::map<std::int64_t, std::size_t> global_to_local_facet;
+    for (std::map<std::int32_t, std::set<unsigned int>>::const_iterator
+           shared = shared_facets.begin(); shared != shared_facets.end();
+         ++shared)
+    {
+      const Facet facet(mesh, shared->first);
+      global_to_local_facet[facet.global_index()] = shared->first;
+    }
+
+    std::vector<std::vector<std::int64_t>> send_answers(mpi_size);
+    for (std::size_t p = 0; p < mpi_size; ++p)
+    {
+      for (std::size_t j = 0; j < recv_facets[p].size(); j += 2)
+      {
+        std::map<std::int64_t, std::size_t>::const_iterator local
+          = global_to_local_facet.find(recv_facets[p][j]);
+        dolfin_assert(local != global_to_local_facet.end());
+        const Facet facet(mesh, local->second);
+        for (std::size_t k = 0; k < facet.num_entities(D); ++k)
+        {
+          const std::size_t c = facet.entities(D)[k];
+          if (c < num_owned_cells && sub_domains[c] == sub_domain)
+          {
+            send_answers[p].push_back(recv_facets[p][j + 1]);
+            break;
+          }
+        }
+      }
+    }
+    std::vector<std::vector<std::int64_t>> recv_answers;
+    MPI::all_to_all(mpi_comm, send_answers, recv_answers);
+    for (std::size_t p = 0; p < mpi_size; ++p)
+      for (std::size_t j = 0; j < recv_answers[p].size(); ++j)
+        neighbour_procs[recv_answers[p][j]].insert(p);
+
+    for (std::size_t i = 0; i < num_sub_cells; ++i)
+    {
+      if (neighbour_procs[i].empty())
+        continue;
+      std::vector<int>& procs = ghost_procs[i];
+      procs.push_back(mpi_rank);
+      procs.insert(procs.end(), neighbour_procs[i].begin(),
+                   neighbour_procs[i].end());
+    }
+  }
+
+  // Build distributed sub mesh, keeping each cell on its process
+  const std::vector<int> cell_partition(num_sub_cells, mpi_rank);
+  MeshPartitioning::build_distributed_mesh(*this, local_data, cell_partition,
+                                           ghost_procs, ghost_mode);
+
+  // Look up the global parent index of each local cell and vertex
+  // from the processes owning their global index ranges
+  std::vector<std::int64_t> owned_parent_cells(num_sub_cells);
+  for (std::size_t i = 0; i < num_sub_cells; ++i)
+    owned_parent_cells[i] = Cell(mesh, parent_cells[i]).global_index();
+
+  std::vector<std::int64_t> sub_global_cells(num_cells());
+  for (CellIterator c(*this, "all"); !c.end(); ++c)
+    sub_global_cells[c->index()] = c->global_index();
+  const std::vector<std::int64_t> parent_global_cells
+    = distributed_lookup(mpi_comm, owned_parent_cells, sub_global_cells);
+
+  std::vector<std::int64_t> sub_global_vertices(num_vertices());
+  for (VertexIterator v(*this, "all"); !v.end(); ++v)
+    sub_global_vertices[v->index()] = v->global_index();
+  const std::vector<std::int64_t> parent_global_vertices
+    = distributed_lookup(mpi_comm, owned_parent_vertices, sub_global_vertices);
+
+  // Local parent index of local sub mesh entities, where present
+  std::map<std::int64_t, std::size_t> parent_global_to_local_cell;
+  for (CellIterator c(mesh, "all"); !c.end(); ++c)
+    parent_global_to_local_cell[c->global_index()] = c->index();
+  std::map<std::int64_t, std::size_t> parent_global_to_local_vertex;
+  for (VertexIterator v(mesh, "all"); !v.end(); ++v)
+    parent_global_to_local_vertex[v->global_index()] = v->index();
+
+  std::vector<std::size_t>& parent_cell_indices
+    = data().create_array("parent_cell_indices", D);
+  std::vector<std::size_t>& parent_global_cell_indices
+    = data().create_array("parent_global_cell_indices", D);
+  parent_cell_indices.assign(num_cells(),
+                             std::numeric_limits<std::size_t>::max());
+  parent_global_cell_indices.resize(num_cells());
+  for (std::size_t i = 0; i < num_cells(); ++i)
+  {
+    parent_global_cell_indices[i] = parent_global_cells[i];
+    std::map<std::int64_t, std::size_t>::const_iterator it
+      = parent_global_to_local_cell.find(parent_global_cells[i]);
+    if (it != parent_global_to_local_cell.end())
+      parent_cell_indices[i] = it->second;
+  }
+
+  std::vector<std::size_t>& parent_vertex_indices
+    = data().create_array("parent_vertex_indices", 0);
+  std::vector<std::size_t>& parent_global_vertex_indices
+    = data().create_array("parent_global_vertex_indices", 0);
+  parent_vertex_indices.assign(num_vertices(),
+                               std::numeric_limits<std::size_t>::max());
+  parent_global_vertex_indices.resize(num_vertices());
+  for (std::size_t i = 0; i < num_vertices(); ++i)
+  {
+    parent_global_vertex_indices[i] = parent_global_vertices[i];
+    std::map<std::int64_t, std::size_t>::const_iterator it
+      = parent_global_to_local_vertex.find(parent_global_vertices[i]);
+    if (it != parent_global_to_local_vertex.end())
+      parent_vertex_indices[i] = it->second;
+  }
+}
+//-----------------------------------------------------------------------------
@@ -36,6 +36,16 @@ namespace dolfin
   /// subsets of a single global mesh. A mapping from the vertices of
   /// the sub mesh to the vertices of the parent mesh is stored as the
   /// mesh data named "parent_vertex_indices".
+  ///
+  /// In parallel the sub mesh is distributed like its parent: each
+  /// process keeps the marked cells it owns, vertices are numbered
+  /// globally without gathering the mesh, and ghost cells are added
+  /// according to the parent ghost mode. The mesh data arrays
+  /// "parent_cell_indices" and "parent_vertex_indices" then hold the
+  /// local parent index (std::numeric_limits<std::size_t>::max() if
+  /// the parent entity is not present on the process), and
+  /// "parent_global_cell_indices" and "parent_global_vertex_indices"
+  /// hold the global parent index of each local cell and vertex.
 
   class SubMesh : public Mesh
   {
@@ -60,6 +70,11 @@ namespace dolfin
     void init(const Mesh& mesh, const std::vector<std::size_t>& sub_domains,
               std::size_t sub_domain);
 
+    // Create sub mesh of a distributed mesh
+    void init_distributed(const Mesh& mesh,
+                          const std::vector<std::size_t>& sub_domains,
+                          std::size_t sub_domain);
+
   };
 
 }
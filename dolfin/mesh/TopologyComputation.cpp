@@ -16,7 +16,10 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
+#include <functional>
+#include <numeric>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -25,10 +28,15 @@
 #include <boost/unordered_map.hpp>
 #include <boost/version.hpp>
 
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/common/MonotonicArena.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/utils.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "Cell.h"
+#include "CellTraits.h"
 #include "CellType.h"
 #include "Mesh.h"
 #include "MeshConnectivity.h"
@@ -38,6 +46,50 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Number of threads to use for topology computations (set by the
+  // global parameter "num_threads")
+  int topology_threads()
+  { return SubSystemsManager::num_threads(); }
+
+  // Sort vector by sorting num_threads blocks concurrently and
+  // merging the sorted blocks pairwise. The result is identical to
+  // std::sort for types with a strict total order.
+  template<typename T>
+  void parallel_sort(std::vector<T>& x, int num_threads)
+  {
+    if (num_threads < 2 || x.size() < 1024*(std::size_t) num_threads)
+    {
+      std::sort(x.begin(), x.end());
+      return;
+    }
+
+    // Partition into blocks
+    std::vector<std::size_t> offsets(num_threads + 1);
+    for (int i = 0; i <= num_threads; ++i)
+      offsets[i] = i*x.size()/num_threads;
+
+    // Sort blocks
+    #pragma omp parallel for num_threads(num_threads)
+    for (int i = 0; i < num_threads; ++i)
+      std::sort(x.begin() + offsets[i], x.begin() + offsets[i + 1]);
+
+    // Merge neighbouring blocks until one sorted block remains
+    for (int width = 1; width < num_threads; width *= 2)
+    {
+      #pragma omp parallel for num_threads(num_threads)
+      for (int i = 0; i < num_threads - width; i += 2*width)
+      {
+        const int last = std::min(i + 2*width, num_threads);
+        std::inplace_merge(x.begin() + offsets[i],
+                           x.begin() + offsets[i + width],
+                           x.begin() + offsets[last]);
+      }
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 std::size_t TopologyComputation::compute_entities(Mesh& mesh, std::size_t dim)
 {
@@ -59,26 +111,77 @@ std::size_t TopologyComputation::compute_entities(Mesh& mesh, std::size_t dim)
     return topology.size(dim);
   }
 
-  // Call specialised function to compute entities
-  const CellType& cell_type = mesh.type();
-  const std::int8_t num_entity_vertices = cell_type.num_vertices(dim);
-  switch (num_entity_vertices)
+  // Call function specialised for cell type and dimension
+  switch (mesh.type().cell_type())
   {
-  case  1:
-    return TopologyComputation::compute_entities_by_key_matching<1>(mesh, dim);
-  case  2:
-    return TopologyComputation::compute_entities_by_key_matching<2>(mesh, dim);
-  case  3:
-    return TopologyComputation::compute_entities_by_key_matching<3>(mesh, dim);
-  case  4:
-    return TopologyComputation::compute_entities_by_key_matching<4>(mesh, dim);
-  default:
-    dolfin_error("TopologyComputation.cpp",
-                 "compute topological entities",
-                 "Entities with %d vertices not supported",
-                 num_entity_vertices);
-    return 0;
+  case CellType::point:
+    if (dim == 0)
+      return compute_entities_by_key_matching<CellType::point, 0>(mesh);
+    break;
+  case CellType::interval:
+    switch (dim)
+    {
+    case 0:
+      return compute_entities_by_key_matching<CellType::interval, 0>(mesh);
+    case 1:
+      return compute_entities_by_key_matching<CellType::interval, 1>(mesh);
+    }
+    break;
+  case CellType::triangle:
+    switch (dim)
+    {
+    case 0:
+      return compute_entities_by_key_matching<CellType::triangle, 0>(mesh);
+    case 1:
+      return compute_entities_by_key_matching<CellType::triangle, 1>(mesh);
+    case 2:
+      return compute_entities_by_key_matching<CellType::triangle, 2>(mesh);
+    }
+    break;
+  case CellType::quadrilateral:
+    switch (dim)
+    {
+    case 0:
+      return compute_entities_by_key_matching<CellType::quadrilateral, 0>(mesh);
+    case 1:
+      return compute_entities_by_key_matching<CellType::quadrilateral, 1>(mesh);
+    case 2:
+      return compute_entities_by_key_matching<CellType::quadrilateral, 2>(mesh);
+    }
+    break;
+  case CellType::tetrahedron:
+    switch (dim)
+    {
+    case 0:
+      return compute_entities_by_key_matching<CellType::tetrahedron, 0>(mesh);
+    case 1:
+      return compute_entities_by_key_matching<CellType::tetrahedron, 1>(mesh);
+    case 2:
+      return compute_entities_by_key_matching<CellType::tetrahedron, 2>(mesh);
+    case 3:
+      return compute_entities_by_key_matching<CellType::tetrahedron, 3>(mesh);
+    }
+    break;
+  case CellType::hexahedron:
+    switch (dim)
+    {
+    case 0:
+      return compute_entities_by_key_matching<CellType::hexahedron, 0>(mesh);
+    case 1:
+      return compute_entities_by_key_matching<CellType::hexahedron, 1>(mesh);
+    case 2:
+      return compute_entities_by_key_matching<CellType::hexahedron, 2>(mesh);
+    case 3:
+      return compute_entities_by_key_matching<CellType::hexahedron, 3>(mesh);
+    }
+    break;
   }
+
+  dolfin_error("TopologyComputation.cpp",
+               "compute topological entities",
+               "Entities of dimension %d not supported for cell type %s",
+               dim, mesh.type().description(false).c_str());
+  return 0;
 }
 //-----------------------------------------------------------------------------
 void TopologyComputation::compute_connectivity(Mesh& mesh,
@@ -128,8 +231,9 @@ void TopologyComputation::compute_connectivity(Mesh& mesh,
   // Decide how to compute the connectivity
   if (d0 == d1)
   {
-    std::vector<std::vector<std::size_t>>
-      connectivity_dd(topology.size(d0), std::vector<std::size_t>(1));
+    // Each entity is connected to itself only
+    std::vector<std::array<std::size_t, 1>>
+      connectivity_dd(topology.size(d0));
     for (MeshEntityIterator e(mesh, d0, "all"); !e.end(); ++e)
       connectivity_dd[e->index()][0] = e->index();
     topology(d0, d0).set(connectivity_dd);
@@ -148,10 +252,14 @@ void TopologyComputation::compute_connectivity(Mesh& mesh,
   }
 }
 //--------------------------------------------------------------------------
-template<int N>
-std::int32_t TopologyComputation::compute_entities_by_key_matching(Mesh& mesh,
-                                                                   int dim)
+template<CellType::Type T, int D>
+std::int32_t TopologyComputation::compute_entities_by_key_matching(Mesh& mesh)
 {
+  // Number of entities of cell and vertices of entity
+  constexpr std::size_t N = CellTraits<T>::num_entity_vertices(D);
+  constexpr std::size_t M = CellTraits<T>::num_entities(D);
+  const int dim = D;
+
   // Get mesh topology and connectivity
   MeshTopology& topology = mesh.topology();
   MeshConnectivity& ce = topology(topology.dim(), dim);
@@ -183,97 +291,109 @@ std::int32_t TopologyComputation::compute_entities_by_key_matching(Mesh& mesh,
 
   // Get cell type
   const CellType& cell_type = mesh.type();
+  dolfin_assert(cell_type.cell_type() == T);
+
+  // Number of entities of cell and vertices of entity
+  const std::int8_t num_entities = M;
+  const std::int8_t num_vertices = N;
+  dolfin_assert(cell_type.num_entities(dim) == M);
+  dolfin_assert(cell_type.num_vertices(dim) == N);
+
+  // Create map from cell vertices to entity vertices (vertices and
+  // the cell itself are not created by the cell type)
+  std::array<std::array<unsigned int, N>, M> e_vertices;
+  if (D == 0)
+  {
+    for (std::size_t i = 0; i < M; ++i)
+      e_vertices[i][0] = i;
+  }
+  else if (D == (int) CellTraits<T>::dim)
+  {
+    for (std::size_t j = 0; j < N; ++j)
+      e_vertices[0][j] = j;
+  }
+  else
+  {
+    boost::multi_array<unsigned int, 2> local_entities;
+    std::array<unsigned int, CellTraits<T>::num_vertices> v;
+    std::iota(v.begin(), v.end(), 0);
+    cell_type.create_entities(local_entities, dim, v.data());
+    for (std::size_t i = 0; i < M; ++i)
+      for (std::size_t j = 0; j < N; ++j)
+        e_vertices[i][j] = local_entities[i][j];
+  }
 
-  // Initialize local array of entities
-  const std::int8_t num_entities = cell_type.num_entities(dim);
-  const int num_vertices = cell_type.num_vertices(dim);
-
-  // Create map from cell vertices to entity vertices
-  boost::multi_array<unsigned int, 2>
-    e_vertices(boost::extents[num_entities][num_vertices]);
-  const int num_vertices_per_cell = cell_type.num_vertices();
-  std::vector<unsigned int> v(num_vertices_per_cell);
-  std::iota(v.begin(), v.end(), 0);
-  cell_type.create_entities(e_vertices, dim, v.data());
+  // Cell-vertex connectivity (read through a const reference so that
+  // it does not count as a change of topology state)
+  const std::size_t tdim = topology.dim();
+  const MeshTopology& ctopology = topology;
+  const MeshConnectivity& cv = ctopology(tdim, 0);
+  const std::int32_t num_cells = topology.size(tdim);
+  const std::int32_t ghost_offset = topology.ghost_offset(tdim);
 
-  dolfin_assert(N == num_vertices);
+  // Number of threads
+  const int num_threads = topology_threads();
 
   // Create data structure to hold entities
-  // ([vertices key], (cell_local_index, cell index), [entity vertices], entity index)
-  std::vector<std::tuple<std::array<std::int32_t, N>,
-                         std::pair<std::int8_t, std::int32_t>,
-                         std::array<std::int32_t, N>, std::int32_t>>
-    keyed_entities(num_entities*mesh.num_cells());
+  // ([vertices key], (cell_local_index, cell index)). Entity
+  // vertices are recovered from the cell and cell local index.
+  std::vector<std::pair<std::array<std::int32_t, N>,
+                        std::pair<std::int8_t, std::int32_t>>>
+    keyed_entities(num_entities*num_cells);
 
   // Loop over cells to build list of keyed (by vertices) entities
-  int entity_counter = 0;
-  for (CellIterator c(mesh, "all"); !c.end(); ++c)
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int32_t c = 0; c < num_cells; ++c)
   {
     // Get vertices from cell
-    const unsigned int* vertices = c->entities(0);
+    const unsigned int* vertices = cv(c);
     dolfin_assert(vertices);
 
     // Iterate over entities of cell
-    const int cell_index = c->index();
     for (std::int8_t i = 0; i < num_entities; ++i)
     {
-      // Get entity vertices
-      auto& entity = std::get<2>(keyed_entities[entity_counter]);
-      for (std::int8_t j = 0; j < num_vertices; ++j)
-        entity[j] = vertices[e_vertices[i][j]];
+      auto& entity = keyed_entities[c*num_entities + i];
 
-      // Sort entity vertices to create key
-      auto& entity_key = std::get<0>(keyed_entities[entity_counter]);
-      std::partial_sort_copy(entity.begin(), entity.end(),
-                             entity_key.begin(), entity_key.end());
+      // Get entity vertices and sort to create key
+      auto& entity_key = entity.first;
+      for (std::int8_t j = 0; j < num_vertices; ++j)
+        entity_key[j] = vertices[e_vertices[i][j]];
+      std::sort(entity_key.begin(), entity_key.end());
 
       // Attach (local index, cell index), making local_index negative
       // if it is not a ghost cell. This ensures that non-ghosts come
       // before ghosts when sorted. The index is corrected later.
-      if (!c->is_ghost())
-        std::get<1>(keyed_entities[entity_counter]) = {-i - 1, cell_index};
+      if (c < ghost_offset)
+        entity.second = {-i - 1, c};
       else
-        std::get<1>(keyed_entities[entity_counter]) = {i, cell_index};
-
-      // Increment entity counter
-      ++entity_counter;
+        entity.second = {i, c};
     }
   }
 
   // Sort entities by key. For the same key, those beloning to
   // non-ghost cells will appear before those belonging to ghost
   // cells.
-  std::sort(keyed_entities.begin(), keyed_entities.end());
+  parallel_sort(keyed_entities, num_threads);
 
   // Compute entity indices (using -1, -2, -3, etc, for ghost
   // entities)
+  std::vector<std::int32_t> entity_index(keyed_entities.size());
   std::int32_t nonghost_index(0), ghost_index(-1);
-  std::array<std::int32_t, N> previous_key;
-  std::fill(previous_key.begin(), previous_key.end(), -1);
-  for (auto e = keyed_entities.begin(); e!= keyed_entities.end(); ++e)
+  for (std::size_t k = 0; k < keyed_entities.size(); ++k)
   {
-    const auto& key = std::get<0>(*e);
-    if (key == previous_key)
+    if (k > 0 && keyed_entities[k].first == keyed_entities[k - 1].first)
     {
       // Repeated entity, reuse entity index
-      std::get<3>(*e) = std::get<3>(*(e - 1));
+      entity_index[k] = entity_index[k - 1];
     }
     else
     {
       // New entity, so give index (negative for ghosts)
-      const auto local_index = std::get<1>(*e).first;
-      if (local_index < 0)
-        std::get<3>(*e) = nonghost_index++;
+      if (keyed_entities[k].second.first < 0)
+        entity_index[k] = nonghost_index++;
       else
-        std::get<3>(*e) = ghost_index--;
-
-      // Update key
-      previous_key = key;
+        entity_index[k] = ghost_index--;
     }
-
-    // Re-map local index (make all positive)
-    auto& local_index = std::get<1>(*e).first;
-    local_index = (local_index < 0) ? (-local_index - 1) : local_index;
   }
 
   // Total number of entities
@@ -282,37 +402,39 @@ std::int32_t TopologyComputation::compute_entities_by_key_matching(Mesh& mesh,
   const std::int32_t num_mesh_entities = num_nonghost_entities + num_ghost_entities;
 
   // List of vertex indices connected to entity e
-  std::vector<std::array<int, N>> connectivity_ev(num_mesh_entities) ;
+  std::vector<std::array<int, N>> connectivity_ev(num_mesh_entities);
 
   // List of entity e indices connected to cell
   boost::multi_array<int, 2>
-    connectivity_ce(boost::extents[mesh.num_cells()][num_entities]);
+    connectivity_ce(boost::extents[num_cells][num_entities]);
 
   // Build connectivity arrays (with ghost entities at the end)
-  //std::int32_t previous_index = -1;
-  std::int32_t previous_index = std::numeric_limits<std::int32_t>::min();
-  for (auto& entity : keyed_entities)
+  const std::int64_t num_keyed_entities = keyed_entities.size();
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t k = 0; k < num_keyed_entities; ++k)
   {
     // Get entity index, and remap for ghosts (negative entity index)
     // to true index
-    auto& e_index = std::get<3>(entity);
+    std::int32_t e_index = entity_index[k];
     if (e_index < 0)
       e_index = num_nonghost_entities - (e_index + 1);
 
+    // Get cell and (positive) cell local index of entity
+    const auto& cell = keyed_entities[k].second;
+    const std::int8_t local_index
+      = (cell.first < 0) ? (-cell.first - 1) : cell.first;
+    const std::int32_t cell_index = cell.second;
+
     // Add to enity-to-vertex map if entity is new
-    if (e_index != previous_index)
+    if (k == 0 || entity_index[k] != entity_index[k - 1])
     {
       dolfin_assert(e_index < (std::int32_t) connectivity_ev.size());
-      connectivity_ev[e_index] = std::get<2>(entity);
-
-      // Update index
-      previous_index = e_index;
+      const unsigned int* vertices = cv(cell_index);
+      for (std::int8_t j = 0; j < num_vertices; ++j)
+        connectivity_ev[e_index][j] = vertices[e_vertices[local_index][j]];
     }
 
     // Add to cell-to-entity map
-    const auto& cell = std::get<1>(entity);
-    const auto local_index = cell.first;
-    const auto cell_index = cell.second;
     connectivity_ce[cell_index][local_index] = e_index;
   }
 
@@ -348,27 +470,65 @@ void TopologyComputation::compute_from_transpose(Mesh& mesh, std::size_t d0,
   MeshTopology& topology = mesh.topology();
   MeshConnectivity& connectivity = topology(d0, d1);
 
-  // Need connectivity d1 - d0
-  dolfin_assert(!topology(d1, d0).empty());
+  // Connectivity d1 - d0 (read through a const reference so that it
+  // does not count as a change of topology state)
+  const MeshTopology& ctopology = topology;
+  const MeshConnectivity& c10 = ctopology(d1, d0);
+  dolfin_assert(!c10.empty());
+  const std::int64_t num_entities0 = topology.size(d0);
+  const std::int64_t num_entities1 = topology.size(d1);
 
-  // Temporary array
-  std::vector<std::size_t> tmp(topology.size(d0), 0);
+  // Number of threads
+  const int num_threads = topology_threads();
 
   // Count the number of connections
-  for (MeshEntityIterator e1(mesh, d1, "all"); !e1.end(); ++e1)
-    for (MeshEntityIterator e0(*e1, d0); !e0.end(); ++e0)
-      tmp[e0->index()]++;
+  std::vector<std::size_t> tmp(num_entities0, 0);
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t e1 = 0; e1 < num_entities1; ++e1)
+  {
+    const unsigned int* e0 = c10(e1);
+    for (std::size_t i = 0; i < c10.size(e1); ++i)
+    {
+      #pragma omp atomic
+      tmp[e0[i]]++;
+    }
+  }
 
-  // Initialize the number of connections
-  connectivity.init(tmp);
+  // Compute offsets for each entity of dimension d0
+  std::vector<std::size_t> offsets(num_entities0 + 1, 0);
+  std::partial_sum(tmp.begin(), tmp.end(), offsets.begin() + 1);
 
   // Reset current position for each entity
   std::fill(tmp.begin(), tmp.end(), 0);
 
   // Add the connections
-  for (MeshEntityIterator e1(mesh, d1, "all"); !e1.end(); ++e1)
-    for (MeshEntityIterator e0(*e1, d0); !e0.end(); ++e0)
-      connectivity.set(e0->index(), e1->index(), tmp[e0->index()]++);
+  std::vector<unsigned int> connections(offsets.back());
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t e1 = 0; e1 < num_entities1; ++e1)
+  {
+    const unsigned int* e0 = c10(e1);
+    for (std::size_t i = 0; i < c10.size(e1); ++i)
+    {
+      std::size_t pos;
+      #pragma omp atomic capture
+      pos = tmp[e0[i]]++;
+      connections[offsets[e0[i]] + pos] = e1;
+    }
+  }
+
+  // Initialize the number of connections
+  connectivity.init(tmp);
+
+  // Sort connections of each entity (order of insertion depends on
+  // thread scheduling) and copy
+  #pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (std::int64_t e0 = 0; e0 < num_entities0; ++e0)
+  {
+    ArrayView<unsigned int> c(offsets[e0 + 1] - offsets[e0],
+                              connections.data() + offsets[e0]);
+    std::sort(c.begin(), c.end());
+    connectivity.set(e0, c);
+  }
 }
 //----------------------------------------------------------------------------
 void TopologyComputation::compute_from_map(Mesh& mesh,
@@ -378,44 +538,95 @@ void TopologyComputation::compute_from_map(Mesh& mesh,
   dolfin_assert(d1 > 0);
   dolfin_assert(d0 > d1);
 
-  // Get the type of entity d0
-  std::unique_ptr<CellType> cell_type(CellType::create(mesh.type()
-                                                       .entity_type(d0)));
-
-  MeshConnectivity& connectivity = mesh.topology()(d0, d1);
-  connectivity.init(mesh.size(d0), cell_type->num_entities(d1));
-
-  // Make a map from the sorted d1 entity vertices to the d1 entity index
-  boost::unordered_map<std::vector<unsigned int>, unsigned int>
-    entity_to_index;
-  entity_to_index.reserve(mesh.size(d1));
+  // Call function specialised for type of entity d0 and dimension d1
+  switch (mesh.type().entity_type(d0))
+  {
+  case CellType::triangle:
+    if (d1 == 1)
+      return compute_from_map<CellType::triangle, 1>(mesh, d0);
+    break;
+  case CellType::quadrilateral:
+    if (d1 == 1)
+      return compute_from_map<CellType::quadrilateral, 1>(mesh, d0);
+    break;
+  case CellType::tetrahedron:
+    if (d1 == 1)
+      return compute_from_map<CellType::tetrahedron, 1>(mesh, d0);
+    if (d1 == 2)
+      return compute_from_map<CellType::tetrahedron, 2>(mesh, d0);
+    break;
+  case CellType::hexahedron:
+    if (d1 == 1)
+      return compute_from_map<CellType::hexahedron, 1>(mesh, d0);
+    if (d1 == 2)
+      return compute_from_map<CellType::hexahedron, 2>(mesh, d0);
+    break;
+  default:
+    break;
+  }
 
-  const std::size_t num_verts_d1 = mesh.type().num_vertices(d1);
-  std::vector<unsigned int> key(num_verts_d1);
-  for (MeshEntityIterator e(mesh, d1, "all"); !e.end(); ++e)
+  dolfin_error("TopologyComputation.cpp",
+               "compute mesh connectivity",
+               "Connectivity %d - %d not supported for cell type %s",
+               d0, d1, mesh.type().description(false).c_str());
+}
+//-----------------------------------------------------------------------------
+template<CellType::Type T, int D1>
+void TopologyComputation::compute_from_map(Mesh& mesh, std::size_t d0)
+{
+  // Number of d1 entities of a d0 entity and vertices of a d1 entity
+  constexpr std::size_t N = CellTraits<T>::num_entity_vertices(D1);
+  constexpr std::size_t M = CellTraits<T>::num_entities(D1);
+  dolfin_assert(d0 == CellTraits<T>::dim);
+
+  // Create map from d0 entity vertices to d1 entity vertices
+  std::unique_ptr<CellType> cell_type(CellType::create(T));
+  boost::multi_array<unsigned int, 2> local_entities;
+  std::array<unsigned int, CellTraits<T>::num_vertices> v;
+  std::iota(v.begin(), v.end(), 0);
+  cell_type->create_entities(local_entities, D1, v.data());
+  std::array<std::array<unsigned int, N>, M> e_vertices;
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+      e_vertices[i][j] = local_entities[i][j];
+
+  MeshConnectivity& connectivity = mesh.topology()(d0, D1);
+  connectivity.init(mesh.size(d0), M);
+
+  // Make a map from the sorted d1 entity vertices to the d1 entity
+  // index (nodes allocated from an arena, freed on return)
+  typedef std::array<unsigned int, N> Key;
+  MonotonicArena arena;
+  boost::unordered_map<Key, unsigned int, boost::hash<Key>,
+                       std::equal_to<Key>,
+                       ArenaAllocator<std::pair<const Key, unsigned int>>>
+    entity_to_index(arena);
+  entity_to_index.reserve(mesh.size(D1));
+
+  std::array<unsigned int, N> key;
+  for (MeshEntityIterator e(mesh, D1, "all"); !e.end(); ++e)
   {
-    std::partial_sort_copy(e->entities(0), e->entities(0) + num_verts_d1,
+    std::partial_sort_copy(e->entities(0), e->entities(0) + N,
                            key.begin(), key.end());
     entity_to_index.insert({key, e->index()});
   }
 
   // Search for d1 entities of d0 in map, and recover index
-  std::vector<std::size_t> entities;
-  boost::multi_array<unsigned int, 2> keys;
+  std::array<unsigned int, M> entities;
   for (MeshEntityIterator e(mesh, d0, "all"); !e.end(); ++e)
   {
-    entities.clear();
-    cell_type->create_entities(keys, d1, e->entities(0));
-    for (const auto &p : keys)
+    const unsigned int* vertices = e->entities(0);
+    for (std::size_t i = 0; i < M; ++i)
     {
-      std::partial_sort_copy(p.begin(), p.end(), key.begin(), key.end());
+      for (std::size_t j = 0; j < N; ++j)
+        key[j] = vertices[e_vertices[i][j]];
+      std::sort(key.begin(), key.end());
       const auto it = entity_to_index.find(key);
       dolfin_assert(it != entity_to_index.end());
-      entities.push_back(it->second);
+      entities[i] = it->second;
     }
-    connectivity.set(e->index(), entities.data());
+    connectivity.set(e->index(), entities);
   }
-
 }
 //-----------------------------------------------------------------------------
 void TopologyComputation::compute_from_intersection(Mesh& mesh,
@@ -435,7 +646,10 @@ void TopologyComputation::compute_from_intersection(Mesh& mesh,
   dolfin_assert(!topology(d, d1).empty());
 
   // Temporary dynamic storage, later copied into static storage
-  std::vector<std::vector<std::size_t>> connectivity(topology.size(d0));
+  // (allocated from an arena to avoid one allocation per entity)
+  typedef std::vector<std::size_t, ArenaAllocator<std::size_t>> Entities;
+  MonotonicArena arena;
+  std::vector<Entities> connectivity(topology.size(d0), Entities(arena));
 
   // A bitmap used to ensure we do not store duplicates
   std::vector<bool> e1_visited(topology.size(d1));
@@ -449,7 +663,7 @@ void TopologyComputation::compute_from_intersection(Mesh& mesh,
   for (MeshEntityIterator e0(mesh, d0, "all"); !e0.end(); ++e0)
   {
     // Get set of connected entities for current entity
-    std::vector<std::size_t>& entities = connectivity[e0->index()];
+    Entities& entities = connectivity[e0->index()];
 
     // Reserve space
     entities.reserve(max_size);
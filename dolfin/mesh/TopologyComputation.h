@@ -24,6 +24,7 @@
 #define __TOPOLOGY_COMPUTATION_H
 
 #include <vector>
+#include "CellType.h"
 
 namespace dolfin
 {
@@ -38,7 +39,8 @@ namespace dolfin
   public:
 
     /// Compute mesh entities of given topological dimension, and connectivity
-    /// cell-to-enity (tdim, dim)
+    /// cell-to-enity (tdim, dim). The computation is threaded if the
+    /// global parameter "num_threads" is nonzero.
     static std::size_t compute_entities(Mesh& mesh, std::size_t dim);
 
     /// Compute mesh entities of given topological dimension.
@@ -64,13 +66,17 @@ namespace dolfin
     //
     // Returns the number of entities
     //
-    //The function is templated over the number of vertices that make up an
-    //entity of dimension dim. This avoid dynamic memoryt allocations, yielding
-    //significant performance improvements
-    template<int N>
-    static std::int32_t compute_entities_by_key_matching(Mesh& mesh, int dim);
-
-    // Compute connectivity from transpose
+    //The function is templated over the cell type and the entity dimension,
+    //so that the number of vertices of an entity and the number of entities
+    //of a cell are compile-time constants (see CellTraits). This avoid
+    //dynamic memoryt allocations, yielding significant performance
+    //improvements. Keys are built and sorted concurrently (block sort
+    //followed by pairwise merges) when "num_threads" is nonzero.
+    template<CellType::Type T, int D>
+    static std::int32_t compute_entities_by_key_matching(Mesh& mesh);
+
+    // Compute connectivity from transpose (threaded if "num_threads"
+    // is nonzero)
     static void compute_from_transpose(Mesh& mesh, std::size_t d0,
                                        std::size_t d1);
 
@@ -79,6 +85,11 @@ namespace dolfin
                                  std::size_t d0,
                                  std::size_t d1);
 
+    // Implementation of compute_from_map for entities of type T
+    // (dimension d0) and sub-entities of dimension D1
+    template<CellType::Type T, int D1>
+    static void compute_from_map(Mesh& mesh, std::size_t d0);
+
     // Compute connectivity from intersection
     static void compute_from_intersection(Mesh& mesh, std::size_t d0,
                                           std::size_t d1, std::size_t d);
@@ -4,6 +4,7 @@
 // DOLFIN mesh interface
 
 #include <dolfin/mesh/CellType.h>
+#include <dolfin/mesh/CellTraits.h>
 #include <dolfin/mesh/MeshTopology.h>
 #include <dolfin/mesh/MeshGeometry.h>
 #include <dolfin/mesh/MeshDomains.h>
@@ -20,6 +21,10 @@
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/FacetCell.h>
 #include <dolfin/mesh/MeshConnectivity.h>
+#include <dolfin/mesh/CellVertexView.h>
+#include <dolfin/mesh/MeshGeometryCache.h>
+#include <dolfin/mesh/MeshInteriorFacets.h>
+#include <dolfin/mesh/MeshExteriorFacets.h>
 #include <dolfin/mesh/MeshEditor.h>
 #include <dolfin/mesh/DynamicMeshEditor.h>
 #include <dolfin/mesh/LocalMeshValueCollection.h>
@@ -38,5 +43,7 @@
 #include <dolfin/mesh/MultiMesh.h>
 #include <dolfin/mesh/MeshHierarchy.h>
 #include <dolfin/mesh/MeshPartitioning.h>
+#include <dolfin/mesh/MeshRedistribution.h>
+#include <dolfin/mesh/DistributedMeshTools.h>
 
 #endif
@@ -18,11 +18,17 @@
 // First added:  2013-02-15
 // Last changed: 2014-10-13
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <memory>
+#include <dolfin/common/MPI.h>
 #include <dolfin/log/log.h>
+#include <dolfin/function/Constant.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/fem/DirichletBC.h>
+#include <dolfin/fem/Form.h>
+#include <dolfin/la/GenericVector.h>
 
 #include "MultiStageScheme.h"
 
@@ -45,7 +51,8 @@ MultiStageScheme::MultiStageScheme(
 : Variable(name, ""), _stage_forms(stage_forms), _last_stage(last_stage),
   _stage_solutions(stage_solutions), _u(u), _t(t), _dt(dt),
   _dt_stage_offset(dt_stage_offset), _jacobian_indices(jacobian_indices),
-  _order(order), _implicit(false), _human_form(human_form), _bcs(bcs)
+  _order(order), _implicit(false), _human_form(human_form), _bcs(bcs),
+  _error_weights(), _embedded_order(0)
 {
   _check_arguments();
 }
@@ -133,6 +140,117 @@ int MultiStageScheme::jacobian_index(unsigned int stage) const
   return _jacobian_indices[stage];
 }
 //-----------------------------------------------------------------------------
+void MultiStageScheme::set_error_weights(std::vector<double> error_weights,
+                                         unsigned int embedded_order)
+{
+  if (error_weights.size() != _stage_solutions.size())
+  {
+    dolfin_error("MultiStageScheme.cpp",
+                 "setting error weights",
+                 "Expecting one weight for each of the %d stages",
+                 _stage_solutions.size());
+  }
+
+  _error_weights = error_weights;
+  _embedded_order = embedded_order;
+}
+//-----------------------------------------------------------------------------
+bool MultiStageScheme::has_error_estimate() const
+{
+  return !_error_weights.empty();
+}
+//-----------------------------------------------------------------------------
+unsigned int MultiStageScheme::embedded_order() const
+{
+  return _embedded_order;
+}
+//-----------------------------------------------------------------------------
+void
+MultiStageScheme::set_solution_weights(std::vector<double> solution_weights)
+{
+  if (solution_weights.size() != _stage_solutions.size())
+  {
+    dolfin_error("MultiStageScheme.cpp",
+                 "setting solution weights",
+                 "Expecting one weight for each of the %d stages",
+                 _stage_solutions.size());
+  }
+
+  _solution_weights = solution_weights;
+}
+//-----------------------------------------------------------------------------
+const std::vector<double>& MultiStageScheme::solution_weights() const
+{
+  return _solution_weights;
+}
+//-----------------------------------------------------------------------------
+void MultiStageScheme::set_mass_form(std::shared_ptr<const Form> mass_form)
+{
+  dolfin_assert(mass_form);
+  if (mass_form->rank() != 2)
+  {
+    dolfin_error("MultiStageScheme.cpp",
+                 "setting mass form",
+                 "Expecting a bilinear form, form has rank %d",
+                 mass_form->rank());
+  }
+
+  _mass_form = mass_form;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const Form> MultiStageScheme::mass_form() const
+{
+  return _mass_form;
+}
+//-----------------------------------------------------------------------------
+double MultiStageScheme::error_norm(const GenericVector& u0, double atol,
+                                    double rtol) const
+{
+  if (!has_error_estimate())
+  {
+    dolfin_error("MultiStageScheme.cpp",
+                 "computing error estimate",
+                 "Scheme %s has no embedded error estimate",
+                 name().c_str());
+  }
+
+  dolfin_assert(_u);
+  dolfin_assert(_dt);
+  const double dt = *_dt;
+
+  // Get owned values of solutions at start and end of step
+  std::vector<double> u0_values, u_values, k_values;
+  u0.get_local(u0_values);
+  _u->vector()->get_local(u_values);
+
+  // Compute error estimate from stage solutions
+  std::vector<double> error(u_values.size(), 0.0);
+  for (std::size_t i = 0; i < _stage_solutions.size(); ++i)
+  {
+    if (_error_weights[i] == 0.0)
+      continue;
+    _stage_solutions[i]->vector()->get_local(k_values);
+    dolfin_assert(k_values.size() == error.size());
+    for (std::size_t j = 0; j < error.size(); ++j)
+      error[j] += dt*_error_weights[i]*k_values[j];
+  }
+
+  // Scaled sum of squares
+  double sum = 0.0;
+  for (std::size_t j = 0; j < error.size(); ++j)
+  {
+    const double scale
+      = atol + rtol*std::max(std::abs(u0_values[j]), std::abs(u_values[j]));
+    sum += (error[j]/scale)*(error[j]/scale);
+  }
+
+  const MPI_Comm comm = _u->vector()->mpi_comm();
+  sum = MPI::sum(comm, sum);
+  const std::size_t N = _u->vector()->size();
+
+  return N > 0 ? std::sqrt(sum/N) : 0.0;
+}
+//-----------------------------------------------------------------------------
 std::string MultiStageScheme::str(bool verbose) const
 {
   if (!verbose)
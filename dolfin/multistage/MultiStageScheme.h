@@ -35,6 +35,7 @@ namespace dolfin
   class Function;
   class DirichletBC;
   class Constant;
+  class GenericVector;
 
   /// Place-holder for forms and solutions for a multi-stage Butcher tableau based method
 
@@ -96,6 +97,46 @@ namespace dolfin
     /// stage is explicit and hence no jacobian needed.
     int jacobian_index(unsigned int stage) const;
 
+    /// Set the weights of the stage solutions in the difference
+    /// between the solution and an embedded solution of order
+    /// embedded_order (b - b_hat for a Butcher tableau). This enables
+    /// error estimation for adaptive time stepping.
+    void set_error_weights(std::vector<double> error_weights,
+                           unsigned int embedded_order);
+
+    /// Return true if the scheme includes an embedded error estimate
+    bool has_error_estimate() const;
+
+    /// Return the order of the embedded solution
+    unsigned int embedded_order() const;
+
+    /// Set the weights of the stage solutions in the solution at the
+    /// end of a step (b for a Butcher tableau). This enables the
+    /// solution update u = u + dt*sum_i b_i k_i as one vector
+    /// operation instead of an assembly of the last stage form.
+    void set_solution_weights(std::vector<double> solution_weights);
+
+    /// Return the weights of the stage solutions in the solution
+    /// (empty if not set)
+    const std::vector<double>& solution_weights() const;
+
+    /// Set the mass form (bilinear form of the inner product of trial
+    /// and test functions) used for the lumped mass of fully
+    /// explicit schemes with cell integral forms
+    void set_mass_form(std::shared_ptr<const Form> mass_form);
+
+    /// Return the mass form (null if not set)
+    std::shared_ptr<const Form> mass_form() const;
+
+    /// Return the root mean square over all dofs of the error
+    /// estimate dt*sum_i e_i k_i of the last step, where e are the
+    /// error weights and k the stage solutions. Each entry is scaled
+    /// by atol + rtol*max(|u0|, |u|), where u0 is the solution at the
+    /// start of the step, so the step is acceptable if the norm is at
+    /// most one.
+    double error_norm(const GenericVector& u0, double atol,
+                      double rtol) const;
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const;
 
@@ -140,6 +181,20 @@ namespace dolfin
     // The boundary conditions
     std::vector<std::shared_ptr<const DirichletBC>> _bcs;
 
+    // Weights of the stage solutions in the error estimate (empty if
+    // there is no embedded solution)
+    std::vector<double> _error_weights;
+
+    // The order of the embedded solution
+    unsigned int _embedded_order;
+
+    // Weights of the stage solutions in the solution (empty if not
+    // set)
+    std::vector<double> _solution_weights;
+
+    // The mass form for lumped mass stage solutions
+    std::shared_ptr<const Form> _mass_form;
+
   };
 
 }
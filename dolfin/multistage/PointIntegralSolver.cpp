@@ -20,9 +20,15 @@
 
 #include <cmath>
 #include <algorithm>
+#include <exception>
 #include <memory>
 
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
 #include <dolfin/log/log.h>
+#include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/mesh/Mesh.h>
@@ -57,13 +63,8 @@ PointIntegralSolver::PointIntegralSolver(std::shared_ptr<MultiStageScheme> schem
   _system_size(_dofmap.num_entity_dofs(0)),
   _dof_offset(_mesh->type().num_entities(0)),
   _num_stages(_scheme->stage_forms().size()),
-  _local_to_local_dofs(_system_size),
-  _vertex_map(), _local_to_global_dofs(_system_size),
-  _local_stage_solutions(_scheme->stage_solutions().size()),
-  _u0(_system_size), _residual(_system_size), _y(_system_size),
-  _dx(_system_size),
-  _ufcs(), _coefficient_index(), _recompute_jacobian(),
-  _jacobians(), _eta(1.0), _num_jacobian_computations(0)
+  _vertex_map(), _coefficient_index(), _local_data(1), _eta(),
+  _vertex_jacobians(), _vertex_jacobian_stale(), _num_steps(0, 0)
 {
   // Set parameters
   parameters = default_parameters();
@@ -79,10 +80,16 @@ PointIntegralSolver::~PointIntegralSolver()
 //-----------------------------------------------------------------------------
 void PointIntegralSolver::reset_newton_solver()
 {
-  _eta = parameters("newton_solver")["eta_0"];
+  const double eta_0 = parameters("newton_solver")["eta_0"];
+  std::fill(_eta.begin(), _eta.end(), eta_0);
 
-  for (unsigned int i=0; i < _recompute_jacobian.size(); i++)
-    _recompute_jacobian[i] = true;
+  for (auto data = _local_data.begin(); data != _local_data.end(); ++data)
+  {
+    std::fill(data->recompute_jacobian.begin(),
+              data->recompute_jacobian.end(), true);
+  }
+  std::fill(_vertex_jacobian_stale.begin(), _vertex_jacobian_stale.end(),
+            true);
 }
 //-----------------------------------------------------------------------------
 void PointIntegralSolver::reset_stage_solutions()
@@ -94,11 +101,22 @@ void PointIntegralSolver::reset_stage_solutions()
     *_scheme->stage_solutions()[stage]->vector() = 0.0;
 
     // Reset local stage solutions
-    for (unsigned int row=0; row < _system_size; row++)
-      _local_stage_solutions[stage][row] = 0.0;
+    for (auto data = _local_data.begin(); data != _local_data.end(); ++data)
+    {
+      std::fill(data->local_stage_solutions[stage].begin(),
+                data->local_stage_solutions[stage].end(), 0.0);
+    }
   }
 }
 //-----------------------------------------------------------------------------
+std::size_t PointIntegralSolver::num_jacobian_computations() const
+{
+  std::size_t num_computations = 0;
+  for (auto data = _local_data.begin(); data != _local_data.end(); ++data)
+    num_computations += data->num_jacobian_computations;
+  return num_computations;
+}
+//-----------------------------------------------------------------------------
 void PointIntegralSolver::step(double dt)
 {
   dolfin_assert(_mesh);
@@ -139,89 +157,74 @@ void PointIntegralSolver::step(double dt)
 #endif
 
 
-  try
+  // Number of threads for the vertex loop
+  const std::size_t num_threads = SubSystemsManager::num_threads();
+  _init_local_data(num_threads);
+
+  // Allocate storage for one Jacobian per vertex, initially stale
+  if (_scheme->implicit() and parameters("newton_solver")["store_jacobians"])
+  {
+    const std::size_t num_jacobians
+      = _mesh->num_vertices()*_local_data[0].jacobians.size();
+    if (_vertex_jacobian_stale.size() != num_jacobians)
+    {
+      _vertex_jacobians.resize(num_jacobians*_system_size*_system_size);
+      _vertex_jacobian_stale.assign(num_jacobians, true);
+    }
+  }
+  else
   {
+    _vertex_jacobians.clear();
+    _vertex_jacobian_stale.clear();
+  }
 
-    // Iterate over vertices
-    ufc::cell ufc_cell;
-    std::vector<double> coordinate_dofs;
-    for (std::size_t vert_ind = 0; vert_ind < _mesh->num_vertices(); ++vert_ind)
+  try
+  {
+    const std::size_t num_vertices = _mesh->num_vertices();
+    if (num_threads == 1)
     {
-      // Cell containing vertex
-      const Cell cell(*_mesh, _vertex_map[vert_ind].first);
-      cell.get_coordinate_dofs(coordinate_dofs);
-      cell.get_cell_data(ufc_cell);
-
-      // Get all dofs for cell
-      // FIXME: Should we include logics about empty dofmaps?
-      auto cell_dofs = _dofmap.cell_dofs(cell.index());
-
-      // Tabulate local-local dofmap
-      _dofmap.tabulate_entity_dofs(_local_to_local_dofs, 0,
-                                   _vertex_map[vert_ind].second);
-
-      // Fill local to global dof map and check that the dof is owned
-      bool owns_all_dofs = true;
-      for (unsigned int row = 0; row < _system_size; row++)
+      // Iterate over vertices
+      for (std::size_t vert_ind = 0; vert_ind < num_vertices; ++vert_ind)
+        _step_vertex(vert_ind, local_dof_size, _local_data[0]);
+    }
+    else
+    {
+      // Iterate over contiguous blocks of vertices concurrently. An
+      // exception cannot leave the parallel region, so the first one
+      // is stored and rethrown.
+      std::exception_ptr error;
+      const std::int64_t _num_vertices = num_vertices;
+      #pragma omp parallel num_threads(num_threads)
       {
-        _local_to_global_dofs[row] = cell_dofs[_local_to_local_dofs[row]];
-        if (_local_to_global_dofs[row] >= local_dof_size)
+#ifdef HAS_OPENMP
+        LocalData& data = _local_data[omp_get_thread_num()];
+#else
+        LocalData& data = _local_data[0];
+#endif
+        #pragma omp for schedule(static)
+        for (std::int64_t vert_ind = 0; vert_ind < _num_vertices; ++vert_ind)
         {
-          owns_all_dofs = false;
-          break;
-        }
-      }
+          bool failed = false;
+          #pragma omp critical (dolfin_point_integral_solver_error)
+          failed = (bool) error;
+          if (failed)
+            continue;
 
-      // If not owning all dofs
-      if (!owns_all_dofs)
-        continue;
-
-      // Iterate over stage forms
-      for (unsigned int stage = 0; stage < _num_stages; stage++)
-      {
-        // Update cell
-        // TODO: Pass suitable bool vector here to avoid tabulating all
-        // coefficient dofs:
-        _ufcs[stage][0]->update(cell, coordinate_dofs, ufc_cell);
-        //some_integral.enabled_coefficients());
-
-        // Check if we have an explicit stage (only 1 form)
-        if (_ufcs[stage].size() == 1)
-        {
-          _solve_explicit_stage(vert_ind, stage, ufc_cell, coordinate_dofs);
-        }
-        // or an implicit stage (2 forms)
-        else
-        {
-          _solve_implicit_stage(vert_ind, stage, cell, ufc_cell,
-                                coordinate_dofs);
+          try
+          {
+            _step_vertex(vert_ind, local_dof_size, data);
+          }
+          catch (...)
+          {
+            #pragma omp critical (dolfin_point_integral_solver_error)
+            if (!error)
+              error = std::current_exception();
+          }
         }
       }
 
-      // Last stage point integral
-      const ufc::vertex_integral& integral
-        = *_last_stage_ufc->default_vertex_integral;
-
-      // Update coefficients for last stage
-      // TODO: Pass suitable bool vector here to avoid tabulating all
-      // coefficient dofs:
-      _last_stage_ufc->update(cell, coordinate_dofs, ufc_cell);
-      //integral.enabled_coefficients());
-
-      // Tabulate cell tensor
-      integral.tabulate_tensor(_last_stage_ufc->A.data(), _last_stage_ufc->w(),
-                               coordinate_dofs.data(),
-                               _vertex_map[vert_ind].second,
-                               ufc_cell.orientation);
-
-      // Update solution with a tabulation of the last stage
-      for (unsigned int row = 0; row < _system_size; row++)
-        _y[row] = _last_stage_ufc->A[_local_to_local_dofs[row]];
-
-      // Update global solution with last stage
-      _scheme->solution()->vector()->set_local(_y.data(),
-                                               _local_to_global_dofs.size(),
-                                               _local_to_global_dofs.data());
+      if (error)
+        std::rethrow_exception(error);
     }
 
     Timer timer_apply("PointIntegralSolver::apply");
@@ -253,32 +256,125 @@ void PointIntegralSolver::step(double dt)
   timer.stop();
 }
 //-----------------------------------------------------------------------------
+void PointIntegralSolver::_init_local_data(std::size_t num_threads)
+{
+  const std::size_t num_local_data = _local_data.size();
+  if (num_local_data >= num_threads)
+    return;
+
+  // Copy work arrays and create new UFC objects for each additional
+  // thread
+  _local_data.resize(num_threads, _local_data[0]);
+  for (std::size_t i = num_local_data; i < num_threads; ++i)
+  {
+    LocalData& data = _local_data[i];
+    for (unsigned int stage = 0; stage < data.ufcs.size(); stage++)
+    {
+      for (unsigned int j = 0; j < data.ufcs[stage].size(); j++)
+        data.ufcs[stage][j] = std::make_shared<UFC>(*data.ufcs[stage][j]);
+    }
+    data.last_stage_ufc = std::make_shared<UFC>(*data.last_stage_ufc);
+    data.num_jacobian_computations = 0;
+  }
+}
+//-----------------------------------------------------------------------------
+void PointIntegralSolver::_step_vertex(std::size_t vert_ind,
+                                       dolfin::la_index local_dof_size,
+                                       LocalData& data)
+{
+  // Cell containing vertex
+  const Cell cell(*_mesh, _vertex_map[vert_ind].first);
+  cell.get_coordinate_dofs(data.coordinate_dofs);
+  cell.get_cell_data(data.ufc_cell);
+
+  // Get all dofs for cell
+  // FIXME: Should we include logics about empty dofmaps?
+  auto cell_dofs = _dofmap.cell_dofs(cell.index());
+
+  // Tabulate local-local dofmap
+  _dofmap.tabulate_entity_dofs(data.local_to_local_dofs, 0,
+                               _vertex_map[vert_ind].second);
+
+  // Fill local to global dof map and check that the dof is owned
+  for (unsigned int row = 0; row < _system_size; row++)
+  {
+    data.local_to_global_dofs[row] = cell_dofs[data.local_to_local_dofs[row]];
+
+    // If not owning all dofs
+    if (data.local_to_global_dofs[row] >= local_dof_size)
+      return;
+  }
+
+  // Iterate over stage forms
+  for (unsigned int stage = 0; stage < _num_stages; stage++)
+  {
+    // Update cell
+    // TODO: Pass suitable bool vector here to avoid tabulating all
+    // coefficient dofs:
+    #pragma omp critical (dolfin_point_integral_solver)
+    data.ufcs[stage][0]->update(cell, data.coordinate_dofs, data.ufc_cell);
+    //some_integral.enabled_coefficients());
+
+    // Check if we have an explicit stage (only 1 form)
+    if (data.ufcs[stage].size() == 1)
+      _solve_explicit_stage(vert_ind, stage, data);
+    // or an implicit stage (2 forms)
+    else
+      _solve_implicit_stage(vert_ind, stage, cell, data);
+  }
+
+  // Last stage point integral
+  const ufc::vertex_integral& integral
+    = *data.last_stage_ufc->default_vertex_integral;
+
+  // Update coefficients for last stage
+  // TODO: Pass suitable bool vector here to avoid tabulating all
+  // coefficient dofs:
+  #pragma omp critical (dolfin_point_integral_solver)
+  data.last_stage_ufc->update(cell, data.coordinate_dofs, data.ufc_cell);
+  //integral.enabled_coefficients());
+
+  // Tabulate cell tensor
+  integral.tabulate_tensor(data.last_stage_ufc->A.data(),
+                           data.last_stage_ufc->w(),
+                           data.coordinate_dofs.data(),
+                           _vertex_map[vert_ind].second,
+                           data.ufc_cell.orientation);
+
+  // Update solution with a tabulation of the last stage
+  for (unsigned int row = 0; row < _system_size; row++)
+    data.y[row] = data.last_stage_ufc->A[data.local_to_local_dofs[row]];
+
+  // Update global solution with last stage
+  #pragma omp critical (dolfin_point_integral_solver)
+  _scheme->solution()->vector()->set_local(data.y.data(),
+                                           data.local_to_global_dofs.size(),
+                                           data.local_to_global_dofs.data());
+}
+//-----------------------------------------------------------------------------
 void PointIntegralSolver::_solve_explicit_stage(std::size_t vert_ind,
                                                 unsigned int stage,
-                                                const ufc::cell& ufc_cell,
-                                                const std::vector<double>& coordinate_dofs)
+                                                LocalData& data)
 {
 
   // Local vertex ind
   const unsigned int local_vert = _vertex_map[vert_ind].second;
 
   // Point integral
-  const ufc::vertex_integral& integral
-    = *_ufcs[stage][0]->default_vertex_integral;
+  UFC& loc_ufc = *data.ufcs[stage][0];
+  const ufc::vertex_integral& integral = *loc_ufc.default_vertex_integral;
 
   // Tabulate cell tensor
-  integral.tabulate_tensor(_ufcs[stage][0]->A.data(), _ufcs[stage][0]->w(),
-                           coordinate_dofs.data(), local_vert,
-                           ufc_cell.orientation);
+  integral.tabulate_tensor(loc_ufc.A.data(), loc_ufc.w(),
+                           data.coordinate_dofs.data(), local_vert,
+                           data.ufc_cell.orientation);
 
   // Extract vertex dofs from tabulated tensor and put them into the
   // local stage solution vector
   //Extract vertex dofs from tabulated tensor
+  std::vector<double>& u = data.local_stage_solutions[stage];
   for (unsigned int row = 0; row < _system_size; row++)
-  {
-    _local_stage_solutions[stage][row]
-      = _ufcs[stage][0]->A[_local_to_local_dofs[row]];
-  }
+    u[row] = loc_ufc.A[data.local_to_local_dofs[row]];
 
 
   // FIXME: This below is dodgy and will sooner or later break in
@@ -286,24 +382,24 @@ void PointIntegralSolver::_solve_explicit_stage(std::size_t vert_ind,
   // Put solution back into global stage solution vector
   // NOTE: This so an UFC.update (coefficient restriction) would just
   // work
+  #pragma omp critical (dolfin_point_integral_solver)
   _scheme->stage_solutions()[stage]->vector()->set_local(
-    _local_stage_solutions[stage].data(), _system_size,
-    _local_to_global_dofs.data());
+    u.data(), _system_size, data.local_to_global_dofs.data());
 }
 //-----------------------------------------------------------------------------
 void PointIntegralSolver::_solve_implicit_stage(std::size_t vert_ind,
                                                 unsigned int stage,
                                                 const Cell& cell,
-                                                const ufc::cell& ufc_cell,
-                                                const std::vector<double>& coordinate_dofs)
+                                                LocalData& data)
 {
   // Do a simplified newton solve
-  _simplified_newton_solve(vert_ind, stage, cell, ufc_cell, coordinate_dofs);
+  _simplified_newton_solve(vert_ind, stage, cell, data);
 
   // Put solution back into global stage solution vector
-  _scheme->stage_solutions()[stage]->vector()->set_local(_local_stage_solutions[stage].data(),
-                                                         _system_size,
-                                                         _local_to_global_dofs.data());
+  #pragma omp critical (dolfin_point_integral_solver)
+  _scheme->stage_solutions()[stage]->vector()->set_local(
+    data.local_stage_solutions[stage].data(), _system_size,
+    data.local_to_global_dofs.data());
 }
 //-----------------------------------------------------------------------------
 void PointIntegralSolver::step_interval(double t0, double t1, double dt)
@@ -326,6 +422,49 @@ void PointIntegralSolver::step_interval(double t0, double t1, double dt)
   *_scheme->t() = t0;
   double t = t0;
   double next_dt = std::min(t1-t, dt);
+  _num_steps = std::make_pair(0, 0);
+
+  // Adaptive stepping using the embedded error estimate
+  if (parameters["adaptive"] && _scheme->has_error_estimate())
+  {
+    TimeStepController controller(_scheme->embedded_order());
+    controller.parameters.update(parameters("time_step_control"));
+    const double atol = controller.parameters["absolute_tolerance"];
+    const double rtol = controller.parameters["relative_tolerance"];
+    const double dt_min = controller.parameters["minimum_time_step"];
+
+    GenericVector& solution_vector = *_scheme->solution()->vector();
+    std::shared_ptr<GenericVector> u0 = solution_vector.copy();
+    while (t1 - t > DOLFIN_EPS*std::max(1.0, std::abs(t1)))
+    {
+      *u0 = solution_vector;
+      step(next_dt);
+
+      // Accept step, or restore solution and time
+      double proposed_dt = next_dt;
+      const double error = _scheme->error_norm(*u0, atol, rtol);
+      if (controller.accept(error, proposed_dt))
+        t = *_scheme->t();
+      else
+      {
+        solution_vector = *u0;
+        *_scheme->t() = t;
+      }
+
+      if (proposed_dt < dt_min)
+      {
+        dolfin_error("PointIntegralSolver.cpp",
+                     "stepping PointIntegralSolver",
+                     "Time step %g fell below minimum time step at t = %g",
+                     proposed_dt, t);
+      }
+      next_dt = std::min(t1 - t, proposed_dt);
+    }
+
+    _num_steps = std::make_pair(controller.num_accepted_steps(),
+                                controller.num_rejected_steps());
+    return;
+  }
 
   // Step interval
   while (t + next_dt <= t1)
@@ -333,24 +472,27 @@ void PointIntegralSolver::step_interval(double t0, double t1, double dt)
     if (next_dt < DOLFIN_EPS)
       break;
     step(next_dt);
+    ++_num_steps.first;
     t = *_scheme->t();
     next_dt = std::min(t1-t, dt);
   }
 }
 //-----------------------------------------------------------------------------
-void PointIntegralSolver::_compute_jacobian(std::vector<double>& jac,
+void PointIntegralSolver::_compute_jacobian(double* jac,
                                             const std::vector<double>& u,
                                             unsigned int local_vert,
                                             UFC& loc_ufc, const Cell& cell,
-                                            const ufc::cell& ufc_cell,
                                             int coefficient_index,
-                                            const std::vector<double>& coordinate_dofs)
+                                            LocalData& data)
 {
   const ufc::vertex_integral& J_integral = *loc_ufc.default_vertex_integral;
+  const std::vector<std::size_t>& local_to_local_dofs
+    = data.local_to_local_dofs;
 
   // TODO: Pass suitable bool vector here to avoid tabulating all
   // coefficient dofs:
-  loc_ufc.update(cell, coordinate_dofs, ufc_cell);
+  #pragma omp critical (dolfin_point_integral_solver)
+  loc_ufc.update(cell, data.coordinate_dofs, data.ufc_cell);
   //J_integral.enabled_coefficients());
 
   // If there is a solution coefficient in the Jacobian form
@@ -359,14 +501,14 @@ void PointIntegralSolver::_compute_jacobian(std::vector<double>& jac,
     // Put solution back into restricted coefficients before tabulate
     // new jacobian
     for (unsigned int row = 0; row < _system_size; row++)
-      loc_ufc.w()[coefficient_index][_local_to_local_dofs[row]] = u[row];
+      loc_ufc.w()[coefficient_index][local_to_local_dofs[row]] = u[row];
   }
 
   // Tabulate Jacobian
   J_integral.tabulate_tensor(loc_ufc.A.data(), loc_ufc.w(),
-                             coordinate_dofs.data(),
+                             data.coordinate_dofs.data(),
                              local_vert,
-                             ufc_cell.orientation);
+                             data.ufc_cell.orientation);
 
   // Extract vertex dofs from tabulated tensor
   for (unsigned int row = 0; row < _system_size; row++)
@@ -374,76 +516,64 @@ void PointIntegralSolver::_compute_jacobian(std::vector<double>& jac,
     for (unsigned int col = 0; col < _system_size; col++)
     {
       jac[row*_system_size + col]
-        = loc_ufc.A[_local_to_local_dofs[row]*_dof_offset*_system_size
-                    + _local_to_local_dofs[col]];
+        = loc_ufc.A[local_to_local_dofs[row]*_dof_offset*_system_size
+                    + local_to_local_dofs[col]];
     }
   }
 
   // LU factorize Jacobian
   _lu_factorize(jac);
-  _num_jacobian_computations += 1;
+  data.num_jacobian_computations += 1;
 
 }
 //-----------------------------------------------------------------------------
-void PointIntegralSolver::_lu_factorize(std::vector<double>& A)
+void PointIntegralSolver::_lu_factorize(double* A) const
 {
-  // Local variables
-  double sum;
-  const int system_size = _system_size;
-  for (int k = 1; k < system_size; k++)
+  // In-place LU factorization without pivoting, storing the unit
+  // lower triangle below the diagonal. The update of each row is a
+  // contiguous loop which the compiler can vectorise.
+  const std::size_t n = _system_size;
+  for (std::size_t k = 0; k < n; ++k)
   {
-    for (int i = 0; i <= k-1; ++i)
+    const double* A_k = A + k*n;
+    const double pivot = A_k[k];
+    for (std::size_t i = k + 1; i < n; ++i)
     {
-      sum = 0.0;
-      for (int r = 0; r <= i-1; r++)
-        sum += A[i*_system_size+r]*A[r*_system_size+k];
-      A[i*_system_size+k] -=sum;
-
-      sum = 0.0;
-      for (int r = 0; r <= i-1; r++)
-        sum += A[k*_system_size+r]*A[r*_system_size+i];
-      A[k*_system_size+i] = (A[k*_system_size+i]-sum)/A[i*_system_size+i];
+      double* A_i = A + i*n;
+      const double l = A_i[k]/pivot;
+      A_i[k] = l;
+      for (std::size_t j = k + 1; j < n; ++j)
+        A_i[j] -= l*A_k[j];
     }
-
-    sum = 0.0;
-    for (int r = 0; r <= k-1; r++)
-      sum += A[k*_system_size+r]*A[r*_system_size+k];
-    A[k*_system_size + k] -= sum;
   }
 }
 //-----------------------------------------------------------------------------
-void PointIntegralSolver::_forward_backward_subst(const std::vector<double>& A,
+void PointIntegralSolver::_forward_backward_subst(const double* A,
                                                   const std::vector<double>& b,
                                                   std::vector<double>& x) const
 {
   // solves Ax = b with forward backward substitution, provided that
   // A is already LU factorized
-
-  double sum;
-  x[0] = b[0];
+  const std::size_t n = _system_size;
 
   // Forward
-  for (unsigned int i=1; i < _system_size; ++i)
+  for (std::size_t i = 0; i < n; ++i)
   {
-    sum = 0.0;
-    for (unsigned int j=0; j <= i-1; ++j)
-      sum = sum + A[i*_system_size+j]*x[j];
-
-    x[i] = b[i] -sum;
+    const double* A_i = A + i*n;
+    double sum = 0.0;
+    for (std::size_t j = 0; j < i; ++j)
+      sum += A_i[j]*x[j];
+    x[i] = b[i] - sum;
   }
 
-  const unsigned int _system_size_m_1 = _system_size-1;
-  x[_system_size_m_1]
-    = x[_system_size_m_1]/A[_system_size_m_1*_system_size + _system_size_m_1];
-
   // Backward
-  for (int i = _system_size-2; i >= 0; i--)
+  for (std::size_t i = n; i-- > 0;)
   {
-    sum = 0;
-    for (unsigned int j=i+1; j < _system_size; ++j)
-      sum = sum +A[i*_system_size+j]*x[j];
-
-    x[i] = (x[i]-sum)/A[i*_system_size+i];
+    const double* A_i = A + i*n;
+    double sum = 0.0;
+    for (std::size_t j = i + 1; j < n; ++j)
+      sum += A_i[j]*x[j];
+    x[i] = (x[i] - sum)/A_i[i];
   }
 }
 //-----------------------------------------------------------------------------
@@ -500,13 +630,24 @@ void PointIntegralSolver::_init()
   std::vector<std::vector<std::shared_ptr<const Form>>>& stage_forms
     = _scheme->stage_forms();
 
+  // Work arrays for the serial vertex loop
+  LocalData& data = _local_data[0];
+  data.local_to_local_dofs.resize(_system_size);
+  data.local_to_global_dofs.resize(_system_size);
+  data.u0.resize(_system_size);
+  data.residual.resize(_system_size);
+  data.y.resize(_system_size);
+  data.dx.resize(_system_size);
+  data.num_jacobian_computations = 0;
+
   // Init local stage solutions
+  data.local_stage_solutions.resize(_scheme->stage_solutions().size());
   for (unsigned int stage = 0; stage < _num_stages; stage++)
-    _local_stage_solutions[stage].resize(_system_size);
+    data.local_stage_solutions[stage].resize(_system_size);
 
   // Init coefficient index and ufcs
   _coefficient_index.resize(stage_forms.size());
-  _ufcs.resize(stage_forms.size());
+  data.ufcs.resize(stage_forms.size());
 
   // Initiate jacobian matrices
   if (_scheme->implicit())
@@ -520,26 +661,26 @@ void PointIntegralSolver::_init()
     }
 
     // Create memory for jacobians
-    _jacobians.resize(max_jacobian_index+1);
+    data.jacobians.resize(max_jacobian_index+1);
     for (int i=0; i<=max_jacobian_index; i++)
-      _jacobians[i].resize(_system_size*_system_size);
-    _recompute_jacobian.resize(max_jacobian_index+1, true);
+      data.jacobians[i].resize(_system_size*_system_size);
+    data.recompute_jacobian.resize(max_jacobian_index+1, true);
   }
 
   // Create last stage UFC form
-  _last_stage_ufc = std::make_shared<UFC>(*_scheme->last_stage());
+  data.last_stage_ufc = std::make_shared<UFC>(*_scheme->last_stage());
 
   // Iterate over stages and collect information
   for (unsigned int stage = 0; stage < stage_forms.size(); stage++)
   {
     // Create a UFC object for first form
-    _ufcs[stage].push_back(std::make_shared<UFC>(*stage_forms[stage][0]));
+    data.ufcs[stage].push_back(std::make_shared<UFC>(*stage_forms[stage][0]));
 
     //  If implicit stage
     if (stage_forms[stage].size()==2)
     {
       // Create a UFC object for second form
-      _ufcs[stage].push_back(std::make_shared<UFC>(*stage_forms[stage][1]));
+      data.ufcs[stage].push_back(std::make_shared<UFC>(*stage_forms[stage][1]));
 
       // Find coefficient index for each of the two implicit forms
       for (unsigned int i = 0; i < 2; i++)
@@ -571,6 +712,7 @@ void PointIntegralSolver::_init()
 
   // Build vertex map
   _vertex_map.resize(_mesh->num_vertices());
+  _eta.resize(_mesh->num_vertices(), 1.0);
 
   // Init mesh connections
   _mesh->init(0);
@@ -622,7 +764,7 @@ void PointIntegralSolver::_init()
 //-----------------------------------------------------------------------------
 void PointIntegralSolver::_simplified_newton_solve(
   std::size_t vert_ind, unsigned int stage, const Cell& cell,
-  const ufc::cell& ufc_cell, const std::vector<double>& coordinate_dofs)
+  LocalData& data)
 {
   const Parameters& newton_solver_params = parameters("newton_solver");
   const size_t report_vertex = newton_solver_params["report_vertex"];
@@ -638,16 +780,37 @@ void PointIntegralSolver::_simplified_newton_solve(
   bool always_recompute_jacobian
     = newton_solver_params["always_recompute_jacobian"];
   const unsigned int local_vert = _vertex_map[vert_ind].second;
-  UFC& loc_ufc_F = *_ufcs[stage][0];
-  UFC& loc_ufc_J = *_ufcs[stage][1];
+  UFC& loc_ufc_F = *data.ufcs[stage][0];
+  UFC& loc_ufc_J = *data.ufcs[stage][1];
   const int coefficient_index_F = _coefficient_index[stage][0];
   const int coefficient_index_J = _coefficient_index[stage].size()==2 ?
     _coefficient_index[stage][1] : -1;
   const unsigned int jac_index = _scheme->jacobian_index(stage);
-  std::vector<double>& jac = _jacobians[jac_index];
+  const bool store_jacobians = newton_solver_params["store_jacobians"];
+  double& eta = _eta[vert_ind];
+  const std::vector<std::size_t>& local_to_local_dofs
+    = data.local_to_local_dofs;
+  const std::vector<double>& coordinate_dofs = data.coordinate_dofs;
+  const ufc::cell& ufc_cell = data.ufc_cell;
+
+  // Use the Jacobian stored for this vertex, or the one of the
+  // current thread which is shared by consecutive vertices
+  double* jac;
+  char* jacobian_stale;
+  if (store_jacobians)
+  {
+    const std::size_t i = vert_ind*data.jacobians.size() + jac_index;
+    jac = _vertex_jacobians.data() + i*_system_size*_system_size;
+    jacobian_stale = &_vertex_jacobian_stale[i];
+  }
+  else
+  {
+    jac = data.jacobians[jac_index].data();
+    jacobian_stale = &data.recompute_jacobian[jac_index];
+  }
 
   if (newton_solver_params["recompute_jacobian_each_solve"])
-    _recompute_jacobian[jac_index] = true;
+    *jacobian_stale = true;
 
   bool newton_solve_restared = false;
   unsigned int newton_iterations = 0;
@@ -658,14 +821,14 @@ void PointIntegralSolver::_simplified_newton_solve(
   const ufc::vertex_integral& F_integral = *loc_ufc_F.default_vertex_integral;
 
   // Local solution
-  std::vector<double>& u = _local_stage_solutions[stage];
+  std::vector<double>& u = data.local_stage_solutions[stage];
 
   // Update with previous local solution and make a backup of solution
   // to be used in a potential restarting of newton solver
   for (unsigned int row=0; row < _system_size; row++)
   {
-    _u0[row] = u[row]
-      = loc_ufc_F.w()[coefficient_index_F][_local_to_local_dofs[row]];
+    data.u0[row] = u[row]
+      = loc_ufc_F.w()[coefficient_index_F][local_to_local_dofs[row]];
   }
 
   do
@@ -679,9 +842,9 @@ void PointIntegralSolver::_simplified_newton_solve(
     // Extract vertex dofs from tabulated tensor, together with the
     // old stage solution
     for (unsigned int row=0; row < _system_size; row++)
-      _residual[row] = loc_ufc_F.A[_local_to_local_dofs[row]];
+      data.residual[row] = loc_ufc_F.A[local_to_local_dofs[row]];
 
-    residual = _norm(_residual);
+    residual = _norm(data.residual);
     if (newton_iterations == 0)
       initial_residual = residual;//std::max(residual, DOLFIN_EPS);
 
@@ -699,15 +862,15 @@ void PointIntegralSolver::_simplified_newton_solve(
     }
 
     // Should we recompute jacobian
-    if (_recompute_jacobian[jac_index] || always_recompute_jacobian)
+    if (*jacobian_stale || always_recompute_jacobian)
     {
-      _compute_jacobian(jac, u, local_vert, loc_ufc_J, cell, ufc_cell,
-                        coefficient_index_J, coordinate_dofs);
-      _recompute_jacobian[jac_index] = false;
+      _compute_jacobian(jac, u, local_vert, loc_ufc_J, cell,
+                        coefficient_index_J, data);
+      *jacobian_stale = false;
     }
 
     // Perform linear solve By forward backward substitution
-    _forward_backward_subst(jac, _residual, _dx);
+    _forward_backward_subst(jac, data.residual, data.dx);
 
     // Newton_Iterations == 0
     if (newton_iterations == 0)
@@ -716,8 +879,8 @@ void PointIntegralSolver::_simplified_newton_solve(
       // the one from previous step and increase it slightly. This is
       // important for linear problems which only should require 1
       // iteration to converge.
-      _eta = _eta > DOLFIN_EPS ? _eta : DOLFIN_EPS;
-      _eta = std::pow(_eta, 0.8);
+      eta = eta > DOLFIN_EPS ? eta : DOLFIN_EPS;
+      eta = std::pow(eta, 0.8);
     }
     // 2nd time around
     else
@@ -762,12 +925,12 @@ void PointIntegralSolver::_simplified_newton_solve(
           // Reset solution
           for (unsigned int row=0; row < _system_size; row++)
           {
-            loc_ufc_F.w()[coefficient_index_F][_local_to_local_dofs[row]]
-              = u[row] = _u0[row];
+            loc_ufc_F.w()[coefficient_index_F][local_to_local_dofs[row]]
+              = u[row] = data.u0[row];
           }
 
           // Update variables
-          _eta = parameters("newton_solver")["eta_0"];
+          eta = newton_solver_params["eta_0"];
           newton_iterations = 0;
           relative_previous_residual = prev_residual = initial_residual
             = relative_residual = 1.0;
@@ -791,7 +954,7 @@ void PointIntegralSolver::_simplified_newton_solve(
                newton_iterations, vert_ind, relative_previous_residual,
                relative_residual, residual);
         }
-        _recompute_jacobian[jac_index] = true;
+        *jacobian_stale = true;
       }
       else
       {
@@ -804,7 +967,7 @@ void PointIntegralSolver::_simplified_newton_solve(
                relative_residual, residual);
         }
         // Update eta
-        _eta = relative_previous_residual/(1.0 - relative_previous_residual);
+        eta = relative_previous_residual/(1.0 - relative_previous_residual);
       }
     }
 
@@ -826,20 +989,20 @@ void PointIntegralSolver::_simplified_newton_solve(
     // Update solution
     if (std::abs(1.0 - relaxation) < DOLFIN_EPS)
       for (unsigned int i=0; i < u.size(); i++)
-        u[i] -= _dx[i];
+        u[i] -= data.dx[i];
     else
       for (unsigned int i=0; i < u.size(); i++)
-        u[i] -= relaxation*_dx[i];
+        u[i] -= relaxation*data.dx[i];
 
     // Put solution back into restricted coefficients before tabulate
     // new residual
     for (unsigned int row=0; row < _system_size; row++)
-      loc_ufc_F.w()[coefficient_index_F][_local_to_local_dofs[row]] = u[row];
+      loc_ufc_F.w()[coefficient_index_F][local_to_local_dofs[row]] = u[row];
 
     prev_residual = residual;
     newton_iterations++;
 
-  } while(_eta*relative_residual >= kappa*rtol);
+  } while(eta*relative_residual >= kappa*rtol);
 
   if ((report && vert_ind == report_vertex) || verbose_report)
   {
@@ -23,10 +23,13 @@
 
 #include <memory>
 #include <set>
+#include <utility>
 #include <vector>
 
+#include <ufc.h>
 #include <dolfin/common/Variable.h>
 #include <dolfin/fem/Assembler.h>
+#include "TimeStepController.h"
 
 namespace dolfin
 {
@@ -39,6 +42,30 @@ namespace dolfin
   /// It only includes Point integrals with piecewise linear test
   /// functions. Such problems are disconnected at the vertices and
   /// can therefore be solved locally.
+  ///
+  /// The vertex loop runs on the number of threads given by the
+  /// global parameter "num_threads" (serial if zero or if DOLFIN is
+  /// compiled without OpenMP). Each thread uses its own UFC objects
+  /// and work arrays, while restriction of coefficients and insertion
+  /// into the global vectors are serialised. The Newton convergence
+  /// estimate is kept per vertex, so results do not depend on the
+  /// number of threads as long as the Jacobian is recomputed for each
+  /// solve ("recompute_jacobian_each_solve", default). Otherwise each
+  /// thread reuses the Jacobian over its own contiguous block of
+  /// vertices.
+  ///
+  /// If the Newton solver parameter "store_jacobians" is set, a
+  /// factorized Jacobian is kept for each vertex and reused over
+  /// stages and time steps until the convergence at that vertex
+  /// deteriorates. This requires "recompute_jacobian_each_solve" to be
+  /// false (and "reset_each_step" to be false for reuse over steps),
+  /// and uses (number of dofs per vertex)^2 doubles per vertex and
+  /// Jacobian.
+  ///
+  /// If the parameter "adaptive" is set and the scheme includes an
+  /// embedded error estimate, step_interval adapts the time step
+  /// using a TimeStepController with the parameters
+  /// "time_step_control".
 
   class PointIntegralSolver : public Variable
   {
@@ -55,7 +82,8 @@ namespace dolfin
     /// Step solver with time step dt
     void step(double dt);
 
-    /// Step solver an interval using dt as time step
+    /// Step solver an interval using dt as time step (the initial
+    /// time step if adaptive)
     void step_interval(double t0, double t1, double dt);
 
     /// Return the MultiStageScheme
@@ -68,12 +96,15 @@ namespace dolfin
       Parameters p("point_integral_solver");
 
       p.add("reset_stage_solutions", true);
+      p.add("adaptive", false);
+      p.add(TimeStepController::default_parameters());
 
       // Set parameters for NewtonSolver
       Parameters pn("newton_solver");
       pn.add("maximum_iterations", 40);
       pn.add("always_recompute_jacobian", false);
       pn.add("recompute_jacobian_each_solve", true);
+      pn.add("store_jacobians", false);
       pn.add("relaxation_parameter", 1., 0., 1.);
       pn.add("relative_tolerance", 1e-10, 1e-20, 2.);
       pn.add("absolute_tolerance", 1e-15, 1e-20, 2.);
@@ -98,27 +129,80 @@ namespace dolfin
     void reset_stage_solutions();
 
     /// Return number of computations of jacobian
-    std::size_t num_jacobian_computations() const
-    { return _num_jacobian_computations; }
+    std::size_t num_jacobian_computations() const;
+
+    /// Return number of accepted and rejected steps of the last call
+    /// to step_interval
+    std::pair<std::size_t, std::size_t> num_steps() const
+    { return _num_steps; }
 
   private:
 
+    // Work arrays and UFC objects used in the vertex loop, one
+    // instance per thread
+    struct LocalData
+    {
+      // Local to local dofs to be used in tabulate entity dofs
+      std::vector<std::size_t> local_to_local_dofs;
+
+      // Local to global dofs used when solution is fanned out to
+      // global vector
+      std::vector<dolfin::la_index> local_to_global_dofs;
+
+      // Local stage solutions
+      std::vector<std::vector<double>> local_stage_solutions;
+
+      // Local solutions
+      std::vector<double> u0;
+      std::vector<double> residual;
+      std::vector<double> y;
+      std::vector<double> dx;
+
+      // UFC objects, one for each form
+      std::vector<std::vector<std::shared_ptr<UFC>>> ufcs;
+
+      // UFC objects for the last form
+      std::shared_ptr<UFC> last_stage_ufc;
+
+      // Flag which is set to false once the jacobian has been
+      // computed
+      std::vector<char> recompute_jacobian;
+
+      // Jacobians/LU factorized jacobians matrices
+      std::vector<std::vector<double>> jacobians;
+
+      // Cell data
+      ufc::cell ufc_cell;
+      std::vector<double> coordinate_dofs;
+
+      // Number of computations of Jacobian
+      std::size_t num_jacobian_computations;
+    };
+
+    // Make sure there is local data for num_threads threads, copying
+    // the UFC objects of the first instance
+    void _init_local_data(std::size_t num_threads);
+
+    // Solve all stages at a vertex and insert the last stage into the
+    // solution vector
+    void _step_vertex(std::size_t vert_ind, dolfin::la_index local_dof_size,
+                      LocalData& data);
+
     // In-place LU factorization of jacobian matrix
-    void _lu_factorize(std::vector<double>& A);
+    void _lu_factorize(double* A) const;
 
     // Forward backward substitution, assume that mat is already
     // in place LU factorized
-    void _forward_backward_subst(const std::vector<double>& A,
+    void _forward_backward_subst(const double* A,
                                  const std::vector<double>& b,
                                  std::vector<double>& x) const;
 
     // Compute jacobian using passed UFC form
-    void _compute_jacobian(std::vector<double>& jac,
+    void _compute_jacobian(double* jac,
                            const std::vector<double>& u,
                            unsigned int local_vert, UFC& loc_ufc,
-                           const Cell& cell, const ufc::cell& ufc_cell,
-                           int coefficient_index,
-                           const std::vector<double>& coordinate_dofs);
+                           const Cell& cell, int coefficient_index,
+                           LocalData& data);
 
     // Compute the norm of a vector
     double _norm(const std::vector<double>& vec) const;
@@ -133,18 +217,15 @@ namespace dolfin
 
     // Solve an explicit stage
     void _solve_explicit_stage(std::size_t vert_ind, unsigned int stage,
-                               const ufc::cell& ufc_cell,
-                               const std::vector<double>& coordinate_dofs);
+                               LocalData& data);
 
     // Solve an implicit stage
     void _solve_implicit_stage(std::size_t vert_ind, unsigned int stage,
-                               const Cell& cell, const ufc::cell& ufc_cell,
-                               const std::vector<double>& coordinate_dofs);
+                               const Cell& cell, LocalData& data);
 
     void
       _simplified_newton_solve(std::size_t vert_ind, unsigned int stage,
-                               const Cell& cell, const ufc::cell& ufc_cell,
-                               const std::vector<double>& coordinate_dofs);
+                               const Cell& cell, LocalData& data);
 
     // The MultiStageScheme
     std::shared_ptr<MultiStageScheme> _scheme;
@@ -165,48 +246,29 @@ namespace dolfin
     // Number of stages
     const unsigned int _num_stages;
 
-    // Local to local dofs to be used in tabulate entity dofs
-    std::vector<std::size_t> _local_to_local_dofs;
-
     // Vertex map between vertices, cells and corresponding local
     // vertex
     std::vector<std::pair<std::size_t, unsigned int>> _vertex_map;
 
-    // Local to global dofs used when solution is fanned out to global
-    // vector
-    std::vector<dolfin::la_index> _local_to_global_dofs;
-
-    // Local stage solutions
-    std::vector<std::vector<double>> _local_stage_solutions;
-
-    // Local solutions
-    std::vector<double> _u0;
-    std::vector<double> _residual;
-    std::vector<double> _y;
-    std::vector<double> _dx;
-
-    // UFC objects, one for each form
-    std::vector<std::vector<std::shared_ptr<UFC>>> _ufcs;
-
-    // UFC objects for the last form
-    std::shared_ptr<UFC> _last_stage_ufc;
-
     // Solution coefficient index in form
     std::vector<std::vector<int>> _coefficient_index;
 
-    // Flag which is set to false once the jacobian has been computed
-    std::vector<bool> _recompute_jacobian;
-
-    // Jacobians/LU factorized jacobians matrices
-    std::vector<std::vector<double>> _jacobians;
+    // Thread-local data (the first instance is used in serial)
+    std::vector<LocalData> _local_data;
 
     // Variable used in the estimation of the error of the newton
     // iteration for the first iteration (important for linear
-    // problems!)
-    double _eta;
+    // problems!), one for each vertex
+    std::vector<double> _eta;
+
+    // LU factorized Jacobians for each vertex and Jacobian index
+    // (if parameter "store_jacobians" is set), stored contiguously,
+    // and flags marking those which need to be recomputed
+    std::vector<double> _vertex_jacobians;
+    std::vector<char> _vertex_jacobian_stale;
 
-    // Number of computations of Jacobian
-    std::size_t _num_jacobian_computations;
+    // Number of accepted and rejected steps
+    std::pair<std::size_t, std::size_t> _num_steps;
 
   };
 
@@ -35,9 +35,17 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 RKSolver::RKSolver(std::shared_ptr<MultiStageScheme> scheme) :
-  _scheme(scheme), _tmp(scheme->solution()->vector()->copy())
+  Variable("RKSolver", "unnamed"), _scheme(scheme), _num_steps(0, 0)
 {
-  // Do nothing
+  // Set parameters
+  parameters = default_parameters();
+
+  // Stage solution vectors for the fused solution update
+  std::vector<std::shared_ptr<Function>>& stage_solutions
+    = _scheme->stage_solutions();
+  for (std::size_t i = 0; i < stage_solutions.size(); ++i)
+    _stage_vectors.push_back(stage_solutions[i]->vector());
+  _update_weights.resize(stage_solutions.size());
 }
 //-----------------------------------------------------------------------------
 void RKSolver::step(double dt)
@@ -57,6 +65,11 @@ void RKSolver::step(double dt)
     = _scheme->stage_solutions();
   std::vector<std::shared_ptr<const DirichletBC>> bcs = _scheme->bcs();
 
+  // Compute inverse of lumped mass (once)
+  const bool lumped_mass = parameters["lumped_mass"];
+  if (lumped_mass and !_inverse_mass)
+    init_inverse_mass();
+
   // Iterate over stage forms
   for (unsigned int stage=0; stage < stage_forms.size(); stage++)
   {
@@ -70,6 +83,10 @@ void RKSolver::step(double dt)
       _assembler.assemble(*stage_solutions[stage]->vector(),
                           *stage_forms[stage][0]);
 
+      // Apply inverse of lumped mass
+      if (lumped_mass)
+        *stage_solutions[stage]->vector() *= *_inverse_mass;
+
       // Apply boundary conditions
       // FIXME: stage solutions are time derivatives and we cannot apply the
       // bcs directly on them
@@ -97,14 +114,62 @@ void RKSolver::step(double dt)
   // Update solution with last stage
   GenericVector& solution_vector = *_scheme->solution()->vector();
 
-  // Do the last stage (just an assemble)
-  _assembler.assemble(*_tmp, *_scheme->last_stage());
-  solution_vector = *_tmp;
+  const std::vector<double>& weights = _scheme->solution_weights();
+  if (!weights.empty())
+  {
+    // Add weighted stage solutions in a single pass
+    for (std::size_t i = 0; i < weights.size(); ++i)
+      _update_weights[i] = dt*weights[i];
+    solution_vector.maxpy(_update_weights, _stage_vectors);
+    solution_vector.apply("insert");
+  }
+  else
+  {
+    // Do the last stage (just an assemble)
+    if (!_tmp)
+      _tmp = solution_vector.copy();
+    _assembler.assemble(*_tmp, *_scheme->last_stage());
+    solution_vector = *_tmp;
+  }
 
   // Update time
   *_scheme->t() = t0 + dt;
 }
 //-----------------------------------------------------------------------------
+void RKSolver::init_inverse_mass()
+{
+  if (_scheme->implicit())
+  {
+    dolfin_error("RKSolver.cpp",
+                 "stepping RKSolver",
+                 "A lumped mass requires a fully explicit scheme");
+  }
+  if (!_scheme->mass_form() || _scheme->solution_weights().empty())
+  {
+    dolfin_error("RKSolver.cpp",
+                 "stepping RKSolver",
+                 "A lumped mass requires a scheme with a mass form and solution weights");
+  }
+
+  // Assemble row sums of mass matrix and invert them
+  _inverse_mass = _scheme->solution()->vector()->copy();
+  _assembler.assemble_diagonal(*_inverse_mass, *_scheme->mass_form(), true);
+  std::vector<double> values;
+  _inverse_mass->get_local(values);
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    if (values[i] == 0.0)
+    {
+      dolfin_error("RKSolver.cpp",
+                   "stepping RKSolver",
+                   "Lumped mass is zero for local dof %d", i);
+    }
+    values[i] = 1.0/values[i];
+  }
+  _inverse_mass->set_local(values);
+  _inverse_mass->apply("insert");
+}
+//-----------------------------------------------------------------------------
 void RKSolver::step_interval(double t0, double t1, double dt)
 {
   if (dt <= 0.0)
@@ -125,6 +190,49 @@ void RKSolver::step_interval(double t0, double t1, double dt)
   *_scheme->t() = t0;
   double t = t0;
   double next_dt = std::min(t1-t, dt);
+  _num_steps = std::make_pair(0, 0);
+
+  // Adaptive stepping using the embedded error estimate
+  if (parameters["adaptive"] && _scheme->has_error_estimate())
+  {
+    TimeStepController controller(_scheme->embedded_order());
+    controller.parameters.update(parameters("time_step_control"));
+    const double atol = controller.parameters["absolute_tolerance"];
+    const double rtol = controller.parameters["relative_tolerance"];
+    const double dt_min = controller.parameters["minimum_time_step"];
+
+    GenericVector& solution_vector = *_scheme->solution()->vector();
+    std::shared_ptr<GenericVector> u0 = solution_vector.copy();
+    while (t1 - t > DOLFIN_EPS*std::max(1.0, std::abs(t1)))
+    {
+      *u0 = solution_vector;
+      step(next_dt);
+
+      // Accept step, or restore solution and time
+      double proposed_dt = next_dt;
+      const double error = _scheme->error_norm(*u0, atol, rtol);
+      if (controller.accept(error, proposed_dt))
+        t = *_scheme->t();
+      else
+      {
+        solution_vector = *u0;
+        *_scheme->t() = t;
+      }
+
+      if (proposed_dt < dt_min)
+      {
+        dolfin_error("RKSolver.cpp",
+                     "stepping RKSolver",
+                     "Time step %g fell below minimum time step at t = %g",
+                     proposed_dt, t);
+      }
+      next_dt = std::min(t1 - t, proposed_dt);
+    }
+
+    _num_steps = std::make_pair(controller.num_accepted_steps(),
+                                controller.num_rejected_steps());
+    return;
+  }
 
   // Step interval
   while (t + next_dt <= t1)
@@ -132,6 +240,7 @@ void RKSolver::step_interval(double t0, double t1, double dt)
     if (next_dt < DOLFIN_EPS)
       break;
     step(next_dt);
+    ++_num_steps.first;
     t = *_scheme->t();
     next_dt = std::min(t1-t, dt);
   }
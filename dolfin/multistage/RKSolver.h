@@ -21,10 +21,13 @@
 #ifndef __RKSOLVER_H
 #define __RKSOLVER_H
 
+#include <utility>
 #include <vector>
 #include <memory>
+#include <dolfin/common/Variable.h>
 #include <dolfin/fem/Assembler.h>
 #include <dolfin/la/GenericVector.h>
+#include "TimeStepController.h"
 
 namespace dolfin
 {
@@ -32,7 +35,20 @@ namespace dolfin
   class MultiStageScheme;
 
   /// This class is a time integrator for general Runge Kutta problems
-  class RKSolver
+
+  /// If the parameter "adaptive" is set and the scheme includes an
+  /// embedded error estimate, step_interval adapts the time step
+  /// using a TimeStepController with the parameters
+  /// "time_step_control".
+  ///
+  /// If the scheme has solution weights, the solution is updated
+  /// with one fused multi-AXPY of the stage solutions instead of an
+  /// assembly of the last stage form. If the parameter "lumped_mass"
+  /// is set, the stage solutions of a fully explicit scheme are
+  /// divided by the row sums of its mass form (assembled once,
+  /// without a matrix), as needed for forms with cell integrals.
+
+  class RKSolver : public Variable
   {
   public:
 
@@ -43,25 +59,55 @@ namespace dolfin
     /// Step solver with time step dt
     void step(double dt);
 
-    /// Step solver an interval using dt as time step
+    /// Step solver an interval using dt as time step (the initial
+    /// time step if adaptive)
     void step_interval(double t0, double t1, double dt);
 
     /// Return the MultiStageScheme
     std::shared_ptr<MultiStageScheme> scheme() const
     {return _scheme;}
 
+    /// Return number of accepted and rejected steps of the last call
+    /// to step_interval
+    std::pair<std::size_t, std::size_t> num_steps() const
+    { return _num_steps; }
+
+    /// Default parameter values
+    static Parameters default_parameters()
+    {
+      Parameters p("rk_solver");
+      p.add("adaptive", false);
+      p.add("lumped_mass", false);
+      p.add(TimeStepController::default_parameters());
+      return p;
+    }
+
   private:
 
+    // Assemble the inverse of the lumped mass of the scheme
+    void init_inverse_mass();
+
     // The MultiStageScheme
     std::shared_ptr<MultiStageScheme> _scheme;
 
-    // Temp vector for final stage
+    // Temp vector for final stage (if assembled)
     // FIXME: Add this as a Function called previous step or something
     std::shared_ptr<GenericVector> _tmp;
 
+    // Inverse of the lumped mass (if used)
+    std::shared_ptr<GenericVector> _inverse_mass;
+
+    // Weights dt*b_i of the stage solutions in the solution update,
+    // and the stage solution vectors
+    std::vector<double> _update_weights;
+    std::vector<std::shared_ptr<const GenericVector>> _stage_vectors;
+
     // Assembler for explicit stages
     Assembler _assembler;
 
+    // Number of accepted and rejected steps
+    std::pair<std::size_t, std::size_t> _num_steps;
+
   };
 
 }
@@ -0,0 +1,71 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+
+#include "TimeStepController.h"
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+TimeStepController::TimeStepController(unsigned int embedded_order)
+  : Variable("TimeStepController", "unnamed"), _k(embedded_order + 1.0),
+    _previous_error(1.0), _num_accepted_steps(0), _num_rejected_steps(0)
+{
+  // Set parameters
+  parameters = default_parameters();
+}
+//-----------------------------------------------------------------------------
+bool TimeStepController::accept(double error, double& dt)
+{
+  const double safety = parameters["safety"];
+  const double min_factor = parameters["min_factor"];
+  const double max_factor = parameters["max_factor"];
+  const double alpha = parameters["alpha"];
+  const double beta = parameters["beta"];
+
+  // Avoid division by zero for exact steps
+  const double err = std::max(error, 1e-10);
+
+  if (error <= 1.0)
+  {
+    // Accepted: PI control using the error of the previous step
+    const double factor = safety*std::pow(1.0/err, alpha/_k)
+      *std::pow(_previous_error, beta/_k);
+    dt *= std::min(max_factor, std::max(min_factor, factor));
+    _previous_error = err;
+    ++_num_accepted_steps;
+    return true;
+  }
+  else
+  {
+    // Rejected: proportional control only and no growth
+    const double factor = safety*std::pow(1.0/err, 1.0/_k);
+    dt *= std::min(1.0, std::max(min_factor, factor));
+    ++_num_rejected_steps;
+    return false;
+  }
+}
+//-----------------------------------------------------------------------------
+void TimeStepController::reset()
+{
+  _previous_error = 1.0;
+  _num_accepted_steps = 0;
+  _num_rejected_steps = 0;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __TIME_STEP_CONTROLLER_H
+#define __TIME_STEP_CONTROLLER_H
+
+#include <cstddef>
+#include <dolfin/common/Variable.h>
+
+namespace dolfin
+{
+
+  /// This class implements a proportional-integral (PI) controller
+  /// for the time step of adaptive Runge-Kutta methods. The error
+  /// norm passed to the controller is scaled by the tolerances, so a
+  /// step is accepted if the error norm is at most one. The new time
+  /// step is
+  ///
+  ///     dt_new = safety*dt*(1/err)^(alpha/k)*(err_prev)^(beta/k)
+  ///
+  /// where k is one plus the order of the embedded solution, limited
+  /// by the factors min_factor and max_factor. After a rejected step,
+  /// only the proportional part is used and the step is not allowed
+  /// to grow.
+
+  class TimeStepController : public Variable
+  {
+  public:
+
+    /// Create controller for error estimates which are of order
+    /// embedded_order + 1 in the time step
+    explicit TimeStepController(unsigned int embedded_order);
+
+    /// Decide whether a step of size dt with (scaled) error norm
+    /// error is accepted, and update dt to the proposed size of the
+    /// next step
+    bool accept(double error, double& dt);
+
+    /// Reset error history and step counters
+    void reset();
+
+    /// Return number of accepted steps since last reset
+    std::size_t num_accepted_steps() const
+    { return _num_accepted_steps; }
+
+    /// Return number of rejected steps since last reset
+    std::size_t num_rejected_steps() const
+    { return _num_rejected_steps; }
+
+    /// Default parameter values
+    static Parameters default_parameters()
+    {
+      Parameters p("time_step_control");
+      p.add("absolute_tolerance", 1e-6, 0.0, 1.0e10);
+      p.add("relative_tolerance", 1e-6, 0.0, 1.0);
+      p.add("safety", 0.9, 0.1, 1.0);
+      p.add("min_factor", 0.2, 0.0, 1.0);
+      p.add("max_factor", 5.0, 1.0, 1000.0);
+      p.add("alpha", 0.7, 0.0, 2.0);
+      p.add("beta", 0.4, 0.0, 2.0);
+      p.add("minimum_time_step", 1e-12, 0.0, 1.0e10);
+      return p;
+    }
+
+  private:
+
+    // The exponent denominator (order of embedded solution + 1)
+    const double _k;
+
+    // Error norm of the last accepted step
+    double _previous_error;
+
+    // Step statistics
+    std::size_t _num_accepted_steps;
+    std::size_t _num_rejected_steps;
+
+  };
+
+}
+
+#endif
@@ -22,8 +22,11 @@
 // First added:  2005-10-23
 // Last changed: 2014-05-27
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <string>
+#include <Eigen/Dense>
 
 #include <dolfin/common/constants.h>
 #include <dolfin/common/NoDeleter.h>
@@ -34,13 +37,86 @@
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/la/LUSolver.h>
 #include <dolfin/la/KrylovSolver.h>
+#include <dolfin/la/LinearOperator.h>
 #include <dolfin/log/log.h>
+#include <dolfin/log/SolverTelemetry.h>
 #include <dolfin/common/MPI.h>
 #include "NonlinearProblem.h"
 #include "NewtonSolver.h"
 
 using namespace dolfin;
 
+namespace
+{
+  // Jacobian J(x) applied by a forward difference of the residual,
+  // J(x) v = (F(x + h v) - F(x))/h. The residual is evaluated at the
+  // solution vector itself (NonlinearProblem::F usually assembles
+  // forms defined on the Function that owns x), which is restored
+  // after each product.
+  class FiniteDifferenceJacobian : public LinearOperator
+  {
+  public:
+
+    FiniteDifferenceJacobian(NonlinearProblem& nonlinear_problem,
+                             GenericVector& x, const GenericVector& F,
+                             double epsilon)
+      : LinearOperator(x, F), _nonlinear_problem(nonlinear_problem),
+      _x(x), _F(F), _epsilon(epsilon), _x0(x.copy()),
+      _A(x.factory().create_matrix(x.mpi_comm())),
+      _P(x.factory().create_matrix(x.mpi_comm()))
+    {
+      // Do nothing
+    }
+
+    std::size_t size(std::size_t dim) const
+    { return _x.size(); }
+
+    void mult(const GenericVector& v, GenericVector& y) const
+    {
+      const double v_norm = v.norm("l2");
+      if (v_norm == 0.0)
+      {
+        y.zero();
+        return;
+      }
+
+      // Perturbation size relative to the size of x
+      *_x0 = _x;
+      const double h = _epsilon*(1.0 + _x.norm("l2"))/v_norm;
+
+      // Evaluate F(x + h v) and restore x
+      _x.axpy(h, v);
+      _nonlinear_problem.form(*_A, *_P, y, _x);
+      _nonlinear_problem.F(y, _x);
+      _x = *_x0;
+
+      y.axpy(-1.0, _F);
+      y *= 1.0/h;
+    }
+
+  private:
+
+    NonlinearProblem& _nonlinear_problem;
+    GenericVector& _x;
+    const GenericVector& _F;
+    const double _epsilon;
+
+    // Copy of unperturbed x and (unused) matrices passed to
+    // NonlinearProblem::form
+    std::shared_ptr<GenericVector> _x0;
+    std::shared_ptr<GenericMatrix> _A, _P;
+  };
+
+  // Return time (seconds) since t0 and reset t0 to now
+  double lap(std::chrono::steady_clock::time_point& t0)
+  {
+    const auto t = std::chrono::steady_clock::now();
+    const std::chrono::duration<double> dt = t - t0;
+    t0 = t;
+    return dt.count();
+  }
+}
+
 //-----------------------------------------------------------------------------
 Parameters NewtonSolver::default_parameters()
 {
@@ -56,7 +132,39 @@ Parameters NewtonSolver::default_parameters()
   p.add("error_on_nonconvergence", true);
   p.add<double>("relaxation_parameter");
 
-  //p.add("reuse_preconditioner", false);
+  // Reuse of the preconditioner/factorization across Newton
+  // iterations is set by "reuse_policy" of the linear solver
+  // parameters. Setting "preconditioner_lag" to k > 1 is a short-hand
+  // for the "steps" policy with k solves per preconditioner.
+  p.add("preconditioner_lag", 1, 1, 1000000);
+
+  // Assemble the Jacobian only every "jacobian_lag" iterations
+  p.add("jacobian_lag", 1, 1, 1000000);
+
+  // Inexact Newton: tolerance of the Krylov solver chosen by the
+  // Eisenstat-Walker forcing terms (choice 1, or choice 2 with
+  // parameters gamma and alpha), starting from "forcing_term_initial"
+  // and bounded by "forcing_term_maximum"
+  p.add("krylov_forcing_term", "none", {"none", "eisenstat_walker_1",
+                                        "eisenstat_walker_2"});
+  p.add("forcing_term_initial", 0.3, 0.0, 1.0);
+  p.add("forcing_term_maximum", 0.9, 0.0, 1.0);
+  p.add("forcing_term_gamma", 0.9, 0.0, 1.0);
+  p.add("forcing_term_alpha", 0.5*(1.0 + std::sqrt(5.0)), 1.0, 2.0);
+
+  // Jacobian-free Newton-Krylov: apply the Jacobian by finite
+  // differences of F with relative step "matrix_free_epsilon". J is
+  // then only assembled when no J_pc is given, and only to
+  // precondition the Krylov solver.
+  p.add("jacobian", "assembled", {"assembled", "matrix_free"});
+  p.add("matrix_free_epsilon", DOLFIN_SQRT_EPS);
+
+  // Anderson acceleration of the iteration x -> x - dx (a Newton or,
+  // with an approximate Jacobian, a Picard iteration): the next
+  // iterate is the least-squares mixing of the last "anderson_depth"
+  // iterates and updates, damped by "anderson_damping"
+  p.add("anderson_depth", 0, 0, 1000);
+  p.add("anderson_damping", 1.0, 0.0, 1.0);
 
   p.add(LUSolver::default_parameters());
   p.add(KrylovSolver::default_parameters());
@@ -68,7 +176,8 @@ NewtonSolver::NewtonSolver(MPI_Comm comm,
                            std::shared_ptr<GenericLinearSolver> solver,
                            GenericLinearAlgebraFactory& factory)
   : Variable("Newton solver", "unnamed"), _newton_iteration(0),
-    _krylov_iterations(0), _relaxation_parameter(1.0), _residual(0.0),
+    _krylov_iterations(0), _jacobian_assemblies(0),
+    _relaxation_parameter(1.0), _residual(0.0),
     _residual0(0.0), _solver(solver), _matA(factory.create_matrix(comm)),
     _matP(factory.create_matrix(comm)), _dx(factory.create_vector(comm)),
     _b(factory.create_vector(comm)), _mpi_comm(comm)
@@ -119,20 +228,83 @@ NewtonSolver::solve(NonlinearProblem& nonlinear_problem,
   dolfin_assert(_solver);
 
   // Set parameters for linear solver
-  _solver->update_parameters(parameters(_solver->parameter_type()));
+  Parameters solver_parameters(parameters(_solver->parameter_type()));
+  const int preconditioner_lag = parameters["preconditioner_lag"];
+  if (preconditioner_lag > 1)
+  {
+    if (solver_parameters.has_parameter("reuse_policy"))
+    {
+      solver_parameters["reuse_policy"] = "steps";
+      solver_parameters["reuse_steps"] = preconditioner_lag;
+    }
+    else
+      warning("Linear solver does not support preconditioner reuse, ignoring \"preconditioner_lag\"");
+  }
+  _solver->update_parameters(solver_parameters);
+
+  // Inexact Newton (only for Krylov solvers)
+  const std::size_t jacobian_lag = (int) parameters["jacobian_lag"];
+  const std::string forcing_term = parameters["krylov_forcing_term"];
+  const bool inexact = forcing_term != "none"
+    and _solver->parameter_type() == "krylov_solver";
+  if (forcing_term != "none" and !inexact)
+    warning("Krylov forcing terms require a Krylov solver, ignoring \"krylov_forcing_term\"");
+  double eta = parameters["forcing_term_initial"];
+  double residual_norm = 0.0;
+  double linear_residual_norm = 0.0;
 
   // Reset iteration counts
   _newton_iteration = 0;
   _krylov_iterations = 0;
+  _jacobian_assemblies = 0;
+
+  // Reset Anderson history
+  const std::size_t anderson_depth = (int) parameters["anderson_depth"];
+  const double anderson_damping = parameters["anderson_damping"];
+  _anderson_dx.clear();
+  _anderson_df.clear();
+  _anderson_x_previous.reset();
+  _anderson_f_previous.reset();
+
+  // Telemetry record of this solve: assembly (setup) and linear
+  // solve times, and the norm tested for convergence at each
+  // iteration
+  SolverRecord record;
+  record.solver = "newton";
+  record.name = name();
+  auto t0 = std::chrono::steady_clock::now();
 
   // Compute F(u)
   nonlinear_problem.form(*_matA, *_matP, *_b, x);
   nonlinear_problem.F(*_b, x);
+  record.setup_time += lap(t0);
+  if (inexact)
+    residual_norm = _b->norm("l2");
+
+  // Matrix-free Jacobian (only for Krylov solvers)
+  const bool matrix_free
+    = std::string(parameters["jacobian"]) == "matrix_free";
+  std::shared_ptr<const GenericLinearOperator> jacobian = _matA;
+  if (matrix_free)
+  {
+    if (_solver->parameter_type() != "krylov_solver")
+    {
+      dolfin_error("NewtonSolver.cpp",
+                   "solve nonlinear system with NewtonSolver",
+                   "A matrix-free Jacobian requires a Krylov solver");
+    }
+
+    jacobian = std::make_shared<FiniteDifferenceJacobian>(
+      nonlinear_problem, x, *_b, parameters["matrix_free_epsilon"]);
+  }
 
   // Check convergence
   bool newton_converged = false;
   if (convergence_criterion == "residual")
+  {
     newton_converged = converged(*_b, nonlinear_problem, 0);
+    record.residuals.push_back(_residual);
+  }
   else if (convergence_criterion == "incremental")
   {
     // We need to do at least one Newton step with the ||dx||-stopping
@@ -150,22 +322,71 @@ NewtonSolver::solve(NonlinearProblem& nonlinear_problem,
   // Start iterations
   while (!newton_converged && _newton_iteration < maxiter)
   {
-    // Compute Jacobian
-    nonlinear_problem.J(*_matA, x);
-    nonlinear_problem.J_pc(*_matP, x);
+    // Compute Jacobian (unless lagged). In matrix-free mode, only the
+    // preconditioner matrix is assembled, using J if no J_pc is given.
+    lap(t0);
+    if (_newton_iteration % jacobian_lag == 0)
+    {
+      if (!matrix_free)
+      {
+        nonlinear_problem.J(*_matA, x);
+        nonlinear_problem.J_pc(*_matP, x);
+      }
+      else
+      {
+        nonlinear_problem.J_pc(*_matP, x);
+        if (_matP->empty())
+          nonlinear_problem.J(*_matA, x);
+      }
+      ++_jacobian_assemblies;
+    }
+    record.setup_time += lap(t0);
 
     // Setup (linear) solver (including set operators)
-    solver_setup(_matA, _matP, nonlinear_problem, _newton_iteration);
+    if (!matrix_free)
+      solver_setup(_matA, _matP, nonlinear_problem, _newton_iteration);
+    else if (_matP->empty())
+      _solver->set_operators(jacobian, _matA);
+    else
+      _solver->set_operators(jacobian, _matP);
+
+    // Set Krylov tolerance to forcing term
+    if (inexact)
+    {
+      solver_parameters["relative_tolerance"] = eta;
+      _solver->update_parameters(solver_parameters);
+    }
 
     // Perform linear solve and update total number of Krylov
     // iterations
     if (!_dx->empty())
       _dx->zero();
     _krylov_iterations += _solver->solve(*_dx, *_b);
+    record.solve_time += lap(t0);
+
+    // Norm of linear residual b - A dx (for Eisenstat-Walker choice
+    // 1)
+    if (inexact and forcing_term == "eisenstat_walker_1")
+    {
+      if (!_linear_residual)
+        _linear_residual = _b->copy();
+      jacobian->mult(*_dx, *_linear_residual);
+      _linear_residual->axpy(-1.0, *_b);
+      linear_residual_norm = _linear_residual->norm("l2");
+    }
 
     // Update solution
+    if (anderson_depth > 0)
+    {
+      if (!_anderson_x)
+        _anderson_x = x.copy();
+      else
+        *_anderson_x = x;
+    }
     update_solution(x, *_dx, _relaxation_parameter,
                     nonlinear_problem, _newton_iteration);
+    if (anderson_depth > 0)
+      anderson_update(x, anderson_depth, anderson_damping);
 
     // Increment iteration count
     _newton_iteration++;
@@ -174,8 +395,19 @@ NewtonSolver::solve(NonlinearProblem& nonlinear_problem,
     //        this has converged.
     // FIXME: But, this function call may update internal variable, etc.
     // Compute F
+    lap(t0);
     nonlinear_problem.form(*_matA, *_matP, *_b, x);
     nonlinear_problem.F(*_b, x);
+    record.setup_time += lap(t0);
+
+    // Update forcing term
+    if (inexact)
+    {
+      const double previous_residual_norm = residual_norm;
+      residual_norm = _b->norm("l2");
+      eta = forcing_term_update(eta, residual_norm, previous_residual_norm,
+                                linear_residual_norm, forcing_term);
+    }
 
     // Test for convergence
     if (convergence_criterion == "residual")
@@ -194,6 +426,23 @@ NewtonSolver::solve(NonlinearProblem& nonlinear_problem,
                    "The convergence criterion %s is unknown, known criteria are 'residual' or 'incremental'",
                    convergence_criterion.c_str());
     }
+    record.residuals.push_back(_residual);
+  }
+
+  // Record telemetry (before raising an error on non-convergence)
+  if (SolverTelemetry::enabled())
+  {
+    record.iterations = _newton_iteration;
+    record.linear_iterations = _krylov_iterations;
+    record.converged = newton_converged;
+    if (newton_converged)
+      record.reason = "converged";
+    else if (_newton_iteration == maxiter)
+      record.reason = "maximum_iterations";
+    else
+      record.reason = "diverged";
+    record.time = SolverTelemetry::time();
+    SolverTelemetry::record(record);
   }
 
   if (newton_converged)
@@ -239,6 +488,11 @@ std::size_t NewtonSolver::krylov_iterations() const
   return _krylov_iterations;
 }
 //-----------------------------------------------------------------------------
+std::size_t NewtonSolver::jacobian_assemblies() const
+{
+  return _jacobian_assemblies;
+}
+//-----------------------------------------------------------------------------
 double NewtonSolver::residual() const
 {
   return _residual;
@@ -327,3 +581,121 @@ void NewtonSolver::update_solution(GenericVector& x, const GenericVector& dx,
     x.axpy(-relaxation_parameter, dx);
 }
 //-----------------------------------------------------------------------------
+void NewtonSolver::anderson_update(GenericVector& x, std::size_t depth,
+                                   double damping)
+{
+  dolfin_assert(_anderson_x);
+
+  // Residual f = g(x) - x of the fixed-point map g, where x holds
+  // g(x) and _anderson_x the iterate x
+  if (!_anderson_f)
+    _anderson_f = x.copy();
+  else
+    *_anderson_f = x;
+  *_anderson_f -= *_anderson_x;
+
+  // Add differences to previous iterate and residual to history,
+  // reusing the oldest vectors if the history is full
+  if (_anderson_x_previous)
+  {
+    std::shared_ptr<GenericVector> dx, df;
+    if (_anderson_dx.size() == depth)
+    {
+      dx = _anderson_dx.front();
+      df = _anderson_df.front();
+      _anderson_dx.pop_front();
+      _anderson_df.pop_front();
+    }
+    else
+    {
+      dx = x.copy();
+      df = x.copy();
+    }
+    *dx = *_anderson_x;
+    *dx -= *_anderson_x_previous;
+    *df = *_anderson_f;
+    *df -= *_anderson_f_previous;
+    _anderson_dx.push_back(dx);
+    _anderson_df.push_back(df);
+
+    *_anderson_x_previous = *_anderson_x;
+    *_anderson_f_previous = *_anderson_f;
+  }
+  else
+  {
+    _anderson_x_previous = _anderson_x->copy();
+    _anderson_f_previous = _anderson_f->copy();
+  }
+
+  // Damped fixed-point step x + beta f
+  x = *_anderson_x;
+  x.axpy(damping, *_anderson_f);
+  const std::size_t m = _anderson_df.size();
+  if (m == 0)
+    return;
+
+  // Solve least-squares problem min |f - dF gamma| by its normal
+  // equations (one global reduction per history vector)
+  const std::vector<std::shared_ptr<const GenericVector>>
+    df(_anderson_df.begin(), _anderson_df.end());
+  Eigen::MatrixXd A(m, m);
+  Eigen::VectorXd b(m);
+  const std::vector<double> f_dot_df = _anderson_f->mdot(df);
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    b(i) = f_dot_df[i];
+    const std::vector<std::shared_ptr<const GenericVector>>
+      df_j(df.begin(), df.begin() + i + 1);
+    const std::vector<double> df_dot_df = df[i]->mdot(df_j);
+    for (std::size_t j = 0; j <= i; ++j)
+      A(i, j) = A(j, i) = df_dot_df[j];
+  }
+  const Eigen::VectorXd gamma = A.colPivHouseholderQr().solve(b);
+
+  // Mix history, x = x + beta f - (dX + beta dF) gamma, in a single
+  // pass
+  std::vector<double> weights(2*m);
+  std::vector<std::shared_ptr<const GenericVector>> vectors(2*m);
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    weights[i] = -gamma(i);
+    vectors[i] = _anderson_dx[i];
+    weights[m + i] = -damping*gamma(i);
+    vectors[m + i] = _anderson_df[i];
+  }
+  x.maxpy(weights, vectors);
+}
+//-----------------------------------------------------------------------------
+double NewtonSolver::forcing_term_update(double eta, double residual_norm,
+                                         double previous_residual_norm,
+                                         double linear_residual_norm,
+                                         std::string forcing_term) const
+{
+  const double eta_max = parameters["forcing_term_maximum"];
+  if (previous_residual_norm == 0.0)
+    return eta_max;
+
+  // Eisenstat and Walker (1996), choices 1 and 2, with safeguards
+  // against decreasing the forcing term too quickly
+  double eta_new, eta_safe;
+  if (forcing_term == "eisenstat_walker_1")
+  {
+    const double alpha = 0.5*(1.0 + std::sqrt(5.0));
+    eta_new = std::abs(residual_norm - linear_residual_norm)
+      /previous_residual_norm;
+    eta_safe = std::pow(eta, alpha);
+  }
+  else
+  {
+    const double gamma = parameters["forcing_term_gamma"];
+    const double alpha = parameters["forcing_term_alpha"];
+    eta_new = gamma*std::pow(residual_norm/previous_residual_norm, alpha);
+    eta_safe = gamma*std::pow(eta, alpha);
+  }
+
+  if (eta_safe > 0.1)
+    eta_new = std::max(eta_new, eta_safe);
+
+  return std::min(eta_new, eta_max);
+}
+//-----------------------------------------------------------------------------
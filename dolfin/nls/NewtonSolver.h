@@ -24,6 +24,7 @@
 #ifndef __NEWTON_SOLVER_H
 #define __NEWTON_SOLVER_H
 
+#include <deque>
 #include <utility>
 #include <memory>
 #include <dolfin/common/MPI.h>
@@ -95,6 +96,14 @@ namespace dolfin
     ///         The number of iterations.
     std::size_t krylov_iterations() const;
 
+    /// Return number of Jacobian assemblies since solve started
+    /// (fewer than the number of iterations if "jacobian_lag" > 1)
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The number of assemblies.
+    std::size_t jacobian_assemblies() const;
+
     /// Return current residual
     ///
     /// *Returns*
@@ -212,12 +221,28 @@ namespace dolfin
 
   private:
 
+    // Compute the next Eisenstat-Walker forcing term from the current
+    // and previous residual norms and the norm of the linear residual
+    // of the last step
+    double forcing_term_update(double eta, double residual_norm,
+                               double previous_residual_norm,
+                               double linear_residual_norm,
+                               std::string forcing_term) const;
+
+    // Replace x, which holds the updated iterate of _anderson_x, by
+    // the Anderson mixing of the last depth iterates
+    void anderson_update(GenericVector& x, std::size_t depth,
+                         double damping);
+
     // Current number of Newton iterations
     std::size_t _newton_iteration;
 
     // Accumulated number of Krylov iterations since solve began
     std::size_t _krylov_iterations;
 
+    // Number of Jacobian assemblies since solve began
+    std::size_t _jacobian_assemblies;
+
     // Relaxation parameter
     double _relaxation_parameter;
 
@@ -239,6 +264,15 @@ namespace dolfin
     // Residual vector
     std::shared_ptr<GenericVector> _b;
 
+    // Linear residual vector (for inexact Newton)
+    std::shared_ptr<GenericVector> _linear_residual;
+
+    // Anderson acceleration: current and previous iterate and
+    // fixed-point residual, and history of their differences
+    std::shared_ptr<GenericVector> _anderson_x, _anderson_f;
+    std::shared_ptr<GenericVector> _anderson_x_previous, _anderson_f_previous;
+    std::deque<std::shared_ptr<GenericVector>> _anderson_dx, _anderson_df;
+
     // MPI communicator
     dolfin::MPI::Comm _mpi_comm;
 
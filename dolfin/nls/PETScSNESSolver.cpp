@@ -24,6 +24,7 @@
 #ifdef HAS_PETSC
 
 #include <map>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <cmath>
@@ -63,6 +64,8 @@ PETScSNESSolver::_methods
                       SNESFAS}},
     {"nasm",         {"Nonlinear Additive Schwartz", SNESNASM}},
     {"anderson",     {"Anderson mixing method", SNESANDERSON}},
+    {"composite",    {"Composition of the methods in \"composite_methods\"",
+                      SNESCOMPOSITE}},
     {"aspin",        {"Additive-Schwarz Preconditioned Inexact Newton",
                       SNESASPIN}},
     {"ms",           {"Multistage smoothers", SNESMS}} };
@@ -84,7 +87,23 @@ Parameters PETScSNESSolver::default_parameters()
   p.add("maximum_residual_evaluations", 2000);
   p.remove("convergence_criterion");
   p.remove("relaxation_parameter");
+  p.remove("anderson_depth");
+  p.remove("anderson_damping");
   p.add("method", "default");
+
+  // Nonlinear preconditioner (a method applied for a fixed number
+  // of iterations before each iteration of the solver, or to the
+  // residual on the left side), e.g. "newtonls" for the methods
+  // "ngmres", "anderson", "qn" or "ncg"
+  p.add("nonlinear_preconditioner", "none");
+  p.add("nonlinear_preconditioner_side", "right", {"right", "left"});
+  p.add("nonlinear_preconditioner_iterations", 1, 1, 1000000);
+
+  // Comma-separated methods of the "composite" method, and how the
+  // methods are combined
+  p.add("composite_methods", "");
+  p.add("composite_type", "multiplicative",
+        {"multiplicative", "additive", "additiveoptimal"});
   p.add("line_search", "basic",  {"basic", "bt", "l2", "cp", "nleqerr"});
   p.add("sign", "default", {"default", "nonnegative", "nonpositive"});
 
@@ -191,6 +210,44 @@ void PETScSNESSolver::init(NonlinearProblem& nonlinear_problem,
   ierr = SNESSetJacobian(_snes, nullptr, nullptr,
                          PETScSNESSolver::FormJacobian, &_snes_ctx);
   if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetJacobian");
+
+  // Jacobian-free Newton-Krylov: apply the Jacobian by finite
+  // differences (MatMFFD) and use the assembled matrix only as
+  // preconditioner
+  Mat A;
+  ierr = SNESGetJacobian(_snes, &A, nullptr, nullptr, nullptr);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "SNESGetJacobian");
+  PetscBool is_mffd = PETSC_FALSE;
+  if (A)
+  {
+    ierr = PetscObjectTypeCompare((PetscObject)A, MATMFFD, &is_mffd);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectTypeCompare");
+  }
+  if (std::string(parameters["jacobian"]) == "matrix_free")
+  {
+    if (!is_mffd)
+    {
+      ierr = MatCreateSNESMF(_snes, &A);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "MatCreateSNESMF");
+      ierr = SNESSetJacobian(_snes, A, _matP.mat(),
+                             PETScSNESSolver::FormJacobian, &_snes_ctx);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetJacobian");
+      ierr = MatDestroy(&A);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "MatDestroy");
+    }
+    ierr = SNESGetJacobian(_snes, &A, nullptr, nullptr, nullptr);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "SNESGetJacobian");
+    ierr = MatMFFDSetFunctionError(A, parameters["matrix_free_epsilon"]);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatMFFDSetFunctionError");
+  }
+  else if (is_mffd)
+  {
+    // Switch back from a previous matrix-free solve
+    ierr = SNESSetJacobian(_snes, _matJ.mat(), _matP.mat(),
+                           PETScSNESSolver::FormJacobian, &_snes_ctx);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetJacobian");
+  }
+
   SNESSetObjective(_snes, PETScSNESSolver::FormObjective, &_snes_ctx);
   if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetObjective");
 
@@ -245,6 +302,13 @@ void PETScSNESSolver::init(NonlinearProblem& nonlinear_problem,
     if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetType");
   }
 
+  // Set the composed methods and nonlinear preconditioner, if any
+  if (method == "composite")
+    set_composite();
+  const std::string npc_method = parameters["nonlinear_preconditioner"];
+  if (npc_method != "none")
+    set_nonlinear_preconditioner(npc_method);
+
   SNESLineSearch linesearch;
   ierr = SNESGetLineSearch(_snes, &linesearch);
   if (ierr != 0) petsc_error(ierr, __FILE__, "SNESGetLineSearch");
@@ -270,7 +334,18 @@ void PETScSNESSolver::init(NonlinearProblem& nonlinear_problem,
 
   // Following set from options call requires Mat type to be set (at least
   // when PETSC_USE_DEBUG) and we don't have any better way
-  if (_matJ.empty())
+  if (std::string(parameters["jacobian"]) == "matrix_free")
+  {
+    if (_matP.empty())
+    {
+      ierr = SNESGetJacobian(_snes, &A, nullptr, nullptr, nullptr);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "SNESGetJacobian");
+      ierr = FormJacobian(_snes, _snes_ctx.x->vec(),
+                          A, _matP.mat(), &_snes_ctx);
+      if (ierr != 0) petsc_error(ierr, __FILE__, "PETScSNESSolver::FormJacobian");
+    }
+  }
+  else if (_matJ.empty())
   {
     ierr = FormJacobian(_snes, _snes_ctx.x->vec(),
                         _matJ.mat(), _matP.mat(), &_snes_ctx);
@@ -282,6 +357,81 @@ void PETScSNESSolver::init(NonlinearProblem& nonlinear_problem,
   if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetFromOptions");
 }
 //-----------------------------------------------------------------------------
+void PETScSNESSolver::set_composite()
+{
+  PetscErrorCode ierr;
+
+  const std::string type = parameters["composite_type"];
+  SNESCompositeType composite_type = SNES_COMPOSITE_MULTIPLICATIVE;
+  if (type == "additive")
+    composite_type = SNES_COMPOSITE_ADDITIVE;
+  else if (type == "additiveoptimal")
+    composite_type = SNES_COMPOSITE_ADDITIVEOPTIMAL;
+  ierr = SNESCompositeSetType(_snes, composite_type);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "SNESCompositeSetType");
+
+  // Add methods (only once, SNESCOMPOSITE keeps its sub-solvers)
+  PetscInt num_methods = 0;
+  ierr = SNESCompositeGetNumber(_snes, &num_methods);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "SNESCompositeGetNumber");
+  if (num_methods > 0)
+    return;
+
+  std::istringstream methods(std::string(parameters["composite_methods"]));
+  std::string method;
+  while (std::getline(methods, method, ','))
+  {
+    auto it = _methods.find(method);
+    if (it == _methods.end() or method == "default" or method == "composite")
+    {
+      dolfin_error("PETScSNESSolver.cpp",
+                   "set up composite SNES solver",
+                   "Unknown or unsupported SNES method \"%s\" in \"composite_methods\"",
+                   method.c_str());
+    }
+    ierr = SNESCompositeAddSNES(_snes, it->second.second);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "SNESCompositeAddSNES");
+    ++num_methods;
+  }
+
+  if (num_methods == 0)
+  {
+    dolfin_error("PETScSNESSolver.cpp",
+                 "set up composite SNES solver",
+                 "Parameter \"composite_methods\" must list at least one method");
+  }
+}
+//-----------------------------------------------------------------------------
+void PETScSNESSolver::set_nonlinear_preconditioner(std::string method)
+{
+  auto it = _methods.find(method);
+  if (it == _methods.end() or method == "default")
+  {
+    dolfin_error("PETScSNESSolver.cpp",
+                 "set nonlinear preconditioner of SNES solver",
+                 "Unknown SNES method \"%s\"", method.c_str());
+  }
+
+  PetscErrorCode ierr;
+
+  // The preconditioner takes the function and Jacobian of the solver
+  // when the solver is set up
+  SNES npc;
+  ierr = SNESGetNPC(_snes, &npc);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "SNESGetNPC");
+  ierr = SNESSetType(npc, it->second.second);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetType");
+
+  // Fixed number of iterations
+  const int iterations = parameters["nonlinear_preconditioner_iterations"];
+  ierr = SNESSetTolerances(npc, 0.0, 0.0, 0.0, iterations, PETSC_DEFAULT);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetTolerances");
+
+  const std::string side = parameters["nonlinear_preconditioner_side"];
+  ierr = SNESSetNPCSide(_snes, side == "left" ? PC_LEFT : PC_RIGHT);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetNPCSide");
+}
+//-----------------------------------------------------------------------------
 void PETScSNESSolver::set_options_prefix(std::string options_prefix)
 {
   // Set options prefix
@@ -427,6 +577,41 @@ PetscErrorCode PETScSNESSolver::FormJacobian(SNES snes, Vec x, Mat A, Mat P,
   auto snes_ctx = static_cast<struct snes_ctx_t*>(ctx);
   NonlinearProblem* nonlinear_problem = snes_ctx->nonlinear_problem;
 
+  // Matrix-free Jacobian: update its base point and assemble only the
+  // preconditioner, from J_pc if given and from J otherwise
+  PetscBool is_mffd = PETSC_FALSE;
+  PetscErrorCode ierr = PetscObjectTypeCompare((PetscObject)A, MATMFFD,
+                                               &is_mffd);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectTypeCompare");
+  if (is_mffd)
+  {
+    ierr = MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatAssemblyBegin");
+    ierr = MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatAssemblyEnd");
+
+    PETScMatrix A_tmp(PetscObjectComm((PetscObject)P));
+    PETScMatrix P_wrap(P);
+    PETScVector x_wrap(x);
+    PETScVector f(x_wrap.mpi_comm());
+    nonlinear_problem->form(A_tmp, P_wrap, f, x_wrap);
+
+    // J_pc is taken as not supplied if it leaves P unchanged
+    PetscObjectState state0, state1;
+    ierr = PetscObjectStateGet((PetscObject)P, &state0);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectStateGet");
+    nonlinear_problem->J_pc(P_wrap, x_wrap);
+    ierr = PetscObjectStateGet((PetscObject)P, &state1);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectStateGet");
+    if (state0 == state1)
+    {
+      log(TRACE, "SNES FormJacobian: using assembled Jacobian as preconditioner matrix");
+      nonlinear_problem->J(P_wrap, x_wrap);
+    }
+
+    return 0;
+  }
+
   // Wrap the PETSc objects
   PETScMatrix A_wrap(A);
   PETScMatrix P_wrap(P);
@@ -443,7 +628,7 @@ PetscErrorCode PETScSNESSolver::FormJacobian(SNES snes, Vec x, Mat A, Mat P,
   if (P_wrap.empty())
   {
     log(TRACE, "SNES FormJacobian: using Jacobian as preconditioner matrix");
-    PetscErrorCode ierr = SNESSetJacobian(snes, nullptr, A, nullptr, nullptr);
+    ierr = SNESSetJacobian(snes, nullptr, A, nullptr, nullptr);
     if (ierr != 0) petsc_error(ierr, __FILE__, "SNESSetJacobian");
   }
 
@@ -174,6 +174,12 @@ namespace dolfin
     // Check if the problem is a variational inequality
     bool is_vi() const;
 
+    // Add the methods of the "composite" method from the parameters
+    void set_composite();
+
+    // Set the nonlinear preconditioner from the parameters
+    void set_nonlinear_preconditioner(std::string method);
+
     // Jacobian matrix
     PETScMatrix _matJ;
 
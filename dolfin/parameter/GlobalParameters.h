@@ -58,6 +58,12 @@ namespace dolfin
       // Allow extrapolation in function interpolation
       p.add("allow_extrapolation", false);
 
+      // Number of threads for shared-memory parallel assembly, mesh
+      // topology computation, Eigen linear algebra and the
+      // PointIntegralSolver vertex loop (zero means serial). See
+      // SubSystemsManager::num_threads.
+      p.add("num_threads", 0);
+
       //-- Input
 
       // Warn if reading large XML files in parallel (MB)
@@ -74,18 +80,33 @@ namespace dolfin
       // Print the level of thread support provided by the MPI library
       p.add("print_mpi_thread_support_level", false);
 
+      // Level of thread support requested when DOLFIN initialises MPI
+      std::set<std::string> allowed_thread_levels = {"single", "funneled",
+                                                     "serialized",
+                                                     "multiple"};
+      p.add("mpi_thread_level", "multiple", allowed_thread_levels);
+
       //-- dof ordering
 
       // DOF reordering when running in serial
       p.add("reorder_dofs_serial", true);
 
-      // Add dof ordering library
+      // Add dof ordering library ("Boost": reverse Cuthill-McKee,
+      // "SCOTCH": Gibbs-Poole-Stockmeyer, "SFC": Morton order of
+      // node positions, "cell": order of first appearance in the
+      // cells, "random": for testing)
       std::string default_dof_ordering_library = "Boost";
       #ifdef HAS_SCOTCH
       default_dof_ordering_library = "SCOTCH";
       #endif
       p.add("dof_ordering_library", default_dof_ordering_library,
-            {"Boost", "random", "SCOTCH"});
+            {"Boost", "random", "SCOTCH", "SFC", "cell"});
+
+      // Layout of the components of vector-valued spaces within a
+      // process ("interleaved": the components of a node are
+      // contiguous, "blocked": the dofs of each component are
+      // contiguous, with block size 1)
+      p.add("dof_block_layout", "interleaved", {"interleaved", "blocked"});
 
       //-- Meshes
 
@@ -93,6 +114,10 @@ namespace dolfin
       p.add("ghost_mode", "none",
             {"shared_facet", "shared_vertex", "none"});
 
+      // Number of layers of ghost cells (ignored if ghost_mode is
+      // "none")
+      p.add("ghost_layers", 1, 1, 100);
+
       // Mesh ordering via SCOTCH and GPS
       p.add("reorder_cells_gps", false);
       p.add("reorder_vertices_gps", false);
@@ -105,7 +130,7 @@ namespace dolfin
         #endif
       #endif
       p.add("mesh_partitioner", default_mesh_partitioner,
-            {"ParMETIS", "SCOTCH", "None"});
+            {"ParMETIS", "SCOTCH", "RCB", "SFC", "None"});
 
       // Approaches to partitioning (following Zoltan syntax)
       // but applies to ParMETIS
@@ -122,11 +147,17 @@ namespace dolfin
       p.add("refinement_algorithm", "plaza",
             {"regular_cut", "plaza", "plaza_with_parent_facets"});
 
+      // Bounding box tree layout used for point queries: binary, or
+      // flattened 4- or 8-wide tree with child boxes in SoA layout
+      p.add("bounding_box_tree_layout", "binary",
+            {"binary", "wide4", "wide8"});
+
       //-- Graphs
 
       // Graph coloring
       std::set<std::string> allowed_coloring_libraries;
       allowed_coloring_libraries.insert("Boost");
+      allowed_coloring_libraries.insert("JonesPlassmann");
       #ifdef HAS_TRILINOS
       allowed_coloring_libraries.insert("Zoltan");
       #endif
@@ -141,6 +172,25 @@ namespace dolfin
       allowed_backends.insert("PETSc");
       default_backend = "PETSc";
       p.add("use_petsc_signal_handler", false);
+
+      // Assume that the off-process entries of the first assembly of
+      // a PETSc matrix or vector are a superset of those of later
+      // assemblies, so that PETSc can reuse the communication pattern
+      // of the first assembly in apply()
+      p.add("reuse_off_process_pattern", false);
+
+      // Communication for ghost updates of PETSc vectors: "messages"
+      // (MPI point-to-point messages to all neighbours) or
+      // "shared_memory" (direct copies through MPI-3 shared memory
+      // for neighbours on the same node, requires PETSc 3.9-3.11)
+      std::set<std::string> allowed_ghost_updates = {"messages",
+                                                     "shared_memory"};
+      p.add("ghost_update_type", "messages", allowed_ghost_updates);
+
+      // Create PETSc matrices and (unghosted) vectors on a device
+      // (types MATAIJCUSPARSE/VECCUDA or MATAIJVIENNACL/VECVIENNACL)
+      std::set<std::string> allowed_devices = {"host", "cuda", "viennacl"};
+      p.add("petsc_device", "host", allowed_devices);
       #endif
       #ifdef HAS_TRILINOS
       allowed_backends.insert("Tpetra");
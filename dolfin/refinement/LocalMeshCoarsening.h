@@ -31,7 +31,9 @@ namespace dolfin
   class MeshEditor;
   template <typename T> class MeshFunction;
 
-  /// This class implements local mesh coarsening for different mesh types.
+  /// This class implements local mesh coarsening for different mesh
+  /// types. It only works in serial; for coarsening of distributed
+  /// meshes, see MeshHierarchy::coarsen.
 
   class LocalMeshCoarsening
   {
@@ -18,7 +18,9 @@
 //
 // First Added: 2013-01-02
 
+#include <algorithm>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <vector>
 #include <boost/multi_array.hpp>
@@ -40,6 +42,8 @@
 
 using namespace dolfin;
 
+std::size_t ParallelRefinement::_communication_volume = 0;
+
 //-----------------------------------------------------------------------------
 ParallelRefinement::ParallelRefinement(const Mesh& mesh) : _mesh(mesh),
   shared_edges(DistributedMeshTools::compute_shared_entities(_mesh, 1)),
@@ -47,7 +51,29 @@ ParallelRefinement::ParallelRefinement(const Mesh& mesh) : _mesh(mesh),
   marked_edges(mesh.num_edges(), false),
   marked_for_update(MPI::size(mesh.mpi_comm()))
 {
-  // Do nothing
+  // Collect neighbouring processes from shared edges. Edge sharing is
+  // symmetric, so the neighbours are both sources and destinations.
+  std::set<int> neighbours;
+  for (auto const &edge : shared_edges)
+    for (auto const &proc_edge : edge.second)
+      neighbours.insert(proc_edge.first);
+  _neighbours.assign(neighbours.begin(), neighbours.end());
+
+  #ifdef HAS_MPI
+  // Create communicator with distributed graph topology (keeping the
+  // ranks of the parent communicator)
+  MPI_Comm graph_comm;
+  MPI_Dist_graph_create_adjacent(_mesh.mpi_comm(),
+                                 _neighbours.size(), _neighbours.data(),
+                                 MPI_UNWEIGHTED,
+                                 _neighbours.size(), _neighbours.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, 0,
+                                 &graph_comm);
+  _neighbourhood_comm.reset(new MPI::Comm(graph_comm));
+  MPI_Comm_free(&graph_comm);
+  #else
+  _neighbourhood_comm.reset(new MPI::Comm(_mesh.mpi_comm()));
+  #endif
 }
 //-----------------------------------------------------------------------------
 ParallelRefinement::~ParallelRefinement()
@@ -127,13 +153,22 @@ ParallelRefinement::marked_edge_list(const MeshEntity& cell) const
   return result;
 }
 //-----------------------------------------------------------------------------
-void ParallelRefinement::update_logical_edgefunction()
+std::size_t ParallelRefinement::update_logical_edgefunction()
 {
   const std::size_t mpi_size = MPI::size(_mesh.mpi_comm());
 
-  // Send all shared edges marked for update and receive from other processes
+  // Count edges marked for update on all processes
+  std::size_t num_marked = 0;
+  for (auto const &p : _neighbours)
+    num_marked += marked_for_update[p].size();
+  num_marked = MPI::sum(_mesh.mpi_comm(), num_marked);
+  if (num_marked == 0)
+    return 0;
+
+  // Send all shared edges marked for update and receive from
+  // neighbouring processes
   std::vector<std::size_t> received_values;
-  MPI::all_to_all(_mesh.mpi_comm(), marked_for_update, received_values);
+  neighbour_exchange(marked_for_update, received_values);
 
   // Clear marked_for_update vectors
   marked_for_update = std::vector<std::vector<std::size_t>>(mpi_size);
@@ -143,6 +178,7 @@ void ParallelRefinement::update_logical_edgefunction()
   for (auto const &local_index : received_values)
       marked_edges[local_index] = true;
 
+  return num_marked;
 }
 //-----------------------------------------------------------------------------
 void ParallelRefinement::create_new_vertices()
@@ -223,7 +259,7 @@ void ParallelRefinement::create_new_vertices()
 
   // Send new vertex indices to remote processes and receive
   std::vector<std::size_t> received_values;
-  MPI::all_to_all(_mesh.mpi_comm(), values_to_send, received_values);
+  neighbour_exchange(values_to_send, received_values);
 
   // Add received remote global vertex indices to map
   for (auto q = received_values.begin();
@@ -242,6 +278,37 @@ void ParallelRefinement::create_new_vertices()
      _mesh.geometry().dim(), global_indices);
 }
 //-----------------------------------------------------------------------------
+std::size_t ParallelRefinement::communication_volume()
+{
+  return _communication_volume;
+}
+//-----------------------------------------------------------------------------
+void ParallelRefinement::neighbour_exchange(
+  const std::vector<std::vector<std::size_t>>& values,
+  std::vector<std::size_t>& received_values) const
+{
+  dolfin_assert(_neighbourhood_comm);
+
+  // Pack data for neighbours (in order of the graph topology)
+  std::vector<std::vector<std::size_t>> send_values(_neighbours.size());
+  for (std::size_t i = 0; i < _neighbours.size(); ++i)
+  {
+    dolfin_assert(_neighbours[i] < (int) values.size());
+    send_values[i] = values[_neighbours[i]];
+    _communication_volume += send_values[i].size()*sizeof(std::size_t);
+  }
+
+  // Send and receive
+  std::vector<std::vector<std::size_t>> recv_values;
+  MPI::neighbor_all_to_all(_neighbourhood_comm->comm(), send_values,
+                           recv_values);
+
+  // Flatten received values
+  received_values.clear();
+  for (auto const &p : recv_values)
+    received_values.insert(received_values.end(), p.begin(), p.end());
+}
+//-----------------------------------------------------------------------------
 void ParallelRefinement::build_local(Mesh& new_mesh) const
 {
   MeshEditor ed;
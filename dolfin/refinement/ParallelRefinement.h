@@ -21,8 +21,10 @@
 #ifndef __PARALLEL_REFINEMENT_H
 #define __PARALLEL_REFINEMENT_H
 
+#include <memory>
 #include <unordered_map>
 #include <vector>
+#include <dolfin/common/MPI.h>
 
 namespace dolfin
 {
@@ -79,8 +81,13 @@ namespace dolfin
     /// @param cell (const _MeshEntity_)
     std::vector<std::size_t> marked_edge_list(const MeshEntity& cell) const;
 
-    /// Transfer marked edges between processes
-    void update_logical_edgefunction();
+    /// Transfer marked edges between processes. Only the processes
+    /// sharing edges with this process are involved in the
+    /// communication.
+    /// @return std::size_t
+    ///   Number of edges marked for update on any process before the
+    ///   transfer (zero when all processes are up to date)
+    std::size_t update_logical_edgefunction();
 
     /// Add new vertex for each marked edge, and create
     /// new_vertex_coordinates and global_edge->new_vertex mapping.
@@ -113,7 +120,13 @@ namespace dolfin
     /// @param idx (const std::vector<std::size_t>)
     void new_cells(const std::vector<std::size_t>& idx);
 
-    /// Use vertex and topology data to partition new mesh across processes
+    /// Use vertex and topology data to partition new mesh across
+    /// processes. If redistribute is true, the cells are
+    /// repartitioned using the "mesh_partitioner" and
+    /// "partitioning_approach" parameters. With ParMETIS and
+    /// "REPARTITION", the current distribution is taken as the
+    /// starting point so that only the cells needed to restore the
+    /// load balance are migrated.
     /// @param new_mesh (_Mesh_)
     /// @param redistribute (bool)
     void partition(Mesh& new_mesh, bool redistribute) const;
@@ -122,8 +135,19 @@ namespace dolfin
     /// @param new_mesh (_Mesh_)
     void build_local(Mesh& new_mesh) const;
 
+    /// Return total number of bytes sent to other processes by this
+    /// process during edge marker and new vertex exchanges (summed
+    /// over all refinements since the program started)
+    static std::size_t communication_volume();
+
   private:
 
+    // Send values[p] to process p for each neighbouring process p
+    // (processes sharing edges with this process) and return the
+    // received values
+    void neighbour_exchange(const std::vector<std::vector<std::size_t>>& values,
+                            std::vector<std::size_t>& received_values) const;
+
     // Mesh reference
     const Mesh& _mesh;
 
@@ -131,6 +155,14 @@ namespace dolfin
     std::unordered_map<unsigned int, std::vector<std::pair<unsigned int,
       unsigned int> > > shared_edges;
 
+    // Processes sharing edges with this process (sorted), and
+    // communicator with the corresponding distributed graph topology
+    std::vector<int> _neighbours;
+    std::unique_ptr<MPI::Comm> _neighbourhood_comm;
+
+    // Total number of bytes sent to other processes
+    static std::size_t _communication_volume;
+
     // Mapping from old local edge index to new global vertex, needed
     // to create new topology
     std::shared_ptr<std::map<std::size_t, std::size_t> > local_edge_to_new_vertex;
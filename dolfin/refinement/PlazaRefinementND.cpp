@@ -26,6 +26,7 @@
 
 #include <dolfin/common/Timer.h>
 #include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshEditor.h>
 #include <dolfin/mesh/MeshEntityIterator.h>
 #include <dolfin/mesh/MeshRelation.h>
 #include <dolfin/mesh/Cell.h>
@@ -282,30 +283,34 @@ void PlazaRefinementND::enforce_rules(ParallelRefinement& p_ref,
   Timer t0("PLAZA: Enforce rules");
 
   // Enforce rule, that if any edge of a face is marked, longest edge
-  // must also be marked
+  // must also be marked. The rule is applied locally until no more
+  // edges are marked, before exchanging the marked shared edges with
+  // the neighbouring processes in a single batch. This is repeated
+  // until no process has shared edges to update.
 
-  std::size_t update_count = 1;
-  while (update_count != 0)
+  do
   {
-    update_count = 0;
-    p_ref.update_logical_edgefunction();
-
-    for (FaceIterator f(mesh); !f.end(); ++f)
+    std::size_t update_count = 1;
+    while (update_count != 0)
     {
-      const std::size_t long_e = long_edge[f->index()];
-      if (p_ref.is_marked(long_e))
-        continue;
-      bool any_marked = false;
-      for (EdgeIterator e(*f); !e.end(); ++e)
-        any_marked |= p_ref.is_marked(e->index());
-      if (any_marked)
+      update_count = 0;
+      for (FaceIterator f(mesh); !f.end(); ++f)
       {
-        p_ref.mark(long_e);
-        ++update_count;
+        const std::size_t long_e = long_edge[f->index()];
+        if (p_ref.is_marked(long_e))
+          continue;
+        bool any_marked = false;
+        for (EdgeIterator e(*f); !e.end(); ++e)
+          any_marked |= p_ref.is_marked(e->index());
+        if (any_marked)
+        {
+          p_ref.mark(long_e);
+          ++update_count;
+        }
       }
     }
-    update_count = dolfin::MPI::sum(mesh.mpi_comm(), update_count);
   }
+  while (p_ref.update_logical_edgefunction() != 0);
 }
 //-----------------------------------------------------------------------------
 void PlazaRefinementND::refine(Mesh& new_mesh, const Mesh& mesh,
@@ -326,6 +331,13 @@ void PlazaRefinementND::refine(Mesh& new_mesh, const Mesh& mesh,
   std::vector<bool> edge_ratio_ok;
   face_long_edge(long_edge, edge_ratio_ok, mesh);
 
+  // Use memory-lean refinement in serial
+  if (dolfin::MPI::size(mesh.mpi_comm()) == 1 and !calculate_parent_facets)
+  {
+    do_uniform_refine(new_mesh, mesh, long_edge, edge_ratio_ok);
+    return;
+  }
+
   ParallelRefinement p_ref(mesh);
   p_ref.mark_all();
 
@@ -389,6 +401,88 @@ void PlazaRefinementND::refine(Mesh& new_mesh, const Mesh& mesh,
             calculate_parent_facets, mesh_relation);
 }
 //-----------------------------------------------------------------------------
+void PlazaRefinementND::do_uniform_refine(Mesh& new_mesh, const Mesh& mesh,
+                                          const std::vector<unsigned int>& long_edge,
+                                          const std::vector<bool>& edge_ratio_ok)
+{
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_cell_edges = tdim*3 - 3;
+  const std::size_t num_cell_vertices = tdim + 1;
+  const std::size_t num_vertices = mesh.num_vertices();
+  const std::size_t num_edges = mesh.num_edges();
+
+  // All edges are marked (cell local indexing)
+  const std::vector<bool> markers(num_cell_edges, true);
+
+  std::vector<std::size_t> simplex_set;
+  std::vector<std::size_t> longest_edge;
+
+  MeshEditor editor;
+  editor.open(new_mesh, mesh.type().cell_type(), tdim, gdim);
+
+  // Copy old vertices and add a new vertex at the midpoint of each
+  // edge
+  editor.init_vertices(num_vertices + num_edges);
+  for (VertexIterator v(mesh); !v.end(); ++v)
+    editor.add_vertex(v->index(), v->point());
+  for (EdgeIterator e(mesh); !e.end(); ++e)
+    editor.add_vertex(num_vertices + e->index(), e->midpoint());
+
+  // Each simplex is subdivided into 2^tdim simplices
+  const std::size_t num_children = (tdim == 2) ? 4 : 8;
+  editor.init_cells(num_children*mesh.num_cells());
+  std::vector<std::size_t>& parent_cell
+    = new_mesh.data().create_array("parent_cell", tdim);
+  parent_cell.resize(num_children*mesh.num_cells());
+
+  std::vector<std::size_t> indices(num_cell_vertices + num_cell_edges);
+  std::vector<std::size_t> cell_vertices(num_cell_vertices);
+  std::size_t c = 0;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    // Create vector of indices in the order [vertices][edges], 3+3 in
+    // 2D, 4+6 in 3D
+    const unsigned int* vertices = cell->entities(0);
+    const unsigned int* edges = cell->entities(1);
+    for (std::size_t j = 0; j < num_cell_vertices; ++j)
+      indices[j] = vertices[j];
+    for (std::size_t j = 0; j < num_cell_edges; ++j)
+      indices[num_cell_vertices + j] = num_vertices + edges[j];
+
+    // Longest edges of each facet in cell local indexing
+    longest_edge.clear();
+    for (FaceIterator f(*cell); !f.end(); ++f)
+    {
+      const unsigned int e = long_edge[f->index()];
+      for (std::size_t j = 0; j < num_cell_edges; ++j)
+      {
+        if (edges[j] == e)
+        {
+          longest_edge.push_back(j);
+          break;
+        }
+      }
+    }
+
+    const bool uniform
+      = (tdim == 2) ? edge_ratio_ok[cell->index()] : false;
+    get_simplices(simplex_set, markers, longest_edge, tdim, uniform);
+    dolfin_assert(simplex_set.size() == num_children*num_cell_vertices);
+
+    // Add cells
+    for (std::size_t i = 0; i < num_children; ++i)
+    {
+      for (std::size_t j = 0; j < num_cell_vertices; ++j)
+        cell_vertices[j] = indices[simplex_set[i*num_cell_vertices + j]];
+      parent_cell[c] = cell->index();
+      editor.add_cell(c++, cell_vertices);
+    }
+  }
+
+  editor.close();
+}
+//-----------------------------------------------------------------------------
 void PlazaRefinementND::do_refine(Mesh& new_mesh, const Mesh& mesh,
                                   ParallelRefinement& p_ref,
                                   const std::vector<unsigned int>& long_edge,
@@ -494,6 +588,8 @@ void PlazaRefinementND::do_refine(Mesh& new_mesh, const Mesh& mesh,
       set_parent_facet_markers(mesh, new_mesh, new_vertex_map);
 
     mesh_relation.edge_to_global_vertex = p_ref.edge_to_new_vertex();
+    mesh_relation.parent_cell
+      = std::make_shared<const std::vector<std::size_t>>(parent_cell);
   }
   else if (calculate_parent_facets)
     warning("Cannot calculate parent facets if redistributing cells");
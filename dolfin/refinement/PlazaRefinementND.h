@@ -128,6 +128,14 @@ namespace dolfin
        const std::vector<bool>& marked_edges,
        const std::vector<std::size_t>& longest_edge);
 
+    // Uniform refinement of a serial mesh, writing vertices and cells
+    // directly into the new mesh (without the intermediate storage
+    // of ParallelRefinement). New vertex i is the midpoint of edge
+    // i - num_vertices.
+    static void do_uniform_refine(Mesh& new_mesh, const Mesh& mesh,
+                                  const std::vector<unsigned int>& long_edge,
+                                  const std::vector<bool>& edge_ratio_ok);
+
     // Convenient interface for both uniform and marker refinement
     static void do_refine(Mesh& new_mesh, const Mesh& mesh,
                           ParallelRefinement& p_ref,
@@ -72,6 +72,9 @@ PROBLEM_RENAMES(NonlinearVariational)
 //-----------------------------------------------------------------------------
 %rename (_function_space) dolfin::DirichletBC::function_space;
 %ignore dolfin::DirichletBC::gather;
+%rename (zero_columns_multiple) dolfin::DirichletBC::zero_columns(GenericMatrix&, GenericVector&,
+                                                               std::vector<std::shared_ptr<const DirichletBC>>,
+                                                               double);
 
 //-----------------------------------------------------------------------------
 // Modifying the interface of Form
@@ -87,6 +90,11 @@ PROBLEM_RENAMES(NonlinearVariational)
 %ignore dolfin::Form::dP;
 %ignore dolfin::Form::operator==;
 
+//-----------------------------------------------------------------------------
+// Ignore cell-wise functional values of MultiFormAssembler
+//-----------------------------------------------------------------------------
+%ignore dolfin::MultiFormAssembler::add(std::vector<double>&, const Form&);
+
 //-----------------------------------------------------------------------------
 // Ignore dolfin::Cell versions of signatures as these now are handled by
 // a typemap
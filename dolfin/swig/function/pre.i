@@ -32,6 +32,10 @@
 // modules has been loaded.
 // ===========================================================================
 
+// Ignore non-const accessors of particle data
+%ignore dolfin::Particles::positions();
+%ignore dolfin::Particles::values(std::size_t);
+
 %ignore dolfin::GenericFunction::eval(Eigen::Ref<Eigen::VectorXd>,
                                       Eigen::Ref<const Eigen::VectorXd>,
                                       const ufc::cell&) const;
@@ -49,6 +53,24 @@
                                  const ufc::cell&) const;
 %ignore dolfin::Expression::eval(Eigen::Ref<Eigen::VectorXd>,
                                  Eigen::Ref<const Eigen::VectorXd>) const;
+%ignore dolfin::Expression::eval_block;
+%ignore dolfin::Expression::eval_points;
+%ignore dolfin::Expression::restrict_cells;
+
+//-----------------------------------------------------------------------------
+// Return writable NumPy array of QuadratureData values
+//-----------------------------------------------------------------------------
+%ignore dolfin::QuadratureData::cell_values;
+%ignore dolfin::QuadratureData::values;
+%extend dolfin::QuadratureData
+{
+  PyObject* array()
+  {
+    return %make_numpy_array(2, double)(self->mesh()->num_cells(),
+                                        self->block_size(),
+                                        self->values().data(), true);
+  }
+}
 
 
 %ignore dolfin::Function::eval(Eigen::Ref<Eigen::VectorXd>,
@@ -60,6 +82,9 @@
                                Eigen::Ref<const Eigen::VectorXd>,
                                const dolfin::Cell&,
                                const ufc::cell&) const;
+%ignore dolfin::Function::eval(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> >,
+                               Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> >,
+                               std::vector<unsigned int>&) const;
 
 
 //-----------------------------------------------------------------------------
@@ -131,6 +156,7 @@ __div__ = __truediv__
 %feature("nodirector") dolfin::Expression::str;
 %feature("nodirector") dolfin::Expression::compute_vertex_values;
 %feature("nodirector") dolfin::Expression::function_space;
+%feature("nodirector") dolfin::Expression::has_eval_points;
 
 //-----------------------------------------------------------------------------
 // Macro for defining an in typemap for a const std::vector<std::pair<double,
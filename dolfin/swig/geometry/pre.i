@@ -38,6 +38,10 @@
 //-----------------------------------------------------------------------------
 %ignore dolfin::BoundingBoxTree::BoundingBoxTree(const Mesh&);
 %ignore dolfin::BoundingBoxTree::BoundingBoxTree(const Mesh&, unsigned int);
+%ignore dolfin::BoundingBoxTree::compute_distributed_entity_collisions;
+%ignore dolfin::GenericBoundingBoxTree::compute_distributed_entity_collisions;
+%ignore dolfin::BoundaryDistance::compute_distances;
+%ignore dolfin::BoundaryDistance::compute_closest_points;
 
 //-----------------------------------------------------------------------------
 // Ignore nested classes. They are not supported by SWIG
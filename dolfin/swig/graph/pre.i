@@ -28,3 +28,4 @@
 //-----------------------------------------------------------------------------
 %ignore dolfin::GraphBuilder::compute_dual_graph;
 %ignore dolfin::SCOTCH::compute_partition;
+%ignore dolfin::GeometricPartitioner::compute_partition;
@@ -122,6 +122,30 @@ def __exit__(self, type, value, traceback) :
 %}
 }
 
+#ifdef HAS_ADIOS2
+%extend dolfin::ADIOS2File {
+%pythoncode %{
+def __enter__(self) :
+    return self
+
+def __exit__(self, type, value, traceback) :
+    self.close()
+%}
+}
+#endif
+
+#ifdef HAS_ASCENT
+%extend dolfin::AscentAdaptor {
+%pythoncode %{
+def __enter__(self) :
+    return self
+
+def __exit__(self, type, value, traceback) :
+    self.close()
+%}
+}
+#endif
+
 %extend dolfin::X3DOMParameters
 {
 %pythoncode %{
@@ -110,6 +110,8 @@
 %ignore dolfin::GenericTensor::get(double*, const  dolfin::la_index*, const dolfin::la_index * const *) const;
 %ignore dolfin::GenericTensor::set(const double* , const dolfin::la_index* , const dolfin::la_index * const *);
 %ignore dolfin::GenericTensor::add(const double* , const dolfin::la_index* , const dolfin::la_index * const *);
+%ignore dolfin::GenericTensor::add_local_blocks;
+%ignore dolfin::BlockBatch;
 %ignore dolfin::PETScLinearOperator::wrapper;
 
 //-----------------------------------------------------------------------------
@@ -148,6 +150,8 @@
 //-----------------------------------------------------------------------------
 %ignore dolfin::GenericVector::get(double*, std::size_t, const dolfin::la_index*) const;
 %ignore dolfin::GenericVector::set(const double* , std::size_t m, const dolfin::la_index*);
+%ignore dolfin::GenericVector::get_local_strided;
+%ignore dolfin::GenericVector::set_local_strided;
 
 %ignore dolfin::GenericVector::data() const;
 %ignore dolfin::GenericVector::data();
@@ -178,6 +182,8 @@
 //-----------------------------------------------------------------------------
 #ifdef HAS_PETSC
 
+%ignore dolfin::PETScMatrix::data;
+
 // Only ignore C++ accessors if petsc4py is enabled
 #ifdef HAS_PETSC4PY
 %ignore dolfin::PETScVector::vec() const;
@@ -197,6 +203,63 @@
 #endif
 #endif
 
+#ifdef HAS_PETSC
+//-----------------------------------------------------------------------------
+// Typemap for the blocks of PETScNestMatrix. None is kept as a null
+// (zero) block so the block positions are preserved
+//-----------------------------------------------------------------------------
+%typecheck(SWIG_TYPECHECK_POINTER) std::vector<std::shared_ptr<const dolfin::GenericMatrix> > mats
+{
+  $1 = PyList_Check($input) ? 1 : 0;
+}
+
+%typemap (in) std::vector<std::shared_ptr<const dolfin::GenericMatrix> > mats (
+std::vector<std::shared_ptr<const dolfin::GenericMatrix> > tmp_vec)
+{
+  if (!PyList_Check($input))
+  {
+    SWIG_exception(SWIG_TypeError, "list of GenericMatrix expected");
+  }
+
+  int size = PyList_Size($input);
+  tmp_vec.reserve(size);
+  for (int i = 0; i < size; i++)
+  {
+    PyObject* py_item = PyList_GetItem($input, i);
+    if (py_item == Py_None)
+    {
+      tmp_vec.push_back(std::shared_ptr<const dolfin::GenericMatrix>());
+      continue;
+    }
+
+    void* itemp = 0;
+    int newmem = 0;
+    int res = SWIG_ConvertPtrAndOwn(py_item, &itemp, $descriptor(std::shared_ptr< dolfin::GenericMatrix > *), 0, &newmem);
+    if (!SWIG_IsOK(res) || !itemp)
+    {
+      SWIG_exception(SWIG_TypeError, "expected a list of GenericMatrix or None (Bad conversion)");
+    }
+    tmp_vec.push_back(*(reinterpret_cast<std::shared_ptr<dolfin::GenericMatrix> *>(itemp)));
+    if (newmem & SWIG_CAST_NEW_MEMORY)
+      delete reinterpret_cast<std::shared_ptr<dolfin::GenericMatrix> *>(itemp);
+  }
+  $1 = tmp_vec;
+}
+
+//-----------------------------------------------------------------------------
+// Return the block dofs of PETScNestMatrix as a NumPy array
+//-----------------------------------------------------------------------------
+%ignore dolfin::PETScNestMatrix::get_block_dofs(std::vector<dolfin::la_index>&, std::size_t) const;
+%extend dolfin::PETScNestMatrix {
+  std::vector<dolfin::la_index> get_block_dofs(std::size_t idx) const
+  {
+    std::vector<dolfin::la_index> dofs;
+    self->get_block_dofs(dofs, idx);
+    return dofs;
+  }
+}
+#endif
+
 #ifdef HAS_SLEPC
 // Only ignore C++ accessors if slepc4py is enabled
 #ifdef HAS_SLEPC4PY
@@ -55,3 +55,9 @@
 %ignore dolfin::LogStream;
 %ignore dolfin::cout;
 %ignore dolfin::endl;
+
+//-----------------------------------------------------------------------------
+// Ignore SolverTelemetry callbacks (std::function is not wrapped)
+//-----------------------------------------------------------------------------
+%ignore dolfin::SolverTelemetry::add_callback;
+%ignore dolfin::SolverTelemetry::remove_callback;
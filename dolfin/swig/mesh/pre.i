@@ -36,6 +36,7 @@
 
 %ignore dolfin::SubDomain::inside(Eigen::Ref<const Eigen::VectorXd>, bool) const;
 %ignore dolfin::SubDomain::map(Eigen::Ref<const Eigen::VectorXd>, Eigen::Ref<Eigen::VectorXd>) const;
+%ignore dolfin::SubDomain::inside_points;
 
 //-----------------------------------------------------------------------------
 // SWIG does not seem to generate useful code for non-member operators
@@ -165,17 +166,28 @@ CPP_VALUE_TYPE(dolfin::MeshFunction<std::size_t>, std::size_t)
 // Misc ignores
 //-----------------------------------------------------------------------------
 %ignore dolfin::MeshEditor::open(Mesh&, CellType::Type, std::size_t, std::size_t);
+%ignore dolfin::MeshEditor::add_vertices;
+%ignore dolfin::MeshEditor::add_vertices_global;
+%ignore dolfin::MeshEditor::add_cells;
+%ignore dolfin::MeshEditor::add_cells_global;
+%ignore dolfin::MeshTopology::set_global_indices;
+%ignore dolfin::MeshConnectivity::assign;
 %ignore dolfin::Mesh::operator=;
 %ignore dolfin::MeshData::operator=;
 %ignore dolfin::MeshFunction::operator=;
 %ignore dolfin::MeshFunction::operator[];
 %ignore dolfin::MeshValueCollection::operator=;
+%ignore dolfin::MeshValueCollection::entities;
+%ignore dolfin::MeshValueCollection::entity_values;
 %ignore dolfin::MeshGeometry::operator=;
 %ignore dolfin::MeshTopology::operator=;
 %ignore dolfin::MeshTopology::shared_entities(unsigned int) const;
 %ignore dolfin::MeshValueCollection::operator=;
 %ignore dolfin::MeshConnectivity::operator=;
 %ignore dolfin::MeshConnectivity::set;
+%ignore dolfin::MeshConnectivity::connections;
+%ignore dolfin::ConnectionIterator;
+%ignore dolfin::CellVertexView;
 %ignore dolfin::MeshEntityIterator::operator->;
 %ignore dolfin::MeshEntityIterator::operator[];
 %ignore dolfin::MeshEntity::operator->;
@@ -185,6 +197,7 @@ CPP_VALUE_TYPE(dolfin::MeshFunction<std::size_t>, std::size_t)
 %ignore dolfin::MeshDomains::markers(std::size_t) const;
 %ignore dolfin::MeshData::array(std::string) const;
 %ignore dolfin::MeshHierarchy::operator[];
+%ignore dolfin::MeshHierarchy::parent_cells;
 
 //-----------------------------------------------------------------------------
 // Map increment, decrease and dereference operators for iterators
@@ -351,4 +364,17 @@ FORWARD_DECLARE_MESHFUNCTIONS(std::size_t, Sizet)
 //-----------------------------------------------------------------------------
 %ignore dolfin::MeshPartitioning::build_distributed_mesh(Mesh&, const std::vector<std::size_t>&);
 %ignore dolfin::MeshPartitioning::build_distributed_mesh(Mesh&, const LocalMeshData&);
+%ignore dolfin::MeshPartitioning::build_distributed_mesh(Mesh&, const LocalMeshData&, const std::vector<int>&, const std::map<std::int64_t, std::vector<int>>&, const std::string);
 %ignore dolfin::MeshPartitioning::build_distributed_value_collection;
+%ignore dolfin::MeshPartitioning::repartition(const std::vector<std::shared_ptr<const MeshFunction<double>>>&);
+
+//-----------------------------------------------------------------------------
+// Only expose the partition diagnostics of DistributedMeshTools
+//-----------------------------------------------------------------------------
+%ignore dolfin::DistributedMeshTools::number_entities;
+%ignore dolfin::DistributedMeshTools::init_facet_cell_connections;
+%ignore dolfin::DistributedMeshTools::locate_off_process_entities;
+%ignore dolfin::DistributedMeshTools::compute_shared_entities;
+%ignore dolfin::DistributedMeshTools::reorder_vertices_by_global_indices;
+%ignore dolfin::DistributedMeshTools::reorder_values_by_global_indices;
+%ignore dolfin::DistributedMeshTools::partition_diagnostics;
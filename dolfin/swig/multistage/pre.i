@@ -37,3 +37,6 @@
 
 %ignore dolfin::PointIntegralSolver::scheme;
 %ignore dolfin::RKSolver::scheme;
+
+// Time step is updated through a reference
+%ignore dolfin::TimeStepController::accept;
@@ -64,6 +64,7 @@
 
 // ale
 %shared_ptr(dolfin::MeshDisplacement)
+%shared_ptr(dolfin::HarmonicSmoothing)
 
 // common
 %shared_ptr(dolfin::Variable)
@@ -101,6 +102,8 @@
 %shared_ptr(dolfin::Expression)
 %shared_ptr(dolfin::FacetArea)
 %shared_ptr(dolfin::Constant)
+%shared_ptr(dolfin::QuadratureData)
+%shared_ptr(dolfin::Particles)
 %shared_ptr(dolfin::MeshCoordinates)
 %shared_ptr(dolfin::MultiMeshFunctionSpace)
 %shared_ptr(dolfin::MultiMeshSubSpace)
@@ -114,6 +117,9 @@
 %shared_ptr(dolfin::BoundaryMesh)
 %shared_ptr(dolfin::Mesh)
 %shared_ptr(dolfin::SubMesh)
+%shared_ptr(dolfin::MeshGeometryCache)
+%shared_ptr(dolfin::MeshInteriorFacets)
+%shared_ptr(dolfin::MeshExteriorFacets)
 %shared_ptr(dolfin::UnitTetrahedronMesh)
 %shared_ptr(dolfin::UnitCubeMesh)
 %shared_ptr(dolfin::UnitIntervalMesh)
@@ -175,6 +181,7 @@
 %shared_ptr(dolfin::PETScKrylovSolver)
 %shared_ptr(dolfin::PETScLUSolver)
 %shared_ptr(dolfin::PETScMatrix)
+%shared_ptr(dolfin::PETScNestMatrix)
 %shared_ptr(dolfin::PETScObject)
 %shared_ptr(dolfin::PETScPreconditioner)
 %shared_ptr(dolfin::PETScVector)
@@ -200,6 +207,7 @@
 
 %shared_ptr(dolfin::TensorLayout)
 %shared_ptr(dolfin::SparsityPattern)
+%shared_ptr(dolfin::VectorSpaceBasis)
 
 // log
 %shared_ptr(dolfin::Table)
@@ -209,6 +217,8 @@
 %shared_ptr(dolfin::File)
 %shared_ptr(dolfin::XDMFFile)
 %shared_ptr(dolfin::HDF5File)
+%shared_ptr(dolfin::ADIOS2File)
+%shared_ptr(dolfin::AscentAdaptor)
 %shared_ptr(dolfin::X3DOM)
 
 // math
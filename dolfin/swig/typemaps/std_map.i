@@ -101,6 +101,9 @@ namespace std
   }
 }
 
+%typemap(out) const MAP_TYPE<std::pair<KEY_TYPE, KEY_TYPE>, VALUE_TYPE>&
+  = MAP_TYPE<std::pair<KEY_TYPE, KEY_TYPE>, VALUE_TYPE>&;
+
 %typemap(out) MAP_TYPE<KEY_TYPE, std::pair<VALUE_TYPE, VALUE_TYPE> >
   (MAP_TYPE<KEY_TYPE, std::pair<VALUE_TYPE, VALUE_TYPE> >::const_iterator it,
   PyObject* item0, PyObject* item1)
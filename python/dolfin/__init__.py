@@ -32,31 +32,45 @@ del sys
 
 # Import cpp modules
 from .cpp.common import (Variable, has_debug, has_hdf5, has_scotch,
-                         has_hdf5_parallel, has_mpi, has_petsc,
+                         has_hdf5_parallel, has_adios2, has_ascent, has_mpi,
+                         has_petsc,
                          has_parmetis, has_slepc, git_commit_hash,
                          DOLFIN_EPS, DOLFIN_PI, TimingClear,
                          TimingType, timing, timings, list_timings,
-                         dump_timings_to_xml)
+                         dump_timings_to_xml, timing_tree,
+                         list_timing_tree, start_timing_trace,
+                         stop_timing_trace, dump_timing_trace,
+                         enable_hardware_counters, startup_timings,
+                         disable_hardware_counters)
 
 if has_hdf5():
     from .cpp.adaptivity import TimeSeries
     from .cpp.io import HDF5File
 
-from .cpp.ale import ALE
+if has_adios2():
+    from .cpp.io import ADIOS2File
+
+if has_ascent():
+    from .cpp.io import AscentAdaptor
+
+from .cpp.adaptivity import Checkpointer
+from .cpp.ale import ALE, HarmonicSmoothing
 from .cpp import MPI
 from .cpp.function import (Expression, Constant, FunctionAXPY,
                            LagrangeInterpolator, FunctionAssigner,
-                           assign)
-from .cpp.fem import (FiniteElement, DofMap, Assembler,
+                           QuadratureData, Particles, assign)
+from .cpp.fem import (FiniteElement, DofMap, Assembler, MultiFormAssembler,
                       get_coordinates, create_mesh, set_coordinates,
                       vertex_to_dof_map, dof_to_vertex_map,
+                      rigid_body_modes, set_rigid_body_near_nullspace,
                       PointSource, DiscreteOperators,
                       LinearVariationalSolver,
                       NonlinearVariationalSolver,
                       SparsityPatternBuilder)
 
-from .cpp.geometry import (BoundingBoxTree, Point,
-                           MeshPointIntersection, intersect)
+from .cpp.geometry import (BoundingBoxTree, BoundaryDistance, Point,
+                           MeshPointIntersection, intersect,
+                           orient2d, orient3d)
 from .cpp.generation import (IntervalMesh, BoxMesh, RectangleMesh,
                              UnitDiscMesh, UnitQuadMesh, UnitHexMesh,
                              UnitTriangleMesh, UnitCubeMesh,
@@ -89,13 +103,15 @@ from .cpp.la import (IndexMap, DefaultFactory, Matrix, Vector, Scalar,
                      KrylovSolver, TensorLayout, LinearOperator,
                      BlockMatrix, BlockVector)
 from .cpp.la import GenericVector  # Remove when pybind11 transition complete
-from .cpp.log import (info, Table, set_log_level, get_log_level, LogLevel)
+from .cpp.log import (info, Table, MemoryReport, SolverTelemetry,
+                      set_log_level, get_log_level, LogLevel)
 from .cpp.math import ipow, near, between
 from .cpp.mesh import (Mesh, MeshTopology, MeshGeometry, MeshEntity,
                        MeshColoring, CellType, Cell, Facet, Face,
                        Edge, Vertex, cells, facets, faces, edges,
                        entities, vertices, SubDomain, BoundaryMesh,
-                       MeshEditor, MeshQuality, SubMesh,
+                       MeshEditor, MeshQuality, DistributedMeshTools,
+                       SubMesh,
                        DomainBoundary, PeriodicBoundaryComputation,
                        MeshTransformation, SubsetIterator)
 
@@ -111,16 +127,16 @@ from . import mesh
 from . import parameter
 
 from .common import timer
-from .common.timer import Timer, timed
+from .common.timer import Timer, ScopedTimer, timed
 from .common.plotting import plot
 
 from .fem.assembling import (assemble, assemble_system,
                              SystemAssembler, assemble_local)
 from .fem.form import Form
-from .fem.norms import norm, errornorm
+from .fem.norms import norm, errornorm, ErrorNorm
 from .fem.dirichletbc import DirichletBC, AutoSubDomain
 from .fem.interpolation import interpolate
-from .fem.projection import project
+from .fem.projection import project, Projector
 from .fem.solving import (solve, LocalSolver,
                           LinearVariationalProblem,
                           NonlinearVariationalProblem)
@@ -155,7 +171,7 @@ from .mesh.meshvaluecollection import MeshValueCollection
 from .mesh.subdomain import CompiledSubDomain
 
 from .multistage.multistagescheme import (RK4, CN2, ExplicitMidPoint,
-                                          ESDIRK3, ESDIRK4,
+                                          ESDIRK3, ESDIRK4, BS3,
                                           ForwardEuler, BackwardEuler)
 from .multistage.multistagesolvers import PointIntegralSolver, RKSolver
 from .multistage.rushlarsenschemes import RL1, RL2, GRL1, GRL2
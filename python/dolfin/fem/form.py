@@ -8,8 +8,8 @@
 # version.
 
 import ufl
-import ffc
 import dolfin.cpp as cpp
+from dolfin.jit.jit import ffc_jit, dolfin_form_compiler_parameters
 
 
 class Form(cpp.fem.Form):
@@ -29,19 +29,10 @@ class Form(cpp.fem.Form):
             raise RuntimeError("Expecting to find a Mesh in the form.")
 
         form_compiler_parameters = kwargs.pop("form_compiler_parameters", None)
+        form_compiler_parameters = dolfin_form_compiler_parameters(form_compiler_parameters)
 
-        # Add DOLFIN include paths (just the Boost path for special
-        # math functions is really required)
-        # FIXME: move getting include paths to elsewhere
-        import pkgconfig
-        d = pkgconfig.parse('dolfin')
-        if form_compiler_parameters is None:
-            form_compiler_parameters = {"external_include_dirs": d["include_dirs"]}
-        else:
-            # FIXME: add paths if dict entry already exists
-            form_compiler_parameters["external_include_dirs"] = d["include_dirs"]
-
-        ufc_form = ffc.jit(form, form_compiler_parameters)
+        ufc_form = ffc_jit(form, form_compiler_parameters,
+                           mpi_comm=mesh.mpi_comm())
         ufc_form = cpp.fem.make_ufc_form(ufc_form[0])
 
         function_spaces = [func.function_space()._cpp_object for func in form.arguments()]
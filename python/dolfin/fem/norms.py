@@ -34,7 +34,7 @@ from dolfin.function.functionspace import (FunctionSpace,
 from dolfin.function.function import Function
 
 
-__all__ = ["norm", "errornorm"]
+__all__ = ["norm", "errornorm", "ErrorNorm"]
 
 
 def norm(v, norm_type="L2", mesh=None):
@@ -277,3 +277,43 @@ def errornorm(u, uh, norm_type="l2", degree_rise=3, mesh=None):
 
     # Compute norm
     return norm(e, norm_type=norm_type, mesh=mesh)
+
+
+class ErrorNorm(object):
+    """Error norm evaluator on a fixed mesh, computing norms of
+    :math:`e = u - u_h` by quadrature of a given degree without
+    interpolation to a higher degree space. The quadrature points are
+    kept between calls, which makes repeated evaluation cheap.
+
+    *Arguments*
+        mesh
+            The :py:class:`Mesh <dolfin.cpp.Mesh>` to integrate over.
+        quadrature_degree
+            Degree of the quadrature rule (1 to 6).
+
+    *Example of usage*
+
+        .. code-block:: python
+
+            error = ErrorNorm(mesh, 4)
+            for t in times:
+                ...
+                e = error.compute(u_exact, uh, "H1")
+
+    """
+
+    def __init__(self, mesh, quadrature_degree):
+        self._cpp_object = cpp.fem.ErrorNorm(mesh, quadrature_degree)
+
+    def compute(self, u, uh, norm_type="L2"):
+        """Return norm of *u* - *uh*, where *uh* is a Function on the
+        mesh and *u* a Function or Expression. Norm types are "L2",
+        "H10" and "H1"; gradients require *u* to be a Function on the
+        same mesh."""
+        u = getattr(u, "_cpp_object", u)
+        uh = getattr(uh, "_cpp_object", uh)
+        return self._cpp_object.compute(u, uh, norm_type)
+
+    def num_points(self):
+        "Return number of local quadrature points"
+        return self._cpp_object.num_points()
@@ -29,10 +29,11 @@ import dolfin
 from dolfin.function.argument import TestFunction, TrialFunction
 from dolfin.function.function import Function
 from dolfin.fem.assembling import assemble_system
+from dolfin.fem.form import Form
 from dolfin.function.functionspace import (FunctionSpace,
                                            VectorFunctionSpace, TensorFunctionSpace)
 
-__all__ = ['project']
+__all__ = ['project', 'Projector']
 
 
 def project(v, V=None, bcs=None, mesh=None,
@@ -116,6 +117,57 @@ def project(v, V=None, bcs=None, mesh=None,
 
     return function
 
+class Projector(object):
+    """Projector onto a fixed finite element space *V*, keeping the
+    mass matrix and its factorization between projections.
+
+    *Arguments*
+        V
+            a :py:class:`FunctionSpace
+            <dolfin.functions.functionspace.FunctionSpace>`
+        method
+            "lu" (factorized mass matrix), "lumped" (row-sum lumped
+            mass matrix) or "local" (cell-wise solves, exact for
+            discontinuous spaces).
+        form_compiler_parameters
+            see :py:class:`Parameters <dolfin.cpp.Parameters>` for more
+            information.
+
+    *Example of usage*
+
+        .. code-block:: python
+
+            projector = Projector(V)
+            for t in times:
+                ...
+                projector.project(sigma, function=s)
+
+    """
+
+    def __init__(self, V, method="lu", form_compiler_parameters=None):
+        self._V = V
+        self._form_compiler_parameters = form_compiler_parameters
+        w = TestFunction(V)
+        Pv = TrialFunction(V)
+        a = ufl.inner(w, Pv)*ufl.dx(V.mesh())
+        self._a = Form(a, form_compiler_parameters=form_compiler_parameters)
+        self._cpp_object = cpp.fem.Projector(self._a, method)
+
+    def project(self, v, function=None):
+        """Return projection of *v* onto the finite element space of
+        the projector (in *function* if given)."""
+        w = TestFunction(self._V)
+        L = ufl.inner(w, v)*ufl.dx(self._V.mesh())
+        L = Form(L, form_compiler_parameters=self._form_compiler_parameters)
+        if function is None:
+            function = Function(self._V)
+        self._cpp_object.project(function._cpp_object, L)
+        return function
+
+    def num_assemblies(self):
+        "Return number of times the mass matrix has been assembled"
+        return self._cpp_object.num_assemblies()
+
 
 def _extract_function_space(expression, mesh):
     """Try to extract a suitable function space for projection of given
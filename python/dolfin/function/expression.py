@@ -56,6 +56,10 @@ class _InterfaceExpression(cpp.function.Expression):
             self.user_expression.eval(values, x)
         def wrapped_eval_cell(self, values, x, cell):
             self.user_expression.eval_cell(values, x, cell)
+        def wrapped_eval_points(self, values, x):
+            self.user_expression.eval_points(values, x)
+        def wrapped_has_eval_points(self):
+            return True
 
         # Attach user-provided Python eval functions (if they exist in
         # the user expression class) to the C++ class
@@ -64,6 +68,13 @@ class _InterfaceExpression(cpp.function.Expression):
         elif hasattr(user_expression, 'eval_cell'):
             self.eval_cell = types.MethodType(wrapped_eval_cell, self)
 
+        # Attach vectorised eval function, which is called with all
+        # points of a mesh (values and x are (num_points, value_size)
+        # and (num_points, gdim) arrays)
+        if hasattr(user_expression, 'eval_points'):
+            self.eval_points = types.MethodType(wrapped_eval_points, self)
+            self.has_eval_points = types.MethodType(wrapped_has_eval_points, self)
+
         # Create C++ Expression object
         cpp.function.Expression.__init__(self, value_shape)
 
@@ -225,7 +236,8 @@ class BaseExpression(ufl.Coefficient):
 
 class UserExpression(BaseExpression):
     """Base class for user-defined Python Expression classes, where the
-    user overloads eval or eval_cell
+    user overloads eval or eval_cell, and optionally eval_points(values,
+    x) which evaluates the expression at many points with NumPy
 
     """
 
@@ -47,7 +47,7 @@ namespace dolfin
        {{
 {statement}
        }}
-
+{block_eval}
        void set_property(std::string name, double _value) override
        {{
 {set_props}
@@ -93,6 +93,23 @@ extern "C" DLL_EXPORT dolfin::Expression * create_{classname}()
         for i, val in enumerate(statements):
             statement += "          values[" + str(i) + "] = " + val + ";\n"
 
+    # Evaluate all points of a cell in one loop, unless the statements
+    # depend on other functions
+    _block_eval = """
+       void eval_block(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> _values,
+                       Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> _x,
+                       const ufc::cell& cell) const override
+       {{
+         for (Eigen::Index _i = 0; _i < _x.rows(); ++_i)
+         {{
+          const double* x = _x.row(_i).data();
+          double* values = _values.row(_i).data();
+{statement}
+         }}
+       }}
+"""
+    block_eval = _block_eval.format(statement=statement)
+
     constructor = ""
     members = ""
     set_props = ""
@@ -124,6 +141,7 @@ extern "C" DLL_EXPORT dolfin::Expression * create_{classname}()
 
             generic_function_{key}->eval(Eigen::Map<Eigen::Matrix<double, {value_size}, 1>>({key}), x);\n""".format(key=k, value_size=value_size)
             statement = _setup_statement + statement
+            block_eval = ""
 
     # Set the value_shape
     for dim in class_data['value_shape']:
@@ -131,6 +149,7 @@ extern "C" DLL_EXPORT dolfin::Expression * create_{classname}()
 
     classname = signature
     code_c = template_code.format(statement=statement,
+                                  block_eval=block_eval,
                                   classname=classname,
                                   members=members,
                                   constructor=constructor,
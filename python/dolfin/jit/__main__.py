@@ -0,0 +1,29 @@
+# -*- coding: utf-8 -*-
+"""Compile the forms and elements of UFL files into the JIT cache
+ahead of a run
+
+Usage: python -m dolfin.jit [-j N] file.ufl [file.ufl ...]
+"""
+
+# Distributed under the terms of the GNU Lesser Public License (LGPL),
+# either version 3 of the License, or (at your option) any later
+# version.
+
+import argparse
+from dolfin.jit.jit import prewarm_ufl_files
+
+
+def main():
+    parser = argparse.ArgumentParser(prog="python -m dolfin.jit",
+                                     description="Pre-compile UFL files "
+                                     "into the DOLFIN JIT cache")
+    parser.add_argument("-j", "--jobs", type=int, default=None,
+                        help="number of concurrent builds")
+    parser.add_argument("files", nargs="+", help="UFL files")
+    args = parser.parse_args()
+    modules = prewarm_ufl_files(args.files, max_workers=args.jobs)
+    print("Compiled %d forms and elements" % len(modules))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,8 +1,12 @@
 # -*- coding: utf-8 -*-
 
+import os
+import functools
+import concurrent.futures
 import numpy
 import hashlib
 import dijitso
+import ffc
 import dolfin.cpp as cpp
 
 _cpp_math_builtins = [
@@ -20,6 +24,147 @@ const double pi = DOLFIN_PI;
 """ % "\n".join("using std::%s;" % mf for mf in _cpp_math_builtins)
 
 
+# Node communicators (one per communicator passed to the JIT)
+_node_comms = {}
+
+# Compiled classes, by module name
+_class_cache = {}
+
+
+def _node_comm(mpi_comm):
+    "Return communicator of the processes sharing a node with this one"
+    key = int(mpi_comm)
+    if key not in _node_comms:
+        _node_comms[key] = cpp.MPI.split(mpi_comm, 0)
+    return _node_comms[key]
+
+
+def mpi_jit_decorator(local_jit, *args, **kwargs):
+    """A decorator for collective jit compilation
+
+    In a parallel run, the decorated function is first called on the
+    building processes, which compile and fill the cache, and then on
+    the remaining processes, which only load the module from the
+    cache. By default the cache is assumed to be shared by all
+    processes and only process 0 of the communicator builds. If the
+    environment variable DOLFIN_JIT_NODE_LOCAL_CACHE is set (and the
+    dijitso cache, DIJITSO_CACHE_DIR, is on node-local storage), one
+    process per node builds, so that nodes compile in parallel and
+    never touch a shared filesystem.
+
+    The communicator is passed as the keyword argument mpi_comm
+    (default MPI.comm_world), and the call is collective on it.
+
+    *Example*
+        .. code-block:: python
+
+            @mpi_jit_decorator
+            def jit_something(something):
+                ....
+
+    """
+    @functools.wraps(local_jit)
+    def mpi_jit(*args, **kwargs):
+
+        mpi_comm = kwargs.pop("mpi_comm", None)
+        if mpi_comm is None:
+            mpi_comm = cpp.MPI.comm_world
+
+        # Just call JIT compiler when running in serial
+        if cpp.MPI.size(mpi_comm) == 1:
+            return local_jit(*args, **kwargs)
+
+        # Decide which processes build
+        node_local = os.environ.get("DOLFIN_JIT_NODE_LOCAL_CACHE", "0")
+        if node_local not in ("", "0"):
+            builder = cpp.MPI.rank(_node_comm(mpi_comm)) == 0
+        else:
+            builder = cpp.MPI.rank(mpi_comm) == 0
+
+        # Default status (0 == ok, 1 == fail)
+        status = 0
+        error_msg = ""
+        if builder:
+            try:
+                output = local_jit(*args, **kwargs)
+            except Exception as e:
+                status = 1
+                error_msg = str(e)
+
+        # Wait for the building processes and agree on status, so
+        # that all processes fail simultaneously (allowing the error
+        # to be caught without deadlock)
+        if cpp.MPI.max(mpi_comm, float(status)) > 0.0:
+            if not error_msg:
+                error_msg = "Compilation failed on building process."
+            raise RuntimeError(error_msg)
+
+        # Load from the cache on the other processes
+        if not builder:
+            output = local_jit(*args, **kwargs)
+        return output
+
+    return mpi_jit
+
+
+def dolfin_form_compiler_parameters(form_compiler_parameters=None):
+    "Add the DOLFIN include paths to form compiler parameters"
+
+    # Add DOLFIN include paths (just the Boost path for special
+    # math functions is really required)
+    import pkgconfig
+    d = pkgconfig.parse('dolfin')
+    if form_compiler_parameters is None:
+        form_compiler_parameters = {"external_include_dirs": d["include_dirs"]}
+    else:
+        # FIXME: add paths if dict entry already exists
+        form_compiler_parameters["external_include_dirs"] = d["include_dirs"]
+    return form_compiler_parameters
+
+
+@mpi_jit_decorator
+def ffc_jit(ufl_object, form_compiler_parameters=None):
+    """Compile UFL form or element with FFC (collective on the
+    communicator passed as mpi_comm)"""
+    return ffc.jit(ufl_object, form_compiler_parameters)
+
+
+def prewarm(ufl_objects, form_compiler_parameters=None, max_workers=None):
+    """Compile UFL forms and finite elements ahead of use, building
+    independent objects concurrently
+
+    Forms are compiled with the parameters used by dolfin.Form and
+    elements with the parameters used by dolfin.FunctionSpace, so the
+    modules are found in the cache when the objects are created.
+    max_workers is the number of concurrent builds (default: number
+    of CPUs).
+    """
+    import ufl
+    form_parameters = dolfin_form_compiler_parameters(form_compiler_parameters)
+
+    def _compile(ufl_object):
+        if isinstance(ufl_object, ufl.Form):
+            return ffc.jit(ufl_object, dict(form_parameters))
+        return ffc.jit(ufl_object, None)
+
+    if max_workers is None:
+        max_workers = os.cpu_count() or 1
+    with concurrent.futures.ThreadPoolExecutor(max_workers) as executor:
+        return list(executor.map(_compile, ufl_objects))
+
+
+def prewarm_ufl_files(filenames, form_compiler_parameters=None,
+                      max_workers=None):
+    "Compile all forms and elements of the given UFL files (see prewarm)"
+    from ufl.algorithms import load_ufl_file
+    ufl_objects = []
+    for filename in filenames:
+        ufd = load_ufl_file(filename)
+        ufl_objects += list(ufd.forms) + list(ufd.elements)
+    return prewarm(ufl_objects, form_compiler_parameters, max_workers)
+
+
+@mpi_jit_decorator
 def compile_class(cpp_data):
     """Compile a user C(++) string or set of statements to a Python object
 
@@ -70,9 +215,14 @@ def compile_class(cpp_data):
     module_hash = hashlib.md5(hash_str.encode('utf-8')).hexdigest()
     module_name = "dolfin_" + name + "_" + module_hash
 
+    # Look up module compiled earlier by this process before touching
+    # the disk cache
+    module = _class_cache.get(module_name)
     try:
-        module, signature = dijitso.jit(cpp_data, module_name, params,
-                                        generate=cpp_data['jit_generate'])
+        if module is None:
+            module, signature = dijitso.jit(cpp_data, module_name, params,
+                                            generate=cpp_data['jit_generate'])
+            _class_cache[module_name] = module
         submodule = dijitso.extract_factory_function(module, "create_" + module_name)()
     except:
         raise RuntimeError("Unable to compile C++ code with dijitso")
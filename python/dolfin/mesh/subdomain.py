@@ -45,6 +45,12 @@ namespace dolfin
          return {inside};
        }}
 
+       // Inside can be evaluated by several threads
+       bool thread_safe() const final
+       {{
+         return true;
+       }}
+
        void set_property(std::string name, double value)
        {{
 {set_props}
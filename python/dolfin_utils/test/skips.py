@@ -29,6 +29,10 @@ skip_if_not_PETsc_or_not_slepc = pytest.mark.skipif(not has_linear_algebra_backe
                                                     reason='Skipping unit test(s) depending on PETSc and slepc.')
 skip_if_not_HDF5 = pytest.mark.skipif(not has_hdf5(),
                                       reason="Skipping unit test(s) depending on HDF5.")
+skip_if_not_ADIOS2 = pytest.mark.skipif(not has_adios2(),
+                                        reason="Skipping unit test(s) depending on ADIOS2.")
+skip_if_not_Ascent = pytest.mark.skipif(not has_ascent(),
+                                        reason="Skipping unit test(s) depending on Ascent.")
 skip_if_not_PETSc = pytest.mark.skipif(not has_linear_algebra_backend("PETSc"),
                                        reason="Skipping unit test(s) depending on PETSc.")
 skip_if_not_petsc4py = pytest.mark.skipif(not has_petsc4py(),
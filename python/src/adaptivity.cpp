@@ -25,6 +25,7 @@
 #include <dolfin/adaptivity/ErrorControl.h>
 #include <dolfin/adaptivity/GenericAdaptiveVariationalSolver.h>
 #include <dolfin/adaptivity/GoalFunctional.h>
+#include <dolfin/adaptivity/Checkpointer.h>
 #include <dolfin/adaptivity/TimeSeries.h>
 #include <dolfin/common/Variable.h>
 #include <dolfin/fem/DirichletBC.h>
@@ -57,6 +58,34 @@ namespace dolfin_wrappers
       .def("mesh_times", &dolfin::TimeSeries::mesh_times);
 #endif
 
+    // dolfin::Checkpointer
+    py::class_<dolfin::Checkpointer, std::shared_ptr<dolfin::Checkpointer>,
+               dolfin::Variable>
+      checkpointer(m, "Checkpointer", "Binomial checkpointing schedule");
+    checkpointer
+      .def(py::init<MPI_Comm, std::size_t, std::size_t, std::size_t, std::string>(),
+           py::arg("mpi_comm"), py::arg("num_steps"),
+           py::arg("num_memory_checkpoints"), py::arg("num_disk_checkpoints")=0,
+           py::arg("filename")="checkpoints.h5")
+      .def("next", &dolfin::Checkpointer::next)
+      .def("current_step", &dolfin::Checkpointer::current_step)
+      .def("target_step", &dolfin::Checkpointer::target_step)
+      .def("checkpoint", &dolfin::Checkpointer::checkpoint)
+      .def("on_disk", &dolfin::Checkpointer::on_disk)
+      .def("num_forward_steps", &dolfin::Checkpointer::num_forward_steps)
+      .def("store", (void (dolfin::Checkpointer::*)(const dolfin::GenericVector&))
+           &dolfin::Checkpointer::store)
+      .def("restore", (void (dolfin::Checkpointer::*)(dolfin::GenericVector&) const)
+           &dolfin::Checkpointer::restore);
+
+    py::enum_<dolfin::Checkpointer::Action>(checkpointer, "Action")
+      .value("advance", dolfin::Checkpointer::Action::advance)
+      .value("store", dolfin::Checkpointer::Action::store)
+      .value("restore", dolfin::Checkpointer::Action::restore)
+      .value("first_adjoint", dolfin::Checkpointer::Action::first_adjoint)
+      .value("adjoint", dolfin::Checkpointer::Action::adjoint)
+      .value("terminate", dolfin::Checkpointer::Action::terminate);
+
     // dolfin::ErrorControl
     py::class_<dolfin::ErrorControl, std::shared_ptr<dolfin::ErrorControl>,
                dolfin::Variable>
@@ -87,7 +116,8 @@ namespace dolfin_wrappers
                std::shared_ptr<dolfin::GenericAdaptiveVariationalSolver>,
                dolfin::Variable>
       (m, "GenericAdaptiveVariationalSolver", "Generic adaptive variational solver")
-      .def("solve", &dolfin::GenericAdaptiveVariationalSolver::solve)
+      .def("solve", &dolfin::GenericAdaptiveVariationalSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
       .def("summary", &dolfin::GenericAdaptiveVariationalSolver::summary);
 
     // dolfin::AdaptiveLinearVariationalSolver
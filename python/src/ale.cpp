@@ -19,6 +19,7 @@
 #include <pybind11/pybind11.h>
 
 #include <dolfin/ale/ALE.h>
+#include <dolfin/ale/HarmonicSmoothing.h>
 #include <dolfin/ale/MeshDisplacement.h>
 #include <dolfin/common/Variable.h>
 #include <dolfin/function/Expression.h>
@@ -38,6 +39,14 @@ namespace dolfin_wrappers
                dolfin::Expression>(m, "MeshDisplacement")
       .def(py::init<std::shared_ptr<const dolfin::Mesh>>());
 
+    // dolfin::HarmonicSmoothing
+    py::class_<dolfin::HarmonicSmoothing, std::shared_ptr<dolfin::HarmonicSmoothing>>
+      (m, "HarmonicSmoothing")
+      .def(py::init<std::shared_ptr<dolfin::Mesh>>())
+      .def("displace", &dolfin::HarmonicSmoothing::displace)
+      .def("reset", &dolfin::HarmonicSmoothing::reset)
+      .def_static("move", &dolfin::HarmonicSmoothing::move);
+
     // ALE static functions
     py::class_<dolfin::ALE>
       (m, "ALE")
@@ -25,6 +25,7 @@
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/constants.h>
 #include <dolfin/common/defines.h>
+#include <dolfin/common/ScopedTimer.h>
 #include <dolfin/common/SubSystemsManager.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/Variable.h>
@@ -53,6 +54,8 @@ namespace dolfin_wrappers
     m.def("has_debug", &dolfin::has_debug);
     m.def("has_hdf5", &dolfin::has_hdf5);
     m.def("has_hdf5_parallel", &dolfin::has_hdf5_parallel);
+    m.def("has_adios2", &dolfin::has_adios2);
+    m.def("has_ascent", &dolfin::has_ascent);
     m.def("has_mpi", &dolfin::has_mpi);
     m.def("has_parmetis", &dolfin::has_parmetis);
     m.def("has_scotch", &dolfin::has_scotch);
@@ -74,6 +77,13 @@ namespace dolfin_wrappers
       .def("resume", &dolfin::Timer::resume)
       .def("elapsed", &dolfin::Timer::elapsed);
 
+    // dolfin::ScopedTimer
+    py::class_<dolfin::ScopedTimer, std::shared_ptr<dolfin::ScopedTimer>>
+      (m, "ScopedTimer", "Lightweight timer for regions in a call tree")
+      .def(py::init<std::size_t>())
+      .def("stop", &dolfin::ScopedTimer::stop, "Stop timer")
+      .def_static("register_region", &dolfin::ScopedTimer::register_region);
+
     // dolfin::Timer enums
     py::enum_<dolfin::TimingClear>(m, "TimingClear")
       .value("clear", dolfin::TimingClear::clear)
@@ -81,7 +91,11 @@ namespace dolfin_wrappers
     py::enum_<dolfin::TimingType>(m, "TimingType")
       .value("wall", dolfin::TimingType::wall)
       .value("system", dolfin::TimingType::system)
-      .value("user", dolfin::TimingType::user);
+      .value("user", dolfin::TimingType::user)
+      .value("cycles", dolfin::TimingType::cycles)
+      .value("instructions", dolfin::TimingType::instructions)
+      .value("cache_references", dolfin::TimingType::cache_references)
+      .value("cache_misses", dolfin::TimingType::cache_misses);
 
     // dolfin/common free functions
     m.def("timing", &dolfin::timing);
@@ -96,6 +110,15 @@ namespace dolfin_wrappers
             dolfin::list_timings(clear, _type);
           });
     m.def("dump_timings_to_xml", &dolfin::dump_timings_to_xml);
+    m.def("timing_tree", &dolfin::timing_tree);
+    m.def("list_timing_tree", &dolfin::list_timing_tree);
+    m.def("start_timing_trace", &dolfin::start_timing_trace);
+    m.def("stop_timing_trace", &dolfin::stop_timing_trace);
+    m.def("dump_timing_trace", &dolfin::dump_timing_trace);
+    m.def("enable_hardware_counters", &dolfin::enable_hardware_counters);
+    m.def("disable_hardware_counters", &dolfin::disable_hardware_counters);
+    m.def("startup_timings", &dolfin::SubSystemsManager::startup_timings,
+          "Startup phases with wall-clock times (s) since loading of DOLFIN");
 
   }
 
@@ -125,8 +148,12 @@ namespace dolfin_wrappers
 #endif
       .def_static("init", [](){ dolfin::SubSystemsManager::init_mpi(); }, "Initialise MPI")
       .def_static("barrier", &dolfin::MPI::barrier)
+      .def_static("thread_level", &dolfin::SubSystemsManager::mpi_thread_level,
+                  "Level of thread support provided by MPI (-1 if MPI is not initialised)")
       .def_static("rank", &dolfin::MPI::rank)
       .def_static("size", &dolfin::MPI::size)
+      .def_static("split", &dolfin::MPI::split, py::arg("comm"), py::arg("group_size")=0,
+                  "Split communicator into one group per node (group_size=0) or groups of group_size ranks")
       .def_static("local_range", (std::pair<std::int64_t, std::int64_t> (*)(MPI_Comm, std::int64_t))
                   &dolfin::MPI::local_range)
       .def_static("max", &dolfin::MPI::max<double>)
@@ -31,6 +31,7 @@
 #include <dolfin/fem/assemble.h>
 #include <dolfin/fem/assemble_local.h>
 #include <dolfin/fem/Assembler.h>
+#include <dolfin/fem/AssemblyProfile.h>
 #include <dolfin/fem/DirichletBC.h>
 #include <dolfin/fem/DiscreteOperators.h>
 #include <dolfin/fem/DofMap.h>
@@ -39,12 +40,18 @@
 #include <dolfin/fem/LinearVariationalProblem.h>
 #include <dolfin/fem/LinearVariationalSolver.h>
 #include <dolfin/fem/LocalSolver.h>
+#include <dolfin/fem/ErrorNorm.h>
+#include <dolfin/fem/MatrixFreeOperator.h>
+#include <dolfin/fem/MultiFormAssembler.h>
+#include <dolfin/fem/TensorProductOperator.h>
 #include <dolfin/fem/NonlinearVariationalProblem.h>
 #include <dolfin/fem/NonlinearVariationalSolver.h>
 #include <dolfin/fem/PointSource.h>
+#include <dolfin/fem/Projector.h>
 #include <dolfin/fem/SystemAssembler.h>
 #include <dolfin/fem/PETScDMCollection.h>
 #include <dolfin/fem/SparsityPatternBuilder.h>
+#include <dolfin/fem/StaticCondensation.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/function/GenericFunction.h>
 #include <dolfin/mesh/Mesh.h>
@@ -53,6 +60,7 @@
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/la/SparsityPattern.h>
+#include <dolfin/la/VectorSpaceBasis.h>
 
 #include "casters.h"
 
@@ -221,7 +229,10 @@ namespace dolfin_wrappers
       .def(py::init<std::shared_ptr<const ufc::dofmap>, const dolfin::Mesh&>())
       .def(py::init<std::shared_ptr<const ufc::dofmap>, const dolfin::Mesh&, std::shared_ptr<const dolfin::SubDomain>>())
       .def("ownership_range", &dolfin::DofMap::ownership_range)
-      .def("cell_dofs", &dolfin::DofMap::cell_dofs);
+      .def("cell_dofs", &dolfin::DofMap::cell_dofs)
+      .def("memory_usage", &dolfin::DofMap::memory_usage)
+      .def("bandwidth", &dolfin::DofMap::bandwidth)
+      .def("profile", &dolfin::DofMap::profile);
 
     // dolfin::SparsityPatternBuilder
     py::class_<dolfin::SparsityPatternBuilder>(m, "SparsityPatternBuilder")
@@ -251,8 +262,15 @@ namespace dolfin_wrappers
       .def("homogenize", &dolfin::DirichletBC::homogenize)
       .def("method", &dolfin::DirichletBC::method)
       .def("zero", &dolfin::DirichletBC::zero)
-      .def("zero_columns", &dolfin::DirichletBC::zero_columns,
+      .def("zero_columns", (void (dolfin::DirichletBC::*)(dolfin::GenericMatrix&, dolfin::GenericVector&, double) const)
+           &dolfin::DirichletBC::zero_columns,
            py::arg("A"), py::arg("b"), py::arg("diagonal_value")=0.0)
+      .def_static("zero_columns_multiple",
+                  (void (*)(dolfin::GenericMatrix&, dolfin::GenericVector&,
+                            std::vector<std::shared_ptr<const dolfin::DirichletBC>>, double))
+                  &dolfin::DirichletBC::zero_columns,
+                  py::arg("A"), py::arg("b"), py::arg("bcs"),
+                  py::arg("diagonal_value")=0.0)
       .def("get_boundary_values", [](const dolfin::DirichletBC& instance)
            {
              dolfin::DirichletBC::Map map;
@@ -273,18 +291,100 @@ namespace dolfin_wrappers
              self.set_value(_u);
            });
 
+    // dolfin::AssemblyProfile
+    py::class_<dolfin::AssemblyProfile, std::shared_ptr<dolfin::AssemblyProfile>>
+      assembly_profile(m, "AssemblyProfile");
+
+    // dolfin::AssemblyProfile enums
+    py::enum_<dolfin::AssemblyProfile::EntityType>(assembly_profile, "EntityType")
+      .value("cells", dolfin::AssemblyProfile::cells)
+      .value("exterior_facets", dolfin::AssemblyProfile::exterior_facets)
+      .value("interior_facets", dolfin::AssemblyProfile::interior_facets)
+      .value("vertices", dolfin::AssemblyProfile::vertices)
+      .export_values();
+    py::enum_<dolfin::AssemblyProfile::Phase>(assembly_profile, "Phase")
+      .value("update", dolfin::AssemblyProfile::update)
+      .value("tabulate_tensor", dolfin::AssemblyProfile::tabulate_tensor)
+      .value("add_local", dolfin::AssemblyProfile::add_local)
+      .value("apply", dolfin::AssemblyProfile::apply)
+      .export_values();
+
+    assembly_profile.def(py::init<>())
+      .def("enabled", &dolfin::AssemblyProfile::enabled)
+      .def("num_entities", &dolfin::AssemblyProfile::num_entities)
+      .def("time", &dolfin::AssemblyProfile::time)
+      .def("entities_per_second", &dolfin::AssemblyProfile::entities_per_second)
+      .def("table", &dolfin::AssemblyProfile::table)
+      .def("str", &dolfin::AssemblyProfile::str);
+
     // dolfin::AssemblerBase
     py::class_<dolfin::AssemblerBase, std::shared_ptr<dolfin::AssemblerBase>>
       (m, "AssemblerBase")
       .def_readwrite("add_values", &dolfin::Assembler::add_values)
       .def_readwrite("keep_diagonal", &dolfin::Assembler::keep_diagonal)
-      .def_readwrite("finalize_tensor", &dolfin::Assembler::finalize_tensor);
+      .def_readwrite("finalize_tensor", &dolfin::Assembler::finalize_tensor)
+      .def_readwrite("num_threads", &dolfin::Assembler::num_threads)
+      .def_readwrite("coloring_type", &dolfin::Assembler::coloring_type)
+      .def_readwrite("batch_size", &dolfin::Assembler::batch_size)
+      .def_readwrite("cache_element_tensors", &dolfin::Assembler::cache_element_tensors)
+      .def_readwrite("use_assembly_plan", &dolfin::Assembler::use_assembly_plan)
+      .def_readwrite("device_assembly", &dolfin::Assembler::device_assembly)
+      .def_readwrite("approximate_preallocation", &dolfin::Assembler::approximate_preallocation)
+      .def_readwrite("collect_profile", &dolfin::Assembler::collect_profile)
+      .def("profile", &dolfin::AssemblerBase::profile,
+           py::return_value_policy::reference_internal);
 
     // dolfin::Assembler
     py::class_<dolfin::Assembler, std::shared_ptr<dolfin::Assembler>, dolfin::AssemblerBase>
       (m, "Assembler", "DOLFIN Assembler object")
       .def(py::init<>())
-      .def("assemble", &dolfin::Assembler::assemble);
+      .def("assemble", &dolfin::Assembler::assemble,
+           py::call_guard<py::gil_scoped_release>())
+      .def("assemble_diagonal", &dolfin::Assembler::assemble_diagonal,
+           py::arg("d"), py::arg("a"), py::arg("row_sum")=false,
+           py::call_guard<py::gil_scoped_release>());
+
+    // dolfin::MultiFormAssembler
+    py::class_<dolfin::MultiFormAssembler,
+               std::shared_ptr<dolfin::MultiFormAssembler>,
+               dolfin::AssemblerBase>
+      (m, "MultiFormAssembler", "DOLFIN MultiFormAssembler object")
+      .def(py::init<>())
+      .def("add", (void (dolfin::MultiFormAssembler::*)(dolfin::GenericTensor&,
+                                                         const dolfin::Form&))
+           &dolfin::MultiFormAssembler::add,
+           py::keep_alive<1, 2>(), py::keep_alive<1, 3>())
+      .def("num_forms", &dolfin::MultiFormAssembler::num_forms)
+      .def("clear", &dolfin::MultiFormAssembler::clear)
+      .def("assemble", &dolfin::MultiFormAssembler::assemble,
+           py::call_guard<py::gil_scoped_release>())
+      .def("num_shared_restrictions",
+           &dolfin::MultiFormAssembler::num_shared_restrictions);
+
+    // dolfin::MatrixFreeOperator
+    py::class_<dolfin::MatrixFreeOperator, std::shared_ptr<dolfin::MatrixFreeOperator>,
+               dolfin::LinearOperator>
+      (m, "MatrixFreeOperator", "DOLFIN MatrixFreeOperator object")
+      .def(py::init<std::shared_ptr<const dolfin::Form>>())
+      .def("size", &dolfin::MatrixFreeOperator::size)
+      .def("mult", &dolfin::MatrixFreeOperator::mult)
+      .def("get_diagonal", &dolfin::MatrixFreeOperator::get_diagonal)
+      .def("init_vector", &dolfin::MatrixFreeOperator::init_vector);
+
+    // dolfin::TensorProductOperator
+    py::class_<dolfin::TensorProductOperator,
+               std::shared_ptr<dolfin::TensorProductOperator>,
+               dolfin::LinearOperator>
+      (m, "TensorProductOperator", "DOLFIN TensorProductOperator object")
+      .def(py::init<std::shared_ptr<const dolfin::FunctionSpace>, double, double,
+           std::size_t>(), py::arg("V"), py::arg("mass_coefficient"),
+           py::arg("stiffness_coefficient"), py::arg("num_points")=0)
+      .def("size", &dolfin::TensorProductOperator::size)
+      .def("mult", &dolfin::TensorProductOperator::mult)
+      .def("get_diagonal", &dolfin::TensorProductOperator::get_diagonal)
+      .def("init_vector", &dolfin::TensorProductOperator::init_vector)
+      .def("lexicographic_dofs",
+           &dolfin::TensorProductOperator::lexicographic_dofs);
 
     // dolfin::SystemAssembler
     py::class_<dolfin::SystemAssembler, std::shared_ptr<dolfin::SystemAssembler>, dolfin::AssemblerBase>
@@ -292,14 +392,19 @@ namespace dolfin_wrappers
       .def(py::init<std::shared_ptr<const dolfin::Form>, std::shared_ptr<const dolfin::Form>,
            std::vector<std::shared_ptr<const dolfin::DirichletBC>>>())
       .def("assemble", (void (dolfin::SystemAssembler::*)(dolfin::GenericMatrix&, dolfin::GenericVector&))
-           &dolfin::SystemAssembler::assemble)
-      .def("assemble", (void (dolfin::SystemAssembler::*)(dolfin::GenericMatrix&)) &dolfin::SystemAssembler::assemble)
-      .def("assemble", (void (dolfin::SystemAssembler::*)(dolfin::GenericVector&)) &dolfin::SystemAssembler::assemble)
+           &dolfin::SystemAssembler::assemble,
+           py::call_guard<py::gil_scoped_release>())
+      .def("assemble", (void (dolfin::SystemAssembler::*)(dolfin::GenericMatrix&)) &dolfin::SystemAssembler::assemble,
+           py::call_guard<py::gil_scoped_release>())
+      .def("assemble", (void (dolfin::SystemAssembler::*)(dolfin::GenericVector&)) &dolfin::SystemAssembler::assemble,
+           py::call_guard<py::gil_scoped_release>())
       .def("assemble", (void (dolfin::SystemAssembler::*)(dolfin::GenericMatrix&, dolfin::GenericVector&,
                                                           const dolfin::GenericVector&))
-           &dolfin::SystemAssembler::assemble)
+           &dolfin::SystemAssembler::assemble,
+           py::call_guard<py::gil_scoped_release>())
       .def("assemble", (void (dolfin::SystemAssembler::*)(dolfin::GenericVector&, const dolfin::GenericVector&))
-           &dolfin::SystemAssembler::assemble);
+           &dolfin::SystemAssembler::assemble,
+           py::call_guard<py::gil_scoped_release>());
 
     // dolfin::DiscreteOperators
     py::class_<dolfin::DiscreteOperators> (m, "DiscreteOperators")
@@ -309,6 +414,14 @@ namespace dolfin_wrappers
                     auto _V0 = V0.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
                     auto _V1 = V1.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
                     return dolfin::DiscreteOperators::build_gradient(*_V0, *_V1);
+                  })
+      .def_static("build_interpolation_matrix",
+                  &dolfin::DiscreteOperators::build_interpolation_matrix)
+      .def_static("build_interpolation_matrix", [](py::object V0, py::object V1)
+                  {
+                    auto _V0 = V0.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
+                    auto _V1 = V1.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
+                    return dolfin::DiscreteOperators::build_interpolation_matrix(*_V0, *_V1);
                   });
 
     // dolfin::Form
@@ -322,6 +435,9 @@ namespace dolfin_wrappers
            &dolfin::Form::set_coefficient, "Doc")
       .def("set_coefficient", (void (dolfin::Form::*)(std::string, std::shared_ptr<const dolfin::GenericFunction>))
            &dolfin::Form::set_coefficient, "Doc")
+      .def("set_static_coefficient", &dolfin::Form::set_static_coefficient,
+           py::arg("i"), py::arg("is_static")=true)
+      .def("is_static_coefficient", &dolfin::Form::is_static_coefficient)
       .def("set_mesh", &dolfin::Form::set_mesh)
       .def("set_cell_domains", &dolfin::Form::set_cell_domains)
       .def("set_exterior_facet_domains", &dolfin::Form::set_exterior_facet_domains)
@@ -411,7 +527,10 @@ namespace dolfin_wrappers
                std::shared_ptr<dolfin::LinearVariationalSolver>,
                dolfin::Variable>(m, "LinearVariationalSolver")
       .def(py::init<std::shared_ptr<dolfin::LinearVariationalProblem>>())
-      .def("solve", &dolfin::LinearVariationalSolver::solve);
+      .def("solve", &dolfin::LinearVariationalSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
+      .def("num_operator_assemblies",
+           &dolfin::LinearVariationalSolver::num_operator_assemblies);
 
     // dolfin::NonlinearVariationalProblem
     py::class_<dolfin::NonlinearVariationalProblem,
@@ -441,7 +560,8 @@ namespace dolfin_wrappers
                dolfin::Variable>
       (m, "NonlinearVariationalSolver")
       .def(py::init<std::shared_ptr<dolfin::NonlinearVariationalProblem>>())
-      .def("solve", &dolfin::NonlinearVariationalSolver::solve);
+      .def("solve", &dolfin::NonlinearVariationalSolver::solve,
+           py::call_guard<py::gil_scoped_release>());
 
     // dolfin::LocalSolver
     py::class_<dolfin::LocalSolver, std::shared_ptr<dolfin::LocalSolver>>
@@ -459,6 +579,7 @@ namespace dolfin_wrappers
                      dolfin::LocalSolver::SolverType>())
       .def("factorize", &dolfin::LocalSolver::factorize)
       .def("clear_factorization", &dolfin::LocalSolver::clear_factorization)
+      .def("set_factorization_reuse", &dolfin::LocalSolver::set_factorization_reuse)
       .def("solve_local", &dolfin::LocalSolver::solve_local)
       .def("solve_local_rhs", &dolfin::LocalSolver::solve_local_rhs)
       .def("solve_global_rhs", &dolfin::LocalSolver::solve_global_rhs)
@@ -473,6 +594,34 @@ namespace dolfin_wrappers
              self.solve_global_rhs(*_u);
            });
 
+    // dolfin::ErrorNorm
+    py::class_<dolfin::ErrorNorm, std::shared_ptr<dolfin::ErrorNorm>>
+      (m, "ErrorNorm", "DOLFIN ErrorNorm object")
+      .def(py::init<std::shared_ptr<const dolfin::Mesh>, std::size_t>(),
+           py::arg("mesh"), py::arg("quadrature_degree"))
+      .def("compute", &dolfin::ErrorNorm::compute, py::arg("u"),
+           py::arg("uh"), py::arg("norm_type")="L2")
+      .def("num_points", &dolfin::ErrorNorm::num_points);
+
+    // dolfin::Projector
+    py::class_<dolfin::Projector, std::shared_ptr<dolfin::Projector>>
+      (m, "Projector", "DOLFIN Projector object")
+      .def(py::init<std::shared_ptr<const dolfin::Form>, std::string>(),
+           py::arg("a"), py::arg("method")="lu")
+      .def("project", &dolfin::Projector::project)
+      .def("method", &dolfin::Projector::method)
+      .def("num_assemblies", &dolfin::Projector::num_assemblies);
+
+    // dolfin::StaticCondensation
+    py::class_<dolfin::StaticCondensation, std::shared_ptr<dolfin::StaticCondensation>>
+      (m, "StaticCondensation", "DOLFIN StaticCondensation object")
+      .def(py::init<std::shared_ptr<const dolfin::Form>, std::shared_ptr<const dolfin::Form>,
+           std::size_t>(), py::arg("a"), py::arg("L"), py::arg("interior_space")=0)
+      .def("trace_space", &dolfin::StaticCondensation::trace_space)
+      .def("assemble", &dolfin::StaticCondensation::assemble,
+           py::call_guard<py::gil_scoped_release>())
+      .def("backsubstitute", &dolfin::StaticCondensation::backsubstitute);
+
 #ifdef HAS_PETSC
     // dolfin::PETScDMCollection
     py::class_<dolfin::PETScDMCollection, std::shared_ptr<dolfin::PETScDMCollection>>
@@ -488,31 +637,45 @@ namespace dolfin_wrappers
                       }
                       return dolfin::PETScDMCollection(_V);
                     }))
-      .def_static("create_transfer_matrix", &dolfin::PETScDMCollection::create_transfer_matrix)
+      .def_static("create_transfer_matrix",
+                  (std::shared_ptr<dolfin::PETScMatrix> (*)(const dolfin::FunctionSpace&, const dolfin::FunctionSpace&))
+                  &dolfin::PETScDMCollection::create_transfer_matrix)
       .def_static("create_transfer_matrix", [](py::object V_coarse, py::object V_fine)
                   {
                     auto _V0 = V_coarse.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
                     auto _V1 = V_fine.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
                     return dolfin::PETScDMCollection::create_transfer_matrix(*_V0, *_V1);
                   })
+      .def_static("create_transfer_matrix", [](py::object V_coarse, py::object V_fine,
+                                               const std::vector<std::size_t>& parent_cells)
+                  {
+                    auto _V0 = V_coarse.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
+                    auto _V1 = V_fine.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
+                    return dolfin::PETScDMCollection::create_transfer_matrix(*_V0, *_V1, parent_cells);
+                  })
+      .def("transfer_matrix", &dolfin::PETScDMCollection::transfer_matrix)
       .def("check_ref_count", &dolfin::PETScDMCollection::check_ref_count)
       .def("get_dm", &dolfin::PETScDMCollection::get_dm);
 #endif
 
     // Assemble free functions
-    m.def("assemble", (void (*)(dolfin::GenericTensor&, const dolfin::Form&)) &dolfin::assemble);
-    m.def("assemble", (double (*)(const dolfin::Form&)) &dolfin::assemble);
+    m.def("assemble", (void (*)(dolfin::GenericTensor&, const dolfin::Form&)) &dolfin::assemble,
+          py::call_guard<py::gil_scoped_release>());
+    m.def("assemble", (double (*)(const dolfin::Form&)) &dolfin::assemble,
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("assemble_system", (void (*)(dolfin::GenericMatrix&, dolfin::GenericVector&,
                                        const dolfin::Form&, const dolfin::Form&,
                                        std::vector<std::shared_ptr<const dolfin::DirichletBC>>))
-          &dolfin::assemble_system);
+          &dolfin::assemble_system,
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("assemble_system", (void (*)(dolfin::GenericMatrix&, dolfin::GenericVector&,
                                        const dolfin::Form&, const dolfin::Form&,
                                        std::vector<std::shared_ptr<const dolfin::DirichletBC>>,
                                        const dolfin::GenericVector&))
-          &dolfin::assemble_system);
+          &dolfin::assemble_system,
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("assemble_local", [](const dolfin::Form& form, const dolfin::Cell& cell)
           {
@@ -562,5 +725,19 @@ namespace dolfin_wrappers
             const auto _d2v = dolfin::dof_to_vertex_map(*_V);
             return py::array_t<std::size_t>(_d2v.size(), _d2v.data());
           });
+    m.def("rigid_body_modes", [](const dolfin::FunctionSpace& V, bool orthonormalize)
+          { return dolfin::rigid_body_modes(V, orthonormalize); },
+          py::arg("V"), py::arg("orthonormalize")=true);
+    m.def("rigid_body_modes", [](py::object V, bool orthonormalize)
+          {
+            auto _V = V.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
+            return dolfin::rigid_body_modes(*_V, orthonormalize);
+          }, py::arg("V"), py::arg("orthonormalize")=true);
+    m.def("set_rigid_body_near_nullspace", &dolfin::set_rigid_body_near_nullspace);
+    m.def("set_rigid_body_near_nullspace", [](dolfin::GenericMatrix& A, py::object V)
+          {
+            auto _V = V.attr("_cpp_object").cast<dolfin::FunctionSpace*>();
+            dolfin::set_rigid_body_near_nullspace(A, *_V);
+          });
   }
 }
@@ -33,6 +33,10 @@
 #include <dolfin/function/FunctionAXPY.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/function/LagrangeInterpolator.h>
+#include <dolfin/function/LagrangeInterpolationPlan.h>
+#include <dolfin/function/Particles.h>
+#include <dolfin/function/PointEvaluator.h>
+#include <dolfin/function/QuadratureData.h>
 #include <dolfin/function/SpecialFunctions.h>
 #include <dolfin/fem/FiniteElement.h>
 #include <dolfin/fem/GenericDofMap.h>
@@ -102,7 +106,8 @@ namespace dolfin_wrappers
           }, "Create a dolfin::Expression object from a pointer integer, typically returned by a just-in-time compiler");
 
     // dolfin::Expression trampoline (used for overloading virtual
-    // function from Python)
+    // function from Python). The PYBIND11_OVERLOAD macros acquire
+    // the GIL, which is released by the bindings of assemble etc.
     class PyExpression : public dolfin::Expression
     {
       using dolfin::Expression::Expression;
@@ -116,6 +121,13 @@ namespace dolfin_wrappers
                 const ufc::cell& cell) const override
       { PYBIND11_OVERLOAD_NAME(void, dolfin::Expression, "eval_cell", eval, values, x, cell); }
 
+      void eval_points(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> values,
+                       Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> x) const override
+      { PYBIND11_OVERLOAD(void, dolfin::Expression, eval_points, values, x); }
+
+      bool has_eval_points() const override
+      { PYBIND11_OVERLOAD(bool, dolfin::Expression, has_eval_points, ); }
+
     };
 
     // dolfin:Expression
@@ -232,6 +244,16 @@ namespace dolfin_wrappers
             self.eval(_values, x);
             return values;
           })
+      .def("eval_points", [](const dolfin::Function& self,
+                             Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> x,
+                             std::vector<unsigned int> cells)
+           {
+             Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+               values(x.rows(), self.value_size());
+             self.eval(values, x, cells);
+             return py::make_tuple(values, cells);
+           }, py::arg("x"), py::arg("cells")=std::vector<unsigned int>(),
+           "Evaluate Function at a set of points, returning values and containing cells")
       .def("extrapolate", &dolfin::Function::extrapolate)
       .def("extrapolate", [](dolfin::Function& instance, const py::object v)
            {
@@ -358,6 +380,104 @@ namespace dolfin_wrappers
                       throw py::type_error("Can only interpolate Expression or Function");
                   });
 
+    // dolfin::QuadratureData
+    py::class_<dolfin::QuadratureData, std::shared_ptr<dolfin::QuadratureData>,
+               dolfin::GenericFunction>
+      (m, "QuadratureData", "Values at the quadrature points of all cells")
+      .def(py::init<std::shared_ptr<const dolfin::Mesh>, std::size_t>())
+      .def(py::init<std::shared_ptr<const dolfin::Mesh>, std::size_t,
+           std::vector<std::size_t>>())
+      .def("num_points", &dolfin::QuadratureData::num_points)
+      .def("block_size", &dolfin::QuadratureData::block_size)
+      .def("mesh", &dolfin::QuadratureData::mesh)
+      .def("array", [](py::object self)
+           {
+             auto& q = self.cast<dolfin::QuadratureData&>();
+             return py::array_t<double>({q.mesh()->num_cells(), q.block_size()},
+                                        q.values().data(), self);
+           });
+
+    // dolfin::LagrangeInterpolationPlan
+    py::class_<dolfin::LagrangeInterpolationPlan,
+               std::shared_ptr<dolfin::LagrangeInterpolationPlan>>
+      (m, "LagrangeInterpolationPlan", "Reusable interpolation between non-matching meshes")
+      .def(py::init<std::shared_ptr<const dolfin::FunctionSpace>,
+           std::shared_ptr<const dolfin::FunctionSpace>>())
+      .def(py::init([](py::object V, py::object V0)
+           {
+             auto _V = V.attr("_cpp_object").cast<std::shared_ptr<const dolfin::FunctionSpace>>();
+             auto _V0 = V0.attr("_cpp_object").cast<std::shared_ptr<const dolfin::FunctionSpace>>();
+             return dolfin::LagrangeInterpolationPlan(_V, _V0);
+           }))
+      .def("interpolate", [](const dolfin::LagrangeInterpolationPlan& self,
+                             py::object u, py::object u0)
+           {
+             auto _u = u.attr("_cpp_object").cast<dolfin::Function*>();
+             auto _u0 = u0.attr("_cpp_object").cast<const dolfin::Function*>();
+             self.interpolate(*_u, *_u0);
+           });
+
+    // dolfin::PointEvaluator
+    py::class_<dolfin::PointEvaluator, std::shared_ptr<dolfin::PointEvaluator>>
+      (m, "PointEvaluator", "Evaluate Functions at a fixed set of points in parallel")
+      .def(py::init<std::shared_ptr<const dolfin::Mesh>, const std::vector<double>&>())
+      .def("eval", [](const dolfin::PointEvaluator& self, py::object u)
+           {
+             auto _u = u.attr("_cpp_object").cast<const dolfin::Function*>();
+             std::vector<double> values;
+             self.eval(values, *_u);
+             return py::array_t<double>(values.size(), values.data());
+           })
+      .def("num_points", &dolfin::PointEvaluator::num_points);
+
+    // dolfin::Particles
+    py::class_<dolfin::Particles, std::shared_ptr<dolfin::Particles>, dolfin::Variable>
+      (m, "Particles", "Particles on a distributed mesh")
+      .def(py::init<std::shared_ptr<const dolfin::Mesh>>())
+      .def("add_property", &dolfin::Particles::add_property)
+      .def("property", &dolfin::Particles::property)
+      .def("num_properties", &dolfin::Particles::num_properties)
+      .def("value_size", &dolfin::Particles::value_size)
+      .def("add_particles", &dolfin::Particles::add_particles)
+      .def("relocate", &dolfin::Particles::relocate)
+      .def("num_particles", &dolfin::Particles::num_particles)
+      .def("positions", [](const dolfin::Particles& self)
+           {
+             const std::vector<double>& x = self.positions();
+             return py::array_t<double>(x.size(), x.data());
+           })
+      .def("set_positions", [](dolfin::Particles& self, std::vector<double> x)
+           {
+             if (x.size() != self.positions().size())
+               throw py::value_error("Wrong number of coordinates");
+             self.positions() = x;
+           })
+      .def("values", [](const dolfin::Particles& self, std::size_t property)
+           {
+             const std::vector<double>& v = self.values(property);
+             return py::array_t<double>(v.size(), v.data());
+           })
+      .def("set_values", [](dolfin::Particles& self, std::size_t property,
+                            std::vector<double> v)
+           {
+             if (v.size() != self.values(property).size())
+               throw py::value_error("Wrong number of values");
+             self.values(property) = v;
+           })
+      .def("cells", &dolfin::Particles::cells)
+      .def("cell_offsets", &dolfin::Particles::cell_offsets)
+      .def("cell_particles", &dolfin::Particles::cell_particles)
+      .def("interpolate", [](dolfin::Particles& self, py::object u, std::size_t property)
+           {
+             auto _u = u.attr("_cpp_object").cast<const dolfin::Function*>();
+             self.interpolate(*_u, property);
+           })
+      .def("project", [](const dolfin::Particles& self, py::object u, std::size_t property)
+           {
+             auto _u = u.attr("_cpp_object").cast<dolfin::Function*>();
+             self.project(*_u, property);
+           });
+
     // dolfin::FunctionAssigner
     py::class_<dolfin::FunctionAssigner, std::shared_ptr<dolfin::FunctionAssigner>>
       (m, "FunctionAssigner")
@@ -19,6 +19,7 @@
 #include <memory>
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 
 #include <dolfin/geometry/Point.h>
 #include <dolfin/generation/BoxMesh.h>
@@ -26,6 +27,8 @@
 #include <dolfin/generation/UnitCubeMesh.h>
 #include <dolfin/generation/UnitDiscMesh.h>
 #include <dolfin/generation/SphericalShellMesh.h>
+#include <dolfin/generation/StructuredGrid.h>
+#include <dolfin/mesh/Mesh.h>
 #include <dolfin/generation/UnitSquareMesh.h>
 #include <dolfin/generation/UnitIntervalMesh.h>
 #include <dolfin/generation/UnitQuadMesh.h>
@@ -103,5 +106,32 @@ namespace dolfin_wrappers
     py::class_<dolfin::BoxMesh, std::shared_ptr<dolfin::BoxMesh>, dolfin::Mesh>(m, "BoxMesh")
       .def(py::init<const dolfin::Point&, const dolfin::Point&, std::size_t, std::size_t, std::size_t>())
       .def(py::init<MPI_Comm, const dolfin::Point&, const dolfin::Point&, std::size_t, std::size_t, std::size_t>());
+
+    // dolfin::StructuredGrid
+    py::class_<dolfin::StructuredGrid, std::shared_ptr<dolfin::StructuredGrid>>
+      (m, "StructuredGrid", "DOLFIN StructuredGrid object")
+      .def(py::init<MPI_Comm, const dolfin::Point&, const dolfin::Point&, std::size_t, std::size_t,
+           std::size_t, dolfin::CellType::Type>())
+      .def("dim", &dolfin::StructuredGrid::dim)
+      .def("cell_type", &dolfin::StructuredGrid::cell_type)
+      .def("num_vertices", &dolfin::StructuredGrid::num_vertices)
+      .def("num_cells", &dolfin::StructuredGrid::num_cells)
+      .def("vertex", &dolfin::StructuredGrid::vertex)
+      .def("cell_vertices", [](const dolfin::StructuredGrid& self, std::size_t c)
+           {
+             std::vector<std::size_t> vertices;
+             self.cell_vertices(vertices, c);
+             return vertices;
+           })
+      .def("cell_neighbours", [](const dolfin::StructuredGrid& self, std::size_t c)
+           {
+             std::vector<std::size_t> cells;
+             self.cell_neighbours(cells, c);
+             return cells;
+           })
+      .def("locate", &dolfin::StructuredGrid::locate)
+      .def("mesh", &dolfin::StructuredGrid::mesh)
+      .def("has_mesh", &dolfin::StructuredGrid::has_mesh)
+      .def("str", &dolfin::StructuredGrid::str);
   }
 }
@@ -24,9 +24,12 @@
 #include <Eigen/Dense>
 
 #include <dolfin/geometry/intersect.h>
+#include <dolfin/geometry/predicates.h>
+#include <dolfin/geometry/BoundaryDistance.h>
 #include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/geometry/MeshPointIntersection.h>
 #include <dolfin/geometry/Point.h>
+#include <dolfin/function/Function.h>
 #include <dolfin/mesh/Mesh.h>
 
 namespace py = pybind11;
@@ -44,6 +47,8 @@ namespace dolfin_wrappers
            &dolfin::BoundingBoxTree::build)
       .def("build", (void (dolfin::BoundingBoxTree::*)(const dolfin::Mesh&, std::size_t))
            &dolfin::BoundingBoxTree::build)
+      .def("refit", &dolfin::BoundingBoxTree::refit)
+      .def("build_grid", &dolfin::BoundingBoxTree::build_grid)
       .def("compute_collisions", (std::vector<unsigned int> (dolfin::BoundingBoxTree::*)(const dolfin::Point&) const)
            &dolfin::BoundingBoxTree::compute_collisions)
       .def("compute_collisions",
@@ -56,9 +61,44 @@ namespace dolfin_wrappers
            (std::pair<std::vector<unsigned int>, std::vector<unsigned int>>
             (dolfin::BoundingBoxTree::*)(const dolfin::BoundingBoxTree&) const)
             &dolfin::BoundingBoxTree::compute_entity_collisions)
+      .def("compute_distributed_entity_collisions",
+           &dolfin::BoundingBoxTree::compute_distributed_entity_collisions)
       .def("compute_first_collision", &dolfin::BoundingBoxTree::compute_first_collision)
       .def("compute_first_entity_collision", &dolfin::BoundingBoxTree::compute_first_entity_collision)
-      .def("compute_closest_entity", &dolfin::BoundingBoxTree::compute_closest_entity);
+      .def("compute_closest_entity", (std::pair<unsigned int, double> (dolfin::BoundingBoxTree::*)(const dolfin::Point&) const)
+           &dolfin::BoundingBoxTree::compute_closest_entity)
+      .def("compute_closest_entity", (std::pair<unsigned int, double> (dolfin::BoundingBoxTree::*)(const dolfin::Point&, unsigned int) const)
+           &dolfin::BoundingBoxTree::compute_closest_entity);
+
+    // dolfin::BoundaryDistance
+    py::class_<dolfin::BoundaryDistance, std::shared_ptr<dolfin::BoundaryDistance>>
+      (m, "BoundaryDistance")
+      .def(py::init<const dolfin::Mesh&>())
+      .def("compute_distances", [](const dolfin::BoundaryDistance& self,
+                                   const std::vector<double>& points,
+                                   std::vector<unsigned int> facets)
+           {
+             std::vector<double> distances;
+             self.compute_distances(distances, facets, points);
+             return std::make_pair(distances, facets);
+           }, py::arg("points"), py::arg("facets")=std::vector<unsigned int>())
+      .def("compute_closest_points", [](const dolfin::BoundaryDistance& self,
+                                        const std::vector<double>& points,
+                                        std::vector<unsigned int> facets)
+           {
+             std::vector<double> closest_points;
+             self.compute_closest_points(closest_points, facets, points);
+             return std::make_pair(closest_points, facets);
+           }, py::arg("points"), py::arg("facets")=std::vector<unsigned int>())
+      .def("compute", &dolfin::BoundaryDistance::compute)
+      .def("compute", [](const dolfin::BoundaryDistance& self, py::object u)
+           {
+             auto& _u = u.attr("_cpp_object").cast<dolfin::Function&>();
+             self.compute(_u);
+           })
+      .def("compute_vertex_distances", &dolfin::BoundaryDistance::compute_vertex_distances)
+      .def("facet_mesh", &dolfin::BoundaryDistance::facet_mesh,
+           py::return_value_policy::reference_internal);
 
     // dolfin::Point
     py::class_<dolfin::Point>(m, "Point")
@@ -134,6 +174,8 @@ namespace dolfin_wrappers
 
     // dolfin/geometry free functions
     m.def("intersect", &dolfin::intersect);
+    m.def("orient2d", &dolfin::orient2d);
+    m.def("orient3d", &dolfin::orient3d);
 
   }
 }
@@ -22,13 +22,17 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <dolfin/io/ADIOS2File.h>
+#include <dolfin/io/AscentAdaptor.h>
 #include <dolfin/io/File.h>
 #include <dolfin/io/HDF5Attribute.h>
 #include <dolfin/io/HDF5File.h>
 #include <dolfin/io/VTKFile.h>
 #include <dolfin/io/XDMFFile.h>
 #include <dolfin/io/X3DOM.h>
+#include <dolfin/fem/Form.h>
 #include <dolfin/function/Function.h>
+#include <dolfin/function/QuadratureData.h>
 #include <dolfin/geometry/Point.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/mesh/Mesh.h>
@@ -50,30 +54,49 @@ namespace dolfin_wrappers
       .def(py::init<std::string, std::string>())
       .def(py::init<MPI_Comm, std::string>())
       //
-      .def("write", (void (dolfin::File::*)(const dolfin::Parameters&)) &dolfin::File::write)
+      .def("write", (void (dolfin::File::*)(const dolfin::Parameters&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
       //
-      .def("write", (void (dolfin::File::*)(const dolfin::Mesh&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::Mesh&, double)) &dolfin::File::write)
+      .def("write", (void (dolfin::File::*)(const dolfin::Mesh&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::Mesh&, double)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
       //
-      .def("write", (void (dolfin::File::*)(const dolfin::Function&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::Function&, double)) &dolfin::File::write)
+      .def("write", (void (dolfin::File::*)(const dolfin::Function&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::Function&, double)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
        //
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<int>&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<int>&, double)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<std::size_t>&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<std::size_t>&, double)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<double>&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<double>&, double)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<bool>&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<bool>&, double)) &dolfin::File::write)
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<int>&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<int>&, double)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<std::size_t>&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<std::size_t>&, double)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<double>&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<double>&, double)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<bool>&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshFunction<bool>&, double)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
       //
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshValueCollection<int>&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshValueCollection<std::size_t>&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshValueCollection<double>&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::MeshValueCollection<bool>&)) &dolfin::File::write)
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshValueCollection<int>&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshValueCollection<std::size_t>&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshValueCollection<double>&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::MeshValueCollection<bool>&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
       //
-      .def("write", (void (dolfin::File::*)(const dolfin::GenericVector&)) &dolfin::File::write)
-      .def("write", (void (dolfin::File::*)(const dolfin::Table&)) &dolfin::File::write)
+      .def("write", (void (dolfin::File::*)(const dolfin::GenericVector&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::File::*)(const dolfin::Table&)) &dolfin::File::write,
+           py::call_guard<py::gil_scoped_release>())
       // Unpack
       .def("write", [](dolfin::File& instance, py::object u)
            {
@@ -86,22 +109,35 @@ namespace dolfin_wrappers
              instance.write(_u, t);
            })
       // Read
-      .def("read", (void (dolfin::File::*)(dolfin::Parameters&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::Table&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::GenericVector&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::Function&)) &dolfin::File::read)
+      .def("read", (void (dolfin::File::*)(dolfin::Parameters&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::Table&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::GenericVector&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::Function&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
       //
-      .def("read", (void (dolfin::File::*)(dolfin::MeshFunction<bool>&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::MeshFunction<int>&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::MeshFunction<std::size_t>&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::MeshFunction<double>&)) &dolfin::File::read)
+      .def("read", (void (dolfin::File::*)(dolfin::MeshFunction<bool>&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::MeshFunction<int>&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::MeshFunction<std::size_t>&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::MeshFunction<double>&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
       //
-      .def("read", (void (dolfin::File::*)(dolfin::MeshValueCollection<bool>&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::MeshValueCollection<int>&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::MeshValueCollection<std::size_t>&)) &dolfin::File::read)
-      .def("read", (void (dolfin::File::*)(dolfin::MeshValueCollection<double>&)) &dolfin::File::read)
+      .def("read", (void (dolfin::File::*)(dolfin::MeshValueCollection<bool>&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::MeshValueCollection<int>&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::MeshValueCollection<std::size_t>&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::File::*)(dolfin::MeshValueCollection<double>&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>())
       //
-      .def("read", (void (dolfin::File::*)(dolfin::Mesh&)) &dolfin::File::read);
+      .def("read", (void (dolfin::File::*)(dolfin::Mesh&)) &dolfin::File::read,
+           py::call_guard<py::gil_scoped_release>());
 
     // dolfin::VTKFile
     py::class_<dolfin::VTKFile, std::shared_ptr<dolfin::VTKFile>>(m, "VTKFile")
@@ -225,31 +261,49 @@ namespace dolfin_wrappers
       .def("type_str", &dolfin::HDF5Attribute::type_str);
 
     // dolfin::HDF5File
-    py::class_<dolfin::HDF5File, std::shared_ptr<dolfin::HDF5File>> (m, "HDF5File")
+    py::class_<dolfin::HDF5File, std::shared_ptr<dolfin::HDF5File>,
+               dolfin::Variable> (m, "HDF5File")
       .def(py::init<MPI_Comm, std::string, std::string>())
       .def("__enter__", [](dolfin::HDF5File& self){ return &self; })
       .def("__exit__", [](dolfin::HDF5File& self, py::args args, py::kwargs kwargs){ self.close(); })
       .def("close", &dolfin::HDF5File::close)
+      .def("write_distributed_mesh", &dolfin::HDF5File::write_distributed_mesh,
+           py::arg("mesh"), py::arg("name"))
+      .def("read_distributed_mesh", &dolfin::HDF5File::read_distributed_mesh,
+           py::arg("mesh"), py::arg("name"))
       // read
-      .def("read", (void (dolfin::HDF5File::*)(dolfin::Mesh&, std::string, bool) const) &dolfin::HDF5File::read)
+      .def("read", (void (dolfin::HDF5File::*)(dolfin::Mesh&, std::string, bool) const) &dolfin::HDF5File::read,
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::MeshValueCollection<bool>&, std::string) const)
-           &dolfin::HDF5File::read, py::arg("mvc"), py::arg("name"))
+           &dolfin::HDF5File::read, py::arg("mvc"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::MeshValueCollection<std::size_t>&, std::string) const)
-           &dolfin::HDF5File::read, py::arg("mvc"), py::arg("name"))
+           &dolfin::HDF5File::read, py::arg("mvc"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::MeshValueCollection<double>&, std::string) const)
-           &dolfin::HDF5File::read, py::arg("mvc"), py::arg("name"))
+           &dolfin::HDF5File::read, py::arg("mvc"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::MeshFunction<bool>&, std::string) const)
-           &dolfin::HDF5File::read, py::arg("meshfunction"), py::arg("name"))
+           &dolfin::HDF5File::read, py::arg("meshfunction"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::MeshFunction<std::size_t>&, std::string) const)
-           &dolfin::HDF5File::read, py::arg("meshfunction"), py::arg("name"))
+           &dolfin::HDF5File::read, py::arg("meshfunction"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::MeshFunction<int>&, std::string) const)
-           &dolfin::HDF5File::read, py::arg("meshfunction"), py::arg("name"))
+           &dolfin::HDF5File::read, py::arg("meshfunction"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::MeshFunction<double>&, std::string) const)
-           &dolfin::HDF5File::read, py::arg("meshfunction"), py::arg("name"))
+           &dolfin::HDF5File::read, py::arg("meshfunction"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::GenericVector&, std::string, bool) const)
-           &dolfin::HDF5File::read, py::arg("vector"), py::arg("name"), py::arg("use_partitioning"))
+           &dolfin::HDF5File::read, py::arg("vector"), py::arg("name"), py::arg("use_partitioning"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::HDF5File::*)(dolfin::Function&, const std::string))
-           &dolfin::HDF5File::read, py::arg("u"), py::arg("name"))
+           &dolfin::HDF5File::read, py::arg("u"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("read", (void (dolfin::HDF5File::*)(dolfin::QuadratureData&, const std::string) const)
+           &dolfin::HDF5File::read, py::arg("data"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("read", [](dolfin::HDF5File& self, py::object u, std::string name)
            {
              try{
@@ -260,27 +314,41 @@ namespace dolfin_wrappers
              }
            }, py::arg("u"), py::arg("name"))
       // write
-      .def("write", (void (dolfin::HDF5File::*)(const dolfin::Mesh&, std::string)) &dolfin::HDF5File::write)
+      .def("write", (void (dolfin::HDF5File::*)(const dolfin::Mesh&, std::string)) &dolfin::HDF5File::write,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::MeshValueCollection<bool>&, std::string))
-           &dolfin::HDF5File::write, py::arg("mvc"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("mvc"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::MeshValueCollection<std::size_t>&, std::string))
-           &dolfin::HDF5File::write, py::arg("mvc"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("mvc"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::MeshValueCollection<double>&, std::string))
-           &dolfin::HDF5File::write, py::arg("mvc"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("mvc"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::MeshFunction<bool>&, std::string))
-           &dolfin::HDF5File::write, py::arg("meshfunction"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("meshfunction"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::MeshFunction<std::size_t>&, std::string))
-           &dolfin::HDF5File::write, py::arg("meshfunction"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("meshfunction"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::MeshFunction<int>&, std::string))
-           &dolfin::HDF5File::write, py::arg("meshfunction"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("meshfunction"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::MeshFunction<double>&, std::string))
-           &dolfin::HDF5File::write, py::arg("meshfunction"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("meshfunction"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::GenericVector&, std::string))
-           &dolfin::HDF5File::write, py::arg("vector"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("vector"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::Function&, std::string))
-           &dolfin::HDF5File::write, py::arg("u"), py::arg("name"))
+           &dolfin::HDF5File::write, py::arg("u"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", (void (dolfin::HDF5File::*)(const dolfin::QuadratureData&, std::string))
+           &dolfin::HDF5File::write, py::arg("data"), py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::HDF5File::*)(const dolfin::Function&, std::string, double))
-           &dolfin::HDF5File::write, py::arg("u"), py::arg("name"), py::arg("t"))
+           &dolfin::HDF5File::write, py::arg("u"), py::arg("name"), py::arg("t"),
+           py::call_guard<py::gil_scoped_release>())
       .def("write", [](dolfin::HDF5File& self, py::object u, std::string name)
            {
              try{
@@ -306,14 +374,73 @@ namespace dolfin_wrappers
 
 #endif
 
+#ifdef HAS_ADIOS2
+    // dolfin::ADIOS2File
+    py::class_<dolfin::ADIOS2File, std::shared_ptr<dolfin::ADIOS2File>,
+               dolfin::Variable>(m, "ADIOS2File")
+      .def(py::init<MPI_Comm, std::string, std::string>(), py::arg("comm"),
+           py::arg("filename"), py::arg("engine")="BP4")
+      .def("__enter__", [](dolfin::ADIOS2File& self){ return &self; })
+      .def("__exit__", [](dolfin::ADIOS2File& self, py::args args, py::kwargs kwargs){ self.close(); })
+      .def("set_engine_parameter", &dolfin::ADIOS2File::set_engine_parameter)
+      .def("flush", &dolfin::ADIOS2File::flush)
+      .def("close", &dolfin::ADIOS2File::close)
+      .def("num_steps", &dolfin::ADIOS2File::num_steps)
+      .def("write", (void (dolfin::ADIOS2File::*)(const dolfin::Mesh&, double))
+           &dolfin::ADIOS2File::write, py::arg("mesh"), py::arg("t")=0.0)
+      .def("write", (void (dolfin::ADIOS2File::*)(const dolfin::Function&, double))
+           &dolfin::ADIOS2File::write, py::arg("u"), py::arg("t"))
+      .def("write", [](dolfin::ADIOS2File& self, py::object u, double t)
+           {
+             auto _u = u.attr("_cpp_object").cast<dolfin::Function*>();
+             self.write(*_u, t);
+           }, py::arg("u"), py::arg("t"))
+      .def("write", (void (dolfin::ADIOS2File::*)(const dolfin::MeshFunction<bool>&, double))
+           &dolfin::ADIOS2File::write, py::arg("mf"), py::arg("t"))
+      .def("write", (void (dolfin::ADIOS2File::*)(const dolfin::MeshFunction<std::size_t>&, double))
+           &dolfin::ADIOS2File::write, py::arg("mf"), py::arg("t"))
+      .def("write", (void (dolfin::ADIOS2File::*)(const dolfin::MeshFunction<int>&, double))
+           &dolfin::ADIOS2File::write, py::arg("mf"), py::arg("t"))
+      .def("write", (void (dolfin::ADIOS2File::*)(const dolfin::MeshFunction<double>&, double))
+           &dolfin::ADIOS2File::write, py::arg("mf"), py::arg("t"));
+#endif
+
+#ifdef HAS_ASCENT
+    // dolfin::AscentAdaptor
+    py::class_<dolfin::AscentAdaptor, std::shared_ptr<dolfin::AscentAdaptor>,
+               dolfin::Variable>(m, "AscentAdaptor")
+      .def(py::init<MPI_Comm, std::string>(), py::arg("comm"),
+           py::arg("actions_file")="ascent_actions.yaml")
+      .def("__enter__", [](dolfin::AscentAdaptor& self){ return &self; })
+      .def("__exit__", [](dolfin::AscentAdaptor& self, py::args args, py::kwargs kwargs){ self.close(); })
+      .def("set_mesh", &dolfin::AscentAdaptor::set_mesh)
+      .def("add", &dolfin::AscentAdaptor::add)
+      .def("add", [](dolfin::AscentAdaptor& self, py::object u)
+           {
+             auto _u = u.attr("_cpp_object").cast<std::shared_ptr<dolfin::Function>>();
+             self.add(_u);
+           })
+      .def("execute", (void (dolfin::AscentAdaptor::*)(double, std::size_t))
+           &dolfin::AscentAdaptor::execute, py::arg("t"), py::arg("cycle"))
+      .def("execute", (void (dolfin::AscentAdaptor::*)(double, std::size_t, const std::string))
+           &dolfin::AscentAdaptor::execute, py::arg("t"), py::arg("cycle"),
+           py::arg("actions"))
+      .def("close", &dolfin::AscentAdaptor::close);
+#endif
+
     // dolfin::XDMFFile
-    py::class_<dolfin::XDMFFile, std::shared_ptr<dolfin::XDMFFile>> xdmf_file(m, "XDMFFile");
+    py::class_<dolfin::XDMFFile, std::shared_ptr<dolfin::XDMFFile>,
+               dolfin::Variable> xdmf_file(m, "XDMFFile");
 
     xdmf_file
       .def(py::init<MPI_Comm, std::string>())
       .def(py::init<std::string>())
       .def("__enter__", [](dolfin::XDMFFile& self){ return &self; })
-      .def("__exit__", [](dolfin::XDMFFile& self, py::args args, py::kwargs kwargs){ self.close(); });
+      .def("__exit__", [](dolfin::XDMFFile& self, py::args args, py::kwargs kwargs){ self.close(); })
+      .def("close", &dolfin::XDMFFile::close)
+      .def("flush", &dolfin::XDMFFile::flush)
+      .def("add_probe", &dolfin::XDMFFile::add_probe)
+      .def("add_functional", &dolfin::XDMFFile::add_functional);
 
     // dolfin::XDMFFile::Encoding enums
     py::enum_<dolfin::XDMFFile::Encoding>(xdmf_file, "Encoding")
@@ -324,30 +451,41 @@ namespace dolfin_wrappers
     xdmf_file
        // Function
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::Function&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("u"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("u"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::Function&, double, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("u"), py::arg("t"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("u"), py::arg("t"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       // Mesh
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::Mesh&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mesh"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mesh"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       // MeshFunction
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::MeshFunction<bool>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::MeshFunction<std::size_t>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::MeshFunction<int>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::MeshFunction<double>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       // MeshValueCollection
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::MeshValueCollection<bool>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::MeshValueCollection<std::size_t>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::MeshValueCollection<int>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::XDMFFile::*)(const dolfin::MeshValueCollection<double>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("mvc"), py::arg("encoding") = dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       // py:object / dolfin.function.Function
       .def("write", [](dolfin::XDMFFile& instance, const py::object u, dolfin::XDMFFile::Encoding encoding)
            {
@@ -375,10 +513,12 @@ namespace dolfin_wrappers
            }, py::arg("u"), py::arg("t"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5)
       // Points
       .def("write", (void (dolfin::XDMFFile::*)(const std::vector<dolfin::Point>&, dolfin::XDMFFile::Encoding))
-           &dolfin::XDMFFile::write, py::arg("points"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5)
+           &dolfin::XDMFFile::write, py::arg("points"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       .def("write", (void (dolfin::XDMFFile::*)(const std::vector<dolfin::Point>&, const std::vector<double>&,
                                                 dolfin::XDMFFile::Encoding)) &dolfin::XDMFFile::write,
-           py::arg("points"), py::arg("values"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5)
+           py::arg("points"), py::arg("values"), py::arg("encoding")=dolfin::XDMFFile::Encoding::HDF5,
+           py::call_guard<py::gil_scoped_release>())
       // Check points
       .def("write_checkpoint", [](dolfin::XDMFFile& instance, const dolfin::Function& u,
                                   std::string function_name,
@@ -399,25 +539,34 @@ namespace dolfin_wrappers
     // XDFMFile::read
     xdmf_file
       // Mesh
-      .def("read", (void (dolfin::XDMFFile::*)(dolfin::Mesh&) const) &dolfin::XDMFFile::read)
+      .def("read", (void (dolfin::XDMFFile::*)(dolfin::Mesh&) const) &dolfin::XDMFFile::read,
+           py::call_guard<py::gil_scoped_release>())
       // MeshFunction
       .def("read", (void (dolfin::XDMFFile::*)(dolfin::MeshFunction<bool>&, std::string))
-           &dolfin::XDMFFile::read, py::arg("mf"), py::arg("name") = "")
+           &dolfin::XDMFFile::read, py::arg("mf"), py::arg("name") = "",
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::XDMFFile::*)(dolfin::MeshFunction<std::size_t>&, std::string))
-           &dolfin::XDMFFile::read, py::arg("mf"), py::arg("name") = "")
+           &dolfin::XDMFFile::read, py::arg("mf"), py::arg("name") = "",
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::XDMFFile::*)(dolfin::MeshFunction<int>&, std::string))
-           &dolfin::XDMFFile::read, py::arg("mf"), py::arg("name") = "")
+           &dolfin::XDMFFile::read, py::arg("mf"), py::arg("name") = "",
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::XDMFFile::*)(dolfin::MeshFunction<double>&, std::string))
-           &dolfin::XDMFFile::read, py::arg("mf"), py::arg("name") = "")
+           &dolfin::XDMFFile::read, py::arg("mf"), py::arg("name") = "",
+           py::call_guard<py::gil_scoped_release>())
       // MeshValueCollection
       .def("read", (void (dolfin::XDMFFile::*)(dolfin::MeshValueCollection<bool>&, std::string))
-           &dolfin::XDMFFile::read, py::arg("mvc"), py::arg("name") = "")
+           &dolfin::XDMFFile::read, py::arg("mvc"), py::arg("name") = "",
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::XDMFFile::*)(dolfin::MeshValueCollection<std::size_t>&, std::string))
-           &dolfin::XDMFFile::read, py::arg("mvc"), py::arg("name") = "")
+           &dolfin::XDMFFile::read, py::arg("mvc"), py::arg("name") = "",
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::XDMFFile::*)(dolfin::MeshValueCollection<int>&, std::string))
-           &dolfin::XDMFFile::read, py::arg("mvc"), py::arg("name") = "")
+           &dolfin::XDMFFile::read, py::arg("mvc"), py::arg("name") = "",
+           py::call_guard<py::gil_scoped_release>())
       .def("read", (void (dolfin::XDMFFile::*)(dolfin::MeshValueCollection<double>&, std::string))
-           &dolfin::XDMFFile::read, py::arg("mvc"), py::arg("name") = "")
+           &dolfin::XDMFFile::read, py::arg("mvc"), py::arg("name") = "",
+           py::call_guard<py::gil_scoped_release>())
       //
       .def("read_checkpoint", &dolfin::XDMFFile::read_checkpoint, py::arg("u"), py::arg("name"),
            py::arg("counter")=-1)
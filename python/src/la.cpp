@@ -42,12 +42,14 @@
 #include <dolfin/la/TensorLayout.h>
 #include <dolfin/la/DefaultFactory.h>
 #include <dolfin/la/EigenFactory.h>
+#include <dolfin/la/EigenLUSolver.h>
 #include <dolfin/la/EigenMatrix.h>
 #include <dolfin/la/EigenVector.h>
 #include <dolfin/la/PETScKrylovSolver.h>
 #include <dolfin/la/PETScLUSolver.h>
 #include <dolfin/la/PETScFactory.h>
 #include <dolfin/la/PETScMatrix.h>
+#include <dolfin/la/PETScNestMatrix.h>
 #include <dolfin/la/PETScOptions.h>
 #include <dolfin/la/PETScPreconditioner.h>
 #include <dolfin/la/PETScVector.h>
@@ -108,6 +110,8 @@ namespace dolfin_wrappers
       .def("init", &dolfin::SparsityPattern::init)
       .def("apply", &dolfin::SparsityPattern::apply)
       .def("str", &dolfin::SparsityPattern::str)
+      .def("memory_usage", &dolfin::SparsityPattern::memory_usage)
+      .def("block_size", &dolfin::SparsityPattern::block_size)
       .def("num_nonzeros", &dolfin::SparsityPattern::num_nonzeros)
       .def("num_nonzeros_diagonal", [](const dolfin::SparsityPattern& instance)
            {
@@ -166,11 +170,20 @@ namespace dolfin_wrappers
     py::enum_<dolfin::TensorLayout::Ghosts>(tensor_layout, "Ghosts")
       .value("GHOSTED", dolfin::TensorLayout::Ghosts::GHOSTED)
       .value("UNGHOSTED", dolfin::TensorLayout::Ghosts::UNGHOSTED);
+    py::enum_<dolfin::TensorLayout::Blocking>(tensor_layout, "Blocking")
+      .value("BLOCKED", dolfin::TensorLayout::Blocking::BLOCKED)
+      .value("UNBLOCKED", dolfin::TensorLayout::Blocking::UNBLOCKED);
 
     tensor_layout
-      .def(py::init<MPI_Comm, std::size_t, dolfin::TensorLayout::Sparsity>())
+      .def(py::init<MPI_Comm, std::size_t, dolfin::TensorLayout::Sparsity,
+           dolfin::TensorLayout::Blocking>(), py::arg("comm"),
+           py::arg("primary_dim"), py::arg("sparsity_pattern"),
+           py::arg("blocking")=dolfin::TensorLayout::Blocking::UNBLOCKED)
       .def(py::init<MPI_Comm, std::vector<std::shared_ptr<const dolfin::IndexMap>>,
-           std::size_t, dolfin::TensorLayout::Sparsity, dolfin::TensorLayout::Ghosts>())
+           std::size_t, dolfin::TensorLayout::Sparsity, dolfin::TensorLayout::Ghosts,
+           dolfin::TensorLayout::Blocking>(), py::arg("comm"), py::arg("index_maps"),
+           py::arg("primary_dim"), py::arg("sparsity_pattern"), py::arg("ghosted"),
+           py::arg("blocking")=dolfin::TensorLayout::Blocking::UNBLOCKED)
       .def("init", &dolfin::TensorLayout::init)
       .def("sparsity_pattern", (std::shared_ptr<dolfin::SparsityPattern> (dolfin::TensorLayout::*)()) &dolfin::TensorLayout::sparsity_pattern);
 
@@ -190,7 +203,8 @@ namespace dolfin_wrappers
                dolfin::LinearAlgebraObject>
       (m, "GenericTensor", "DOLFIN GenericTensor object")
       .def("init", &dolfin::GenericTensor::init)
-      .def("zero", &dolfin::GenericTensor::zero);
+      .def("zero", &dolfin::GenericTensor::zero)
+      .def("memory_usage", &dolfin::GenericTensor::memory_usage);
 
     // dolfin::GenericMatrix
     py::class_<dolfin::GenericMatrix, std::shared_ptr<dolfin::GenericMatrix>,
@@ -516,6 +530,9 @@ namespace dolfin_wrappers
              return py::array_t<double>(values.size(), values.data());
            })
       .def("axpy", &dolfin::GenericVector::axpy)
+      .def("maxpy", &dolfin::GenericVector::maxpy)
+      .def("mdot", &dolfin::GenericVector::mdot)
+      .def("inner_norm", &dolfin::GenericVector::inner_norm)
       .def("sum", (double (dolfin::GenericVector::*)() const) &dolfin::GenericVector::sum)
       .def("sum", [](const dolfin::GenericVector& self, py::array_t<std::size_t> rows)
            { const dolfin::Array<std::size_t> _rows(rows.size(), rows.mutable_data()); return self.sum(_rows); })
@@ -766,7 +783,51 @@ namespace dolfin_wrappers
       .def("get_options_prefix", &dolfin::PETScMatrix::get_options_prefix)
       .def("set_options_prefix", &dolfin::PETScMatrix::set_options_prefix)
       .def("set_nullspace", &dolfin::PETScMatrix::set_nullspace)
-      .def("set_near_nullspace", &dolfin::PETScMatrix::set_near_nullspace);
+      .def("set_near_nullspace", &dolfin::PETScMatrix::set_near_nullspace)
+      .def("data_view", [](dolfin::PETScMatrix& instance)
+           {
+             typedef Eigen::Matrix<PetscInt, Eigen::Dynamic, 1> VectorXp;
+             auto _data = instance.data();
+             auto m_range = instance.local_range(0);
+             std::size_t nnz = std::get<3>(_data);
+
+             Eigen::Map<const VectorXp> rows(std::get<0>(_data), m_range.second - m_range.first + 1);
+             Eigen::Map<const VectorXp> cols(std::get<1>(_data), nnz);
+             Eigen::Map<const Eigen::VectorXd> values(std::get<2>(_data), nnz);
+
+             return py::make_tuple(rows, cols, values);
+           },
+           py::return_value_policy::reference_internal, "Return CSR matrix data as NumPy arrays (shared data)")
+      .def("data", [](dolfin::PETScMatrix& instance)
+           {
+             typedef Eigen::Matrix<PetscInt, Eigen::Dynamic, 1> VectorXp;
+             auto _data = instance.data();
+             auto m_range = instance.local_range(0);
+             std::size_t nnz = std::get<3>(_data);
+
+             VectorXp rows = Eigen::Map<const VectorXp>(std::get<0>(_data), m_range.second - m_range.first + 1);
+             VectorXp cols = Eigen::Map<const VectorXp>(std::get<1>(_data), nnz);
+             Eigen::VectorXd values  = Eigen::Map<const Eigen::VectorXd>(std::get<2>(_data), nnz);
+
+             return py::make_tuple(rows, cols, values);
+           },
+           py::return_value_policy::copy, "Return copy of CSR matrix data as NumPy arrays");
+
+    // dolfin::PETScNestMatrix
+    py::class_<dolfin::PETScNestMatrix, std::shared_ptr<dolfin::PETScNestMatrix>,
+               dolfin::PETScMatrix>
+      (m, "PETScNestMatrix", "DOLFIN PETScNestMatrix object")
+      .def(py::init<std::vector<std::shared_ptr<const dolfin::GenericMatrix>>, bool>(),
+           py::arg("mats"), py::arg("use_mat_nest")=true)
+      .def("num_blocks", &dolfin::PETScNestMatrix::num_blocks)
+      .def("init_vectors", &dolfin::PETScNestMatrix::init_vectors,
+           py::arg("z"), py::arg("z_sub"), py::arg("dim")=1)
+      .def("get_block_dofs", [](const dolfin::PETScNestMatrix& self, std::size_t idx)
+           {
+             std::vector<dolfin::la_index> dofs;
+             self.get_block_dofs(dofs, idx);
+             return dofs;
+           });
 
     py::class_<dolfin::PETScPreconditioner, std::shared_ptr<dolfin::PETScPreconditioner>>
       (m, "PETScPreconditioner", "DOLFIN PETScPreconditioner object")
@@ -817,11 +878,13 @@ namespace dolfin_wrappers
       .def("set_operators", &dolfin::BelosKrylovSolver::set_operators)
       .def("solve", (std::size_t (dolfin::BelosKrylovSolver::*)
                      (dolfin::GenericVector&, const dolfin::GenericVector&))
-           &dolfin::BelosKrylovSolver::solve)
+           &dolfin::BelosKrylovSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
       .def("solve", (std::size_t (dolfin::BelosKrylovSolver::*)
                      (const dolfin::GenericLinearOperator&,
                       dolfin::GenericVector&, const dolfin::GenericVector&))
-           &dolfin::BelosKrylovSolver::solve);
+           &dolfin::BelosKrylovSolver::solve,
+           py::call_guard<py::gil_scoped_release>());
     #endif
 
     // dolfin::LUSolver
@@ -837,11 +900,31 @@ namespace dolfin_wrappers
       .def("set_operator", &dolfin::LUSolver::set_operator)
       .def("solve", (std::size_t (dolfin::LUSolver::*)(dolfin::GenericVector&,
                                                        const dolfin::GenericVector&))
-           &dolfin::LUSolver::solve)
+           &dolfin::LUSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
       .def("solve", (std::size_t (dolfin::LUSolver::*)(const dolfin::GenericLinearOperator&,
                                                        dolfin::GenericVector&,
                                                        const dolfin::GenericVector&))
-           &dolfin::LUSolver::solve);
+           &dolfin::LUSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
+      .def("solve", (std::size_t (dolfin::LUSolver::*)(const std::vector<std::shared_ptr<dolfin::GenericVector>>&,
+                                                       const std::vector<std::shared_ptr<const dolfin::GenericVector>>&))
+           &dolfin::LUSolver::solve, py::arg("x"), py::arg("b"),
+           py::call_guard<py::gil_scoped_release>());
+
+    // dolfin::EigenLUSolver
+    py::class_<dolfin::EigenLUSolver, std::shared_ptr<dolfin::EigenLUSolver>,
+      dolfin::GenericLinearSolver>
+      (m, "EigenLUSolver", "DOLFIN EigenLUSolver object")
+      .def(py::init<std::string>(), py::arg("method")="default")
+      .def("set_operator", (void (dolfin::EigenLUSolver::*)(std::shared_ptr<const dolfin::GenericLinearOperator>))
+           &dolfin::EigenLUSolver::set_operator)
+      .def("solve", (std::size_t (dolfin::EigenLUSolver::*)(dolfin::GenericVector&,
+                                                            const dolfin::GenericVector&))
+           &dolfin::EigenLUSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
+      .def("num_symbolic_factorizations",
+           &dolfin::EigenLUSolver::num_symbolic_factorizations);
 
     #ifdef HAS_PETSC
     // dolfin::PETScLUSolver
@@ -857,7 +940,12 @@ namespace dolfin_wrappers
       .def("get_options_prefix", &dolfin::PETScLUSolver::get_options_prefix)
       .def("set_options_prefix", &dolfin::PETScLUSolver::set_options_prefix)
       .def("solve", (std::size_t (dolfin::PETScLUSolver::*)(dolfin::GenericVector&, const dolfin::GenericVector&))
-           &dolfin::PETScLUSolver::solve);
+           &dolfin::PETScLUSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
+      .def("solve", (std::size_t (dolfin::PETScLUSolver::*)(const std::vector<std::shared_ptr<dolfin::GenericVector>>&,
+                                                       const std::vector<std::shared_ptr<const dolfin::GenericVector>>&))
+           &dolfin::PETScLUSolver::solve, py::arg("x"), py::arg("b"),
+           py::call_guard<py::gil_scoped_release>());
     #endif
 
     // dolfin::KrylovSolver
@@ -876,7 +964,12 @@ namespace dolfin_wrappers
       .def("set_operators", &dolfin::KrylovSolver::set_operators)
       .def("solve", (std::size_t (dolfin::KrylovSolver::*)(dolfin::GenericVector&,
                                                            const dolfin::GenericVector&))
-           &dolfin::KrylovSolver::solve);
+           &dolfin::KrylovSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
+      .def("solve", (std::size_t (dolfin::KrylovSolver::*)(const std::vector<std::shared_ptr<dolfin::GenericVector>>&,
+                                                       const std::vector<std::shared_ptr<const dolfin::GenericVector>>&))
+           &dolfin::KrylovSolver::solve, py::arg("x"), py::arg("b"),
+           py::call_guard<py::gil_scoped_release>());
 
     #ifdef HAS_PETSC
     // dolfin::PETScKrylovSolver
@@ -900,11 +993,17 @@ namespace dolfin_wrappers
                                                                  std::shared_ptr<const dolfin::GenericLinearOperator>))
            &dolfin::PETScKrylovSolver::set_operators)
       .def("solve", (std::size_t (dolfin::PETScKrylovSolver::*)(dolfin::GenericVector&, const dolfin::GenericVector&))
-           &dolfin::PETScKrylovSolver::solve)
+           &dolfin::PETScKrylovSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
+      .def("solve", (std::size_t (dolfin::PETScKrylovSolver::*)(const std::vector<std::shared_ptr<dolfin::GenericVector>>&,
+                                                       const std::vector<std::shared_ptr<const dolfin::GenericVector>>&))
+           &dolfin::PETScKrylovSolver::solve, py::arg("x"), py::arg("b"),
+           py::call_guard<py::gil_scoped_release>())
       .def("set_from_options", &dolfin::PETScKrylovSolver::set_from_options)
       .def("set_reuse_preconditioner", &dolfin::PETScKrylovSolver::set_reuse_preconditioner)
       .def("set_dm", &dolfin::PETScKrylovSolver::set_dm)
       .def("set_dm_active", &dolfin::PETScKrylovSolver::set_dm_active)
+      .def("pipelined", &dolfin::PETScKrylovSolver::pipelined)
       .def("ksp", &dolfin::PETScKrylovSolver::ksp);
 
     py::enum_<dolfin::PETScKrylovSolver::norm_type>(petsc_ks, "norm_type")
@@ -924,6 +1023,7 @@ namespace dolfin_wrappers
       // constructors. Check the MPI_Comm caster raises appropriate
       // exceptions for pybind11 to move onto next interface.
       .def(py::init<MPI_Comm>())
+      .def("set_operators", &dolfin::SLEPcEigenSolver::set_operators)
       .def("set_options_prefix", &dolfin::SLEPcEigenSolver::set_options_prefix)
       .def("set_from_options", &dolfin::SLEPcEigenSolver::set_from_options)
       .def("get_options_prefix", &dolfin::SLEPcEigenSolver::get_options_prefix)
@@ -931,9 +1031,11 @@ namespace dolfin_wrappers
       .def("set_deflation_space", &dolfin::SLEPcEigenSolver::set_deflation_space)
       .def("set_initial_space", &dolfin::SLEPcEigenSolver::set_initial_space)
       .def("solve", (void (dolfin::SLEPcEigenSolver::*)())
-           &dolfin::SLEPcEigenSolver::solve)
+           &dolfin::SLEPcEigenSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
       .def("solve", (void (dolfin::SLEPcEigenSolver::*)(std::size_t))
-           &dolfin::SLEPcEigenSolver::solve)
+           &dolfin::SLEPcEigenSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_eigenvalue", [](dolfin::SLEPcEigenSolver& self, std::size_t i)
            {
              double lr, lc;
@@ -973,6 +1075,7 @@ namespace dolfin_wrappers
     m.def("solve", (std::size_t (*)(const dolfin::GenericLinearOperator&, dolfin::GenericVector&,
                                     const dolfin::GenericVector&, std::string, std::string)) &dolfin::solve,
           py::arg("A"), py::arg("x"), py::arg("b"), py::arg("method")="lu",
-          py::arg("preconditioner")="none");
+          py::arg("preconditioner")="none",
+          py::call_guard<py::gil_scoped_release>());
   }
 }
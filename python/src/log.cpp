@@ -19,9 +19,12 @@
 #include <string>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/functional.h>
 
 #include <dolfin/common/Variable.h>
 #include <dolfin/log/log.h>
+#include <dolfin/log/MemoryReport.h>
+#include <dolfin/log/SolverTelemetry.h>
 #include <dolfin/log/Table.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/multistage/MultiStageScheme.h>
@@ -36,7 +39,47 @@ namespace dolfin_wrappers
     // dolfin::Table
     py::class_<dolfin::Table, std::shared_ptr<dolfin::Table>>(m, "Table")
       .def(py::init<std::string>())
-      .def("str", &dolfin::Table::str);
+      .def("str", &dolfin::Table::str)
+      .def("get", &dolfin::Table::get)
+      .def("get_value", &dolfin::Table::get_value);
+
+    // dolfin::MemoryReport
+    py::class_<dolfin::MemoryReport, std::shared_ptr<dolfin::MemoryReport>>
+      (m, "MemoryReport", "Memory footprints grouped by subsystem")
+      .def(py::init<>())
+      .def("add", &dolfin::MemoryReport::add)
+      .def("bytes", &dolfin::MemoryReport::bytes)
+      .def("table", &dolfin::MemoryReport::table)
+      .def("list", &dolfin::MemoryReport::list);
+
+    // dolfin::SolverRecord
+    py::class_<dolfin::SolverRecord, std::shared_ptr<dolfin::SolverRecord>>
+      (m, "SolverRecord", "Record of one linear or nonlinear solve")
+      .def_readonly("solver", &dolfin::SolverRecord::solver)
+      .def_readonly("name", &dolfin::SolverRecord::name)
+      .def_readonly("sequence", &dolfin::SolverRecord::sequence)
+      .def_readonly("time", &dolfin::SolverRecord::time)
+      .def_readonly("iterations", &dolfin::SolverRecord::iterations)
+      .def_readonly("linear_iterations", &dolfin::SolverRecord::linear_iterations)
+      .def_readonly("converged", &dolfin::SolverRecord::converged)
+      .def_readonly("reason", &dolfin::SolverRecord::reason)
+      .def_readonly("setup_time", &dolfin::SolverRecord::setup_time)
+      .def_readonly("solve_time", &dolfin::SolverRecord::solve_time)
+      .def_readonly("preconditioner_rebuilt", &dolfin::SolverRecord::preconditioner_rebuilt)
+      .def_readonly("residuals", &dolfin::SolverRecord::residuals);
+
+    // dolfin::SolverTelemetry
+    py::class_<dolfin::SolverTelemetry>
+      (m, "SolverTelemetry", "Structured records of solver convergence and timings")
+      .def_static("enable", &dolfin::SolverTelemetry::enable, py::arg("capacity")=1000)
+      .def_static("disable", &dolfin::SolverTelemetry::disable)
+      .def_static("enabled", &dolfin::SolverTelemetry::enabled)
+      .def_static("add_callback", &dolfin::SolverTelemetry::add_callback)
+      .def_static("remove_callback", &dolfin::SolverTelemetry::remove_callback)
+      .def_static("size", &dolfin::SolverTelemetry::size)
+      .def_static("drain", &dolfin::SolverTelemetry::drain)
+      .def_static("json", &dolfin::SolverTelemetry::json)
+      .def_static("write", &dolfin::SolverTelemetry::write);
 
     // dolfin/log free functions
     m.def("info", [](const dolfin::Variable& v){ dolfin::info(v); });
@@ -27,11 +27,15 @@
 #include <dolfin/mesh/BoundaryMesh.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/MeshColoring.h>
+#include <dolfin/mesh/MeshRenumbering.h>
 #include <dolfin/mesh/MeshData.h>
 #include <dolfin/mesh/MeshEditor.h>
 #include <dolfin/mesh/CellType.h>
 #include <dolfin/mesh/MeshTopology.h>
 #include <dolfin/mesh/MeshGeometry.h>
+#include <dolfin/mesh/MeshGeometryCache.h>
+#include <dolfin/mesh/MeshInteriorFacets.h>
+#include <dolfin/mesh/MeshExteriorFacets.h>
 #include <dolfin/mesh/MeshEntity.h>
 #include <dolfin/mesh/Vertex.h>
 #include <dolfin/mesh/Edge.h>
@@ -42,6 +46,10 @@
 #include <dolfin/mesh/MeshFunction.h>
 #include <dolfin/mesh/MeshValueCollection.h>
 #include <dolfin/mesh/MeshQuality.h>
+#include <dolfin/mesh/DistributedMeshTools.h>
+#include <dolfin/mesh/MeshPartitioning.h>
+#include <dolfin/mesh/MeshRedistribution.h>
+#include <dolfin/function/Function.h>
 #include <dolfin/mesh/SubDomain.h>
 #include <dolfin/mesh/SubMesh.h>
 #include <dolfin/mesh/SubsetIterator.h>
@@ -87,7 +95,11 @@ namespace dolfin_wrappers
     py::class_<dolfin::MeshGeometry, std::shared_ptr<dolfin::MeshGeometry>>
       (m, "MeshGeometry", "DOLFIN MeshGeometry object")
       .def("dim", &dolfin::MeshGeometry::dim, "Geometrical dimension")
-      .def("degree", &dolfin::MeshGeometry::degree, "Degree");
+      .def("degree", &dolfin::MeshGeometry::degree, "Degree")
+      .def("state", &dolfin::MeshGeometry::state, "State counter of coordinates")
+      .def("num_cell_points", &dolfin::MeshGeometry::num_cell_points)
+      .def("cell_points", [](const dolfin::MeshGeometry& self, std::size_t cell)
+           { return py::array_t<unsigned int>(self.num_cell_points(), self.cell_points(cell)); });
 
     // dolfin::MeshTopology class
     py::class_<dolfin::MeshTopology, std::shared_ptr<dolfin::MeshTopology>>
@@ -97,6 +109,9 @@ namespace dolfin_wrappers
            &dolfin::MeshTopology::operator())
       .def("size", &dolfin::MeshTopology::size)
       .def("hash", &dolfin::MeshTopology::hash)
+      .def("state", &dolfin::MeshTopology::state, "State counter of topology")
+      .def("memory_usage", &dolfin::MeshTopology::memory_usage)
+      .def("compress", &dolfin::MeshTopology::compress, py::arg("encode")=false)
       .def("have_global_indices", &dolfin::MeshTopology::have_global_indices)
       .def("ghost_offset", &dolfin::MeshTopology::ghost_offset)
       .def("cell_owner", (const std::vector<unsigned int>& (dolfin::MeshTopology::*)() const) &dolfin::MeshTopology::cell_owner)
@@ -117,6 +132,15 @@ namespace dolfin_wrappers
       .def(py::init<MPI_Comm>())
       .def(py::init<MPI_Comm, std::string>())  // Put MPI constructors last to avoid casting problems
       .def("bounding_box_tree", &dolfin::Mesh::bounding_box_tree)
+      .def("geometry_cache", [](const dolfin::Mesh& self)
+           { return std::const_pointer_cast<dolfin::MeshGeometryCache>(self.geometry_cache()); })
+      .def("interior_facets", [](const dolfin::Mesh& self)
+           { return std::const_pointer_cast<dolfin::MeshInteriorFacets>(self.interior_facets()); })
+      .def("exterior_facets", [](const dolfin::Mesh& self)
+           { return std::const_pointer_cast<dolfin::MeshExteriorFacets>(self.exterior_facets()); })
+      .def("memory_usage", &dolfin::Mesh::memory_usage)
+      .def("set_point_locator", &dolfin::Mesh::set_point_locator)
+      .def("point_locator", &dolfin::Mesh::point_locator)
       .def("cells", [](const dolfin::Mesh& self)
            {
              const unsigned int tdim = self.topology().dim();
@@ -144,10 +168,16 @@ namespace dolfin_wrappers
       .def("hmax", &dolfin::Mesh::hmax)
       .def("hmin", &dolfin::Mesh::hmin)
       .def("id", &dolfin::Mesh::id)
-      .def("init_global", &dolfin::Mesh::init_global)
-      .def("init", (void (dolfin::Mesh::*)() const) &dolfin::Mesh::init)
-      .def("init", (std::size_t (dolfin::Mesh::*)(std::size_t) const) &dolfin::Mesh::init)
-      .def("init", (void (dolfin::Mesh::*)(std::size_t, std::size_t) const) &dolfin::Mesh::init)
+      .def("init_global", &dolfin::Mesh::init_global,
+           py::call_guard<py::gil_scoped_release>())
+      .def("init_cell_points", &dolfin::Mesh::init_cell_points)
+      .def("init", (void (dolfin::Mesh::*)() const) &dolfin::Mesh::init,
+           py::call_guard<py::gil_scoped_release>())
+      .def("init", (std::size_t (dolfin::Mesh::*)(std::size_t) const) &dolfin::Mesh::init,
+           py::call_guard<py::gil_scoped_release>())
+      .def("init", (void (dolfin::Mesh::*)(std::size_t, std::size_t) const) &dolfin::Mesh::init,
+           py::call_guard<py::gil_scoped_release>())
+      .def("clean", &dolfin::Mesh::clean)
       .def("init_cell_orientations", &dolfin::Mesh::init_cell_orientations)
       .def("init_cell_orientations", [](dolfin::Mesh& self, py::object o)
            {
@@ -205,6 +235,54 @@ namespace dolfin_wrappers
       .def(py::init<const dolfin::Mesh&, std::string, bool>(),
            py::arg("mesh"), py::arg("type"), py::arg("order")=true);
 
+    // dolfin::MeshGeometryCache class
+    py::class_<dolfin::MeshGeometryCache, std::shared_ptr<dolfin::MeshGeometryCache>>
+      (m, "MeshGeometryCache", "Cached geometric quantities of a mesh")
+      .def("geometry_state", &dolfin::MeshGeometryCache::geometry_state)
+      .def("topology_state", &dolfin::MeshGeometryCache::topology_state)
+      .def("cell_volumes", [](const dolfin::MeshGeometryCache& self)
+           { auto& a = self.cell_volumes(); return py::array_t<double>(a.size(), a.data()); })
+      .def("cell_circumradii", [](const dolfin::MeshGeometryCache& self)
+           { auto& a = self.cell_circumradii(); return py::array_t<double>(a.size(), a.data()); })
+      .def("cell_radius_ratios", [](const dolfin::MeshGeometryCache& self)
+           { auto& a = self.cell_radius_ratios(); return py::array_t<double>(a.size(), a.data()); })
+      .def("jacobians", [](const dolfin::MeshGeometryCache& self)
+           { auto& a = self.jacobians(); return py::array_t<double>(a.size(), a.data()); })
+      .def("jacobian_determinants", [](const dolfin::MeshGeometryCache& self)
+           { auto& a = self.jacobian_determinants(); return py::array_t<double>(a.size(), a.data()); })
+      .def("facet_areas", [](const dolfin::MeshGeometryCache& self)
+           { auto& a = self.facet_areas(); return py::array_t<double>(a.size(), a.data()); })
+      .def("facet_normals", [](const dolfin::MeshGeometryCache& self)
+           { auto& a = self.facet_normals(); return py::array_t<double>(a.size(), a.data()); })
+      .def("memory_usage", &dolfin::MeshGeometryCache::memory_usage);
+
+    // dolfin::MeshInteriorFacets class
+    py::class_<dolfin::MeshInteriorFacets, std::shared_ptr<dolfin::MeshInteriorFacets>>
+      (m, "MeshInteriorFacets", "Interior facets of a mesh with their cells")
+      .def("topology_state", &dolfin::MeshInteriorFacets::topology_state)
+      .def("size", &dolfin::MeshInteriorFacets::size)
+      .def("facets", [](const dolfin::MeshInteriorFacets& self)
+           { auto& a = self.facets(); return py::array_t<unsigned int>(a.size(), a.data()); })
+      .def("cells", [](const dolfin::MeshInteriorFacets& self)
+           { auto& a = self.cells(); return py::array_t<unsigned int>(a.size(), a.data()); })
+      .def("local_facets", [](const dolfin::MeshInteriorFacets& self)
+           { auto& a = self.local_facets(); return py::array_t<std::uint8_t>(a.size(), a.data()); })
+      .def("owned", [](const dolfin::MeshInteriorFacets& self)
+           { auto& a = self.owned(); return py::array_t<std::uint8_t>(a.size(), a.data()); })
+      .def("position", &dolfin::MeshInteriorFacets::position)
+      .def("memory_usage", &dolfin::MeshInteriorFacets::memory_usage);
+
+    // dolfin::MeshExteriorFacets class
+    py::class_<dolfin::MeshExteriorFacets, std::shared_ptr<dolfin::MeshExteriorFacets>>
+      (m, "MeshExteriorFacets", "Exterior facets of a mesh as cells and local facet indices")
+      .def("topology_state", &dolfin::MeshExteriorFacets::topology_state)
+      .def("size", &dolfin::MeshExteriorFacets::size)
+      .def("cells", [](const dolfin::MeshExteriorFacets& self)
+           { auto& a = self.cells(); return py::array_t<unsigned int>(a.size(), a.data()); })
+      .def("local_facets", [](const dolfin::MeshExteriorFacets& self)
+           { auto& a = self.local_facets(); return py::array_t<std::uint8_t>(a.size(), a.data()); })
+      .def("memory_usage", &dolfin::MeshExteriorFacets::memory_usage);
+
     // dolfin::MeshConnectivity class
     py::class_<dolfin::MeshConnectivity, std::shared_ptr<dolfin::MeshConnectivity>>
       (m, "MeshConnectivity", "DOLFIN MeshConnectivity object")
@@ -214,7 +292,14 @@ namespace dolfin_wrappers
       .def("size", (std::size_t (dolfin::MeshConnectivity::*)() const)
            &dolfin::MeshConnectivity::size)
       .def("size", (std::size_t (dolfin::MeshConnectivity::*)(std::size_t) const)
-           &dolfin::MeshConnectivity::size);
+           &dolfin::MeshConnectivity::size)
+      .def("shares_storage", &dolfin::MeshConnectivity::shares_storage)
+      .def("hash", &dolfin::MeshConnectivity::hash)
+      .def("memory_usage", &dolfin::MeshConnectivity::memory_usage)
+      .def("compress", &dolfin::MeshConnectivity::compress, py::arg("encode")=false)
+      .def("expand", &dolfin::MeshConnectivity::expand)
+      .def("encoded", &dolfin::MeshConnectivity::encoded)
+      .def("valence", &dolfin::MeshConnectivity::valence);
 
     // dolfin::MeshEntity class
     py::class_<dolfin::MeshEntity, std::shared_ptr<dolfin::MeshEntity>>
@@ -374,6 +459,7 @@ namespace dolfin_wrappers
       .def("__len__", &dolfin::MeshFunction<SCALAR>::size) \
       .def("dim", &dolfin::MeshFunction<SCALAR>::dim) \
       .def("size", &dolfin::MeshFunction<SCALAR>::size) \
+      .def("state", &dolfin::MeshFunction<SCALAR>::state) \
       .def("id", &dolfin::MeshFunction<SCALAR>::id) \
       .def("ufl_id", &dolfin::MeshFunction<SCALAR>::id) \
       .def("mesh", &dolfin::MeshFunction<SCALAR>::mesh) \
@@ -458,6 +544,10 @@ namespace dolfin_wrappers
            &dolfin::MeshEditor::add_vertex)
       .def("add_cell", (void (dolfin::MeshEditor::*)(std::size_t, const std::vector<std::size_t>&))
            &dolfin::MeshEditor::add_cell)
+      .def("add_vertices", &dolfin::MeshEditor::add_vertices)
+      .def("add_vertices_global", &dolfin::MeshEditor::add_vertices_global)
+      .def("add_cells", &dolfin::MeshEditor::add_cells)
+      .def("add_cells_global", &dolfin::MeshEditor::add_cells_global)
       .def("close", &dolfin::MeshEditor::close, py::arg("order") = true);
 
     // dolfin::MeshQuality
@@ -471,6 +561,52 @@ namespace dolfin_wrappers
       .def_static("dihedral_angles_min_max", &dolfin::MeshQuality::dihedral_angles_min_max)
       .def_static("dihedral_angles_matplotlib_histogram", &dolfin::MeshQuality::dihedral_angles_matplotlib_histogram);
 
+    // dolfin::DistributedMeshTools
+    py::class_<dolfin::DistributedMeshTools>
+      (m, "DistributedMeshTools", "DOLFIN DistributedMeshTools class")
+      .def_static("partition_diagnostics", &dolfin::DistributedMeshTools::partition_diagnostics)
+      .def_static("partition_report", &dolfin::DistributedMeshTools::partition_report)
+      .def_static("partition_function", &dolfin::DistributedMeshTools::partition_function);
+
+    // dolfin::MeshPartitioning
+    py::class_<dolfin::MeshPartitioning>
+      (m, "MeshPartitioning", "DOLFIN MeshPartitioning class")
+      .def_static("repartition", (std::shared_ptr<dolfin::Mesh> (*)(const dolfin::Mesh&, const std::vector<std::size_t>&, std::size_t))
+                  &dolfin::MeshPartitioning::repartition,
+                  py::arg("mesh"), py::arg("cell_weight"), py::arg("num_cell_weights")=1)
+      .def_static("repartition", (std::shared_ptr<dolfin::Mesh> (*)(const std::vector<std::shared_ptr<const dolfin::MeshFunction<double>>>&))
+                  &dolfin::MeshPartitioning::repartition)
+      .def_static("redistribute", &dolfin::MeshPartitioning::redistribute);
+
+    // dolfin::MeshRedistribution
+    py::class_<dolfin::MeshRedistribution>
+      (m, "MeshRedistribution", "DOLFIN MeshRedistribution class")
+      .def(py::init<std::shared_ptr<const dolfin::Mesh>, const std::vector<int>&>())
+      .def("old_mesh", &dolfin::MeshRedistribution::old_mesh)
+      .def("mesh", &dolfin::MeshRedistribution::mesh)
+      .def("redistribute", [](const dolfin::MeshRedistribution& self,
+                              const dolfin::MeshFunction<std::size_t>& f)
+           { return self.redistribute(f); })
+      .def("redistribute", [](const dolfin::MeshRedistribution& self,
+                              const dolfin::MeshFunction<int>& f)
+           { return self.redistribute(f); })
+      .def("redistribute", [](const dolfin::MeshRedistribution& self,
+                              const dolfin::MeshFunction<double>& f)
+           { return self.redistribute(f); })
+      .def("redistribute", [](const dolfin::MeshRedistribution& self,
+                              const dolfin::MeshFunction<bool>& f)
+           { return self.redistribute(f); })
+      .def("redistribute", [](const dolfin::MeshRedistribution& self,
+                              const dolfin::MeshValueCollection<std::size_t>& c)
+           { return self.redistribute(c); })
+      .def("redistribute", [](const dolfin::MeshRedistribution& self,
+                              py::object u, py::object u_new)
+           {
+             auto _u = u.attr("_cpp_object").cast<dolfin::Function*>();
+             auto _u_new = u_new.attr("_cpp_object").cast<dolfin::Function*>();
+             self.redistribute(*_u, *_u_new);
+           });
+
     // dolfin::SubMesh
     py::class_<dolfin::SubMesh, std::shared_ptr<dolfin::SubMesh>, dolfin::Mesh>
       (m, "SubMesh", "DOLFIN SubMesh")
@@ -479,7 +615,7 @@ namespace dolfin_wrappers
       .def(py::init<const dolfin::Mesh&, const dolfin::MeshFunction<std::size_t>&, std::size_t>());
 
     // dolfin::SubDomain trampoline class for user overloading from
-    // Python
+    // Python (the GIL is acquired by the PYBIND11_OVERLOAD macros)
     class PySubDomain : public dolfin::SubDomain
     {
       using dolfin::SubDomain::SubDomain;
@@ -487,6 +623,11 @@ namespace dolfin_wrappers
       bool inside(Eigen::Ref<const Eigen::VectorXd> x, bool on_boundary) const override
       { PYBIND11_OVERLOAD(bool, dolfin::SubDomain, inside, x, on_boundary); }
 
+      void inside_points(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, 1>> values,
+                         Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> x,
+                         bool on_boundary) const override
+      { PYBIND11_OVERLOAD(void, dolfin::SubDomain, inside_points, values, x, on_boundary); }
+
       void map(Eigen::Ref<const Eigen::VectorXd> x, Eigen::Ref<Eigen::VectorXd> y) const override
       { PYBIND11_OVERLOAD(void, dolfin::SubDomain, map, x, y); }
     };
@@ -529,6 +670,16 @@ namespace dolfin_wrappers
                   &dolfin::MeshColoring::cell_colors)
       .def_static("color_cells", &dolfin::MeshColoring::color_cells);
 
+    // dolfin::MeshRenumbering
+    py::class_<dolfin::MeshRenumbering>(m, "MeshRenumbering")
+      .def_static("renumber_by_color", &dolfin::MeshRenumbering::renumber_by_color)
+      .def_static("reorder_entities", &dolfin::MeshRenumbering::reorder_entities,
+                  py::arg("mesh"), py::arg("method")="rcm")
+      .def_static("reorder_mesh_function", &dolfin::MeshRenumbering::reorder_mesh_function<bool>)
+      .def_static("reorder_mesh_function", &dolfin::MeshRenumbering::reorder_mesh_function<int>)
+      .def_static("reorder_mesh_function", &dolfin::MeshRenumbering::reorder_mesh_function<std::size_t>)
+      .def_static("reorder_mesh_function", &dolfin::MeshRenumbering::reorder_mesh_function<double>);
+
     // dolfin::MeshTransformation
     py::class_<dolfin::MeshTransformation>(m, "MeshTransformation")
       .def_static("translate", &dolfin::MeshTransformation::translate)
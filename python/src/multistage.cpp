@@ -27,6 +27,8 @@
 #include <dolfin/multistage/MultiStageScheme.h>
 #include <dolfin/multistage/PointIntegralSolver.h>
 #include <dolfin/multistage/RKSolver.h>
+#include <dolfin/multistage/TimeStepController.h>
+#include <dolfin/la/GenericVector.h>
 
 namespace py = pybind11;
 
@@ -49,21 +51,43 @@ namespace dolfin_wrappers
            const std::string,
            const std::string,
            std::vector<std::shared_ptr<const dolfin::DirichletBC>>>())
-      .def("order", &dolfin::MultiStageScheme::order);
+      .def("order", &dolfin::MultiStageScheme::order)
+      .def("set_error_weights", &dolfin::MultiStageScheme::set_error_weights)
+      .def("has_error_estimate", &dolfin::MultiStageScheme::has_error_estimate)
+      .def("embedded_order", &dolfin::MultiStageScheme::embedded_order)
+      .def("set_solution_weights", &dolfin::MultiStageScheme::set_solution_weights)
+      .def("solution_weights", &dolfin::MultiStageScheme::solution_weights)
+      .def("set_mass_form", &dolfin::MultiStageScheme::set_mass_form)
+      .def("mass_form", &dolfin::MultiStageScheme::mass_form)
+      .def("error_norm", &dolfin::MultiStageScheme::error_norm);
+
+    // dolfin::TimeStepController
+    py::class_<dolfin::TimeStepController, std::shared_ptr<dolfin::TimeStepController>,
+               dolfin::Variable>
+      (m, "TimeStepController")
+      .def(py::init<unsigned int>())
+      .def("reset", &dolfin::TimeStepController::reset)
+      .def("num_accepted_steps", &dolfin::TimeStepController::num_accepted_steps)
+      .def("num_rejected_steps", &dolfin::TimeStepController::num_rejected_steps);
 
     // dolfin::RKSolver
-    py::class_<dolfin::RKSolver, std::shared_ptr<dolfin::RKSolver>>
+    py::class_<dolfin::RKSolver, std::shared_ptr<dolfin::RKSolver>, dolfin::Variable>
       (m, "RKSolver")
       .def(py::init<std::shared_ptr<dolfin::MultiStageScheme>>())
-      .def("step_interval", &dolfin::RKSolver::step_interval);
+      .def("step", &dolfin::RKSolver::step)
+      .def("step_interval", &dolfin::RKSolver::step_interval)
+      .def("num_steps", &dolfin::RKSolver::num_steps);
 
     // dolfin::PointIntegralSolver
-    py::class_<dolfin::PointIntegralSolver, std::shared_ptr<dolfin::PointIntegralSolver>>
+    py::class_<dolfin::PointIntegralSolver, std::shared_ptr<dolfin::PointIntegralSolver>,
+               dolfin::Variable>
       (m, "PointIntegralSolver")
       .def(py::init<std::shared_ptr<dolfin::MultiStageScheme>>())
       .def("reset_newton_solver", &dolfin::PointIntegralSolver::reset_newton_solver)
       .def("reset_stage_solutions", &dolfin::PointIntegralSolver::reset_stage_solutions)
       .def("step", &dolfin::PointIntegralSolver::step)
-      .def("step_interval", &dolfin::PointIntegralSolver::step_interval);
+      .def("step_interval", &dolfin::PointIntegralSolver::step_interval)
+      .def("num_jacobian_computations", &dolfin::PointIntegralSolver::num_jacobian_computations)
+      .def("num_steps", &dolfin::PointIntegralSolver::num_steps);
   }
 }
@@ -96,7 +96,11 @@ namespace dolfin_wrappers
                dolfin::Variable>(m, "NewtonSolver")
       .def(py::init<>())
       .def(py::init<MPI_Comm>())
-      .def("solve", &dolfin::NewtonSolver::solve)
+      .def("solve", &dolfin::NewtonSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
+      .def("iteration", &dolfin::NewtonSolver::iteration)
+      .def("krylov_iterations", &dolfin::NewtonSolver::krylov_iterations)
+      .def("jacobian_assemblies", &dolfin::NewtonSolver::jacobian_assemblies)
       .def("converged", &PyPublicNewtonSolver::converged)
       .def("solver_setup", &PyPublicNewtonSolver::solver_setup)
       .def("update_solution", &PyPublicNewtonSolver::update_solution);
@@ -110,7 +114,8 @@ namespace dolfin_wrappers
       .def_readwrite("parameters", &dolfin::PETScSNESSolver::parameters)
       .def("solve", (std::pair<std::size_t, bool> (dolfin::PETScSNESSolver::*)(dolfin::NonlinearProblem&,
                                                                                dolfin::GenericVector&))
-           &dolfin::PETScSNESSolver::solve);
+           &dolfin::PETScSNESSolver::solve,
+           py::call_guard<py::gil_scoped_release>());
 
     // dolfin::TAOLinearBoundSolver
     py::class_<dolfin::TAOLinearBoundSolver>(m, "TAOLinearBoundSolver")
@@ -121,7 +126,8 @@ namespace dolfin_wrappers
                      (const dolfin::GenericMatrix&, dolfin::GenericVector&,
                       const dolfin::GenericVector&, const dolfin::GenericVector&,
                       const dolfin::GenericVector&))
-           &dolfin::TAOLinearBoundSolver::solve);
+           &dolfin::TAOLinearBoundSolver::solve,
+           py::call_guard<py::gil_scoped_release>());
 
     // dolfin::PETScTAOSolver
     py::class_<dolfin::PETScTAOSolver, std::shared_ptr<dolfin::PETScTAOSolver>, dolfin::PETScObject>(m, "PETScTAOSolver")
@@ -133,10 +139,12 @@ namespace dolfin_wrappers
            py::arg("ksp_type")="default", py::arg("pc_type")="default")
       .def_readwrite("parameters", &dolfin::PETScTAOSolver::parameters)
       .def("solve", (std::pair<std::size_t, bool> (dolfin::PETScTAOSolver::*)(dolfin::OptimisationProblem&, dolfin::GenericVector&))
-           &dolfin::PETScTAOSolver::solve)
+           &dolfin::PETScTAOSolver::solve,
+           py::call_guard<py::gil_scoped_release>())
       .def("solve", (std::pair<std::size_t, bool> (dolfin::PETScTAOSolver::*)(dolfin::OptimisationProblem&, dolfin::GenericVector&,
                                                                               const dolfin::GenericVector&, const dolfin::GenericVector&))
-           &dolfin::PETScTAOSolver::solve);
+           &dolfin::PETScTAOSolver::solve,
+           py::call_guard<py::gil_scoped_release>());
 #endif
 
     // dolfin::NonlinearProblem 'trampoline' for overloading from
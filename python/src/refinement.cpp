@@ -28,8 +28,10 @@ namespace dolfin_wrappers
   {
     // dolfin/refinement free functions
     m.def("refine", (dolfin::Mesh (*)(const dolfin::Mesh&, bool)) &dolfin::refine,
-          py::arg("mesh"), py::arg("redistribute")=true);
+          py::arg("mesh"), py::arg("redistribute")=true,
+          py::call_guard<py::gil_scoped_release>());
     m.def("refine", (dolfin::Mesh (*)(const dolfin::Mesh&, const dolfin::MeshFunction<bool>&, bool))
-          &dolfin::refine, py::arg("mesh"), py::arg("marker"), py::arg("redistribute")=true);
+          &dolfin::refine, py::arg("mesh"), py::arg("marker"), py::arg("redistribute")=true,
+          py::call_guard<py::gil_scoped_release>());
   }
 }
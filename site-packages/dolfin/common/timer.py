@@ -21,7 +21,7 @@ import functools
 
 from dolfin import cpp
 
-__all__ = ["Timer", "timed"]
+__all__ = ["Timer", "ScopedTimer", "timed"]
 
 
 class Timer(cpp.Timer):
@@ -62,6 +62,26 @@ class Timer(cpp.Timer):
         self.stop()
 
 
+class ScopedTimer(cpp.ScopedTimer):
+    """A lightweight timer for regions which are entered often.
+    Regions are registered once by name and timed by id::
+
+        region = ScopedTimer.register_region("Some costly operation")
+        with ScopedTimer(region):
+            costly_call()
+
+    Regions timed within other regions are recorded as children, and
+    a summary of the resulting call tree may be printed using
+    ``list_timing_tree`` or obtained using ``timing_tree``.
+    """
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.stop()
+
+
 def timed(task):
     """Decorator for timing functions. Usage::
 
@@ -53,7 +53,7 @@ public:
   {
 %(evalcode)s
   }
-};
+%(evalcode_block)s};
 """
 
 def flatten_and_check_expression(expr):
@@ -145,9 +145,29 @@ def expression_to_dolfin_expression(expr, generic_function_members, mesh_functio
         evalcode.append("                   \"Need cell to evaluate this Expression\");")
         evalcode = "\n".join(evalcode)
 
+    # Evaluate all points of a cell in one loop if the expression
+    # only depends on the coordinates
+    evalcode_block = ""
+    if not generic_function_members and not mesh_function_members:
+        evalcode_block = [
+            "",
+            "  void eval_block(Eigen::Ref<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> > _values,",
+            "                  Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> > _x,",
+            "                  const ufc::cell& cell) const",
+            "  {",
+            "    for (Eigen::Index _i = 0; _i < _x.rows(); ++_i)",
+            "    {",
+            "      const double* x = _x.row(_i).data();",
+            "      double* values = _values.row(_i).data();"]
+        evalcode_block.extend("      values[%d] = %s;" % (i, c)
+                              for i, c in enumerate(expr))
+        evalcode_block.extend(["    }", "  }"])
+        evalcode_block = "\n".join(evalcode_block)
+
     # Connect the code fragments using the expression template code
     fragments["evalcode"]  = evalcode
     fragments["evalcode_cell"]  = evalcode_cell
+    fragments["evalcode_block"]  = evalcode_block
     fragments["value_shape"] = "\n".join(value_shape_code)
 
     # Assign classname
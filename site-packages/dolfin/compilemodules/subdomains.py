@@ -50,6 +50,12 @@ public:
     %(inside)s
   }
 
+  /// Return true (inside can be evaluated by several threads)
+  bool thread_safe() const
+  {
+    return true;
+  }
+
 };
 """
 
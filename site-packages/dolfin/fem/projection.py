@@ -34,8 +34,9 @@ from dolfin.functions.multimeshfunction import *
 from dolfin.functions.expression import *
 from dolfin.functions.functionspace import *
 from dolfin.fem.assembling import *
+from dolfin.fem.form import Form
 
-__all__ = ['project']
+__all__ = ['project', 'Projector']
 
 
 def project(v, V=None, bcs=None, mesh=None,
@@ -149,6 +150,58 @@ def project(v, V=None, bcs=None, mesh=None,
     return function
 
 
+class Projector(object):
+    """Projector onto a fixed finite element space *V*, keeping the
+    mass matrix and its factorization between projections.
+
+    *Arguments*
+        V
+            a :py:class:`FunctionSpace
+            <dolfin.functions.functionspace.FunctionSpace>`
+        method
+            "lu" (factorized mass matrix), "lumped" (row-sum lumped
+            mass matrix) or "local" (cell-wise solves, exact for
+            discontinuous spaces).
+        form_compiler_parameters
+            see :py:class:`Parameters <dolfin.cpp.Parameters>` for more
+            information.
+
+    *Example of usage*
+
+        .. code-block:: python
+
+            projector = Projector(V)
+            for t in times:
+                ...
+                projector.project(sigma, function=s)
+
+    """
+
+    def __init__(self, V, method="lu", form_compiler_parameters=None):
+        self._V = V
+        self._form_compiler_parameters = form_compiler_parameters
+        w = TestFunction(V)
+        Pv = TrialFunction(V)
+        a = ufl.inner(w, Pv)*ufl.dx(V.mesh())
+        self._a = Form(a, form_compiler_parameters=form_compiler_parameters)
+        self._cpp_object = cpp.Projector(self._a, method)
+
+    def project(self, v, function=None):
+        """Return projection of *v* onto the finite element space of
+        the projector (in *function* if given)."""
+        w = TestFunction(self._V)
+        L = ufl.inner(w, v)*ufl.dx(self._V.mesh())
+        L = Form(L, form_compiler_parameters=self._form_compiler_parameters)
+        if function is None:
+            function = Function(self._V)
+        self._cpp_object.project(function, L)
+        return function
+
+    def num_assemblies(self):
+        "Return number of times the mass matrix has been assembled"
+        return self._cpp_object.num_assemblies()
+
+
 def _extract_function_space(expression, mesh):
     """Try to extract a suitable function space for projection of
     given expression."""
@@ -634,7 +634,8 @@ class ButcherMultiStageScheme(MultiStageScheme):
     Base class for all MultiStageSchemes
     """
     def __init__(self, rhs_form, solution, time, bcs, a, b, c, order,
-                 generator=_butcher_scheme_generator):
+                 generator=_butcher_scheme_generator, b_hat=None,
+                 embedded_order=None):
         bcs = bcs or []
         time = time or Constant(0.0)
         ufl_stage_forms, dolfin_stage_forms, jacobian_indices, last_stage, \
@@ -653,6 +654,26 @@ class ButcherMultiStageScheme(MultiStageScheme):
                                   self.__class__.__name__, human_form,
                                   bcs, contraction)
 
+        # Weights of the embedded error estimate, if any
+        self.b_hat = b_hat
+        if b_hat is not None:
+            self.set_error_weights([float(w) for w in b - b_hat],
+                                   embedded_order)
+
+        # The last stage of the forward scheme is u + dt*sum_i b_i k_i,
+        # which the RKSolver can compute without assembly for vertex
+        # integrals, or with a lumped mass for cell integrals
+        if generator is _butcher_scheme_generator and len(b.shape) == 1:
+            DX = _check_form(rhs_form)
+            v = rhs_form.arguments()[0]
+            u = ufl.TrialFunction(v.ufl_function_space())
+            if DX is ufl.dP:
+                self.set_solution_weights([float(bi) for bi in b])
+            elif all(a[i, i] == 0 for i in range(a.shape[0])):
+                self._mass_form = Form(ufl.inner(u, v)*DX)
+                self.set_solution_weights([float(bi) for bi in b])
+                self.set_mass_form(self._mass_form)
+
     def to_tlm(self, perturbation):
         r"""
         Return another MultiStageScheme that implements the tangent
@@ -749,6 +770,24 @@ class ERK4(ButcherMultiStageScheme):
         ButcherMultiStageScheme.__init__(self, rhs_form, solution, t, bcs, a, b, c, 4)
 
 
+class BS3(ButcherMultiStageScheme):
+    """
+    Explicit 3rd order Bogacki-Shampine scheme with an embedded 2nd
+    order solution for adaptive time stepping
+    """
+    def __init__(self, rhs_form, solution, t=None, bcs=None):
+        a = np.array([[0, 0, 0, 0],
+                      [0.5, 0, 0, 0],
+                      [0, 0.75, 0, 0],
+                      [2./9, 1./3, 4./9, 0]])
+        b = np.array([2./9, 1./3, 4./9, 0])
+        b_hat = np.array([7./24, 1./4, 1./3, 1./8])
+        c = np.array([0, 0.5, 0.75, 1])
+        ButcherMultiStageScheme.__init__(self, rhs_form, solution, t, bcs,
+                                         a, b, c, 3, b_hat=b_hat,
+                                         embedded_order=2)
+
+
 class ESDIRK3(ButcherMultiStageScheme):
     """Explicit implicit 3rd order scheme
 
@@ -764,7 +803,11 @@ class ESDIRK3(ButcherMultiStageScheme):
                       [0.308809969973036,   1.490563388254108,  -1.235239879727145,   0.435866521500000 ]])
         b = a[-1,:].copy()
         c = a.sum(1)
-        ButcherMultiStageScheme.__init__(self, rhs_form, solution, t, bcs, a, b, c, 3)
+
+        # The second to last stage is an embedded 2nd order solution
+        b_hat = a[-2,:].copy()
+        ButcherMultiStageScheme.__init__(self, rhs_form, solution, t, bcs, a, b, c, 3,
+                                         b_hat=b_hat, embedded_order=2)
 
 
 class ESDIRK4(ButcherMultiStageScheme):
@@ -785,7 +828,11 @@ class ESDIRK4(ButcherMultiStageScheme):
 
         b = a[-1,:].copy()
         c = a.sum(1)
-        ButcherMultiStageScheme.__init__(self, rhs_form, solution, t, bcs, a, b, c, 4)
+
+        # The second to last stage is an embedded 3rd order solution
+        b_hat = a[-2,:].copy()
+        ButcherMultiStageScheme.__init__(self, rhs_form, solution, t, bcs, a, b, c, 4,
+                                         b_hat=b_hat, embedded_order=3)
 
 
 # Aliases
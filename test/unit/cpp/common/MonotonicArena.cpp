@@ -0,0 +1,85 @@
+// Copyright (C) 2017 The FEniCS Project
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Unit tests for MonotonicArena and ArenaAllocator
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+#include <dolfin/common/MonotonicArena.h>
+#include <gtest/gtest.h>
+
+using namespace dolfin;
+
+//-----------------------------------------------------------------------------
+TEST(MonotonicArenaTest, testAlignment)
+{
+  MonotonicArena arena(1024);
+  for (std::size_t i = 1; i < 100; ++i)
+  {
+    arena.allocate(i, 1);
+    void* p = arena.allocate(8, alignof(double));
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignof(double),
+              (std::uintptr_t) 0);
+  }
+}
+//-----------------------------------------------------------------------------
+TEST(MonotonicArenaTest, testContainers)
+{
+  MonotonicArena arena(1024);
+
+  typedef std::vector<int, ArenaAllocator<int>> Vector;
+  std::map<int, Vector, std::less<int>,
+           ArenaAllocator<std::pair<const int, Vector>>> map(arena);
+  std::set<int, std::less<int>, ArenaAllocator<int>> set(arena);
+  for (int i = 0; i < 10000; ++i)
+  {
+    map.insert({i % 100, Vector(arena)}).first->second.push_back(i);
+    set.insert(i % 321);
+  }
+
+  ASSERT_EQ(map.size(), (std::size_t) 100);
+  ASSERT_EQ(map.find(7)->second.size(), (std::size_t) 100);
+  ASSERT_EQ(map.find(7)->second.back(), 9907);
+  ASSERT_EQ(set.size(), (std::size_t) 321);
+
+  // Blocks grow geometrically
+  ASSERT_GT(arena.capacity(), (std::size_t) 1024);
+  ASSERT_LT(arena.num_blocks(), (std::size_t) 20);
+}
+//-----------------------------------------------------------------------------
+TEST(MonotonicArenaTest, testRelease)
+{
+  MonotonicArena arena(1024);
+  for (int i = 0; i < 100; ++i)
+  {
+    {
+      std::vector<double, ArenaAllocator<double>> x(arena);
+      x.reserve(1000);
+      x.assign(1000, 1.0);
+      ASSERT_EQ(x[999], 1.0);
+    }
+    arena.release();
+
+    // Largest block is kept and reused
+    ASSERT_EQ(arena.num_blocks(), (std::size_t) 1);
+  }
+  ASSERT_GE(arena.capacity(), 1000*sizeof(double));
+}
+//-----------------------------------------------------------------------------
@@ -134,6 +134,29 @@ TEST(MeshIterators, testMixedIterators)
   ASSERT_EQ(n, 4*mesh.num_cells());
 }
 //-----------------------------------------------------------------------------
+TEST(MeshIterators, testCellVertexView)
+{
+  // Compare cell-vertex view with iterators
+  UnitCubeMesh mesh(3, 3, 3);
+  const CellVertexView view(mesh);
+  ASSERT_EQ(view.ghost_offset(), mesh.num_cells());
+  ASSERT_EQ(view.gdim(), mesh.geometry().dim());
+
+  std::vector<double> coordinate_dofs, view_coordinate_dofs(4*3);
+  for (CellIterator c(mesh); !c.end(); ++c)
+  {
+    const ArrayView<const unsigned int> vertices = view.vertices(c->index());
+    ASSERT_EQ(vertices.size(), c->num_vertices());
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+      ASSERT_EQ(vertices[i], c->entities(0)[i]);
+
+    c->get_coordinate_dofs(coordinate_dofs);
+    view.get_coordinate_dofs(c->index(), view_coordinate_dofs.data());
+    for (std::size_t i = 0; i < coordinate_dofs.size(); ++i)
+      ASSERT_EQ(view_coordinate_dofs[i], coordinate_dofs[i]);
+  }
+}
+//-----------------------------------------------------------------------------
 TEST(BoundaryExtraction, testBoundaryComputation)
 {
   // Compute boundary of mesh
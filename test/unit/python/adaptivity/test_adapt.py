@@ -0,0 +1,51 @@
+#!/usr/bin/env py.test
+
+"""Unit tests for adapt() of functions"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import pytest
+from dolfin import *
+from dolfin_utils.test import skip_in_parallel, skip_if_pybind11
+
+
+@skip_in_parallel
+@skip_if_pybind11(reason="adapt not wrapped in pybind11")
+@pytest.mark.parametrize("family, degree", [("CG", 2), ("DG", 1), ("N1curl", 1)])
+def test_adapt_function(family, degree):
+    mesh = UnitSquareMesh(4, 4)
+    markers = CellFunction("bool", mesh, False)
+    markers[0] = True
+    markers[5] = True
+    adapted_mesh = adapt(mesh, markers)
+
+    V = FunctionSpace(mesh, family, degree)
+    if family == "N1curl":
+        f = Expression(("1.0 + x[1]", "2.0 - x[0]"), degree=1)
+    else:
+        f = Expression("x[0]*x[0] + x[0]*x[1]", degree=2)
+    u = interpolate(f, V)
+    v = Function(V)
+    v.vector()[:] = 2.0*u.vector().get_local()
+
+    # Functions in the same space are transferred with the same cell
+    # matrices, which reproduce functions of the parent space
+    u_a = adapt(u, adapted_mesh)
+    v_a = adapt(v, adapted_mesh)
+    assert round(errornorm(f, u_a, degree_rise=1), 10) == 0
+    assert round(errornorm(u_a, v_a, degree_rise=0) - norm(u_a), 10) == 0
@@ -0,0 +1,67 @@
+#!/usr/bin/env py.test
+
+"""Unit tests for the Checkpointer class"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import os
+import pytest
+from dolfin import *
+from dolfin_utils.test import skip_if_not_HDF5, tempdir
+
+
+def _run_schedule(checkpointer, num_steps):
+    "Run adjoint sweep with forward state x[:] = step"
+    Action = Checkpointer.Action
+    x = Vector(mpi_comm_world(), 8)
+    reversed_steps = []
+    while True:
+        action = checkpointer.next()
+        step = checkpointer.current_step()
+        if action == Action.advance:
+            assert round(x.max() - step, 12) == 0
+            x[:] = float(checkpointer.target_step())
+        elif action == Action.store:
+            checkpointer.store(x)
+        elif action == Action.restore:
+            x[:] = -1.0
+            checkpointer.restore(x)
+            assert round(x.max() - step, 12) == 0
+        elif action in (Action.first_adjoint, Action.adjoint):
+            assert round(x.max() - step, 12) == 0
+            reversed_steps.append(step)
+        else:
+            assert action == Action.terminate
+            break
+    assert reversed_steps == list(reversed(range(num_steps)))
+
+
+@pytest.mark.parametrize("num_steps, num_checkpoints, num_forward",
+                         [(10, 1, 45), (10, 3, 15), (20, 20, 19)])
+def test_memory_schedule(num_steps, num_checkpoints, num_forward):
+    checkpointer = Checkpointer(mpi_comm_world(), num_steps, num_checkpoints)
+    _run_schedule(checkpointer, num_steps)
+    assert checkpointer.num_forward_steps() == num_forward
+
+
+@skip_if_not_HDF5
+def test_disk_schedule(tempdir):
+    filename = os.path.join(tempdir, "checkpoints.h5")
+    checkpointer = Checkpointer(mpi_comm_world(), 30, 2, 2, filename)
+    assert checkpointer.on_disk(0) and not checkpointer.on_disk(2)
+    _run_schedule(checkpointer, 30)
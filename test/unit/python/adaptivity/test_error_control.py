@@ -108,6 +108,20 @@ def test_error_estimation(problem, u, ec):
     assert round(error_estimate - reference, 7) == 0
 
 
+@skip_in_parallel
+def test_repeated_error_estimation(problem, u, ec):
+
+    solver = LinearVariationalSolver(problem)
+    solver.solve()
+
+    # Dual solver (with factorization reuse) is kept between calls
+    ec.parameters["dual_variational_solver"]["linear_solver"] = "lu"
+    ec.parameters["dual_variational_solver"]["lu_solver"]["reuse_policy"] = "steps"
+    first = ec.estimate_error(u, problem.bcs())
+    second = ec.estimate_error(u, problem.bcs())
+    assert round(first - second, 10) == 0
+
+
 @skip_in_parallel
 def test_error_indicators(problem, u, mesh):
 
@@ -140,3 +154,19 @@ def _test_adaptive_solve(problem, goal, u, mesh):
     # Compare computed goal with reference
     reference = 0.12583303389560166
     assert round(assemble(M) - reference, 7) == 0
+
+
+@skip_in_parallel
+def test_extrapolation_linear():
+    # Extrapolation reproduces (mixed) functions in the lower-order
+    # space that are also in the extrapolation space
+    mesh = UnitSquareMesh(4, 4)
+    P1 = FiniteElement("CG", triangle, 1)
+    P2 = FiniteElement("CG", triangle, 2)
+    V = FunctionSpace(mesh, MixedElement([P1, P1]))
+    W = FunctionSpace(mesh, MixedElement([P2, P2]))
+    f = Expression(("1.0 + 2.0*x[0] - x[1]", "x[0] + 3.0*x[1]"), degree=1)
+    v = interpolate(f, V)
+    w = Function(W)
+    w.extrapolate(v)
+    assert round(errornorm(f, w), 10) == 0
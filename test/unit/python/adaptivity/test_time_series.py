@@ -94,3 +94,33 @@ def test_subdirectory(tempdir):
 
     series1.retrieve(m1, 0.1)
     series1.retrieve(x1, 0.15)
+
+
+@skip_if_not_HDF5
+def test_retrieve_backwards(tempdir):
+    "Test interpolated retrieval of vectors in reverse order"
+    filename = os.path.join(tempdir, "test_retrieve_backwards")
+
+    series = TimeSeries(mpi_comm_world(), filename)
+    x = Vector(mpi_comm_world(), 20)
+    times = [0.0, 1.0, 2.0, 3.0, 4.0]
+    for t in times:
+        x[:] = t
+        series.store(x, t)
+    assert series.vector_times() == times
+
+    y = Vector(mpi_comm_world(), 20)
+    for t in [3.75, 3.25, 2.4, 1.6, 0.25, 0.25]:
+        series.retrieve(y, t)
+        assert round(y.max() - t, 12) == 0
+        assert round(y.min() - t, 12) == 0
+        series.retrieve(y, t, False)
+        assert round(y.max() - round(t), 12) == 0
+
+    # Samples are found by a new series on the same file
+    series = TimeSeries(mpi_comm_world(), filename)
+    assert series.vector_times() == times
+    z = Vector()
+    series.retrieve(z, 2.5)
+    assert z.size() == 20
+    assert round(z.max() - 2.5, 12) == 0
@@ -23,7 +23,7 @@ from __future__ import print_function
 import pytest
 from dolfin import UnitSquareMesh, BoundaryMesh, Expression, \
                    CellFunction, SubMesh, Constant, MPI, MeshQuality,\
-                   mpi_comm_world, ALE
+                   mpi_comm_world, ALE, HarmonicSmoothing
 from dolfin_utils.test import skip_in_parallel
 
 def test_HarmonicSmoothing():
@@ -54,6 +54,26 @@ def test_HarmonicSmoothing():
     rmin = MeshQuality.radius_ratio_min_max(mesh)[0]
     assert rmin > magic_number
 
+def test_HarmonicSmoothing_reuse():
+
+    # Move mesh twice with the same smoother
+    mesh = UnitSquareMesh(10, 10)
+    smoother = HarmonicSmoothing(mesh)
+    for step in range(2):
+        boundary = BoundaryMesh(mesh, 'exterior')
+        disp = Expression(("0.1*x[0]*x[1]", "0.1*(1.0-x[1])"), degree=2)
+        ALE.move(boundary, disp)
+        smoother.displace(boundary)
+
+        # Boundary is moved as given
+        boundary_new = BoundaryMesh(mesh, 'exterior')
+        err = sum(sum(abs(boundary.coordinates() \
+                        - boundary_new.coordinates()))) / mesh.num_vertices()
+        assert round(err - 0.0, 5) == 0
+
+    assert MeshQuality.radius_ratio_min_max(mesh)[0] > 0.35
+
+
 @skip_in_parallel
 def test_ale():
 
@@ -20,10 +20,13 @@
 import pytest
 
 import gc
+import json
+import os
 import uuid
 from time import sleep
 
 from dolfin import *
+from dolfin_utils.test import skip_in_parallel, skip_if_not_pybind11, tempdir
 
 
 def get_random_task_name():
@@ -139,3 +142,89 @@ def test_decorator_timing_correctness():
 
     # Check that sleeping above did not influence timer
     assert timing(task, TimingClear_clear)[1] < 0.1
+
+
+def test_scoped_timer_tree():
+    outer_name = get_random_task_name()
+    inner_name = get_random_task_name()
+    outer = ScopedTimer.register_region(outer_name)
+    inner = ScopedTimer.register_region(inner_name)
+    assert ScopedTimer.register_region(outer_name) == outer
+    assert inner != outer
+
+    with ScopedTimer(outer):
+        for i in range(3):
+            with ScopedTimer(inner):
+                sleep(0.01)
+
+    # Nested region is reported by its path in the call tree
+    summary = timing_tree(TimingClear_clear).str(True)
+    assert outer_name in summary
+    assert outer_name + "/" + inner_name in summary
+
+    # Timings are cleared
+    summary = timing_tree(TimingClear_keep).str(True)
+    assert outer_name not in summary
+
+
+@skip_in_parallel
+def test_timing_trace(tempdir):
+    task = get_random_task_name()
+    region_name = get_random_task_name()
+    region = ScopedTimer.register_region(region_name)
+
+    start_timing_trace(2)
+    with Timer(task):
+        with ScopedTimer(region):
+            sleep(0.01)
+    for i in range(3):
+        with ScopedTimer(region):
+            pass
+    stop_timing_trace()
+
+    # Timer stopped after tracing is not recorded
+    with Timer(get_random_task_name()):
+        pass
+
+    filename = os.path.join(tempdir, "trace.json")
+    dump_timing_trace(filename, TimingClear_clear)
+    with open(filename) as f:
+        events = json.load(f)["traceEvents"]
+
+    # Ring buffer keeps the two most recent events
+    names = [e["name"] for e in events if e["ph"] == "X"]
+    assert names == [region_name, region_name]
+
+
+def test_hardware_counters():
+    if not enable_hardware_counters():
+        pytest.skip("Hardware counters not available")
+
+    task = get_random_task_name()
+    try:
+        with Timer(task):
+            sum(range(100000))
+    finally:
+        disable_hardware_counters()
+
+    types = [TimingType_wall, TimingType_instructions,
+             TimingType_cache_misses]
+    summary = timings(TimingClear_keep, types).str(True)
+    assert "instr tot" in summary
+    assert "LLC miss tot" in summary
+    timing(task, TimingClear_clear)
+
+
+@skip_if_not_pybind11
+def test_startup_timings():
+    mesh = UnitSquareMesh(2, 2)
+    assemble(Constant(1.0)*dx(mesh))
+
+    phases = startup_timings()
+    names = [name for name, t in phases]
+    times = [t for name, t in phases]
+    assert "first mesh" in names or "first distributed mesh" in names
+    assert "first assembly" in names
+    assert len(set(names)) == len(names)
+    assert times == sorted(times)
+    assert all(t >= 0.0 for t in times)
@@ -452,3 +452,337 @@ def test_ways_to_pass_mesh_to_assembler():
 
     # Geometric quantities without mesh in domain:
     assert round(0.0 - assemble(n2[0]*ds(mesh)), 7) == 0
+
+
+def test_threaded_assembly(pushpop_parameters):
+    "Test that threaded assembly gives the same result as serial assembly"
+    parameters["ghost_mode"] = "shared_facet"
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "CG", 2)
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    f = Expression("x[0]*x[1]", degree=2)
+    n = FacetNormal(mesh)
+
+    a = inner(grad(v), grad(u))*dx + f*v*u*ds \
+        + inner(jump(grad(v), n), jump(grad(u), n))*dS
+    L = f*v*dx + v*ds
+    M = f*f*dx + f*ds + avg(f)*dS
+
+    A0 = assemble(a)
+    b0 = assemble(L)
+    m0 = assemble(M)
+
+    parameters["num_threads"] = 4
+    A1 = assemble(a)
+    b1 = assemble(L)
+    m1 = assemble(M)
+
+    assert round(A1.norm("frobenius") - A0.norm("frobenius"), 10) == 0
+    assert round(b1.norm("l2") - b0.norm("l2"), 10) == 0
+    assert round(m1 - m0, 10) == 0
+
+
+def test_batched_cell_assembly():
+    "Test that batched cell assembly gives the same result as cell-by-cell assembly"
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "CG", 2)
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    f = Function(V)
+    f.interpolate(Expression("1.0 + x[0]", degree=2))
+    g = Expression("x[1]", degree=1)
+
+    a = f*g*inner(grad(v), grad(u))*dx
+    L = f*g*v*dx
+
+    assembler = cpp.Assembler()
+    assembler.batch_size = 7
+    A = Matrix()
+    b = Vector()
+    assembler.assemble(A, Form(a))
+    assembler.assemble(b, Form(L))
+
+    assert round(A.norm("frobenius") - assemble(a).norm("frobenius"), 10) == 0
+    assert round(b.norm("l2") - assemble(L).norm("l2"), 10) == 0
+
+
+def test_cached_element_tensors():
+    "Test that cached cell tensors are reused and invalidated on changes"
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "CG", 1)
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    f = Function(V)
+    f.interpolate(Constant(1.0))
+    c = Constant(2.0)
+
+    a = c*f*inner(grad(v), grad(u))*dx
+    form = Form(a)
+
+    assembler = cpp.Assembler()
+    assembler.cache_element_tensors = True
+    A = Matrix()
+    assembler.assemble(A, form)
+    norm0 = A.norm("frobenius")
+    assert round(norm0 - assemble(a).norm("frobenius"), 10) == 0
+
+    # Reassemble with unchanged data
+    assembler.assemble(A, form)
+    assert round(A.norm("frobenius") - norm0, 10) == 0
+
+    # Modify coefficient vector
+    f.vector()[:] = 3.0
+    assembler.assemble(A, form)
+    assert round(A.norm("frobenius") - 3.0*norm0, 10) == 0
+
+    # Modify constant
+    c.assign(1.0)
+    assembler.assemble(A, form)
+    assert round(A.norm("frobenius") - 1.5*norm0, 10) == 0
+
+    # Modify geometry
+    mesh.coordinates()[:] *= 2.0
+    assembler.assemble(A, form)
+    assert round(A.norm("frobenius") - assemble(a).norm("frobenius"), 10) == 0
+
+
+@skip_in_parallel
+@pytest.mark.parametrize("backend", ["Eigen", "PETSc"])
+def test_assembly_plan(backend, pushpop_parameters):
+    "Test that reassembly with an assembly plan gives the same matrix"
+    if backend == "PETSc" and not has_linear_algebra_backend("PETSc"):
+        pytest.skip("PETSc not available")
+    parameters["linear_algebra_backend"] = backend
+
+    mesh = UnitSquareMesh(6, 6)
+    V = FunctionSpace(mesh, "CG", 2)
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    f = Function(V)
+    f.interpolate(Expression("1.0 + x[0]*x[1]", degree=2))
+
+    a = f*inner(grad(v), grad(u))*dx
+    form = Form(a)
+    A_ref = assemble(a)
+
+    assembler = cpp.Assembler()
+    assembler.use_assembly_plan = True
+    A = Matrix()
+    for i in range(3):
+        assembler.assemble(A, form)
+        assert round(A.norm("frobenius") - A_ref.norm("frobenius"), 10) == 0
+
+    # Change coefficient and check that plan is used for new values
+    f.vector()[:] *= 2.0
+    assembler.assemble(A, form)
+    assert round(A.norm("frobenius") - 2.0*A_ref.norm("frobenius"), 10) == 0
+
+
+@skip_in_parallel
+@pytest.mark.parametrize("backend", ["Eigen", "PETSc"])
+def test_device_assembly(backend, pushpop_parameters):
+    "Test batched plan assembly used for device offload (host fallback)"
+    if backend == "PETSc" and not has_linear_algebra_backend("PETSc"):
+        pytest.skip("PETSc not available")
+    parameters["linear_algebra_backend"] = backend
+
+    mesh = UnitSquareMesh(6, 6)
+    V = FunctionSpace(mesh, "CG", 2)
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    f = Function(V)
+    f.interpolate(Expression("1.0 + x[0]*x[1]", degree=2))
+
+    a = f*inner(grad(v), grad(u))*dx + u*v*ds
+    form = Form(a)
+    A_ref = assemble(a)
+
+    for batch_size in [0, 5]:
+        assembler = cpp.Assembler()
+        assembler.device_assembly = True
+        assembler.batch_size = batch_size
+        A = Matrix()
+        for i in range(3):
+            assembler.assemble(A, form)
+            assert round(A.norm("frobenius") - A_ref.norm("frobenius"), 10) == 0
+
+
+@skip_in_parallel
+def test_assembly_profile():
+    "Test breakdown of assembly time into update, kernel and insertion"
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "CG", 1)
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    a = inner(grad(v), grad(u))*dx + u*v*ds
+    L = v*dx
+
+    assembler = cpp.Assembler()
+    A = Matrix()
+    assembler.assemble(A, Form(a))
+    assert not assembler.profile().enabled()
+
+    assembler.collect_profile = True
+    assembler.assemble(A, Form(a))
+    profile = assembler.profile()
+    P = cpp.AssemblyProfile
+    assert profile.num_entities(P.cells) == mesh.num_cells()
+    assert profile.num_entities(P.exterior_facets) == 4*8
+    assert profile.num_entities(P.interior_facets) == 0
+    assert profile.time(P.cells, P.tabulate_tensor) > 0.0
+    assert profile.entities_per_second(P.cells) > 0.0
+    assert profile.time(P.cells, P.apply) > 0.0
+    assert "tabulate_tensor" in profile.str(True)
+
+    # System assembler (exterior facets are assembled with their
+    # cells)
+    bc = DirichletBC(V, 0.0, "on_boundary")
+    system_assembler = SystemAssembler(a, L, bc)
+    system_assembler.collect_profile = True
+    b = Vector()
+    system_assembler.assemble(A, b)
+    profile = system_assembler.profile()
+    assert profile.num_entities(P.cells) == mesh.num_cells()
+    assert profile.time(P.cells, P.add_local) > 0.0
+
+
+def test_static_coefficient():
+    "Test assembly with a static Expression coefficient"
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "CG", 1)
+    v = TestFunction(V)
+    f = Expression("sin(x[0])*x[1]", degree=2)
+    c = Constant(2.0)
+    L = c*f*v*dx
+
+    b_ref = assemble(L)
+
+    form = Form(L)
+    assert not form.is_static_coefficient(0)
+    for i in range(form.num_coefficients()):
+        form.set_static_coefficient(i)
+    assert form.is_static_coefficient(0)
+
+    assembler = cpp.Assembler()
+    b = Vector()
+    for k in range(2):
+        assembler.assemble(b, form)
+        assert round(b.norm("l2") - b_ref.norm("l2"), 10) == 0
+
+
+def test_repeated_assembly_coefficient_change():
+    "Test that cached form checks and UFC data follow coefficient changes"
+    mesh = UnitSquareMesh(4, 4)
+    V = FunctionSpace(mesh, "CG", 1)
+    f = Function(V)
+    f.vector()[:] = 1.0
+    M = Form(f*dx)
+
+    assembler = cpp.Assembler()
+    s = Scalar()
+    for k in range(3):
+        assembler.assemble(s, M)
+        assert round(s.get_scalar_value() - 1.0, 10) == 0
+
+    # Replace coefficient
+    g = Function(V)
+    g.vector()[:] = 2.0
+    M.set_coefficient(0, g._cpp_object if has_pybind11() else g)
+    assembler.assemble(s, M)
+    assert round(s.get_scalar_value() - 2.0, 10) == 0
+
+
+def test_multi_form_assembly():
+    "Test fused assembly of several forms sharing a coefficient"
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "CG", 1)
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    f = Function(V)
+    f.interpolate(Expression("x[0]*x[1]", degree=2))
+
+    a = Form(f*inner(grad(u), grad(v))*dx)
+    L = Form(f*v*dx + v*ds)
+    M = Form(f*f*dx)
+
+    A = Matrix()
+    b = Vector()
+    s = Scalar()
+    assembler = cpp.MultiFormAssembler()
+    assembler.add(A, a)
+    assembler.add(b, L)
+    assembler.add(s, M)
+    assert assembler.num_forms() == 3
+    assembler.assemble()
+
+    # Coefficient f is restricted once per cell and shared
+    assert assembler.num_shared_restrictions() == 2*mesh.num_cells()
+
+    A_ref = assemble(f*inner(grad(u), grad(v))*dx)
+    b_ref = assemble(f*v*dx + v*ds)
+    M_ref = assemble(f*f*dx)
+    assert round(A.norm("frobenius") - A_ref.norm("frobenius"), 10) == 0
+    assert round(b.norm("l2") - b_ref.norm("l2"), 10) == 0
+    assert round(s.get_scalar_value() - M_ref, 10) == 0
+
+
+def test_diagonal_assembly():
+    "Test assembly of the diagonal and row sums of bilinear forms"
+    mesh = UnitSquareMesh(6, 6)
+    V = FunctionSpace(mesh, "DG", 1)
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    f = Function(V)
+    f.interpolate(Expression("1.0 + x[0]", degree=1))
+    a = f*inner(grad(u), grad(v))*dx + u*v*ds + jump(u)*jump(v)*dS
+
+    A = assemble(a)
+    assembler = cpp.Assembler()
+
+    # Diagonal
+    d = Vector()
+    assembler.assemble_diagonal(d, Form(a))
+    d_ref = Vector()
+    A.init_vector(d_ref, 0)
+    A.get_diagonal(d_ref)
+    assert round((d - d_ref).norm("l2"), 10) == 0
+
+    # Row sums (lumped mass matrix)
+    m = u*v*dx
+    M = assemble(m)
+    ones = Vector()
+    M.init_vector(ones, 1)
+    ones[:] = 1.0
+    l_ref = M*ones
+    l = Vector()
+    assembler.assemble_diagonal(l, Form(m), True)
+    assert round((l - l_ref).norm("l2"), 10) == 0
+    assert round(l.sum() - 1.0, 10) == 0
+
+
+@skip_in_parallel
+def test_approximate_preallocation(pushpop_parameters):
+    "Test assembly into a matrix preallocated from estimated row counts"
+    if not has_linear_algebra_backend("PETSc"):
+        pytest.skip("PETSc not available")
+    parameters["linear_algebra_backend"] = "PETSc"
+
+    mesh = UnitSquareMesh(8, 8)
+    V = VectorFunctionSpace(mesh, "CG", 2)
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    a = inner(grad(v), grad(u))*dx + inner(v, u)*ds + inner(jump(v), jump(u))*dS
+
+    assembler = cpp.Assembler()
+    assembler.approximate_preallocation = True
+    A = Matrix()
+    assembler.assemble(A, Form(a))
+    A_ref = assemble(a)
+    assert A.nnz() == A_ref.nnz()
+    assert round(A.norm("frobenius") - A_ref.norm("frobenius"), 10) == 0
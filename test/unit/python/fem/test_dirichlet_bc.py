@@ -247,6 +247,46 @@ def test_zero_columns_square():
     assert numpy.isclose(x1.norm('linf'), 0.0)
 
 
+
+def test_zero_columns_multiple():
+    """Test zero_columns for several bcs against sequential application"""
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "P", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    a = inner(grad(u), grad(v))*dx
+    L = Constant(1)*v*dx
+
+    bc0 = DirichletBC(V, 1.0, 'near(x[0], 0.0)')
+    bc1 = DirichletBC(V, 2.0, 'near(x[0], 1.0)')
+
+    A0, b0 = assemble(a), assemble(L)
+    bc0.zero_columns(A0, b0, 1.0)
+    bc1.zero_columns(A0, b0, 1.0)
+
+    A1, b1 = assemble(a), assemble(L)
+    DirichletBC.zero_columns_multiple(A1, b1, [bc0, bc1], 1.0)
+
+    A1.axpy(-1.0, A0, False)
+    b1.axpy(-1.0, b0)
+    assert numpy.isclose(A1.norm('frobenius'), 0.0)
+    assert numpy.isclose(b1.norm('linf'), 0.0)
+
+
+def test_apply_cached_dofs():
+    """Test repeated apply with changed boundary value"""
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "P", 1)
+    g = Constant(1.0)
+    bc = DirichletBC(V, g, 'on_boundary')
+    u = Function(V)
+
+    bc.apply(u.vector())
+    assert numpy.isclose(u.vector().max(), 1.0)
+    g.assign(3.0)
+    bc.apply(u.vector())
+    assert numpy.isclose(u.vector().max(), 3.0)
+
+
 def test_homogenize_consistency():
     mesh = UnitIntervalMesh(10)
     V = FunctionSpace(mesh, "CG", 1)
@@ -278,3 +318,24 @@ def test_nocaching_values():
         bc.set_value(Constant(2.0))
         bc.apply(x)
         assert numpy.allclose(x.array(), 2.0)
+
+
+@pytest.mark.parametrize("check_midpoint", [True, False])
+def test_boundary_method(check_midpoint):
+    "Test that method 'boundary' finds the dofs of 'topological'"
+    mesh = UnitCubeMesh(4, 3, 3)
+    V = FunctionSpace(mesh, "CG", 2)
+    u = Constant(1.0)
+
+    class Left(SubDomain):
+        def inside(self, x, on_boundary):
+            return on_boundary and x[0] < DOLFIN_EPS
+
+    for sub_domain in [DomainBoundary(), Left()]:
+        bc = DirichletBC(V, u, sub_domain, method="topological",
+                         check_midpoint=check_midpoint)
+        bc_boundary = DirichletBC(V, u, sub_domain, method="boundary",
+                                  check_midpoint=check_midpoint)
+        values = bc_boundary.get_boundary_values()
+        assert values == bc.get_boundary_values()
+        assert MPI.sum(mesh.mpi_comm(), len(values)) > 0
@@ -62,3 +62,36 @@ def test_incompatible_spaces():
     V = FunctionSpace(mesh, "Lagrange", 2)
     with pytest.raises(RuntimeError):
         G = DiscreteOperators.build_gradient(W, V)
+
+
+def test_interpolation_matrix():
+    "Test interpolation matrix against Function interpolation"
+
+    meshes = [UnitSquareMesh(7, 5), UnitCubeMesh(3, 2, 4)]
+    for mesh in meshes:
+        V = FunctionSpace(mesh, "Lagrange", 1)
+        W = FunctionSpace(mesh, "Lagrange", 2)
+        P = DiscreteOperators.build_interpolation_matrix(W, V)
+        assert P.size(0) == W.dim()
+        assert P.size(1) == V.dim()
+
+        u = interpolate(Expression("1.0 + x[0] + 2.0*x[1]", degree=1), V)
+        w = Function(W)
+        P.mult(u.vector(), w.vector())
+
+        w_ref = interpolate(u, W)
+        w_ref.vector().axpy(-1.0, w.vector())
+        assert round(w_ref.vector().norm("l2"), 10) == 0.0
+
+        # Vector-valued source into an edge space
+        Q = VectorFunctionSpace(mesh, "Lagrange", 1)
+        N = FunctionSpace(mesh, "Nedelec 1st kind H(curl)", 1)
+        P = DiscreteOperators.build_interpolation_matrix(N, Q)
+        assert P.size(0) == N.dim()
+        assert P.size(1) == Q.dim()
+
+    mesh = UnitSquareMesh(4, 4)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    Q = VectorFunctionSpace(mesh, "Lagrange", 1)
+    with pytest.raises(RuntimeError):
+        DiscreteOperators.build_interpolation_matrix(Q, V)
@@ -518,3 +518,91 @@ def test_dofs_dim():
                 num_mesh_entities = mesh.num_entities(dim)
                 dofs_per_entity = dofmap.num_entity_dofs(dim)
                 assert len(edofs) == dofs_per_entity*num_mesh_entities
+
+
+@pytest.mark.parametrize('ordering_library', ["Boost", "random", "SFC",
+                                              "cell"])
+def test_threaded_dofmap_build(ordering_library, pushpop_parameters):
+    """Test that building the dofmap graph with threads gives the same
+    dofmap as the serial build"""
+    mesh = UnitCubeMesh(4, 4, 4)
+    parameters["dof_ordering_library"] = ordering_library
+
+    dofmaps = []
+    for num_threads in [0, 4]:
+        parameters["num_threads"] = num_threads
+        V = VectorFunctionSpace(mesh, "Lagrange", 2)
+        dofmap = V.dofmap()
+        dofmaps.append([dofmap.cell_dofs(c).copy()
+                        for c in range(mesh.num_cells())])
+
+    if ordering_library != "random":
+        for dofs0, dofs1 in zip(*dofmaps):
+            assert np.array_equal(dofs0, dofs1)
+
+    # Dofmap is a permutation of the owned and ghost dofs
+    for dofmap in dofmaps:
+        all_dofs = np.unique(np.concatenate(dofmap))
+        assert np.array_equal(all_dofs, np.arange(len(all_dofs)))
+
+
+@skip_in_parallel
+def test_dof_ordering_locality(pushpop_parameters):
+    """Test that the locality-preserving orderings give a smaller
+    bandwidth and profile than a random ordering"""
+    mesh = UnitSquareMesh(16, 16)
+
+    bandwidth, profile = {}, {}
+    for ordering_library in ["Boost", "random", "SFC", "cell"]:
+        parameters["dof_ordering_library"] = ordering_library
+        dofmap = FunctionSpace(mesh, "Lagrange", 2).dofmap()
+        bandwidth[ordering_library] = dofmap.bandwidth()
+        profile[ordering_library] = dofmap.profile()
+        assert dofmap.bandwidth() < dofmap.global_dimension()
+
+    for ordering_library in ["Boost", "SFC", "cell"]:
+        assert bandwidth[ordering_library] < bandwidth["random"]
+        assert profile[ordering_library] < profile["random"]
+
+
+@skip_in_parallel
+def test_blocked_dof_layout(pushpop_parameters):
+    """Test that the blocked layout numbers the dofs of each component
+    contiguously"""
+    mesh = UnitSquareMesh(4, 4)
+
+    parameters["dof_block_layout"] = "interleaved"
+    V = VectorFunctionSpace(mesh, "Lagrange", 1)
+    assert V.dofmap().block_size() == 2
+
+    parameters["dof_block_layout"] = "blocked"
+    V = VectorFunctionSpace(mesh, "Lagrange", 1)
+    assert V.dofmap().block_size() == 1
+    n = mesh.num_vertices()
+    for i in range(2):
+        dofs = np.sort(V.sub(i).dofmap().dofs())
+        assert np.array_equal(dofs, np.arange(i*n, (i + 1)*n))
+
+    # Each component has a dof at each vertex
+    x = V.tabulate_dof_coordinates().reshape((-1, 2))
+    x0 = sorted(map(tuple, np.round(x[:n], 12)))
+    x1 = sorted(map(tuple, np.round(x[n:], 12)))
+    assert x0 == x1
+
+
+def test_sub_dofmap_view_cell_dofs(mesh):
+    """Test that sub-dofmap views give the parent cell dofs of each
+    sub-element"""
+    P2 = VectorElement("Lagrange", mesh.ufl_cell(), 2)
+    P1 = FiniteElement("Lagrange", mesh.ufl_cell(), 1)
+    W = FunctionSpace(mesh, P2*P1)
+
+    offset = 0
+    for i, n in [(0, 0), (0, 1), (1, None)]:
+        V = W.sub(i) if n is None else W.sub(i).sub(n)
+        dim = V.dofmap().max_element_dofs()
+        for c in range(mesh.num_cells()):
+            parent_dofs = W.dofmap().cell_dofs(c)
+            assert np.array_equal(V.dofmap().cell_dofs(c),
+                                  parent_dofs[offset:offset + dim])
+        offset += dim
@@ -0,0 +1,78 @@
+#!/usr/bin/env py.test
+
+"""Unit tests for the ErrorNorm class"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import pytest
+from dolfin import *
+from dolfin_utils.test import skip_if_not_pybind11, skip_in_parallel
+
+
+@skip_if_not_pybind11
+@pytest.mark.parametrize("norm_type", ["L2", "H10", "H1"])
+def test_error_norm_same_mesh(norm_type):
+    mesh = UnitSquareMesh(6, 6)
+    V = FunctionSpace(mesh, "CG", 1)
+    W = FunctionSpace(mesh, "CG", 3)
+    u = interpolate(Expression("sin(x[0])*x[1]*x[1]", degree=3), W)
+    uh = interpolate(u, V)
+
+    error = ErrorNorm(mesh, 6)
+    e = error.compute(u, uh, norm_type)
+    e_ref = errornorm(u, uh, norm_type, degree_rise=2)
+    assert round(e - e_ref, 10) == 0
+
+    # Repeated evaluation reuses the quadrature points
+    n = error.num_points()
+    uh.vector()[:] *= 2.0
+    e = error.compute(u, uh, norm_type)
+    assert round(e - errornorm(u, uh, norm_type, degree_rise=2), 10) == 0
+    assert error.num_points() == n
+
+
+@skip_if_not_pybind11
+def test_error_norm_expression():
+    mesh = UnitCubeMesh(3, 3, 3)
+    V = VectorFunctionSpace(mesh, "CG", 2)
+    u = Expression(("x[0]*x[0]", "x[1]", "x[2]*x[0]"), degree=2)
+    uh = interpolate(u, V)
+    assert ErrorNorm(mesh, 4).compute(u, uh) < 1.0e-12
+
+    uh.vector()[:] = 0.0
+    assert round(ErrorNorm(mesh, 4).compute(u, uh)
+                 - sqrt(assemble(inner(u, u)*dx(mesh))), 10) == 0
+
+    with pytest.raises(RuntimeError):
+        ErrorNorm(mesh, 4).compute(u, uh, "H1")
+
+
+@skip_if_not_pybind11
+@skip_in_parallel
+def test_error_norm_other_mesh():
+    mesh0 = UnitSquareMesh(16, 16)
+    mesh1 = UnitSquareMesh(5, 7)
+    f = Expression("x[0]*x[1]", degree=2)
+    u = interpolate(f, FunctionSpace(mesh0, "CG", 2))
+    uh = interpolate(f, FunctionSpace(mesh1, "CG", 1))
+
+    error = ErrorNorm(mesh1, 4)
+    e0 = error.compute(u, uh)
+    e1 = ErrorNorm(mesh1, 4).compute(f, uh)
+    assert round(e0 - e1, 10) == 0
+    assert round(error.compute(u, uh) - e0, 12) == 0
@@ -26,7 +26,7 @@ import pytest
 import numpy
 from dolfin import *
 from dolfin_utils.test import skip_in_parallel
-from dolfin_utils.test import set_parameters_fixture
+from dolfin_utils.test import set_parameters_fixture, pushpop_parameters
 ghost_mode = set_parameters_fixture("ghost_mode", ["shared_facet"])
 
 
@@ -207,3 +207,27 @@ def test_solve_local(ghost_mode):
     u_ls = Function(U)
     local_solver.solve_local(u_ls.vector(), b, U.dofmap())
     assert round((u_lu.vector() - u_ls.vector()).norm("l2"), 12) == 0
+
+
+@pytest.mark.parametrize("num_threads", [0, 4])
+def test_local_solver_reuse_factorization(num_threads, pushpop_parameters):
+    parameters["num_threads"] = num_threads
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "DG", 2)
+    u, v = TrialFunction(V), TestFunction(V)
+    f = Function(V)
+    a, L = inner(u, v)*dx, inner(f, v)*dx
+
+    solvers = [LocalSolver.SolverType_LU, LocalSolver.SolverType_Cholesky]
+    for solver_type in solvers:
+        local_solver = LocalSolver(a, L, solver_type)
+        local_solver.set_factorization_reuse(True)
+
+        # Factorizations computed by the first solve are reused in
+        # the following "time steps"
+        u = Function(V)
+        for t in range(3):
+            f.interpolate(Expression("(1 + t)*sin(x[0])*x[1]", t=t,
+                                     degree=2))
+            local_solver.solve_local_rhs(u)
+            assert round((u.vector() - f.vector()).norm("l2"), 10) == 0
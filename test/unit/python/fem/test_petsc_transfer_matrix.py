@@ -46,6 +46,36 @@ def test_scalar_p1():
     diff.assign(Vuc - uf)
     assert diff.vector().norm("l2") < 1.0e-12
 
+@skip_if_pybind11(reason="MeshHierarchy not wrapped in pybind11")
+def test_hierarchy_transfer_matrix():
+    meshc = UnitCubeMesh(2, 2, 2)
+    hierarchy = MeshHierarchy(meshc)
+    markers = CellFunction("bool", meshc, True)
+    hierarchy = hierarchy.refine(markers)
+    meshf = hierarchy[1]
+
+    Vc = FunctionSpace(meshc, "CG", 2)
+    Vf = FunctionSpace(meshf, "CG", 2)
+
+    u = Expression("x[0]*x[0] + 2*x[1] + 3*x[2]*x[0]", degree=2)
+    uc = interpolate(u, Vc)
+    uf = interpolate(u, Vf)
+
+    # Transfer matrix from parent-child cell relations
+    dm_collection = PETScDMCollection([Vc, Vf], hierarchy)
+    mat = dm_collection.transfer_matrix(1)
+    Vuc = Function(Vf)
+    mat.mult(uc.vector(), Vuc.vector())
+    as_backend_type(Vuc.vector()).update_ghost_values()
+
+    diff = Function(Vf)
+    diff.assign(Vuc - uf)
+    assert diff.vector().norm("l2") < 1.0e-12
+
+    # Cached matrix is reused
+    mat2 = dm_collection.transfer_matrix(-1)
+    assert mat2.norm("frobenius") == mat.norm("frobenius")
+
 def test_scalar_p1_scaled_mesh():
     # Make coarse mesh smaller than fine mesh
     meshc = UnitCubeMesh(2, 2, 2)
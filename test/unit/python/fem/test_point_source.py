@@ -474,3 +474,26 @@ def test_multi_ps_matrix(mesh):
     # Checks b sums to correct value
     a_sum = MPI.sum(mesh.mpi_comm(), np.sum(A.array()))
     assert round(a_sum - 2*len(c_ids)*10) == 0
+
+
+def test_multi_ps_vector_repeated_apply():
+    """Tests point source with many points given on rank 0, applied
+    repeatedly to a vector.
+
+    """
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "CG", 1)
+    v = TestFunction(V)
+    b = assemble(Constant(0.0)*v*dx)
+
+    source = []
+    if MPI.rank(mesh.mpi_comm()) == 0:
+        for x in np.linspace(0.05, 0.95, 20):
+            for y in np.linspace(0.05, 0.95, 20):
+                source.append((Point(x, y), 1.0))
+    ps = PointSource(V, source)
+
+    # Each source adds its magnitude (partition of unity)
+    for k in range(3):
+        ps.apply(b)
+        assert round(b.sum() - (k + 1)*400.0, 8) == 0
@@ -110,6 +110,46 @@ def test_calling():
     # FIXME: Include more tests for this versatile function
 
 
+@pytest.mark.parametrize("symmetric", [False, True])
+def test_linear_variational_solver_reuse_operator(symmetric):
+    "Test that the operator is only reassembled when it changes"
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u = TrialFunction(V)
+    v = TestFunction(V)
+    k = Function(V)
+    k.vector()[:] = 1.0
+    f = Constant(1.0)
+
+    a = k*dot(grad(u), grad(v))*dx + u*v*dx
+    L = f*v*dx
+    bc = DirichletBC(V, 0.0, DomainBoundary())
+
+    w = Function(V)
+    problem = LinearVariationalProblem(a, L, w, [bc])
+    solver = LinearVariationalSolver(problem)
+    solver.parameters["reuse_operator"] = True
+    solver.parameters["symmetric"] = symmetric
+    solver.parameters["linear_solver"] = "lu"
+
+    # Change right-hand side only
+    for value in [1.0, 2.0]:
+        f.assign(value)
+        solver.solve()
+        w_ref = Function(V)
+        solve(a == L, w_ref, bc)
+        assert round(w.vector().norm("l2") - w_ref.vector().norm("l2"), 10) == 0
+    assert solver.num_operator_assemblies() == 1
+
+    # Change bilinear form coefficient
+    k.vector()[:] = 2.0
+    solver.solve()
+    assert solver.num_operator_assemblies() == 2
+    w_ref = Function(V)
+    solve(a == L, w_ref, bc)
+    assert round(w.vector().norm("l2") - w_ref.vector().norm("l2"), 10) == 0
+
+
 def test_nonlinear_variational_solver_custom_comm():
     "Check that nonlinear variational solver works on subset of comm_world"
     if MPI.rank(mpi_comm_world()) == 0:
@@ -125,3 +165,26 @@ def test_nonlinear_variational_solver_custom_comm():
         solve(F == 0, u, solver_parameters={"nonlinear_solver": "newton"})
         if has_petsc():
             solve(F == 0, u, solver_parameters={"nonlinear_solver": "snes"})
+
+
+@pytest.mark.parametrize("method", ["lu", "lumped", "local"])
+def test_projector(method):
+    "Test projection with cached mass matrix"
+    mesh = UnitSquareMesh(8, 8)
+    family = "DG" if method == "local" else "CG"
+    V = FunctionSpace(mesh, family, 1)
+    W = FunctionSpace(mesh, "CG", 2)
+    f = interpolate(Expression("x[0]*x[0] + x[1]", degree=2), W)
+
+    projector = Projector(V, method)
+    u = Function(V)
+    for k in range(3):
+        f.vector()[:] *= 2.0
+        projector.project(f, function=u)
+        u_ref = project(f, V)
+        error = u.vector() - u_ref.vector()
+        if method == "lumped":
+            assert error.norm("linf") < 0.1*u_ref.vector().norm("linf")
+        else:
+            assert error.norm("linf") < 1.0e-10
+    assert projector.num_assemblies() == 1
@@ -0,0 +1,59 @@
+#!/usr/bin/env py.test
+
+"""Unit tests for StaticCondensation"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import pytest
+from dolfin import *
+
+
+@pytest.mark.parametrize("interior_space", [0, 1])
+def test_static_condensation(interior_space):
+    mesh = UnitSquareMesh(6, 6)
+    DG = FiniteElement("DG", mesh.ufl_cell(), 1)
+    CG = FiniteElement("CG", mesh.ufl_cell(), 1)
+    elements = [DG, CG] if interior_space == 0 else [CG, DG]
+    W = FunctionSpace(mesh, MixedElement(elements))
+
+    # Interior (DG) dofs only couple to dofs on the same cell
+    u, v = TrialFunctions(W), TestFunctions(W)
+    uI, uT = u[interior_space], u[1 - interior_space]
+    vI, vT = v[interior_space], v[1 - interior_space]
+    f = Expression("sin(x[0])*x[1]", degree=2)
+    a = (uI*vI + uT*vT + inner(grad(uT), grad(vT))
+         + 0.5*uT*vI + 0.5*uI*vT)*dx
+    L = f*vI*dx + f*vT*dx
+
+    # Reference solution of the full system
+    w0 = Function(W)
+    solve(a == L, w0, solver_parameters={"linear_solver": "lu"})
+
+    # Solve condensed system and back-substitute
+    condensation = StaticCondensation(Form(a), Form(L), interior_space)
+    S, g = Matrix(), Vector()
+    condensation.assemble(S, g)
+    assert S.size(0) == condensation.trace_space().dim()
+
+    x = Vector()
+    solver = LUSolver(S)
+    solver.solve(x, g)
+
+    w = Function(W)
+    condensation.backsubstitute(w, x)
+    assert round((w.vector() - w0.vector()).norm("l2"), 10) == 0
@@ -476,3 +476,39 @@ def test_ghost_mode_handling(pushpop_parameters):
     _check_value(_forms())
     parameters["ghost_mode"] = "shared_facet"
     _check_value(_forms())
+
+
+@skip_in_parallel
+def test_threaded_facet_assembly(pushpop_parameters):
+    "Test that threaded facet-wise system assembly matches serial assembly"
+    mesh = UnitSquareMesh(12, 12)
+    V = FunctionSpace(mesh, "DG", 1)
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    n = FacetNormal(mesh)
+    h = CellSize(mesh)
+    h_avg = (h('+') + h('-'))/2
+    f = Expression("1.0 + x[0]*x[1]", degree=2)
+
+    a = dot(grad(v), grad(u))*dx \
+        - dot(avg(grad(v)), jump(u, n))*dS \
+        - dot(jump(v, n), avg(grad(u)))*dS \
+        + 4.0/h_avg*dot(jump(v, n), jump(u, n))*dS \
+        + 8.0/h*v*u*ds
+    L = v*f*dx + avg(v)*dS
+    bc = DirichletBC(V, Constant(1.0), "x[0] < DOLFIN_EPS", "geometric")
+
+    results = []
+    for num_threads in [0, 4]:
+        parameters["num_threads"] = num_threads
+        A, b = assemble_system(a, L)
+        Abc, bbc = assemble_system(a, L, bc)
+        x = Vector()
+        solve(Abc, x, bbc)
+        results.append((A.norm("frobenius"), b.norm("l2"), x))
+
+    assert round(results[1][0] - results[0][0], 10) == 0
+    assert round(results[1][1] - results[0][1], 10) == 0
+    x0, x1 = results[0][2], results[1][2]
+    x1 -= x0
+    assert round(x1.norm("l2"), 10) == 0
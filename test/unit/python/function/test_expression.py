@@ -189,6 +189,52 @@ def test_overload_and_call_back(V, mesh):
     assert round(s2 - ref, 7) == 0
 
 
+@skip_if_not_pybind11
+@skip_in_parallel
+def test_python_expression_assemble_threads(mesh):
+    # Assembly releases the GIL, and the callback reacquires it
+    import threading
+
+    class F0(UserExpression):
+        def eval(self, values, x):
+            values[0] = x[0]
+
+    f = F0(degree=1)
+    results = [None]*4
+
+    def compute(i):
+        results[i] = assemble(f*dx(mesh))
+
+    threads = [threading.Thread(target=compute, args=(i,)) for i in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    for result in results:
+        assert round(result - 0.5, 10) == 0
+
+
+@skip_if_not_pybind11
+def test_eval_points(mesh, V):
+    class F0(UserExpression):
+        def eval(self, values, x):
+            values[0] = sin(3.0*x[0])*x[1] + x[2]
+
+    class F1(UserExpression):
+        def eval_points(self, values, x):
+            values[:, 0] = np.sin(3.0*x[:, 0])*x[:, 1] + x[:, 2]
+
+    f0 = F0(degree=1)
+    f1 = F1(degree=1)
+
+    u0 = interpolate(f0, V)
+    u1 = interpolate(f1, V)
+    assert np.allclose(u0.vector().get_local(), u1.vector().get_local())
+    assert np.allclose(f0.compute_vertex_values(mesh),
+                       f1.compute_vertex_values(mesh))
+
+
 def test_wrong_eval():
     # Test wrong evaluation
     class F0(UserExpression):
@@ -314,6 +360,21 @@ def test_compute_vertex_values(mesh):
     assert all(e1_values[mesh.num_vertices():mesh.num_vertices()*2] == 2)
     assert all(e1_values[mesh.num_vertices()*2:mesh.num_vertices()*3] == 3)
 
+
+def test_eval_block(mesh):
+    # Expressions depending on other functions are evaluated point by
+    # point, and should match the block evaluation
+    e0 = Expression(("sin(x[0])*x[1]", "x[2]"), degree=2)
+    e1 = Expression(("c*sin(x[0])*x[1]", "c*x[2]"), c=Constant(1.0),
+                    degree=2)
+
+    V = VectorFunctionSpace(mesh, "CG", 2, dim=2)
+    u0 = interpolate(e0, V)
+    u1 = interpolate(e1, V)
+    assert np.allclose(u0.vector().get_local(), u1.vector().get_local())
+    assert np.allclose(e0.compute_vertex_values(mesh),
+                       e1.compute_vertex_values(mesh))
+
 @skip_if_pybind11
 def test_wrong_sub_classing():
 
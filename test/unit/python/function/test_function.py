@@ -20,6 +20,7 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
 import pytest
+import numpy
 from dolfin import *
 import ufl
 
@@ -77,6 +78,45 @@ def test_compute_vertex_values(V, W, mesh):
     assert all(u_values == 1)
 
 
+def test_compute_vertex_values_cached():
+    "Test vertex values for gathered and interpolated spaces"
+    import numpy
+    mesh = UnitCubeMesh(3, 3, 3)
+
+    # Field contained in all spaces below
+    f = Expression(("1.0 + x[2] - x[1]", "2.0 + x[0] - x[2]",
+                    "3.0 + x[1] - x[0]"), degree=1)
+
+    def exact_values(mesh):
+        x = mesh.coordinates()
+        return numpy.concatenate([1.0 + x[:, 2] - x[:, 1],
+                                  2.0 + x[:, 0] - x[:, 2],
+                                  3.0 + x[:, 1] - x[:, 0]])
+
+    exact = exact_values(mesh)
+    for family, degree in [("CG", 1), ("CG", 2), ("DG", 1), ("N1curl", 1)]:
+        if family == "N1curl":
+            Q = FunctionSpace(mesh, family, degree)
+        else:
+            Q = VectorFunctionSpace(mesh, family, degree)
+        u = interpolate(f, Q)
+
+        # Second call reuses the cached vertex interpolation
+        for i in range(2):
+            assert numpy.allclose(u.compute_vertex_values(mesh), exact)
+
+        # Values follow the function after modifying the vector
+        u.vector()[:] *= 2.0
+        assert numpy.allclose(u.compute_vertex_values(mesh), 2.0*exact)
+
+    # Moving the mesh invalidates the cell interpolation matrices
+    Q = FunctionSpace(mesh, "N1curl", 1)
+    interpolate(f, Q).compute_vertex_values(mesh)
+    mesh.coordinates()[:] *= 2.0
+    u = interpolate(f, Q)
+    assert numpy.allclose(u.compute_vertex_values(mesh), exact_values(mesh))
+
+
 def test_assign(V, W):
     from ufl.algorithms import replace
 
@@ -223,6 +263,12 @@ def test_axpy(V, W):
         assert (round(u.vector().sum() -
                       float(expr_scalar1*u.vector().size()), 7) == 0)
 
+        # Assignment including the function itself
+        u.vector()[:] = 1.0
+        u.assign(FunctionAXPY([(2.0, u), (3.0, u1), (1.0, u)]))
+        assert (round(u.vector().sum() -
+                      float(12.0*u.vector().size()), 7) == 0)
+
         with pytest.raises((RuntimeError, TypeError)):
             FunctionAXPY(u, u3, 0)
 
@@ -423,3 +469,56 @@ def test_interpolation_old(V, W, mesh):
     f = Function(W)
     f.interpolate(f1)
     assert round(f.vector().norm("l1") - 3*mesh.num_vertices(), 7) == 0
+
+
+def test_interpolation_same_mesh_cached():
+    """Repeated interpolation between spaces on the same mesh uses a
+    cached operator and matches interpolation of the expression"""
+    mesh = UnitSquareMesh(6, 5)
+    P2 = FunctionSpace(mesh, "Lagrange", 2)
+    P1 = FunctionSpace(mesh, "Lagrange", 1)
+    DG1 = VectorFunctionSpace(mesh, "DG", 1)
+    P3 = VectorFunctionSpace(mesh, "Lagrange", 3)
+    f = Expression("x[0]*x[0] + 2.0*x[1]", degree=2)
+    g = Expression(("x[0] - x[1]", "3.0*x[0]"), degree=1)
+
+    u = interpolate(f, P2)
+    w = interpolate(g, DG1)
+    v = Function(P1)
+    z = Function(P3)
+    for k in range(3):
+        v.interpolate(u)
+        z.interpolate(w)
+        assert numpy.allclose(v.vector().get_local(),
+                              (k + 1)*interpolate(f, P1).vector().get_local())
+        assert numpy.allclose(z.vector().get_local(),
+                              (k + 1)*interpolate(g, P3).vector().get_local())
+        u.vector()[:] += interpolate(f, P2).vector()
+        w.vector()[:] += interpolate(g, DG1).vector()
+
+    # Cache is rebuilt for the moved mesh
+    ALE.move(mesh, Expression(("0.1*x[1]", "0.0"), degree=1))
+    u = interpolate(f, P2)
+    v.interpolate(u)
+    assert numpy.allclose(v.vector().get_local(),
+                          interpolate(f, P1).vector().get_local())
+
+
+def test_point_evaluator(W, mesh):
+    u = Function(W)
+    u.interpolate(Expression(("x[0]", "2*x[1]", "x[0] + x[2]"), degree=1))
+
+    # Every process asks for the same points, regardless of partition
+    points = numpy.array([[0.1, 0.2, 0.3], [0.9, 0.5, 0.25],
+                          [0.5, 0.5, 0.5], [1.0, 1.0, 1.0]])
+    evaluator = PointEvaluator(mesh, points.flatten())
+    assert evaluator.num_points() == 4
+
+    values = evaluator.eval(u).reshape(4, 3)
+    for x, v in zip(points, values):
+        assert numpy.allclose(v, [x[0], 2*x[1], x[0] + x[2]])
+
+    # Re-evaluate with the cached plan
+    u.vector()[:] = 2.0*u.vector().get_local()
+    values = evaluator.eval(u).reshape(4, 3)
+    assert numpy.allclose(values[0], [0.2, 0.8, 0.8])
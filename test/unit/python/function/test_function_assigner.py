@@ -227,3 +227,16 @@ def test_1_N_assigner(u0, u1, u2, w, qq, qqv, V, W):
 
     assert np.all(qqv.sub(0, deepcopy=True).vector().array() == qq.vector().array())
     assert np.all(qqv.sub(1, deepcopy=True).vector().array() == u1.vector().array())
+
+
+def test_round_trip_assigner(V, W):
+    # Block ordered vector dofs give evenly spaced indices
+    w = Function(W)
+    w.vector()[:] = np.random.rand(w.vector().local_size())
+    w.vector().apply("insert")
+    u = [Function(V) for i in range(3)]
+    FunctionAssigner(u, W).assign(u, w)
+
+    w2 = Function(W)
+    FunctionAssigner(W, [V, V, V]).assign(w2, u)
+    assert np.all(w2.vector().get_local() == w.vector().get_local())
@@ -173,6 +173,12 @@ def test_collapse(W, V):
     f1 = Function(Vc)
     assert len(f0.vector()) == len(f1.vector())
 
+    # Collapsed space and map are cached on the sub space
+    Vc2, dofmap_new_old2 = Vs.collapse(True)
+    assert Vc == Vc2
+    assert dofmap_new_old == dofmap_new_old2
+    assert sorted(dofmap_new_old.keys()) == list(range(len(dofmap_new_old)))
+
 def test_argument_equality(mesh, V, V2, W, W2):
     """Placed this test here because it's mainly about detecting differing
 function spaces."""
@@ -86,3 +86,29 @@ def test_functional3D():
     u1 = Function(V1)
     LagrangeInterpolator.interpolate(u1, u0)
     assert round(assemble(u0*dx) - assemble(u1*dx), 10) == 0
+
+
+def test_interpolation_plan():
+    """Test reuse of interpolation plan between non-matching meshes"""
+
+    mesh0 = UnitSquareMesh(8, 8)
+    V0 = FunctionSpace(mesh0, "Lagrange", 2)
+    u0 = Function(V0)
+    LagrangeInterpolator.interpolate(u0, Quadratic2D(degree=2))
+
+    mesh1 = UnitSquareMesh(13, 11)
+    V1 = FunctionSpace(mesh1, "Lagrange", 2)
+    u1 = Function(V1)
+    u2 = Function(V1)
+    LagrangeInterpolator.interpolate(u1, u0)
+
+    plan = LagrangeInterpolationPlan(V1, V0)
+    plan.interpolate(u2, u0)
+    assert numpy.allclose(u1.vector().get_local(), u2.vector().get_local())
+
+    # Reuse plan with updated source values
+    u0.vector()[:] = 3.0*u0.vector().get_local()
+    plan.interpolate(u2, u0)
+    assert numpy.allclose(3.0*u1.vector().get_local(),
+                          u2.vector().get_local())
+    assert round(assemble(u0*dx) - assemble(u2*dx), 10) == 0
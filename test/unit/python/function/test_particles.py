@@ -0,0 +1,95 @@
+#!/usr/bin/env py.test
+
+"""Unit tests for the Particles class"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import numpy
+from dolfin import *
+from dolfin_utils.test import skip_if_not_pybind11
+
+
+def create_particles():
+    mesh = UnitSquareMesh(mpi_comm_world(), 8, 8)
+    particles = Particles(mesh)
+    q = particles.add_property("q", 1)
+
+    # All points are given on process 0 and sent to their owners
+    if MPI.rank(mesh.mpi_comm()) == 0:
+        s = numpy.linspace(0.05, 0.95, 10)
+        x = numpy.array([[a, b] for a in s for b in s])
+    else:
+        x = numpy.zeros((0, 2))
+    particles.add_particles(x.flatten())
+    return mesh, particles, q
+
+
+@skip_if_not_pybind11
+def test_add_and_interpolate():
+    mesh, particles, q = create_particles()
+    assert MPI.sum(mesh.mpi_comm(), float(particles.num_particles())) == 100
+
+    # Cell index holds every particle once, in its cell
+    offsets = particles.cell_offsets()
+    cells = particles.cells()
+    assert offsets[-1] == particles.num_particles()
+    assert sorted(particles.cell_particles()) == list(range(particles.num_particles()))
+    for c in range(len(offsets) - 1):
+        for p in particles.cell_particles()[offsets[c]:offsets[c + 1]]:
+            assert cells[p] == c
+
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u = interpolate(Expression("x[0] + 2*x[1]", degree=1), V)
+    particles.interpolate(u, q)
+    x = particles.positions().reshape(-1, 2)
+    assert numpy.allclose(particles.values(q), x[:, 0] + 2*x[:, 1])
+
+
+@skip_if_not_pybind11
+def test_relocate():
+    mesh, particles, q = create_particles()
+    x = particles.positions().reshape(-1, 2)
+    particles.set_values(q, x[:, 1])
+
+    # Move particles, some leave the domain
+    x[:, 0] += 0.3
+    particles.set_positions(x.flatten())
+    removed = particles.relocate()
+    assert MPI.sum(mesh.mpi_comm(), float(removed)) == 30
+    assert MPI.sum(mesh.mpi_comm(), float(particles.num_particles())) == 70
+
+    # Particles are in their cells and keep their properties
+    x = particles.positions().reshape(-1, 2)
+    for p, c in enumerate(particles.cells()):
+        assert Cell(mesh, c).contains(Point(x[p, 0], x[p, 1]))
+    assert numpy.allclose(particles.values(q), x[:, 1])
+
+
+@skip_if_not_pybind11
+def test_project():
+    mesh, particles, q = create_particles()
+    x = particles.positions().reshape(-1, 2)
+    particles.set_values(q, 3.0 + 0.0*x[:, 0])
+
+    # Constant property is reproduced where there are particles
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u = Function(V)
+    particles.project(u, q)
+    values = u.vector().get_local()
+    assert numpy.allclose(values[values != 0.0], 3.0)
+    assert MPI.sum(mesh.mpi_comm(), float(numpy.count_nonzero(values))) > 0
@@ -0,0 +1,67 @@
+#!/usr/bin/env py.test
+
+"""Unit tests for BoundaryDistance"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import pytest
+import numpy
+
+from dolfin import *
+from dolfin_utils.test import skip_if_not_pybind11
+
+
+def _wall_distance(x):
+    return numpy.min(numpy.hstack((x, 1.0 - x)), axis=1)
+
+
+@pytest.mark.parametrize("mesh", [UnitSquareMesh(mpi_comm_world(), 8, 8),
+                                  UnitCubeMesh(mpi_comm_world(), 4, 4, 4)])
+def test_vertex_distances(mesh):
+    distance = BoundaryDistance(mesh)
+    d = numpy.array(distance.compute_vertex_distances(mesh))
+    assert numpy.allclose(d, _wall_distance(mesh.coordinates()))
+
+
+def test_compute_function():
+    mesh = UnitSquareMesh(mpi_comm_world(), 6, 6)
+    V = FunctionSpace(mesh, "CG", 2)
+    u = Function(V)
+    BoundaryDistance(mesh).compute(u)
+    x = V.tabulate_dof_coordinates().reshape((-1, 2))
+    assert numpy.allclose(u.vector().get_local(), _wall_distance(x))
+
+
+@skip_if_not_pybind11
+def test_warm_start_and_closest_points():
+    mesh = UnitCubeMesh(mpi_comm_world(), 3, 3, 3)
+    distance = BoundaryDistance(mesh)
+
+    # Points inside and outside the unit cube
+    points = numpy.random.RandomState(1).uniform(-0.5, 1.5, (200, 3))
+    d, facets = distance.compute_distances(points.flatten())
+    x, _ = distance.compute_closest_points(points.flatten())
+    x = numpy.array(x).reshape((-1, 3))
+    assert numpy.allclose(numpy.linalg.norm(points - x, axis=1), d)
+    assert numpy.all(x >= -1e-12) and numpy.all(x <= 1.0 + 1e-12)
+
+    # Warm start from the previous facets after a small displacement
+    points += 1e-3
+    d_warm, _ = distance.compute_distances(points.flatten(), facets)
+    d_cold, _ = distance.compute_distances(points.flatten())
+    assert numpy.allclose(d_warm, d_cold)
@@ -26,9 +26,9 @@ import numpy
 from dolfin import BoundingBoxTree
 from dolfin import UnitIntervalMesh, UnitSquareMesh, UnitCubeMesh
 from dolfin import Point
-from dolfin import MeshEntity
-from dolfin import MPI, mpi_comm_world
-from dolfin_utils.test import skip_in_parallel
+from dolfin import MeshEntity, Cell
+from dolfin import MPI, mpi_comm_world, mpi_comm_self, parameters
+from dolfin_utils.test import skip_in_parallel, pushpop_parameters
 
 
 #--- compute_collisions with point ---
@@ -307,6 +307,70 @@ def test_compute_entity_collisions_tree_3d():
         assert set(entities_A) == references[i][0]
         assert set(entities_B) == references[i][1]
 
+@skip_in_parallel
+@pytest.mark.parametrize("gdim", [2, 3])
+def test_compute_entity_collisions_tree_packets(gdim):
+    "Compare packet tests of simplex meshes with cell-by-cell tests"
+    if gdim == 2:
+        mesh_A = UnitSquareMesh(6, 6)
+        mesh_B = UnitSquareMesh(7, 5)
+        mesh_B.rotate(17.0)
+        mesh_B.translate(Point(0.31, 0.17))
+    else:
+        mesh_A = UnitCubeMesh(3, 3, 3)
+        mesh_B = UnitCubeMesh(3, 2, 4)
+        mesh_B.rotate(17.0, 2)
+        mesh_B.translate(Point(0.31, 0.17, 0.23))
+
+    tree_A = BoundingBoxTree()
+    tree_A.build(mesh_A)
+    tree_B = BoundingBoxTree()
+    tree_B.build(mesh_B)
+
+    candidates_A, candidates_B = tree_A.compute_collisions(tree_B)
+    reference = set((a, b) for a, b in zip(candidates_A, candidates_B)
+                    if Cell(mesh_A, a).collides(Cell(mesh_B, b)))
+
+    entities_A, entities_B = tree_A.compute_entity_collisions(tree_B)
+    assert len(entities_A) == len(reference)
+    assert set(zip(entities_A, entities_B)) == reference
+
+@pytest.mark.parametrize("gdim", [2, 3])
+def test_compute_distributed_entity_collisions(gdim):
+    "Compare distributed collisions with collisions of serial meshes"
+    def create_meshes(comm):
+        if gdim == 2:
+            mesh_A = UnitSquareMesh(comm, 6, 6)
+            mesh_B = UnitSquareMesh(comm, 7, 5)
+            mesh_B.rotate(17.0)
+            mesh_B.translate(Point(0.31, 0.17))
+        else:
+            mesh_A = UnitCubeMesh(comm, 3, 3, 3)
+            mesh_B = UnitCubeMesh(comm, 3, 2, 4)
+            mesh_B.rotate(17.0, 2)
+            mesh_B.translate(Point(0.31, 0.17, 0.23))
+        tree_A = BoundingBoxTree()
+        tree_A.build(mesh_A)
+        tree_B = BoundingBoxTree()
+        tree_B.build(mesh_B)
+        return mesh_A, tree_A, tree_B
+
+    # Number of collisions of each cell of A (by global index)
+    mesh_A, tree_A, tree_B = create_meshes(mpi_comm_self())
+    entities_A, entities_B = tree_A.compute_entity_collisions(tree_B)
+    reference = numpy.bincount(entities_A, minlength=mesh_A.num_cells())
+
+    mesh_A, tree_A, tree_B = create_meshes(mpi_comm_world())
+    entities_A, processes, entities_B = \
+        tree_A.compute_distributed_entity_collisions(tree_B)
+    assert len(entities_A) == len(processes) == len(entities_B)
+    assert all(p < MPI.size(mesh_A.mpi_comm()) for p in processes)
+    num_owned = mesh_A.topology().ghost_offset(mesh_A.topology().dim())
+    counts = numpy.bincount(entities_A, minlength=num_owned)
+    assert len(counts) == num_owned
+    for c in range(num_owned):
+        assert counts[c] == reference[Cell(mesh_A, c).global_index()]
+
 #--- compute_first_collision ---
 
 @skip_in_parallel
@@ -485,3 +549,91 @@ def test_compute_closest_entity_3d():
     entity, distance = tree.compute_closest_entity(p)
     assert entity == reference[0]
     assert round(distance - reference[1], 7) == 0
+
+@skip_in_parallel
+@pytest.mark.parametrize("layout", ["wide4", "wide8"])
+def test_wide_layout(layout, pushpop_parameters):
+
+    mesh = UnitCubeMesh(8, 8, 8)
+    points = [Point(0.52, 0.51, 0.3), Point(0.1, 0.05, -0.1),
+              Point(0.9, 0.2, 0.45), Point(1.5, 0.5, 0.5)]
+
+    binary = BoundingBoxTree()
+    binary.build(mesh)
+
+    parameters["bounding_box_tree_layout"] = layout
+    wide = BoundingBoxTree()
+    wide.build(mesh)
+
+    for p in points:
+        assert sorted(wide.compute_collisions(p)) == \
+            sorted(binary.compute_collisions(p))
+        assert sorted(wide.compute_entity_collisions(p)) == \
+            sorted(binary.compute_entity_collisions(p))
+        first = wide.compute_first_entity_collision(p)
+        assert (first in binary.compute_entity_collisions(p)) or \
+            (first == binary.compute_first_entity_collision(p))
+        assert round(wide.compute_closest_entity(p)[1] -
+                     binary.compute_closest_entity(p)[1], 7) == 0
+
+@skip_in_parallel
+def test_refit():
+
+    mesh = UnitSquareMesh(8, 8)
+    tree = mesh.bounding_box_tree()
+    p = Point(0.9, 0.9)
+    assert len(tree.compute_entity_collisions(p)) > 0
+
+    # Shrink mesh and check that the tree follows the coordinates
+    mesh.coordinates()[:] *= 0.5
+    tree.refit()
+    assert len(tree.compute_entity_collisions(p)) == 0
+    assert len(tree.compute_entity_collisions(Point(0.45, 0.45))) > 0
+
+    # Compare with a tree built from scratch
+    reference = BoundingBoxTree()
+    reference.build(mesh)
+    q = Point(0.2, 0.3)
+    assert sorted(tree.compute_entity_collisions(q)) == \
+        sorted(reference.compute_entity_collisions(q))
+
+@skip_in_parallel
+def test_refit_on_geometry_change():
+
+    mesh = UnitCubeMesh(4, 4, 4)
+    p = Point(0.9, 0.9, 0.9)
+    assert mesh.bounding_box_tree().compute_first_entity_collision(p) \
+        < mesh.num_cells()
+
+    # Moving the coordinates refits the tree of the mesh
+    mesh.coordinates()[:] *= 0.5
+    tree = mesh.bounding_box_tree()
+    assert len(tree.compute_entity_collisions(p)) == 0
+    assert len(tree.compute_entity_collisions(Point(0.45, 0.45, 0.45))) > 0
+
+
+@pytest.mark.parametrize('gdim', [1, 2, 3])
+def test_grid_point_locator(gdim):
+
+    if gdim == 1:
+        mesh = UnitIntervalMesh(16)
+    elif gdim == 2:
+        mesh = UnitSquareMesh(8, 5)
+    else:
+        mesh = UnitCubeMesh(4, 3, 5)
+
+    tree = BoundingBoxTree()
+    tree.build(mesh)
+    mesh.set_point_locator("grid")
+    grid = mesh.bounding_box_tree()
+    assert mesh.point_locator() == "grid"
+
+    numpy.random.seed(1)
+    for x in numpy.random.rand(50, gdim)*1.4 - 0.2:
+        p = Point(*x)
+        assert sorted(grid.compute_entity_collisions(p)) \
+            == sorted(tree.compute_entity_collisions(p))
+        assert (grid.compute_first_entity_collision(p) < mesh.num_cells()) \
+            == (tree.compute_first_entity_collision(p) < mesh.num_cells())
+        assert round(grid.compute_closest_entity(p)[1]
+                     - tree.compute_closest_entity(p)[1], 10) == 0
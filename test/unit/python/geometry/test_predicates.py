@@ -0,0 +1,69 @@
+"""Unit tests for the robust geometric predicates"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+from __future__ import print_function
+import pytest
+import numpy as np
+from fractions import Fraction
+
+from dolfin import Point, orient2d, orient3d
+
+
+def sign(x):
+    return (x > 0) - (x < 0)
+
+
+def test_orient2d_simple():
+    a, b, c = Point(0.0, 0.0), Point(1.0, 0.0), Point(0.0, 1.0)
+    assert orient2d(a, b, c) > 0.0
+    assert orient2d(a, c, b) < 0.0
+    assert orient2d(a, b, Point(2.0, 0.0)) == 0.0
+
+
+def test_orient2d_near_collinear():
+    # Points near the line through b and c, where the floating-point
+    # determinant often has the wrong sign
+    b, c = Point(12.0, 12.0), Point(24.0, 24.0)
+    h = np.ldexp(1.0, -53)
+    for i in range(32):
+        for j in range(32):
+            ax, ay = 0.5 + i*h, 0.5 + j*h
+            exact = (Fraction(ax) - 24)*(12 - 24) - (Fraction(ay) - 24)*(12 - 24)
+            assert sign(orient2d(Point(ax, ay), b, c)) == sign(exact)
+
+
+def test_orient3d_simple():
+    a, b, c = Point(0.0, 0.0, 0.0), Point(1.0, 0.0, 0.0), Point(0.0, 1.0, 0.0)
+    assert orient3d(a, b, c, Point(0.0, 0.0, -1.0)) > 0.0
+    assert orient3d(a, b, c, Point(0.0, 0.0, 1.0)) < 0.0
+    assert orient3d(a, b, c, Point(0.3, 0.7, 0.0)) == 0.0
+
+
+def test_orient3d_near_coplanar():
+    np.random.seed(1)
+    for k in range(200):
+        a, b, c = [np.random.rand(3) for i in range(3)]
+        d = a + 0.3*(b - a) + 0.4*(c - a)
+        rows = [[Fraction(p[i]) - Fraction(d[i]) for i in range(3)]
+                for p in (a, b, c)]
+        exact = rows[0][0]*(rows[1][1]*rows[2][2] - rows[1][2]*rows[2][1]) \
+            - rows[0][1]*(rows[1][0]*rows[2][2] - rows[1][2]*rows[2][0]) \
+            + rows[0][2]*(rows[1][0]*rows[2][1] - rows[1][1]*rows[2][0])
+        result = orient3d(Point(*a), Point(*b), Point(*c), Point(*d))
+        assert sign(result) == sign(exact)
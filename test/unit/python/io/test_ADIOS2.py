@@ -0,0 +1,55 @@
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+import pytest
+import os
+from dolfin import *
+from dolfin_utils.test import skip_if_not_ADIOS2, fixture, tempdir
+
+
+@skip_if_not_ADIOS2
+@pytest.mark.parametrize("engine", ["BP4", "BP5"])
+def test_save_function_series(tempdir, engine):
+    filename = os.path.join(tempdir, "u_%s.bp" % engine)
+    mesh = UnitSquareMesh(8, 8)
+    V = VectorFunctionSpace(mesh, "CG", 1)
+    u = Function(V)
+    mf = MeshFunction("size_t", mesh, mesh.topology().dim(), 1)
+
+    with ADIOS2File(mesh.mpi_comm(), filename, engine) as f:
+        f.set_engine_parameter("NumAggregators", "1")
+        for t in (0.1, 0.2, 0.3):
+            u.vector()[:] = t
+            f.write(u, t)
+            f.write(mf, t)
+        f.flush()
+        assert f.num_steps() == 3
+
+    assert os.path.exists(filename)
+
+
+@skip_if_not_ADIOS2
+def test_engine_parameter_after_write(tempdir):
+    filename = os.path.join(tempdir, "mesh.bp")
+    mesh = UnitCubeMesh(2, 2, 2)
+    f = ADIOS2File(mesh.mpi_comm(), filename)
+    f.write(mesh)
+    with pytest.raises(RuntimeError):
+        f.set_engine_parameter("NumAggregators", "1")
+    f.close()
+    assert f.num_steps() == 1
@@ -0,0 +1,68 @@
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+
+import pytest
+import os
+import glob
+from dolfin import *
+from dolfin_utils.test import skip_if_not_Ascent, fixture, tempdir
+
+
+extract_actions = """
+-
+  action: "add_extracts"
+  extracts:
+    e1:
+      type: "relay"
+      params:
+        path: "%s"
+        protocol: "blueprint/mesh/hdf5"
+"""
+
+
+@skip_if_not_Ascent
+@pytest.mark.parametrize("mesh_factory", [(UnitSquareMesh, (4, 4)),
+                                          (UnitCubeMesh, (2, 2, 2)),
+                                          (UnitQuadMesh.create, (4, 4))])
+def test_execute_extract(tempdir, mesh_factory):
+    func, args = mesh_factory
+    mesh = func(mpi_comm_world(), *args)
+    u = Function(VectorFunctionSpace(mesh, "CG", 1), name="u")
+    p = Function(FunctionSpace(mesh, "DG", 0), name="p")
+    path = os.path.join(tempdir, "extract_%s" % mesh.type().cell_type())
+
+    with AscentAdaptor(mesh.mpi_comm()) as adaptor:
+        adaptor.add(u)
+        adaptor.add(p)
+        for cycle in range(2):
+            u.vector()[:] = float(cycle)
+            p.vector()[:] = 2.0*cycle
+            adaptor.execute(0.1*cycle, cycle, extract_actions % path)
+
+    MPI.barrier(mesh.mpi_comm())
+    assert len(glob.glob(path + "*.root")) == 2
+
+
+@skip_if_not_Ascent
+def test_function_on_different_mesh():
+    mesh0 = UnitSquareMesh(2, 2)
+    mesh1 = UnitSquareMesh(2, 2)
+    adaptor = AscentAdaptor(mesh0.mpi_comm())
+    adaptor.set_mesh(mesh0)
+    with pytest.raises(RuntimeError):
+        adaptor.add(Function(FunctionSpace(mesh1, "CG", 1)))
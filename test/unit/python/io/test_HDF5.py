@@ -23,6 +23,7 @@
 
 import pytest
 import os
+import numpy
 from dolfin import *
 from dolfin_utils.test import skip_if_not_HDF5, fixture, tempdir, xfail_with_serial_hdf5_in_parallel
 
@@ -60,6 +61,78 @@ def test_save_and_read_vector(tempdir):
         assert y.size() == x.size()
         assert (x - y).norm("l1") == 0.0
 
+@skip_if_not_HDF5
+@xfail_with_serial_hdf5_in_parallel
+def test_save_and_read_compressed_vector(tempdir):
+    filename = os.path.join(tempdir, "vector_compressed.h5")
+
+    # Write to file with chunking and compression
+    x = Vector(mpi_comm_world(), 30500)
+    x[:] = 1.2
+    with HDF5File(x.mpi_comm(), filename, "w") as vector_file:
+        vector_file.parameters["chunk_size"] = 1000
+        vector_file.parameters["compression_level"] = 4
+        vector_file.parameters["shuffle"] = True
+        vector_file.write(x, "/my_vector")
+
+    # Read from file
+    y = Vector()
+    with HDF5File(x.mpi_comm(), filename, "r") as vector_file:
+        vector_file.read(y, "/my_vector", False)
+        assert y.size() == x.size()
+        assert (x - y).norm("l1") == 0.0
+
+@skip_if_not_HDF5
+@xfail_with_serial_hdf5_in_parallel
+@pytest.mark.parametrize("aggregation", [-1, 2])
+def test_save_and_read_aggregated(tempdir, aggregation):
+    filename = os.path.join(tempdir, "aggregated_%d.h5" % aggregation)
+
+    # Write vector and mesh, aggregating output on fewer processes
+    mesh = UnitSquareMesh(8, 8)
+    x = Vector(mpi_comm_world(), 305)
+    x[:] = 1.2
+    with HDF5File(x.mpi_comm(), filename, "w") as hdf5_file:
+        hdf5_file.parameters["aggregation"] = aggregation
+        hdf5_file.write(x, "/my_vector")
+        hdf5_file.write(mesh, "/my_mesh")
+
+    # Read from file
+    y = Vector()
+    mesh2 = Mesh()
+    with HDF5File(x.mpi_comm(), filename, "r") as hdf5_file:
+        hdf5_file.read(y, "/my_vector", False)
+        hdf5_file.read(mesh2, "/my_mesh", False)
+    assert (x - y).norm("l1") == 0.0
+    assert mesh2.size_global(0) == mesh.size_global(0)
+    assert mesh2.size_global(2) == mesh.size_global(2)
+
+@skip_if_not_HDF5
+@xfail_with_serial_hdf5_in_parallel
+def test_save_and_read_distributed_mesh(tempdir):
+    filename = os.path.join(tempdir, "distributed_mesh.h5")
+    mesh = UnitCubeMesh(4, 4, 4)
+    mesh.init(2)
+    with HDF5File(mesh.mpi_comm(), filename, "w") as mesh_file:
+        mesh_file.write_distributed_mesh(mesh, "/my_mesh")
+
+    # Read back without repartitioning, including the facets
+    mesh2 = Mesh()
+    with HDF5File(mesh.mpi_comm(), filename, "r") as mesh_file:
+        mesh_file.read_distributed_mesh(mesh2, "/my_mesh")
+
+    for d in (0, 2, 3):
+        assert mesh2.topology().size(d) == mesh.topology().size(d)
+        assert mesh2.topology().size_global(d) == mesh.topology().size_global(d)
+        assert mesh2.topology().ghost_offset(d) == mesh.topology().ghost_offset(d)
+        assert (mesh2.topology().global_indices(d) == mesh.topology().global_indices(d)).all()
+        assert mesh2.topology().shared_entities(d) == mesh.topology().shared_entities(d)
+    assert (mesh2.coordinates() == mesh.coordinates()).all()
+    assert (mesh2.cells() == mesh.cells()).all()
+    for c in range(mesh.num_cells()):
+        assert (mesh2.topology()(3, 2)(c) == mesh.topology()(3, 2)(c)).all()
+    assert assemble(1.0*ds(mesh2)) == pytest.approx(assemble(1.0*ds(mesh)))
+
 @skip_if_not_HDF5
 @xfail_with_serial_hdf5_in_parallel
 def test_save_and_read_meshfunction_2D(tempdir):
@@ -197,6 +270,68 @@ def test_save_and_read_function(tempdir):
     assert len(result.array().nonzero()[0]) == 0
     hdf5_file.close()
 
+@skip_if_not_HDF5
+@xfail_with_serial_hdf5_in_parallel
+def test_read_several_functions(tempdir):
+    filename = os.path.join(tempdir, "functions.h5")
+
+    mesh = UnitSquareMesh(10, 10)
+    Q = FunctionSpace(mesh, "CG", 2)
+    P = FunctionSpace(mesh, "DG", 1)
+    functions = [interpolate(Expression("x[0] + %d*x[1]" % i, degree=1), V)
+                 for i, V in enumerate((Q, Q, P, Q))]
+
+    hdf5_file = HDF5File(mesh.mpi_comm(), filename, "w")
+    for i, F in enumerate(functions):
+        hdf5_file.write(F, "/function_%d" % i)
+    hdf5_file.close()
+
+    # Read back (twice) from the same file, reusing redistributions
+    hdf5_file = HDF5File(mesh.mpi_comm(), filename, "r")
+    for k in range(2):
+        for i, F0 in enumerate(functions):
+            F1 = Function(F0.function_space())
+            hdf5_file.read(F1, "/function_%d" % i)
+            result = F0.vector() - F1.vector()
+            assert len(result.array().nonzero()[0]) == 0
+    hdf5_file.close()
+
+@skip_if_not_HDF5
+@xfail_with_serial_hdf5_in_parallel
+def test_save_and_read_quadrature_data(tempdir):
+    filename = os.path.join(tempdir, "quadrature_data.h5")
+
+    mesh = UnitSquareMesh(6, 6)
+    q0 = QuadratureData(mesh, 3, [2])
+    assert q0.block_size() == 6
+    values = q0.array()
+    for cell in cells(mesh):
+        values[cell.index(), :] = cell.global_index() + numpy.arange(6)
+
+    hdf5_file = HDF5File(mesh.mpi_comm(), filename, "w")
+    hdf5_file.write(mesh, "/mesh")
+    hdf5_file.write(q0, "/state")
+    hdf5_file.close()
+
+    # Read back on the mesh from file (possibly partitioned differently)
+    mesh1 = Mesh()
+    hdf5_file = HDF5File(mesh.mpi_comm(), filename, "r")
+    hdf5_file.read(mesh1, "/mesh", False)
+    q1 = QuadratureData(mesh1, 3, [2])
+    hdf5_file.read(q1, "/state")
+    hdf5_file.close()
+    values = q1.array()
+    for cell in cells(mesh1):
+        assert numpy.array_equal(values[cell.index(), :],
+                                 cell.global_index() + numpy.arange(6))
+
+    # Layout must match
+    q2 = QuadratureData(mesh1, 4)
+    hdf5_file = HDF5File(mesh.mpi_comm(), filename, "r")
+    with pytest.raises(RuntimeError):
+        hdf5_file.read(q2, "/state")
+    hdf5_file.close()
+
 @skip_if_not_HDF5
 @xfail_with_serial_hdf5_in_parallel
 def test_save_and_read_mesh_2D(tempdir):
@@ -18,7 +18,8 @@
 import pytest
 import os
 from dolfin import *
-from dolfin_utils.test import skip_in_parallel, fixture, tempdir
+from dolfin_utils.test import skip_in_parallel, fixture, tempdir, \
+    pushpop_parameters
 
 
 # Supported XDMF file encoding
@@ -73,6 +74,14 @@ def test_save_and_load_1d_mesh(tempdir, encoding):
     assert mesh.size_global(dim) == mesh2.size_global(dim)
 
 
+def test_read_missing_file(tempdir):
+    filename = os.path.join(tempdir, "missing.xdmf")
+    mesh = Mesh()
+    with XDMFFile(mpi_comm_world(), filename) as file:
+        with pytest.raises(RuntimeError):
+            file.read(mesh)
+
+
 @pytest.mark.parametrize("encoding", encodings)
 def test_save_and_load_2d_mesh(tempdir, encoding):
     if invalid_config(encoding):
@@ -324,6 +333,175 @@ def test_save_3d_vector_series(tempdir, encoding):
         file.write(u, 0.3, encoding)
 
 
+@skip_in_parallel
+def test_checkpoint_different_dof_layout(tempdir, pushpop_parameters):
+    if invalid_config(XDMFFile.Encoding_HDF5):
+        pytest.skip("XDMF unsupported in current configuration")
+    filename = os.path.join(tempdir, "u_layout.xdmf")
+    mesh = UnitSquareMesh(8, 8)
+
+    parameters["reorder_dofs_serial"] = True
+    V_out = FunctionSpace(mesh, "CG", 2)
+    u_out = interpolate(Expression("x[0]*x[0] + 2.0*x[1]", degree=2), V_out)
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.write_checkpoint(u_out, "u_out", 0)
+
+    # Read into function with different dof numbering (redistribution)
+    parameters["reorder_dofs_serial"] = False
+    V_in = FunctionSpace(mesh, "CG", 2)
+    u_in = Function(V_in)
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.read_checkpoint(u_in, "u_out", 0)
+
+    for p in (Point(0.3, 0.4), Point(0.71, 0.05)):
+        assert round(u_in(p) - u_out(p), 12) == 0.0
+
+
+def test_save_function_single_precision(tempdir):
+    if invalid_config(XDMFFile.Encoding_HDF5):
+        pytest.skip("XDMF unsupported in current configuration")
+    filename = os.path.join(tempdir, "u_single.xdmf")
+    mesh = UnitSquareMesh(mpi_comm_world(), 8, 8)
+    V = FunctionSpace(mesh, "CG", 1)
+    u = interpolate(Expression("x[0] + 1.0e-9*x[1]", degree=1), V)
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.parameters["value_precision"] = "single"
+        file.write(u, 0.0)
+        file.write(u, 1.0)
+
+    if MPI.rank(mesh.mpi_comm()) == 0:
+        # Only the function values are written in single precision
+        with open(filename) as f:
+            assert f.read().count('Precision="4"') == 2
+
+
+def test_save_and_load_mesh_file_per_process(tempdir):
+    if invalid_config(XDMFFile.Encoding_HDF5):
+        pytest.skip("XDMF unsupported in current configuration")
+    filename = os.path.join(tempdir, "mesh_pieces.xdmf")
+    mesh = UnitCubeMesh(4, 4, 4)
+
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.parameters["file_per_process"] = True
+        file.write(mesh)
+
+    rank = MPI.rank(mesh.mpi_comm())
+    assert os.path.isfile(os.path.join(tempdir, "mesh_pieces_p%d.h5" % rank))
+
+    mesh_in = Mesh()
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.read(mesh_in)
+    assert mesh_in.num_cells() == mesh.num_cells()
+    assert mesh_in.size_global(0) == mesh.size_global(0)
+    assert mesh_in.size_global(3) == mesh.size_global(3)
+    assert round(assemble(1.0*dx(mesh_in)) - 1.0, 12) == 0.0
+
+
+def test_save_and_checkpoint_file_per_process(tempdir):
+    if invalid_config(XDMFFile.Encoding_HDF5):
+        pytest.skip("XDMF unsupported in current configuration")
+    filename = os.path.join(tempdir, "u_pieces.xdmf")
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "CG", 2)
+
+    times = [0.5, 0.2]
+    u_out = [interpolate(Expression("x[0]*x[1]*p", p=p, degree=2), V)
+             for p in times]
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.parameters["file_per_process"] = True
+        for u, p in zip(u_out, times):
+            file.write_checkpoint(u, "u_out", p)
+
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        for i, u in enumerate(u_out):
+            u_in = Function(V)
+            file.read_checkpoint(u_in, "u_out", i)
+            result = u_in.vector() - u.vector()
+            assert all([near(x, 0.0) for x in result.array()])
+
+
+def test_save_3d_vector_series_async(tempdir):
+    if invalid_config(XDMFFile.Encoding_HDF5):
+        pytest.skip("XDMF unsupported in current configuration")
+    filename = os.path.join(tempdir, "u_3D_async.xdmf")
+    mesh = UnitCubeMesh(4, 4, 4)
+    u = Function(VectorFunctionSpace(mesh, "Lagrange", 1))
+
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.parameters["async_output"] = True
+        for t in (0.1, 0.2, 0.3):
+            u.vector()[:] = t
+            file.write(u, t, XDMFFile.Encoding_HDF5)
+
+    assert os.path.isfile(filename)
+    assert os.path.isfile(os.path.join(tempdir, "u_3D_async.h5"))
+
+
+@pytest.mark.parametrize("encoding", encodings)
+def test_save_series_incremental_xml(tempdir, encoding):
+    if invalid_config(encoding):
+        pytest.skip("XDMF unsupported in current configuration")
+    mesh = UnitSquareMesh(4, 4)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u = Function(V)
+    u.rename("u", "u")
+    v = Function(V)
+    v.rename("v", "v")
+
+    # Incremental and full rewrites of the XML must give the same file
+    xml = []
+    for incremental in (True, False):
+        filename = os.path.join(tempdir, "series_%d.xdmf" % incremental)
+        with XDMFFile(mesh.mpi_comm(), filename) as file:
+            file.parameters["incremental_xml"] = incremental
+            file.parameters["functions_share_mesh"] = True
+            file.parameters["rewrite_function_mesh"] = False
+            for t in (0.0, 0.5, 1.0):
+                u.vector()[:] = t
+                v.vector()[:] = 2.0*t
+                file.write(u, t, encoding)
+                file.write(v, t, encoding)
+        if MPI.rank(mesh.mpi_comm()) == 0:
+            with open(filename) as f:
+                xml.append(f.read().replace("series_%d" % incremental, ""))
+
+    if MPI.rank(mesh.mpi_comm()) == 0:
+        assert xml[0] == xml[1]
+
+
+def test_save_series_decimation_and_reductions(tempdir, encoding):
+    if invalid_config(encoding):
+        pytest.skip("XDMF unsupported in current configuration")
+    mesh = UnitSquareMesh(4, 4)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u = Function(V)
+    u.rename("u", "u")
+
+    filename = os.path.join(tempdir, "reductions.xdmf")
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.parameters["decimation"] = 2
+        file.parameters["statistics"] = True
+        file.add_probe("centre", Point(0.5, 0.5))
+        file.add_functional(u, "integral", Form(u*dx))
+        for step in range(5):
+            u.vector()[:] = float(step)
+            file.write(u, float(step), encoding)
+
+    if MPI.rank(mesh.mpi_comm()) == 0:
+        # Only steps 0, 2 and 4 are written to the XDMF file
+        with open(filename) as f:
+            assert f.read().count("<Time ") == 3
+
+        # Reductions are written at every step
+        with open(os.path.join(tempdir, "reductions_reductions.csv")) as f:
+            rows = [line.strip().split(",") for line in f]
+        assert rows[0] == ["function", "step", "time", "quantity", "value"]
+        assert len(rows) == 1 + 5*6
+        for row in rows[1:]:
+            if row[3] != "norm_l2":
+                assert round(float(row[4]) - float(row[1]), 10) == 0
+
+
 @pytest.mark.parametrize("encoding", encodings)
 def test_save_2d_tensor(tempdir, encoding):
     if invalid_config(encoding):
@@ -113,3 +113,17 @@ def test_mesh_domains_io(cd_tempdir):
             len(output_mesh.domains().markers(2))
     assert len(input_mesh.domains().markers(3)) == \
             len(output_mesh.domains().markers(3))
+
+def test_read_mesh_stream(cd_tempdir):
+    "Test that (gzipped) XML meshes read in parallel are complete"
+    if MPI.rank(mpi_comm_world()) == 0:
+        mesh = UnitCubeMesh(mpi_comm_self(), 4, 4, 4)
+        File(mpi_comm_self(), "unit_cube.xml") << mesh
+        File(mpi_comm_self(), "unit_cube.xml.gz") << mesh
+    MPI.barrier(mpi_comm_world())
+
+    for filename in ["unit_cube.xml", "unit_cube.xml.gz"]:
+        mesh = Mesh(filename)
+        assert mesh.num_entities_global(0) == 125
+        assert mesh.num_entities_global(3) == 384
+        assert round(assemble(Constant(1.0)*dx(domain=mesh)) - 1.0, 7) == 0
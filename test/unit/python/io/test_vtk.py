@@ -25,7 +25,8 @@ from dolfin_utils.test import skip_in_parallel, fixture, tempdir
 # VTK file options
 @fixture
 def file_options():
-    return ["ascii", "base64", "compressed"]
+    return ["ascii", "base64", "compressed", "appended",
+            "appended_compressed"]
 
 @fixture
 def mesh_functions():
@@ -206,3 +207,20 @@ def test_save_3d_tensor(tempfile, file_options):
     f << (u, 1.)
     for file_option in file_options:
         File(tempfile + "u.pvd", file_option) << u
+
+@skip_in_parallel
+def test_save_appended(tempfile):
+    mesh = UnitSquareMesh(16, 16)
+    u = Function(VectorFunctionSpace(mesh, "Lagrange", 1))
+    u.vector()[:] = 1.0
+    for file_option in ["appended", "appended_compressed"]:
+        File(tempfile + file_option + ".pvd", file_option) << u
+
+        # Raw data follows the XML, and the temporary file is removed
+        vtu = tempfile + file_option + "000000.vtu"
+        with open(vtu, "rb") as f:
+            data = f.read()
+        assert data.count(b'format="appended"') == 5
+        assert b'<AppendedData  encoding="raw">' in data
+        assert data.endswith(b"</AppendedData>\n</VTKFile>")
+        assert not os.path.exists(vtu + ".appended")
@@ -279,3 +279,19 @@ def test_mpi_dependent_jiting():
         u = Function(V)
         v = TestFunction(V)
         Form(u*v*dx)
+
+
+def test_jit_prewarm():
+    "Test that pre-compiled forms and elements are found by Form and FunctionSpace"
+    from dolfin.jit.jit import prewarm
+    mesh = UnitSquareMesh(MPI.comm_world, 4, 4)
+    element = FiniteElement("Lagrange", mesh.ufl_cell(), 2)
+    u = TrialFunction(FunctionSpace(mesh, element))
+    v = TestFunction(u.function_space())
+    a = inner(grad(u), grad(v))*dx + u*v*dx
+    modules = prewarm([element, a], max_workers=2)
+    assert len(modules) == 2
+
+    # Collective compilation (cache hit) and assembly
+    A = assemble(a)
+    assert A.size(0) == u.function_space().dim()
@@ -253,3 +253,97 @@ def test_krylov_tpetra():
 
     # Number of iterations should be around 15
     assert n_iter < 50
+
+
+def test_krylov_iterative_refinement(pushpop_parameters):
+    "Test that iterative refinement recovers accuracy of a loose solve"
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    bc = DirichletBC(V, Constant(0.0), lambda x, on_boundary: on_boundary)
+    A, b = assemble_system(inner(grad(u), grad(v))*dx, Constant(1.0)*v*dx,
+                           bc)
+
+    def residual(x):
+        r = b.copy()
+        r.axpy(-1.0, A*x)
+        return r.norm("l2")/b.norm("l2")
+
+    solver = KrylovSolver(A, "cg")
+    solver.parameters["relative_tolerance"] = 1.0e-3
+
+    x = Vector()
+    solver.solve(x, b)
+    assert residual(x) > 1.0e-8
+
+    solver.parameters["iterative_refinement_steps"] = 20
+    solver.parameters["iterative_refinement_tolerance"] = 1.0e-10
+    x = Vector()
+    solver.solve(x, b)
+    assert residual(x) < 1.0e-9
+
+
+@skip_if_not_PETSc
+def test_krylov_pipelined(pushpop_parameters):
+    "Test pipelined Krylov methods against their standard variants"
+    parameters["linear_algebra_backend"] = "PETSc"
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    bc = DirichletBC(V, Constant(0.0), lambda x, on_boundary: on_boundary)
+    A, b = assemble_system(inner(grad(u), grad(v))*dx, Constant(1.0)*v*dx,
+                           bc)
+
+    x_ref = PETScVector()
+    solver = PETScKrylovSolver("cg", "jacobi")
+    solver.parameters["relative_tolerance"] = 1.0e-10
+    solver.solve(A, x_ref, b)
+    assert not solver.pipelined()
+
+    methods = [m for m in ["pipecg", "pgmres", "pipegcr"]
+               if m in krylov_solver_methods()]
+    assert "pipecg" in methods
+    for method in methods:
+        solver = PETScKrylovSolver(method, "jacobi")
+        solver.parameters["relative_tolerance"] = 1.0e-10
+        assert solver.pipelined()
+        x = PETScVector()
+        solver.solve(A, x, b)
+        x.axpy(-1.0, x_ref)
+        assert x.norm("l2") < 1.0e-6*x_ref.norm("l2")
+
+    # Front-end
+    solver = KrylovSolver(A, "pipecg", "jacobi")
+    x = Vector()
+    solver.solve(x, b)
+
+
+@skip_if_not_PETSc
+def test_krylov_reuse_policy():
+    "Test preconditioner reuse for a number of solves"
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, 'Lagrange', 1)
+    bc = DirichletBC(V, Constant(0.0), lambda x, on_boundary: on_boundary)
+    u, v = TrialFunction(V), TestFunction(V)
+    a, L = inner(grad(u), grad(v))*dx, Constant(1.0)*v*dx
+
+    A, P, b = PETScMatrix(), PETScMatrix(), PETScVector()
+    assemble(a, tensor=A)
+    assemble(a, tensor=P)
+    assemble(L, tensor=b)
+    for T in (A, P, b):
+        bc.apply(T)
+
+    solver = PETScKrylovSolver("gmres", "bjacobi")
+    solver.parameters["reuse_policy"] = "steps"
+    solver.parameters["reuse_steps"] = 2
+    solver.set_operators(A, P)
+    num_iter_ref = solver.solve(PETScVector(), b)
+
+    # Bad preconditioner matrix, second solve reuses the preconditioner
+    assemble(u*v*dx, tensor=P)
+    bc.apply(P)
+    assert solver.solve(PETScVector(), b) == num_iter_ref
+
+    # Preconditioner is rebuilt after two solves
+    assert solver.solve(PETScVector(), b) > num_iter_ref
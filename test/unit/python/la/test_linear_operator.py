@@ -20,6 +20,7 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
 from dolfin import *
+import numpy
 import pytest
 
 from dolfin_utils.test import *
@@ -91,3 +92,111 @@ def test_linear_operator(backend):
 
     # Reset backend
     parameters["linear_algebra_backend"] = prev_backend
+
+
+@pytest.mark.parametrize('backend', backends)
+def test_matrix_free_operator(backend, pushpop_parameters):
+
+    # Check whether backend is available
+    if not has_linear_algebra_backend(backend):
+        pytest.skip('Need %s as backend to run this test' % backend)
+    parameters["linear_algebra_backend"] = backend
+
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "Lagrange", 3)
+    u = TrialFunction(V)
+    v = TestFunction(V)
+    k = Expression("1.0 + x[0]", degree=1)
+    a = k*dot(grad(u), grad(v))*dx + u*v*dx + u*v*ds
+    L = Constant(1.0)*v*dx
+    A = assemble(a)
+    b = assemble(L)
+
+    O = MatrixFreeOperator(Form(a))
+    assert O.size(0) == V.dim()
+    assert O.size(1) == V.dim()
+
+    # Compare action with assembled matrix
+    x = Vector()
+    A.init_vector(x, 1)
+    x[:] = numpy.random.rand(x.local_size())
+    y_ref = Vector()
+    A.init_vector(y_ref, 0)
+    A.mult(x, y_ref)
+    y = Vector()
+    O.init_vector(y, 0)
+    O.mult(x, y)
+    assert round((y - y_ref).norm("l2"), 10) == 0
+
+    # Ghost values of the work vector must follow a new x
+    x *= 2.0
+    A.mult(x, y_ref)
+    O.mult(x, y)
+    assert round((y - y_ref).norm("l2"), 10) == 0
+
+    # Compare diagonal with assembled matrix
+    d_ref = Vector()
+    A.init_vector(d_ref, 0)
+    A.get_diagonal(d_ref)
+    d = Vector()
+    O.init_vector(d, 0)
+    O.get_diagonal(d)
+    assert round((d - d_ref).norm("l2"), 10) == 0
+
+    # Solve with matrix-free operator and Jacobi preconditioning
+    x_ref = Vector()
+    solve(A, x_ref, b, "cg", "none")
+    x = Vector()
+    solver = KrylovSolver(O, "cg", "jacobi")
+    solver.solve(x, b)
+    assert round(x.norm("l2") - x_ref.norm("l2"), 6) == 0
+
+
+@pytest.mark.parametrize('backend', backends)
+@pytest.mark.parametrize('mesh, degree',
+                         [(UnitIntervalMesh(10), 4),
+                          (UnitQuadMesh.create(mpi_comm_world(), 4, 5), 3),
+                          (UnitHexMesh.create(mpi_comm_world(), 2, 2, 3), 2)])
+def test_tensor_product_operator(backend, mesh, degree, pushpop_parameters):
+
+    # Check whether backend is available
+    if not has_linear_algebra_backend(backend):
+        pytest.skip('Need %s as backend to run this test' % backend)
+    parameters["linear_algebra_backend"] = backend
+
+    V = FunctionSpace(mesh, "Lagrange", degree)
+    u = TrialFunction(V)
+    v = TestFunction(V)
+    A = assemble(2.0*u*v*dx + 0.5*dot(grad(u), grad(v))*dx)
+
+    O = TensorProductOperator(V, 2.0, 0.5)
+    assert O.size(0) == V.dim()
+    assert len(O.lexicographic_dofs()) == (degree + 1)**mesh.topology().dim()
+
+    # Compare action with assembled matrix
+    x = Vector()
+    A.init_vector(x, 1)
+    x[:] = numpy.random.rand(x.local_size())
+    y_ref = Vector()
+    A.init_vector(y_ref, 0)
+    A.mult(x, y_ref)
+    y = Vector()
+    O.init_vector(y, 0)
+    O.mult(x, y)
+    assert round((y - y_ref).norm("l2")/y_ref.norm("l2"), 10) == 0
+
+    # Compare diagonal with assembled matrix
+    d_ref = Vector()
+    A.init_vector(d_ref, 0)
+    A.get_diagonal(d_ref)
+    d = Vector()
+    O.init_vector(d, 0)
+    O.get_diagonal(d)
+    assert round((d - d_ref).norm("l2")/d_ref.norm("l2"), 10) == 0
+
+
+def test_tensor_product_operator_simplex():
+    mesh = UnitSquareMesh(2, 2)
+    V = FunctionSpace(mesh, "Lagrange", 2)
+    with pytest.raises(RuntimeError):
+        TensorProductOperator(V, 1.0, 1.0)
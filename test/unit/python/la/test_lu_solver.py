@@ -112,3 +112,66 @@ def test_lu_solver_reuse(backend):
 
     # Reset backend
     parameters["linear_algebra_backend"] = prev_backend
+
+
+@pytest.mark.parametrize('backend', backends)
+def test_lu_solver_multiple_rhs(backend):
+    """Test LU solve for several right-hand sides with one
+    factorisation"""
+
+    # Check whether backend is available
+    if not has_linear_algebra_backend(backend):
+        pytest.skip('Need %s as backend to run this test' % backend)
+
+    # Set linear algebra backend
+    prev_backend = parameters["linear_algebra_backend"]
+    parameters["linear_algebra_backend"] = backend
+
+    mesh = UnitSquareMesh(12, 12)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    A = assemble(Constant(1.0)*u*v*dx)
+    norm = 13.0
+
+    scales = [1.0, 2.0, 3.0]
+    bs = [assemble(Constant(c)*v*dx) for c in scales]
+    xs = [Vector() for c in scales]
+
+    solver = LUSolver(A)
+    solver.solve(xs, bs)
+    for c, x in zip(scales, xs):
+        assert round(x.norm("l2") - c*norm, 10) == 0
+
+    # Reset backend
+    parameters["linear_algebra_backend"] = prev_backend
+
+
+@skip_in_parallel
+def test_eigen_lu_solver_symbolic_reuse():
+    "Test reuse of symbolic factorisation for unchanged sparsity pattern"
+
+    # Check whether backend is available
+    if not has_linear_algebra_backend("Eigen"):
+        pytest.skip('Need Eigen as backend to run this test')
+
+    # Set linear algebra backend
+    prev_backend = parameters["linear_algebra_backend"]
+    parameters["linear_algebra_backend"] = "Eigen"
+
+    mesh = UnitSquareMesh(12, 12)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u, v = TrialFunction(V), TestFunction(V)
+    b = assemble(Constant(1.0)*v*dx)
+    norm = 13.0
+
+    solver = cpp.EigenLUSolver()
+    for c in [1.0, 2.0, 4.0]:
+        A = assemble(Constant(c)*u*v*dx)
+        solver.set_operator(A)
+        x = Vector()
+        solver.solve(x, b)
+        assert round(x.norm("l2") - norm/c, 10) == 0
+    assert solver.num_symbolic_factorizations() == 1
+
+    # Reset backend
+    parameters["linear_algebra_backend"] = prev_backend
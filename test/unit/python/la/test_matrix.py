@@ -34,13 +34,17 @@ from dolfin_utils.test import *
 # Lists of backends supporting or not supporting FooMatrix::data()
 # access
 data_backends = []
-no_data_backends = [("PETSc", ""), ("Tpetra", "")]
+no_data_backends = [("Tpetra", "")]
 
 # Add serial only backends
 if MPI.size(mpi_comm_world()) == 1:
     # TODO: What about "Dense" and "Sparse"? The sub_backend wasn't
     # used in the old test.
     data_backends += [("Eigen", "")]
+    if has_pybind11():
+        data_backends += [("PETSc", "")]
+else:
+    no_data_backends += [("PETSc", "")]
 
 # Remove backends we haven't built with
 data_backends = [b for b in data_backends if has_linear_algebra_backend(b[0])]
@@ -321,7 +325,7 @@ class TestMatrixForAnyBackend:
 
 
     # Test the access of the raw data through pointers
-    # This is only available for the Eigen backend
+    # This is only available for the Eigen and (serial) PETSc backends
     def test_matrix_data(self, use_backend, data_backend):
         """ Test for ordinary Matrix"""
         self.backend, self.sub_backend = data_backend
@@ -359,6 +363,14 @@ class TestMatrixForAnyBackend:
             for k in range(rows[row], rows[row+1]):
                 assert array[row,cols[k]] == values[k]
 
+        # Test shared data against copy
+        if has_pybind11():
+            import numpy
+            _rows, _cols, _values = A.data_view()
+            assert numpy.array_equal(_rows, rows)
+            assert numpy.array_equal(_cols, cols)
+            assert numpy.array_equal(_values, values)
+
 
     def test_matrix_nnz(self, any_backend):
         A, B = self.assemble_matrices()
@@ -21,6 +21,7 @@
 
 from dolfin import *
 import pytest
+import numpy
 from dolfin_utils.test import *
 
 backends = ["PETSc", skip_in_parallel("Eigen")]
@@ -107,6 +108,13 @@ def test_nullspace_orthogonal():
             assert null_space.is_orthogonal()
             assert null_space.is_orthonormal()
 
+            # Orthogonalise a vector with respect to the basis
+            y = x.copy()
+            y[:] = numpy.random.rand(y.local_size())
+            null_space.orthogonalize(y)
+            for i in range(null_space.dim()):
+                assert abs(null_space[i].inner(y)) < 1.0e-10
+
 
 @pytest.mark.parametrize('backend', backends)
 def test_nullspace_check(backend):
@@ -145,3 +153,36 @@ def test_nullspace_check(backend):
 
     # Reset backend
     parameters["linear_algebra_backend"] = prev_backend
+
+
+@pytest.mark.parametrize('backend', backends)
+def test_rigid_body_modes(backend, pushpop_parameters):
+    "Test rigid body modes built in C++ against the Python loop"
+    if not has_linear_algebra_backend(backend):
+        pytest.skip('Need %s as backend to run this test' % backend)
+    parameters["linear_algebra_backend"] = backend
+
+    for mesh in [UnitSquareMesh(8, 8), UnitCubeMesh(3, 3, 3)]:
+        for p in [1, 2]:
+            V = VectorFunctionSpace(mesh, 'CG', p)
+            u, v = TrialFunction(V), TestFunction(V)
+            A = assemble(inner(sym(grad(u)), grad(v))*dx)
+
+            modes = rigid_body_modes(V)
+            assert modes.dim() == (3 if mesh.geometry().dim() == 2 else 6)
+            assert modes.is_orthonormal()
+            assert in_nullspace(A, modes)
+
+            # Same span as the modes built with set_x
+            x = Vector()
+            A.init_vector(x, 1)
+            reference = build_elastic_nullspace(V, x)
+            for i in range(reference.dim()):
+                y = reference[i].copy()
+                norm = y.norm("l2")
+                modes.orthogonalize(y)
+                assert y.norm("l2") < 1.0e-10*norm
+
+            if backend == "PETSc":
+                set_rigid_body_near_nullspace(A, V)
+
@@ -24,7 +24,8 @@ from __future__ import print_function
 from dolfin import (PETScVector, PETScMatrix, PETScLUSolver,
                     PETScKrylovSolver, UnitSquareMesh, TrialFunction,
                     TestFunction, mpi_comm_self, mpi_comm_world,
-                    FunctionSpace, assemble, Constant, dx, parameters)
+                    FunctionSpace, assemble, Constant, dx, parameters,
+                    Function, Expression)
 from dolfin_utils.test import (skip_if_not_PETSc,
                                skip_if_not_petsc4py,
                                pushpop_parameters)
@@ -164,6 +165,21 @@ def test_options_prefix(pushpop_parameters):
     # run_test(solver, init_solver)
 
 
+@skip_if_not_PETSc
+def test_shared_memory_ghost_update(pushpop_parameters):
+    "Test ghost updates of PETScVector through shared memory"
+    mesh = UnitSquareMesh(mpi_comm_world(), 12, 12)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    ref = assemble(Expression("x[0]", degree=1)*dx(domain=mesh))
+
+    parameters["linear_algebra_backend"] = "PETSc"
+    for ghost_update_type in ("messages", "shared_memory"):
+        parameters["ghost_update_type"] = ghost_update_type
+        u = Function(V)
+        u.interpolate(Expression("x[0]", degree=1))
+        assert round(assemble(u*dx) - ref, 12) == 0
+
+
 @skip_if_not_petsc4py
 def test_lu_cholesky():
     """Test that PETScLUSolver selects LU or Cholesky solver based on
@@ -203,3 +219,61 @@ def test_lu_cholesky():
     solver = PETScLUSolver(mesh.mpi_comm(), A, "petsc")
     pc_type = solver.ksp().getPC().getType()
     assert pc_type == "lu"
+
+
+@skip_if_not_PETSc
+def test_nest_matrix():
+    "Test nested (block) matrix assembled over separate sub-spaces"
+
+    from dolfin import PETScNestMatrix
+
+    mesh = UnitSquareMesh(mpi_comm_world(), 8, 8)
+    P1 = FunctionSpace(mesh, "Lagrange", 1)
+    P2 = FunctionSpace(mesh, "Lagrange", 2)
+    u1, v1 = TrialFunction(P1), TestFunction(P1)
+    u2, v2 = TrialFunction(P2), TestFunction(P2)
+
+    A00 = PETScMatrix(mesh.mpi_comm())
+    A01 = PETScMatrix(mesh.mpi_comm())
+    A11 = PETScMatrix(mesh.mpi_comm())
+    assemble(u1*v1*dx, tensor=A00)
+    assemble(u2*v1*dx, tensor=A01)
+    assemble(u2*v2*dx, tensor=A11)
+
+    # Upper block triangular matrix, zero (1, 0) block
+    A = PETScNestMatrix([A00, A01, None, A11])
+    assert A.num_blocks() == 2
+    assert A.size(0) == A00.size(0) + A11.size(0)
+    assert A.size(1) == A01.size(1) + A00.size(1)
+
+    # Nested vectors referencing the block vectors
+    x0, x1 = PETScVector(), PETScVector()
+    y0, y1 = PETScVector(), PETScVector()
+    A00.init_vector(x0, 1)
+    A11.init_vector(x1, 1)
+    A00.init_vector(y0, 0)
+    A11.init_vector(y1, 0)
+    x0[:] = 1.0
+    x1[:] = 2.0
+    x, y = PETScVector(), PETScVector()
+    A.init_vectors(x, [x0, x1])
+    A.init_vectors(y, [y0, y1], 0)
+    A.mult(x, y)
+
+    # Compare with block-wise products
+    z0, z1, w0 = PETScVector(), PETScVector(), PETScVector()
+    A00.init_vector(z0, 0)
+    A00.init_vector(w0, 0)
+    A11.init_vector(z1, 0)
+    A00.mult(x0, z0)
+    A01.mult(x1, w0)
+    z0.axpy(1.0, w0)
+    A11.mult(x1, z1)
+    assert round(y.norm("l2")**2 - z0.norm("l2")**2 - z1.norm("l2")**2,
+                 7) == 0
+
+    # Block row index sets partition the rows
+    dofs0 = A.get_block_dofs(0)
+    dofs1 = A.get_block_dofs(1)
+    assert len(dofs0) == A00.local_range(0)[1] - A00.local_range(0)[0]
+    assert len(dofs1) == A11.local_range(0)[1] - A11.local_range(0)[0]
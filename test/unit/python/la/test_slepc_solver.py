@@ -121,6 +121,35 @@ def test_slepc_eigensolver_gen_hermitian(K_M):
         assert near(v_im.norm("l2"), 0.0)
 
 
+@skip_if_not_PETsc_or_not_slepc
+def test_slepc_parameter_sweep(K_M):
+    "Test SLEPc eigen solver reusing factorization and eigenspace"
+
+    K, M = K_M
+    esolver = SLEPcEigenSolver(K, M)
+
+    esolver.parameters["solver"] = "krylov-schur"
+    esolver.parameters["spectral_transform"] = 'shift-and-invert'
+    esolver.parameters['spectral_shift'] = 0.0
+    esolver.parameters["problem_type"] = "gen_hermitian"
+    esolver.parameters["reuse_factorization"] = True
+    esolver.parameters["warm_start"] = True
+
+    nevs = 6
+    esolver.solve(nevs)
+    re_1, im_1 = esolver.get_eigenvalue(1)
+
+    # Scaled operator with the same nonzero pattern
+    for scale in (2.0, 3.0):
+        K_scaled = as_backend_type(K.copy())
+        K_scaled *= scale
+        esolver.set_operators(K_scaled, M)
+        esolver.solve(nevs)
+        re, im = esolver.get_eigenvalue(1)
+        assert near(re, scale*re_1, eps=1e-8*scale*re_1)
+        assert near(im, 0.0)
+
+
 @skip_if_not_PETsc_or_not_slepc
 def test_slepc_null_space(K_M, V):
     "Test SLEPc eigen solver with nullspace as PETScVector"
@@ -165,3 +165,59 @@ def test_insert_local_global(mesh, V):
             assert nnz_d[local_row] == (nnz_on_diagonal if local_row in primary_dim_local_entries else 0)
         else:
             assert nnz_od[local_row] == (nnz_off_diagonal if local_row in primary_dim_local_entries else 0)
+
+
+@pytest.mark.parametrize("diagonal", [False, True])
+def test_build_compressed(mesh, diagonal):
+    "Test that compressed (CSR) sparsity patterns match set-based patterns"
+    V = VectorFunctionSpace(mesh, "CG", 2)
+    dm = V.dofmap()
+    index_map = dm.index_map()
+
+    def build(init):
+        tl = TensorLayout(mesh.mpi_comm(), 0, TensorLayout.Sparsity_SPARSE)
+        tl.init([index_map, index_map], TensorLayout.Ghosts_UNGHOSTED)
+        sp = tl.sparsity_pattern()
+        if not init:
+            sp.init([index_map, index_map])
+        SparsityPatternBuilder.build(sp, mesh, [dm, dm],
+                                     True, False, True, False,
+                                     diagonal, init=init, finalize=True)
+        return sp
+
+    sp_sets = build(False)
+    sp_csr = build(True)
+
+    assert sp_csr.num_nonzeros() == sp_sets.num_nonzeros()
+    assert np.all(np.array(sp_csr.num_nonzeros_diagonal())
+                  == np.array(sp_sets.num_nonzeros_diagonal()))
+    assert np.all(np.array(sp_csr.num_nonzeros_off_diagonal())
+                  == np.array(sp_sets.num_nonzeros_off_diagonal()))
+
+
+def test_build_blocked(mesh):
+    "Test that patterns of blocks match entry-wise patterns"
+    V = VectorFunctionSpace(mesh, "CG", 2)
+    dm = V.dofmap()
+    index_map = dm.index_map()
+    bs = index_map.block_size()
+
+    def build(blocking):
+        tl = TensorLayout(mesh.mpi_comm(), 0, TensorLayout.Sparsity_SPARSE,
+                          blocking)
+        tl.init([index_map, index_map], TensorLayout.Ghosts_UNGHOSTED)
+        sp = tl.sparsity_pattern()
+        SparsityPatternBuilder.build(sp, mesh, [dm, dm],
+                                     True, False, True, False,
+                                     False, init=True, finalize=True)
+        return sp
+
+    sp = build(TensorLayout.Blocking_UNBLOCKED)
+    sp_blocked = build(TensorLayout.Blocking_BLOCKED)
+
+    assert sp.block_size() == 1
+    assert sp_blocked.block_size() == bs
+    assert sp_blocked.num_nonzeros()*bs*bs == sp.num_nonzeros()
+    nnz_d = np.array(sp.num_nonzeros_diagonal())
+    nnz_d_blocked = np.array(sp_blocked.num_nonzeros_diagonal())
+    assert np.all(nnz_d[::bs] == bs*nnz_d_blocked)
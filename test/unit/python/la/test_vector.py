@@ -305,6 +305,23 @@ class TestVectorForAnyBackend:
         v0 /= -2.0
         assert v0.sum() == 0.5*n
 
+    def test_fused_operations(self, any_backend):
+        n = 301
+        v0 = Vector(mpi_comm_world(), n)
+        v1 = Vector(mpi_comm_world(), n)
+        v2 = Vector(mpi_comm_world(), n)
+        v0[:] = 1.0
+        v1[:] = 2.0
+        v2[:] = 3.0
+        v0.maxpy([2.0, -1.0], [v1, v2])
+        assert round(v0.sum() - 2.0*n, 7) == 0
+        dots = v0.mdot([v1, v2])
+        assert round(dots[0] - 8.0*n, 7) == 0
+        assert round(dots[1] - 12.0*n, 7) == 0
+        dot, norm = v0.inner_norm(v1)
+        assert round(dot - 8.0*n, 7) == 0
+        assert round(norm - v0.norm("l2"), 7) == 0
+
     def test_vector_add(self, any_backend):
         n = 301
         v0 = Vector(mpi_comm_world(), n)
@@ -530,3 +547,32 @@ class TestVectorForAnyBackend:
         # Test with vector casted to backend type
         v = as_backend_type(v)
         _test_binary_ops(v, operand)
+
+
+@skip_in_parallel
+@pytest.mark.skipif(not has_linear_algebra_backend("Eigen"),
+                    reason="Eigen backend not available")
+def test_eigen_threaded_vector_operations(pushpop_parameters):
+    "Test that threaded Eigen vector operations match serial results"
+    n = 100003
+    x = EigenVector(MPI.comm_self, n)
+    y = EigenVector(MPI.comm_self, n)
+    x.set_local(numpy.linspace(-1.0, 1.0, n))
+    y.set_local(numpy.cos(numpy.arange(n, dtype=float)))
+
+    def compute():
+        z = x.copy()
+        z.axpy(0.5, y)
+        z *= 3.0
+        z -= y
+        return (z.get_local(), x.inner(y),
+                [z.norm(t) for t in ("l1", "l2", "linf")])
+
+    parameters["num_threads"] = 0
+    z0, inner0, norms0 = compute()
+    parameters["num_threads"] = 4
+    z1, inner1, norms1 = compute()
+
+    assert numpy.allclose(z0, z1)
+    assert round(inner0 - inner1, 10) == 0
+    assert numpy.allclose(norms0, norms1)
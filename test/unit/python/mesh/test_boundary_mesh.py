@@ -57,3 +57,23 @@ def test_3D_mesh():
     assert MPI.sum(mesh.mpi_comm(), bmesh1.num_cells()) == 6*8*8*2
     assert bmesh1.size_global(2) == 6*8*8*2
     assert bmesh1.topology().dim() == 2
+
+
+@pytest.mark.parametrize("ghost_mode", ["none", "shared_facet"])
+def test_entity_maps(ghost_mode):
+    parameters["ghost_mode"] = ghost_mode
+    mesh = UnitSquareMesh(8, 8)
+    parameters["ghost_mode"] = "none"
+
+    bmesh = BoundaryMesh(mesh, "exterior")
+    assert bmesh.size_global(0) == 4*8
+
+    vertex_map = bmesh.entity_map(0)
+    cell_map = bmesh.entity_map(1)
+    for v in vertices(bmesh):
+        parent = Vertex(mesh, vertex_map[v])
+        assert v.point().distance(parent.point()) < 1.0e-12
+    for c in cells(bmesh):
+        facet = Facet(mesh, cell_map[c])
+        assert facet.exterior()
+        assert c.midpoint().distance(facet.midpoint()) < 1.0e-12
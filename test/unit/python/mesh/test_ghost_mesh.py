@@ -98,3 +98,54 @@ def test_ghost_3d(pushpop_parameters):
         mesh = UnitCubeMesh(N, N, N)
         if MPI.size(mesh.mpi_comm()) > 1:
             assert MPI.sum(mesh.mpi_comm(), mesh.num_cells()) > num_cells
+
+
+@pytest.mark.parametrize("mode", ["shared_vertex", "shared_facet"])
+def test_ghost_layers(pushpop_parameters, mode):
+    parameters["ghost_mode"] = mode
+    N = 8
+
+    parameters["ghost_layers"] = 1
+    mesh1 = UnitSquareMesh(N, N)
+    parameters["ghost_layers"] = 2
+    mesh2 = UnitSquareMesh(N, N)
+
+    comm = mesh2.mpi_comm()
+    tdim = mesh2.topology().dim()
+    assert MPI.sum(comm, mesh2.topology().ghost_offset(tdim)) == 2*N*N
+    if MPI.size(comm) > 1:
+        assert MPI.sum(comm, mesh2.num_cells()) > MPI.sum(comm, mesh1.num_cells())
+
+    # Dof ownership is unaffected by the extra layer
+    V1 = FunctionSpace(mesh1, "DG", 1)
+    V2 = FunctionSpace(mesh2, "DG", 1)
+    assert V1.dim() == V2.dim()
+    u = interpolate(Expression("x[0] + 2*x[1]", degree=1), V2)
+    assert round(assemble(u*dx) - 1.5, 10) == 0
+
+
+def test_partition_diagnostics(pushpop_parameters):
+    for mode in ["none", "shared_vertex", "shared_facet"]:
+        parameters["ghost_mode"] = mode
+        mesh = UnitSquareMesh(8, 8)
+        num_processes = MPI.size(mesh.mpi_comm())
+
+        report = DistributedMeshTools.partition_report(mesh)
+        assert report.get_value("max", "owned cells") >= 128/num_processes
+        assert report.get_value("imbalance", "owned cells") >= 1.0
+        if num_processes == 1:
+            assert report.get_value("process 0", "ghost cells") == 0
+            assert report.get_value("process 0", "neighbours") == 0
+        elif mode != "none":
+            assert report.get_value("max", "ghost cells") > 0
+
+        rank = MPI.rank(mesh.mpi_comm())
+        cf = DistributedMeshTools.partition_function(mesh, "rank")
+        assert all(cf.array() == rank)
+
+        cf = DistributedMeshTools.partition_function(mesh, "owned cells")
+        owned = report.get_value("process %d" % rank, "owned cells")
+        assert all(cf.array() == owned)
+
+        with pytest.raises(RuntimeError):
+            DistributedMeshTools.partition_function(mesh, "foo")
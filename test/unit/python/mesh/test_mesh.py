@@ -29,7 +29,8 @@ from six.moves import range
 from dolfin import *
 from dolfin_utils.test import fixture, set_parameters_fixture
 from dolfin_utils.test import skip_in_parallel, xfail_in_parallel
-from dolfin_utils.test import cd_tempdir
+from dolfin_utils.test import cd_tempdir, pushpop_parameters, skip_if_pybind11
+from dolfin_utils.test import skip_if_not_pybind11
 import FIAT
 
 import os
@@ -191,6 +192,104 @@ def test_UnitCubeMeshDistributedLocal():
     assert mesh.num_cells() == 1890
 
 
+@pytest.mark.parametrize("create", [
+    lambda comm: UnitCubeMesh(comm, 3, 4, 5),
+    lambda comm: UnitSquareMesh(comm, 5, 7, "right/left"),
+    lambda comm: UnitSquareMesh(comm, 5, 7, "crossed")])
+def test_StructuredMeshDistributedMatchesSerial(create):
+    """Distributed structured meshes are built without a partitioner but
+    have the same cells, by global index, as the serial mesh."""
+    mesh = create(mpi_comm_world())
+    serial_mesh = create(mpi_comm_self())
+    tdim = mesh.topology().dim()
+    assert mesh.size_global(tdim) == serial_mesh.num_cells()
+    assert mesh.size_global(0) == serial_mesh.num_vertices()
+
+    x = mesh.coordinates()
+    x_serial = serial_mesh.coordinates()
+    for cell in cells(mesh):
+        serial_cell = Cell(serial_mesh, cell.global_index())
+        assert numpy.allclose(sorted(map(tuple, x[cell.entities(0)])),
+                              sorted(map(tuple, x_serial[serial_cell.entities(0)])))
+
+
+def test_RepartitionWeighted():
+    """Repartitioning with cell weights balances the weights."""
+    mesh = UnitSquareMesh(32, 32)
+
+    def cell_weights(mesh):
+        return numpy.array([10 if c.midpoint().x() < 0.5 else 1
+                            for c in cells(mesh)], dtype=numpy.uintp)
+
+    new_mesh = MeshPartitioning.repartition(mesh, cell_weights(mesh), 1)
+    assert new_mesh.size_global(2) == mesh.size_global(2)
+    assert new_mesh.size_global(0) == mesh.size_global(0)
+
+    local_weight = cell_weights(new_mesh).sum()
+    comm = new_mesh.mpi_comm()
+    average = MPI.sum(comm, float(local_weight))/MPI.size(comm)
+    assert MPI.max(comm, float(local_weight)) < 1.25*average
+
+
+def test_Redistribute():
+    """Move a mesh and data on it to a new partition."""
+    mesh = UnitSquareMesh(8, 8)
+    comm = mesh.mpi_comm()
+    size = MPI.size(comm)
+
+    # Cycle cells to the next process
+    rank = MPI.rank(comm)
+    num_local_cells = mesh.topology().ghost_offset(2)
+    partition = [(rank + 1) % size]*num_local_cells
+    redistribution = MeshRedistribution(mesh, partition)
+    new_mesh = redistribution.mesh()
+    assert new_mesh.size_global(2) == mesh.size_global(2)
+    assert new_mesh.size_global(0) == mesh.size_global(0)
+    assert MPI.sum(comm, new_mesh.topology().ghost_offset(2)) \
+        == mesh.size_global(2)
+
+    # Cell function of global cell indices
+    f = CellFunction("size_t", mesh)
+    for c in cells(mesh):
+        f[c] = c.global_index()
+    f_new = redistribution.redistribute(f)
+    for c in cells(new_mesh):
+        assert f_new[c] == c.global_index()
+
+    # Facet function of facet midpoints
+    g = FacetFunction("double", mesh)
+    for facet in facets(mesh):
+        g[facet] = facet.midpoint().x() + 2.0*facet.midpoint().y()
+    g_new = redistribution.redistribute(g)
+    for facet in facets(new_mesh):
+        x = facet.midpoint()
+        assert abs(g_new[facet] - (x.x() + 2.0*x.y())) < 1.0e-12
+
+    # Function values
+    e = Expression("1.0 + x[0] + x[1]*x[1]", degree=2)
+    V = FunctionSpace(mesh, "Lagrange", 2)
+    V_new = FunctionSpace(new_mesh, "Lagrange", 2)
+    u = interpolate(e, V)
+    u_new = Function(V_new)
+    redistribution.redistribute(u, u_new)
+    u_new.vector().axpy(-1.0, interpolate(e, V_new).vector())
+    assert u_new.vector().norm("linf") < 1.0e-12
+
+
+@pytest.mark.parametrize("partitioner", ["RCB", "SFC"])
+def test_GeometricPartitioner(pushpop_parameters, partitioner):
+    """Distribute meshes with the geometric partitioners."""
+    parameters["mesh_partitioner"] = partitioner
+    for mesh in (UnitIntervalMesh(mpi_comm_world(), 200),
+                 UnitQuadMesh.create(mpi_comm_world(), 16, 16),
+                 UnitHexMesh.create(mpi_comm_world(), 6, 6, 6)):
+        tdim = mesh.topology().dim()
+        num_cells = mesh.num_cells()
+        assert MPI.sum(mesh.mpi_comm(), num_cells) == mesh.size_global(tdim)
+        average = float(mesh.size_global(tdim))/MPI.size(mesh.mpi_comm())
+        assert MPI.max(mesh.mpi_comm(), num_cells) < 1.25*average + 1
+
+
 def test_UnitQuadMesh():
     mesh = UnitQuadMesh.create(mpi_comm_world(), 5, 7)
     assert mesh.size_global(0) == 48
@@ -203,6 +302,47 @@ def test_UnitHexMesh():
     assert mesh.size_global(3) == 315
 
 
+@pytest.mark.parametrize('cell_type, n, mesh',
+                         [(CellType.Type_triangle, [4, 3, 0],
+                           RectangleMesh(Point(0.0, 1.0), Point(2.0, 2.0), 4, 3)),
+                          (CellType.Type_tetrahedron, [2, 3, 2],
+                           BoxMesh(Point(0.0, 1.0, 0.0), Point(2.0, 2.0, 1.0), 2, 3, 2))])
+def test_StructuredGrid(cell_type, n, mesh):
+    grid = StructuredGrid(mpi_comm_self(), Point(0.0, 1.0, 0.0),
+                          Point(2.0, 2.0, 1.0), n[0], n[1], n[2], cell_type)
+    assert not grid.has_mesh()
+    assert grid.num_vertices() == mesh.size_global(0)
+    assert grid.num_cells() == mesh.size_global(grid.dim())
+
+    # Implicit topology and geometry agree with the generated mesh
+    if MPI.size(mesh.mpi_comm()) == 1:
+        for c in range(grid.num_cells()):
+            assert list(grid.cell_vertices(c)) == list(Cell(mesh, c).entities(0))
+        for v in range(grid.num_vertices()):
+            assert grid.vertex(v).distance(Vertex(mesh, v).point()) < 1e-14
+
+    # Facet neighbours agree with the explicit mesh of the grid
+    gmesh = grid.mesh()
+    assert grid.has_mesh()
+    D = gmesh.topology().dim()
+    gmesh.init(D - 1, D)
+    for cell in cells(gmesh):
+        neighbours = set()
+        for facet in facets(cell):
+            neighbours.update(facet.entities(D))
+        neighbours.discard(cell.index())
+        assert sorted(neighbours) == list(grid.cell_neighbours(cell.index()))
+
+    # Point location
+    point = Point(*[1.3, 1.7, 0.4][:D])
+    c = grid.locate(point)
+    assert Cell(gmesh, c).contains(point)
+    assert grid.locate(Point(3.0, 1.5, 0.5)) == numpy.iinfo(numpy.uint32).max
+
+    V = FunctionSpace(gmesh, "Lagrange", 1)
+    assert V.dim() == grid.num_vertices()
+
+
 def test_RefineUnitIntervalMesh():
     """Refine mesh of unit interval."""
     mesh = UnitIntervalMesh(20)
@@ -229,6 +369,43 @@ def test_RefineUnitCubeMesh():
     assert mesh.size_global(3) == 15120
 
 
+def test_RefineUniformMatchesMarked():
+    """Uniform refinement matches refinement with all cells marked."""
+    mesh = UnitCubeMesh(3, 2, 2)
+    mesh0 = refine(mesh)
+    mesh1 = refine(mesh, CellFunction("bool", mesh, True))
+    assert mesh0.size_global(0) == mesh1.size_global(0)
+    assert mesh0.size_global(3) == mesh1.size_global(3)
+    assert numpy.isclose(MPI.sum(mesh0.mpi_comm(), sum(c.volume() for c in cells(mesh0))), 1.0)
+    assert numpy.isclose(mesh0.hmin(), mesh1.hmin())
+    assert numpy.isclose(mesh0.hmax(), mesh1.hmax())
+
+
+@pytest.mark.skipif(not has_parmetis(), reason="ParMETIS not available")
+def test_RefineRepartition():
+    """Refine mesh locally and redistribute using adaptive repartitioning."""
+    mesh = UnitSquareMesh(8, 8)
+    num_global_cells = mesh.size_global(2)
+
+    # Refine cells close to the origin
+    cell_markers = CellFunction("bool", mesh, False)
+    for c in cells(mesh):
+        cell_markers[c] = c.midpoint().norm() < 0.5
+
+    partitioner = parameters["mesh_partitioner"]
+    approach = parameters["partitioning_approach"]
+    try:
+        parameters["mesh_partitioner"] = "ParMETIS"
+        parameters["partitioning_approach"] = "REPARTITION"
+        mesh2 = refine(mesh, cell_markers, True)
+    finally:
+        parameters["mesh_partitioner"] = partitioner
+        parameters["partitioning_approach"] = approach
+
+    assert mesh2.size_global(2) > num_global_cells
+    assert MPI.sum(mesh2.mpi_comm(), mesh2.num_cells()) == mesh2.size_global(2)
+
+
 def test_BoundaryComputation():
     """Compute boundary of mesh."""
     mesh = UnitCubeMesh(2, 2, 2)
@@ -538,6 +715,26 @@ def test_shared_entities(mesh_factory, ghost_mode):
         assert size_global ==  mesh.size_global(shared_dim)
 
 
+def test_number_entities_threaded(pushpop_parameters):
+    """Threaded ownership classification gives the serial entity
+    counts and a bijective global numbering"""
+    parameters["num_threads"] = 2
+    mesh = UnitCubeMesh(mpi_comm_world(), 4, 5, 3)
+    serial_mesh = UnitCubeMesh(mpi_comm_self(), 4, 5, 3)
+    for d in (1, 2):
+        mesh.init_global(d)
+        serial_mesh.init(d)
+        assert mesh.size_global(d) == serial_mesh.num_entities(d)
+
+        # Each global index is used by the owner and the sharing processes
+        shared = mesh.topology().shared_entities(d)
+        indices = mesh.topology().global_indices(d)
+        assert indices.min() >= 0
+        assert indices.max() < mesh.size_global(d)
+        weight = sum(1.0/(1 + len(shared.get(i, ()))) for i in range(mesh.size(d)))
+        assert round(MPI.sum(mesh.mpi_comm(), weight) - mesh.size_global(d), 8) == 0
+
+
 @pytest.mark.parametrize('mesh_factory', mesh_factories)
 def test_mesh_topology_against_fiat(mesh_factory, ghost_mode):
     """Test that mesh cells have topology matching to FIAT reference
@@ -618,3 +815,275 @@ def test_mesh_ufc_ordering(mesh_factory, ghost_mode):
 
                 # Check that d1-subentities of d-entity have increasing indices
                 assert sorted(subentities_indices) == subentities_indices
+
+
+@skip_in_parallel
+def test_threaded_topology_computation(pushpop_parameters):
+    """Test that threaded computation of mesh entities and connectivity
+    gives the same result as serial computation"""
+    mesh0 = UnitCubeMesh(6, 6, 6)
+    mesh0.init(2)
+    mesh0.init(1)
+    mesh0.init(0, 3)
+
+    parameters["num_threads"] = 4
+    mesh1 = UnitCubeMesh(6, 6, 6)
+    mesh1.init(2)
+    mesh1.init(1)
+    mesh1.init(0, 3)
+
+    for d0, d1 in [(2, 0), (3, 2), (1, 0), (3, 1), (0, 3)]:
+        assert mesh0.size(d0) == mesh1.size(d0)
+        c0 = mesh0.topology()(d0, d1)
+        c1 = mesh1.topology()(d0, d1)
+        for i in range(mesh0.size(d0)):
+            assert numpy.array_equal(c0(i), c1(i))
+
+
+def test_memory_usage():
+    mesh = UnitCubeMesh(4, 4, 4)
+    bytes0 = mesh.memory_usage()
+    assert bytes0 >= mesh.num_cells()*4*4 + mesh.num_vertices()*3*8
+    assert mesh.topology().memory_usage() < bytes0
+
+    # Computed connectivity is accounted for
+    mesh.init(1)
+    assert mesh.memory_usage() > bytes0
+
+    report = MemoryReport()
+    report.add("mesh", mesh.memory_usage())
+    report.add("mesh", 1024)
+    assert report.bytes("mesh") == mesh.memory_usage() + 1024
+    assert report.bytes("dofmap") == 0
+    assert "mesh" in report.table().str(True)
+    report.list(mesh.mpi_comm())
+
+
+def test_compress_connectivity():
+    mesh = UnitCubeMesh(4, 4, 4)
+    mesh.init(0, 3)
+    topology = mesh.topology()
+    cells = [topology(3, 0)(i).copy() for i in range(mesh.num_cells())]
+    vertex_cells = [topology(0, 3)(i).copy() for i in range(mesh.num_vertices())]
+    hash0 = topology(0, 3).hash()
+    bytes0 = topology.memory_usage()
+
+    topology.compress(True)
+    assert topology.memory_usage() < bytes0
+
+    # Constant valence: offsets are implicit
+    c = topology(3, 0)
+    assert c.valence() == 4 and not c.encoded()
+    for i in range(mesh.num_cells()):
+        assert numpy.array_equal(c(i), cells[i])
+
+    # Varying valence: connections are encoded
+    c = topology(0, 3)
+    assert c.encoded()
+    assert c.size() == sum(len(v) for v in vertex_cells)
+    assert c.hash() == hash0
+    for i in range(mesh.num_vertices()):
+        assert c.size(i) == len(vertex_cells[i])
+    with pytest.raises(RuntimeError):
+        c(0)
+
+    c.expand()
+    assert not c.encoded()
+    for i in range(mesh.num_vertices()):
+        assert numpy.array_equal(c(i), vertex_cells[i])
+
+
+def test_copy_shares_connectivity():
+    mesh = UnitSquareMesh(4, 4)
+    mesh.init(1)
+    x = mesh.coordinates().copy()
+
+    # Moving the coordinates of a copy leaves the original unchanged
+    copy = Mesh(mesh)
+    copy.coordinates()[:] += 1.0
+    assert numpy.array_equal(mesh.coordinates(), x)
+    assert numpy.array_equal(mesh.cells(), copy.cells())
+    assert mesh.topology().hash() == copy.topology().hash()
+
+    # Modifying the topology of a copy leaves the original unchanged
+    copy.clean()
+    assert copy.topology()(1, 0).size() == 0
+    assert mesh.topology()(1, 0).size() > 0
+    for e in range(mesh.num_edges()):
+        assert len(mesh.topology()(1, 0)(e)) == 2
+
+
+@pytest.mark.parametrize("mesh", [UnitIntervalMesh(5), UnitSquareMesh(3, 4),
+                                  UnitCubeMesh(2, 3, 2)])
+def test_geometry_cache(mesh):
+    gdim = mesh.geometry().dim()
+    tdim = mesh.topology().dim()
+    cache = mesh.geometry_cache()
+
+    volumes = cache.cell_volumes()
+    ratios = cache.cell_radius_ratios()
+    for cell in cells(mesh):
+        assert round(volumes[cell.index()] - cell.volume(), 12) == 0.0
+        assert round(ratios[cell.index()] - cell.radius_ratio(), 12) == 0.0
+    assert round(MeshQuality.radius_ratio_min_max(mesh)[1]
+                 - max(ratios[:mesh.topology().ghost_offset(tdim)]), 12) == 0.0
+
+    normals = cache.facet_normals()
+    areas = cache.facet_areas()
+    for facet in facets(mesh):
+        n = facet.normal()
+        for i in range(gdim):
+            assert round(normals[facet.index()*gdim + i] - n[i], 12) == 0.0
+        cell = Cell(mesh, facet.entities(tdim)[0])
+        local_facet = list(cell.entities(tdim - 1)).index(facet.index())
+        area = cell.facet_area(local_facet)
+        assert round(areas[facet.index()] - area, 12) == 0.0
+
+    # The cache is reused until the coordinates change
+    assert mesh.geometry_cache().geometry_state() == cache.geometry_state()
+    mesh.coordinates()[:] *= 2.0
+    mesh.translate(Point(*([0.0]*gdim)))
+    new_volumes = mesh.geometry_cache().cell_volumes()
+    assert round(new_volumes[0] - 2.0**tdim*volumes[0], 12) == 0.0
+
+
+@skip_if_not_pybind11
+@pytest.mark.parametrize("mesh", [UnitSquareMesh(3, 4), UnitCubeMesh(2, 3, 2)])
+def test_interior_facets(mesh):
+    tdim = mesh.topology().dim()
+    table = mesh.interior_facets()
+    facet_cells = table.cells()
+    local_facets = table.local_facets()
+
+    num_interior = 0
+    for facet in facets(mesh):
+        pos = table.position(facet.index())
+        if facet.num_entities(tdim) == 1:
+            assert pos == -1
+            continue
+        num_interior += 1
+        assert table.facets()[pos] == facet.index()
+        for k in range(2):
+            c = facet_cells[2*pos + k]
+            assert c == facet.entities(tdim)[k]
+            cell = Cell(mesh, c)
+            assert cell.entities(tdim - 1)[local_facets[2*pos + k]] \
+                == facet.index()
+    assert table.size() == num_interior
+    if MPI.size(mesh.mpi_comm()) == 1:
+        assert all(table.owned())
+
+    # The table is reused until the topology changes
+    assert mesh.interior_facets().topology_state() \
+        == mesh.topology().state()
+
+
+
+@skip_if_not_pybind11
+@pytest.mark.parametrize("mesh_factory", [(UnitSquareMesh, (3, 4)),
+                                          (UnitCubeMesh, (2, 3, 2))])
+def test_exterior_facets(mesh_factory):
+    func, args = mesh_factory
+    mesh = func(*args)
+    tdim = mesh.topology().dim()
+    table = mesh.exterior_facets()
+
+    # The table is computed without the facets of the mesh
+    if MPI.size(mesh.mpi_comm()) == 1:
+        assert mesh.num_entities(tdim - 1) == 0
+
+    computed = set(zip(table.cells(), table.local_facets()))
+    assert len(computed) == table.size()
+
+    mesh.init(tdim - 1, tdim)
+    expected = set()
+    for facet in facets(mesh):
+        if facet.exterior():
+            cell = Cell(mesh, facet.entities(tdim)[0])
+            if not cell.is_ghost():
+                expected.add((cell.index(), cell.index(facet)))
+    assert computed == expected
+
+
+def test_topology_state():
+    mesh = UnitCubeMesh(3, 3, 3)
+    state = mesh.topology().state()
+
+    # Computing new connectivity does not change the state
+    mesh.init(1)
+    mesh.init(2, 3)
+    assert mesh.topology().state() == state
+    assert mesh.geometry_cache().topology_state() == state
+
+    # Rebuilding the mesh does
+    mesh = Mesh(mpi_comm_self())
+    for n in (1, 2):
+        state = mesh.topology().state()
+        editor = MeshEditor()
+        editor.open(mesh, "interval", 1, 1)
+        editor.init_vertices(n + 1)
+        editor.init_cells(n)
+        for i in range(n + 1):
+            editor.add_vertex(i, Point(float(i)))
+        for i in range(n):
+            editor.add_cell(i, numpy.array([i, i + 1], dtype=numpy.uintp))
+        editor.close()
+        assert mesh.topology().state() > state
+        assert mesh.geometry_cache().num_cells() == n
+
+
+def test_mesh_function_state():
+    mesh = UnitSquareMesh(3, 3)
+    f = MeshFunction("size_t", mesh, mesh.topology().dim(), 0)
+    state = f.state()
+    f[0]
+    assert f.state() == state
+    f[0] = 1
+    assert f.state() > state
+    state = f.state()
+    f.set_all(2)
+    assert f.state() > state
+
+
+def test_cell_points():
+    mesh = UnitDiscMesh.create(mpi_comm_world(), 4, 2, 2)
+    geometry = mesh.geometry()
+    mesh.init_cell_points()
+    assert geometry.num_cell_points() == 6
+
+    # Vertices come first, followed by one point per edge
+    num_vertices = mesh.num_vertices()
+    for cell in cells(mesh):
+        points = geometry.cell_points(cell.index())
+        assert (points[:3] == cell.entities(0)).all()
+        assert (points[3:] >= num_vertices).all()
+        assert len(set(points)) == 6
+
+    # Affine geometries map cells to their vertices
+    mesh = UnitSquareMesh(2, 2)
+    mesh.init_cell_points()
+    for cell in cells(mesh):
+        points = mesh.geometry().cell_points(cell.index())
+        assert (points == cell.entities(0)).all()
+
+
+def test_smooth():
+    mesh = UnitSquareMesh(8, 8)
+
+    # Perturb interior vertices
+    x = mesh.coordinates()
+    interior = numpy.logical_and(numpy.all(x > 1.0e-12, axis=1),
+                                 numpy.all(x < 1.0 - 1.0e-12, axis=1))
+    x[interior, 0] += 0.3*x[interior, 0]*(1.0 - x[interior, 0])
+    q0 = MeshQuality.radius_ratio_min_max(mesh)[0]
+    x_boundary = x[numpy.logical_not(interior)].copy()
+
+    mesh.smooth(5)
+
+    # Boundary vertices are fixed, quality improves, and the area is
+    # preserved
+    x = mesh.coordinates()
+    assert numpy.allclose(x[numpy.logical_not(interior)], x_boundary)
+    assert MeshQuality.radius_ratio_min_max(mesh)[0] > q0
+    area = MPI.sum(mesh.mpi_comm(), sum(c.volume() for c in cells(mesh)))
+    assert round(area - 1.0, 10) == 0.0
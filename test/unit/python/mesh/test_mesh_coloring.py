@@ -38,3 +38,22 @@ def test_by_entity_cell_coloring(pushpop_parameters):
         coloring_type = (dim, dim - 1, dim, dim - 1, dim)
         mesh.color(coloring_type);
         colors = MeshColoring.cell_colors(mesh, coloring_type)
+
+
+def test_jones_plassmann_coloring(pushpop_parameters):
+    """Jones-Plassmann cell coloring is valid, also with ghost cells
+    and threads."""
+    parameters["graph_coloring_library"] = "JonesPlassmann"
+    parameters["num_threads"] = 2
+    parameters["ghost_mode"] = "shared_vertex"
+    mesh = UnitCubeMesh(8, 8, 8)
+    mesh.color("vertex")
+    colors = MeshColoring.cell_colors(mesh, "vertex")
+
+    # Cells sharing a vertex have different colors
+    mesh.init(0, 3)
+    for cell in cells(mesh):
+        for v in vertices(cell):
+            for c in cells(v):
+                if c.index() != cell.index():
+                    assert colors[c] != colors[cell]
@@ -22,7 +22,9 @@
 # First added:  2006-08-08
 # Last changed: 2014-02-06
 
+import pytest
 from dolfin import *
+from dolfin_utils.test import skip_in_parallel, skip_if_not_pybind11
 import numpy
 
 def test_triangle_mesh():
@@ -46,3 +48,33 @@ def test_triangle_mesh():
 
     # Close editor
     editor.close()
+
+
+@skip_in_parallel
+@skip_if_not_pybind11
+def test_bulk_mesh():
+
+    # Build copy of unit square mesh from arrays
+    reference = UnitSquareMesh(3, 3)
+    mesh = Mesh()
+    editor = MeshEditor()
+    editor.open(mesh, "triangle", 2, 2, 1)
+    editor.init_vertices(reference.num_vertices())
+    editor.init_cells(reference.num_cells())
+    editor.add_vertices(reference.coordinates().flatten())
+    editor.add_cells(reference.cells().flatten().astype(numpy.uintc))
+    editor.close()
+
+    assert mesh.num_cells() == reference.num_cells()
+    assert numpy.array_equal(mesh.coordinates(), reference.coordinates())
+    assert numpy.array_equal(mesh.cells(), reference.cells())
+    assert mesh.topology().global_indices(0)[-1] == mesh.num_vertices() - 1
+
+    # Arrays of wrong size, or out-of-range vertices, are rejected
+    editor.open(Mesh(), "triangle", 2, 2, 1)
+    editor.init_vertices(3)
+    editor.init_cells(1)
+    with pytest.raises(RuntimeError):
+        editor.add_vertices([0.0, 0.0, 1.0])
+    with pytest.raises(RuntimeError):
+        editor.add_cells([0, 1, 3])
@@ -0,0 +1,51 @@
+#!/usr/bin/env py.test
+
+"""Unit tests for MeshHierarchy"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+from __future__ import print_function
+import pytest
+from dolfin import *
+
+from dolfin_utils.test import skip_if_pybind11
+
+
+@skip_if_pybind11(reason="MeshHierarchy not wrapped in pybind11")
+def test_coarsen():
+    mesh = UnitSquareMesh(8, 8)
+    hierarchy = MeshHierarchy(mesh)
+    markers = CellFunction("bool", mesh, True)
+    hierarchy = hierarchy.refine(markers)
+    fine = hierarchy[1]
+    assert fine.size_global(2) == 4*mesh.size_global(2)
+
+    # Coarsen everywhere: recovers the original mesh
+    coarsen_markers = CellFunction("bool", fine, True)
+    coarse = hierarchy.coarsen(coarsen_markers)
+    assert coarse.size() == 2
+    assert coarse[1].size_global(2) == mesh.size_global(2)
+
+    # Coarsen the left half only
+    coarsen_markers = CellFunction("bool", fine, False)
+    for c in cells(fine):
+        coarsen_markers[c] = c.midpoint()[0] < 0.5
+    coarse = hierarchy.coarsen(coarsen_markers)
+    num_cells = coarse[1].size_global(2)
+    assert mesh.size_global(2) < num_cells < fine.size_global(2)
+    assert MPI.sum(coarse[1].mpi_comm(), coarse[1].num_cells()) == num_cells
@@ -0,0 +1,59 @@
+"""Unit tests for mesh renumbering"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import pytest
+import numpy
+from dolfin import *
+from dolfin_utils.test import skip_in_parallel
+
+
+@skip_in_parallel
+@pytest.mark.parametrize('method', ['rcm', 'hilbert'])
+def test_reorder_entities(method):
+    """Reorder cells and vertices and check that the mesh is unchanged
+    up to numbering."""
+    mesh = UnitCubeMesh(6, 6, 6)
+    tdim = mesh.topology().dim()
+
+    # Mark a subset of facets
+    facets = MeshFunction("size_t", mesh, tdim - 1, 0)
+    CompiledSubDomain("near(x[0], 0.0)").mark(facets, 1)
+
+    new_mesh = MeshRenumbering.reorder_entities(mesh, method)
+    assert new_mesh.num_cells() == mesh.num_cells()
+    assert new_mesh.num_vertices() == mesh.num_vertices()
+    assert new_mesh.ordered()
+
+    # Check maps to original vertices and cells
+    parent_vertices = new_mesh.data().array("parent_vertex_indices", 0)
+    parent_cells = new_mesh.data().array("parent_cell_indices", tdim)
+    assert numpy.allclose(new_mesh.coordinates(),
+                          mesh.coordinates()[parent_vertices])
+    assert sorted(parent_cells) == list(range(mesh.num_cells()))
+    for c in cells(new_mesh):
+        parent = Cell(mesh, parent_cells[c.index()])
+        assert sorted(parent_vertices[c.entities(0)]) \
+            == sorted(parent.entities(0))
+        assert round(c.volume() - parent.volume(), 12) == 0
+
+    # Check transfer of mesh functions
+    if has_pybind11():
+        new_facets = MeshRenumbering.reorder_mesh_function(new_mesh, facets)
+        assert sum(new_facets.array()) == sum(facets.array())
+
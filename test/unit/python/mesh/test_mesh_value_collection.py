@@ -172,3 +172,30 @@ def test_mesh_function_assign_2D_vertices():
         for i, vert in enumerate(vertices(cell)):
             assert 25 == g.get_value(cell.index(), i)
             assert f2[vert] == g.get_value(cell.index(), i)
+
+
+def test_append_finalize():
+    mesh = UnitSquareMesh(3, 3)
+    ncells = mesh.num_cells()
+    f = MeshValueCollection("int", mesh, 2)
+    f.reserve(ncells + 1)
+
+    # Append in reverse order, with one duplicate position
+    for cell in reversed(list(cells(mesh))):
+        f.append(cell.index(), 0, cell.index())
+    f.append(0, 0, 42)
+    f.finalize()
+
+    assert ncells == f.size()
+    assert 42 == f.get_value(0, 0)
+    for cell in cells(mesh):
+        if cell.index() > 0:
+            assert cell.index() == f.get_value(cell.index(), 0)
+
+    values = f.values()
+    assert sorted(values.keys()) == [(i, 0) for i in range(ncells)]
+    assert 42 == values[(0, 0)]
+
+    # Values set after finalize must be visible in a new values() map
+    assert not f.set_value(1, 0, 7)
+    assert 7 == f.values()[(1, 0)]
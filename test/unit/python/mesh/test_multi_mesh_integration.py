@@ -111,3 +111,81 @@ def test_integrate():
 
     # errorstring = "translation=" + str(dx[0]) + str(" ") + str(dx[1])
     # assert round(volume - exactvolume, 7, errorstring)
+
+
+@skip_in_parallel
+@skip_if_pybind11(reason="Not supported in pybind11")
+def test_threaded_quadrature_rules():
+    "Test that cut cell quadrature rules do not depend on num_threads"
+    mesh_0 = UnitSquareMesh(10, 10)
+    mesh_1 = UnitSquareMesh(11, 11)
+    pt = Point(0.632350, 0.278498)
+    mesh_1.translate(pt)
+    exactarea = 2 - (1 - pt[0])*(1 - pt[1])
+
+    num_threads = parameters["num_threads"]
+    areas = []
+    weights = []
+    try:
+        for n in (1, 2):
+            parameters["num_threads"] = n
+            multimesh = MultiMesh()
+            multimesh.add(mesh_0)
+            multimesh.add(mesh_1)
+            multimesh.build()
+
+            # Sum volume of uncut cells and weights of cut cells
+            area = 0.0
+            w = []
+            for part in range(multimesh.num_parts()):
+                mesh = multimesh.part(part)
+                for c in multimesh.uncut_cells(part):
+                    area += Cell(mesh, c).volume()
+                for c in multimesh.cut_cells(part):
+                    qr = multimesh.quadrature_rule_cut_cell(part, c)
+                    area += sum(qr[1])
+                    w += list(qr[1])
+            areas.append(area)
+            weights.append(w)
+    finally:
+        parameters["num_threads"] = num_threads
+
+    assert numpy.allclose(weights[0], weights[1])
+    assert round(areas[0] - exactarea, 7) == 0
+
+
+
+@skip_in_parallel
+@skip_if_pybind11(reason="Not supported in pybind11")
+def test_update_moved_part():
+    "Test that updating a moved part gives the same rules as a new build"
+    mesh_0 = UnitSquareMesh(10, 10)
+    mesh_1 = RectangleMesh(Point(0.1, 0.1), Point(0.5, 0.5), 6, 6)
+    mesh_2 = RectangleMesh(Point(0.6, 0.2), Point(0.9, 0.7), 5, 5)
+
+    multimesh = MultiMesh()
+    for mesh in (mesh_0, mesh_1, mesh_2):
+        multimesh.add(mesh)
+    multimesh.build()
+
+    # Move the middle part and update
+    mesh_1.translate(Point(0.2, 0.1))
+    multimesh.update(1)
+
+    reference = MultiMesh()
+    for mesh in (mesh_0, mesh_1, mesh_2):
+        reference.add(mesh)
+    reference.build()
+
+    for part in range(multimesh.num_parts()):
+        assert list(multimesh.uncut_cells(part)) == \
+            list(reference.uncut_cells(part))
+        assert list(multimesh.cut_cells(part)) == \
+            list(reference.cut_cells(part))
+        assert list(multimesh.covered_cells(part)) == \
+            list(reference.covered_cells(part))
+        for c in multimesh.cut_cells(part):
+            qr = multimesh.quadrature_rule_cut_cell(part, c)
+            qr_reference = reference.quadrature_rule_cut_cell(part, c)
+            assert numpy.allclose(qr[0], qr_reference[0])
+            assert numpy.allclose(qr[1], qr_reference[1])
@@ -67,3 +67,28 @@ def test_MastersSlaves(periodic_boundary, mesh):
     mf = PeriodicBoundaryComputation.masters_slaves(mesh, periodic_boundary, 1)
     assert len(np.where(mf.array() == 1)[0]) == 4
     assert len(np.where(mf.array() == 2)[0]) == 4
+
+
+@skip_in_parallel
+def test_ComputePeriodicPairs3D():
+
+    class PeriodicBoundary(SubDomain):
+        def inside(self, x, on_boundary):
+            return x[0] < DOLFIN_EPS
+
+        def map(self, x, y):
+            y[0] = x[0] - 1.0
+            y[1] = x[1]
+            y[2] = x[2]
+
+    # Verify that slave vertices are paired with masters at the
+    # mapped coordinate
+    mesh = UnitCubeMesh(3, 3, 3)
+    vertices = PeriodicBoundaryComputation.compute_periodic_pairs(mesh, PeriodicBoundary(), 0)
+    facets = PeriodicBoundaryComputation.compute_periodic_pairs(mesh, PeriodicBoundary(), 2)
+    assert len(vertices) == 16
+    assert len(facets) == 18
+
+    x = mesh.coordinates()
+    for slave, (process, master) in vertices.items():
+        assert np.allclose(x[slave] - [1.0, 0.0, 0.0], x[master])
@@ -21,6 +21,7 @@
 import numpy as np
 from dolfin import *
 from dolfin_utils.test import skip_in_parallel, skip_if_pybind11, skip_if_not_pybind11
+from dolfin_utils.test import pushpop_parameters
 import pytest
 
 
@@ -333,3 +334,47 @@ def test_creation_and_marking_pybind11():
             # Check that the number of marked entities is correct
             assert sum(f.array() == 1) == 0
             assert sum(f.array() == 2) == mesh.num_entities(f_dim)
+
+
+@skip_if_not_pybind11
+def test_marking_inside_points():
+
+    class LeftOnBoundary(SubDomain):
+        def inside(self, x, on_boundary):
+            return x[0] < 0.5 and on_boundary
+
+    class LeftOnBoundaryPoints(SubDomain):
+        def inside_points(self, values, x, on_boundary):
+            values[:] = (x[:, 0] < 0.5) & on_boundary
+
+    mesh = UnitCubeMesh(4, 4, 4)
+    for dim in range(mesh.topology().dim() + 1):
+        f0 = MeshFunction("size_t", mesh, dim, 0)
+        f1 = MeshFunction("size_t", mesh, dim, 0)
+        LeftOnBoundary().mark(f0, 1)
+        LeftOnBoundaryPoints().mark(f1, 1)
+        assert np.array_equal(f0.array(), f1.array())
+        if dim < mesh.topology().dim():
+            assert f1.array().sum() > 0
+
+
+def test_threaded_marking(pushpop_parameters):
+    """Test that marking with a compiled subdomain and threads gives
+    the same markers as marking with a Python subdomain"""
+
+    class LeftOnBoundary(SubDomain):
+        def inside(self, x, on_boundary):
+            return x[0] < 0.5 + DOLFIN_EPS and on_boundary
+
+    compiled = CompiledSubDomain("x[0] < 0.5 + DOLFIN_EPS && on_boundary")
+
+    parameters["num_threads"] = 4
+    mesh = UnitCubeMesh(4, 4, 4)
+    for dim in range(mesh.topology().dim() + 1):
+        f0 = MeshFunction("size_t", mesh, dim, 0)
+        f1 = MeshFunction("size_t", mesh, dim, 0)
+        LeftOnBoundary().mark(f0, 1)
+        compiled.mark(f1, 1)
+        assert np.array_equal(f0.array(), f1.array())
+        if dim < mesh.topology().dim():
+            assert f1.array().sum() > 0
@@ -24,7 +24,8 @@ import gc
 import pytest
 from dolfin import *
 import six
-from dolfin_utils.test import skip_in_parallel, datadir, fixture
+from dolfin_utils.test import skip_in_parallel, datadir, fixture, \
+    pushpop_parameters
 
 
 @pytest.mark.parametrize("MeshFunc", [
@@ -115,3 +116,29 @@ def test_facet_domain_propagation(datadir):
                 (outer_facets.array() == value).sum())
         assert ((parent_facets.array() == value).sum() ==
                 (outer_facets.array() == value).sum())
+
+
+@pytest.mark.parametrize("ghost_mode", ["none", "shared_facet"])
+def test_distributed_parent_maps(ghost_mode, pushpop_parameters):
+    """Create SubMesh of a distributed mesh and check parent maps."""
+    parameters["ghost_mode"] = ghost_mode
+    mesh = UnitSquareMesh(8, 8)
+
+    domains = CellFunction("size_t", mesh, 0)
+    CompiledSubDomain("x[0] < 0.5 + DOLFIN_EPS").mark(domains, 1)
+    smesh = SubMesh(mesh, domains, 1)
+
+    # Half of the cells are in the sub mesh
+    tdim = mesh.topology().dim()
+    assert smesh.size_global(tdim) == mesh.size_global(tdim) // 2
+    assert smesh.size_global(0) == 9*5
+
+    parent_cells = smesh.data().array("parent_cell_indices", tdim)
+    parent_vertices = smesh.data().array("parent_vertex_indices", 0)
+    for cell in cells(smesh):
+        parent = Cell(mesh, parent_cells[cell.index()])
+        assert cell.midpoint().distance(parent.midpoint()) < 1.0e-12
+    for vertex in vertices(smesh):
+        if parent_vertices[vertex.index()] < mesh.num_vertices():
+            parent = Vertex(mesh, parent_vertices[vertex.index()])
+            assert vertex.point().distance(parent.point()) < 1.0e-12
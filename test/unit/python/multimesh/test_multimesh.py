@@ -65,3 +65,17 @@ def test_assemble_zero(v, multimesh):
 def test_assemble_area(v, multimesh):
     v.vector()[:] = 1
     assert numpy.isclose(assemble_multimesh(v*dX), 1)
+
+
+@skip_if_pybind11
+@skip_in_parallel
+def test_assemble_area_threaded(v, multimesh):
+    v.vector()[:] = 1
+    parameters["num_threads"] = 2
+    try:
+        area = assemble_multimesh(v*dX)
+        interface_length = assemble_multimesh(v("+")*dI)
+    finally:
+        parameters["num_threads"] = 0
+    assert numpy.isclose(area, 1)
+    assert numpy.isclose(interface_length, 1)
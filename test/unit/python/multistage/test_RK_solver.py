@@ -95,3 +95,52 @@ def test_butcher_schemes_vector():
 
         assert scheme.order()-min(convergence_order(u_errors_0))<0.1
         assert scheme.order()-min(convergence_order(u_errors_1))<0.1
+
+
+@skip_in_parallel
+def test_adaptive_time_stepping():
+
+    mesh = UnitSquareMesh(4, 4)
+
+    V = FunctionSpace(mesh, "R", 0)
+    u = Function(V)
+    v = TestFunction(V)
+    form = -u*v*dx
+
+    tstop = 5.0
+    for Scheme in [BS3, ESDIRK3]:
+        scheme = Scheme(form, u)
+        assert scheme.has_error_estimate()
+        solver = RKSolver(scheme)
+        solver.parameters["adaptive"] = True
+        solver.parameters["time_step_control"]["relative_tolerance"] = 1e-5
+        solver.parameters["time_step_control"]["absolute_tolerance"] = 1e-8
+        u.interpolate(Constant(1.0))
+        solver.step_interval(0., tstop, 0.001)
+
+        num_accepted, num_rejected = solver.num_steps()
+        assert num_accepted < 500
+        assert abs(float(scheme.t()) - tstop) < 1e-12
+        assert abs(u(0.0, 0.0) - np.exp(-tstop)) < 1e-4
+
+
+def test_lumped_mass():
+
+    mesh = UnitSquareMesh(4, 4)
+
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    u = Function(V)
+    v = TestFunction(V)
+    form = -u*v*dx
+
+    tstop = 1.0
+    for Scheme in [ForwardEuler, RK4]:
+        scheme = Scheme(form, u)
+        assert len(scheme.solution_weights()) == len(scheme.b)
+        solver = RKSolver(scheme)
+        solver.parameters["lumped_mass"] = True
+        u.interpolate(Constant(1.0))
+        solver.step_interval(0., tstop, 0.01)
+        error = 1e-2 if Scheme is ForwardEuler else 1e-8
+        assert abs(u.vector().max() - np.exp(-tstop)) < error
+        assert abs(u.vector().min() - np.exp(-tstop)) < error
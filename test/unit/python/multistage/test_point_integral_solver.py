@@ -25,7 +25,7 @@ import pytest
 from dolfin import *
 import numpy as np
 
-from dolfin_utils.test import set_parameters_fixture
+from dolfin_utils.test import set_parameters_fixture, pushpop_parameters
 
 optimize = set_parameters_fixture('form_compiler.optimize', [True])
 
@@ -159,3 +159,75 @@ def test_butcher_schemes_vector(Scheme, optimize):
         u_errors.append(errornorm(u_true, u))
 
     assert scheme.order()-min(convergence_order(u_errors))<0.1
+
+
+def test_point_integral_solver_threaded(pushpop_parameters):
+    "Test that threaded stepping reproduces the serial solution"
+    mesh = UnitSquareMesh(10, 10)
+    V = VectorFunctionSpace(mesh, "CG", 1, dim=2)
+    v = TestFunction(V)
+    u = Function(V)
+    form = (-u[1]*v[0] + u[0]*v[1] - u[0]**3*v[0])*dP
+
+    values = []
+    for num_threads in [0, 3]:
+        parameters["num_threads"] = num_threads
+        scheme = ESDIRK3(form, u)
+        solver = PointIntegralSolver(scheme)
+        u.interpolate(Expression(("1.0 + x[0]", "x[1]"), degree=1))
+        scheme.t().assign(0.0)
+        solver.step_interval(0., 0.5, 0.05)
+        values.append(u.vector().get_local())
+
+    assert np.array_equal(values[0], values[1])
+
+
+def test_point_integral_solver_stored_jacobians():
+    "Test that per-vertex Jacobians are reused over stages and steps"
+    mesh = UnitSquareMesh(4, 4)
+    V = FunctionSpace(mesh, "CG", 1)
+    v = TestFunction(V)
+    u = Function(V)
+    form = (1 - u)*v*dP
+
+    values = []
+    num_jacobians = []
+    for store in [False, True]:
+        scheme = ESDIRK3(form, u)
+        solver = PointIntegralSolver(scheme)
+        solver.parameters["newton_solver"]["store_jacobians"] = store
+        if store:
+            solver.parameters["newton_solver"]["recompute_jacobian_each_solve"] = False
+            solver.parameters["newton_solver"]["reset_each_step"] = False
+        u.interpolate(Constant(0.0))
+        scheme.t().assign(0.0)
+        solver.step_interval(0., 0.5, 0.05)
+        values.append(u.vector().get_local())
+        num_jacobians.append(solver.num_jacobian_computations())
+
+    assert num_jacobians[1] < num_jacobians[0]
+    assert np.allclose(values[0], values[1], rtol=1e-8)
+
+
+def test_point_integral_solver_adaptive():
+    "Test adaptive time stepping with embedded error estimates"
+    mesh = UnitSquareMesh(4, 4)
+    V = FunctionSpace(mesh, "CG", 1)
+    v = TestFunction(V)
+    u = Function(V)
+    form = (1 - u)*v*dP
+
+    tstop = 5.0
+    for Scheme in [BS3, ESDIRK4]:
+        scheme = Scheme(form, u)
+        solver = PointIntegralSolver(scheme)
+        solver.parameters["adaptive"] = True
+        solver.parameters["time_step_control"]["relative_tolerance"] = 1e-6
+        u.interpolate(Constant(0.0))
+        solver.step_interval(0., tstop, 0.001)
+
+        num_accepted, num_rejected = solver.num_steps()
+        assert num_accepted < 500
+        assert abs(float(scheme.t()) - tstop) < 1e-12
+        assert np.allclose(u.vector().get_local(), 1.0 - np.exp(-tstop),
+                           rtol=1e-4)
@@ -0,0 +1,222 @@
+#!/usr/bin/env py.test
+
+"""Unit tests for the inexact and lagged Newton solver"""
+
+# Copyright (C) 2017 The FEniCS Project
+#
+# This file is part of DOLFIN.
+#
+# DOLFIN is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DOLFIN is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+import os
+import json
+import pytest
+from dolfin import *
+
+from dolfin_utils.test import *
+
+
+class Problem(NonlinearProblem):
+    def __init__(self, F, J, bcs):
+        NonlinearProblem.__init__(self)
+        self.a = J
+        self.L = F
+        self.bcs = bcs
+
+    def F(self, b, x):
+        assemble(self.L, tensor=b)
+        for bc in self.bcs:
+            bc.apply(b, x)
+
+    def J(self, A, x):
+        assemble(self.a, tensor=A)
+        for bc in self.bcs:
+            bc.apply(A)
+
+
+def solve_problem(params):
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "CG", 1)
+    u = Function(V)
+    v = TestFunction(V)
+    F = inner((1 + u**2)*grad(u), grad(v))*dx - Constant(10.0)*v*dx
+    J = derivative(F, u)
+    bcs = [DirichletBC(V, 0.0, "on_boundary")]
+
+    solver = NewtonSolver()
+    solver.parameters.update(params)
+    solver.parameters["relative_tolerance"] = 1e-10
+    solver.parameters["maximum_iterations"] = 50
+    converged = solver.solve(Problem(F, J, bcs), u.vector())[1]
+    return solver, u, converged
+
+
+@pytest.mark.parametrize("forcing_term", ["none", "eisenstat_walker_1",
+                                          "eisenstat_walker_2"])
+@skip_if_not_PETSc
+def test_inexact_newton(forcing_term):
+    "Test that Newton converges to the same solution with forcing terms"
+    params = {"linear_solver": "gmres", "preconditioner": "ilu",
+              "krylov_solver": {"relative_tolerance": 1e-12},
+              "krylov_forcing_term": forcing_term}
+    solver, u, converged = solve_problem(params)
+    assert converged
+
+    solver0, u0, converged0 = solve_problem({"linear_solver": "lu"})
+    assert converged0
+    assert (u.vector() - u0.vector()).norm("linf") < 1e-8
+
+
+def test_jacobian_lag():
+    "Test that a lagged Jacobian is assembled less often"
+    solver, u, converged = solve_problem({"jacobian_lag": 2,
+                                          "linear_solver": "lu"})
+    assert converged
+    assert solver.jacobian_assemblies() == (solver.iteration() + 1)//2
+
+    solver0, u0, converged0 = solve_problem({"linear_solver": "lu"})
+    assert (u.vector() - u0.vector()).norm("linf") < 1e-8
+
+
+@skip_if_not_PETSc
+def test_matrix_free_newton():
+    "Test that Jacobian-free Newton-Krylov converges with NewtonSolver"
+    params = {"linear_solver": "gmres", "preconditioner": "ilu",
+              "jacobian": "matrix_free",
+              "krylov_solver": {"relative_tolerance": 1e-12}}
+    solver, u, converged = solve_problem(params)
+    assert converged
+
+    solver0, u0, converged0 = solve_problem({"linear_solver": "lu"})
+    assert (u.vector() - u0.vector()).norm("linf") < 1e-6
+
+
+@skip_if_not_PETSc
+def test_matrix_free_snes():
+    "Test that Jacobian-free Newton-Krylov converges with PETScSNESSolver"
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "CG", 1)
+    u = Function(V)
+    v = TestFunction(V)
+    F = inner((1 + u**2)*grad(u), grad(v))*dx - Constant(10.0)*v*dx
+    J = derivative(F, u)
+    bcs = [DirichletBC(V, 0.0, "on_boundary")]
+
+    solver = PETScSNESSolver()
+    solver.parameters["linear_solver"] = "gmres"
+    solver.parameters["preconditioner"] = "ilu"
+    solver.parameters["jacobian"] = "matrix_free"
+    solver.parameters["relative_tolerance"] = 1e-10
+    converged = solver.solve(Problem(F, J, bcs), u.vector())[1]
+    assert converged
+
+    solver0, u0, converged0 = solve_problem({"linear_solver": "lu"})
+    assert (u.vector() - u0.vector()).norm("linf") < 1e-6
+
+
+def test_anderson_acceleration():
+    "Test that Anderson acceleration reduces Picard iterations"
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "CG", 1)
+    u = Function(V)
+    v = TestFunction(V)
+    du = TrialFunction(V)
+    F = inner((1 + u**2)*grad(u), grad(v))*dx - Constant(10.0)*v*dx
+    J_picard = inner((1 + u**2)*grad(du), grad(v))*dx
+    bcs = [DirichletBC(V, 0.0, "on_boundary")]
+
+    iterations = []
+    for depth in (0, 5):
+        u.vector().zero()
+        solver = NewtonSolver()
+        solver.parameters["linear_solver"] = "lu"
+        solver.parameters["relative_tolerance"] = 1e-10
+        solver.parameters["maximum_iterations"] = 100
+        solver.parameters["anderson_depth"] = depth
+        n, converged = solver.solve(Problem(F, J_picard, bcs), u.vector())
+        assert converged
+        iterations.append(n)
+    assert iterations[1] < iterations[0]
+
+    solver0, u0, converged0 = solve_problem({"linear_solver": "lu"})
+    assert (u.vector() - u0.vector()).norm("linf") < 1e-8
+
+
+@skip_if_not_PETSc
+def test_snes_nonlinear_preconditioner():
+    "Test PETScSNESSolver with a nonlinear preconditioner"
+    mesh = UnitSquareMesh(16, 16)
+    V = FunctionSpace(mesh, "CG", 1)
+    u = Function(V)
+    v = TestFunction(V)
+    F = inner((1 + u**2)*grad(u), grad(v))*dx - Constant(10.0)*v*dx
+    J = derivative(F, u)
+    bcs = [DirichletBC(V, 0.0, "on_boundary")]
+
+    solver = PETScSNESSolver()
+    solver.parameters["method"] = "anderson"
+    solver.parameters["nonlinear_preconditioner"] = "newtonls"
+    solver.parameters["linear_solver"] = "lu"
+    solver.parameters["relative_tolerance"] = 1e-10
+    converged = solver.solve(Problem(F, J, bcs), u.vector())[1]
+    assert converged
+
+    solver0, u0, converged0 = solve_problem({"linear_solver": "lu"})
+    assert (u.vector() - u0.vector()).norm("linf") < 1e-6
+
+
+@skip_if_not_PETSc
+def test_solver_telemetry(tempdir):
+    "Test structured records of Krylov and Newton solves"
+    SolverTelemetry.enable(100)
+    params = {"linear_solver": "gmres", "preconditioner": "ilu",
+              "krylov_solver": {"relative_tolerance": 1e-12}}
+    solver, u, converged = solve_problem(params)
+    assert converged
+
+    records = SolverTelemetry.drain()
+    assert SolverTelemetry.size() == 0
+    krylov = [r for r in records if r.solver == "krylov"]
+    newton = [r for r in records if r.solver == "newton"]
+    assert len(newton) == 1
+    assert len(krylov) == solver.iteration()
+
+    # Preconditioner is rebuilt for each new Jacobian
+    assert all(r.converged and r.preconditioner_rebuilt for r in krylov)
+    assert all(len(r.residuals) == r.iterations + 1 for r in krylov)
+    assert sum(r.iterations for r in krylov) == solver.krylov_iterations()
+
+    r = newton[0]
+    assert r.converged and r.reason == "converged"
+    assert r.iterations == solver.iteration()
+    assert len(r.residuals) == r.iterations + 1
+    assert r.residuals[-1] < r.residuals[0]
+    assert r.setup_time > 0.0 and r.solve_time > 0.0
+    assert '"solver": "newton"' in SolverTelemetry.json(r)
+
+    # Callbacks and JSON lines output
+    names = []
+    callback = SolverTelemetry.add_callback(lambda r: names.append(r.solver))
+    solve_problem(params)
+    SolverTelemetry.remove_callback(callback)
+    assert names[-1] == "newton"
+
+    filename = os.path.join(tempdir, "telemetry.jsonl")
+    SolverTelemetry.write(filename, u.function_space().mesh().mpi_comm())
+    SolverTelemetry.disable()
+    if MPI.rank(MPI.comm_world) == 0:
+        with open(filename) as f:
+            lines = [json.loads(l) for l in f]
+        assert len(lines) == len(names)
+        assert lines[-1]["solver"] == "newton"